@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "cdrom/cdriso.h"
+#include "cdrom/sectorstore.h"
+#include "support/benchmark.h"
+#include "support/file.h"
+#include "supportpsx/iec-60908b.h"
+
+using PCSX::Benchmark::doNotOptimize;
+using PCSX::Benchmark::Registrar;
+using PCSX::Benchmark::State;
+
+namespace {
+
+// About 10MB worth of sectors, a small data track.
+constexpr unsigned c_sectors = 4500;
+
+// A scratch directory holding a disc image in the various formats, removed once the benchmark is done.
+class Images {
+  public:
+    Images() : m_dir(std::filesystem::temp_directory_path() / "pcsx-redux-bench-cdriso") {
+        std::filesystem::remove_all(m_dir);
+        std::filesystem::create_directories(m_dir);
+    }
+    ~Images() {
+        std::error_code ec;
+        std::filesystem::remove_all(m_dir, ec);
+    }
+
+    // Mode 2 sectors, with their sync pattern and header, and contents which don't deduplicate.
+    std::filesystem::path raw() {
+        auto path = m_dir / "disc.bin";
+        PCSX::IO<PCSX::File> file(new PCSX::PosixFile(path, PCSX::FileOps::TRUNCATE));
+        uint8_t sector[PCSX::IEC60908b::FRAMESIZE_RAW];
+        for (unsigned lba = 0; lba < c_sectors; lba++) {
+            fillSector(sector, lba);
+            sector[0] = 0;
+            memset(sector + 1, 0xff, 10);
+            sector[11] = 0;
+            PCSX::IEC60908b::MSF msf(lba + 150);
+            sector[12] = toBCD(msf.m);
+            sector[13] = toBCD(msf.s);
+            sector[14] = toBCD(msf.f);
+            sector[15] = 2;
+            file->write(sector, sizeof(sector));
+        }
+        return path;
+    }
+    // Only the user data, which the reader then has to rebuild full sectors from.
+    std::filesystem::path iso() {
+        auto path = m_dir / "disc.iso";
+        PCSX::IO<PCSX::File> file(new PCSX::PosixFile(path, PCSX::FileOps::TRUNCATE));
+        uint8_t sector[PCSX::IEC60908b::FRAMESIZE_RAW];
+        for (unsigned lba = 0; lba < c_sectors; lba++) {
+            fillSector(sector, lba);
+            file->write(sector, 2048);
+        }
+        return path;
+    }
+    // The raw image, moved into a sector store, and mounted through its manifest.
+    std::filesystem::path manifest() {
+        auto path = m_dir / "disc.manifest";
+        PCSX::SectorStore store(m_dir / "store", true);
+        PCSX::CDRIso iso(raw());
+        if (store.failed() || iso.failed() || !iso.exportManifest(store, path)) return {};
+        return path;
+    }
+
+  private:
+    static uint8_t toBCD(uint8_t value) { return ((value / 10) << 4) | (value % 10); }
+    static void fillSector(uint8_t* sector, unsigned lba) {
+        for (unsigned i = 0; i < PCSX::IEC60908b::FRAMESIZE_RAW; i++) sector[i] = uint8_t(lba * 7 + i * 13 + (i >> 8));
+    }
+
+    const std::filesystem::path m_dir;
+};
+
+// Reads the disc sequentially, the way the drive does when streaming, one sector at a time.
+void benchmarkRead(State& state, std::filesystem::path (Images::*create)()) {
+    Images images;
+    auto path = (images.*create)();
+    if (path.empty()) {
+        state.skipWithError("couldn't create the disc image");
+        return;
+    }
+    auto iso = std::make_unique<PCSX::CDRIso>(path);
+    if (iso->failed()) {
+        state.skipWithError("couldn't open the disc image");
+        return;
+    }
+    unsigned lba = 0;
+    while (state.keepRunning()) {
+        if (!iso->readTrack(PCSX::IEC60908b::MSF(lba + 150))) {
+            state.skipWithError("couldn't read a sector");
+            break;
+        }
+        doNotOptimize(iso->getBuffer());
+        if (++lba == c_sectors) lba = 0;
+    }
+    iso->cancelReadAhead();
+    state.setBytesProcessed(state.iterations() * PCSX::IEC60908b::FRAMESIZE_RAW);
+}
+
+Registrar s_raw("CDRIso/Read/Raw", [](State& state) { benchmarkRead(state, &Images::raw); });
+Registrar s_iso("CDRIso/Read/ISO", [](State& state) { benchmarkRead(state, &Images::iso); });
+Registrar s_manifest("CDRIso/Read/Manifest", [](State& state) { benchmarkRead(state, &Images::manifest); });
+
+}  // namespace
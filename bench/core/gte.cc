@@ -0,0 +1,101 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+
+#include <random>
+
+#include "core/gte-kernels.h"
+#include "core/gte.h"
+#include "core/psxemulator.h"
+#include "support/benchmark.h"
+
+using PCSX::Benchmark::doNotOptimize;
+using PCSX::Benchmark::Registrar;
+using PCSX::Benchmark::State;
+
+namespace {
+
+void benchmarkKernel(State& state, decltype(&PCSX::GTEKernels::multiplyScalar) multiply) {
+    std::mt19937 gen(0x6e7e);
+    std::uniform_int_distribution<int16_t> dist16;
+    int16_t m[3][3];
+    int16_t v[64][3];
+    int32_t t[3] = {0x1000, -0x2000, 0x3000};
+    for (auto& row : m) {
+        for (auto& c : row) c = dist16(gen);
+    }
+    for (auto& vector : v) {
+        for (auto& c : vector) c = dist16(gen);
+    }
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        auto result = multiply(m, v[i++ & 63], t);
+        doNotOptimize(result);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+Registrar s_multiplyScalar("GTE/Kernels/MultiplyScalar", [](State& state) {
+    benchmarkKernel(state, PCSX::GTEKernels::multiplyScalar);
+});
+
+Registrar s_multiplySIMD("GTE/Kernels/MultiplySIMD", [](State& state) {
+    if (!PCSX::GTEKernels::hasSIMD()) {
+        state.skipWithError("no SIMD support on this CPU");
+        return;
+    }
+    benchmarkKernel(state, PCSX::GTEKernels::multiplySIMD);
+});
+
+// A plausible 3D setup: a rotation of a few degrees, a translation pushing things away from the camera,
+// the usual screen offset and projection plane distance, and some lighting.
+void setupRegisters(PCSX::GTE& gte) {
+    const uint32_t control[32] = {
+        0x00000ffb, 0xff4d00b3, 0x0ffbff4d, 0x00b30000, 0x00000ff6,  // rotation
+        0x00000010, 0xffffffe0, 0x00000800,                          // translation
+        0x08000400, 0xf8000c00, 0x06000200, 0xfa000100, 0x00000800,  // light directions
+        0x00000200, 0x00000300, 0x00000400,                          // background colour
+        0x08000800, 0x08000000, 0x08000800, 0x00000000, 0x00000800,  // light colours
+        0x00000100, 0x00000200, 0x00000300,                          // far colour
+        160 << 16, 120 << 16, 200, 0xffffeccd, 0x01400000, 0x0155, 0x0100, 0x00000000,
+    };
+    for (unsigned i = 0; i < 32; i++) gte.CTC2(control[i], i);
+    const uint32_t data[] = {0x00400020, 0x00000010, 0xffe00040, 0xfff0, 0x0020ffc0, 0x0030, 0x30405060};
+    for (unsigned i = 0; i < sizeof(data) / sizeof(data[0]); i++) gte.MTC2(data[i], i);
+    gte.MTC2(0x0800, 8);
+}
+
+template <void (PCSX::GTE::*operation)(uint32_t)>
+void benchmarkOperation(State& state, uint32_t code) {
+    auto& gte = *PCSX::g_emulator->m_gte;
+    setupRegisters(gte);
+    while (state.keepRunning()) (gte.*operation)(code);
+    state.setItemsProcessed(state.iterations());
+}
+
+Registrar s_rtps("GTE/RTPS", [](State& state) { benchmarkOperation<&PCSX::GTE::RTPS>(state, 0x00080001); });
+Registrar s_rtpt("GTE/RTPT", [](State& state) { benchmarkOperation<&PCSX::GTE::RTPT>(state, 0x00080030); });
+Registrar s_nclip("GTE/NCLIP", [](State& state) { benchmarkOperation<&PCSX::GTE::NCLIP>(state, 0x00000006); });
+Registrar s_mvmva("GTE/MVMVA", [](State& state) { benchmarkOperation<&PCSX::GTE::MVMVA>(state, 0x00080012); });
+Registrar s_ncds("GTE/NCDS", [](State& state) { benchmarkOperation<&PCSX::GTE::NCDS>(state, 0x00080413); });
+Registrar s_ncdt("GTE/NCDT", [](State& state) { benchmarkOperation<&PCSX::GTE::NCDT>(state, 0x00080416); });
+Registrar s_avsz3("GTE/AVSZ3", [](State& state) { benchmarkOperation<&PCSX::GTE::AVSZ3>(state, 0x0008002d); });
+
+}  // namespace
@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "support/benchmark.h"
+#include "supportpsx/mdec-kernels.h"
+
+using PCSX::Benchmark::doNotOptimize;
+using PCSX::Benchmark::Registrar;
+using PCSX::Benchmark::State;
+using namespace PCSX::MDECKernels;
+
+namespace {
+
+constexpr unsigned c_macroblocks = 300;
+
+// Random, but plausible, blocks: a DC coefficient, a handful of AC coefficients towards the low
+// frequencies, and the occasional denser block. This is the same as mdec-bench's synthetic streams.
+struct Stream {
+    Stream() {
+        std::mt19937 gen(c_macroblocks);
+        uint8_t tables[128];
+        for (auto& t : tables) t = 1 + gen() % 63;
+        initQuantTable(iqY, tables);
+        initQuantTable(iqUV, tables + 64);
+        std::uniform_int_distribution<int> value(-64, 63);
+        for (unsigned i = 0; i < c_macroblocks * 6; i++) {
+            const unsigned qscale = 1 + gen() % 32;
+            rl.push_back((qscale << 10) | (value(gen) & 0x3ff));
+            const unsigned coefficients = (gen() % 8) == 0 ? 40 : gen() % 10;
+            unsigned k = 0;
+            for (unsigned c = 0; c < coefficients; c++) {
+                const unsigned run = gen() % 3;
+                if ((k + run + 1) > 63) break;
+                k += run + 1;
+                rl.push_back((run << 10) | (value(gen) & 0x3ff));
+            }
+            rl.push_back(END_OF_DATA);
+        }
+        // The parser can read up to 65 words per block past the end.
+        rl.resize(rl.size() + 6 * 65, END_OF_DATA);
+    }
+    void parse(int* blocks, int* usedCols) {
+        uint16_t* p = rl.data();
+        for (unsigned m = 0; m < c_macroblocks; m++) {
+            p = parseMacroblock(blocks + m * MACROBLOCK_SIZE, usedCols + m * 6, p, iqY, iqUV);
+        }
+    }
+
+    int iqY[DSIZE2];
+    int iqUV[DSIZE2];
+    std::vector<uint16_t> rl;
+};
+
+Registrar s_parse("MDEC/Parse", [](State& state) {
+    Stream stream;
+    std::vector<int> blocks(c_macroblocks * MACROBLOCK_SIZE);
+    std::vector<int> usedCols(c_macroblocks * 6);
+    while (state.keepRunning()) {
+        stream.parse(blocks.data(), usedCols.data());
+        doNotOptimize(blocks.data());
+    }
+    state.setItemsProcessed(state.iterations() * c_macroblocks);
+});
+
+// The IDCT and colour conversion of whole macroblocks, which is what a decode command spends most of its time on.
+void benchmarkDecode(State& state, const Kernels& kernels, bool bits24) {
+    Stream stream;
+    std::vector<int> parsed(c_macroblocks * MACROBLOCK_SIZE);
+    std::vector<int> usedCols(c_macroblocks * 6);
+    stream.parse(parsed.data(), usedCols.data());
+    std::vector<int> blocks(parsed.size());
+    std::vector<uint8_t> image(16 * 16 * 3);
+    while (state.keepRunning()) {
+        memcpy(blocks.data(), parsed.data(), blocks.size() * sizeof(int));
+        for (unsigned m = 0; m < c_macroblocks; m++) {
+            int* blk = blocks.data() + m * MACROBLOCK_SIZE;
+            for (unsigned b = 0; b < 6; b++) kernels.idct(blk + b * DSIZE2, usedCols[m * 6 + b]);
+            if (bits24) {
+                kernels.rgb24(blk, image.data());
+            } else {
+                kernels.rgb15(blk, reinterpret_cast<uint16_t*>(image.data()), 0);
+            }
+            doNotOptimize(image.data());
+        }
+    }
+    state.setItemsProcessed(state.iterations() * c_macroblocks);
+}
+
+Registrar s_decode15Scalar("MDEC/Decode15/Scalar",
+                           [](State& state) { benchmarkDecode(state, getScalarKernels(), false); });
+Registrar s_decode15("MDEC/Decode15/Best", [](State& state) { benchmarkDecode(state, getKernels(), false); });
+Registrar s_decode24Scalar("MDEC/Decode24/Scalar",
+                           [](State& state) { benchmarkDecode(state, getScalarKernels(), true); });
+Registrar s_decode24("MDEC/Decode24/Best", [](State& state) { benchmarkDecode(state, getKernels(), true); });
+
+}  // namespace
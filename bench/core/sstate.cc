@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string>
+
+#include "core/sstate.h"
+#include "support/benchmark.h"
+
+using PCSX::Benchmark::doNotOptimize;
+using PCSX::Benchmark::Registrar;
+using PCSX::Benchmark::State;
+
+namespace {
+
+// These run against whatever state the emulator is in when the benchmarks start, which is freshly reset.
+
+Registrar s_save("SaveState/Save", [](State& state) {
+    size_t bytes = 0;
+    while (state.keepRunning()) {
+        auto data = PCSX::SaveStates::save();
+        bytes += data.size();
+        doNotOptimize(data.data());
+    }
+    state.setBytesProcessed(bytes);
+});
+
+Registrar s_load("SaveState/Load", [](State& state) {
+    auto data = PCSX::SaveStates::save();
+    while (state.keepRunning()) {
+        if (!PCSX::SaveStates::load(data)) {
+            state.skipWithError("couldn't load the save state back");
+            break;
+        }
+    }
+    state.setBytesProcessed(state.iterations() * data.size());
+});
+
+Registrar s_snapshotTake("SaveState/Snapshot/Take", [](State& state) {
+    auto base = PCSX::SaveStates::Snapshot::take();
+    while (state.keepRunning()) {
+        auto snapshot = PCSX::SaveStates::Snapshot::take(&base);
+        doNotOptimize(snapshot.empty());
+    }
+});
+
+Registrar s_snapshotRestore("SaveState/Snapshot/Restore", [](State& state) {
+    auto snapshot = PCSX::SaveStates::Snapshot::take();
+    while (state.keepRunning()) {
+        if (!snapshot.restore(true)) {
+            state.skipWithError("couldn't restore the snapshot");
+            break;
+        }
+    }
+});
+
+}  // namespace
@@ -0,0 +1,67 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <random>
+
+#include "core/decode_xa.h"
+#include "support/benchmark.h"
+
+using PCSX::Benchmark::Registrar;
+using PCSX::Benchmark::State;
+
+namespace {
+
+// The subheader, then 18 sound groups of 128 bytes.
+constexpr size_t c_sectorSize = 8 + 18 * 128;
+constexpr unsigned c_sectors = 16;
+
+// The decoder works in place, so each iteration decodes a fresh copy of the sectors.
+void benchmarkDecode(State& state, uint8_t coding, decltype(&xa_decode_sector) decode) {
+    std::mt19937 gen(coding);
+    std::uniform_int_distribution<unsigned> byte(0, 255);
+    uint8_t sectors[c_sectors][c_sectorSize];
+    for (auto& sector : sectors) {
+        for (auto& b : sector) b = byte(gen);
+        sector[3] = sector[7] = coding;
+    }
+    auto xa = std::make_unique<xa_decode_t>();
+    memset(xa.get(), 0, sizeof(xa_decode_t));
+    uint8_t copy[c_sectorSize];
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        memcpy(copy, sectors[i % c_sectors], c_sectorSize);
+        decode(xa.get(), copy, i == 0);
+        i++;
+    }
+    state.setItemsProcessed(state.iterations());
+    state.setBytesProcessed(state.iterations() * c_sectorSize);
+}
+
+// Coding 0x00 is 4 bits mono at 37.8kHz, and 0x01 is its stereo version.
+Registrar s_monoScalar("XA/Mono/Scalar", [](State& state) { benchmarkDecode(state, 0x00, xa_decode_sector_scalar); });
+Registrar s_mono("XA/Mono/Best", [](State& state) { benchmarkDecode(state, 0x00, xa_decode_sector); });
+Registrar s_stereoScalar("XA/Stereo/Scalar",
+                         [](State& state) { benchmarkDecode(state, 0x01, xa_decode_sector_scalar); });
+Registrar s_stereo("XA/Stereo/Best", [](State& state) { benchmarkDecode(state, 0x01, xa_decode_sector); });
+
+}  // namespace
@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+
+#include <initializer_list>
+#include <vector>
+
+#include "core/gpu.h"
+#include "core/psxemulator.h"
+#include "support/benchmark.h"
+
+using PCSX::Benchmark::Registrar;
+using PCSX::Benchmark::State;
+
+namespace {
+
+// These go through the GPU the emulator is running with, which the bench binary sets to the software one.
+
+constexpr uint32_t vertex(int x, int y) { return (uint32_t(y & 0xffff) << 16) | uint32_t(x & 0xffff); }
+
+// Each primitive is drawn over and over at the same spot, in the middle of the drawing area. Textured ones
+// sample 15 bits direct colors from the second texture page, so they don't need a CLUT.
+constexpr uint32_t c_texpage = (2 << 7) | 1;
+
+void benchmarkPrimitive(State& state, std::initializer_list<uint32_t> primitive) {
+    auto gpu = PCSX::g_emulator->m_gpu.get();
+    const std::vector<uint32_t> setup = {
+        0xe1000000 | c_texpage | (1 << 10),       // draw to the display area, with dithering
+        0xe2000000,                               // no texture window
+        0xe3000000,                               // drawing area from 0, 0
+        0xe4000000 | (511 << 10) | 1023,          // to the bottom right of VRAM
+        0xe5000000,                               // no drawing offset
+        0xe6000000,                               // no mask bit
+    };
+    gpu->replayCommands(setup.data(), setup.size(), PCSX::GPU::Logged::Origin::REPLAY, 0);
+
+    // Batching the primitives keeps the command parser's overhead out of the way, which a DMA chain does too.
+    constexpr unsigned c_batch = 64;
+    std::vector<uint32_t> words;
+    for (unsigned i = 0; i < c_batch; i++) words.insert(words.end(), primitive);
+    while (state.keepRunning()) {
+        gpu->replayCommands(words.data(), words.size(), PCSX::GPU::Logged::Origin::REPLAY, 0);
+    }
+    state.setItemsProcessed(state.iterations() * c_batch);
+}
+
+Registrar s_triFlat("SoftGPU/Triangle/Flat", [](State& state) {
+    benchmarkPrimitive(state, {0x20204080, vertex(100, 100), vertex(228, 100), vertex(100, 228)});
+});
+
+Registrar s_triGouraud("SoftGPU/Triangle/Gouraud", [](State& state) {
+    benchmarkPrimitive(state,
+                       {0x30ff0000, vertex(100, 100), 0x0000ff00, vertex(228, 100), 0x000000ff, vertex(100, 228)});
+});
+
+Registrar s_triTextured("SoftGPU/Triangle/Textured", [](State& state) {
+    benchmarkPrimitive(state, {0x24808080, vertex(100, 100), 0x00000000, vertex(228, 100), (c_texpage << 16) | 0x00ff,
+                               vertex(100, 228), 0x0000ff00});
+});
+
+Registrar s_triTexturedSemi("SoftGPU/Triangle/TexturedSemiTransparent", [](State& state) {
+    benchmarkPrimitive(state, {0x26808080, vertex(100, 100), 0x00000000, vertex(228, 100), (c_texpage << 16) | 0x00ff,
+                               vertex(100, 228), 0x0000ff00});
+});
+
+Registrar s_quadGouraudTextured("SoftGPU/Quad/GouraudTextured", [](State& state) {
+    benchmarkPrimitive(state, {0x3cff8080, vertex(100, 100), 0x00000000, 0x0080ff80, vertex(228, 100),
+                               (c_texpage << 16) | 0x00ff, 0x008080ff, vertex(100, 228), 0x0000ff00, 0x00ffffff,
+                               vertex(228, 228), 0x0000ffff});
+});
+
+Registrar s_rect("SoftGPU/Rect/Flat", [](State& state) {
+    benchmarkPrimitive(state, {0x60204080, vertex(100, 100), vertex(128, 128)});
+});
+
+Registrar s_sprite("SoftGPU/Rect/Textured", [](State& state) {
+    // Sprites take their texture page from the drawing mode, which the setup pointed at the same one.
+    benchmarkPrimitive(state, {0x64808080, vertex(100, 100), 0x00000000, vertex(128, 128)});
+});
+
+Registrar s_lineFlat("SoftGPU/Line/Flat", [](State& state) {
+    benchmarkPrimitive(state, {0x40204080, vertex(100, 100), vertex(300, 180)});
+});
+
+Registrar s_lineGouraud("SoftGPU/Line/Gouraud", [](State& state) {
+    benchmarkPrimitive(state, {0x50ff0000, vertex(100, 100), 0x000000ff, vertex(300, 180)});
+});
+
+Registrar s_fill("SoftGPU/Fill", [](State& state) {
+    benchmarkPrimitive(state, {0x02204080, vertex(0, 0), vertex(320, 240)});
+});
+
+}  // namespace
@@ -0,0 +1,120 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <chrono>
+#include <string>
+
+#include "flags.h"
+#include "fmt/format.h"
+#include "main/main.h"
+#include "support/benchmark.h"
+#include "support/file.h"
+
+namespace {
+
+// The dynarec gets measured end to end, running the mips test programs the same way the pcsxrunner tests do,
+// since what matters there is the compilation and the generated code together.
+const char* const c_programs[] = {"cpu", "memcpy", "memset", "libc"};
+
+void runProgram(const std::string& name, bool dynarec, unsigned runs) {
+    const std::string exe = fmt::format("src/mips/tests/{}/{}.ps-exe", name, name);
+    PCSX::Benchmark::Result result;
+    result.name = fmt::format("Program/{}/{}", name, dynarec ? "Dynarec" : "Interpreter");
+    double total = 0;
+    for (unsigned i = 0; i < runs; i++) {
+        MainInvoker invoker("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode",
+                            dynarec ? "-dynarec" : "-interpreter", "-loadexe", exe.c_str());
+        const auto start = std::chrono::steady_clock::now();
+        const int ret = invoker.invoke();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        if (ret != 0) {
+            result.error = fmt::format("exited with code {}", ret);
+            break;
+        }
+        total += elapsed.count();
+        result.iterations++;
+    }
+    if (result.iterations != 0) result.realTime = result.cpuTime = total / result.iterations;
+    PCSX::Benchmark::addResult(std::move(result));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    CommandLine::args args(argc, argv);
+
+    const bool asksForHelp = args.get<bool>("h").value_or(false);
+    const std::string filter = args.get<std::string>("filter").value_or("");
+    const std::string minTime = fmt::format("{}", args.get<double>("min-time").value_or(0.5));
+    const unsigned runs = args.get<unsigned>("program-runs").value_or(3);
+    const auto json = args.get<std::string>("json");
+    if (asksForHelp) {
+        fmt::print(R"(
+Usage: {} [-filter substring] [-min-time seconds] [-program-runs count] [-json output.json] [-h]
+  -filter substring     only runs the benchmarks with this in their name.
+  -min-time seconds     how long to run each benchmark for at least, default 0.5.
+  -program-runs count   how many times to run each mips test program, default 3, 0 to skip them.
+  -json output.json     also writes the results, in the Google Benchmark JSON format.
+  -h                    displays this help information and exit.
+)",
+                   argv[0]);
+        return -1;
+    }
+
+    // The kernels run from within the emulator, as most of them need it set up.
+    int ret = 0;
+    if (filter.empty()) {
+        MainInvoker invoker("-no-ui", "-softgpu", "-bios", "src/mips/openbios/openbios.bin", "-bench",
+                            "-bench-min-time", minTime.c_str());
+        ret = invoker.invoke();
+    } else {
+        MainInvoker invoker("-no-ui", "-softgpu", "-bios", "src/mips/openbios/openbios.bin", "-bench",
+                            "-bench-min-time", minTime.c_str(), "-bench-filter", filter.c_str());
+        ret = invoker.invoke();
+    }
+    if (ret != 0) {
+        fmt::print("The emulator failed to run the benchmarks, exit code {}\n", ret);
+        return -1;
+    }
+
+    for (auto program : c_programs) {
+        for (bool dynarec : {true, false}) {
+            if (runs == 0) break;
+            const auto name = fmt::format("Program/{}/{}", program, dynarec ? "Dynarec" : "Interpreter");
+            if (name.find(filter) == std::string::npos) continue;
+            runProgram(program, dynarec, runs);
+        }
+    }
+
+    fmt::print("{}", PCSX::Benchmark::reportConsole());
+    if (json.has_value()) {
+        PCSX::IO<PCSX::File> out(new PCSX::PosixFile(json.value(), PCSX::FileOps::TRUNCATE));
+        if (out->failed()) {
+            fmt::print("Unable to write {}\n", json.value());
+            return -1;
+        }
+        const auto report = PCSX::Benchmark::reportJson();
+        out->write(report.data(), report.size());
+    }
+
+    for (auto& result : PCSX::Benchmark::results()) {
+        if (!result.error.empty()) return -1;
+    }
+    return 0;
+}
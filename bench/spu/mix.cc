@@ -0,0 +1,138 @@
+/***************************************************************************
+ *   Copyright (C) 2026 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+
+#include "core/psxemulator.h"
+#include "spu/interface.h"
+#include "spu/registers.h"
+#include "support/benchmark.h"
+
+using PCSX::Benchmark::doNotOptimize;
+using PCSX::Benchmark::Registrar;
+using PCSX::Benchmark::State;
+
+namespace PCSX {
+
+namespace SPU {
+
+// The mixing stages are private to the SPU, so the benchmarks get to them through here. They run on the
+// emulator's own SPU, with its mixer thread stopped for the duration, so nothing else touches the state.
+struct MixBenchmark {
+    static impl* stopMixer() {
+        auto spu = static_cast<impl*>(g_emulator->m_spu.get());
+        if (spu->hMainThread.joinable()) spu->RemoveThread();
+        return spu;
+    }
+    static void restartMixer(impl* spu) { spu->SetupThread(); }
+
+    // One voice in its sustain phase, panned a bit to the left, and feeding the reverb.
+    static void voiceBlock(State& state, bool gauss) {
+        auto spu = stopMixer();
+        auto& block = spu->m_voiceBlock;
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<int32_t> sample(-0x8000, 0x7fff);
+        for (size_t n = 0; n < impl::VOICEBLOCKSIZE; n++) {
+            for (auto& tap : block.gaussTaps[n]) tap = sample(gen);
+            block.gaussIndex[n] = (gen() & 0xff) << 2;
+            block.samples[n] = sample(gen);
+        }
+        SPUCHAN* channel = &spu->s_chan[0];
+        channel->data.get<Chan::Stop>().value = false;
+        channel->data.get<Chan::FMod>().value = 0;
+        channel->data.get<Chan::Mute>().value = false;
+        channel->data.get<Chan::RVBActive>().value = true;
+        channel->data.get<Chan::LeftVolume>().value = 0x3000;
+        channel->data.get<Chan::RightVolume>().value = 0x1000;
+        channel->ADSRX.get<exState>().value = 2;
+        channel->ADSRX.get<exSustainIncrease>().value = 0;
+        channel->ADSRX.get<exSustainModeExp>().value = 0;
+        channel->ADSRX.get<exSustainRate>().value = 0x7f;
+
+        int32_t capVoice1Index = 0;
+        int32_t capVoice3Index = 0;
+        while (state.keepRunning()) {
+            // The sums only ever grow over a block, so they start over on each one, like the mixer does.
+            memset(spu->SSumL, 0, sizeof(spu->SSumL));
+            memset(spu->SSumR, 0, sizeof(spu->SSumR));
+            memset(spu->sRVBStart, 0, impl::NSSIZE * 2 * sizeof(int));
+            channel->ADSRX.get<exEnvelopeVol>().value = 0x6000;
+            spu->MixVoiceBlock(channel, 0, impl::NSSIZE, gauss, capVoice1Index, capVoice3Index);
+            doNotOptimize(spu->SSumL);
+        }
+        state.setItemsProcessed(state.iterations() * impl::NSSIZE);
+        restartMixer(spu);
+    }
+
+    // The "Room" preset from the hardware documentation, with its work area at the end of the SPU RAM.
+    static void reverb(State& state) {
+        static const uint16_t c_room[] = {
+            0x007d, 0x005b, 0x6d80, 0x54b8, 0xbed0, 0x0000, 0x0000, 0xba80, 0x5800, 0x5300, 0x04d6,
+            0x0333, 0x03f0, 0x0227, 0x0374, 0x01ef, 0x0334, 0x01b5, 0x0000, 0x0000, 0x0000, 0x0000,
+            0x0000, 0x0000, 0x0000, 0x0000, 0x01b4, 0x0136, 0x00b8, 0x005c, 0x8000, 0x8000,
+        };
+        auto spu = stopMixer();
+        auto& reverbMode = spu->settings.get<Reverb>().value;
+        const auto savedMode = reverbMode;
+        reverbMode = 2;
+        for (unsigned i = 0; i < sizeof(c_room) / sizeof(c_room[0]); i++) {
+            spu->writeRegister(0x1f801000 | (H_Reverb + i * 2), c_room[i]);
+        }
+        spu->writeRegister(0x1f801000 | H_SPUReverbAddr, (0x80000 - 0x26c0) / 8);
+        spu->writeRegister(0x1f801000 | H_SPUrvolL, 0x3000);
+        spu->writeRegister(0x1f801000 | H_SPUrvolR, 0x3000);
+        spu->writeRegister(0x1f801000 | H_SPUctrl,
+                           impl::ControlFlags::Enable | impl::ControlFlags::Mute |
+                               impl::ControlFlags::ReverbMasterEnable);
+
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<int> sample(-0x8000, 0x7fff);
+        int input[impl::NSSIZE * 2];
+        for (auto& s : input) s = sample(gen);
+        int sumLeft[impl::NSSIZE];
+        int sumRight[impl::NSSIZE];
+        while (state.keepRunning()) {
+            memcpy(spu->sRVBStart, input, sizeof(input));
+            memset(sumLeft, 0, sizeof(sumLeft));
+            memset(sumRight, 0, sizeof(sumRight));
+            spu->MixREVERB(sumLeft, sumRight);
+            doNotOptimize(sumLeft);
+        }
+        state.setItemsProcessed(state.iterations() * impl::NSSIZE);
+        reverbMode = savedMode;
+        restartMixer(spu);
+    }
+};
+
+}  // namespace SPU
+
+}  // namespace PCSX
+
+namespace {
+
+Registrar s_voiceBlock("SPU/MixVoiceBlock/NoInterpolation",
+                       [](State& state) { PCSX::SPU::MixBenchmark::voiceBlock(state, false); });
+Registrar s_voiceBlockGauss("SPU/MixVoiceBlock/Gauss",
+                            [](State& state) { PCSX::SPU::MixBenchmark::voiceBlock(state, true); });
+Registrar s_reverb("SPU/MixREVERB", PCSX::SPU::MixBenchmark::reverb);
+
+}  // namespace
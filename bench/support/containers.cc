@@ -0,0 +1,213 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "support/benchmark.h"
+#include "support/circular.h"
+#include "support/eventbus.h"
+#include "support/flathashmap.h"
+#include "support/hashtable.h"
+#include "support/tree.h"
+
+using PCSX::Benchmark::doNotOptimize;
+using PCSX::Benchmark::Registrar;
+using PCSX::Benchmark::State;
+
+namespace {
+
+// Audio-sized chunks, as the SPU and the CD-ROM push them to the audio output.
+constexpr size_t c_chunk = 512;
+
+template <PCSX::CircularPolicy P>
+void benchmarkCircular(State& state) {
+    auto circular = std::make_unique<PCSX::Circular<int16_t, 16384, P>>();
+    int16_t in[c_chunk] = {};
+    int16_t out[c_chunk];
+    while (state.keepRunning()) {
+        circular->enqueue(in, c_chunk);
+        circular->dequeue(out, c_chunk);
+        doNotOptimize(out);
+    }
+    state.setBytesProcessed(state.iterations() * sizeof(in));
+}
+
+Registrar s_circularLocked("Circular/Locked", benchmarkCircular<PCSX::CircularPolicy::Locked>);
+Registrar s_circularSPSC("Circular/SPSC", benchmarkCircular<PCSX::CircularPolicy::SPSC>);
+
+// The same, with the consumer on its own thread, which is how the audio output uses it.
+template <PCSX::CircularPolicy P>
+void benchmarkCircularThreaded(State& state) {
+    auto circular = std::make_unique<PCSX::Circular<int16_t, 16384, P>>();
+    std::atomic<bool> done = false;
+    std::thread consumer([&]() {
+        int16_t out[c_chunk];
+        while (!done.load(std::memory_order_relaxed)) circular->dequeue(out, c_chunk);
+    });
+    int16_t in[c_chunk] = {};
+    while (state.keepRunning()) circular->enqueue(in, c_chunk, std::chrono::milliseconds::max());
+    done = true;
+    consumer.join();
+    state.setBytesProcessed(state.iterations() * sizeof(in));
+}
+
+Registrar s_circularLockedThreaded("Circular/Locked/Threaded",
+                                   benchmarkCircularThreaded<PCSX::CircularPolicy::Locked>);
+Registrar s_circularSPSCThreaded("Circular/SPSC/Threaded", benchmarkCircularThreaded<PCSX::CircularPolicy::SPSC>);
+
+struct Ping {
+    int value;
+};
+
+// A handful of listeners on the same event, which is about what the busiest events of the emulator get.
+constexpr unsigned c_listeners = 8;
+
+Registrar s_eventBusSignal("EventBus/Signal", [](State& state) {
+    auto bus = std::make_shared<PCSX::EventBus::EventBus>();
+    PCSX::EventBus::Listener listener(bus);
+    uint64_t sum = 0;
+    for (unsigned i = 0; i < c_listeners; i++) {
+        listener.listen<Ping>([&sum, i](const auto& event) { sum += event.value + i; });
+    }
+    int i = 0;
+    while (state.keepRunning()) bus->signal(Ping{i++ & 1});
+    doNotOptimize(sum);
+    state.setItemsProcessed(state.iterations());
+});
+
+// The same fan out through plain std::function objects, as the baseline for the dispatch overhead.
+Registrar s_eventBusFunctions("EventBus/StdFunction", [](State& state) {
+    uint64_t sum = 0;
+    std::vector<std::function<void(const Ping&)>> functions;
+    for (unsigned i = 0; i < c_listeners; i++) {
+        functions.emplace_back([&sum, i](const Ping& event) { sum += event.value + i; });
+    }
+    int i = 0;
+    while (state.keepRunning()) {
+        const Ping event{i++ & 1};
+        for (auto& function : functions) function(event);
+    }
+    doNotOptimize(sum);
+    state.setItemsProcessed(state.iterations());
+});
+
+constexpr unsigned c_elements = 4096;
+
+struct HashElement;
+typedef PCSX::Intrusive::HashTable<uint32_t, HashElement> HashTableType;
+struct HashElement : public HashTableType::Node {};
+
+std::vector<uint32_t> randomKeys() {
+    std::mt19937 gen(c_elements);
+    std::vector<uint32_t> keys(c_elements);
+    for (auto& key : keys) key = gen();
+    return keys;
+}
+
+Registrar s_hashTableInsert("HashTable/Insert", [](State& state) {
+    const auto keys = randomKeys();
+    std::vector<HashElement> elements(c_elements);
+    HashTableType table;
+    while (state.keepRunning()) {
+        for (unsigned i = 0; i < c_elements; i++) table.insert(keys[i], &elements[i]);
+        state.pauseTiming();
+        for (auto& element : elements) element.unlink();
+        state.resumeTiming();
+    }
+    state.setItemsProcessed(state.iterations() * c_elements);
+});
+
+Registrar s_hashTableFind("HashTable/Find", [](State& state) {
+    const auto keys = randomKeys();
+    std::vector<HashElement> elements(c_elements);
+    HashTableType table;
+    for (unsigned i = 0; i < c_elements; i++) table.insert(keys[i], &elements[i]);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        auto found = table.find(keys[i++ % c_elements]);
+        doNotOptimize(found);
+    }
+    state.setItemsProcessed(state.iterations());
+});
+
+// The open addressing map the dynarec keeps its block links in, against the intrusive one above.
+Registrar s_flatHashMapFind("FlatHashMap/Find", [](State& state) {
+    const auto keys = randomKeys();
+    PCSX::FlatHashMap<uint32_t, uint32_t> map;
+    for (auto key : keys) map[key] = key;
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        auto found = map.find(keys[i++ % c_elements]);
+        doNotOptimize(found);
+    }
+    state.setItemsProcessed(state.iterations());
+});
+
+struct TreeElement;
+typedef PCSX::Intrusive::Tree<uint32_t, TreeElement> TreeType;
+struct TreeElement : public TreeType::Node {};
+
+Registrar s_treeInsert("Tree/Insert", [](State& state) {
+    const auto keys = randomKeys();
+    std::vector<TreeElement> elements(c_elements);
+    TreeType tree;
+    while (state.keepRunning()) {
+        for (unsigned i = 0; i < c_elements; i++) tree.insert(keys[i], &elements[i]);
+        state.pauseTiming();
+        tree.clear();
+        state.resumeTiming();
+    }
+    state.setItemsProcessed(state.iterations() * c_elements);
+});
+
+Registrar s_treeFind("Tree/Find", [](State& state) {
+    const auto keys = randomKeys();
+    std::vector<TreeElement> elements(c_elements);
+    TreeType tree;
+    for (unsigned i = 0; i < c_elements; i++) tree.insert(keys[i], &elements[i]);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        auto found = tree.find(keys[i++ % c_elements]);
+        doNotOptimize(found);
+    }
+    state.setItemsProcessed(state.iterations());
+});
+
+// Intervals of a few KB, the way the memory and the debugger track ranges of addresses.
+Registrar s_treeIntervalSearch("Tree/IntervalSearch", [](State& state) {
+    const auto keys = randomKeys();
+    std::vector<TreeElement> elements(c_elements);
+    TreeType tree;
+    for (unsigned i = 0; i < c_elements; i++) tree.insert(keys[i], keys[i] + (keys[i] & 0xffff), &elements[i]);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        unsigned count = 0;
+        for (auto it = tree.find(keys[i++ % c_elements], TreeType::INTERVAL_SEARCH); it != tree.end(); it++) count++;
+        doNotOptimize(count);
+    }
+    state.setItemsProcessed(state.iterations());
+});
+
+}  // namespace
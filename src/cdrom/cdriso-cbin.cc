@@ -58,11 +58,9 @@ bool PCSX::CDRIso::handlecbin(const char *isofile) {
         }
     }
 
-    m_compr_img = (compr_img_t *)calloc(1, sizeof(*m_compr_img));
-    if (m_compr_img == NULL) goto fail_io;
+    m_compr_img = new compr_img_t();
 
     m_compr_img->block_shift = 0;
-    m_compr_img->current_block = (unsigned int)-1;
 
     m_compr_img->index_len = ciso_hdr.total_bytes / ciso_hdr.block_size;
     m_compr_img->index_table =
@@ -92,9 +90,7 @@ fail_index:
     free(m_compr_img->index_table);
     m_compr_img->index_table = NULL;
 fail_io:
-    if (m_compr_img != NULL) {
-        free(m_compr_img);
-        m_compr_img = NULL;
-    }
+    delete m_compr_img;
+    m_compr_img = NULL;
     return false;
 }
@@ -17,245 +17,291 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include "cdrom/cdriso.h"
 #include "core/cdrom.h"
 
 static constexpr unsigned ECM_HEADER_SIZE = 4;
 
+namespace {
+
+// Reads the ECM stream through a window, so that walking the record headers doesn't cost one
+// file access per byte, while still being able to skip over large payloads.
+class ECMReader {
+  public:
+    ECMReader(PCSX::IO<PCSX::File> f, size_t windowSize) : m_file(f), m_size(f->size()), m_window(windowSize) {}
+    bool read(uint8_t *dest, size_t len, size_t pos) {
+        if ((pos + len) > m_size) return false;
+        if (len > m_window.size()) return m_file->readAt(dest, len, pos) == ssize_t(len);
+        if ((pos < m_start) || ((pos + len) > (m_start + m_len))) {
+            ssize_t r = m_file->readAt(m_window.data(), std::min(m_window.size(), m_size - pos), pos);
+            m_start = pos;
+            m_len = std::max(r, ssize_t(0));
+            if (m_len < len) return false;
+        }
+        memcpy(dest, m_window.data() + pos - m_start, len);
+        return true;
+    }
+    int getc(size_t pos) {
+        uint8_t c;
+        return read(&c, 1, pos) ? c : EOF;
+    }
+
+  private:
+    PCSX::IO<PCSX::File> m_file;
+    const size_t m_size;
+    std::vector<uint8_t> m_window;
+    size_t m_start = 0;
+    size_t m_len = 0;
+};
+
 /* Adapted from ecm.c:unecmify() (C) Neill Corlett */
-ssize_t PCSX::CDRIso::ecmDecode(IO<File> f, unsigned int base, void *dest, int sector) {
-    uint32_t b = 0, writebytecount = 0, num;
-    uint32_t sectorcount = 0;
-    int8_t type = 0;  // mode type 0 (META) or 1, 2 or 3 for CDROM type
-    uint8_t sector_buffer[PCSX::IEC60908b::FRAMESIZE_RAW];
-    // this flag tells if to decode all sectors or just skip to wanted sector
-    bool processsectors = (bool)m_decoded_ecm_sectors;
-    ECMFILELUT *pos = &(m_ecm_savetable[0]);  // points always to beginning of ECM DATA
+bool readRecordHeader(ECMReader &reader, size_t &pos, uint32_t &type, uint32_t &num) {
+    int c = reader.getc(pos++);
+    int bits = 5;
+    if (c == EOF) return false;
+    type = c & 3;
+    num = (c >> 2) & 0x1F;
+    while (c & 0x80) {
+        c = reader.getc(pos++);
+        if (c == EOF) return false;
+        if ((bits > 31) || ((uint32_t)(c & 0x7F)) >= (((uint32_t)0x80000000LU) >> (bits - 1))) return false;
+        num |= ((uint32_t)(c & 0x7F)) << bits;
+        bits += 7;
+    }
+    return true;
+}
 
-    // If not pointing to ECM file but CDDA file or some other track
-    if (f != m_cdHandle) {
-        // printf("BASETR %i %i\n", base, sector);
-        return (*this.*m_cdimg_read_func_o)(f, base, dest, sector);
+void reconstructSector(uint8_t *sector, uint32_t type) {
+    // Sync
+    sector[0x000] = 0x00;
+    sector[0x001] = 0xff;
+    sector[0x002] = 0xff;
+    sector[0x003] = 0xff;
+    sector[0x004] = 0xff;
+    sector[0x005] = 0xff;
+    sector[0x006] = 0xff;
+    sector[0x007] = 0xff;
+    sector[0x008] = 0xff;
+    sector[0x009] = 0xff;
+    sector[0x00a] = 0xff;
+    sector[0x00b] = 0x00;
+
+    switch (type) {
+        case 1:
+            // Mode
+            sector[0x00f] = 0x01;
+            // Empty
+            sector[0x814] = 0x00;
+            sector[0x815] = 0x00;
+            sector[0x816] = 0x00;
+            sector[0x817] = 0x00;
+            sector[0x818] = 0x00;
+            sector[0x819] = 0x00;
+            sector[0x81a] = 0x00;
+            sector[0x81b] = 0x00;
+            break;
+        case 2:
+        case 3:
+            // Mode
+            sector[0x00f] = 0x02;
+            // Subheaders
+            sector[0x010] = sector[0x014];
+            sector[0x011] = sector[0x015];
+            sector[0x012] = sector[0x016];
+            sector[0x013] = sector[0x017];
+            break;
     }
-    // When sector exists in decoded ECM file buffer
-    else if (m_decoded_ecm_sectors && sector < m_decoded_ecm_sectors) {
-        // printf("ReadSector %i %i\n", sector, savedsectors);
-        return (*this.*m_cdimg_read_func_o)(m_decoded_ecm, base, dest, sector);
+
+    PCSX::IEC60908b::computeEDCECC(sector);
+}
+
+struct ECMIndexHeader {
+    uint8_t magic[4];
+    uint32_t version;
+    uint64_t ecmSize;
+    uint64_t decodedSize;
+    uint32_t blockSectors;
+    uint32_t count;
+};
+
+constexpr uint8_t c_ecmIndexMagic[4] = {'E', 'C', 'M', 'X'};
+constexpr uint32_t c_ecmIndexVersion = 1;
+
+}  // namespace
+
+bool PCSX::CDRIso::buildECMIndex(IO<File> f) {
+    static constexpr uint64_t blockSize = sizeof(ECMBlock::data);
+    ECMReader reader(f, 256 * 1024);
+    const size_t size = f->size();
+    uint64_t out = 0;
+    size_t pos = ECM_HEADER_SIZE;
+
+    m_ecmIndex.clear();
+    while (true) {
+        uint32_t type, num;
+        if (!readRecordHeader(reader, pos, type, num)) return false;
+        if (num == 0xFFFFFFFF) break;
+        const uint64_t count = uint64_t(num) + 1;
+        const uint64_t end = out + count * ECM_SECTOR_SIZE[type];
+        // Checkpoint all the blocks starting within this record, at the unit covering their first byte.
+        while ((m_ecmIndex.size() * blockSize) < end) {
+            const uint64_t unit = (m_ecmIndex.size() * blockSize - out) / ECM_SECTOR_SIZE[type];
+            m_ecmIndex.push_back({out + unit * ECM_SECTOR_SIZE[type], uint32_t(pos + unit * ECM_UNIT_SIZE[type]),
+                                  uint32_t(count - unit), type});
+        }
+        out = end;
+        pos += count * ECM_UNIT_SIZE[type];
+        if (pos > size) return false;
     }
-    // To prevent invalid seek
-    /* else if (sector > m_len_ecm_savetable) {
-            PCSX::g_system->printf("ECM: invalid sector requested\n");
-            return -1;
-    }*/
-    // printf("SeekSector %i %i %i %i\n", sector, pos->sector, m_prevsector, base);
-
-    if (sector <= m_len_ecm_savetable) {
-        // get sector from LUT which points to wanted sector or close to
-        // TODO: What would be optimal maximum to search near sector?
-        //       Might cause slowdown if too small but too big also..
-        for (sectorcount = sector; ((sectorcount > 0) && ((sector - sectorcount) <= 50000)); sectorcount--) {
-            if (m_ecm_savetable[sectorcount].filepos >= ECM_HEADER_SIZE) {
-                pos = &(m_ecm_savetable[sectorcount]);
-                // printf("LUTSector %i %i %i %i\n", sector, pos->sector, m_prevsector, base);
-                break;
-            }
+
+    m_ecmDecodedSize = out;
+    return !m_ecmIndex.empty();
+}
+
+bool PCSX::CDRIso::loadECMIndex(const std::filesystem::path &path, size_t ecmSize) {
+    IO<File> f(new PosixFile(path));
+    if (f->failed()) return false;
+
+    ECMIndexHeader header;
+    if (f->read(&header, sizeof(header)) != sizeof(header)) return false;
+    if ((memcmp(header.magic, c_ecmIndexMagic, sizeof(c_ecmIndexMagic)) != 0) ||
+        (header.version != c_ecmIndexVersion) || (header.ecmSize != ecmSize) ||
+        (header.blockSectors != c_ecmBlockSectors) || (header.count == 0) ||
+        (header.count != ((header.decodedSize + sizeof(ECMBlock::data) - 1) / sizeof(ECMBlock::data)))) {
+        return false;
+    }
+
+    m_ecmIndex.resize(header.count);
+    const size_t len = header.count * sizeof(ECMCheckpoint);
+    bool valid = f->read(m_ecmIndex.data(), len) == ssize_t(len);
+    for (auto &checkpoint : m_ecmIndex) {
+        if (!valid) break;
+        valid = (checkpoint.type < 4) && (checkpoint.remaining != 0) && (checkpoint.filePos < ecmSize);
+    }
+    if (!valid) {
+        m_ecmIndex.clear();
+        return false;
+    }
+    m_ecmDecodedSize = header.decodedSize;
+    return true;
+}
+
+void PCSX::CDRIso::saveECMIndex(const std::filesystem::path &path, size_t ecmSize) {
+    // This is only a cache, so if the image lives somewhere read-only, we'll just scan it again next time.
+    IO<File> f(new PosixFile(path, FileOps::TRUNCATE));
+    if (f->failed()) return;
+
+    ECMIndexHeader header;
+    memcpy(header.magic, c_ecmIndexMagic, sizeof(c_ecmIndexMagic));
+    header.version = c_ecmIndexVersion;
+    header.ecmSize = ecmSize;
+    header.decodedSize = m_ecmDecodedSize;
+    header.blockSectors = c_ecmBlockSectors;
+    header.count = m_ecmIndex.size();
+    f->write(&header, sizeof(header));
+    f->write(m_ecmIndex.data(), m_ecmIndex.size() * sizeof(ECMCheckpoint));
+}
+
+PCSX::CDRIso::ECMBlock *PCSX::CDRIso::decodeECMBlock(IO<File> f, uint32_t block) {
+    ECMBlock *victim = &m_ecmCache[0];
+    for (unsigned i = 0; i < c_ecmCachedBlocks; i++) {
+        ECMBlock &cached = m_ecmCache[i];
+        if (cached.block == block) {
+            cached.lastUse = ++m_ecmUse;
+            return &cached;
         }
-        // if suitable sector was not found from LUT use last sector if less than wanted sector
-        if (pos->filepos <= ECM_HEADER_SIZE && sector > m_prevsector) pos = &(m_ecm_savetable[m_prevsector]);
+        if (cached.lastUse < victim->lastUse) victim = &cached;
     }
+    if (block >= m_ecmIndex.size()) return nullptr;
 
-    auto reconstructSector = [](uint8_t *sector, int8_t type) {
-        auto ref32 = [sector](uint32_t offset) -> uint32_t & { return *reinterpret_cast<uint32_t *>(sector + offset); };
-        // Sync
-        sector[0x000] = 0x00;
-        sector[0x001] = 0xff;
-        sector[0x002] = 0xff;
-        sector[0x003] = 0xff;
-        sector[0x004] = 0xff;
-        sector[0x005] = 0xff;
-        sector[0x006] = 0xff;
-        sector[0x007] = 0xff;
-        sector[0x008] = 0xff;
-        sector[0x009] = 0xff;
-        sector[0x00a] = 0xff;
-        sector[0x00b] = 0x00;
+    static constexpr uint64_t blockSize = sizeof(ECMBlock::data);
+    const ECMCheckpoint &checkpoint = m_ecmIndex[block];
+    const uint64_t blockStart = block * blockSize;
+    const uint64_t blockEnd = std::min(blockStart + blockSize, m_ecmDecodedSize);
+    // A block's span of the ECM file is at most a bit over 37kB, so this is a single read.
+    ECMReader reader(f, 64 * 1024);
+    uint8_t sector[IEC60908b::FRAMESIZE_RAW] = {0};
+    uint64_t out = checkpoint.outPos;
+    size_t pos = checkpoint.filePos;
+    uint64_t remaining = checkpoint.remaining;
+    uint32_t type = checkpoint.type;
 
+    victim->block = ~0u;
+    if (blockEnd != (blockStart + blockSize)) memset(victim->data, 0, blockSize);
+    while (out < blockEnd) {
+        if (remaining == 0) {
+            uint32_t num;
+            if (!readRecordHeader(reader, pos, type, num) || (num == 0xFFFFFFFF)) return nullptr;
+            remaining = uint64_t(num) + 1;
+        }
+        const uint8_t *unit = sector;
+        uint64_t len = ECM_SECTOR_SIZE[type];
         switch (type) {
-            case 1:
-                // Mode
-                sector[0x00f] = 0x01;
-                // Empty
-                sector[0x814] = 0x00;
-                sector[0x815] = 0x00;
-                sector[0x816] = 0x00;
-                sector[0x817] = 0x00;
-                sector[0x818] = 0x00;
-                sector[0x819] = 0x00;
-                sector[0x81a] = 0x00;
-                sector[0x81b] = 0x00;
+            case 0:  // META
+                len = std::min({remaining, blockEnd - out, uint64_t(sizeof(sector))});
+                if (!reader.read(sector, len, pos)) return nullptr;
+                pos += len;
+                remaining -= len;
                 break;
-            case 2:
-            case 3:
-                // Mode
-                sector[0x00f] = 0x02;
-                // Subheaders
-                sector[0x010] = sector[0x014];
-                sector[0x011] = sector[0x015];
-                sector[0x012] = sector[0x016];
-                sector[0x013] = sector[0x017];
+            case 1:  // Mode 1
+                if (!reader.read(sector + 0x00C, 0x003, pos)) return nullptr;
+                if (!reader.read(sector + 0x010, 0x800, pos + 0x003)) return nullptr;
+                reconstructSector(sector, type);
+                pos += ECM_UNIT_SIZE[type];
+                remaining--;
                 break;
-        }
-
-        IEC60908b::computeEDCECC(sector);
-    };
-
-    writebytecount = pos->sector * PCSX::IEC60908b::FRAMESIZE_RAW;
-    sectorcount = pos->sector;
-    if (m_decoded_ecm_sectors) m_decoded_ecm->rSeek(writebytecount, SEEK_SET);  // rewind to last pos
-    f->rSeek(/*base+*/ pos->filepos, SEEK_SET);
-    while (sector >= sectorcount) {  // decode ecm file until we are past wanted sector
-        int c = f->getc();
-        int bits = 5;
-        if (c == EOF) {
-            goto error_in;
-        }
-        type = c & 3;
-        num = (c >> 2) & 0x1F;
-        // printf("ECM1 file; count %x\n", c);
-        while (c & 0x80) {
-            c = f->getc();
-            // printf("ECM2 file; count %x\n", c);
-            if (c == EOF) {
-                goto error_in;
-            }
-            if ((bits > 31) || ((uint32_t)(c & 0x7F)) >= (((uint32_t)0x80000000LU) >> (bits - 1))) {
-                // PCSX::g_system->message(_("Corrupt ECM file; invalid sector count\n"));
-                goto error;
-            }
-            num |= ((uint32_t)(c & 0x7F)) << bits;
-            bits += 7;
-        }
-        if (num == 0xFFFFFFFF) {
-            // End indicator
-            m_len_decoded_ecm_buffer = writebytecount;
-            m_len_ecm_savetable = m_len_decoded_ecm_buffer / PCSX::IEC60908b::FRAMESIZE_RAW;
-            break;
-        }
-        num++;
-        while (num) {
-            if (!processsectors && sectorcount >= (sector - 1)) {  // ensure that we read the sector we are supposed to
-                processsectors = true;
-                // printf("Saving at %i\n", sectorcount);
-            } else if (processsectors && sectorcount > sector) {
-                // printf("Terminating at %i\n", sectorcount);
+            case 2:  // Mode 2 (XA), form 1
+            case 3:  // Mode 2 (XA), form 2
+                if (!reader.read(sector + 0x014, ECM_UNIT_SIZE[type], pos)) return nullptr;
+                reconstructSector(sector, type);
+                unit = sector + 0x10;
+                pos += ECM_UNIT_SIZE[type];
+                remaining--;
                 break;
-            }
-            /*printf("Type %i Num %i SeekSector %i ProcessedSectors %i(%i) Bytecount %i Pos %li Write %u\n",
-                            type, num, sector, sectorcount, pos->sector, writebytecount, ftell(f),
-               processsectors);*/
-            switch (type) {
-                case 0:  // META
-                    b = num;
-                    if (b > sizeof(sector_buffer)) {
-                        b = sizeof(sector_buffer);
-                    }
-                    writebytecount += b;
-                    if (!processsectors) {
-                        f->rSeek(b, SEEK_CUR);
-                        break;
-                    }  // seek only
-                    if (f->read(sector_buffer, b) != b) {
-                        goto error_in;
-                    }
-                    // output_edc = edc_compute(output_edc, sector_buffer, b);
-                    if (m_decoded_ecm_sectors &&
-                        m_decoded_ecm->write(sector_buffer, b) != b) {  // just seek or write also
-                        goto error_out;
-                    }
-                    break;
-                case 1:  // Mode 1
-                    b = 1;
-                    writebytecount += ECM_SECTOR_SIZE[type];
-                    if (f->read(sector_buffer + 0x00C, 0x003) != 0x003) {
-                        goto error_in;
-                    }
-                    if (f->read(sector_buffer + 0x010, 0x800) != 0x800) {
-                        goto error_in;
-                    }
-                    if (!processsectors) break;  // seek only
-                    reconstructSector(sector_buffer, type);
-                    // output_edc = edc_compute(output_edc, sector_buffer, ECM_SECTOR_SIZE[type]);
-                    if (m_decoded_ecm_sectors &&
-                        m_decoded_ecm->write(sector_buffer, ECM_SECTOR_SIZE[type]) != ECM_SECTOR_SIZE[type]) {
-                        goto error_out;
-                    }
-                    break;
-                case 2:  // Mode 2 (XA), form 1
-                    b = 1;
-                    writebytecount += ECM_SECTOR_SIZE[type];
-                    if (!processsectors) {
-                        f->rSeek(0x804, SEEK_CUR);
-                        break;
-                    }  // seek only
-                    if (f->read(sector_buffer + 0x014, 0x804) != 0x804) {
-                        goto error_in;
-                    }
-                    reconstructSector(sector_buffer, type);
-                    // output_edc = edc_compute(output_edc, sector_buffer + 0x10, ECM_SECTOR_SIZE[type]);
-                    if (m_decoded_ecm_sectors &&
-                        m_decoded_ecm->write(sector_buffer + 0x10, ECM_SECTOR_SIZE[type]) != ECM_SECTOR_SIZE[type]) {
-                        goto error_out;
-                    }
-                    break;
-                case 3:  // Mode 2 (XA), form 2
-                    b = 1;
-                    writebytecount += ECM_SECTOR_SIZE[type];
-                    if (!processsectors) {
-                        f->rSeek(0x918, SEEK_CUR);
-                        break;
-                    }  // seek only
-                    if (f->read(sector_buffer + 0x014, 0x918) != 0x918) {
-                        goto error_in;
-                    }
-                    reconstructSector(sector_buffer, type);
-                    // output_edc = edc_compute(output_edc, sector_buffer + 0x10, ECM_SECTOR_SIZE[type]);
-                    if (m_decoded_ecm_sectors &&
-                        m_decoded_ecm->write(sector_buffer + 0x10, ECM_SECTOR_SIZE[type]) != ECM_SECTOR_SIZE[type]) {
-                        goto error_out;
-                    }
-                    break;
-            }
-            sectorcount = ((writebytecount / PCSX::IEC60908b::FRAMESIZE_RAW) - 0);
-            num -= b;
-        }
-        if (type && sectorcount > 0 && m_ecm_savetable[sectorcount].filepos <= ECM_HEADER_SIZE) {
-            m_ecm_savetable[sectorcount].filepos = f->rTell() /*-base*/;
-            m_ecm_savetable[sectorcount].sector = sectorcount;
-            // printf("Marked %i at pos %i\n", m_ecm_savetable[sectorcount].sector,
-            // m_ecm_savetable[sectorcount].filepos);
         }
+        // Only the first unit may start before the block, and only the last one may end after it.
+        const uint64_t from = std::max(out, blockStart);
+        const uint64_t to = std::min(out + len, blockEnd);
+        memcpy(victim->data + (from - blockStart), unit + (from - out), to - from);
+        out += len;
+    }
+
+    victim->block = block;
+    victim->lastUse = ++m_ecmUse;
+    return victim;
+}
+
+ssize_t PCSX::CDRIso::ecmDecode(IO<File> f, unsigned int base, void *dest, int sector) {
+    static constexpr uint64_t blockSize = sizeof(ECMBlock::data);
+
+    // If not pointing to ECM file but CDDA file or some other track
+    if (f != m_cdHandle) return (*this.*m_cdimg_read_func_o)(f, base, dest, sector);
+
+    uint64_t offset = base + uint64_t(sector) * IEC60908b::FRAMESIZE_RAW;
+    if ((sector < 0) || (offset >= m_ecmDecodedSize)) {
+        PCSX::g_system->printf("ECM: invalid sector %i requested\n", sector);
+        return -1;
     }
 
-    if (m_decoded_ecm_sectors) {
-        m_decoded_ecm->rSeek(-1 * PCSX::IEC60908b::FRAMESIZE_RAW, SEEK_CUR);
-        num = m_decoded_ecm->read(sector_buffer, PCSX::IEC60908b::FRAMESIZE_RAW);
-        m_decoded_ecm_sectors = std::max(m_decoded_ecm_sectors, sectorcount);
-    } else {
-        num = PCSX::IEC60908b::FRAMESIZE_RAW;
+    uint8_t *ptr = reinterpret_cast<uint8_t *>(dest);
+    size_t left = IEC60908b::FRAMESIZE_RAW;
+    while (left) {
+        ECMBlock *block = decodeECMBlock(f, offset / blockSize);
+        if (!block) {
+            PCSX::g_system->printf("Error decoding ECM image: WantedSector %i Base %i\n", sector, base);
+            return -1;
+        }
+        const size_t blockOffset = offset % blockSize;
+        const size_t len = std::min(left, size_t(blockSize - blockOffset));
+        memcpy(ptr, block->data + blockOffset, len);
+        ptr += len;
+        offset += len;
+        left -= len;
     }
 
-    memcpy(dest, sector_buffer, PCSX::IEC60908b::FRAMESIZE_RAW);
-    m_prevsector = sectorcount;
-    // printf("OK: Frame decoded %i %i\n", sectorcount-1, writebytecount);
-    return num;
-
-error_in:
-error:
-error_out:
-    // memset(dest, 0x0, PCSX::CDRomCD_FRAMESIZE_RAW);
-    PCSX::g_system->printf("Error decoding ECM image: WantedSector %i Type %i Base %i Sectors %i(%i) Pos %i(%li)\n",
-                           sector, type, base, sectorcount, pos->sector, writebytecount, f->rTell());
-    return -1;
+    return IEC60908b::FRAMESIZE_RAW;
 }
 
 bool PCSX::CDRIso::handleecm(const char *isoname, IO<File> cdh, int32_t *accurate_length) {
@@ -263,39 +309,37 @@ bool PCSX::CDRIso::handleecm(const char *isoname, IO<File> cdh, int32_t *accurat
     cdh->rSeek(0, SEEK_SET);
     if ((cdh->getc() == 'E') && (cdh->getc() == 'C') && (cdh->getc() == 'M') && (cdh->getc() == 0x00) &&
         (strncmp((isoname + strlen(isoname) - 5), ".ecm", 4))) {
-        // Function used to read CD normally
-        // TODO: detect if 2048 and use it
-        m_cdimg_read_func_o = &CDRIso::cdread_normal;
-
-        // Function used to decode ECM data
-        m_cdimg_read_func = &CDRIso::ecmDecode;
-
-        // Last accessed sector
-        m_prevsector = 0;
-
         // Already analyzed during this session, use cached results
         if (m_ecm_file_detected) {
-            if (accurate_length) *accurate_length = m_len_ecm_savetable;
+            if (accurate_length) *accurate_length = m_ecmDecodedSize / IEC60908b::FRAMESIZE_RAW;
             return 0;
         }
 
         PCSX::g_system->printf(_("\nDetected ECM file with proper header and filename suffix.\n"));
 
-        // Reserve maximum known sector ammount for LUT (80MIN CD)
-        m_len_ecm_savetable = 75 * 80 * 60;  // 2*(accurate_length/PCSX::CDRomCD_FRAMESIZE_RAW);
+        std::filesystem::path indexPath = m_isoPath;
+        indexPath += ".idx";
+        const size_t ecmSize = cdh->size();
+        if (!loadECMIndex(indexPath, ecmSize)) {
+            if (!buildECMIndex(cdh)) {
+                PCSX::g_system->printf(_("Corrupt ECM file.\n"));
+                m_ecmIndex.clear();
+                m_ecmDecodedSize = 0;
+                return false;
+            }
+            saveECMIndex(indexPath, ecmSize);
+        }
+        m_ecmCache.reset(new ECMBlock[c_ecmCachedBlocks]);
+        m_ecmUse = 0;
 
-        // Index 0 always points to beginning of ECM data
-        m_ecm_savetable = (ECMFILELUT *)calloc(m_len_ecm_savetable, sizeof(ECMFILELUT));  // calloc returns nulled data
-        m_ecm_savetable[0].filepos = ECM_HEADER_SIZE;
+        // Function used to read CD normally
+        // TODO: detect if 2048 and use it
+        m_cdimg_read_func_o = &CDRIso::cdread_normal;
 
-        if (accurate_length || m_decoded_ecm_sectors) {
-            uint8_t tbuf1[PCSX::IEC60908b::FRAMESIZE_RAW];
-            m_len_ecm_savetable = 0;             // indicates to cdread_ecm_decode that no lut has been built yet
-            ecmDecode(cdh, 0U, tbuf1, INT_MAX);  // builds LUT completely
-            if (accurate_length) *accurate_length = m_len_ecm_savetable;
-        }
+        // Function used to decode ECM data
+        m_cdimg_read_func = &CDRIso::ecmDecode;
 
-        // Full image decoded? Needs fmemopen()
+        if (accurate_length) *accurate_length = m_ecmDecodedSize / IEC60908b::FRAMESIZE_RAW;
 
         m_ecm_file_detected = true;
 
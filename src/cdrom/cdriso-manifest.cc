@@ -0,0 +1,177 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string>
+#include <vector>
+
+#include "cdrom/cdriso.h"
+
+// A sector manifest describes a disc whose sectors live in a SectorStore. It covers the whole disc as the
+// emulator reads it, from LBA 150 onwards, one digest per sector, with the sectors of the pregaps and
+// the audio tracks in there too. The store is referenced relative to the manifest's directory when possible,
+// so that a library can be moved around as a whole.
+//
+// Header, then the store path, without terminator, then the tracks, then the digests.
+
+namespace {
+
+struct ManifestHeader {
+    uint8_t magic[8];
+    uint32_t version;
+    uint32_t tracks;
+    uint32_t sectors;
+    uint32_t storePathSize;
+};
+
+struct ManifestTrack {
+    uint32_t type;
+    uint32_t start;
+    uint32_t pregap;
+    uint32_t length;
+};
+
+constexpr uint8_t c_manifestMagic[8] = {'P', 'S', 'X', 'S', 'E', 'C', 'T', 0x1a};
+constexpr uint32_t c_manifestVersion = 1;
+
+}  // namespace
+
+ssize_t PCSX::CDRIso::cdread_store(IO<File> f, unsigned int base, void *dest, int sector) {
+    const size_t index = base / IEC60908b::FRAMESIZE_RAW + sector;
+    if ((sector < 0) || (index >= m_storeSlots.size())) return -1;
+    memcpy(dest, m_sectorStore->sector(m_storeSlots[index]), IEC60908b::FRAMESIZE_RAW);
+    return IEC60908b::FRAMESIZE_RAW;
+}
+
+bool PCSX::CDRIso::handlemanifest() {
+    ManifestHeader header;
+    if (m_cdHandle->size() < sizeof(header)) return false;
+    if (m_cdHandle->readAt(&header, sizeof(header), 0) != sizeof(header)) return false;
+    if (memcmp(header.magic, c_manifestMagic, sizeof(c_manifestMagic)) != 0) return false;
+    if ((header.version != c_manifestVersion) || (header.tracks == 0) || (header.tracks >= MAXTRACKS)) {
+        PCSX::g_system->printf(_("Unsupported sector manifest.\n"));
+        return false;
+    }
+
+    size_t pos = sizeof(header);
+    std::u8string storePath(header.storePathSize, u8'\0');
+    if (m_cdHandle->readAt(storePath.data(), storePath.size(), pos) != ssize_t(storePath.size())) return false;
+    pos += storePath.size();
+    std::filesystem::path store(storePath);
+    if (store.is_relative()) store = m_isoPath.parent_path() / store;
+
+    std::vector<ManifestTrack> tracks(header.tracks);
+    size_t len = tracks.size() * sizeof(ManifestTrack);
+    if (m_cdHandle->readAt(tracks.data(), len, pos) != ssize_t(len)) return false;
+    pos += len;
+
+    std::vector<SectorStore::Digest> digests(header.sectors);
+    len = digests.size() * sizeof(SectorStore::Digest);
+    if (m_cdHandle->readAt(digests.data(), len, pos) != ssize_t(len)) return false;
+
+    auto sectorStore = std::make_unique<SectorStore>(store);
+    if (sectorStore->failed()) {
+        PCSX::g_system->printf(_("Unable to open the sector store %s.\n"), store.string());
+        return false;
+    }
+    std::vector<uint32_t> slots;
+    slots.reserve(digests.size());
+    for (auto &digest : digests) {
+        auto slot = sectorStore->find(digest);
+        if (slot < 0) {
+            PCSX::g_system->printf(_("Sector store %s is missing sector %u.\n"), store.string(), slots.size());
+            return false;
+        }
+        slots.push_back(slot);
+    }
+
+    for (unsigned i = 0; i < tracks.size(); i++) {
+        const auto &track = tracks[i];
+        if ((track.start < 150) || ((track.start - 150 + uint64_t(track.length)) > header.sectors)) return false;
+        auto &ti = m_ti[i + 1];
+        ti.type = track.type == uint32_t(TrackType::CDDA) ? TrackType::CDDA : TrackType::DATA;
+        ti.start = IEC60908b::MSF(track.start);
+        ti.pregap = IEC60908b::MSF(track.pregap);
+        ti.length = IEC60908b::MSF(track.length);
+        ti.handle = m_cdHandle;
+        ti.cddatype = ti.type == TrackType::CDDA ? trackinfo::BIN : trackinfo::NONE;
+        ti.start_offset = (track.start - 150) * IEC60908b::FRAMESIZE_RAW;
+    }
+    m_numtracks = tracks.size();
+
+    m_sectorStore = std::move(sectorStore);
+    m_storeSlots = std::move(slots);
+    m_cdimg_read_func = &CDRIso::cdread_store;
+
+    return true;
+}
+
+bool PCSX::CDRIso::exportManifest(SectorStore &store, const std::filesystem::path &manifest) {
+    if (failed() || store.failed()) return false;
+
+    const uint32_t end = getLength(0).toLBA();
+    std::vector<SectorStore::Digest> digests;
+    digests.reserve(end - 150);
+    uint8_t buffer[IEC60908b::FRAMESIZE_RAW];
+    IEC60908b::Sub sub;
+    for (uint32_t lba = 150; lba < end; lba++) {
+        unsigned track;
+        for (track = m_numtracks; track > 1; track--) {
+            if (m_ti[track].start.toLBA() <= lba) break;
+        }
+        bool ret;
+        if (m_ti[track].type == TrackType::DATA) {
+            bool subMissing;
+            std::lock_guard<std::mutex> lock(m_decoderMutex);
+            ret = readSectorLocked(IEC60908b::MSF(lba), buffer, &sub, subMissing);
+        } else {
+            ret = readCDDA(IEC60908b::MSF(lba), buffer);
+        }
+        if (!ret) memset(buffer, 0, sizeof(buffer));
+        digests.push_back(store.add(buffer));
+        if (store.failed()) return false;
+    }
+
+    std::error_code ec;
+    auto base = std::filesystem::absolute(manifest, ec).parent_path();
+    auto storePath = std::filesystem::relative(std::filesystem::absolute(store.path(), ec), base, ec);
+    if (ec || storePath.empty()) storePath = std::filesystem::absolute(store.path(), ec);
+    const auto storePathString = storePath.u8string();
+
+    IO<File> out(new PosixFile(manifest, FileOps::TRUNCATE));
+    if (out->failed()) return false;
+
+    ManifestHeader header;
+    memcpy(header.magic, c_manifestMagic, sizeof(c_manifestMagic));
+    header.version = c_manifestVersion;
+    header.tracks = getTN();
+    header.sectors = digests.size();
+    header.storePathSize = storePathString.size();
+    out->write(&header, sizeof(header));
+    out->write(storePathString.data(), storePathString.size());
+    for (unsigned i = 1; i <= header.tracks; i++) {
+        ManifestTrack track;
+        track.type = uint32_t(m_ti[i].type);
+        track.start = m_ti[i].start.toLBA();
+        track.pregap = m_ti[i].pregap.toLBA();
+        track.length = m_ti[i].length.toLBA();
+        out->write(&track, sizeof(track));
+    }
+    const size_t len = digests.size() * sizeof(SectorStore::Digest);
+    return out->write(digests.data(), len) == ssize_t(len);
+}
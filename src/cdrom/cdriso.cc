@@ -19,6 +19,7 @@
 
 #include "cdrom/cdriso.h"
 
+#include "cdrom/iso9660-reader.h"
 #include "supportpsx/iec-60908b.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -65,7 +66,7 @@
 // ECC:   Error Correction Code
 //
 
-PCSX::CDRIso::CDRIso() {
+PCSX::CDRIso::CDRIso() : m_pathIndex(std::make_shared<ISO9660PathIndex>()) {
     m_zstr.next_in = Z_NULL;
     m_zstr.avail_in = 0;
     m_zstr.zalloc = Z_NULL;
@@ -122,7 +123,7 @@ ssize_t PCSX::CDRIso::cdread_sub_mixed(IO<File> f, unsigned int base, void *dest
     f->readAt(m_subbuffer.raw, IEC60908b::SUB_FRAMESIZE,
               base + sector * (IEC60908b::FRAMESIZE_RAW + IEC60908b::SUB_FRAMESIZE) + IEC60908b::FRAMESIZE_RAW);
 
-    if (m_subChanRaw) decodeRawSubData();
+    if (m_subChanRaw) decodeRawSubData(&m_subbuffer);
 
     return ret;
 }
@@ -144,21 +145,37 @@ static int uncompress2_internal(void *out, unsigned long *out_size, void *in, un
     return ret == 1 ? 0 : ret;
 }
 
+void PCSX::CDRIso::initCompressedCache() {
+    const int blocks = std::clamp(g_emulator->settings.get<Emulator::SettingCompressedCacheBlocks>().value, 1, 1024);
+    m_compr_img->cache.resize(blocks);
+    m_compr_img->use_counter = 0;
+    m_comprStats = {};
+}
+
 ssize_t PCSX::CDRIso::cdread_compressed(IO<File> f, unsigned int base, void *dest, int sector) {
     unsigned long cdbuffer_size, cdbuffer_size_expect;
     unsigned int start_byte, size;
     int is_compressed;
-    int ret, block;
+    int ret, sector_in_blk;
+    unsigned int block;
 
     if (base) sector += base / 2352;
 
     block = sector >> m_compr_img->block_shift;
-    m_compr_img->sector_in_blk = sector & ((1 << m_compr_img->block_shift) - 1);
-
-    if (block == m_compr_img->current_block) {
-        // printf("hit sect %d\n", sector);
-        goto finish;
+    sector_in_blk = sector & ((1 << m_compr_img->block_shift) - 1);
+
+    // looking for the block in the cache, and for the least recently used one otherwise
+    auto *cached = &m_compr_img->cache[0];
+    for (auto &b : m_compr_img->cache) {
+        if (b.block == block) {
+            m_comprStats.hits++;
+            b.last_use = ++m_compr_img->use_counter;
+            memcpy(dest, b.raw[sector_in_blk], IEC60908b::FRAMESIZE_RAW);
+            return IEC60908b::FRAMESIZE_RAW;
+        }
+        if (b.last_use < cached->last_use) cached = &b;
     }
+    m_comprStats.misses++;
 
     if (sector >= m_compr_img->index_len * 16) {
         PCSX::g_system->printf("sector %d is past img end\n", sector);
@@ -166,30 +183,27 @@ ssize_t PCSX::CDRIso::cdread_compressed(IO<File> f, unsigned int base, void *des
     }
 
     start_byte = m_compr_img->index_table[block] & 0x7fffffff;
-    if (m_cdHandle->rSeek(start_byte, SEEK_SET) != 0) {
-        PCSX::g_system->printf("seek error for block %d at %x: ", block, start_byte);
-        perror(NULL);
-        return -1;
-    }
-
     is_compressed = !(m_compr_img->index_table[block] & 0x80000000);
     size = (m_compr_img->index_table[block + 1] & 0x7fffffff) - start_byte;
-    if (size > sizeof(m_compr_img->buff_compressed)) {
+    // Uncompressed blocks go straight into the cache slot, which is a bit smaller than the compressed buffer
+    const size_t capacity = is_compressed ? sizeof(m_compr_img->buff_compressed) : sizeof(cached->raw);
+    if (size > capacity) {
         PCSX::g_system->printf("block %d is too large: %u\n", block, size);
         return -1;
     }
 
-    if (m_cdHandle->read(is_compressed ? m_compr_img->buff_compressed : m_compr_img->buff_raw[0], size) != size) {
+    // the slot is getting overwritten, so it can't be trusted anymore until the block is complete
+    cached->block = ~0u;
+    if (m_cdHandle->readAt(is_compressed ? m_compr_img->buff_compressed : cached->raw[0], size, start_byte) != size) {
         PCSX::g_system->printf("read error for block %d at %x: ", block, start_byte);
         perror(NULL);
         return -1;
     }
 
     if (is_compressed) {
-        cdbuffer_size_expect = sizeof(m_compr_img->buff_raw[0]) << m_compr_img->block_shift;
+        cdbuffer_size_expect = sizeof(cached->raw[0]) << m_compr_img->block_shift;
         cdbuffer_size = cdbuffer_size_expect;
-        ret =
-            uncompress2_internal(m_compr_img->buff_raw[0], &cdbuffer_size, m_compr_img->buff_compressed, size, &m_zstr);
+        ret = uncompress2_internal(cached->raw[0], &cdbuffer_size, m_compr_img->buff_compressed, size, &m_zstr);
         if (ret != 0) {
             PCSX::g_system->printf("uncompress failed with %d for block %d, sector %d\n", ret, block, sector);
             return -1;
@@ -197,14 +211,14 @@ ssize_t PCSX::CDRIso::cdread_compressed(IO<File> f, unsigned int base, void *des
         if (cdbuffer_size != cdbuffer_size_expect)
             PCSX::g_system->printf("cdbuffer_size: %lu != %lu, sector %d\n", cdbuffer_size, cdbuffer_size_expect,
                                    sector);
+        m_comprStats.inflatedBytes += cdbuffer_size;
     }
 
     // done at last!
-    m_compr_img->current_block = block;
+    cached->block = block;
+    cached->last_use = ++m_compr_img->use_counter;
 
-finish:
-    if (dest != m_cdbuffer)  // copy avoid HACK
-        memcpy(dest, m_compr_img->buff_raw[m_compr_img->sector_in_blk], IEC60908b::FRAMESIZE_RAW);
+    memcpy(dest, cached->raw[sector_in_blk], IEC60908b::FRAMESIZE_RAW);
     return IEC60908b::FRAMESIZE_RAW;
 }
 
@@ -227,24 +241,18 @@ ssize_t PCSX::CDRIso::cdread_2048(IO<File> f, unsigned int base, void *dest_, in
     dest[10] = 0xff;
     dest[11] = 0x00;
     IEC60908b::MSF(sector + 150).toBCD(dest + 12);
-    m_cdbuffer[15] = 2;
-    m_cdbuffer[16] = m_cdbuffer[20] = 0;
-    m_cdbuffer[17] = m_cdbuffer[21] = 0;
-    m_cdbuffer[18] = m_cdbuffer[22] = 8;
-    m_cdbuffer[19] = m_cdbuffer[23] = 0;
+    dest[15] = 2;
+    dest[16] = dest[20] = 0;
+    dest[17] = dest[21] = 0;
+    dest[18] = dest[22] = 8;
+    dest[19] = dest[23] = 0;
 
-    IEC60908b::computeEDCECC(m_cdbuffer);
+    IEC60908b::computeEDCECC(dest);
 
     return ret;
 }
 
-uint8_t *PCSX::CDRIso::getBuffer() {
-    if (m_useCompressed) {
-        return m_compr_img->buff_raw[m_compr_img->sector_in_blk] + 12;
-    } else {
-        return m_cdbuffer + 12;
-    }
-}
+const uint8_t *PCSX::CDRIso::getBuffer() { return m_sectorData + 12; }
 
 void PCSX::CDRIso::printTracks() {
     for (int i = 1; i <= m_numtracks; i++) {
@@ -283,7 +291,9 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         i = {};
     }
 
-    if (parsecue(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
+    if (handlemanifest()) {
+        PCSX::g_system->printf("[+manifest]");
+    } else if (parsecue(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
         PCSX::g_system->printf("[+cue]");
     } else if (parsetoc(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
         PCSX::g_system->printf("[+toc]");
@@ -297,10 +307,12 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         PCSX::g_system->printf("[pbp]");
         m_useCompressed = true;
         m_cdimg_read_func = &CDRIso::cdread_compressed;
+        initCompressedCache();
     } else if (handlecbin(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
         PCSX::g_system->printf("[cbin]");
         m_useCompressed = true;
         m_cdimg_read_func = &CDRIso::cdread_compressed;
+        initCompressedCache();
     } else if ((handleecm(reinterpret_cast<const char *>(m_isoPath.string().c_str()), m_cdHandle, NULL))) {
         PCSX::g_system->printf("[+ecm]");
     }
@@ -312,7 +324,7 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         PCSX::g_system->printf("[+sbi]");
     }
 
-    if (!m_ecm_file_detected) {
+    if (!m_ecm_file_detected && !m_sectorStore) {
         // guess whether it is mode1/2048
         if (m_cdHandle->size() % 2048 == 0) {
             unsigned int modeTest = m_cdHandle->readAt<uint32_t>(0);
@@ -331,7 +343,7 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         m_ti[1].start = IEC60908b::MSF(0, 2, 0);
         m_ti[1].pregap = IEC60908b::MSF(0, 0, 0);
         m_ti[1].handle = m_cdHandle;
-        m_ti[1].length = IEC60908b::MSF(m_ti[1].handle->size() / 2352);
+        m_ti[1].length = IEC60908b::MSF((m_ecm_file_detected ? m_ecmDecodedSize : m_ti[1].handle->size()) / 2352);
     }
 
     if (m_ppf.load(m_isoPath)) {
@@ -347,6 +359,20 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         m_cdimg_read_func = &CDRIso::cdread_2048;
     }
 
+    // Plain raw images can be read straight out of a mapping of the file, letting the OS page cache do the rest
+    if ((m_cdimg_read_func == &CDRIso::cdread_normal) && m_cdHandle.isA<UvFile>() &&
+        !g_emulator->settings.get<Emulator::SettingFullCaching>()) {
+        IO<File> mapped(new MmapFile(m_cdHandle->filename()));
+        if (!mapped->failed() && (mapped->size() == m_cdHandle->size())) {
+            for (auto &track : m_ti) {
+                if (track.handle == m_cdHandle) track.handle = mapped;
+            }
+            m_cdHandle = mapped;
+            m_mappedImage = mapped.asA<MmapFile>()->data();
+            PCSX::g_system->printf("Mapped CD Image in memory.\n");
+        }
+    }
+
     // make sure we have another handle open for cdda
     if (m_numtracks > 1 && !m_ti[1].handle) {
         m_ti[1].handle.setFile(new UvFile(m_isoPath));
@@ -359,12 +385,16 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
 }
 
 void PCSX::CDRIso::close() {
+    stopReadAhead();
+    stopCDDAReadAhead();
+    m_sectorData = m_cdbuffer;
+    m_mappedImage = nullptr;
     m_cdHandle.reset();
     m_subHandle.reset();
 
     if (m_compr_img) {
         free(m_compr_img->index_table);
-        free(m_compr_img);
+        delete m_compr_img;
         m_compr_img = nullptr;
     }
 
@@ -379,15 +409,12 @@ void PCSX::CDRIso::close() {
 
     memset(m_cdbuffer, 0, sizeof(m_cdbuffer));
     m_useCompressed = false;
-    // ECM LUT
-    free(m_ecm_savetable);
-    m_ecm_savetable = nullptr;
-
-    if (m_decoded_ecm) {
-        m_decoded_ecm.reset();
-        free(m_decoded_ecm_buffer);
-        m_decoded_ecm_buffer = nullptr;
-    }
+    m_sectorStore.reset();
+    m_storeSlots.clear();
+    // ECM index
+    m_ecmIndex.clear();
+    m_ecmCache.reset();
+    m_ecmDecodedSize = 0;
     m_ecm_file_detected = false;
 }
 
@@ -424,48 +451,183 @@ PCSX::IEC60908b::MSF PCSX::CDRIso::getPregap(uint8_t track) {
 
 // Decode 'raw' subchannel data from being packed bitwise.
 // Essentially is a bitwise matrix transposition.
-void PCSX::CDRIso::decodeRawSubData() {
+void PCSX::CDRIso::decodeRawSubData(IEC60908b::Sub *sub) {
     unsigned char subQData[12];
     memset(subQData, 0, sizeof(subQData));
 
     for (int i = 0; i < 8 * 12; i++) {
-        if (m_subbuffer.raw[i] & (1 << 6)) {  // only subchannel Q is needed
+        if (sub->raw[i] & (1 << 6)) {  // only subchannel Q is needed
             subQData[i >> 3] |= (1 << (7 - (i & 7)));
         }
     }
 
-    memcpy(&m_subbuffer.Q, subQData, 12);
+    memcpy(&sub->Q, subQData, 12);
+}
+
+// Images don't contain the pregap of the track following the data track, so the sectors past it are
+// shifted back, and there's no subchannel data to return for the pregap itself.
+int PCSX::CDRIso::imageSector(uint32_t lba, bool &subMissing) const {
+    int sector = lba - 150;
+    subMissing = false;
+    if (m_pregapOffset) {
+        if (sector >= m_pregapOffset) {
+            sector -= 2 * 75;
+            if (sector < m_pregapOffset) subMissing = true;
+        }
+    }
+    return sector;
+}
+
+void PCSX::CDRIso::readSubchannel(int sector, IEC60908b::Sub *sub) {
+    if (m_subHandle) {
+        m_subHandle->readAt(sub->raw, IEC60908b::SUB_FRAMESIZE, sector * IEC60908b::SUB_FRAMESIZE);
+
+        if (m_subChanRaw) decodeRawSubData(sub);
+    }
+}
+
+// Reads a data track sector, and its subchannel data when it's in a separate file. Needs m_decoderMutex.
+bool PCSX::CDRIso::readSectorLocked(const IEC60908b::MSF time, uint8_t *dest, IEC60908b::Sub *sub,
+                                    bool &subMissing) {
+    const int sector = imageSector(time.toLBA(), subMissing);
+
+    long ret = (*this.*m_cdimg_read_func)(m_cdHandle, 0, dest, sector);
+    if (ret < 0) return false;
+
+    readSubchannel(sector, sub);
+    m_ppf.maybePatchSector(dest, time);
+
+    return true;
 }
 
 // read track
 bool PCSX::CDRIso::readTrack(const IEC60908b::MSF time) {
-    int sector = time.toLBA() - 150;
-    long ret;
-
     if (!m_cdHandle || m_cdHandle->failed()) {
         return false;
     }
-    if (m_pregapOffset) {
-        m_subChanMissing = false;
-        if (sector >= m_pregapOffset) {
-            sector -= 2 * 75;
-            if (sector < m_pregapOffset) m_subChanMissing = true;
+
+    const uint32_t lba = time.toLBA();
+
+    // Mapped images need neither decoding nor copying, unless the sector has to be patched
+    if (m_mappedImage) {
+        const int sector = imageSector(lba, m_subChanMissing);
+        if ((sector < 0) || ((sector + 1) * size_t(IEC60908b::FRAMESIZE_RAW) > m_cdHandle->size())) return false;
+        m_sectorData = m_mappedImage + sector * size_t(IEC60908b::FRAMESIZE_RAW);
+        readSubchannel(sector, &m_subbuffer);
+        if (m_ppf.hasPatch(time)) {
+            memcpy(m_cdbuffer, m_sectorData, sizeof(m_cdbuffer));
+            m_ppf.maybePatchSector(m_cdbuffer, time);
+            m_sectorData = m_cdbuffer;
         }
+        return true;
     }
 
-    ret = (*this.*m_cdimg_read_func)(m_cdHandle, 0, m_cdbuffer, sector);
-    if (ret < 0) return false;
+    m_sectorData = m_cdbuffer;
+    const bool readAhead = readAheadEnabled();
+    if (readAhead) {
+        std::unique_lock<std::mutex> lock(m_readAheadMutex);
+        if (!m_readAheadThread.joinable()) {
+            m_readAheadThread = std::thread([this, emulator = g_emulator, system = g_system]() {
+                Emulator::Scope scope(emulator, system);
+                readAheadMain();
+            });
+        }
+        const auto &slot = m_readAhead[lba % c_readAheadSectors];
+        if (slot.lba == lba) {
+            memcpy(m_cdbuffer, slot.data, sizeof(m_cdbuffer));
+            m_subbuffer = slot.sub;
+            m_subChanMissing = slot.subMissing;
+            scheduleReadAhead(lba + 1);
+            return true;
+        }
+        // Not prefetched yet, so we're going to read it ourselves. Keep the worker out of the way meanwhile.
+        m_readAheadNext = m_readAheadEnd;
+    }
 
-    if (m_subHandle) {
-        m_subHandle->rSeek(sector * IEC60908b::SUB_FRAMESIZE, SEEK_SET);
-        m_subHandle->read(m_subbuffer.raw, IEC60908b::SUB_FRAMESIZE);
+    bool ret;
+    {
+        std::lock_guard<std::mutex> lock(m_decoderMutex);
+        ret = readSectorLocked(time, m_cdbuffer, &m_subbuffer, m_subChanMissing);
+    }
 
-        if (m_subChanRaw) decodeRawSubData();
+    if (ret && readAhead) {
+        std::lock_guard<std::mutex> lock(m_readAheadMutex);
+        scheduleReadAhead(lba + 1);
     }
 
-    m_ppf.maybePatchSector(m_cdbuffer, time);
+    return ret;
+}
 
-    return true;
+// Sectors mixing subchannel data in the main file get decoded into m_subbuffer directly, which the
+// emulation reads at any time. Preloaded and mapped images are already in memory.
+bool PCSX::CDRIso::readAheadEnabled() {
+    return !m_subChanMixed && !m_mappedImage && g_emulator->settings.get<Emulator::SettingCDReadAhead>() &&
+           !g_emulator->settings.get<Emulator::SettingFullCaching>();
+}
+
+// Needs m_readAheadMutex. The sectors already in the ring get skipped by the worker.
+void PCSX::CDRIso::scheduleReadAhead(uint32_t lba) {
+    m_readAheadNext = lba;
+    m_readAheadEnd = lba + c_readAheadSectors;
+    m_readAheadCV.notify_one();
+
+    if ((lba >= m_prefetchStart) && ((lba + c_readAheadSectors) <= m_prefetchEnd)) return;
+    size_t sectorSize = 0;
+    if (m_cdimg_read_func == &CDRIso::cdread_normal) sectorSize = IEC60908b::FRAMESIZE_RAW;
+    if (m_cdimg_read_func == &CDRIso::cdread_2048) sectorSize = 2048;
+    m_prefetchStart = lba;
+    m_prefetchEnd = lba + c_prefetchSectors;
+    bool subMissing;
+    const int sector = imageSector(lba, subMissing);
+    if ((sectorSize != 0) && (sector >= 0)) m_cdHandle->prefetch(sector * sectorSize, c_prefetchSectors * sectorSize);
+}
+
+void PCSX::CDRIso::cancelReadAhead() {
+    std::lock_guard<std::mutex> lock(m_readAheadMutex);
+    m_readAheadNext = m_readAheadEnd;
+}
+
+void PCSX::CDRIso::stopReadAhead() {
+    if (m_readAheadThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_readAheadMutex);
+            m_readAheadExit = true;
+        }
+        m_readAheadCV.notify_one();
+        m_readAheadThread.join();
+        m_readAheadExit = false;
+    }
+    for (auto &slot : m_readAhead) slot.lba = ~0u;
+    m_readAheadNext = m_readAheadEnd = 0;
+    m_prefetchStart = m_prefetchEnd = 0;
+}
+
+void PCSX::CDRIso::readAheadMain() {
+    std::unique_lock<std::mutex> lock(m_readAheadMutex);
+    while (true) {
+        m_readAheadCV.wait(lock, [this]() { return m_readAheadExit || (m_readAheadNext < m_readAheadEnd); });
+        if (m_readAheadExit) return;
+        const uint32_t lba = m_readAheadNext++;
+        if (m_readAhead[lba % c_readAheadSectors].lba == lba) continue;
+
+        lock.unlock();
+        bool ret;
+        {
+            std::lock_guard<std::mutex> decoder(m_decoderMutex);
+            ret = readSectorLocked(IEC60908b::MSF(lba), m_readAheadStaging.data, &m_readAheadStaging.sub,
+                                   m_readAheadStaging.subMissing);
+        }
+        lock.lock();
+
+        // Most likely the end of the image, there's no point in trying the next ones
+        if (!ret) {
+            m_readAheadNext = m_readAheadEnd;
+            continue;
+        }
+        auto &slot = m_readAhead[lba % c_readAheadSectors];
+        slot = m_readAheadStaging;
+        slot.lba = lba;
+    }
 }
 
 unsigned PCSX::CDRIso::readSectors(uint32_t lba, void *buffer_, unsigned count) {
@@ -480,6 +642,7 @@ unsigned PCSX::CDRIso::readSectors(uint32_t lba, void *buffer_, unsigned count)
         auto ptr = buffer + actual * IEC60908b::FRAMESIZE_RAW;
         if (lba < m_ti[1].length.toLBA()) {
             IEC60908b::MSF time(lba + 150);
+            std::lock_guard<std::mutex> lock(m_decoderMutex);
             long ret = (*this.*m_cdimg_read_func)(m_cdHandle, 0, ptr, lba++);
             m_ppf.maybePatchSector(ptr, time);
             if (ret < 0) return actual;
@@ -501,19 +664,98 @@ const PCSX::IEC60908b::Sub *PCSX::CDRIso::getBufferSub() {
     return nullptr;
 }
 
+unsigned PCSX::CDRIso::cddaTrack(uint32_t lba) const {
+    unsigned track;
+    for (track = m_numtracks;; track--) {
+        if (m_ti[track].start.toLBA() <= lba) break;
+        if (track == 1) break;
+    }
+    return track;
+}
+
+unsigned PCSX::CDRIso::cddaLookahead(uint32_t lba) const {
+    const auto &ti = m_ti[cddaTrack(lba)];
+    if ((ti.type != TrackType::CDDA) || (ti.cddatype != trackinfo::CCDDA)) return 0;
+    return std::clamp(g_emulator->settings.get<Emulator::SettingCDDALookahead>().value, 0, 600);
+}
+
 // read CDDA sector into buffer
 bool PCSX::CDRIso::readCDDA(IEC60908b::MSF msf, unsigned char *buffer) {
-    unsigned int file, track, track_start = 0;
-    int ret;
+    const uint32_t lba = msf.toLBA();
+    const unsigned lookahead = cddaLookahead(lba);
+    if (lookahead == 0) return readCDDASector(lba, buffer);
+
+    std::unique_lock<std::mutex> lock(m_cddaMutex);
+    if (!m_cddaThread.joinable()) {
+        m_cddaThread = std::thread([this, emulator = g_emulator, system = g_system]() {
+            Emulator::Scope scope(emulator, system);
+            cddaReadAheadMain();
+        });
+    }
+    if (m_cddaRing.size() != lookahead) m_cddaRing.assign(lookahead, {});
+    bool ret = true;
+    const auto &slot = m_cddaRing[lba % m_cddaRing.size()];
+    if (slot.lba == lba) {
+        memcpy(buffer, slot.data, IEC60908b::FRAMESIZE_RAW);
+    } else {
+        // Not decoded yet, which happens when starting to play, or after a seek. Keep the worker out of the
+        // way while decoding it ourselves.
+        m_cddaNext = m_cddaEnd;
+        lock.unlock();
+        ret = readCDDASector(lba, buffer);
+        lock.lock();
+    }
+    m_cddaNext = lba + 1;
+    m_cddaEnd = lba + 1 + m_cddaRing.size();
+    m_cddaCV.notify_one();
+    return ret;
+}
 
-    uint32_t lba = msf.toLBA();
+void PCSX::CDRIso::stopCDDAReadAhead() {
+    if (m_cddaThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_cddaMutex);
+            m_cddaExit = true;
+        }
+        m_cddaCV.notify_one();
+        m_cddaThread.join();
+        m_cddaExit = false;
+    }
+    m_cddaRing.clear();
+    m_cddaNext = m_cddaEnd = 0;
+}
 
-    // find current track index
-    for (track = m_numtracks;; track--) {
-        track_start = m_ti[track].start.toLBA();
-        if (track_start <= lba) break;
-        if (track == 1) break;
+void PCSX::CDRIso::cddaReadAheadMain() {
+    std::unique_lock<std::mutex> lock(m_cddaMutex);
+    while (true) {
+        m_cddaCV.wait(lock, [this]() { return m_cddaExit || (m_cddaNext < m_cddaEnd); });
+        if (m_cddaExit) return;
+        const uint32_t lba = m_cddaNext++;
+        if (m_cddaRing.empty() || (m_cddaRing[lba % m_cddaRing.size()].lba == lba)) continue;
+
+        lock.unlock();
+        uint8_t data[IEC60908b::FRAMESIZE_RAW];
+        const bool ret = readCDDASector(lba, data);
+        lock.lock();
+
+        if (!ret) {
+            m_cddaNext = m_cddaEnd;
+            continue;
+        }
+        // The ring may have been resized meanwhile.
+        if (m_cddaRing.empty()) continue;
+        auto &slot = m_cddaRing[lba % m_cddaRing.size()];
+        memcpy(slot.data, data, sizeof(data));
+        slot.lba = lba;
     }
+}
+
+bool PCSX::CDRIso::readCDDASector(uint32_t lba, unsigned char *buffer) {
+    unsigned int file;
+    int ret;
+
+    const unsigned track = cddaTrack(lba);
+    const uint32_t track_start = m_ti[track].start.toLBA();
 
     // data tracks play silent
     if (m_ti[track].type != TrackType::CDDA) {
@@ -535,7 +777,10 @@ bool PCSX::CDRIso::readCDDA(IEC60908b::MSF msf, unsigned char *buffer) {
         }
     }
 
-    ret = (*this.*m_cdimg_read_func)(m_ti[file].handle, m_ti[track].start_offset, buffer, lba - track_start);
+    {
+        std::lock_guard<std::mutex> lock(m_decoderMutex);
+        ret = (*this.*m_cdimg_read_func)(m_ti[file].handle, m_ti[track].start_offset, buffer, lba - track_start);
+    }
     if (ret != IEC60908b::FRAMESIZE_RAW) {
         memset(buffer, 0, IEC60908b::FRAMESIZE_RAW);
         return false;
@@ -554,4 +799,4 @@ bool PCSX::CDRIso::readCDDA(IEC60908b::MSF msf, unsigned char *buffer) {
     return true;
 }
 
-bool PCSX::CDRIso::failed() { return !m_cdHandle && !m_ecm_savetable && !m_decoded_ecm; }
+bool PCSX::CDRIso::failed() { return !m_cdHandle; }
@@ -22,20 +22,36 @@
 #include <stdio.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <condition_variable>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "cdrom/ppf.h"
+#include "cdrom/sectorstore.h"
 #include "core/psxemulator.h"
+#include "support/mmapfile.h"
 #include "support/uvfile.h"
 #include "supportpsx/iec-60908b.h"
 
 namespace PCSX {
 
+struct ISO9660PathIndex;
+
 class CDRIso {
   public:
-    CDRIso(const std::filesystem::path& path) : CDRIso() {
+    // The disc to pick, for images which hold several, such as multi-disc PBPs.
+    CDRIso(const std::filesystem::path& path, unsigned multidiskSelect = 0) : CDRIso() {
         m_isoPath = path;
-        open(new UvFile(m_isoPath));
+        m_cdrIsoMultidiskSelect = multidiskSelect;
+        if (UvHttpFile::isUrl(m_isoPath.string())) {
+            open(new UvHttpFile(m_isoPath.string()));
+        } else {
+            open(new UvFile(m_isoPath));
+        }
     }
     CDRIso(IO<File> isoFile) : CDRIso() {
         m_isoPath = isoFile->filename();
@@ -53,16 +69,35 @@ class CDRIso {
     IEC60908b::MSF getLength(uint8_t track);
     IEC60908b::MSF getPregap(uint8_t track);
     bool readTrack(const IEC60908b::MSF time);
+    // Stops prefetching the sectors following the last readTrack, for when the drive is about to move elsewhere
+    void cancelReadAhead();
     unsigned readSectors(uint32_t lba, void* buffer, unsigned count);
-    uint8_t* getBuffer();
+    const uint8_t* getBuffer();
     const IEC60908b::Sub* getBufferSub();
     bool readCDDA(const IEC60908b::MSF msf, unsigned char* buffer);
     PPF* getPPF() { return &m_ppf; }
+    std::shared_ptr<ISO9660PathIndex> getPathIndex() { return m_pathIndex; }
+
+    // Block cache statistics for compressed images, since they got opened.
+    struct CompressedStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inflatedBytes = 0;
+    };
+    bool isCompressed() { return m_useCompressed; }
+    CompressedStats getCompressedStats() {
+        std::lock_guard<std::mutex> lock(m_decoderMutex);
+        return m_comprStats;
+    }
 
     bool failed();
 
-    unsigned m_cdrIsoMultidiskCount;
-    unsigned m_cdrIsoMultidiskSelect;
+    // Adds all the sectors of the disc to the store, and writes a manifest for it, which can then be opened
+    // like any other disc image.
+    bool exportManifest(SectorStore& store, const std::filesystem::path& manifest);
+
+    unsigned m_cdrIsoMultidiskCount = 1;
+    unsigned m_cdrIsoMultidiskSelect = 0;
 
     bool CheckSBI(const uint8_t* time);
 
@@ -72,6 +107,7 @@ class CDRIso {
     void close();
 
     std::filesystem::path m_isoPath;
+    std::shared_ptr<ISO9660PathIndex> m_pathIndex;
     typedef ssize_t (CDRIso::*read_func_t)(IO<File> f, unsigned int base, void* dest, int sector);
 
     bool m_useCompressed = false;
@@ -88,6 +124,10 @@ class CDRIso {
     bool m_isMode1ISO = false;  // TODO: use sector size/mode info from CUE also?
 
     uint8_t m_cdbuffer[2352];
+    // Where the last sector read by readTrack is. Usually m_cdbuffer, but raw images which could be mapped
+    // in memory get read directly from m_mappedImage.
+    const uint8_t* m_sectorData = m_cdbuffer;
+    const uint8_t* m_mappedImage = nullptr;
     IEC60908b::Sub m_subbuffer;
 
     bool m_cddaBigEndian = false;
@@ -98,40 +138,60 @@ class CDRIso {
     unsigned int m_pregapOffset;
 
     // compressed image stuff
+    // Games seeking back and forth between a few areas of the disc would keep inflating the same blocks,
+    // so the last SettingCompressedCacheBlocks of them are kept. The read ahead thread covers the next
+    // block, as its window always reaches into it.
     struct compr_img_t {
-        unsigned char buff_raw[16][2352];
+        struct block_t {
+            unsigned int block = ~0u;
+            uint32_t last_use = 0;
+            unsigned char raw[16][2352];
+        };
+        std::vector<block_t> cache;
+        uint32_t use_counter = 0;
         unsigned char buff_compressed[2352 * 16 + 100];
-        unsigned int* index_table;
-        unsigned int index_len;
-        unsigned int block_shift;
-        unsigned int current_block;
-        unsigned int sector_in_blk;
+        unsigned int* index_table = nullptr;
+        unsigned int index_len = 0;
+        unsigned int block_shift = 0;
     }* m_compr_img = nullptr;
+    CompressedStats m_comprStats;
+    void initCompressedCache();
 
     read_func_t m_cdimg_read_func = nullptr;
 
-    uint32_t m_len_decoded_ecm_buffer = 0;  // same as decoded ECM file length or 2x size
-    uint32_t m_len_ecm_savetable = 0;       // same as sector count of decoded ECM file or 2x count
-
-    uint32_t m_decoded_ecm_sectors = 0;  // disabled
-
     bool m_ecm_file_detected = false;
-    uint32_t m_prevsector;
-
-    IO<File> m_decoded_ecm = nullptr;
-    void* m_decoded_ecm_buffer = nullptr;
 
     // Function that is used to read CD normally
     read_func_t m_cdimg_read_func_o = nullptr;
 
-    struct ECMFILELUT {
-        int32_t sector;
-        int32_t filepos;
+    // ECM images are read through a sparse index, holding one checkpoint per block of c_ecmBlockSectors
+    // decoded sectors: the state of the decoder at the unit covering the start of the block. It is built
+    // with a single pass over the record headers, and saved next to the image, so this only ever happens
+    // once. Reading a sector then only decodes its block, and the last few decoded blocks are kept around.
+    static constexpr unsigned c_ecmBlockSectors = 16;
+    static constexpr unsigned c_ecmCachedBlocks = 8;
+    struct ECMCheckpoint {
+        uint64_t outPos;     // decoded offset of the unit
+        uint32_t filePos;    // offset of the unit's payload in the ECM file
+        uint32_t remaining;  // units left in the record, including this one
+        uint32_t type;
+    };
+    struct ECMBlock {
+        uint32_t block = ~0u;
+        uint32_t lastUse = 0;
+        uint8_t data[c_ecmBlockSectors * IEC60908b::FRAMESIZE_RAW];
     };
+    std::vector<ECMCheckpoint> m_ecmIndex;
+    std::unique_ptr<ECMBlock[]> m_ecmCache;
+    uint32_t m_ecmUse = 0;
+    uint64_t m_ecmDecodedSize = 0;
 
-    ECMFILELUT* m_ecm_savetable = nullptr;
+    // Disc images mounted from a sector manifest, and which slot of the store each of their sectors is in.
+    std::unique_ptr<SectorStore> m_sectorStore;
+    std::vector<uint32_t> m_storeSlots;
 
     static inline const size_t ECM_SECTOR_SIZE[4] = {1, 2352, 2336, 2336};
+    static inline const size_t ECM_UNIT_SIZE[4] = {1, 0x803, 0x804, 0x918};
     static inline const uint8_t ZEROADDRESS[4] = {0, 0, 0, 0};
 
     struct trackinfo {
@@ -153,14 +213,71 @@ class CDRIso {
     uint8_t sbitime[256][3], sbicount;
     PPF m_ppf;
 
-    void decodeRawSubData();
+    void decodeRawSubData(IEC60908b::Sub* sub);
+    int imageSector(uint32_t lba, bool& subMissing) const;
+    void readSubchannel(int sector, IEC60908b::Sub* sub);
+    bool readSectorLocked(const IEC60908b::MSF time, uint8_t* dest, IEC60908b::Sub* sub, bool& subMissing);
+
+    // While the emulation reads the data track, a worker thread decodes the sectors that follow, so that the
+    // image reads, which may be slow on network shares, don't stall the emulation. The sectors are kept
+    // in a small ring indexed by their LBA. The decoders aren't thread safe, so any image read has to hold
+    // m_decoderMutex, while m_readAheadMutex protects the ring and the range of sectors left to fetch.
+    static constexpr unsigned c_readAheadSectors = 16;
+    // The file gets hinted about a larger window, in one go, so that it can fetch it with a single request.
+    static constexpr unsigned c_prefetchSectors = 256;
+    struct ReadAheadSector {
+        uint32_t lba = ~0u;
+        bool subMissing = false;
+        uint8_t data[2352];
+        IEC60908b::Sub sub;
+    };
+    bool readAheadEnabled();
+    void scheduleReadAhead(uint32_t lba);
+    void stopReadAhead();
+    void readAheadMain();
+    std::mutex m_decoderMutex;
+    std::mutex m_readAheadMutex;
+    std::condition_variable m_readAheadCV;
+    std::thread m_readAheadThread;
+    ReadAheadSector m_readAhead[c_readAheadSectors];
+    ReadAheadSector m_readAheadStaging;
+    uint32_t m_readAheadNext = 0;
+    uint32_t m_readAheadEnd = 0;
+    uint32_t m_prefetchStart = 0;
+    uint32_t m_prefetchEnd = 0;
+    bool m_readAheadExit = false;
+
+    // Compressed CD audio tracks get decoded ahead of the play position by yet another worker, into a ring holding
+    // as many sectors as the CDDALookahead setting asks for, so that playing them only copies the PCM data. Each
+    // image has its own worker, so that several emulator instances decode on separate cores.
+    struct CDDASector {
+        uint32_t lba = ~0u;
+        uint8_t data[2352];
+    };
+    unsigned cddaTrack(uint32_t lba) const;
+    unsigned cddaLookahead(uint32_t lba) const;
+    bool readCDDASector(uint32_t lba, unsigned char* buffer);
+    void stopCDDAReadAhead();
+    void cddaReadAheadMain();
+    std::mutex m_cddaMutex;
+    std::condition_variable m_cddaCV;
+    std::thread m_cddaThread;
+    std::vector<CDDASector> m_cddaRing;
+    uint32_t m_cddaNext = 0;
+    uint32_t m_cddaEnd = 0;
+    bool m_cddaExit = false;
     bool parsetoc(const char* isofile);
     bool parsecue(const char* isofile);
     bool parseccd(const char* isofile);
     bool parsemds(const char* isofile);
     bool handlepbp(const char* isofile);
     bool handlecbin(const char* isofile);
+    bool handlemanifest();
     bool handleecm(const char* isoname, IO<File> cdh, int32_t* accurate_length);
+    bool buildECMIndex(IO<File> f);
+    bool loadECMIndex(const std::filesystem::path& path, size_t ecmSize);
+    void saveECMIndex(const std::filesystem::path& path, size_t ecmSize);
+    ECMBlock* decodeECMBlock(IO<File> f, uint32_t block);
     bool opensubfile(const char* isoname);
     bool opensbifile(const char* isoname);
 
@@ -170,6 +287,7 @@ class CDRIso {
     ssize_t cdread_sub_mixed(IO<File> f, unsigned int base, void* dest, int sector);
     ssize_t cdread_compressed(IO<File> f, unsigned int base, void* dest, int sector);
     ssize_t cdread_2048(IO<File> f, unsigned int base, void* dest, int sector);
+    ssize_t cdread_store(IO<File> f, unsigned int base, void* dest, int sector);
     ssize_t ecmDecode(IO<File> f, unsigned int base, void* dest, int sector);
 
     void printTracks();
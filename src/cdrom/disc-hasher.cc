@@ -0,0 +1,199 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/disc-hasher.h"
+
+#include <zlib.h>
+
+#include <fstream>
+#include <future>
+
+#include "cdrom/cdriso.h"
+#include "core/psxemulator.h"
+#include "core/system.h"
+#include "fmt/format.h"
+#include "json.hpp"
+#include "support/md5.h"
+
+namespace {
+
+// Big enough for the hashing of a chunk to be worth a thread, small enough to keep the progress moving.
+constexpr unsigned c_chunkSectors = 512;
+
+struct ImageKey {
+    uintmax_t size;
+    int64_t mtime;
+};
+
+std::optional<ImageKey> imageKey(const std::filesystem::path& image) {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(image, ec)) return std::nullopt;
+    const auto size = std::filesystem::file_size(image, ec);
+    if (ec) return std::nullopt;
+    const auto mtime = std::filesystem::last_write_time(image, ec);
+    if (ec) return std::nullopt;
+    return ImageKey{size, int64_t(mtime.time_since_epoch().count())};
+}
+
+nlohmann::json toJson(const PCSX::DiscHasher::Hashes& hashes) {
+    return {{"crc32", fmt::format("{:08x}", hashes.crc32)}, {"md5", hashes.md5String()}};
+}
+
+bool fromJson(const nlohmann::json& j, PCSX::DiscHasher::Hashes& hashes) {
+    if (!j.is_object() || !j.contains("crc32") || !j.contains("md5")) return false;
+    const std::string crc32 = j["crc32"];
+    const std::string md5 = j["md5"];
+    if ((crc32.size() != 8) || (md5.size() != 32)) return false;
+    hashes.crc32 = std::stoul(crc32, nullptr, 16);
+    for (unsigned i = 0; i < 16; i++) hashes.md5[i] = std::stoul(md5.substr(i * 2, 2), nullptr, 16);
+    return true;
+}
+
+}  // namespace
+
+std::string PCSX::DiscHasher::Hashes::md5String() const {
+    std::string ret;
+    for (auto byte : md5) ret += fmt::format("{:02x}", byte);
+    return ret;
+}
+
+std::filesystem::path PCSX::DiscHasher::sidecarPath(const std::filesystem::path& image) {
+    auto ret = image;
+    ret += ".hashes";
+    return ret;
+}
+
+std::optional<PCSX::DiscHasher::Result> PCSX::DiscHasher::loadSidecar(const std::filesystem::path& image) {
+    const auto key = imageKey(image);
+    if (!key) return std::nullopt;
+    std::ifstream in(sidecarPath(image));
+    if (!in) return std::nullopt;
+    auto j = nlohmann::json::parse(in, nullptr, false);
+    if (!j.is_object() || !j.contains("size") || !j.contains("mtime") || !j.contains("tracks")) return std::nullopt;
+    if ((j["size"] != key->size) || (j["mtime"] != key->mtime)) return std::nullopt;
+    Result result;
+    if (!fromJson(j, result.disc) || !j["tracks"].is_array()) return std::nullopt;
+    for (auto& track : j["tracks"]) {
+        if (!fromJson(track, result.tracks.emplace_back())) return std::nullopt;
+    }
+    return result;
+}
+
+bool PCSX::DiscHasher::saveSidecar(const std::filesystem::path& image, const Result& result) {
+    const auto key = imageKey(image);
+    if (!key) return false;
+    nlohmann::json j = toJson(result.disc);
+    j["size"] = key->size;
+    j["mtime"] = key->mtime;
+    j["tracks"] = nlohmann::json::array();
+    for (auto& track : result.tracks) j["tracks"].push_back(toJson(track));
+    std::ofstream out(sidecarPath(image));
+    if (!out) return false;
+    out << j.dump(4);
+    return bool(out);
+}
+
+std::shared_ptr<PCSX::DiscHasher> PCSX::DiscHasher::start(const std::filesystem::path& path) {
+    std::shared_ptr<DiscHasher> hasher(new DiscHasher());
+    hasher->m_path = path;
+    auto memoised = loadSidecar(path);
+    if (memoised) {
+        hasher->m_result = std::move(memoised.value());
+        hasher->m_memoised = true;
+        hasher->m_progress = 1.0f;
+        hasher->m_done = true;
+        return hasher;
+    }
+    hasher->m_iso = std::make_unique<CDRIso>(path);
+    if (hasher->m_iso->failed()) {
+        hasher->m_failed = true;
+        hasher->m_done = true;
+        return hasher;
+    }
+    // Reading the audio tracks goes through the settings, and may start the CDDA decoding thread, which both
+    // need the emulator this got started from.
+    hasher->m_thread = std::thread([hasher = hasher.get(), emulator = g_emulator, system = g_system]() {
+        Emulator::Scope scope(emulator, system);
+        hasher->run();
+    });
+    return hasher;
+}
+
+PCSX::DiscHasher::~DiscHasher() {
+    m_cancelled = true;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void PCSX::DiscHasher::run() {
+    const unsigned trackCount = m_iso->getTN();
+    uint32_t totalSectors = 0;
+    for (unsigned t = 1; t <= trackCount; t++) totalSectors += m_iso->getLength(t).toLBA();
+
+    MD5 discMD5;
+    std::vector<MD5> trackMD5s(trackCount);
+    m_result.disc.crc32 = crc32(0L, Z_NULL, 0);
+    m_result.tracks.resize(trackCount);
+    for (auto& track : m_result.tracks) track.crc32 = crc32(0L, Z_NULL, 0);
+
+    // While a chunk is being hashed, the next one gets read in the other buffer.
+    std::vector<uint8_t> buffers[2];
+    for (auto& buffer : buffers) buffer.resize(c_chunkSectors * IEC60908b::FRAMESIZE_RAW);
+    unsigned current = 0;
+    std::future<void> hashing;
+
+    uint32_t lba = 0;
+    for (unsigned t = 1; !m_failed && (t <= trackCount); t++) {
+        auto& track = m_result.tracks[t - 1];
+        auto& trackMD5 = trackMD5s[t - 1];
+        uint32_t remaining = m_iso->getLength(t).toLBA();
+        while (remaining != 0) {
+            if (m_cancelled) {
+                m_failed = true;
+                break;
+            }
+            const unsigned count = std::min(remaining, c_chunkSectors);
+            auto& buffer = buffers[current];
+            if (m_iso->readSectors(lba, buffer.data(), count) != count) {
+                m_failed = true;
+                break;
+            }
+            lba += count;
+            remaining -= count;
+            if (hashing.valid()) hashing.wait();
+            const size_t size = count * IEC60908b::FRAMESIZE_RAW;
+            hashing = std::async(std::launch::async, [&, data = buffer.data(), size]() {
+                m_result.disc.crc32 = crc32(m_result.disc.crc32, data, size);
+                track.crc32 = crc32(track.crc32, data, size);
+                discMD5.update(data, size);
+                trackMD5.update(data, size);
+            });
+            current ^= 1;
+            m_progress.store(float(lba) / float(totalSectors), std::memory_order_relaxed);
+        }
+    }
+    if (hashing.valid()) hashing.wait();
+
+    if (!m_failed) {
+        discMD5.finish(m_result.disc.md5.data());
+        for (unsigned t = 0; t < trackCount; t++) trackMD5s[t].finish(m_result.tracks[t].md5.data());
+        saveSidecar(m_path, m_result);
+    }
+    m_iso.reset();
+    m_done.store(true, std::memory_order_release);
+}
@@ -0,0 +1,88 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PCSX {
+
+class CDRIso;
+
+// Identifies disc images by hashing their raw sectors, the way redump does: a CRC32 and an MD5 of the whole disc,
+// and of each of its tracks. The hashing runs on a worker thread, which reads the next sectors while the previous
+// ones get hashed, so that neither the emulation nor the UI wait on it, and several images can be identified at
+// once. The results are memoised in a sidecar file next to the image, which is trusted for as long as the size and
+// modification time of the image stay the same.
+class DiscHasher {
+  public:
+    struct Hashes {
+        uint32_t crc32 = 0;
+        std::array<uint8_t, 16> md5 = {};
+        std::string md5String() const;
+    };
+    struct Result {
+        Hashes disc;
+        // Track 1 is at index 0.
+        std::vector<Hashes> tracks;
+    };
+
+    // Has to be called from a thread running an emulator, as opening and reading the image log, and read the
+    // settings. The worker thread uses the same emulator.
+    static std::shared_ptr<DiscHasher> start(const std::filesystem::path& path);
+    ~DiscHasher();
+
+    bool done() const { return m_done.load(std::memory_order_acquire); }
+    // The remaining ones are only valid once done.
+    bool failed() const { return m_failed; }
+    // Whether the result came from the sidecar file, without hashing anything.
+    bool memoised() const { return m_memoised; }
+    const Result& result() const { return m_result; }
+    float progress() const { return m_progress.load(std::memory_order_relaxed); }
+
+    static std::filesystem::path sidecarPath(const std::filesystem::path& image);
+    // Returns nothing if there's no sidecar file for the image, or if the image changed since it got written.
+    static std::optional<Result> loadSidecar(const std::filesystem::path& image);
+    static bool saveSidecar(const std::filesystem::path& image, const Result& result);
+
+  private:
+    DiscHasher() = default;
+    void run();
+
+    std::filesystem::path m_path;
+    std::unique_ptr<CDRIso> m_iso;
+    std::thread m_thread;
+    std::atomic<bool> m_done = false;
+    std::atomic<bool> m_cancelled = false;
+    std::atomic<float> m_progress = 0.0f;
+    bool m_failed = false;
+    bool m_memoised = false;
+    Result m_result;
+};
+
+}  // namespace PCSX
@@ -19,11 +19,12 @@
 
 #include "cdrom/iso9660-reader.h"
 
+#include "cdrom/cdriso.h"
 #include "cdrom/file.h"
 #include "support/strings-helpers.h"
 #include "supportpsx/iso9660-lowlevel.h"
 
-PCSX::ISO9660Reader::ISO9660Reader(std::shared_ptr<CDRIso> iso) : m_iso(iso) {
+PCSX::ISO9660Reader::ISO9660Reader(std::shared_ptr<CDRIso> iso) : m_iso(iso), m_index(iso->getPathIndex()) {
     unsigned pvdSector = 16;
 
     while (true) {
@@ -67,20 +68,35 @@ std::optional<PCSX::ISO9660Reader::FullDirEntry> PCSX::ISO9660Reader::findEntry(
     if (m_failed) return {};
     auto parts = StringsHelpers::split(filename, "/");
 
+    std::string path;
+    for (auto &part : parts) {
+        if (!path.empty()) path += '/';
+        path += part;
+    }
+
+    std::lock_guard<std::mutex> lock(m_index->mutex);
+    auto found = m_index->entries.find(path);
+    if (found != m_index->entries.end()) return found->second;
+
+    // Not seen yet, so walking down from the root, listing the directories we didn't list before.
     FullDirEntry current;
     current.first = m_pvd.get<ISO9660LowLevel::PVD_RootDir>();
+    path.clear();
 
     for (auto &part : parts) {
-        auto entries = listAllEntriesFrom(current.first);
-        for (auto &entry : entries) {
-            const auto &entryFilename = entry.first.get<ISO9660LowLevel::DirEntry_Filename>().value;
-            if (entryFilename == part) {
-                current = entry;
-                break;
+        if (!m_index->listedDirectories.contains(path)) {
+            for (auto &entry : listAllEntriesFrom(current.first)) {
+                const auto &entryFilename = entry.first.get<ISO9660LowLevel::DirEntry_Filename>().value;
+                m_index->entries.try_emplace(path.empty() ? entryFilename : path + '/' + entryFilename, entry);
             }
+            m_index->listedDirectories.insert(path);
         }
 
-        if (current.first.get<ISO9660LowLevel::DirEntry_Filename>() != part) return {};
+        if (!path.empty()) path += '/';
+        path += part;
+        found = m_index->entries.find(path);
+        if (found == m_index->entries.end()) return {};
+        current = found->second;
     }
 
     return current;
@@ -20,7 +20,11 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cdrom/file.h"
@@ -30,6 +34,16 @@ namespace PCSX {
 
 class CDRIso;
 
+// Every directory record found so far on a disc, by full path, and which directories were already
+// listed entirely. The CDRIso keeps it, so that all of its readers share it, and so that it goes
+// away with the disc.
+struct ISO9660PathIndex {
+    typedef std::pair<ISO9660LowLevel::DirEntry, ISO9660LowLevel::DirEntry_XA> FullDirEntry;
+    std::mutex mutex;
+    std::unordered_map<std::string, FullDirEntry> entries;
+    std::unordered_set<std::string> listedDirectories;
+};
+
 class ISO9660Reader {
   public:
     ISO9660Reader(std::shared_ptr<CDRIso>);
@@ -42,8 +56,9 @@ class ISO9660Reader {
 
   private:
     std::shared_ptr<CDRIso> m_iso;
+    std::shared_ptr<ISO9660PathIndex> m_index;
     bool m_failed = false;
-    typedef std::pair<ISO9660LowLevel::DirEntry, ISO9660LowLevel::DirEntry_XA> FullDirEntry;
+    typedef ISO9660PathIndex::FullDirEntry FullDirEntry;
 
     std::optional<FullDirEntry> findEntry(const std::string_view& filename);
     std::vector<FullDirEntry> listAllEntriesFrom(const ISO9660LowLevel::DirEntry& entry);
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/sectorstore.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "support/md5.h"
+
+PCSX::SectorStore::SectorStore(const std::filesystem::path& path, bool writable) : m_path(path) {
+    const auto packPath = path / "sectors.pack";
+    const auto indexPath = path / "sectors.index";
+
+    if (writable) {
+        std::error_code ec;
+        std::filesystem::create_directories(path, ec);
+        // Creating the files if they're missing, so they can be opened in read-write mode afterwards.
+        IO<File>(new PosixFile(packPath, FileOps::CREATE));
+        IO<File>(new PosixFile(indexPath, FileOps::CREATE));
+    }
+
+    std::vector<Digest> digests;
+    size_t packSize = 0;
+    {
+        IO<File> index(new PosixFile(indexPath));
+        IO<File> pack(new PosixFile(packPath));
+        if (index->failed() || pack->failed()) return;
+        // The pack gets written before the index, so a sector is only there once both of them have it.
+        packSize = pack->size();
+        digests.resize(std::min(index->size() / sizeof(Digest), packSize / IEC60908b::FRAMESIZE_RAW));
+        const size_t len = digests.size() * sizeof(Digest);
+        if (len && (index->read(digests.data(), len) != ssize_t(len))) return;
+    }
+    m_count = digests.size();
+    m_slots.reserve(m_count);
+    for (uint32_t slot = 0; slot < m_count; slot++) m_slots.emplace(digests[slot], slot);
+
+    if (writable) {
+        // Anything past the last complete sector is from an interrupted add, and gets overwritten.
+        m_packOut.setFile(new PosixFile(packPath, FileOps::READWRITE));
+        m_indexOut.setFile(new PosixFile(indexPath, FileOps::READWRITE));
+        if (m_packOut->failed() || m_indexOut->failed()) return;
+        m_packOut->wSeek(size_t(m_count) * IEC60908b::FRAMESIZE_RAW, SEEK_SET);
+        m_indexOut->wSeek(size_t(m_count) * sizeof(Digest), SEEK_SET);
+    } else if (m_count) {
+        m_pack.setFile(new MmapFile(packPath));
+        if (m_pack->failed()) return;
+        m_data = m_pack->data();
+    }
+
+    m_failed = false;
+}
+
+PCSX::SectorStore::Digest PCSX::SectorStore::digest(const uint8_t* sector) {
+    Digest ret;
+    MD5 md5;
+    md5.update(sector, IEC60908b::FRAMESIZE_RAW);
+    md5.finish(ret.data());
+    return ret;
+}
+
+PCSX::SectorStore::Digest PCSX::SectorStore::add(const uint8_t* sector) {
+    Digest ret = digest(sector);
+    if (m_failed || !m_packOut || (find(ret) >= 0)) return ret;
+
+    if ((m_packOut->write(sector, IEC60908b::FRAMESIZE_RAW) != IEC60908b::FRAMESIZE_RAW) ||
+        (m_indexOut->write(ret.data(), ret.size()) != ssize_t(ret.size()))) {
+        m_failed = true;
+        return ret;
+    }
+    m_slots.emplace(ret, m_count++);
+    return ret;
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <array>
+#include <filesystem>
+#include <unordered_map>
+
+#include "support/file.h"
+#include "support/mmapfile.h"
+#include "supportpsx/iec-60908b.h"
+
+namespace PCSX {
+
+// A content addressed store of raw 2352 bytes sectors, shared by any number of disc images. Each distinct
+// sector is kept only once, in the order it was first added, and is known by the MD5 digest of its contents.
+// The store is a directory holding two files: sectors.pack, the sectors themselves, and sectors.index,
+// the digest of each of them. Both files only ever grow, and a store can be read by several processes
+// while one is adding to it: readers only see the sectors which were there when they opened it.
+//
+// Read-only stores are mapped in memory, so all the emulator instances using the same store share its
+// pages through the OS cache. Disc images are mounted from a store through a manifest, see CDRIso.
+class SectorStore {
+  public:
+    typedef std::array<uint8_t, 16> Digest;
+
+    SectorStore(const std::filesystem::path& path, bool writable = false);
+    bool failed() { return m_failed; }
+    const std::filesystem::path& path() const { return m_path; }
+    uint32_t count() const { return m_count; }
+
+    static Digest digest(const uint8_t* sector);
+    // Adds a sector if its contents aren't in the store yet. Only for stores opened as writable.
+    Digest add(const uint8_t* sector);
+    // Returns the slot holding the sector with this digest, or -1 if it's not in the store.
+    int64_t find(const Digest& digest) const {
+        auto i = m_slots.find(digest);
+        return i == m_slots.end() ? -1 : int64_t(i->second);
+    }
+    // Only for stores opened as read-only.
+    const uint8_t* sector(uint32_t slot) const {
+        return slot < m_count ? m_data + size_t(slot) * IEC60908b::FRAMESIZE_RAW : nullptr;
+    }
+
+  private:
+    struct DigestHash {
+        size_t operator()(const Digest& digest) const {
+            size_t ret;
+            memcpy(&ret, digest.data(), sizeof(ret));
+            return ret;
+        }
+    };
+
+    const std::filesystem::path m_path;
+    std::unordered_map<Digest, uint32_t, DigestHash> m_slots;
+    IO<MmapFile> m_pack;
+    const uint8_t* m_data = nullptr;
+    IO<File> m_packOut;
+    IO<File> m_indexOut;
+    uint32_t m_count = 0;
+    bool m_failed = true;
+};
+
+}  // namespace PCSX
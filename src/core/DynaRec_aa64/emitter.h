@@ -80,6 +80,31 @@ class Emitter : public MacroAssembler {
 
     void setRX() { GetBuffer()->SetExecutable(); }
 
+    // Compiling a block can recursively compile the blocks it links to, so writes to the buffer nest.
+    // Only the outermost writer flips the buffer's protection and flushes the icache, which puts a whole chain of
+    // freshly compiled blocks and the link patches made after them under a single writable window.
+    void beginWrite() {
+        if (m_writeDepth++ == 0) {
+            m_writeStart = getCurr<char*>();
+#if defined(__APPLE__)
+            setRW();
+#endif
+        }
+    }
+
+    void endWrite() {
+        if (--m_writeDepth == 0) {
+            // The cache might have been flushed while writing, in which case everything from the start is new
+            char* const end = getCurr<char*>();
+            char* const start = (m_writeStart <= end) ? m_writeStart : getCode<char*>();
+            __builtin___clear_cache(start, end);
+            ready();
+#if defined(__APPLE__)
+            setRX();
+#endif
+        }
+    }
+
     void align() { GetBuffer()->Align(); }
 
 #define MAKE_CONDITIONAL_BRANCH(properName, alias)      \
@@ -170,5 +195,9 @@ class Emitter : public MacroAssembler {
 
     // Emit a trap instruction that gdb/lldb/Visual Studio can interpret as a breakpoint
     void breakpoint() { Brk(0); }
+
+  private:
+    int m_writeDepth = 0;          // How many writers currently have the buffer open
+    char* m_writeStart = nullptr;  // Where the outermost writer started emitting
 };
 #endif  // DYNAREC_AA64
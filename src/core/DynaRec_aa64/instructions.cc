@@ -678,6 +678,7 @@ void DynaRecCPU::recMFHI(uint32_t code) {
 
 template <int size, bool signExtend>
 void DynaRecCPU::recompileLoad(uint32_t code) {
+    bool calledHandler = false;
     if (m_gprs[_Rs_].isConst()) {  // Store the address in first argument register
         const uint32_t addr = m_gprs[_Rs_].val + _Imm_;
         const auto pointer = PCSX::g_emulator->m_mem->pointerRead(addr);
@@ -689,25 +690,28 @@ void DynaRecCPU::recompileLoad(uint32_t code) {
             return;
         }
 
-        gen.Mov(arg1, addr);
+        calledHandler = emitHardwareLoad<size>(addr);
+        if (!calledHandler) gen.Mov(arg1, addr);
     } else {
         allocateReg(_Rs_);
         gen.moveAndAdd(arg1, m_gprs[_Rs_].allocatedReg, _Imm_);
     }
 
-    switch (size) {
-        case 8:
-            call(read8Wrapper);
-            break;
-        case 16:
-            call(read16Wrapper);
-            break;
-        case 32:
-            call(read32Wrapper);
-            break;
-        default:
-            PCSX::g_system->message("Invalid size for memory load in dynarec. Instruction %08x\n", m_regs.code);
-            break;
+    if (!calledHandler) {
+        switch (size) {
+            case 8:
+                call(read8Wrapper);
+                break;
+            case 16:
+                call(read16Wrapper);
+                break;
+            case 32:
+                call(read32Wrapper);
+                break;
+            default:
+                PCSX::g_system->message("Invalid size for memory load in dynarec. Instruction %08x\n", m_regs.code);
+                break;
+        }
     }
 
     if (_Rt_) {
@@ -1016,6 +1020,7 @@ void DynaRecCPU::recSB(uint32_t code) {
                 allocateReg(_Rt_);
                 store<8>(m_gprs[_Rt_].allocatedReg, pointer);
             }
+            markDirty(pointer);
 
             return;
         }
@@ -1056,6 +1061,7 @@ void DynaRecCPU::recSH(uint32_t code) {
                 allocateReg(_Rt_);
                 store<16>(m_gprs[_Rt_].allocatedReg, pointer);
             }
+            markDirty(pointer);
 
             return;
         }
@@ -1097,8 +1103,10 @@ void DynaRecCPU::recSH(uint32_t code) {
             gen.Mov(arg2, m_gprs[_Rt_].allocatedReg);
         }
 
-        gen.Mov(arg1, addr);  // Address to write to in arg1   TODO: Optimize
-        call(write16Wrapper);
+        if (!emitHardwareCall(PCSX::HW::getWrite16Handler(addr), addr)) {
+            gen.Mov(arg1, addr);  // Address to write to in arg1   TODO: Optimize
+            call(write16Wrapper);
+        }
     }
 
     else {
@@ -1126,6 +1134,7 @@ void DynaRecCPU::recSW(uint32_t code) {
                 allocateReg(_Rt_);
                 store<32>(m_gprs[_Rt_].allocatedReg, pointer);
             }
+            markDirty(pointer);
 
             return;
         }
@@ -1137,8 +1146,10 @@ void DynaRecCPU::recSW(uint32_t code) {
             gen.Mov(arg2, m_gprs[_Rt_].allocatedReg);
         }
 
-        gen.Mov(arg1, addr);  // Address to write to in arg1   TODO: Optimize
-        call(write32Wrapper);
+        if (!emitHardwareCall(PCSX::HW::getWrite32Handler(addr), addr)) {
+            gen.Mov(arg1, addr);  // Address to write to in arg1   TODO: Optimize
+            call(write32Wrapper);
+        }
     }
 
     else {
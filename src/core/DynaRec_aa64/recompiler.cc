@@ -68,9 +68,15 @@ bool DynaRecCPU::Init() {
         return false;
     }
 #else
-    gen.setRW();  // M1 wants buffer marked as readable/writable with mprotect before emitting code
+    // Check to make sure code buffer memory was allocated
+    if (gen.getCode<void*>() == nullptr) {
+        PCSX::g_system->message("[Dynarec] Failed to allocate memory for Dynarec.\nTry disabling the Dynarec CPU.");
+        return false;
+    }
 #endif
+    gen.beginWrite();  // M1 wants buffer marked as readable/writable with mprotect before emitting code
     emitDispatcher();  // Emit our assembly dispatcher
+    gen.endWrite();    // Mark code cache as readable/executable before jumping into dispatcher
     uncompileAll();    // Mark all blocks as uncompiled
 
     for (int i = 0; i < 0x10000 / 4; i++) {  // Mark all dummy blocks as invalid
@@ -78,15 +84,6 @@ bool DynaRecCPU::Init() {
     }
 
     m_gprs[0].markConst(0);  // $zero is always zero
-
-#if defined(__APPLE__)
-    // Check to make sure code buffer memory was allocated
-    if (gen.getCode<void*>() == nullptr) {
-        PCSX::g_system->message("[Dynarec] Failed to allocate memory for Dynarec.\nTry disabling the Dynarec CPU.");
-        return false;
-    }
-    gen.setRX();  // Mark code cache as readable/executable before jumping into dispatcher
-#endif
     return true;
 }
 
@@ -136,6 +133,7 @@ void DynaRecCPU::uncompileAll() {
 }
 
 void DynaRecCPU::flushCache() {
+    m_jitStats.cacheFlushes++;
     gen.Reset();       // Reset the emitter's code pointer and code size variables
     emitDispatcher();  // Re-emit dispatcher
     uncompileAll();    // Mark all blocks as uncompiled
@@ -247,9 +245,7 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
     const auto startingPC = m_pc;
     int count = 0;  // How many instructions have we compiled?
 
-#if defined(__APPLE__)
-    gen.setRW();  // Mark code cache as readable/writeable before emitting code
-#endif
+    gen.beginWrite();  // Mark code cache as readable/writeable before emitting code
 
     if (align) {
         gen.align();  // Align next block
@@ -261,6 +257,7 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
 
     const auto blockStart = gen.getCurr<DynarecCallback>();
     *callback = blockStart;
+    m_jitStats.blocksCompiled++;
     handleKernelCall();  // Check if this is a kernel call vector, emit some extra code in that case.
 
     auto shouldContinue = [&]() {
@@ -282,6 +279,7 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
 
         uint32_t* p = PCSX::g_emulator->m_mem->getPointer<uint32_t>(m_pc);
         if (p == nullptr) {  // Error if it can't be fetched
+            gen.endWrite();
             return m_invalidBlock;
         }
 
@@ -315,12 +313,9 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
         jmp((void*)m_returnFromBlock);
     }
 
-    // Clear stale instruction cache contents.
-    __builtin___clear_cache(reinterpret_cast<char*>(blockStart), gen.getCurr<char*>());
-    gen.ready();
-#if defined(__APPLE__)
-    gen.setRX();  // Mark code cache as readable/executable before returning to dispatcher
-#endif
+    // Clear stale instruction cache contents and mark the code cache as readable/executable before returning to
+    // the dispatcher. If we're a linked block being compiled by another one, this happens once the outermost is done
+    gen.endWrite();
     // The block might have been invalidated by handleLinking, so re-read the pointer from *callback
     return *callback;
 }
@@ -340,10 +335,16 @@ void DynaRecCPU::handleKernelCall() {
         return;  // Mask out the segment, return if not a kernel call vector
 
     switch (pc) {  // Handle the A0/B0/C0 vectors
-        case 0xA0:
+        case 0xA0: {
+            // The call may get run natively, in which case the pc now points back at the caller
+            vixl::aarch64::Label notHandled;
             loadThisPointer(arg1.X());
-            call(interceptKernelCallWrapper<0xA0>);
+            call(interceptKernelCallWrapper<0xA0, true>);
+            gen.Cbz(w0, &notHandled);
+            jmp((void*)m_returnFromBlock);
+            gen.L(notHandled);
             break;
+        }
 
         case 0xB0:
             loadThisPointer(arg1.X());
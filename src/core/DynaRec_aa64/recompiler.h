@@ -18,6 +18,7 @@
  ***************************************************************************/
 
 #pragma once
+#include "core/psxhw.h"
 #include "core/r3000a.h"
 
 #if defined(DYNAREC_AA64)
@@ -205,9 +206,9 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         return that->recompile(callback, that->m_regs.pc);
     }
 
-    template <uint32_t pc>
-    static void interceptKernelCallWrapper(DynaRecCPU* that) {
-        that->InterceptBIOS<false>(pc);
+    template <uint32_t pc, bool hle = false>
+    static bool interceptKernelCallWrapper(DynaRecCPU* that) {
+        return that->InterceptBIOS<false, hle>(pc);
     }
 
     // TODO: This is currently un-unsed in x64 DynaRec. Check this.
@@ -299,6 +300,35 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         }
     }
 
+    // Direct stores, to addresses known when compiling, also need to mark their page of RAM as dirty
+    void markDirty(const void* pointer) {
+        if (auto flag = PCSX::g_emulator->m_mem->dirtyFlag(pointer)) store<8>(1u, flag);
+    }
+
+    // Accesses to constant addresses which land on a register with its own handler in PCSX::HW can call the
+    // handler directly, instead of going through Memory and the HW switches. Stores need their value in arg2
+    // beforehand. These return false when there's no handler, and the generic path has to be used.
+    template <typename Handler>
+    bool emitHardwareCall(Handler handler, uint32_t address) {
+        if (handler == nullptr) return false;
+        gen.Ldr(x4, MemOperand(contextPointer, CYCLE_OFFSET));  // Memory counts a cycle for every data access
+        gen.Add(x4, x4, 1);
+        gen.Str(x4, MemOperand(contextPointer, CYCLE_OFFSET));
+        gen.Mov(arg1, address);
+        call(*handler);
+        return true;
+    }
+
+    template <int size>
+    bool emitHardwareLoad(uint32_t address) {
+        if constexpr (size == 16) {
+            return emitHardwareCall(PCSX::HW::getRead16Handler(address), address);
+        } else if constexpr (size == 32) {
+            return emitHardwareCall(PCSX::HW::getRead32Handler(address), address);
+        }
+        return false;
+    }
+
     // Prepare for a call to a C++ function and then actually emit it
     template <typename T>
     void call(T& func) {
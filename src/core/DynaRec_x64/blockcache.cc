@@ -0,0 +1,173 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "recompiler.h"
+
+#if defined(DYNAREC_X86_64)
+#include <zlib.h>
+
+#include <filesystem>
+
+// The block cache remembers which blocks got compiled during previous sessions, so that they can be compiled in
+// their final form before the emulator starts running. The emitted code itself can't be persisted, as it embeds
+// host pointers into heap objects (the JIT object, the memory LUTs, the Memory object...) without any record of
+// where they are, so there would be no way to relocate it.
+// Instead, the file stores the start address of each block, a CRC32 of the instructions it was compiled from, and
+// whether it ended up needing full load delay emulation, keyed by BIOS CRC and emulator build.
+
+namespace {
+
+constexpr uint32_t c_blockCacheMagic = 0x43524450;  // "PDRC"
+constexpr uint32_t c_blockCacheVersion = 1;
+constexpr size_t c_maxCachedBlocks = 0x40000;
+
+struct BlockCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t buildKey;
+    uint32_t biosCRC;
+    uint32_t count;
+};
+
+struct BlockCacheEntry {
+    uint32_t pc;
+    uint32_t hash;
+    uint16_t length;
+    uint16_t flags;
+};
+
+constexpr uint16_t c_fullLoadDelaysFlag = 1;
+
+std::filesystem::path getBlockCachePath() { return PCSX::g_system->getPersistentDir() / "dynarec.cache"; }
+
+uint32_t getBuildKey() {
+    const auto& version = PCSX::g_system->getVersion();
+    uint32_t crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, (const Bytef*)version.version.data(), version.version.size());
+    crc = crc32(crc, (const Bytef*)version.changeset.data(), version.changeset.size());
+    const uint32_t layout[] = {c_blockCacheVersion, (uint32_t)sizeof(DynaRecCPU)};
+    return crc32(crc, (const Bytef*)layout, sizeof(layout));
+}
+
+}  // namespace
+
+bool DynaRecCPU::useBlockCache() {
+    return PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecBlockCache>();
+}
+
+// Returns the CRC32 of the "length" instructions starting at "pc", or nullopt if they aren't all in valid memory
+std::optional<uint32_t> DynaRecCPU::hashBlock(uint32_t pc, uint32_t length) {
+    auto& memory = PCSX::g_emulator->m_mem;
+    uint32_t crc = crc32(0L, Z_NULL, 0);
+
+    for (uint32_t i = 0; i < length; i++, pc += 4) {
+        const auto ptr = memory->getPointer<uint32_t>(pc);
+        if (!ptr) return std::nullopt;
+        crc = crc32(crc, (const Bytef*)ptr, sizeof(uint32_t));
+    }
+
+    return crc;
+}
+
+// Called when a block has been compiled, so that the next session knows about it
+void DynaRecCPU::recordCachedBlock(uint32_t pc, uint32_t length, bool fullLoadDelays) {
+    if (length == 0 || length > 0xffff) return;
+    if (m_blockCache.size() >= c_maxCachedBlocks && m_blockCache.find(pc) == m_blockCache.end()) return;
+
+    const auto hash = hashBlock(pc, length);
+    if (!hash) return;
+
+    auto& entry = m_blockCache[pc];
+    // A block that needed full load delays once will likely need them again, even if it got invalidated since
+    const bool sameCode = entry.length == length && entry.hash == hash.value();
+    entry.fullLoadDelays = fullLoadDelays || (sameCode && entry.fullLoadDelays);
+    entry.hash = hash.value();
+    entry.length = length;
+}
+
+// Looks up the block starting at "pc" in the cache, and checks it still matches what's in memory
+const DynaRecCPU::CachedBlock* DynaRecCPU::findCachedBlock(uint32_t pc) {
+    const auto it = m_blockCache.find(pc);
+    if (it == m_blockCache.end()) return nullptr;
+
+    const auto hash = hashBlock(pc, it->second.length);
+    if (!hash || hash.value() != it->second.hash) return nullptr;
+    return &it->second;
+}
+
+void DynaRecCPU::loadBlockCache() {
+    m_blockCache.clear();
+    m_blockCacheLoaded = true;
+    m_blockCacheBiosCRC = PCSX::g_emulator->m_mem->getBiosCRC32();
+
+    std::ifstream file(getBlockCachePath(), std::ios::binary);
+    if (!file) return;
+
+    BlockCacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return;
+    if (header.magic != c_blockCacheMagic || header.version != c_blockCacheVersion) return;
+    if (header.buildKey != getBuildKey() || header.biosCRC != m_blockCacheBiosCRC) return;
+    if (header.count > c_maxCachedBlocks) return;
+
+    for (uint32_t i = 0; i < header.count; i++) {
+        BlockCacheEntry entry;
+        if (!file.read(reinterpret_cast<char*>(&entry), sizeof(entry))) break;
+        m_blockCache[entry.pc] = {entry.hash, entry.length, (entry.flags & c_fullLoadDelaysFlag) != 0};
+    }
+}
+
+void DynaRecCPU::saveBlockCache() {
+    if (!m_blockCacheLoaded || m_blockCache.empty()) return;
+
+    std::ofstream file(getBlockCachePath(), std::ios::binary | std::ios::trunc);
+    if (!file) return;
+
+    const BlockCacheHeader header = {c_blockCacheMagic, c_blockCacheVersion, getBuildKey(), m_blockCacheBiosCRC,
+                                     (uint32_t)m_blockCache.size()};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& [pc, block] : m_blockCache) {
+        const BlockCacheEntry entry = {pc, block.hash, block.length,
+                                       uint16_t(block.fullLoadDelays ? c_fullLoadDelaysFlag : 0)};
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+}
+
+// Compiles every cached block whose source is in memory and unchanged. Called on reset, at which point that's
+// mostly the BIOS. RAM blocks get their cached load delay mode applied when they're first compiled instead.
+void DynaRecCPU::precompileCachedBlocks() {
+    // The entries we have are tied to the BIOS they were recorded with, so switching BIOS means starting over
+    if (!m_blockCacheLoaded || m_blockCacheBiosCRC != PCSX::g_emulator->m_mem->getBiosCRC32()) {
+        loadBlockCache();
+    }
+
+    // Compiling records blocks in the cache, so we can't iterate over it directly
+    std::vector<std::pair<uint32_t, bool>> blocks;
+    blocks.reserve(m_blockCache.size());
+    for (const auto& [pc, block] : m_blockCache) {
+        blocks.emplace_back(pc, block.fullLoadDelays);
+    }
+
+    for (const auto& [pc, fullLoadDelays] : blocks) {
+        if (!isPcValid(pc) || *getBlockPointer(pc) != m_uncompiledBlock || findCachedBlock(pc) == nullptr) continue;
+        recompile(pc, fullLoadDelays);
+    }
+}
+
+#endif  // DYNAREC_X86_64
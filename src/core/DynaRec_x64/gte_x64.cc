@@ -23,6 +23,8 @@
 #include "core/gte.h"
 #define COP2_CONTROL_OFFSET(reg) ((uintptr_t) & m_regs.CP2C.r[(reg)] - (uintptr_t)this)
 #define COP2_DATA_OFFSET(reg) ((uintptr_t) & m_regs.CP2D.r[(reg)] - (uintptr_t)this)
+#define GTE_SF(op) (((op) >> 19) & 1)
+#define GTE_LM(op) (((op) >> 10) & 1)
 
 void DynaRecCPU::recCOP2(uint32_t code) {
     const auto func = m_recGTE[m_regs.code & 0x3F];  // Look up the opcode in our decoding LUT
@@ -449,6 +451,137 @@ void DynaRecCPU::recAVSZ(uint32_t code) {
 void DynaRecCPU::recAVSZ3(uint32_t code) { recAVSZ<false>(code); }
 void DynaRecCPU::recAVSZ4(uint32_t code) { recAVSZ<true>(code); }
 
+// Saturate eax to the range of IR1/IR2/IR3 like GTE::Lm_B1/B2/B3 do, then store it in the IR register
+void DynaRecCPU::emitGTESaturateIR(int index, bool lm, Reg32 flag) {
+    Xbyak::Label checkIfBelowLim, saturate, store;
+    static constexpr uint32_t flags[] = {(1 << 31) | (1 << 24), (1 << 31) | (1 << 23), 1 << 22};
+    const int32_t min = lm ? 0 : -0x8000;
+
+    gen.cmp(eax, 0x7fff);
+    gen.jle(checkIfBelowLim);
+    gen.mov(eax, 0x7fff);
+    gen.jmp(saturate);
+
+    gen.L(checkIfBelowLim);
+    gen.cmp(eax, min);
+    gen.jge(store);
+    gen.mov(eax, min);
+
+    gen.L(saturate);
+    gen.or_(flag, flags[index - 1]);
+    gen.L(store);
+    gen.mov(word[contextPointer + COP2_DATA_OFFSET(8 + index)], ax);
+}
+
+// Shift rax/arg2/arg3 by sf * 12 and write them to MAC1/MAC2/MAC3, then saturate them into IR1/IR2/IR3.
+// The callers only use this for results that can't overflow 44 bits, so there are no MAC flags to check
+void DynaRecCPU::emitGTEStoreMAC123(bool sf, bool lm, Reg32 flag) {
+    const Reg64 results[] = {rax, arg2.cvt64(), arg3.cvt64()};
+
+    for (int i = 0; i < 3; i++) {
+        if (sf) {
+            gen.sar(results[i], 12);
+        }
+        gen.mov(dword[contextPointer + COP2_DATA_OFFSET(25 + i)], results[i].cvt32());
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (i != 0) {
+            gen.mov(eax, results[i].cvt32());
+        }
+        emitGTESaturateIR(i + 1, lm, flag);
+    }
+}
+
+// MAC0 = SX0 * SY1 + SX1 * SY2 + SX2 * SY0 - SX0 * SY2 - SX1 * SY0 - SX2 * SY1
+// The 64-bit sum is only used for the MAC0 overflow flags. PGXP isn't supported by the JIT, so we don't have to
+// check for it like GTE::NCLIP does
+void DynaRecCPU::recNCLIP(uint32_t code) {
+    Xbyak::Label label1, end;
+    constexpr Reg32 flag = arg1;
+    const Reg64 product = arg2.cvt64();
+    const Reg64 temp = arg3.cvt64();
+
+    const auto sx = [this](int i) { return COP2_DATA_OFFSET(12 + i); };
+    const auto sy = [this](int i) { return COP2_DATA_OFFSET(12 + i) + 2; };
+    static constexpr int terms[6][2] = {{0, 1}, {1, 2}, {2, 0}, {0, 2}, {1, 0}, {2, 1}};
+
+    gen.xor_(flag, flag);  // Set FLAG to 0
+    gen.xor_(eax, eax);    // rax = sum of the products
+
+    for (int i = 0; i < 6; i++) {
+        gen.movsx(product, word[contextPointer + sx(terms[i][0])]);
+        gen.movsx(temp, word[contextPointer + sy(terms[i][1])]);
+        gen.imul(product, temp);
+
+        if (i < 3) {
+            gen.add(rax, product);
+        } else {
+            gen.sub(rax, product);
+        }
+    }
+
+    gen.mov(dword[contextPointer + COP2_DATA_OFFSET(24)], eax);  // Set MAC0
+    // Calculate flags if the result is larger than 31 bits
+    gen.cmp(rax, 0x7fffffff);
+    gen.jle(label1);
+    gen.mov(flag, (1 << 31) | (1 << 16));
+    gen.jmp(end);
+
+    gen.L(label1);
+    gen.cmp(rax, 0x80000000);
+    gen.jge(end);
+    gen.mov(flag, (1 << 31) | (1 << 15));
+
+    gen.L(end);
+    gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], flag);  // Writeback FLAG
+}
+
+// MACn = IRn * IRn, with IR1/IR2/IR3 saturated afterwards
+void DynaRecCPU::recSQR(uint32_t code) {
+    constexpr Reg32 flag = arg1;
+    const Reg64 results[] = {rax, arg2.cvt64(), arg3.cvt64()};
+
+    gen.xor_(flag, flag);  // Set FLAG to 0
+    for (int i = 0; i < 3; i++) {
+        gen.movsx(results[i], word[contextPointer + COP2_DATA_OFFSET(9 + i)]);
+        gen.imul(results[i], results[i]);
+    }
+
+    emitGTEStoreMAC123(GTE_SF(code), GTE_LM(code), flag);
+    gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], flag);  // Writeback FLAG
+}
+
+// Outer product of the diagonal of the rotation matrix (R11, R22, R33) and IR1/IR2/IR3
+void DynaRecCPU::recOP(uint32_t code) {
+    constexpr Reg32 flag = arg1;
+    const Reg64 results[] = {rax, arg2.cvt64(), arg3.cvt64()};
+    const Reg64 temp1 = arg4.cvt64();
+    const Reg64 temp2 = flag.cvt64();  // FLAG isn't needed until the products are done
+
+    // Offsets of R11, R22 and R33 in the control registers
+    const uintptr_t diagonal[] = {COP2_CONTROL_OFFSET(0), COP2_CONTROL_OFFSET(2), COP2_CONTROL_OFFSET(4)};
+    const auto ir = [this](int i) { return COP2_DATA_OFFSET(9 + i); };
+
+    for (int i = 0; i < 3; i++) {
+        // MACn = D[n + 1] * IR[n + 2] - D[n + 2] * IR[n + 1], with indices wrapping around
+        const int j = (i + 1) % 3;
+        const int k = (i + 2) % 3;
+
+        gen.movsx(results[i], word[contextPointer + diagonal[j]]);
+        gen.movsx(temp1, word[contextPointer + ir(k)]);
+        gen.imul(results[i], temp1);
+        gen.movsx(temp1, word[contextPointer + diagonal[k]]);
+        gen.movsx(temp2, word[contextPointer + ir(j)]);
+        gen.imul(temp1, temp2);
+        gen.sub(results[i], temp1);
+    }
+
+    gen.xor_(flag, flag);  // Set FLAG to 0
+    emitGTEStoreMAC123(GTE_SF(code), GTE_LM(code), flag);
+    gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], flag);  // Writeback FLAG
+}
+
 #define GTE_FALLBACK(name)                      \
     void DynaRecCPU::rec##name(uint32_t code) { \
         gen.mov(arg2, code);                    \
@@ -468,13 +601,12 @@ GTE_FALLBACK(NCCS);
 GTE_FALLBACK(NCCT);
 GTE_FALLBACK(NCDS);
 GTE_FALLBACK(NCDT);
-GTE_FALLBACK(NCLIP);
 GTE_FALLBACK(NCS);
 GTE_FALLBACK(NCT);
-GTE_FALLBACK(OP);
 GTE_FALLBACK(RTPS);
 GTE_FALLBACK(RTPT);
-GTE_FALLBACK(SQR);
 
 #undef GTE_FALLBACK
+#undef GTE_SF
+#undef GTE_LM
 #endif  // DYNAREC_X86_64
@@ -745,6 +745,7 @@ void DynaRecCPU::recompileLoad(uint32_t code) {
     // If we won't emulate the load delay, make sure to cancel any pending loads that might trample the value
     maybeCancelDelayedLoad(_Rt_);
 
+    bool calledHandler = false;
     if (m_gprs[_Rs_].isConst()) {  // Store the address in arg2
         const uint32_t addr = m_gprs[_Rs_].val + _Imm_;
         const auto pointer = PCSX::g_emulator->m_mem->pointerRead(addr);
@@ -756,22 +757,38 @@ void DynaRecCPU::recompileLoad(uint32_t code) {
             return;
         }
 
-        gen.mov(arg2, addr);
+        if (size != 8 && _Rt_ != 0 && PCSX::HW::isLatchRead(addr)) {
+            allocateRegWithoutLoad(_Rt_);
+            m_gprs[_Rt_].setWriteback(true);
+            gen.inc(qword[contextPointer + CYCLE_OFFSET]);  // Memory counts a cycle for every data access
+            load<size, signExtend>(m_gprs[_Rt_].allocatedReg, &PCSX::g_emulator->m_mem->m_hard[addr & 0xffff]);
+            return;
+        }
+
+        calledHandler = emitHardwareLoad<size>(addr);
+        if (!calledHandler) gen.mov(arg2, addr);
     } else {
         allocateReg(_Rs_);
         gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);
+
+        if (_Rt_ != 0 && useFastMemoryPath()) {
+            emitFastLoad<size, signExtend>(code);
+            return;
+        }
     }
 
-    switch (size) {
-        case 8:
-            callMemoryFunc(&PCSX::Memory::read8);
-            break;
-        case 16:
-            callMemoryFunc(&PCSX::Memory::read16);
-            break;
-        case 32:
-            callMemoryFunc(&PCSX::Memory::read32);
-            break;
+    if (!calledHandler) {
+        switch (size) {
+            case 8:
+                callMemoryFunc(&PCSX::Memory::read8);
+                break;
+            case 16:
+                callMemoryFunc(&PCSX::Memory::read16);
+                break;
+            case 32:
+                callMemoryFunc(&PCSX::Memory::read32);
+                break;
+        }
     }
 
     if (_Rt_) {
@@ -792,6 +809,244 @@ void DynaRecCPU::recompileLoad(uint32_t code) {
     }
 }
 
+// Returns a mask of the allocated volatile registers a call out of an inline memory access has to preserve.
+// "exclude" is left out of it, as the caller is about to overwrite it.
+uint32_t DynaRecCPU::getLiveVolatiles(std::optional<Reg32> exclude) {
+    uint32_t liveVolatiles = 0;
+
+    for (auto i = ALLOCATEABLE_NON_VOLATILE_COUNT; i < m_allocatedRegisters; i++) {
+        if (m_hostRegs[i].mappedReg && !(exclude && allocateableRegisters[i] == exclude.value())) {
+            liveVolatiles |= 1 << i;
+        }
+    }
+
+    return liveVolatiles;
+}
+
+// Calls a Memory handler from the slow side of an inline memory access. Unlike callMemoryFunc, this doesn't flush
+// volatile registers, so the register allocator state stays the same on both sides of the access. Instead we save
+// the registers in the "liveVolatiles" mask on the stack around the call.
+template <typename T>
+void DynaRecCPU::emitPreservingMemoryCall(T func, uint32_t liveVolatiles) {
+    std::array<Reg64, ALLOCATEABLE_REG_COUNT> saved;
+    int savedCount = 0;
+
+    for (auto i = ALLOCATEABLE_NON_VOLATILE_COUNT; i < ALLOCATEABLE_REG_COUNT; i++) {
+        if (liveVolatiles & (1 << i)) {
+            saved[savedCount++] = allocateableRegisters[i].cvt64();
+        }
+    }
+
+    for (int i = 0; i < savedCount; i++) {
+        gen.push(saved[i]);
+    }
+
+    // Keep the stack 16-byte aligned, and give Windows its shadow space below what we pushed
+    const int stackAdjustment = ((savedCount & 1) ? 8 : 0) + (isWindows() ? 32 : 0);
+    if (stackAdjustment != 0) {
+        gen.sub(rsp, stackAdjustment);
+    }
+    emitMemberFunctionCall(func, PCSX::g_emulator->m_mem.get());
+    if (stackAdjustment != 0) {
+        gen.add(rsp, stackAdjustment);
+    }
+
+    for (int i = savedCount - 1; i >= 0; i--) {
+        gen.pop(saved[i]);
+    }
+}
+
+// Emits a load from the address in arg2 to $rt. With fastmem, this is a single host load from the FastMem region,
+// Otherwise Memory::m_readLUT gets looked up inline.
+template <int size, bool signExtend>
+void DynaRecCPU::emitFastLoad(uint32_t code) {
+    allocateRegWithoutLoad(_Rt_);
+    m_gprs[_Rt_].setWriteback(true);
+    const auto dest = m_gprs[_Rt_].allocatedReg;
+
+    if (useFastmem()) {
+        emitFastmemLoad<size, signExtend>(dest);
+    } else {
+        emitLUTLoad<size, signExtend>(dest, getLiveVolatiles(dest));
+    }
+}
+
+// Emits a load from the address in arg2 to "dest", looking up Memory::m_readLUT inline.
+// Only accesses to unmapped pages (hardware registers, expansion regions, Lua handlers...) go through Memory::read.
+template <int size, bool signExtend>
+void DynaRecCPU::emitLUTLoad(Reg32 dest, uint32_t liveVolatiles) {
+    Label slowPath, done;
+    const auto page = arg1.cvt64();
+
+    gen.mov(eax, arg2);
+    gen.shr(eax, 16);
+    loadAddress(page, PCSX::g_emulator->m_mem->m_readLUT);
+    gen.mov(page, qword[page + rax * 8]);  // Host pointer to the 64KB page we're reading from
+    gen.test(page, page);
+    gen.jz(slowPath, T_NEAR);
+
+    gen.movzx(eax, arg2.cvt16());  // Offset into the page
+    switch (size) {
+        case 8:
+            signExtend ? gen.movsx(dest, Xbyak::util::byte[page + rax])
+                       : gen.movzx(dest, Xbyak::util::byte[page + rax]);
+            break;
+        case 16:
+            signExtend ? gen.movsx(dest, word[page + rax]) : gen.movzx(dest, word[page + rax]);
+            break;
+        case 32:
+            gen.mov(dest, dword[page + rax]);
+            break;
+    }
+    gen.inc(qword[contextPointer + CYCLE_OFFSET]);  // Memory::read counts a cycle for every data access
+    gen.jmp(done, T_NEAR);
+
+    gen.L(slowPath);
+    switch (size) {
+        case 8:
+            emitPreservingMemoryCall(&PCSX::Memory::read8, liveVolatiles);
+            signExtend ? gen.movsx(dest, al) : gen.movzx(dest, al);
+            break;
+        case 16:
+            emitPreservingMemoryCall(&PCSX::Memory::read16, liveVolatiles);
+            signExtend ? gen.movsx(dest, ax) : gen.movzx(dest, ax);
+            break;
+        case 32:
+            gen.xor_(arg3, arg3);  // ReadType::Data
+            emitPreservingMemoryCall(&PCSX::Memory::read32, liveVolatiles);
+            gen.mov(dest, eax);
+            break;
+    }
+    gen.L(done);
+}
+
+// Emits a load from the address in arg2 to "dest", straight from the FastMem region. Only RAM is mapped there, so
+// the first time one of these touches anything else, it faults. The fault handler then patches the start of the
+// sequence into a jump to a thunk doing the LUT lookup, which gets emitted after the end of the block.
+template <int size, bool signExtend>
+void DynaRecCPU::emitFastmemLoad(Reg32 dest) {
+    const auto site = gen.getCurr<uint8_t*>();
+    gen.mov(rax, (uintptr_t)m_fastmem.getBase());  // 10 bytes, enough room for the jump to the thunk
+    const auto access = gen.getCurr<uintptr_t>();
+    switch (size) {
+        case 8:
+            signExtend ? gen.movsx(dest, Xbyak::util::byte[rax + arg2.cvt64()])
+                       : gen.movzx(dest, Xbyak::util::byte[rax + arg2.cvt64()]);
+            break;
+        case 16:
+            signExtend ? gen.movsx(dest, word[rax + arg2.cvt64()]) : gen.movzx(dest, word[rax + arg2.cvt64()]);
+            break;
+        case 32:
+            gen.mov(dest, dword[rax + arg2.cvt64()]);
+            break;
+    }
+    gen.inc(qword[contextPointer + CYCLE_OFFSET]);  // Memory::read counts a cycle for every data access
+    const auto resume = gen.getCurr<uint8_t*>();
+
+    const auto liveVolatiles = getLiveVolatiles(dest);
+    m_fastmemThunks.push_back([this, site, access, resume, dest, liveVolatiles]() {
+        m_fastmemSites[access] = {site, gen.getCurr<uint8_t*>()};
+        emitLUTLoad<size, signExtend>(dest, liveVolatiles);
+        gen.jmp((void*)resume, T_NEAR);
+    });
+}
+
+// Emits the fastmem slow paths the current block queued up. Must be called after the block's final jump.
+void DynaRecCPU::emitFastmemThunks() {
+    for (const auto& thunk : m_fastmemThunks) {
+        thunk();
+    }
+    m_fastmemThunks.clear();
+}
+
+// Called from the FastMem fault handler. If the fault comes from one of our fastmem loads, redirect it to its thunk
+// and patch the load so that it jumps to the thunk from now on.
+bool DynaRecCPU::handleFastmemFault(void* opaque, uintptr_t& pc) {
+    const auto that = reinterpret_cast<DynaRecCPU*>(opaque);
+    const auto it = that->m_fastmemSites.find(pc);
+    if (it == that->m_fastmemSites.end()) return false;
+
+    const auto& [site, thunk] = it->second;
+    const auto displacement = (intptr_t)thunk - (intptr_t)(site + 5);
+    assert(Xbyak::inner::IsInInt32(displacement));
+    site[0] = 0xE9;  // jmp rel32
+    memcpy(site + 1, &displacement, 4);
+
+    pc = (uintptr_t)thunk;
+    that->m_fastmemSites.erase(it);
+    return true;
+}
+
+// Emits a store of arg3 to the address in arg2, looking up Memory::m_writeLUT inline.
+// Stores that would invalidate a compiled block take the slow path, so that Memory::write can call Clear.
+template <int size>
+void DynaRecCPU::emitFastStore() {
+    Label slowPath, done;
+    const auto page = arg1.cvt64();
+    const auto blocks = arg4.cvt64();
+    const auto lutOffset = (size_t)m_recompilerLUT - (size_t)this;
+    const auto uncompiledBlockOffset = (uintptr_t)&m_uncompiledBlock - (uintptr_t)this;
+
+    gen.mov(eax, arg2);
+    gen.shr(eax, 16);
+    loadAddress(page, PCSX::g_emulator->m_mem->m_writeLUT);
+    gen.mov(page, qword[page + rax * 8]);  // Host pointer to the 64KB page we're writing to
+    gen.test(page, page);
+    gen.jz(slowPath, T_NEAR);
+
+    // Check if there's a compiled block starting at this address
+    if (Xbyak::inner::IsInInt32(lutOffset)) {
+        gen.mov(blocks, qword[contextPointer + rax * 8 + lutOffset]);
+    } else {
+        loadAddress(blocks, m_recompilerLUT);
+        gen.mov(blocks, qword[blocks + rax * 8]);
+    }
+    gen.mov(eax, arg2);
+    gen.and_(eax, 0xfffc);
+    gen.mov(blocks, qword[blocks + rax * 2]);
+    gen.cmp(blocks, qword[contextPointer + uncompiledBlockOffset]);
+    gen.jne(slowPath, T_NEAR);
+
+    gen.movzx(eax, arg2.cvt16());  // Offset into the page
+    switch (size) {
+        case 8:
+            gen.mov(Xbyak::util::byte[page + rax], arg3.cvt8());
+            break;
+        case 16:
+            gen.mov(word[page + rax], arg3.cvt16());
+            break;
+        case 32:
+            gen.mov(dword[page + rax], arg3);
+            break;
+    }
+    gen.inc(qword[contextPointer + CYCLE_OFFSET]);  // Memory::write counts a cycle for every access
+
+    // Mark the page dirty, the same way Memory::markDirty does: pages outside of RAM land past the end
+    gen.add(page, rax);
+    loadAddress(blocks, PCSX::g_emulator->m_mem->m_wram);
+    gen.sub(page, blocks);
+    gen.cmp(page, 0x00800000);
+    gen.jae(done, T_NEAR);
+    gen.shr(page, PCSX::Memory::c_dirtyPageShift);
+    loadAddress(blocks, PCSX::g_emulator->m_mem->dirtyFlag(PCSX::g_emulator->m_mem->m_wram));
+    gen.mov(Xbyak::util::byte[blocks + page], 1);
+    gen.jmp(done, T_NEAR);
+
+    gen.L(slowPath);
+    switch (size) {
+        case 8:
+            emitPreservingMemoryCall(&PCSX::Memory::write8, getLiveVolatiles(std::nullopt));
+            break;
+        case 16:
+            emitPreservingMemoryCall(&PCSX::Memory::write16, getLiveVolatiles(std::nullopt));
+            break;
+        case 32:
+            emitPreservingMemoryCall(&PCSX::Memory::write32, getLiveVolatiles(std::nullopt));
+            break;
+    }
+    gen.L(done);
+}
+
 void DynaRecCPU::recLB(uint32_t code) { recompileLoad<8, true>(code); }
 void DynaRecCPU::recLBU(uint32_t code) { recompileLoad<8, false>(code); }
 void DynaRecCPU::recLH(uint32_t code) { recompileLoad<16, true>(code); }
@@ -996,6 +1251,7 @@ void DynaRecCPU::recSB(uint32_t code) {
                 allocateReg(_Rt_);
                 store<8>(m_gprs[_Rt_].allocatedReg.cvt8(), pointer);
             }
+            markDirty(pointer);
 
             return;
         }
@@ -1020,8 +1276,12 @@ void DynaRecCPU::recSB(uint32_t code) {
         }
 
         allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2   TODO: Optimize
-        callMemoryFunc(&PCSX::Memory::write8);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2
+        if (useFastMemoryPath()) {
+            emitFastStore<8>();
+        } else {
+            callMemoryFunc(&PCSX::Memory::write8);
+        }
     }
 }
 
@@ -1036,6 +1296,7 @@ void DynaRecCPU::recSH(uint32_t code) {
                 allocateReg(_Rt_);
                 store<16>(m_gprs[_Rt_].allocatedReg.cvt16(), pointer);
             }
+            markDirty(pointer);
 
             return;
         }
@@ -1068,6 +1329,18 @@ void DynaRecCPU::recSH(uint32_t code) {
             return;
         }
 
+        else if (const auto handler = PCSX::HW::getWrite16Handler(addr)) {
+            if (m_gprs[_Rt_].isConst()) {  // Full 32-bit value to write in arg2
+                gen.moveImm(arg2, m_gprs[_Rt_].val);
+            } else {
+                allocateReg(_Rt_);
+                gen.mov(arg2, m_gprs[_Rt_].allocatedReg);
+            }
+
+            emitHardwareCall(handler, addr);
+            return;
+        }
+
         if (m_gprs[_Rt_].isConst()) {  // Full 32-bit value to write in arg3
             gen.moveImm(arg3, m_gprs[_Rt_].val);
         } else {
@@ -1088,8 +1361,12 @@ void DynaRecCPU::recSH(uint32_t code) {
         }
 
         allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2   TODO: Optimize
-        callMemoryFunc(&PCSX::Memory::write16);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2
+        if (useFastMemoryPath()) {
+            emitFastStore<16>();
+        } else {
+            callMemoryFunc(&PCSX::Memory::write16);
+        }
     }
 }
 
@@ -1104,7 +1381,33 @@ void DynaRecCPU::recSW(uint32_t code) {
                 allocateReg(_Rt_);
                 store<32>(m_gprs[_Rt_].allocatedReg, pointer);
             }
+            markDirty(pointer);
+
+            return;
+        }
+
+        if (PCSX::HW::isLatchWrite32(addr)) {
+            const auto latch = &PCSX::g_emulator->m_mem->m_hard[addr & 0xffff];
+            gen.inc(qword[contextPointer + CYCLE_OFFSET]);  // Memory counts a cycle for every data access
+            if (m_gprs[_Rt_].isConst()) {
+                store<32>(m_gprs[_Rt_].val, latch);
+            } else {
+                allocateReg(_Rt_);
+                store<32>(m_gprs[_Rt_].allocatedReg, latch);
+            }
+
+            return;
+        }
+
+        if (const auto handler = PCSX::HW::getWrite32Handler(addr)) {
+            if (m_gprs[_Rt_].isConst()) {  // Value to write in arg2
+                gen.moveImm(arg2, m_gprs[_Rt_].val);
+            } else {
+                allocateReg(_Rt_);
+                gen.mov(arg2, m_gprs[_Rt_].allocatedReg);
+            }
 
+            emitHardwareCall(handler, addr);
             return;
         }
 
@@ -1128,8 +1431,12 @@ void DynaRecCPU::recSW(uint32_t code) {
         }
 
         allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2   TODO: Optimize
-        callMemoryFunc(&PCSX::Memory::write32);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2
+        if (useFastMemoryPath()) {
+            emitFastStore<32>();
+        } else {
+            callMemoryFunc(&PCSX::Memory::write32);
+        }
     }
 }
 
@@ -1477,6 +1784,7 @@ void DynaRecCPU::recBNE(uint32_t code) {
     gen.mov(eax, m_pc + 4);  // eax = addr if jump not taken
     gen.cmovne(eax, ecx);    // if not equal, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    markSideExit(target);
 }
 
 void DynaRecCPU::recJ(uint32_t code) {
@@ -1575,6 +1883,7 @@ void DynaRecCPU::recREGIMM(uint32_t code) {
     }
 
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    markSideExit(target);
 }
 
 void DynaRecCPU::recBEQ(uint32_t code) {
@@ -1612,6 +1921,7 @@ void DynaRecCPU::recBEQ(uint32_t code) {
     gen.mov(eax, m_pc + 4);  // eax = addr if jump not taken
     gen.cmove(eax, ecx);     // if equal, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    markSideExit(target);
 }
 
 void DynaRecCPU::recBGTZ(uint32_t code) {
@@ -1645,6 +1955,7 @@ void DynaRecCPU::recBGTZ(uint32_t code) {
     gen.mov(ecx, target);    // ecx = addr if jump is taken
     gen.cmovg(eax, ecx);     // if taken, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    markSideExit(target);
 }
 
 void DynaRecCPU::recBLEZ(uint32_t code) {
@@ -1678,6 +1989,7 @@ void DynaRecCPU::recBLEZ(uint32_t code) {
     gen.mov(ecx, target);    // ecx = addr if jump is taken
     gen.cmovle(eax, ecx);    // if taken, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    markSideExit(target);
 }
 
 void DynaRecCPU::recDIV(uint32_t code) {
@@ -40,6 +40,9 @@ bool DynaRecCPU::Init() {
     m_ramBlocks = new DynarecCallback[m_ramSize / 4];
     m_biosBlocks = new DynarecCallback[biosSize / 4];
     m_dummyBlocks = new DynarecCallback[0x10000 / 4];  // Allocate one page worth of dummy blocks
+    m_ramPageInvalidations.assign(m_ramSize >> 12, 0);
+    m_ramCodePages.assign(m_ramSize >> 12, 0);
+    m_ramCodePageCount = 0;
 
     gen.reset();
 
@@ -68,20 +71,32 @@ bool DynaRecCPU::Init() {
         return false;
     }
     emitDispatcher();  // Emit our assembly dispatcher
-    uncompileAll();    // Mark all blocks as uncompiled
+    resetCodeRegions();
+    uncompileAll();  // Mark all blocks as uncompiled
 
     for (int i = 0; i < 0x10000 / 4; i++) {  // Mark all dummy blocks as invalid
         m_dummyBlocks[i] = m_invalidBlock;
     }
 
+    if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingFastmem>()) {
+        if (!m_fastmem.init(handleFastmemFault, this)) {
+            PCSX::g_system->log(PCSX::LogClass::CPU, _("[Dynarec] Fastmem isn't available, using LUT lookups\n"));
+        }
+    }
+
     if constexpr (ENABLE_SYMBOLS) {
         makeSymbols();
     }
 
+    if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecPerfMap>()) {
+        openPerfMap();
+    }
+
     if constexpr (ENABLE_PROFILER) {
         m_profiler.init();
     }
 
+    m_blockCounterCount = 0;
     m_gprs[0].markConst(0);  // $zero is always zero
     m_currentDelayedLoad = 0;
     m_runtimeLoadDelay.active = false;
@@ -89,11 +104,21 @@ bool DynaRecCPU::Init() {
 }
 
 void DynaRecCPU::Shutdown() {
+    if (useBlockCache()) {
+        saveBlockCache();
+    }
+    m_blockLinks.clear();
+    m_linkTargets.clear();
+    m_fastmem.shutdown();
+    m_fastmemSites.clear();
+    m_fastmemThunks.clear();
     delete[] m_recompilerLUT;
     delete[] m_ramBlocks;
     delete[] m_biosBlocks;
     delete[] m_dummyBlocks;
 
+    m_perfMap.close();
+
     if constexpr (ENABLE_SYMBOLS) {
         std::ofstream out("DynarecOutput.map");
         out << m_symbols;
@@ -110,6 +135,10 @@ void DynaRecCPU::Reset() {
     R3000Acpu::Reset();  // Reset CPU registers
     Shutdown();          // Deinit and re-init dynarec
     Init();
+
+    if (useBlockCache()) {
+        precompileCachedBlocks();
+    }
 }
 
 std::unique_ptr<PCSX::R3000Acpu> PCSX::Cpus::getDynaRec() { return std::unique_ptr<PCSX::R3000Acpu>(new DynaRecCPU()); }
@@ -141,15 +170,148 @@ void DynaRecCPU::uncompileAll() {
     for (auto i = 0; i < m_ramSize / 4; i++) {  // Mark all RAM blocks as uncompiled
         m_ramBlocks[i] = m_uncompiledBlock;
     }
+    std::fill(m_ramCodePages.begin(), m_ramCodePages.end(), 0);
+    m_ramCodePageCount = 0;
     for (auto i = 0; i < biosSize / 4; i++) {  // Mark all BIOS blocks as uncompiled
         m_biosBlocks[i] = m_uncompiledBlock;
     }
 }
 
-void DynaRecCPU::flushCache() {
-    gen.reset();       // Reset the emitter's code pointer and code size variables
-    emitDispatcher();  // Re-emit dispatcher
-    uncompileAll();    // Mark all blocks as uncompiled
+// Called whenever a block gets compiled, so that Clear and invalidateCache know which pages of RAM hold code
+void DynaRecCPU::markCodePage(DynarecCallback* slot) {
+    if (isRamBlock(slot)) {
+        auto& page = m_ramCodePages[(slot - m_ramBlocks) >> 10];
+        if (!page) {
+            page = 1;
+            m_ramCodePageCount++;
+        }
+    }
+}
+
+// Uncompiles every RAM block. Games flush the instruction cache way more often than they actually load code,
+// So we only touch the pages blocks got compiled from, unless there's enough of them that one big memset is faster.
+void DynaRecCPU::invalidateCodePages() {
+    const int pageCount = m_ramCodePages.size();
+
+    if (m_ramCodePageCount >= pageCount / 4) {
+        m_invalidateBlocks();
+    } else if (m_ramCodePageCount != 0) {
+        for (int page = 0; page < pageCount; page++) {
+            if (m_ramCodePages[page]) {
+                std::fill_n(&m_ramBlocks[page * 1024], 1024, m_uncompiledBlock);
+            }
+        }
+    }
+
+    std::fill(m_ramCodePages.begin(), m_ramCodePages.end(), 0);
+    m_ramCodePageCount = 0;
+    m_jitStats.invalidations++;
+}
+
+// Splits whatever is left of the code cache past the dispatcher into equally sized regions, all of them empty
+void DynaRecCPU::resetCodeRegions() {
+    const size_t start = (gen.getSize() + 15) & ~size_t(15);
+    const size_t regionSize = ((codeCacheSize - start) / CODE_CACHE_REGIONS) & ~size_t(15);
+
+    for (int i = 0; i < CODE_CACHE_REGIONS; i++) {
+        auto& region = m_codeRegions[i];
+        region.start = start + i * regionSize;
+        region.end = (i == CODE_CACHE_REGIONS - 1) ? codeCacheSize : region.start + regionSize;
+        region.blocks.clear();
+    }
+
+    m_currentRegion = 0;
+    m_codeHighWater = 0;
+    m_blockCounterCount = 0;
+    m_freeBlockCounters.clear();
+    m_blockCounterSlots.clear();
+}
+
+// Called when the current region is full. Code goes on in the next one, wrapping around to the oldest region,
+// whose blocks get evicted. Blocks that keep running will simply get compiled again in the new region.
+void DynaRecCPU::nextCodeRegion() {
+    m_codeHighWater = std::max(m_codeHighWater, gen.getSize());
+    m_currentRegion = (m_currentRegion + 1) % CODE_CACHE_REGIONS;
+    auto& region = m_codeRegions[m_currentRegion];
+
+    evictCodeRegion(region);
+    gen.setSize(region.start);
+}
+
+void DynaRecCPU::evictCodeRegion(CodeRegion& region) {
+    if (region.blocks.empty()) return;  // Not used yet
+
+    m_jitStats.cacheEvictions++;
+    const auto start = gen.getCode<uintptr_t>() + region.start;
+    const auto end = gen.getCode<uintptr_t>() + region.end;
+    const auto inRegion = [start, end](const void* pointer) {
+        return (uintptr_t)pointer >= start && (uintptr_t)pointer < end;
+    };
+
+    // Jumps out of the evicted blocks are about to be overwritten, so they must not get patched anymore
+    for (auto it = m_blockLinks.begin(); it != m_blockLinks.end();) {
+        auto& links = it->second;
+        std::erase_if(links, [&inRegion](const BlockLink& link) { return inRegion(link.site); });
+        if (links.empty()) {
+            it = m_blockLinks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Blocks that got recompiled or invalidated since no longer point here, and are left alone.
+    // The others go back to uncompiled, and the blocks jumping straight into them go back through the dispatcher.
+    for (const auto slot : region.blocks) {
+        if (!inRegion((void*)*slot)) continue;
+        unlinkBlock(slot);
+        m_linkTargets.erase(slot);  // Its outgoing links got dropped above
+        releaseBlockCounter(slot);
+        *slot = m_uncompiledBlock;
+    }
+
+    for (auto it = m_fastmemSites.begin(); it != m_fastmemSites.end();) {
+        if (inRegion((void*)it->first)) {
+            it = m_fastmemSites.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    region.blocks.clear();
+}
+
+// Returns the index of a free tiered compilation counter, or -1 if they're all in use
+int DynaRecCPU::allocateBlockCounter() {
+    if (m_freeBlockCounters.empty() && m_blockCounterCount == MAX_BLOCK_COUNTERS) {
+        // Out of counters. Take back the ones whose block got uncompiled without us hearing about it
+        for (auto it = m_blockCounterSlots.begin(); it != m_blockCounterSlots.end();) {
+            if (*it->first != it->second.code) {
+                m_freeBlockCounters.push_back(it->second.index);
+                it = m_blockCounterSlots.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (!m_freeBlockCounters.empty()) {
+        const auto index = m_freeBlockCounters.back();
+        m_freeBlockCounters.pop_back();
+        return index;
+    }
+    if (m_blockCounterCount < MAX_BLOCK_COUNTERS) {
+        return m_blockCounterCount++;
+    }
+    return -1;
+}
+
+// Called when the block at "slot" goes away or gets replaced, so its counter can be handed out again
+void DynaRecCPU::releaseBlockCounter(DynarecCallback* slot) {
+    const auto it = m_blockCounterSlots.find(slot);
+    if (it == m_blockCounterSlots.end()) return;
+
+    m_freeBlockCounters.push_back(it->second.index);
+    m_blockCounterSlots.erase(it);
 }
 
 void DynaRecCPU::emitBlockLookup() {
@@ -312,16 +474,27 @@ void DynaRecCPU::emitDispatcher() {
     gen.mov(arg2, 1);                   // Fully emulate load delays
     gen.callFunc(recRecompileWrapper);  // Call recompilation function. Returns pointer to emitted code
     gen.jmp(rax);
+
+    // Code to recompile the current block as a superblock once it's hot
+    gen.align(16);
+    m_promoteBlock = gen.getCurr<DynarecCallback>();
+    loadThisPointer(arg1.cvt64());
+    gen.callFunc(recPromoteWrapper);  // Call recompilation function. Returns pointer to emitted code
+    gen.jmp(rax);
 }
 
 // Compile a block, write address of compiled code to *callback
 // Returns the address of the compiled block
-DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation, bool align) {
+// Unless "hot" is set, the block can get compiled as a baseline block first. See HOT_BLOCK_THRESHOLD
+DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation, bool align, bool hot) {
     m_stopCompiling = false;
     m_inDelaySlot = false;
     m_nextIsDelaySlot = false;
     m_pcWrittenBack = false;
     m_linkedPC = std::nullopt;
+    m_sideExitTarget = std::nullopt;
+    m_loadDelayAcrossBlocks = false;
+    m_fastmemThunks.clear();
     m_delayedLoadInfo[0].active = false;
     m_delayedLoadInfo[1].active = false;
     m_pc = pc & ~3;
@@ -332,16 +505,32 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
     // If we somehow ended up compiling a block at an invalid PC, throw an error.
     if (!isPcValid(m_pc)) return m_invalidBlock;
 
+    // Blocks that needed full load delay emulation last time get compiled that way straight away
+    if (!m_fullLoadDelayEmulation && useBlockCache()) {
+        const auto cached = findCachedBlock(m_pc);
+        if (cached && cached->fullLoadDelays) {
+            m_fullLoadDelayEmulation = true;
+        }
+    }
+
     const auto startingPC = m_pc;
     unsigned count = 0;                                 // How many instructions have we compiled?
+    unsigned sideExits = 0;                             // How many branches have we continued past?
     DynarecCallback* callback = getBlockPointer(m_pc);  // Pointer to where we'll store the addr of the emitted code
+    // Blocks with full load delay emulation aren't worth tiering, as they only happen on the odd block boundary
+    const int counterIndex =
+        ENABLE_TIERED_COMPILATION && !hot && !m_fullLoadDelayEmulation ? allocateBlockCounter() : -1;
+    const bool baseline = counterIndex >= 0;
+    const int maxBlockSize = baseline ? MAX_BLOCK_SIZE : getMaxBlockSize(callback);
+    bool couldExtend = false;  // Would a superblock have kept going past one of this block's branches?
 
     if (align) {
         gen.align(16);  // Align next block
     }
 
-    if (gen.getSize() > codeCacheSize) {  // Flush JIT cache if we've gone above the acceptable size
-        flushCache();
+    // Move on to the next region of the code cache if this one is full
+    if (gen.getSize() + CODE_REGION_SLACK > m_codeRegions[m_currentRegion].end) {
+        nextCodeRegion();
     }
 
     if constexpr (ENABLE_SYMBOLS) {
@@ -350,9 +539,27 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
         gen.mov(contextPointer, (uintptr_t)this);
     }
 
+    // Whatever was compiled here before is dead code now, whose jumps must not be patched or tracked anymore
+    dropBlockLinks(callback);
+    // If we're replacing an existing block (eg when recompiling with full load delays), blocks linked to the old
+    // version need to go back through the dispatcher to find the new one. Promoted blocks are the hottest ones
+    // though, so their links are kept, and get pointed at the new version once it's done.
+    if (*callback != m_uncompiledBlock) {
+        if (hot) {
+            m_jitStats.blocksPromoted++;
+        } else {
+            unlinkBlock(callback);
+        }
+    }
+    releaseBlockCounter(callback);
     *callback = gen.getCurr<DynarecCallback>();  // Pointer to emitted code
+    m_compilingSlot = callback;
+    m_codeRegions[m_currentRegion].blocks.push_back(callback);
+    m_jitStats.blocksCompiled++;
+    markCodePage(callback);
     if constexpr (ENABLE_PROFILER) {
         if (startProfiling(m_pc)) {  // Uncompile all blocks if the profiler data overflower
+            unlinkAll();
             uncompileAll();
         }
     }
@@ -365,21 +572,58 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
         gen.cmp(Xbyak::util::byte[contextPointer + isActiveOffset], 0);
         gen.jne((void*)m_needFullLoadDelays);
     }
+
+    uint8_t* counterSite = nullptr;
+    if (baseline) {
+        m_blockCounterSlots[callback] = {counterIndex, *callback};
+        const auto counterOffset = (uintptr_t)&m_blockCounters[counterIndex] - (uintptr_t)this;
+        m_blockCounters[counterIndex] = HOT_BLOCK_THRESHOLD;
+
+        counterSite = gen.getCurr<uint8_t*>();
+        gen.dec(dword[contextPointer + counterOffset]);
+        gen.jz((void*)m_promoteBlock, T_NEAR);
+    }
+    const auto counterEnd = gen.getCurr<uint8_t*>();
     handleKernelCall();  // Check if this is a kernel call vector, emit some extra code in that case.
 
-    const auto shouldContinue = [this, &count]() {
+    const auto shouldContinue = [this, &count, maxBlockSize]() {
         if (m_nextIsDelaySlot) {
             return true;
         }
         if (m_stopCompiling) {
             return false;
         }
-        if (count >= MAX_BLOCK_SIZE && !m_delayedLoadInfo[0].active && !m_delayedLoadInfo[1].active) {
+        if (count >= maxBlockSize && !m_delayedLoadInfo[0].active && !m_delayedLoadInfo[1].active) {
             return false;
         }
         return true;
     };
 
+    // Once a conditional branch and its delay slot have been compiled, check if we can keep going down the
+    // fall-through path instead of ending the block there
+    const auto canExtendBlock = [this, &count, &sideExits, &memory, &couldExtend, baseline, maxBlockSize]() {
+        if (!m_stopCompiling || m_nextIsDelaySlot || !m_sideExitTarget) {
+            return false;
+        }
+        if (baseline) {
+            // Remember there's something to gain from recompiling this block once it's hot
+            couldExtend = true;
+            return false;
+        }
+        if (count >= maxBlockSize || sideExits >= MAX_SIDE_EXITS) {
+            return false;
+        }
+        if (m_delayedLoadInfo[0].active || m_delayedLoadInfo[1].active) {
+            return false;
+        }
+        // Kernel call vectors and the shell entrypoint need their block-entry hooks, so they always start a block
+        const uint32_t pc = m_pc & PCSX::g_emulator->getRamMask();
+        if (pc == 0xA0 || pc == 0xB0 || pc == 0xC0 || m_pc == 0x80030000) {
+            return false;
+        }
+        return isPcValid(m_pc) && memory->getPointer<uint32_t>(m_pc) != nullptr;
+    };
+
     const auto processDelayedLoad = [this]() {
         m_currentDelayedLoad ^= 1;
         auto& delayedLoad = m_delayedLoadInfo[m_currentDelayedLoad];
@@ -438,27 +682,57 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
             return m_invalidBlock;
         }
         processDelayedLoad();
+
+        if (canExtendBlock()) {
+            emitSideExit(count);
+            sideExits++;
+        }
     }
 
-    flushRegs();
-    if (!m_pcWrittenBack) {
-        gen.mov(dword[contextPointer + PC_OFFSET], m_pc);
+    // Recompiling a block that wouldn't change as a superblock is a waste of time, so jump over its counter
+    if (counterSite && !couldExtend) {
+        counterSite[0] = 0xEB;  // jmp rel8
+        counterSite[1] = uint8_t(counterEnd - counterSite - 2);
     }
 
     // If this was the block at 0x8003'0000 (Start of shell), don't link the PC in case we fastboot
     if (startingPC == 0x80030000) {
         m_linkedPC = std::nullopt;
     }
+    const bool link = m_linkedPC && ENABLE_BLOCK_LINKING && m_linkedPC.value() != startingPC;
+
+    // When jumping straight into the next block, registers it overwrites before reading don't need to be written back
+    if (link && canLink(m_linkedPC.value()) && !m_loadDelayAcrossBlocks) {
+        flushRegs(getDeadRegistersOnEntry(m_linkedPC.value()));
+    } else {
+        flushRegs();
+    }
+    if (!m_pcWrittenBack) {
+        gen.mov(dword[contextPointer + PC_OFFSET], m_pc);
+    }
+
     if constexpr (ENABLE_PROFILER) {
         endProfiling();
     }
 
     gen.add(qword[contextPointer + CYCLE_OFFSET], count * PCSX::Emulator::BIAS);  // Add block cycles;
-    if (m_linkedPC && ENABLE_BLOCK_LINKING && m_linkedPC.value() != startingPC) {
+    if (m_perfMap.is_open()) {
+        // Linking may compile the next block right after this one, so only the body of the block gets recorded
+        const auto start = (const uint8_t*)*callback;
+        recordPerfMapEntry(startingPC, start, gen.getCurr<const uint8_t*>() - start);
+    }
+    if (useBlockCache()) {
+        recordCachedBlock(startingPC, (m_pc - startingPC) / 4, m_fullLoadDelayEmulation);
+    }
+    if (link) {
         handleLinking();
     } else {
         gen.jmp((void*)m_returnFromBlock);
     }
+    emitFastmemThunks();
+    if (hot) {
+        relinkBlock(callback);
+    }
 
     // Block linking might have invalidated this block, so don't cache the pointer to the invalidated block.
     // Instead, read the callback address again
@@ -484,7 +758,13 @@ void DynaRecCPU::handleKernelCall() {
     if ((base != 0x000) && (base != 0x800) && (base != 0xa00))
         return;  // Mask out the segment, return if not a kernel call vector
 
-    if (pc == 0xA0 || pc == 0xB0 || pc == 0xC0) {
+    if (pc == 0xA0 && !m_fullLoadDelayEmulation) {
+        // The call may get run natively, in which case the pc now points back at the caller
+        gen.mov(arg2, m_pc);
+        emitMemberFunctionCall(&PCSX::R3000Acpu::InterceptBIOS<false, true>, this);
+        gen.test(al, al);
+        gen.jnz((void*)m_returnFromBlock, T_NEAR);
+    } else if (pc == 0xA0 || pc == 0xB0 || pc == 0xC0) {
         gen.mov(arg2, m_pc);
         emitMemberFunctionCall(&PCSX::R3000Acpu::InterceptBIOS<false>, this);
     }
@@ -493,44 +773,308 @@ void DynaRecCPU::handleKernelCall() {
 // Emits a jump to the dispatcher if there's no block to link to.
 // Otherwise, handle linking blocks
 void DynaRecCPU::handleLinking() {
-    // Don't link unless the next PC is valid, and there's over 1MB of free space in the code cache
-    if (isPcValid(m_linkedPC.value()) && gen.getRemainingSize() > 0x100000) {
+    if (canLink(m_linkedPC.value())) {
         const auto nextPC = m_linkedPC.value();
         const auto nextBlockPointer = getBlockPointer(nextPC);
-        const auto nextBlockOffset = (size_t)nextBlockPointer - (size_t)this;
 
         if (*nextBlockPointer == m_uncompiledBlock) {  // If the next block hasn't been compiled yet
-            // Check that the block hasn't been invalidated/moved
-            // The value will be patched later. Since all code is within the same 32MB segment,
-            // We can get away with only checking the low 32 bits of the block pointer
-            if (Xbyak::inner::IsInInt32(nextBlockOffset)) {
-                gen.cmp(dword[contextPointer + nextBlockOffset], 0xcccccccc);
-            } else {
-                loadAddress(rax, nextBlockPointer);
-                gen.cmp(dword[rax], 0xcccccccc);
+            // Emit a link to the dispatcher for now, compile the next block right after this one,
+            // Then point the link at it. This ends up being a jump over the alignment padding.
+            const auto site = emitLinkedJump(nextBlockPointer, nullptr);
+            emitFastmemThunks();       // The next block is about to queue up its own
+            recompile(nextPC, false);  // Fallthrough to next block
+
+            // The next block might have failed to compile, in which case we keep going through the dispatcher
+            if (*nextBlockPointer != m_uncompiledBlock && *nextBlockPointer != m_invalidBlock) {
+                patchLinkedJump(site, *nextBlockPointer);
             }
+        } else {  // If it has already been compiled, link by jumping to the compiled code
+            emitLinkedJump(nextBlockPointer, *nextBlockPointer);
+        }
+    } else {  // Can't link, so return to dispatcher
+        gen.jmp((void*)m_returnFromBlock);
+    }
+}
 
-            const auto pointer = gen.getCurr<uint8_t*>();
-            gen.jne((void*)m_returnFromBlock);  // Return if the block addr changed
-            recompile(nextPC, false);           // Fallthrough to next block
+// Called by Clear when a compiled block gets invalidated
+void DynaRecCPU::blockInvalidated(DynarecCallback* slot) {
+    if (!m_blockLinks.empty()) {
+        unlinkBlock(slot);
+    }
+    if (!m_linkTargets.empty()) {
+        dropBlockLinks(slot);
+    }
+    releaseBlockCounter(slot);
 
-            *(uint32_t*)(pointer - 4) = (uint32_t)(uintptr_t)*nextBlockPointer;  // Patch comparison value
-        } else {  // If it has already been compiled, link by jumping to the compiled code
-            if (Xbyak::inner::IsInInt32(nextBlockOffset)) {
-                gen.cmp(dword[contextPointer + nextBlockOffset], (uint32_t)(uintptr_t)*nextBlockPointer);
+    if (slot >= m_ramBlocks && slot < m_ramBlocks + m_ramSize / 4) {
+        auto& invalidations = m_ramPageInvalidations[(slot - m_ramBlocks) >> 10];  // 1024 entrypoints per 4KB page
+        if (invalidations != 0xff) {
+            invalidations++;
+        }
+    }
+}
+
+// Regions that keep getting recompiled (overlays, self-modifying code, data accidentally executed) stick to short
+// blocks, as a superblock there would just be thrown away again. Everything else can form superblocks.
+int DynaRecCPU::getMaxBlockSize(DynarecCallback* slot) {
+    if (slot >= m_ramBlocks && slot < m_ramBlocks + m_ramSize / 4) {
+        if (m_ramPageInvalidations[(slot - m_ramBlocks) >> 10] >= SUPERBLOCK_INVALIDATION_THRESHOLD) {
+            return MAX_BLOCK_SIZE;
+        }
+    }
+
+    return MAX_SUPERBLOCK_SIZE;
+}
+
+// Called by conditional branches whose outcome isn't known at compile time, after the PC has been written back.
+// Forward branches are most often not taken (if/else skips), so those are the ones we follow the fall-through of.
+// Backwards branches close loops and are usually taken, so we keep ending the block on them.
+void DynaRecCPU::markSideExit(uint32_t target) {
+    if (target < m_pc) return;
+
+    // Only continue past delay slots that can't end the block or start a load delay themselves
+    const uint32_t delaySlot = PCSX::g_emulator->m_mem->read32(m_pc, PCSX::Memory::ReadType::Instr);
+    const auto opcode = delaySlot >> 26;
+    bool safe = false;
+
+    if (opcode == 0) {
+        // Shifts, HI/LO moves, multiplications/divisions and register ALU ops
+        constexpr uint64_t safeSpecials = 0x00000cff'0f0f00ddULL;
+        safe = ((safeSpecials >> (delaySlot & 0x3f)) & 1) != 0;
+    } else {
+        // Immediate ALU ops, and stores
+        safe = (opcode >= 0x08 && opcode < 0x10) || (opcode >= 0x28 && opcode < 0x2f && opcode != 0x2c &&
+                                                    opcode != 0x2d);
+    }
+
+    if (safe) {
+        m_sideExitTarget = target;
+    }
+}
+
+// Ends the current branch with a conditional exit for the taken path, then lets compilation resume on the
+// fall-through path. The branch already wrote the next PC back, so all we need to do is compare against it.
+void DynaRecCPU::emitSideExit(unsigned count) {
+    Label notTaken;
+    const auto target = m_sideExitTarget.value();
+
+    flushRegs();
+    gen.cmp(dword[contextPointer + PC_OFFSET], target);
+    gen.jne(notTaken, T_NEAR);
+
+    if constexpr (ENABLE_PROFILER) {
+        endProfiling();
+    }
+    gen.add(qword[contextPointer + CYCLE_OFFSET], count * PCSX::Emulator::BIAS);  // Add cycles up to this exit
+
+    // Link to the taken path if it's already compiled. We can't compile it now, since we're in the middle of a block
+    const auto targetPointer = isPcValid(target) ? getBlockPointer(target) : nullptr;
+    if (ENABLE_BLOCK_LINKING && targetPointer && *targetPointer != m_uncompiledBlock) {
+        emitLinkedJump(targetPointer, *targetPointer);
+    } else {
+        gen.jmp((void*)m_returnFromBlock);
+    }
+    gen.L(notTaken);
+
+    m_sideExitTarget = std::nullopt;
+    m_stopCompiling = false;
+    m_pcWrittenBack = false;
+}
+
+// Don't link unless the next PC is valid, and there's enough free space left in the current region of the code cache.
+// Linking can compile the next block right away, and a chain of blocks must not move on to the next region halfway.
+bool DynaRecCPU::canLink(uint32_t pc) { return isPcValid(pc) && getRegionRemainingSize() > 4 * CODE_REGION_SLACK; }
+
+// Emits a patchable jmp rel32 to "target" and records it as a link into the block at "targetSlot"
+// If target is nullptr, the jump goes to the unlinked path until it gets patched.
+// All code lives in the same 32MB buffer, so a rel32 displacement can always reach
+// Returns the link site
+uint8_t* DynaRecCPU::emitLinkedJump(DynarecCallback* targetSlot, DynarecCallback target) {
+    // Force the 5-byte encoding so the displacement can be patched later
+    gen.jmp(target ? (void*)target : (void*)m_returnFromBlock, T_NEAR);
+    const auto site = gen.getCurr<uint8_t*>();
+    DynarecCallback fallback = m_returnFromBlock;
+
+    // If flushRegs skipped writebacks because of this link, the unlinked path needs to perform them before
+    // going back to the dispatcher. The values are still in their host registers when the jump executes.
+    if (!m_elidedWritebacks.empty()) {
+        fallback = gen.getCurr<DynarecCallback>();
+        for (const auto& writeback : m_elidedWritebacks) {
+            if (writeback.isConst) {
+                gen.mov(dword[contextPointer + GPR_OFFSET(writeback.index)], writeback.value);
             } else {
-                loadAddress(rax, nextBlockPointer);
-                gen.cmp(dword[rax], (uint32_t)(uintptr_t)*nextBlockPointer);
+                gen.mov(dword[contextPointer + GPR_OFFSET(writeback.index)], writeback.reg);
             }
-
-            gen.jne((void*)m_returnFromBlock);  // Return if the block addr changed
-            gen.jmp((void*)*nextBlockPointer);  // Jump to linked block otherwise
         }
-    } else {  // Can't link, so return to dispatcher
         gen.jmp((void*)m_returnFromBlock);
+        m_elidedWritebacks.clear();
+
+        if (!target) {
+            patchLinkedJump(site, fallback);
+        }
+    }
+
+    m_blockLinks[targetSlot].push_back({site, fallback, m_compilingSlot});
+    auto& targets = m_linkTargets[m_compilingSlot];
+    if (targets.empty() || targets.back() != targetSlot) {
+        targets.push_back(targetSlot);
+    }
+    return site;
+}
+
+void DynaRecCPU::patchLinkedJump(uint8_t* site, DynarecCallback target) {
+    const auto displacement = (intptr_t)target - (intptr_t)site;
+    assert(Xbyak::inner::IsInInt32(displacement));
+    *(int32_t*)(site - 4) = (int32_t)displacement;
+}
+
+// Called when the block at "slot" is invalidated. Every block that jumps directly into it gets redirected to the
+// dispatcher. The PC has already been written back by the time a linked jump executes, so this is always safe.
+void DynaRecCPU::unlinkBlock(DynarecCallback* slot) {
+    const auto it = m_blockLinks.find(slot);
+    if (it == m_blockLinks.end()) return;
+
+    for (const auto& link : it->second) {
+        patchLinkedJump(link.site, link.fallback);
+    }
+    m_blockLinks.erase(it);
+}
+
+// Called once a block got promoted, to point the jumps into its baseline version at the new code. Links whose site got
+// evicted while compiling are gone already, and if the block itself got invalidated meanwhile, it's unlinked instead.
+void DynaRecCPU::relinkBlock(DynarecCallback* slot) {
+    if (*slot == m_uncompiledBlock || *slot == m_invalidBlock) {
+        unlinkBlock(slot);
+        return;
+    }
+
+    const auto it = m_blockLinks.find(slot);
+    if (it == m_blockLinks.end()) return;
+
+    for (const auto& link : it->second) {
+        patchLinkedJump(link.site, *slot);
     }
 }
 
+bool DynaRecCPU::isBlockLinked(uint32_t from, uint32_t to) {
+    if (!isPcValid(from) || !isPcValid(to)) return false;
+    const auto source = getBlockPointer(from);
+    const auto it = m_blockLinks.find(getBlockPointer(to));
+    if (it == m_blockLinks.end()) return false;
+
+    return std::any_of(it->second.begin(), it->second.end(),
+                       [source](const BlockLink& link) { return link.source == source; });
+}
+
+// Called when the block at "source" is invalidated or replaced. The jumps it contains are dead code from now on, so
+// their entries go away instead of piling up until the code cache region gets evicted.
+void DynaRecCPU::dropBlockLinks(DynarecCallback* source) {
+    const auto it = m_linkTargets.find(source);
+    if (it == m_linkTargets.end()) return;
+
+    for (const auto targetSlot : it->second) {
+        const auto links = m_blockLinks.find(targetSlot);
+        if (links == m_blockLinks.end()) continue;  // Already unlinked
+        std::erase_if(links->second, [source](const BlockLink& link) { return link.source == source; });
+        if (links->second.empty()) {
+            m_blockLinks.erase(links);
+        }
+    }
+    m_linkTargets.erase(it);
+}
+
+void DynaRecCPU::unlinkAll() {
+    for (const auto& [slot, links] : m_blockLinks) {
+        for (const auto& link : links) {
+            patchLinkedJump(link.site, link.fallback);
+        }
+    }
+    m_blockLinks.clear();
+    m_linkTargets.clear();
+}
+
+// Scans the start of the block at "pc" and returns a mask of the guest registers it overwrites before reading them.
+// We stop at the first instruction that isn't a plain ALU op, as anything else (memory accesses, branches,
+// exceptions, COP moves) might call into C++ code or leave the block, and expect registers to be up to date.
+uint32_t DynaRecCPU::getDeadRegistersOnEntry(uint32_t pc) {
+    // Kernel call vectors and the shell entrypoint call into C++ code as soon as the block starts
+    const uint32_t maskedPC = pc & PCSX::g_emulator->getRamMask();
+    if (maskedPC == 0xA0 || maskedPC == 0xB0 || maskedPC == 0xC0 || pc == 0x80030000) {
+        return 0;
+    }
+
+    auto& memory = PCSX::g_emulator->m_mem;
+    uint32_t read = 0;
+    uint32_t dead = 0;
+
+    for (int i = 0; i < 16; i++) {
+        const uint32_t* ptr = memory->getPointer<uint32_t>(pc + i * 4);
+        if (!ptr) break;
+
+        const uint32_t code = *ptr;
+        const auto rs = 1u << _Rs_;
+        const auto rt = 1u << _Rt_;
+        const auto rd = 1u << _Rd_;
+        uint32_t reads = 0;
+        uint32_t writes = 0;
+
+        switch (code >> 26) {
+            case 0x00:
+                switch (code & 0x3f) {
+                    case 0x00:  // SLL
+                    case 0x02:  // SRL
+                    case 0x03:  // SRA
+                        reads = rt;
+                        writes = rd;
+                        break;
+                    case 0x04:  // SLLV
+                    case 0x06:  // SRLV
+                    case 0x07:  // SRAV
+                    case 0x20:  // ADD
+                    case 0x21:  // ADDU
+                    case 0x22:  // SUB
+                    case 0x23:  // SUBU
+                    case 0x24:  // AND
+                    case 0x25:  // OR
+                    case 0x26:  // XOR
+                    case 0x27:  // NOR
+                    case 0x2a:  // SLT
+                    case 0x2b:  // SLTU
+                        reads = rs | rt;
+                        writes = rd;
+                        break;
+                    case 0x10:  // MFHI
+                    case 0x12:  // MFLO
+                        writes = rd;
+                        break;
+                    default:
+                        return dead & ~1u;
+                }
+                break;
+            case 0x08:  // ADDI
+            case 0x09:  // ADDIU
+            case 0x0a:  // SLTI
+            case 0x0b:  // SLTIU
+            case 0x0c:  // ANDI
+            case 0x0d:  // ORI
+            case 0x0e:  // XORI
+                reads = rs;
+                writes = rt;
+                break;
+            case 0x0f:  // LUI
+                writes = rt;
+                break;
+            default:
+                return dead & ~1u;
+        }
+
+        read |= reads & ~dead;
+        dead |= writes & ~read;
+    }
+
+    return dead & ~1u;  // $zero is never written back anyway
+}
+
 void DynaRecCPU::handleShellReached() {
     Xbyak::Label alreadyReached;
 
@@ -548,14 +1092,82 @@ void DynaRecCPU::handleShellReached() {
 // Peek at the next instruction to see if it has a read dependency on register "index"
 // If it does, we need to emulate the load delay
 DynaRecCPU::LoadDelayDependencyType DynaRecCPU::getLoadDelayDependencyType(int index) {
-    // Always emulate load delays when there's a load in a branch delay slot
-    if (m_stopCompiling && index != 0) return LoadDelayDependencyType::DependencyAcrossBlocks;
-
     if (index == 0) {  // Loads to $zero go to the void, so don't bother emulating it as a delayed load
         return LoadDelayDependencyType::NoDependency;
     }
 
+    // A load in a branch delay slot lands in whichever block comes next, so only emulate the delay if that block
+    // could actually observe it
+    if (m_stopCompiling) {
+        if (!delaySlotLoadIsObservable(index)) {
+            return LoadDelayDependencyType::NoDependency;
+        }
+        m_loadDelayAcrossBlocks = true;
+        return LoadDelayDependencyType::DependencyAcrossBlocks;
+    }
+
     const uint32_t instruction = PCSX::g_emulator->m_mem->read32(m_pc, PCSX::Memory::ReadType::Instr);
+    return readsRegister(instruction, index) ? LoadDelayDependencyType::DependencyInsideBlock
+                                             : LoadDelayDependencyType::NoDependency;
+}
+
+// Check whether the block following the branch we're compiling the delay slot of could read register "index" before
+// the delayed load lands. The successors of a direct jump or a conditional branch are known statically, so look at the
+// first instruction of each of them. Anything we can't see through (indirect jumps, blocks ending for other reasons,
+// kernel call vectors and the like) is assumed to observe the delay.
+// Whatever we find gets baked into this block, but any other block can be invalidated or recompiled on its own, and
+// nothing would invalidate this one along with it. So only a branch back to the start of this very block, whose first
+// instruction can't change without this block going away too, is looked at. Every other successor observes the delay.
+bool DynaRecCPU::delaySlotLoadIsObservable(int index) {
+    if (!m_inDelaySlot) return true;
+
+    auto& memory = PCSX::g_emulator->m_mem;
+    const uint32_t branchPC = m_pc - 8;
+    const uint32_t* branchPtr = memory->getPointer<uint32_t>(branchPC);
+    if (!branchPtr) return true;
+
+    const uint32_t branch = *branchPtr;
+    const uint32_t opcode = branch >> 26;
+    const uint32_t branchTarget = branchPC + 4 + (uint32_t(int16_t(branch)) << 2);
+    uint32_t successors[2];
+    unsigned successorCount = 0;
+
+    switch (opcode) {
+        case 0:  // JR/JALR are only followed when their target was known at compile time
+            if ((branch & 0x3e) != 0x08 || !m_linkedPC) return true;
+            successors[successorCount++] = m_linkedPC.value();
+            break;
+        case 0x01:  // BLTZ/BGEZ/BLTZAL/BGEZAL
+        case 0x04:  // BEQ
+        case 0x05:  // BNE
+        case 0x06:  // BLEZ
+        case 0x07:  // BGTZ
+            successors[successorCount++] = branchTarget;
+            successors[successorCount++] = m_pc;
+            break;
+        case 0x02:  // J
+        case 0x03:  // JAL
+            successors[successorCount++] = ((branchPC + 4) & 0xf0000000) | ((branch & 0x3ffffff) << 2);
+            break;
+        default:
+            return true;
+    }
+
+    for (unsigned i = 0; i < successorCount; i++) {
+        const uint32_t pc = successors[i];
+        const uint32_t maskedPC = pc & PCSX::g_emulator->getRamMask();
+        if (maskedPC == 0xA0 || maskedPC == 0xB0 || maskedPC == 0xC0 || pc == 0x80030000) return true;
+        if (!isPcValid(pc) || getBlockPointer(pc) != m_compilingSlot) return true;
+
+        const uint32_t* ptr = memory->getPointer<uint32_t>(pc);
+        if (!ptr || readsRegister(*ptr, index)) return true;
+    }
+
+    return false;
+}
+
+// Check if an instruction reads register "index"
+bool DynaRecCPU::readsRegister(uint32_t instruction, int index) {
     const auto rt = (instruction >> 16) & 0x1f;
     const auto rs = (instruction >> 21) & 0x1f;
     const auto opcode = instruction >> 26;
@@ -599,14 +1211,12 @@ DynaRecCPU::LoadDelayDependencyType DynaRecCPU::getLoadDelayDependencyType(int i
             break;
         case 0x10: {  // COP0 instructions also need special handling
             // We need to emulate the delay if the rs field is 4, ie the instruction is MTC0, and "index" is the source
-            return (rs == 4 && rt == index) ? LoadDelayDependencyType::DependencyInsideBlock
-                                            : LoadDelayDependencyType::NoDependency;
+            return rs == 4 && rt == index;
         } break;
         case 0x12: {  // COP2 instructions too
             // Check if the instruction is MFC2 or CFC2 with the source being $rt
             const bool isMove = (instruction & 0x3F) == 0 && (rs == 4 || rs == 6);
-            return (isMove && rt == index) ? LoadDelayDependencyType::DependencyInsideBlock
-                                           : LoadDelayDependencyType::NoDependency;
+            return isMove && rt == index;
             break;
         }
         default:
@@ -616,20 +1226,17 @@ DynaRecCPU::LoadDelayDependencyType DynaRecCPU::getLoadDelayDependencyType(int i
 
     switch (dependencyType) {
         case NoDep:
-            return LoadDelayDependencyType::NoDependency;
+            return false;
         case DepIfRs:
-            return (index == rs) ? LoadDelayDependencyType::DependencyInsideBlock
-                                 : LoadDelayDependencyType::NoDependency;
+            return index == rs;
         case DepIfRt:
-            return (index == rt) ? LoadDelayDependencyType::DependencyInsideBlock
-                                 : LoadDelayDependencyType::NoDependency;
+            return index == rt;
         case DepIfRsOrRt:
-            return (index == rs || index == rt) ? LoadDelayDependencyType::DependencyInsideBlock
-                                                : LoadDelayDependencyType::NoDependency;
+            return index == rs || index == rt;
     }
 
     // Unreachable, but returning nothing would technically be UB.
     abort();
-    return LoadDelayDependencyType::NoDependency;
+    return false;
 }
 #endif  // DYNAREC_X86_64
@@ -18,22 +18,29 @@
  ***************************************************************************/
 
 #pragma once
+#include "core/psxhw.h"
 #include "core/r3000a.h"
 
 #if defined(DYNAREC_X86_64)
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "core/fastmem.h"
 #include "core/gpu.h"
 #include "emitter.h"
 #include "fmt/format.h"
 #include "profiler.h"
 #include "regAllocation.h"
 #include "spu/interface.h"
+#include "support/flathashmap.h"
 #include "tracy/Tracy.hpp"
 
 #define HOST_REG_CACHE_OFFSET(x) ((uintptr_t) & m_hostRegisterCache[(x)] - (uintptr_t)this)
@@ -113,6 +120,8 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     DynarecCallback m_loadDelayHandler;  // Pointer to the code that will handle load delays at the start of a block
     // Pointer to the code that will be executed when a block needs to be recompiled with full load delay support
     DynarecCallback m_needFullLoadDelays;
+    // Pointer to the code that will be executed when a baseline block becomes hot and needs to be recompiled
+    DynarecCallback m_promoteBlock;
 
     Emitter gen;
     uint32_t m_pc;  // Recompiler PC
@@ -132,6 +141,42 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     } m_runtimeLoadDelay;
 
     const int MAX_BLOCK_SIZE = 50;
+    // Superblocks keep compiling through the fall-through path of forward conditional branches,
+    // Emitting a side exit for the taken path instead of ending the block.
+    const int MAX_SUPERBLOCK_SIZE = 256;
+    const int MAX_SIDE_EXITS = 8;
+    // Once this many compiled blocks in a 4KB page of RAM got invalidated, stop forming superblocks there
+    static constexpr uint8_t SUPERBLOCK_INVALIDATION_THRESHOLD = 16;
+
+    // Tiered compilation: blocks are first compiled as plain blocks, with a countdown at their entry. Once a block
+    // has run HOT_BLOCK_THRESHOLD times, it gets recompiled as a superblock.
+    static constexpr uint32_t HOT_BLOCK_THRESHOLD = 32;
+    static constexpr int MAX_BLOCK_COUNTERS = 0x10000;
+    uint32_t m_blockCounters[MAX_BLOCK_COUNTERS];
+    int m_blockCounterCount = 0;           // How many of the counters above have ever been handed out
+    std::vector<int> m_freeBlockCounters;  // Counters of evicted or invalidated blocks, which can be handed out again
+    // The counter each baseline block uses, indexed by LUT slot, along with the code it was handed out to.
+    // Blocks that got uncompiled in bulk (cache flushes) are only noticed once we run out of counters.
+    struct BlockCounter {
+        int index;
+        DynarecCallback code;
+    };
+    PCSX::FlatHashMap<DynarecCallback*, BlockCounter> m_blockCounterSlots;
+
+    // The code cache is split into regions, which get filled one after the other. Once the last one is full,
+    // we wrap around and evict the oldest region, rather than throwing away the whole cache at once.
+    // Each region keeps track of the blocks compiled into it, so they can be marked as uncompiled on eviction.
+    static constexpr int CODE_CACHE_REGIONS = 8;
+    // Move on to the next region when there's less than this left in the current one. No block gets close to it
+    static constexpr size_t CODE_REGION_SLACK = 0x10000;
+    struct CodeRegion {
+        size_t start = 0;  // Offsets in the code cache
+        size_t end = 0;
+        std::vector<DynarecCallback*> blocks;  // LUT slots of the blocks compiled here. Some may have moved since
+    };
+    std::array<CodeRegion, CODE_CACHE_REGIONS> m_codeRegions;
+    int m_currentRegion = 0;
+    size_t m_codeHighWater = 0;  // How far into the code cache we've ever emitted code, for the disassembly widget
 
     enum class RegState { Unknown, Constant };
     enum class LoadingMode { DoNotLoad, Load };
@@ -176,6 +221,64 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     Register m_gprs[32];
     std::array<HostRegister, ALLOCATEABLE_REG_COUNT> m_hostRegs;
     std::optional<uint32_t> m_linkedPC = std::nullopt;
+    std::optional<uint32_t> m_sideExitTarget = std::nullopt;  // Taken target of a branch the block can continue past
+    std::vector<uint8_t> m_ramPageInvalidations;                // How many compiled blocks got invalidated per 4KB page
+    // Whether any block got compiled from each 4KB page of RAM since it was last flushed, and how many such pages
+    std::vector<uint8_t> m_ramCodePages;
+    int m_ramCodePageCount = 0;
+
+    // Direct block links. Maps the LUT slot of a block entrypoint to the list of jmp rel32 instructions that
+    // jump straight into it. Each entry points right past the end of the jmp, so the displacement lives at [site - 4]
+    // Unlinked jumps go to "fallback", which performs any writebacks the link let us skip, then goes to the dispatcher
+    // "source" is the LUT slot of the block the jump lives in.
+    struct BlockLink {
+        uint8_t* site;
+        DynarecCallback fallback;
+        DynarecCallback* source;
+    };
+    PCSX::FlatHashMap<DynarecCallback*, std::vector<BlockLink>> m_blockLinks;
+    // The other way around: the slots each block has links into, so they can be dropped along with the block
+    PCSX::FlatHashMap<DynarecCallback*, std::vector<DynarecCallback*>> m_linkTargets;
+    DynarecCallback* m_compilingSlot = nullptr;  // LUT slot of the block being compiled, the source of new links
+
+    // Fastmem loads that haven't faulted yet, indexed by the address of their host load instruction.
+    // "site" is where the jump to the thunk gets patched in.
+    struct FastmemSite {
+        uint8_t* site;
+        uint8_t* thunk;
+    };
+    PCSX::FastMem m_fastmem;
+    PCSX::FlatHashMap<uintptr_t, FastmemSite> m_fastmemSites;
+    std::vector<std::function<void()>> m_fastmemThunks;  // Slow paths to emit once the current block is done
+
+    // Blocks compiled in this and previous sessions, indexed by start address. See blockcache.cc
+    struct CachedBlock {
+        uint32_t hash;        // CRC32 of the instructions the block was compiled from
+        uint16_t length;      // In instructions
+        bool fullLoadDelays;  // Whether the block had to be compiled with full load delay emulation
+    };
+    PCSX::FlatHashMap<uint32_t, CachedBlock> m_blockCache;
+    bool m_blockCacheLoaded = false;
+    uint32_t m_blockCacheBiosCRC = 0;
+
+    // Writebacks skipped at the end of a block because the linked block overwrites the registers before using them
+    struct ElidedWriteback {
+        int index;
+        bool isConst;
+        uint32_t value;
+        Reg32 reg;
+    };
+    std::vector<ElidedWriteback> m_elidedWritebacks;
+    bool m_loadDelayAcrossBlocks = false;  // Does this block end with a load delay that the next block has to resolve?
+
+    bool canLink(uint32_t pc);
+    uint8_t* emitLinkedJump(DynarecCallback* targetSlot, DynarecCallback target);
+    void patchLinkedJump(uint8_t* site, DynarecCallback target);
+    void unlinkBlock(DynarecCallback* slot);
+    void relinkBlock(DynarecCallback* slot);
+    void dropBlockLinks(DynarecCallback* source);
+    void unlinkAll();
+    uint32_t getDeadRegistersOnEntry(uint32_t pc);
 
     template <LoadingMode mode = LoadingMode::Load>
     void reserveReg(int index);
@@ -190,7 +293,7 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     void alloc_rs_wb_rt(uint32_t code);
     void alloc_rt_rs_wb_rd(uint32_t code);
 
-    void flushRegs();
+    void flushRegs(uint32_t skipWriteback = 0);
     void spillRegisterCache();
     unsigned int m_allocatedRegisters = 0;  // how many registers have been allocated in this block?
 
@@ -198,6 +301,9 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     void handleKernelCall();
     void emitDispatcher();
     void uncompileAll();
+    void markCodePage(DynarecCallback* slot);
+    void invalidateCodePages();
+    bool isRamBlock(DynarecCallback* slot) { return slot >= m_ramBlocks && slot < m_ramBlocks + m_ramSize / 4; }
 
   public:
     DynaRecCPU() : R3000Acpu("Dynarec (x86-64)") {}
@@ -205,30 +311,48 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     virtual bool Implemented() final { return true; }
     virtual bool Init() final;
     virtual void Reset() final;
+    virtual void resetState() final {
+        R3000Acpu::resetState();
+        m_runtimeLoadDelay.active = false;
+    }
     virtual void Shutdown() final;
     virtual bool isDynarec() final { return true; }
+    virtual bool isBlockLinked(uint32_t from, uint32_t to) final;
     virtual void Execute() final {
         ZoneScoped;         // Tell the Tracy profiler to do its thing
         (*m_dispatcher)();  // Jump to assembly dispatcher
     }
     // For the GUI dynarec disassembly widget
     virtual const uint8_t* getBufferPtr() final { return gen.getCode<const uint8_t*>(); }
-    virtual const size_t getBufferSize() final { return gen.getSize(); }
+    virtual const size_t getBufferSize() final { return std::max(m_codeHighWater, gen.getSize()); }
 
-    // TODO: Make it less slow and bad
     // Possibly clear blocks more aggressively
     // Note: This relies on the behavior in psxmem.cc which calls Clear after force-aligning the address
     virtual void Clear(uint32_t addr, uint32_t size) final {
         auto pointer = getBlockPointer(addr);
-        for (auto i = 0; i < size; i++) {
-            *pointer++ = m_uncompiledBlock;
+        while (size != 0) {
+            // Handle the range one 4KB page at a time, skipping RAM pages nothing was ever compiled from
+            const uint32_t chunk = std::min<uint32_t>(size, 1024 - ((addr >> 2) & 1023));
+            if (!isRamBlock(pointer) || m_ramCodePages[(pointer - m_ramBlocks) >> 10]) {
+                for (uint32_t i = 0; i < chunk; i++) {
+                    // Only compiled blocks need any bookkeeping, so plain data writes stay on the fast path
+                    if (pointer[i] != m_uncompiledBlock) {
+                        blockInvalidated(&pointer[i]);
+                    }
+                    pointer[i] = m_uncompiledBlock;
+                }
+            }
+            pointer += chunk;
+            addr += chunk * 4;
+            size -= chunk;
         }
     }
 
     virtual void invalidateCache() override final {
         memset(m_regs.iCacheAddr, 0xff, sizeof(m_regs.iCacheAddr));
         memset(m_regs.iCacheCode, 0xff, sizeof(m_regs.iCacheCode));
-        m_invalidateBlocks();
+        unlinkAll();
+        invalidateCodePages();
     }
 
     virtual void SetPGXPMode(uint32_t pgxpMode) final {
@@ -316,6 +440,33 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         }
     }
 
+    // Direct stores, to addresses known when compiling, also need to mark their page of RAM as dirty
+    void markDirty(const void* pointer) {
+        if (auto flag = PCSX::g_emulator->m_mem->dirtyFlag(pointer)) store<8>(1u, flag);
+    }
+
+    // Accesses to constant addresses which land on a register with its own handler in PCSX::HW can call the
+    // handler directly, instead of going through Memory and the HW switches. Stores need their value in arg2
+    // beforehand. These return false when there's no handler, and the generic path has to be used.
+    template <typename Handler>
+    bool emitHardwareCall(Handler handler, uint32_t address) {
+        if (handler == nullptr) return false;
+        gen.inc(qword[contextPointer + CYCLE_OFFSET]);  // Memory counts a cycle for every data access
+        gen.mov(arg1, address);
+        call(*handler);
+        return true;
+    }
+
+    template <int size>
+    bool emitHardwareLoad(uint32_t address) {
+        if constexpr (size == 16) {
+            return emitHardwareCall(PCSX::HW::getRead16Handler(address), address);
+        } else if constexpr (size == 32) {
+            return emitHardwareCall(PCSX::HW::getRead32Handler(address), address);
+        }
+        return false;
+    }
+
     // Emit a call to a class member function, passing "thisObject" (+ an adjustment if necessary)
     // As the function's "this" pointer. Only works with classes with single, non-virtual inheritance
     // Hence the static asserts. Those are all we need though, thankfully.
@@ -368,22 +519,45 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     static DynarecCallback recRecompileWrapper(DynaRecCPU* that, bool fullLoadDelayEmulation) {
         return that->recompile(that->m_regs.pc, fullLoadDelayEmulation);
     }
+    static DynarecCallback recPromoteWrapper(DynaRecCPU* that) {
+        return that->recompile(that->m_regs.pc, false, true, true);
+    }
 
     // Check if we're executing from valid memory
     inline bool isPcValid(uint32_t addr) { return m_recompilerLUT[addr >> 16] != m_dummyBlocks; }
 
     DynarecCallback* getBlockPointer(uint32_t pc);
-    DynarecCallback recompile(uint32_t pc, bool fullLoadDelayEmulation, bool align = true);
+    DynarecCallback recompile(uint32_t pc, bool fullLoadDelayEmulation, bool align = true, bool hot = false);
+
+    bool useBlockCache();
+    std::optional<uint32_t> hashBlock(uint32_t pc, uint32_t length);
+    void recordCachedBlock(uint32_t pc, uint32_t length, bool fullLoadDelays);
+    const CachedBlock* findCachedBlock(uint32_t pc);
+    void loadBlockCache();
+    void saveBlockCache();
+    void precompileCachedBlocks();
     void error();
-    void flushCache();
+    void resetCodeRegions();
+    void nextCodeRegion();
+    void evictCodeRegion(CodeRegion& region);
+    size_t getRegionRemainingSize() { return m_codeRegions[m_currentRegion].end - gen.getSize(); }
+    int allocateBlockCounter();
+    void releaseBlockCounter(DynarecCallback* slot);
     void handleLinking();
+    void blockInvalidated(DynarecCallback* slot);
+    int getMaxBlockSize(DynarecCallback* slot);
+    void markSideExit(uint32_t target);
+    void emitSideExit(unsigned count);
     void handleShellReached();
     void emitBlockLookup();
 
     std::string m_symbols;
     RecompilerProfiler<10000000> m_profiler;
+    std::ofstream m_perfMap;  // See SettingDynarecPerfMap
 
     void makeSymbols();
+    void openPerfMap();
+    void recordPerfMapEntry(uint32_t pc, const uint8_t* code, size_t size);
     bool startProfiling(uint32_t pc);
     void endProfiling();
     void dumpProfileData();
@@ -407,6 +581,8 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         }
     }
     LoadDelayDependencyType getLoadDelayDependencyType(int index);
+    static bool readsRegister(uint32_t instruction, int index);
+    bool delaySlotLoadIsObservable(int index);
 
     // Instruction definitions
     void recUnknown(uint32_t code);
@@ -507,6 +683,8 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     template <bool isAVSZ4>
     void recAVSZ(uint32_t code);
     void loadGTEDataRegister(Reg32 dest, int index);
+    void emitGTESaturateIR(int index, bool lm, Reg32 flag);
+    void emitGTEStoreMAC123(bool sf, bool lm, Reg32 flag);
 
     template <bool readSR>
     void testSoftwareInterrupt();
@@ -524,6 +702,24 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     template <int size, bool signExtend>
     void recompileLoad(uint32_t code);
     template <int size, bool signExtend>
+    void emitFastLoad(uint32_t code);
+    template <int size, bool signExtend>
+    void emitLUTLoad(Reg32 dest, uint32_t liveVolatiles);
+    template <int size, bool signExtend>
+    void emitFastmemLoad(Reg32 dest);
+    template <int size>
+    void emitFastStore();
+    uint32_t getLiveVolatiles(std::optional<Reg32> exclude);
+    template <typename T>
+    void emitPreservingMemoryCall(T func, uint32_t liveVolatiles);
+    void emitFastmemThunks();
+    static bool handleFastmemFault(void* opaque, uintptr_t& pc);
+    // Loads and stores to non-constant addresses can look up the memory LUTs inline, instead of calling into C++.
+    // MSAN needs to see every access, so it forces the C++ handlers.
+    bool useFastMemoryPath() { return ENABLE_FAST_MEMORY && !PCSX::g_emulator->m_mem->msanInitialized(); }
+    // On top of that, loads can go straight through the FastMem region if it's been set up
+    bool useFastmem() { return useFastMemoryPath() && m_fastmem.isEnabled(); }
+    template <int size, bool signExtend>
     void recompileLoadWithDelay(uint32_t code, LoadDelayDependencyType dependencyType);
 
     const recompilationFunc m_recBSC[64] = {
@@ -584,6 +780,8 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     };
 
     static constexpr bool ENABLE_BLOCK_LINKING = true;
+    static constexpr bool ENABLE_FAST_MEMORY = true;
+    static constexpr bool ENABLE_TIERED_COMPILATION = true;
     static constexpr bool ENABLE_PROFILER = false;
     static constexpr bool ENABLE_SYMBOLS = false;
 };
@@ -44,17 +44,31 @@ void DynaRecCPU::reserveReg(int index) {
 }
 
 // Flush constants and allocated registers to host regs at the end of a block
-void DynaRecCPU::flushRegs() {
+// Registers in the skipWriteback mask are not written back. They're recorded in m_elidedWritebacks instead,
+// For the block linking code to emit on the path where the link gets undone.
+void DynaRecCPU::flushRegs(uint32_t skipWriteback) {
+    m_elidedWritebacks.clear();
+
     for (auto i = 1; i < 32; i++) {
+        const bool skip = (skipWriteback & (1 << i)) != 0;
+
         if (m_gprs[i].isConst()) {  // If const: Write the value directly, mark as unknown
-            gen.mov(dword[contextPointer + GPR_OFFSET(i)], m_gprs[i].val);
+            if (skip) {
+                m_elidedWritebacks.push_back({i, true, m_gprs[i].val, m_gprs[i].allocatedReg});
+            } else {
+                gen.mov(dword[contextPointer + GPR_OFFSET(i)], m_gprs[i].val);
+            }
             m_gprs[i].markUnknown();
         }
 
         else if (m_gprs[i].isAllocated()) {  // If it's been allocated to a register, unallocate
             m_gprs[i].allocated = false;
             if (m_gprs[i].writeback) {  // And if writeback was specified, write the value back
-                gen.mov(dword[contextPointer + GPR_OFFSET(i)], m_gprs[i].allocatedReg);
+                if (skip) {
+                    m_elidedWritebacks.push_back({i, false, 0, m_gprs[i].allocatedReg});
+                } else {
+                    gen.mov(dword[contextPointer + GPR_OFFSET(i)], m_gprs[i].allocatedReg);
+                }
                 m_gprs[i].writeback = false;  // And turn writeback off
             }
         }
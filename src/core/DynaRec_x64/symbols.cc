@@ -23,6 +23,10 @@
 #include <array>
 #include <cstring>
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 #include "fmt/format.h"
 
 #define REGISTER_VARIABLE(variable, name, size) \
@@ -115,6 +119,31 @@ void DynaRecCPU::makeSymbols() {
     m_symbols += fmt::format("{} invalid_block_handler\n", (void*)m_invalidBlock);
 }
 
+// perf picks up /tmp/perf-<pid>.map to name code in anonymous memory, which is where our code cache ends up.
+// Each line is "start size name", in hex. Blocks evicted from the code cache and compiled again simply show up
+// once more, and perf goes with the latest entry covering an address.
+void DynaRecCPU::openPerfMap() {
+#ifdef __linux__
+    m_perfMap.open(fmt::format("/tmp/perf-{}.map", getpid()), std::ios::out | std::ios::trunc);
+    if (!m_perfMap.is_open()) {
+        PCSX::g_system->log(PCSX::LogClass::CPU, _("[Dynarec] Couldn't create the perf map file\n"));
+        return;
+    }
+    m_perfMap << fmt::format("{} {:x} dynarec_dispatcher\n", (void*)m_dispatcher,
+                             gen.getCurr<uintptr_t>() - (uintptr_t)m_dispatcher);
+#endif
+}
+
+void DynaRecCPU::recordPerfMapEntry(uint32_t pc, const uint8_t* code, size_t size) {
+    const auto symbol = findContainingSymbol(pc);
+    if (symbol) {
+        m_perfMap << fmt::format("{} {:x} psx_{:08x} {}+{:#x}\n", (void*)code, size, pc, symbol->name,
+                                 pc - symbol->address);
+    } else {
+        m_perfMap << fmt::format("{} {:x} psx_{:08x}\n", (void*)code, size, pc);
+    }
+}
+
 #undef REGISTER_VARIABLE
 #undef REGISTER_FUNCTION
 #endif  // DYNAREC_X86_64
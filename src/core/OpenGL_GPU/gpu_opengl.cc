@@ -22,9 +22,11 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstring>
 #include <stdexcept>
 
 #include "core/debug.h"
+#include "core/logger.h"
 #include "core/psxemulator.h"
 #include "core/system.h"
 #include "fmt/format.h"
@@ -42,12 +44,14 @@ void PCSX::OpenGL_GPU::resetBackend() {
     m_rectTexpage = 0;
     m_vertexCount = 0;
     m_syncVRAM = true;
+    m_dirtyAll = true;
     m_display.reset();
 
     m_drawAreaLeft = m_drawAreaTop = 0;
     m_drawAreaBottom = vramHeight;
     m_drawAreaRight = vramWidth;
     updateDrawArea();
+    setScissorArea();
 
     m_drawingOffset = OpenGL::ivec2(0, 0);
 
@@ -68,6 +72,9 @@ void PCSX::OpenGL_GPU::clearVRAM(float r, float g, float b, float a) {
     OpenGL::disableScissor();
     OpenGL::setClearColor(r, g, b, a);
     OpenGL::clearColor();
+    m_vramGeneration++;
+    m_dirtyAll = true;
+    markAllVRAMDirty();
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldFBO);
 
     if (oldScissor) OpenGL::enableScissor();
@@ -79,10 +86,20 @@ void PCSX::OpenGL_GPU::clearVRAM() { clearVRAM(0.f, 0.f, 0.f, 1.f); }
 int PCSX::OpenGL_GPU::initBackend(UI *ui) {
     m_gui = dynamic_cast<GUI *>(ui);
     // Reserve some size for vertices & vram transfers to avoid dynamic allocations later.
-    m_vertices.resize(vertexBufferSize);
-
-    m_vbo.createFixedSize(sizeof(Vertex) * vertexBufferSize, GL_STREAM_DRAW);
+    const auto ringSize = sizeof(Vertex) * vertexRingSegmentSize * vertexRingSegments;
+    m_persistentVertices = reinterpret_cast<Vertex *>(m_vbo.createPersistent(ringSize));
+    if (m_persistentVertices) {
+        m_vertices = m_persistentVertices;
+        m_batchCapacity = vertexRingSegmentSize;
+    } else {
+        m_vertexStorage.resize(vertexBufferSize);
+        m_vertices = m_vertexStorage.data();
+        m_batchCapacity = vertexBufferSize;
+        m_vbo.createFixedSize(sizeof(Vertex) * vertexBufferSize, GL_STREAM_DRAW);
+    }
     m_vbo.bind();
+    m_vramShadow.resize(vramWidth * vramHeight);
+    addVRAMTracker(&m_shadowDirty);
     m_vao.create();
     m_vao.bind();
 
@@ -102,22 +119,38 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
     m_vao.setAttributeFloat<GLushort>(4, 2, sizeof(Vertex), offsetof(Vertex, uv));
     m_vao.enableAttribute(4);
 
+    // Pick the internal resolution, backing off if the driver can't hold textures that large
+    const int maxTextureSize = OpenGL::get<GLint>(GL_MAX_TEXTURE_SIZE);
+    const int scaleSetting = g_emulator->settings.get<Emulator::SettingResolutionScale>();
+    m_scale = std::clamp(scaleSetting, 1, maxResolutionScale);
+    while (m_scale > 1 && vramWidth * m_scale > maxTextureSize) m_scale--;
+    const int scaledWidth = vramWidth * m_scale;
+    const int scaledHeight = vramHeight * m_scale;
+    if (m_scale > 1) {
+        m_nativeTexture.create(vramWidth, vramHeight, GL_RGBA8);
+        m_nativeFBO.createWithDrawTexture(m_nativeTexture);
+    }
+
     // Make VRAM texture and attach it to draw frambuffer
+    // Multisampled VRAM can't be blitted onto itself, so VRAM to VRAM copies need glCopyImageSubData then.
     const int msaaSampleCount = g_emulator->settings.get<Emulator::SettingMSAA>();
-    if (msaaSampleCount > 1 && glTexStorage2DMultisample != nullptr) {
-        m_vramTexture.createMSAA(vramWidth, vramHeight, GL_RGBA8, msaaSampleCount);
+    if (msaaSampleCount > 1 && glTexStorage2DMultisample != nullptr && glCopyImageSubData != nullptr) {
+        m_vramTexture.createMSAA(scaledWidth, scaledHeight, GL_RGBA8, msaaSampleCount);
+        m_blitTexture.createMSAA(scaledWidth, scaledHeight, GL_RGBA8, msaaSampleCount);
         m_fbo.createWithTextureMSAA(m_vramTexture);
 
-        m_vramTextureNoMSAA.create(vramWidth, vramHeight, GL_RGBA8);
+        m_vramTextureNoMSAA.create(scaledWidth, scaledHeight, GL_RGBA8);
         m_fboNoMSAA.createWithTexture(m_vramTextureNoMSAA);
         m_multisampled = true;
     } else {
-        m_vramTexture.create(vramWidth, vramHeight, GL_RGBA8);
+        m_blitTexture.create(scaledWidth, scaledHeight, GL_RGBA8);
+        m_blitFBO.createWithDrawTexture(m_blitTexture);
+        m_vramTexture.create(scaledWidth, scaledHeight, GL_RGBA8);
         m_fbo.createWithTexture(m_vramTexture);
         m_multisampled = false;
     }
 
-    m_sampleTexture.create(vramWidth, vramHeight, GL_RGBA8);
+    m_sampleTexture.create(scaledWidth, scaledHeight, GL_RGBA8);
 
     if (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         throw std::runtime_error("Non-complete framebuffer");
@@ -149,7 +182,10 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
         // inClut: The CLUT (palette) for textured primitives
         // inTexpage: The texpage. We use bit 15 for indicating an untextured primitive (1 = untextured). This
         // lets us batch untextured and textured primitives together. Bit 15 is unused by hardware, so this is a possible optimization
+        // Bits 9 to 14 hold the texture page cache slot plus one, or 0 if the page isn't cached
         // inUV: The UVs (texture coordinates) for textured primitives
+        // When blending in the fragment shader, bit 15 of inClut flags semi-transparent primitives, which blend with
+        // the mode in bits 5 and 6 of inTexpage. Untextured primitives have it there too.
 
         layout (location = 0) in ivec2 inPos;
         layout (location = 1) in uint inColor;
@@ -162,6 +198,8 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
         flat out ivec2 clutBase;
         flat out ivec2 texpageBase;
         flat out int texMode;
+        flat out int cacheSlot;
+        flat out int blendMode;
 
         // We always apply a 0.5 offset in addition to the drawing offsets, to cover up OpenGL inaccuracies
         uniform vec2 u_vertexOffsets = vec2(+0.5, -0.5);
@@ -184,39 +222,59 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
 
            gl_Position = vec4(xx, yy, 1.0, 1.0);
            vertexColor = vec4(color / 255.0, 1.0);
+           blendMode = (inClut & 0x8000) != 0 ? (inTexpage >> 5) & 3 : -1;
 
            if ((inTexpage & 0x8000) != 0) { // Untextured primitive
                texMode = 4;
+               cacheSlot = -1;
            } else {
                texMode = (inTexpage >> 7) & 3;
+               cacheSlot = ((inTexpage >> 9) & 0x3f) - 1;
                texCoords = inUV;
                texpageBase = ivec2((inTexpage & 0xf) * 64, ((inTexpage >> 4) & 0x1) * 256);
-               clutBase = ivec2((inClut & 0x3f) * 16, inClut >> 6);
+               clutBase = ivec2((inClut & 0x3f) * 16, (inClut >> 6) & 0x1ff);
            }
         }
     )";
 
-    static const char *fragSource = R"(
+    // FRAMEBUFFER_FETCH gets set to 1 when the driver lets the fragment shader read the pixel it's about to overwrite,
+    // in which case it does all of the blending itself, in a single pass, instead of relying on dual-source blending.
+    std::string fragSource = R"(
         #version 330 core
+        #define FRAMEBUFFER_FETCH 0
+        #if FRAMEBUFFER_FETCH
+        #extension GL_EXT_shader_framebuffer_fetch : require
+        #endif
         in vec4 vertexColor;
         in vec2 texCoords;
         flat in ivec2 clutBase;
         flat in ivec2 texpageBase;
         flat in int texMode;
+        flat in int cacheSlot;
+        flat in int blendMode;
 
+        #if FRAMEBUFFER_FETCH
+        // Holds the pixel in VRAM until written to
+        layout(location = 0) inout vec4 FragColor;
+        #else
         // We use dual-source blending in order to emulate the fact that the GPU can enable blending per-pixel
         // FragColor: The colour of the pixel before alpha blending comes into play
         // BlendColor: Contains blending coefficients
         layout(location = 0, index = 0) out vec4 FragColor;
         layout(location = 0, index = 1) out vec4 BlendColor;
+        #endif
 
         // Tex window uniform format
         // x, y components: masks to & coords with
         // z, w components: masks to | coords with
         uniform ivec4 u_texWindow;
         uniform sampler2D u_vramTex;
+        uniform sampler2D u_texCache;
         uniform vec4 u_blendFactors;
         uniform vec4 u_blendFactorsIfOpaque = vec4(1.0, 1.0, 1.0, 0.0);
+        // Internal resolution multiplier. VRAM coordinates stay native, and each texel is read from the middle of
+        // its scaled block, the same one readbacks pick when scaling VRAM back down
+        uniform int u_scale = 1;
 
         int floatToU5(float f) {
             return int(floor(f * 31.0 + 0.5));
@@ -224,7 +282,7 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
 
         vec4 sampleVRAM(ivec2 coords) {
             coords &= ivec2(1023, 511); // Out-of-bounds VRAM accesses wrap
-            return texelFetch(u_vramTex, coords, 0);
+            return texelFetch(u_vramTex, coords * u_scale + u_scale / 2, 0);
         }
 
         int sample16(ivec2 coords) {
@@ -236,6 +294,11 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
             return r | (g << 5) | (b << 10) | msb;
         }
 
+        // Decoded 4bpp and 8bpp texture pages are laid out in 8 columns of 256x256 slots
+        vec4 sampleCache(ivec2 UV) {
+            return texelFetch(u_texCache, ivec2(cacheSlot & 7, cacheSlot >> 3) * 256 + UV, 0);
+        }
+
         // Apply texture blending
             // Formula for RGB8 colours: col1 * col2 / 128
         vec4 texBlend(vec4 colour1, vec4 colour2) {
@@ -244,10 +307,33 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
             return ret;
         }
 
+        // Writes the pixel, blended with the one underneath if both the primitive and texel are semi-transparent
+        void emit(vec4 colour, bool semiTransparent) {
+        #if FRAMEBUFFER_FETCH
+            if (blendMode >= 0 && semiTransparent) {
+                vec3 back = FragColor.rgb;
+                vec3 front = colour.rgb;
+                if (blendMode == 0) {
+                    front = (back + front) * 0.5;
+                } else if (blendMode == 1) {
+                    front = back + front;
+                } else if (blendMode == 2) {
+                    front = back - front;
+                } else {
+                    front = back + front * 0.25;
+                }
+                colour.rgb = clamp(front, 0.0, 1.0);
+            }
+            FragColor = colour;
+        #else
+            FragColor = colour;
+            BlendColor = semiTransparent ? u_blendFactors : u_blendFactorsIfOpaque;
+        #endif
+        }
+
         void main() {
            if (texMode == 4) { // Untextured primitive
-               FragColor = vertexColor;
-               BlendColor = u_blendFactors;
+               emit(vertexColor, true);
                return;
            }
 
@@ -255,47 +341,66 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
            ivec2 UV = ivec2(floor(texCoords + vec2(0.0001, 0.0001))) & ivec2(0xff);
            UV = (UV & u_texWindow.xy) | u_texWindow.zw;
 
+           vec4 texel;
            if (texMode == 0) { // 4bpp texture
-               ivec2 texelCoord = ivec2(UV.x >> 2, UV.y) + texpageBase;
+               if (cacheSlot >= 0) {
+                   texel = sampleCache(UV);
+               } else {
+                   ivec2 texelCoord = ivec2(UV.x >> 2, UV.y) + texpageBase;
 
-               int sample = sample16(texelCoord);
-               int shift = (UV.x & 3) << 2;
-               int clutIndex = (sample >> shift) & 0xf;
+                   int sample = sample16(texelCoord);
+                   int shift = (UV.x & 3) << 2;
+                   int clutIndex = (sample >> shift) & 0xf;
 
-               ivec2 sampleCoords = ivec2(clutBase.x + clutIndex, clutBase.y);
-               FragColor = texelFetch(u_vramTex, sampleCoords, 0);
+                   ivec2 sampleCoords = ivec2(clutBase.x + clutIndex, clutBase.y);
+                   texel = sampleVRAM(sampleCoords);
+               }
 
-               if (FragColor.rgb == vec3(0.0, 0.0, 0.0)) discard;
-               BlendColor = FragColor.a >= 0.5 ? u_blendFactors : u_blendFactorsIfOpaque;
-               FragColor = texBlend(FragColor, vertexColor);
+               if (texel.rgb == vec3(0.0, 0.0, 0.0)) discard;
+               emit(texBlend(texel, vertexColor), texel.a >= 0.5);
            } else if (texMode == 1) { // 8bpp texture
-               ivec2 texelCoord = ivec2(UV.x >> 1, UV.y) + texpageBase;
+               if (cacheSlot >= 0) {
+                   texel = sampleCache(UV);
+               } else {
+                   ivec2 texelCoord = ivec2(UV.x >> 1, UV.y) + texpageBase;
 
-               int sample = sample16(texelCoord);
-               int shift = (UV.x & 1) << 3;
-               int clutIndex = (sample >> shift) & 0xff;
+                   int sample = sample16(texelCoord);
+                   int shift = (UV.x & 1) << 3;
+                   int clutIndex = (sample >> shift) & 0xff;
 
-               ivec2 sampleCoords = ivec2(clutBase.x + clutIndex, clutBase.y);
-               FragColor = texelFetch(u_vramTex, sampleCoords, 0);
+                   ivec2 sampleCoords = ivec2(clutBase.x + clutIndex, clutBase.y);
+                   texel = sampleVRAM(sampleCoords);
+               }
 
-               if (FragColor.rgb == vec3(0.0, 0.0, 0.0)) discard;
-               BlendColor = FragColor.a >= 0.5 ? u_blendFactors : u_blendFactorsIfOpaque;
-               FragColor = texBlend(FragColor, vertexColor);
+               if (texel.rgb == vec3(0.0, 0.0, 0.0)) discard;
+               emit(texBlend(texel, vertexColor), texel.a >= 0.5);
            } else { // Texture depth 2 and 3 both indicate 16bpp textures
                ivec2 texelCoord = UV + texpageBase;
-               FragColor = sampleVRAM(texelCoord);
+               texel = sampleVRAM(texelCoord);
 
-               if (FragColor.rgb == vec3(0.0, 0.0, 0.0)) discard;
-               FragColor = texBlend(FragColor, vertexColor);
-               BlendColor = u_blendFactors;
+               if (texel.rgb == vec3(0.0, 0.0, 0.0)) discard;
+               emit(texBlend(texel, vertexColor), true);
            }
         }
     )";
 
     m_shaderEditor.init();
     m_shaderEditor.reset(m_gui);
-    m_shaderEditor.setText(vertSource, fragSource, "");
-    auto status = m_shaderEditor.compile(m_gui);
+    auto status = OpenGL::Status::makeOk();
+    m_framebufferFetch = OpenGL::hasExtension("GL_EXT_shader_framebuffer_fetch");
+    if (m_framebufferFetch) {
+        std::string fetchSource = fragSource;
+        const std::string_view define = "#define FRAMEBUFFER_FETCH 0";
+        fetchSource.replace(fetchSource.find(define), define.size(), "#define FRAMEBUFFER_FETCH 1");
+        m_shaderEditor.setText(vertSource, fetchSource, "");
+        // Some drivers advertise the extension, yet fail to compile shaders using it
+        status = m_shaderEditor.compile(m_gui);
+        m_framebufferFetch = status.isOk();
+    }
+    if (!m_framebufferFetch) {
+        m_shaderEditor.setText(vertSource, fragSource, "");
+        status = m_shaderEditor.compile(m_gui);
+    }
     if (!status.isOk()) return -1;
     m_program.setProgram(m_shaderEditor.getProgram());
 
@@ -307,6 +412,77 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
 
     const auto vramSamplerLoc = OpenGL::uniformLocation(m_program, "u_vramTex");
     glUniform1i(vramSamplerLoc, 0);  // Make the fragment shader read from currently binded texture
+    glUniform1i(OpenGL::uniformLocation(m_program, "u_texCache"), 1);
+    glUniform1i(OpenGL::uniformLocation(m_program, "u_scale"), m_scale);
+
+    // The texture page decoder runs one full-slot triangle per page, doing the CLUT lookups of the main shader
+    static const char *pageVertSource = R"(
+        #version 330 core
+        void main() {
+            vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+            gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+        }
+    )";
+
+    static const char *pageFragSource = R"(
+        #version 330 core
+        layout(location = 0) out vec4 FragColor;
+
+        uniform sampler2D u_vramTex;
+        // x, y: texpage base. z, w: CLUT base
+        uniform ivec4 u_pageParams;
+        // x, y: bottom left corner of the slot in the atlas. z: texture mode
+        uniform ivec3 u_slot;
+        uniform int u_scale = 1;
+
+        int floatToU5(float f) {
+            return int(floor(f * 31.0 + 0.5));
+        }
+
+        vec4 sampleVRAM(ivec2 coords) {
+            return texelFetch(u_vramTex, (coords & ivec2(1023, 511)) * u_scale + u_scale / 2, 0);
+        }
+
+        int sample16(ivec2 coords) {
+            vec4 colour = sampleVRAM(coords);
+            int r = floatToU5(colour.r);
+            int g = floatToU5(colour.g);
+            int b = floatToU5(colour.b);
+            int msb = int(ceil(colour.a)) << 15;
+            return r | (g << 5) | (b << 10) | msb;
+        }
+
+        void main() {
+            ivec2 UV = ivec2(gl_FragCoord.xy) - u_slot.xy;
+            int clutIndex;
+            if (u_slot.z == 0) {
+                int sample = sample16(ivec2(UV.x >> 2, UV.y) + u_pageParams.xy);
+                clutIndex = (sample >> ((UV.x & 3) << 2)) & 0xf;
+            } else {
+                int sample = sample16(ivec2(UV.x >> 1, UV.y) + u_pageParams.xy);
+                clutIndex = (sample >> ((UV.x & 1) << 3)) & 0xff;
+            }
+            FragColor = sampleVRAM(ivec2(u_pageParams.z + clutIndex, u_pageParams.w));
+        }
+    )";
+
+    OpenGL::Shader pageVert, pageFrag;
+    if (pageVert.create(pageVertSource, GL_VERTEX_SHADER).isOk() &&
+        pageFrag.create(pageFragSource, GL_FRAGMENT_SHADER).isOk() &&
+        m_texturePageProgram.create({pageVert, pageFrag}).isOk()) {
+        m_texturePageAtlas.create(texturePageAtlasSize, texturePageAtlasSize, GL_RGBA8);
+        m_texturePageFBO.createWithDrawTexture(m_texturePageAtlas);
+        m_texturePageVAO.create();
+        m_texturePageProgram.use();
+        glUniform1i(OpenGL::uniformLocation(m_texturePageProgram, "u_vramTex"), 0);
+        m_texturePageParamsLoc = OpenGL::uniformLocation(m_texturePageProgram, "u_pageParams");
+        m_texturePageSlotLoc = OpenGL::uniformLocation(m_texturePageProgram, "u_slot");
+        glUniform1i(OpenGL::uniformLocation(m_texturePageProgram, "u_scale"), m_scale);
+        m_useTexturePageCache = true;
+    } else {
+        g_system->log(LogClass::GPU, "Unable to compile the texture page decoder, texture page cache disabled\n");
+    }
+    m_program.use();
 
     m_vramTexture24.create(1024, 512, GL_RGBA8);
     m_fbo24.createWithDrawTexture(m_vramTexture24);
@@ -426,7 +602,31 @@ void PCSX::OpenGL_GPU::setLinearFiltering() {
     m_display.setLinearFiltering();
 }
 
-int PCSX::OpenGL_GPU::shutdown() { return 0; }
+int PCSX::OpenGL_GPU::shutdown() {
+    // Let pending screenshots complete, so nobody is left waiting on them
+    for (auto &readback : m_readbacks) {
+        finishReadback(readback, false);
+        if (readback.pbo != 0) glDeleteBuffers(1, &readback.pbo);
+        readback.pbo = 0;
+    }
+
+    // Release the vertex ring while the context is still current, so it doesn't stay mapped past the GPU's lifetime
+    for (auto &fence : m_ringFences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (m_persistentVertices) {
+        m_vbo.bind();
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        m_persistentVertices = nullptr;
+    }
+    m_vbo.destroy();
+    m_vertices = nullptr;
+    m_vertexCount = 0;
+    m_ringSegment = 0;
+    m_batchFirst = 0;
+    return 0;
+}
 
 uint32_t PCSX::OpenGL_GPU::readStatusInternal() {
     return 0b01011110100000000000000000000000;
@@ -450,6 +650,8 @@ bool PCSX::OpenGL_GPU::configure() {
 
             const auto vramSamplerLoc = OpenGL::uniformLocation(m_program, "u_vramTex");
             glUniform1i(vramSamplerLoc, 0);  // Make the fragment shader read from currently bound texture
+            glUniform1i(OpenGL::uniformLocation(m_program, "u_texCache"), 1);
+            glUniform1i(OpenGL::uniformLocation(m_program, "u_scale"), m_scale);
             glUniform4f(m_blendFactorsIfOpaqueLoc, 1.0, 1.0, 1.0, 0.0);
             glUniform4f(m_blendFactorsLoc, m_blendFactors.x(), m_blendFactors.x(), m_blendFactors.x(),
                         m_blendFactors.y());
@@ -496,11 +698,32 @@ bool PCSX::OpenGL_GPU::configure() {
             ImGui::EndCombo();
         }
 
+        const int scale = g_emulator->settings.get<Emulator::SettingResolutionScale>();
+        const auto scaleString = fmt::format(f_("{}x native"), scale);
+        if (ImGui::BeginCombo(_("Internal resolution"), scaleString.c_str())) {
+            for (int i = 1; i <= maxResolutionScale; i++) {
+                const auto str = fmt::format(f_("{}x native"), i);
+                if (ImGui::Selectable(str.c_str(), i == scale)) {
+                    g_emulator->settings.get<Emulator::SettingResolutionScale>() = i;
+                    changed = true;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        if (scale != m_scale) {
+            ImGui::TextWrapped(_("Currently rendering at %dx. The internal resolution is applied when the renderer "
+                                 "starts."),
+                               m_scale);
+        }
+
         if (ImGui::Checkbox(_("Use linear filtering"),
                             &g_emulator->settings.get<Emulator::SettingLinearFiltering>().value)) {
             changed = true;
             setLinearFiltering();
         }
+        if (m_texturePageProgram.exists()) {
+            ImGui::Checkbox(_("Cache decoded texture pages"), &m_useTexturePageCache);
+        }
         ImGui::Checkbox(_("Edit OpenGL GPU shaders"), &m_shaderEditor.m_show);
         ImGui::End();
     }
@@ -531,9 +754,13 @@ void PCSX::OpenGL_GPU::debug() {
 
 // Called at the start of a UI frame to restore context
 void PCSX::OpenGL_GPU::setOpenGLContext() {
+    pollReadbacks();
     m_vbo.bind();
     m_vao.bind();
     m_fbo.bind(OpenGL::DrawAndReadFramebuffer);
+    glActiveTexture(GL_TEXTURE1);
+    m_texturePageAtlas.bind();
+    glActiveTexture(GL_TEXTURE0);
     m_sampleTexture.bind();
     OpenGL::setViewport(m_vramTexture.width(), m_vramTexture.height());
     OpenGL::enableScissor();
@@ -546,12 +773,19 @@ void PCSX::OpenGL_GPU::setOpenGLContext() {
 }
 
 void PCSX::OpenGL_GPU::updateDrawArea() {
-    renderBatch();
     const int left = m_drawAreaLeft;
     const int width = std::max<int>(m_drawAreaRight - left + 1, 0);
     const int top = m_drawAreaTop;
     const int height = std::max<int>(m_drawAreaBottom - m_drawAreaTop + 1, 0);
 
+    // Games routinely rewrite the drawing area with the values it already has. Keep the batch going if so.
+    if (m_scissorBox.x == left && m_scissorBox.y == top && m_scissorBox.width == width &&
+        m_scissorBox.height == height) {
+        return;
+    }
+
+    renderBatch();
+
     m_scissorBox.x = left;
     m_scissorBox.y = top;
     m_scissorBox.width = width;
@@ -561,10 +795,12 @@ void PCSX::OpenGL_GPU::updateDrawArea() {
 
 // Set the OpenGL scissor based on our PS1's drawing area.
 void PCSX::OpenGL_GPU::setScissorArea() {
-    OpenGL::setScissor(m_scissorBox.x, m_scissorBox.y, m_scissorBox.width, m_scissorBox.height);
+    OpenGL::setScissor(m_scissorBox.x * m_scale, m_scissorBox.y * m_scale, m_scissorBox.width * m_scale,
+                       m_scissorBox.height * m_scale);
 }
 
 GLuint PCSX::OpenGL_GPU::getVRAMTexture() {
+    commitVRAM();
     if (!m_multisampled) {
         return m_vramTexture.handle();
     } else {
@@ -574,7 +810,10 @@ GLuint PCSX::OpenGL_GPU::getVRAMTexture() {
 
 // Called at the end of a frame
 void PCSX::OpenGL_GPU::vblank(bool fromGui) {
+    commitVRAM();
     renderBatch();
+    pollReadbacks();
+    queueSpeculativeReadback();
 
     // Set the fill mode to fill before passing the OpenGL context to the GUI
     if (m_polygonMode != OpenGL::FillPoly) {
@@ -598,7 +837,9 @@ void PCSX::OpenGL_GPU::vblank(bool fromGui) {
         if (m_multisampled) {
             m_fbo.bind(OpenGL::ReadFramebuffer);
             m_fboNoMSAA.bind(OpenGL::DrawFramebuffer);
-            glBlitFramebuffer(0, 0, 1024, 512, 0, 0, 1024, 512, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            const int width = m_vramTexture.width();
+            const int height = m_vramTexture.height();
+            glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
             texture = m_vramTextureNoMSAA.handle();
         } else {
             texture = m_vramTexture.handle();
@@ -626,72 +867,454 @@ void PCSX::OpenGL_GPU::vblank(bool fromGui) {
 
 void PCSX::OpenGL_GPU::renderBatch() {
     if (m_vertexCount > 0) {
-        if (m_syncVRAM) {
-            m_syncVRAM = false;
-            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, vramWidth, vramHeight);
-        }
+        syncSampleTexture();
 
         if (m_updateDrawOffset) {
             m_updateDrawOffset = false;
             setDrawOffset(m_lastDrawOffsetSetting);
         }
-        m_vbo.bufferVertsSub(&m_vertices[0], m_vertexCount);
+
+        // Persistently mapped vertices are already in place, we only need to point the draw at them
+        GLint first = 0;
+        if (m_persistentVertices) {
+            first = m_batchFirst;
+        } else {
+            m_vbo.bufferVertsSub(m_vertices, m_vertexCount);
+        }
 
         // Special handling if we're using subtractive blending
         if (m_lastBlendingMode == 2) {
             // Draw opaque only
             OpenGL::setBlendEquation(OpenGL::BlendEquation::Add);
             setBlendFactors(0.0, 1.0);
-            OpenGL::draw(OpenGL::Triangles, m_vertexCount);
+            OpenGL::draw(OpenGL::Triangles, first, m_vertexCount);
 
             // Draw transparent only
             OpenGL::setBlendEquation(OpenGL::BlendEquation::ReverseSub, OpenGL::BlendEquation::Add);
             setBlendFactors(1.0, 1.0);
             glUniform4f(m_blendFactorsIfOpaqueLoc, 0.0, 0.0, 0.0, 1.0);
-            OpenGL::draw(OpenGL::Triangles, m_vertexCount);
+            OpenGL::draw(OpenGL::Triangles, first, m_vertexCount);
 
             glUniform4f(m_blendFactorsIfOpaqueLoc, 1.0, 1.0, 1.0, 0.0);
         } else {
-            OpenGL::draw(OpenGL::Triangles, m_vertexCount);
+            OpenGL::draw(OpenGL::Triangles, first, m_vertexCount);
+        }
+
+        // The next batch starts right after this one, in the same ring segment
+        if (m_persistentVertices) {
+            m_vertices += m_vertexCount;
+            m_batchFirst += m_vertexCount;
+            m_batchCapacity -= m_vertexCount;
         }
         m_vertexCount = 0;
+        m_vramGeneration++;
+        m_batchSerial++;
+        markDirty(m_scissorBox.x, m_scissorBox.y, m_scissorBox.width, m_scissorBox.height);
+    }
+}
+
+void PCSX::OpenGL_GPU::syncSampleTexture() {
+    if (!m_syncVRAM) return;
+    m_syncVRAM = false;
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, m_vramTexture.width(), m_vramTexture.height());
+
+    // The sample texture now has all the VRAM writes since the last sync. Drop the cached pages they touched.
+    for (int slot = 0; slot < texturePageSlots; slot++) {
+        auto &page = m_texturePages[slot];
+        if (!page.valid) continue;
+        bool dirty = m_dirtyAll;
+        for (const auto &rect : m_dirtyRects) {
+            if (dirty) break;
+            dirty = rect.intersects(page.page) || rect.intersects(page.clut);
+        }
+        if (dirty) {
+            page.valid = false;
+            m_texturePageLookup.erase(page.key);
+        }
     }
+    m_dirtyRects.clear();
+    m_dirtyAll = false;
+}
+
+void PCSX::OpenGL_GPU::markDirty(int x, int y, int w, int h) {
+    markVRAMDirty(x, y, w, h);
+    if (m_dirtyAll) return;
+    OpenGL::Rectangle<int> rect(x, y, w, h);
+    // Consecutive batches usually draw into the same area
+    if (!m_dirtyRects.empty()) {
+        const auto &last = m_dirtyRects.back();
+        if (last.x == x && last.y == y && last.width == w && last.height == h) return;
+    }
+    // Past a point, checking every rectangle costs more than redecoding everything
+    if (m_dirtyRects.size() >= 64) {
+        m_dirtyRects.clear();
+        m_dirtyAll = true;
+        return;
+    }
+    m_dirtyRects.push_back(rect);
+}
+
+// Returns the cache slot holding the decoded texture page, decoding it if needed, or -1 if it can't be cached
+int PCSX::OpenGL_GPU::lookupTexturePage(uint32_t texpage, uint16_t clut) {
+    const auto depth = (texpage >> 7) & 3;
+    if (!m_useTexturePageCache || depth >= 2) return -1;  // 15bpp textures don't go through a CLUT
+
+    // Pages get decoded from the sample texture, so it has to be current, and pages it invalidates gone
+    syncSampleTexture();
+
+    const uint32_t key = (texpage & 0x19f) | (uint32_t(clut) << 9);
+    auto it = m_texturePageLookup.find(key);
+    if (it != m_texturePageLookup.end()) {
+        m_texturePages[it->second].lastUse = m_batchSerial;
+        return it->second;
+    }
+
+    // Take a free slot, or evict the least recently used page
+    int slot = 0;
+    for (int i = 0; i < texturePageSlots; i++) {
+        if (!m_texturePages[i].valid) {
+            slot = i;
+            break;
+        }
+        if (m_texturePages[i].lastUse < m_texturePages[slot].lastUse) slot = i;
+    }
+
+    auto &page = m_texturePages[slot];
+    if (page.valid) {
+        // Primitives still waiting in the current batch may be using it
+        if (page.lastUse == m_batchSerial) renderBatch();
+        m_texturePageLookup.erase(page.key);
+    }
+
+    decodeTexturePage(slot, texpage, clut);
+
+    const int pageX = (texpage & 0xf) * 64;
+    const int pageWidth = depth == 0 ? 64 : 128;
+    page.key = key;
+    page.valid = true;
+    page.lastUse = m_batchSerial;
+    // 8bpp pages starting at the right edge wrap around, just consider the whole width for these
+    if (pageX + pageWidth > vramWidth) {
+        page.page = OpenGL::Rectangle<int>(0, ((texpage >> 4) & 1) * 256, vramWidth, 256);
+    } else {
+        page.page = OpenGL::Rectangle<int>(pageX, ((texpage >> 4) & 1) * 256, pageWidth, 256);
+    }
+    page.clut = OpenGL::Rectangle<int>((clut & 0x3f) * 16, (clut >> 6) & 0x1ff, depth == 0 ? 16 : 256, 1);
+    m_texturePageLookup[key] = slot;
+    return slot;
+}
+
+void PCSX::OpenGL_GPU::decodeTexturePage(int slot, uint32_t texpage, uint16_t clut) {
+    const int slotX = (slot % 8) * 256;
+    const int slotY = (slot / 8) * 256;
+
+    m_texturePageFBO.bind(OpenGL::DrawFramebuffer);
+    OpenGL::disableScissor();
+    if (m_lastTransparency == Transparency::Transparent) OpenGL::disableBlend();
+    if (m_polygonMode != OpenGL::FillPoly) OpenGL::setFillMode(OpenGL::FillPoly);
+    OpenGL::setViewport(slotX, slotY, 256, 256);
+
+    m_texturePageProgram.use();
+    glUniform4i(m_texturePageParamsLoc, (texpage & 0xf) * 64, ((texpage >> 4) & 1) * 256, (clut & 0x3f) * 16,
+                (clut >> 6) & 0x1ff);
+    glUniform3i(m_texturePageSlotLoc, slotX, slotY, (texpage >> 7) & 3);
+    m_texturePageVAO.bind();
+    OpenGL::draw(OpenGL::Triangles, 3);
+
+    // Back to drawing into VRAM
+    m_vao.bind();
+    m_program.use();
+    m_fbo.bind(OpenGL::DrawFramebuffer);
+    OpenGL::setViewport(m_vramTexture.width(), m_vramTexture.height());
+    OpenGL::enableScissor();
+    if (m_lastTransparency == Transparency::Transparent) OpenGL::enableBlend();
+    if (m_polygonMode != OpenGL::FillPoly) OpenGL::setFillMode(m_polygonMode);
+}
+
+uint16_t PCSX::OpenGL_GPU::texpageAttribute(uint32_t texpage, uint16_t clut) {
+    const int slot = lookupTexturePage(texpage, clut);
+    return (texpage & 0x1ff) | ((slot + 1) << 9);
+}
+
+// Called when the current ring segment is full. Fence off all the draws we've issued from it, and move on to the
+// next one, waiting for the GPU to be done reading it first if needed.
+void PCSX::OpenGL_GPU::nextRingSegment() {
+    m_ringFences[m_ringSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_ringSegment = (m_ringSegment + 1) % vertexRingSegments;
+
+    auto &fence = m_ringFences[m_ringSegment];
+    if (fence) {
+        ZoneScopedN("OpenGL GPU vertex ring stall");
+        GLenum result;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    m_batchFirst = m_ringSegment * vertexRingSegmentSize;
+    m_vertices = m_persistentVertices + m_batchFirst;
+    m_batchCapacity = vertexRingSegmentSize;
 }
 
 void PCSX::OpenGL_GPU::setDisplayEnable(bool enabled) { m_display.enabled = enabled; }
 
-PCSX::Slice PCSX::OpenGL_GPU::getVRAM(Ownership) {
-    static constexpr uint32_t texSize = 1024 * 512 * sizeof(uint16_t);
-    uint16_t *pixels = (uint16_t *)malloc(texSize);
-    glFlush();
-    const auto oldTex = OpenGL::getTex2D();
-    glBindTexture(GL_TEXTURE_2D, getVRAMTexture());
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, pixels);
-    glBindTexture(GL_TEXTURE_2D, oldTex);
+// Only the parts of the shadow VRAM that changed since the last call get read back. If the changes are
+// scattered all over, a single readback of everything is cheaper than a lot of small ones.
+PCSX::Slice PCSX::OpenGL_GPU::getVRAM(Ownership ownership) {
+    commitVRAM();
+    renderBatch();
+    Readback *pending[readbackQueueSize];
+    int count = 0;
+    m_shadowDirty.forEachRect([&count](int, int, int, int) { count++; });
+    if (count > readbackQueueSize) {
+        pending[0] = &queueReadback(0, 0, vramWidth, vramHeight);
+        count = 1;
+    } else {
+        count = 0;
+        m_shadowDirty.forEachRect(
+            [this, &pending, &count](int x, int y, int w, int h) { pending[count++] = &queueReadback(x, y, w, h); });
+    }
+    for (int i = 0; i < count; i++) finishReadback(*pending[i], true);
+    m_shadowDirty.clear();
 
     Slice slice;
-    slice.acquire(pixels, texSize);
+    if (ownership == Ownership::BORROW) {
+        slice.borrow(m_vramShadow.data(), m_vramShadow.size() * sizeof(uint16_t));
+    } else {
+        slice.copy(m_vramShadow.data(), m_vramShadow.size() * sizeof(uint16_t));
+    }
     return slice;
 }
 
 void PCSX::OpenGL_GPU::partialUpdateVRAM(int x, int y, int w, int h, const uint16_t *pixels,
                                          PartialUpdateVram updateType) {
+    commitVRAM();
     renderBatch();
 
     OpenGL::bindScreenFramebuffer();
     const auto oldTex = updateType == PartialUpdateVram::Asynchronous ? OpenGL::getTex2D() : GLint(-1);
-    m_vramTexture.bind();
+    if (m_scale > 1) {
+        m_nativeTexture.bind();
+    } else {
+        m_vramTexture.bind();
+    }
 
     glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, pixels);
 
     if (updateType == PartialUpdateVram::Asynchronous) glBindTexture(GL_TEXTURE_2D, oldTex);
     m_fbo.bind(OpenGL::DrawAndReadFramebuffer);
 
+    // At higher resolutions, the pixels get uploaded at native size, then stretched into place
+    if (m_scale > 1) {
+        const auto oldScissor = OpenGL::scissorEnabled();
+        OpenGL::disableScissor();
+        m_nativeFBO.bind(OpenGL::ReadFramebuffer);
+        glBlitFramebuffer(x, y, x + w, y + h, x * m_scale, y * m_scale, (x + w) * m_scale, (y + h) * m_scale,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        m_fbo.bind(OpenGL::ReadFramebuffer);
+        if (oldScissor) OpenGL::enableScissor();
+    }
+
     m_syncVRAM = true;
+    m_vramGeneration++;
+    markDirty(x, y, w, h);
+}
+
+PCSX::OpenGL_GPU::Readback &PCSX::OpenGL_GPU::queueReadback(int x, int y, int w, int h) {
+    renderBatch();
+
+    // Recycle the oldest request. If it's a screenshot, this completes it.
+    auto &readback = m_readbacks[m_nextReadback];
+    m_nextReadback = (m_nextReadback + 1) % readbackQueueSize;
+    finishReadback(readback, false);
+
+    const auto oldReadFBO = OpenGL::get<GLint>(GL_READ_FRAMEBUFFER_BINDING);
+    if (m_multisampled || m_scale > 1) {
+        const auto oldDrawFBO = OpenGL::getDrawFramebuffer();
+        const auto oldScissor = OpenGL::scissorEnabled();
+        OpenGL::disableScissor();
+        const int sx = x * m_scale;
+        const int sy = y * m_scale;
+        const int sw = w * m_scale;
+        const int sh = h * m_scale;
+        m_fbo.bind(OpenGL::ReadFramebuffer);
+        if (m_multisampled) {
+            // Multisampled framebuffers can't be read from directly, resolve the region first
+            m_fboNoMSAA.bind(OpenGL::DrawFramebuffer);
+            glBlitFramebuffer(sx, sy, sx + sw, sy + sh, sx, sy, sx + sw, sy + sh, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            m_fboNoMSAA.bind(OpenGL::ReadFramebuffer);
+        }
+        if (m_scale > 1) {
+            // Scale only the region we're after back down, picking the middle texel of each block like the shaders
+            m_nativeFBO.bind(OpenGL::DrawFramebuffer);
+            glBlitFramebuffer(sx, sy, sx + sw, sy + sh, x, y, x + w, y + h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            m_nativeFBO.bind(OpenGL::ReadFramebuffer);
+        }
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldDrawFBO);
+        if (oldScissor) OpenGL::enableScissor();
+    } else {
+        m_fbo.bind(OpenGL::ReadFramebuffer);
+    }
+
+    if (readback.pbo == 0) glGenBuffers(1, &readback.pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, w * h * sizeof(uint16_t), nullptr, GL_STREAM_READ);
+    glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, oldReadFBO);
+
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.x = x;
+    readback.y = y;
+    readback.w = w;
+    readback.h = h;
+    readback.generation = m_vramGeneration;
+    return readback;
+}
+
+// Waits for a readback to land, and hands its data over to the shadow VRAM and/or its screenshot callback.
+// Speculative readbacks nobody asked for are simply dropped.
+void PCSX::OpenGL_GPU::finishReadback(Readback &readback, bool copyToShadow) {
+    if (!readback.fence) return;
+
+    ScreenShot ss;
+    auto callback = std::move(readback.screenShot);
+    readback.screenShot = nullptr;
+
+    if (copyToShadow || callback) {
+        GLenum result;
+        do {
+            result = glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        const auto size = readback.w * readback.h * sizeof(uint16_t);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+        auto mapping = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        auto pixels = reinterpret_cast<const uint16_t *>(mapping);
+        if (pixels && copyToShadow) {
+            for (int row = 0; row < readback.h; row++) {
+                std::memcpy(&m_vramShadow[(readback.y + row) * vramWidth + readback.x], pixels + row * readback.w,
+                            readback.w * sizeof(uint16_t));
+            }
+        }
+        if (callback) {
+            // Same format as the software renderer's screenshots: rows of either 16 bits pixels or packed RGB888
+            const unsigned rowSize = readback.screenShotWidth * (readback.screenShotRGB24 ? 3 : 2);
+            const unsigned dataSize = pixels ? rowSize * readback.h : 0;
+            char *data = reinterpret_cast<char *>(malloc(dataSize));
+            for (unsigned row = 0; row < dataSize / rowSize; row++) {
+                std::memcpy(data + row * rowSize, pixels + row * readback.w, rowSize);
+            }
+            ss.data.acquire(data, dataSize);
+            ss.width = pixels ? readback.screenShotWidth : 0;
+            ss.height = pixels ? readback.h : 0;
+            ss.bpp = readback.screenShotRGB24 ? ScreenShot::BPP_24 : ScreenShot::BPP_16;
+        }
+        if (mapping) glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    glDeleteSync(readback.fence);
+    readback.fence = nullptr;
+    if (callback) callback(std::move(ss));
+}
+
+// Completes the screenshots whose data already arrived, without waiting on the others
+void PCSX::OpenGL_GPU::pollReadbacks() {
+    for (auto &readback : m_readbacks) {
+        if (!readback.fence || !readback.screenShot) continue;
+        const auto result = glClientWaitSync(readback.fence, 0, 0);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) finishReadback(readback, false);
+    }
+}
+
+void PCSX::OpenGL_GPU::queueSpeculativeReadback() {
+    auto &hot = m_hotReadback;
+    if (!hot.readThisFrame) hot.frames = 0;
+    hot.readThisFrame = false;
+    if (hot.frames >= 2) queueReadback(hot.x, hot.y, hot.w, hot.h);
+}
+
+PCSX::Slice PCSX::OpenGL_GPU::getVRAMRegion(int x, int y, int w, int h) {
+    commitVRAM();
+    Slice slice;
+    slice.borrow(m_vramShadow.data(), m_vramShadow.size() * sizeof(uint16_t));
+    if (w <= 0 || h <= 0) return slice;
+
+    auto &hot = m_hotReadback;
+    if (hot.x == x && hot.y == y && hot.w == w && hot.h == h) {
+        if (!hot.readThisFrame) hot.frames++;
+    } else {
+        hot.x = x;
+        hot.y = y;
+        hot.w = w;
+        hot.h = h;
+        hot.frames = 1;
+    }
+    hot.readThisFrame = true;
+
+    // Use a speculative readback if there's one covering this region, and VRAM didn't change since it was queued
+    renderBatch();
+    Readback *found = nullptr;
+    for (auto &readback : m_readbacks) {
+        if (!readback.fence || readback.screenShot || readback.generation != m_vramGeneration) continue;
+        if (readback.x <= x && readback.y <= y && readback.x + readback.w >= x + w &&
+            readback.y + readback.h >= y + h) {
+            found = &readback;
+            break;
+        }
+    }
+    if (!found) found = &queueReadback(x, y, w, h);
+    finishReadback(*found, true);
+
+    return slice;
+}
+
+// Figures out which part of VRAM the display covers, in 16 bits units, and queues its readback
+PCSX::OpenGL_GPU::Readback *PCSX::OpenGL_GPU::queueScreenShot(ScreenShotCallback &&callback) {
+    const bool rgb24 = m_display.info.depth == CtrlDisplayMode::CD_24BITS;
+    const int x = m_display.start.x();
+    const int y = m_display.start.y();
+    const int width = std::min<int>(m_display.size.x(), rgb24 ? (vramWidth - x) * 2 / 3 : vramWidth - x);
+    const int height = std::min<int>(m_display.size.y(), vramHeight - y);
+
+    if (width <= 0 || height <= 0) {
+        ScreenShot ss;
+        ss.width = ss.height = 0;
+        ss.bpp = rgb24 ? ScreenShot::BPP_24 : ScreenShot::BPP_16;
+        callback(std::move(ss));
+        return nullptr;
+    }
+
+    auto &readback = queueReadback(x, y, rgb24 ? (width * 3 + 1) / 2 : width, height);
+    readback.screenShot = std::move(callback);
+    readback.screenShotWidth = width;
+    readback.screenShotRGB24 = rgb24;
+    return &readback;
+}
+
+PCSX::GPU::ScreenShot PCSX::OpenGL_GPU::takeScreenShot() {
+    commitVRAM();
+    ScreenShot ret;
+    auto readback = queueScreenShot([&ret](ScreenShot &&ss) { ret = std::move(ss); });
+    if (readback) finishReadback(*readback, false);
+    return ret;
+}
+
+void PCSX::OpenGL_GPU::takeScreenShotAsync(ScreenShotCallback &&callback) {
+    commitVRAM();
+    queueScreenShot(std::move(callback));
 }
 
 template <PCSX::OpenGL_GPU::Transparency setting>
 void PCSX::OpenGL_GPU::setTransparency() {
+    // Blending in the fragment shader only needs the vertices tagged, so the batch can go on
+    if (m_framebufferFetch) {
+        m_semiTransparent = setting == Transparency::Transparent;
+        return;
+    }
     // Check if we had transparency previously disabled and it just got enabled or vice versa
     if (m_lastTransparency != setting) {
         renderBatch();
@@ -707,6 +1330,10 @@ void PCSX::OpenGL_GPU::setTransparency() {
 }
 
 void PCSX::OpenGL_GPU::setBlendingModeFromTexpage(uint32_t texpage) {
+    if (m_framebufferFetch) {
+        m_blendingModeBits = texpage & 0x60;
+        return;
+    }
     const auto newBlendingMode = (texpage >> 5) & 3;
 
     if (m_lastBlendingMode != newBlendingMode) {
@@ -742,43 +1369,53 @@ void PCSX::OpenGL_GPU::setBlendFactors(float sourceFactor, float destFactor) {
     }
 }
 
+void PCSX::OpenGL_GPU::pushVertex(Vertex vertex) {
+    if (m_framebufferFetch) {
+        vertex.texpage = (vertex.texpage & ~0x60) | m_blendingModeBits;
+        vertex.clut = m_semiTransparent ? (vertex.clut | 0x8000) : (vertex.clut & 0x7fff);
+    }
+    m_vertices[m_vertexCount++] = vertex;
+}
+
 void PCSX::OpenGL_GPU::drawTri(int *x, int *y, uint32_t *colors) {
     maybeRenderBatch<3>();
 
-    m_vertices[m_vertexCount++] = Vertex(x[0], y[0], colors[0]);
-    m_vertices[m_vertexCount++] = Vertex(x[1], y[1], colors[1]);
-    m_vertices[m_vertexCount++] = Vertex(x[2], y[2], colors[2]);
+    pushVertex(Vertex(x[0], y[0], colors[0]));
+    pushVertex(Vertex(x[1], y[1], colors[1]));
+    pushVertex(Vertex(x[2], y[2], colors[2]));
 }
 
 void PCSX::OpenGL_GPU::drawTriTextured(int *x, int *y, uint32_t *colors, uint16_t clut, uint16_t texpage, unsigned *u,
                                        unsigned *v) {
     maybeRenderBatch<3>();
 
-    m_vertices[m_vertexCount++] = Vertex(x[0], y[0], colors[0], clut, texpage, u[0], v[0]);
-    m_vertices[m_vertexCount++] = Vertex(x[1], y[1], colors[1], clut, texpage, u[1], v[1]);
-    m_vertices[m_vertexCount++] = Vertex(x[2], y[2], colors[2], clut, texpage, u[2], v[2]);
+    pushVertex(Vertex(x[0], y[0], colors[0], clut, texpage, u[0], v[0]));
+    pushVertex(Vertex(x[1], y[1], colors[1], clut, texpage, u[1], v[1]));
+    pushVertex(Vertex(x[2], y[2], colors[2], clut, texpage, u[2], v[2]));
 }
 
 void PCSX::OpenGL_GPU::drawRect(int x, int y, int w, int h, uint32_t color) {
     maybeRenderBatch<6>();
-    m_vertices[m_vertexCount++] = Vertex(x, y, color);
-    m_vertices[m_vertexCount++] = Vertex(x + w, y, color);
-    m_vertices[m_vertexCount++] = Vertex(x + w, y + h, color);
-    m_vertices[m_vertexCount++] = Vertex(x + w, y + h, color);
-    m_vertices[m_vertexCount++] = Vertex(x, y + h, color);
-    m_vertices[m_vertexCount++] = Vertex(x, y, color);
+    pushVertex(Vertex(x, y, color));
+    pushVertex(Vertex(x + w, y, color));
+    pushVertex(Vertex(x + w, y + h, color));
+    pushVertex(Vertex(x + w, y + h, color));
+    pushVertex(Vertex(x, y + h, color));
+    pushVertex(Vertex(x, y, color));
 }
 
 void PCSX::OpenGL_GPU::drawRectTextured(int x, int y, int w, int h, uint32_t color, uint16_t clut, unsigned u,
                                         unsigned v) {
+    // Flushing has to happen before looking up the page, so that it gets marked as used by the batch the
+    // rectangle ends up in
     maybeRenderBatch<6>();
-    const uint32_t texpage = m_rectTexpage;
-    m_vertices[m_vertexCount++] = Vertex(x, y, color, clut, texpage, u, v);
-    m_vertices[m_vertexCount++] = Vertex(x + w, y, color, clut, texpage, u + w, v);
-    m_vertices[m_vertexCount++] = Vertex(x + w, y + h, color, clut, texpage, u + w, v + h);
-    m_vertices[m_vertexCount++] = Vertex(x + w, y + h, color, clut, texpage, u + w, v + h);
-    m_vertices[m_vertexCount++] = Vertex(x, y + h, color, clut, texpage, u, v + h);
-    m_vertices[m_vertexCount++] = Vertex(x, y, color, clut, texpage, u, v);
+    const uint16_t texpage = texpageAttribute(m_rectTexpage, clut);
+    pushVertex(Vertex(x, y, color, clut, texpage, u, v));
+    pushVertex(Vertex(x + w, y, color, clut, texpage, u + w, v));
+    pushVertex(Vertex(x + w, y + h, color, clut, texpage, u + w, v + h));
+    pushVertex(Vertex(x + w, y + h, color, clut, texpage, u + w, v + h));
+    pushVertex(Vertex(x, y + h, color, clut, texpage, u, v + h));
+    pushVertex(Vertex(x, y, color, clut, texpage, u, v));
 }
 
 void PCSX::OpenGL_GPU::drawLine(int x1, int y1, uint32_t color1, int x2, int y2, uint32_t color2) {
@@ -792,13 +1429,13 @@ void PCSX::OpenGL_GPU::drawLine(int x1, int y1, uint32_t color1, int x2, int y2,
 
     // Both vertices coincide, render 1x1 rectangle with the colour and coords of v1
     if (dx == 0 && dy == 0) {
-        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1 + 1, y1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1 + 1, y1 + 1, color1);
+        pushVertex(Vertex(x1, y1, color1));
+        pushVertex(Vertex(x1 + 1, y1, color1));
+        pushVertex(Vertex(x1 + 1, y1 + 1, color1));
 
-        m_vertices[m_vertexCount++] = Vertex(x1 + 1, y1 + 1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1, y1 + 1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1);
+        pushVertex(Vertex(x1 + 1, y1 + 1, color1));
+        pushVertex(Vertex(x1, y1 + 1, color1));
+        pushVertex(Vertex(x1, y1, color1));
     } else {
         int xOffset, yOffset;
         if (absDx > absDy) {  // x-major line
@@ -815,13 +1452,13 @@ void PCSX::OpenGL_GPU::drawLine(int x1, int y1, uint32_t color1, int x2, int y2,
             dy > 0 ? y2++ : y1++;
         }
 
-        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x2, y2, color2);
-        m_vertices[m_vertexCount++] = Vertex(x2 + xOffset, y2 + yOffset, color2);
+        pushVertex(Vertex(x1, y1, color1));
+        pushVertex(Vertex(x2, y2, color2));
+        pushVertex(Vertex(x2 + xOffset, y2 + yOffset, color2));
 
-        m_vertices[m_vertexCount++] = Vertex(x2 + xOffset, y2 + yOffset, color2);
-        m_vertices[m_vertexCount++] = Vertex(x1 + xOffset, y1 + yOffset, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1);
+        pushVertex(Vertex(x2 + xOffset, y2 + yOffset, color2));
+        pushVertex(Vertex(x1 + xOffset, y1 + yOffset, color1));
+        pushVertex(Vertex(x1, y1, color1));
     }
 }
 
@@ -888,11 +1525,11 @@ void PCSX::OpenGL_GPU::setDrawOffset(uint32_t cmd) {
 }
 
 void PCSX::OpenGL_GPU::write0(DrawingOffset *prim) {
-    renderBatch();
     const uint32_t word = prim->raw & 0x3fffff;
 
-    // Queue a draw offset update if it changed
+    // Queue a draw offset update if it changed. Otherwise, the current batch can carry on.
     if (word != m_lastDrawOffsetSetting) {
+        renderBatch();
         m_updateDrawOffset = true;
         m_lastDrawOffsetSetting = word;
     }
@@ -906,30 +1543,82 @@ void PCSX::OpenGL_GPU::write0(FastFill *prim) {
     const float b = float((colour >> 16) & 0xff) / 255.f;
 
     OpenGL::setClearColor(r, g, b, 1.f);
-    OpenGL::setScissor(prim->x, prim->y, prim->w, prim->h);
+    OpenGL::setScissor(prim->x * m_scale, prim->y * m_scale, prim->w * m_scale, prim->h * m_scale);
     OpenGL::clearColor();
     setScissorArea();
+    m_vramGeneration++;
+    markDirty(prim->x, prim->y, prim->w, prim->h);
 }
 
 void PCSX::OpenGL_GPU::write0(BlitVramVram *prim) {
     renderBatch();
     OpenGL::disableScissor();  // We disable scissor testing because it affects glBlitFramebuffer
 
-    // TODO: Sanitize this
-    const auto srcX = prim->sX;
-    const auto srcY = prim->sY;
-    const auto destX = prim->dX;
-    const auto destY = prim->dY;
+    const int srcX = prim->sX & 0x3ff;
+    const int srcY = prim->sY & 0x1ff;
+    const int destX = prim->dX & 0x3ff;
+    const int destY = prim->dY & 0x1ff;
+    const int width = ((prim->w - 1) & 0x3ff) + 1;
+    const int height = ((prim->h - 1) & 0x1ff) + 1;
+
+    // Both rectangles wrap around the edges of VRAM, so the copy gets split where either of them crosses one.
+    for (int y = 0; y < height;) {
+        const int h = std::min({height - y, vramHeight - ((srcY + y) & 0x1ff), vramHeight - ((destY + y) & 0x1ff)});
+        for (int x = 0; x < width;) {
+            const int w = std::min({width - x, vramWidth - ((srcX + x) & 0x3ff), vramWidth - ((destX + x) & 0x3ff)});
+            copyVRAM((srcX + x) & 0x3ff, (srcY + y) & 0x1ff, (destX + x) & 0x3ff, (destY + y) & 0x1ff, w, h);
+            markDirty((destX + x) & 0x3ff, (destY + y) & 0x1ff, w, h);
+            x += w;
+        }
+        y += h;
+    }
 
-    uint32_t width = prim->w;
-    uint32_t height = prim->h;
+    OpenGL::enableScissor();
+    m_vramGeneration++;
+}
 
-    width = ((width - 1) & 0x3ff) + 1;
-    height = ((height - 1) & 0x1ff) + 1;
+// Copies a rectangle of VRAM which doesn't cross its edges, in native units. None of these stall: the copies
+// stay in the command stream, ordered with the draws around them.
+void PCSX::OpenGL_GPU::copyVRAM(int srcX, int srcY, int destX, int destY, int width, int height) {
+    const int scale = m_scale;
+    srcX *= scale;
+    srcY *= scale;
+    destX *= scale;
+    destY *= scale;
+    width *= scale;
+    height *= scale;
+
+    const bool overlap = (srcX < destX + width) && (destX < srcX + width) && (srcY < destY + height) &&
+                         (destY < srcY + height);
+    const GLenum target = m_multisampled ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+
+    if (!overlap) {
+        if (m_multisampled) {
+            glCopyImageSubData(m_vramTexture.handle(), target, 0, srcX, srcY, 0, m_vramTexture.handle(), target, 0,
+                               destX, destY, 0, width, height, 1);
+        } else {
+            glBlitFramebuffer(srcX, srcY, srcX + width, srcY + height, destX, destY, destX + width, destY + height,
+                              GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        }
+        return;
+    }
 
-    glBlitFramebuffer(srcX, srcY, srcX + width, srcY + height, destX, destY, destX + width, destY + height,
-                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
-    OpenGL::enableScissor();
+    // Overlapping copies go through the staging texture, at the same coordinates, then back into VRAM.
+    if (glCopyImageSubData != nullptr) {
+        glCopyImageSubData(m_vramTexture.handle(), target, 0, srcX, srcY, 0, m_blitTexture.handle(), target, 0, srcX,
+                           srcY, 0, width, height, 1);
+        glCopyImageSubData(m_blitTexture.handle(), target, 0, srcX, srcY, 0, m_vramTexture.handle(), target, 0, destX,
+                           destY, 0, width, height, 1);
+    } else {
+        m_blitFBO.bind(OpenGL::DrawFramebuffer);
+        glBlitFramebuffer(srcX, srcY, srcX + width, srcY + height, srcX, srcY, srcX + width, srcY + height,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        m_blitFBO.bind(OpenGL::ReadFramebuffer);
+        m_fbo.bind(OpenGL::DrawFramebuffer);
+        glBlitFramebuffer(srcX, srcY, srcX + width, srcY + height, destX, destY, destX + width, destY + height,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        m_fbo.bind(OpenGL::ReadFramebuffer);
+    }
 }
 
 template <PCSX::GPU::Shading shading, PCSX::GPU::Shape shape, PCSX::GPU::Textured textured, PCSX::GPU::Blend blend,
@@ -952,10 +1641,12 @@ void PCSX::OpenGL_GPU::polyExec(Poly<shading, shape, textured, blend, modulation
         if constexpr (blend == Blend::Semi) {
             setBlendingModeFromTexpage(prim->tpage.raw);
         }
-        drawTriTextured(&prim->x[0], &prim->y[0], &prim->colors[0], prim->clutraw, prim->tpage.raw, &prim->u[0],
-                        &prim->v[0]);
+        // Same as for rectangles, both triangles of a quad need to end up in the batch the page is marked as used by
+        maybeRenderBatch<shape == Shape::Quad ? 6 : 3>();
+        const uint16_t texpage = texpageAttribute(prim->tpage.raw, prim->clutraw);
+        drawTriTextured(&prim->x[0], &prim->y[0], &prim->colors[0], prim->clutraw, texpage, &prim->u[0], &prim->v[0]);
         if constexpr (shape == Shape::Quad) {
-            drawTriTextured(&prim->x[1], &prim->y[1], &prim->colors[1], prim->clutraw, prim->tpage.raw, &prim->u[1],
+            drawTriTextured(&prim->x[1], &prim->y[1], &prim->colors[1], prim->clutraw, texpage, &prim->u[1],
                             &prim->v[1]);
         }
     }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <array>
+#include <unordered_map>
 #include <vector>
 
 #include "core/gpu.h"
@@ -44,6 +45,9 @@ class OpenGL_GPU final : public GPU {
     GLuint getVRAMTexture() override;
     void setLinearFiltering() override;
     Slice getVRAM(Ownership) override;
+    Slice getVRAMRegion(int x, int y, int w, int h) override;
+    ScreenShot takeScreenShot() override;
+    void takeScreenShotAsync(ScreenShotCallback &&callback) override;
     void partialUpdateVRAM(int x, int y, int w, int h, const uint16_t *pixels, PartialUpdateVram) override;
     void restoreStatus(uint32_t status) { m_gpustat = status; }
 
@@ -103,13 +107,92 @@ class OpenGL_GPU final : public GPU {
     // For CPU->VRAM texture transfers
     OpenGL::Texture m_sampleTexture;
 
+    // Staging area for VRAM to VRAM blits whose source and destination overlap, which a single framebuffer blit
+    // leaves undefined. Same size and sample count as m_vramTexture. The framebuffer is only there for drivers
+    // without glCopyImageSubData, which are never multisampled.
+    OpenGL::Texture m_blitTexture;
+    OpenGL::Framebuffer m_blitFBO;
+
+    // Internal resolution multiplier. VRAM gets rendered at m_scale times its native size, while everything the
+    // emulated side sees stays in native units. Uploads land in m_nativeTexture first and get scaled up from there,
+    // and readbacks scale the region down into it before reading it, so only the pixels asked for are converted.
+    static constexpr int maxResolutionScale = 8;
+    int m_scale = 1;
+    OpenGL::Texture m_nativeTexture;
+    OpenGL::Framebuffer m_nativeFBO;
+
+    // Decoded 4 and 8 bits texture pages. Each 256x256 slot of the atlas holds a page already run through its CLUT,
+    // so the fragment shader does a single fetch instead of two. Primitives refer to their slot through the otherwise
+    // unused bits 9 to 14 of the texpage attribute, which hold the slot index plus one, or 0 for uncached pages.
+    struct TexturePage {
+        uint32_t key;
+        bool valid = false;
+        uint64_t lastUse;  // Value of m_batchSerial when this page was last looked up
+        OpenGL::Rectangle<int> page, clut;
+    };
+    static constexpr int texturePageSlots = 63;
+    static constexpr int texturePageAtlasSize = 2048;
+    TexturePage m_texturePages[texturePageSlots];
+    std::unordered_map<uint32_t, int> m_texturePageLookup;
+    OpenGL::Texture m_texturePageAtlas;
+    OpenGL::Framebuffer m_texturePageFBO;
+    OpenGL::Program m_texturePageProgram;
+    OpenGL::VertexArray m_texturePageVAO;
+    GLint m_texturePageParamsLoc;
+    GLint m_texturePageSlotLoc;
+    bool m_useTexturePageCache = false;
+    // VRAM writes since the sample texture was last synced. Cached pages overlapping them get dropped on the next sync.
+    std::vector<OpenGL::Rectangle<int>> m_dirtyRects;
+    bool m_dirtyAll = true;
+    uint64_t m_batchSerial = 0;
+
     // For the 16-bits to 24-bits conversion
     OpenGL::Framebuffer m_fbo24;
     OpenGL::Texture m_vramTexture24;
     Widgets::ShaderEditor m_shaderEditor24 = {"16-to-24"};
 
-    std::vector<Vertex> m_vertices;
+    // When the driver supports it, vertices are written straight into a persistently mapped buffer. It is split in
+    // vertexRingSegments segments, each guarded by a fence once we move past it, so we never overwrite vertices the GPU
+    // hasn't consumed yet. Otherwise, vertices are staged in m_vertexStorage and uploaded on every batch.
+    static constexpr int vertexRingSegments = 3;
+    static constexpr int vertexRingSegmentSize = vertexBufferSize / 4;
+    std::vector<Vertex> m_vertexStorage;
+    Vertex *m_persistentVertices = nullptr;
+    GLsync m_ringFences[vertexRingSegments] = {};
+    int m_ringSegment = 0;
+    // Start of the batch being built, its index in the vertex buffer, and how many vertices it can hold
+    Vertex *m_vertices = nullptr;
+    int m_batchFirst = 0;
+    int m_batchCapacity = vertexBufferSize;
     OpenGL::Rect m_scissorBox;
+
+    // VRAM readbacks go through pixel buffers, so the copy can be queued right away and only waited upon when its
+    // data is needed. Screenshots complete asynchronously, as we poll the queue on every UI frame and vblank.
+    struct Readback {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        int x, y, w, h;       // The VRAM region, in 16 bits units
+        uint64_t generation;  // Value of m_vramGeneration when the copy was queued
+        ScreenShotCallback screenShot;
+        uint16_t screenShotWidth;
+        bool screenShotRGB24;
+    };
+    static constexpr int readbackQueueSize = 4;
+    Readback m_readbacks[readbackQueueSize];
+    int m_nextReadback = 0;
+    // Bumped every time VRAM may have changed, to tell whether a queued readback is still current
+    uint64_t m_vramGeneration = 0;
+    // VRAM to RAM blits land here, and get handed out as a borrowed slice
+    std::vector<uint16_t> m_vramShadow;
+    // The parts of m_vramShadow which may be out of date, refreshed by getVRAM
+    VRAMDirtyTiles m_shadowDirty;
+    // If a game keeps reading back the same region frame after frame, we speculatively queue its readback at vblank.
+    // Games grabbing the previous frame before drawing anything new then find their data already on its way.
+    struct {
+        int x = 0, y = 0, w = 0, h = 0;
+        unsigned frames = 0;
+        bool readThisFrame = false;
+    } m_hotReadback;
     int m_drawAreaLeft, m_drawAreaRight, m_drawAreaTop, m_drawAreaBottom;
 
     OpenGL::ivec2 m_drawingOffset;
@@ -122,6 +205,11 @@ class OpenGL_GPU final : public GPU {
     OpenGL::vec2 m_blendFactors;
 
     bool m_multisampled = false;
+    // With GL_EXT_shader_framebuffer_fetch, the fragment shader blends semi-transparent primitives itself. Vertices
+    // then carry the transparency and blending mode, which lets every primitive go in the same batch.
+    bool m_framebufferFetch = false;
+    bool m_semiTransparent = false;
+    uint16_t m_blendingModeBits = 0;
     int m_polygonModeIndex = 0;
 
     GLint m_drawingOffsetLoc;
@@ -139,9 +227,25 @@ class OpenGL_GPU final : public GPU {
 
     template <int count>
     void maybeRenderBatch() {
-        if ((m_vertexCount + count) >= vertexBufferSize) renderBatch();
+        if ((m_vertexCount + count) >= m_batchCapacity) {
+            renderBatch();
+            if (m_persistentVertices && count >= m_batchCapacity) nextRingSegment();
+        }
     }
     void renderBatch();
+    void pushVertex(Vertex vertex);
+    void nextRingSegment();
+    void syncSampleTexture();
+    void markDirty(int x, int y, int w, int h);
+    void copyVRAM(int srcX, int srcY, int destX, int destY, int width, int height);
+    int lookupTexturePage(uint32_t texpage, uint16_t clut);
+    void decodeTexturePage(int slot, uint32_t texpage, uint16_t clut);
+    uint16_t texpageAttribute(uint32_t texpage, uint16_t clut);
+    Readback &queueReadback(int x, int y, int w, int h);
+    void finishReadback(Readback &readback, bool copyToShadow);
+    void pollReadbacks();
+    void queueSpeculativeReadback();
+    Readback *queueScreenShot(ScreenShotCallback &&callback);
     void clearVRAM(float r, float g, float b, float a = 1.0);
     void updateDrawArea();
     void setScissorArea();
@@ -42,4 +42,19 @@ PCSX::Arguments::Arguments(const CommandLine::args& args) {
     if (args.get<bool>("noupdate")) m_updateDisabled = true;
     if (args.get<bool>("viewports")) m_viewportsEnabled = true;
     if (args.get<bool>("no-viewports")) m_viewportsEnabled = false;
+    auto audioSinkPath = args.get<std::string_view>("audiosink");
+    if (audioSinkPath.has_value()) m_audioSinkPath = audioSinkPath.value();
+    auto audioHashPath = args.get<std::string_view>("audiohash");
+    if (audioHashPath.has_value()) m_audioHashPath = audioHashPath.value();
+    if (args.get<bool>("turbo")) m_turboEnabled = true;
+    m_turboPresentInterval = args.get<uint32_t>("turbo-present").value_or(0);
+    if (args.get<bool>("bootcache")) m_bootCacheEnabled = true;
+    auto replayPath = args.get<std::string_view>("replay");
+    if (replayPath.has_value()) m_replayPath = replayPath.value();
+    auto benchStatePath = args.get<std::string_view>("bench-state");
+    if (benchStatePath.has_value()) {
+        m_benchStatePath = benchStatePath.value();
+        m_turboEnabled = true;
+    }
+    m_benchFrames = args.get<uint32_t>("bench-frames").value_or(600);
 }
@@ -81,8 +81,49 @@ class Arguments {
     // Set with the flag -portable.
     std::string_view getPortablePath() const { return m_portablePath; }
 
+    // Returns the file where the audio output should be written, as raw 16 bits
+    // stereo PCM at 44.1kHz. Set with the flag -audiosink.
+    std::string_view getAudioSinkPath() const { return m_audioSinkPath; }
+
+    // Returns the file where the MD5 of the audio output should be written on exit,
+    // in hexadecimal. Set with the flag -audiohash.
+    std::string_view getAudioHashPath() const { return m_audioHashPath; }
+
+    // Returns true if the emulation should run as fast as it can, for batch jobs: nothing paces it,
+    // the frames only get presented every so often, and the emulated frame rate is reported on exit.
+    // Enabled with the flag -turbo.
+    bool isTurboEnabled() const { return m_turboEnabled; }
+
+    // Returns how often the frames get presented in turbo mode, 0 meaning never.
+    // Set with the flag -turbo-present.
+    unsigned getTurboPresentInterval() const { return m_turboPresentInterval; }
+
+    // Returns true if the boot gets resumed from a cached state of the shell hand-off, saved by an earlier
+    // boot with the same BIOS, RAM size, video standard and disc. Enabled with the flag -bootcache.
+    bool isBootCacheEnabled() const { return m_bootCacheEnabled; }
+
+    // Returns the movie to replay headless, as fast as possible, before exiting.
+    // Set with the flag -replay.
+    std::string_view getReplayPath() const { return m_replayPath; }
+
+    // Returns the save state to run the whole system benchmark from, which implies turbo mode.
+    // Set with the flag -bench-state, along with -bench-frames for how many frames to run, 600 by default.
+    std::string_view getBenchStatePath() const { return m_benchStatePath; }
+    unsigned getBenchFrames() const { return m_benchFrames; }
+
+    // Returns true if the audio output goes to a file instead of an audio device. The
+    // emulation then isn't paced by the audio anymore, and runs as fast as it can.
+    // Headless replays and turbo mode don't play their audio either, even without a file to write it to.
+    bool isAudioSinkEnabled() const {
+        return !m_audioSinkPath.empty() || !m_audioHashPath.empty() || !m_replayPath.empty() || m_turboEnabled;
+    }
+
   private:
     std::string m_portablePath = "";
+    std::string m_audioSinkPath = "";
+    std::string m_audioHashPath = "";
+    std::string m_replayPath = "";
+    std::string m_benchStatePath = "";
     bool m_luaStdoutEnabled = false;
     bool m_stdoutEnabled = false;
     bool m_guiLogsEnabled = true;
@@ -92,6 +133,10 @@ class Arguments {
     bool m_uiResetRequested = false;
     bool m_shadersDisabled = false;
     bool m_updateDisabled = false;
+    bool m_turboEnabled = false;
+    bool m_bootCacheEnabled = false;
+    unsigned m_turboPresentInterval = 0;
+    unsigned m_benchFrames = 600;
 #ifdef __linux__
     bool m_viewportsEnabled = false;
 #else
@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/blocktrace.h"
+
+#include <string.h>
+
+#include "core/disr3000a.h"
+#include "core/system.h"
+#include "fmt/format.h"
+
+namespace {
+
+const char* registerName(unsigned index) {
+    if (index == 32) return "lo";
+    if (index == 33) return "hi";
+    return PCSX::Disasm::s_disRNameGPR[index];
+}
+
+}  // namespace
+
+bool PCSX::BlockTrace::record(const std::filesystem::path& filename) {
+    close();
+    if (!m_writer.open(filename, true)) return false;
+    m_mode = Mode::Record;
+    return true;
+}
+
+bool PCSX::BlockTrace::verify(const std::filesystem::path& filename) {
+    close();
+    if (!m_reader.open(filename)) return false;
+    m_mode = Mode::Verify;
+    return true;
+}
+
+void PCSX::BlockTrace::close() {
+    m_mode = Mode::Off;
+    m_writer.close();
+    m_reader.close();
+    m_lookahead.clear();
+    m_referenceEnded = false;
+    m_misses = 0;
+    m_firstMiss = 0;
+    m_matched = 0;
+    m_lastMatch = {};
+}
+
+void PCSX::BlockTrace::fill() {
+    while (!m_referenceEnded && (m_lookahead.size() < c_window)) {
+        const auto status = m_reader.next();
+        if (status == ExecTrace::Reader::Status::Checkpoint) {
+            const auto& decoder = m_reader.decoder();
+            auto& checkpoint = m_lookahead.emplace_back();
+            checkpoint.pc = decoder.pc();
+            checkpoint.cycle = decoder.cycle();
+            memcpy(checkpoint.regs, decoder.registers(), sizeof(checkpoint.regs));
+        } else if (status == ExecTrace::Reader::Status::Instruction) {
+            // Single instructions can't be lined up with the block boundaries, so they get ignored.
+            continue;
+        } else {
+            if (status == ExecTrace::Reader::Status::Error) {
+                g_system->printf(_("Block trace: the reference is corrupted after %u records.\n"),
+                                 unsigned(m_reader.count()));
+            }
+            m_referenceEnded = true;
+        }
+    }
+}
+
+void PCSX::BlockTrace::check(uint32_t pc, uint64_t cycle, const uint32_t* regs) {
+    fill();
+    for (size_t i = 0; i < m_lookahead.size(); i++) {
+        const auto& reference = m_lookahead[i];
+        if (reference.pc != pc) continue;
+        if (memcmp(reference.regs, regs, sizeof(reference.regs)) != 0) {
+            std::string report = fmt::format(
+                "Block trace divergence after {} matching blocks, with the registers differing at pc {:08x}, "
+                "cycle {}, reference cycle {}:\n",
+                m_matched, pc, cycle, reference.cycle);
+            for (unsigned r = 0; r < ExecTrace::REGISTERS; r++) {
+                if (reference.regs[r] == regs[r]) continue;
+                report += fmt::format("  {}: {:08x}, reference {:08x}\n", registerName(r), regs[r], reference.regs[r]);
+            }
+            diverged(report);
+            return;
+        }
+        m_lastMatch = reference;
+        m_matched++;
+        m_misses = 0;
+        m_lookahead.erase(m_lookahead.begin(), m_lookahead.begin() + i + 1);
+        return;
+    }
+
+    if (m_lookahead.empty()) {
+        g_system->printf(_("Block trace: reached the end of the reference, after %u matching blocks.\n"),
+                         unsigned(m_matched));
+        close();
+        return;
+    }
+    if (m_misses++ == 0) m_firstMiss = pc;
+    if (m_misses < c_window) return;
+    diverged(fmt::format(
+        "Block trace divergence after {} matching blocks, with the control flow differing. The last match was at pc "
+        "{:08x}, cycle {}, and the reference went on to {:08x}, while this went to {:08x}.\n",
+        m_matched, m_lastMatch.pc, m_lastMatch.cycle, m_lookahead.front().pc, m_firstMiss));
+}
+
+void PCSX::BlockTrace::diverged(const std::string& report) {
+    g_system->printf("%s", report.c_str());
+    close();
+    g_system->pause();
+    if (g_system->getArgs().isTestModeEnabled()) g_system->quit(1);
+}
@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <deque>
+#include <filesystem>
+#include <string>
+
+#include "core/tracewriter.h"
+#include "supportpsx/exectrace-reader.h"
+
+namespace PCSX {
+
+// Records the registers at every block boundary, or checks them against such a recording, in order to
+// run the same code with two different CPU cores, and find out where they start disagreeing. The two
+// cores won't split the code into the same blocks, so each boundary gets matched against the next one
+// with the same pc in the reference, and the boundaries without any counterpart are skipped over.
+class BlockTrace {
+  public:
+    ~BlockTrace() { close(); }
+    bool record(const std::filesystem::path& filename);
+    bool verify(const std::filesystem::path& filename);
+    void close();
+    bool isActive() const { return m_mode != Mode::Off; }
+
+    // To be called in between blocks, before running the one at pc.
+    void step(uint32_t pc, uint64_t cycle, const uint32_t* regs) {
+        if (m_mode == Mode::Record) {
+            m_writer.checkpoint(pc, cycle, regs);
+        } else {
+            check(pc, cycle, regs);
+        }
+    }
+
+  private:
+    // How far ahead to look into the reference for the current pc, and how many boundaries in a row can
+    // go without a match before calling it a divergence.
+    static constexpr unsigned c_window = 64;
+
+    enum class Mode { Off, Record, Verify };
+    struct Checkpoint {
+        uint32_t pc = 0;
+        uint64_t cycle = 0;
+        uint32_t regs[ExecTrace::REGISTERS] = {};
+    };
+
+    void check(uint32_t pc, uint64_t cycle, const uint32_t* regs);
+    void fill();
+    [[gnu::cold]] void diverged(const std::string& report);
+
+    Mode m_mode = Mode::Off;
+    TraceWriter m_writer;
+    ExecTrace::Reader m_reader;
+    std::deque<Checkpoint> m_lookahead;
+    bool m_referenceEnded = false;
+    unsigned m_misses = 0;
+    uint32_t m_firstMiss = 0;
+    uint64_t m_matched = 0;
+    Checkpoint m_lastMatch;
+};
+
+}  // namespace PCSX
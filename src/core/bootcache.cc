@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   Copyright (C) 2026 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/bootcache.h"
+
+#include <ctype.h>
+#include <zlib.h>
+
+#include <system_error>
+
+#include "core/arguments.h"
+#include "core/cdrom.h"
+#include "core/logger.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/system.h"
+#include "fmt/format.h"
+#include "support/file.h"
+
+namespace {
+
+// A state saved by another build can still load, yet come from a BIOS run against different code.
+uint32_t getBuildKey() {
+    const auto& version = PCSX::g_system->getVersion();
+    uint32_t crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, (const Bytef*)version.version.data(), version.version.size());
+    crc = crc32(crc, (const Bytef*)version.changeset.data(), version.changeset.size());
+    const uint32_t buildId = version.buildId.value_or(0);
+    return crc32(crc, (const Bytef*)&buildId, sizeof(buildId));
+}
+
+// The BIOS runs the pre and post boot hooks of whatever sits in EXP1, so the cartridge contents are part
+// of the boot too. Only the PIO window ever gets filled.
+uint32_t getEXP1Key() {
+    if (!PCSX::g_emulator->settings.get<PCSX::Emulator::SettingPIOConnected>()) return 0;
+    uint32_t crc = crc32(0L, Z_NULL, 0);
+    return crc32(crc, PCSX::g_emulator->m_mem->m_exp1, 0x00040000);
+}
+
+}  // namespace
+
+bool PCSX::BootCache::enabled() {
+    return g_system->getArgs().isBootCacheEnabled() || g_emulator->settings.get<Emulator::SettingBootCache>();
+}
+
+std::filesystem::path PCSX::BootCache::path() {
+    const auto& settings = g_emulator->settings;
+    std::string disc = g_emulator->m_cdrom->getCDRomID();
+    if (disc.empty()) disc = "nodisc";
+    // The disc ID comes from the disc itself, and is only ever used as part of a file name.
+    for (auto& c : disc) {
+        if (!isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+    const auto name = fmt::format("{:08x}-{:08x}-{:08x}-{}-{}-{}.sstate", getBuildKey(),
+                                  g_emulator->m_mem->getBiosCRC32(), getEXP1Key(),
+                                  settings.get<Emulator::Setting8MB>() ? "8mb" : "2mb",
+                                  settings.get<Emulator::SettingVideo>() == Emulator::PSX_TYPE_PAL ? "pal" : "ntsc",
+                                  disc);
+    return g_system->getPersistentDir() / "bootcache" / name;
+}
+
+bool PCSX::BootCache::restore() {
+    m_restored = false;
+    if (!enabled()) return false;
+    m_writer.wait();
+    const auto filename = path();
+    std::error_code ec;
+    if (!std::filesystem::exists(filename, ec)) return false;
+    IO<File> file(new PosixFile(filename));
+    // A state that doesn't load, for instance because of a version mismatch, gets replaced by a fresh one.
+    if (!SaveStates::load(file)) {
+        g_system->log(LogClass::UI, "Boot cache: failed to load %s\n", filename.string());
+        file->close();
+        std::filesystem::remove(filename, ec);
+        return false;
+    }
+    g_system->log(LogClass::UI, "Boot cache: resumed from %s\n", filename.string());
+    m_restored = true;
+    return true;
+}
+
+void PCSX::BootCache::shellReached() {
+    if (!enabled()) return;
+    if (m_restored) {
+        m_restored = false;
+        return;
+    }
+    const auto filename = path();
+    std::error_code ec;
+    if (std::filesystem::exists(filename, ec)) return;
+    std::filesystem::create_directories(filename.parent_path(), ec);
+    // Serializing the state happens right now, before the shell gets a chance to run. Compressing and
+    // writing it happen in the background.
+    if (m_writer.save(filename, SaveStates::Codec::GZipFast)) {
+        g_system->log(LogClass::UI, "Boot cache: saved %s\n", filename.string());
+    }
+}
@@ -0,0 +1,48 @@
+/***************************************************************************
+ *   Copyright (C) 2026 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+
+#include "core/sstate.h"
+
+namespace PCSX {
+
+// Skips the BIOS initialization on boot. The first time the BIOS hands over to the shell, the state of
+// the machine gets saved, keyed by the emulator build, the BIOS, the EXP1 cartridge, the RAM size, the
+// video standard and the disc. Later resets with the same key load it back straight away, and boot on
+// from the shell hand-off, fast boot and binary loading included.
+class BootCache {
+  public:
+    // Called from reset, once the machine is back to its power on state. Returns true if the cached state
+    // got loaded.
+    bool restore();
+    // Called when the BIOS reaches the shell, before anything changes the pc.
+    void shellReached();
+
+  private:
+    static bool enabled();
+    static std::filesystem::path path();
+
+    bool m_restored = false;
+    SaveStates::FileWriter m_writer;
+};
+
+}  // namespace PCSX
@@ -24,7 +24,8 @@
 #include "core/r3000a.h"
 #include "core/system.h"
 
-#if 0
+// Tracing the tracker is far too verbose to be left in; build with PCSX_CALLSTACKS_DEBUG defined to see it.
+#ifdef PCSX_CALLSTACKS_DEBUG
 template <typename... Args>
 static void debugLog(const char* format, const Args&... args) {
     PCSX::g_system->log(PCSX::LogClass::SYSTEM, "%08x: ", PCSX::g_emulator->m_cpu->m_regs.pc);
@@ -40,28 +41,44 @@ static void normalLog(const char* format, const Args&... args) {
     PCSX::g_system->log(PCSX::LogClass::SYSTEM, format, args...);
 }
 
+PCSX::CallStacks::CallStack* PCSX::CallStacks::allocate(uint32_t low, uint32_t high) {
+    CallStack* victim = &m_callstacks[0];
+    for (auto& stack : m_callstacks) {
+        if (!stack.used) {
+            victim = &stack;
+            break;
+        }
+        if (stack.lastUse < victim->lastUse) victim = &stack;
+    }
+    if (victim->used) {
+        debugLog("[CSDBG] allocate: evicting callstack 0x%08x - 0x%08x\n", victim->low, victim->high);
+        release(victim);
+    }
+    victim->used = true;
+    victim->low = low;
+    victim->high = high;
+    victim->lastUse = ++m_useCounter;
+    return victim;
+}
+
 void PCSX::CallStacks::setSP(uint32_t oldSP, uint32_t newSP) {
     debugLog("[CSDBG] setSP(0x%08x, 0x%08x)\n", oldSP, newSP);
     m_current = nullptr;
-    auto callstack = m_callstacks.find(newSP, TreeType::INTERVAL_SEARCH);
-    ListType todelete;
     m_currentSP = newSP;
-    while (callstack != m_callstacks.end()) {
-        if (callstack->getLow() == newSP) {
-            debugLog("[CSDBG] setSP: switching callstack to 0x%08x - 0x%08x\n", callstack->getLow(),
-                     callstack->getHigh());
-            m_current = &*callstack;
+    for (auto& stack : m_callstacks) {
+        if (!stack.used || (stack.low > newSP) || (stack.high < newSP)) continue;
+        if (stack.low == newSP) {
+            debugLog("[CSDBG] setSP: switching callstack to 0x%08x - 0x%08x\n", stack.low, stack.high);
+            stack.lastUse = ++m_useCounter;
+            m_current = &stack;
         } else {
             // Don't nuke a callstack on a spurious lui
             if (newSP & 0xffff) {
-                debugLog("[CSDBG] setSP: deleting obsolete callstack 0x%08x - 0x%08x\n", callstack->getLow(),
-                         callstack->getHigh());
-                todelete.push_back(&*callstack);
+                debugLog("[CSDBG] setSP: deleting obsolete callstack 0x%08x - 0x%08x\n", stack.low, stack.high);
+                release(&stack);
             }
         }
-        callstack++;
     }
-    todelete.destroyAll();
 }
 
 void PCSX::CallStacks::offsetSP(uint32_t oldSP, int32_t offset) {
@@ -69,45 +86,47 @@ void PCSX::CallStacks::offsetSP(uint32_t oldSP, int32_t offset) {
     uint32_t highSP = oldSP;
     m_currentSP = lowSP;
     debugLog("[CSDBG] offsetSP: moving stack from 0x%08x to 0x%08x\n", oldSP, lowSP);
-    if (!m_current) {
-        debugLog("[CSDBG] offsetSP: no current stack, creating a new one\n");
-        m_current = new CallStack();
-    } else {
-        highSP = m_current->getHigh();
+    if (m_current) {
+        highSP = m_current->high;
         debugLog("[CSDBG] offsetSP: adjusting high pointer to 0x%08x\n", highSP);
     }
     if (lowSP > highSP) {
         debugLog("[CSDBG] inconsistent stack offset; adjusting (low = 0x%08x, high = 0x%08x)\n", lowSP, highSP);
         highSP = lowSP;
     }
-    m_callstacks.unlink(m_current);
-    auto callstacks = m_callstacks.find(lowSP, highSP);
-    ListType todelete;
-    while (callstacks != m_callstacks.end()) {
-        debugLog("[CSDBG] deleting intersecting stack\n", callstacks->getLow(), callstacks->getHigh());
-        todelete.push_back(&*callstacks);
-        callstacks++;
+    for (auto& stack : m_callstacks) {
+        if (!stack.used || (&stack == m_current) || (stack.low > highSP) || (stack.high < lowSP)) continue;
+        debugLog("[CSDBG] deleting intersecting stack 0x%08x - 0x%08x\n", stack.low, stack.high);
+        release(&stack);
+    }
+    if (!m_current) {
+        debugLog("[CSDBG] offsetSP: no current stack, creating a new one\n");
+        m_current = allocate(lowSP, highSP);
+    } else {
+        m_current->low = lowSP;
+        m_current->high = highSP;
+        m_current->lastUse = ++m_useCounter;
     }
-    todelete.destroyAll();
-    m_callstacks.insert(lowSP, highSP, m_current);
     auto& calls = m_current->calls;
-    CallStack::Call* maybeShadow = nullptr;
+    // A call made from the shadow space just below the stack survives the stack growing back past it, unless
+    // the call under it gets popped as well.
+    bool maybeShadow = false;
     while (true) {
-        if ((calls.size() == 0) || ((calls.size() == 1) && maybeShadow)) break;
-        auto last = --calls.end();
-        if (maybeShadow) last--;
-        if (last->sp >= lowSP) break;
+        unsigned size = calls.size();
+        if ((size == 0) || ((size == 1) && maybeShadow)) break;
+        auto& last = calls[maybeShadow ? size - 2 : size - 1];
+        if (last.sp >= lowSP) break;
         if (maybeShadow) {
-            debugLog("[CSDBG] offsetSP: deleting shadow space call to 0x%08x from 0x%08x\n", maybeShadow->ra,
-                     maybeShadow->sp);
-            delete maybeShadow;
-            maybeShadow = nullptr;
+            debugLog("[CSDBG] offsetSP: deleting shadow space call to 0x%08x from 0x%08x\n", calls.back().ra,
+                     calls.back().sp);
+            calls.pop();
+            maybeShadow = false;
         }
-        if (last->shadow) {
-            maybeShadow = &*last;
+        if (last.shadow) {
+            maybeShadow = true;
         } else {
-            debugLog("[CSDBG] offsetSP: deleting call to 0x%08x from 0x%08x\n", last->ra, last->sp);
-            delete &*last;
+            debugLog("[CSDBG] offsetSP: deleting call to 0x%08x from 0x%08x\n", last.ra, last.sp);
+            calls.pop();
             m_current->ra = 0;
             m_current->fp = 0;
         }
@@ -119,8 +138,8 @@ void PCSX::CallStacks::storeRA(uint32_t sp, uint32_t ra) {
         normalLog("[CS] Got 0x%08x written to 0x%08x, but we don't have a callstack for it.\n", ra, sp);
         return;
     }
-    uint32_t low = m_current->getLow();
-    uint32_t high = m_current->getHigh();
+    uint32_t low = m_current->low;
+    uint32_t high = m_current->high;
     bool shadow = false;
     if ((high < sp) || (low > sp)) {
         if ((low - 16) > sp) {
@@ -143,7 +162,7 @@ void PCSX::CallStacks::storeRA(uint32_t sp, uint32_t ra) {
     } else {
         debugLog("[CSDBG] storeRA: creating call to 0x%08x from 0x%08x on stack 0x%08x\n", ra, sp, high);
     }
-    m_current->calls.push_back(new CallStack::Call(sp, fp, ra, shadow));
+    m_current->calls.push({sp, fp, ra, shadow});
 }
 
 void PCSX::CallStacks::loadRA(uint32_t sp) {
@@ -152,14 +171,14 @@ void PCSX::CallStacks::loadRA(uint32_t sp) {
         return;
     }
     auto& calls = m_current->calls;
-    if (calls.size() == 0) {
+    if (calls.empty()) {
         debugLog("[CSDBG] Got a RA load from 0x%08x, but current stack is empty.\n", sp);
         return;
     }
-    auto last = --calls.end();
-    if (last->sp != sp) {
+    auto& last = calls.back();
+    if (last.sp != sp) {
         debugLog("[CSDBG] Got a RA load from 0x%08x, but the active stack's at 0x%08x (ra: 0x%08x, size = %i)\n", sp,
-                 last->sp, last->ra, calls.size());
+                 last.sp, last.ra, calls.size());
     }
 }
 
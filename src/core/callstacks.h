@@ -21,60 +21,108 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <array>
+
 #include "core/system.h"
 #include "support/eventbus.h"
-#include "support/list.h"
-#include "support/tree.h"
 
 namespace PCSX {
 
 struct SaveStateWrapper;
 
+// Shadow model of the guest's call stacks, fed by the CPU whenever $sp moves or $ra gets spilled. Since this
+// happens at nearly every function prologue and epilogue, everything lives in fixed-size arrays, and nothing
+// gets allocated while tracking.
 class CallStacks {
   public:
-    struct CallStack;
+    // How many distinct stack regions are tracked at once; the least recently used one gets evicted past that.
+    static constexpr unsigned MAX_STACKS = 16;
+    // How many calls deep each stack goes; the outermost calls get forgotten past that.
+    static constexpr unsigned MAX_DEPTH = 256;
+    static_assert((MAX_DEPTH & (MAX_DEPTH - 1)) == 0, "MAX_DEPTH needs to be a power of 2");
 
-  private:
-    typedef Intrusive::Tree<uint32_t, CallStack> TreeType;
-    typedef Intrusive::List<CallStack> ListType;
+    struct Call {
+        uint32_t sp, fp, ra;
+        bool shadow;
+    };
+    // The calls of a stack, as a ring which drops the outermost call when full. Index 0 is the outermost one.
+    class Calls {
+      public:
+        unsigned size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        const Call& operator[](unsigned index) const { return m_calls[(m_first + index) & (MAX_DEPTH - 1)]; }
+        const Call& back() const { return (*this)[m_size - 1]; }
+        void push(const Call& call) {
+            if (m_size == MAX_DEPTH) {
+                m_first = (m_first + 1) & (MAX_DEPTH - 1);
+                m_size--;
+            }
+            m_calls[(m_first + m_size++) & (MAX_DEPTH - 1)] = call;
+        }
+        void pop() { m_size--; }
+        void clear() { m_first = m_size = 0; }
 
-  public:
-    struct CallStack : public TreeType::Node, public ListType::Node {
-        struct Call;
-        typedef Intrusive::List<Call> ListType;
-        struct Call : public ListType::Node {
-            Call(uint32_t sp_, uint32_t fp_, uint32_t ra_, bool shadow_) : sp(sp_), fp(fp_), ra(ra_), shadow(shadow_) {}
-            uint32_t sp, fp, ra;
-            bool shadow;
-        };
-        ~CallStack() { calls.destroyAll(); }
-        ListType calls;
+      private:
+        std::array<Call, MAX_DEPTH> m_calls;
+        unsigned m_first = 0;
+        unsigned m_size = 0;
+    };
+    struct CallStack {
+        uint32_t getLow() const { return low; }
+        uint32_t getHigh() const { return high; }
+        Calls calls;
+        uint32_t low = 0, high = 0;
         uint32_t ra = 0, fp = 0;
+
+      private:
+        friend class CallStacks;
+        uint64_t lastUse = 0;
+        bool used = false;
     };
 
     bool hasCurrent() { return m_current; }
     const CallStack& getCurrent() { return *m_current; }
-    const TreeType& getCallstacks() { return m_callstacks; }
+    // Calls the functor with every tracked stack, by increasing address.
+    template <typename Func>
+    void forEachCallstack(Func&& func) const {
+        std::array<const CallStack*, MAX_STACKS> stacks;
+        unsigned count = 0;
+        for (auto& stack : m_callstacks) {
+            if (stack.used) stacks[count++] = &stack;
+        }
+        std::sort(stacks.begin(), stacks.begin() + count,
+                  [](const CallStack* a, const CallStack* b) { return a->low < b->low; });
+        for (unsigned i = 0; i < count; i++) func(*stacks[i]);
+    }
 
     void serialize(SaveStateWrapper*);
     void deserialize(const SaveStateWrapper*);
 
   private:
-    TreeType m_callstacks;
+    void clear() {
+        for (auto& stack : m_callstacks) release(&stack);
+        m_current = nullptr;
+        m_currentSP = 0;
+    }
+    CallStack* allocate(uint32_t low, uint32_t high);
+    void release(CallStack* stack) {
+        stack->used = false;
+        stack->calls.clear();
+        stack->ra = stack->fp = 0;
+    }
+
+    std::array<CallStack, MAX_STACKS> m_callstacks;
     CallStack* m_current = nullptr;
     uint32_t m_currentSP = 0;
+    uint64_t m_useCounter = 0;
 
     EventBus::Listener m_listener;
 
   public:
     CallStacks() : m_listener(g_system->m_eventBus) {
-        m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) {
-            m_callstacks.clear();
-            m_current = nullptr;
-            m_currentSP = 0;
-        });
+        m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) { clear(); });
     }
-    ~CallStacks() { m_callstacks.destroyAll(); }
     void setSP(uint32_t oldSP, uint32_t newSP);
     void offsetSP(uint32_t oldSP, int32_t offset);
     void storeRA(uint32_t sp, uint32_t ra);
@@ -23,6 +23,7 @@
 
 #include "core/cdrom.h"
 
+#include <algorithm>
 #include <magic_enum_all.hpp>
 
 #include "cdrom/iso9660-reader.h"
@@ -182,10 +183,23 @@ class CDRomImpl : public PCSX::CDRom {
         PCSX::g_emulator->m_cpu->scheduleInterrupt(PCSX::PSXINT_CDRDMA, eCycle);
     }
 
+    // Fast timings, see latchSpeedups. Delays never go below irqReschedule, so the game still gets
+    // a bit of time between events. Streaming reads keep their actual pace, as XA audio is played
+    // back as the sectors come in.
+    static uint32_t speedup(uint32_t cycles, uint32_t divisor) {
+        if (divisor <= 1) return cycles;
+        return std::max(cycles / divisor, uint32_t(irqReschedule));
+    }
+    uint32_t seekDelay(uint32_t cycles) const { return speedup(cycles, m_seekSpeedup); }
+    uint32_t readDelay(uint32_t cycles) const {
+        return (m_mode & MODE_STRSND) ? cycles : speedup(cycles, m_readSpeedup);
+    }
+    uint32_t spinDelay(uint32_t cycles) const { return speedup(cycles, m_spinSpeedup); }
+
     inline void StopReading() {
         if (m_reading) {
             m_reading = 0;
-            PCSX::g_emulator->m_cpu->m_regs.interrupt &= ~(1 << PCSX::PSXINT_CDREAD);
+            PCSX::g_emulator->m_cpu->cancelInterrupt(PCSX::PSXINT_CDREAD);
         }
         m_statP &= ~(STATUS_READ | STATUS_SEEK);
     }
@@ -210,21 +224,20 @@ class CDRomImpl : public PCSX::CDRom {
         if (m_stat & m_reg2) PCSX::g_emulator->m_mem->setIRQ(4);
     }
 
-    void adjustTransferIndex(void) {
-        size_t bufSize = 0;
-
+    size_t transferBufferSize() {
         switch (m_mode & (MODE_SIZE_2340 | MODE_SIZE_2328)) {
             case MODE_SIZE_2340:
-                bufSize = 2340;
-                break;
+                return 2340;
             case MODE_SIZE_2328:
-                bufSize = 12 + 2328;
-                break;
+                return 12 + 2328;
             case MODE_SIZE_2048:
             default:
-                bufSize = 12 + 2048;
-                break;
+                return 12 + 2048;
         }
+    }
+
+    void adjustTransferIndex(void) {
+        size_t bufSize = transferBufferSize();
 
         if (m_transferIndex >= bufSize) m_transferIndex -= bufSize;
 
@@ -313,7 +326,7 @@ class CDRomImpl : public PCSX::CDRom {
                     // only sometimes does that
                     // (not done when lots of commands are sent?)
 
-                    scheduleCDLidIRQ(cdReadTime * 30);
+                    scheduleCDLidIRQ(spinDelay(cdReadTime * 30));
                     break;
                 } else if (m_statP & STATUS_ROTATING) {
                     m_statP &= ~STATUS_ROTATING;
@@ -325,7 +338,7 @@ class CDRomImpl : public PCSX::CDRom {
                     // and is only cleared by CdlGetStat
 
                     m_driveState = DRIVESTATE_RESCAN_CD;
-                    scheduleCDLidIRQ(cdReadTime * 105);
+                    scheduleCDLidIRQ(spinDelay(cdReadTime * 105));
                     break;
                 }
 
@@ -339,14 +352,14 @@ class CDRomImpl : public PCSX::CDRom {
 
                 // this is very long on real hardware, over 6 seconds
                 // make it a bit faster here...
-                scheduleCDLidIRQ(cdReadTime * 150);
+                scheduleCDLidIRQ(spinDelay(cdReadTime * 150));
                 break;
 
             case DRIVESTATE_PREPARE_CD:
                 m_statP |= STATUS_SEEK;
 
                 m_driveState = DRIVESTATE_STANDBY;
-                scheduleCDLidIRQ(cdReadTime * 26);
+                scheduleCDLidIRQ(seekDelay(cdReadTime * 26));
                 break;
         }
     }
@@ -412,7 +425,12 @@ class CDRomImpl : public PCSX::CDRom {
             m_suceeded = false;
         } else {
             m_suceeded = m_iso->readTrack(time);
-            if (m_suceeded) m_prev = time;
+            if (m_suceeded) {
+                m_prev = time;
+                m_readStats.dataSectors++;
+            } else {
+                m_readStats.failures++;
+            }
         }
 
         const PCSX::IEC60908b::Sub *sub = m_iso->getBufferSub();
@@ -537,6 +555,7 @@ class CDRomImpl : public PCSX::CDRom {
         }
 
         m_iso->readCDDA(m_setSectorPlay, m_transfer);
+        m_readStats.audioSectors++;
         if (!m_irq && !m_stat && (m_mode & (MODE_AUTOPAUSE | MODE_REPORT))) cdrPlayInterrupt_Autopause();
 
         if (!m_play) return;
@@ -549,7 +568,7 @@ class CDRomImpl : public PCSX::CDRom {
         m_setSectorPlay++;
 
         if (m_locationChanged) {
-            scheduleCDPlayIRQ(cdReadTime * 30);
+            scheduleCDPlayIRQ(seekDelay(cdReadTime * 30));
             m_locationChanged = false;
         } else {
             scheduleCDPlayIRQ(cdReadTime);
@@ -603,6 +622,8 @@ class CDRomImpl : public PCSX::CDRom {
                 break;
 
             case CdlSetloc:
+                // Whatever was prefetched after the previous location won't be needed anymore
+                m_iso->cancelReadAhead();
                 break;
 
             do_CdlPlay:
@@ -691,7 +712,7 @@ class CDRomImpl : public PCSX::CDRom {
                     error = ERROR_INVALIDARG;
                     goto set_error;
                 }
-                AddIrqQueue(CdlStandby + 0x100, cdReadTime * 125 / 2);
+                AddIrqQueue(CdlStandby + 0x100, spinDelay(cdReadTime * 125 / 2));
                 start_rotating = 1;
                 break;
 
@@ -710,7 +731,7 @@ class CDRomImpl : public PCSX::CDRom {
                 StopReading();
 
                 delay = 0x800;
-                if (m_driveState == DRIVESTATE_STANDBY) delay = cdReadTime * 30 / 2;
+                if (m_driveState == DRIVESTATE_STANDBY) delay = spinDelay(cdReadTime * 30 / 2);
 
                 m_driveState = DRIVESTATE_STOPPED;
                 AddIrqQueue(CdlStop + 0x100, delay);
@@ -816,7 +837,7 @@ class CDRomImpl : public PCSX::CDRom {
 
             case CdlReadT:  // SetSession?
                 // really long
-                AddIrqQueue(CdlReadT + 0x100, cdReadTime * 290 / 4);
+                AddIrqQueue(CdlReadT + 0x100, spinDelay(cdReadTime * 290 / 4));
                 start_rotating = 1;
                 break;
 
@@ -857,6 +878,7 @@ class CDRomImpl : public PCSX::CDRom {
             case CdlSeekP:
                 StopCdda();
                 StopReading();
+                m_iso->cancelReadAhead();
                 m_statP |= STATUS_SEEK;
 
                 /*
@@ -872,7 +894,7 @@ class CDRomImpl : public PCSX::CDRom {
                 Rockman X5 = 0.5-4x
                 - fix capcom logo
                 */
-                scheduleCDPlayIRQ(m_seeked == SEEK_DONE ? 0x800 : cdReadTime * 4);
+                scheduleCDPlayIRQ(seekDelay(m_seeked == SEEK_DONE ? 0x800 : cdReadTime * 4));
                 m_seeked = SEEK_PENDING;
                 start_rotating = 1;
                 break;
@@ -946,7 +968,7 @@ class CDRomImpl : public PCSX::CDRom {
                 break;
 
             case CdlReadToc:
-                AddIrqQueue(CdlReadToc + 0x100, cdReadTime * 180 / 4);
+                AddIrqQueue(CdlReadToc + 0x100, spinDelay(cdReadTime * 180 / 4));
                 no_busy_error = 1;
                 start_rotating = 1;
                 break;
@@ -981,7 +1003,7 @@ class CDRomImpl : public PCSX::CDRom {
                 // Crusaders of Might and Magic - update getlocl now
                 // - fixes cutscene speech
                 {
-                    uint8_t *buf = m_iso->getBuffer();
+                    const uint8_t *buf = m_iso->getBuffer();
                     if (buf != NULL) memcpy(m_transfer, buf, 8);
                 }
 
@@ -1013,12 +1035,12 @@ class CDRomImpl : public PCSX::CDRom {
                     // - fix cutscene speech (startup)
 
                     // ??? - use more accurate seek time later
-                    scheduleCDReadIRQ((m_mode & 0x80) ? (cdReadTime) : cdReadTime * 2);
+                    scheduleCDReadIRQ(readDelay((m_mode & 0x80) ? (cdReadTime) : cdReadTime * 2));
                 } else {
                     m_statP |= STATUS_READ;
                     m_statP &= ~STATUS_SEEK;
 
-                    scheduleCDReadIRQ((m_mode & 0x80) ? (cdReadTime) : cdReadTime * 2);
+                    scheduleCDReadIRQ(readDelay((m_mode & 0x80) ? (cdReadTime) : cdReadTime * 2));
                 }
 
                 m_result[0] = m_statP;
@@ -1105,7 +1127,7 @@ class CDRomImpl : public PCSX::CDRom {
     }
 
     void readInterrupt() final {
-        uint8_t *buf;
+        const uint8_t *buf;
 
         if (!m_reading) return;
 
@@ -1182,10 +1204,10 @@ class CDRomImpl : public PCSX::CDRom {
 
         uint32_t delay = (m_mode & MODE_SPEED) ? (cdReadTime / 2) : cdReadTime;
         if (m_locationChanged) {
-            scheduleCDReadIRQ(delay * 30);
+            scheduleCDReadIRQ(seekDelay(delay * 30));
             m_locationChanged = false;
         } else {
-            scheduleCDReadIRQ(delay);
+            scheduleCDReadIRQ(readDelay(delay));
         }
 
         /*
@@ -1462,10 +1484,17 @@ class CDRomImpl : public PCSX::CDRom {
                 - CdlPlay
                 - Spams DMA3 and gets buffer overrun
                 */
-                for (i = 0; i < cdsize; ++i) {
-                    memFile->write<uint8_t>(m_transfer[m_transferIndex++]);
+                // The transfer buffer gets copied in blocks, up to each point where it wraps around.
+                for (i = 0; i < cdsize;) {
+                    const size_t bufSize = transferBufferSize();
+                    const size_t left = m_transferIndex < bufSize ? bufSize - m_transferIndex : 1;
+                    const size_t block = std::min(size_t(cdsize - i), left);
+                    memFile->write(m_transfer + m_transferIndex, block);
+                    m_transferIndex += block;
+                    i += block;
                     adjustTransferIndex();
                 }
+                PCSX::g_emulator->m_mem->markDirtyRange(madr, cdsize);
                 PCSX::g_emulator->m_mem->msanDmaWrite(madr, cdsize);
                 if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
                         .get<PCSX::Emulator::DebugSettings::Debug>()) {
@@ -1555,6 +1584,8 @@ class CDRomImpl : public PCSX::CDRom {
         m_subq.absolute[2] = 0;
         m_trackChanged = false;
 
+        latchSpeedups();
+
         m_curTrack = 1;
         m_file = 1;
         m_channel = 1;
@@ -1716,4 +1747,26 @@ void PCSX::CDRom::check() {
     g_system->printf(_("CD-ROM Label: %.32s\n"), m_cdromLabel);
     g_system->printf(_("CD-ROM ID: %.9s\n"), m_cdromId);
     g_system->printf(_("CD-ROM EXE Name: %.255s\n"), exename);
+
+    latchSpeedups();
+}
+
+// The speedups are only picked up on reset or when the disc changes, and are then saved with the state,
+// so that a savestate or a replay taken with fast timings is played back with the same timings.
+void PCSX::CDRom::latchSpeedups() {
+    auto &settings = g_emulator->settings;
+    m_seekSpeedup = m_readSpeedup = m_spinSpeedup = 1;
+    if (!settings.get<Emulator::SettingCDFastTimings>()) return;
+    auto &exclusions = settings.get<Emulator::SettingCDFastTimingsExclusions>().value;
+    if (!m_cdromId.empty() && (std::find(exclusions.begin(), exclusions.end(), m_cdromId) != exclusions.end())) {
+        return;
+    }
+    auto factor = [](int value) { return uint32_t(std::clamp(value, 1, 64)); };
+    m_seekSpeedup = factor(settings.get<Emulator::SettingCDFastSeekFactor>());
+    m_readSpeedup = factor(settings.get<Emulator::SettingCDFastReadFactor>());
+    m_spinSpeedup = factor(settings.get<Emulator::SettingCDFastSpinFactor>());
+    if ((m_seekSpeedup != 1) || (m_readSpeedup != 1) || (m_spinSpeedup != 1)) {
+        g_system->printf(_("CD-ROM fast timings: seek x%u, read x%u, spin x%u\n"), m_seekSpeedup, m_readSpeedup,
+                         m_spinSpeedup);
+    }
 }
@@ -63,6 +63,10 @@ class CDRom {
         m_iso.reset(iso);
         g_system->m_eventBus->signal(Events::IsoMounted{});
     }
+    void setIso(std::shared_ptr<CDRIso> iso) {
+        m_iso = iso;
+        g_system->m_eventBus->signal(Events::IsoMounted{});
+    }
 
     const std::string& getCDRomID() { return m_cdromId; }
     const std::string& getCDRomLabel() { return m_cdromLabel; }
@@ -91,8 +95,17 @@ class CDRom {
 
     std::shared_ptr<CDRIso> getIso() const { return m_iso; }
 
+    // Running totals of what got read off the image, for monitoring.
+    struct ReadStats {
+        uint64_t dataSectors = 0;
+        uint64_t audioSectors = 0;
+        uint64_t failures = 0;
+    };
+    const ReadStats& getReadStats() const { return m_readStats; }
+
   protected:
     std::shared_ptr<CDRIso> m_iso;
+    ReadStats m_readStats;
     // savestate stuff starts here
     uint8_t m_reg1Mode;
     uint8_t m_reg2;
@@ -158,8 +171,17 @@ class CDRom {
         uint8_t absolute[3];
     } m_subq;
     bool m_trackChanged;
+    // Divisors of the seek, read and spin-up delays, latched when the emulation gets reset or the disc changes,
+    // and saved along with the rest, so that fast timings don't change behind the back of a savestate or a replay.
+    // A divided delay never goes below irqReschedule, and streaming reads ignore m_readSpeedup. Values of one or
+    // less, such as the zero a savestate from before these existed loads, leave the delays as they are.
+    uint32_t m_seekSpeedup = 1;
+    uint32_t m_readSpeedup = 1;
+    uint32_t m_spinSpeedup = 1;
     // end savestate
-    friend SaveStates::SaveState SaveStates::constructSaveState();
+    friend SaveStates::SaveState SaveStates::constructSaveState(bool);
+
+    void latchSpeedups();
 
   private:
     friend class Widgets::IsoBrowser;
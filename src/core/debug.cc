@@ -19,6 +19,9 @@
 
 #include "core/debug.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
@@ -28,6 +31,7 @@
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "mips/common/util/decoder.hh"
 #include "supportpsx/memory.h"
 
 enum {
@@ -43,7 +47,7 @@ enum {
 
 PCSX::Debug::Debug() : m_listener(g_system->m_eventBus) {
     m_listener.listen<PCSX::Events::ExecutionFlow::Reset>([this](auto&) {
-        m_checkKernel = false;
+        setCheckKernel(false);
         clearMaps();
     });
 }
@@ -114,6 +118,11 @@ bool PCSX::Debug::isMapMarked(uint32_t address, int mask) {
 
 void PCSX::Debug::process(uint32_t oldPC, uint32_t newPC, uint32_t oldCode, uint32_t newCode, bool linked) {
     const auto& regs = g_emulator->m_cpu->m_regs;
+    // Nothing to map, check, break on or step through: don't bother decoding the instruction.
+    if (!m_features && m_breakpoints.empty() && (m_step == STEP_NONE) && !m_scheduledCop0.has_value() &&
+        ((regs.CP0.n.DCIC & 0xc0800000) != 0xc0800000)) {
+        return;
+    }
     const uint32_t basic = newCode >> 26;
     const bool isAnyLoadOrStore = (basic >= 0x20) && (basic < 0x3b);
     const bool isJAL = basic == 3;
@@ -148,10 +157,10 @@ void PCSX::Debug::process(uint32_t oldPC, uint32_t newPC, uint32_t oldCode, uint
     const uint32_t targetBase = normalizeAddress(target) & ~0xe0000000;
 
     checkBP(newPC, BreakpointType::Exec, 4);
-    if (m_breakmp_e && !isMapMarked(newPC, MAP_EXEC)) {
+    if (hasFeature(FEATURE_BREAK_EXEC) && !isMapMarked(newPC, MAP_EXEC)) {
         triggerBP(nullptr, newPC, 4, _("Execution map"));
     }
-    if (m_mapping_e) {
+    if (hasFeature(FEATURE_MAP_EXEC)) {
         markMap(newPC, MAP_EXEC);
         if (isJAL) markMap(target, MAP_EXEC_JAL);
         if (isJALR) markMap(regs.GPR.r[rd], MAP_EXEC_JAL);
@@ -163,7 +172,7 @@ void PCSX::Debug::process(uint32_t oldPC, uint32_t newPC, uint32_t oldCode, uint
     // - is not going to the break or exception handler
     if ((isJR || isJALR) && !wasInKernel && isTargetInKernel && !isJRToRA && (targetBase != 0x40) &&
         (targetBase != 0x80) && (targetBase != 0xa0) && (targetBase != 0xb0) && (targetBase != 0xc0)) {
-        if (m_checkKernel) {
+        if (checkKernel()) {
             g_system->printf(_("Kernel checker: Jump from 0x%08x to 0x%08x\n"), oldPC, targetBase);
             g_system->pause();
         }
@@ -173,49 +182,49 @@ void PCSX::Debug::process(uint32_t oldPC, uint32_t newPC, uint32_t oldCode, uint
         if (isLWL || isLWR || isSWR || isSWL) offset &= ~3;
         if (isLB || isLBU) {
             checkBP(offset, BreakpointType::Read, 1);
-            if (m_breakmp_r8 && !isMapMarked(offset, MAP_R8)) {
+            if (hasFeature(FEATURE_BREAK_R8) && !isMapMarked(offset, MAP_R8)) {
                 triggerBP(nullptr, offset, 1, _("Read 8 map"));
             }
-            if (m_mapping_r8) markMap(offset, MAP_R8);
+            if (hasFeature(FEATURE_MAP_R8)) markMap(offset, MAP_R8);
         }
         if (isLH || isLHU) {
             checkBP(offset, BreakpointType::Read, 2);
-            if (m_breakmp_r16 && !isMapMarked(offset, MAP_R16)) {
+            if (hasFeature(FEATURE_BREAK_R16) && !isMapMarked(offset, MAP_R16)) {
                 triggerBP(nullptr, offset, 2, _("Read 16 map"));
             }
-            if (m_mapping_r16) markMap(offset, MAP_R16);
+            if (hasFeature(FEATURE_MAP_R16)) markMap(offset, MAP_R16);
         }
         if (isLW || isLWR || isLWL || isLWC2) {
             checkBP(offset, BreakpointType::Read, 4);
-            if (m_breakmp_r32 && !isMapMarked(offset, MAP_R32)) {
+            if (hasFeature(FEATURE_BREAK_R32) && !isMapMarked(offset, MAP_R32)) {
                 triggerBP(nullptr, offset, 4, _("Read 32 map"));
             }
-            if (m_mapping_r32) markMap(offset, MAP_R32);
+            if (hasFeature(FEATURE_MAP_R32)) markMap(offset, MAP_R32);
         }
         if (isSB) {
             checkBP(offset, BreakpointType::Write, 1);
-            if (m_breakmp_w8 && !isMapMarked(offset, MAP_W8)) {
+            if (hasFeature(FEATURE_BREAK_W8) && !isMapMarked(offset, MAP_W8)) {
                 triggerBP(nullptr, offset, 1, _("Write 8 map"));
             }
-            if (m_mapping_w8) markMap(offset, MAP_W8);
+            if (hasFeature(FEATURE_MAP_W8)) markMap(offset, MAP_W8);
         }
         if (isSH) {
             checkBP(offset, BreakpointType::Write, 2);
-            if (m_breakmp_w16 && !isMapMarked(offset, MAP_W16)) {
+            if (hasFeature(FEATURE_BREAK_W16) && !isMapMarked(offset, MAP_W16)) {
                 triggerBP(nullptr, offset, 2, _("Write 16 map"));
             }
-            if (m_mapping_w16) markMap(offset, MAP_W16);
+            if (hasFeature(FEATURE_MAP_W16)) markMap(offset, MAP_W16);
         }
         if (isSW || isSWR || isSWL || isSWC2) {
             checkBP(offset, BreakpointType::Write, 4);
-            if (m_breakmp_w32 && !isMapMarked(offset, MAP_W32)) {
+            if (hasFeature(FEATURE_BREAK_W32) && !isMapMarked(offset, MAP_W32)) {
                 triggerBP(nullptr, offset, 4, _("Write 32 map"));
             }
-            if (m_mapping_w32) markMap(offset, MAP_W32);
+            if (hasFeature(FEATURE_MAP_W32)) markMap(offset, MAP_W32);
         }
         // Are we accessing a kernel address from a non-kernel address, while not in IRQ?
         if (!g_emulator->m_cpu->m_inISR && offsetIsInKernel && !wasInKernel) {
-            if (m_checkKernel) {
+            if (checkKernel()) {
                 if (isLoad) {
                     g_system->printf(_("Kernel checker: Reading %08x from %08x\n"), offset, oldPC);
                     g_system->pause();
@@ -267,6 +276,31 @@ void PCSX::Debug::process(uint32_t oldPC, uint32_t newPC, uint32_t oldCode, uint
     }
 }
 
+void PCSX::Debug::markBreakpointPages(uint32_t low, uint32_t high) {
+    low &= ~0xe0000000;
+    high &= ~0xe0000000;
+    if (high < low) high = 0x1fffffff;
+    for (uint32_t page = low >> c_breakpointPageShift; page <= (high >> c_breakpointPageShift); page++) {
+        m_breakpointPages[page / 8] |= 1 << (page % 8);
+    }
+}
+
+bool PCSX::Debug::hasBreakpointPages(uint32_t low, uint32_t high) const {
+    low &= ~0xe0000000;
+    high &= ~0xe0000000;
+    // Wrapping around the end of the address space; rare enough to just do the lookup.
+    if (high < low) return true;
+    for (uint32_t page = low >> c_breakpointPageShift; page <= (high >> c_breakpointPageShift); page++) {
+        if (m_breakpointPages[page / 8] & (1 << (page % 8))) return true;
+    }
+    return false;
+}
+
+void PCSX::Debug::rebuildBreakpointPages() {
+    memset(m_breakpointPages, 0, sizeof(m_breakpointPages));
+    for (auto& bp : m_breakpoints) markBreakpointPages(bp.getLow(), bp.getHigh());
+}
+
 void PCSX::Debug::startStepping() {
     if (PCSX::g_system->running()) return;
     m_wasInISR = g_emulator->m_cpu->m_inISR;
@@ -316,8 +350,16 @@ void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width,
         }
     }
 
-    auto end = m_breakpoints.end();
+    // Data accesses to RAM are caught by the page protection when it's armed.
+    if (m_watchpointsArmed && (type != BreakpointType::Exec) && ((address & ~0xe0000000) < 0x00800000)) return;
+    runBreakpoints(address, type, width, cause);
+}
+
+void PCSX::Debug::runBreakpoints(uint32_t address, BreakpointType type, uint32_t width, const char* cause) {
+    if (m_breakpoints.empty()) return;
     uint32_t normalizedAddress = normalizeAddress(address & ~0xe0000000);
+    if (!hasBreakpointPages(normalizedAddress, normalizedAddress + width - 1)) return;
+    auto end = m_breakpoints.end();
 
     BreakpointTemporaryListType torun;
     for (auto it = m_breakpoints.find(normalizedAddress, normalizedAddress + width - 1); it != end; it++) {
@@ -334,6 +376,33 @@ void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width,
     }
 }
 
+void PCSX::Debug::updateWatchpoints() {
+    const bool wanted = g_emulator->settings.get<Emulator::SettingDebugSettings>()
+                            .get<Emulator::DebugSettings::PageWatchpoints>();
+    m_watchpointsArmed = wanted && m_watchpoints.isEnabled();
+    m_watchpoints.clear();
+    if (m_watchpointsArmed) {
+        const uint32_t ramMask = g_emulator->settings.get<Emulator::Setting8MB>() ? 0x007fffff : 0x001fffff;
+        for (auto& bp : m_breakpoints) {
+            if (bp.type() == BreakpointType::Exec) continue;
+            const uint32_t address = bp.address();
+            if (address >= 0x00800000) continue;
+            m_watchpoints.watch(address & ramMask, bp.width(), bp.type() == BreakpointType::Read);
+        }
+    }
+    m_watchpoints.apply();
+    g_system->m_eventBus->signal(Events::Memory::WatchpointsChanged{});
+}
+
+void PCSX::Debug::processWatchpointHits() {
+    m_watchpoints.drainHits([this](const Watchpoints::Hit& hit) {
+        // The faulting host address only tells us where the access started, so look at the whole word.
+        const uint32_t address = hit.offset & ~3;
+        const auto type = hit.write ? BreakpointType::Write : BreakpointType::Read;
+        runBreakpoints(address, type, 4, hit.write ? _("Write watchpoint") : _("Read watchpoint"));
+    });
+}
+
 std::string PCSX::Debug::generateFlowIDC() {
     std::stringstream ss;
     ss << "#include <idc.idc>\r\n\r\n";
@@ -365,6 +434,41 @@ std::string PCSX::Debug::Breakpoint::name() const {
                        m_source);
 }
 
+bool PCSX::Debug::Breakpoint::conditionMet(uint32_t address, unsigned width) {
+    auto& regs = g_emulator->m_cpu->m_regs;
+    if ((regs.pc < m_pcLow) || (regs.pc > m_pcHigh)) return false;
+    if (m_condition == BreakpointCondition::Always) return true;
+
+    // Breakpoints trigger before the instruction runs, so a write's value has to come from the instruction itself.
+    uint32_t value = 0;
+    if (m_type == BreakpointType::Write) {
+        Mips::Decoder::Instruction instr(regs.code);
+        if (instr.isStore()) value = instr.getValueToStore(regs.GPR, regs.CP2D.r);
+    } else if (m_type == BreakpointType::Read) {
+        auto ptr = reinterpret_cast<const uint8_t*>(g_emulator->m_mem->pointerRead(address));
+        if (ptr) memcpy(&value, ptr, std::min(width, 4u));
+    }
+    value &= m_conditionMask;
+
+    switch (m_condition) {
+        case BreakpointCondition::Always:
+            return true;
+        case BreakpointCondition::Change:
+            if (value == m_conditionData) return false;
+            m_conditionData = value;
+            return true;
+        case BreakpointCondition::Greater:
+            return value > m_conditionData;
+        case BreakpointCondition::Less:
+            return value < m_conditionData;
+        case BreakpointCondition::Equal:
+            return value == m_conditionData;
+        case BreakpointCondition::Range:
+            return (value >= m_conditionData) && (value <= m_conditionHigh);
+    }
+    return true;
+}
+
 void PCSX::Debug::stepOut() {
     m_step = STEP_OUT;
     startStepping();
@@ -24,6 +24,7 @@
 
 #include "core/psxemulator.h"
 #include "core/system.h"
+#include "core/watchpoints.h"
 #include "fmt/format.h"
 #include "support/list.h"
 #include "support/tree.h"
@@ -37,7 +38,7 @@ class Debug {
     static bool isInKernel(uint32_t address, bool biosIsKernel = true);
     static inline std::function<const char*()> s_breakpoint_type_names[] = {l_("Exec"), l_("Read"), l_("Write")};
     enum class BreakpointType { Exec, Read, Write };
-    enum class BreakpointCondition { Always, Change, Greater, Less, Equal };
+    enum class BreakpointCondition { Always, Change, Greater, Less, Equal, Range };
 
     void checkDMAread(unsigned c, uint32_t address, uint32_t len) {
         std::string cause = fmt::format("DMA channel {} read", c);
@@ -50,6 +51,7 @@ class Debug {
 
   private:
     void checkBP(uint32_t address, BreakpointType type, uint32_t width, const char* cause = "");
+    void runBreakpoints(uint32_t address, BreakpointType type, uint32_t width, const char* cause);
 
   public:
     // call this if PC is being set, like when the emulation is being reset, or when doing fastboot
@@ -82,6 +84,22 @@ class Debug {
         void setCondition(BreakpointCondition condition) { m_condition = condition; }
         uint32_t conditionData() const { return m_conditionData; }
         void setConditionData(uint32_t data) { m_conditionData = data; }
+        // The upper bound, inclusive, of the Range condition, whose lower bound is the condition data.
+        uint32_t conditionHigh() const { return m_conditionHigh; }
+        void setConditionHigh(uint32_t high) { m_conditionHigh = high; }
+        // Applied to the accessed value before it gets compared.
+        uint32_t conditionMask() const { return m_conditionMask; }
+        void setConditionMask(uint32_t mask) { m_conditionMask = mask; }
+        // Only the accesses done by an instruction within these, inclusive, meet the condition.
+        void setPCFilter(uint32_t low, uint32_t high) {
+            m_pcLow = low;
+            m_pcHigh = high;
+        }
+        uint32_t pcLow() const { return m_pcLow; }
+        uint32_t pcHigh() const { return m_pcHigh; }
+        // Evaluates the condition against the access being done, without having to go through the invoker.
+        // This updates the condition data for the Change condition.
+        bool conditionMet(uint32_t address, unsigned width);
         unsigned width() const { return getHigh() - getLow() + 1; }
         uint32_t address() const { return getLow(); }
         bool enabled() const { return m_enabled; }
@@ -101,6 +119,10 @@ class Debug {
         const BreakpointType m_type;
         BreakpointCondition m_condition = BreakpointCondition::Always;
         uint32_t m_conditionData = 0;
+        uint32_t m_conditionHigh = 0;
+        uint32_t m_conditionMask = 0xffffffff;
+        uint32_t m_pcLow = 0;
+        uint32_t m_pcHigh = 0xffffffff;
         const std::string m_source;
         const BreakpointInvoker m_invoker;
         mutable std::string m_label;
@@ -120,13 +142,35 @@ class Debug {
     }
     void stepOut();
 
-    bool m_mapping_e = false;
-    bool m_mapping_r8 = false, m_mapping_r16 = false, m_mapping_r32 = false;
-    bool m_mapping_w8 = false, m_mapping_w16 = false, m_mapping_w32 = false;
-    bool m_breakmp_e = false;
-    bool m_breakmp_r8 = false, m_breakmp_r16 = false, m_breakmp_r32 = false;
-    bool m_breakmp_w8 = false, m_breakmp_w16 = false, m_breakmp_w32 = false;
-    bool m_checkKernel = false;
+    // All of the mapping and checking toggles, packed together so the per-instruction
+    // hook can tell with a single test whether any of them is on.
+    enum Feature : uint32_t {
+        FEATURE_MAP_EXEC = 1 << 0,
+        FEATURE_MAP_R8 = 1 << 1,
+        FEATURE_MAP_R16 = 1 << 2,
+        FEATURE_MAP_R32 = 1 << 3,
+        FEATURE_MAP_W8 = 1 << 4,
+        FEATURE_MAP_W16 = 1 << 5,
+        FEATURE_MAP_W32 = 1 << 6,
+        FEATURE_BREAK_EXEC = 1 << 7,
+        FEATURE_BREAK_R8 = 1 << 8,
+        FEATURE_BREAK_R16 = 1 << 9,
+        FEATURE_BREAK_R32 = 1 << 10,
+        FEATURE_BREAK_W8 = 1 << 11,
+        FEATURE_BREAK_W16 = 1 << 12,
+        FEATURE_BREAK_W32 = 1 << 13,
+        FEATURE_CHECK_KERNEL = 1 << 14,
+    };
+    uint32_t m_features = 0;
+    bool hasFeature(uint32_t feature) const { return m_features & feature; }
+    bool checkKernel() const { return hasFeature(FEATURE_CHECK_KERNEL); }
+    void setCheckKernel(bool enabled) {
+        if (enabled) {
+            m_features |= FEATURE_CHECK_KERNEL;
+        } else {
+            m_features &= ~FEATURE_CHECK_KERNEL;
+        }
+    }
 
     void clearMaps() {
         memset(m_mainMemoryMap, 0, sizeof(m_mainMemoryMap));
@@ -146,7 +190,10 @@ class Debug {
         }) {
         uint32_t base = address & 0xe0000000;
         address &= ~0xe0000000;
-        return &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base));
+        markBreakpointPages(address, address + width - 1);
+        auto bp = &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base));
+        if (type != BreakpointType::Exec) updateWatchpoints();
+        return bp;
     }
     inline Breakpoint* addBreakpoint(
         uint32_t address, BreakpointType type, unsigned width, const std::string& source, std::string label,
@@ -156,23 +203,56 @@ class Debug {
         }) {
         uint32_t base = address & 0xe0000000;
         address &= ~0xe0000000;
-        return &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base, label));
+        markBreakpointPages(address, address + width - 1);
+        auto bp =
+            &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base, label));
+        if (type != BreakpointType::Exec) updateWatchpoints();
+        return bp;
     }
     const BreakpointTreeType& getTree() { return m_breakpoints; }
     const Breakpoint* lastBP() { return m_lastBP; }
     void removeBreakpoint(const Breakpoint* bp) {
         if (m_lastBP == bp) m_lastBP = nullptr;
+        const bool watched = bp->type() != BreakpointType::Exec;
         delete const_cast<Breakpoint*>(bp);
+        rebuildBreakpointPages();
+        if (watched) updateWatchpoints();
     }
     void removeAllBreakpoints() {
         m_breakpoints.clear();
         m_lastBP = nullptr;
+        memset(m_breakpointPages, 0, sizeof(m_breakpointPages));
+        updateWatchpoints();
     }
 
+    // Page protection based read and write breakpoints on RAM, when enabled in the settings.
+    // See core/watchpoints.h for how these work.
+    void initWatchpoints() { m_watchpoints.init(); }
+    void updateWatchpoints();
+    bool watchpointsArmed() const { return m_watchpointsArmed; }
+    bool isWatchingReads(uint32_t offset, uint32_t size) const {
+        return m_watchpointsArmed && m_watchpoints.isWatched(offset, size, true);
+    }
+    bool hasWatchpointHits() const { return m_watchpoints.hasHits(); }
+    void processWatchpointHits();
+
   private:
     bool triggerBP(Breakpoint* bp, uint32_t address, unsigned width, const char* reason = "");
     BreakpointTreeType m_breakpoints;
 
+    // One bit per 4KB page of the normalized address space, set for every page a breakpoint
+    // covers, so that checkBP only walks the tree for accesses landing near a breakpoint.
+    // Bits may linger after a breakpoint is deleted, which only costs a useless lookup.
+    static constexpr unsigned c_breakpointPageShift = 12;
+    static constexpr uint32_t c_breakpointPageCount = 0x20000000 >> c_breakpointPageShift;
+    uint8_t m_breakpointPages[c_breakpointPageCount / 8] = {0};
+    void markBreakpointPages(uint32_t low, uint32_t high);
+    bool hasBreakpointPages(uint32_t low, uint32_t high) const;
+    void rebuildBreakpointPages();
+
+    Watchpoints m_watchpoints;
+    bool m_watchpointsArmed = false;
+
     uint8_t m_mainMemoryMap[0x00800000] = {0};
     uint8_t m_biosMemoryMap[0x00080000] = {0};
     uint8_t m_scratchPadMap[0x00000400] = {0};
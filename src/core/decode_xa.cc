@@ -23,14 +23,23 @@
 
 #include "core/decode_xa.h"
 
-// #define FIXED
+#include <string.h>
 
-#define NOT(_X_) (!(_X_))
-#define XACLAMP(_X_, _MI_, _MA_)    \
-    {                               \
-        if (_X_ < _MI_) _X_ = _MI_; \
-        if (_X_ > _MA_) _X_ = _MA_; \
-    }
+#include <algorithm>
+
+#include "supportpsx/adpcm.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define XA_DECODE_SSE41
+#define XA_DECODE_TARGET_SSE41
+#else
+#define XA_DECODE_SSE41
+#define XA_DECODE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#endif
+#endif
 
 #define SH 4
 #define SHC 10
@@ -39,16 +48,6 @@
 //===  ADPCM DECODING ROUTINES
 //============================================
 
-#ifndef FIXED
-static const double s_K0[4] = {0.0, 0.9375, 1.796875, 1.53125};
-
-static const double s_K1[4] = {0.0, 0.0, -0.8125, -0.859375};
-#else
-static const int s_K0[4] = {0.0 * (1 << SHC), 0.9375 * (1 << SHC), 1.796875 * (1 << SHC), 1.53125 * (1 << SHC)};
-
-static const int s_K1[4] = {0.0 * (1 << SHC), 0.0 * (1 << SHC), -0.8125 * (1 << SHC), -0.859375 * (1 << SHC)};
-#endif
-
 #define BLKSIZ 28 /* block size (32 - 4 nibbles) */
 
 //===========================================
@@ -58,193 +57,219 @@ static void ADPCM_InitDecode(ADPCM_Decode_t *decp) {
 }
 
 //===========================================
-#ifndef FIXED
-#define IK0(fid) ((int)((-s_K0[fid]) * (1 << SHC)))
-#define IK1(fid) ((int)((-s_K1[fid]) * (1 << SHC)))
-#else
-#define IK0(fid) (-s_K0[fid])
-#define IK1(fid) (-s_K1[fid])
-#endif
+// The XA decoder only has 4 filters, so the top bits of the filter nibble are ignored.
+static inline const std::array<int32_t, 2> &xa_filter(uint8_t filter_range) {
+    return PCSX::ADPCM::c_fixedFilters[(filter_range >> 4) & 3];
+}
 
-static inline void ADPCM_DecodeBlock16(ADPCM_Decode_t *decp, uint8_t filter_range, const void *vblockp, short *destp,
-                                       int inc) {
-    int range, filterid;
-    int32_t fy0, fy1;
-    const uint16_t *blockp;
+// Corrupted streams can overflow the prediction, which then wraps around, same as the vectorised code does.
+static inline int32_t xa_predict(const std::array<int32_t, 2> &filter, int32_t fy0, int32_t fy1) {
+    const uint32_t prediction = uint32_t(filter[0]) * uint32_t(fy0) + uint32_t(filter[1]) * uint32_t(fy1);
+    return int32_t(prediction) >> SHC;
+}
 
-    blockp = (const unsigned short *)vblockp;
-    filterid = (filter_range >> 4) & 0x0f;
-    range = (filter_range >> 0) & 0x0f;
+static inline void ADPCM_DecodeBlock16(ADPCM_Decode_t *decp, uint8_t filter_range, const uint16_t *blockp,
+                                       short *destp, int inc) {
+    const auto &filter = xa_filter(filter_range);
+    const int range = filter_range & 0x0f;
 
-    fy0 = decp->y0;
-    fy1 = decp->y1;
+    int32_t fy0 = decp->y0;
+    int32_t fy1 = decp->y1;
 
     for (int i = BLKSIZ / 4; i; --i) {
-        int32_t y;
-        int32_t x0, x1, x2, x3;
-
-        y = *blockp++;
-        x3 = (short)(y & 0xf000) >> range;
-        x3 <<= SH;
-        x2 = (short)((y << 4) & 0xf000) >> range;
-        x2 <<= SH;
-        x1 = (short)((y << 8) & 0xf000) >> range;
-        x1 <<= SH;
-        x0 = (short)((y << 12) & 0xf000) >> range;
-        x0 <<= SH;
-
-        x0 -= (IK0(filterid) * fy0 + (IK1(filterid) * fy1)) >> SHC;
-        fy1 = fy0;
-        fy0 = x0;
-        x1 -= (IK0(filterid) * fy0 + (IK1(filterid) * fy1)) >> SHC;
-        fy1 = fy0;
-        fy0 = x1;
-        x2 -= (IK0(filterid) * fy0 + (IK1(filterid) * fy1)) >> SHC;
-        fy1 = fy0;
-        fy0 = x2;
-        x3 -= (IK0(filterid) * fy0 + (IK1(filterid) * fy1)) >> SHC;
+        int32_t y = *blockp++;
+        int32_t x[4];
+        x[3] = (short)(y & 0xf000) >> range;
+        x[2] = (short)((y << 4) & 0xf000) >> range;
+        x[1] = (short)((y << 8) & 0xf000) >> range;
+        x[0] = (short)((y << 12) & 0xf000) >> range;
+
+        for (int j = 0; j < 4; j++) {
+            int32_t sample = x[j] << SH;
+            sample -= xa_predict(filter, fy0, fy1);
+            fy1 = fy0;
+            fy0 = sample;
+            sample = std::clamp(sample, -32768 << SH, 32767 << SH);
+            *destp = sample >> SH;
+            destp += inc;
+        }
+    }
+    decp->y0 = fy0;
+    decp->y1 = fy1;
+}
+
+#if defined(XA_DECODE_SSE41)
+
+// Expands the 28 nibbles of a block, as (short)(nibble << 12) >> range, in playing order. The block
+// needs 8 words, the last one being ignored, and the output 32 samples, the last 4 being garbage.
+XA_DECODE_TARGET_SSE41 static inline void ADPCM_ExpandBlockSIMD(uint8_t filter_range, const uint16_t *blockp,
+                                                                int16_t *samples) {
+    const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(blockp));
+    const __m128i mask = _mm_set1_epi16(int16_t(0xf000));
+    const __m128i range = _mm_cvtsi32_si128(filter_range & 0x0f);
+    const __m128i n0 = _mm_sra_epi16(_mm_slli_epi16(words, 12), range);
+    const __m128i n1 = _mm_sra_epi16(_mm_and_si128(_mm_slli_epi16(words, 8), mask), range);
+    const __m128i n2 = _mm_sra_epi16(_mm_and_si128(_mm_slli_epi16(words, 4), mask), range);
+    const __m128i n3 = _mm_sra_epi16(_mm_and_si128(words, mask), range);
+    // Putting the 4 nibbles of each word next to each other.
+    const __m128i lo01 = _mm_unpacklo_epi16(n0, n1);
+    const __m128i hi01 = _mm_unpackhi_epi16(n0, n1);
+    const __m128i lo23 = _mm_unpacklo_epi16(n2, n3);
+    const __m128i hi23 = _mm_unpackhi_epi16(n2, n3);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(samples + 0), _mm_unpacklo_epi32(lo01, lo23));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(samples + 8), _mm_unpackhi_epi32(lo01, lo23));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(samples + 16), _mm_unpacklo_epi32(hi01, hi23));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(samples + 24), _mm_unpackhi_epi32(hi01, hi23));
+}
+
+// Each sample of a channel depends on the two previous ones, so the only thing left to vectorise
+// for mono streams is the nibble expansion.
+XA_DECODE_TARGET_SSE41 static void ADPCM_DecodeBlock16SIMD(ADPCM_Decode_t *decp, uint8_t filter_range,
+                                                           const uint16_t *blockp, short *destp) {
+    alignas(16) int16_t samples[32];
+    ADPCM_ExpandBlockSIMD(filter_range, blockp, samples);
+    const auto &filter = xa_filter(filter_range);
+
+    int32_t fy0 = decp->y0;
+    int32_t fy1 = decp->y1;
+    for (int i = 0; i < BLKSIZ; i++) {
+        int32_t sample = int32_t(samples[i]) << SH;
+        sample -= xa_predict(filter, fy0, fy1);
         fy1 = fy0;
-        fy0 = x3;
-
-        XACLAMP(x0, -32768 << SH, 32767 << SH);
-        *destp = x0 >> SH;
-        destp += inc;
-        XACLAMP(x1, -32768 << SH, 32767 << SH);
-        *destp = x1 >> SH;
-        destp += inc;
-        XACLAMP(x2, -32768 << SH, 32767 << SH);
-        *destp = x2 >> SH;
-        destp += inc;
-        XACLAMP(x3, -32768 << SH, 32767 << SH);
-        *destp = x3 >> SH;
-        destp += inc;
+        fy0 = sample;
+        sample = std::clamp(sample, -32768 << SH, 32767 << SH);
+        destp[i] = sample >> SH;
     }
     decp->y0 = fy0;
     decp->y1 = fy1;
 }
 
+// Stereo streams have their two channels decoded side by side, one per lane. The output is interleaved.
+XA_DECODE_TARGET_SSE41 static void ADPCM_DecodeStereoBlock16SIMD(ADPCM_Decode_t *left, ADPCM_Decode_t *right,
+                                                                 uint8_t filter_range_left,
+                                                                 uint8_t filter_range_right,
+                                                                 const uint16_t *blockp_left,
+                                                                 const uint16_t *blockp_right, short *destp) {
+    alignas(16) int16_t samples_left[32];
+    alignas(16) int16_t samples_right[32];
+    ADPCM_ExpandBlockSIMD(filter_range_left, blockp_left, samples_left);
+    ADPCM_ExpandBlockSIMD(filter_range_right, blockp_right, samples_right);
+
+    // Pairs of left and right samples, so that each step loads both lanes at once.
+    alignas(16) int16_t pairs[64];
+    for (int i = 0; i < 32; i += 8) {
+        const __m128i l = _mm_load_si128(reinterpret_cast<const __m128i *>(samples_left + i));
+        const __m128i r = _mm_load_si128(reinterpret_cast<const __m128i *>(samples_right + i));
+        _mm_store_si128(reinterpret_cast<__m128i *>(pairs + i * 2), _mm_unpacklo_epi16(l, r));
+        _mm_store_si128(reinterpret_cast<__m128i *>(pairs + i * 2 + 8), _mm_unpackhi_epi16(l, r));
+    }
+
+    const auto &filter_left = xa_filter(filter_range_left);
+    const auto &filter_right = xa_filter(filter_range_right);
+    const __m128i k0 = _mm_setr_epi32(filter_left[0], filter_right[0], 0, 0);
+    const __m128i k1 = _mm_setr_epi32(filter_left[1], filter_right[1], 0, 0);
+    __m128i fy0 = _mm_setr_epi32(left->y0, right->y0, 0, 0);
+    __m128i fy1 = _mm_setr_epi32(left->y1, right->y1, 0, 0);
+
+    for (int i = 0; i < BLKSIZ; i++) {
+        int32_t pair;
+        memcpy(&pair, pairs + i * 2, sizeof(pair));
+        const __m128i x = _mm_slli_epi32(_mm_cvtepi16_epi32(_mm_cvtsi32_si128(pair)), SH);
+        const __m128i prediction = _mm_add_epi32(_mm_mullo_epi32(k0, fy0), _mm_mullo_epi32(k1, fy1));
+        const __m128i sample = _mm_sub_epi32(x, _mm_srai_epi32(prediction, SHC));
+        fy1 = fy0;
+        fy0 = sample;
+        // Saturating after the shift is the same as clamping before it.
+        const __m128i sample16 = _mm_packs_epi32(_mm_srai_epi32(sample, SH), sample);
+        pair = _mm_cvtsi128_si32(sample16);
+        memcpy(destp + i * 2, &pair, sizeof(pair));
+    }
+
+    left->y0 = _mm_cvtsi128_si32(fy0);
+    right->y0 = _mm_extract_epi32(fy0, 1);
+    left->y1 = _mm_cvtsi128_si32(fy1);
+    right->y1 = _mm_extract_epi32(fy1, 1);
+}
+
+static bool xa_has_simd() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+#endif
+
 static const int s_headtable[4] = {0, 2, 8, 10};
 
 //===========================================
-static void xa_decode_data(xa_decode_t *xdp, unsigned char *srcp) {
-    const uint8_t *sound_groupsp;
-    const uint8_t *sound_datap, *sound_datap2;
-    int i, j, k, nbits;
-    uint16_t data[4096], *datap;
-    short *destp;
-
-    destp = xdp->pcm;
-    nbits = xdp->nbits == 4 ? 4 : 2;
-
-    if (xdp->stereo) {                                    // stereo
-        if ((xdp->nbits == 8) && (xdp->freq == 37800)) {  // level A
-            for (j = 0; j < 18; j++) {
-                sound_groupsp = srcp + j * 128;    // sound groups header
-                sound_datap = sound_groupsp + 16;  // sound data just after the header
-
-                for (i = 0; i < nbits; i++) {
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-
-                    for (k = 0; k < 14; k++, sound_datap2 += 8) {
-                        *(datap++) = (uint16_t)sound_datap2[0] | (uint16_t)(sound_datap2[4] << 8);
-                    }
-
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 0], data, destp + 0, 2);
-
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 14; k++, sound_datap2 += 8) {
-                        *(datap++) = (uint16_t)sound_datap2[0] | (uint16_t)(sound_datap2[4] << 8);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->right, sound_groupsp[s_headtable[i] + 1], data, destp + 1, 2);
-
-                    destp += 28 * 2;
-                }
-            }
-        } else {  // level B/C
-            for (j = 0; j < 18; j++) {
-                sound_groupsp = srcp + j * 128;    // sound groups header
-                sound_datap = sound_groupsp + 16;  // sound data just after the header
-
-                for (i = 0; i < nbits; i++) {
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-
-                    for (k = 0; k < 7; k++, sound_datap2 += 16) {
-                        *(datap++) = (uint16_t)(sound_datap2[0] & 0x0f) | ((uint16_t)(sound_datap2[4] & 0x0f) << 4) |
-                                     ((uint16_t)(sound_datap2[8] & 0x0f) << 8) |
-                                     ((uint16_t)(sound_datap2[12] & 0x0f) << 12);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 0], data, destp + 0, 2);
-
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 7; k++, sound_datap2 += 16) {
-                        *(datap++) = (uint16_t)(sound_datap2[0] >> 4) | ((uint16_t)(sound_datap2[4] >> 4) << 4) |
-                                     ((uint16_t)(sound_datap2[8] >> 4) << 8) |
-                                     ((uint16_t)(sound_datap2[12] >> 4) << 12);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->right, sound_groupsp[s_headtable[i] + 1], data, destp + 1, 2);
-
-                    destp += 28 * 2;
-                }
+// Level A units are 8 bits wide, gathered here as if they were 4 bits units. The 8th word
+// of the output is padding for the vectorised decoder.
+static void xa_gather_level_a(const uint8_t *sound_datap, uint16_t *data) {
+    for (int k = 0; k < BLKSIZ / 4; k++, sound_datap += 8) {
+        data[k] = (uint16_t)sound_datap[0] | (uint16_t)(sound_datap[4] << 8);
+    }
+    data[BLKSIZ / 4] = 0;
+}
+
+static void xa_gather_level_bc(const uint8_t *sound_datap, int shift, uint16_t *data) {
+    for (int k = 0; k < BLKSIZ / 4; k++, sound_datap += 16) {
+        data[k] = (uint16_t)((sound_datap[0] >> shift) & 0x0f) | ((uint16_t)((sound_datap[4] >> shift) & 0x0f) << 4) |
+                  ((uint16_t)((sound_datap[8] >> shift) & 0x0f) << 8) |
+                  ((uint16_t)((sound_datap[12] >> shift) & 0x0f) << 12);
+    }
+    data[BLKSIZ / 4] = 0;
+}
+
+//===========================================
+static void xa_decode_data(xa_decode_t *xdp, unsigned char *srcp, bool simd) {
+    short *destp = xdp->pcm;
+    const bool level_a = (xdp->nbits == 8) && (xdp->freq == 37800);
+    const int nbits = xdp->nbits == 4 ? 4 : 2;
+    uint16_t data0[BLKSIZ / 4 + 1], data1[BLKSIZ / 4 + 1];
+
+    for (int j = 0; j < 18; j++) {
+        const uint8_t *sound_groupsp = srcp + j * 128;    // sound groups header
+        const uint8_t *sound_datap = sound_groupsp + 16;  // sound data just after the header
+
+        for (int i = 0; i < nbits; i++) {
+            const uint8_t filter_range0 = sound_groupsp[s_headtable[i] + 0];
+            const uint8_t filter_range1 = sound_groupsp[s_headtable[i] + 1];
+            if (level_a) {
+                xa_gather_level_a(sound_datap + i, data0);
+                xa_gather_level_a(sound_datap + i, data1);
+            } else {
+                xa_gather_level_bc(sound_datap + i, 0, data0);
+                xa_gather_level_bc(sound_datap + i, 4, data1);
             }
-        }
-    } else {                                              // mono
-        if ((xdp->nbits == 8) && (xdp->freq == 37800)) {  // level A
-            for (j = 0; j < 18; j++) {
-                sound_groupsp = srcp + j * 128;    // sound groups header
-                sound_datap = sound_groupsp + 16;  // sound data just after the header
-
-                for (i = 0; i < nbits; i++) {
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 14; k++, sound_datap2 += 8) {
-                        *(datap++) = (uint16_t)sound_datap2[0] | (uint16_t)(sound_datap2[4] << 8);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 0], data, destp, 1);
-
-                    destp += 28;
-
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 14; k++, sound_datap2 += 8) {
-                        *(datap++) = (uint16_t)sound_datap2[0] | (uint16_t)(sound_datap2[4] << 8);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 1], data, destp, 1);
-
-                    destp += 28;
+
+            if (xdp->stereo) {
+#if defined(XA_DECODE_SSE41)
+                if (simd) {
+                    ADPCM_DecodeStereoBlock16SIMD(&xdp->left, &xdp->right, filter_range0, filter_range1, data0, data1,
+                                                  destp);
+                    destp += BLKSIZ * 2;
+                    continue;
                 }
-            }
-        } else {  // level B/C
-            for (j = 0; j < 18; j++) {
-                sound_groupsp = srcp + j * 128;    // sound groups header
-                sound_datap = sound_groupsp + 16;  // sound data just after the header
-
-                for (i = 0; i < nbits; i++) {
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 7; k++, sound_datap2 += 16) {
-                        *(datap++) = (uint16_t)(sound_datap2[0] & 0x0f) | ((uint16_t)(sound_datap2[4] & 0x0f) << 4) |
-                                     ((uint16_t)(sound_datap2[8] & 0x0f) << 8) |
-                                     ((uint16_t)(sound_datap2[12] & 0x0f) << 12);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 0], data, destp, 1);
-
-                    destp += 28;
-
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 7; k++, sound_datap2 += 16) {
-                        *(datap++) = (uint16_t)(sound_datap2[0] >> 4) | ((uint16_t)(sound_datap2[4] >> 4) << 4) |
-                                     ((uint16_t)(sound_datap2[8] >> 4) << 8) |
-                                     ((uint16_t)(sound_datap2[12] >> 4) << 12);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 1], data, destp, 1);
-
-                    destp += 28;
+#endif
+                ADPCM_DecodeBlock16(&xdp->left, filter_range0, data0, destp + 0, 2);
+                ADPCM_DecodeBlock16(&xdp->right, filter_range1, data1, destp + 1, 2);
+                destp += BLKSIZ * 2;
+            } else {
+#if defined(XA_DECODE_SSE41)
+                if (simd) {
+                    ADPCM_DecodeBlock16SIMD(&xdp->left, filter_range0, data0, destp);
+                    ADPCM_DecodeBlock16SIMD(&xdp->left, filter_range1, data1, destp + BLKSIZ);
+                    destp += BLKSIZ * 2;
+                    continue;
                 }
+#endif
+                ADPCM_DecodeBlock16(&xdp->left, filter_range0, data0, destp, 1);
+                ADPCM_DecodeBlock16(&xdp->left, filter_range1, data1, destp + BLKSIZ, 1);
+                destp += BLKSIZ * 2;
             }
         }
     }
@@ -285,7 +310,7 @@ typedef struct {
 
 //============================================
 static int parse_xa_audio_sector(xa_decode_t *xdp, xa_subheader_t *subheadp, unsigned char *sectorp,
-                                 int is_first_sector) {
+                                 int is_first_sector, bool simd) {
     if (is_first_sector) {
         int freq;
         int nbits;
@@ -337,7 +362,7 @@ static int parse_xa_audio_sector(xa_decode_t *xdp, xa_subheader_t *subheadp, uns
             if (xdp->stereo == 1) xdp->nsamples /= 2;
         }
     }
-    xa_decode_data(xdp, sectorp);
+    xa_decode_data(xdp, sectorp, simd);
 
     return 0;
 }
@@ -352,7 +377,21 @@ static int parse_xa_audio_sector(xa_decode_t *xdp, xa_subheader_t *subheadp, uns
 //=== return -1 if error
 //================================================================
 int32_t xa_decode_sector(xa_decode_t *xdp, unsigned char *sectorp, int is_first_sector) {
-    if (parse_xa_audio_sector(xdp, (xa_subheader_t *)sectorp, sectorp + sizeof(xa_subheader_t), is_first_sector))
+#if defined(XA_DECODE_SSE41)
+    static const bool simd = xa_has_simd();
+#else
+    static const bool simd = false;
+#endif
+    if (parse_xa_audio_sector(xdp, (xa_subheader_t *)sectorp, sectorp + sizeof(xa_subheader_t), is_first_sector,
+                              simd))
+        return -1;
+
+    return 0;
+}
+
+int32_t xa_decode_sector_scalar(xa_decode_t *xdp, unsigned char *sectorp, int is_first_sector) {
+    if (parse_xa_audio_sector(xdp, (xa_subheader_t *)sectorp, sectorp + sizeof(xa_subheader_t), is_first_sector,
+                              false))
         return -1;
 
     return 0;
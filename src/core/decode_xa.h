@@ -35,4 +35,7 @@ struct xa_decode_t {
 };
 
 int32_t xa_decode_sector(xa_decode_t *xdp, unsigned char *sectorp, int is_first_sector);
+// Same as above, without any vectorisation. This is the reference implementation, and
+// xa_decode_sector must return the exact same output.
+int32_t xa_decode_sector_scalar(xa_decode_t *xdp, unsigned char *sectorp, int is_first_sector);
 void xa_decode_reset(xa_decode_t *xdp);
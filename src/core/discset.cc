@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/discset.h"
+
+#include <time.h>
+
+#include <regex>
+
+#include "cdrom/cdriso.h"
+#include "core/cdrom.h"
+#include "core/psxemulator.h"
+#include "core/system.h"
+#include "fmt/format.h"
+#include "support/uvfile.h"
+
+PCSX::DiscSet::DiscSet() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::IsoMounted>([this](auto&) { mounted(); });
+    m_listener.listen<Events::GPU::VSync>([this](auto&) { preloadNext(); });
+}
+
+std::vector<std::filesystem::path> PCSX::DiscSet::findSiblings(const std::filesystem::path& image) {
+    static const std::regex pattern(R"(\(dis[ck] ?([0-9]+))", std::regex::icase);
+    // No PlayStation game shipped on more discs than this.
+    constexpr unsigned maxDiscs = 9;
+
+    std::vector<std::filesystem::path> ret;
+    const auto name = image.filename().string();
+    std::smatch match;
+    if (UvHttpFile::isUrl(image.string()) || !std::regex_search(name, match, pattern)) {
+        ret.push_back(image);
+        return ret;
+    }
+    const auto prefix = name.substr(0, match.position(1));
+    const auto suffix = name.substr(match.position(1) + match.length(1));
+    const unsigned self = std::stoul(match.str(1));
+    for (unsigned disc = 1; disc <= maxDiscs; disc++) {
+        if (disc == self) {
+            ret.push_back(image);
+            continue;
+        }
+        auto sibling = image.parent_path() / (prefix + std::to_string(disc) + suffix);
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(sibling, ec)) ret.push_back(sibling);
+    }
+    return ret;
+}
+
+std::string PCSX::DiscSet::label(unsigned index) const {
+    auto& disc = m_discs[index];
+    auto ret = disc.path.filename().string();
+    if (m_discs.front().path == m_discs.back().path) ret += fmt::format(" #{}", disc.multidiskSelect + 1);
+    return ret;
+}
+
+void PCSX::DiscSet::mounted() {
+    auto iso = g_emulator->m_cdrom->getIso();
+    for (unsigned i = 0; i < m_discs.size(); i++) {
+        if (m_discs[i].iso == iso) {
+            m_current = i;
+            return;
+        }
+    }
+
+    m_discs.clear();
+    m_current = 0;
+    if (!iso || iso->failed()) return;
+    const auto& path = iso->getIsoPath();
+    if (iso->m_cdrIsoMultidiskCount > 1) {
+        for (unsigned i = 0; i < iso->m_cdrIsoMultidiskCount; i++) {
+            m_discs.push_back({path, i, i == iso->m_cdrIsoMultidiskSelect ? iso : nullptr});
+        }
+        m_current = iso->m_cdrIsoMultidiskSelect;
+        return;
+    }
+    for (auto& sibling : findSiblings(path)) {
+        if (sibling == path) m_current = m_discs.size();
+        m_discs.push_back({sibling, 0, sibling == path ? iso : nullptr});
+    }
+    if (m_discs.size() == 1) m_discs.clear();
+}
+
+void PCSX::DiscSet::preloadNext() {
+    if (!g_emulator->settings.get<Emulator::SettingPreloadDiscSet>()) return;
+    // One per frame, so that opening a whole set doesn't stall the emulation.
+    for (auto& disc : m_discs) {
+        if (disc.iso) continue;
+        disc.iso = std::make_shared<CDRIso>(disc.path, disc.multidiskSelect);
+        return;
+    }
+}
+
+void PCSX::DiscSet::swap(unsigned index) {
+    if ((index >= m_discs.size()) || (index == m_current)) return;
+    auto& disc = m_discs[index];
+    if (!disc.iso) disc.iso = std::make_shared<CDRIso>(disc.path, disc.multidiskSelect);
+    auto& cdrom = g_emulator->m_cdrom;
+    cdrom->setIso(disc.iso);
+    cdrom->check();
+    cdrom->setLidOpenTime((int64_t)time(nullptr) + 2);
+    cdrom->lidInterrupt();
+}
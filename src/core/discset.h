@@ -0,0 +1,68 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+class CDRIso;
+
+// The discs of a multi-disc game: either all the images of a PBP, or sibling images named
+// like "Game (Disc 1).cue", "Game (Disc 2).cue"... Whenever an image gets mounted, the other
+// discs of its set get opened one per frame, so that their cue sheets, subchannel data and
+// compressed indexes are parsed, and, when disk images get preloaded, their contents cached,
+// long before the game asks for them. Swapping discs then only hands an already open image
+// to the drive.
+class DiscSet {
+  public:
+    DiscSet();
+
+    // Zero when the mounted image isn't part of a set.
+    unsigned count() const { return m_discs.size(); }
+    unsigned current() const { return m_current; }
+    std::string label(unsigned index) const;
+    bool loaded(unsigned index) const { return !!m_discs[index].iso; }
+    // Puts another disc of the set in the drive, opening and closing the lid around it.
+    void swap(unsigned index);
+
+    // Returns the images the given one goes with, in disc order, itself included.
+    static std::vector<std::filesystem::path> findSiblings(const std::filesystem::path& image);
+
+  private:
+    void mounted();
+    void preloadNext();
+
+    struct Disc {
+        std::filesystem::path path;
+        unsigned multidiskSelect = 0;
+        std::shared_ptr<CDRIso> iso;
+    };
+    std::vector<Disc> m_discs;
+    unsigned m_current = 0;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
@@ -19,44 +19,54 @@
 
 #include "core/eventslua.h"
 
+#include <chrono>
+#include <memory>
+
+#include "core/framestats.h"
 #include "core/logger.h"
+#include "core/luaprofiler.h"
 #include "core/system.h"
 #include "support/eventbus.h"
 
 namespace {
 
+// Accounts the time spent in each listener, so that the scripts slowing down the emulation can be found.
+struct CallbackStats {
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+    uint64_t maxNanoseconds = 0;
+    uint64_t overBudget = 0;
+    uint64_t budget = 1000000;
+};
+
+// The events are passed to the callbacks in a table preallocated for each listener, and reused for every
+// call, so that hooking frequent events doesn't create garbage. These fill it in, at the top of the stack.
 template <typename Event>
-void pushEvent(PCSX::Lua L, const Event& e) {
-    L.newtable();
-}
+void fillEvent(PCSX::Lua L, const Event& e) {}
 
 template <>
-void pushEvent(PCSX::Lua L, const PCSX::Events::ExecutionFlow::Pause& e) {
-    L.newtable();
+void fillEvent(PCSX::Lua L, const PCSX::Events::ExecutionFlow::Pause& e) {
     L.push("exception");
     L.push(e.exception);
     L.settable();
 }
 
 template <>
-void pushEvent(PCSX::Lua L, const PCSX::Events::ExecutionFlow::Reset& e) {
-    L.newtable();
+void fillEvent(PCSX::Lua L, const PCSX::Events::ExecutionFlow::Reset& e) {
     L.push("hard");
     L.push(e.hard);
     L.settable();
 }
 
 template <>
-void pushEvent(PCSX::Lua L, const PCSX::Events::GUI::JumpToPC& e) {
-    L.newtable();
+void fillEvent(PCSX::Lua L, const PCSX::Events::GUI::JumpToPC& e) {
     L.push("pc");
     L.push(lua_Number(e.pc));
     L.settable();
 }
 
 template <>
-void pushEvent(PCSX::Lua L, const PCSX::Events::GUI::JumpToMemory& e) {
-    L.newtable();
+void fillEvent(PCSX::Lua L, const PCSX::Events::GUI::JumpToMemory& e) {
     L.push("address");
     L.push(lua_Number(e.address));
     L.settable();
@@ -66,8 +76,7 @@ void pushEvent(PCSX::Lua L, const PCSX::Events::GUI::JumpToMemory& e) {
 }
 
 template <>
-void pushEvent(PCSX::Lua L, const PCSX::Events::Keyboard& e) {
-    L.newtable();
+void fillEvent(PCSX::Lua L, const PCSX::Events::Keyboard& e) {
     L.push("key");
     L.push(lua_Number(e.key));
     L.settable();
@@ -83,7 +92,7 @@ void pushEvent(PCSX::Lua L, const PCSX::Events::Keyboard& e) {
 }
 
 template <typename Event>
-void createListener(PCSX::Lua L) {
+void createListener(PCSX::Lua L, const char* name) {
     // 1 = event name, 2 = callback
     L.getfieldtable("EVENT_LISTENERS", LUA_REGISTRYINDEX);
     // 3 = event listeners table
@@ -101,16 +110,26 @@ void createListener(PCSX::Lua L) {
     auto t = L.thread(true);
     L.settable();
 
+    L.push("args");
+    L.newtable();
+    L.settable();
+
     // grabs a reference to the event info table, which looks like this:
-    // { callback = function, thread = coroutine }
+    // { callback = function, thread = coroutine, args = table }
     int ref = L.ref();
 
+    auto stats = std::make_shared<CallbackStats>();
     auto listener = new PCSX::EventBus::Listener(PCSX::g_system->m_eventBus);
-    listener->listen<Event>([L = t, ref](auto e) mutable {
+    listener->listen<Event>([L = t, ref, stats, name](const auto& e) mutable {
+        PCSX::FrameStats::Scope scope(PCSX::FrameStats::Lua);
+        PCSX::LuaProfiler::Scope profilerScope(name);
+        const auto start = std::chrono::steady_clock::now();
+        const int top = L.gettop();
         L.getfieldtable("EVENT_LISTENERS", LUA_REGISTRYINDEX);
-        L.getfield(ref, true);
+        L.getfield(ref, -1, true);
         L.getfield("callback");
-        pushEvent(L, e);
+        L.getfield("args", -2);
+        fillEvent(L, e);
         try {
             L.pcall(1);
         } catch (std::exception& e) {
@@ -118,6 +137,13 @@ void createListener(PCSX::Lua L) {
         } catch (...) {
             PCSX::g_system->log(PCSX::LogClass::LUA, "Unknown error in event listener");
         }
+        while (L.gettop() > top) L.pop();
+        const uint64_t elapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        stats->calls++;
+        stats->nanoseconds += elapsed;
+        if (elapsed > stats->maxNanoseconds) stats->maxNanoseconds = elapsed;
+        if (elapsed > stats->budget) stats->overBudget++;
     });
 
     int a = L.gettop();
@@ -162,6 +188,32 @@ void createListener(PCSX::Lua L) {
             return 0;
         },
         -1);
+    L.declareFunc(
+        "stats",
+        [stats](PCSX::Lua L) -> int {
+            L.newtable();
+            L.push(lua_Number(stats->calls));
+            L.setfield("calls");
+            L.push(lua_Number(stats->nanoseconds / 1000000.0));
+            L.setfield("total");
+            L.push(lua_Number(stats->maxNanoseconds / 1000000.0));
+            L.setfield("max");
+            L.push(lua_Number(stats->overBudget));
+            L.setfield("overBudget");
+            L.push(lua_Number(stats->budget / 1000000.0));
+            L.setfield("budget");
+            return 1;
+        },
+        -1);
+    L.declareFunc(
+        "setBudget",
+        [stats](PCSX::Lua L) -> int {
+            if (!L.isnumber(-1)) return L.error("setBudget: expected a number of milliseconds");
+            stats->budget = L.tonumber(-1) * 1000000.0;
+            stats->overBudget = 0;
+            return 0;
+        },
+        -1);
 }
 
 }  // namespace
@@ -182,29 +234,29 @@ void PCSX::LuaBindings::open_events(Lua L) {
             }
             auto name = L.tostring(1);
             if (name == "Quitting") {
-                createListener<Events::Quitting>(L);
+                createListener<Events::Quitting>(L, "Quitting");
             } else if (name == "IsoMounted") {
-                createListener<Events::IsoMounted>(L);
+                createListener<Events::IsoMounted>(L, "IsoMounted");
             } else if (name == "GPU::Vsync") {
-                createListener<Events::GPU::VSync>(L);
+                createListener<Events::GPU::VSync>(L, "GPU::Vsync");
             } else if (name == "ExecutionFlow::ShellReached") {
-                createListener<Events::ExecutionFlow::ShellReached>(L);
+                createListener<Events::ExecutionFlow::ShellReached>(L, "ExecutionFlow::ShellReached");
             } else if (name == "ExecutionFlow::Run") {
-                createListener<Events::ExecutionFlow::Run>(L);
+                createListener<Events::ExecutionFlow::Run>(L, "ExecutionFlow::Run");
             } else if (name == "ExecutionFlow::Pause") {
-                createListener<Events::ExecutionFlow::Pause>(L);
+                createListener<Events::ExecutionFlow::Pause>(L, "ExecutionFlow::Pause");
             } else if (name == "ExecutionFlow::Reset") {
-                createListener<Events::ExecutionFlow::Reset>(L);
+                createListener<Events::ExecutionFlow::Reset>(L, "ExecutionFlow::Reset");
             } else if (name == "ExecutionFlow::SaveStateLoaded") {
-                createListener<Events::ExecutionFlow::SaveStateLoaded>(L);
+                createListener<Events::ExecutionFlow::SaveStateLoaded>(L, "ExecutionFlow::SaveStateLoaded");
             } else if (name == "GUI::JumpToPC") {
-                createListener<Events::GUI::JumpToPC>(L);
+                createListener<Events::GUI::JumpToPC>(L, "GUI::JumpToPC");
             } else if (name == "GUI::JumpToMemory") {
-                createListener<Events::GUI::JumpToMemory>(L);
+                createListener<Events::GUI::JumpToMemory>(L, "GUI::JumpToMemory");
             } else if (name == "Keyboard") {
-                createListener<Events::Keyboard>(L);
+                createListener<Events::Keyboard>(L, "Keyboard");
             } else if (name == "Memory::SetLuts") {
-                createListener<Events::Memory::SetLuts>(L);
+                createListener<Events::Memory::SetLuts>(L, "Memory::SetLuts");
             } else {
                 return L.error("createListener: unknown event name");
             }
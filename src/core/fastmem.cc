@@ -0,0 +1,169 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/fastmem.h"
+
+#include "core/debug.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define PCSX_FASTMEM_SUPPORTED
+#endif
+
+#if defined(PCSX_FASTMEM_SUPPORTED)
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+namespace PCSX {
+
+struct FastMemSignalHandler {
+    static inline FastMem* s_instance = nullptr;
+    static inline struct sigaction s_previousSegv;
+    static inline struct sigaction s_previousBus;
+
+    static uintptr_t& getPC(void* context) {
+        auto ucontext = reinterpret_cast<ucontext_t*>(context);
+#if defined(__APPLE__)
+        return *reinterpret_cast<uintptr_t*>(&ucontext->uc_mcontext->__ss.__rip);
+#else
+        return *reinterpret_cast<uintptr_t*>(&ucontext->uc_mcontext.gregs[REG_RIP]);
+#endif
+    }
+
+    static void handler(int sig, siginfo_t* info, void* context) {
+        if (s_instance && s_instance->handleFault(reinterpret_cast<uintptr_t>(info->si_addr), getPC(context))) {
+            return;
+        }
+
+        // Not one of ours: hand it over to whoever was there before us
+        const struct sigaction& previous = sig == SIGBUS ? s_previousBus : s_previousSegv;
+        if (previous.sa_flags & SA_SIGINFO) {
+            previous.sa_sigaction(sig, info, context);
+        } else if (previous.sa_handler == SIG_DFL || previous.sa_handler == SIG_IGN) {
+            // Restore the original disposition, and let the faulting instruction run again
+            sigaction(sig, &previous, nullptr);
+        } else {
+            previous.sa_handler(sig);
+        }
+    }
+
+    static bool install(FastMem* instance) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = handler;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGSEGV, &action, &s_previousSegv) != 0) return false;
+        if (sigaction(SIGBUS, &action, &s_previousBus) != 0) {
+            sigaction(SIGSEGV, &s_previousSegv, nullptr);
+            return false;
+        }
+        s_instance = instance;
+        return true;
+    }
+
+    static void uninstall() {
+        sigaction(SIGSEGV, &s_previousSegv, nullptr);
+        sigaction(SIGBUS, &s_previousBus, nullptr);
+        s_instance = nullptr;
+    }
+};
+
+}  // namespace PCSX
+
+PCSX::FastMem::FastMem() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::Memory::SetLuts>([this](const auto& event) {
+        if (isEnabled()) remap();
+    });
+    m_listener.listen<Events::Memory::WatchpointsChanged>([this](const auto& event) {
+        if (isEnabled()) remap();
+    });
+}
+
+bool PCSX::FastMem::init(FaultHandler handler, void* opaque) {
+    shutdown();
+    if (FastMemSignalHandler::s_instance != nullptr) return false;
+    if (!g_emulator->m_mem->m_wramShared.isShared()) return false;
+
+    void* base = mmap(nullptr, c_regionSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) return false;
+
+    m_base = reinterpret_cast<uint8_t*>(base);
+    m_handler = handler;
+    m_opaque = opaque;
+    remap();
+
+    if (!FastMemSignalHandler::install(this)) {
+        munmap(m_base, c_regionSize);
+        m_base = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void PCSX::FastMem::shutdown() {
+    if (!isEnabled()) return;
+    FastMemSignalHandler::uninstall();
+    munmap(m_base, c_regionSize);
+    m_base = nullptr;
+    m_handler = nullptr;
+    m_opaque = nullptr;
+}
+
+// Mirror the RAM pages of the read LUT into the region. Pages the LUT doesn't point to RAM for get an
+// inaccessible mapping, so that accessing them goes through the fault handler. So do the pages with read
+// watchpoints, as the loads need to go through wram itself for these to trigger.
+void PCSX::FastMem::remap() {
+    auto& memory = g_emulator->m_mem;
+    const auto wram = memory->m_wram;
+    const auto wramSize = memory->m_wramShared.getSize();
+
+    for (uint32_t segment : {0x0000, 0x8000, 0xa000}) {
+        for (uint32_t i = 0; i < 0x80; i++) {
+            const uint32_t page = segment + i;
+            const auto pointer = memory->m_readLUT[page];
+            void* address = m_base + (size_t(page) << 16);
+            if (pointer >= wram && pointer < wram + wramSize &&
+                !g_emulator->m_debug->isWatchingReads(pointer - wram, c_pageSize) &&
+                memory->m_wramShared.mapView(address, pointer - wram, c_pageSize)) {
+                continue;
+            }
+            mmap(address, c_pageSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+        }
+    }
+}
+
+bool PCSX::FastMem::handleFault(uintptr_t faultAddress, uintptr_t& pc) {
+    const auto base = reinterpret_cast<uintptr_t>(m_base);
+    if (faultAddress < base || faultAddress >= base + c_regionSize) return false;
+    return m_handler(m_opaque, pc);
+}
+
+#else
+
+PCSX::FastMem::FastMem() : m_listener(g_system->m_eventBus) {}
+bool PCSX::FastMem::init(FaultHandler handler, void* opaque) { return false; }
+void PCSX::FastMem::shutdown() {}
+void PCSX::FastMem::remap() {}
+bool PCSX::FastMem::handleFault(uintptr_t faultAddress, uintptr_t& pc) { return false; }
+
+#endif
@@ -0,0 +1,65 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/system.h"
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// A 4GB host region laid out like the PSX address space, so that a recompiler can turn a guest load into a single
+// host load from base + address. The RAM mirrors get mapped read-only from Memory's shared wram, following
+// Memory::m_readLUT. Everything else is left inaccessible: accessing it faults, and the fault handler registered
+// in init gets a chance to redirect the faulting host instruction to a slow path.
+class FastMem {
+  public:
+    // Called from the fault handler with the host program counter of the faulting instruction.
+    // Returns true if pc has been updated to point somewhere execution can resume from.
+    using FaultHandler = bool (*)(void* opaque, uintptr_t& pc);
+
+    FastMem();
+    ~FastMem() { shutdown(); }
+
+    bool init(FaultHandler handler, void* opaque);
+    void shutdown();
+
+    bool isEnabled() { return m_base != nullptr; }
+    uint8_t* getBase() { return m_base; }
+
+  private:
+    static constexpr size_t c_pageSize = 0x10000;
+    // Guest accesses can go up to 3 bytes past 0xffffffff, so keep a guard page at the end of the region
+    static constexpr size_t c_regionSize = 0x100000000ULL + c_pageSize;
+
+    void remap();
+    bool handleFault(uintptr_t faultAddress, uintptr_t& pc);
+
+    uint8_t* m_base = nullptr;
+    FaultHandler m_handler = nullptr;
+    void* m_opaque = nullptr;
+    EventBus::Listener m_listener;
+
+    friend struct FastMemSignalHandler;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/flashwriter.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "support/file.h"
+
+void PCSX::FlashWriter::write(const std::filesystem::path& path, const uint8_t* flash, const Sectors& dirty) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_pending.any() && (m_path != path)) {
+        m_now = true;
+        m_wakeWriter.notify_one();
+        m_idle.wait(lock, [this]() { return m_pending.none(); });
+    }
+    if (!m_flash) m_flash.reset(new uint8_t[c_flashSize]);
+    m_path = path;
+    for (size_t i = 0; i < c_sectors; i++) {
+        if (dirty.test(i)) memcpy(m_flash.get() + i * c_sectorSize, flash + i * c_sectorSize, c_sectorSize);
+    }
+
+    const auto current = Clock::now();
+    if (m_pending.none()) m_pendingSince = current;
+    m_pending |= dirty;
+    m_deadline = std::min(current + m_delay, m_pendingSince + 4 * m_delay);
+    if (!m_thread.joinable()) {
+        m_closing = false;
+        m_thread = std::thread([this]() { writerMain(); });
+    }
+    lock.unlock();
+    m_wakeWriter.notify_one();
+}
+
+void PCSX::FlashWriter::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_pending.none() && !m_writing) return;
+    m_now = true;
+    m_wakeWriter.notify_one();
+    m_idle.wait(lock, [this]() { return m_pending.none() && !m_writing; });
+}
+
+void PCSX::FlashWriter::close() {
+    if (!m_thread.joinable()) return;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_wakeWriter.notify_one();
+    m_thread.join();
+}
+
+void PCSX::FlashWriter::writerMain() {
+    std::unique_ptr<uint8_t[]> flash(new uint8_t[c_flashSize]);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        if (m_pending.none()) {
+            if (m_closing) break;
+            m_wakeWriter.wait(lock);
+            continue;
+        }
+        if (!m_now && !m_closing && (Clock::now() < m_deadline)) {
+            m_wakeWriter.wait_until(lock, m_deadline);
+            continue;
+        }
+        const Sectors sectors = m_pending;
+        for (size_t i = 0; i < c_sectors; i++) {
+            if (sectors.test(i)) memcpy(flash.get() + i * c_sectorSize, m_flash.get() + i * c_sectorSize, c_sectorSize);
+        }
+        const auto path = m_path;
+        m_pending.reset();
+        m_now = false;
+        m_writing = true;
+        m_idle.notify_all();
+        lock.unlock();
+        save(path, flash.get(), sectors);
+        lock.lock();
+        m_writing = false;
+        m_idle.notify_all();
+    }
+}
+
+// Runs of consecutive dirty sectors go out as a single write.
+void PCSX::FlashWriter::save(const std::filesystem::path& path, const uint8_t* flash, const Sectors& sectors) {
+    IO<File> out(new PosixFile(path, FileOps::READWRITE));
+    if (out->failed()) return;
+    size_t i = 0;
+    while (i < c_sectors) {
+        if (!sectors.test(i)) {
+            i++;
+            continue;
+        }
+        const size_t first = i;
+        while ((i < c_sectors) && sectors.test(i)) i++;
+        out->writeAt(flash + first * c_sectorSize, (i - first) * c_sectorSize, first * c_sectorSize);
+    }
+}
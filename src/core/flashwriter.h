@@ -0,0 +1,76 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace PCSX {
+
+// Writes the PIO cartridge's flash back into its ROM file behind the emulation's back. Unlike memory cards, the
+// file is patched in place, one sector at a time, so that programming a few bytes of a large image doesn't
+// rewrite all of it. The sectors handed over get merged into a copy of the flash, which a background thread
+// writes once the program stopped touching the flash for a little while.
+class FlashWriter {
+  public:
+    static constexpr size_t c_sectorSize = 128;
+    static constexpr size_t c_flashSize = 256 * 1024;
+    static constexpr size_t c_sectors = c_flashSize / c_sectorSize;
+    typedef std::bitset<c_sectors> Sectors;
+
+    explicit FlashWriter(std::chrono::milliseconds delay = std::chrono::milliseconds(500)) : m_delay(delay) {}
+    ~FlashWriter() { close(); }
+
+    // Hands over the sectors of the flash flagged as dirty. A different path first flushes what's pending.
+    void write(const std::filesystem::path& path, const uint8_t* flash, const Sectors& dirty);
+    // Blocks until everything handed over so far is in the file.
+    void flush();
+    void close();
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+    void writerMain();
+    static void save(const std::filesystem::path& path, const uint8_t* flash, const Sectors& sectors);
+
+    const std::chrono::milliseconds m_delay;
+    std::unique_ptr<uint8_t[]> m_flash;
+    std::filesystem::path m_path;
+    Sectors m_pending;
+    bool m_writing = false;
+    bool m_now = false;
+    bool m_closing = false;
+    Clock::time_point m_pendingSince;
+    Clock::time_point m_deadline;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeWriter;
+    std::condition_variable m_idle;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/framepacer.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool PCSX::FramePacer::ratesMatch(double hostHz, double emulatedHz) {
+    if ((hostHz <= 0.0) || (emulatedHz <= 0.0)) return false;
+    return std::abs(hostHz - emulatedHz) <= emulatedHz * c_rateTolerance;
+}
+
+void PCSX::FramePacer::begin(clock::time_point now) {
+    m_begin = now;
+    m_begun = true;
+}
+
+void PCSX::FramePacer::submit(clock::time_point now) {
+    if (!m_begun) return;
+    m_begun = false;
+    const auto work = now - m_begin;
+    if (work > c_gap) return;
+    m_work[m_workIndex] = std::chrono::duration_cast<std::chrono::nanoseconds>(work).count();
+    m_workIndex = (m_workIndex + 1) % HISTORY;
+    if (m_workSize < HISTORY) m_workSize++;
+}
+
+void PCSX::FramePacer::presented(clock::time_point now) {
+    const auto interval = now - m_lastPresent;
+    const bool hadPresented = m_presentedOnce;
+    m_lastPresent = now;
+    m_presentedOnce = true;
+    if (!hadPresented) return;
+    if (interval > c_gap) {
+        reset();
+        m_lastPresent = now;
+        m_presentedOnce = true;
+        return;
+    }
+    m_intervals[m_intervalIndex] = std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count();
+    m_intervalIndex = (m_intervalIndex + 1) % HISTORY;
+    if (m_intervalSize < HISTORY) m_intervalSize++;
+}
+
+void PCSX::FramePacer::reset() {
+    m_begun = false;
+    m_presentedOnce = false;
+    m_workIndex = m_workSize = 0;
+    m_intervalIndex = m_intervalSize = 0;
+}
+
+PCSX::FramePacer::clock::duration PCSX::FramePacer::workEstimate() const {
+    if (m_workSize < c_minSamples) return clock::duration::zero();
+    int64_t sorted[HISTORY];
+    std::copy(m_work, m_work + m_workSize, sorted);
+    const unsigned index = (m_workSize * 95) / 100;
+    std::nth_element(sorted, sorted + index, sorted + m_workSize);
+    return std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(sorted[index]));
+}
+
+PCSX::FramePacer::clock::duration PCSX::FramePacer::delay(clock::duration period) const {
+    if (m_workSize < c_minSamples) return clock::duration::zero();
+    const auto delay = period - workEstimate() - c_margin;
+    return std::clamp(delay, clock::duration::zero(), period);
+}
+
+PCSX::FramePacer::Stats PCSX::FramePacer::presentStats() const {
+    Stats stats;
+    if (m_intervalSize == 0) return stats;
+    double sum = 0.0;
+    stats.min = stats.max = m_intervals[0] / 1000000.0;
+    for (unsigned i = 0; i < m_intervalSize; i++) {
+        const double ms = m_intervals[i] / 1000000.0;
+        sum += ms;
+        stats.min = std::min(stats.min, ms);
+        stats.max = std::max(stats.max, ms);
+    }
+    stats.count = m_intervalSize;
+    stats.mean = sum / m_intervalSize;
+    double variance = 0.0;
+    for (unsigned i = 0; i < m_intervalSize; i++) {
+        const double d = m_intervals[i] / 1000000.0 - stats.mean;
+        variance += d * d;
+    }
+    stats.stddev = std::sqrt(variance / m_intervalSize);
+    return stats;
+}
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+
+namespace PCSX {
+
+// Lines the emulated frames up with the host display. With the swap interval at 1, presenting blocks until the
+// host vsync, and the emulation of the next frame would then start right away, reading the pads one whole host
+// frame before its result gets shown. The pacer instead measures how long the frames take to emulate and draw,
+// and delays their start so that they finish just before the next host vsync, which is when the pads get read
+// as late as can be. It also keeps track of the intervals between presents, whether pacing or not, as their
+// spread is what shows as judder.
+class FramePacer {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr unsigned HISTORY = 120;
+    // How far off the host display can be from the emulated frame rate for the pacing to still make sense.
+    static constexpr double c_rateTolerance = 0.01;
+    // Kept between the expected end of a frame and the host vsync, to absorb the scheduler's wake up jitter.
+    static constexpr std::chrono::microseconds c_margin{1500};
+    // An interval longer than this is a pause or a hitch, and restarts the measurements.
+    static constexpr std::chrono::milliseconds c_gap{250};
+
+    struct Stats {
+        double mean = 0.0;
+        double stddev = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        unsigned count = 0;
+    };
+
+    static bool ratesMatch(double hostHz, double emulatedHz);
+
+    // The emulation of a frame starts, after the delay.
+    void begin(clock::time_point now);
+    // The frame is done, and about to get presented.
+    void submit(clock::time_point now);
+    // The present returned.
+    void presented(clock::time_point now);
+    void reset();
+
+    // How long to wait after a present before starting the next frame, for a host display refreshing with the
+    // given period. This is zero until there's enough history to know how long the frames take.
+    clock::duration delay(clock::duration period) const;
+    // The intervals between presents, in milliseconds.
+    Stats presentStats() const;
+    // The time it takes to emulate and draw a frame, as used for the delay: a high percentile, to not have the
+    // occasional slower frame miss its vsync.
+    clock::duration workEstimate() const;
+
+  private:
+    static constexpr unsigned c_minSamples = 10;
+
+    clock::time_point m_begin;
+    bool m_begun = false;
+    clock::time_point m_lastPresent;
+    bool m_presentedOnce = false;
+
+    int64_t m_work[HISTORY] = {};
+    unsigned m_workIndex = 0;
+    unsigned m_workSize = 0;
+    int64_t m_intervals[HISTORY] = {};
+    unsigned m_intervalIndex = 0;
+    unsigned m_intervalSize = 0;
+};
+
+}  // namespace PCSX
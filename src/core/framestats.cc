@@ -0,0 +1,51 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/framestats.h"
+
+void PCSX::FrameStats::endFrame(uint64_t cycle) {
+    charge();
+    for (unsigned i = 0; i < COUNT; i++) {
+        m_last.nanoseconds[i] = m_pending[i];
+        m_pending[i] = 0;
+    }
+    m_last.nanoseconds[Rasterizer] = m_rasterizer.exchange(0, std::memory_order_relaxed);
+    // Resets and save states can take the cycle counter backwards.
+    m_last.cycles = cycle >= m_lastCycle ? cycle - m_lastCycle : 0;
+    m_lastCycle = cycle;
+    for (unsigned i = 0; i < COUNT; i++) m_totals.nanoseconds[i] += m_last.nanoseconds[i];
+    m_totals.cycles += m_last.cycles;
+    m_frames++;
+
+    m_history[m_historyIndex] = m_last;
+    m_historyIndex = (m_historyIndex + 1) % HISTORY;
+    if (m_historySize < HISTORY) m_historySize++;
+}
+
+PCSX::FrameStats::Frame PCSX::FrameStats::average() const {
+    Frame average;
+    if (m_historySize == 0) return average;
+    for (unsigned f = 0; f < m_historySize; f++) {
+        for (unsigned i = 0; i < COUNT; i++) average.nanoseconds[i] += m_history[f].nanoseconds[i];
+        average.cycles += m_history[f].cycles;
+    }
+    for (unsigned i = 0; i < COUNT; i++) average.nanoseconds[i] /= m_historySize;
+    average.cycles /= m_historySize;
+    return average;
+}
@@ -0,0 +1,117 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+
+#include "core/psxemulator.h"
+
+namespace PCSX {
+
+// Always-on accounting of where the host time goes, per emulated frame. The emulation thread's time is
+// charged to whichever subsystem is innermost when it's spent, with the Scopes placed around the calls
+// into each subsystem, and the CPU getting the rest. The GPU command thread, when there's one, reports
+// its time separately, as rasterisation. The counters roll over at each vsync.
+class FrameStats {
+  public:
+    enum Subsystem : unsigned { CPU, GPU, Rasterizer, SPU, CDROM, MDEC, Lua, GUI, Idle, COUNT };
+    static constexpr const char* c_names[COUNT] = {
+        "CPU", "GPU", "Rasterizer", "SPU", "CD-ROM", "MDEC", "Lua", "GUI", "Idle",
+    };
+    // For the Lua and web server APIs.
+    static constexpr const char* c_keys[COUNT] = {
+        "cpu", "gpu", "rasterizer", "spu", "cdrom", "mdec", "lua", "gui", "idle",
+    };
+
+    struct Frame {
+        uint64_t nanoseconds[COUNT] = {};
+        uint64_t cycles = 0;
+        // The rasteriser runs alongside, so it's not part of the frame's wall time.
+        uint64_t wallTime() const {
+            uint64_t total = 0;
+            for (unsigned i = 0; i < COUNT; i++) {
+                if (i != Rasterizer) total += nanoseconds[i];
+            }
+            return total;
+        }
+    };
+
+    class Scope {
+      public:
+        explicit Scope(Subsystem subsystem)
+            : m_stats(g_emulator->m_frameStats.get()), m_previous(m_stats->enter(subsystem)) {}
+        ~Scope() { m_stats->leave(m_previous); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        FrameStats* const m_stats;
+        const Subsystem m_previous;
+    };
+
+    FrameStats() : m_since(clock::now()) {}
+
+    void addRasterizer(uint64_t nanoseconds) { m_rasterizer.fetch_add(nanoseconds, std::memory_order_relaxed); }
+    void endFrame(uint64_t cycle);
+    const Frame& lastFrame() const { return m_last; }
+    // Since startup, for the monitoring counters.
+    const Frame& totals() const { return m_totals; }
+    uint64_t frames() const { return m_frames; }
+    // Over the last HISTORY frames, to smooth out the noise.
+    Frame average() const;
+
+    static constexpr unsigned HISTORY = 60;
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    Subsystem enter(Subsystem subsystem) {
+        charge();
+        const Subsystem previous = m_current;
+        m_current = subsystem;
+        return previous;
+    }
+    void leave(Subsystem previous) {
+        charge();
+        m_current = previous;
+    }
+    void charge() {
+        const auto now = clock::now();
+        m_pending[m_current] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_since).count();
+        m_since = now;
+    }
+
+    Subsystem m_current = CPU;
+    clock::time_point m_since;
+    uint64_t m_pending[COUNT] = {};
+    std::atomic<uint64_t> m_rasterizer = 0;
+    uint64_t m_lastCycle = 0;
+    Frame m_last;
+    Frame m_totals;
+    uint64_t m_frames = 0;
+    Frame m_history[HISTORY];
+    unsigned m_historyIndex = 0;
+    unsigned m_historySize = 0;
+};
+
+}  // namespace PCSX
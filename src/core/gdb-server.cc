@@ -265,10 +265,10 @@ static const std::string memoryMap = R"(<?xml version="1.0"?>
   <memory type="ram" start="0xffffffff9fa00000" length="0x200000"/>
   <memory type="ram" start="0xffffffffbfa00000" length="0x200000"/>
 
-  <!-- BIOS -->
-  <memory type="ram" start="0x000000001fc00000" length="0x80000"/>
-  <memory type="ram" start="0xffffffff9fc00000" length="0x80000"/>
-  <memory type="ram" start="0xffffffffbfc00000" length="0x80000"/>
+  <!-- BIOS, which gdb can then cache, and put hardware breakpoints in -->
+  <memory type="rom" start="0x000000001fc00000" length="0x80000"/>
+  <memory type="rom" start="0xffffffff9fc00000" length="0x80000"/>
+  <memory type="rom" start="0xffffffffbfc00000" length="0x80000"/>
 
   <!-- MSAN -->
   <memory type="ram" start="0x0000000020000000" length="0x60000000"/>
@@ -470,6 +470,60 @@ void PCSX::GdbClient::setOneRegister(int n, uint32_t value) {
     }
 }
 
+// The whole reply gets hex encoded into a single buffer, straight from memory wherever it's directly
+// addressable. The rest, such as the hardware registers, goes through the memory file.
+void PCSX::GdbClient::readMemory(uint32_t address, uint32_t length) {
+    std::string out;
+    out.resize(size_t(length) * 2);
+    char* hex = out.data();
+    auto encode = [&hex](const uint8_t* src, uint32_t size) {
+        for (uint32_t i = 0; i < size; i++) {
+            *hex++ = toHex[src[i] >> 4];
+            *hex++ = toHex[src[i] & 0x0f];
+        }
+    };
+    auto& mem = g_emulator->m_mem;
+    while (length) {
+        const uint32_t page = address >> 16;
+        const uint32_t offset = address & 0xffff;
+        uint32_t chunk = std::min(length, 0x10000 - offset);
+        const uint8_t* src = nullptr;
+        if ((page == 0x1f80) || (page == 0x9f80) || (page == 0xbf80)) {
+            // Only the scratchpad is contiguous in there.
+            if (offset < 0x400) {
+                chunk = std::min(chunk, 0x400 - offset);
+                src = reinterpret_cast<const uint8_t*>(mem->pointerRead(address));
+            } else {
+                chunk = std::min(chunk, 0x400u);
+            }
+        } else {
+            src = reinterpret_cast<const uint8_t*>(mem->pointerRead(address));
+        }
+        if (src) {
+            encode(src, chunk);
+        } else {
+            uint8_t bytes[0x400];
+            for (uint32_t done = 0; done < chunk;) {
+                const uint32_t size = std::min<uint32_t>(chunk - done, sizeof(bytes));
+                mem->getMemoryAsFile()->readAt(bytes, size, address + done);
+                encode(bytes, size);
+                done += size;
+            }
+        }
+        address += chunk;
+        length -= chunk;
+    }
+    write(std::move(out));
+}
+
+void PCSX::GdbClient::writeMemory(uint32_t address, const char* data, uint32_t length) {
+    if (((address == 0x8000f800) && (length == 0x800)) || ((address == 0x8000ffea) && (length == 22))) {
+        // heuristic for our ps-exe.ld and cpe.ld
+        return;
+    }
+    g_emulator->m_mem->getMemoryAsFile()->writeAt(data, length, address);
+}
+
 void PCSX::GdbClient::processCommand() {
     if (m_ackEnabled) sendAck();
     if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::GdbServerTrace>()) {
@@ -547,36 +601,37 @@ void PCSX::GdbClient::processCommand() {
         // write memory
         auto elements = StringsHelpers::split(m_cmd, ":");
         auto [off, len] = parseCursor(elements[0].substr(1));
-        if (((off == 0x8000f800) && (len == 0x800)) || ((off == 0x8000ffea) && (len == 22))) {
-            // heuristic for our ps-exe.ld and cpe.ld
-            write("OK");
+        if ((elements.size() != 2) || (elements[1].size() != len * 2)) {
+            write("E00");
             return;
         }
-        size_t i = 0;
-        IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
-        memFile->wSeek(off);
-        while (len--) {
+        std::string data(len, '\0');
+        for (size_t i = 0; i < len; i++) {
             uint8_t c = fromHexChar(elements[1][i * 2 + 0]);
             c <<= 4;
             c |= fromHexChar(elements[1][i * 2 + 1]);
-            memFile->write(c);
-            i++;
+            data[i] = c;
         }
+        writeMemory(off, data.data(), len);
+        write("OK");
+    } else if (m_cmd[0] == 'X') {
+        // write memory, binary; the escapes were already undone while reading the packet
+        auto colon = m_cmd.find(':');
+        if (colon == std::string::npos) {
+            write("E00");
+            return;
+        }
+        auto [off, len] = parseCursor(m_cmd.substr(1, colon - 1));
+        if ((m_cmd.size() - colon - 1) != len) {
+            write("E00");
+            return;
+        }
+        writeMemory(off, m_cmd.data() + colon + 1, len);
         write("OK");
     } else if (m_cmd[0] == 'm') {
         // read memory
         auto [off, len] = parseCursor(m_cmd.substr(1));
-        startStream();
-        IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
-        memFile->rSeek(off);
-        while (len--) {
-            uint8_t v = memFile->read<uint8_t>();
-            char s[3] = {0, 0, 0};
-            s[0] = toHex[v >> 4];
-            s[1] = toHex[(v & 0x0f)];
-            stream(s);
-        }
-        stopStream();
+        readMemory(off, len);
     } else if ((m_cmd[0] == 'z') || (m_cmd[0] == 'Z')) {
         // insert or remove breakpoint
         enum class Action {
@@ -671,7 +726,7 @@ void PCSX::GdbClient::processCommand() {
                 multiprocess = true;
             }
         }
-        std::string answer = "PacketSize=47ff;qXfer:threads:read+;QStartNoAckMode+";
+        std::string answer = "PacketSize=20000;qXfer:threads:read+;QStartNoAckMode+";
         if (multiprocess) {
             answer += ";multiprocess+";
         }
@@ -23,6 +23,7 @@
 
 #include <cstdarg>
 #include <string>
+#include <vector>
 
 #include "core/debug.h"
 #include "core/psxemulator.h"
@@ -106,28 +107,27 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
         req->enqueueRaw(this);
     }
 
+    // Streamed packets are gathered as they're built, and go out with a single write once complete.
     void startStream() {
         m_crc = 0;
-        auto* req = new WriteRequest();
-        req->m_slice.copy("$", 1);
-        req->enqueueRaw(this);
+        m_stream.clear();
+        m_stream.push("$");
     }
 
     void stream(const std::string& data) {
         for (int i = 0; i < data.length(); i++) {
             m_crc += data[i];
         }
-        auto* req = new WriteRequest();
-        req->m_slice.copy(data.data(), data.size());
-        req->enqueueRaw(this);
+        m_stream.push(std::string(data));
     }
 
     void stopStream() {
-        auto* req = new WriteRequest();
-        char end[3] = {'#'};
+        std::string end(3, '#');
         end[1] = toHex[m_crc >> 4];
         end[2] = toHex[m_crc & 0x0f];
-        req->m_slice.copy(end, 3);
+        m_stream.push(std::move(end));
+        auto* req = new WriteRequest();
+        req->m_slices = std::move(m_stream);
         req->enqueueRaw(this);
     }
 
@@ -157,6 +157,10 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
             uv_write(&m_req, reinterpret_cast<uv_stream_t*>(&client->m_tcp), m_bufs, 3, writeCB);
         }
         void enqueueRaw(GdbClient* client) {
+            if (!m_slices.empty()) {
+                enqueueSlices(client);
+                return;
+            }
             if (g_emulator->settings.get<Emulator::SettingDebugSettings>()
                     .get<Emulator::DebugSettings::GdbServerTrace>()) {
                 std::string msg((const char*)m_slice.data(), m_slice.size());
@@ -167,6 +171,21 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
             client->m_requests.insert(reinterpret_cast<uintptr_t>(&m_req), this);
             uv_write(&m_req, reinterpret_cast<uv_stream_t*>(&client->m_tcp), m_bufs, 1, writeCB);
         }
+        void enqueueSlices(GdbClient* client) {
+            if (g_emulator->settings.get<Emulator::SettingDebugSettings>()
+                    .get<Emulator::DebugSettings::GdbServerTrace>()) {
+                std::string msg;
+                m_slices.forEach([&msg](const void* ptr, size_t size) { msg.append((const char*)ptr, size); });
+                g_system->log(LogClass::GDB, "GDB <-- PCSX %s\n", msg.c_str());
+            }
+            m_chainBufs.reserve(m_slices.count());
+            m_slices.forEach([this](const void* ptr, size_t size) {
+                m_chainBufs.push_back(uv_buf_init(static_cast<char*>(const_cast<void*>(ptr)), size));
+            });
+            client->m_requests.insert(reinterpret_cast<uintptr_t>(&m_req), this);
+            uv_write(&m_req, reinterpret_cast<uv_stream_t*>(&client->m_tcp), m_chainBufs.data(), m_chainBufs.size(),
+                     writeCB);
+        }
         static void writeCB(uv_write_t* request, int status) {
             GdbClient* client = static_cast<GdbClient*>(request->handle->data);
             auto self = client->m_requests.find(reinterpret_cast<uintptr_t>(request));
@@ -178,10 +197,13 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
         char m_after[3] = {'#'};
         uv_buf_t m_bufs[3];
         Slice m_slice;
+        SliceChain m_slices;
+        std::vector<uv_buf_t> m_chainBufs;
     };
     friend struct WriteRequest;
     Intrusive::HashTable<uintptr_t, WriteRequest> m_requests;
-    static constexpr size_t BUFFER_SIZE = 256;
+    // Big enough to take in a full sized binary write packet in one go.
+    static constexpr size_t BUFFER_SIZE = 16384;
     static void allocTrampoline(uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf) {
         GdbClient* client = static_cast<GdbClient*>(handle->data);
         client->alloc(suggestedSize, buf);
@@ -216,6 +238,9 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
     Slice passthroughData(Slice slice);
     std::pair<uint64_t, uint64_t> parseCursor(const std::string& cursorStr);
 
+    void readMemory(uint32_t address, uint32_t length);
+    void writeMemory(uint32_t address, const char* data, uint32_t length);
+
     std::string dumpOneRegister(int n);
     void setOneRegister(int n, uint32_t value);
     static std::string dumpValue(uint32_t value);
@@ -243,6 +268,7 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
     bool m_canReceiveLogs = false;
     std::string m_cmd;
     uint8_t m_crc;
+    SliceChain m_stream;
     EventBus::Listener m_listener;
     uv_loop_t* m_loop;
     Debug::BreakpointUserListType m_breakpoints;
@@ -21,17 +21,22 @@
 
 #include "core/gpu.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <magic_enum_all.hpp>
 #include <sstream>
 
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "core/gpulogger.h"
 #include "core/pgxp_mem.h"
+#include "core/pgxp_value.h"
 #include "core/psxdma.h"
 #include "core/psxhw.h"
 #include "imgui/imgui.h"
 #include "imgui/imgui_internal.h"
+#include "support/table-generator.h"
+#include "supportpsx/pixel-kernels.h"
 
 #define GPUSTATUS_READYFORVRAM 0x08000000
 #define GPUSTATUS_IDLE 0x04000000  // CMD ready
@@ -73,22 +78,57 @@ void GPU::Poly<shading, shape, textured, blend, modulation>::processWrite(Buffer
                 value = buf.get();
                 [[fallthrough]];
         case READ_UV:
-                if constexpr (textured == Textured::Yes) {
-                    u[m_count] = value & 0xff;
-                    v[m_count] = (value >> 8) & 0xff;
-                    value >>= 16;
-                    if (m_count == 0) {
-                        clutraw = value;
-                    } else if (m_count == 1) {
-                        value &= 0b0000100111111111;
-                        tpage = TPage(value);
-                        uint32_t lastTPage = m_gpu->m_lastTPage.raw & ~0b0000100111111111;
-                        m_gpu->m_lastTPage = TPage(lastTPage | value);
-                    }
-                }
+                readUV(m_count, value);
             }
         }
     }
+    submit(origin, origvalue, length);
+}
+// clang-format on
+
+template <GPU::Shading shading, GPU::Shape shape, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+void GPU::Poly<shading, shape, textured, blend, modulation>::processPacket(const uint32_t *words, Logged::Origin origin,
+                                                                         uint32_t origvalue, uint32_t length) {
+    uint32_t value = SWAP_LE32(*words++);
+    for (unsigned i = 0; i < count; i++) {
+        if ((shading == Shading::Gouraud) || (i == 0)) {
+            if ((shading == Shading::Gouraud) && (i != 0)) value = SWAP_LE32(*words++);
+            if constexpr ((textured == Textured::Yes) && (modulation == Modulation::Off)) {
+                colors[i] = 0x808080;
+            } else {
+                colors[i] = value & 0xffffff;
+            }
+        } else {
+            colors[i] = colors[0];
+        }
+        value = SWAP_LE32(*words++);
+        x[i] = GPU::signExtend<int, 11>(value & 0xffff);
+        y[i] = GPU::signExtend<int, 11>(value >> 16);
+        if constexpr (textured == Textured::Yes) readUV(i, SWAP_LE32(*words++));
+    }
+    submit(origin, origvalue, length);
+}
+
+template <GPU::Shading shading, GPU::Shape shape, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+void GPU::Poly<shading, shape, textured, blend, modulation>::readUV(unsigned index, uint32_t value) {
+    if constexpr (textured == Textured::Yes) {
+        u[index] = value & 0xff;
+        v[index] = (value >> 8) & 0xff;
+        value >>= 16;
+        if (index == 0) {
+            clutraw = value;
+        } else if (index == 1) {
+            value &= 0b0000100111111111;
+            tpage = TPage(value);
+            uint32_t lastTPage = m_gpu->m_lastTPage.raw & ~0b0000100111111111;
+            m_gpu->m_lastTPage = TPage(lastTPage | value);
+        }
+    }
+}
+
+template <GPU::Shading shading, GPU::Shape shape, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+void GPU::Poly<shading, shape, textured, blend, modulation>::submit(Logged::Origin origin, uint32_t origvalue,
+                                                                  uint32_t length) {
     m_count = 0;
     m_state = READ_COLOR;
     if constexpr (textured == Textured::Yes) {
@@ -97,9 +137,11 @@ void GPU::Poly<shading, shape, textured, blend, modulation>::processWrite(Buffer
     offset = m_gpu->m_lastOffset;
     m_gpu->m_defaultProcessor.setActive();
     g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+    if (m_gpu->skipDraw(x, y, count, offset.x, offset.y)) return;
     m_gpu->write0(this);
 }
 
+// clang-format off
 template <GPU::Shading shading, GPU::LineType lineType, GPU::Blend blend>
 void GPU::Line<shading, lineType, blend>::processWrite(Buffer & buf, Logged::Origin origin, uint32_t origvalue, uint32_t length) {
     uint32_t value = buf.get();
@@ -147,6 +189,32 @@ void GPU::Line<shading, lineType, blend>::processWrite(Buffer & buf, Logged::Ori
             }
         }
     }
+    submit(origin, origvalue, length);
+}
+// clang-format on
+
+template <GPU::Shading shading, GPU::LineType lineType, GPU::Blend blend>
+void GPU::Line<shading, lineType, blend>::processPacket(const uint32_t *words, Logged::Origin origin,
+                                                        uint32_t origvalue, uint32_t length) {
+    if constexpr (lineType == LineType::Simple) {
+        uint32_t value = SWAP_LE32(*words++);
+        for (unsigned i = 0; i < 2; i++) {
+            if ((shading == Shading::Gouraud) || (i == 0)) {
+                if ((shading == Shading::Gouraud) && (i != 0)) value = SWAP_LE32(*words++);
+                colors[i] = value & 0xffffff;
+            } else {
+                colors[i] = colors[0];
+            }
+            value = SWAP_LE32(*words++);
+            x[i] = GPU::signExtend<int, 11>(value & 0xffff);
+            y[i] = GPU::signExtend<int, 11>(value >> 16);
+        }
+        submit(origin, origvalue, length);
+    }
+}
+
+template <GPU::Shading shading, GPU::LineType lineType, GPU::Blend blend>
+void GPU::Line<shading, lineType, blend>::submit(Logged::Origin origin, uint32_t origvalue, uint32_t length) {
     if constexpr (lineType == LineType::Simple) {
         m_count = 0;
     }
@@ -155,7 +223,7 @@ void GPU::Line<shading, lineType, blend>::processWrite(Buffer & buf, Logged::Ori
     m_gpu->m_defaultProcessor.setActive();
     if ((colors.size() >= 2) && ((colors.size() == x.size()))) {
         g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
-        m_gpu->write0(this);
+        if (!m_gpu->skipDraw(x.data(), y.data(), x.size(), offset.x, offset.y)) m_gpu->write0(this);
     } else {
         g_system->log(LogClass::GPU, "Got an invalid line command...\n");
     }
@@ -166,6 +234,7 @@ void GPU::Line<shading, lineType, blend>::processWrite(Buffer & buf, Logged::Ori
     }
 }
 
+// clang-format off
 template <GPU::Size size, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
 void GPU::Rect<size, textured, blend, modulation>::processWrite(Buffer & buf, Logged::Origin origin, uint32_t origvalue, uint32_t length) {
     uint32_t value = buf.get();
@@ -215,6 +284,45 @@ void GPU::Rect<size, textured, blend, modulation>::processWrite(Buffer & buf, Lo
                 h = value >> 16;
             }
     }
+    submit(origin, origvalue, length);
+}
+// clang-format on
+
+template <GPU::Size size, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+void GPU::Rect<size, textured, blend, modulation>::processPacket(const uint32_t *words, Logged::Origin origin,
+                                                                 uint32_t origvalue, uint32_t length) {
+    uint32_t value = SWAP_LE32(*words++);
+    if constexpr ((textured == Textured::No) || (modulation == Modulation::On)) {
+        color = value & 0xffffff;
+    }
+    value = SWAP_LE32(*words++);
+    x = GPU::signExtend<int, 11>(value & 0xffff);
+    y = GPU::signExtend<int, 11>(value >> 16);
+    if constexpr (textured == Textured::Yes) {
+        value = SWAP_LE32(*words++);
+        u = value & 0xff;
+        v = (value >> 8) & 0xff;
+        clutraw = value >> 16;
+    }
+    if constexpr (size == Size::S1) {
+        h = 1;
+        w = 1;
+    } else if constexpr (size == Size::S8) {
+        h = 8;
+        w = 8;
+    } else if constexpr (size == Size::S16) {
+        h = 16;
+        w = 16;
+    } else {
+        value = SWAP_LE32(*words++);
+        w = value & 0xffff;
+        h = value >> 16;
+    }
+    submit(origin, origvalue, length);
+}
+
+template <GPU::Size size, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+void GPU::Rect<size, textured, blend, modulation>::submit(Logged::Origin origin, uint32_t origvalue, uint32_t length) {
     m_state = READ_COLOR;
     if constexpr (textured == Textured::Yes) {
         tpage = TPage(m_gpu->m_lastTPage.raw);
@@ -223,12 +331,43 @@ void GPU::Rect<size, textured, blend, modulation>::processWrite(Buffer & buf, Lo
     offset = m_gpu->m_lastOffset;
     m_gpu->m_defaultProcessor.setActive();
     g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+    if (m_gpu->skipDraw(x + offset.x, y + offset.y, w, h)) return;
     m_gpu->write0(this);
 }
 // clang-format on
 
 namespace {
 
+// How many words each GP0 primitive packet holds, header included. Polylines are left at zero, since their
+// length is only known once their terminator shows up, as are all the non-primitive opcodes.
+struct PrimitiveWordsGenerator {
+    static consteval uint8_t calculateValue(std::size_t opcode) {
+        const bool gouraud = opcode & 0x10;
+        const bool textured = opcode & 0x04;
+        switch (opcode >> 5) {
+            case 1: {  // polygon
+                const unsigned count = (opcode & 0x08) ? 4 : 3;
+                return count * (textured ? 2 : 1) + (gouraud ? count : 1);
+            }
+            case 2:  // line
+                if (opcode & 0x08) return 0;
+                return gouraud ? 4 : 3;
+            case 3:  // rectangle
+                return 2 + (textured ? 1 : 0) + (((opcode >> 3) & 3) == 0 ? 1 : 0);
+        }
+        return 0;
+    }
+};
+
+constexpr auto c_primitiveWords = generateTable<256, PrimitiveWordsGenerator>();
+
+static_assert(c_primitiveWords[0x20] == 4);
+static_assert(c_primitiveWords[0x3c] == 12);
+static_assert(c_primitiveWords[0x48] == 0);
+static_assert(c_primitiveWords[0x50] == 4);
+static_assert(c_primitiveWords[0x64] == 4);
+static_assert(c_primitiveWords[0x78] == 2);
+
 GPU::Poly<GPU::Shading::Flat, GPU::Shape::Tri, GPU::Textured::No, GPU::Blend::Off, GPU::Modulation::On> s_poly00;
 GPU::Poly<GPU::Shading::Flat, GPU::Shape::Tri, GPU::Textured::No, GPU::Blend::Off, GPU::Modulation::Off> s_poly01;
 GPU::Poly<GPU::Shading::Flat, GPU::Shape::Tri, GPU::Textured::No, GPU::Blend::Semi, GPU::Modulation::On> s_poly02;
@@ -309,110 +448,110 @@ GPU::Rect<GPU::Size::S16, GPU::Textured::Yes, GPU::Blend::Semi, GPU::Modulation:
 }  // namespace PCSX
 
 PCSX::GPU::GPU() {
-    m_polygons[0x00] = &s_poly00;
-    m_polygons[0x01] = &s_poly01;
-    m_polygons[0x02] = &s_poly02;
-    m_polygons[0x03] = &s_poly03;
-    m_polygons[0x04] = &s_poly04;
-    m_polygons[0x05] = &s_poly05;
-    m_polygons[0x06] = &s_poly06;
-    m_polygons[0x07] = &s_poly07;
-    m_polygons[0x08] = &s_poly08;
-    m_polygons[0x09] = &s_poly09;
-    m_polygons[0x0a] = &s_poly0a;
-    m_polygons[0x0b] = &s_poly0b;
-    m_polygons[0x0c] = &s_poly0c;
-    m_polygons[0x0d] = &s_poly0d;
-    m_polygons[0x0e] = &s_poly0e;
-    m_polygons[0x0f] = &s_poly0f;
-    m_polygons[0x10] = &s_poly10;
-    m_polygons[0x11] = &s_poly11;
-    m_polygons[0x12] = &s_poly12;
-    m_polygons[0x13] = &s_poly13;
-    m_polygons[0x14] = &s_poly14;
-    m_polygons[0x15] = &s_poly15;
-    m_polygons[0x16] = &s_poly16;
-    m_polygons[0x17] = &s_poly17;
-    m_polygons[0x18] = &s_poly18;
-    m_polygons[0x19] = &s_poly19;
-    m_polygons[0x1a] = &s_poly1a;
-    m_polygons[0x1b] = &s_poly1b;
-    m_polygons[0x1c] = &s_poly1c;
-    m_polygons[0x1d] = &s_poly1d;
-    m_polygons[0x1e] = &s_poly1e;
-    m_polygons[0x1f] = &s_poly1f;
-
-    m_lines[0x00] = &s_line0;
-    m_lines[0x01] = &s_line0;
-    m_lines[0x02] = &s_line1;
-    m_lines[0x03] = &s_line1;
-    m_lines[0x04] = &s_line0;
-    m_lines[0x05] = &s_line0;
-    m_lines[0x06] = &s_line1;
-    m_lines[0x07] = &s_line1;
-    m_lines[0x08] = &s_line2;
-    m_lines[0x09] = &s_line2;
-    m_lines[0x0a] = &s_line3;
-    m_lines[0x0b] = &s_line3;
-    m_lines[0x0c] = &s_line2;
-    m_lines[0x0d] = &s_line2;
-    m_lines[0x0e] = &s_line3;
-    m_lines[0x0f] = &s_line3;
-    m_lines[0x10] = &s_line4;
-    m_lines[0x11] = &s_line4;
-    m_lines[0x12] = &s_line5;
-    m_lines[0x13] = &s_line5;
-    m_lines[0x14] = &s_line4;
-    m_lines[0x15] = &s_line4;
-    m_lines[0x16] = &s_line5;
-    m_lines[0x17] = &s_line5;
-    m_lines[0x18] = &s_line6;
-    m_lines[0x19] = &s_line6;
-    m_lines[0x1a] = &s_line7;
-    m_lines[0x1b] = &s_line7;
-    m_lines[0x1c] = &s_line6;
-    m_lines[0x1d] = &s_line6;
-    m_lines[0x1e] = &s_line7;
-    m_lines[0x1f] = &s_line7;
-
-    m_rects[0x00] = &s_rect00;
-    m_rects[0x01] = &s_rect01;
-    m_rects[0x02] = &s_rect02;
-    m_rects[0x03] = &s_rect03;
-    m_rects[0x04] = &s_rect04;
-    m_rects[0x05] = &s_rect05;
-    m_rects[0x06] = &s_rect06;
-    m_rects[0x07] = &s_rect07;
-    m_rects[0x08] = &s_rect08;
-    m_rects[0x09] = &s_rect09;
-    m_rects[0x0a] = &s_rect0a;
-    m_rects[0x0b] = &s_rect0b;
-    m_rects[0x0c] = &s_rect0c;
-    m_rects[0x0d] = &s_rect0d;
-    m_rects[0x0e] = &s_rect0e;
-    m_rects[0x0f] = &s_rect0f;
-    m_rects[0x10] = &s_rect10;
-    m_rects[0x11] = &s_rect11;
-    m_rects[0x12] = &s_rect12;
-    m_rects[0x13] = &s_rect13;
-    m_rects[0x14] = &s_rect14;
-    m_rects[0x15] = &s_rect15;
-    m_rects[0x16] = &s_rect16;
-    m_rects[0x17] = &s_rect17;
-    m_rects[0x18] = &s_rect18;
-    m_rects[0x19] = &s_rect19;
-    m_rects[0x1a] = &s_rect1a;
-    m_rects[0x1b] = &s_rect1b;
-    m_rects[0x1c] = &s_rect1c;
-    m_rects[0x1d] = &s_rect1d;
-    m_rects[0x1e] = &s_rect1e;
-    m_rects[0x1f] = &s_rect1f;
+    m_primitives[0x20] = &s_poly00;
+    m_primitives[0x21] = &s_poly01;
+    m_primitives[0x22] = &s_poly02;
+    m_primitives[0x23] = &s_poly03;
+    m_primitives[0x24] = &s_poly04;
+    m_primitives[0x25] = &s_poly05;
+    m_primitives[0x26] = &s_poly06;
+    m_primitives[0x27] = &s_poly07;
+    m_primitives[0x28] = &s_poly08;
+    m_primitives[0x29] = &s_poly09;
+    m_primitives[0x2a] = &s_poly0a;
+    m_primitives[0x2b] = &s_poly0b;
+    m_primitives[0x2c] = &s_poly0c;
+    m_primitives[0x2d] = &s_poly0d;
+    m_primitives[0x2e] = &s_poly0e;
+    m_primitives[0x2f] = &s_poly0f;
+    m_primitives[0x30] = &s_poly10;
+    m_primitives[0x31] = &s_poly11;
+    m_primitives[0x32] = &s_poly12;
+    m_primitives[0x33] = &s_poly13;
+    m_primitives[0x34] = &s_poly14;
+    m_primitives[0x35] = &s_poly15;
+    m_primitives[0x36] = &s_poly16;
+    m_primitives[0x37] = &s_poly17;
+    m_primitives[0x38] = &s_poly18;
+    m_primitives[0x39] = &s_poly19;
+    m_primitives[0x3a] = &s_poly1a;
+    m_primitives[0x3b] = &s_poly1b;
+    m_primitives[0x3c] = &s_poly1c;
+    m_primitives[0x3d] = &s_poly1d;
+    m_primitives[0x3e] = &s_poly1e;
+    m_primitives[0x3f] = &s_poly1f;
+
+    m_primitives[0x40] = &s_line0;
+    m_primitives[0x41] = &s_line0;
+    m_primitives[0x42] = &s_line1;
+    m_primitives[0x43] = &s_line1;
+    m_primitives[0x44] = &s_line0;
+    m_primitives[0x45] = &s_line0;
+    m_primitives[0x46] = &s_line1;
+    m_primitives[0x47] = &s_line1;
+    m_primitives[0x48] = &s_line2;
+    m_primitives[0x49] = &s_line2;
+    m_primitives[0x4a] = &s_line3;
+    m_primitives[0x4b] = &s_line3;
+    m_primitives[0x4c] = &s_line2;
+    m_primitives[0x4d] = &s_line2;
+    m_primitives[0x4e] = &s_line3;
+    m_primitives[0x4f] = &s_line3;
+    m_primitives[0x50] = &s_line4;
+    m_primitives[0x51] = &s_line4;
+    m_primitives[0x52] = &s_line5;
+    m_primitives[0x53] = &s_line5;
+    m_primitives[0x54] = &s_line4;
+    m_primitives[0x55] = &s_line4;
+    m_primitives[0x56] = &s_line5;
+    m_primitives[0x57] = &s_line5;
+    m_primitives[0x58] = &s_line6;
+    m_primitives[0x59] = &s_line6;
+    m_primitives[0x5a] = &s_line7;
+    m_primitives[0x5b] = &s_line7;
+    m_primitives[0x5c] = &s_line6;
+    m_primitives[0x5d] = &s_line6;
+    m_primitives[0x5e] = &s_line7;
+    m_primitives[0x5f] = &s_line7;
+
+    m_primitives[0x60] = &s_rect00;
+    m_primitives[0x61] = &s_rect01;
+    m_primitives[0x62] = &s_rect02;
+    m_primitives[0x63] = &s_rect03;
+    m_primitives[0x64] = &s_rect04;
+    m_primitives[0x65] = &s_rect05;
+    m_primitives[0x66] = &s_rect06;
+    m_primitives[0x67] = &s_rect07;
+    m_primitives[0x68] = &s_rect08;
+    m_primitives[0x69] = &s_rect09;
+    m_primitives[0x6a] = &s_rect0a;
+    m_primitives[0x6b] = &s_rect0b;
+    m_primitives[0x6c] = &s_rect0c;
+    m_primitives[0x6d] = &s_rect0d;
+    m_primitives[0x6e] = &s_rect0e;
+    m_primitives[0x6f] = &s_rect0f;
+    m_primitives[0x70] = &s_rect10;
+    m_primitives[0x71] = &s_rect11;
+    m_primitives[0x72] = &s_rect12;
+    m_primitives[0x73] = &s_rect13;
+    m_primitives[0x74] = &s_rect14;
+    m_primitives[0x75] = &s_rect15;
+    m_primitives[0x76] = &s_rect16;
+    m_primitives[0x77] = &s_rect17;
+    m_primitives[0x78] = &s_rect18;
+    m_primitives[0x79] = &s_rect19;
+    m_primitives[0x7a] = &s_rect1a;
+    m_primitives[0x7b] = &s_rect1b;
+    m_primitives[0x7c] = &s_rect1c;
+    m_primitives[0x7d] = &s_rect1d;
+    m_primitives[0x7e] = &s_rect1e;
+    m_primitives[0x7f] = &s_rect1f;
 }
 
 int PCSX::GPU::init(UI *ui) {
-    for (auto poly : m_polygons) poly->setGPU(this);
-    for (auto line : m_lines) line->setGPU(this);
-    for (auto rect : m_rects) rect->setGPU(this);
+    for (auto primitive : m_primitives) {
+        if (primitive) primitive->setGPU(this);
+    }
     m_textureWindowRaw = 0;
     m_drawingStartRaw = 0;
     m_drawingEndRaw = 0;
@@ -436,57 +575,8 @@ inline bool PCSX::GPU::CheckForEndlessLoop(uint32_t laddr) {
     return false;
 }
 
-uint32_t PCSX::GPU::gpuDmaChainSize(uint32_t addr) {
-    uint32_t size;
-    uint32_t DMACommandCounter = 0;
-    bool usingMsan = g_emulator->m_mem->msanInitialized();
-
-    s_usedAddr[0] = s_usedAddr[1] = s_usedAddr[2] = 0xffffff;
-
-    // initial linked list s_ptr (word)
-    size = 1;
-
-    do {
-        uint32_t header;
-        if (usingMsan && PCSX::Memory::inMsanRange(addr)) {
-            addr &= 0xfffffffc;
-            switch (g_emulator->m_mem->msanGetStatus<4>(addr)) {
-                case PCSX::MsanStatus::UNINITIALIZED:
-                    g_system->log(LogClass::GPU, _("GPU DMA went into usable but uninitialized msan memory: %8.8lx\n"),
-                                  addr);
-                    g_system->pause();
-                    return size;
-                case PCSX::MsanStatus::UNUSABLE:
-                    g_system->log(LogClass::GPU, _("GPU DMA went into unusable msan memory: %8.8lx\n"), addr);
-                    g_system->pause();
-                    return size;
-                case PCSX::MsanStatus::OK:
-                    header = *(uint32_t *)(g_emulator->m_mem->m_msanRAM + (addr - PCSX::Memory::c_msanStart));
-                    break;
-            }
-        } else {
-            addr &= g_emulator->getRamMask<4>();
-            header = SWAP_LEu32(*g_emulator->m_mem->getPointer<uint32_t>(addr));
-        }
-
-        if (DMACommandCounter++ > 2000000) break;
-        if (CheckForEndlessLoop(addr)) break;
-
-        // # 32-bit blocks to transfer
-        size += (header >> 24) + 1;
-
-        // next 32-bit pointer
-        uint32_t nextAddr = header & 0xffffff;
-        if (usingMsan && nextAddr == PCSX::Memory::c_msanChainMarker) {
-            addr = g_emulator->m_mem->msanGetChainPtr(addr);
-            continue;
-        }
-        addr = nextAddr;
-    } while (!(addr & 0x800000));  // contrary to some documentation, the end-of-linked-list marker is not actually
-    return size;  // 0xFF'FFFF any pointer with bit 23 set will do.
-}
-
 uint32_t PCSX::GPU::readStatus() {
+    syncCommands();
     uint32_t ret = readStatusInternal();  // Get status from GPU core
 
 // Gameshark Lite - wants to see VRAM busy
@@ -516,6 +606,7 @@ void PCSX::GPU::dma(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // GPU
             size = (bcr >> 16) * (bcr & 0xffff);
             directDMARead(ptr, size, madr);
             g_emulator->m_cpu->Clear(madr, size);
+            g_emulator->m_mem->markDirtyRange(madr, size * 4);
             g_emulator->m_mem->msanDmaWrite(madr, size * 4);
             if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
                 g_emulator->m_debug->checkDMAwrite(2, madr, size * 4);
@@ -558,8 +649,7 @@ void PCSX::GPU::dma(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // GPU
         case 0x01000401:  // dma chain
             PSXDMA_LOG("*** DMA 2 - GPU dma chain *** %8.8lx addr = %lx size = %lx\n", chcr, madr, bcr);
 
-            size = gpuDmaChainSize(madr);
-            chainedDMAWrite((uint32_t *)PCSX::g_emulator->m_mem->m_wram, madr);
+            size = chainedDMAWrite((uint32_t *)PCSX::g_emulator->m_mem->m_wram, madr);
 
             // Tekken 3 = use 1.0 only (not 1.5x)
 
@@ -578,6 +668,12 @@ void PCSX::GPU::dma(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // GPU
     gpuInterrupt();
 }
 
+void PCSX::GPU::pgxpCacheVertex(short sx, short sy, const unsigned char *_pVertex) {
+    if (!_pVertex) return;
+    const auto value = reinterpret_cast<const PGXP_value *>(_pVertex);
+    m_pgxpVertexCache.insert(sx, sy, {value->x, value->y, value->z});
+}
+
 void PCSX::GPU::gpuInterrupt() {
     auto &mem = g_emulator->m_mem;
     mem->clearDMABusy<2>();
@@ -585,6 +681,10 @@ void PCSX::GPU::gpuInterrupt() {
 }
 
 void PCSX::GPU::writeStatus(uint32_t value) {
+    // The control commands are few and far between, and some of them touch the display or the IRQ
+    // state on the backend side, so they are always run synchronously.
+    syncCommands();
+    g_emulator->m_gpuLogger->addRaw(Logged::Origin::CTRLWRITE, value, &value, 1);
     uint32_t cmd = (value >> 24) & 0xff;
     bool gotUnknown = false;
 
@@ -593,6 +693,7 @@ void PCSX::GPU::writeStatus(uint32_t value) {
     switch (cmd) {
         case 0: {
             m_readFifo->reset();
+            m_readbackPending = false;
             m_processor->reset();
             m_defaultProcessor.setActive();
             CtrlReset ctrl;
@@ -660,10 +761,14 @@ void PCSX::GPU::writeStatus(uint32_t value) {
 }
 
 uint32_t PCSX::GPU::readData() {
+    syncCommands();
     if (m_readFifo->size() == 0) {
+        m_readbackPending = false;
         return m_dataRet;
     }
-    return m_readFifo.asA<File>()->read<uint32_t>();
+    uint32_t ret = m_readFifo.asA<File>()->read<uint32_t>();
+    m_readbackPending = m_readFifo->size() != 0;
+    return ret;
 }
 
 void PCSX::GPU::write1(CtrlQuery *ctrl) {
@@ -684,20 +789,128 @@ void PCSX::GPU::write1(CtrlQuery *ctrl) {
 }
 
 void PCSX::GPU::writeData(uint32_t value) {
+    commitVRAM();
+    const uint32_t word = SWAP_LE32(value);
+    if (queueCommands(&word, 1, Logged::Origin::DATAWRITE, value, 1)) return;
+    g_emulator->m_gpuLogger->addRaw(Logged::Origin::DATAWRITE, value, &word, 1);
     Buffer buf(value);
     m_processor->processWrite(buf, Logged::Origin::DATAWRITE, value, 1);
 }
 
 void PCSX::GPU::directDMAWrite(const uint32_t *feed, int transferSize, uint32_t hwAddr) {
+    commitVRAM();
+    if (queueCommands(feed, transferSize, Logged::Origin::DIRECT_DMA, hwAddr, transferSize)) return;
+    g_emulator->m_gpuLogger->addRaw(Logged::Origin::DIRECT_DMA, hwAddr, feed, transferSize);
     Buffer buf(feed, transferSize);
     while (!buf.isEmpty()) {
         m_processor->processWrite(buf, Logged::Origin::DIRECT_DMA, hwAddr, transferSize);
     }
 }
 
+void PCSX::GPU::replayCommands(const uint32_t *words, size_t count, Logged::Origin origin, uint32_t value) {
+    syncCommands();
+    commitVRAM();
+    Buffer buf(words, count);
+    while (!buf.isEmpty()) {
+        m_processor->processWrite(buf, origin, value, count);
+    }
+}
+
+void PCSX::GPU::getEnvironment(std::vector<uint32_t> &control, std::vector<uint32_t> &data) {
+    // Same order as when loading a save state, leaving out the reset, acknowledge and DMA commands, as well
+    // as the ones which never got written, and would otherwise play back as a reset.
+    for (unsigned cmd : {8, 6, 7, 5, 4, 3}) {
+        if ((m_statusControl[cmd] >> 24) == cmd) control.push_back(m_statusControl[cmd]);
+    }
+    const uint32_t status = readStatus();
+    data.push_back(0xe1000000 | (m_lastTPage.raw & 0xffffff));
+    data.push_back(0xe2000000 | m_textureWindowRaw);
+    data.push_back(0xe3000000 | m_drawingStartRaw);
+    data.push_back(0xe4000000 | m_drawingEndRaw);
+    data.push_back(0xe5000000 | m_drawingOffsetRaw);
+    data.push_back(0xe6000000 | ((status >> 11) & 3));
+}
+
+void PCSX::GPU::resetFrameSkip() {
+    m_skipFrame = false;
+    m_displayFrames = 0;
+    m_displayTiles[0].clear();
+    m_displayTiles[1].clear();
+    m_skippableTiles.clear();
+    m_skippedTiles.clear();
+    m_readbackTiles.clear();
+}
+
+void PCSX::GPU::beginFrame(bool skip) {
+    // The command thread looks at the skipping state while parsing, so it needs to catch up first.
+    syncCommands();
+    int x = 0, y = 0, w = 320, h = 240;
+    if ((m_statusControl[5] >> 24) == 5) {
+        x = m_statusControl[5] & 0x3ff;
+        y = (m_statusControl[5] >> 10) & 0x1ff;
+    }
+    if ((m_statusControl[8] >> 24) == 8) {
+        const uint32_t mode = m_statusControl[8];
+        static constexpr int widths[4] = {256, 320, 512, 640};
+        w = (mode & 0x40) ? 368 : widths[mode & 3];
+        h = ((mode & 0x24) == 0x24) ? 480 : 240;
+    }
+    if ((m_displayFrames++ % c_displayWindow) == 0) {
+        std::swap(m_displayTiles[0], m_displayTiles[1]);
+        m_displayTiles[0].clear();
+    }
+    m_displayTiles[0].mark(x, y, w, h);
+    m_skippableTiles = m_displayTiles[0];
+    m_skippableTiles |= m_displayTiles[1];
+    m_skippableTiles.remove(m_readbackTiles);
+    m_skipFrame = skip;
+}
+
+bool PCSX::GPU::skipDraw(int x, int y, int w, int h) {
+    if (!m_skipFrame) return false;
+    const int left = std::max(x, int(m_drawingStartRaw & 0x3ff));
+    const int top = std::max(y, int((m_drawingStartRaw >> 10) & 0x1ff));
+    const int right = std::min(x + w - 1, int(m_drawingEndRaw & 0x3ff));
+    const int bottom = std::min(y + h - 1, int((m_drawingEndRaw >> 10) & 0x1ff));
+    // Nothing gets drawn anyway, and the backend already knows how to do nothing.
+    if ((left > right) || (top > bottom)) return false;
+    if (!m_skippableTiles.covers(left, top, right - left + 1, bottom - top + 1)) return false;
+    m_skippedTiles.mark(left, top, right - left + 1, bottom - top + 1);
+    return true;
+}
+
+bool PCSX::GPU::skipDraw(const int *x, const int *y, size_t count, int offsetX, int offsetY) {
+    if (!m_skipFrame || (count == 0)) return false;
+    const auto [left, right] = std::minmax_element(x, x + count);
+    const auto [top, bottom] = std::minmax_element(y, y + count);
+    return skipDraw(*left + offsetX, *top + offsetY, *right - *left + 1, *bottom - *top + 1);
+}
+
+void PCSX::GPU::markVRAMRead(int x, int y, int w, int h) {
+    if (!m_skippableTiles.intersects(x, y, w, h)) return;
+    if (m_skippedTiles.intersects(x, y, w, h)) {
+        g_system->log(LogClass::GPU, "Frame skip: VRAM read back from %i, %i (%ix%i) after skipping drawing there\n", x,
+                      y, w, h);
+    }
+    m_readbackTiles.mark(x, y, w, h);
+    m_skippableTiles.remove(m_readbackTiles);
+}
+
+void PCSX::GPU::ScreenShot::toRGBA(uint8_t *dst) const {
+    auto &kernels = PixelKernels::getKernels();
+    const unsigned count = width * height;
+    if (bpp == BPP_16) {
+        kernels.rgb15(reinterpret_cast<const uint16_t *>(data.data()), dst, count);
+    } else {
+        kernels.rgb24(reinterpret_cast<const uint8_t *>(data.data()), dst, count);
+    }
+}
+
 void PCSX::GPU::directDMARead(uint32_t *dest, int transferSize, uint32_t hwAddr) {
+    syncCommands();
     auto size = m_readFifo->size();
     m_readFifo->read(dest, transferSize * 4);
+    m_readbackPending = m_readFifo->size() != 0;
     transferSize -= size / 4;
     dest += size / 4;
     while (transferSize != 0) {
@@ -705,13 +918,24 @@ void PCSX::GPU::directDMARead(uint32_t *dest, int transferSize, uint32_t hwAddr)
     }
 }
 
-void PCSX::GPU::chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr) {
+static inline void prefetchChainNode(const void *ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr);
+#endif
+}
+
+uint32_t PCSX::GPU::chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr) {
+    commitVRAM();
     uint32_t addr = hwAddr;
-    uint32_t DMACommandCounter = 0;
     bool usingMsan = g_emulator->m_mem->msanInitialized();
+    const uint32_t ramMask = g_emulator->getRamMask<4>();
+    DMAChainStats stats;
 
     s_usedAddr[0] = s_usedAddr[1] = s_usedAddr[2] = 0xffffff;
 
+    // initial linked list pointer (word)
+    uint32_t size = 1;
+
     do {
         uint32_t header;
         const uint32_t *feed;
@@ -723,41 +947,169 @@ void PCSX::GPU::chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr) {
                     g_system->log(LogClass::GPU, _("GPU DMA went into usable but uninitialized msan memory: %8.8lx\n"),
                                   addr);
                     g_system->pause();
-                    return;
+                    stats.aborted = true;
+                    m_lastDMAChainStats = stats;
+                    return size;
                 case PCSX::MsanStatus::UNUSABLE:
                     g_system->log(LogClass::GPU, _("GPU DMA went into unusable msan memory: %8.8lx\n"), addr);
                     g_system->pause();
-                    return;
+                    stats.aborted = true;
+                    m_lastDMAChainStats = stats;
+                    return size;
                 case PCSX::MsanStatus::OK:
                     break;
             }
             header = *headerPtr;
             feed = headerPtr + 1;
+            // The packet itself has to be valid as well, and gets checked at once.
+            if (const uint32_t packetSize = (header >> 24) * 4) {
+                if (!PCSX::Memory::inMsanRange(addr + packetSize) ||
+                    (g_emulator->m_mem->msanGetRangeStatus(addr + 4, packetSize) != PCSX::MsanStatus::OK)) {
+                    g_system->log(LogClass::GPU, _("GPU DMA packet went into invalid msan memory: %8.8lx\n"), addr);
+                    g_system->pause();
+                    stats.aborted = true;
+                    m_lastDMAChainStats = stats;
+                    return size;
+                }
+            }
         } else {
-            addr &= g_emulator->getRamMask<4>();
-            header = memory[addr / 4];
+            addr &= ramMask;
+            header = SWAP_LEu32(memory[addr / 4]);
             feed = memory + addr / 4 + 1;
         }
 
-        if (DMACommandCounter++ > 2000000) break;
-        if (CheckForEndlessLoop(addr)) break;
+        if ((stats.nodes++ > 2000000) || CheckForEndlessLoop(addr)) {
+            stats.aborted = true;
+            break;
+        }
+
+        // next 32-bit pointer
+        uint32_t nextAddr = header & 0xffffff;
+        // Ordering tables are scattered all over RAM, so start pulling the next header in while
+        // this packet gets parsed.
+        if (!(nextAddr & 0x800000)) prefetchChainNode(memory + (nextAddr & ramMask) / 4);
 
         // # 32-bit blocks to transfer
         uint32_t transferWords = header >> 24;
-        Buffer buf(feed, transferWords);
-        while (!buf.isEmpty()) {
-            m_processor->processWrite(buf, Logged::Origin::CHAIN_DMA, addr, transferWords);
+        size += transferWords + 1;
+        if (transferWords == 0) {
+            stats.emptyNodes++;
+        } else if (!queueCommands(feed, transferWords, Logged::Origin::CHAIN_DMA, addr, transferWords)) {
+            g_emulator->m_gpuLogger->addRaw(Logged::Origin::CHAIN_DMA, addr, feed, transferWords);
+            Buffer buf(std::span<const uint32_t>(feed, transferWords));
+            while (!buf.isEmpty()) {
+                m_processor->processWrite(buf, Logged::Origin::CHAIN_DMA, addr, transferWords);
+            }
         }
+        stats.words += transferWords;
 
-        // next 32-bit pointer
-        uint32_t nextAddr = header & 0xffffff;
         if (usingMsan && nextAddr == PCSX::Memory::c_msanChainMarker) {
+            stats.msanJumps++;
             addr = g_emulator->m_mem->msanGetChainPtr(addr);
             continue;
         }
         addr = nextAddr;
     } while (!(addr & 0x800000));  // contrary to some documentation, the end-of-linked-list marker is not actually
-}  // 0xFF'FFFF any pointer with bit 23 set will do.
+                                   // 0xFF'FFFF any pointer with bit 23 set will do.
+
+    PSXDMA_LOG("*** DMA 2 - GPU dma chain *** %u nodes (%u empty), %u words%s\n", stats.nodes, stats.emptyNodes,
+               stats.words, stats.aborted ? ", aborted" : "");
+    m_lastDMAChainStats = stats;
+    return size;
+}
+
+void PCSX::GPU::startCommandThread() {
+    if (m_commandThread.joinable() || !supportsCommandThread()) return;
+    m_commandRing = std::make_unique<CommandRing>();
+    m_commandThread = std::thread([this, emulator = g_emulator, system = g_system]() {
+        Emulator::Scope scope(emulator, system);
+        commandThreadMain();
+    });
+}
+
+void PCSX::GPU::stopCommandThread() {
+    if (!m_commandThread.joinable()) return;
+    // The exit packet goes through the ring like anything else, so what's queued before it still gets processed
+    const uint32_t header[3] = {COMMAND_PACKET_EXIT << 28, 0, 0};
+    m_commandRing->waitForSpace(3);
+    m_commandRing->write(header, 3);
+    m_commandRing->commit(3);
+    m_commandThread.join();
+    m_commandRing.reset();
+}
+
+void PCSX::GPU::syncCommands() {
+    commitVRAM();
+    if (!m_commandThread.joinable()) return;
+    // The backend calls this from the functions the commands themselves use, such as partialUpdateVRAM
+    if (std::this_thread::get_id() == m_commandThread.get_id()) return;
+    m_commandRing->waitForEmpty();
+}
+
+void PCSX::GPU::flushPendingVRAM() {
+    // Taken out first, since the backends sync, and therefore commit, from partialUpdateVRAM.
+    auto vram = std::move(m_pendingVRAM);
+    partialUpdateVRAM(0, 0, 1024, 512, reinterpret_cast<const uint16_t *>(vram.get()));
+}
+
+bool PCSX::GPU::queueCommands(const uint32_t *words, size_t count, Logged::Origin origin, uint32_t value,
+                              uint32_t length) {
+    if (!m_commandThread.joinable()) return false;
+    // The logger draws its heatmaps using OpenGL, so it needs to run on the main thread.
+    if (m_readbackPending || g_emulator->m_gpuLogger->isEnabled()) {
+        syncCommands();
+        return false;
+    }
+
+    // The words are copied into the ring, so that the CPU is free to modify the memory they came from as soon
+    // as we return, same as with the real DMA.
+    while (count != 0) {
+        const size_t chunk = std::min(count, c_maxCommandPacket);
+        const uint32_t header[3] = {
+            (COMMAND_PACKET_GP0 << 28) | (magic_enum::enum_integer(origin) << 24) | uint32_t(chunk), value, length};
+        m_commandRing->waitForSpace(chunk + 3);
+        m_commandRing->write(header, 3);
+        m_commandRing->write(words, chunk, 3);
+        m_commandRing->commit(chunk + 3);
+        words += chunk;
+        count -= chunk;
+    }
+    return true;
+}
+
+void PCSX::GPU::commandThreadMain() {
+    auto &ring = *m_commandRing;
+    while (true) {
+        ring.waitForData();
+        uint32_t header[3];
+        ring.read(header, 3);
+        if ((header[0] >> 28) == COMMAND_PACKET_EXIT) {
+            ring.consume(3);
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const auto origin = static_cast<Logged::Origin>((header[0] >> 24) & 0x0f);
+        size_t count = header[0] & 0xffffff;
+        size_t offset = 3;
+        // The packet may wrap around the end of the ring, but the commands are all able to resume
+        // processing from one buffer to the next, same as when the CPU writes them one word at a time.
+        while (count != 0) {
+            auto span = ring.peek(offset);
+            const size_t chunk = std::min(count, span.size());
+            Buffer buf(span.first(chunk));
+            while (!buf.isEmpty()) {
+                m_processor->processWrite(buf, origin, header[1], header[2]);
+            }
+            offset += chunk;
+            count -= chunk;
+        }
+        // Only consuming the packet once it's been processed is what lets syncCommands simply wait for the ring
+        // to be empty.
+        ring.consume(offset);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        g_emulator->m_frameStats->addRasterizer(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+}
 
 void PCSX::GPU::Command::processWrite(Buffer &buf, Logged::Origin origin, uint32_t originValue, uint32_t length) {
     while (!buf.isEmpty()) {
@@ -786,20 +1138,21 @@ void PCSX::GPU::Command::processWrite(Buffer &buf, Logged::Origin origin, uint32
                     } break;
                 }
                 break;
-            case 1: {  // Polygon primitive
-                buf.rewind();
-                m_gpu->m_polygons[command]->setActive();
-                m_gpu->m_processor->processWrite(buf, origin, originValue, length);
-            } break;
-            case 2: {  // Line primitive
-                buf.rewind();
-                m_gpu->m_lines[command]->setActive();
-                m_gpu->m_processor->processWrite(buf, origin, originValue, length);
-            } break;
+            case 1:    // Polygon primitive
+            case 2:    // Line primitive
             case 3: {  // Rectangle primitive
+                const uint8_t opcode = value >> 24;
+                Command *primitive = m_gpu->m_primitives[opcode];
+                const unsigned words = c_primitiveWords[opcode];
                 buf.rewind();
-                m_gpu->m_rects[command]->setActive();
-                m_gpu->m_processor->processWrite(buf, origin, originValue, length);
+                if ((words != 0) && (buf.size() >= words)) {
+                    // The whole packet is already there, so it can be parsed in one go.
+                    primitive->processPacket(buf.data(), origin, originValue, length);
+                    buf.consume(words);
+                } else {
+                    primitive->setActive();
+                    m_gpu->m_processor->processWrite(buf, origin, originValue, length);
+                }
             } break;
             case 4: {  // Move data in VRAM
                 m_gpu->m_blitVramVram.setActive();
@@ -933,6 +1286,7 @@ void PCSX::GPU::BlitVramVram::processWrite(Buffer &buf, Logged::Origin origin, u
             m_state = READ_COMMAND;
             m_gpu->m_defaultProcessor.setActive();
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+            m_gpu->markVRAMRead(sX, sY, w, h);
             m_gpu->write0(this);
             return;
     }
@@ -974,10 +1328,9 @@ void PCSX::GPU::BlitRamVram::processWrite(Buffer &buf, Logged::Origin origin, ui
                 m_data.append(reinterpret_cast<const char *>(buf.data()), toConsume * 4);
                 done = m_data.size() == size * 4;
                 buf.consume(toConsume);
-                if (done) {
-                    data.acquire(std::move(m_data));
-                    m_data.clear();
-                }
+                // Borrowing keeps the reassembly buffer's capacity around for the next blit, instead of
+                // reallocating it every time. It doesn't get touched again until the next blit starts.
+                if (done) data.borrow(m_data.data(), m_data.size());
             }
             break;
     }
@@ -1023,7 +1376,8 @@ void PCSX::GPU::BlitVramRam::processWrite(Buffer &buf, Logged::Origin origin, ui
             m_state = READ_COMMAND;
             m_gpu->m_defaultProcessor.setActive();
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
-            m_gpu->m_vramReadSlice = m_gpu->getVRAM();
+            m_gpu->markVRAMRead(x, y, w, h);
+            m_gpu->m_vramReadSlice = m_gpu->getVRAMRegion(x, y, w, h);
             for (auto l = y; l < y + h; l++) {
                 Slice slice;
                 slice.borrow(m_gpu->m_vramReadSlice, (l * 1024 + x) * 2, w * 2);
@@ -21,17 +21,22 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <filesystem>
 #include <functional>
 #include <magic_enum_all.hpp>
 #include <memory>
 #include <ostream>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
@@ -41,6 +46,7 @@
 #include "support/opengl.h"
 #include "support/polyfills.h"
 #include "support/slice.h"
+#include "support/spsc.h"
 
 namespace PCSX {
 class UI;
@@ -77,7 +83,6 @@ class GPU {
   private:
     uint32_t s_usedAddr[3];
     bool CheckForEndlessLoop(uint32_t laddr);
-    uint32_t gpuDmaChainSize(uint32_t addr);
     virtual void resetBackend() = 0;
 
   public:
@@ -90,10 +95,38 @@ class GPU {
     void writeData(uint32_t gdata);
     void directDMAWrite(const uint32_t *feed, int transferSize, uint32_t hwAddr);
     void directDMARead(uint32_t *dest, int transferSize, uint32_t hwAddr);
-    void chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr);
+    // Walks the linked list and sends its packets to the command parser in a single pass. Returns the number
+    // of words in the chain, headers included, which is what the DMA timing is based on.
+    uint32_t chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr);
+
+    struct DMAChainStats {
+        unsigned nodes = 0;
+        unsigned emptyNodes = 0;
+        unsigned words = 0;
+        unsigned msanJumps = 0;
+        // Set when the walk stopped on a loop, or on a msan error
+        bool aborted = false;
+    };
+    const DMAChainStats &getLastDMAChainStats() const { return m_lastDMAChainStats; }
     void writeStatus(uint32_t gdata);
     virtual void setOpenGLContext() {}
 
+    // GP0 writes can be handed over to a worker thread, for backends that don't need to draw from the main
+    // thread. Anything reading back from the GPU, or looking at its state or VRAM from another thread, needs
+    // to call syncCommands() first.
+    virtual bool supportsCommandThread() { return false; }
+    void startCommandThread();
+    void stopCommandThread();
+    void syncCommands();
+
+    // Loading a save state doesn't hand VRAM over to the backend right away, which for the OpenGL one means
+    // an upload to the host GPU. It only happens once something needs it: the next GP0 command or read back,
+    // the next vblank, or anything looking at VRAM from the outside. Backends call this from the functions
+    // reading or writing VRAM on behalf of others, and syncCommands() does too.
+    void commitVRAM() {
+        if (m_pendingVRAM) [[unlikely]] flushPendingVRAM();
+    }
+
     virtual void restoreStatus(uint32_t status) = 0;
 
     virtual void vblank(bool fromGui = false) = 0;
@@ -101,12 +134,14 @@ class GPU {
         throw std::runtime_error("Not yet implemented");
     }
     virtual void pgxpMemory(unsigned int addr, unsigned char *pVRAM) {}
-    virtual void pgxpCacheVertex(short sx, short sy, const unsigned char *_pVertex) {
-        throw std::runtime_error("Not yet implemented");
-    }
+    virtual void pgxpCacheVertex(short sx, short sy, const unsigned char *_pVertex);
 
     virtual void setDither(int setting) = 0;
     void reset() {
+        syncCommands();
+        m_readbackPending = false;
+        m_pgxpVertexCache.clear();
+        resetFrameSkip();
         resetBackend();
         m_dataRet = 0;
         m_readFifo->reset();
@@ -121,8 +156,175 @@ class GPU {
     static std::unique_ptr<GPU> getSoft();
     static std::unique_ptr<GPU> getOpenGL();
 
+    // Coarse map of which parts of VRAM changed, in tiles of 32x16 pixels, one bit each. Whoever keeps a copy
+    // of VRAM around, such as a display texture, registers one with addVRAMTracker, and then only needs to
+    // refresh the rectangles it reports before clearing it.
+    class VRAMDirtyTiles {
+      public:
+        static constexpr int c_tileWidth = 32;
+        static constexpr int c_tileHeight = 16;
+        static constexpr int c_columns = 1024 / c_tileWidth;
+        static constexpr int c_rows = 512 / c_tileHeight;
+
+        // Coordinates wrap around the edges of VRAM, the same way drawing does
+        void mark(int x, int y, int w, int h) {
+            forEachRow(x, y, w, h, [this](int row, uint32_t mask) { m_rows[row] |= mask; });
+        }
+        void markAll() { m_rows.fill(~0u); }
+        void clear() { m_rows.fill(0); }
+        bool empty() const {
+            for (auto row : m_rows) {
+                if (row) return false;
+            }
+            return true;
+        }
+        // Whether any of the tiles under the rectangle is marked
+        bool intersects(int x, int y, int w, int h) const {
+            bool ret = false;
+            forEachRow(x, y, w, h, [this, &ret](int row, uint32_t mask) { ret |= (m_rows[row] & mask) != 0; });
+            return ret;
+        }
+        // Whether all of the tiles under the rectangle are marked. Empty rectangles aren't covered.
+        bool covers(int x, int y, int w, int h) const {
+            if (w <= 0 || h <= 0) return false;
+            bool ret = true;
+            forEachRow(x, y, w, h, [this, &ret](int row, uint32_t mask) { ret &= (m_rows[row] & mask) == mask; });
+            return ret;
+        }
+        VRAMDirtyTiles &operator|=(const VRAMDirtyTiles &other) {
+            for (int row = 0; row < c_rows; row++) m_rows[row] |= other.m_rows[row];
+            return *this;
+        }
+        // Unmarks the tiles marked in the other tracker
+        void remove(const VRAMDirtyTiles &other) {
+            for (int row = 0; row < c_rows; row++) m_rows[row] &= ~other.m_rows[row];
+        }
+        // Calls f(x, y, w, h) with rectangles, in pixels, covering all the dirty tiles. Runs of tiles are merged
+        // horizontally first, then downwards as long as the rows below have the same run. The rectangles come
+        // out sorted by their top row.
+        template <typename F>
+        void forEachRect(F &&f) const {
+            auto rows = m_rows;
+            for (int row = 0; row < c_rows; row++) {
+                while (rows[row]) {
+                    const int start = std::countr_zero(rows[row]);
+                    const int length = std::countr_one(rows[row] >> start);
+                    const uint32_t mask = (length == 32 ? ~0u : (1u << length) - 1) << start;
+                    int end = row + 1;
+                    while (end < c_rows && (rows[end] & mask) == mask) rows[end++] &= ~mask;
+                    rows[row] &= ~mask;
+                    f(start * c_tileWidth, row * c_tileHeight, length * c_tileWidth, (end - row) * c_tileHeight);
+                }
+            }
+        }
+
+      private:
+        // Calls f(row, mask) for each row of tiles under the rectangle, with the mask of its columns
+        template <typename F>
+        static void forEachRow(int x, int y, int w, int h, F &&f) {
+            if (w <= 0 || h <= 0) return;
+            const int firstColumn = x >> 5;
+            const int columns = std::min(((x + std::min(w, 1024) - 1) >> 5) - firstColumn + 1, c_columns);
+            const uint32_t mask = columns == c_columns ? ~0u : std::rotl((1u << columns) - 1, firstColumn & 31);
+            const int firstRow = y >> 4;
+            const int rows = std::min(((y + std::min(h, 512) - 1) >> 4) - firstRow + 1, c_rows);
+            for (int i = 0; i < rows; i++) f((firstRow + i) & (c_rows - 1), mask);
+        }
+        std::array<uint32_t, c_rows> m_rows = {};
+    };
+    // The tracker starts out fully dirty, and needs to outlive the GPU object.
+    void addVRAMTracker(VRAMDirtyTiles *tracker) {
+        tracker->markAll();
+        m_vramTrackers.push_back(tracker);
+    }
+    void removeVRAMTracker(VRAMDirtyTiles *tracker) { std::erase(m_vramTrackers, tracker); }
+
+    // Frame skipping. Called on each vsync, with whether the frame about to start should be skipped. On skipped
+    // frames, the polygons, lines and rectangles landing entirely inside the areas recently shown on screen don't
+    // get rasterised. Everything else still runs: VRAM transfers, fills, and drawing anywhere else, which keeps
+    // render to texture working. The CPU reading back a part of the display areas, or copying it elsewhere in
+    // VRAM, makes any drawing there happen from then on, including on skipped frames.
+    void beginFrame(bool skip);
+    bool skippingFrame() const { return m_skipFrame; }
+
+    // Precise vertices out of the GTE, keyed by the screen coordinates it stored in SXY2, so that primitives can
+    // have their integer vertices matched back to them. Games usually send a frame's ordering table during the next
+    // one, so there are two open addressing tables: the current frame's, and the previous one's. Moving on to the
+    // next frame drops the older one by bumping its generation, without clearing anything. Coordinates that got
+    // different precise values within a frame are ambiguous, and don't match anything.
+    class PGXPVertexCache {
+      public:
+        struct Vertex {
+            float x, y, z;
+        };
+        PGXPVertexCache() : m_entries(new Entry[2 * c_size]()) {}
+        void newFrame() {
+            m_current ^= 1;
+            m_generations[m_current] = ++m_lastGeneration;
+            m_counts[m_current] = 0;
+        }
+        void clear() {
+            newFrame();
+            newFrame();
+        }
+        void insert(int16_t sx, int16_t sy, const Vertex &vertex) {
+            const uint32_t key = uint16_t(sx) | (uint32_t(uint16_t(sy)) << 16);
+            Entry *entries = &m_entries[m_current * c_size];
+            const uint32_t generation = m_generations[m_current];
+            for (uint32_t i = hash(key);; i = (i + 1) & (c_size - 1)) {
+                Entry &entry = entries[i];
+                if (entry.generation != generation) {
+                    // Past half full, probe sequences get long. Drop the vertex instead.
+                    if (m_counts[m_current] >= c_size / 2) return;
+                    m_counts[m_current]++;
+                    entry = {key, generation, false, vertex};
+                    return;
+                }
+                if (entry.key != key) continue;
+                if (entry.vertex.x != vertex.x || entry.vertex.y != vertex.y || entry.vertex.z != vertex.z) {
+                    entry.ambiguous = true;
+                }
+                return;
+            }
+        }
+        const Vertex *lookup(int16_t sx, int16_t sy) const {
+            const uint32_t key = uint16_t(sx) | (uint32_t(uint16_t(sy)) << 16);
+            const Vertex *found = find(m_current, key);
+            return found ? found : find(m_current ^ 1, key);
+        }
+
+      private:
+        static constexpr unsigned c_bits = 13;
+        static constexpr uint32_t c_size = 1 << c_bits;
+        struct Entry {
+            uint32_t key;
+            uint32_t generation;
+            bool ambiguous;
+            Vertex vertex;
+        };
+        static uint32_t hash(uint32_t key) { return (key * 0x9e3779b1u) >> (32 - c_bits); }
+        const Vertex *find(unsigned table, uint32_t key) const {
+            const Entry *entries = &m_entries[table * c_size];
+            const uint32_t generation = m_generations[table];
+            for (uint32_t i = hash(key);; i = (i + 1) & (c_size - 1)) {
+                const Entry &entry = entries[i];
+                if (entry.generation != generation) return nullptr;
+                if (entry.key == key) return entry.ambiguous ? nullptr : &entry.vertex;
+            }
+        }
+        std::unique_ptr<Entry[]> m_entries;
+        uint32_t m_generations[2] = {1, 2};
+        uint32_t m_counts[2] = {};
+        uint32_t m_lastGeneration = 2;
+        unsigned m_current = 1;
+    };
+    PGXPVertexCache &pgxpVertexCache() { return m_pgxpVertexCache; }
+
     enum class Ownership { BORROW, ACQUIRE };
     virtual Slice getVRAM(Ownership = Ownership::BORROW) = 0;
+    // Same layout as getVRAM, but only the given rectangle is guaranteed to be up to date. Backends keeping VRAM
+    // on the host GPU can use this to only read back what a VRAM to RAM blit needs.
+    virtual Slice getVRAMRegion(int x, int y, int w, int h) { return getVRAM(); }
     enum class PartialUpdateVram : bool { Synchronous, Asynchronous };
     virtual void partialUpdateVRAM(int x, int y, int w, int h, const uint16_t *pixels,
                                    PartialUpdateVram = PartialUpdateVram::Asynchronous) = 0;
@@ -131,8 +333,13 @@ class GPU {
         Slice data;
         uint16_t width, height;
         enum { BPP_16, BPP_24 } bpp;
+        // Converts the pixels to RGBA8888 into dst, which needs room for width * height * 4 bytes.
+        void toRGBA(uint8_t *dst) const;
     };
     virtual ScreenShot takeScreenShot() { throw std::runtime_error("Not yet implemented"); }
+    // The callback may be called later, from the main loop, once the screenshot data is available.
+    typedef std::function<void(ScreenShot &&)> ScreenShotCallback;
+    virtual void takeScreenShotAsync(ScreenShotCallback &&callback) { callback(takeScreenShot()); }
 
     struct GPUStats {
         unsigned triangles = 0;
@@ -175,6 +382,8 @@ class GPU {
         virtual void cumulateStats(GPUStats *) = 0;
         virtual void getVertices(AddTri &&, PixelOp) = 0;
         virtual bool writeJsonFields(std::ostream &) const { return false; }
+        // Tells apart the flavours of the primitives which share the same name.
+        virtual std::string getVariant() const { return {}; }
         virtual bool isInside(unsigned x, unsigned y) { return false; }
         void addLine(AddTri &&, int x1, int y1, int x2, int y2);
 
@@ -192,8 +401,58 @@ class GPU {
         static bool isInsideLine(int x, int y, int x1, int y1, int x2, int y2);
     };
 
+    // Sends little endian GP0 words straight to the command parser, as if they came from the given origin. This is how the
+    // GPU logger plays a saved frame log back.
+    void replayCommands(const uint32_t *words, size_t count, Logged::Origin origin, uint32_t value);
+    // The GP1 and GP0 words which bring a freshly reset GPU into the display and drawing state this one is in,
+    // which is what a capture spanning several frames has to start with to be played back faithfully.
+    void getEnvironment(std::vector<uint32_t> &control, std::vector<uint32_t> &data);
+
+  protected:
+    void markVRAMDirty(int x, int y, int w, int h) {
+        for (auto tracker : m_vramTrackers) tracker->mark(x, y, w, h);
+    }
+    void markAllVRAMDirty() {
+        for (auto tracker : m_vramTrackers) tracker->markAll();
+    }
+
   private:
     uint32_t m_statusControl[256];
+    std::vector<VRAMDirtyTiles *> m_vramTrackers;
+    PGXPVertexCache m_pgxpVertexCache;
+    DMAChainStats m_lastDMAChainStats;
+
+    // The display areas get collected over two windows of frames, so that both buffers of a double buffered
+    // game are in, and areas which stopped being displayed eventually drop out.
+    static constexpr unsigned c_displayWindow = 8;
+    bool m_skipFrame = false;
+    unsigned m_displayFrames = 0;
+    VRAMDirtyTiles m_displayTiles[2];
+    VRAMDirtyTiles m_skippableTiles;
+    VRAMDirtyTiles m_skippedTiles;
+    VRAMDirtyTiles m_readbackTiles;
+    void resetFrameSkip();
+    // Whether a primitive covering this rectangle of VRAM can be left out of the current frame
+    bool skipDraw(int x, int y, int w, int h);
+    bool skipDraw(const int *x, const int *y, size_t count, int offsetX, int offsetY);
+    void markVRAMRead(int x, int y, int w, int h);
+
+    // Command packets are a 3 words header, followed by the GP0 words. The header holds the packet type in
+    // its top 4 bits, the origin in the next 4 bits, and then the number of GP0 words. The other two words are
+    // the origin value and length, as passed to processWrite.
+    enum : uint32_t { COMMAND_PACKET_GP0, COMMAND_PACKET_EXIT };
+    static constexpr size_t c_commandRingSize = 1024 * 1024;
+    static constexpr size_t c_maxCommandPacket = 64 * 1024;
+    typedef SPSCRing<uint32_t, c_commandRingSize> CommandRing;
+    std::unique_ptr<CommandRing> m_commandRing;
+    std::thread m_commandThread;
+    // Set while the read fifo still holds borrowed VRAM slices the CPU hasn't read yet, in which case the
+    // commands are processed synchronously so that they can't change VRAM under the CPU's feet.
+    bool m_readbackPending = false;
+    std::unique_ptr<uint8_t[]> m_pendingVRAM;
+    void flushPendingVRAM();
+    bool queueCommands(const uint32_t *words, size_t count, Logged::Origin, uint32_t value, uint32_t length);
+    void commandThreadMain();
 
     class Buffer {
       public:
@@ -202,6 +461,7 @@ class GPU {
             m_size = 1;
         }
         Buffer(const uint32_t *ptr, size_t size) : m_size(size), m_data(ptr) {}
+        Buffer(std::span<const uint32_t> span) : m_size(span.size()), m_data(span.data()) {}
         Buffer(const Buffer &other) = delete;
         Buffer(Buffer &&other) = delete;
         Buffer &operator=(const Buffer &other) = delete;
@@ -235,6 +495,10 @@ class GPU {
         Command(GPU *parent) : m_gpu(parent) {}
         virtual ~Command() {}
         virtual void processWrite(Buffer &, Logged::Origin, uint32_t value, uint32_t length);
+        // Parses and executes a whole primitive packet at once, header included, without going through the
+        // processWrite state machine. Only called for opcodes with a non-zero c_primitiveWords entry, and only
+        // once all of the packet's words are available.
+        virtual void processPacket(const uint32_t *words, Logged::Origin, uint32_t value, uint32_t length) {}
         virtual void reset() {}
         void setActive() { m_gpu->m_processor = this; }
 
@@ -545,6 +809,15 @@ class GPU {
         static constexpr unsigned count = shape == Shape::Tri ? 3 : 4;
 
         std::string_view getName() override { return "Polygon"; }
+        std::string getVariant() const override {
+            std::string variant = shading == Shading::Gouraud ? "gouraud" : "flat";
+            variant += shape == Shape::Quad ? " quad" : " triangle";
+            if constexpr (textured == Textured::Yes) {
+                variant += modulation == Modulation::On ? ", textured" : ", raw textured";
+            }
+            if constexpr (blend == Blend::Semi) variant += ", semi-transparent";
+            return variant;
+        }
         void drawLogNode(unsigned itemIndex, const DrawLogSettings &) override;
         void execute(GPU *gpu) override { gpu->write0(this); }
         void generateStatsInfo() override;
@@ -553,6 +826,7 @@ class GPU {
         bool writeJsonFields(std::ostream &) const override;
         Poly() {}
         void processWrite(Buffer &, Logged::Origin, uint32_t value, uint32_t length) override;
+        void processPacket(const uint32_t *words, Logged::Origin, uint32_t value, uint32_t length) override;
         void reset() override {
             m_state = READ_COLOR;
             m_count = 0;
@@ -603,6 +877,9 @@ class GPU {
         }
 
       private:
+        void readUV(unsigned index, uint32_t value);
+        void submit(Logged::Origin, uint32_t value, uint32_t length);
+
         GPUStats stats;
         unsigned m_count = 0;
         enum { READ_COLOR, READ_XY, READ_UV } m_state = READ_COLOR;
@@ -611,6 +888,12 @@ class GPU {
     template <Shading shading, LineType lineType, Blend blend>
     struct Line final : public Command, public Logged {
         std::string_view getName() override { return "Line"; }
+        std::string getVariant() const override {
+            std::string variant = shading == Shading::Gouraud ? "gouraud" : "flat";
+            variant += lineType == LineType::Poly ? " polyline" : " line";
+            if constexpr (blend == Blend::Semi) variant += ", semi-transparent";
+            return variant;
+        }
         void drawLogNode(unsigned itemIndex, const DrawLogSettings &) override;
         void execute(GPU *gpu) override { gpu->write0(this); }
         void generateStatsInfo() override;
@@ -621,6 +904,7 @@ class GPU {
             if constexpr (lineType == LineType::Simple) m_count = 0;
         }
         void processWrite(Buffer &, Logged::Origin, uint32_t value, uint32_t length) override;
+        void processPacket(const uint32_t *words, Logged::Origin, uint32_t value, uint32_t length) override;
         void reset() override {
             m_state = READ_COLOR;
             if constexpr (lineType == LineType::Simple) {
@@ -654,6 +938,8 @@ class GPU {
         DrawingOffset offset;
 
       private:
+        void submit(Logged::Origin, uint32_t value, uint32_t length);
+
         GPUStats stats;
         struct Empty {};
         POLYFILL_NO_UNIQUE_ADDRESS
@@ -664,6 +950,15 @@ class GPU {
     template <Size size, Textured textured, Blend blend, Modulation modulation>
     struct Rect final : public Command, public Logged {
         std::string_view getName() override { return "Rectangle"; }
+        std::string getVariant() const override {
+            constexpr const char *sizes[] = {"variable", "1x1", "8x8", "16x16"};
+            std::string variant = sizes[static_cast<unsigned>(size)];
+            if constexpr (textured == Textured::Yes) {
+                variant += modulation == Modulation::On ? ", textured" : ", raw textured";
+            }
+            if constexpr (blend == Blend::Semi) variant += ", semi-transparent";
+            return variant;
+        }
         void drawLogNode(unsigned itemIndex, const DrawLogSettings &) override;
         void execute(GPU *gpu) override { gpu->write0(this); }
         void generateStatsInfo() override {}
@@ -672,6 +967,7 @@ class GPU {
         bool writeJsonFields(std::ostream &) const override;
         Rect() {}
         void processWrite(Buffer &, Logged::Origin, uint32_t value, uint32_t length) override;
+        void processPacket(const uint32_t *words, Logged::Origin, uint32_t value, uint32_t length) override;
         void reset() override { m_state = READ_COLOR; }
         bool isInside(unsigned x, unsigned y) override {
             return (x >= (this->x + offset.x)) && (y >= (this->y + offset.y)) && (x < (this->x + offset.x) + this->w) &&
@@ -715,6 +1011,8 @@ class GPU {
         }
 
       private:
+        void submit(Logged::Origin, uint32_t value, uint32_t length);
+
         enum { READ_COLOR, READ_XY, READ_UV, READ_HW } m_state = READ_COLOR;
     };
 
@@ -878,9 +1176,8 @@ class GPU {
     Command m_defaultProcessor = {this};
 
     FastFill m_fastFill = {this};
-    Command *m_polygons[32];
-    Command *m_lines[32];
-    Command *m_rects[32];
+    // Polygons, lines and rectangles, indexed by their full opcode byte. The other entries are null.
+    Command *m_primitives[256] = {};
     BlitVramVram m_blitVramVram = {this};
     BlitRamVram m_blitRamVram = {this};
     BlitVramRam m_blitVramRam = {this};
@@ -19,15 +19,24 @@
 
 #include "core/gpulogger.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <string>
 #include <string_view>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
 
 #include "core/gpu.h"
 #include "core/psxemulator.h"
 #include "core/r3000a.h"
 #include "core/system.h"
+#include "fmt/format.h"
 #include "imgui/imgui.h"
 
 static const char* const c_vtx = R"(
@@ -67,7 +76,9 @@ void main() {
 
 PCSX::GPULogger::GPULogger() : m_listener(g_system->m_eventBus) {
     m_listener.listen<Events::GPU::VSync>([this](auto event) {
+        if (m_capture) captureFrame();
         m_frameCounter++;
+        flushHeatmaps();
         if (m_breakOnVSync) {
             g_system->pause();
         }
@@ -178,8 +189,11 @@ void PCSX::GPULogger::enable() {
 }
 
 void PCSX::GPULogger::disable() {
+    m_capture.reset();
     m_hasFramebuffers = false;
     m_vram.reset();
+    m_pendingWritten.clear();
+    m_pendingRead.clear();
 }
 
 void PCSX::GPULogger::addTri(OpenGL::ivec2& v1, OpenGL::ivec2& v2, OpenGL::ivec2& v3) {
@@ -196,26 +210,71 @@ void PCSX::GPULogger::flush() {
     m_verticesCount = 0;
 }
 
+void* PCSX::GPULogger::FrameArena::allocate(size_t size, size_t alignment) {
+    while (true) {
+        if (m_block == m_blocks.size()) {
+            m_blocks.emplace_back(new std::max_align_t[c_blockSize / sizeof(std::max_align_t)]);
+        }
+        const size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+        if ((offset + size) <= c_blockSize) {
+            m_offset = offset + size;
+            return reinterpret_cast<uint8_t*>(m_blocks[m_block].get()) + offset;
+        }
+        m_block++;
+        m_offset = 0;
+    }
+}
+
+void PCSX::GPULogger::destroyNodes() {
+    // The nodes unlink themselves when destroyed, and their memory belongs to the arena
+    while (!m_list.empty()) m_list.begin()->~Logged();
+    m_arena.reset();
+    m_raw.clear();
+}
+
+void PCSX::GPULogger::checkNewFrame() {
+    // The list only ever holds a single frame's worth of nodes and records
+    if (m_logFrame == m_frameCounter) return;
+    m_logFrame = m_frameCounter;
+    destroyNodes();
+    startNewFrame();
+}
+
 void PCSX::GPULogger::addNodeInternal(GPU::Logged* node, GPU::Logged::Origin origin, uint32_t value, uint32_t length) {
     auto frame = m_frameCounter;
 
-    bool gotNewFrame = false;
-    for (auto i = m_list.begin(); (i != m_list.end()) && (i->frame != frame); i = m_list.begin()) {
-        delete &*i;
-        gotNewFrame = true;
-    }
-    if (gotNewFrame) startNewFrame();
-
     node->origin = origin;
     node->value = value;
     node->length = length;
-    node->pc = g_emulator->m_cpu->m_regs.pc;
+    node->pc = m_loading ? m_loadingPC : g_emulator->m_cpu->m_regs.pc;
     node->frame = frame;
     node->generateStatsInfo();
     m_list.push_back(node);
 
     if (!m_hasFramebuffers) return;
 
+    node->getVertices(
+        [this](auto v1, auto v2, auto v3) {
+            m_pendingWritten.push_back(v1);
+            m_pendingWritten.push_back(v2);
+            m_pendingWritten.push_back(v3);
+        },
+        GPU::Logged::PixelOp::WRITE);
+    node->getVertices(
+        [this](auto v1, auto v2, auto v3) {
+            m_pendingRead.push_back(v1);
+            m_pendingRead.push_back(v2);
+            m_pendingRead.push_back(v3);
+        },
+        GPU::Logged::PixelOp::READ);
+    if ((m_pendingWritten.size() >= m_vertices.size()) || (m_pendingRead.size() >= m_vertices.size())) {
+        flushHeatmaps();
+    }
+}
+
+void PCSX::GPULogger::flushHeatmaps() {
+    if (!m_hasFramebuffers || (m_pendingWritten.empty() && m_pendingRead.empty())) return;
+
     const auto oldFBO = OpenGL::getDrawFramebuffer();
 
     m_vbo.bind();
@@ -223,21 +282,319 @@ void PCSX::GPULogger::addNodeInternal(GPU::Logged* node, GPU::Logged::Origin ori
     m_program.use();
     OpenGL::disableScissor();
 
+    // The vertex buffer holds as many vertices as m_vertices, so the batches go through it in pieces that size.
+    auto drawPending = [this](std::vector<OpenGL::ivec2>& pending) {
+        for (size_t offset = 0; offset < pending.size(); offset += m_vertices.size()) {
+            const size_t count = std::min(pending.size() - offset, m_vertices.size());
+            m_vbo.bufferVertsSub(&pending[offset], count);
+            OpenGL::draw(OpenGL::Triangles, count);
+        }
+        pending.clear();
+    };
+
     OpenGL::setViewport(m_writtenHeatmapTex.width(), m_writtenHeatmapTex.height());
     m_writtenHeatmapFB.bind(OpenGL::DrawFramebuffer);
-    node->getVertices([this](auto v1, auto v2, auto v3) { addTri(v1, v2, v3); }, GPU::Logged::PixelOp::WRITE);
-    flush();
+    drawPending(m_pendingWritten);
 
     OpenGL::setViewport(m_readHeatmapTex.width(), m_readHeatmapTex.height());
     m_readHeatmapFB.bind(OpenGL::DrawFramebuffer);
-    node->getVertices([this](auto v1, auto v2, auto v3) { addTri(v1, v2, v3); }, GPU::Logged::PixelOp::READ);
-    flush();
+    drawPending(m_pendingRead);
 
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldFBO);
     g_emulator->m_gpu->setOpenGLContext();
 }
 
+namespace {
+
+constexpr char c_frameLogMagic[8] = {'P', 'C', 'S', 'X', 'G', 'P', 'U', 'L'};
+constexpr uint32_t c_frameLogVersion = 2;
+constexpr size_t c_vramSize = 1024 * 512 * 2;
+
+void appendRecords(std::vector<uint32_t>& raw, PCSX::GPU::Logged::Origin origin, uint32_t value, uint32_t pc,
+                   const uint32_t* words, size_t count) {
+    while (count != 0) {
+        const size_t chunk = std::min(count, size_t(0xffffff));
+        raw.push_back((static_cast<uint32_t>(origin) << 24) | uint32_t(chunk));
+        raw.push_back(value);
+        raw.push_back(pc);
+        raw.insert(raw.end(), words, words + chunk);
+        words += chunk;
+        count -= chunk;
+    }
+}
+
+bool validRecords(const std::vector<uint32_t>& raw) {
+    for (size_t i = 0; i < raw.size();) {
+        const uint32_t origin = raw[i] >> 24;
+        const size_t count = raw[i] & 0xffffff;
+        if (origin > static_cast<uint32_t>(PCSX::GPU::Logged::Origin::REPLAY)) return false;
+        if ((raw.size() - i) < (count + 3)) return false;
+        i += count + 3;
+    }
+    return true;
+}
+
+}  // namespace
+
+void PCSX::GPULogger::addRawInternal(GPU::Logged::Origin origin, uint32_t value, const uint32_t* words,
+                                     size_t count) {
+    appendRecords(m_raw, origin, value, g_emulator->m_cpu->m_regs.pc, words, count);
+}
+
 bool PCSX::GPULogger::saveFrameLog(const std::filesystem::path& path) {
+    if (path.extension() == ".json") return saveJsonFrameLog(path);
+    return saveBinaryFrameLog(path);
+}
+
+bool PCSX::GPULogger::saveBinaryFrameLog(const std::filesystem::path& path) {
+    FrameLog log;
+    log.frame = m_frameCounter;
+    log.vram = m_vram;
+    log.frames.push_back(m_raw);
+    return writeFrameLog(path, log);
+}
+
+// The layout is the magic, the version, the number of the first frame, whether VRAM follows, VRAM as it was
+// at the start of the first frame, the number of frames, and then for each of them the number of words in its
+// records, followed by the records, all little endian. The first version only had a single frame, and thus no
+// frame count.
+bool PCSX::GPULogger::writeFrameLog(const std::filesystem::path& path, const FrameLog& log) {
+    std::ofstream output(path, std::ios::binary);
+    if (!output.is_open()) return false;
+
+    const uint32_t hasVRAM = log.vram.size() == c_vramSize;
+    const uint32_t frameCount = log.frames.size();
+    output.write(c_frameLogMagic, sizeof(c_frameLogMagic));
+    output.write(reinterpret_cast<const char*>(&c_frameLogVersion), sizeof(c_frameLogVersion));
+    output.write(reinterpret_cast<const char*>(&log.frame), sizeof(log.frame));
+    output.write(reinterpret_cast<const char*>(&hasVRAM), sizeof(hasVRAM));
+    if (hasVRAM) output.write(log.vram.data<char>(), c_vramSize);
+    output.write(reinterpret_cast<const char*>(&frameCount), sizeof(frameCount));
+    for (auto& raw : log.frames) {
+        const uint32_t rawSize = raw.size();
+        output.write(reinterpret_cast<const char*>(&rawSize), sizeof(rawSize));
+        output.write(reinterpret_cast<const char*>(raw.data()), rawSize * sizeof(uint32_t));
+    }
+
+    return output.good();
+}
+
+bool PCSX::GPULogger::readFrameLog(const std::filesystem::path& path, FrameLog& log) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) return false;
+
+    char magic[sizeof(c_frameLogMagic)];
+    uint32_t version = 0;
+    uint32_t hasVRAM = 0;
+    input.read(magic, sizeof(magic));
+    input.read(reinterpret_cast<char*>(&version), sizeof(version));
+    input.read(reinterpret_cast<char*>(&log.frame), sizeof(log.frame));
+    input.read(reinterpret_cast<char*>(&hasVRAM), sizeof(hasVRAM));
+    if (!input.good() || (memcmp(magic, c_frameLogMagic, sizeof(magic)) != 0)) return false;
+    if ((version == 0) || (version > c_frameLogVersion)) return false;
+    if (hasVRAM) {
+        std::string vram;
+        vram.resize(c_vramSize);
+        input.read(vram.data(), c_vramSize);
+        log.vram.acquire(std::move(vram));
+    } else {
+        log.vram.reset();
+    }
+    uint32_t frameCount = 1;
+    if (version >= 2) input.read(reinterpret_cast<char*>(&frameCount), sizeof(frameCount));
+    if (!input.good()) return false;
+
+    // Checking all of the records before playing any of them back, so that a truncated file doesn't leave
+    // things halfway through a frame.
+    log.frames.clear();
+    for (uint32_t f = 0; f < frameCount; f++) {
+        uint32_t rawSize = 0;
+        input.read(reinterpret_cast<char*>(&rawSize), sizeof(rawSize));
+        if (!input.good()) return false;
+        auto& raw = log.frames.emplace_back(rawSize);
+        input.read(reinterpret_cast<char*>(raw.data()), rawSize * sizeof(uint32_t));
+        if (!input.good() || !validRecords(raw)) return false;
+    }
+
+    return true;
+}
+
+void PCSX::GPULogger::playRecords(GPU* gpu, const std::vector<uint32_t>& raw) {
+    const bool loading = m_loading;
+    m_loading = true;
+    for (size_t i = 0; i < raw.size();) {
+        const auto origin = static_cast<GPU::Logged::Origin>(raw[i] >> 24);
+        const size_t count = raw[i] & 0xffffff;
+        const uint32_t value = raw[i + 1];
+        m_loadingPC = raw[i + 2];
+        const uint32_t* words = &raw[i + 3];
+        if (origin == GPU::Logged::Origin::CTRLWRITE) {
+            for (size_t w = 0; w < count; w++) gpu->writeStatus(words[w]);
+        } else {
+            gpu->replayCommands(words, count, origin, value);
+        }
+        i += count + 3;
+    }
+    m_loading = loading;
+}
+
+bool PCSX::GPULogger::loadFrameLog(const std::filesystem::path& path) {
+    if (!m_enabled) return false;
+    FrameLog log;
+    if (!readFrameLog(path, log) || log.frames.empty()) return false;
+
+    // All of the frames get played back, but only the last one stays in the logger, as if it had just been
+    // emulated.
+    GPU* gpu = g_emulator->m_gpu.get();
+    destroyNodes();
+    if (log.vram.size() == c_vramSize) gpu->partialUpdateVRAM(0, 0, 1024, 512, log.vram.data<uint16_t>());
+    m_vram = std::move(log.vram);
+    for (size_t f = 0; f < log.frames.size(); f++) {
+        if (f != 0) {
+            gpu->vblank(true);
+            destroyNodes();
+            m_vram = gpu->getVRAM(GPU::Ownership::ACQUIRE);
+        }
+        playRecords(gpu, log.frames[f]);
+    }
+    m_raw = std::move(log.frames.back());
+    m_logFrame = m_frameCounter;
+    gpu->vblank(true);
+
+    return true;
+}
+
+bool PCSX::GPULogger::startCapture(const std::filesystem::path& path, unsigned frames) {
+    if (!m_enabled || (frames == 0)) return false;
+    m_capture = std::make_unique<Capture>();
+    m_capture->path = path;
+    m_capture->length = frames;
+    return true;
+}
+
+void PCSX::GPULogger::captureFrame() {
+    auto& capture = *m_capture;
+    if (!capture.started) {
+        // This is the vsync right before the first captured frame, so VRAM and the GPU state are as that
+        // frame will find them. The state gets played back as the first records of the capture.
+        GPU* gpu = g_emulator->m_gpu.get();
+        std::vector<uint32_t> control, data;
+        gpu->getEnvironment(control, data);
+        capture.log.frame = m_frameCounter + 1;
+        capture.log.vram = gpu->getVRAM(GPU::Ownership::ACQUIRE);
+        appendRecords(capture.environment, GPU::Logged::Origin::CTRLWRITE, 0, 0, control.data(), control.size());
+        appendRecords(capture.environment, GPU::Logged::Origin::DATAWRITE, 0, 0, data.data(), data.size());
+        capture.started = true;
+        return;
+    }
+
+    // The records only get reset on the first command of a frame, so they're stale if this one had none.
+    auto& frame = capture.log.frames.emplace_back(std::move(capture.environment));
+    capture.environment.clear();
+    if (m_logFrame == m_frameCounter) frame.insert(frame.end(), m_raw.begin(), m_raw.end());
+    if (capture.log.frames.size() == capture.length) {
+        if (writeFrameLog(capture.path, capture.log)) {
+            g_system->printf(_("Captured %u GPU frames into %s\n"), capture.length, capture.path.string().c_str());
+        } else {
+            g_system->printf(_("Unable to write the GPU capture to %s\n"), capture.path.string().c_str());
+        }
+        m_capture.reset();
+    }
+}
+
+bool PCSX::GPULogger::benchmark(const std::filesystem::path& path, GPU* gpu, unsigned passes, std::string& report) {
+    using Clock = std::chrono::steady_clock;
+    FrameLog log;
+    if (!readFrameLog(path, log) || log.frames.empty() || (passes == 0)) return false;
+    const bool hasVRAM = log.vram.size() == c_vramSize;
+    const bool enabled = m_enabled;
+    const bool hasFramebuffers = m_hasFramebuffers;
+
+    // The timed passes don't log anything, so that they only measure the backend. The vblank at the end of
+    // each frame is what waits for backends which draw asynchronously.
+    m_enabled = false;
+    std::vector<Clock::duration> best(log.frames.size(), Clock::duration::max());
+    for (unsigned pass = 0; pass < passes; pass++) {
+        if (hasVRAM) gpu->partialUpdateVRAM(0, 0, 1024, 512, log.vram.data<uint16_t>());
+        for (size_t f = 0; f < log.frames.size(); f++) {
+            const auto start = Clock::now();
+            playRecords(gpu, log.frames[f]);
+            gpu->vblank(true);
+            best[f] = std::min(best[f], Clock::now() - start);
+        }
+    }
+
+    // Then a last pass logs each frame, to get its statistics, and to run its primitives again one by one,
+    // from the VRAM the frame started with, timing each of them.
+    struct Timing {
+        std::string name;
+        unsigned count = 0;
+        Clock::duration time = {};
+    };
+    std::unordered_map<std::type_index, Timing> timings;
+    std::vector<GPU::GPUStats> stats(log.frames.size());
+    m_enabled = true;
+    m_hasFramebuffers = false;
+    m_logFrame = m_frameCounter;
+    if (hasVRAM) gpu->partialUpdateVRAM(0, 0, 1024, 512, log.vram.data<uint16_t>());
+    for (size_t f = 0; f < log.frames.size(); f++) {
+        destroyNodes();
+        const Slice vram = gpu->getVRAM(GPU::Ownership::ACQUIRE);
+        playRecords(gpu, log.frames[f]);
+        gpu->partialUpdateVRAM(0, 0, 1024, 512, vram.data<uint16_t>());
+        for (auto& node : m_list) {
+            node.cumulateStats(&stats[f]);
+            const auto start = Clock::now();
+            node.execute(gpu);
+            const auto time = Clock::now() - start;
+            auto& timing = timings[std::type_index(typeid(node))];
+            if (timing.name.empty()) {
+                timing.name = node.getName();
+                const auto variant = node.getVariant();
+                if (!variant.empty()) timing.name += " (" + variant + ")";
+            }
+            timing.time += time;
+            timing.count++;
+        }
+        gpu->vblank(true);
+    }
+    destroyNodes();
+    m_enabled = enabled;
+    m_hasFramebuffers = hasFramebuffers;
+
+    auto toMicroseconds = [](Clock::duration d) {
+        return std::chrono::duration<double, std::micro>(d).count();
+    };
+    Clock::duration total = {};
+    report = fmt::format("GPU benchmark of {} frames from {}, best of {} passes\n", log.frames.size(),
+                         path.string(), passes);
+    report += fmt::format("{:>6} {:>12} {:>10} {:>10} {:>10} {:>10} {:>12} {:>12}\n", "frame", "time (us)",
+                          "triangles", "textured", "rectangles", "sprites", "pixel writes", "texel reads");
+    for (size_t f = 0; f < log.frames.size(); f++) {
+        total += best[f];
+        const auto& s = stats[f];
+        report += fmt::format("{:>6} {:>12.1f} {:>10} {:>10} {:>10} {:>10} {:>12} {:>12}\n", f,
+                              toMicroseconds(best[f]), s.triangles, s.texturedTriangles, s.rectangles, s.sprites,
+                              s.pixelWrites, s.texelReads);
+    }
+    report += fmt::format("total {:.1f} us, {:.1f} frames per second\n\n", toMicroseconds(total),
+                          log.frames.size() * 1000000.0 / std::max(toMicroseconds(total), 1.0));
+
+    // The slowest kinds of primitives come first. These are only the time spent submitting them for the
+    // backends which draw asynchronously.
+    std::vector<Timing> sorted;
+    for (auto& [type, timing] : timings) sorted.push_back(std::move(timing));
+    std::sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) { return a.time > b.time; });
+    report += fmt::format("{:<56} {:>10} {:>12} {:>12}\n", "primitive", "count", "total (us)", "each (ns)");
+    for (auto& timing : sorted) {
+        report += fmt::format("{:<56} {:>10} {:>12.1f} {:>12.1f}\n", timing.name, timing.count,
+                              toMicroseconds(timing.time), toMicroseconds(timing.time) * 1000.0 / timing.count);
+    }
+
+    return true;
+}
+
+bool PCSX::GPULogger::saveJsonFrameLog(const std::filesystem::path& path) {
     std::ofstream output(path);
     if (!output.is_open()) return false;
 
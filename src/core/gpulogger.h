@@ -22,7 +22,12 @@
 #include <stdint.h>
 
 #include <array>
+#include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
 
 #include "core/gpu.h"
 #include "support/eventbus.h"
@@ -38,18 +43,48 @@ class GPULogger;
 class GPULogger {
   public:
     GPULogger();
-    void clearFrameLog() { m_list.destroyAll(); }
+    ~GPULogger() { destroyNodes(); }
+    void clearFrameLog() { destroyNodes(); }
     template <typename T>
     void addNode(const T& data, GPU::Logged::Origin origin, uint32_t value, uint32_t length) {
         if (m_enabled) {
-            addNodeInternal(new T(data), origin, value, length);
+            static_assert(alignof(T) <= alignof(std::max_align_t));
+            static_assert(sizeof(T) <= FrameArena::c_blockSize);
+            checkNewFrame();
+            addNodeInternal(new (m_arena.allocate(sizeof(T), alignof(T))) T(data), origin, value, length);
         }
     }
+    // Records the words a command came in as, which is what the binary frame logs hold. Control writes are
+    // recorded as their single GP1 word.
+    void addRaw(GPU::Logged::Origin origin, uint32_t value, const uint32_t* words, size_t count) {
+        if (m_enabled && !m_loading) {
+            checkNewFrame();
+            addRawInternal(origin, value, words, count);
+        }
+    }
+    // Frame logs get saved as binary, unless the path ends with .json, which is only meant for reading.
     bool saveFrameLog(const std::filesystem::path& path);
+    // Loads a binary frame log, by playing its commands back through the GPU, which logs them anew.
+    bool loadFrameLog(const std::filesystem::path& path);
+    // Records the given number of frames, from the next vsync on, into a binary frame log. The log starts with
+    // VRAM and the GPU state as they were at that point, so that the frames can be played back on their own.
+    bool startCapture(const std::filesystem::path& path, unsigned frames);
+    void cancelCapture() { m_capture.reset(); }
+    bool isCapturing() const { return m_capture != nullptr; }
+    unsigned capturedFrames() const { return m_capture ? m_capture->log.frames.size() : 0; }
+    unsigned captureLength() const { return m_capture ? m_capture->length : 0; }
+    // Plays a frame log back through the given GPU as fast as it can, the given number of times, and reports
+    // the fastest time for each frame, followed by the time spent on each kind of primitive. Whatever the
+    // logger held gets discarded, as this is meant for the -gpu-bench command line mode.
+    bool benchmark(const std::filesystem::path& path, GPU* gpu, unsigned passes, std::string& report);
     void replay(GPU*);
     void highlight(GPU::Logged* node, bool only = false);
     void enable();
     void disable();
+    bool isEnabled() const { return m_enabled; }
+    // Draws the primitives logged since the last call into the heatmaps. This happens on its own at the end
+    // of each frame, and should be done before sampling them while the emulation is paused mid-frame.
+    void flushHeatmaps();
     void bindWrittenHeatmap() { m_writtenHeatmapTex.bind(); }
     void bindReadHeatmap() { m_readHeatmapTex.bind(); }
     void bindWrittenHighlight() { m_writtenHighlightTex.bind(); }
@@ -57,7 +92,48 @@ class GPULogger {
 
   private:
     void startNewFrame();
+    void checkNewFrame();
+    void destroyNodes();
     void addNodeInternal(GPU::Logged* node, GPU::Logged::Origin, uint32_t value, uint32_t length);
+    void addRawInternal(GPU::Logged::Origin origin, uint32_t value, const uint32_t* words, size_t count);
+    bool saveJsonFrameLog(const std::filesystem::path& path);
+    bool saveBinaryFrameLog(const std::filesystem::path& path);
+    void playRecords(GPU* gpu, const std::vector<uint32_t>& raw);
+    void captureFrame();
+
+    struct FrameLog {
+        uint64_t frame = 0;
+        Slice vram;
+        std::vector<std::vector<uint32_t>> frames;
+    };
+    static bool writeFrameLog(const std::filesystem::path& path, const FrameLog& log);
+    static bool readFrameLog(const std::filesystem::path& path, FrameLog& log);
+
+    struct Capture {
+        std::filesystem::path path;
+        unsigned length;
+        bool started = false;
+        // The GPU state from when the capture started, which the first frame's records begin with.
+        std::vector<uint32_t> environment;
+        FrameLog log;
+    };
+
+    // The logged nodes only live for a frame, so they are carved out of a few large blocks, which get
+    // recycled whenever a new frame starts, instead of going through the heap for every single primitive.
+    class FrameArena {
+      public:
+        static constexpr size_t c_blockSize = 1024 * 1024;
+        void* allocate(size_t size, size_t alignment);
+        void reset() {
+            m_block = 0;
+            m_offset = 0;
+        }
+
+      private:
+        std::vector<std::unique_ptr<std::max_align_t[]>> m_blocks;
+        size_t m_block = 0;
+        size_t m_offset = 0;
+    };
 
     EventBus::Listener m_listener;
     bool m_enabled = false;
@@ -65,12 +141,25 @@ class GPULogger {
     bool m_hasFramebuffers = false;
     uint64_t m_frameCounter = 0;
     GPU::LoggedList m_list;
+    FrameArena m_arena;
     Slice m_vram;
+    // The frame's commands as they were sent. Each record is a header word, holding the origin in its top 8
+    // bits and the number of words in the other 24, followed by the origin's value, the pc, and the words.
+    std::vector<uint32_t> m_raw;
+    // The frame the nodes and records belong to. They get discarded on the first command of any other frame.
+    uint64_t m_logFrame = ~uint64_t(0);
+    std::unique_ptr<Capture> m_capture;
+    bool m_loading = false;
+    uint32_t m_loadingPC = 0;
     float m_impact = 1.0f / 256.0f;
     float m_decayRate = 1.0f / 1024.0f;
 
     std::array<OpenGL::ivec2, 3 * 0x10000> m_vertices;
     unsigned m_verticesCount = 0;
+    // The heatmaps get drawn in batches, as switching over to their framebuffers for every single primitive
+    // costs a lot more than drawing it.
+    std::vector<OpenGL::ivec2> m_pendingWritten;
+    std::vector<OpenGL::ivec2> m_pendingRead;
 
     OpenGL::Framebuffer m_writtenHeatmapFB, m_readHeatmapFB, m_writtenHighlightFB, m_readHighlightFB;
     OpenGL::Texture m_writtenHeatmapTex, m_readHeatmapTex, m_writtenHighlightTex, m_readHighlightTex;
@@ -0,0 +1,144 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/gte-kernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define GTE_KERNELS_AVX2
+#define GTE_KERNELS_TARGET_AVX2
+#else
+#define GTE_KERNELS_AVX2
+#define GTE_KERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+// Overflow bits for each row, matching GTE::A1, A2 and A3
+constexpr uint32_t c_positiveOverflow[3] = {(1u << 31) | (1 << 30), (1u << 31) | (1 << 29), (1u << 31) | (1 << 28)};
+constexpr uint32_t c_negativeOverflow[3] = {(1u << 31) | (1 << 27), (1u << 31) | (1 << 26), (1u << 31) | (1 << 25)};
+
+}  // namespace
+
+PCSX::GTEKernels::MatrixVectorResult PCSX::GTEKernels::multiplyScalar(const int16_t m[3][3], const int16_t v[3],
+                                                                      const int32_t t[3]) {
+    MatrixVectorResult result;
+    result.flags = 0;
+
+    for (int i = 0; i < 3; i++) {
+        int64_t acc = (int64_t)t[i] << 12;
+        bool positiveOverflow = false;
+        bool negativeOverflow = false;
+
+        for (int j = 0; j < 3; j++) {
+            const int64_t term = m[i][j] * v[j];
+            const int64_t value = ((acc + term) << 20) >> 20;
+            positiveOverflow |= value < 0 && acc >= 0 && term >= 0;
+            negativeOverflow |= value >= 0 && acc < 0 && term < 0;
+            acc = value;
+        }
+
+        result.mac[i] = acc;
+        if (positiveOverflow) result.flags |= c_positiveOverflow[i];
+        if (negativeOverflow) result.flags |= c_negativeOverflow[i];
+    }
+
+    return result;
+}
+
+#if defined(GTE_KERNELS_AVX2)
+
+// One 64-bit lane per row, the 4th lane is unused
+GTE_KERNELS_TARGET_AVX2 PCSX::GTEKernels::MatrixVectorResult PCSX::GTEKernels::multiplySIMD(const int16_t m[3][3],
+                                                                                              const int16_t v[3],
+                                                                                              const int32_t t[3]) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mask44 = _mm256_set1_epi64x((int64_t(1) << 44) - 1);
+    const __m256i sign44 = _mm256_set1_epi64x(int64_t(1) << 43);
+
+    __m256i acc = _mm256_set_epi64x(0, (int64_t)t[2] << 12, (int64_t)t[1] << 12, (int64_t)t[0] << 12);
+    __m256i positiveOverflow = zero;
+    __m256i negativeOverflow = zero;
+
+    for (int j = 0; j < 3; j++) {
+        // _mm256_mul_epi32 multiplies the sign-extended low 32 bits of each lane into a 64-bit product
+        const __m256i column = _mm256_set_epi64x(0, m[2][j], m[1][j], m[0][j]);
+        const __m256i term = _mm256_mul_epi32(column, _mm256_set1_epi64x(v[j]));
+
+        // Wrap to 44 bits. There's no 64-bit arithmetic shift before AVX-512, so sign-extend with a xor/sub pair
+        __m256i value = _mm256_and_si256(_mm256_add_epi64(acc, term), mask44);
+        value = _mm256_sub_epi64(_mm256_xor_si256(value, sign44), sign44);
+
+        const __m256i valueNegative = _mm256_cmpgt_epi64(zero, value);
+        const __m256i accNegative = _mm256_cmpgt_epi64(zero, acc);
+        const __m256i termNegative = _mm256_cmpgt_epi64(zero, term);
+        const __m256i bothNegative = _mm256_and_si256(accNegative, termNegative);
+        const __m256i bothPositive = _mm256_andnot_si256(_mm256_or_si256(accNegative, termNegative), valueNegative);
+        positiveOverflow = _mm256_or_si256(positiveOverflow, bothPositive);
+        negativeOverflow = _mm256_or_si256(negativeOverflow, _mm256_andnot_si256(valueNegative, bothNegative));
+        acc = value;
+    }
+
+    MatrixVectorResult result;
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    result.mac[0] = lanes[0];
+    result.mac[1] = lanes[1];
+    result.mac[2] = lanes[2];
+
+    const int positiveMask = _mm256_movemask_pd(_mm256_castsi256_pd(positiveOverflow));
+    const int negativeMask = _mm256_movemask_pd(_mm256_castsi256_pd(negativeOverflow));
+    result.flags = 0;
+    for (int i = 0; i < 3; i++) {
+        if (positiveMask & (1 << i)) result.flags |= c_positiveOverflow[i];
+        if (negativeMask & (1 << i)) result.flags |= c_negativeOverflow[i];
+    }
+
+    return result;
+}
+
+bool PCSX::GTEKernels::hasSIMD() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#else
+
+PCSX::GTEKernels::MatrixVectorResult PCSX::GTEKernels::multiplySIMD(const int16_t m[3][3], const int16_t v[3],
+                                                                      const int32_t t[3]) {
+    return multiplyScalar(m, v, t);
+}
+
+bool PCSX::GTEKernels::hasSIMD() { return false; }
+
+#endif
@@ -0,0 +1,51 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace PCSX {
+
+namespace GTEKernels {
+
+// The result of a GTE matrix-vector multiplication. Each lane of "mac" holds the 44-bit accumulator,
+// sign-extended to 64 bits, before any shifting. "flags" holds the FLAG overflow bits the accumulation set.
+struct MatrixVectorResult {
+    int64_t mac[3];
+    uint32_t flags;
+};
+
+// Computes (t[i] << 12) + m[i][0] * v[0] + m[i][1] * v[1] + m[i][2] * v[2] for the 3 rows of the matrix,
+// wrapping to 44 bits and checking for overflow after each addition, like the hardware does.
+// This is the reference implementation, the others must return the exact same results.
+MatrixVectorResult multiplyScalar(const int16_t m[3][3], const int16_t v[3], const int32_t t[3]);
+
+// Same as above, computing the 3 rows in parallel. Only available if hasSIMD() returns true.
+MatrixVectorResult multiplySIMD(const int16_t m[3][3], const int16_t v[3], const int32_t t[3]);
+bool hasSIMD();
+
+inline MatrixVectorResult multiply(const int16_t m[3][3], const int16_t v[3], const int32_t t[3]) {
+    static const bool simd = hasSIMD();
+    return simd ? multiplySIMD(m, v, t) : multiplyScalar(m, v, t);
+}
+
+}  // namespace GTEKernels
+
+}  // namespace PCSX
@@ -9,6 +9,7 @@
 
 #include <algorithm>
 
+#include "core/gte-kernels.h"
 #include "core/pgxp_debug.h"
 #include "core/pgxp_gte.h"
 #include "core/psxmem.h"
@@ -423,6 +424,17 @@ int32_t PCSX::GTE::A3(int44 a) {
     s_mac3 = a.value();
     return BOUNDS(a, (1 << 31) | (1 << 28), (1 << 31) | (1 << 25));
 }
+
+// MAC1..3 = A1..3((t << 12) + m * v), with the 3 rows computed at once by the GTE kernels
+void PCSX::GTE::multiplyMatrixVector(const int16_t m[3][3], const int16_t v[3], const int32_t t[3]) {
+    const auto result = GTEKernels::multiply(m, v, t);
+    FLAG |= result.flags;
+    s_mac3 = result.mac[2];
+    MAC1 = gte_shift(result.mac[0], s_sf);
+    MAC2 = gte_shift(result.mac[1], s_sf);
+    MAC3 = gte_shift(result.mac[2], s_sf);
+}
+
 static int32_t Lm_B1(int32_t a, int lm) { return LIM(a, 0x7fff, -0x8000 * !lm, (1 << 31) | (1 << 24)); }
 static int32_t Lm_B2(int32_t a, int lm) { return LIM(a, 0x7fff, -0x8000 * !lm, (1 << 31) | (1 << 23)); }
 static int32_t Lm_B3(int32_t a, int lm) { return LIM(a, 0x7fff, -0x8000 * !lm, (1 << 22)); }
@@ -500,9 +512,10 @@ void PCSX::GTE::RTPS(uint32_t op) {
     s_sf = GTE_SF(gteop(op));
     FLAG = 0;
 
-    MAC1 = A1(int44((int64_t)TRX << 12) + (R11 * VX0) + (R12 * VY0) + (R13 * VZ0));
-    MAC2 = A2(int44((int64_t)TRY << 12) + (R21 * VX0) + (R22 * VY0) + (R23 * VZ0));
-    MAC3 = A3(int44((int64_t)TRZ << 12) + (R31 * VX0) + (R32 * VY0) + (R33 * VZ0));
+    const int16_t rotation[3][3] = {{R11, R12, R13}, {R21, R22, R23}, {R31, R32, R33}};
+    const int16_t vector[3] = {VX0, VY0, VZ0};
+    const int32_t translation[3] = {TRX, TRY, TRZ};
+    multiplyMatrixVector(rotation, vector, translation);
     IR1 = Lm_B1(MAC1, lm);
     IR2 = Lm_B2(MAC2, lm);
     IR3 = Lm_B3_sf(s_mac3, s_sf, lm);
@@ -614,11 +627,15 @@ void PCSX::GTE::MVMVA(uint32_t op) {
             Lm_B3(A3(((int64_t)CV3(cv) << 12) + (MX31(mx) * VX(v))), 0);
             break;
 
-        default:
-            MAC1 = A1(int44((int64_t)CV1(cv) << 12) + (MX11(mx) * VX(v)) + (MX12(mx) * VY(v)) + (MX13(mx) * VZ(v)));
-            MAC2 = A2(int44((int64_t)CV2(cv) << 12) + (MX21(mx) * VX(v)) + (MX22(mx) * VY(v)) + (MX23(mx) * VZ(v)));
-            MAC3 = A3(int44((int64_t)CV3(cv) << 12) + (MX31(mx) * VX(v)) + (MX32(mx) * VY(v)) + (MX33(mx) * VZ(v)));
+        default: {
+            const int16_t matrix[3][3] = {{(int16_t)MX11(mx), (int16_t)MX12(mx), (int16_t)MX13(mx)},
+                                          {MX21(mx), MX22(mx), MX23(mx)},
+                                          {MX31(mx), MX32(mx), MX33(mx)}};
+            const int16_t vector[3] = {VX(v), VY(v), VZ(v)};
+            const int32_t translation[3] = {CV1(cv), CV2(cv), CV3(cv)};
+            multiplyMatrixVector(matrix, vector, translation);
             break;
+        }
     }
 
     IR1 = Lm_B1(MAC1, lm);
@@ -921,10 +938,12 @@ void PCSX::GTE::RTPT(uint32_t op) {
     s_sf = GTE_SF(gteop(op));
     FLAG = 0;
 
+    const int16_t rotation[3][3] = {{R11, R12, R13}, {R21, R22, R23}, {R31, R32, R33}};
+    const int32_t translation[3] = {TRX, TRY, TRZ};
+
     for (int v = 0; v < 3; v++) {
-        MAC1 = A1(int44((int64_t)TRX << 12) + (R11 * VX(v)) + (R12 * VY(v)) + (R13 * VZ(v)));
-        MAC2 = A2(int44((int64_t)TRY << 12) + (R21 * VX(v)) + (R22 * VY(v)) + (R23 * VZ(v)));
-        MAC3 = A3(int44((int64_t)TRZ << 12) + (R31 * VX(v)) + (R32 * VY(v)) + (R33 * VZ(v)));
+        const int16_t vector[3] = {VX(v), VY(v), VZ(v)};
+        multiplyMatrixVector(rotation, vector, translation);
         IR1 = Lm_B1(MAC1, lm);
         IR2 = Lm_B2(MAC2, lm);
         IR3 = Lm_B3_sf(s_mac3, s_sf, lm);
@@ -997,16 +1016,20 @@ void PCSX::GTE::NCCT(uint32_t op) {
     s_sf = GTE_SF(gteop(op));
     FLAG = 0;
 
+    // The light vector products can't overflow 44 bits, so a zero translation gives the same results
+    const int16_t light[3][3] = {{L11, L12, L13}, {L21, L22, L23}, {L31, L32, L33}};
+    const int16_t color[3][3] = {{LR1, LR2, LR3}, {LG1, LG2, LG3}, {LB1, LB2, LB3}};
+    const int32_t noTranslation[3] = {0, 0, 0};
+    const int32_t background[3] = {RBK, GBK, BBK};
+
     for (int v = 0; v < 3; v++) {
-        MAC1 = A1((int64_t)(L11 * VX(v)) + (L12 * VY(v)) + (L13 * VZ(v)));
-        MAC2 = A2((int64_t)(L21 * VX(v)) + (L22 * VY(v)) + (L23 * VZ(v)));
-        MAC3 = A3((int64_t)(L31 * VX(v)) + (L32 * VY(v)) + (L33 * VZ(v)));
+        const int16_t vector[3] = {VX(v), VY(v), VZ(v)};
+        multiplyMatrixVector(light, vector, noTranslation);
         IR1 = Lm_B1(MAC1, lm);
         IR2 = Lm_B2(MAC2, lm);
         IR3 = Lm_B3(MAC3, lm);
-        MAC1 = A1(int44((int64_t)RBK << 12) + (LR1 * IR1) + (LR2 * IR2) + (LR3 * IR3));
-        MAC2 = A2(int44((int64_t)GBK << 12) + (LG1 * IR1) + (LG2 * IR2) + (LG3 * IR3));
-        MAC3 = A3(int44((int64_t)BBK << 12) + (LB1 * IR1) + (LB2 * IR2) + (LB3 * IR3));
+        const int16_t ir[3] = {IR1, IR2, IR3};
+        multiplyMatrixVector(color, ir, background);
         IR1 = Lm_B1(MAC1, lm);
         IR2 = Lm_B2(MAC2, lm);
         IR3 = Lm_B3(MAC3, lm);
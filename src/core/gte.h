@@ -149,6 +149,7 @@ class GTE {
     int32_t A2(int44 a);
     int32_t A3(int44 a);
     int64_t F(int64_t a);
+    void multiplyMatrixVector(const int16_t m[3][3], const int16_t v[3], const int32_t t[3]);
 
     uint32_t MFC2_internal(int reg);
     void MTC2_internal(uint32_t value, int reg);
@@ -0,0 +1,188 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/guestprofiler.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+#include "core/callstacks.h"
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "fmt/format.h"
+#include "support/file.h"
+#include "support/protobuf.h"
+#include "support/zfile.h"
+
+namespace {
+
+std::string symbolise(uint32_t address) {
+    auto symbol = PCSX::g_emulator->m_cpu->findContainingSymbol(address);
+    if (symbol) return std::string(symbol->name);
+    return fmt::format("0x{:08x}", address);
+}
+
+// Just enough of the protobuf wire format for pprof's profile.proto.
+void putVarIntField(PCSX::Protobuf::OutSlice& out, unsigned field, uint64_t value) {
+    out.putVarInt(field << 3);
+    out.putVarInt(value);
+}
+
+void putMessage(PCSX::Protobuf::OutSlice& out, unsigned field, PCSX::Protobuf::OutSlice& message) {
+    out.putVarInt((field << 3) | 2);
+    out.putVarInt(message.size());
+    out.putSlice(&message);
+}
+
+void putString(PCSX::Protobuf::OutSlice& out, unsigned field, const std::string& str) {
+    out.putVarInt((field << 3) | 2);
+    out.putVarInt(str.size());
+    out.putBytes(str);
+}
+
+}  // namespace
+
+void PCSX::GuestProfiler::start(uint64_t interval, uint64_t cycle) {
+    m_interval = std::max<uint64_t>(interval, 1);
+    m_period = m_interval;
+    m_lastSample = cycle;
+}
+
+void PCSX::GuestProfiler::sample(uint32_t pc, uint64_t cycle) {
+    if (!isRunning()) return;
+    // The cycle counter went backwards, from a reset or a save state, so there's nothing to account for.
+    if (cycle < m_lastSample) {
+        m_lastSample = cycle;
+        return;
+    }
+
+    std::vector<uint32_t> stack;
+    stack.push_back(pc);
+    auto& callStacks = g_emulator->m_callStacks;
+    if (callStacks->hasCurrent()) {
+        auto& current = callStacks->getCurrent();
+        if (current.ra != 0) stack.push_back(current.ra);
+        for (unsigned i = current.calls.size(); (i != 0) && (stack.size() < c_maxDepth);) {
+            stack.push_back(current.calls[--i].ra);
+        }
+    }
+
+    auto& weight = m_stacks[std::move(stack)];
+    weight.samples++;
+    weight.cycles += cycle - m_lastSample;
+    m_lastSample = cycle;
+}
+
+PCSX::GuestProfiler::Format PCSX::GuestProfiler::formatFor(const std::filesystem::path& filename) {
+    const auto name = filename.filename().string();
+    const auto endsWith = [&name](std::string_view suffix) {
+        return (name.size() >= suffix.size()) && (name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0);
+    };
+    return (endsWith(".pprof") || endsWith(".pb.gz")) ? Format::Pprof : Format::Collapsed;
+}
+
+bool PCSX::GuestProfiler::save(const std::filesystem::path& filename, Format format) const {
+    std::string out;
+    IO<File> file(new PosixFile(filename, FileOps::TRUNCATE));
+    if (file->failed()) return false;
+    if (format == Format::Pprof) {
+        savePprof(out);
+        file = new ZWriter(file, ZWriter::GZIP);
+    } else {
+        saveCollapsed(out);
+    }
+    file->writeString(out);
+    file->close();
+    return true;
+}
+
+void PCSX::GuestProfiler::saveCollapsed(std::string& out) const {
+    // Different addresses within the same functions fold into the same line.
+    std::map<std::string, uint64_t> lines;
+    for (auto& [stack, weight] : m_stacks) {
+        std::string line;
+        for (auto address = stack.rbegin(); address != stack.rend(); address++) {
+            if (!line.empty()) line += ';';
+            line += symbolise(*address);
+        }
+        lines[line] += weight.cycles;
+    }
+    for (auto& [line, cycles] : lines) out += fmt::format("{} {}\n", line, cycles);
+}
+
+void PCSX::GuestProfiler::savePprof(std::string& out) const {
+    std::vector<std::string> strings = {""};
+    std::map<std::string, uint64_t> stringIndices = {{"", 0}};
+    const auto string = [&](const std::string& str) {
+        auto [i, inserted] = stringIndices.try_emplace(str, strings.size());
+        if (inserted) strings.push_back(str);
+        return i->second;
+    };
+    std::map<std::string, uint64_t> functions;
+    std::map<uint32_t, uint64_t> locations;
+
+    Protobuf::OutSlice profile;
+    const auto valueType = [&](unsigned field, const char* type, const char* unit) {
+        Protobuf::OutSlice message;
+        putVarIntField(message, 1, string(type));
+        putVarIntField(message, 2, string(unit));
+        putMessage(profile, field, message);
+    };
+    valueType(1, "samples", "count");
+    valueType(1, "cycles", "cycles");
+
+    for (auto& [stack, weight] : m_stacks) {
+        Protobuf::OutSlice ids;
+        for (auto address : stack) {
+            auto [location, inserted] = locations.try_emplace(address, locations.size() + 1);
+            ids.putVarInt(location->second);
+            if (!inserted) continue;
+
+            const std::string name = symbolise(address);
+            auto [function, newFunction] = functions.try_emplace(name, functions.size() + 1);
+            if (newFunction) {
+                Protobuf::OutSlice message;
+                putVarIntField(message, 1, function->second);
+                putVarIntField(message, 2, string(name));
+                putVarIntField(message, 3, string(name));
+                putMessage(profile, 5, message);
+            }
+            Protobuf::OutSlice line;
+            putVarIntField(line, 1, function->second);
+            Protobuf::OutSlice message;
+            putVarIntField(message, 1, location->second);
+            putVarIntField(message, 3, address);
+            putMessage(message, 4, line);
+            putMessage(profile, 4, message);
+        }
+        Protobuf::OutSlice values;
+        values.putVarInt(weight.samples);
+        values.putVarInt(weight.cycles);
+        Protobuf::OutSlice sample;
+        putMessage(sample, 1, ids);
+        putMessage(sample, 2, values);
+        putMessage(profile, 2, sample);
+    }
+
+    valueType(11, "cycles", "cycles");
+    putVarIntField(profile, 12, m_period);
+    for (auto& str : strings) putString(profile, 6, str);
+    out = profile.finalize();
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace PCSX {
+
+// A sampling profiler for the code running in the emulated machine, that works the same for both CPU
+// cores, as it is driven from branchTest. Every interval emulated cycles, it records the pc along with
+// the call stack tracked by CallStacks, which only the interpreter maintains, so the dynarec profiles
+// are flat. Each sample is weighted by the cycles elapsed since the previous one, which accounts for the
+// idle loop skipping jumping ahead. The profile can be saved as collapsed stacks, as understood by the
+// flame graph scripts and speedscope, or as a gzipped pprof protobuf, and gets symbolised along the way
+// with the CPU's symbols.
+class GuestProfiler {
+  public:
+    enum class Format { Collapsed, Pprof };
+
+    void start(uint64_t interval, uint64_t cycle);
+    void stop() { m_interval = UINT64_MAX; }
+    void clear() { m_stacks.clear(); }
+    bool isRunning() const { return m_interval != UINT64_MAX; }
+    bool empty() const { return m_stacks.empty(); }
+    bool save(const std::filesystem::path& filename, Format format) const;
+    // Profiles named .pprof, or .pb.gz, are saved as pprof, and everything else as collapsed stacks.
+    static Format formatFor(const std::filesystem::path& filename);
+
+    bool due(uint64_t cycle) const { return cycle - m_lastSample >= m_interval; }
+    void sample(uint32_t pc, uint64_t cycle);
+
+  private:
+    static constexpr unsigned c_maxDepth = 64;
+
+    struct Weight {
+        uint64_t samples = 0;
+        uint64_t cycles = 0;
+    };
+    void saveCollapsed(std::string& out) const;
+    void savePprof(std::string& out) const;
+
+    uint64_t m_interval = UINT64_MAX;
+    uint64_t m_period = 0;
+    uint64_t m_lastSample = 0;
+    // Keyed by the addresses making up the stack, innermost first.
+    std::map<std::vector<uint32_t>, Weight> m_stacks;
+};
+
+}  // namespace PCSX
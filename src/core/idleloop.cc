@@ -0,0 +1,213 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/idleloop.h"
+
+#include <algorithm>
+
+#include "mips/common/util/decoder.hh"
+
+PCSX::IdleLoop::Loop PCSX::IdleLoop::analyze(const uint32_t* code, unsigned count, uint32_t pc) {
+    using Instruction = Mips::Decoder::Instruction;
+
+    Loop loop;
+    count = std::min(count, MAX_INSTRUCTIONS);
+
+    uint32_t written = 0;      // Registers written so far in this iteration
+    uint32_t allWritten = 0;   // Registers written anywhere in the loop
+    uint32_t carried = 0;      // Registers read before being written in this iteration
+    uint32_t pendingLoad = 0;  // The register the previous instruction loads, which isn't visible yet
+    uint32_t exits[MAX_INSTRUCTIONS];
+    unsigned exitCount = 0;
+    unsigned closingBranch = count;
+    bool inDelaySlot = false;
+
+    for (unsigned i = 0; i < count; i++) {
+        const Instruction insn(code[i]);
+        const uint32_t address = pc + i * 4;
+        uint32_t reads = 0;
+        uint32_t writes = 0;
+        bool load = false;
+        bool branch = false;
+        uint32_t target = 0;
+
+        switch (insn.mnemonic()) {
+            case Instruction::ADD:
+            case Instruction::ADDU:
+            case Instruction::SUB:
+            case Instruction::SUBU:
+            case Instruction::SLT:
+            case Instruction::SLTU:
+            case Instruction::AND:
+            case Instruction::OR:
+            case Instruction::XOR:
+            case Instruction::NOR:
+            case Instruction::SLLV:
+            case Instruction::SRLV:
+            case Instruction::SRAV:
+                reads = (1 << insn.rs()) | (1 << insn.rt());
+                writes = 1 << insn.rd();
+                break;
+            case Instruction::SLL:
+            case Instruction::SRL:
+            case Instruction::SRA:
+                reads = 1 << insn.rt();
+                writes = 1 << insn.rd();
+                break;
+            case Instruction::ADDI:
+            case Instruction::ADDIU:
+            case Instruction::SLTI:
+            case Instruction::SLTIU:
+            case Instruction::ANDI:
+            case Instruction::ORI:
+            case Instruction::XORI:
+                reads = 1 << insn.rs();
+                writes = 1 << insn.rt();
+                break;
+            case Instruction::LUI:
+                writes = 1 << insn.rt();
+                break;
+            // HI and LO can't be written by the loop, as multiplications and divisions aren't allowed.
+            case Instruction::MFHI:
+            case Instruction::MFLO:
+                writes = 1 << insn.rd();
+                break;
+            case Instruction::LWL:
+            case Instruction::LWR:
+                // These merge into the existing contents of the register.
+                reads = 1 << insn.rt();
+                [[fallthrough]];
+            case Instruction::LB:
+            case Instruction::LBU:
+            case Instruction::LH:
+            case Instruction::LHU:
+            case Instruction::LW: {
+                if (loop.loadCount == MAX_LOADS) return {};
+                reads |= 1 << insn.rs();
+                writes = 1 << insn.rt();
+                load = true;
+                auto& l = loop.loads[loop.loadCount++];
+                l.base = insn.rs();
+                l.offset = insn.imm();
+                switch (insn.mnemonic()) {
+                    case Instruction::LB:
+                    case Instruction::LBU:
+                        l.size = 1;
+                        break;
+                    case Instruction::LH:
+                    case Instruction::LHU:
+                        l.size = 2;
+                        break;
+                    default:
+                        l.size = 4;
+                        break;
+                }
+                break;
+            }
+            case Instruction::BEQ:
+            case Instruction::BNE:
+                reads = (1 << insn.rs()) | (1 << insn.rt());
+                branch = true;
+                target = address + 4 + insn.imm() * 4;
+                break;
+            case Instruction::BGEZ:
+            case Instruction::BGTZ:
+            case Instruction::BLEZ:
+            case Instruction::BLTZ:
+                reads = 1 << insn.rs();
+                branch = true;
+                target = address + 4 + insn.imm() * 4;
+                break;
+            case Instruction::J:
+                branch = true;
+                target = ((address + 4) & 0xf0000000) | (insn.target() << 2);
+                break;
+            default:
+                return {};
+        }
+
+        if (branch) {
+            // A branch in a delay slot, or a branch without its delay slot in view.
+            if (inDelaySlot || (i + 1 >= count)) return {};
+            if (target == pc) {
+                closingBranch = i;
+            } else if (insn.mnemonic() == Instruction::J) {
+                return {};
+            } else {
+                exits[exitCount++] = target;
+            }
+        }
+        // A load in the delay slot of the closing branch would only land in the middle of the next iteration.
+        if (load && (i == closingBranch + 1)) return {};
+
+        reads &= ~1;
+        writes &= ~1;
+        carried |= reads & ~written;
+        written |= pendingLoad;
+        if (writes & pendingLoad) return {};
+        pendingLoad = 0;
+        if (load) {
+            pendingLoad = writes;
+        } else {
+            written |= writes;
+        }
+        allWritten |= writes;
+
+        if (i == closingBranch + 1) {
+            loop.length = i + 1;
+            break;
+        }
+        inDelaySlot = branch;
+    }
+
+    if (loop.length == 0) return {};
+    if (carried & allWritten) return {};
+    const uint32_t end = pc + loop.length * 4;
+    for (unsigned i = 0; i < exitCount; i++) {
+        if ((exits[i] >= pc) && (exits[i] < end)) return {};
+    }
+    for (unsigned i = 0; i < loop.loadCount; i++) {
+        if (allWritten & (1 << loop.loads[i].base)) return {};
+    }
+
+    return loop;
+}
+
+bool PCSX::IdleLoop::isStableAddress(uint32_t address, unsigned size) {
+    // KSEG2 only has the cache control register.
+    if (address >= 0xc0000000) return false;
+    const uint32_t physical = address & 0x1fffffff;
+
+    if (physical < 0x00800000) return true;                                // RAM, and its mirrors
+    if ((physical >= 0x1f800000) && (physical < 0x1f800400)) return true;  // Scratchpad
+    if ((physical >= 0x1fc00000) && (physical < 0x1fc80000)) return true;  // BIOS
+    if ((physical >= 0x1f801080) && (physical < 0x1f801100)) return true;  // DMA registers
+
+    switch (physical & ~3) {
+        case 0x1f801070:  // ISTAT
+        case 0x1f801074:  // IMASK
+        case 0x1f801814:  // GPUSTAT
+            return true;
+        case 0x1f801800:
+            // Only the CD-ROM status register. The other ones are fifos.
+            return (physical == 0x1f801800) && (size == 1);
+    }
+
+    return false;
+}
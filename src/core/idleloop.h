@@ -0,0 +1,61 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace PCSX {
+
+namespace IdleLoop {
+
+static constexpr unsigned MAX_INSTRUCTIONS = 16;
+static constexpr unsigned MAX_LOADS = 4;
+
+struct Load {
+    uint8_t base;
+    uint8_t size;
+    int16_t offset;
+};
+
+// An idle loop is one which, given the same memory contents, does the exact same thing on every iteration,
+// and never writes anywhere. Once it's been through one iteration without getting out, it can only get out
+// after something else changed the state of the machine, meaning an interrupt or a hardware event.
+struct Loop {
+    // In instructions, including the delay slot of the branch going back to the start. 0 if this isn't an
+    // idle loop.
+    unsigned length = 0;
+    // The loads the loop does, which need to be checked against isStableAddress before skipping over it.
+    // Their base registers are never written by the loop.
+    unsigned loadCount = 0;
+    Load loads[MAX_LOADS];
+};
+
+// Looks at the instructions starting at pc, of which there are count in code, for an idle loop going
+// back to pc. Only ALU operations, loads and branches are allowed in there, and the registers the loop
+// writes mustn't be read before being written in the same iteration.
+Loop analyze(const uint32_t* code, unsigned count, uint32_t pc);
+
+// Whether a load from this address returns the same value until the next interrupt or hardware event, and
+// has no side effect. That's RAM, the scratchpad, the BIOS, and a handful of hardware status registers.
+bool isStableAddress(uint32_t address, unsigned size);
+
+}  // namespace IdleLoop
+
+}  // namespace PCSX
@@ -33,6 +33,7 @@ void deleteIso(LuaIso* wrapper);
 bool isIsoFailed(LuaIso* wrapper);
 void isoClearPPF(LuaIso* wrapper);
 void isoSavePPF(LuaIso* wrapper);
+bool isoExportManifest(LuaIso* wrapper, const char* store, const char* manifest);
 LuaIso* getCurrentIso();
 LuaIso* openIso(const char* path);
 LuaIso* openIsoFromFile(LuaFile* wrapper);
@@ -50,6 +51,17 @@ void isoBuilderWriteLicense(ISO9660Builder* builder, LuaFile*);
 void isoBuilderWriteSector(ISO9660Builder* builder, const uint8_t* sectorData, enum SectorMode mode);
 void isoBuilderClose(ISO9660Builder* builder);
 
+typedef struct { char opaque[?]; } LuaDiscHasher;
+LuaDiscHasher* isoStartHashing(LuaIso* wrapper);
+void deleteDiscHasher(LuaDiscHasher* wrapper);
+bool discHasherDone(LuaDiscHasher* wrapper);
+bool discHasherFailed(LuaDiscHasher* wrapper);
+bool discHasherMemoised(LuaDiscHasher* wrapper);
+float discHasherProgress(LuaDiscHasher* wrapper);
+unsigned discHasherTrackCount(LuaDiscHasher* wrapper);
+uint32_t discHasherCRC32(LuaDiscHasher* wrapper, unsigned track);
+void discHasherMD5(LuaDiscHasher* wrapper, unsigned track, char out[33]);
+
 ]]
 
 local C = ffi.load 'CORE_ISO'
@@ -62,6 +74,24 @@ local function createIsoReaderWrapper(isoReader)
     return reader
 end
 
+local function createDiscHasherWrapper(wrapper)
+    local hasher = {
+        _wrapper = ffi.gc(wrapper, C.deleteDiscHasher),
+        done = function(self) return C.discHasherDone(self._wrapper) end,
+        failed = function(self) return C.discHasherFailed(self._wrapper) end,
+        memoised = function(self) return C.discHasherMemoised(self._wrapper) end,
+        progress = function(self) return C.discHasherProgress(self._wrapper) end,
+        trackCount = function(self) return C.discHasherTrackCount(self._wrapper) end,
+        crc32 = function(self, track) return C.discHasherCRC32(self._wrapper, track or 0) end,
+        md5 = function(self, track)
+            local out = ffi.new('char[33]')
+            C.discHasherMD5(self._wrapper, track or 0, out)
+            return ffi.string(out)
+        end,
+    }
+    return hasher
+end
+
 local function createIsoWrapper(wrapper)
     local iso = {
         _wrapper = ffi.gc(wrapper, C.deleteIso),
@@ -69,6 +99,8 @@ local function createIsoWrapper(wrapper)
         createReader = function(self) return createIsoReaderWrapper(C.createIsoReader(self._wrapper)) end,
         clearPPF = function(self) C.isoClearPPF(self._wrapper) end,
         savePPF = function(self) C.isoSavePPF(self._wrapper) end,
+        exportManifest = function(self, store, manifest) return C.isoExportManifest(self._wrapper, store, manifest) end,
+        startHashing = function(self) return createDiscHasherWrapper(C.isoStartHashing(self._wrapper)) end,
         open = function(self, lba, size, mode)
             if type(size) == 'string' and mode == nil then
                 mode = size
@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -37,6 +38,59 @@ const char* getA0name(uint32_t call);
 const char* getB0name(uint32_t call);
 const char* getC0name(uint32_t call);
 
+// A BIOS call, as recorded by the kernel log. Only the raw registers get kept when the call happens, along
+// with the strings its first two arguments may point to, and turning all this into text is left for when
+// it gets displayed. Whatever else the decoding reads from memory, such as file structures, is as it is then.
+struct Call {
+    static constexpr unsigned STRING_SIZE = 48;
+    uint64_t cycle;
+    uint16_t table;  // 0xa0, 0xb0 or 0xc0
+    uint16_t call;
+    struct {
+        uint32_t a0, a1, a2, a3, ra;
+        // The fifth argument, on the stack.
+        uint32_t arg4;
+    } regs;
+    char strings[2][STRING_SIZE];
+};
+
+// The most recent calls, oldest first, with the older ones dropped once full.
+class CallLog {
+  public:
+    static constexpr size_t CAPACITY = 16384;
+    CallLog() : m_calls(new Call[CAPACITY]) {}
+    Call& push() {
+        Call& call = m_calls[(m_first + m_size) % CAPACITY];
+        if (m_size == CAPACITY) {
+            m_first = (m_first + 1) % CAPACITY;
+        } else {
+            m_size++;
+        }
+        m_total++;
+        return call;
+    }
+    const Call& operator[](size_t index) const { return m_calls[(m_first + index) % CAPACITY]; }
+    size_t size() const { return m_size; }
+    // How many calls got recorded since the last clear, dropped ones included.
+    uint64_t total() const { return m_total; }
+    void clear() {
+        m_first = m_size = 0;
+        m_total = 0;
+    }
+
+    static std::string decode(const Call& call, IO<File> memory);
+
+  private:
+    static std::string decodeA0(const Call& call, IO<File> memory);
+    static std::string decodeB0(const Call& call, IO<File> memory);
+    static std::string decodeC0(const Call& call, IO<File> memory);
+
+    std::unique_ptr<Call[]> m_calls;
+    size_t m_first = 0;
+    size_t m_size = 0;
+    uint64_t m_total = 0;
+};
+
 namespace Events {
 
 class Event {
@@ -117,6 +117,46 @@ static const char *fileActionToString(uint32_t action) {
     return "<UKNOWN>";
 }
 
+// Copies the string at this address, if any, without any of the overhead of going through a file.
+static void snapshotString(char *dst, uint32_t address) {
+    auto &mem = PCSX::g_emulator->m_mem;
+    for (unsigned i = 0; i < PCSX::Kernel::Call::STRING_SIZE - 1; i++) {
+        auto ptr = static_cast<const char *>(mem->pointerRead(address + i));
+        dst[i] = ptr ? *ptr : 0;
+        if (dst[i] == 0) return;
+    }
+    dst[PCSX::Kernel::Call::STRING_SIZE - 1] = 0;
+}
+
+void PCSX::R3000Acpu::recordKernelCall(uint16_t table, uint32_t call) {
+    auto &n = m_regs.GPR.n;
+    auto &record = m_kernelCalls.push();
+    record.cycle = m_regs.cycle;
+    record.table = table;
+    record.call = call;
+    record.regs.a0 = n.a0;
+    record.regs.a1 = n.a1;
+    record.regs.a2 = n.a2;
+    record.regs.a3 = n.a3;
+    record.regs.ra = n.ra;
+    auto arg4 = static_cast<const uint32_t *>(g_emulator->m_mem->pointerRead(n.sp + 0x10));
+    record.regs.arg4 = arg4 ? *arg4 : 0;
+    snapshotString(record.strings[0], n.a0);
+    snapshotString(record.strings[1], n.a1);
+}
+
+std::string PCSX::Kernel::CallLog::decode(const Call &call, IO<File> memory) {
+    switch (call.table) {
+        case 0xa0:
+            return decodeA0(call, memory);
+        case 0xb0:
+            return decodeB0(call, memory);
+        case 0xc0:
+            return decodeC0(call, memory);
+    }
+    return {};
+}
+
 static const char *const A0names[] = {
     // 00
     "open", "lseek", "read", "write", "close", "ioctl", "exit", "isFileConsole", "getc", "putc", "todigit", nullptr,
@@ -193,605 +233,601 @@ void PCSX::R3000Acpu::logA0KernelCall(uint32_t call) {
     }
     uint32_t bit = 1 << (call % 32);
     if (!flags || ((*flags & bit) == 0)) return;
-    auto &n = m_regs.GPR.n;
-    const char *const name = Kernel::getA0name(call);
-    if (name) g_system->log(LogClass::KERNEL, "KernelCall A0:%02X:%s(", call, name);
+    recordKernelCall(0xa0, call);
+}
 
-    IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
-    memFile->rSeek(n.a0);
-    auto s0 = memFile->gets<false>();
-    memFile->rSeek(n.a1);
-    auto s1 = memFile->gets<false>();
+std::string PCSX::Kernel::CallLog::decodeA0(const Call &c, IO<File> memFile) {
+    const uint32_t call = c.call;
+    const auto &n = c.regs;
+    const char *const s0 = c.strings[0];
+    const char *const s1 = c.strings[1];
+    std::string ret;
+    const char *const name = getA0name(call);
+    if (name) ret += fmt::sprintf("KernelCall A0:%02X:%s(", call, name);
 
     switch (call) {
         case 0x00: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%04x {%s})", n.a0, s0, n.a1, fileFlagsToString(n.a1));
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%04x {%s})", n.a0, s0, n.a1, fileFlagsToString(n.a1));
             break;
         }
         case 0x01: {
-            g_system->log(LogClass::KERNEL, "%i, %i, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, %i, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x02: {
-            g_system->log(LogClass::KERNEL, "%i, 0x%08x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, 0x%08x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x03: {
-            g_system->log(LogClass::KERNEL, "%i, 0x%08x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, 0x%08x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x04: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x05: {
-            g_system->log(LogClass::KERNEL, "%i, %i, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, %i, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x06: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x07: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x08: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x09: {
-            g_system->log(LogClass::KERNEL, "%i, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, %i)", n.a0, n.a1);
             break;
         }
         case 0x0a: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x0c: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\",  0x%08x, %i)", n.a0, s0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x:\"%s\",  0x%08x, %i)", n.a0, s0, n.a1, n.a2);
             break;
         }
         case 0x0d: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\",  0x%08x, %i)", n.a0, s0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x:\"%s\",  0x%08x, %i)", n.a0, s0, n.a1, n.a2);
             break;
         }
         case 0x0e: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x0f: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x10: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x11: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x12: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x)", n.a0, s0, n.a1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x)", n.a0, s0, n.a1);
             break;
         }
         case 0x13: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x14: {
-            g_system->log(LogClass::KERNEL, "0x%08x, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("0x%08x, %i)", n.a0, n.a1);
             break;
         }
         case 0x15: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
             break;
         }
         case 0x16: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\", %i)", n.a0, s0, n.a1, s1, n.a2);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\", %i)", n.a0, s0, n.a1, s1, n.a2);
             break;
         }
         case 0x17: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
             break;
         }
         case 0x18: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\", %i)", n.a0, s0, n.a1, s1, n.a2);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\", %i)", n.a0, s0, n.a1, s1, n.a2);
             break;
         }
         case 0x19: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x:\"%s\")", n.a0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x, 0x%08x:\"%s\")", n.a0, n.a1, s1);
             break;
         }
         case 0x1a: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x:\"%s\", %i)", n.a0, n.a1, s1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%08x:\"%s\", %i)", n.a0, n.a1, s1, n.a2);
             break;
         }
         case 0x1b: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x1c: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", '%c')", n.a0, s0, n.a1);
+            ret += fmt::sprintf("0x%08x:\"%s\", '%c')", n.a0, s0, n.a1);
             break;
         }
         case 0x1d: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", '%c')", n.a0, s0, n.a1);
+            ret += fmt::sprintf("0x%08x:\"%s\", '%c')", n.a0, s0, n.a1);
             break;
         }
         case 0x1e: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", '%c')", n.a0, s0, n.a1);
+            ret += fmt::sprintf("0x%08x:\"%s\", '%c')", n.a0, s0, n.a1);
             break;
         }
         case 0x1f: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", '%c')", n.a0, s0, n.a1);
+            ret += fmt::sprintf("0x%08x:\"%s\", '%c')", n.a0, s0, n.a1);
             break;
         }
         case 0x20: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
             break;
         }
         case 0x21: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
             break;
         }
         case 0x22: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
             break;
         }
         case 0x23: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
             break;
         }
         case 0x24: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
             break;
         }
         case 0x25: {
-            g_system->log(LogClass::KERNEL, "'%c')", n.a0);
+            ret += fmt::sprintf("'%c')", n.a0);
             break;
         }
         case 0x26: {
-            g_system->log(LogClass::KERNEL, "'%c')", n.a0);
+            ret += fmt::sprintf("'%c')", n.a0);
             break;
         }
         case 0x27: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x28: {
-            g_system->log(LogClass::KERNEL, "0x%08x, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("0x%08x, %i)", n.a0, n.a1);
             break;
         }
         case 0x29: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x2a: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x2b: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%02x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%02x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x2c: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x2d: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%08x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x2e: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%02x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%02x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x2f: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x30: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x31: {
-            g_system->log(LogClass::KERNEL, "0x%08x, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3);
+            ret += fmt::sprintf("0x%08x, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3);
             break;
         }
         case 0x32: {
-            g_system->log(LogClass::KERNEL, "\"%s\", 0x%08x)", n.a0, n.a1);
+            ret += fmt::sprintf("\"%s\", 0x%08x)", n.a0, n.a1);
             break;
         }
         case 0x33: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x34: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x35: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3,
-                          memFile->readAt<uint32_t>(n.sp + 0x10));
+            ret += fmt::sprintf("0x%08x, 0x%08x, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3, n.arg4);
             break;
         }
         case 0x36: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3,
-                          memFile->readAt<uint32_t>(n.sp + 0x10));
+            ret += fmt::sprintf("0x%08x, 0x%08x, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3, n.arg4);
             break;
         }
         case 0x37: {
-            g_system->log(LogClass::KERNEL, "%i, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, %i)", n.a0, n.a1);
             break;
         }
         case 0x38: {
-            g_system->log(LogClass::KERNEL, "0x%08x, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("0x%08x, %i)", n.a0, n.a1);
             break;
         }
         case 0x39: {
-            g_system->log(LogClass::KERNEL, "0x%08x, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("0x%08x, %i)", n.a0, n.a1);
             break;
         }
         case 0x3a: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x3b: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x3c: {
-            g_system->log(LogClass::KERNEL, "'%c')", n.a0);
+            ret += fmt::sprintf("'%c')", n.a0);
             break;
         }
         case 0x3d: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x3e: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x3f: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", ...)", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\", ...)", n.a0, s0);
             break;
         }
         case 0x40: {
-            g_system->log(LogClass::KERNEL, ")", s0);
+            ret += fmt::sprintf(")", s0);
             break;
         }
         case 0x41: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x)", n.a0, s0, n.a1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x)", n.a0, s0, n.a1);
             break;
         }
         case 0x42: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x)", n.a0, s0, n.a1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x)", n.a0, s0, n.a1);
             break;
         }
         case 0x43: {
             uint32_t newPc = memFile->readAt<uint32_t>(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {.pc = 0x%08x}, %i, 0x%08x)", n.a0, newPc, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x {.pc = 0x%08x}, %i, 0x%08x)", n.a0, newPc, n.a1, n.a2);
             break;
         }
         case 0x44: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x45: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x46: {
-            g_system->log(LogClass::KERNEL, "%i, %i, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3,
-                          memFile->readAt<uint32_t>(n.sp + 0x10));
+            ret += fmt::sprintf("%i, %i, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3, n.arg4);
             break;
         }
         case 0x47: {
-            g_system->log(LogClass::KERNEL, "%i, %i, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3,
-                          memFile->readAt<uint32_t>(n.sp + 0x10));
+            ret += fmt::sprintf("%i, %i, %i, %i, 0x%08x)", n.a0, n.a1, n.a2, n.a3, n.arg4);
             break;
         }
         case 0x48: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x49: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x4a: {
-            g_system->log(LogClass::KERNEL, "0x%08x, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("0x%08x, %i)", n.a0, n.a1);
             break;
         }
         case 0x4b: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x4c: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x4d: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x4e: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x51: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x, 0x%08x)", n.a0, s0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x, 0x%08x)", n.a0, s0, n.a1, n.a2);
             break;
         }
         case 0x54: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x55: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x56: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x5b: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x5c: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, 0x%08x:\"%s\", 0x%04x {%s})", n.a0, fileToString(memFile),
-                          n.a1, s1, n.a2, fileFlagsToString(n.a2));
+            ret += fmt::sprintf("0x%08x {%s}, 0x%08x:\"%s\", 0x%04x {%s})", n.a0, fileToString(memFile), n.a1, s1, n.a2,
+                                fileFlagsToString(n.a2));
             break;
         }
         case 0x5d: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, %i {%s})", n.a0, fileToString(memFile), n.a1,
-                          fileActionToString(n.a1));
+            ret += fmt::sprintf("0x%08x {%s}, %i {%s})", n.a0, fileToString(memFile), n.a1, fileActionToString(n.a1));
             break;
         }
         case 0x5e: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, %i, %i)", n.a0, fileToString(memFile), n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x {%s}, %i, %i)", n.a0, fileToString(memFile), n.a1, n.a2);
             break;
         }
         case 0x5f: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, 0x%08x:\"%s\", 0x%04x {%s})", n.a0, fileToString(memFile),
-                          n.a1, s1, n.a2, fileFlagsToString(n.a2));
+            ret += fmt::sprintf("0x%08x {%s}, 0x%08x:\"%s\", 0x%04x {%s})", n.a0, fileToString(memFile), n.a1, s1, n.a2,
+                                fileFlagsToString(n.a2));
             break;
         }
         case 0x60: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, 0x%08x, %i)", n.a0, fileToString(memFile), n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x {%s}, 0x%08x, %i)", n.a0, fileToString(memFile), n.a1, n.a2);
             break;
         }
         case 0x61: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s})", n.a0, fileToString(memFile));
+            ret += fmt::sprintf("0x%08x {%s})", n.a0, fileToString(memFile));
             break;
         }
         case 0x62: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, %08x:\"%s\", 0x%08x)", n.a0, fileToString(memFile), n.a1, s1,
-                          n.a2);
+            ret += fmt::sprintf("0x%08x {%s}, %08x:\"%s\", 0x%08x)", n.a0, fileToString(memFile), n.a1, s1, n.a2);
             break;
         }
         case 0x63: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, 0x%08x)", n.a0, fileToString(memFile), n.a1);
+            ret += fmt::sprintf("0x%08x {%s}, 0x%08x)", n.a0, fileToString(memFile), n.a1);
             break;
         }
         case 0x64: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, 0x%08x:\"%s\")", n.a0, fileToString(memFile), n.a1, s1);
+            ret += fmt::sprintf("0x%08x {%s}, 0x%08x:\"%s\")", n.a0, fileToString(memFile), n.a1, s1);
             break;
         }
         case 0x65: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, 0x%08x:\"%s\", 0x%04x {%s})", n.a0, fileToString(memFile),
-                          n.a1, s1, n.a2, fileFlagsToString(n.a2));
+            ret += fmt::sprintf("0x%08x {%s}, 0x%08x:\"%s\", 0x%04x {%s})", n.a0, fileToString(memFile), n.a1, s1, n.a2,
+                                fileFlagsToString(n.a2));
             break;
         }
         case 0x66: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, 0x%08x, %i)", n.a0, fileToString(memFile), n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x {%s}, 0x%08x, %i)", n.a0, fileToString(memFile), n.a1, n.a2);
             break;
         }
         case 0x67: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, 0x%08x, %i)", n.a0, fileToString(memFile), n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x {%s}, 0x%08x, %i)", n.a0, fileToString(memFile), n.a1, n.a2);
             break;
         }
         case 0x68: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s})", n.a0, fileToString(memFile));
+            ret += fmt::sprintf("0x%08x {%s})", n.a0, fileToString(memFile));
             break;
         }
         case 0x69: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, %08x:\"%s\", 0x%08x)", n.a0, fileToString(memFile), n.a1, s1,
-                          n.a2);
+            ret += fmt::sprintf("0x%08x {%s}, %08x:\"%s\", 0x%08x)", n.a0, fileToString(memFile), n.a1, s1, n.a2);
             break;
         }
         case 0x6a: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s}, 0x%08x)", n.a0, fileToString(memFile), n.a1);
+            ret += fmt::sprintf("0x%08x {%s}, 0x%08x)", n.a0, fileToString(memFile), n.a1);
             break;
         }
         case 0x6f: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s})", n.a0, fileToString(memFile));
+            ret += fmt::sprintf("0x%08x {%s})", n.a0, fileToString(memFile));
             break;
         }
         case 0x70: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x71: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x72: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x78: {
             uint8_t m = memFile->readAt<uint8_t>(n.a0);
             uint8_t s = memFile->readAt<uint8_t>(n.a0 + 1);
             uint8_t f = memFile->readAt<uint8_t>(n.a0 + 2);
-            g_system->log(LogClass::KERNEL, "0x%08x {%02x:%02x:%02x})", n.a0, m, s, f);
+            ret += fmt::sprintf("0x%08x {%02x:%02x:%02x})", n.a0, m, s, f);
             break;
         }
         case 0x7c: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x7e: {
-            g_system->log(LogClass::KERNEL, "%i, 0x%08x, 0x%02x)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, 0x%08x, 0x%02x)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x81: {
-            g_system->log(LogClass::KERNEL, "0x%02x)", n.a0);
+            ret += fmt::sprintf("0x%02x)", n.a0);
             break;
         }
         case 0x90: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x91: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x92: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x93: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x94: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x)", n.a0, n.a1);
+            ret += fmt::sprintf("0x%08x, 0x%08x)", n.a0, n.a1);
             break;
         }
         case 0x95: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x96: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x97: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x98: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x99: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x9c: {
-            g_system->log(LogClass::KERNEL, "%i, %i, 0x%08x)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, %i, 0x%08x)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x9d: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x, 0x%08x)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%08x, 0x%08x)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x9e: {
-            g_system->log(LogClass::KERNEL, "%i, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, %i)", n.a0, n.a1);
             break;
         }
         case 0x9f: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0xa0: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0xa1: {
-            g_system->log(LogClass::KERNEL, "%i, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, %i)", n.a0, n.a1);
             break;
         }
         case 0xa2: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0xa3: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0xa4: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0xa5: {
-            g_system->log(LogClass::KERNEL, "%i, %i, 0x%08x)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, %i, 0x%08x)", n.a0, n.a1, n.a2);
             break;
         }
         case 0xa6: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0xa7: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0xa8: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0xa9: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0xaa: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0xab: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0xac: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0xad: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0xae: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0xaf: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0xb2: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0xb4: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         default: {
-            g_system->log(LogClass::KERNEL, "KernelCall: unknown kernel call A0:%02X", call);
+            ret += fmt::sprintf("KernelCall: unknown kernel call A0:%02X", call);
             break;
         }
     }
-    g_system->log(LogClass::KERNEL, " from 0x%08x\n", n.ra);
+    ret += fmt::sprintf(" from 0x%08x", n.ra);
+    return ret;
 }
 
 static const char *const B0names[] = {
@@ -842,301 +878,304 @@ void PCSX::R3000Acpu::logB0KernelCall(uint32_t call) {
     }
     uint32_t bit = 1 << (call % 32);
     if (!flags || ((*flags & bit) == 0)) return;
-    auto &n = m_regs.GPR.n;
-    const char *const name = Kernel::getB0name(call);
-    if (name) g_system->log(LogClass::KERNEL, "KernelCall B0:%02X:%s(", call, name);
-    IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
-    memFile->rSeek(n.a0);
-    auto s0 = memFile->gets<false>();
-    memFile->rSeek(n.a1);
-    auto s1 = memFile->gets<false>();
+    recordKernelCall(0xb0, call);
+}
+
+std::string PCSX::Kernel::CallLog::decodeB0(const Call &c, IO<File> memFile) {
+    const uint32_t call = c.call;
+    const auto &n = c.regs;
+    const char *const s0 = c.strings[0];
+    const char *const s1 = c.strings[1];
+    std::string ret;
+    const char *const name = getB0name(call);
+    if (name) ret += fmt::sprintf("KernelCall B0:%02X:%s(", call, name);
 
     switch (call) {
         case 0x00: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x01: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x02: {
-            g_system->log(LogClass::KERNEL, "%i, %i, 0x%04x)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, %i, 0x%04x)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x03: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x04: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x05: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x06: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x07: {
-            g_system->log(LogClass::KERNEL, "%s, %s)", Kernel::Events::Event::resolveClass(n.a0).c_str(),
-                          Kernel::Events::Event::resolveSpec(n.a1).c_str());
+            ret += fmt::sprintf("%s, %s)", Kernel::Events::Event::resolveClass(n.a0).c_str(),
+                                Kernel::Events::Event::resolveSpec(n.a1).c_str());
             break;
         }
         case 0x08: {
             int id = Kernel::Events::getFirstFreeEvent(memFile);
-            g_system->log(LogClass::KERNEL, "%s, %s, %s, 0x%08x) --> 0x%08x",
-                          Kernel::Events::Event::resolveClass(n.a0).c_str(),
-                          Kernel::Events::Event::resolveSpec(n.a1).c_str(),
-                          Kernel::Events::Event::resolveMode(n.a2).c_str(), n.a3, id | 0xf1000000);
+            ret += fmt::sprintf("%s, %s, %s, 0x%08x) --> 0x%08x", Kernel::Events::Event::resolveClass(n.a0).c_str(),
+                                Kernel::Events::Event::resolveSpec(n.a1).c_str(),
+                                Kernel::Events::Event::resolveMode(n.a2).c_str(), n.a3, id | 0xf1000000);
             break;
         }
         case 0x09: {
             Kernel::Events::Event ev{memFile, n.a0};
-            g_system->log(LogClass::KERNEL, "0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
+            ret += fmt::sprintf("0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
             break;
         }
         case 0x0a: {
             Kernel::Events::Event ev{memFile, n.a0};
-            g_system->log(LogClass::KERNEL, "0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
+            ret += fmt::sprintf("0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
             break;
         }
         case 0x0b: {
             Kernel::Events::Event ev{memFile, n.a0};
-            g_system->log(LogClass::KERNEL, "0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
+            ret += fmt::sprintf("0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
             break;
         }
         case 0x0c: {
             Kernel::Events::Event ev{memFile, n.a0};
-            g_system->log(LogClass::KERNEL, "0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
+            ret += fmt::sprintf("0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
             break;
         }
         case 0x0d: {
             Kernel::Events::Event ev{memFile, n.a0};
-            g_system->log(LogClass::KERNEL, "0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
+            ret += fmt::sprintf("0x%08x {%s, %s})", n.a0, ev.getClass().c_str(), ev.getSpec().c_str());
             break;
         }
         case 0x0e: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x, 0x%08x)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("0x%08x, 0x%08x, 0x%08x)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x0f: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x10: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x12: {
-            g_system->log(LogClass::KERNEL, "0x%08x, %i, 0x%08x, %i)", n.a0, n.a1, n.a2, n.a3);
+            ret += fmt::sprintf("0x%08x, %i, 0x%08x, %i)", n.a0, n.a1, n.a2, n.a3);
             break;
         }
         case 0x13: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x14: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x15: {
-            g_system->log(LogClass::KERNEL, "%i, 0x%08x, ...)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, 0x%08x, ...)", n.a0, n.a1);
             break;
         }
         case 0x16: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x17: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x18: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x19: {
             uint32_t ra = memFile->readAt<uint32_t>(n.a0);
             uint32_t sp = memFile->readAt<uint32_t>(n.a0 + 4);
-            g_system->log(LogClass::KERNEL, "0x%08x {.ra = 0x%08x, .sp = 0x%08x})", n.a0, ra, sp);
+            ret += fmt::sprintf("0x%08x {.ra = 0x%08x, .sp = 0x%08x})", n.a0, ra, sp);
             break;
         }
         case 0x20: {
-            g_system->log(LogClass::KERNEL, "%s, %s)", Kernel::Events::Event::resolveClass(n.a0).c_str(),
-                          Kernel::Events::Event::resolveSpec(n.a1).c_str());
+            ret += fmt::sprintf("%s, %s)", Kernel::Events::Event::resolveClass(n.a0).c_str(),
+                                Kernel::Events::Event::resolveSpec(n.a1).c_str());
             break;
         }
         case 0x32: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%04x {%s})", n.a0, s0, n.a1, fileFlagsToString(n.a1));
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%04x {%s})", n.a0, s0, n.a1, fileFlagsToString(n.a1));
             break;
         }
         case 0x33: {
-            g_system->log(LogClass::KERNEL, "%i, %i, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, %i, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x34: {
-            g_system->log(LogClass::KERNEL, "%i, 0x%08x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, 0x%08x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x35: {
-            g_system->log(LogClass::KERNEL, "%i, 0x%08x, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, 0x%08x, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x36: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x37: {
-            g_system->log(LogClass::KERNEL, "%i, %i, %i)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, %i, %i)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x38: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x39: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x3a: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x3b: {
-            g_system->log(LogClass::KERNEL, "%i, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, %i)", n.a0, n.a1);
             break;
         }
         case 0x3c: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x3d: {
-            g_system->log(LogClass::KERNEL, "'%c')", n.a0);
+            ret += fmt::sprintf("'%c')", n.a0);
             break;
         }
         case 0x3e: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x3f: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x40: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x41: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x42: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x)", n.a0, s0, n.a1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x)", n.a0, s0, n.a1);
             break;
         }
         case 0x43: {
-            g_system->log(LogClass::KERNEL, "0x%08x)", n.a0);
+            ret += fmt::sprintf("0x%08x)", n.a0);
             break;
         }
         case 0x44: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
             break;
         }
         case 0x45: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x46: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x47: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s})", n.a0, deviceToString(memFile));
+            ret += fmt::sprintf("0x%08x {%s})", n.a0, deviceToString(memFile));
             break;
         }
         case 0x48: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x49: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x4a: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x4b: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x4c: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x4d: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x4e: {
-            g_system->log(LogClass::KERNEL, "%i, %i, 0x%08x)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, %i, 0x%08x)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x4f: {
-            g_system->log(LogClass::KERNEL, "%i, %i, 0x%08x)", n.a0, n.a1, n.a2);
+            ret += fmt::sprintf("%i, %i, 0x%08x)", n.a0, n.a1, n.a2);
             break;
         }
         case 0x50: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x51: {
-            g_system->log(LogClass::KERNEL, "0x%04x)", n.a0);
+            ret += fmt::sprintf("0x%04x)", n.a0);
             break;
         }
         case 0x53: {
-            g_system->log(LogClass::KERNEL, "0x%04x)", n.a0);
+            ret += fmt::sprintf("0x%04x)", n.a0);
             break;
         }
         case 0x54: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x55: {
             memFile->rSeek(n.a0);
-            g_system->log(LogClass::KERNEL, "0x%08x {%s})", n.a0, fileToString(memFile));
+            ret += fmt::sprintf("0x%08x {%s})", n.a0, fileToString(memFile));
             break;
         }
         case 0x56: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x57: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x58: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x59: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\")", n.a0, s0);
+            ret += fmt::sprintf("0x%08x:\"%s\")", n.a0, s0);
             break;
         }
         case 0x5b: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         default: {
-            g_system->log(LogClass::KERNEL, "KernelCall: unknown kernel call B0:%02X", call);
+            ret += fmt::sprintf("KernelCall: unknown kernel call B0:%02X", call);
             break;
         }
     }
-    g_system->log(LogClass::KERNEL, " from 0x%08x\n", n.ra);
+    ret += fmt::sprintf(" from 0x%08x", n.ra);
+    return ret;
 }
 
 static const char *const C0names[] = {
@@ -1168,112 +1207,116 @@ void PCSX::R3000Acpu::logC0KernelCall(uint32_t call) {
     }
     uint32_t bit = 1 << (call % 32);
     if (!flags || ((*flags & bit) == 0)) return;
-    auto &n = m_regs.GPR.n;
-    const char *const name = Kernel::getC0name(call);
-    if (name) g_system->log(LogClass::KERNEL, "KernelCall C0:%02X:%s(", call, name);
-    IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
-    memFile->rSeek(n.a0);
-    auto s0 = memFile->gets<false>();
-    memFile->rSeek(n.a1);
-    auto s1 = memFile->gets<false>();
+    recordKernelCall(0xc0, call);
+}
+
+std::string PCSX::Kernel::CallLog::decodeC0(const Call &c, IO<File> memFile) {
+    const uint32_t call = c.call;
+    const auto &n = c.regs;
+    const char *const s0 = c.strings[0];
+    const char *const s1 = c.strings[1];
+    std::string ret;
+    const char *const name = getC0name(call);
+    if (name) ret += fmt::sprintf("KernelCall C0:%02X:%s(", call, name);
 
     switch (call) {
         case 0x00: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x01: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x02: {
-            g_system->log(LogClass::KERNEL, "%i, 0x%08x)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, 0x%08x)", n.a0, n.a1);
             break;
         }
         case 0x03: {
-            g_system->log(LogClass::KERNEL, "%i, 0x%08x)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, 0x%08x)", n.a0, n.a1);
             break;
         }
         case 0x04: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x05: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x06: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x07: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x08: {
-            g_system->log(LogClass::KERNEL, "0x%08x, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("0x%08x, %i)", n.a0, n.a1);
             break;
         }
         case 0x0a: {
-            g_system->log(LogClass::KERNEL, "%i, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, %i)", n.a0, n.a1);
             break;
         }
         case 0x0c: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x0d: {
-            g_system->log(LogClass::KERNEL, "%i, %i)", n.a0, n.a1);
+            ret += fmt::sprintf("%i, %i)", n.a0, n.a1);
             break;
         }
         case 0x12: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x13: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x15: {
-            g_system->log(LogClass::KERNEL, "0x%08x, '%c')", n.a0, n.a1);
+            ret += fmt::sprintf("0x%08x, '%c')", n.a0, n.a1);
             break;
         }
         case 0x16: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x17: {
-            g_system->log(LogClass::KERNEL, "0x%08x, 0x%08x:\"%s\")", n.a0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x, 0x%08x:\"%s\")", n.a0, n.a1, s1);
             break;
         }
         case 0x18: {
-            g_system->log(LogClass::KERNEL, "'%c', 0x%08x)", n.a0, n.a1);
+            ret += fmt::sprintf("'%c', 0x%08x)", n.a0, n.a1);
             break;
         }
         case 0x19: {
-            g_system->log(LogClass::KERNEL, "0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
+            ret += fmt::sprintf("0x%08x:\"%s\", 0x%08x:\"%s\")", n.a0, s0, n.a1, s1);
             break;
         }
         case 0x1a: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x1b: {
-            g_system->log(LogClass::KERNEL, "%i)", n.a0);
+            ret += fmt::sprintf("%i)", n.a0);
             break;
         }
         case 0x1c: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         case 0x1d: {
-            g_system->log(LogClass::KERNEL, ")");
+            ret += fmt::sprintf(")");
             break;
         }
         default: {
-            g_system->log(LogClass::KERNEL, "KernelCall: unknown kernel call C0:%02X", call, m_regs.GPR.n.ra);
+            ret += fmt::sprintf("KernelCall: unknown kernel call C0:%02X", call);
             break;
         }
     }
-    g_system->log(LogClass::KERNEL, " from 0x%08x\n", n.ra);
+    ret += fmt::sprintf(" from 0x%08x", n.ra);
+    return ret;
 }
@@ -54,10 +54,9 @@ enum class LogClass : unsigned {
 template <LogClass logClass, bool enabled>
 struct Logger {
     template <typename... Args>
-    static void Log(const char *format, Args &&...args) {
+    static void Log(const char *format, const Args &...args) {
         if (!enabled) return;
-        std::string s = fmt::sprintf(format, std::forward<Args>(args)...);
-        g_system->log(logClass, std::move(s));
+        g_system->log(logClass, format, args...);
     }
     static void Log(std::string &&s) {
         if (!enabled) return;
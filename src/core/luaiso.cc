@@ -19,9 +19,12 @@
 
 #include "core/luaiso.h"
 
+#include <string.h>
+
 #include <memory>
 
 #include "cdrom/cdriso.h"
+#include "cdrom/disc-hasher.h"
 #include "cdrom/file.h"
 #include "cdrom/iso9660-reader.h"
 #include "core/cdrom.h"
@@ -40,6 +43,10 @@ void deleteIso(LuaIso* wrapper) { delete wrapper; }
 bool isIsoFailed(LuaIso* wrapper) { return wrapper->iso->failed(); }
 void isoClearPPF(LuaIso* wrapper) { wrapper->iso->getPPF()->clear(); }
 void isoSavePPF(LuaIso* wrapper) { wrapper->iso->getPPF()->save(wrapper->iso->getIsoPath()); }
+bool isoExportManifest(LuaIso* wrapper, const char* store, const char* manifest) {
+    PCSX::SectorStore sectorStore(store, true);
+    return wrapper->iso->exportManifest(sectorStore, manifest);
+}
 LuaIso* getCurrentIso() { return new LuaIso(PCSX::g_emulator->m_cdrom->getIso()); }
 LuaIso* openIso(const char* path) { return new LuaIso(std::make_shared<PCSX::CDRIso>(path)); }
 LuaIso* openIsoFromFile(PCSX::LuaFFI::LuaFile* wrapper) {
@@ -69,6 +76,37 @@ void isoBuilderWriteSector(PCSX::ISO9660Builder* builder, const uint8_t* sectorD
 }
 void isoBuilderClose(PCSX::ISO9660Builder* builder) { builder->close(); }
 
+struct LuaDiscHasher {
+    LuaDiscHasher(std::shared_ptr<PCSX::DiscHasher> hasher) : hasher(hasher) {}
+    std::shared_ptr<PCSX::DiscHasher> hasher;
+};
+
+LuaDiscHasher* isoStartHashing(LuaIso* wrapper) {
+    return new LuaDiscHasher(PCSX::DiscHasher::start(wrapper->iso->getIsoPath()));
+}
+void deleteDiscHasher(LuaDiscHasher* wrapper) { delete wrapper; }
+bool discHasherDone(LuaDiscHasher* wrapper) { return wrapper->hasher->done(); }
+bool discHasherFailed(LuaDiscHasher* wrapper) { return wrapper->hasher->failed(); }
+bool discHasherMemoised(LuaDiscHasher* wrapper) { return wrapper->hasher->memoised(); }
+float discHasherProgress(LuaDiscHasher* wrapper) { return wrapper->hasher->progress(); }
+unsigned discHasherTrackCount(LuaDiscHasher* wrapper) { return wrapper->hasher->result().tracks.size(); }
+// Track 0 is the whole disc.
+const PCSX::DiscHasher::Hashes* getHashes(LuaDiscHasher* wrapper, unsigned track) {
+    auto& result = wrapper->hasher->result();
+    if (track == 0) return &result.disc;
+    if (track > result.tracks.size()) return nullptr;
+    return &result.tracks[track - 1];
+}
+uint32_t discHasherCRC32(LuaDiscHasher* wrapper, unsigned track) {
+    auto hashes = getHashes(wrapper, track);
+    return hashes ? hashes->crc32 : 0;
+}
+void discHasherMD5(LuaDiscHasher* wrapper, unsigned track, char out[33]) {
+    auto hashes = getHashes(wrapper, track);
+    out[0] = 0;
+    if (hashes) strncat(out, hashes->md5String().c_str(), 32);
+}
+
 }  // namespace
 
 template <typename T, size_t S>
@@ -89,6 +127,7 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, isIsoFailed);
     REGISTER(L, isoClearPPF);
     REGISTER(L, isoSavePPF);
+    REGISTER(L, isoExportManifest);
     REGISTER(L, getCurrentIso);
     REGISTER(L, openIso);
     REGISTER(L, openIsoFromFile);
@@ -104,6 +143,16 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, isoBuilderWriteSector);
     REGISTER(L, isoBuilderClose);
 
+    REGISTER(L, isoStartHashing);
+    REGISTER(L, deleteDiscHasher);
+    REGISTER(L, discHasherDone);
+    REGISTER(L, discHasherFailed);
+    REGISTER(L, discHasherMemoised);
+    REGISTER(L, discHasherProgress);
+    REGISTER(L, discHasherTrackCount);
+    REGISTER(L, discHasherCRC32);
+    REGISTER(L, discHasherMD5);
+
     L.settable();
     L.pop();
 }
@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/luaprofiler.h"
+
+#include <algorithm>
+#include <set>
+#include <string_view>
+
+#include "core/psxemulator.h"
+#include "fmt/format.h"
+#include "support/file.h"
+
+PCSX::LuaProfiler::Scope::Scope(const char* label)
+    : m_profiler(g_emulator->m_luaProfiler.get()), m_previous(m_profiler->m_scope) {
+    m_profiler->m_scope = label;
+}
+
+PCSX::LuaProfiler::Scope::~Scope() { m_profiler->m_scope = m_previous; }
+
+void PCSX::LuaProfiler::start(Lua L, unsigned interval) {
+    if (m_running) stop();
+    m_L = L.getState();
+    m_interval = std::max(interval, 1u);
+    // Function level granularity, as lines would make for much larger profiles, for little benefit.
+    const auto mode = fmt::format("fi{}", m_interval);
+    luaJIT_profile_start(m_L, mode.c_str(), sample, this);
+    m_running = true;
+}
+
+void PCSX::LuaProfiler::stop() {
+    if (!m_running) return;
+    luaJIT_profile_stop(m_L);
+    m_running = false;
+}
+
+void PCSX::LuaProfiler::sample(void* data, lua_State* L, int samples, int vmstate) {
+    auto profiler = reinterpret_cast<LuaProfiler*>(data);
+    size_t len;
+    const char* frames = luaJIT_profile_dumpstack(L, "pFZ;", -c_maxDepth, &len);
+    std::string stack;
+    if (profiler->m_scope) stack = fmt::format("[{}]", profiler->m_scope);
+    if (len != 0) {
+        if (!stack.empty()) stack += ';';
+        stack.append(frames, len);
+    }
+    // The time spent outside of the scripts proper still gets charged to whatever caused it.
+    const char* state = nullptr;
+    switch (vmstate) {
+        case 'C':
+            state = "[C]";
+            break;
+        case 'G':
+            state = "[GC]";
+            break;
+        case 'J':
+            state = "[JIT compiler]";
+            break;
+    }
+    if (state) {
+        if (!stack.empty()) stack += ';';
+        stack += state;
+    }
+    if (stack.empty()) stack = "[unknown]";
+    profiler->m_stacks[stack] += samples;
+    profiler->m_samples += samples;
+}
+
+std::vector<PCSX::LuaProfiler::Function> PCSX::LuaProfiler::functions() const {
+    std::map<std::string_view, Function> functions;
+    for (auto& [stack, samples] : m_stacks) {
+        // Recursive functions only count once towards their total per sample.
+        std::set<std::string_view> seen;
+        std::string_view frames = stack;
+        while (true) {
+            const auto separator = frames.find(';');
+            const auto frame = frames.substr(0, separator);
+            auto& function = functions[frame];
+            if (seen.insert(frame).second) function.total += samples;
+            if (separator == std::string_view::npos) {
+                function.self += samples;
+                break;
+            }
+            frames.remove_prefix(separator + 1);
+        }
+    }
+    std::vector<Function> ret;
+    ret.reserve(functions.size());
+    for (auto& [name, function] : functions) {
+        ret.push_back(function);
+        ret.back().name = name;
+    }
+    std::sort(ret.begin(), ret.end(), [](const Function& a, const Function& b) {
+        return (a.self != b.self) ? (a.self > b.self) : (a.total > b.total);
+    });
+    return ret;
+}
+
+bool PCSX::LuaProfiler::save(const std::filesystem::path& filename) const {
+    IO<File> file(new PosixFile(filename, FileOps::TRUNCATE));
+    if (file->failed()) return false;
+    std::string out;
+    for (auto& [stack, samples] : m_stacks) out += fmt::format("{} {}\n", stack, samples);
+    file->writeString(out);
+    file->close();
+    return true;
+}
@@ -0,0 +1,88 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "lua/luawrapper.h"
+
+namespace PCSX {
+
+// A sampling profiler for the Lua scripts, built on LuaJIT's own profiler. Every interval milliseconds
+// of Lua execution, the VM stops at the next safe point and hands over its stack, which gets recorded
+// as a line of collapsed stacks. When the sample lands in an event listener, the stack is rooted under
+// the name of the event, so that the time each callback costs per event shows up. When stopped, there
+// is no hook installed whatsoever, and the listeners only swap a pointer around their calls.
+class LuaProfiler {
+  public:
+    struct Function {
+        std::string name;
+        uint64_t self = 0;
+        uint64_t total = 0;
+    };
+
+    // Marks the Lua code called during its lifetime as running on behalf of the given event.
+    class Scope {
+      public:
+        explicit Scope(const char* label);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        LuaProfiler* const m_profiler;
+        const char* const m_previous;
+    };
+
+    ~LuaProfiler() { stop(); }
+
+    void start(Lua L, unsigned interval);
+    void stop();
+    void clear() {
+        m_stacks.clear();
+        m_samples = 0;
+    }
+    bool isRunning() const { return m_running; }
+    uint64_t samples() const { return m_samples; }
+    unsigned interval() const { return m_interval; }
+    // Sorted by self samples, heaviest first.
+    std::vector<Function> functions() const;
+    // Saved as collapsed stacks, as understood by the flame graph scripts and speedscope.
+    bool save(const std::filesystem::path& filename) const;
+
+  private:
+    static constexpr int c_maxDepth = 64;
+    static void sample(void* data, lua_State* L, int samples, int vmstate);
+
+    lua_State* m_L = nullptr;
+    bool m_running = false;
+    unsigned m_interval = 1;
+    uint64_t m_samples = 0;
+    const char* m_scope = nullptr;
+    // Frames separated with semicolons, outermost first.
+    std::map<std::string, uint64_t> m_stacks;
+};
+
+}  // namespace PCSX
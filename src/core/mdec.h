@@ -19,10 +19,17 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "core/psxdma.h"
 #include "core/psxemulator.h"
 #include "core/psxhw.h"
 #include "core/r3000a.h"
+#include "supportpsx/mdec-kernels.h"
 
 namespace PCSX {
 
@@ -40,12 +47,17 @@ class MDEC {
     void mdec0Interrupt();
     void mdec1Interrupt();
 
-    static const unsigned DSIZE = 8;
-    static const unsigned DSIZE2 = DSIZE * DSIZE;
+    static const unsigned DSIZE = MDECKernels::DSIZE;
+    static const unsigned DSIZE2 = MDECKernels::DSIZE2;
 
     void serialize(SaveStateWrapper *);
     void deserialize(const SaveStateWrapper *);
 
+    // (Re)starts the decoding workers, according to the settings.
+    void startWorkers();
+    // Waits for all the macroblocks of the last DMA to be written to memory.
+    void sync() { m_pool.sync(); }
+
   private:
     /* memory speed is 1 byte per MDEC_BIAS psx clock
      * That mean (PCSX::g_emulator->m_psxClockSpeed / MDEC_BIAS) B/s
@@ -79,29 +91,55 @@ class MDEC {
 
     int iq_y[DSIZE2], iq_uv[DSIZE2];
 
-    static inline const int zscan[DSIZE2] = {
-        0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,   // 00
-        12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,  // 10
-        35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,  // 20
-        58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,  // 30
+    // A macroblock whose run-length data has been parsed and dequantized, waiting for its IDCT
+    // and colour conversion. Each one is written to its own part of memory, so the macroblocks
+    // of a DMA can be finished in any order, and on any thread.
+    struct Macroblock {
+        int blk[MDECKernels::MACROBLOCK_SIZE];
+        int usedCol[6];
+        uint8_t *image;
+        bool rgb15;
+        bool bnw;
+        uint16_t alpha;
     };
+    static void decodeMacroblock(Macroblock &mb);
+
+    // Finishes the macroblocks of a DMA on worker threads. The emulation thread helps with whatever is
+    // left when it calls sync(), which has to happen before anybody can look at the decoded memory:
+    // before the DMA completes, and before saving or loading a state.
+    class DecodePool {
+      public:
+        ~DecodePool() { stop(); }
+
+        void start(unsigned count);
+        void stop();
+        bool isRunning() const { return !m_workers.empty(); }
 
-    static inline const int aanscales[DSIZE2] = {
-        1048576, 1454417, 1370031, 1232995, 1048576, 823861,  567485, 289301,  // 00
-        1454417, 2017334, 1900287, 1710213, 1454417, 1142728, 787125, 401273,  // 08
-        1370031, 1900287, 1790031, 1610986, 1370031, 1076426, 741455, 377991,  // 10
-        1232995, 1710213, 1610986, 1449849, 1232995, 968758,  667292, 340183,  // 18
-        1048576, 1454417, 1370031, 1232995, 1048576, 823861,  567485, 289301,  // 20
-        823861,  1142728, 1076426, 968758,  823861,  647303,  445870, 227303,  // 28
-        567485,  787125,  741455,  667292,  567485,  445870,  307121, 156569,  // 30
-        289301,  401273,  377991,  340183,  289301,  227303,  156569, 79818    // 38
+        // Finishes all the macroblocks of the batch, on the workers if there are any, or right away
+        // otherwise. The batch must stay untouched until the next sync().
+        void submit(std::vector<Macroblock> &batch);
+        void sync();
+
+      private:
+        void run();
+        // Finishes macroblocks until there are none left to start. Needs to be called with the lock held.
+        void drain(std::unique_lock<std::mutex> &lock);
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_idle;
+        Macroblock *m_batch = nullptr;
+        size_t m_count = 0;
+        size_t m_next = 0;
+        size_t m_done = 0;
+        bool m_exit = false;
     };
 
-    void putlinebw15(uint16_t *image, int *Yblk);
-    void putquadrgb15(uint16_t *image, int *Yblk, int Cr, int Cb);
-    void yuv2rgb15(int *blk, unsigned short *image);
-    void iqtab_init(int *iqtab, unsigned char *iq_y);
-    unsigned short *rl2blk(int *blk, unsigned short *mdec_rl);
+    std::vector<Macroblock> m_batch;
+    DecodePool m_pool;
+
+    void parseMacroblock(Macroblock &mb, uint8_t *image);
 };
 
 }  // namespace PCSX
@@ -245,6 +245,7 @@ uint8_t PCSX::MemoryCard::tickWriteCommand(uint8_t value) {
             m_directoryFlag = Flags::DirectoryRead;
             data_out = Responses::GoodReadWrite;
             memcpy(&m_mcdData[m_sector * 128], &m_tempBuffer, c_sectorSize);
+            m_dirtyFrames.set(m_sector);
             m_savedToDisk = false;
             break;
     }
@@ -341,6 +342,9 @@ void PCSX::MemoryCard::loadMcd(PCSX::u8string mcd) {
     const char *fname = reinterpret_cast<const char *>(mcd.c_str());
     size_t bytesRead;
 
+    // Whatever is still waiting to be written has to land before reading the card back
+    m_writer.reset();
+    m_dirtyFrames.reset();
     m_directoryFlag = Flags::DirectoryUnread;
 
     FILE *f = fopen(fname, "rb");
@@ -389,40 +393,31 @@ void PCSX::MemoryCard::loadMcd(PCSX::u8string mcd) {
     }
 }
 
+void PCSX::MemoryCard::commit(PCSX::u8string mcd) {
+    if (m_savedToDisk) return;
+    if (std::filesystem::path(mcd).is_relative()) {
+        mcd = (g_system->getPersistentDir() / mcd).u8string();
+    }
+    m_writer.write(mcd, m_mcdData, m_dirtyFrames);
+    m_dirtyFrames.reset();
+    m_savedToDisk = true;
+}
+
 void PCSX::MemoryCard::saveMcd(PCSX::u8string mcd, const char *data, uint32_t adr, size_t size) {
     if (std::filesystem::path(mcd).is_relative()) {
         mcd = (g_system->getPersistentDir() / mcd).u8string();
     }
     const char *fname = reinterpret_cast<const char *>(mcd.c_str());
-    FILE *f = fopen(fname, "r+b");
 
-    if (f != nullptr) {
-        struct stat buf;
-
-        if (stat(fname, &buf) != -1) {
-            if (buf.st_size == c_cardSize + 64) {
-                fseek(f, adr + 64, SEEK_SET);
-            } else if (buf.st_size == c_cardSize + 3904) {
-                fseek(f, adr + 3904, SEEK_SET);
-            } else {
-                fseek(f, adr, SEEK_SET);
-            }
-        } else {
-            fseek(f, adr, SEEK_SET);
-        }
-
-        fwrite(data + adr, 1, size, f);
-        fclose(f);
+    MemoryCardWriter::Frames frames;
+    const size_t last = std::min((adr + size + c_sectorSize - 1) / c_sectorSize, MemoryCardWriter::c_frames);
+    for (size_t frame = adr / c_sectorSize; frame < last; frame++) frames.set(frame);
+    m_writer.write(mcd, data, frames, true);
+    if (data == m_mcdData) {
+        m_dirtyFrames.reset();
         m_savedToDisk = true;
-        PCSX::g_system->printf(_("Saving memory card %s\n"), fname);
-    } else {
-        // try to create it again if we can't open it
-        f = fopen(fname, "wb");
-        if (f != NULL) {
-            fwrite(data, 1, c_cardSize, f);
-            fclose(f);
-        }
     }
+    PCSX::g_system->printf(_("Saving memory card %s\n"), fname);
 }
 
 void PCSX::MemoryCard::createMcd(PCSX::u8string mcd) {
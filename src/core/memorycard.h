@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 
+#include "core/memorycardwriter.h"
 #include "core/sstate.h"
 
 namespace PCSX {
@@ -43,11 +44,8 @@ class MemoryCard {
     }
 
     // File system / data manipulation
-    void commit(const PCSX::u8string path) {
-        if (!m_savedToDisk) {
-            saveMcd(path);
-        }
-    }
+    // Hands the frames written since the last commit over to the background writer
+    void commit(PCSX::u8string path);
     void createMcd(PCSX::u8string mcd);
     bool dataChanged() { return !m_savedToDisk; }
     void disablePocketstation() { m_pocketstationEnabled = false; };
@@ -95,7 +93,7 @@ class MemoryCard {
     };
 
     friend class SIO;
-    friend SaveStates::SaveState SaveStates::constructSaveState();
+    friend SaveStates::SaveState SaveStates::constructSaveState(bool);
 
     static constexpr size_t c_sectorSize = 8 * 16;
     static constexpr size_t c_blockSize = 8192;
@@ -113,6 +111,8 @@ class MemoryCard {
     char m_mcdData[c_cardSize];
     uint8_t m_tempBuffer[c_sectorSize];
     bool m_savedToDisk = false;
+    MemoryCardWriter::Frames m_dirtyFrames;
+    MemoryCardWriter m_writer;
 
     uint8_t m_checksumIn = 0, m_checksumOut = 0;
     uint16_t m_commandTicks = 0;
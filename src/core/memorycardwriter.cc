@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/memorycardwriter.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "support/file.h"
+
+void PCSX::MemoryCardWriter::write(const std::filesystem::path& path, const char* card, const Frames& dirty, bool now) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_card || (m_path != path)) {
+        // A card still waiting to be saved goes to its own file first
+        if (m_pending) {
+            m_now = true;
+            m_wakeWriter.notify_one();
+            m_idle.wait(lock, [this]() { return !m_pending; });
+        }
+        if (!m_card) m_card.reset(new char[c_cardSize]);
+        memcpy(m_card.get(), card, c_cardSize);
+        m_path = path;
+    } else {
+        for (size_t i = 0; i < c_frames; i++) {
+            if (dirty.test(i)) memcpy(m_card.get() + i * c_frameSize, card + i * c_frameSize, c_frameSize);
+        }
+    }
+
+    const auto current = Clock::now();
+    if (!m_pending) m_pendingSince = current;
+    m_pending = true;
+    m_now = m_now || now;
+    m_deadline = std::min(current + m_delay, m_pendingSince + 4 * m_delay);
+    if (!m_thread.joinable()) {
+        m_closing = false;
+        m_thread = std::thread([this]() { writerMain(); });
+    }
+    lock.unlock();
+    m_wakeWriter.notify_one();
+}
+
+void PCSX::MemoryCardWriter::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_pending && !m_writing) return;
+    m_now = true;
+    m_wakeWriter.notify_one();
+    m_idle.wait(lock, [this]() { return !m_pending && !m_writing; });
+}
+
+void PCSX::MemoryCardWriter::reset() {
+    flush();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_path.clear();
+}
+
+void PCSX::MemoryCardWriter::close() {
+    if (!m_thread.joinable()) return;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_wakeWriter.notify_one();
+    m_thread.join();
+}
+
+void PCSX::MemoryCardWriter::writerMain() {
+    std::unique_ptr<char[]> card(new char[c_cardSize]);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        if (!m_pending) {
+            if (m_closing) break;
+            m_wakeWriter.wait(lock);
+            continue;
+        }
+        if (!m_now && !m_closing && (Clock::now() < m_deadline)) {
+            m_wakeWriter.wait_until(lock, m_deadline);
+            continue;
+        }
+        memcpy(card.get(), m_card.get(), c_cardSize);
+        const auto path = m_path;
+        m_pending = false;
+        m_now = false;
+        m_writing = true;
+        m_idle.notify_all();
+        lock.unlock();
+        save(path, card.get());
+        lock.lock();
+        m_writing = false;
+        m_idle.notify_all();
+    }
+}
+
+void PCSX::MemoryCardWriter::save(const std::filesystem::path& path, const char* card) {
+    // The largest header is the DexDrive one
+    char header[3904];
+    size_t headerSize = 0;
+    {
+        IO<File> old(new PosixFile(path));
+        if (!old->failed()) {
+            const size_t size = old->size();
+            if ((size == c_cardSize + 64) || (size == c_cardSize + 3904)) {
+                headerSize = size - c_cardSize;
+                if (old->read(header, headerSize) != ssize_t(headerSize)) return;
+            }
+        }
+    }
+
+    auto temporary = path;
+    temporary += ".tmp";
+    bool written = false;
+    {
+        IO<File> out(new PosixFile(temporary, FileOps::TRUNCATE));
+        if (out->failed()) return;
+        written = ((headerSize == 0) || (out->write(header, headerSize) == ssize_t(headerSize))) &&
+                  (out->write(card, c_cardSize) == ssize_t(c_cardSize));
+    }
+    std::error_code ec;
+    if (written) {
+        std::filesystem::rename(temporary, path, ec);
+    } else {
+        std::filesystem::remove(temporary, ec);
+    }
+}
@@ -0,0 +1,79 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace PCSX {
+
+// Writes memory card images out to disk behind the emulation's back. The frames a game writes get merged into a
+// copy of the card, which a background thread saves once the game stopped writing for a little while. The file
+// is always replaced as a whole through a temporary one, so a crash in the middle can't leave a torn card behind.
+// A VGS or DexDrive header already present in the file is kept as it is.
+class MemoryCardWriter {
+  public:
+    static constexpr size_t c_frameSize = 128;
+    static constexpr size_t c_frames = 1024;
+    static constexpr size_t c_cardSize = c_frames * c_frameSize;
+    typedef std::bitset<c_frames> Frames;
+
+    explicit MemoryCardWriter(std::chrono::milliseconds delay = std::chrono::milliseconds(500)) : m_delay(delay) {}
+    ~MemoryCardWriter() { close(); }
+
+    // Hands over the frames of the card flagged as dirty. The whole card is taken the first time, or when the path
+    // changes. With now set, the card gets saved right away instead of after the delay.
+    void write(const std::filesystem::path& path, const char* card, const Frames& dirty, bool now = false);
+    // Blocks until everything handed over so far is on disk.
+    void flush();
+    // Flushes, then forgets about the card, for when it gets reloaded from disk.
+    void reset();
+    void close();
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+    void writerMain();
+    static void save(const std::filesystem::path& path, const char* card);
+
+    const std::chrono::milliseconds m_delay;
+    std::unique_ptr<char[]> m_card;
+    std::filesystem::path m_path;
+    bool m_pending = false;
+    bool m_writing = false;
+    bool m_now = false;
+    bool m_closing = false;
+    // When the oldest change still waiting was handed over, so a game writing without pause still gets saved
+    Clock::time_point m_pendingSince;
+    Clock::time_point m_deadline;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeWriter;
+    std::condition_variable m_idle;
+};
+
+}  // namespace PCSX
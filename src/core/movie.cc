@@ -0,0 +1,256 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/movie.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "core/pad.h"
+#include "core/psxemulator.h"
+#include "core/sstate.h"
+#include "core/system.h"
+#include "support/zfile.h"
+
+namespace {
+
+constexpr char c_magic[8] = {'P', 'S', 'X', 'M', 'O', 'V', 'I', 'E'};
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool get(std::string_view& data, T& value) {
+    if (data.size() < sizeof(T)) return false;
+    memcpy(&value, data.data(), sizeof(T));
+    data.remove_prefix(sizeof(T));
+    return true;
+}
+
+}  // namespace
+
+void PCSX::Movie::encodeHeader(std::string& out, unsigned keyframeInterval) {
+    out.append(c_magic, sizeof(c_magic));
+    put<uint32_t>(out, VERSION);
+    put<uint32_t>(out, keyframeInterval);
+}
+
+void PCSX::Movie::encodeKeyframe(std::string& out, uint32_t frame, std::string_view compressedState) {
+    out.push_back('K');
+    put<uint32_t>(out, frame);
+    put<uint32_t>(out, compressedState.size());
+    out.append(compressedState);
+}
+
+void PCSX::Movie::encodeInputs(std::string& out, uint32_t inputs, uint16_t count) {
+    out.push_back('I');
+    put<uint32_t>(out, inputs);
+    put<uint16_t>(out, count);
+}
+
+bool PCSX::Movie::parse(std::string_view data, Contents& contents) {
+    contents = {};
+    if ((data.size() < sizeof(c_magic)) || (memcmp(data.data(), c_magic, sizeof(c_magic)) != 0)) return false;
+    data.remove_prefix(sizeof(c_magic));
+    uint32_t version, interval;
+    if (!get(data, version) || (version != VERSION) || !get(data, interval)) return false;
+    contents.keyframeInterval = interval;
+
+    while (!data.empty()) {
+        const char type = data.front();
+        data.remove_prefix(1);
+        if (type == 'K') {
+            uint32_t frame, size;
+            if (!get(data, frame) || !get(data, size) || (data.size() < size)) return false;
+            // The keyframes are the state at the start of their frame, before its inputs.
+            if (frame != contents.inputs.size()) return false;
+            contents.keyframes.push_back({frame, data.substr(0, size)});
+            data.remove_prefix(size);
+        } else if (type == 'I') {
+            uint32_t inputs;
+            uint16_t count;
+            if (!get(data, inputs) || !get(data, count) || (count == 0)) return false;
+            contents.inputs.insert(contents.inputs.end(), count, inputs);
+        } else {
+            return false;
+        }
+    }
+
+    return !contents.keyframes.empty() && (contents.keyframes.front().frame == 0);
+}
+
+const PCSX::Movie::Keyframe* PCSX::Movie::Contents::keyframeFor(uint32_t frame) const {
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), frame,
+                               [](uint32_t frame, const Keyframe& keyframe) { return frame < keyframe.frame; });
+    if (it == keyframes.begin()) return nullptr;
+    return &*--it;
+}
+
+PCSX::Movie::Movie() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::GPU::VSync>([this](auto&) { vsync(); });
+    // A reset isn't part of the movie, so replaying it would go its own way from there.
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](auto&) {
+        if (m_status != Status::Stopped) stop();
+    });
+    m_listener.listen<Events::Quitting>([this](auto&) { stop(); });
+}
+
+PCSX::Movie::~Movie() { finish(); }
+
+bool PCSX::Movie::record(const std::filesystem::path& filename, unsigned keyframeInterval) {
+    if (m_status != Status::Stopped) return false;
+    IO<File> file(new PosixFile(filename, FileOps::TRUNCATE));
+    if (file->failed()) return false;
+
+    m_file = file;
+    m_keyframeInterval = std::max(keyframeInterval, 1u);
+    m_buffer.clear();
+    encodeHeader(m_buffer, m_keyframeInterval);
+    m_frame = 0;
+    m_runCount = 0;
+    m_status = Status::Recording;
+    writeKeyframe();
+    recordFrame();
+    return true;
+}
+
+bool PCSX::Movie::replay(const std::filesystem::path& filename, bool headless) {
+    if (m_status != Status::Stopped) return false;
+    IO<File> file(new PosixFile(filename));
+    if (file->failed()) return false;
+    m_data = file->readString(file->size());
+    if (!parse(m_data, m_contents) || m_contents.inputs.empty() || !loadKeyframe(m_contents.keyframes.front())) {
+        m_data.clear();
+        m_contents = {};
+        return false;
+    }
+
+    m_frame = 0;
+    m_seekTo = 0;
+    m_headless = headless;
+    m_status = Status::Replaying;
+    apply(m_contents.inputs.front());
+    return true;
+}
+
+bool PCSX::Movie::seek(uint32_t frame) {
+    if ((m_status != Status::Replaying) || (frame >= length())) return false;
+    auto keyframe = m_contents.keyframeFor(frame);
+    // Going forward without crossing a keyframe is quicker by just running there.
+    if ((frame < m_frame) || (keyframe->frame > m_frame)) {
+        if (!loadKeyframe(*keyframe)) {
+            stop();
+            return false;
+        }
+        m_frame = keyframe->frame;
+        apply(m_contents.inputs[m_frame]);
+    }
+    m_seekTo = frame;
+    return true;
+}
+
+void PCSX::Movie::stop() {
+    if (m_status == Status::Stopped) return;
+    finish();
+    g_emulator->m_pads->forceButtons(Pads::Port::Port1, std::nullopt);
+    g_emulator->m_pads->forceButtons(Pads::Port::Port2, std::nullopt);
+}
+
+void PCSX::Movie::finish() {
+    if (m_status == Status::Recording) {
+        flushRun();
+        if (m_writer.joinable()) m_writer.join();
+        m_file->writeString(m_buffer);
+        m_file->close();
+        m_file.reset();
+        m_buffer.clear();
+    }
+    m_data.clear();
+    m_contents = {};
+    m_seekTo = 0;
+    m_status = Status::Stopped;
+}
+
+void PCSX::Movie::vsync() {
+    if (m_status == Status::Stopped) return;
+    m_frame++;
+
+    if (m_status == Status::Recording) {
+        if ((m_frame % m_keyframeInterval) == 0) writeKeyframe();
+        recordFrame();
+        return;
+    }
+
+    if (m_frame >= length()) {
+        g_system->printf(_("Movie replay finished after %u frames\n"), m_frame);
+        const bool headless = m_headless;
+        stop();
+        if (headless) g_system->quit(0);
+        return;
+    }
+    apply(m_contents.inputs[m_frame]);
+}
+
+void PCSX::Movie::apply(uint32_t inputs) {
+    g_emulator->m_pads->forceButtons(Pads::Port::Port1, uint16_t(inputs));
+    g_emulator->m_pads->forceButtons(Pads::Port::Port2, uint16_t(inputs >> 16));
+}
+
+void PCSX::Movie::recordFrame() {
+    const uint32_t inputs = Movie::inputs(g_emulator->m_pads->sampleButtons(Pads::Port::Port1),
+                                          g_emulator->m_pads->sampleButtons(Pads::Port::Port2));
+    apply(inputs);
+    if ((m_runCount != 0) && (inputs == m_runInputs) && (m_runCount < UINT16_MAX)) {
+        m_runCount++;
+        return;
+    }
+    flushRun();
+    m_runInputs = inputs;
+    m_runCount = 1;
+}
+
+void PCSX::Movie::flushRun() {
+    if (m_runCount == 0) return;
+    encodeInputs(m_buffer, m_runInputs, m_runCount);
+    m_runCount = 0;
+}
+
+// The state gets captured right away, but compressing and writing it is left to a background thread, along with
+// the inputs recorded since the previous keyframe, so that the file stays in order.
+void PCSX::Movie::writeKeyframe() {
+    flushRun();
+    std::string state = SaveStates::save();
+    if (m_writer.joinable()) m_writer.join();
+    m_writer = std::thread([file = m_file, buffer = std::move(m_buffer), state = std::move(state),
+                            frame = m_frame]() mutable {
+        Slice compressed = ZWriter::compress(state, Z_BEST_SPEED);
+        encodeKeyframe(buffer, frame, compressed.asStringView());
+        file->writeString(buffer);
+    });
+    m_buffer = std::string();
+}
+
+bool PCSX::Movie::loadKeyframe(const Keyframe& keyframe) {
+    std::string state;
+    if (!ZReader::uncompress(keyframe.state, state)) return false;
+    return SaveStates::load(state);
+}
@@ -0,0 +1,117 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "support/eventbus.h"
+#include "support/file.h"
+
+namespace PCSX {
+
+// Records the pad inputs of every frame into a movie file, and plays them back. The file starts with a save
+// state, and more of them get inserted every so often as keyframes, so that seeking into the movie only has
+// to replay the frames since the closest keyframe before the target, instead of everything since the start.
+// The inputs replace the host ones for the whole frame while recording too, so that what the game saw while
+// recording is exactly what it gets to see during the replay.
+//
+// The format is a header, followed by records:
+//   "PSXMOVIE", u32 version, u32 keyframe interval
+//   'K', u32 frame, u32 size, gzip compressed save state
+//   'I', u32 inputs, u16 number of consecutive frames with these inputs
+class Movie {
+  public:
+    static constexpr unsigned DEFAULT_KEYFRAME_INTERVAL = 600;
+    static constexpr uint32_t VERSION = 1;
+
+    // The inputs of a frame, with the first pad in the low 16 bits.
+    static uint32_t inputs(uint16_t pad1, uint16_t pad2) { return pad1 | (uint32_t(pad2) << 16); }
+
+    struct Keyframe {
+        uint32_t frame;
+        std::string_view state;
+    };
+    // A movie file decoded in memory. The keyframes point into the data it got parsed from.
+    struct Contents {
+        unsigned keyframeInterval = 0;
+        std::vector<uint32_t> inputs;
+        std::vector<Keyframe> keyframes;
+        // The last keyframe at or before this frame, if any.
+        const Keyframe* keyframeFor(uint32_t frame) const;
+    };
+    static void encodeHeader(std::string& out, unsigned keyframeInterval);
+    static void encodeKeyframe(std::string& out, uint32_t frame, std::string_view compressedState);
+    static void encodeInputs(std::string& out, uint32_t inputs, uint16_t count);
+    // Fails on anything malformed, including a movie which doesn't start with a keyframe.
+    static bool parse(std::string_view data, Contents& contents);
+
+    Movie();
+    ~Movie();
+
+    bool record(const std::filesystem::path& filename, unsigned keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+    // A headless replay doesn't present any frame, and quits once the movie is over.
+    bool replay(const std::filesystem::path& filename, bool headless = false);
+    // Goes back or forward to the start of this frame of the replayed movie.
+    bool seek(uint32_t frame);
+    void stop();
+
+    bool recording() const { return m_status == Status::Recording; }
+    bool replaying() const { return m_status == Status::Replaying; }
+    uint32_t frame() const { return m_frame; }
+    uint32_t length() const { return m_contents.inputs.size(); }
+    // The frame currently emulated only gets run to reach a seek target, and shouldn't be presented.
+    bool fastForwarding() const { return replaying() && (m_headless || (m_frame + 1 < m_seekTo)); }
+
+  private:
+    enum class Status { Stopped, Recording, Replaying };
+
+    void vsync();
+    void apply(uint32_t inputs);
+    void recordFrame();
+    void flushRun();
+    void writeKeyframe();
+    bool loadKeyframe(const Keyframe& keyframe);
+    // Closes the movie without touching the pads, which may not be there anymore when destroying it.
+    void finish();
+
+    EventBus::Listener m_listener;
+    Status m_status = Status::Stopped;
+    uint32_t m_frame = 0;
+
+    IO<File> m_file;
+    std::thread m_writer;
+    std::string m_buffer;
+    unsigned m_keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+    uint32_t m_runInputs = 0;
+    uint16_t m_runCount = 0;
+
+    std::string m_data;
+    Contents m_contents;
+    uint32_t m_seekTo = 0;
+    bool m_headless = false;
+};
+
+}  // namespace PCSX
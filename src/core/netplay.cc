@@ -0,0 +1,283 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/netplay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "core/psxemulator.h"
+#include "core/system.h"
+
+void PCSX::Netplay::Inputs::reset(unsigned delay) {
+    m_entries.fill({});
+    m_confirmed = delay;
+    m_lastRemote = 0xffff;
+    m_rollback.reset();
+}
+
+PCSX::Netplay::Inputs::Entry& PCSX::Netplay::Inputs::entry(uint32_t frame) {
+    auto& e = m_entries[frame % HISTORY];
+    if (e.frame != frame) e = {frame};
+    return e;
+}
+
+void PCSX::Netplay::Inputs::setLocal(uint32_t frame, uint16_t buttons) { entry(frame).local = buttons; }
+
+uint16_t PCSX::Netplay::Inputs::local(uint32_t frame) const {
+    auto& e = m_entries[frame % HISTORY];
+    return e.frame == frame ? e.local : 0xffff;
+}
+
+bool PCSX::Netplay::Inputs::setRemote(uint32_t frame, uint16_t buttons) {
+    if (frame != m_confirmed) return false;
+    auto& e = entry(frame);
+    if (e.predicted && (e.remote != buttons)) m_rollback = std::min(m_rollback.value_or(frame), frame);
+    e.remote = buttons;
+    e.predicted = false;
+    m_lastRemote = buttons;
+    m_confirmed++;
+    return true;
+}
+
+uint16_t PCSX::Netplay::Inputs::remote(uint32_t frame) {
+    if (frame < m_confirmed) {
+        auto& e = m_entries[frame % HISTORY];
+        return e.frame == frame ? e.remote : 0xffff;
+    }
+    auto& e = entry(frame);
+    e.remote = m_lastRemote;
+    e.predicted = true;
+    return e.remote;
+}
+
+std::optional<uint32_t> PCSX::Netplay::Inputs::takeRollback() {
+    auto ret = m_rollback;
+    m_rollback.reset();
+    return ret;
+}
+
+PCSX::Netplay::Netplay() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::GPU::VSync>([this](auto&) { vsync(); });
+    // Both sides would go their separate ways from there.
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](auto&) {
+        if (active()) stop();
+    });
+    m_listener.listen<Events::Quitting>([this](auto&) {
+        if (active()) stop();
+    });
+}
+
+bool PCSX::Netplay::host(unsigned port, unsigned delay) {
+    if (active()) return false;
+    start(delay);
+    m_isHost = true;
+    m_status = Status::Listening;
+    m_listening = true;
+    m_fifoListener.start(port, g_system->getLoop(), &m_async, [this](auto fifo) {
+        if (fifo) {
+            // Only the first one to connect gets to play.
+            if (m_fifo || (m_status != Status::Listening)) {
+                IO<File> discard(fifo);
+                discard->close();
+                return;
+            }
+            m_fifo.setFile(fifo);
+        } else {
+            uv_close(reinterpret_cast<uv_handle_t*>(&m_async), [](uv_handle_t* handle) {});
+        }
+    });
+    return true;
+}
+
+bool PCSX::Netplay::connect(std::string_view address, unsigned port, unsigned delay) {
+    if (active()) return false;
+    start(delay);
+    m_isHost = false;
+    m_status = Status::Connecting;
+    m_fifo.setFile(new UvFifo(address, port));
+    return true;
+}
+
+void PCSX::Netplay::start(unsigned delay) {
+    m_delay = std::clamp(delay, 1u, MAX_ROLLBACK);
+    m_stateSize = 0;
+    m_frame = 0;
+    m_resimulateTo = 0;
+    m_inputs.reset(m_delay);
+    m_snapshotFrames.fill(UINT32_MAX);
+}
+
+void PCSX::Netplay::stop() {
+    if (m_listening) {
+        m_listening = false;
+        m_fifoListener.stop();
+    }
+    if (m_fifo) {
+        m_fifo->close();
+        m_fifo.reset();
+    }
+    if (m_status == Status::Playing) {
+        g_emulator->m_pads->forceButtons(Pads::Port::Port1, std::nullopt);
+        g_emulator->m_pads->forceButtons(Pads::Port::Port2, std::nullopt);
+    }
+    m_status = Status::Stopped;
+    for (auto& snapshot : m_snapshots) snapshot = {};
+}
+
+// The host sends its state as soon as someone connects, and the other side waits for it before playing.
+bool PCSX::Netplay::handshake() {
+    if (m_isHost) {
+        if (!m_fifo) return false;
+        std::string state = SaveStates::save();
+        std::string header;
+        header.push_back(char(Message::State));
+        const uint32_t size = state.size();
+        header.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        Slice headerSlice, stateSlice;
+        headerSlice.acquire(std::move(header));
+        stateSlice.acquire(std::move(state));
+        m_fifo->write(std::move(headerSlice));
+        m_fifo->write(std::move(stateSlice));
+        g_system->printf("%s", _("Netplay client connected\n"));
+        return true;
+    }
+
+    if (m_fifo.asA<UvFifo>()->isConnecting()) return false;
+    if (m_stateSize == 0) {
+        if (m_fifo->size() < 5) return false;
+        if (m_fifo->byte() != uint8_t(Message::State)) {
+            g_system->printf("%s", _("Netplay handshake failed\n"));
+            stop();
+            return false;
+        }
+        m_stateSize = m_fifo->read<uint32_t>();
+    }
+    if (m_fifo->size() < m_stateSize) return false;
+    std::string state = m_fifo->readString(m_stateSize);
+    if (!SaveStates::load(state)) {
+        g_system->printf("%s", _("Netplay couldn't load the state of the host\n"));
+        stop();
+        return false;
+    }
+    g_system->printf("%s", _("Netplay connected\n"));
+    return true;
+}
+
+bool PCSX::Netplay::receive() {
+    while (m_fifo->size() >= 7) {
+        const uint8_t type = m_fifo->byte();
+        const uint32_t frame = m_fifo->read<uint32_t>();
+        const uint16_t buttons = m_fifo->read<uint16_t>();
+        if ((type != uint8_t(Message::Input)) || !m_inputs.setRemote(frame, buttons)) {
+            g_system->printf("%s", _("Netplay received an invalid message, disconnecting\n"));
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void PCSX::Netplay::send(uint32_t frame, uint16_t buttons) {
+    std::string message;
+    message.push_back(char(Message::Input));
+    message.append(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    message.append(reinterpret_cast<const char*>(&buttons), sizeof(buttons));
+    Slice slice;
+    slice.acquire(std::move(message));
+    m_fifo->write(std::move(slice));
+}
+
+// A rollback can't go further back than the oldest snapshot, so the emulation has to stop and wait for the
+// other side when it gets too far ahead.
+bool PCSX::Netplay::waitForRemote() {
+    static constexpr auto c_timeout = std::chrono::seconds(30);
+    const auto start = std::chrono::steady_clock::now();
+    while (m_frame >= m_inputs.confirmed() + MAX_ROLLBACK) {
+        if (fifoError() || (std::chrono::steady_clock::now() - start > c_timeout)) {
+            g_system->printf("%s", _("Netplay connection lost\n"));
+            stop();
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (!receive()) return false;
+    }
+    return true;
+}
+
+void PCSX::Netplay::vsync() {
+    if (m_status == Status::Stopped) return;
+    if (fifoError()) {
+        if (m_fifo || (m_status == Status::Playing)) {
+            g_system->printf("%s", _("Netplay connection lost\n"));
+            stop();
+        }
+        return;
+    }
+
+    if (m_status == Status::Playing) {
+        m_frame++;
+    } else {
+        if (!handshake()) return;
+        if (m_listening) {
+            m_listening = false;
+            m_fifoListener.stop();
+        }
+        m_status = Status::Playing;
+    }
+
+    if (!receive() || !waitForRemote()) return;
+
+    bool restored = false;
+    auto rollback = m_inputs.takeRollback();
+    if (rollback.has_value() && (rollback.value() < m_frame)) {
+        const uint32_t frame = rollback.value();
+        auto& snapshot = m_snapshots[frame % SNAPSHOTS];
+        if ((m_snapshotFrames[frame % SNAPSHOTS] != frame) || !snapshot.restore()) {
+            g_system->printf("%s", _("Netplay lost sync, disconnecting\n"));
+            stop();
+            return;
+        }
+        m_resimulateTo = std::max(m_resimulateTo, m_frame);
+        m_frame = frame;
+        restored = true;
+    }
+
+    // The replayed frames already had their local input sent the first time around.
+    if (m_frame >= m_resimulateTo) {
+        const auto localPort = m_isHost ? Pads::Port::Port1 : Pads::Port::Port2;
+        const uint16_t buttons = g_emulator->m_pads->sampleButtons(localPort);
+        m_inputs.setLocal(m_frame + m_delay, buttons);
+        send(m_frame + m_delay, buttons);
+    }
+
+    if (!restored) {
+        const unsigned slot = m_frame % SNAPSHOTS;
+        const unsigned previous = (m_frame + SNAPSHOTS - 1) % SNAPSHOTS;
+        const bool hasBase = (m_frame > 0) && (m_snapshotFrames[previous] == m_frame - 1);
+        m_snapshots[slot] = SaveStates::Snapshot::take(hasBase ? &m_snapshots[previous] : nullptr);
+        m_snapshotFrames[slot] = m_frame;
+    }
+
+    const uint16_t local = m_inputs.local(m_frame);
+    const uint16_t remote = m_inputs.remote(m_frame);
+    g_emulator->m_pads->forceButtons(Pads::Port::Port1, m_isHost ? local : remote);
+    g_emulator->m_pads->forceButtons(Pads::Port::Port2, m_isHost ? remote : local);
+}
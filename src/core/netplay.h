@@ -0,0 +1,121 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <optional>
+#include <string_view>
+
+#include "core/pad.h"
+#include "core/sstate.h"
+#include "support/eventbus.h"
+#include "support/file.h"
+#include "support/uvfile.h"
+
+namespace PCSX {
+
+// Plays a game across two instances over TCP, each of them driving one of the pads. The host sends its state
+// to the other side when it connects, and from there on both sides only exchange their pad inputs, one message
+// per frame. The local input gets applied a few frames late, so that it has time to reach the other side, and
+// the remote input which hasn't arrived yet is predicted to be the last one received. When a prediction turns
+// out wrong, the emulation goes back to the snapshot of that frame, and replays from there without showing it.
+class Netplay {
+  public:
+    // How far behind the remote inputs can be, and thus how many frames a rollback may replay.
+    static constexpr unsigned MAX_ROLLBACK = 8;
+    static constexpr unsigned DEFAULT_DELAY = 2;
+
+    // The pad inputs of both sides, per frame. This remembers which of the remote inputs were predicted,
+    // to work out where the emulation has to go back to once the actual ones arrive.
+    class Inputs {
+      public:
+        static constexpr unsigned HISTORY = 64;
+
+        // The first frames are played with no buttons pressed on both sides, as nothing could have been
+        // sent for them yet.
+        void reset(unsigned delay);
+        void setLocal(uint32_t frame, uint16_t buttons);
+        uint16_t local(uint32_t frame) const;
+        // The remote inputs have to come in order. Returns false for any other frame than the next one.
+        bool setRemote(uint32_t frame, uint16_t buttons);
+        // Predicts the input if it isn't known yet, and remembers the prediction.
+        uint16_t remote(uint32_t frame);
+        // The first frame for which the remote input is still unknown.
+        uint32_t confirmed() const { return m_confirmed; }
+        // The earliest frame which got played with a wrong prediction, if any, since the last call.
+        std::optional<uint32_t> takeRollback();
+
+      private:
+        struct Entry {
+            uint32_t frame = UINT32_MAX;
+            uint16_t local = 0xffff;
+            uint16_t remote = 0xffff;
+            bool predicted = false;
+        };
+        Entry& entry(uint32_t frame);
+
+        std::array<Entry, HISTORY> m_entries;
+        uint32_t m_confirmed = 0;
+        uint16_t m_lastRemote = 0xffff;
+        std::optional<uint32_t> m_rollback;
+    };
+
+    Netplay();
+    // The host plays the first pad, and the one connecting to it the second one. Both fail if already started.
+    bool host(unsigned port, unsigned delay = DEFAULT_DELAY);
+    bool connect(std::string_view address, unsigned port, unsigned delay = DEFAULT_DELAY);
+    void stop();
+    bool active() const { return m_status != Status::Stopped; }
+    // The frame currently emulated is a replay after a rollback, and its output shouldn't be presented.
+    bool resimulating() const { return (m_status == Status::Playing) && (m_frame + 1 < m_resimulateTo); }
+
+  private:
+    enum class Status { Stopped, Listening, Connecting, Playing };
+    enum class Message : uint8_t { State = 'S', Input = 'I' };
+    static constexpr unsigned SNAPSHOTS = MAX_ROLLBACK + 1;
+
+    void start(unsigned delay);
+    void vsync();
+    bool handshake();
+    bool receive();
+    void send(uint32_t frame, uint16_t buttons);
+    bool waitForRemote();
+    bool fifoError() { return !m_fifo || m_fifo->failed() || m_fifo->eof() || m_fifo->isClosed(); }
+
+    EventBus::Listener m_listener;
+    uv_async_t m_async;
+    UvFifoListener m_fifoListener;
+    bool m_listening = false;
+    IO<File> m_fifo;
+    Status m_status = Status::Stopped;
+    bool m_isHost = false;
+    unsigned m_delay = DEFAULT_DELAY;
+    uint32_t m_stateSize = 0;
+
+    Inputs m_inputs;
+    uint32_t m_frame = 0;
+    uint32_t m_resimulateTo = 0;
+    std::array<SaveStates::Snapshot, SNAPSHOTS> m_snapshots;
+    std::array<uint32_t, SNAPSHOTS> m_snapshotFrames;
+};
+
+}  // namespace PCSX
@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <magic_enum_all.hpp>
 
@@ -66,9 +67,35 @@ class PadsImpl : public PCSX::Pads {
             return m_pads[pad - 1].isControllerConnected();
         }
     }
+    void setOverrides(Port port, uint16_t overrides) override {
+        m_pads[magic_enum::enum_integer(port)].m_data.overrides = overrides;
+    }
+    uint16_t sampleButtons(Port port) override {
+        auto& pad = m_pads[magic_enum::enum_integer(port)];
+        if (!m_hostSampling) pad.getButtons();
+        return pad.m_data.buttonStatus & pad.m_data.overrides;
+    }
+    void forceButtons(Port port, std::optional<uint16_t> buttons) override {
+        auto& pad = m_pads[magic_enum::enum_integer(port)];
+        pad.m_data.forced = buttons;
+        // Back to the host input, which may not get sampled again before the next poll.
+        if (!buttons.has_value() && m_hostSampling) pad.getButtons();
+    }
+    void sampleHostInput() override;
 
   private:
     PCSX::EventBus::Listener m_listener;
+
+    // Once the UI samples the host input, polls stop reading it themselves, and use the latest sample instead.
+    bool m_hostSampling = false;
+    std::chrono::steady_clock::time_point m_sampleTime;
+    // How old the sample was when the emulated SIO polled the pads.
+    struct SampleLatency {
+        std::chrono::nanoseconds last{0};
+        std::chrono::nanoseconds max{0};
+        std::chrono::nanoseconds total{0};
+        uint64_t polls = 0;
+    } m_sampleLatency;
     // This is a list of all of the valid GLFW gamepad IDs that we have found querying GLFW.
     // A value of -1 means that there is no gamepad at that index.
     int m_gamepadsMap[16] = {0};
@@ -143,6 +170,9 @@ class PadsImpl : public PCSX::Pads {
         // overriding from Lua
         uint16_t overrides = 0xffff;
 
+        // replacing the host input entirely, from netplay
+        std::optional<uint16_t> forced;
+
         // Analog stick values in range (0 - 255) where 128 = center
         uint8_t rightJoyX, rightJoyY, leftJoyX, leftJoyY;
     };
@@ -678,10 +708,30 @@ void PadsImpl::Pad::getButtons() {
     pad.buttonStatus = result ^ 0xffff;  // Controls are inverted, so 0 = pressed
 }
 
+void PadsImpl::sampleHostInput() {
+    m_hostSampling = true;
+    m_sampleTime = std::chrono::steady_clock::now();
+    for (auto& pad : m_pads) {
+        if (!pad.m_data.forced.has_value()) pad.getButtons();
+    }
+}
+
 uint8_t PadsImpl::startPoll(Port port) {
     int index = magic_enum::enum_integer(port);
-    m_pads[index].getButtons();
-    return m_pads[index].startPoll();
+    auto& pad = m_pads[index];
+    if (pad.m_data.forced.has_value()) {
+        pad.m_data.buttonStatus = pad.m_data.forced.value();
+        pad.m_data.leftJoyX = pad.m_data.rightJoyX = pad.m_data.leftJoyY = pad.m_data.rightJoyY = 0x80;
+    } else if (m_hostSampling) {
+        const auto latency = std::chrono::steady_clock::now() - m_sampleTime;
+        m_sampleLatency.last = latency;
+        m_sampleLatency.max = std::max<std::chrono::nanoseconds>(m_sampleLatency.max, latency);
+        m_sampleLatency.total += latency;
+        m_sampleLatency.polls++;
+    } else {
+        pad.getButtons();
+    }
+    return pad.startPoll();
 }
 
 uint8_t PadsImpl::poll(uint8_t value, Port port, uint32_t& padState) {
@@ -761,7 +811,7 @@ uint8_t PadsImpl::Pad::doDualshockCommand(uint32_t& padState) {
             return read();
         }
     } else if (m_cmd == magic_enum::enum_integer(PadCommands::GetAnalogMode) && m_configMode) {
-        static uint8_t reply[] = {0x00, 0x5a, 0x01, 0x02, 0x00, 0x02, 0x01, 0x00};
+        uint8_t reply[] = {0x00, 0x5a, 0x01, 0x02, 0x00, 0x02, 0x01, 0x00};
 
         reply[4] = m_analogMode ? 1 : 0;
         std::memcpy(m_buf, reply, 8);
@@ -807,7 +857,8 @@ uint8_t PadsImpl::Pad::startPoll() {
 
 uint8_t PadsImpl::Pad::read() {
     const PadData& pad = m_data;
-    uint16_t buttonStatus = pad.buttonStatus & pad.overrides;
+    // The forced buttons already had the overrides applied on the side they come from.
+    uint16_t buttonStatus = pad.forced.has_value() ? pad.buttonStatus : pad.buttonStatus & pad.overrides;
     if (!m_settings.get<SettingConnected>()) {
         m_bufferLen = 0;
         return 0xff;
@@ -932,6 +983,16 @@ bool PadsImpl::configure(PCSX::GUI* gui) {
         m_pads[m_selectedPadForConfig].setDefaults(m_selectedPadForConfig == 0);
     }
 
+    if (m_hostSampling && (m_sampleLatency.polls != 0)) {
+        using Milliseconds = std::chrono::duration<double, std::milli>;
+        const auto average = m_sampleLatency.total / m_sampleLatency.polls;
+        ImGui::Text(_("Input sample to poll latency: %.2fms (average %.2fms, max %.2fms)"),
+                    Milliseconds(m_sampleLatency.last).count(), Milliseconds(average).count(),
+                    Milliseconds(m_sampleLatency.max).count());
+        ImGui::SameLine();
+        if (ImGui::Button(_("Reset##latency"))) m_sampleLatency = {};
+    }
+
     changed |= m_pads[m_selectedPadForConfig].configure();
     ImGui::End();
     return changed;
@@ -19,8 +19,11 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <stdio.h>
 
+#include <optional>
+
 #include "json.hpp"
 #include "lua/luawrapper.h"
 
@@ -51,6 +54,16 @@ class Pads {
     virtual void setLua(PCSX::Lua L) = 0;
 
     virtual bool isPadConnected(int pad) = 0;
+    // Forces buttons as pressed: each cleared bit presses its button, like the Lua setOverride does.
+    // 0xffff lets the host input through.
+    virtual void setOverrides(Port port, uint16_t overrides) = 0;
+    // Reads the buttons of the host input for a pad, with the overrides applied, as the next poll would see them.
+    virtual uint16_t sampleButtons(Port port) = 0;
+    // Replaces the host input of a pad with these buttons altogether, for netplay. std::nullopt brings it back.
+    virtual void forceButtons(Port port, std::optional<uint16_t> buttons) = 0;
+    // Reads the host keyboard and gamepads into the state the next polls will use, instead of reading them again
+    // on every poll. The UI calls this each time it's done processing the host input events.
+    virtual void sampleHostInput() = 0;
 
     bool m_showCfg = false;
 
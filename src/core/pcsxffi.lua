@@ -48,9 +48,12 @@ typedef struct {
 } psxRegisters;
 
 enum BreakpointType { Exec, Read, Write };
+enum BreakpointCondition { Always, Change, Greater, Less, Equal, Range };
 typedef struct { uint8_t opaque[?]; } Breakpoint;
 
 uint64_t getCPUCycles();
+uint64_t getBlocksPromoted();
+bool isBlockLinked(uint32_t from, uint32_t to);
 uint8_t* getMemPtr();
 uint8_t* getParPtr();
 uint8_t* getRomPtr();
@@ -59,6 +62,7 @@ psxRegisters* getRegisters();
 uint8_t** getReadLUT();
 uint8_t** getWriteLUT();
 Breakpoint* addBreakpoint(uint32_t address, enum BreakpointType type, unsigned width, const char* cause, bool (*invoker)(uint32_t address, unsigned width, const char* cause), const char* label);
+void setBreakpointCondition(Breakpoint*, enum BreakpointCondition condition, uint32_t data, uint32_t high, uint32_t mask, uint32_t pcLow, uint32_t pcHigh);
 void enableBreakpoint(Breakpoint*);
 void disableBreakpoint(Breakpoint*);
 bool breakpointEnabled(Breakpoint*);
@@ -83,11 +87,45 @@ typedef struct {
 
 LuaScreenShot takeScreenShot();
 
+typedef struct { uint8_t opaque[?]; } LuaScreenShotRequest;
+LuaScreenShotRequest* takeScreenShotAsync();
+bool screenShotReady(LuaScreenShotRequest*);
+LuaScreenShot getScreenShotResult(LuaScreenShotRequest*);
+void destroyScreenShotRequest(LuaScreenShotRequest*);
+
 LuaSlice* createSaveState();
 void loadSaveStateFromSlice(LuaSlice*);
 void loadSaveStateFromFile(LuaFile*);
 
+typedef struct { uint8_t opaque[?]; } LuaSnapshot;
+LuaSnapshot* createSnapshot(LuaSnapshot* base);
+bool restoreSnapshot(LuaSnapshot*);
+void destroySnapshot(LuaSnapshot*);
+
+bool netplayHost(unsigned port, unsigned delay);
+bool netplayConnect(const char* address, unsigned port, unsigned delay);
+void netplayStop();
+bool netplayActive();
+
+bool movieRecord(const char* filename, unsigned keyframeInterval);
+bool movieReplay(const char* filename);
+bool movieSeek(uint32_t frame);
+void movieStop();
+uint32_t movieFrame();
+uint32_t movieLength();
+bool movieRecording();
+bool movieReplaying();
+
 LuaFile* getMemoryAsFile();
+void takeDirtyPages(uint8_t* pages);
+
+typedef struct { uint8_t opaque[?]; } MemoryScanner;
+MemoryScanner* createMemoryScanner();
+void destroyMemoryScanner(MemoryScanner*);
+void memoryScanFirst(MemoryScanner*, int type, int comparison, int64_t value);
+void memoryScanNext(MemoryScanner*, int comparison, int64_t value);
+uint32_t memoryScanCount(MemoryScanner*);
+uint32_t memoryScanResults(MemoryScanner*, uint32_t* addresses, uint32_t first, uint32_t count);
 
 void quit(int code);
 ]]
@@ -103,12 +141,38 @@ local function removeBreakpoint(bp)
     end
 end
 
+local function wrapScreenShot(ss)
+    return {
+        data = Support.File._createSliceWrapper(ss.data),
+        width = ss.width,
+        height = ss.height,
+        bpp = ss.bpp,
+    }
+end
+
 local function defaultInvoker(address, width, cause)
     C.pauseEmulator()
     return true
 end
 
 local validBpTypes = { Exec = true, Read = true, Write = true }
+local validBpConditions = { Always = true, Change = true, Greater = true, Less = true, Equal = true, Range = true }
+
+-- The condition is evaluated natively, and the invoker only gets called when it is met, e.g.
+-- bp:setCondition { condition = 'Range', value = 10, high = 20, mask = 0xff, pcLow = 0x80010000, pcHigh = 0x8001ffff }
+local function setBreakpointCondition(bp, options)
+    if type(options) ~= 'table' then error 'setCondition needs a table of options' end
+    local condition = options.condition or 'Always'
+    if not validBpConditions[condition] then error 'setCondition needs a valid condition' end
+    local function number(name, default)
+        local value = options[name]
+        if value == nil then return default end
+        if type(value) ~= 'number' then error('setCondition needs ' .. name .. ' to be a number') end
+        return value
+    end
+    C.setBreakpointCondition(bp._wrapper, condition, number('value', 0), number('high', 0xffffffff),
+                             number('mask', 0xffffffff), number('pcLow', 0), number('pcHigh', 0xffffffff))
+end
 
 local function addBreakpoint(address, bptype, width, cause, invoker, label)
     if type(address) ~= 'number' then error 'PCSX.addBreakpoint needs an address' end
@@ -146,6 +210,7 @@ local function addBreakpoint(address, bptype, width, cause, invoker, label)
         enable = function(bp) C.enableBreakpoint(bp._wrapper) end,
         disable = function(bp) C.disableBreakpoint(bp._wrapper) end,
         isEnabled = function(bp) return C.breakpointEnabled(bp._wrapper) end,
+        setCondition = setBreakpointCondition,
         remove = function(bp) removeBreakpoint(bp) end,
     }
     -- Use a proxy instead of doing this on the wrapper directly using ffi.gc, because of a bug in LuaJIT,
@@ -154,6 +219,52 @@ local function addBreakpoint(address, bptype, width, cause, invoker, label)
     return bp
 end
 
+-- Same order as the enums in support/memscanner.h.
+local scanValueTypes = { Char = 0, Uchar = 1, Short = 2, Ushort = 3, Int = 4, Uint = 5 }
+local scanComparisons = {
+    Equal = 0,
+    NotEqual = 1,
+    Greater = 2,
+    Less = 3,
+    Changed = 4,
+    Unchanged = 5,
+    Increased = 6,
+    Decreased = 7,
+    Any = 8,
+}
+
+local function scanComparison(comparison, name)
+    local ret = scanComparisons[comparison or 'Equal']
+    if ret == nil then error(name .. ' needs a valid comparison') end
+    return ret
+end
+
+local function createMemoryScanner()
+    local scanner = ffi.gc(C.createMemoryScanner(), C.destroyMemoryScanner)
+    return {
+        _type = 'MemoryScanner',
+        _wrapper = scanner,
+        first = function(self, valueType, comparison, value)
+            local type = scanValueTypes[valueType or 'Uint']
+            if type == nil then error 'MemoryScanner:first needs a valid value type' end
+            C.memoryScanFirst(scanner, type, scanComparison(comparison, 'MemoryScanner:first'), value or 0)
+        end,
+        next = function(self, comparison, value)
+            C.memoryScanNext(scanner, scanComparison(comparison, 'MemoryScanner:next'), value or 0)
+        end,
+        count = function(self) return C.memoryScanCount(scanner) end,
+        results = function(self, first, count)
+            first = first or 0
+            count = count or C.memoryScanCount(scanner)
+            local addresses = ffi.new('uint32_t[?]', math.max(count, 1))
+            local written = C.memoryScanResults(scanner, addresses, first, count)
+            local ret = {}
+            for i = 0, written - 1 do ret[#ret + 1] = addresses[i] end
+            return ret
+        end,
+    }
+end
+
 local function printLike(callback, ...)
     local s = ''
     for i, v in ipairs({ ... }) do s = s .. tostring(v) .. ' ' end
@@ -174,6 +285,8 @@ end
 
 PCSX = {
     getCPUCycles = function() return C.getCPUCycles() end,
+    getBlocksPromoted = function() return C.getBlocksPromoted() end,
+    isBlockLinked = function(from, to) return C.isBlockLinked(from, to) end,
     getMemPtr = function() return C.getMemPtr() end,
     getParPtr = function() return C.getParPtr() end,
     getRomPtr = function() return C.getRomPtr() end,
@@ -197,13 +310,18 @@ PCSX = {
         end
     end,
     GPU = {
-        takeScreenShot = function()
-            local ss = C.takeScreenShot()
+        takeScreenShot = function() return wrapScreenShot(C.takeScreenShot()) end,
+        takeScreenShotAsync = function()
+            local request = ffi.gc(C.takeScreenShotAsync(), C.destroyScreenShotRequest)
+            local screenshot
             return {
-                data = Support.File._createSliceWrapper(ss.data),
-                width = ss.width,
-                height = ss.height,
-                bpp = ss.bpp,
+                ready = function(self) return screenshot ~= nil or C.screenShotReady(request) end,
+                get = function(self)
+                    if screenshot == nil and C.screenShotReady(request) then
+                        screenshot = wrapScreenShot(C.getScreenShotResult(request))
+                    end
+                    return screenshot
+                end,
             }
         end,
     },
@@ -221,7 +339,46 @@ PCSX = {
             error('loadSaveState: requires a Slice or File as input')
         end
     end,
+    createSnapshot = function(base)
+        if base ~= nil and (type(base) ~= 'table' or base._type ~= 'Snapshot') then
+            error('createSnapshot: the base has to be a snapshot')
+        end
+        local snapshot = C.createSnapshot(base and base._wrapper or nil)
+        return { _type = 'Snapshot', _wrapper = ffi.gc(snapshot, C.destroySnapshot) }
+    end,
+    restoreSnapshot = function(snapshot)
+        if type(snapshot) ~= 'table' or snapshot._type ~= 'Snapshot' then
+            error('restoreSnapshot: requires a snapshot as input')
+        end
+        return C.restoreSnapshot(snapshot._wrapper)
+    end,
+    Netplay = {
+        host = function(port, delay) return C.netplayHost(port, delay or 2) end,
+        connect = function(address, port, delay) return C.netplayConnect(address, port, delay or 2) end,
+        stop = function() C.netplayStop() end,
+        active = function() return C.netplayActive() end,
+    },
+    Movie = {
+        record = function(filename, keyframeInterval) return C.movieRecord(filename, keyframeInterval or 600) end,
+        replay = function(filename) return C.movieReplay(filename) end,
+        seek = function(frame) return C.movieSeek(frame) end,
+        stop = function() C.movieStop() end,
+        frame = function() return C.movieFrame() end,
+        length = function() return C.movieLength() end,
+        recording = function() return C.movieRecording() end,
+        replaying = function() return C.movieReplaying() end,
+    },
     getMemoryAsFile = function() return Support.File._createFileWrapper(C.getMemoryAsFile()) end,
+    takeDirtyPages = function()
+        local flags = ffi.new('uint8_t[2048]')
+        C.takeDirtyPages(flags)
+        local pages = {}
+        for i = 0, 2047 do
+            if flags[i] ~= 0 then pages[#pages + 1] = i * 4096 end
+        end
+        return pages
+    end,
+    createMemoryScanner = createMemoryScanner,
     quit = function(code) C.quit(code or 0) end,
 }
 
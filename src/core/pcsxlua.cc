@@ -19,14 +19,26 @@
 
 #include "core/pcsxlua.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "core/gpu.h"
+#include "core/guestprofiler.h"
+#include "core/luaprofiler.h"
+#include "core/movie.h"
+#include "core/netplay.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
 #include "core/sstate.h"
 #include "lua/luafile.h"
 #include "lua/luawrapper.h"
+#include "support/memscanner.h"
 
 namespace {
 
@@ -35,6 +47,8 @@ struct LuaBreakpoint {
 };
 
 uint64_t getCPUCycles() { return PCSX::g_emulator->m_cpu->m_regs.cycle; }
+uint64_t getBlocksPromoted() { return PCSX::g_emulator->m_cpu->getJitStats().blocksPromoted; }
+bool isBlockLinked(uint32_t from, uint32_t to) { return PCSX::g_emulator->m_cpu->isBlockLinked(from, to); }
 void* getMemPtr() { return PCSX::g_emulator->m_mem->m_wram; }
 void* getParPtr() { return PCSX::g_emulator->m_mem->m_exp1; }
 void* getRomPtr() { return PCSX::g_emulator->m_mem->m_bios; }
@@ -48,7 +62,9 @@ LuaBreakpoint* addBreakpoint(uint32_t address, PCSX::Debug::BreakpointType type,
     LuaBreakpoint* ret = new LuaBreakpoint();
     auto* bp = PCSX::g_emulator->m_debug->addBreakpoint(
         address, type, width, std::string("Lua Breakpoint"), cause,
-        [invoker](const PCSX::Debug::Breakpoint* self, uint32_t address, unsigned width, const char* cause) {
+        [invoker](PCSX::Debug::Breakpoint* self, uint32_t address, unsigned width, const char* cause) {
+            // Filtering natively means the scripts only get entered for the accesses they actually want.
+            if (!self->conditionMet(address, width)) return true;
             try {
                 return invoker(address, width, cause);
             } catch (...) {
@@ -60,6 +76,16 @@ LuaBreakpoint* addBreakpoint(uint32_t address, PCSX::Debug::BreakpointType type,
     ret->wrapper.push_back(bp);
     return ret;
 }
+void setBreakpointCondition(LuaBreakpoint* wrapper, PCSX::Debug::BreakpointCondition condition, uint32_t data,
+                            uint32_t high, uint32_t mask, uint32_t pcLow, uint32_t pcHigh) {
+    if (wrapper->wrapper.size() == 0) return;
+    auto bp = &*wrapper->wrapper.begin();
+    bp->setCondition(condition);
+    bp->setConditionData(data);
+    bp->setConditionHigh(high);
+    bp->setConditionMask(mask);
+    bp->setPCFilter(pcLow, pcHigh);
+}
 void enableBreakpoint(LuaBreakpoint* wrapper) {
     if (wrapper->wrapper.size() == 0) return;
     wrapper->wrapper.begin()->enable();
@@ -105,6 +131,35 @@ LuaScreenShot takeScreenShot() {
     return ret;
 }
 
+// The GPU fills the result whenever the screenshot is ready, and the script polls for it. The result is shared,
+// so the GPU callback stays safe to call if the script drops the request early.
+struct LuaScreenShotRequest {
+    std::shared_ptr<std::optional<PCSX::GPU::ScreenShot>> result =
+        std::make_shared<std::optional<PCSX::GPU::ScreenShot>>();
+};
+
+LuaScreenShotRequest* takeScreenShotAsync() {
+    auto request = new LuaScreenShotRequest();
+    PCSX::g_emulator->m_gpu->takeScreenShotAsync(
+        [result = request->result](PCSX::GPU::ScreenShot&& ss) { result->emplace(std::move(ss)); });
+    return request;
+}
+
+bool screenShotReady(LuaScreenShotRequest* request) { return request->result->has_value(); }
+
+LuaScreenShot getScreenShotResult(LuaScreenShotRequest* request) {
+    LuaScreenShot ret;
+    auto& ss = request->result->value();
+    ret.data = new PCSX::Slice(std::move(ss.data));
+    ret.width = ss.width;
+    ret.height = ss.height;
+    ret.bpp = ss.bpp;
+    request->result->reset();
+    return ret;
+}
+
+void destroyScreenShotRequest(LuaScreenShotRequest* request) { delete request; }
+
 PCSX::Slice* createSaveState() {
     auto ss = PCSX::SaveStates::save();
     return new PCSX::Slice(std::move(ss));
@@ -112,15 +167,67 @@ PCSX::Slice* createSaveState() {
 
 void loadSaveStateFromSlice(PCSX::Slice* data) { PCSX::SaveStates::load(data->asStringView()); }
 
-void loadSaveStateFromFile(PCSX::LuaFFI::LuaFile* file) {
-    auto data = file->file->readAt(64 * 1024 * 1024, 0);
-    PCSX::SaveStates::load(data.asStringView());
+void loadSaveStateFromFile(PCSX::LuaFFI::LuaFile* file) { PCSX::SaveStates::load(file->file); }
+
+PCSX::SaveStates::Snapshot* createSnapshot(const PCSX::SaveStates::Snapshot* base) {
+    return new PCSX::SaveStates::Snapshot(PCSX::SaveStates::Snapshot::take(base));
+}
+
+bool restoreSnapshot(const PCSX::SaveStates::Snapshot* snapshot) { return snapshot->restore(); }
+
+void destroySnapshot(PCSX::SaveStates::Snapshot* snapshot) { delete snapshot; }
+
+bool netplayHost(unsigned port, unsigned delay) { return PCSX::g_emulator->m_netplay->host(port, delay); }
+bool netplayConnect(const char* address, unsigned port, unsigned delay) {
+    return PCSX::g_emulator->m_netplay->connect(address, port, delay);
+}
+void netplayStop() { PCSX::g_emulator->m_netplay->stop(); }
+bool netplayActive() { return PCSX::g_emulator->m_netplay->active(); }
+
+bool movieRecord(const char* filename, unsigned keyframeInterval) {
+    return PCSX::g_emulator->m_movie->record(filename, keyframeInterval);
 }
+bool movieReplay(const char* filename) { return PCSX::g_emulator->m_movie->replay(filename); }
+bool movieSeek(uint32_t frame) { return PCSX::g_emulator->m_movie->seek(frame); }
+void movieStop() { PCSX::g_emulator->m_movie->stop(); }
+uint32_t movieFrame() { return PCSX::g_emulator->m_movie->frame(); }
+uint32_t movieLength() { return PCSX::g_emulator->m_movie->length(); }
+bool movieRecording() { return PCSX::g_emulator->m_movie->recording(); }
+bool movieReplaying() { return PCSX::g_emulator->m_movie->replaying(); }
 
 PCSX::LuaFFI::LuaFile* getMemoryAsFile() {
     return new PCSX::LuaFFI::LuaFile(PCSX::g_emulator->m_mem->getMemoryAsFile());
 }
 
+void takeDirtyPages(uint8_t* pages) {
+    auto dirty = PCSX::g_emulator->m_mem->takeDirtyPages();
+    memcpy(pages, dirty.data(), dirty.size());
+}
+
+PCSX::MemoryScanner* createMemoryScanner() { return new PCSX::MemoryScanner(); }
+
+void destroyMemoryScanner(PCSX::MemoryScanner* scanner) { delete scanner; }
+
+void memoryScanFirst(PCSX::MemoryScanner* scanner, int type, int comparison, int64_t value) {
+    const uint32_t size = PCSX::g_emulator->settings.get<PCSX::Emulator::Setting8MB>() ? 0x00800000 : 0x00200000;
+    scanner->first(PCSX::g_emulator->m_mem->m_wram, size, PCSX::MemoryScanner::ValueType(type),
+                   PCSX::MemoryScanner::Comparison(comparison), value);
+}
+
+void memoryScanNext(PCSX::MemoryScanner* scanner, int comparison, int64_t value) {
+    scanner->next(PCSX::g_emulator->m_mem->m_wram, PCSX::MemoryScanner::Comparison(comparison), value);
+}
+
+uint32_t memoryScanCount(PCSX::MemoryScanner* scanner) { return scanner->count(); }
+
+// Fills up to count addresses of the candidates, starting from the first-th one, and returns how many it wrote.
+uint32_t memoryScanResults(PCSX::MemoryScanner* scanner, uint32_t* addresses, uint32_t first, uint32_t count) {
+    if (first >= scanner->count()) return 0;
+    count = std::min(count, uint32_t(scanner->count() - first));
+    for (uint32_t i = 0; i < count; i++) addresses[i] = 0x80000000 + scanner->offset(first + i);
+    return count;
+}
+
 void quit(int code) { PCSX::g_system->quit(code); }
 
 }  // namespace
@@ -139,6 +246,8 @@ static void registerAllSymbols(PCSX::Lua L) {
     L.push("PCSX");
     L.newtable();
     REGISTER(L, getCPUCycles);
+    REGISTER(L, getBlocksPromoted);
+    REGISTER(L, isBlockLinked);
     REGISTER(L, getMemPtr);
     REGISTER(L, getParPtr);
     REGISTER(L, getRomPtr);
@@ -147,6 +256,7 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, getReadLUT);
     REGISTER(L, getWriteLUT);
     REGISTER(L, addBreakpoint);
+    REGISTER(L, setBreakpointCondition);
     REGISTER(L, enableBreakpoint);
     REGISTER(L, disableBreakpoint);
     REGISTER(L, breakpointEnabled);
@@ -161,10 +271,36 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, jumpToMemory);
     REGISTER(L, invalidateCache);
     REGISTER(L, takeScreenShot);
+    REGISTER(L, takeScreenShotAsync);
+    REGISTER(L, screenShotReady);
+    REGISTER(L, getScreenShotResult);
+    REGISTER(L, destroyScreenShotRequest);
     REGISTER(L, createSaveState);
     REGISTER(L, loadSaveStateFromSlice);
     REGISTER(L, loadSaveStateFromFile);
+    REGISTER(L, createSnapshot);
+    REGISTER(L, restoreSnapshot);
+    REGISTER(L, destroySnapshot);
+    REGISTER(L, netplayHost);
+    REGISTER(L, netplayConnect);
+    REGISTER(L, netplayStop);
+    REGISTER(L, netplayActive);
+    REGISTER(L, movieRecord);
+    REGISTER(L, movieReplay);
+    REGISTER(L, movieSeek);
+    REGISTER(L, movieStop);
+    REGISTER(L, movieFrame);
+    REGISTER(L, movieLength);
+    REGISTER(L, movieRecording);
+    REGISTER(L, movieReplaying);
     REGISTER(L, getMemoryAsFile);
+    REGISTER(L, takeDirtyPages);
+    REGISTER(L, createMemoryScanner);
+    REGISTER(L, destroyMemoryScanner);
+    REGISTER(L, memoryScanFirst);
+    REGISTER(L, memoryScanNext);
+    REGISTER(L, memoryScanCount);
+    REGISTER(L, memoryScanResults);
     REGISTER(L, quit);
     L.settable();
     L.pop();
@@ -200,7 +336,7 @@ void PCSX::LuaFFI::open_pcsx(Lua L) {
             }
             uint32_t address = L.checknumber(1);
             auto name = L.tostring(2);
-            g_emulator->m_cpu->m_symbols[address] = name;
+            g_emulator->m_cpu->m_symbols.insert(address, name);
             return 0;
         },
         -1);
@@ -212,17 +348,16 @@ void PCSX::LuaFFI::open_pcsx(Lua L) {
             if (L.gettop() != 1) {
                 return L.error("Wrong number of arguments to insertSymbol");
             }
-            auto i = symbols.begin();
             if (L.isnumber()) {
-                i = symbols.find(L.tonumber());
+                symbols.erase(L.tonumber());
             } else {
                 auto name = L.tostring();
-                while (i != symbols.end()) {
-                    if (i->second == name) break;
-                    i++;
+                for (const auto symbol : symbols) {
+                    if (symbol.name != name) continue;
+                    symbols.erase(symbol.address);
+                    break;
                 }
             }
-            if (i != symbols.end()) symbols.erase(i);
             return 0;
         },
         -1);
@@ -237,13 +372,11 @@ void PCSX::LuaFFI::open_pcsx(Lua L) {
                     return L.error("Wrong number of arguments");
                 }
                 auto iter = symbols.begin();
-                if (L.isnumber(-1)) {
-                    iter = symbols.find(L.tonumber(-1));
-                    if (iter != symbols.end()) iter++;
-                }
+                if (L.isnumber(-1)) iter = symbols.upperBound(L.tonumber(-1));
                 if (iter != symbols.end()) {
-                    L.push(lua_Number(iter->first));
-                    L.push(iter->second);
+                    const auto symbol = *iter;
+                    L.push(lua_Number(symbol.address));
+                    L.push(symbol.name);
                     return 2;
                 }
                 return 0;
@@ -253,5 +386,127 @@ void PCSX::LuaFFI::open_pcsx(Lua L) {
             return 3;
         },
         -1);
+    L.declareFunc(
+        "startProfiler",
+        [](lua_State* L_) -> int {
+            Lua L(L_);
+            uint64_t interval = g_emulator->settings.get<Emulator::SettingDebugSettings>()
+                                    .get<Emulator::DebugSettings::ProfileInterval>();
+            if (L.gettop() >= 1) interval = L.checknumber(1);
+            g_emulator->m_guestProfiler->start(interval, g_emulator->m_cpu->m_regs.cycle);
+            return 0;
+        },
+        -1);
+    L.declareFunc(
+        "stopProfiler",
+        [](lua_State* L_) -> int {
+            g_emulator->m_guestProfiler->stop();
+            return 0;
+        },
+        -1);
+    L.declareFunc(
+        "clearProfile",
+        [](lua_State* L_) -> int {
+            g_emulator->m_guestProfiler->clear();
+            return 0;
+        },
+        -1);
+    L.declareFunc(
+        "saveProfile",
+        [](lua_State* L_) -> int {
+            Lua L(L_);
+            if ((L.gettop() < 1) || (L.gettop() > 2)) {
+                return L.error("Wrong number of arguments to saveProfile");
+            }
+            std::filesystem::path filename = L.tostring(1);
+            auto format = GuestProfiler::formatFor(filename);
+            if (L.gettop() == 2) {
+                auto name = L.tostring(2);
+                if (name == "pprof") {
+                    format = GuestProfiler::Format::Pprof;
+                } else if (name == "collapsed") {
+                    format = GuestProfiler::Format::Collapsed;
+                } else {
+                    return L.error("Unknown profile format, expected 'collapsed' or 'pprof'");
+                }
+            }
+            L.push(g_emulator->m_guestProfiler->save(filename, format));
+            return 1;
+        },
+        -1);
+    L.declareFunc(
+        "getFrameStats",
+        [](lua_State* L_) -> int {
+            Lua L(L_);
+            const bool average = (L.gettop() >= 1) && L.toboolean(1);
+            const auto frame =
+                average ? g_emulator->m_frameStats->average() : g_emulator->m_frameStats->lastFrame();
+            L.newtable();
+            for (unsigned i = 0; i < FrameStats::COUNT; i++) {
+                L.push(lua_Number(frame.nanoseconds[i] / 1000000.0));
+                L.setfield(FrameStats::c_keys[i]);
+            }
+            L.push(lua_Number(frame.wallTime() / 1000000.0));
+            L.setfield("total");
+            L.push(lua_Number(frame.cycles));
+            L.setfield("cycles");
+            return 1;
+        },
+        -1);
+    L.declareFunc(
+        "startLuaProfiler",
+        [](lua_State* L_) -> int {
+            Lua L(L_);
+            unsigned interval = 1;
+            if (L.gettop() >= 1) interval = L.checknumber(1);
+            g_emulator->m_luaProfiler->start(L, interval);
+            return 0;
+        },
+        -1);
+    L.declareFunc(
+        "stopLuaProfiler",
+        [](lua_State* L_) -> int {
+            g_emulator->m_luaProfiler->stop();
+            return 0;
+        },
+        -1);
+    L.declareFunc(
+        "clearLuaProfile",
+        [](lua_State* L_) -> int {
+            g_emulator->m_luaProfiler->clear();
+            return 0;
+        },
+        -1);
+    L.declareFunc(
+        "saveLuaProfile",
+        [](lua_State* L_) -> int {
+            Lua L(L_);
+            if (L.gettop() != 1) return L.error("Wrong number of arguments to saveLuaProfile");
+            L.push(g_emulator->m_luaProfiler->save(L.tostring(1)));
+            return 1;
+        },
+        -1);
+    L.declareFunc(
+        "getLuaProfile",
+        [](lua_State* L_) -> int {
+            Lua L(L_);
+            auto& profiler = g_emulator->m_luaProfiler;
+            const lua_Number interval = profiler->interval();
+            L.newtable();
+            int i = 1;
+            for (auto& function : profiler->functions()) {
+                L.push(lua_Number(i++));
+                L.newtable();
+                L.push(function.name);
+                L.setfield("name");
+                L.push(lua_Number(function.self * interval));
+                L.setfield("self");
+                L.push(lua_Number(function.total * interval));
+                L.setfield("total");
+                L.settable();
+            }
+            return 1;
+        },
+        -1);
     L.pop();
 }
@@ -1,16 +1,27 @@
 #include "core/pgxp_mem.h"
 
+#include <memory>
+
 #include "core/pgxp_cpu.h"
 #include "core/pgxp_gte.h"
 #include "core/pgxp_value.h"
 
-static PGXP_value s_mem[3 * 2048 * 1024 / 4];  // mirror 2MB in 32-bit words * 3
 static const uint32_t s_userMemOffset = 0;
 static const uint32_t s_scratchOffset = 2048 * 1024 / 4;
 static const uint32_t s_registerOffset = 2 * 2048 * 1024 / 4;
 static const uint32_t s_invalidAddress = 3 * 2048 * 1024 / 4;
 
-void PGXP_InitMem() { memset(s_mem, 0, sizeof(s_mem)); }
+// The precision memory mirrors 2MB in 32-bit words * 3, but most of it never holds anything valid. It is split in
+// pages of 1024 words, only allocated once a value with valid components gets stored there. Reading from a page
+// that was never written hands out a blank value, same as the zeroed memory it stands for.
+static const uint32_t s_pageShift = 10;
+static const uint32_t s_pageSize = 1 << s_pageShift;
+static std::unique_ptr<PGXP_value[]> s_pages[s_invalidAddress >> s_pageShift];
+static PGXP_value s_blank;
+
+void PGXP_InitMem() {
+    for (auto& page : s_pages) page.reset();
+}
 
 void PGXP_Init() {
     PGXP_InitMem();
@@ -19,7 +30,7 @@ void PGXP_Init() {
 }
 
 uint8_t* PGXP_GetMem() {
-    return (uint8_t*)(s_mem);  // PCSX::g_emulator->config().PGXP_GTE ? (char*)(s_mem) : NULL;
+    return NULL;  // The precision memory is sparse, there is no flat view of it
 }
 
 /*  Playstation Memory Map (from Playstation doc by Joshua Walker)
@@ -110,8 +121,25 @@ uint32_t PGXP_ConvertAddress(uint32_t addr) {
 PGXP_value* PGXP_GetPtr(uint32_t addr) {
     addr = PGXP_ConvertAddress(addr);
 
-    if (addr != s_invalidAddress) return &s_mem[addr];
-    return NULL;
+    if (addr == s_invalidAddress) return NULL;
+    auto& page = s_pages[addr >> s_pageShift];
+    if (page) return &page[addr & (s_pageSize - 1)];
+    // Callers may modify it, so it has to be cleared every time
+    s_blank = {};
+    return &s_blank;
+}
+
+// Same as PGXP_GetPtr, but allocates the page if the value to store has anything valid in it
+static PGXP_value* GetWritePtr(uint32_t addr, const PGXP_value* value) {
+    addr = PGXP_ConvertAddress(addr);
+
+    if (addr == s_invalidAddress) return NULL;
+    auto& page = s_pages[addr >> s_pageShift];
+    if (!page) {
+        if (value->flags == 0) return NULL;
+        page.reset(new PGXP_value[s_pageSize]());
+    }
+    return &page[addr & (s_pageSize - 1)];
 }
 
 PGXP_value* PGXP_ReadMem(uint32_t addr) { return PGXP_GetPtr(addr); }
@@ -167,13 +195,13 @@ void ValidateAndCopyMem16(PGXP_value* dest, uint32_t addr, uint32_t value, int s
 }
 
 void WriteMem(PGXP_value* value, uint32_t addr) {
-    PGXP_value* pMem = PGXP_GetPtr(addr);
+    PGXP_value* pMem = GetWritePtr(addr, value);
 
     if (pMem) *pMem = *value;
 }
 
 void WriteMem16(PGXP_value* src, uint32_t addr) {
-    PGXP_value* dest = PGXP_GetPtr(addr);
+    PGXP_value* dest = GetWritePtr(addr, src);
     psx_value* pVal = NULL;
 
     if (dest) {
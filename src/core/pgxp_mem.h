@@ -31,7 +31,7 @@
 #include "core/psxemulator.h"
 
 void PGXP_Init();        // initialise memory
-uint8_t* PGXP_GetMem();  // return pointer to precision memory
+uint8_t* PGXP_GetMem();  // return pointer to precision memory, NULL as it is allocated sparsely
 uint32_t PGXP_ConvertAddress(uint32_t addr);
 
 struct PGXP_value_Tag;
@@ -23,11 +23,27 @@
 
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
+#include "core/system.h"
 
 static constexpr bool between(uint32_t val, uint32_t beg, uint32_t end) {
     return (beg > end) ? false : (val >= beg && val <= end);
 }
 
+PCSX::PIOCart::PIOCart() : m_pal(this), m_listener(g_system->m_eventBus) {
+    memset(m_detachedMemory, 0xff, sizeof(m_detachedMemory));
+    m_listener.listen<Events::GPU::VSync>([this](auto &) { commitFlash(); });
+    m_listener.listen<Events::Quitting>([this](auto &) { flushFlash(); });
+}
+
+void PCSX::PIOCart::commitFlash() {
+    if (m_dirtyFlash.none()) return;
+    auto &path = g_emulator->settings.get<Emulator::SettingEXP1Filepath>().value;
+    if (g_emulator->settings.get<Emulator::SettingPIOFlashWriteback>() && !path.empty()) {
+        m_flashWriter.write(path, g_emulator->m_mem->m_exp1, m_dirtyFlash);
+    }
+    m_dirtyFlash.reset();
+}
+
 void PCSX::PIOCart::setLuts() {
     const auto &m_readLUT = g_emulator->m_mem->m_readLUT;
     const auto &m_writeLUT = g_emulator->m_mem->m_writeLUT;
@@ -239,6 +255,7 @@ void PCSX::PIOCart::PAL::FlashMemory::write8(uint32_t address, uint8_t value) {
 
         if ((address / 128) == m_targetWritePage) {
             g_emulator->m_mem->m_exp1[address] = value;
+            m_pal->m_pio->m_dirtyFlash.set(address / FlashWriter::c_sectorSize);
 
             if (((address & 0xff) % 0x80) == 0x7f) {
                 m_pageWriteEnabled = false;
@@ -249,6 +266,7 @@ void PCSX::PIOCart::PAL::FlashMemory::write8(uint32_t address, uint8_t value) {
         }
     } else if (!m_dataProtectEnabled) {
         g_emulator->m_mem->m_exp1[address] = value;
+        m_pal->m_pio->m_dirtyFlash.set(address / FlashWriter::c_sectorSize);
     } else {
         switch (address) {
             case 0x2aaa:  // Command bus
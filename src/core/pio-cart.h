@@ -24,17 +24,27 @@
 
 #include <string>
 
+#include "core/flashwriter.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
+#include "support/eventbus.h"
 
 namespace PCSX {
 
 class PIOCart {
   public:
-    PIOCart() : m_pal(this) { memset(m_detachedMemory, 0xff, sizeof(m_detachedMemory)); }
+    PIOCart();
 
     void setLuts();
 
+    // Hands the flash sectors programmed since last time over to the writer, if writing back is enabled.
+    void commitFlash();
+    // Makes sure the pending sectors made it to the ROM file, before another one gets loaded.
+    void flushFlash() {
+        commitFlash();
+        m_flashWriter.flush();
+    }
+
     bool getSwitch() { return m_switchOn; }
     void setSwitch(bool on) { m_switchOn = on & 1; }
 
@@ -74,6 +84,9 @@ class PIOCart {
   private:
     bool m_switchOn = true;
     uint8_t m_detachedMemory[64 * 1024];
+    FlashWriter::Sectors m_dirtyFlash;
+    FlashWriter m_flashWriter;
+    EventBus::Listener m_listener;
 
     class PAL {
       public:
@@ -109,7 +122,10 @@ class PIOCart {
             }
 
             void softwareDataProtectDisable() { m_dataProtectEnabled = false; }
-            void softwareChipErase() { memset(g_emulator->m_mem->m_exp1, 0xff, 256 * 1024); }
+            void softwareChipErase() {
+                memset(g_emulator->m_mem->m_exp1, 0xff, 256 * 1024);
+                m_pal->m_pio->m_dirtyFlash.set();
+            }
 
             void enterSoftwareIDMode() {
                 setLUTSoftwareID();
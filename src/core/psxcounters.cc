@@ -23,7 +23,11 @@
 
 #include "core/psxcounters.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "core/gpu.h"
 #include "core/sio1.h"
 #include "fmt/printf.h"
@@ -34,13 +38,13 @@ void verboseLog(int32_t level, const char *str, const Args &...args) {
     PSXHW_LOG(str, args...);
 }
 
-inline void PCSX::Counters::writeCounterInternal(uint32_t index, uint32_t value) {
+inline void PCSX::Counters::writeCounterInternal(uint32_t index, uint32_t value, uint64_t cycle) {
     if (value > 0xffff) {
         verboseLog(1, "[RCNT %i] writeCounter > 0xffff: %x\n", index, value);
         value &= 0xffff;
     }
 
-    m_rcnts[index].cycleStart = PCSX::g_emulator->m_cpu->m_regs.cycle;
+    m_rcnts[index].cycleStart = cycle;
     m_rcnts[index].cycleStart -= value * m_rcnts[index].rate;
 
     // TODO: <=.
@@ -54,10 +58,10 @@ inline void PCSX::Counters::writeCounterInternal(uint32_t index, uint32_t value)
     verboseLog(5, "[RCNT %i] scount: %x\n", index, value);
 }
 
-inline uint32_t PCSX::Counters::readCounterInternal(uint32_t index) {
+inline uint32_t PCSX::Counters::readCounterInternal(uint32_t index, uint64_t cycle) {
     uint64_t count;
 
-    count = PCSX::g_emulator->m_cpu->m_regs.cycle;
+    count = cycle;
     count -= m_rcnts[index].cycleStart;
     count /= m_rcnts[index].rate;
 
@@ -69,40 +73,50 @@ inline uint32_t PCSX::Counters::readCounterInternal(uint32_t index) {
     return count;
 }
 
-void PCSX::Counters::set() {
-    m_psxNextCounter = PCSX::g_emulator->m_cpu->m_regs.cycle;
-    uint64_t next = 0x7fffffffffffffff;
+// Counters are only ever looked at when they can raise their IRQ, or when they get accessed. In between,
+// their value and their flags are nothing more than a function of the current cycle.
+uint64_t PCSX::Counters::computeDeadline(uint32_t index) const {
+    const auto &rcnt = m_rcnts[index];
+    // The base counter drives the hsyncs, so it needs to see all of its targets.
+    if ((index == 3) || raisesIrq(rcnt, rcnt.counterState)) return rcnt.cycleStart + rcnt.cycle;
+
+    // Otherwise, the boundary after this one might be raising the IRQ instead.
+    if (rcnt.counterState == CountToTarget) {
+        if (!(rcnt.mode & RcCountToTarget) && raisesIrq(rcnt, CountToOverflow)) {
+            return rcnt.cycleStart + 0xffff * rcnt.rate;
+        }
+    } else if (rcnt.target && raisesIrq(rcnt, CountToTarget)) {
+        return rcnt.cycleStart + rcnt.cycle + rcnt.target * rcnt.rate;
+    }
 
-    for (int i = 0; i < CounterQuantity; ++i) {
-        int64_t countToUpdate = m_rcnts[i].cycle - (m_psxNextCounter - m_rcnts[i].cycleStart);
+    return std::numeric_limits<uint64_t>::max();
+}
 
-        if (countToUpdate < 0) {
-            next = 0;
-            break;
-        }
+void PCSX::Counters::set() {
+    uint64_t next = std::numeric_limits<uint64_t>::max();
 
-        if (countToUpdate < (int64_t)next) {
-            next = countToUpdate;
-        }
+    for (int i = 0; i < CounterQuantity; ++i) {
+        m_rcnts[i].deadline = computeDeadline(i);
+        next = std::min(next, m_rcnts[i].deadline);
     }
 
-    m_psxNextCounter += next;
+    m_psxNextCounter = next;
 }
 
-void PCSX::Counters::reset(uint32_t index) {
+void PCSX::Counters::reset(uint32_t index, uint64_t cycle) {
     uint64_t count;
 
     if (m_rcnts[index].counterState == CountToTarget) {
         if (m_rcnts[index].mode & RcCountToTarget) {
-            count = PCSX::g_emulator->m_cpu->m_regs.cycle;
+            count = cycle;
             count -= m_rcnts[index].cycleStart;
             count /= m_rcnts[index].rate;
             count -= m_rcnts[index].target;
         } else {
-            count = readCounterInternal(index);
+            count = readCounterInternal(index, cycle);
         }
 
-        writeCounterInternal(index, count);
+        writeCounterInternal(index, count, cycle);
 
         if (m_rcnts[index].mode & RcIrqOnTarget) {
             if ((m_rcnts[index].mode & RcIrqRegenerate) || (!m_rcnts[index].irqState)) {
@@ -114,12 +128,12 @@ void PCSX::Counters::reset(uint32_t index) {
 
         m_rcnts[index].mode |= RcCountEqTarget;
     } else if (m_rcnts[index].counterState == CountToOverflow) {
-        count = PCSX::g_emulator->m_cpu->m_regs.cycle;
+        count = cycle;
         count -= m_rcnts[index].cycleStart;
         count /= m_rcnts[index].rate;
         count -= 0xffff;
 
-        writeCounterInternal(index, count);
+        writeCounterInternal(index, count, cycle);
 
         if (m_rcnts[index].mode & RcIrqOnOverflow) {
             if ((m_rcnts[index].mode & RcIrqRegenerate) || (!m_rcnts[index].irqState)) {
@@ -133,8 +147,42 @@ void PCSX::Counters::reset(uint32_t index) {
     }
 
     m_rcnts[index].mode |= RcIrqRequest;
+}
 
-    set();
+// Goes through all the targets and overflows the counter passed since it was last looked at, each of them
+// as of the cycle it happened at. Returns false if there weren't any, in which case nothing changed.
+bool PCSX::Counters::catchUp(uint32_t index) {
+    auto &rcnt = m_rcnts[index];
+    const uint64_t cycle = PCSX::g_emulator->m_cpu->m_regs.cycle;
+    if (cycle - rcnt.cycleStart < rcnt.cycle) return false;
+
+    while (cycle - rcnt.cycleStart >= rcnt.cycle) {
+        // Once a counter settles into a loop, every period it goes through only repeats the same flags and IRQs,
+        // so a counter which has been left alone for a while skips all of them but the last one in one go.
+        uint64_t period = 0;
+        bool bothBoundaries = false;
+        if (!(rcnt.mode & RcCountToTarget)) {
+            period = 0xffff * rcnt.rate;
+            bothBoundaries = true;
+        } else if ((rcnt.counterState == CountToTarget) || !rcnt.target) {
+            period = rcnt.cycle;
+        }
+        const uint64_t late = cycle - rcnt.cycleStart - rcnt.cycle;
+        if (period && (late >= period)) {
+            rcnt.cycleStart += late / period * period;
+            for (uint32_t state : {CountToTarget, CountToOverflow}) {
+                if (!bothBoundaries && (state != rcnt.counterState)) continue;
+                rcnt.mode |= state == CountToTarget ? RcCountEqTarget : RcOverflow;
+                if (raisesIrq(rcnt, state)) {
+                    setIrq(rcnt.irq);
+                    rcnt.irqState = true;
+                }
+            }
+        }
+        reset(index, rcnt.cycleStart + rcnt.cycle);
+    }
+
+    return true;
 }
 
 void PCSX::Counters::update() {
@@ -149,8 +197,12 @@ void PCSX::Counters::update() {
         uint32_t target = m_audioFrames + diff;
         uint32_t newFrames = g_emulator->m_spu->getCurrentFrames();
         int32_t framesDiff = target - newFrames;
-        if (framesDiff > 0) {
+        if (g_emulator->m_spu->outputHeld()) {
+            // Nothing is being heard, so there's nothing to keep pace with either.
+        } else if (framesDiff > 0) {
             g_emulator->m_cpu->m_regs.previousCycles = cycle;
+            // This is the emulation getting throttled down to the audio.
+            FrameStats::Scope scope(FrameStats::Idle);
             g_emulator->m_spu->waitForGoal(target);
             m_audioFrames = target;
         } else if (framesDiff < -2000000000) {
@@ -158,23 +210,14 @@ void PCSX::Counters::update() {
         }
     }
 
-    // rcnt 0.
-    if (cycle - m_rcnts[0].cycleStart >= m_rcnts[0].cycle) {
-        reset(0);
-    }
-
-    // rcnt 1.
-    if (cycle - m_rcnts[1].cycleStart >= m_rcnts[1].cycle) {
-        reset(1);
+    // rcnt 0 to 2, only when they have an IRQ to raise.
+    for (uint32_t i = 0; i < 3; i++) {
+        if (cycle >= m_rcnts[i].deadline) catchUp(i);
     }
 
-    // rcnt 2.
-    if (cycle - m_rcnts[2].cycleStart >= m_rcnts[2].cycle) {
-        reset(2);
-    }
     // rcnt base.
     if (cycle - m_rcnts[3].cycleStart >= m_rcnts[3].cycle) {
-        reset(3);
+        reset(3, cycle);
 
         m_hSyncCount++;
         m_spuSyncCountdown--;
@@ -185,6 +228,7 @@ void PCSX::Counters::update() {
             const auto scanlines = SpuUpdInterval[PCSX::g_emulator->settings.get<PCSX::Emulator::SettingVideo>()];
             m_spuSyncCountdown = scanlines;
 
+            FrameStats::Scope scope(FrameStats::SPU);
             PCSX::g_emulator->m_spu->async(scanlines * m_rcnts[3].target);
         }
 
@@ -203,20 +247,22 @@ void PCSX::Counters::update() {
             m_hSyncCount = 0;
         }
     }
+
+    set();
 }
 
 void PCSX::Counters::writeCounter(uint32_t index, uint32_t value) {
     verboseLog(2, "[RCNT %i] writeCounter: %x\n", index, value);
 
-    update();
-    writeCounterInternal(index, value);
+    catchUp(index);
+    writeCounterInternal(index, value, PCSX::g_emulator->m_cpu->m_regs.cycle);
     set();
 }
 
 void PCSX::Counters::writeMode(uint32_t index, uint32_t value) {
     verboseLog(1, "[RCNT %i] writeMode: %x\n", index, value);
 
-    update();
+    catchUp(index);
     m_rcnts[index].mode = value;
     m_rcnts[index].irqState = false;
 
@@ -251,23 +297,24 @@ void PCSX::Counters::writeMode(uint32_t index, uint32_t value) {
             break;
     }
 
-    writeCounterInternal(index, 0);
+    writeCounterInternal(index, 0, PCSX::g_emulator->m_cpu->m_regs.cycle);
     set();
 }
 
 void PCSX::Counters::writeTarget(uint32_t index, uint32_t value) {
     verboseLog(1, "[RCNT %i] wtarget: %x\n", index, value);
-    update();
+    catchUp(index);
 
     // The target is only 16 bits. To make sure of this, the 32-bit write handlers mask it with 0xFFFF
     m_rcnts[index].target = value;
-    writeCounterInternal(index, readCounterInternal(index));
+    const uint64_t cycle = PCSX::g_emulator->m_cpu->m_regs.cycle;
+    writeCounterInternal(index, readCounterInternal(index, cycle), cycle);
     set();
 }
 
 uint32_t PCSX::Counters::readCounter(uint32_t index) {
-    update();
-    uint32_t count = readCounterInternal(index);
+    if (catchUp(index)) set();
+    uint32_t count = readCounterInternal(index, PCSX::g_emulator->m_cpu->m_regs.cycle);
 
     // Parasite Eve 2 fix - artificial clock jitter based on PCSX::Emulator::BIAS
     // TODO: any other games depend on getting excepted value from RCNT?
@@ -303,7 +350,7 @@ uint32_t PCSX::Counters::readCounter(uint32_t index) {
 }
 
 uint32_t PCSX::Counters::readMode(uint32_t index) {
-    update();
+    if (catchUp(index)) set();
 
     uint16_t mode = m_rcnts[index].mode;
     m_rcnts[index].mode &= 0xe7ff;
@@ -354,7 +401,7 @@ void PCSX::Counters::init() {
                           m_HSyncTotal[PCSX::g_emulator->settings.get<PCSX::Emulator::SettingVideo>()]));
 
     for (int i = 0; i < CounterQuantity; ++i) {
-        writeCounterInternal(i, 0);
+        writeCounterInternal(i, 0, PCSX::g_emulator->m_cpu->m_regs.cycle);
     }
 
     m_hSyncCount = 0;
@@ -30,17 +30,20 @@ struct SaveStateWrapper;
 class Counters {
   private:
     static inline void setIrq(uint32_t irq) { g_emulator->m_mem->setIRQ(irq); }
-    uint32_t readCounterInternal(uint32_t index);
-    void writeCounterInternal(uint32_t index, uint32_t value);
+    uint32_t readCounterInternal(uint32_t index, uint64_t cycle);
+    void writeCounterInternal(uint32_t index, uint32_t value, uint64_t cycle);
 
     void set();
-    void reset(uint32_t index);
+    void reset(uint32_t index, uint64_t cycle);
+    bool catchUp(uint32_t index);
     void calculateHsync();
 
     struct Rcnt {
         uint16_t mode, target;
         uint32_t rate, irq, counterState, irqState;
         uint64_t cycle, cycleStart;
+        // When update() needs to look at this counter next. Not saved, as set() computes it.
+        uint64_t deadline;
     };
 
     enum {
@@ -78,6 +81,12 @@ class Counters {
 
     static const uint16_t JITTER_FLAGS = (Rc2OneEighthClock | RcIrqRegenerate | RcCountToTarget);
 
+    static bool raisesIrq(const Rcnt &rcnt, uint32_t counterState) {
+        const uint16_t flag = counterState == CountToTarget ? RcIrqOnTarget : RcIrqOnOverflow;
+        return (rcnt.mode & flag) && ((rcnt.mode & RcIrqRegenerate) || !rcnt.irqState);
+    }
+    uint64_t computeDeadline(uint32_t index) const;
+
     Rcnt m_rcnts[CounterQuantity];
 
     uint32_t m_hSyncCount = 0;
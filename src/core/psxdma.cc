@@ -19,7 +19,10 @@
 
 #include "core/psxdma.h"
 
+#include <stddef.h>
+
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "spu/interface.h"
 
 void spuInterrupt() {
@@ -29,6 +32,7 @@ void spuInterrupt() {
 }
 
 void dma4(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // SPU
+    PCSX::FrameStats::Scope scope(PCSX::FrameStats::SPU);
     uint16_t *ptr = PCSX::g_emulator->m_mem->getPointer<uint16_t>(madr);
     uint32_t size;
 
@@ -61,6 +65,7 @@ void dma4(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // SPU
             }
             size = (bcr >> 16) * (bcr & 0xffff) * 2;
             PCSX::g_emulator->m_spu->readDMAMem(ptr, size);
+            PCSX::g_emulator->m_mem->markDirtyRange(madr, size * 2);
             PCSX::g_emulator->m_mem->msanDmaWrite(madr, size * 2);
             if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
                     .get<PCSX::Emulator::DebugSettings::Debug>()) {
@@ -110,13 +115,16 @@ void dma6(uint32_t madr, uint32_t bcr, uint32_t chcr) {
             madr += 4;
             PCSX::g_emulator->m_mem->write32(madr, 0xffffff);
         } else {
-            while (bcr--) {
-                *mem-- = SWAP_LE32((madr - 4) & 0xffffff);
-                madr -= 4;
-            }
-            mem++;
-            *mem = 0xffffff;
+            // Each entry points to the one right below it, and the bottom one ends the list. Filling the table
+            // upwards from its bottom gives the same result as the hardware's walk down, in a loop which vectorizes.
+            uint32_t *table = mem + (1 - ptrdiff_t(size));
+            const uint32_t bottom = madr - (size - 1) * 4;
+            for (uint32_t i = 1; i < size; i++) table[i] = SWAP_LE32((bottom + (i - 1) * 4) & 0xffffff);
+            table[0] = 0xffffff;
+            madr -= size * 4;
         }
+        // One more word, since without msan madr ends up right below the table.
+        PCSX::g_emulator->m_mem->markDirtyRange(madr, size * 4 + 4);
         PCSX::g_emulator->m_mem->msanDmaWrite(madr, size * 4);
         if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
                 .get<PCSX::Emulator::DebugSettings::Debug>()) {
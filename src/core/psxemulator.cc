@@ -19,21 +19,32 @@
 
 #include "core/psxemulator.h"
 
+#include "core/bootcache.h"
 #include "core/callstacks.h"
 #include "core/cdrom.h"
 #include "core/debug.h"
+#include "core/discset.h"
 #include "core/eventslua.h"
+#include "core/framepacer.h"
+#include "core/framestats.h"
 #include "core/gdb-server.h"
 #include "core/gpu.h"
 #include "core/gpulogger.h"
 #include "core/gte.h"
+#include "core/guestprofiler.h"
 #include "core/luaiso.h"
+#include "core/luaprofiler.h"
 #include "core/mdec.h"
+#include "core/movie.h"
+#include "core/netplay.h"
 #include "core/pad.h"
 #include "core/patchmanager.h"
 #include "core/pcsxlua.h"
 #include "core/pio-cart.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
+#include "core/runahead.h"
+#include "core/sharedstate.h"
 #include "core/sio.h"
 #include "core/sio1-server.h"
 #include "core/sio1.h"
@@ -55,20 +66,31 @@ extern "C" {
 extern "C" int luaopen_lpeg(lua_State* L);
 
 PCSX::Emulator::Emulator()
-    : m_callStacks(new PCSX::CallStacks),
+    : m_bootCache(new PCSX::BootCache()),
+      m_callStacks(new PCSX::CallStacks),
       m_cdrom(PCSX::CDRom::factory()),
       m_counters(new PCSX::Counters()),
       m_debug(new PCSX::Debug()),
+      m_discSet(new PCSX::DiscSet()),
+      m_framePacer(new PCSX::FramePacer()),
+      m_frameStats(new PCSX::FrameStats()),
       m_gdbServer(new PCSX::GdbServer()),
       m_gpuLogger(new PCSX::GPULogger()),
       m_gte(new PCSX::GTE()),
+      m_guestProfiler(new PCSX::GuestProfiler()),
       m_hw(new PCSX::HW()),
       m_lua(new PCSX::Lua()),
+      m_luaProfiler(new PCSX::LuaProfiler()),
       m_mdec(new PCSX::MDEC()),
       m_mem(new PCSX::Memory()),
+      m_movie(new PCSX::Movie()),
+      m_netplay(new PCSX::Netplay()),
       m_pads(PCSX::Pads::factory()),
       m_patchManager(new PatchManager()),
       m_pioCart(new PCSX::PIOCart),
+      m_rewind(new PCSX::Rewind()),
+      m_runAhead(new PCSX::RunAhead()),
+      m_sharedState(new PCSX::SharedState()),
       m_sio(new PCSX::SIO()),
       m_sio1(new PCSX::SIO1()),
       m_sio1Server(new PCSX::SIO1Server()),
@@ -142,6 +164,8 @@ PCSX::Emulator::~Emulator() {
 int PCSX::Emulator::init() {
     assert(g_system);
     if (m_mem->init() == -1) return -1;
+    // Before the CPU, so that the dynarec's fault handlers get chained after the watchpoints' ones.
+    m_debug->initWatchpoints();
     int ret = R3000Acpu::psxInit();
 
     const auto& args = g_system->getArgs();
@@ -162,7 +186,9 @@ void PCSX::Emulator::reset() {
     m_pads->init();
     m_pads->reset();
     m_sio->reset();
+    m_sio->latchSpeedup();
     m_sio1->reset();
+    m_bootCache->restore();
 }
 
 void PCSX::Emulator::shutdown() {
@@ -173,15 +199,48 @@ void PCSX::Emulator::shutdown() {
 }
 
 void PCSX::Emulator::vsync() {
-    m_gpu->vblank();
-    g_system->m_eventBus->signal<Events::GPU::VSync>({});
-    g_system->update(true);
-
-    if (m_config.RewindInterval > 0 && !(++m_rewind_counter % m_config.RewindInterval)) {
-        // CreateRewindState();
+    m_frameStats->endFrame(m_cpu->m_regs.cycle);
+    // The frames replayed by a netplay rollback were already shown once, and only need to catch up. A movie
+    // doesn't present the frames it runs through to reach a seek target either, nor any of them when headless.
+    const bool replaying = m_netplay->resimulating();
+    bool present = !replaying && !m_movie->fastForwarding();
+    // In turbo mode, the frames only get presented every so often, if at all, and the UI gets to run at least
+    // from time to time, to keep up with its events.
+    bool update = !replaying;
+    const auto& args = g_system->getArgs();
+    if (args.isTurboEnabled()) {
+        const unsigned interval = args.getTurboPresentInterval();
+        present = present && (interval != 0) && ((m_frameStats->frames() % interval) == 0);
+        update = update && (present || ((m_frameStats->frames() % c_turboUpdateInterval) == 0));
+    }
+    // A skipped frame left parts of the display undrawn, and doesn't get presented. The next one is skipped
+    // whenever it isn't the first in a run of FrameSkip + 1 frames.
+    present = present && !m_gpu->skippingFrame();
+    // When running ahead of the input, only the frame furthest ahead gets presented, and the UI only runs along
+    // with it. The frames run ahead aren't part of the timeline the rest of the emulator sees.
+    const bool aheadFrame = m_runAhead->runningAhead();
+    present = present && m_runAhead->presenting();
+    update = update && m_runAhead->presenting();
+    if (present) {
+        FrameStats::Scope scope(FrameStats::GPU);
+        m_gpu->vblank();
     }
+    const int frameSkip = settings.get<SettingFrameSkip>();
+    if ((frameSkip > 0) || m_gpu->skippingFrame()) {
+        m_gpu->beginFrame((frameSkip > 0) && ((m_frameStats->frames() % (frameSkip + 1)) != 0));
+    }
+    m_gpu->pgxpVertexCache().newFrame();
+    Watchpoints::Suspend suspend;
+    if (!aheadFrame) {
+        g_system->m_eventBus->signal<Events::GPU::VSync>({});
+        m_sharedState->vsync();
+    }
+    m_runAhead->vsync();
+    if (!update) return;
+    FrameStats::Scope scope(FrameStats::GUI);
+    g_system->update(true);
 }
 
 void PCSX::Emulator::setPGXPMode(uint32_t pgxpMode) { m_cpu->psxSetPGXPMode(pgxpMode); }
 
-PCSX::Emulator* PCSX::g_emulator;
+thread_local PCSX::Emulator* PCSX::g_emulator;
@@ -66,21 +66,32 @@
 
 namespace PCSX {
 
+class BootCache;
 class CallStacks;
 class CDRom;
 class Counters;
 class Debug;
+class DiscSet;
+class FramePacer;
+class FrameStats;
 class GdbServer;
 class GPU;
 class GPULogger;
 class GTE;
+class GuestProfiler;
 class HW;
 class Lua;
+class LuaProfiler;
 class MDEC;
 class Memory;
+class Movie;
+class Netplay;
 class Pads;
 class PatchManager;
 class R3000Acpu;
+class Rewind;
+class RunAhead;
+class SharedState;
 class SIO;
 class SPUInterface;
 class System;
@@ -91,7 +102,10 @@ class SIO1Client;
 class PIOCart;
 
 class Emulator;
-extern Emulator* g_emulator;
+// The emulator instance the calling thread works for, alongside g_system. Both of them are per thread, so
+// that a process can host several instances side by side, each of them driven by its own thread: whoever
+// runs an instance binds it with an Emulator::Scope, and the threads the core starts bind their creator's.
+extern thread_local Emulator* g_emulator;
 
 class Emulator {
   public:
@@ -100,11 +114,39 @@ class Emulator {
     Emulator(Emulator&&) = delete;
     Emulator(const Emulator&) = delete;
     Emulator& operator=(const Emulator&) = delete;
+
+    // Makes an instance, and the system it runs in, the current ones for the calling thread, until the
+    // end of the scope, where the previous ones are restored.
+    class Scope {
+      public:
+        Scope(Emulator* emulator, System* system) : m_emulator(g_emulator), m_system(g_system) {
+            g_emulator = emulator;
+            g_system = system;
+        }
+        ~Scope() {
+            g_emulator = m_emulator;
+            g_system = m_system;
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        Emulator* const m_emulator;
+        System* const m_system;
+    };
+
     enum VideoType { PSX_TYPE_NTSC = 0, PSX_TYPE_PAL };    // PSX Types
     enum CDDAType { CDDA_DISABLED = 0, CDDA_ENABLED_LE };  // CDDA Types
     struct DebugSettings {
         typedef Setting<bool, TYPESTRING("Debug")> Debug;
+        typedef Setting<bool, TYPESTRING("PageWatchpoints"), false> PageWatchpoints;
         typedef Setting<bool, TYPESTRING("Trace")> Trace;
+        typedef SettingPath<TYPESTRING("TraceFile")> TraceFile;
+        typedef Setting<bool, TYPESTRING("TraceRegisters"), true> TraceRegisters;
+        typedef SettingPath<TYPESTRING("BlockTraceRecord")> BlockTraceRecord;
+        typedef SettingPath<TYPESTRING("BlockTraceVerify")> BlockTraceVerify;
+        typedef SettingPath<TYPESTRING("ProfileFile")> ProfileFile;
+        typedef Setting<uint32_t, TYPESTRING("ProfileInterval"), 33868> ProfileInterval;
         typedef Setting<bool, TYPESTRING("KernelLog")> KernelLog;
         typedef Setting<uint32_t, TYPESTRING("FirstChanceException"), 0x00001cf0> FirstChanceException;
         typedef Setting<bool, TYPESTRING("SkipISR")> SkipISR;
@@ -148,7 +190,8 @@ class Emulator {
                          KernelCallA0_20_3f, KernelCallA0_40_5f, KernelCallA0_60_7f, KernelCallA0_80_9f,
                          KernelCallA0_a0_bf, KernelCallB0_00_1f, KernelCallB0_20_3f, KernelCallB0_40_5f,
                          KernelCallC0_00_1f, PCdrv, PCdrvBase, SIO1Server, SIO1ServerPort, SIO1Client, SIO1ClientHost,
-                         SIO1ClientPort, SIO1ModeSetting>
+                         SIO1ClientPort, SIO1ModeSetting, PageWatchpoints, TraceFile, TraceRegisters,
+                         BlockTraceRecord, BlockTraceVerify, ProfileFile, ProfileInterval>
             type;
     };
     typedef SettingNested<TYPESTRING("Debug"), DebugSettings::type> SettingDebugSettings;
@@ -170,18 +213,48 @@ class Emulator {
     typedef Setting<bool, TYPESTRING("Mcd1Inserted"), true> SettingMcd1Inserted;
     typedef Setting<bool, TYPESTRING("Mcd2Inserted"), true> SettingMcd2Inserted;
     typedef Setting<bool, TYPESTRING("Dynarec"), true> SettingDynarec;
+    typedef Setting<bool, TYPESTRING("Fastmem"), false> SettingFastmem;
+    typedef Setting<bool, TYPESTRING("DynarecBlockCache"), false> SettingDynarecBlockCache;
+    typedef Setting<bool, TYPESTRING("DynarecPerfMap"), false> SettingDynarecPerfMap;
+    typedef Setting<bool, TYPESTRING("CachedInterpreter"), false> SettingCachedInterpreter;
     typedef Setting<bool, TYPESTRING("8Megs"), false> Setting8MB;
     typedef Setting<int, TYPESTRING("GUITheme"), 0> SettingGUITheme;
     typedef Setting<int, TYPESTRING("Dither"), 1> SettingDither;
     typedef Setting<bool, TYPESTRING("UseCachedDithering"), false> SettingCachedDithering;
+    typedef Setting<int, TYPESTRING("SoftGPUThreads"), 0> SettingSoftGPUThreads;
+    typedef Setting<int, TYPESTRING("MdecThreads"), 0> SettingMdecThreads;
+    typedef Setting<bool, TYPESTRING("IdleLoopSkip"), false> SettingIdleLoopSkip;
+    typedef Setting<bool, TYPESTRING("HLEKernelCalls"), false> SettingHLEKernelCalls;
+    typedef Setting<bool, TYPESTRING("BootCache"), false> SettingBootCache;
+    typedef Setting<bool, TYPESTRING("Rewind"), false> SettingRewind;
+    typedef Setting<int, TYPESTRING("RewindInterval"), 30> SettingRewindInterval;
+    typedef Setting<int, TYPESTRING("RewindMemory"), 256> SettingRewindMemory;
+    typedef Setting<int, TYPESTRING("RunAheadFrames"), 0> SettingRunAheadFrames;
+    typedef Setting<bool, TYPESTRING("SharedStateExport"), false> SettingSharedStateExport;
+    typedef Setting<int, TYPESTRING("SaveStateCompression"), 0> SettingSaveStateCompression;
+    typedef Setting<bool, TYPESTRING("GPUCommandThread"), false> SettingGPUCommandThread;
+    typedef Setting<int, TYPESTRING("FrameSkip"), 0> SettingFrameSkip;
     typedef Setting<bool, TYPESTRING("ReportGLErrors"), false> SettingGLErrorReporting;
     typedef Setting<int, TYPESTRING("ReportGLErrorsSeverity"), 1> SettingGLErrorReportingSeverity;
     typedef Setting<bool, TYPESTRING("FullCaching"), false> SettingFullCaching;
+    typedef Setting<bool, TYPESTRING("PreloadDiscSet"), true> SettingPreloadDiscSet;
+    typedef Setting<bool, TYPESTRING("CDReadAhead"), true> SettingCDReadAhead;
+    typedef Setting<int, TYPESTRING("CDDALookahead"), 75> SettingCDDALookahead;
+    typedef Setting<int, TYPESTRING("CompressedCacheBlocks"), 32> SettingCompressedCacheBlocks;
+    typedef Setting<bool, TYPESTRING("CDFastTimings"), false> SettingCDFastTimings;
+    typedef Setting<int, TYPESTRING("CDFastSeekFactor"), 8> SettingCDFastSeekFactor;
+    typedef Setting<int, TYPESTRING("CDFastReadFactor"), 4> SettingCDFastReadFactor;
+    typedef Setting<int, TYPESTRING("CDFastSpinFactor"), 8> SettingCDFastSpinFactor;
+    typedef SettingVector<std::string, TYPESTRING("CDFastTimingsExclusions")> SettingCDFastTimingsExclusions;
+    typedef Setting<bool, TYPESTRING("McdFastAccess"), false> SettingMcdFastAccess;
+    typedef Setting<int, TYPESTRING("McdFastAccessFactor"), 8> SettingMcdFastAccessFactor;
+    typedef SettingVector<std::string, TYPESTRING("McdFastAccessExclusions")> SettingMcdFastAccessExclusions;
     typedef Setting<bool, TYPESTRING("HardwareRenderer"), false> SettingHardwareRenderer;
     typedef Setting<bool, TYPESTRING("ShownAutoUpdateConfig"), false> SettingShownAutoUpdateConfig;
     typedef Setting<bool, TYPESTRING("AutoUpdate"), false> SettingAutoUpdate;
     typedef Setting<int, TYPESTRING("MSAA"), 1> SettingMSAA;
     typedef Setting<bool, TYPESTRING("LinearFiltering"), true> SettingLinearFiltering;
+    typedef Setting<int, TYPESTRING("ResolutionScale"), 1> SettingResolutionScale;
     typedef Setting<bool, TYPESTRING("KioskMode"), false> SettingKioskMode;
     typedef Setting<bool, TYPESTRING("Mcd1Pocketstation"), false> SettingMcd1Pocketstation;
     typedef Setting<bool, TYPESTRING("Mcd2Pocketstation"), false> SettingMcd2Pocketstation;
@@ -189,6 +262,7 @@ class Emulator {
     typedef SettingPath<TYPESTRING("EXP1Filepath")> SettingEXP1Filepath;
     typedef SettingPath<TYPESTRING("EXP1BrowsePath")> SettingEXP1BrowsePath;
     typedef Setting<bool, TYPESTRING("PIOConnected")> SettingPIOConnected;
+    typedef Setting<bool, TYPESTRING("PIOFlashWriteback"), false> SettingPIOFlashWriteback;
     typedef SettingPath<TYPESTRING("MapBrowsePath")> SettingMapBrowsePath;
     typedef SettingVector<std::string, TYPESTRING("OpenDialogFavorites")> SettingOpenDialogFavorites;
 
@@ -197,9 +271,17 @@ class Emulator {
              SettingRCntFix, SettingIsoPath, SettingLocale, SettingMcd1Inserted, SettingMcd2Inserted, SettingDynarec,
              Setting8MB, SettingGUITheme, SettingDither, SettingCachedDithering, SettingGLErrorReporting,
              SettingGLErrorReportingSeverity, SettingFullCaching, SettingHardwareRenderer, SettingShownAutoUpdateConfig,
-             SettingAutoUpdate, SettingMSAA, SettingLinearFiltering, SettingKioskMode, SettingMcd1Pocketstation,
-             SettingMcd2Pocketstation, SettingBiosBrowsePath, SettingEXP1Filepath, SettingEXP1BrowsePath,
-             SettingPIOConnected, SettingMapBrowsePath, SettingOpenDialogFavorites>
+             SettingAutoUpdate, SettingMSAA, SettingLinearFiltering, SettingResolutionScale, SettingKioskMode,
+             SettingMcd1Pocketstation, SettingMcd2Pocketstation, SettingBiosBrowsePath, SettingEXP1Filepath,
+             SettingEXP1BrowsePath, SettingPIOConnected, SettingMapBrowsePath, SettingOpenDialogFavorites, SettingFastmem,
+             SettingDynarecBlockCache, SettingSoftGPUThreads, SettingGPUCommandThread,
+             SettingCDReadAhead, SettingCompressedCacheBlocks, SettingCDFastTimings, SettingCDFastSeekFactor,
+             SettingCDFastReadFactor, SettingCDFastSpinFactor, SettingCDFastTimingsExclusions, SettingMdecThreads,
+             SettingIdleLoopSkip, SettingRewind, SettingRewindInterval, SettingRewindMemory,
+             SettingSaveStateCompression, SettingFrameSkip, SettingHLEKernelCalls,
+             SettingBootCache, SettingDynarecPerfMap, SettingCachedInterpreter, SettingRunAheadFrames,
+             SettingCDDALookahead, SettingSharedStateExport, SettingPIOFlashWriteback, SettingMcdFastAccess,
+             SettingMcdFastAccessFactor, SettingMcdFastAccessExclusions, SettingPreloadDiscSet>
         settings;
     class PcsxConfig {
       public:
@@ -209,8 +291,6 @@ class Emulator {
         bool HideCursor = false;
         bool SaveWindowPos = false;
         int32_t WindowPos[2] = {0, 0};
-        uint32_t RewindCount = 0;
-        uint32_t RewindInterval = 0;
         uint32_t AltSpeed1 = 0;  // Percent relative to natural speed.
         uint32_t AltSpeed2 = 0;
         bool OverClock = false;  // enable overclocking
@@ -222,9 +302,6 @@ class Emulator {
         uint32_t PGXP_Mode = 0;
     };
 
-    // It is safe if these overflow
-    uint32_t m_rewind_counter = 0;
-
     // Used for overclocking
     // Make the timing events trigger faster as we are currently assuming everything
     // takes one cycle, which is not the case on real hardware.
@@ -252,22 +329,33 @@ class Emulator {
 
     PcsxConfig& config() { return m_config; }
 
+    std::unique_ptr<BootCache> m_bootCache;
     std::unique_ptr<CallStacks> m_callStacks;
     std::unique_ptr<CDRom> m_cdrom;
     std::unique_ptr<Counters> m_counters;
     std::unique_ptr<Debug> m_debug;
+    std::unique_ptr<DiscSet> m_discSet;
+    std::unique_ptr<FramePacer> m_framePacer;
+    std::unique_ptr<FrameStats> m_frameStats;
     std::unique_ptr<GdbServer> m_gdbServer;
     std::unique_ptr<GPU> m_gpu;
     std::unique_ptr<GPULogger> m_gpuLogger;
     std::unique_ptr<GTE> m_gte;
+    std::unique_ptr<GuestProfiler> m_guestProfiler;
     std::unique_ptr<HW> m_hw;
     std::unique_ptr<Lua> m_lua;
+    std::unique_ptr<LuaProfiler> m_luaProfiler;
     std::unique_ptr<MDEC> m_mdec;
     std::unique_ptr<Memory> m_mem;
+    std::unique_ptr<Movie> m_movie;
+    std::unique_ptr<Netplay> m_netplay;
     std::unique_ptr<Pads> m_pads;
     std::unique_ptr<PatchManager> m_patchManager;
     std::unique_ptr<PIOCart> m_pioCart;
     std::unique_ptr<R3000Acpu> m_cpu;
+    std::unique_ptr<Rewind> m_rewind;
+    std::unique_ptr<RunAhead> m_runAhead;
+    std::unique_ptr<SharedState> m_sharedState;
     std::unique_ptr<SIO> m_sio;
     std::unique_ptr<SIO1> m_sio1;
     std::unique_ptr<SIO1Server> m_sio1Server;
@@ -276,6 +364,7 @@ class Emulator {
     std::unique_ptr<WebServer> m_webServer;
 
   private:
+    static constexpr unsigned c_turboUpdateInterval = 60;
     PcsxConfig m_config;
 };
 
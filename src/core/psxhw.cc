@@ -23,6 +23,7 @@
 
 #include "core/cdrom.h"
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "core/gpu.h"
 #include "core/logger.h"
 #include "core/mdec.h"
@@ -52,6 +53,314 @@ static constexpr bool addressInRegisterSpace(uint32_t address) {
             between(masked_addr, 0x1f801120, 0x1f80112b));                // Timer 2
 }
 
+// The common tails of the generic paths, which keep m_hard up to date for the registers they handled.
+static void mirrorRead32(uint32_t add, uint32_t hard) {
+    uint32_t *ptr = (uint32_t *)&PCSX::g_emulator->m_mem->m_hard[add & 0xffff];
+    *ptr = hard;
+    PSXHW_LOG("*Known 32bit read at address %x\n", add);
+}
+
+static void mirrorWrite16(uint32_t add, uint32_t rawvalue) {
+    uint16_t value = (uint16_t)rawvalue;
+    uint32_t hwadd = add & 0x1fffffff;
+
+    if (addressInRegisterSpace(hwadd)) {
+        uint32_t *ptr = (uint32_t *)&PCSX::g_emulator->m_mem->m_hard[hwadd & 0xffff];
+        *ptr = SWAP_LEu32(rawvalue);
+        PSXHW_LOG("*Known 16bit(actually 32bit) write at address %x value %x\n", add, rawvalue);
+    } else {
+        uint16_t *ptr = (uint16_t *)&PCSX::g_emulator->m_mem->m_hard[hwadd & 0xffff];
+        *ptr = SWAP_LEu16(value);
+        PSXHW_LOG("*Known 16bit write at address %x value %x\n", add, value);
+    }
+}
+
+static void mirrorWrite32(uint32_t add, uint32_t value) {
+    uint32_t *ptr = (uint32_t *)&PCSX::g_emulator->m_mem->m_hard[add & 0xffff];
+    *ptr = SWAP_LEu32(value);
+    PSXHW_LOG("*Known 32bit write at address %x value %x\n", add, value);
+}
+
+template <unsigned n>
+void PCSX::HW::writeMADR(uint32_t add, uint32_t value) {
+    PSXHW_LOG("DMA%u MADR 32bit write %x\n", n, value);
+    g_emulator->m_mem->setMADR<n>(value);
+}
+
+template <unsigned n>
+void PCSX::HW::writeCHCR(uint32_t add, uint32_t value) {
+    PSXHW_LOG("DMA%u CHCR 32bit write %x\n", n, value);
+    g_emulator->m_hw->dmaExec<n>(value);
+}
+
+// The timers' registers are 0x10 bytes apart, so their handlers are shared, and find their timer from the address.
+static constexpr uint32_t timerRegister(uint32_t timer, uint32_t reg) { return 0x1100 + timer * 0x10 + reg; }
+static unsigned timerFromAddress(uint32_t add) { return (add >> 4) & 3; }
+
+constexpr PCSX::HW::Handlers<PCSX::HW::Read16Handler, PCSX::HW::c_handlers16> PCSX::HW::makeRead16Handlers() {
+    Handlers<Read16Handler, c_handlers16> handlers = {};
+
+    handlers[index16(0x1070)] = [](uint32_t add) -> uint16_t {
+        uint32_t hard = g_emulator->m_mem->readHardwareRegister<Memory::ISTAT>();
+        PSXHW_LOG("ISTAT 16bit read %x\n", hard);
+        return hard;
+    };
+    handlers[index16(0x1074)] = [](uint32_t add) -> uint16_t {
+        uint32_t hard = g_emulator->m_mem->readHardwareRegister<Memory::IMASK>();
+        PSXHW_LOG("IMASK 16bit read %x\n", hard);
+        return hard;
+    };
+    for (uint32_t timer = 0; timer < 3; timer++) {
+        handlers[index16(timerRegister(timer, 0))] = [](uint32_t add) -> uint16_t {
+            unsigned timer = timerFromAddress(add);
+            uint16_t hard = g_emulator->m_counters->readCounter(timer);
+            PSXHW_LOG("T%u count read16: %x\n", timer, hard);
+            PSXHW_LOG("*Known 16bit read at address %x value %x\n", add, hard);
+            return hard;
+        };
+        handlers[index16(timerRegister(timer, 4))] = [](uint32_t add) -> uint16_t {
+            unsigned timer = timerFromAddress(add);
+            uint16_t hard = g_emulator->m_counters->readMode(timer);
+            PSXHW_LOG("T%u mode read16: %x\n", timer, hard);
+            PSXHW_LOG("*Known 16bit read at address %x value %x\n", add, hard);
+            return hard;
+        };
+        handlers[index16(timerRegister(timer, 8))] = [](uint32_t add) -> uint16_t {
+            unsigned timer = timerFromAddress(add);
+            uint16_t hard = g_emulator->m_counters->readTarget(timer);
+            PSXHW_LOG("T%u target read16: %x\n", timer, hard);
+            PSXHW_LOG("*Known 16bit read at address %x value %x\n", add, hard);
+            return hard;
+        };
+    }
+    for (uint32_t reg = 0x1c00; reg < 0x1e00; reg += 2) {
+        handlers[index16(reg)] = [](uint32_t add) -> uint16_t { return g_emulator->m_spu->readRegister(add); };
+    }
+
+    return handlers;
+}
+
+constexpr PCSX::HW::Handlers<PCSX::HW::Read32Handler, PCSX::HW::c_handlers32> PCSX::HW::makeRead32Handlers() {
+    Handlers<Read32Handler, c_handlers32> handlers = {};
+
+    handlers[index32(0x1070)] = [](uint32_t add) -> uint32_t {
+        uint32_t hard = g_emulator->m_mem->readHardwareRegister<Memory::ISTAT>();
+        PSXHW_LOG("ISTAT 32bit read %x\n", hard);
+        return hard;
+    };
+    handlers[index32(0x1074)] = [](uint32_t add) -> uint32_t {
+        uint32_t hard = g_emulator->m_mem->readHardwareRegister<Memory::IMASK>();
+        PSXHW_LOG("IMASK 32bit read %x\n", hard);
+        return hard;
+    };
+    handlers[index32(0x1810)] = [](uint32_t add) -> uint32_t {
+        uint32_t hard = g_emulator->m_gpu->readData();
+        PSXHW_LOG("GPU DATA 32bit read %x\n", hard);
+        mirrorRead32(add, hard);
+        return hard;
+    };
+    handlers[index32(0x1814)] = [](uint32_t add) -> uint32_t {
+        uint32_t hard = g_emulator->m_gpu->readStatus();
+        PSXHW_LOG("GPU STATUS 32bit read %x\n", hard);
+        mirrorRead32(add, hard);
+        return hard;
+    };
+    handlers[index32(0x1820)] = [](uint32_t add) -> uint32_t {
+        uint32_t hard = g_emulator->m_mdec->read0();
+        mirrorRead32(add, hard);
+        return hard;
+    };
+    handlers[index32(0x1824)] = [](uint32_t add) -> uint32_t {
+        uint32_t hard = g_emulator->m_mdec->read1();
+        mirrorRead32(add, hard);
+        return hard;
+    };
+    for (uint32_t timer = 0; timer < 3; timer++) {
+        handlers[index32(timerRegister(timer, 0))] = [](uint32_t add) -> uint32_t {
+            unsigned timer = timerFromAddress(add);
+            uint32_t hard = g_emulator->m_counters->readCounter(timer);
+            PSXHW_LOG("T%u count read32: %x\n", timer, hard);
+            mirrorRead32(add, hard);
+            return hard;
+        };
+        handlers[index32(timerRegister(timer, 4))] = [](uint32_t add) -> uint32_t {
+            unsigned timer = timerFromAddress(add);
+            uint32_t hard = g_emulator->m_counters->readMode(timer);
+            PSXHW_LOG("T%u mode read32: %x\n", timer, hard);
+            mirrorRead32(add, hard);
+            return hard;
+        };
+        handlers[index32(timerRegister(timer, 8))] = [](uint32_t add) -> uint32_t {
+            unsigned timer = timerFromAddress(add);
+            uint32_t hard = g_emulator->m_counters->readTarget(timer);
+            PSXHW_LOG("T%u target read32: %x\n", timer, hard);
+            mirrorRead32(add, hard);
+            return hard;
+        };
+    }
+
+    return handlers;
+}
+
+constexpr PCSX::HW::Handlers<PCSX::HW::Write16Handler, PCSX::HW::c_handlers16> PCSX::HW::makeWrite16Handlers() {
+    Handlers<Write16Handler, c_handlers16> handlers = {};
+
+    handlers[index16(0x1070)] = [](uint32_t add, uint32_t rawvalue) {
+        PSXHW_LOG("ISTAT 16bit(actually 32bit) write %x\n", rawvalue);
+        if (g_emulator->settings.get<Emulator::SettingSpuIrq>()) g_emulator->m_mem->setIRQ(0x200);
+        g_emulator->m_mem->clearIRQ(~rawvalue);
+    };
+    handlers[index16(0x1074)] = [](uint32_t add, uint32_t rawvalue) {
+        PSXHW_LOG("IMASK 16bit write %x\n", rawvalue & 0xffff);
+        mirrorWrite16(add, rawvalue);
+    };
+    for (uint32_t timer = 0; timer < 3; timer++) {
+        handlers[index16(timerRegister(timer, 0))] = [](uint32_t add, uint32_t rawvalue) {
+            unsigned timer = timerFromAddress(add);
+            uint16_t value = (uint16_t)rawvalue;
+            PSXHW_LOG("COUNTER %u COUNT 16bit write %x\n", timer, value);
+            g_emulator->m_counters->writeCounter(timer, value);
+            mirrorWrite16(add, rawvalue);
+        };
+        handlers[index16(timerRegister(timer, 4))] = [](uint32_t add, uint32_t rawvalue) {
+            unsigned timer = timerFromAddress(add);
+            uint16_t value = (uint16_t)rawvalue;
+            PSXHW_LOG("COUNTER %u MODE 16bit write %x\n", timer, value);
+            g_emulator->m_counters->writeMode(timer, value);
+            mirrorWrite16(add, rawvalue);
+        };
+        handlers[index16(timerRegister(timer, 8))] = [](uint32_t add, uint32_t rawvalue) {
+            unsigned timer = timerFromAddress(add);
+            uint16_t value = (uint16_t)rawvalue;
+            PSXHW_LOG("COUNTER %u TARGET 16bit write %x\n", timer, value);
+            g_emulator->m_counters->writeTarget(timer, value);
+            mirrorWrite16(add, rawvalue);
+        };
+    }
+    for (uint32_t reg = 0x1c00; reg < 0x1e00; reg += 2) {
+        handlers[index16(reg)] = [](uint32_t add, uint32_t rawvalue) {
+            g_emulator->m_spu->writeRegister(add, (uint16_t)rawvalue);
+            mirrorWrite16(add, rawvalue);
+        };
+    }
+
+    return handlers;
+}
+
+constexpr PCSX::HW::Handlers<PCSX::HW::Write32Handler, PCSX::HW::c_handlers32> PCSX::HW::makeWrite32Handlers() {
+    Handlers<Write32Handler, c_handlers32> handlers = {};
+
+    handlers[index32(0x1070)] = [](uint32_t add, uint32_t value) {
+        PSXHW_LOG("ISTAT 32bit write %x\n", value);
+        if (g_emulator->settings.get<Emulator::SettingSpuIrq>()) g_emulator->m_mem->setIRQ(0x200);
+        g_emulator->m_mem->clearIRQ(~value);
+    };
+    handlers[index32(0x1074)] = [](uint32_t add, uint32_t value) {
+        PSXHW_LOG("IMASK 32bit write %x\n", value);
+        g_emulator->m_mem->writeHardwareRegister<0x1074>(value);
+        mirrorWrite32(add, value);
+    };
+    handlers[index32(0x1080)] = writeMADR<0>;
+    handlers[index32(0x1088)] = writeCHCR<0>;  // MDEC in
+    handlers[index32(0x1090)] = writeMADR<1>;
+    handlers[index32(0x1098)] = writeCHCR<1>;  // MDEC out
+    handlers[index32(0x10a0)] = writeMADR<2>;
+    handlers[index32(0x10a8)] = writeCHCR<2>;  // GPU
+    handlers[index32(0x10b0)] = writeMADR<3>;
+    handlers[index32(0x10b8)] = writeCHCR<3>;  // CDROM
+    handlers[index32(0x10c0)] = writeMADR<4>;
+    handlers[index32(0x10c8)] = writeCHCR<4>;  // SPU
+    handlers[index32(0x10d0)] = writeMADR<5>;
+    // DMA5 (PIO) isn't implemented, so its CHCR goes through the generic path.
+    handlers[index32(0x10e0)] = writeMADR<6>;
+    handlers[index32(0x10e8)] = writeCHCR<6>;  // OT clear
+    handlers[index32(0x10f0)] = [](uint32_t add, uint32_t value) {
+        // TODO: check if toggling PCR triggers pending DMAs.
+        PSXHW_LOG("DMA PCR 32bit write %x\n", value);
+        g_emulator->m_mem->writeHardwareRegister<0x10f0>(value);
+        mirrorWrite32(add, value);
+    };
+    handlers[index32(0x10f4)] = [](uint32_t add, uint32_t value) {
+        PSXHW_LOG("DMA ICR 32bit write %x\n", value);
+        auto &mem = g_emulator->m_mem;
+        uint32_t icr = mem->readHardwareRegister<Memory::DMA_ICR>();
+        uint32_t ack = value & 0b0'1111111'000000000'000000000'000000;
+        bool wasNotTriggered = (icr & 0x80000000) == 0;
+        bool isTriggered = false;
+        bool hasError = value & 0x00008000;
+        bool isEnabled = value & 0x00800000;
+        ack ^= 0b0'1111111'000000000'000000000'000000;
+        value &= 0b0'0000000'111111111'000000000'111111;
+        icr &= ack;
+        icr |= value;
+        if (((icr & 0x7f008000) != 0) && (hasError || isEnabled)) {
+            icr |= 0x80000000;
+            isTriggered = true;
+        }
+        mem->writeHardwareRegister<Memory::DMA_ICR>(icr);
+        if (wasNotTriggered && isTriggered) {
+            mem->setIRQ(8);
+        }
+    };
+    handlers[index32(0x1810)] = [](uint32_t add, uint32_t value) {
+        PSXHW_LOG("GPU DATA 32bit write %x (CMD/MSB %x)\n", value, value >> 24);
+        g_emulator->m_gpu->writeData(value);
+        mirrorWrite32(add, value);
+    };
+    handlers[index32(0x1814)] = [](uint32_t add, uint32_t value) {
+        PSXHW_LOG("GPU STATUS 32bit write %x\n", value);
+        g_emulator->m_gpu->writeStatus(value);
+        mirrorWrite32(add, value);
+    };
+    handlers[index32(0x1820)] = [](uint32_t add, uint32_t value) {
+        g_emulator->m_mdec->write0(value);
+        mirrorWrite32(add, value);
+    };
+    handlers[index32(0x1824)] = [](uint32_t add, uint32_t value) {
+        g_emulator->m_mdec->write1(value);
+        mirrorWrite32(add, value);
+    };
+    for (uint32_t timer = 0; timer < 3; timer++) {
+        handlers[index32(timerRegister(timer, 0))] = [](uint32_t add, uint32_t value) {
+            unsigned timer = timerFromAddress(add);
+            PSXHW_LOG("COUNTER %u COUNT 32bit write %x\n", timer, value);
+            g_emulator->m_counters->writeCounter(timer, value & 0xffff);
+            mirrorWrite32(add, value);
+        };
+        handlers[index32(timerRegister(timer, 4))] = [](uint32_t add, uint32_t value) {
+            unsigned timer = timerFromAddress(add);
+            PSXHW_LOG("COUNTER %u MODE 32bit write %x\n", timer, value);
+            g_emulator->m_counters->writeMode(timer, value);
+            mirrorWrite32(add, value);
+        };
+        handlers[index32(timerRegister(timer, 8))] = [](uint32_t add, uint32_t value) {
+            unsigned timer = timerFromAddress(add);
+            PSXHW_LOG("COUNTER %u TARGET 32bit write %x\n", timer, value);
+            g_emulator->m_counters->writeTarget(timer, value & 0xffff);
+            mirrorWrite32(add, value);
+        };
+    }
+    // The SPU registers are 16 bits wide, so 32-bit writes get split in two.
+    for (uint32_t reg = 0x1c00; reg < 0x1e00; reg += 4) {
+        handlers[index32(reg)] = [](uint32_t add, uint32_t value) {
+            s_write16Handlers[index16(add)](add, value & 0xffff);
+            s_write16Handlers[index16(add + 2)](add + 2, value >> 16);
+            mirrorWrite32(add, value);
+        };
+    }
+
+    return handlers;
+}
+
+constinit const PCSX::HW::Handlers<PCSX::HW::Read16Handler, PCSX::HW::c_handlers16> PCSX::HW::s_read16Handlers =
+    makeRead16Handlers();
+constinit const PCSX::HW::Handlers<PCSX::HW::Read32Handler, PCSX::HW::c_handlers32> PCSX::HW::s_read32Handlers =
+    makeRead32Handlers();
+constinit const PCSX::HW::Handlers<PCSX::HW::Write16Handler, PCSX::HW::c_handlers16> PCSX::HW::s_write16Handlers =
+    makeWrite16Handlers();
+constinit const PCSX::HW::Handlers<PCSX::HW::Write32Handler, PCSX::HW::c_handlers32> PCSX::HW::s_write32Handlers =
+    makeWrite32Handlers();
+
 void PCSX::HW::reset() {
     if (g_emulator->settings.get<Emulator::SettingSpuIrq>()) g_emulator->m_mem->setIRQ(0x200);
 
@@ -120,7 +429,7 @@ uint8_t PCSX::HW::read8(uint32_t add) {
             hard = 0x58;
             break;
         case 0x1f802088:
-            hard = g_emulator->m_debug->m_checkKernel;
+            hard = g_emulator->m_debug->checkKernel();
             break;
         default:
             hard = g_emulator->m_mem->m_hard[hwadd & 0xffff];
@@ -133,20 +442,12 @@ uint8_t PCSX::HW::read8(uint32_t add) {
 }
 
 uint16_t PCSX::HW::read16(uint32_t add) {
+    if (auto handler = getRead16Handler(add)) return handler(add);
+
     uint16_t hard;
     uint32_t hwadd = add & 0x1fffffff;
 
     switch (hwadd) {
-        case 0x1f801070: {
-            uint32_t hard = g_emulator->m_mem->readHardwareRegister<Memory::ISTAT>();
-            PSXHW_LOG("ISTAT 16bit read %x\n", hard);
-            return hard;
-        }
-        case 0x1f801074: {
-            uint32_t hard = g_emulator->m_mem->readHardwareRegister<Memory::IMASK>();
-            PSXHW_LOG("IMASK 16bit read %x\n", hard);
-            return hard;
-        }
         case 0x1f801040:
             hard = g_emulator->m_sio->read8();
             hard |= g_emulator->m_sio->read8() << 8;
@@ -198,43 +499,6 @@ uint16_t PCSX::HW::read16(uint32_t add) {
                 return 0x80;
             */
 
-        case 0x1f801100:
-            hard = g_emulator->m_counters->readCounter(0);
-            PSXHW_LOG("T0 count read16: %x\n", hard);
-            break;
-        case 0x1f801104:
-            hard = g_emulator->m_counters->readMode(0);
-            PSXHW_LOG("T0 mode read16: %x\n", hard);
-            break;
-        case 0x1f801108:
-            hard = g_emulator->m_counters->readTarget(0);
-            PSXHW_LOG("T0 target read16: %x\n", hard);
-            break;
-        case 0x1f801110:
-            hard = g_emulator->m_counters->readCounter(1);
-            PSXHW_LOG("T1 count read16: %x\n", hard);
-            break;
-        case 0x1f801114:
-            hard = g_emulator->m_counters->readMode(1);
-            PSXHW_LOG("T1 mode read16: %x\n", hard);
-            break;
-        case 0x1f801118:
-            hard = g_emulator->m_counters->readTarget(1);
-            PSXHW_LOG("T1 target read16: %x\n", hard);
-            break;
-        case 0x1f801120:
-            hard = g_emulator->m_counters->readCounter(2);
-            PSXHW_LOG("T2 count read16: %x\n", hard);
-            break;
-        case 0x1f801124:
-            hard = g_emulator->m_counters->readMode(2);
-            PSXHW_LOG("T2 mode read16: %x\n", hard);
-            break;
-        case 0x1f801128:
-            hard = g_emulator->m_counters->readTarget(2);
-            PSXHW_LOG("T2 target read16: %x\n", hard);
-            break;
-
             // case 0x1f802030: hard =   //int_2000????
             // case 0x1f802040: hard =//dip switches...??
 
@@ -245,23 +509,21 @@ uint16_t PCSX::HW::read16(uint32_t add) {
             hard = 0x5853;
             break;
 
-        default:
-            if ((hwadd >= 0x1f801c00) && (hwadd < 0x1f801e00)) {
-                hard = g_emulator->m_spu->readRegister(add);
-            } else {
-                uint16_t *ptr = (uint16_t *)&g_emulator->m_mem->m_hard[add & 0xffff];
-                hard = *ptr;
-                PSXHW_LOG("*Unknown 16bit read at address %x\n", add);
-            }
+        default: {
+            uint16_t *ptr = (uint16_t *)&g_emulator->m_mem->m_hard[add & 0xffff];
+            hard = *ptr;
+            PSXHW_LOG("*Unknown 16bit read at address %x\n", add);
             return hard;
+        }
     }
 
-    uint16_t *ptr = (uint16_t *)&g_emulator->m_mem->m_hard[add & 0xffff];
     PSXHW_LOG("*Known 16bit read at address %x value %x\n", add, hard);
     return hard;
 }
 
 uint32_t PCSX::HW::read32(uint32_t add) {
+    if (auto handler = getRead32Handler(add)) return handler(add);
+
     uint32_t hard;
     uint32_t hwadd = add & 0x1fffffff;
 
@@ -292,68 +554,6 @@ uint32_t PCSX::HW::read32(uint32_t add) {
             PSXHW_LOG("RAM size read %x\n", hard);
             return hard;
         }
-        case 0x1f801070: {
-            hard = g_emulator->m_mem->readHardwareRegister<Memory::ISTAT>();
-            PSXHW_LOG("ISTAT 32bit read %x\n", hard);
-            return hard;
-        }
-        case 0x1f801074: {
-            hard = g_emulator->m_mem->readHardwareRegister<Memory::IMASK>();
-            PSXHW_LOG("IMASK 32bit read %x\n", hard);
-            return hard;
-        }
-        case 0x1f801810:
-            hard = g_emulator->m_gpu->readData();
-            PSXHW_LOG("GPU DATA 32bit read %x\n", hard);
-            break;
-        case 0x1f801814:
-            hard = PCSX::g_emulator->m_gpu->readStatus();
-            PSXHW_LOG("GPU STATUS 32bit read %x\n", hard);
-            break;
-
-        case 0x1f801820:
-            hard = g_emulator->m_mdec->read0();
-            break;
-        case 0x1f801824:
-            hard = g_emulator->m_mdec->read1();
-            break;
-        // time for rootcounters :)
-        case 0x1f801100:
-            hard = g_emulator->m_counters->readCounter(0);
-            PSXHW_LOG("T0 count read32: %x\n", hard);
-            break;
-        case 0x1f801104:
-            hard = g_emulator->m_counters->readMode(0);
-            PSXHW_LOG("T0 mode read32: %x\n", hard);
-            break;
-        case 0x1f801108:
-            hard = g_emulator->m_counters->readTarget(0);
-            PSXHW_LOG("T0 target read32: %x\n", hard);
-            break;
-        case 0x1f801110:
-            hard = g_emulator->m_counters->readCounter(1);
-            PSXHW_LOG("T1 count read32: %x\n", hard);
-            break;
-        case 0x1f801114:
-            hard = g_emulator->m_counters->readMode(1);
-            PSXHW_LOG("T1 mode read32: %x\n", hard);
-            break;
-        case 0x1f801118:
-            hard = g_emulator->m_counters->readTarget(1);
-            PSXHW_LOG("T1 target read32: %x\n", hard);
-            break;
-        case 0x1f801120:
-            hard = g_emulator->m_counters->readCounter(2);
-            PSXHW_LOG("T2 count read32: %x\n", hard);
-            break;
-        case 0x1f801124:
-            hard = g_emulator->m_counters->readMode(2);
-            PSXHW_LOG("T2 mode read32: %x\n", hard);
-            break;
-        case 0x1f801128:
-            hard = g_emulator->m_counters->readTarget(2);
-            PSXHW_LOG("T2 target read32: %x\n", hard);
-            break;
         case 0x1f801014:
             hard = g_emulator->m_mem->readHardwareRegister<0x1014>();
             PSXHW_LOG("SPU delay [0x1014] read32: %8.8lx\n", hard);
@@ -399,9 +599,7 @@ uint32_t PCSX::HW::read32(uint32_t add) {
             return hard;
         }
     }
-    uint32_t *ptr = (uint32_t *)&g_emulator->m_mem->m_hard[hwadd & 0xffff];
-    *ptr = hard;
-    PSXHW_LOG("*Known 32bit read at address %x\n", add);
+    mirrorRead32(add, hard);
     return hard;
 }
 
@@ -474,7 +672,7 @@ void PCSX::HW::write8(uint32_t add, uint32_t rawvalue) {
             }
             break;
         case 0x1f802088:
-            g_emulator->m_debug->m_checkKernel = value;
+            g_emulator->m_debug->setCheckKernel(value);
             break;
         case 0x1f802089:
             g_emulator->m_mem->initMsan(value);
@@ -501,6 +699,8 @@ void PCSX::HW::write8(uint32_t add, uint32_t rawvalue) {
 }
 
 void PCSX::HW::write16(uint32_t add, uint32_t rawvalue) {
+    if (auto handler = getWrite16Handler(add)) return handler(add, rawvalue);
+
     uint16_t value = (uint16_t)rawvalue;
     uint32_t hwadd = add & 0x1fffffff;
 
@@ -545,64 +745,11 @@ void PCSX::HW::write16(uint32_t add, uint32_t rawvalue) {
             g_emulator->m_sio1->writeBaud16(value);
             SIO1_LOG("SIO1.BAUD write16 %x, %x\n", add & 0xf, value);
             break;
-        case 0x1f801070:
-            PSXHW_LOG("ISTAT 16bit(actually 32bit) write %x\n", rawvalue);
-            if (g_emulator->settings.get<Emulator::SettingSpuIrq>()) g_emulator->m_mem->setIRQ(0x200);
-            g_emulator->m_mem->clearIRQ(~rawvalue);
-            return;
-
-        case 0x1f801074:
-            PSXHW_LOG("IMASK 16bit write %x\n", value);
-            break;
-
-        case 0x1f801100:
-            PSXHW_LOG("COUNTER 0 COUNT 16bit write %x\n", value);
-            g_emulator->m_counters->writeCounter(0, value);
-            break;
-        case 0x1f801104:
-            PSXHW_LOG("COUNTER 0 MODE 16bit write %x\n", value);
-            g_emulator->m_counters->writeMode(0, value);
-            break;
-        case 0x1f801108:
-            PSXHW_LOG("COUNTER 0 TARGET 16bit write %x\n", value);
-            g_emulator->m_counters->writeTarget(0, value);
-            break;
-
-        case 0x1f801110:
-            PSXHW_LOG("COUNTER 1 COUNT 16bit write %x\n", value);
-            g_emulator->m_counters->writeCounter(1, value);
-            break;
-        case 0x1f801114:
-            PSXHW_LOG("COUNTER 1 MODE 16bit write %x\n", value);
-            g_emulator->m_counters->writeMode(1, value);
-            break;
-        case 0x1f801118:
-            PSXHW_LOG("COUNTER 1 TARGET 16bit write %x\n", value);
-            g_emulator->m_counters->writeTarget(1, value);
-            break;
-
-        case 0x1f801120:
-            PSXHW_LOG("COUNTER 2 COUNT 16bit write %x\n", value);
-            g_emulator->m_counters->writeCounter(2, value);
-            break;
-        case 0x1f801124:
-            PSXHW_LOG("COUNTER 2 MODE 16bit write %x\n", value);
-            g_emulator->m_counters->writeMode(2, value);
-            break;
-        case 0x1f801128:
-            PSXHW_LOG("COUNTER 2 TARGET 16bit write %x\n", value);
-            g_emulator->m_counters->writeTarget(2, value);
-            break;
         case 0x1f802082:
             g_system->testQuit((int16_t)value);
             break;
 
         default:
-            if ((hwadd >= 0x1f801c00) && (hwadd < 0x1f801e00)) {
-                g_emulator->m_spu->writeRegister(add, value);
-                break;
-            }
-
             if (addressInRegisterSpace(hwadd)) {
                 uint32_t *ptr = (uint32_t *)&g_emulator->m_mem->m_hard[hwadd & 0xffff];
                 *ptr = SWAP_LEu32(rawvalue);
@@ -614,35 +761,35 @@ void PCSX::HW::write16(uint32_t add, uint32_t rawvalue) {
             }
             return;
     }
-    if (addressInRegisterSpace(hwadd)) {
-        uint32_t *ptr = (uint32_t *)&g_emulator->m_mem->m_hard[hwadd & 0xffff];
-        *ptr = SWAP_LEu32(rawvalue);
-        PSXHW_LOG("*Known 16bit(actually 32bit) write at address %x value %x\n", add, rawvalue);
-    } else {
-        uint16_t *ptr = (uint16_t *)&g_emulator->m_mem->m_hard[hwadd & 0xffff];
-        *ptr = SWAP_LEu16(value);
-        PSXHW_LOG("*Known 16bit write at address %x value %x\n", add, value);
-    }
+    mirrorWrite16(add, rawvalue);
 }
 
 inline void PCSX::HW::dma0(uint32_t madr, uint32_t bcr, uint32_t chcr) {
     PSXDMA_LOG("*** DMA0 MDEC *** %x addr = %x size = %x\n", chcr, madr, bcr);
+    FrameStats::Scope scope(FrameStats::MDEC);
     g_emulator->m_mdec->dma0(madr, bcr, chcr);
 }
 
 inline void PCSX::HW::dma1(uint32_t madr, uint32_t bcr, uint32_t chcr) {
     PSXDMA_LOG("*** DMA1 MDEC *** %x addr = %x size = %x\n", chcr, madr, bcr);
+    FrameStats::Scope scope(FrameStats::MDEC);
     g_emulator->m_mdec->dma1(madr, bcr, chcr);
 }
 
-inline void PCSX::HW::dma2(uint32_t madr, uint32_t bcr, uint32_t chcr) { g_emulator->m_gpu->dma(madr, bcr, chcr); }
+inline void PCSX::HW::dma2(uint32_t madr, uint32_t bcr, uint32_t chcr) {
+    FrameStats::Scope scope(FrameStats::GPU);
+    g_emulator->m_gpu->dma(madr, bcr, chcr);
+}
 
 inline void PCSX::HW::dma3(uint32_t madr, uint32_t bcr, uint32_t chcr) {
     PSXDMA_LOG("*** DMA3 CDROM *** %x addr = %x size = %x\n", chcr, madr, bcr);
+    FrameStats::Scope scope(FrameStats::CDROM);
     g_emulator->m_cdrom->dma(madr, bcr, chcr);
 }
 
 void PCSX::HW::write32(uint32_t add, uint32_t value) {
+    if (auto handler = getWrite32Handler(add)) return handler(add, value);
+
     uint32_t hwadd = add & 0x1fffffff;
 
     switch (hwadd) {
@@ -666,156 +813,16 @@ void PCSX::HW::write32(uint32_t add, uint32_t value) {
             g_emulator->m_mem->writeHardwareRegister<0x1060>(value);
             g_emulator->m_mem->setLuts();
             break;  // Ram size
-        case 0x1f801070:
-            PSXHW_LOG("ISTAT 32bit write %x\n", value);
-            if (g_emulator->settings.get<Emulator::SettingSpuIrq>()) g_emulator->m_mem->setIRQ(0x200);
-            g_emulator->m_mem->clearIRQ(~value);
-            return;
-        case 0x1f801074:
-            PSXHW_LOG("IMASK 32bit write %x\n", value);
-            g_emulator->m_mem->writeHardwareRegister<0x1074>(value);
-            break;
-        case 0x1f801080:
-            PSXHW_LOG("DMA0 MADR 32bit write %x\n", value);
-            g_emulator->m_mem->setMADR<0>(value);
-            return;
-        case 0x1f801088:
-            PSXHW_LOG("DMA0 CHCR 32bit write %x\n", value);
-            dmaExec<0>(value);  // DMA0 chcr (MDEC in DMA)
-            return;
-        case 0x1f801090:
-            PSXHW_LOG("DMA1 MADR 32bit write %x\n", value);
-            g_emulator->m_mem->setMADR<1>(value);
-            return;
-        case 0x1f801098:
-            PSXHW_LOG("DMA1 CHCR 32bit write %x\n", value);
-            dmaExec<1>(value);  // DMA1 chcr (MDEC out DMA)
-            return;
-        case 0x1f8010a0:
-            PSXHW_LOG("DMA2 MADR 32bit write %x\n", value);
-            g_emulator->m_mem->setMADR<2>(value);
-            return;
-        case 0x1f8010a8:
-            PSXHW_LOG("DMA2 CHCR 32bit write %x\n", value);
-            dmaExec<2>(value);  // DMA2 chcr (GPU DMA)
-            return;
-        case 0x1f8010b0:
-            PSXHW_LOG("DMA3 MADR 32bit write %x\n", value);
-            g_emulator->m_mem->setMADR<3>(value);
-            return;
-        case 0x1f8010b8:
-            PSXHW_LOG("DMA3 CHCR 32bit write %x\n", value);
-            dmaExec<3>(value);  // DMA3 chcr (CDROM DMA)
-            return;
-        case 0x1f8010c0:
-            PSXHW_LOG("DMA4 MADR 32bit write %x\n", value);
-            g_emulator->m_mem->setMADR<4>(value);
-            return;
-        case 0x1f8010c8:
-            PSXHW_LOG("DMA4 CHCR 32bit write %x\n", value);
-            dmaExec<4>(value);  // DMA4 chcr (SPU DMA)
-            return;
-        case 0x1f8010d0:
-            PSXHW_LOG("DMA5 MADR 32bit write %x\n", value);
-            g_emulator->m_mem->setMADR<5>(value);
-            return;
 #if 0
         case 0x1f8010d8:
             PSXHW_LOG("DMA5 CHCR 32bit write %x\n", value);
             dmaExec<5>(value);  // DMA5 chcr (PIO DMA)
             return;
 #endif
-        case 0x1f8010e0:
-            PSXHW_LOG("DMA6 MADR 32bit write %x\n", value);
-            g_emulator->m_mem->setMADR<6>(value);
-            return;
-        case 0x1f8010e8:
-            PSXHW_LOG("DMA6 CHCR 32bit write %x\n", value);
-            dmaExec<6>(value);  // DMA6 chcr (OT clear)
-            return;
-        case 0x1f8010f0:
-            // TODO: check if toggling PCR triggers pending DMAs.
-            PSXHW_LOG("DMA PCR 32bit write %x\n", value);
-            g_emulator->m_mem->writeHardwareRegister<0x10f0>(value);
-            break;
-        case 0x1f8010f4:
-            PSXHW_LOG("DMA ICR 32bit write %x\n", value);
-            {
-                auto &mem = g_emulator->m_mem;
-                uint32_t icr = mem->readHardwareRegister<Memory::DMA_ICR>();
-                uint32_t ack = value & 0b0'1111111'000000000'000000000'000000;
-                bool wasNotTriggered = (icr & 0x80000000) == 0;
-                bool isTriggered = false;
-                bool hasError = value & 0x00008000;
-                bool isEnabled = value & 0x00800000;
-                ack ^= 0b0'1111111'000000000'000000000'000000;
-                value &= 0b0'0000000'111111111'000000000'111111;
-                icr &= ack;
-                icr |= value;
-                if (((icr & 0x7f008000) != 0) && (hasError || isEnabled)) {
-                    icr |= 0x80000000;
-                    isTriggered = true;
-                }
-                mem->writeHardwareRegister<Memory::DMA_ICR>(icr);
-                if (wasNotTriggered && isTriggered) {
-                    mem->setIRQ(8);
-                };
-                return;
-            }
         case 0x1f801014:
             PSXHW_LOG("SPU delay [0x1014] write32: %8.8lx\n", value);
             g_emulator->m_mem->writeHardwareRegister<0x1014>(value);
             break;
-        case 0x1f801810:
-            PSXHW_LOG("GPU DATA 32bit write %x (CMD/MSB %x)\n", value, value >> 24);
-            g_emulator->m_gpu->writeData(value);
-            break;
-        case 0x1f801814:
-            PSXHW_LOG("GPU STATUS 32bit write %x\n", value);
-            g_emulator->m_gpu->writeStatus(value);
-            break;
-        case 0x1f801820:
-            g_emulator->m_mdec->write0(value);
-            break;
-        case 0x1f801824:
-            g_emulator->m_mdec->write1(value);
-            break;
-        case 0x1f801100:
-            PSXHW_LOG("COUNTER 0 COUNT 32bit write %x\n", value);
-            g_emulator->m_counters->writeCounter(0, value & 0xffff);
-            break;
-        case 0x1f801104:
-            PSXHW_LOG("COUNTER 0 MODE 32bit write %x\n", value);
-            g_emulator->m_counters->writeMode(0, value);
-            break;
-        case 0x1f801108:
-            PSXHW_LOG("COUNTER 0 TARGET 32bit write %x\n", value);
-            g_emulator->m_counters->writeTarget(0, value & 0xffff);
-            break;  //  HW_DMA_ICR&= SWAP_LE32((~value)&0xff000000);
-        case 0x1f801110:
-            PSXHW_LOG("COUNTER 1 COUNT 32bit write %x\n", value);
-            g_emulator->m_counters->writeCounter(1, value & 0xffff);
-            break;
-        case 0x1f801114:
-            PSXHW_LOG("COUNTER 1 MODE 32bit write %x\n", value);
-            g_emulator->m_counters->writeMode(1, value);
-            break;
-        case 0x1f801118:
-            PSXHW_LOG("COUNTER 1 TARGET 32bit write %x\n", value);
-            g_emulator->m_counters->writeTarget(1, value & 0xffff);
-            break;
-        case 0x1f801120:
-            PSXHW_LOG("COUNTER 2 COUNT 32bit write %x\n", value);
-            g_emulator->m_counters->writeCounter(2, value & 0xffff);
-            break;
-        case 0x1f801124:
-            PSXHW_LOG("COUNTER 2 MODE 32bit write %x\n", value);
-            g_emulator->m_counters->writeMode(2, value);
-            break;
-        case 0x1f801128:
-            PSXHW_LOG("COUNTER 2 TARGET 32bit write %x\n", value);
-            g_emulator->m_counters->writeTarget(2, value & 0xffff);
-            break;
         case 0x1f802084: {
             IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
             memFile->rSeek(value);
@@ -845,19 +852,11 @@ void PCSX::HW::write32(uint32_t add, uint32_t value) {
             }
         }
         default: {
-            if ((hwadd >= 0x1f801c00) && (hwadd < 0x1f801e00)) {
-                write16(add, value & 0xffff);
-                write16(add + 2, value >> 16);
-                break;
-            }
-
             uint32_t *ptr = (uint32_t *)&g_emulator->m_mem->m_hard[hwadd & 0xffff];
             *ptr = SWAP_LEu32(value);
             PSXHW_LOG("*Unknown 32bit write at address %x value %x\n", add, value);
             return;
         }
     }
-    uint32_t *ptr = (uint32_t *)&g_emulator->m_mem->m_hard[hwadd & 0xffff];
-    *ptr = SWAP_LEu32(value);
-    PSXHW_LOG("*Known 32bit write at address %x value %x\n", add, value);
+    mirrorWrite32(add, value);
 }
@@ -19,11 +19,18 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
 #include "core/psxcounters.h"
 #include "core/psxdma.h"
+#include "core/logger.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/watchpoints.h"
 
 namespace PCSX {
 
@@ -37,7 +44,67 @@ class HW {
     void write16(uint32_t add, uint32_t value);
     void write32(uint32_t add, uint32_t value);
 
+    // The registers games hammer the most, such as the GPU, IRQ, DMA, timers and SPU ones, get their own handlers,
+    // looked up in tables built at compile time instead of going through the switches. The tables cover the
+    // 0x1f801000-0x1f801fff range, with one entry per halfword for 16-bit accesses, and one per word for 32-bit
+    // ones. A null handler means the access has to go through the generic path. The recompilers look them up
+    // for constant addresses, in order to emit direct calls.
+    using Read16Handler = uint16_t (*)(uint32_t add);
+    using Read32Handler = uint32_t (*)(uint32_t add);
+    using Write16Handler = void (*)(uint32_t add, uint32_t value);
+    using Write32Handler = void (*)(uint32_t add, uint32_t value);
+    static Read16Handler getRead16Handler(uint32_t add) {
+        return inHandlersRange(add, 1) ? s_read16Handlers[index16(add)] : nullptr;
+    }
+    static Read32Handler getRead32Handler(uint32_t add) {
+        return inHandlersRange(add, 3) ? s_read32Handlers[index32(add)] : nullptr;
+    }
+    static Write16Handler getWrite16Handler(uint32_t add) {
+        return inHandlersRange(add, 1) ? s_write16Handlers[index16(add)] : nullptr;
+    }
+    static Write32Handler getWrite32Handler(uint32_t add) {
+        return inHandlersRange(add, 3) ? s_write32Handlers[index32(add)] : nullptr;
+    }
+
+    // A few registers are plain latches: their handlers only read back what m_hard holds, or for 32-bit writes,
+    // store the new value there. The recompilers access those inline instead of calling the handlers, unless the
+    // hardware log would miss the accesses.
+    static bool isLatchRead(uint32_t add) {
+        if (PSXHW_LOGGER::c_enabled || !inHandlersRange(add, 1)) return false;
+        const uint32_t reg = add & 0xffff;
+        return (reg == 0x1070) || (reg == 0x1074);  // ISTAT, IMASK
+    }
+    static bool isLatchWrite32(uint32_t add) {
+        if (PSXHW_LOGGER::c_enabled || !inHandlersRange(add, 3)) return false;
+        const uint32_t reg = add & 0xffff;
+        return (reg == 0x1074) || (reg == 0x10f0);  // IMASK, DMA PCR
+    }
+
   private:
+    template <typename Handler, size_t count>
+    using Handlers = std::array<Handler, count>;
+    static constexpr size_t c_handlers16 = 0x800;
+    static constexpr size_t c_handlers32 = 0x400;
+    static constexpr bool inHandlersRange(uint32_t add, uint32_t alignmentMask) {
+        const uint32_t page = add >> 16;
+        if ((page != 0x1f80) && (page != 0x9f80) && (page != 0xbf80)) return false;
+        return ((add & 0xf000) == 0x1000) && ((add & alignmentMask) == 0);
+    }
+    static constexpr size_t index16(uint32_t add) { return (add & 0xfff) >> 1; }
+    static constexpr size_t index32(uint32_t add) { return (add & 0xfff) >> 2; }
+    static constexpr Handlers<Read16Handler, c_handlers16> makeRead16Handlers();
+    static constexpr Handlers<Read32Handler, c_handlers32> makeRead32Handlers();
+    static constexpr Handlers<Write16Handler, c_handlers16> makeWrite16Handlers();
+    static constexpr Handlers<Write32Handler, c_handlers32> makeWrite32Handlers();
+    static const Handlers<Read16Handler, c_handlers16> s_read16Handlers;
+    static const Handlers<Read32Handler, c_handlers32> s_read32Handlers;
+    static const Handlers<Write16Handler, c_handlers16> s_write16Handlers;
+    static const Handlers<Write32Handler, c_handlers32> s_write32Handlers;
+    template <unsigned n>
+    static void writeMADR(uint32_t add, uint32_t value);
+    template <unsigned n>
+    static void writeCHCR(uint32_t add, uint32_t value);
+
     void dma0(uint32_t madr, uint32_t bcr, uint32_t chcr);
     void dma1(uint32_t madr, uint32_t bcr, uint32_t chcr);
     void dma2(uint32_t madr, uint32_t bcr, uint32_t chcr);
@@ -48,6 +115,8 @@ class HW {
         auto &mem = g_emulator->m_mem;
         mem->setCHCR<n>(chcr);
         if ((chcr & 0x01000000) && mem->template isDMAEnabled<n>()) {
+            // The transfer isn't the CPU accessing RAM, so it doesn't trigger watchpoints.
+            Watchpoints::Suspend suspend;
             uint32_t madr = mem->template getMADR<n>();
             bool usingMsan = g_emulator->m_mem->msanInitialized();
             if (usingMsan && PCSX::Memory::inMsanRange(madr)) {
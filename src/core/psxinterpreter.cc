@@ -26,6 +26,8 @@
 #include "core/pgxp_gte.h"
 #include "core/psxemulator.h"
 #include "core/r3000a.h"
+#include "core/tracewriter.h"
+#include "support/flathashmap.h"
 #include "tracy/Tracy.hpp"
 
 #undef _PC_
@@ -88,9 +90,13 @@ class InterpretedCPU final : public PCSX::R3000Acpu {
   private:
     virtual bool Implemented() final { return true; }
     virtual bool Init() override;
-    virtual void Reset() override;
+    virtual void resetState() override;
     virtual void Execute() override;
     virtual void Clear(uint32_t Addr, uint32_t Size) override;
+    virtual void invalidateCache() override {
+        R3000Acpu::invalidateCache();
+        dropDecodedBlocks();
+    }
     virtual void Shutdown() override;
     virtual void SetPGXPMode(uint32_t pgxpMode) override;
     virtual bool isDynarec() override { return false; }
@@ -114,8 +120,33 @@ class InterpretedCPU final : public PCSX::R3000Acpu {
     cIntFunc_t *s_pPsxCP2 = NULL;
     cIntFunc_t *s_pPsxCP2BSC = NULL;
 
+    // When the trace setting is on along with a trace file, the trace goes there, in binary form,
+    // instead of the disassembly going to the CPU log.
+    PCSX::TraceWriter m_traceWriter;
+
     template <bool debug, bool trace>
     void execBlock();
+    void updateTraceWriter(bool trace);
+
+    // The cached interpreter, for when neither debugging nor tracing. Straight runs of instructions get decoded
+    // once, with the secondary opcode tables already looked up, and the result is reused until the memory they
+    // were decoded from gets written to. Blocks end after the delay slot of the first jump or branch.
+    struct DecodedInstruction {
+        intFunc_t handler;
+        uint32_t code;
+    };
+    static constexpr unsigned c_maxDecodedBlockSize = 64;
+    PCSX::FlatHashMap<uint32_t, std::vector<DecodedInstruction>> m_decodedBlocks;
+    // The start addresses of the decoded blocks overlapping each 4KB page of RAM, for invalidation.
+    std::vector<std::vector<uint32_t>> m_decodedPages = std::vector<std::vector<uint32_t>>(0x800000 >> 12);
+    // Bumped whenever decoded blocks get dropped, so that the block being run can tell it's gone.
+    uint32_t m_decodedGeneration = 0;
+
+    void execDecodedBlock();
+    const std::vector<DecodedInstruction> *decodeBlock(uint32_t pc);
+    intFunc_t decodeHandler(uint32_t code);
+    void dropDecodedBlocks();
+    void dropDecodedBlocks(uint32_t addr, uint32_t size);
     void doBranch(uint32_t target, bool fromLink);
 
     void MTC0(int reg, uint32_t val);
@@ -1564,8 +1595,8 @@ const InterpretedCPU::intFunc_t InterpretedCPU::s_pgxpPsxBSCMem[64] = {
 ///////////////////////////////////////////
 
 bool InterpretedCPU::Init() { return true; }
-void InterpretedCPU::Reset() {
-    R3000Acpu::Reset();
+void InterpretedCPU::resetState() {
+    R3000Acpu::resetState();
     m_nextIsDelaySlot = false;
     m_inDelaySlot = false;
     m_delayedLoadInfo[0].active = false;
@@ -1575,6 +1606,7 @@ void InterpretedCPU::Reset() {
 }
 void InterpretedCPU::Execute() {
     ZoneScoped;
+    const bool &cached = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingCachedInterpreter>();
     while (hasToRun()) {
         const bool &debug = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
                                 .get<PCSX::Emulator::DebugSettings::Debug>();
@@ -1582,6 +1614,7 @@ void InterpretedCPU::Execute() {
                                 .get<PCSX::Emulator::DebugSettings::Trace>();
         const bool &skipISR = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
                                   .get<PCSX::Emulator::DebugSettings::SkipISR>();
+        updateTraceWriter(trace);
         if (debug) {
             if (!trace || (skipISR && m_inISR)) {
                 execBlock<true, false>();
@@ -1590,7 +1623,11 @@ void InterpretedCPU::Execute() {
             }
         } else {
             if (!trace || (skipISR && m_inISR)) {
-                execBlock<false, false>();
+                if (cached) {
+                    execDecodedBlock();
+                } else {
+                    execBlock<false, false>();
+                }
             } else {
                 execBlock<false, true>();
             }
@@ -1599,13 +1636,160 @@ void InterpretedCPU::Execute() {
 }
 
 void InterpretedCPU::Clear(uint32_t Addr, uint32_t Size) {
+    if (!m_decodedBlocks.empty()) dropDecodedBlocks(Addr, Size);
+    // Past 256 lines, every line of the cache would get flushed at least once anyway
+    if (Size > 1024) {
+        R3000Acpu::invalidateCache();
+        return;
+    }
     for (auto i = 0; i < Size; i += 4) {
         flushICacheLine(Addr);
         Addr += 16;
     }
 }
 
-void InterpretedCPU::Shutdown() {}
+void InterpretedCPU::dropDecodedBlocks() {
+    if (m_decodedBlocks.empty()) return;
+    m_decodedBlocks.clear();
+    for (auto &page : m_decodedPages) page.clear();
+    m_decodedGeneration++;
+}
+
+// Size is in words, as for Clear.
+void InterpretedCPU::dropDecodedBlocks(uint32_t addr, uint32_t size) {
+    const uint32_t physical = addr & 0x1fffffff;
+    if ((physical >= 0x800000) || (size == 0)) return;
+    const uint32_t ramMask = PCSX::g_emulator->getRamMask();
+    const uint32_t first = (physical & ramMask) >> 12;
+    const uint32_t last = std::min((physical & ramMask) + size * 4 - 1, ramMask) >> 12;
+    for (uint32_t index = first; index <= last; index++) {
+        auto &page = m_decodedPages[index];
+        if (page.empty()) continue;
+        for (auto start : page) m_decodedBlocks.erase(start);
+        page.clear();
+        m_decodedGeneration++;
+    }
+}
+
+InterpretedCPU::intFunc_t InterpretedCPU::decodeHandler(uint32_t code) {
+    switch (_Op_) {
+        case 0x00:
+            return s_pPsxSPC[_Funct_];
+        case 0x01:
+            return s_pPsxREG[_Rt_];
+        case 0x10:
+            return s_pPsxCP0[_Rs_];
+    }
+    return s_pPsxBSC[_Op_];
+}
+
+// Returns nullptr for code that isn't in RAM or the BIOS, which goes through the plain interpreter instead.
+const std::vector<InterpretedCPU::DecodedInstruction> *InterpretedCPU::decodeBlock(uint32_t pc) {
+    const auto it = m_decodedBlocks.find(pc);
+    if (it != m_decodedBlocks.end()) return &it->second;
+
+    const uint32_t physical = pc & 0x1fffffff;
+    const bool ram = physical < 0x800000;
+    const bool bios = (physical >= 0x1fc00000) && (physical < 0x1fc80000);
+    if (!ram && !bios) return nullptr;
+
+    auto &memory = PCSX::g_emulator->m_mem;
+    std::vector<DecodedInstruction> block;
+    bool delaySlot = false;
+    for (uint32_t address = pc; block.size() < c_maxDecodedBlockSize; address += 4) {
+        const auto pointer = memory->getPointer<uint32_t>(address);
+        if (!pointer) break;
+        const uint32_t code = SWAP_LE32(*pointer);
+        block.push_back({decodeHandler(code), code});
+        if (delaySlot) break;
+
+        const uint32_t op = _Op_;
+        const uint32_t funct = _Funct_;
+        // Jumps and branches end the block after their delay slot, syscalls and breaks end it right away
+        if ((op >= 0x01 && op <= 0x07) || (op == 0 && (funct == 0x08 || funct == 0x09))) {
+            delaySlot = true;
+        } else if (op == 0 && (funct == 0x0c || funct == 0x0d)) {
+            break;
+        }
+    }
+    if (block.empty()) return nullptr;
+
+    if (ram) {
+        const uint32_t ramMask = PCSX::g_emulator->getRamMask();
+        const uint32_t first = (physical & ramMask) >> 12;
+        const uint32_t last = std::min((physical & ramMask) + uint32_t(block.size()) * 4 - 1, ramMask) >> 12;
+        for (uint32_t index = first; index <= last; index++) m_decodedPages[index].push_back(pc);
+    }
+    return &m_decodedBlocks.insert_or_assign(pc, std::move(block)).first->second;
+}
+
+// Same as execBlock<false, false>, minus the fetching and decoding.
+void InterpretedCPU::execDecodedBlock() {
+    uint32_t pc = m_regs.pc;
+    const auto block = decodeBlock(pc);
+    if (!block) {
+        execBlock<false, false>();
+        return;
+    }
+    const auto generation = m_decodedGeneration;
+    const size_t size = block->size();
+
+    for (size_t i = 0; i < size; i++, pc += 4) {
+        // Stop whenever we're not going down the block anymore, such as after an exception,
+        // or if the instruction we just ran wrote over the block.
+        if ((m_regs.pc != pc) || (m_decodedGeneration != generation)) return;
+        const auto &instruction = (*block)[i];
+
+        if (m_nextIsDelaySlot) {
+            m_inDelaySlot = true;
+            m_nextIsDelaySlot = false;
+        }
+        m_regs.code = instruction.code;
+        m_regs.pc += 4;
+        m_regs.cycle += PCSX::Emulator::BIAS;
+
+        (*this.*instruction.handler)(instruction.code);
+
+        m_currentDelayedLoad ^= 1;
+        flushCurrentDelayedLoad();
+        auto &delayedLoad = m_delayedLoadInfo[m_currentDelayedLoad];
+        if (delayedLoad.pcActive) {
+            m_regs.pc = delayedLoad.pcValue;
+            delayedLoad.pcActive = false;
+            delayedLoad.fromLink = false;
+        }
+        if (m_inDelaySlot) {
+            m_inDelaySlot = false;
+            if (m_delayedLoadInfo[0].active || m_delayedLoadInfo[1].active) {
+                InterceptBIOS<true>(m_regs.pc);
+            } else {
+                InterceptBIOS<true, true>(m_regs.pc);
+            }
+            branchTest();
+            return;
+        }
+    }
+}
+
+void InterpretedCPU::Shutdown() { m_traceWriter.close(); }
+
+void InterpretedCPU::updateTraceWriter(bool trace) {
+    auto &debugSettings = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>();
+    auto &traceFile = debugSettings.get<PCSX::Emulator::DebugSettings::TraceFile>();
+    const bool wanted = trace && !traceFile.empty();
+    if (wanted == m_traceWriter.isOpen()) return;
+    if (!wanted) {
+        m_traceWriter.close();
+        return;
+    }
+    const bool registers = debugSettings.get<PCSX::Emulator::DebugSettings::TraceRegisters>();
+    if (!m_traceWriter.open(traceFile.value, registers)) {
+        PCSX::g_system->printf(_("Unable to open trace file %s, tracing to the CPU log instead.\n"),
+                               reinterpret_cast<const char *>(traceFile.string().c_str()));
+        traceFile.reset();
+    }
+}
+
 // interpreter execution
 template <bool debug, bool trace>
 inline void InterpretedCPU::execBlock() {
@@ -1623,8 +1807,12 @@ inline void InterpretedCPU::execBlock() {
         m_regs.code = code;
 
         if constexpr (trace) {
-            std::string ins = PCSX::Disasm::asString(code, 0, pc, nullptr, true);
-            PCSX::g_system->log(PCSX::LogClass::CPU, "%s\n", ins);
+            if (m_traceWriter.isOpen()) {
+                m_traceWriter.before(pc, m_regs.GPR.r);
+            } else {
+                std::string ins = PCSX::Disasm::asString(code, 0, pc, nullptr, true);
+                PCSX::g_system->log(PCSX::LogClass::CPU, "%s\n", ins);
+            }
         }
 
         m_regs.pc += 4;
@@ -1635,6 +1823,9 @@ inline void InterpretedCPU::execBlock() {
 
         m_currentDelayedLoad ^= 1;
         flushCurrentDelayedLoad();
+        if constexpr (trace) {
+            if (m_traceWriter.isOpen()) m_traceWriter.after(pc, code, m_regs.GPR.r);
+        }
         auto &delayedLoad = m_delayedLoadInfo[m_currentDelayedLoad];
         bool fromLink = false;
         if (delayedLoad.pcActive) {
@@ -1646,7 +1837,12 @@ inline void InterpretedCPU::execBlock() {
         if (m_inDelaySlot) {
             m_inDelaySlot = false;
             ranDelaySlot = true;
-            InterceptBIOS<true>(m_regs.pc);
+            // A load still in flight would be lost by leaving the kernel vector right away.
+            if (m_delayedLoadInfo[0].active || m_delayedLoadInfo[1].active) {
+                InterceptBIOS<true>(m_regs.pc);
+            } else {
+                InterceptBIOS<true, true>(m_regs.pc);
+            }
             branchTest();
         }
         if constexpr (debug) {
@@ -1686,7 +1882,7 @@ void InterpretedCPU::SetPGXPMode(uint32_t pgxpMode) {
     }
 
     // reset to ensure new func tables are used
-    InterpretedCPU::Reset();
+    Reset();
 }
 
 std::unique_ptr<PCSX::R3000Acpu> PCSX::Cpus::getInterpreted() {
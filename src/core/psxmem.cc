@@ -106,6 +106,8 @@ int PCSX::Memory::init() {
     if (!success) g_system->message(_("SharedMem failed to share memory for wram, falling back to memory alloc\n"));
     m_wram = m_wramShared.getPtr();
 
+    // Only the PIO window of EXP1 gets filled, so the rest of it stays as pages the system hasn't committed yet,
+    // which save states and snapshots are careful not to write to either.
     m_exp1 = (uint8_t *)calloc(0x00800000, 1);
     m_hard = (uint8_t *)calloc(0x00010000, 1);
     m_bios = (uint8_t *)calloc(0x00080000, 1);
@@ -139,6 +141,7 @@ int PCSX::Memory::init() {
 bool PCSX::Memory::loadEXP1FromFile(std::filesystem::path rom_path) {
     const size_t exp1_size = 0x00040000;
     bool result = false;
+    g_emulator->m_pioCart->flushFlash();
 
     auto &exp1Path = rom_path;
     if (!exp1Path.empty()) {
@@ -172,6 +175,7 @@ void PCSX::Memory::reset() {
     const uint32_t bios_size = 0x00080000;
     const uint32_t exp1_size = 0x00040000;
     memset(m_wram, 0, 0x00800000);
+    markAllDirty();
     memset(m_exp1, 0xff, exp1_size);
     memset(m_bios, 0, bios_size);
     static const uint32_t nobios[6] = {
@@ -513,6 +517,7 @@ void PCSX::Memory::write8(uint32_t address, uint32_t value) {
         [[likely]];
         const uint32_t offset = address & 0xffff;
         *(pointer + offset) = static_cast<uint8_t>(value);
+        markDirty(pointer + offset);
         g_emulator->m_cpu->Clear((address & (~3)), 1);
     } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400) {
@@ -550,6 +555,7 @@ void PCSX::Memory::write16(uint32_t address, uint32_t value) {
         [[likely]];
         const uint32_t offset = address & 0xffff;
         *(uint16_t *)(pointer + offset) = SWAP_LEu16(static_cast<uint16_t>(value));
+        markDirty(pointer + offset);
         g_emulator->m_cpu->Clear((address & (~3)), 1);
     } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400) {
@@ -588,6 +594,7 @@ void PCSX::Memory::write32(uint32_t address, uint32_t value) {
         [[likely]];
         const uint32_t offset = address & 0xffff;
         *(uint32_t *)(pointer + offset) = SWAP_LEu32(value);
+        markDirty(pointer + offset);
         g_emulator->m_cpu->Clear((address & (~3)), 1);
     } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400) {
@@ -791,6 +798,23 @@ ssize_t PCSX::Memory::MemoryAsFile::writeAt(const void *src, size_t size, size_t
     return ret;
 }
 
+PCSX::Slice PCSX::Memory::MemoryAsFile::viewAt(size_t size, size_t ptr) {
+    if (ptr >= c_size) return {};
+    size = cappedSize(size, ptr);
+    if (size == 0) return {};
+    // Only ranges which are mapped, and contiguous in host memory, can be referenced
+    // directly; this is the case for the RAM and its mirrors, for instance.
+    auto first = m_memory->m_readLUT[ptr / c_blockSize];
+    bool contiguous = first != nullptr;
+    for (size_t block = ptr / c_blockSize + 1; contiguous && (block <= (ptr + size - 1) / c_blockSize); block++) {
+        contiguous = m_memory->m_readLUT[block] == first + (block - ptr / c_blockSize) * c_blockSize;
+    }
+    if (!contiguous) return File::viewAt(size, ptr);
+    Slice ret;
+    ret.borrow(first + ptr % c_blockSize, size);
+    return ret;
+}
+
 void PCSX::Memory::MemoryAsFile::readBlock(void *dest_, size_t size, size_t ptr) {
     auto dest = reinterpret_cast<uint8_t *>(dest_);
     auto block = m_memory->m_readLUT[ptr / c_blockSize];
@@ -829,6 +853,26 @@ void PCSX::Memory::MemoryAsFile::writeBlock(const void *src_, size_t size, size_
     auto offset = ptr % c_blockSize;
     auto toCopy = std::min(size, c_blockSize - offset);
     memcpy(block + offset, src, toCopy);
+    m_memory->markDirtyRange(ptr, toCopy);
+}
+
+PCSX::Memory::DirtyPages PCSX::Memory::takeDirtyPages(unsigned consumer) {
+    // The writers only ever touch m_dirtyPages, so it gets spread over the consumers here.
+    for (auto& pages : m_dirtyPagesConsumers) {
+        for (size_t i = 0; i < c_dirtyPageCount; i++) pages[i] |= m_dirtyPages[i];
+    }
+    m_dirtyPages.fill(0);
+    DirtyPages ret = m_dirtyPagesConsumers[consumer];
+    m_dirtyPagesConsumers[consumer].fill(0);
+    return ret;
+}
+
+void PCSX::Memory::markDirtyRange(uint32_t address, uint32_t size) {
+    if (size == 0) return;
+    const uint32_t last = (address + size - 1) >> c_dirtyPageShift;
+    for (uint32_t page = address >> c_dirtyPageShift; page <= last; page++) {
+        markDirty(getPointer(page << c_dirtyPageShift));
+    }
 }
 
 void PCSX::Memory::initMsan(bool reset) {
@@ -850,13 +894,15 @@ void PCSX::Memory::initMsan(bool reset) {
 
     // 1.5GB of RAM, with 384MB worth of bitmap, between 0x20000000 and 0x80000000
     m_msanRAM = (uint8_t *)calloc(c_msanSize, 1);
-    m_msanUsableBitmap = (uint8_t *)calloc(c_msanSize / 8, 1);
-    m_msanInitializedBitmap = (uint8_t *)calloc(c_msanSize / 8, 1);
+    m_msanUsableBitmap = (uint8_t *)calloc(c_msanSize / 8 + 1, 1);
+    m_msanInitializedBitmap = (uint8_t *)calloc(c_msanSize / 8 + 1, 1);
     m_msanPtr = 1024;
     for (uint32_t segment = c_msanStart; segment < c_msanEnd; segment += 0x10000) {
         m_readLUT[segment >> 16] = m_msanRAM + (segment - c_msanStart);
         m_writeLUT[segment >> 16] = m_msanRAM + (segment - c_msanStart);
     }
+    // The dynarecs inline plain memory accesses, which would bypass the MSAN checks in already compiled code
+    g_emulator->m_cpu->invalidateCache();
 }
 
 uint32_t PCSX::Memory::msanAlloc(uint32_t size) {
@@ -877,9 +923,7 @@ uint32_t PCSX::Memory::msanAlloc(uint32_t size) {
     uint32_t ptr = m_msanPtr;
     m_msanPtr += actualSize;
     // Mark the allocation as usable.
-    for (uint32_t i = 0; i < size; i++) {
-        m_msanUsableBitmap[(ptr + i) / 8] |= 1 << ((ptr + i) % 8);
-    }
+    msanSetBits(m_msanUsableBitmap, ptr, size);
 
     // Insert the allocation into the list of allocations.
     m_msanAllocs.insert({ptr, size});
@@ -904,9 +948,7 @@ void PCSX::Memory::msanFree(uint32_t ptr) {
         return;
     }
     // Mark the allocation as unusable.
-    for (uint32_t i = 0; i < m_msanAllocs[ptr]; i++) {
-        m_msanUsableBitmap[(ptr + i) / 8] &= ~(1 << ((ptr + i) % 8));
-    }
+    msanClearBits(m_msanUsableBitmap, ptr, it->second);
     // Remove the allocation from the list of allocations.
     m_msanAllocs.erase(ptr);
 }
@@ -943,19 +985,57 @@ uint32_t PCSX::Memory::msanRealloc(uint32_t ptr, uint32_t size) {
     memcpy(m_msanRAM + newPtr, m_msanRAM + ptr, std::min(size, oldSize));
 
     // Mark the old allocation as unusable
-    for (uint32_t i = 0; i < oldSize; i++) {
-        m_msanUsableBitmap[(ptr + i) / 8] &= ~(1 << ((ptr + i) % 8));
-    }
+    msanClearBits(m_msanUsableBitmap, ptr, oldSize);
     // Mark the new allocation as written to
     auto toCopy = std::min(size, oldSize);
-    for (uint32_t i = 0; i < toCopy; i++) {
-        m_msanInitializedBitmap[(newPtr + i) / 8] |= 1 << ((newPtr + i) % 8);
-    }
+    msanSetBits(m_msanInitializedBitmap, newPtr, toCopy);
     // Remove the allocation from the list of allocations.
     m_msanAllocs.erase(ptr);
     return newPtr + c_msanStart;
 }
 
+void PCSX::Memory::msanSetBits(uint8_t *bitmap, uint32_t offset, uint32_t size) {
+    for (; size && (offset % 8); --size, ++offset) bitmap[offset / 8] |= 1 << (offset % 8);
+    memset(bitmap + offset / 8, 0xff, size / 8);
+    offset += size & ~7;
+    for (size %= 8; size; --size, ++offset) bitmap[offset / 8] |= 1 << (offset % 8);
+}
+
+void PCSX::Memory::msanClearBits(uint8_t *bitmap, uint32_t offset, uint32_t size) {
+    for (; size && (offset % 8); --size, ++offset) bitmap[offset / 8] &= ~(1 << (offset % 8));
+    memset(bitmap + offset / 8, 0, size / 8);
+    offset += size & ~7;
+    for (size %= 8; size; --size, ++offset) bitmap[offset / 8] &= ~(1 << (offset % 8));
+}
+
+bool PCSX::Memory::msanAllBitsSet(const uint8_t *bitmap, uint32_t offset, uint32_t size) {
+    for (; size && (offset % 8); --size, ++offset) {
+        if (!(bitmap[offset / 8] & (1 << (offset % 8)))) return false;
+    }
+    const uint8_t *bytes = bitmap + offset / 8;
+    uint32_t count = size / 8;
+    for (; count >= 8; count -= 8, bytes += 8) {
+        uint64_t word;
+        memcpy(&word, bytes, sizeof(word));
+        if (word != ~uint64_t(0)) return false;
+    }
+    for (; count; --count, ++bytes) {
+        if (*bytes != 0xff) return false;
+    }
+    offset += size & ~7;
+    for (size %= 8; size; --size, ++offset) {
+        if (!(bitmap[offset / 8] & (1 << (offset % 8)))) return false;
+    }
+    return true;
+}
+
+PCSX::MsanStatus PCSX::Memory::msanGetRangeStatus(uint32_t addr, uint32_t size) const {
+    const uint32_t offset = addr - c_msanStart;
+    if (msanAllBitsSet(m_msanInitializedBitmap, offset, size)) return MsanStatus::OK;
+    if (!msanAllBitsSet(m_msanUsableBitmap, offset, size)) return MsanStatus::UNUSABLE;
+    return MsanStatus::UNINITIALIZED;
+}
+
 uint32_t PCSX::Memory::msanSetChainPtr(uint32_t headerAddr, uint32_t nextPtr, uint32_t wordCount) {
     if (!inMsanRange(headerAddr)) {
         headerAddr &= 0xffffff;
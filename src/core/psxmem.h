@@ -19,6 +19,10 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <string.h>
+
+#include <array>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
@@ -93,52 +97,37 @@ class Memory {
 
     template <uint32_t length>
     MsanStatus msanGetStatus(uint32_t addr) const {
-        uint32_t bitmapIndex = (addr - c_msanStart) / 8;
-        uint32_t bitmask = ((1 << length) - 1) << addr % 8;
-        MsanStatus bestCase = MsanStatus::OK;
-        if (uint32_t nextBitmask = bitmask >> 8) [[unlikely]] {
-            if ((m_msanInitializedBitmap[bitmapIndex + 1] & nextBitmask) != nextBitmask) {
-                if ((m_msanUsableBitmap[bitmapIndex + 1] & nextBitmask) != nextBitmask) {
-                    return MsanStatus::UNUSABLE;
-                }
-                bestCase = MsanStatus::UNINITIALIZED;
-            }
-            bitmask &= 0xff;
+        const uint32_t offset = addr - c_msanStart;
+        const uint32_t mask = ((1 << length) - 1) << offset % 8;
+        const uint32_t missing = mask & ~msanBits(m_msanInitializedBitmap, offset);
+        if (missing == 0) [[likely]] {
+            return MsanStatus::OK;
         }
-        if ((m_msanInitializedBitmap[bitmapIndex] & bitmask) != bitmask) [[unlikely]] {
-            if ((m_msanUsableBitmap[bitmapIndex] & bitmask) != bitmask) {
-                return MsanStatus::UNUSABLE;
-            }
-            return MsanStatus::UNINITIALIZED;
+        if ((msanBits(m_msanUsableBitmap, offset) & missing) != missing) {
+            return MsanStatus::UNUSABLE;
         }
-        return bestCase;
+        return MsanStatus::UNINITIALIZED;
     }
 
     // if the write is valid, marks the address as initialized, otherwise returns false
     template <uint32_t length>
     bool msanValidateWrite(uint32_t addr) {
-        uint32_t bitmapIndex = (addr - c_msanStart) / 8;
-        uint32_t bitmask = ((1 << length) - 1) << addr % 8;
-        if (uint32_t nextBitmask = bitmask >> 8) [[unlikely]] {
-            if ((m_msanUsableBitmap[bitmapIndex + 1] & nextBitmask) != nextBitmask) {
-                return false;
-            }
-            m_msanInitializedBitmap[bitmapIndex + 1] |= nextBitmask;
-            bitmask &= 0xff;
-        }
-        if ((m_msanUsableBitmap[bitmapIndex] & bitmask) != bitmask) [[unlikely]] {
+        const uint32_t offset = addr - c_msanStart;
+        const uint32_t mask = ((1 << length) - 1) << offset % 8;
+        if ((msanBits(m_msanUsableBitmap, offset) & mask) != mask) [[unlikely]] {
             return false;
         }
-        m_msanInitializedBitmap[bitmapIndex] |= bitmask;
+        m_msanInitializedBitmap[offset / 8] |= mask;
+        m_msanInitializedBitmap[offset / 8 + 1] |= mask >> 8;
         return true;
     }
 
+    // The same as msanGetStatus, for a whole range, such as the source of a DMA.
+    MsanStatus msanGetRangeStatus(uint32_t addr, uint32_t size) const;
+
     void msanDmaWrite(uint32_t addr, uint32_t size) {
         if (!msanInitialized() || !inMsanRange(addr)) return;
-        addr -= c_msanStart;
-        for (uint32_t i = 0; i < size; ++i) {
-            m_msanInitializedBitmap[(addr + i) / 8] |= 1 << ((addr + i) % 8);
-        }
+        msanSetBits(m_msanInitializedBitmap, addr - c_msanStart, size);
     }
 
     static inline bool inMsanRange(uint32_t addr) { return addr >= c_msanStart && addr < c_msanEnd; }
@@ -255,6 +244,40 @@ class Memory {
         writeHardwareRegister<ISTAT>(istat);
     }
 
+    // Which 4kB pages of RAM got written to since the last takeDirtyPages(). It's one byte per page rather
+    // than one bit, so that marking one is a single store, which the recompilers inline next to theirs.
+    // Everything writing RAM on behalf of the emulated machine marks it: write8/16/32, the recompilers'
+    // direct stores, DMAs, MemoryAsFile, and loading states. Only raw pointers to m_wram, such as the
+    // Lua getMemPtr() one, bypass it.
+    static constexpr unsigned c_dirtyPageShift = 12;
+    static constexpr size_t c_dirtyPageCount = 0x00800000 >> c_dirtyPageShift;
+    typedef std::array<uint8_t, c_dirtyPageCount> DirtyPages;
+    // The flag of the page of RAM holding this host pointer, or nullptr if it's not in RAM.
+    uint8_t *dirtyFlag(const void *pointer) {
+        const uintptr_t offset = reinterpret_cast<uintptr_t>(pointer) - reinterpret_cast<uintptr_t>(m_wram);
+        return offset < 0x00800000 ? &m_dirtyPages[offset >> c_dirtyPageShift] : nullptr;
+    }
+    void markDirty(const void *pointer) {
+        if (auto flag = dirtyFlag(pointer)) *flag = 1;
+    }
+    // For a range of CPU addresses, mirrors included.
+    void markDirtyRange(uint32_t address, uint32_t size);
+    void markAllDirty() { m_dirtyPages.fill(1); }
+    // The page of RAM holding this CPU address, or -1 if it's not in RAM.
+    int dirtyPageOf(uint32_t address) {
+        const uintptr_t offset =
+            reinterpret_cast<uintptr_t>(pointerRead(address)) - reinterpret_cast<uintptr_t>(m_wram);
+        return offset < 0x00800000 ? int(offset >> c_dirtyPageShift) : -1;
+    }
+    // Each user of the dirty pages gets its own set of them, so that taking them doesn't hide writes from
+    // the other ones. Consumer 0 always exists, and is the default one.
+    unsigned addDirtyPagesConsumer() {
+        m_dirtyPagesConsumers.emplace_back();
+        return m_dirtyPagesConsumers.size() - 1;
+    }
+    // Returns the pages written to so far, and starts over, with nothing written in between getting lost.
+    DirtyPages takeDirtyPages(unsigned consumer = 0);
+
     uint32_t getBiosCRC32() { return m_biosCRC; }
     std::string_view getBiosVersionString();
 
@@ -281,6 +304,7 @@ class Memory {
         }
         ssize_t readAt(void *dest, size_t size, size_t ptr) final override;
         ssize_t writeAt(const void *src, size_t size, size_t ptr) final override;
+        Slice viewAt(size_t size, size_t ptr) final override;
 
       private:
         MemoryAsFile(Memory *memory) : File(File::FileType::RW_SEEKABLE), m_memory(memory) {}
@@ -308,9 +332,13 @@ class Memory {
 
     // Shared memory wrappers, pointers below point to these where appropriate
     friend class GdbClient;
+    friend class FastMem;
+    friend class Watchpoints;
     SharedMem m_wramShared;
 
     uint32_t m_BIU = 0;
+    DirtyPages m_dirtyPages = {};
+    std::vector<DirtyPages> m_dirtyPagesConsumers = std::vector<DirtyPages>(1);
 
     // hopefully this should become private eventually, with only certain classes having direct access.
   public:
@@ -328,6 +356,15 @@ class Memory {
     uint8_t *m_msanRAM = nullptr;
     uint8_t *m_msanUsableBitmap = nullptr;
     uint8_t *m_msanInitializedBitmap = nullptr;
+    // Both bitmaps have one bit per byte of MSAN memory, plus a byte of padding, so that accesses up to 32 bits
+    // always fit in the 16 bits starting at the byte of their first bit. The range helpers work byte or word
+    // at a time in the middle of their range, which is where long ranges spend their time.
+    static uint32_t msanBits(const uint8_t *bitmap, uint32_t offset) {
+        return bitmap[offset / 8] | (bitmap[offset / 8 + 1] << 8);
+    }
+    static void msanSetBits(uint8_t *bitmap, uint32_t offset, uint32_t size);
+    static void msanClearBits(uint8_t *bitmap, uint32_t offset, uint32_t size);
+    static bool msanAllBitsSet(const uint8_t *bitmap, uint32_t offset, uint32_t size);
     uint32_t m_msanPtr = 1024;
     EventBus::Listener m_listener;
 
@@ -27,8 +27,10 @@
 
 #include "core/cdrom.h"
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "core/gpu.h"
 #include "core/gte.h"
+#include "core/guestprofiler.h"
 #include "core/mdec.h"
 #include "core/pgxp_mem.h"
 #include "core/sio.h"
@@ -58,6 +60,8 @@ void PCSX::R3000Acpu::psxReset() {
     Reset();
 
     memset(&m_regs, 0, sizeof(m_regs));
+    m_idleCyclesSkipped = 0;
+    m_idleLoopsSkipped = 0;
     m_shellStarted = false;
     m_inISR = false;
     m_nextIsDelaySlot = false;
@@ -77,9 +81,46 @@ void PCSX::R3000Acpu::psxReset() {
     m_regs.CP0.r[15] = 0x00000002;  // PRevID = Revision ID, same as R3000A
 
     PCSX::g_emulator->m_hw->reset();
+    openBlockTrace();
+
+    auto& debugSettings = g_emulator->settings.get<Emulator::SettingDebugSettings>();
+    auto& profiler = g_emulator->m_guestProfiler;
+    if (!debugSettings.get<Emulator::DebugSettings::ProfileFile>().empty() && !profiler->isRunning()) {
+        profiler->start(debugSettings.get<Emulator::DebugSettings::ProfileInterval>(), m_regs.cycle);
+    }
 }
 
-void PCSX::R3000Acpu::psxShutdown() { Shutdown(); }
+void PCSX::R3000Acpu::psxShutdown() {
+    m_blockTrace.close();
+    auto& profileFile = g_emulator->settings.get<Emulator::SettingDebugSettings>()
+                            .get<Emulator::DebugSettings::ProfileFile>();
+    auto& profiler = g_emulator->m_guestProfiler;
+    if (!profileFile.empty() && !profiler->empty()) {
+        if (!profiler->save(profileFile.value, GuestProfiler::formatFor(profileFile.value))) {
+            g_system->printf(_("Unable to save the profile to %s.\n"),
+                             reinterpret_cast<const char*>(profileFile.string().c_str()));
+        }
+    }
+    Shutdown();
+}
+
+void PCSX::R3000Acpu::openBlockTrace() {
+    auto& debugSettings = g_emulator->settings.get<Emulator::SettingDebugSettings>();
+    const auto& record = debugSettings.get<Emulator::DebugSettings::BlockTraceRecord>();
+    const auto& verify = debugSettings.get<Emulator::DebugSettings::BlockTraceVerify>();
+    m_blockTrace.close();
+    if (!verify.empty()) {
+        if (!m_blockTrace.verify(verify.value)) {
+            g_system->printf(_("Unable to open block trace %s for verification.\n"),
+                             reinterpret_cast<const char*>(verify.string().c_str()));
+        }
+    } else if (!record.empty()) {
+        if (!m_blockTrace.record(record.value)) {
+            g_system->printf(_("Unable to create block trace %s.\n"),
+                             reinterpret_cast<const char*>(record.string().c_str()));
+        }
+    }
+}
 
 void PCSX::R3000Acpu::exception(uint32_t code, bool bd, bool cop0) {
     auto& emuSettings = g_emulator->settings;
@@ -352,51 +393,90 @@ void PCSX::R3000Acpu::branchTest() {
     }
 #endif
 
+    // Interrupts run from here do the DMA transfers' work, and breakpoint invokers may touch memory as well.
+    // None of this is the CPU accessing RAM.
+    Watchpoints::Suspend suspend;
+    if (g_emulator->m_debug->hasWatchpointHits()) g_emulator->m_debug->processWatchpointHits();
+
+    const uint32_t pc = m_regs.pc;
+    if (m_blockTrace.isActive()) m_blockTrace.step(pc, m_regs.cycle, m_regs.GPR.r);
+    auto& profiler = g_emulator->m_guestProfiler;
+    if (profiler->due(m_regs.cycle)) profiler->sample(pc, m_regs.cycle);
+    // We got back to the same place without anything happening in between, so if this is an idle loop, it'll
+    // keep spinning until the next event. Let's go straight there.
+    const bool looped = (m_branchTestHistory[0].pc == pc) ||
+                        ((m_branchTestHistory[1].pc == pc) && m_branchTestHistory[0].quiet);
+    if (looped && g_emulator->settings.get<Emulator::SettingIdleLoopSkip>() && isIdleLoop(pc)) {
+        const uint64_t target = std::min(m_regs.lowestTarget, g_emulator->m_counters->m_psxNextCounter);
+        if (target > m_regs.cycle) {
+            m_idleCyclesSkipped += target - m_regs.cycle;
+            m_idleLoopsSkipped++;
+            m_regs.cycle = target;
+        }
+    }
+    m_branchTestHistory[1] = m_branchTestHistory[0];
+    m_branchTestHistory[0] = {pc, true};
+
     const uint64_t cycle = m_regs.cycle;
 
-    if (cycle >= g_emulator->m_counters->m_psxNextCounter) g_emulator->m_counters->update();
-
-    if (m_regs.spuInterrupt.exchange(false)) g_emulator->m_spu->interrupt();
-
-    const uint32_t interrupts = m_regs.interrupt;
-
-    int32_t lowestDistance = std::numeric_limits<int64_t>::max();
-    uint64_t lowestTarget = cycle;
-    uint64_t* targets = m_regs.intTargets;
-
-    if ((interrupts != 0) && (m_regs.lowestTarget < cycle)) {
-#define checkAndUpdate(irq, act)                                                          \
-    {                                                                                     \
-        constexpr uint32_t mask = 1 << irq;                                               \
-        if ((interrupts & mask) != 0) {                                                   \
-            uint64_t target = targets[irq];                                               \
-            int64_t dist = target - cycle;                                                \
-            if (dist > 0) {                                                               \
-                if (lowestDistance > dist) {                                              \
-                    lowestDistance = dist;                                                \
-                    lowestTarget = target;                                                \
-                }                                                                         \
-            } else {                                                                      \
-                m_regs.interrupt &= ~mask;                                                \
-                PSXIRQ_LOG("Triggering interrupt %08x\n", magic_enum::enum_integer(irq)); \
-                act();                                                                    \
-            }                                                                             \
-        }                                                                                 \
+    if (cycle >= g_emulator->m_counters->m_psxNextCounter) {
+        g_emulator->m_counters->update();
+        m_branchTestHistory[0].quiet = false;
     }
-        checkAndUpdate(PSXINT_SIO, g_emulator->m_sio->interrupt);
-        checkAndUpdate(PSXINT_SIO1, g_emulator->m_sio1->interrupt);
-        checkAndUpdate(PSXINT_CDR, g_emulator->m_cdrom->interrupt);
-        checkAndUpdate(PSXINT_CDREAD, g_emulator->m_cdrom->readInterrupt);
-        checkAndUpdate(PSXINT_GPUDMA, GPU::gpuInterrupt);
-        checkAndUpdate(PSXINT_MDECOUTDMA, g_emulator->m_mdec->mdec1Interrupt);
-        checkAndUpdate(PSXINT_SPUDMA, spuInterrupt);
-        checkAndUpdate(PSXINT_MDECINDMA, g_emulator->m_mdec->mdec0Interrupt);
-        checkAndUpdate(PSXINT_GPUOTCDMA, gpuotcInterrupt);
-        checkAndUpdate(PSXINT_CDRDMA, g_emulator->m_cdrom->dmaInterrupt);
-        checkAndUpdate(PSXINT_CDRPLAY, g_emulator->m_cdrom->playInterrupt);
-        checkAndUpdate(PSXINT_CDRDBUF, g_emulator->m_cdrom->decodedBufferInterrupt);
-        checkAndUpdate(PSXINT_CDRLID, g_emulator->m_cdrom->lidSeekInterrupt);
-        m_regs.lowestTarget = lowestTarget;
+
+    // Most of the time there's nothing to exchange, so the locked operation is only done when needed.
+    if (m_regs.spuInterrupt.load(std::memory_order_relaxed) && m_regs.spuInterrupt.exchange(false)) {
+        g_emulator->m_spu->interrupt();
+        m_branchTestHistory[0].quiet = false;
+    }
+
+    if (cycle >= m_regs.lowestTarget) {
+        m_branchTestHistory[0].quiet = false;
+        // Everything that's due gets taken out of the queue first, so that a handler scheduling an interrupt
+        // right away won't see it run again during the same pass.
+        uint8_t due[PSXINT_COUNT];
+        unsigned count = 0;
+        int irq;
+        while ((irq = m_events.popDue(cycle)) >= 0) due[count++] = irq;
+
+        for (unsigned i = 0; i < count; i++) {
+            irq = due[i];
+            const uint32_t mask = 1 << irq;
+            // This one got cancelled, or rescheduled, by an earlier handler.
+            if (((m_regs.interrupt & mask) == 0) || m_events.scheduled(irq)) continue;
+#define trigger(irq, act)                                          \
+    case irq:                                                      \
+        m_regs.interrupt &= ~mask;                                 \
+        PSXIRQ_LOG("Triggering interrupt %08x\n", unsigned(irq));  \
+        act();                                                     \
+        break;
+#define triggerIn(irq, act, subsystem)                             \
+    case irq: {                                                    \
+        m_regs.interrupt &= ~mask;                                 \
+        PSXIRQ_LOG("Triggering interrupt %08x\n", unsigned(irq));  \
+        FrameStats::Scope scope(FrameStats::subsystem);            \
+        act();                                                     \
+        break;                                                     \
+    }
+            switch (irq) {
+                trigger(PSXINT_SIO, g_emulator->m_sio->interrupt);
+                trigger(PSXINT_SIO1, g_emulator->m_sio1->interrupt);
+                triggerIn(PSXINT_CDR, g_emulator->m_cdrom->interrupt, CDROM);
+                triggerIn(PSXINT_CDREAD, g_emulator->m_cdrom->readInterrupt, CDROM);
+                trigger(PSXINT_GPUDMA, GPU::gpuInterrupt);
+                triggerIn(PSXINT_MDECOUTDMA, g_emulator->m_mdec->mdec1Interrupt, MDEC);
+                trigger(PSXINT_SPUDMA, spuInterrupt);
+                triggerIn(PSXINT_MDECINDMA, g_emulator->m_mdec->mdec0Interrupt, MDEC);
+                trigger(PSXINT_GPUOTCDMA, gpuotcInterrupt);
+                triggerIn(PSXINT_CDRDMA, g_emulator->m_cdrom->dmaInterrupt, CDROM);
+                triggerIn(PSXINT_CDRPLAY, g_emulator->m_cdrom->playInterrupt, CDROM);
+                triggerIn(PSXINT_CDRDBUF, g_emulator->m_cdrom->decodedBufferInterrupt, CDROM);
+                triggerIn(PSXINT_CDRLID, g_emulator->m_cdrom->lidSeekInterrupt, CDROM);
+            }
+#undef triggerIn
+#undef trigger
+        }
+        m_regs.lowestTarget = m_events.nextDeadline();
     }
     auto& mem = g_emulator->m_mem;
     auto istat = mem->readHardwareRegister<Memory::ISTAT>();
@@ -413,10 +493,42 @@ void PCSX::R3000Acpu::branchTest() {
         }
 
         PSXIRQ_LOG("Interrupt: %x %x\n", istat, imask);
+        m_branchTestHistory[0].quiet = false;
         exception(0x400, 0);
     }
 }
 
+bool PCSX::R3000Acpu::isIdleLoop(uint32_t pc) {
+    // The code can't be further away than the end of the memory page it's in.
+    const uint32_t* code = g_emulator->m_mem->getPointer<uint32_t>(pc & ~3);
+    if (!code) return false;
+    const unsigned count = std::min(IdleLoop::MAX_INSTRUCTIONS, (0x10000 - (pc & 0xfffc)) / 4);
+
+    auto& entry = m_idleLoopCache[(pc >> 2) & (IDLE_LOOP_CACHE_SIZE - 1)];
+    bool same = entry.pc == pc;
+    for (unsigned i = 0; same && (i < std::max(entry.loop.length, 1u)); i++) {
+        same = entry.code[i] == SWAP_LEu32(code[i]);
+    }
+    if (!same) {
+        entry.pc = pc;
+        for (unsigned i = 0; i < count; i++) entry.code[i] = SWAP_LEu32(code[i]);
+        entry.loop = IdleLoop::analyze(entry.code, count, pc);
+    }
+
+    const auto& loop = entry.loop;
+    if (loop.length == 0) return false;
+    for (unsigned i = 0; i < loop.loadCount; i++) {
+        const auto& load = loop.loads[i];
+        if (!IdleLoop::isStableAddress(m_regs.GPR.r[load.base] + load.offset, load.size)) return false;
+    }
+
+    // An interrupt is about to be taken anyway.
+    auto& mem = g_emulator->m_mem;
+    const uint32_t istat = mem->readHardwareRegister<Memory::ISTAT>();
+    const uint32_t imask = mem->readHardwareRegister<Memory::IMASK>();
+    return !((istat & imask) && ((m_regs.CP0.n.Status & 0x401) == 0x401));
+}
+
 void PCSX::R3000Acpu::psxSetPGXPMode(uint32_t pgxpMode) {
     SetPGXPMode(pgxpMode);
     // g_emulator->m_cpu->Reset();
@@ -469,6 +581,117 @@ void PCSX::R3000Acpu::processA0KernelCall(uint32_t call) {
     }
 }
 
+bool PCSX::R3000Acpu::hleA0KernelCall(uint32_t call) {
+    auto& r = m_regs.GPR.n;
+    auto& mem = g_emulator->m_mem;
+    // The debugger and the memory sanitizer need to see every access, so they get the real thing.
+    if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) return false;
+    if (mem->msanInitialized()) return false;
+
+    const uint32_t ramMask = g_emulator->getRamMask();
+    // Host pointer to a range of main RAM, through kuseg, kseg0 or kseg1, or nullptr if it isn't all in the
+    // same mirror of it. Anything else, such as the scratchpad, is left to the BIOS.
+    const auto ram = [&mem, ramMask](uint32_t address, uint32_t size) -> uint8_t* {
+        const uint32_t segment = address >> 29;
+        if ((segment != 0) && (segment != 4) && (segment != 5)) return nullptr;
+        const uint32_t physical = address & 0x1fffffff;
+        if (physical >= 0x00800000) return nullptr;
+        const uint32_t offset = physical & ramMask;
+        if (size > ramMask + 1 - offset) return nullptr;
+        return mem->m_wram + offset;
+    };
+    // Length of the string at this address, or -1 if it runs out of its mirror of RAM.
+    const auto length = [&ram, ramMask](uint32_t address) -> int32_t {
+        const uint8_t* str = ram(address, 1);
+        if (!str) return -1;
+        const uint32_t available = ramMask + 1 - (address & ramMask);
+        const void* end = memchr(str, 0, available);
+        return end ? int32_t(reinterpret_cast<const uint8_t*>(end) - str) : -1;
+    };
+    const auto written = [this, &mem](uint32_t address, uint32_t size) {
+        mem->markDirtyRange(address, size);
+        Clear(address & ~3, (size + 3) / 4 + 1);
+    };
+
+    // The cycles are the instructions of the retail BIOS loops, plus the A0 dispatch and the return.
+    static constexpr uint32_t c_callOverhead = 12;
+    uint32_t instructions = c_callOverhead;
+    switch (call) {
+        case 0x19: {  // strcpy
+            if ((r.a0 == 0) || (r.a1 == 0)) return false;
+            const int32_t size = length(r.a1);
+            if (size < 0) return false;
+            const uint8_t* src = ram(r.a1, size + 1);
+            uint8_t* dst = ram(r.a0, size + 1);
+            if (!dst || ((dst > src) && (dst <= src + size))) return false;
+            memmove(dst, src, size + 1);
+            written(r.a0, size + 1);
+            r.v0 = r.a0;
+            instructions += (size + 1) * 5;
+            break;
+        }
+        case 0x1b: {  // strlen
+            if (r.a0 == 0) return false;
+            const int32_t size = length(r.a0);
+            if (size < 0) return false;
+            r.v0 = size;
+            instructions += (size + 1) * 4;
+            break;
+        }
+        case 0x27: {  // bcopy
+            const int32_t size = r.a2;
+            if ((r.a0 == 0) || (r.a1 == 0) || (size <= 0)) return false;
+            const uint8_t* src = ram(r.a0, size);
+            uint8_t* dst = ram(r.a1, size);
+            if (!src || !dst || ((dst > src) && (dst < src + size))) return false;
+            memmove(dst, src, size);
+            written(r.a1, size);
+            instructions += size * 6;
+            break;
+        }
+        case 0x28: {  // bzero
+            const int32_t size = r.a1;
+            if ((r.a0 == 0) || (size <= 0)) return false;
+            uint8_t* dst = ram(r.a0, size);
+            if (!dst) return false;
+            memset(dst, 0, size);
+            written(r.a0, size);
+            r.v0 = r.a0;
+            instructions += size * 4;
+            break;
+        }
+        case 0x2a: {  // memcpy
+            const int32_t size = r.a2;
+            if ((r.a0 == 0) || (r.a1 == 0) || (size <= 0)) return false;
+            const uint8_t* src = ram(r.a1, size);
+            uint8_t* dst = ram(r.a0, size);
+            // The BIOS copies forwards one byte at a time, which overlapping ranges can see.
+            if (!src || !dst || ((dst > src) && (dst < src + size))) return false;
+            memmove(dst, src, size);
+            written(r.a0, size);
+            r.v0 = r.a0;
+            instructions += size * 6;
+            break;
+        }
+        case 0x2b: {  // memset
+            const int32_t size = r.a2;
+            if ((r.a0 == 0) || (size <= 0)) return false;
+            uint8_t* dst = ram(r.a0, size);
+            if (!dst) return false;
+            memset(dst, r.a1 & 0xff, size);
+            written(r.a0, size);
+            r.v0 = r.a0;
+            instructions += size * 4;
+            break;
+        }
+        default:
+            return false;
+    }
+    m_regs.cycle += instructions * Emulator::BIAS;
+    m_regs.pc = r.ra;
+    return true;
+}
+
 void PCSX::R3000Acpu::processB0KernelCall(uint32_t call) {
     auto& r = m_regs.GPR.n;
 
@@ -504,27 +727,21 @@ void PCSX::R3000Acpu::processB0KernelCall(uint32_t call) {
     }
 }
 
-std::pair<const uint32_t, std::string>* PCSX::R3000Acpu::findContainingSymbol(uint32_t addr) {
-    auto symBefore = m_symbols.upper_bound(addr);
-    if (symBefore != m_symbols.begin()) {  // verify there is actually a symbol before addr
-        symBefore--;
-        if (symBefore->first != addr) {
-            PCSX::PSXAddress addrInfo(addr);
-            PCSX::PSXAddress symbolInfo(symBefore->first);
-            if (addrInfo.segment != symbolInfo.segment) {
-                // if the symbol is different and not in the same memory region, it'd be wrong
-                return nullptr;
-            }
+std::optional<PCSX::SymbolTable::Symbol> PCSX::R3000Acpu::findContainingSymbol(uint32_t addr) {
+    auto symBefore = m_symbols.findContaining(addr);
+    if (symBefore && (symBefore->address != addr)) {
+        PCSX::PSXAddress addrInfo(addr);
+        PCSX::PSXAddress symbolInfo(symBefore->address);
+        if (addrInfo.segment != symbolInfo.segment) {
+            // if the symbol is different and not in the same memory region, it'd be wrong
+            return std::nullopt;
         }
-        return &*symBefore;
     }
-    return nullptr;
+    return symBefore;
 }
 
-std::string* PCSX::R3000Acpu::getSymbolAt(uint32_t addr) {
-    auto symBefore = m_symbols.find(addr);
-    if (symBefore != m_symbols.end()) {
-        return &symBefore->second;
-    }
-    return nullptr;
+std::optional<std::string_view> PCSX::R3000Acpu::getSymbolAt(uint32_t addr) {
+    auto symbol = m_symbols.find(addr);
+    if (symbol) return symbol->name;
+    return std::nullopt;
 }
@@ -25,16 +25,22 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
+#include "core/blocktrace.h"
+#include "core/idleloop.h"
 #include "core/kernel.h"
 #include "core/psxcounters.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "mips/common/util/mips.hh"
+#include "support/eventqueue.h"
 #include "support/file.h"
 #include "support/hashtable.h"
+#include "supportpsx/symboltable.h"
 
 #if defined(__i386__) || defined(_M_IX86)
 #define DYNAREC_NONE  // Hahano
@@ -177,7 +183,8 @@ enum {
     PSXINT_SPUASYNC,
     PSXINT_CDRDBUF,
     PSXINT_CDRLID,
-    PSXINT_CDRPLAY
+    PSXINT_CDRPLAY,
+    PSXINT_COUNT
 };
 
 struct psxRegisters {
@@ -274,12 +281,25 @@ class R3000Acpu {
     virtual const uint8_t *getBufferPtr() = 0;
     virtual const size_t getBufferSize() = 0;
 
+    // Running totals for the recompilers, for monitoring. The interpreter leaves them at zero.
+    struct JitStats {
+        uint64_t blocksCompiled = 0;
+        uint64_t cacheFlushes = 0;
+        uint64_t cacheEvictions = 0;  // Of code cache regions, for the recompilers which don't flush it all at once
+        uint64_t invalidations = 0;  // Of the RAM code blocks, when the guest flushes its instruction cache
+        uint64_t blocksPromoted = 0;  // Baseline blocks recompiled once hot, for the recompilers which tier
+    };
+    const JitStats &getJitStats() const { return m_jitStats; }
+    // Whether the block starting at "from" jumps straight into the one starting at "to", without going through
+    // the dispatcher. Always false for the CPUs which don't link blocks.
+    virtual bool isBlockLinked(uint32_t from, uint32_t to) { return false; }
+
     const std::string &getName() { return m_name; }
 
-    std::map<uint32_t, std::string> m_symbols;
+    SymbolTable m_symbols;
 
-    std::pair<const uint32_t, std::string> *findContainingSymbol(uint32_t addr);
-    std::string *getSymbolAt(uint32_t addr);
+    std::optional<SymbolTable::Symbol> findContainingSymbol(uint32_t addr);
+    std::optional<std::string_view> getSymbolAt(uint32_t addr);
 
     static int psxInit();
     virtual bool isDynarec() = 0;
@@ -312,17 +332,44 @@ class R3000Acpu {
         uint64_t target = cycle + uint64_t(eCycle * m_interruptScales[interrupt]);
         m_regs.interrupt |= (1 << interrupt);
         m_regs.intTargets[interrupt] = target;
-        if (target < m_regs.lowestTarget) m_regs.lowestTarget = target;
+        m_events.schedule(interrupt, target);
+        m_regs.lowestTarget = m_events.nextDeadline();
+    }
+    void cancelInterrupt(unsigned interrupt) {
+        m_regs.interrupt &= ~(1 << interrupt);
+        m_events.cancel(interrupt);
+        m_regs.lowestTarget = m_events.nextDeadline();
+    }
+    // Rebuilds the event queue out of the pending interrupts and their targets, after loading a save state.
+    void rescheduleInterrupts() {
+        m_events.clear();
+        for (unsigned interrupt = 0; interrupt < PSXINT_COUNT; interrupt++) {
+            if (m_regs.interrupt & (1 << interrupt)) m_events.schedule(interrupt, m_regs.intTargets[interrupt]);
+        }
+        m_regs.lowestTarget = m_events.nextDeadline();
     }
 
     psxRegisters m_regs;
-    float m_interruptScales[15] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+    // How many cycles the idle loop skipping saved from being emulated, and how many times it kicked in.
+    uint64_t m_idleCyclesSkipped = 0;
+    uint64_t m_idleLoopsSkipped = 0;
+    float m_interruptScales[PSXINT_COUNT] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
                                    1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
     bool m_shellStarted = false;
+    // The BIOS calls recorded while the kernel log is enabled.
+    Kernel::CallLog m_kernelCalls;
 
     virtual void Reset() {
         invalidateCache();
+        resetState();
+    }
+    // Everything Reset does but dropping the caches and compiled code, for loading a state which mostly runs
+    // the same code as the current one. The code which differs then has to be dropped with Clear.
+    virtual void resetState() {
         m_regs.interrupt = 0;
+        m_events.clear();
+        m_regs.lowestTarget = m_events.nextDeadline();
+        for (auto &entry : m_branchTestHistory) entry = {};
     }
     bool m_inISR = false;
     bool m_nextIsDelaySlot = false;
@@ -368,6 +415,7 @@ class R3000Acpu {
 
   protected:
     R3000Acpu(const std::string &name) : m_name(name) {}
+    JitStats m_jitStats;
     static inline const uint32_t MASKS[7] = {0, 0xffffff, 0xffff, 0xff, 0xff000000, 0xffff0000, 0xffffff00};
     static inline const uint32_t LWL_MASK[4] = {0xffffff, 0xffff, 0xff, 0};
     static inline const uint32_t LWL_MASK_INDEX[4] = {1, 2, 3, 0};
@@ -391,18 +439,24 @@ class R3000Acpu {
     }
     void processA0KernelCall(uint32_t call);
     void processB0KernelCall(uint32_t call);
+    // Runs the memory and string functions of the A0 table natively, and returns to the caller, charging
+    // the cycles the BIOS loops would have taken. Returns false to let the BIOS handle the call.
+    bool hleA0KernelCall(uint32_t call);
     void logA0KernelCall(uint32_t call);
     void logB0KernelCall(uint32_t call);
     void logC0KernelCall(uint32_t call);
+    void recordKernelCall(uint16_t table, uint32_t call);
 
   public:
-    template <bool checkPC = true>
-    inline void InterceptBIOS(uint32_t currentPC) {
+    // Returns true if the call got run natively, in which case the pc now points back at the caller. Only
+    // callers able to leave the kernel vector at this point, with no load pending, ask for it with hle.
+    template <bool checkPC = true, bool hle = false>
+    inline bool InterceptBIOS(uint32_t currentPC) {
         const uint32_t pc = currentPC & g_emulator->getRamMask();
 
         if constexpr (checkPC) {
             const uint32_t base = (currentPC >> 20) & 0xffc;
-            if ((base != 0x000) && (base != 0x800) && (base != 0xa00)) return;
+            if ((base != 0x000) && (base != 0x800) && (base != 0xa00)) return false;
         }
 
         auto r = m_regs.GPR.n;
@@ -437,6 +491,13 @@ class R3000Acpu {
                     break;
             }
         }
+
+        if constexpr (hle) {
+            if ((pc == 0xa0) && g_emulator->settings.get<Emulator::SettingHLEKernelCalls>()) {
+                return hleA0KernelCall(call);
+            }
+        }
+        return false;
     }
 
     /*
@@ -498,8 +559,13 @@ Formula One 2001
                 *(uint32_t *)(iAddr + pcCache + 0x8) = SWAP_LE32(pcOffset + 0x8);
                 *(uint32_t *)(iAddr + pcCache + 0xc) = SWAP_LE32(pcOffset + 0xc);
 
-                // opcode line
+                // opcode line; when it's plain memory, which it nearly always is, copy it over in one go
                 pcOffset = pc & ~0xf;
+                const auto line = g_emulator->m_mem->getPointer<uint8_t>(pcOffset);
+                if (line) {
+                    memcpy(iCode + pcCache, line, 16);
+                    return SWAP_LE32(*((uint32_t *)(iCode + (pc & 0xfff))));
+                }
                 *(uint32_t *)(iCode + pcCache + 0x0) =
                     g_emulator->m_mem->read32(pcOffset + 0x0, Memory::ReadType::Instr);
                 *(uint32_t *)(iCode + pcCache + 0x4) =
@@ -517,6 +583,27 @@ Formula One 2001
 
   private:
     const std::string m_name;
+    // The pending interrupts, by target cycle. m_regs.interrupt and m_regs.intTargets remain the reference,
+    // as they are what goes in save states, and m_regs.lowestTarget is the earliest target in there.
+    EventQueue<PSXINT_COUNT> m_events;
+
+    bool isIdleLoop(uint32_t pc);
+    // The analysis of the last loops seen, validated against the code they were done on.
+    struct IdleLoopCacheEntry {
+        uint32_t pc = 0;
+        uint32_t code[IdleLoop::MAX_INSTRUCTIONS];
+        IdleLoop::Loop loop;
+    };
+    static constexpr unsigned IDLE_LOOP_CACHE_SIZE = 64;
+    IdleLoopCacheEntry m_idleLoopCache[IDLE_LOOP_CACHE_SIZE];
+    // The PCs of the last two calls to branchTest, and whether each of them ran an event or took an interrupt.
+    struct {
+        uint32_t pc = 0;
+        bool quiet = false;
+    } m_branchTestHistory[2];
+    // Set up from the debug settings on reset, to compare the block boundaries against another run.
+    BlockTrace m_blockTrace;
+    void openBlockTrace();
 
     struct PCdrvFile;
     typedef Intrusive::HashTable<uint32_t, PCdrvFile> PCdrvFiles;
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/rewind.h"
+
+#include "core/psxemulator.h"
+#include "core/system.h"
+
+PCSX::Rewind::Rewind() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::GPU::VSync>([this](auto&) {
+        auto& settings = g_emulator->settings;
+        if (!settings.get<Emulator::SettingRewind>()) {
+            if (!m_groups.empty()) clear();
+            return;
+        }
+        if (++m_frames < unsigned(std::max(settings.get<Emulator::SettingRewindInterval>().value, 1))) return;
+        m_frames = 0;
+        record();
+    });
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](auto&) { clear(); });
+}
+
+void PCSX::Rewind::record() {
+    if (m_groups.empty() || (m_groups.back().deltas.size() >= DELTAS_PER_KEY)) {
+        const SaveStates::Snapshot* base = m_groups.empty() ? nullptr : &m_groups.back().key;
+        m_groups.push_back({SaveStates::Snapshot::take(base), {}});
+        m_bytes += m_groups.back().key.exclusiveBytes();
+    } else {
+        auto& group = m_groups.back();
+        auto delta = SaveStates::Snapshot::take(&group.key).diff(group.key);
+        m_bytes += delta.size();
+        group.deltas.push_back(std::move(delta));
+    }
+
+    const size_t budget = size_t(std::max(g_emulator->settings.get<Emulator::SettingRewindMemory>().value, 1)) << 20;
+    while ((m_bytes > budget) && (m_groups.size() > 1)) {
+        auto& oldest = m_groups.front();
+        m_bytes -= oldest.key.exclusiveBytes();
+        for (auto& delta : oldest.deltas) m_bytes -= delta.size();
+        m_groups.pop_front();
+    }
+}
+
+bool PCSX::Rewind::stepBack() {
+    if (m_groups.empty()) return false;
+    m_frames = 0;
+    auto& group = m_groups.back();
+    if (!group.deltas.empty()) {
+        const bool ret = group.key.rebuild(group.deltas.back()).restore();
+        m_bytes -= group.deltas.back().size();
+        group.deltas.pop_back();
+        return ret;
+    }
+    const bool ret = group.key.restore();
+    m_bytes -= group.key.exclusiveBytes();
+    m_groups.pop_back();
+    return ret;
+}
+
+void PCSX::Rewind::clear() {
+    m_groups.clear();
+    m_bytes = 0;
+    m_frames = 0;
+}
+
+size_t PCSX::Rewind::count() const {
+    size_t ret = 0;
+    for (auto& group : m_groups) ret += group.deltas.size() + 1;
+    return ret;
+}
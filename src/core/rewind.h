@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+
+#include <deque>
+#include <vector>
+
+#include "core/sstate.h"
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Keeps the recent past of the emulation, to step back through it. Every few frames, a snapshot of the
+// state goes in a ring bounded by a memory budget, the oldest ones being dropped first. The snapshots come
+// in groups: the first one of a group is a key, sharing its unchanged pages with the previous key, and the
+// others are only kept as their XOR delta against it.
+class Rewind {
+  public:
+    static constexpr unsigned DELTAS_PER_KEY = 15;
+
+    Rewind();
+
+    // Goes back to the most recent snapshot, and drops it, so that the next call goes further back.
+    bool stepBack();
+    void clear();
+
+    size_t count() const;
+    size_t bytes() const { return m_bytes; }
+
+  private:
+    void record();
+
+    struct Group {
+        SaveStates::Snapshot key;
+        std::vector<SaveStates::Snapshot::Delta> deltas;
+    };
+    std::deque<Group> m_groups;
+    // The pages are counted once, by whichever key allocated them, and discounted once no key holds them.
+    size_t m_bytes = 0;
+    unsigned m_frames = 0;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/runahead.h"
+
+#include <algorithm>
+
+#include "core/movie.h"
+#include "core/netplay.h"
+#include "core/psxemulator.h"
+#include "core/spu.h"
+#include "core/system.h"
+
+PCSX::RunAhead::RunAhead() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](auto&) { cancel(); });
+}
+
+unsigned PCSX::RunAhead::framesAhead() const {
+    // Netplay and movies need every frame to be a real one, played with the input it's recorded with.
+    if (g_emulator->m_netplay->active() || g_emulator->m_movie->recording() || g_emulator->m_movie->replaying()) {
+        return 0;
+    }
+    return std::clamp(g_emulator->settings.get<Emulator::SettingRunAheadFrames>().value, 0, MAX_FRAMES);
+}
+
+bool PCSX::RunAhead::presenting() const {
+    // A real frame is never shown while running ahead, since the ones run past it supersede it. Should the
+    // setting get lowered while running ahead, the current run stops at the next frame.
+    if (m_ahead == 0) return framesAhead() == 0;
+    return m_ahead >= framesAhead();
+}
+
+void PCSX::RunAhead::vsync() {
+    const unsigned frames = framesAhead();
+    if (m_ahead == 0) {
+        if (frames == 0) {
+            if (!m_snapshot.empty()) m_snapshot = {};
+            return;
+        }
+        // Consecutive snapshots share their unchanged pages, which spares copying most of them.
+        m_snapshot = SaveStates::Snapshot::take(m_snapshot.empty() ? nullptr : &m_snapshot);
+        g_emulator->m_spu->holdOutput(true);
+        m_ahead = 1;
+        return;
+    }
+    if (m_ahead < frames) {
+        m_ahead++;
+        return;
+    }
+
+    // The frame furthest ahead got presented, so back to the real timeline. The audio stays held while
+    // restoring, as loading the state replays the pending XA audio.
+    m_ahead = 0;
+    m_snapshot.restore(true);
+    g_emulator->m_spu->holdOutput(false);
+}
+
+void PCSX::RunAhead::cancel() {
+    if (m_ahead != 0) g_emulator->m_spu->holdOutput(false);
+    m_ahead = 0;
+    m_snapshot = {};
+}
@@ -0,0 +1,56 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include "core/sstate.h"
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Hides some of the frames games take between reading the pads and showing the result. Once a frame is done,
+// the state gets snapshotted, and the emulation keeps going for a few more frames with the same input. Only the
+// last of those gets presented, after which the emulation goes back to the snapshot, and runs the next frame
+// for real. What's on screen is thus what the input would only have shown a few frames later.
+// The frames run ahead are silent, and don't signal the VSync event, so that the rest of the emulator only ever
+// sees the real timeline.
+class RunAhead {
+  public:
+    static constexpr int MAX_FRAMES = 4;
+
+    RunAhead();
+
+    // Whether the frame which just ended got run ahead of the real timeline.
+    bool runningAhead() const { return m_ahead != 0; }
+    // Whether the frame which just ended is the one to present.
+    bool presenting() const;
+    // Called at the end of every frame, after the real ones signaled their VSync event.
+    void vsync();
+
+  private:
+    unsigned framesAhead() const;
+    void cancel();
+
+    SaveStates::Snapshot m_snapshot;
+    // How many frames have been run past the snapshot, counting the one in progress.
+    unsigned m_ahead = 0;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
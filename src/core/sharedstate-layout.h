@@ -0,0 +1,98 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+/*
+ * Layout of the memory the emulator exports for external tools, when the
+ * "Export state to shared memory" option is enabled. This header is plain C,
+ * and doesn't depend on the rest of the emulator, so that tools can use it
+ * as-is.
+ *
+ * There are three named shared memory regions, all of them read-only for the
+ * tools, and named after the process ID of the emulator:
+ *   - "pcsx-redux-state-<pid>": one struct pcsx_shared_state,
+ *   - "pcsx-redux-vram-<pid>": the 1024x512 16 bits VRAM, 1MB,
+ *   - "pcsx-redux-spuram-<pid>": the SPU RAM, 512KB.
+ * The main RAM is already always shared as "pcsx-redux-wram-<pid>", and is
+ * updated live, without any synchronisation. On POSIX systems, these are
+ * opened with shm_open, and on Windows with OpenFileMapping.
+ *
+ * The emulator refreshes the state, VRAM and SPU RAM regions once per frame,
+ * under the sequence counter of the state block. The counter is odd while an
+ * update is in progress. A consistent snapshot of any of the three regions
+ * is taken this way:
+ *
+ *   do {
+ *       do seq = atomic_load_acquire(&state->sequence); while (seq & 1);
+ *       ... copy what's needed out of the regions ...
+ *       atomic_thread_fence_acquire();
+ *   } while (atomic_load_relaxed(&state->sequence) != seq);
+ *
+ * The layout only ever grows at the end. Tools should check the magic, and
+ * that the version is at least the one they know about.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define PCSX_SHARED_STATE_MAGIC 0x54535350 /* "PSST" */
+#define PCSX_SHARED_STATE_VERSION 1
+
+#define PCSX_SHARED_VRAM_SIZE (1024 * 512 * 2)
+#define PCSX_SHARED_SPURAM_SIZE (512 * 1024)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct pcsx_shared_state {
+    uint32_t magic;
+    uint32_t version;
+    /* The size of the whole struct, as written by the emulator. */
+    uint32_t size;
+    uint32_t sequence;
+    /* Number of frames emulated since the emulator started. */
+    uint64_t frame;
+    /* CPU cycles since the last reset. */
+    uint64_t cycle;
+    uint32_t pc;
+    uint32_t reserved;
+    /* r0 to r31, then lo and hi. */
+    uint32_t gpr[34];
+    uint32_t cp0[32];
+    /* The GTE data registers, then its control registers. */
+    uint32_t cp2d[32];
+    uint32_t cp2c[32];
+    /* The 1KB of scratchpad, at 0x1f800000. */
+    uint8_t scratchpad[1024];
+    /* The hardware registers from 0x1f801000 to 0x1f802fff, as last written by the CPU. */
+    uint8_t hwregs[8192];
+};
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/sharedstate.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "core/framestats.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/r3000a.h"
+#include "core/sharedstate-layout.h"
+#include "core/spu.h"
+#include "core/system.h"
+
+PCSX::SharedState::~SharedState() { close(); }
+
+void PCSX::SharedState::vsync() {
+    if (!g_emulator->settings.get<Emulator::SettingSharedStateExport>()) {
+        if (m_state) close();
+        return;
+    }
+    if (!m_state) open();
+    if (m_state) update();
+}
+
+void PCSX::SharedState::open() {
+    auto state = std::make_unique<SharedMem>();
+    auto vram = std::make_unique<SharedMem>();
+    auto spuRAM = std::make_unique<SharedMem>();
+    if (!state->init("state", sizeof(pcsx_shared_state), true) || !vram->init("vram", PCSX_SHARED_VRAM_SIZE, true) ||
+        !spuRAM->init("spuram", PCSX_SHARED_SPURAM_SIZE, true)) {
+        // Nobody would be able to see the regions, so there's no point updating them. Giving up for good
+        // spares trying again every frame.
+        g_system->message("%s", _("Failed to create the shared memory regions to export the state to\n"));
+        g_emulator->settings.get<Emulator::SettingSharedStateExport>().value = false;
+        return;
+    }
+    auto header = reinterpret_cast<pcsx_shared_state *>(state->getPtr());
+    header->magic = PCSX_SHARED_STATE_MAGIC;
+    header->version = PCSX_SHARED_STATE_VERSION;
+    header->size = sizeof(pcsx_shared_state);
+    m_state = std::move(state);
+    m_vram = std::move(vram);
+    m_spuRAM = std::move(spuRAM);
+    // The tracker starts out fully dirty, which gets the whole of VRAM copied on the first update.
+    m_trackedGPU = g_emulator->m_gpu.get();
+    m_trackedGPU->addVRAMTracker(&m_vramDirty);
+}
+
+void PCSX::SharedState::close() {
+    if (m_trackedGPU) m_trackedGPU->removeVRAMTracker(&m_vramDirty);
+    m_trackedGPU = nullptr;
+    m_state.reset();
+    m_vram.reset();
+    m_spuRAM.reset();
+}
+
+void PCSX::SharedState::update() {
+    auto header = reinterpret_cast<pcsx_shared_state *>(m_state->getPtr());
+    // Readers retry for as long as the sequence is odd, or changed while they were copying.
+    std::atomic_ref<uint32_t> sequence(header->sequence);
+    const uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (!m_vramDirty.empty()) {
+        const Slice vram = g_emulator->m_gpu->getVRAM();
+        const auto src = vram.data<uint8_t>();
+        const auto dst = m_vram->getPtr();
+        m_vramDirty.forEachRect([src, dst](int x, int y, int w, int h) {
+            for (int line = y; line < y + h; line++) {
+                const size_t offset = (line * 1024 + x) * sizeof(uint16_t);
+                memcpy(dst + offset, src + offset, w * sizeof(uint16_t));
+            }
+        });
+        m_vramDirty.clear();
+    }
+    memcpy(m_spuRAM->getPtr(), g_emulator->m_spu->getRAM(), PCSX_SHARED_SPURAM_SIZE);
+
+    const auto &regs = g_emulator->m_cpu->m_regs;
+    header->frame = g_emulator->m_frameStats->frames();
+    header->cycle = regs.cycle;
+    header->pc = regs.pc;
+    memcpy(header->gpr, regs.GPR.r, sizeof(header->gpr));
+    memcpy(header->cp0, regs.CP0.r, sizeof(header->cp0));
+    memcpy(header->cp2d, regs.CP2D.r, sizeof(header->cp2d));
+    memcpy(header->cp2c, regs.CP2C.r, sizeof(header->cp2c));
+    memcpy(header->scratchpad, g_emulator->m_mem->m_hard, sizeof(header->scratchpad));
+    memcpy(header->hwregs, g_emulator->m_mem->m_hard + 0x1000, sizeof(header->hwregs));
+
+    sequence.store(seq + 2, std::memory_order_release);
+}
@@ -0,0 +1,53 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <memory>
+
+#include "core/gpu.h"
+#include "support/sharedmem.h"
+
+namespace PCSX {
+
+// Exports VRAM, the SPU RAM and the CPU registers to named shared memory, once per frame, so that external
+// tools can follow the emulation without going through the web server or Lua. The layout, and the way to read
+// it consistently, is described in core/sharedstate-layout.h.
+class SharedState {
+  public:
+    ~SharedState();
+    // Called at the end of every real frame. Creates the regions on the first frame the export is enabled, and
+    // drops them once it's disabled.
+    void vsync();
+    bool active() const { return m_state != nullptr; }
+
+  private:
+    void open();
+    void close();
+    void update();
+
+    std::unique_ptr<SharedMem> m_state;
+    std::unique_ptr<SharedMem> m_vram;
+    std::unique_ptr<SharedMem> m_spuRAM;
+    // Only the parts of VRAM which changed since the last frame get copied over.
+    GPU::VRAMDirtyTiles m_vramDirty;
+    GPU *m_trackedGPU = nullptr;
+};
+
+}  // namespace PCSX
@@ -25,6 +25,7 @@
 #include <bitset>
 #include <stdexcept>
 
+#include "core/cdrom.h"
 #include "core/memorycard.h"
 #include "core/pad.h"
 #include "support/sjis_conv.h"
@@ -38,11 +39,34 @@
 void PCSX::SIO::acknowledge() {
     if (m_regs.control & ControlFlags::TX_ENABLE) {
         if (m_regs.control & ControlFlags::ACK_IRQEN) {
-            scheduleInterrupt(SIO_CYCLES);
+            scheduleInterrupt(transferDelay());
         }
     }
 }
 
+// Memory card transfers go a byte at a time, each one waiting on its interrupt, so reading a whole card takes
+// seconds. With fast access, the delay gets divided, but never goes below what the BIOS interrupt handler needs
+// between sending a byte and acknowledging the interrupt, or the next one would get lost.
+uint32_t PCSX::SIO::transferDelay() const {
+    static constexpr uint32_t c_minimumDelay = 128;
+    const uint32_t cycles = SIO_CYCLES;
+    if ((m_mcdSpeedup <= 1) || (m_currentDevice != DeviceType::MemoryCard)) return cycles;
+    return std::max(cycles / m_mcdSpeedup, std::min(cycles, c_minimumDelay));
+}
+
+// Like the CD-ROM fast timings, the speedup is only picked up on reset, and is then saved with the state, so that
+// a savestate or a replay taken with fast access is played back with the same timings.
+void PCSX::SIO::latchSpeedup() {
+    auto &settings = g_emulator->settings;
+    m_mcdSpeedup = 1;
+    if (!settings.get<Emulator::SettingMcdFastAccess>()) return;
+    auto &exclusions = settings.get<Emulator::SettingMcdFastAccessExclusions>().value;
+    const auto &id = g_emulator->m_cdrom->getCDRomID();
+    if (!id.empty() && (std::find(exclusions.begin(), exclusions.end(), id) != exclusions.end())) return;
+    m_mcdSpeedup = std::clamp(settings.get<Emulator::SettingMcdFastAccessFactor>().value, 1, 64);
+    if (m_mcdSpeedup != 1) g_system->printf(_("Memory card fast access: x%u\n"), m_mcdSpeedup);
+}
+
 void PCSX::SIO::init() {
     reset();
     togglePocketstationMode();
@@ -244,7 +268,7 @@ void PCSX::SIO::transmitData() {
     g_emulator->m_mem->writeHardwareRegister<0x1040, uint8_t>(m_rxBuffer);
 
     if (isReceiveIRQReady() && !(m_regs.status & StatusFlags::IRQ)) {
-        scheduleInterrupt(SIO_CYCLES);
+        scheduleInterrupt(transferDelay());
     }
     m_regs.status |= StatusFlags::TX_DATACLEAR | StatusFlags::TX_FINISHED;
     g_emulator->m_mem->writeHardwareRegister<0x1044>(m_regs.status);
@@ -307,7 +331,7 @@ void PCSX::SIO::writeCtrl16(uint16_t value) {
         m_bufferIndex = 0;
         m_regs.status = StatusFlags::TX_DATACLEAR | StatusFlags::TX_FINISHED;
         g_emulator->m_mem->writeHardwareRegister<0x1044>(m_regs.status);
-        PCSX::g_emulator->m_cpu->m_regs.interrupt &= ~(1 << PCSX::PSXINT_SIO);
+        PCSX::g_emulator->m_cpu->cancelInterrupt(PCSX::PSXINT_SIO);
         m_currentDevice = DeviceType::None;
     }
 
@@ -95,6 +95,7 @@ class SIO {
     void init();
     void interrupt();
     void reset();
+    void latchSpeedup();
 
     bool copyMcdFile(McdBlock block);
     void eraseMcdFile(const McdBlock &block);
@@ -227,7 +228,7 @@ class SIO {
     };
 
     friend MemoryCard;
-    friend SaveStates::SaveState SaveStates::constructSaveState();
+    friend SaveStates::SaveState SaveStates::constructSaveState(bool);
 
     static constexpr size_t c_padBufferSize = 0x1010;
 
@@ -250,6 +251,9 @@ class SIO {
     };
 
     uint8_t m_currentDevice = DeviceType::None;
+    // Fast memory card access, see latchSpeedup.
+    uint32_t m_mcdSpeedup = 1;
+    uint32_t transferDelay() const;
 
     // Pads
     uint8_t m_buffer[c_padBufferSize];
@@ -51,8 +51,20 @@ std::string PCSX::SIO1::encodeMessage(SIOPayload message) {
 void PCSX::SIO1::sendDataMessage() {
     if (fifoError()) return;
 
-    std::string txByte(1, m_regs.data);
-    SIOPayload payload = makeDataMessage(std::move(txByte));
+    // Bytes are bundled until the next poll, so that a burst turns into a single packet on the wire.
+    m_txBundle.push_back(m_regs.data);
+    if (m_txBundle.size() >= c_maxBundleSize) flushDataMessage();
+}
+
+void PCSX::SIO1::flushDataMessage() {
+    if (m_txBundle.empty()) return;
+    if (fifoError()) {
+        m_txBundle.clear();
+        return;
+    }
+
+    SIOPayload payload = makeDataMessage(std::move(m_txBundle));
+    m_txBundle = std::string();
     std::string message = encodeMessage(payload);
     transmitMessage(std::move(message));
 }
@@ -66,6 +78,8 @@ void PCSX::SIO1::sendFlowControlMessage() {
     }
     m_prevFlowControl = m_flowControl;
 
+    // The pending bytes were sent under the previous flow control state, and have to reach the other side first.
+    flushDataMessage();
     SIOPayload payload = makeFlowControlMessage();
     std::string message = encodeMessage(payload);
     transmitMessage(std::move(message));
@@ -281,7 +295,7 @@ void PCSX::SIO1::writeCtrl16(uint16_t v) {
             m_sio1fifo.asA<Fifo>()->reset();
         }
 
-        PCSX::g_emulator->m_cpu->m_regs.interrupt &= ~(1 << PCSX::PSXINT_SIO1);
+        PCSX::g_emulator->m_cpu->cancelInterrupt(PCSX::PSXINT_SIO1);
     }
 
     if (!(m_regs.control & CR_RXEN)) {
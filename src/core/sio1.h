@@ -75,6 +75,7 @@ class SIO1 {
     void poll() {
         if (fifoError()) return;
         if (m_sio1Mode == SIO1Mode::Protobuf) {
+            flushDataMessage();
             sio1StateMachine();
         } else {
             if (m_sio1fifo->size() >= 1) {
@@ -93,13 +94,15 @@ class SIO1 {
         m_decodeState = READ_SIZE;
         messageSize = 0;
         initialMessage = true;
-        g_emulator->m_cpu->m_regs.interrupt &= ~(1 << PCSX::PSXINT_SIO1);
+        m_txBundle.clear();
+        g_emulator->m_cpu->cancelInterrupt(PCSX::PSXINT_SIO1);
     }
 
     void stopSIO1Connection() {
         m_decodeState = READ_SIZE;
         messageSize = 0;
         initialMessage = true;
+        m_txBundle.clear();
         if (m_sio1fifo.isA<Fifo>()) {
             m_sio1fifo.asA<Fifo>()->reset();
         } else if (m_sio1fifo) {
@@ -165,14 +168,18 @@ class SIO1 {
     SIO1Registers m_regs;
 
   private:
+    // The messages are prefixed with a single byte for their size, so the bundles have to stay below that.
+    static constexpr size_t c_maxBundleSize = 192;
     uint8_t messageSize = 0;
     uint64_t m_cycleCount = 2352;  // Default to cycles for 115200 baud
     uint64_t m_baudRate = 115200;  // Default to 115200 baud
     bool initialMessage = true;
+    std::string m_txBundle;
     SIOPayload makeDataMessage(std::string &&data);
     SIOPayload makeFlowControlMessage();
     std::string encodeMessage(SIOPayload message);
     void sendDataMessage();
+    void flushDataMessage();
     void sendFlowControlMessage();
     void transmitMessage(std::string &&message);
     void decodeMessage();
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "core/decode_xa.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
@@ -59,13 +61,22 @@ class SPUInterface {
     virtual uint32_t getCurrentFrames() = 0;
     virtual void waitForGoal(uint32_t goal) = 0;
     virtual uint32_t getFrameCount() = 0;
+    virtual uint64_t getUnderruns() = 0;
     virtual void setLua(Lua L) = 0;
+    // Holds the audio output while the emulation runs frames which aren't meant to be heard, such as the ones
+    // run ahead of the input. The mixer stops, the XA and CD-DA audio gets dropped, and the emulation isn't
+    // throttled to the audio anymore.
+    virtual void holdOutput(bool hold) = 0;
+    // The 512KB of sound RAM.
+    virtual const uint8_t *getRAM() = 0;
+    bool outputHeld() const { return m_outputHeld.load(std::memory_order_relaxed); }
 
     bool m_showDebug = false;
     bool m_showCfg = false;
 
   protected:
     void scheduleInterrupt();
+    std::atomic<bool> m_outputHeld = false;
 };
 
 }  // namespace PCSX
@@ -19,6 +19,12 @@
 
 #include "core/sstate.h"
 
+#include <string.h>
+
+#include <functional>
+#include <random>
+#include <system_error>
+
 #include "core/callstacks.h"
 #include "core/cdrom.h"
 #include "core/gpu.h"
@@ -28,9 +34,14 @@
 #include "core/psxmem.h"
 #include "core/r3000a.h"
 #include "core/sio.h"
+#include "fmt/format.h"
 #include "spu/interface.h"
+#include "support/file.h"
+#include "support/xordelta.h"
+#include "support/zfile.h"
 
-PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState() {
+PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState(bool withMemory) {
+    auto& mem = g_emulator->m_mem;
     // clang-format off
     return SaveState {
         SaveStateInfo {
@@ -39,10 +50,11 @@ PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState() {
         },
         Thumbnail {},
         Memory {
-            RAM { g_emulator->m_mem->m_wram },
-            ROM { g_emulator->m_mem->m_bios },
-            EXP1 { g_emulator->m_mem->m_exp1 },
-            HardwareMemory { g_emulator->m_mem->m_hard },
+            RAM { withMemory ? mem->m_wram : nullptr },
+            ROM { withMemory ? mem->m_bios : nullptr },
+            EXP1 { withMemory ? mem->m_exp1 : nullptr },
+            HardwareMemory { withMemory ? mem->m_hard : nullptr },
+            EXP1Pages { withMemory ? mem->m_exp1 : nullptr },
         },
         Registers {
             GPR { g_emulator->m_cpu->m_regs.GPR.r },
@@ -106,6 +118,7 @@ PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState() {
             SIOMCD2CurrentCommand{g_emulator->m_sio->m_memoryCard[1].m_currentCommand},
             SIOMCD2Sector{g_emulator->m_sio->m_memoryCard[1].m_sector},
             SIOMCD2DataOffset{g_emulator->m_sio->m_memoryCard[1].m_dataOffset},
+            SIOMcdSpeedup{g_emulator->m_sio->m_mcdSpeedup},
         },
         CDRom {
             CDReg1Mode { g_emulator->m_cdrom->m_reg1Mode },
@@ -161,6 +174,9 @@ PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState() {
             CDSubQAbsolute { g_emulator->m_cdrom->m_subq.absolute },
             CDTrackChanged { g_emulator->m_cdrom->m_trackChanged },
             CDLocationChanged { g_emulator->m_cdrom->m_locationChanged },
+            CDSeekSpeedup { g_emulator->m_cdrom->m_seekSpeedup },
+            CDReadSpeedup { g_emulator->m_cdrom->m_readSpeedup },
+            CDSpinSpeedup { g_emulator->m_cdrom->m_spinSpeedup },
         },
         Hardware {},
         Counters {},
@@ -171,6 +187,65 @@ PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState() {
     // clang-format on
 }
 
+static bool isFilledWith(const uint8_t* page, uint8_t value) {
+    return (page[0] == value) && (memcmp(page, page + 1, PCSX::SaveStates::EXP1Pages::PAGE_SIZE - 1) == 0);
+}
+
+// Only reading EXP1 here, so the pages which were never written to don't get committed.
+void PCSX::SaveStates::EXP1Pages::serialize(Protobuf::OutSlice* slice) const {
+    std::vector<uint32_t> entries;
+    size_t size = 0;
+    for (uint32_t i = 0; i < SIZE / PAGE_SIZE; i++) {
+        const uint8_t* page = m_dest + i * PAGE_SIZE;
+        if (isFilledWith(page, 0)) continue;
+        if (isFilledWith(page, 0xff)) {
+            entries.push_back(i | FILLED);
+            size += 4;
+        } else {
+            entries.push_back(i);
+            size += 4 + PAGE_SIZE;
+        }
+    }
+    slice->putVarInt(size);
+    for (auto entry : entries) {
+        slice->putU32(entry);
+        if (entry & FILLED) continue;
+        slice->putBytes(m_dest + entry * PAGE_SIZE, PAGE_SIZE);
+    }
+}
+
+void PCSX::SaveStates::EXP1Pages::deserialize(Protobuf::InSlice* slice, unsigned) {
+    const uint64_t size = slice->getVarInt();
+    if (size > SIZE + SIZE / PAGE_SIZE * 4) throw Protobuf::OutOfBoundError();
+    m_pages = slice->getBytes(size);
+    m_present = true;
+}
+
+void PCSX::SaveStates::EXP1Pages::commit() {
+    if (!m_present || !m_dest) return;
+    std::vector<uint8_t> seen(SIZE / PAGE_SIZE);
+    Protobuf::InSlice slice(reinterpret_cast<const uint8_t*>(m_pages.data()), m_pages.size());
+    while (slice.bytesLeft() >= 4) {
+        const uint32_t entry = slice.getU32();
+        const uint32_t index = entry & ~FILLED;
+        if (index >= seen.size()) break;
+        uint8_t* page = m_dest + index * PAGE_SIZE;
+        seen[index] = 1;
+        if (entry & FILLED) {
+            memset(page, 0xff, PAGE_SIZE);
+        } else if (slice.bytesLeft() >= PAGE_SIZE) {
+            slice.getBytes(page, PAGE_SIZE);
+        } else {
+            break;
+        }
+    }
+    // Clearing only what isn't clear yet, which leaves the pages never touched uncommitted.
+    for (size_t i = 0; i < seen.size(); i++) {
+        uint8_t* page = m_dest + i * PAGE_SIZE;
+        if (!seen[i] && !isFilledWith(page, 0)) memset(page, 0, PAGE_SIZE);
+    }
+}
+
 namespace PCSX {
 struct SaveStateWrapper {
     SaveStateWrapper(SaveStates::SaveState& state_) : state(state_) {}
@@ -178,8 +253,10 @@ struct SaveStateWrapper {
 };
 }  // namespace PCSX
 
-std::string PCSX::SaveStates::save() {
-    SaveState state = constructSaveState();
+// Everything but the memory areas, which constructSaveState() already points at.
+static void fillState(PCSX::SaveStates::SaveState& state) {
+    using namespace PCSX;
+    using namespace PCSX::SaveStates;
     SaveStateWrapper wrapper(state);
 
     state.get<SaveStateInfoField>().get<VersionString>().value = "PCSX-Redux SaveState v4";
@@ -196,27 +273,43 @@ std::string PCSX::SaveStates::save() {
     });
 
     g_emulator->m_callStacks->serialize(&wrapper);
+}
+
+std::string PCSX::SaveStates::save() {
+    SaveState state = constructSaveState();
+    fillState(state);
 
     Protobuf::OutSlice slice;
     state.serialize(&slice);
     return slice.finalize();
 }
 
+bool PCSX::SaveStates::save(File* file) {
+    SaveState state = constructSaveState();
+    fillState(state);
+
+    Protobuf::OutSlice slice(file);
+    state.serialize(&slice);
+    slice.flush();
+    return !slice.failed();
+}
+
 void PCSX::CallStacks::serialize(SaveStateWrapper* w) {
     using namespace SaveStates;
     auto& callstacks = w->state.get<SaveStates::CallStacksField>().get<CallStacksMessageField>().value;
-    for (auto& callstack : getCallstacks()) {
+    forEachCallstack([&](const CallStack& callstack) {
         SaveStates::CallStack sscallstack{};
         sscallstack.get<LowSP>().value = callstack.getLow();
         sscallstack.get<HighSP>().value = callstack.getHigh();
         sscallstack.get<PresumedRA>().value = callstack.ra;
         sscallstack.get<PresumedFP>().value = callstack.fp;
         sscallstack.get<CallstackIsCurrent>().value = &callstack == m_current;
-        for (auto& call : callstack.calls) {
+        for (unsigned i = 0; i < callstack.calls.size(); i++) {
+            auto& call = callstack.calls[i];
             sscallstack.get<Calls>().value.emplace_back(call.ra, call.sp, call.fp, call.shadow);
         }
         callstacks.emplace_back(sscallstack);
-    }
+    });
     w->state.get<SaveStates::CallStacksField>().get<CallStacksCurrentSP>().value = m_currentSP;
 }
 
@@ -241,6 +334,7 @@ void PCSX::GPU::serialize(SaveStateWrapper* w) {
 }
 
 void PCSX::MDEC::serialize(SaveStateWrapper* w) {
+    sync();
     using namespace SaveStates;
     uint8_t* base = (uint8_t*)&PCSX::g_emulator->m_mem->m_wram[0x100000];
     auto& mdecSave = w->state.get<MDECField>();
@@ -278,24 +372,34 @@ void PCSX::Counters::serialize(SaveStateWrapper* w) {
     counters.get<PSXNextCounter>().value = m_psxNextCounter;
 }
 
-bool PCSX::SaveStates::load(std::string_view data) {
-    SaveState state = constructSaveState();
-
-    Protobuf::InSlice slice(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+static bool decodeState(PCSX::SaveStates::SaveState& state, std::string_view data) {
+    using namespace PCSX::SaveStates;
+    PCSX::Protobuf::InSlice slice(reinterpret_cast<const uint8_t*>(data.data()), data.size());
     try {
         state.deserialize(&slice, 0);
     } catch (...) {
         return false;
     }
 
-    if (state.get<SaveStateInfoField>().get<Version>().value != 4) {
-        return false;
-    }
+    return state.get<SaveStateInfoField>().get<Version>().value == 4;
+}
 
+// The memory hook writes whatever the state doesn't carry itself, right where the state gets committed.
+// Keeping the code leaves it to the hook to clear whatever code it changed.
+static void applyState(PCSX::SaveStates::SaveState& state, const std::function<void()>& restoreMemory = {},
+                       bool keepCode = false) {
+    using namespace PCSX;
+    using namespace PCSX::SaveStates;
     SaveStateWrapper wrapper(state);
-    PCSX::g_emulator->m_cpu->Reset();
+    if (keepCode) {
+        PCSX::g_emulator->m_cpu->resetState();
+    } else {
+        PCSX::g_emulator->m_cpu->Reset();
+    }
     state.commit();
-    g_emulator->m_cpu->m_regs.lowestTarget = g_emulator->m_cpu->m_regs.cycle;
+    if (restoreMemory) restoreMemory();
+    g_emulator->m_mem->markAllDirty();
+    g_emulator->m_cpu->rescheduleInterrupts();
     g_emulator->m_cpu->m_regs.previousCycles = g_emulator->m_cpu->m_regs.cycle;
     // x86-64 recompiler might make save states with an unaligned PC, since it ignores the bottom 2 bits
     // So we just force-align it here, since it's never meant to be misaligned
@@ -335,17 +439,166 @@ bool PCSX::SaveStates::load(std::string_view data) {
     }
     g_emulator->m_callStacks->deserialize(&wrapper);
 
-    g_system->m_eventBus->signal(Events::ExecutionFlow::SaveStateLoaded{});
+    if (!keepCode) g_system->m_eventBus->signal(Events::ExecutionFlow::SaveStateLoaded{});
+}
 
+bool PCSX::SaveStates::load(std::string_view data) {
+    SaveState state = constructSaveState();
+    if (!decodeState(state, data)) return false;
+    applyState(state);
+    return true;
+}
+
+bool PCSX::SaveStates::load(IO<File> file) {
+    if (file->failed()) return false;
+    // Gzip streams start with 1f 8b, which a protobuf message can't: it'd be field 3 with wire type 7.
+    uint8_t magic[2] = {0, 0};
+    if (file->seekable()) file->readAt(magic, sizeof(magic), 0);
+    if ((magic[0] != 0x1f) || (magic[1] != 0x8b)) {
+        auto data = file->readAt(64 * 1024 * 1024, 0);
+        return load(data.asStringView());
+    }
+
+    // The whole file is needed anyway, so it gets inflated in one go rather than streamed.
+    auto compressed = file->readAt(64 * 1024 * 1024, 0);
+    std::string data;
+    if (!ZReader::uncompress(compressed.asStringView(), data)) return false;
+    return load(data);
+}
+
+bool PCSX::SaveStates::FileWriter::save(const std::filesystem::path& filename, Codec codec) {
+    wait();
+    // The state goes to a temporary file first, moved in place once complete, so that other processes sharing
+    // the file, such as other instances using the same boot cache, never get to see it half written.
+    auto temporary = filename;
+    temporary += fmt::format(".{:08x}.tmp", std::random_device{}());
+    IO<File> file(new PosixFile(temporary, FileOps::TRUNCATE));
+    if (file->failed()) return false;
+    // Only serializing the state has to happen on the emulation thread, the rest is file work.
+    m_thread = std::thread([file, codec, filename, temporary, state = SaveStates::save()]() mutable {
+        if (codec == Codec::None) {
+            file->writeString(state);
+        } else {
+            file->write(ZWriter::compress(state, codec == Codec::GZipFast ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION));
+        }
+        const bool failed = file->failed();
+        file->close();
+        std::error_code ec;
+        if (!failed) std::filesystem::rename(temporary, filename, ec);
+        if (failed || ec) std::filesystem::remove(temporary, ec);
+    });
+    return true;
+}
+
+// Pages full of zeroes, such as most of EXP1 and whatever memory the game doesn't use, all share this one.
+const std::shared_ptr<const PCSX::SaveStates::Snapshot::Page>& PCSX::SaveStates::Snapshot::Area::blankPage() {
+    static const std::shared_ptr<const Page> blank(new Page{});
+    return blank;
+}
+
+void PCSX::SaveStates::Snapshot::Area::capture(const uint8_t* src, size_t size, const Area* base) {
+    const size_t count = size / PAGE_SIZE;
+    m_pages.resize(count);
+    for (size_t i = 0; i < count; i++, src += PAGE_SIZE) {
+        if (base && (i < base->m_pages.size()) && (memcmp(base->m_pages[i]->data(), src, PAGE_SIZE) == 0)) {
+            m_pages[i] = base->m_pages[i];
+            continue;
+        }
+        if ((src[0] == 0) && (memcmp(src, src + 1, PAGE_SIZE - 1) == 0)) {
+            m_pages[i] = blankPage();
+            continue;
+        }
+        auto page = std::shared_ptr<Page>(new Page);
+        memcpy(page->data(), src, PAGE_SIZE);
+        m_pages[i] = std::move(page);
+    }
+}
+
+// Blank pages are only written if needed, so that restoring doesn't commit the memory never touched.
+void PCSX::SaveStates::Snapshot::Area::copyTo(uint8_t* dst) const {
+    for (auto& page : m_pages) {
+        if ((page != blankPage()) || (memcmp(dst, page->data(), PAGE_SIZE) != 0)) {
+            memcpy(dst, page->data(), PAGE_SIZE);
+        }
+        dst += PAGE_SIZE;
+    }
+}
+
+void PCSX::SaveStates::Snapshot::Area::copyChangedTo(uint8_t* dst, std::vector<size_t>& changed) const {
+    for (size_t i = 0; i < m_pages.size(); i++, dst += PAGE_SIZE) {
+        if (memcmp(dst, m_pages[i]->data(), PAGE_SIZE) == 0) continue;
+        memcpy(dst, m_pages[i]->data(), PAGE_SIZE);
+        changed.push_back(i);
+    }
+}
+
+PCSX::SaveStates::Snapshot PCSX::SaveStates::Snapshot::take(const Snapshot* base) {
+    Snapshot snapshot;
+    auto from = [base](Area Snapshot::*area) { return base ? &(base->*area) : nullptr; };
+
+    SaveState state = constructSaveState(false);
+    fillState(state);
+    // VRAM and SPU RAM go through the state like the rest of their subsystems, and get taken out of it here.
+    auto& vram = state.get<GPUField>().get<GPUVRam>();
+    snapshot.m_vram.capture(vram.value, 0x00100000, from(&Snapshot::m_vram));
+    vram.release();
+    auto& spuRam = state.get<SPUField>().get<SPURam>();
+    snapshot.m_spuRam.capture(spuRam.value, 0x80000, from(&Snapshot::m_spuRam));
+    spuRam.release();
+
+    auto& mem = g_emulator->m_mem;
+    snapshot.m_ram.capture(mem->m_wram, 0x00800000, from(&Snapshot::m_ram));
+    snapshot.m_rom.capture(mem->m_bios, 0x00080000, from(&Snapshot::m_rom));
+    snapshot.m_exp1.capture(mem->m_exp1, 0x00800000, from(&Snapshot::m_exp1));
+    snapshot.m_hardware.capture(mem->m_hard, 0x00010000, from(&Snapshot::m_hardware));
+
+    Protobuf::OutSlice slice;
+    state.serialize(&slice);
+    snapshot.m_state = slice.finalize();
+    return snapshot;
+}
+
+bool PCSX::SaveStates::Snapshot::restore(bool keepCode) const {
+    SaveState state = constructSaveState(false);
+    if (!decodeState(state, m_state)) return false;
+
+    auto& vram = state.get<GPUField>().get<GPUVRam>();
+    vram.allocate();
+    m_vram.copyTo(vram.value);
+    auto& spuRam = state.get<SPUField>().get<SPURam>();
+    spuRam.allocate();
+    m_spuRam.copyTo(spuRam.value);
+
+    applyState(
+        state,
+        [this, keepCode]() {
+            auto& mem = g_emulator->m_mem;
+            if (keepCode) {
+                std::vector<size_t> ram, rom;
+                m_ram.copyChangedTo(mem->m_wram, ram);
+                m_rom.copyChangedTo(mem->m_bios, rom);
+                auto& cpu = g_emulator->m_cpu;
+                const size_t ramSize = size_t(g_emulator->getRamMask()) + 1;
+                for (auto page : ram) {
+                    if (page * PAGE_SIZE < ramSize) cpu->Clear(0x80000000 + uint32_t(page * PAGE_SIZE), PAGE_SIZE / 4);
+                }
+                for (auto page : rom) cpu->Clear(0xbfc00000 + uint32_t(page * PAGE_SIZE), PAGE_SIZE / 4);
+            } else {
+                m_ram.copyTo(mem->m_wram);
+                m_rom.copyTo(mem->m_bios);
+            }
+            m_exp1.copyTo(mem->m_exp1);
+            m_hardware.copyTo(mem->m_hard);
+        },
+        keepCode);
     return true;
 }
 
 void PCSX::CallStacks::deserialize(const SaveStateWrapper* w) {
     using namespace SaveStates;
-    m_callstacks.destroyAll();
+    clear();
 
     auto& callstacks = w->state.get<CallStacksField>().get<CallStacksMessageField>().value;
-    m_current = nullptr;
 
     for (auto& sscallstack : callstacks) {
         auto& calls = sscallstack.get<Calls>().value;
@@ -354,7 +607,7 @@ void PCSX::CallStacks::deserialize(const SaveStateWrapper* w) {
         uint32_t ra = sscallstack.get<PresumedRA>().value;
         uint32_t fp = sscallstack.get<PresumedFP>().value;
         bool isCurrent = sscallstack.get<CallstackIsCurrent>().value;
-        CallStack* callstack = new CallStack();
+        CallStack* callstack = allocate(lowSP, highSP);
         callstack->ra = ra;
         callstack->fp = fp;
         for (auto& call : calls) {
@@ -362,10 +615,9 @@ void PCSX::CallStacks::deserialize(const SaveStateWrapper* w) {
             uint32_t sp = call.get<CallSP>().value;
             uint32_t fp = call.get<CallFP>().value;
             bool shadow = call.get<Shadow>().value;
-            callstack->calls.push_back(new CallStack::Call(sp, fp, ra, shadow));
+            callstack->calls.push({sp, fp, ra, shadow});
         }
         if (isCurrent) m_current = callstack;
-        m_callstacks.insert(lowSP, highSP, callstack);
     }
 
     m_currentSP = w->state.get<SaveStates::CallStacksField>().get<CallStacksCurrentSP>().value;
@@ -375,14 +627,13 @@ static uint32_t getU32(const uint8_t* ptr) { return ptr[0] | (ptr[1] << 8) | (pt
 
 void PCSX::GPU::deserialize(const SaveStateWrapper* w) {
     using namespace SaveStates;
+    // Whatever an earlier load left pending is superseded anyway.
+    m_pendingVRAM.reset();
     reset();
     auto& gpu = w->state.get<GPUField>();
     restoreStatus(gpu.get<GPUStatus>().value);
-    if (gpu.get<GPUVRam>().value) {
-        partialUpdateVRAM(0, 0, 1024, 512, reinterpret_cast<const uint16_t*>(gpu.get<GPUVRam>().value));
-    } else {
-        clearVRAM();
-    }
+    auto& vram = gpu.get<GPUVRam>();
+    if (!vram.value) clearVRAM();
     const auto control = gpu.get<GPUControl>().value;
 
     for (unsigned i = 0; i < 256; i++) {
@@ -398,9 +649,16 @@ void PCSX::GPU::deserialize(const SaveStateWrapper* w) {
     writeStatus(m_statusControl[7]);
     writeStatus(m_statusControl[5]);
     writeStatus(m_statusControl[4]);
+
+    // Last, since the control writes sync. The buffer is taken over from the message, for commitVRAM().
+    if (vram.value) {
+        m_pendingVRAM.reset(vram.value);
+        vram.value = nullptr;
+    }
 }
 
 void PCSX::MDEC::deserialize(const SaveStateWrapper* w) {
+    sync();
     using namespace SaveStates;
     uint8_t* base = (uint8_t*)&g_emulator->m_mem->m_wram[0x100000];
     auto& mdecSave = w->state.get<MDECField>();
@@ -449,4 +707,89 @@ void PCSX::Counters::deserialize(const SaveStateWrapper* w) {
                                             m_HSyncTotal[g_emulator->settings.get<Emulator::SettingVideo>()]));
 
     m_audioFrames = g_emulator->m_spu->getCurrentFrames();
+    set();
+}
+
+// Each page which differs is its index and the length of its delta, as varints, then the delta itself.
+void PCSX::SaveStates::Snapshot::Area::diff(const Area& key, std::string& out) const {
+    std::string delta;
+    for (size_t i = 0; i < m_pages.size(); i++) {
+        if (m_pages[i] == key.m_pages[i]) continue;
+        delta.clear();
+        XorDelta::encode(key.m_pages[i]->data(), m_pages[i]->data(), PAGE_SIZE, delta);
+        if (delta.empty()) continue;
+        XorDelta::putVarInt(out, i);
+        XorDelta::putVarInt(out, delta.size());
+        out += delta;
+    }
+}
+
+bool PCSX::SaveStates::Snapshot::Area::patch(const Area& key, std::string_view delta) {
+    m_pages = key.m_pages;
+    while (!delta.empty()) {
+        uint64_t index, size;
+        if (!XorDelta::getVarInt(delta, index) || !XorDelta::getVarInt(delta, size)) return false;
+        if ((index >= m_pages.size()) || (size > delta.size())) return false;
+        auto page = std::shared_ptr<Page>(new Page(*m_pages[index]));
+        if (!XorDelta::apply(delta.substr(0, size), page->data(), PAGE_SIZE)) return false;
+        m_pages[index] = std::move(page);
+        delta.remove_prefix(size);
+    }
+    return true;
+}
+
+size_t PCSX::SaveStates::Snapshot::Area::exclusiveBytes() const {
+    size_t ret = 0;
+    for (auto& page : m_pages) {
+        if (page.use_count() == 1) ret += PAGE_SIZE;
+    }
+    return ret;
+}
+
+size_t PCSX::SaveStates::Snapshot::Delta::size() const {
+    return m_state.size() + m_ram.size() + m_rom.size() + m_exp1.size() + m_hardware.size() + m_vram.size() +
+           m_spuRam.size();
+}
+
+PCSX::SaveStates::Snapshot::Delta PCSX::SaveStates::Snapshot::diff(const Snapshot& key) const {
+    Delta delta;
+    // The rest of the state is mostly fixed size fields, so it usually lines up with the key's.
+    if (m_state.size() == key.m_state.size()) {
+        XorDelta::encode(reinterpret_cast<const uint8_t*>(key.m_state.data()),
+                         reinterpret_cast<const uint8_t*>(m_state.data()), m_state.size(), delta.m_state);
+        delta.m_stateIsDelta = true;
+    } else {
+        delta.m_state = m_state;
+    }
+    m_ram.diff(key.m_ram, delta.m_ram);
+    m_rom.diff(key.m_rom, delta.m_rom);
+    m_exp1.diff(key.m_exp1, delta.m_exp1);
+    m_hardware.diff(key.m_hardware, delta.m_hardware);
+    m_vram.diff(key.m_vram, delta.m_vram);
+    m_spuRam.diff(key.m_spuRam, delta.m_spuRam);
+    return delta;
+}
+
+PCSX::SaveStates::Snapshot PCSX::SaveStates::Snapshot::rebuild(const Delta& delta) const {
+    Snapshot snapshot;
+    if (delta.m_stateIsDelta) {
+        snapshot.m_state = m_state;
+        if (!XorDelta::apply(delta.m_state, reinterpret_cast<uint8_t*>(snapshot.m_state.data()),
+                             snapshot.m_state.size())) {
+            return {};
+        }
+    } else {
+        snapshot.m_state = delta.m_state;
+    }
+    if (!snapshot.m_ram.patch(m_ram, delta.m_ram) || !snapshot.m_rom.patch(m_rom, delta.m_rom) ||
+        !snapshot.m_exp1.patch(m_exp1, delta.m_exp1) || !snapshot.m_hardware.patch(m_hardware, delta.m_hardware) ||
+        !snapshot.m_vram.patch(m_vram, delta.m_vram) || !snapshot.m_spuRam.patch(m_spuRam, delta.m_spuRam)) {
+        return {};
+    }
+    return snapshot;
+}
+
+size_t PCSX::SaveStates::Snapshot::exclusiveBytes() const {
+    return m_state.size() + m_ram.exclusiveBytes() + m_rom.exclusiveBytes() + m_exp1.exclusiveBytes() +
+           m_hardware.exclusiveBytes() + m_vram.exclusiveBytes() + m_spuRam.exclusiveBytes();
 }
@@ -19,7 +19,15 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 #include "spu/types.h"
 #include "support/protobuf.h"
@@ -44,9 +52,43 @@ typedef Protobuf::MessageField<Thumbnail, TYPESTRING("thumbnail"), 2> ThumbnailF
 
 typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00800000>, TYPESTRING("ram"), 1> RAM;
 typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00080000>, TYPESTRING("rom"), 2> ROM;
-typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00800000>, TYPESTRING("exp1"), 3> EXP1;
+// Older save states hold all of EXP1 there. It's still loaded from them, but no longer written.
+struct EXP1 : public Protobuf::FieldPtr<Protobuf::FixedBytes<0x00800000>, TYPESTRING("exp1"), 3> {
+    using FieldPtr::FieldPtr;
+    constexpr bool hasData() const { return false; }
+};
 typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00010000>, TYPESTRING("hardware"), 4> HardwareMemory;
-typedef Protobuf::Message<TYPESTRING("Memory"), RAM, ROM, EXP1, HardwareMemory> Memory;
+// Nearly all of the 8MB of EXP1 is left untouched, so it's saved as the pages which aren't blank instead. Each
+// is a little endian 32 bits word holding its index, followed by its contents. Pages missing are all zeroes,
+// as unused memory is, and pages all at 0xff, the way an empty cartridge reads, only have the top bit of
+// their index set.
+class EXP1Pages {
+  public:
+    static constexpr size_t PAGE_SIZE = 0x1000;
+    static constexpr size_t SIZE = 0x00800000;
+    static constexpr uint32_t FILLED = 0x80000000;
+
+    EXP1Pages(uint8_t* dest) : m_dest(dest) {}
+    static constexpr uint64_t fieldNumber = 5;
+    static constexpr unsigned wireType = 2;
+    static constexpr bool matches(unsigned wireType) { return wireType == 2; }
+    static void dumpSchema(std::ostream& stream) { stream << "    bytes exp1_pages = 5;" << std::endl; }
+    static constexpr bool needsToSerializeHeader() { return false; }
+    void serialize(Protobuf::OutSlice* slice) const;
+    void deserialize(Protobuf::InSlice* slice, unsigned wireType);
+    void reset() {
+        m_pages.clear();
+        m_present = false;
+    }
+    void commit();
+    bool hasData() const { return m_dest; }
+
+  private:
+    uint8_t* m_dest;
+    std::string m_pages;
+    bool m_present = false;
+};
+typedef Protobuf::Message<TYPESTRING("Memory"), RAM, ROM, EXP1, HardwareMemory, EXP1Pages> Memory;
 typedef Protobuf::MessageField<Memory, TYPESTRING("memory"), 3> MemoryField;
 
 typedef Protobuf::RepeatedFieldRef<Protobuf::UInt32, 34, TYPESTRING("gpr"), 1> GPR;
@@ -167,13 +209,14 @@ typedef Protobuf::FieldRef<Protobuf::UInt16, TYPESTRING("mcd2_commandticks"), 28
 typedef Protobuf::FieldRef<Protobuf::UInt8, TYPESTRING("mcd2_currentcommand"), 29> SIOMCD2CurrentCommand;
 typedef Protobuf::FieldRef<Protobuf::UInt16, TYPESTRING("mcd2_sector"), 30> SIOMCD2Sector;
 typedef Protobuf::FieldRef<Protobuf::UInt32, TYPESTRING("mcd2_dataoffset"), 31> SIOMCD2DataOffset;
+typedef Protobuf::FieldRef<Protobuf::UInt32, TYPESTRING("mcd_speedup"), 32> SIOMcdSpeedup;
 
 typedef Protobuf::Message<TYPESTRING("SIO"), SIOBuffer, SIOStatusReg, SIOModeReg, SIOCtrlReg, SIOBaudReg,
                           SIOBufferMaxIndex, SIOBufferIndex, SIOPadState, SIOCurrentDevice, SIOMCD1TempBuffer,
                           SIOMCD1DirectoryFlag, SIOMCD1ChecksumIn, SIOMCD1ChecksumOut, SIOMCD1CommandTicks,
                           SIOMCD1CurrentCommand, SIOMCD1Sector, SIOMCD1DataOffset, SIOMCD2TempBuffer,
                           SIOMCD2DirectoryFlag, SIOMCD2ChecksumIn, SIOMCD2ChecksumOut, SIOMCD2CommandTicks,
-                          SIOMCD2CurrentCommand, SIOMCD2Sector, SIOMCD2DataOffset>
+                          SIOMCD2CurrentCommand, SIOMCD2Sector, SIOMCD2DataOffset, SIOMcdSpeedup>
     SIO;
 typedef Protobuf::MessageField<SIO, TYPESTRING("sio"), 7> SIOField;
 
@@ -234,6 +277,9 @@ typedef Protobuf::FieldPtr<Protobuf::FixedBytes<3>, TYPESTRING("subq_relative"),
 typedef Protobuf::FieldPtr<Protobuf::FixedBytes<3>, TYPESTRING("subq_absolute"), 55> CDSubQAbsolute;
 typedef Protobuf::FieldRef<Protobuf::Bool, TYPESTRING("track_changed"), 56> CDTrackChanged;
 typedef Protobuf::FieldRef<Protobuf::Bool, TYPESTRING("location_changed"), 57> CDLocationChanged;
+typedef Protobuf::FieldRef<Protobuf::UInt32, TYPESTRING("seek_speedup"), 58> CDSeekSpeedup;
+typedef Protobuf::FieldRef<Protobuf::UInt32, TYPESTRING("read_speedup"), 59> CDReadSpeedup;
+typedef Protobuf::FieldRef<Protobuf::UInt32, TYPESTRING("spin_speedup"), 60> CDSpinSpeedup;
 
 typedef Protobuf::Message<
     TYPESTRING("CDRom"), CDReg1Mode, CDReg2, CDCmdProcess, CDCtrl, CDStat, CDStatP, CDTransfer, CDTransferIndex, CDPrev,
@@ -242,7 +288,8 @@ typedef Protobuf::Message<
     CDSuceeded, CDFirstSector, CDIRQ, CDIrqRepeated, CDECycle, CDSeeked, CDReadRescheduled, CDDriveState, CDFastForward,
     CDFastBackward, CDAttenuatorLeftToLeft, CDAttenuatorLeftToRight, CDAttenuatorRightToRight, CDAttenuatorRightToLeft,
     CDAttenuatorLeftToLeftT, CDAttenuatorLeftToRightT, CDAttenuatorRightToRightT, CDAttenuatorRightToLeftT, CDSubQTrack,
-    CDSubQIndex, CDSubQRelative, CDSubQAbsolute, CDTrackChanged, CDLocationChanged>
+    CDSubQIndex, CDSubQRelative, CDSubQAbsolute, CDTrackChanged, CDLocationChanged, CDSeekSpeedup, CDReadSpeedup,
+    CDSpinSpeedup>
     CDRom;
 typedef Protobuf::MessageField<CDRom, TYPESTRING("cdrom"), 8> CDRomField;
 
@@ -319,10 +366,98 @@ typedef Protobuf::ProtoFile<SaveStateInfo, Thumbnail, Memory, DelaySlotInfo, Reg
                             CDRom, Hardware, Rcnt, Counters, MDEC, PCdrvFile, Call, CallStack, CallStacks, SaveState>
     ProtoFile;
 
-SaveState constructSaveState();
+// Without the memory, the RAM, ROM, EXP1 and hardware areas are left out of the message.
+SaveState constructSaveState(bool withMemory = true);
 
 std::string save();
+// Streams the save state into the file as it gets serialized, without ever holding all of it in memory.
+bool save(File* file);
 bool load(std::string_view data);
+// Loads a save state file, be it compressed or not.
+bool load(IO<File> file);
+
+// How save state files get written. Loading them works out by itself which one it was.
+enum class Codec { GZip, GZipFast, None };
+
+// Writes save state files from a background thread, so that compressing them doesn't stall the emulation.
+// The state itself is captured when calling save(), and the files are written one at a time, in order.
+class FileWriter {
+  public:
+    ~FileWriter() { wait(); }
+    bool save(const std::filesystem::path& filename, Codec codec);
+    // Blocks until the pending file is written, for instance before reading it back.
+    void wait() {
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+  private:
+    std::thread m_thread;
+};
+
+// An in-memory save state, for branching many futures off the same point, the way automated tests or
+// searches do. Unlike save() and load(), the large memory areas, including VRAM and SPU RAM, don't go
+// through the protobuf encoding. They're kept as pages instead, and a snapshot taken against a base one
+// shares the pages which haven't changed since, so a tree of snapshots only costs what differs between them.
+class Snapshot {
+  public:
+    static constexpr size_t PAGE_SIZE = 0x10000;
+
+    // A snapshot stored as its XOR difference from a key snapshot, from which only it can be rebuilt.
+    class Delta {
+      public:
+        size_t size() const;
+
+      private:
+        friend class Snapshot;
+        std::string m_state;
+        bool m_stateIsDelta = false;
+        std::string m_ram;
+        std::string m_rom;
+        std::string m_exp1;
+        std::string m_hardware;
+        std::string m_vram;
+        std::string m_spuRam;
+    };
+
+    static Snapshot take(const Snapshot* base = nullptr);
+    // Keeping the code leaves what the CPU compiled or cached alone, except for the pages of RAM and ROM this
+    // changes, which makes going back and forth between close states cheap. The SaveStateLoaded event is only
+    // signaled without it, as the state restored is then assumed to be one the emulation already went through.
+    bool restore(bool keepCode = false) const;
+    bool empty() const { return m_state.empty(); }
+
+    // Only the pages which aren't shared with the key get encoded, so the snapshot should be taken against it.
+    Delta diff(const Snapshot& key) const;
+    // This is the key. Gives an empty snapshot if the delta doesn't fit it.
+    Snapshot rebuild(const Delta& delta) const;
+    // What would be freed along with this snapshot, counting only the pages no other snapshot shares.
+    size_t exclusiveBytes() const;
+
+  private:
+    typedef std::array<uint8_t, PAGE_SIZE> Page;
+    class Area {
+      public:
+        void capture(const uint8_t* src, size_t size, const Area* base);
+        void copyTo(uint8_t* dst) const;
+        // Only copies the pages which differ from what's already there, and lists their indices.
+        void copyChangedTo(uint8_t* dst, std::vector<size_t>& changed) const;
+        void diff(const Area& key, std::string& out) const;
+        bool patch(const Area& key, std::string_view delta);
+        size_t exclusiveBytes() const;
+
+      private:
+        static const std::shared_ptr<const Page>& blankPage();
+        std::vector<std::shared_ptr<const Page>> m_pages;
+    };
+
+    std::string m_state;
+    Area m_ram;
+    Area m_rom;
+    Area m_exp1;
+    Area m_hardware;
+    Area m_vram;
+    Area m_spuRam;
+};
 }  // namespace SaveStates
 
 }  // namespace PCSX
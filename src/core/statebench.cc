@@ -0,0 +1,71 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/statebench.h"
+
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "core/sstate.h"
+#include "core/system.h"
+#include "json.hpp"
+#include "support/file.h"
+
+PCSX::StateBenchmark::StateBenchmark() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::GPU::VSync>([this](auto&) {
+        if (m_done || (m_frames == 0)) return;
+        auto& stats = g_emulator->m_frameStats;
+        if (m_warmingUp) {
+            m_warmingUp = false;
+            m_start = clock::now();
+            m_startTotals = stats->totals();
+            return;
+        }
+        if (--m_framesLeft != 0) return;
+        m_end = clock::now();
+        m_endTotals = stats->totals();
+        m_done = true;
+        g_system->quit(0);
+    });
+}
+
+bool PCSX::StateBenchmark::start(const std::filesystem::path& state, unsigned frames) {
+    if (frames == 0) return false;
+    IO<File> file(new PosixFile(state));
+    if (!SaveStates::load(file)) return false;
+    m_state = state;
+    m_frames = m_framesLeft = frames;
+    g_system->resume();
+    return true;
+}
+
+std::string PCSX::StateBenchmark::report() const {
+    nlohmann::json json;
+    json["state"] = m_state.string();
+    json["frames"] = m_frames;
+    json["core"] = g_emulator->m_cpu->isDynarec() ? "dynarec" : "interpreter";
+    const double wall = std::chrono::duration<double>(m_end - m_start).count();
+    json["wall_time"] = wall;
+    json["emulated_fps"] = wall > 0 ? m_frames / wall : 0.0;
+    json["cycles"] = m_endTotals.cycles - m_startTotals.cycles;
+    for (unsigned i = 0; i < FrameStats::COUNT; i++) {
+        json["subsystems"][FrameStats::c_keys[i]] =
+            (m_endTotals.nanoseconds[i] - m_startTotals.nanoseconds[i]) / 1000000000.0;
+    }
+    return json.dump(4);
+}
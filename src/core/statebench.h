@@ -0,0 +1,59 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "core/framestats.h"
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Runs a fixed number of frames from a save state, as fast as possible, and reports where the host time went,
+// split the way FrameStats accounts for it. The first frame after loading the state is a warm-up, so that the
+// time spent starting up and loading doesn't get charged to it. Exits once the frames are done.
+class StateBenchmark {
+  public:
+    StateBenchmark();
+    bool start(const std::filesystem::path& state, unsigned frames);
+    bool done() const { return m_done; }
+    // JSON, with wall time and emulated frame rate, and the seconds spent in each subsystem.
+    std::string report() const;
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    std::filesystem::path m_state;
+    unsigned m_frames = 0;
+    unsigned m_framesLeft = 0;
+    bool m_warmingUp = true;
+    bool m_done = false;
+    clock::time_point m_start;
+    clock::time_point m_end;
+    FrameStats::Frame m_startTotals;
+    FrameStats::Frame m_endTotals;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
@@ -26,7 +26,7 @@
 
 #include "support/file.h"
 
-PCSX::System* PCSX::g_system = NULL;
+thread_local PCSX::System* PCSX::g_system = NULL;
 
 static const ImWchar c_frenchRanges[] = {0x0020, 0x00ff, 0x0152, 0x0153, 0};
 static const ImWchar c_greekRanges[] = {0x0020, 0x00ff, 0x0370, 0x03ff, 0};
@@ -270,6 +270,42 @@ bool PCSX::System::loadLocale(const std::string& name, const std::filesystem::pa
     return true;
 }
 
+void PCSX::System::activateLocale(const std::string& name) {
+    // The deferred log lines may have their format strings in the current locale.
+    flushLogs();
+    if (name == "English") {
+        m_currentLocale = "English";
+        m_i18n = {};
+        return;
+    }
+    auto locale = m_locales.find(name);
+    if (locale == m_locales.end()) {
+        auto localeInfo = LOCALES.find(name);
+        if (localeInfo == LOCALES.end()) return;
+        bool loaded = findResource(
+            [&name, this](const std::filesystem::path& filename) { return loadLocale(name, filename); },
+            localeInfo->second.filename, "i18n", "i18n");
+        if (!loaded) return;
+        locale = m_locales.find(name);
+    }
+    m_i18n = locale->second;
+    m_currentLocale = name;
+}
+
+const std::vector<std::string>& PCSX::System::localesNames() {
+    if (!m_availableLocales.empty()) return m_availableLocales;
+    for (auto& l : LOCALES) {
+        bool found = findResource(
+            [](const std::filesystem::path& filename) {
+                std::error_code ec;
+                return std::filesystem::is_regular_file(filename, ec);
+            },
+            l.second.filename, "i18n", "i18n");
+        if (found) m_availableLocales.push_back(l.first);
+    }
+    return m_availableLocales;
+}
+
 bool PCSX::System::findResource(std::function<bool(const std::filesystem::path& path)> walker,
                                 const std::filesystem::path& name, const std::filesystem::path& releasePath,
                                 const std::filesystem::path& sourcePath) {
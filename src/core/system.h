@@ -22,6 +22,7 @@
 #include <stdarg.h>
 #include <uv.h>
 
+#include <atomic>
 #include <chrono>
 #include <filesystem>
 #include <limits>
@@ -35,6 +36,7 @@
 #include "imgui.h"
 #include "support/djbhash.h"
 #include "support/eventbus.h"
+#include "support/logring.h"
 #include "support/version.h"
 
 namespace PCSX {
@@ -118,6 +120,7 @@ struct Keyboard {
 };
 namespace Memory {
 struct SetLuts {};
+struct WatchpointsChanged {};
 }  // namespace Memory
 }  // namespace Events
 
@@ -141,13 +144,40 @@ class System {
         printf(std::move(s));
     }
     virtual void printf(std::string &&) = 0;
-    // Add a log line
+    // Add a log line. When the arguments allow it, only they get recorded here, and the formatting is deferred
+    // until the logs get flushed, which is at the next update, or before any other output.
     template <typename... Args>
     void log(LogClass logClass, const char *format, const Args &...args) {
+        if (!logEnabled(logClass)) return;
+        if constexpr (LogRing<>::c_deferrable<Args...>) {
+            if (m_logRing.push(static_cast<unsigned>(logClass), format, args...)) return;
+        }
         std::string s = fmt::sprintf(format, args...);
         log(logClass, std::move(s));
     }
-    virtual void log(LogClass, std::string &&) = 0;
+    void log(LogClass logClass, std::string &&s) {
+        flushLogs();
+        writeLog(logClass, std::move(s));
+    }
+    // Formats and outputs the deferred log lines.
+    void flushLogs() {
+        unsigned logClass;
+        std::string s;
+        while (m_logRing.pop(logClass, s)) writeLog(static_cast<LogClass>(logClass), std::move(s));
+    }
+    // The classes which would get dropped on output anyway, such as the ones turned off in the GUI, can be
+    // filtered out before any of the formatting work.
+    bool logEnabled(LogClass logClass) const {
+        return (m_disabledLogs.load(std::memory_order_relaxed) & (uint64_t(1) << static_cast<unsigned>(logClass))) == 0;
+    }
+    void setLogEnabled(LogClass logClass, bool enabled) {
+        const uint64_t mask = uint64_t(1) << static_cast<unsigned>(logClass);
+        if (enabled) {
+            m_disabledLogs.fetch_and(~mask, std::memory_order_relaxed);
+        } else {
+            m_disabledLogs.fetch_or(mask, std::memory_order_relaxed);
+        }
+    }
     // Display a popup message to the user
     template <typename... Args>
     void message(const char *format, const Args &...args) {
@@ -198,25 +228,15 @@ class System {
 
     bool findResource(std::function<bool(const std::filesystem::path &path)> walker, const std::filesystem::path &name,
                       const std::filesystem::path &releasePath, const std::filesystem::path &sourcePath);
-    void loadAllLocales() {
-        for (auto &l : LOCALES) {
-            findResource([name = l.first, this](std::filesystem::path filename) { return loadLocale(name, filename); },
-                         l.second.filename, "i18n", "i18n");
-        }
+    // Translations get parsed when first activated, as parsing all of them noticeably slows down startup.
+    // Reloading drops the parsed ones, so that the next activation picks up any change on disk.
+    void reloadLocales() {
+        m_locales.clear();
+        m_availableLocales.clear();
     }
 
     bool loadLocale(const std::string &name, const std::filesystem::path &path);
-    void activateLocale(const std::string &name) {
-        if (name == "English") {
-            m_currentLocale = "English";
-            m_i18n = {};
-            return;
-        }
-        auto locale = m_locales.find(name);
-        if (locale == m_locales.end()) return;
-        m_i18n = locale->second;
-        m_currentLocale = name;
-    }
+    void activateLocale(const std::string &name);
     std::string localeName() const { return m_currentLocale; }
     const ImWchar *getLocaleRanges() const {
         auto localeInfo = LOCALES.find(m_currentLocale);
@@ -228,17 +248,13 @@ class System {
         if (localeInfo == LOCALES.end()) return {};
         return localeInfo->second.extraFonts;
     }
-    std::vector<std::string> localesNames() {
-        std::vector<std::string> locales;
-        for (auto &l : m_locales) {
-            locales.push_back(l.first);
-        }
-        return locales;
-    }
+    const std::vector<std::string> &localesNames();
 
     std::filesystem::path getBinDir() const { return m_binDir; }
     std::filesystem::path getPersistentDir() const;
     const VersionInfo &getVersion() const { return m_version; }
+    // Roughly when the process started, for the startup time diagnostics.
+    std::chrono::steady_clock::time_point getStartTime() const { return m_startTime; }
 
     // needs to be odd, and is a replica of ImGui's range tables
     enum class Range {
@@ -257,7 +273,10 @@ class System {
     uv_loop_t m_loop;
     std::map<uint64_t, std::string> m_i18n;
     std::map<std::string, decltype(m_i18n)> m_locales;
+    // The locales which have a translation file installed, found on first use.
+    std::vector<std::string> m_availableLocales;
     std::string m_currentLocale;
+    const std::chrono::steady_clock::time_point m_startTime = std::chrono::steady_clock::now();
     // If true, indicates that the emulator is currently capturing the main loop
     // and actively emulates the PSX hardware. If false, the emulator is paused,
     // waiting for user input or other events inside the UI. The way the UI
@@ -277,14 +296,18 @@ class System {
         const ImWchar *ranges = nullptr;
     };
     static const std::map<std::string, LocaleInfo> LOCALES;
+    LogRing<> m_logRing;
+    std::atomic<uint64_t> m_disabledLogs = 0;
 
   protected:
+    // Outputs a formatted log line, after the deferred ones.
+    virtual void writeLog(LogClass, std::string &&) = 0;
     std::filesystem::path m_binDir;
     PCSX::VersionInfo m_version;
     bool m_emergencyExit = false;
 };
 
-extern System *g_system;
+extern thread_local System *g_system;
 
 }  // namespace PCSX
 
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/tracewriter.h"
+
+#include "support/file.h"
+#include "support/zfile.h"
+
+bool PCSX::TraceWriter::open(const std::filesystem::path& filename, bool registers) {
+    close();
+    IO<File> file(new PosixFile(filename, FileOps::TRUNCATE));
+    if (file->failed()) return false;
+
+    m_encoder = {};
+    m_buffer.clear();
+    m_buffer.reserve(c_bufferSize + 1024);
+    ExecTrace::Encoder::header(m_buffer);
+    m_registers = registers;
+    m_needSnapshot = true;
+    m_closing = false;
+
+    m_thread = std::thread([this, file]() mutable {
+        // Tracing is about the emulation keeping up, so favour speed over size.
+        file = new ZWriter(file, ZWriter::GZIP, Z_BEST_SPEED);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wakeWriter.wait(lock, [this]() { return m_closing || !m_pending.empty(); });
+            if (m_pending.empty()) break;
+            std::string buffer = std::move(m_pending.front());
+            m_pending.pop_front();
+            m_wakeEmulation.notify_one();
+            lock.unlock();
+            file->writeString(buffer);
+            lock.lock();
+        }
+        file->close();
+    });
+    return true;
+}
+
+void PCSX::TraceWriter::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wakeEmulation.wait(lock, [this]() { return m_pending.size() < c_maxPending; });
+    m_pending.push_back(std::move(m_buffer));
+    m_wakeWriter.notify_one();
+    lock.unlock();
+    m_buffer = std::string();
+    m_buffer.reserve(c_bufferSize + 1024);
+}
+
+void PCSX::TraceWriter::close() {
+    if (!isOpen()) return;
+    if (!m_buffer.empty()) flush();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_wakeWriter.notify_one();
+    m_thread.join();
+    m_buffer.clear();
+}
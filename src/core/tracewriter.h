@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "supportpsx/exectrace.h"
+
+namespace PCSX {
+
+// Writes a binary execution trace, as described in supportpsx/exectrace.h, to a gzip file. The records
+// get appended to a buffer on the emulation thread, and the full buffers get compressed and written out
+// by a background thread. The emulation only waits on it if it falls too far behind.
+class TraceWriter {
+  public:
+    ~TraceWriter() { close(); }
+    bool open(const std::filesystem::path& filename, bool registers);
+    void close();
+    bool isOpen() const { return m_thread.joinable(); }
+
+    // To be called around each instruction, with the registers as they are at that point. Registers changed
+    // in between two instructions, by an exception or a save state for instance, get recorded as a snapshot.
+    void before(uint32_t pc, const uint32_t* regs) {
+        if (!m_registers) return;
+        if (!m_needSnapshot && (memcmp(m_last, regs, sizeof(m_last)) == 0)) return;
+        m_needSnapshot = false;
+        m_encoder.snapshot(m_buffer, pc, regs);
+        memcpy(m_last, regs, sizeof(m_last));
+    }
+    void after(uint32_t pc, uint32_t code, const uint32_t* regs) {
+        if (m_registers) {
+            m_encoder.instruction(m_buffer, pc, code, m_last, regs);
+            memcpy(m_last, regs, sizeof(m_last));
+        } else {
+            m_encoder.instruction(m_buffer, pc, code);
+        }
+        if (m_buffer.size() >= c_bufferSize) flush();
+    }
+    // To be called in between blocks instead, for a trace of the block boundaries only.
+    void checkpoint(uint32_t pc, uint64_t cycle, const uint32_t* regs) {
+        if (m_needSnapshot) {
+            m_needSnapshot = false;
+            m_encoder.snapshot(m_buffer, pc, regs);
+            memcpy(m_last, regs, sizeof(m_last));
+        }
+        m_encoder.checkpoint(m_buffer, pc, cycle, m_last, regs);
+        memcpy(m_last, regs, sizeof(m_last));
+        if (m_buffer.size() >= c_bufferSize) flush();
+    }
+
+  private:
+    static constexpr size_t c_bufferSize = 4 * 1024 * 1024;
+    static constexpr size_t c_maxPending = 16;
+
+    void flush();
+
+    ExecTrace::Encoder m_encoder;
+    std::string m_buffer;
+    bool m_registers = false;
+    bool m_needSnapshot = false;
+    uint32_t m_last[ExecTrace::REGISTERS];
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeWriter;
+    std::condition_variable m_wakeEmulation;
+    std::deque<std::string> m_pending;
+    bool m_closing = false;
+};
+
+}  // namespace PCSX
@@ -21,6 +21,7 @@
 
 #include <fstream>
 
+#include "core/bootcache.h"
 #include "core/callstacks.h"
 #include "core/debug.h"
 #include "core/gpu.h"
@@ -92,6 +93,7 @@ void PCSX::UI::tick() {
 }
 
 void PCSX::UI::shellReached() {
+    g_emulator->m_bootCache->shellReached();
     auto& regs = g_emulator->m_cpu->m_regs;
     uint32_t oldPC = regs.pc;
     if (g_emulator->settings.get<Emulator::SettingFastBoot>()) {
@@ -114,6 +116,8 @@ void PCSX::UI::shellReached() {
             throw std::runtime_error("Failed to open file.");
         }
         success = BinaryLoader::load(in, g_emulator->m_mem->getMemoryAsFile(), info, g_emulator->m_cpu->m_symbols);
+        // The binary went straight into memory, so whatever got cached off the shell is stale now
+        g_emulator->m_cpu->invalidateCache();
         if (!info.pc.has_value()) {
             throw std::runtime_error("Binary loaded without any PC to jump to.");
         }
@@ -0,0 +1,234 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/watchpoints.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define PCSX_WATCHPOINTS_SUPPORTED
+#endif
+
+#if defined(PCSX_WATCHPOINTS_SUPPORTED)
+#include <signal.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+namespace PCSX {
+
+struct WatchpointsSignalHandler {
+    static inline Watchpoints* s_instance = nullptr;
+    static inline struct sigaction s_previousSegv;
+    static inline struct sigaction s_previousBus;
+    static inline struct sigaction s_previousTrap;
+
+    static constexpr uint64_t c_trapFlag = 0x100;
+    static constexpr uint64_t c_writeError = 0x2;
+
+    static uint64_t& getFlags(void* context) {
+        auto ucontext = reinterpret_cast<ucontext_t*>(context);
+#if defined(__APPLE__)
+        return *reinterpret_cast<uint64_t*>(&ucontext->uc_mcontext->__ss.__rflags);
+#else
+        return *reinterpret_cast<uint64_t*>(&ucontext->uc_mcontext.gregs[REG_EFL]);
+#endif
+    }
+
+    static bool isWrite(void* context) {
+        auto ucontext = reinterpret_cast<ucontext_t*>(context);
+#if defined(__APPLE__)
+        return ucontext->uc_mcontext->__es.__err & c_writeError;
+#else
+        return ucontext->uc_mcontext.gregs[REG_ERR] & c_writeError;
+#endif
+    }
+
+    static void forward(const struct sigaction& previous, int sig, siginfo_t* info, void* context) {
+        if (previous.sa_flags & SA_SIGINFO) {
+            previous.sa_sigaction(sig, info, context);
+        } else if (previous.sa_handler == SIG_DFL || previous.sa_handler == SIG_IGN) {
+            // Restore the original disposition, and let the faulting instruction run again
+            sigaction(sig, &previous, nullptr);
+        } else {
+            previous.sa_handler(sig);
+        }
+    }
+
+    static void faultHandler(int sig, siginfo_t* info, void* context) {
+        if (s_instance && s_instance->handleFault(reinterpret_cast<uintptr_t>(info->si_addr), isWrite(context))) {
+            // Run the faulting instruction once with the page unprotected, and get back to us right after it.
+            getFlags(context) |= c_trapFlag;
+            return;
+        }
+        forward(sig == SIGBUS ? s_previousBus : s_previousSegv, sig, info, context);
+    }
+
+    static void trapHandler(int sig, siginfo_t* info, void* context) {
+        if (s_instance && s_instance->handleStep()) {
+            getFlags(context) &= ~c_trapFlag;
+            return;
+        }
+        forward(s_previousTrap, sig, info, context);
+    }
+
+    static bool install(Watchpoints* instance) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        action.sa_sigaction = faultHandler;
+        if (sigaction(SIGSEGV, &action, &s_previousSegv) != 0) return false;
+        if (sigaction(SIGBUS, &action, &s_previousBus) != 0) {
+            sigaction(SIGSEGV, &s_previousSegv, nullptr);
+            return false;
+        }
+        action.sa_sigaction = trapHandler;
+        if (sigaction(SIGTRAP, &action, &s_previousTrap) != 0) {
+            sigaction(SIGSEGV, &s_previousSegv, nullptr);
+            sigaction(SIGBUS, &s_previousBus, nullptr);
+            return false;
+        }
+        s_instance = instance;
+        return true;
+    }
+
+    static void uninstall() {
+        sigaction(SIGSEGV, &s_previousSegv, nullptr);
+        sigaction(SIGBUS, &s_previousBus, nullptr);
+        sigaction(SIGTRAP, &s_previousTrap, nullptr);
+        s_instance = nullptr;
+    }
+};
+
+}  // namespace PCSX
+
+// The FastMem handler chains to whichever one was installed before it, so this needs to be called
+// before the recompiler gets initialized, and stay installed for as long as the emulator is around.
+bool PCSX::Watchpoints::init() {
+    shutdown();
+    if (WatchpointsSignalHandler::s_instance != nullptr) return false;
+    auto& memory = g_emulator->m_mem;
+    // A raw alloc of wram has no guarantee of being page aligned.
+    if (!memory->m_wramShared.isShared() || (memory->m_wramShared.getSize() < c_ramSize)) return false;
+    if (sysconf(_SC_PAGESIZE) != c_pageSize) return false;
+    if (!WatchpointsSignalHandler::install(this)) return false;
+    m_wram = memory->m_wram;
+    s_emulationThread = true;
+    return true;
+}
+
+void PCSX::Watchpoints::shutdown() {
+    if (!isEnabled()) return;
+    clear();
+    apply();
+    WatchpointsSignalHandler::uninstall();
+    m_wram = nullptr;
+    s_emulationThread = false;
+}
+
+void PCSX::Watchpoints::protect(unsigned page, Protection protection) {
+    int prot = PROT_READ | PROT_WRITE;
+    if (protection == PROTECTION_WRITES) prot = PROT_READ;
+    if (protection == PROTECTION_ALL) prot = PROT_NONE;
+    mprotect(m_wram + (size_t(page) << c_pageShift), c_pageSize, prot);
+}
+
+void PCSX::Watchpoints::apply() {
+    if (!isEnabled()) return;
+    for (unsigned page = 0; page < c_pageCount; page++) {
+        if (m_wanted[page] == m_current[page]) continue;
+        protect(page, m_wanted[page]);
+        m_current[page] = m_wanted[page];
+    }
+}
+
+bool PCSX::Watchpoints::handleFault(uintptr_t faultAddress, bool write) {
+    const uintptr_t offset = faultAddress - reinterpret_cast<uintptr_t>(m_wram);
+    if (offset >= c_ramSize) return false;
+    const unsigned page = offset >> c_pageShift;
+    if (m_current[page] == PROTECTION_NONE) return false;
+
+    // Another thread may have protected the page again while we were stepping through it, in which case this
+    // is the same access faulting once more.
+    const bool stepping = std::find(s_steppingPages, s_steppingPages + s_steppingCount, page) !=
+                          s_steppingPages + s_steppingCount;
+    if (!stepping) {
+        if (s_steppingCount == c_maxSteppingPages) return false;
+        s_steppingPages[s_steppingCount++] = page;
+        if (s_emulationThread && (s_suspended == 0)) {
+            const unsigned index = s_hitCount.load(std::memory_order_relaxed);
+            if (index < c_maxHits) s_hits[index] = {uint32_t(offset), write};
+            s_hitCount.store(index + 1, std::memory_order_relaxed);
+        }
+    }
+    protect(page, PROTECTION_NONE);
+    return true;
+}
+
+bool PCSX::Watchpoints::handleStep() {
+    if (s_steppingCount == 0) return false;
+    for (unsigned i = 0; i < s_steppingCount; i++) {
+        const unsigned page = s_steppingPages[i];
+        protect(page, m_current[page]);
+    }
+    s_steppingCount = 0;
+    return true;
+}
+
+#else
+
+bool PCSX::Watchpoints::init() { return false; }
+void PCSX::Watchpoints::shutdown() {}
+void PCSX::Watchpoints::protect(unsigned page, Protection protection) {}
+void PCSX::Watchpoints::apply() {}
+bool PCSX::Watchpoints::handleFault(uintptr_t faultAddress, bool write) { return false; }
+bool PCSX::Watchpoints::handleStep() { return false; }
+
+#endif
+
+void PCSX::Watchpoints::clear() { memset(m_wanted, PROTECTION_NONE, sizeof(m_wanted)); }
+
+void PCSX::Watchpoints::watch(uint32_t offset, uint32_t size, bool reads) {
+    if ((offset >= c_ramSize) || (size == 0)) return;
+    const uint32_t last = std::min<uint64_t>(uint64_t(offset) + size - 1, c_ramSize - 1);
+    for (unsigned page = offset >> c_pageShift; page <= (last >> c_pageShift); page++) {
+        if (reads) {
+            m_wanted[page] = PROTECTION_ALL;
+        } else if (m_wanted[page] == PROTECTION_NONE) {
+            m_wanted[page] = PROTECTION_WRITES;
+        }
+    }
+}
+
+bool PCSX::Watchpoints::isWatched(uint32_t offset, uint32_t size, bool reads) const {
+    if ((offset >= c_ramSize) || (size == 0)) return false;
+    const uint32_t last = std::min<uint64_t>(uint64_t(offset) + size - 1, c_ramSize - 1);
+    for (unsigned page = offset >> c_pageShift; page <= (last >> c_pageShift); page++) {
+        const auto protection = m_current[page];
+        if (protection == PROTECTION_ALL) return true;
+        if (!reads && (protection == PROTECTION_WRITES)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace PCSX {
+
+// Read and write breakpoints on RAM, done by protecting the host pages backing Memory's shared wram instead of
+// looking at every single access. A write watch makes the page read-only, a read watch makes it inaccessible.
+// When a protected page gets touched, the fault handler records which word it was, lets the faulting host
+// instruction through by single stepping it with the page unprotected, then protects the page again. The hits
+// are handed over to the debugger later on, from the CPU's branch test, so emulation stops at the end of the
+// block which did the access, rather than right on it.
+//
+// Only the CPU's accesses are reported, which means only the ones made by the emulation thread, the thread which
+// called init, outside of any Suspend scope. DMA transfers and everything the branch test does are such scopes.
+// Other host threads, like the GPU command thread walking display lists, can still fault on a watched page: they
+// get let through the same way, silently. While one of them is stepping, the page is briefly unprotected for
+// everyone, so a CPU access landing in that window goes unnoticed.
+class Watchpoints {
+  public:
+    struct Hit {
+        uint32_t offset;
+        bool write;
+    };
+
+    ~Watchpoints() { shutdown(); }
+
+    bool init();
+    void shutdown();
+    bool isEnabled() const { return m_wram != nullptr; }
+
+    // Describes the new set of watched ranges, as offsets in RAM: call clear, then watch for each range,
+    // then apply to change the protection of the host pages which need it.
+    void clear();
+    void watch(uint32_t offset, uint32_t size, bool reads);
+    void apply();
+
+    bool isWatched(uint32_t offset, uint32_t size, bool reads) const;
+    bool hasHits() const { return s_hitCount.load(std::memory_order_relaxed) != 0; }
+    template <typename Callback>
+    void drainHits(Callback callback) {
+        // The callback may well touch watched memory itself, so work from a copy.
+        Hit hits[c_maxHits];
+        const unsigned count = std::min(s_hitCount.load(std::memory_order_relaxed), c_maxHits);
+        for (unsigned i = 0; i < count; i++) hits[i] = s_hits[i];
+        s_hitCount.store(0, std::memory_order_relaxed);
+        for (unsigned i = 0; i < count; i++) callback(hits[i]);
+    }
+
+    // The UI, Lua, DMA, or loading a state, may poke at watched memory too. These aren't the guest CPU's doing,
+    // so faults the current thread takes while one of these is alive don't get reported.
+    class Suspend {
+      public:
+        Suspend() { s_suspended++; }
+        ~Suspend() { s_suspended--; }
+    };
+
+  private:
+    static constexpr unsigned c_pageShift = 12;
+    static constexpr size_t c_pageSize = size_t(1) << c_pageShift;
+    static constexpr size_t c_ramSize = 0x00800000;
+    static constexpr unsigned c_pageCount = c_ramSize >> c_pageShift;
+    static constexpr unsigned c_maxHits = 64;
+    // An unaligned or string host instruction may touch more than one watched page before having been let through.
+    static constexpr unsigned c_maxSteppingPages = 4;
+
+    enum Protection : uint8_t {
+        PROTECTION_NONE,
+        PROTECTION_WRITES,
+        PROTECTION_ALL,
+    };
+
+    bool handleFault(uintptr_t faultAddress, bool write);
+    bool handleStep();
+    void protect(unsigned page, Protection protection);
+
+    uint8_t* m_wram = nullptr;
+    Protection m_wanted[c_pageCount] = {};
+    Protection m_current[c_pageCount] = {};
+
+    // Only ever written to by the emulation thread, from its fault handler, and drained by it too.
+    static inline Hit s_hits[c_maxHits];
+    static inline std::atomic<unsigned> s_hitCount = 0;
+    // The pages being stepped through are per thread, as several threads may fault at the same time.
+    static inline thread_local unsigned s_steppingPages[c_maxSteppingPages];
+    static inline thread_local unsigned s_steppingCount = 0;
+    static inline thread_local unsigned s_suspended = 0;
+    static inline thread_local bool s_emulationThread = false;
+
+    friend struct WatchpointsSignalHandler;
+};
+
+}  // namespace PCSX
@@ -22,41 +22,73 @@
 #include <llhttp.h>
 #include <multipart_parser.h>
 
+#include <algorithm>
 #include <charconv>
+#include <chrono>
 #include <magic_enum_all.hpp>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "GL/gl3w.h"
 #include "cdrom/cdriso.h"
 #include "cdrom/file.h"
 #include "cdrom/iso9660-reader.h"
 #include "core/cdrom.h"
+#include "core/framepacer.h"
+#include "core/framestats.h"
 #include "core/gpu.h"
+#include "core/pad.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/spu.h"
+#include "core/sstate.h"
 #include "core/system.h"
 #include "gui/gui.h"
 #include "lua/luawrapper.h"
 #include "support/file.h"
 #include "support/hashtable.h"
 #include "support/strings-helpers.h"
+#include "support/zfile.h"
 #include "supportpsx/iso9660-builder.h"
 #include "uriparser/Uri.h"
 
 namespace {
 
+// Entity tags only need to tell apart the versions of a resource within a run, and to differ from one run to
+// the next, which the start time takes care of.
+std::string entityTag(std::string_view name, uint64_t generation) {
+    static const auto epoch = std::chrono::system_clock::now().time_since_epoch().count();
+    return fmt::format("\"{}-{:x}-{}\"", name, epoch, generation);
+}
+
 class VramExecutor : public PCSX::WebExecutor {
     virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
         return urldata.path == "/api/v1/gpu/vram/raw";
     }
     virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
         if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
-            client->write(
-                "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 1048576\r\n\r\n");
-            client->write(PCSX::g_emulator->m_gpu->getVRAM());
+            // A new version of VRAM only gets counted when something changed since the last request.
+            auto& gpu = PCSX::g_emulator->m_gpu;
+            if (!m_tracking) {
+                gpu->addVRAMTracker(&m_dirty);
+                m_tracking = true;
+            }
+            if (!m_dirty.empty()) {
+                m_dirty.clear();
+                m_generation++;
+            }
+            const auto etag = entityTag("vram", m_generation);
+            if (writeNotModified(client, request, etag)) return true;
+            PCSX::SliceChain response;
+            response.push(fmt::format(
+                "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 1048576\r\n"
+                "ETag: {}\r\n\r\n",
+                etag));
+            response.push(gpu->getVRAM());
+            client->write(std::move(response));
 
             return true;
         } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
@@ -96,9 +128,325 @@ class VramExecutor : public PCSX::WebExecutor {
         return false;
     }
 
+    PCSX::GPU::VRAMDirtyTiles m_dirty;
+    bool m_tracking = false;
+    uint64_t m_generation = 0;
+
   public:
     VramExecutor() {}
-    virtual ~VramExecutor() = default;
+    virtual ~VramExecutor() {
+        if (m_tracking) PCSX::g_emulator->m_gpu->removeVRAMTracker(&m_dirty);
+    }
+};
+
+// Streams VRAM changes as they happen, as a chunked HTTP response which never ends. Each chunk is one frame,
+// sent after a vblank if anything changed since the last one the client got:
+//   uint32_t frame, uint32_t rects, then for each rect uint16_t x, y, w, h followed by w * h 16 bits pixels.
+// Everything is little endian. The first chunk has the whole of VRAM. A client that can't keep up gets its
+// frames skipped until it drained most of what's in flight, with the skipped changes folded into the next
+// frame it gets, so it never falls more than a couple of frames behind.
+class VramStreamExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/gpu/vram/stream";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+        client->write(
+            "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nCache-Control: no-cache\r\n"
+            "Transfer-Encoding: chunked\r\n\r\n");
+        client->deferResponse();
+        auto subscriber = std::make_unique<Subscriber>();
+        subscriber->client = client;
+        subscriber->lifetime = client->lifetime();
+        PCSX::g_emulator->m_gpu->addVRAMTracker(&subscriber->dirty);
+        m_subscribers.push_back(std::move(subscriber));
+        return true;
+    }
+
+    struct Subscriber {
+        PCSX::WebClient* client;
+        std::weak_ptr<void> lifetime;
+        PCSX::GPU::VRAMDirtyTiles dirty;
+    };
+    // Two full copies of VRAM.
+    static constexpr size_t c_maxPendingBytes = 2 * 1024 * 1024;
+
+    void vsync() {
+        if (m_subscribers.empty()) return;
+        auto& gpu = PCSX::g_emulator->m_gpu;
+        std::erase_if(m_subscribers, [&gpu](const auto& subscriber) {
+            if (!subscriber->lifetime.expired()) return false;
+            gpu->removeVRAMTracker(&subscriber->dirty);
+            return true;
+        });
+        m_frame++;
+
+        bool synced = false;
+        PCSX::Slice vram;
+        for (auto& subscriber : m_subscribers) {
+            if (subscriber->dirty.empty() || (subscriber->client->pendingBytes() > c_maxPendingBytes)) continue;
+            if (!synced) {
+                gpu->syncCommands();
+                vram = gpu->getVRAM();
+                synced = true;
+            }
+            subscriber->client->write(encode(subscriber->dirty, vram.data<uint16_t>()));
+            subscriber->dirty.clear();
+        }
+    }
+
+    std::string encode(const PCSX::GPU::VRAMDirtyTiles& dirty, const uint16_t* vram) {
+        std::string frame(8, '\0');
+        uint32_t rects = 0;
+        auto put16 = [&frame](uint16_t value) { frame.append(reinterpret_cast<const char*>(&value), 2); };
+        dirty.forEachRect([&](int x, int y, int w, int h) {
+            rects++;
+            put16(x);
+            put16(y);
+            put16(w);
+            put16(h);
+            for (int line = y; line < y + h; line++) {
+                frame.append(reinterpret_cast<const char*>(vram + line * 1024 + x), w * sizeof(uint16_t));
+            }
+        });
+        memcpy(frame.data(), &m_frame, sizeof(uint32_t));
+        memcpy(frame.data() + 4, &rects, sizeof(uint32_t));
+        return fmt::format("{:x}\r\n", frame.size()) + frame + "\r\n";
+    }
+
+    std::vector<std::unique_ptr<Subscriber>> m_subscribers;
+    uint32_t m_frame = 0;
+    PCSX::EventBus::Listener m_listener;
+
+  public:
+    VramStreamExecutor() : m_listener(PCSX::g_system->m_eventBus) {
+        m_listener.listen<PCSX::Events::GPU::VSync>([this](const auto& event) { vsync(); });
+    }
+    virtual ~VramStreamExecutor() {
+        for (auto& subscriber : m_subscribers) PCSX::g_emulator->m_gpu->removeVRAMTracker(&subscriber->dirty);
+    }
+};
+
+// A binary protocol for bots, on a connection upgraded from a GET /api/v1/rpc with "Upgrade: pcsx-rpc".
+// Both ways, the connection carries frames of a uint32_t payload size followed by the payload, everything
+// little endian. A request payload is a uint32_t id followed by any number of operations, which run in
+// order. The reply echoes the id, then has one uint8_t status (see Status) per operation, followed by its
+// data if it succeeded. A malformed operation stops the frame there.
+//   ReadRAM      uint32_t address, uint32_t size                  -> size bytes
+//   WriteRAM     uint32_t address, uint32_t size, size bytes
+//   ReadRegs                                                      -> 35 uint32_t: the 32 GPRs, lo, hi, pc
+//   WriteReg     uint8_t index, uint32_t value  (same indices as ReadRegs)
+//   SetPad       uint8_t port, uint16_t pressed buttons           (one bit per button, 0 lets the host through)
+//   WaitVSync                                                     (the rest of the frame runs after the next vblank)
+// RAM addresses can be in any of its mirrors. Reads are copied as they run, so they see the operations before
+// them in the frame, and none of the ones after. A read that would make the reply larger than c_maxFrameSize
+// is out of range. Payloads over c_maxFrameSize, or more than c_maxBufferedInput queued up while a frame waits
+// for a vblank, get the connection closed.
+class RpcExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/rpc";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+        auto upgrade = request.headers.find("Upgrade");
+        if ((upgrade == request.headers.end()) || (upgrade->second != "pcsx-rpc")) {
+            client->write("HTTP/1.1 426 Upgrade Required\r\nUpgrade: pcsx-rpc\r\nConnection: Upgrade\r\n\r\n");
+            return true;
+        }
+        client->write("HTTP/1.1 101 Switching Protocols\r\nUpgrade: pcsx-rpc\r\nConnection: Upgrade\r\n\r\n");
+        auto connection = std::make_unique<Connection>();
+        connection->client = client;
+        connection->lifetime = client->lifetime();
+        client->upgrade([this, connection = connection.get()](const PCSX::Slice& slice) {
+            connection->input.append(slice.data<char>(), slice.size());
+            if (connection->input.size() > c_maxBufferedInput) {
+                connection->input.clear();
+                connection->client->close();
+                return;
+            }
+            if (!connection->waiting) process(connection);
+        });
+        m_connections.push_back(std::move(connection));
+        return true;
+    }
+
+    enum class Op : uint8_t { ReadRAM = 1, WriteRAM, ReadRegs, WriteReg, SetPad, WaitVSync };
+    enum class Status : uint8_t { OK = 0, OutOfRange, Malformed };
+    static constexpr unsigned c_registers = 35;
+    // Enough for a frame writing the whole of the 8MB of RAM, and then some.
+    static constexpr uint32_t c_maxFrameSize = 0x1000000;
+    static constexpr size_t c_maxBufferedInput = 2 * (size_t(c_maxFrameSize) + 4);
+
+    struct Connection {
+        PCSX::WebClient* client;
+        std::weak_ptr<void> lifetime;
+        std::string input;
+        // Set while a frame is stopped on WaitVSync, with what's left of it, and its reply so far.
+        bool waiting = false;
+        std::string frame;
+        std::string reply;
+    };
+
+    // Pops frames off the input until it runs out of full ones, or one waits for a vblank.
+    void process(Connection* connection) {
+        if (connection->waiting) {
+            connection->waiting = false;
+            if (!run(connection)) return;
+        }
+        auto& input = connection->input;
+        while ((input.size() >= 4) && !connection->waiting) {
+            uint32_t size;
+            memcpy(&size, input.data(), 4);
+            if (size > c_maxFrameSize) {
+                input.clear();
+                connection->client->close();
+                return;
+            }
+            if (input.size() - 4 < size) return;
+            connection->frame = input.substr(4, size);
+            input.erase(0, 4 + size);
+            std::string_view frame = connection->frame;
+            if (frame.size() < 4) {
+                connection->client->close();
+                return;
+            }
+            connection->reply.assign(frame.data(), 4);
+            connection->frame.erase(0, 4);
+            run(connection);
+        }
+    }
+
+    // Runs the operations of the current frame. Returns false if it stopped on a WaitVSync.
+    bool run(Connection* connection) {
+        std::string_view frame = connection->frame;
+        std::string& reply = connection->reply;
+        auto& emulator = *PCSX::g_emulator;
+        const uint32_t ramSize = emulator.settings.get<PCSX::Emulator::Setting8MB>().value ? 0x800000 : 0x200000;
+        auto get = [&frame]<typename T>(T& value) {
+            if (frame.size() < sizeof(T)) return false;
+            memcpy(&value, frame.data(), sizeof(T));
+            frame.remove_prefix(sizeof(T));
+            return true;
+        };
+        auto status = [&reply](Status value) { reply.push_back(char(value)); };
+        // Maps the RAM mirrors down to an offset into it, or returns false if the range isn't all in RAM.
+        auto ramRange = [ramSize](uint32_t& address, uint32_t size) {
+            address &= 0x1fffffff;
+            return (address < ramSize) && (size <= ramSize - address);
+        };
+
+        bool malformed = false;
+        while (!frame.empty() && !malformed) {
+            Op op = Op(frame.front());
+            frame.remove_prefix(1);
+            switch (op) {
+                case Op::ReadRAM: {
+                    uint32_t address, size;
+                    if (!get(address) || !get(size)) {
+                        malformed = true;
+                        break;
+                    }
+                    // Reads that would grow the reply past the size of a frame fail too.
+                    if (!ramRange(address, size) || (reply.size() + size > c_maxFrameSize)) {
+                        status(Status::OutOfRange);
+                        break;
+                    }
+                    status(Status::OK);
+                    reply.append(reinterpret_cast<const char*>(emulator.m_mem->m_wram + address), size);
+                } break;
+                case Op::WriteRAM: {
+                    uint32_t address, size;
+                    if (!get(address) || !get(size) || (frame.size() < size)) {
+                        malformed = true;
+                        break;
+                    }
+                    if (!ramRange(address, size)) {
+                        frame.remove_prefix(size);
+                        status(Status::OutOfRange);
+                        break;
+                    }
+                    memcpy(emulator.m_mem->m_wram + address, frame.data(), size);
+                    frame.remove_prefix(size);
+                    emulator.m_mem->markDirtyRange(address, size);
+                    emulator.m_cpu->Clear(address & ~3, (size + (address & 3) + 3) / 4);
+                    status(Status::OK);
+                } break;
+                case Op::ReadRegs: {
+                    auto& regs = emulator.m_cpu->m_regs;
+                    uint32_t values[c_registers];
+                    memcpy(values, regs.GPR.r, 34 * sizeof(uint32_t));
+                    values[34] = regs.pc;
+                    status(Status::OK);
+                    reply.append(reinterpret_cast<const char*>(values), sizeof(values));
+                } break;
+                case Op::WriteReg: {
+                    uint8_t index;
+                    uint32_t value;
+                    if (!get(index) || !get(value)) {
+                        malformed = true;
+                        break;
+                    }
+                    auto& regs = emulator.m_cpu->m_regs;
+                    if (index >= c_registers) {
+                        status(Status::OutOfRange);
+                    } else {
+                        (index == 34 ? regs.pc : regs.GPR.r[index]) = value;
+                        status(Status::OK);
+                    }
+                } break;
+                case Op::SetPad: {
+                    uint8_t port;
+                    uint16_t pressed;
+                    if (!get(port) || !get(pressed)) {
+                        malformed = true;
+                        break;
+                    }
+                    if (port > 1) {
+                        status(Status::OutOfRange);
+                    } else {
+                        emulator.m_pads->setOverrides(PCSX::Pads::Port(port), uint16_t(~pressed));
+                        status(Status::OK);
+                    }
+                } break;
+                case Op::WaitVSync:
+                    status(Status::OK);
+                    connection->frame.erase(0, connection->frame.size() - frame.size());
+                    connection->waiting = true;
+                    return false;
+                default:
+                    malformed = true;
+                    break;
+            }
+        }
+        if (malformed) status(Status::Malformed);
+
+        const uint32_t size = reply.size();
+        std::string header(4, '\0');
+        memcpy(header.data(), &size, 4);
+        PCSX::SliceChain slices;
+        slices.push(std::move(header));
+        slices.push(std::move(reply));
+        connection->client->write(std::move(slices));
+        reply.clear();
+        connection->frame.clear();
+        return true;
+    }
+
+    void vsync() {
+        std::erase_if(m_connections, [](const auto& connection) { return connection->lifetime.expired(); });
+        for (auto& connection : m_connections) {
+            if (connection->waiting) process(connection.get());
+        }
+    }
+
+    std::vector<std::unique_ptr<Connection>> m_connections;
+    PCSX::EventBus::Listener m_listener;
+
+  public:
+    RpcExecutor() : m_listener(PCSX::g_system->m_eventBus) {
+        m_listener.listen<PCSX::Events::GPU::VSync>([this](const auto& event) { vsync(); });
+    }
+    virtual ~RpcExecutor() = default;
 };
 
 class RamExecutor : public PCSX::WebExecutor {
@@ -108,19 +456,29 @@ class RamExecutor : public PCSX::WebExecutor {
     virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
         const auto& ram8M = PCSX::g_emulator->settings.get<PCSX::Emulator::Setting8MB>().value;
         if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
-            if (ram8M) {
-                client->write(
-                    "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 8388608\r\n\r\n");
+            // Same as for VRAM, based on the pages written to since the last request. Writes through raw
+            // pointers to the RAM, such as the Lua ones, don't get noticed.
+            auto& mem = PCSX::g_emulator->m_mem;
+            if (m_dirtyConsumer < 0) {
+                m_dirtyConsumer = mem->addDirtyPagesConsumer();
             } else {
-                client->write(
-                    "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 2097152\r\n\r\n");
+                auto pages = mem->takeDirtyPages(m_dirtyConsumer);
+                if (std::any_of(pages.begin(), pages.end(), [](uint8_t page) { return page != 0; })) m_generation++;
             }
+            const auto etag = entityTag(ram8M ? "ram8" : "ram2", m_generation);
+            if (writeNotModified(client, request, etag)) return true;
+            // The RAM keeps changing while the response goes out, so it still needs its snapshot.
             uint32_t size = 1024 * 1024 * (ram8M ? 8 : 2);
+            PCSX::SliceChain response;
+            response.push(fmt::format(
+                "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: {}\r\nETag: {}\r\n\r\n",
+                size, etag));
             uint8_t* data = (uint8_t*)malloc(size);
             memcpy(data, PCSX::g_emulator->m_mem->m_wram, size);
             PCSX::Slice slice;
             slice.acquire(data, size);
-            client->write(std::move(slice));
+            response.push(std::move(slice));
+            client->write(std::move(response));
             return true;
         } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
             const auto ramSize = (ram8M ? 8 : 2) * 1024 * 1024;
@@ -144,12 +502,16 @@ class RamExecutor : public PCSX::WebExecutor {
             }
 
             memcpy(PCSX::g_emulator->m_mem->m_wram + offset, request.body.data<uint8_t>(), size);
+            PCSX::g_emulator->m_mem->markDirtyRange(offset, size);
             client->write("HTTP/1.1 200 OK\r\n\r\n");
             return true;
         }
         return false;
     }
 
+    int m_dirtyConsumer = -1;
+    uint64_t m_generation = 0;
+
   public:
     RamExecutor() = default;
     virtual ~RamExecutor() = default;
@@ -190,7 +552,7 @@ class AssemblyExecutor : public PCSX::WebExecutor {
                         std::from_chars(addressStr.data(), addressStr.data() + addressStr.size(), address, 16);
                     if (result.ec == std::errc::invalid_argument) continue;
 
-                    cpu->m_symbols[address] = name;
+                    cpu->m_symbols.insert(address, name);
                 }
                 client->write("HTTP/1.1 200 OK\r\n\r\n");
                 return true;
@@ -303,6 +665,113 @@ class FlowExecutor : public PCSX::WebExecutor {
     virtual ~FlowExecutor() = default;
 };
 
+class FrameStatsExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/frame-stats";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+        auto toJson = [](const PCSX::FrameStats::Frame& frame) {
+            nlohmann::json j;
+            for (unsigned i = 0; i < PCSX::FrameStats::COUNT; i++) {
+                j[PCSX::FrameStats::c_keys[i]] = frame.nanoseconds[i] / 1000000.0;
+            }
+            j["total"] = frame.wallTime() / 1000000.0;
+            j["cycles"] = frame.cycles;
+            return j;
+        };
+        nlohmann::json j;
+        j["last"] = toJson(PCSX::g_emulator->m_frameStats->lastFrame());
+        j["average"] = toJson(PCSX::g_emulator->m_frameStats->average());
+        const auto present = PCSX::g_emulator->m_framePacer->presentStats();
+        j["present"] = {{"mean", present.mean},
+                        {"stddev", present.stddev},
+                        {"min", present.min},
+                        {"max", present.max},
+                        {"count", present.count}};
+        write200(client, j);
+        return true;
+    }
+
+  public:
+    FrameStatsExecutor() = default;
+    virtual ~FrameStatsExecutor() = default;
+};
+
+// Exports the monitoring counters in the Prometheus text exposition format.
+class MetricsExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/metrics";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+        auto& emulator = *PCSX::g_emulator;
+        const auto& frameStats = *emulator.m_frameStats;
+        const auto average = frameStats.average();
+        const auto& totals = frameStats.totals();
+        const auto& jit = emulator.m_cpu->getJitStats();
+        const auto& cdrom = emulator.m_cdrom->getReadStats();
+
+        std::string body;
+        auto metric = [&body](std::string_view name, std::string_view type, std::string_view help) {
+            body += fmt::format("# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+        };
+
+        metric("pcsx_running", "gauge", "Whether the emulation is running.");
+        body += fmt::format("pcsx_running {}\n", PCSX::g_system->running() ? 1 : 0);
+        metric("pcsx_frames_total", "counter", "Emulated frames since startup.");
+        body += fmt::format("pcsx_frames_total {}\n", frameStats.frames());
+        metric("pcsx_fps", "gauge", "Emulated frames per host second, over the last frames.");
+        const uint64_t wallTime = average.wallTime();
+        body += fmt::format("pcsx_fps {}\n", wallTime == 0 ? 0.0 : 1e9 / wallTime);
+        metric("pcsx_speed_ratio", "gauge", "Emulated time over host time, over the last frames.");
+        const double emulated = double(average.cycles) / emulator.m_psxClockSpeed;
+        body += fmt::format("pcsx_speed_ratio {}\n", wallTime == 0 ? 0.0 : emulated * 1e9 / wallTime);
+        metric("pcsx_emulated_cycles_total", "counter", "Emulated CPU cycles since startup.");
+        body += fmt::format("pcsx_emulated_cycles_total {}\n", totals.cycles);
+        metric("pcsx_host_seconds_total", "counter", "Host time spent in each subsystem.");
+        for (unsigned i = 0; i < PCSX::FrameStats::COUNT; i++) {
+            body += fmt::format("pcsx_host_seconds_total{{subsystem=\"{}\"}} {}\n", PCSX::FrameStats::c_keys[i],
+                                totals.nanoseconds[i] / 1e9);
+        }
+
+        metric("pcsx_dynarec_blocks_compiled_total", "counter", "Blocks compiled by the dynarec.");
+        body += fmt::format("pcsx_dynarec_blocks_compiled_total {}\n", jit.blocksCompiled);
+        metric("pcsx_dynarec_cache_flushes_total", "counter", "Times the dynarec code cache filled up and got flushed.");
+        body += fmt::format("pcsx_dynarec_cache_flushes_total {}\n", jit.cacheFlushes);
+        metric("pcsx_dynarec_cache_evictions_total", "counter", "Dynarec code cache regions evicted to make room.");
+        body += fmt::format("pcsx_dynarec_cache_evictions_total {}\n", jit.cacheEvictions);
+        metric("pcsx_dynarec_invalidations_total", "counter", "Times the RAM blocks got invalidated by the guest.");
+        body += fmt::format("pcsx_dynarec_invalidations_total {}\n", jit.invalidations);
+        metric("pcsx_dynarec_blocks_promoted_total", "counter", "Hot blocks recompiled by the dynarec's second tier.");
+        body += fmt::format("pcsx_dynarec_blocks_promoted_total {}\n", jit.blocksPromoted);
+
+        metric("pcsx_cdrom_sectors_read_total", "counter", "Sectors read off the disc image.");
+        body += fmt::format("pcsx_cdrom_sectors_read_total{{type=\"data\"}} {}\n", cdrom.dataSectors);
+        body += fmt::format("pcsx_cdrom_sectors_read_total{{type=\"audio\"}} {}\n", cdrom.audioSectors);
+        metric("pcsx_cdrom_read_failures_total", "counter", "Data sectors that failed to read.");
+        body += fmt::format("pcsx_cdrom_read_failures_total {}\n", cdrom.failures);
+
+        metric("pcsx_audio_underruns_total", "counter", "Times the audio device ran out of samples.");
+        body += fmt::format("pcsx_audio_underruns_total {}\n", emulator.m_spu->getUnderruns());
+
+        metric("pcsx_memory_bytes", "gauge", "Memory used by the emulated machine and the dynarec.");
+        const bool ram8M = emulator.settings.get<PCSX::Emulator::Setting8MB>().value;
+        body += fmt::format("pcsx_memory_bytes{{area=\"ram\"}} {}\n", ram8M ? 0x800000 : 0x200000);
+        body += fmt::format("pcsx_memory_bytes{{area=\"dynarec_code\"}} {}\n", emulator.m_cpu->getBufferSize());
+
+        std::string message = fmt::format(
+            "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: {}\r\n\r\n{}",
+            body.size(), body);
+        client->write(std::move(message));
+        return true;
+    }
+
+  public:
+    MetricsExecutor() = default;
+    virtual ~MetricsExecutor() = default;
+};
+
 class LuaExecutor : public PCSX::WebExecutor {
     virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
         return PCSX::StringsHelpers::startsWith(urldata.path, c_prefix);
@@ -542,11 +1011,15 @@ class StateExecutor : public PCSX::WebExecutor {
         return PCSX::StringsHelpers::startsWith(urldata.path, c_prefix);
     }
     virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        auto path = request.urlData.path.substr(c_prefix.length());
+        if ((request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) &&
+            ((path == "snapshot") || (path == "restore") || (path == "forget"))) {
+            return executeSnapshot(client, path, request);
+        }
         if (PCSX::g_gui == nullptr) {
             client->write("HTTP/1.1 500 Internal Server Error\r\n\r\nSave states unavailable in CLI/no-UI mode.");
             return false;
         }
-        auto path = request.urlData.path.substr(c_prefix.length());
 
         if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
             if (path == "usage") {
@@ -658,6 +1131,53 @@ class StateExecutor : public PCSX::WebExecutor {
         return false;
     }
 
+    // Snapshots are kept in memory, by name, for as long as the server lives, and don't need the UI.
+    // A snapshot can be taken against a base one, to share the memory pages they have in common.
+    bool executeSnapshot(PCSX::WebClient* client, std::string_view path, PCSX::RequestData& request) {
+        auto vars = parseQuery(request.urlData.query);
+        auto iname = vars.find("name");
+        if ((iname == vars.end()) || iname->second.value_or("").empty()) {
+            client->write("HTTP/1.1 400 Bad Request\r\n\r\nSnapshot name is missing.");
+            return true;
+        }
+        const std::string name = iname->second.value();
+        std::string message;
+        if (path == "snapshot") {
+            const PCSX::SaveStates::Snapshot* base = nullptr;
+            auto ibase = vars.find("base");
+            if (ibase != vars.end()) {
+                auto found = m_snapshots.find(ibase->second.value_or(""));
+                if (found == m_snapshots.end()) {
+                    client->write(fmt::format("HTTP/1.1 404 Not Found\r\n\r\nBase snapshot \"{}\" not found.",
+                                              ibase->second.value_or("")));
+                    return true;
+                }
+                base = &found->second;
+            }
+            m_snapshots[name] = PCSX::SaveStates::Snapshot::take(base);
+            message = fmt::format("HTTP/1.1 200 OK\r\n\r\nSnapshot \"{}\" taken.", name);
+        } else {
+            auto found = m_snapshots.find(name);
+            if (found == m_snapshots.end()) {
+                message = fmt::format("HTTP/1.1 404 Not Found\r\n\r\nSnapshot \"{}\" not found.", name);
+            } else if (path == "restore") {
+                if (found->second.restore()) {
+                    message = fmt::format("HTTP/1.1 200 OK\r\n\r\nSnapshot \"{}\" restored.", name);
+                } else {
+                    message = fmt::format(
+                        "HTTP/1.1 500 Internal Server Error\r\n\r\nSnapshot \"{}\" restore failed.", name);
+                }
+            } else {
+                m_snapshots.erase(found);
+                message = fmt::format("HTTP/1.1 200 OK\r\n\r\nSnapshot \"{}\" forgotten.", name);
+            }
+        }
+        client->write(std::move(message));
+        return true;
+    }
+
+    std::map<std::string, PCSX::SaveStates::Snapshot> m_snapshots;
+
   public:
     const std::string_view c_prefix = "/api/v1/state/";
     StateExecutor() = default;
@@ -679,7 +1199,6 @@ class ScreenExecutor : public PCSX::WebExecutor {
                     client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
                     return true;
                 }
-                std::string message;
                 std::filesystem::path path = std::filesystem::path(ifilepath->second.value_or("").c_str());
                 if (path.is_relative()) {
                     std::filesystem::path persistentDir = PCSX::g_system->getPersistentDir();
@@ -688,60 +1207,60 @@ class ScreenExecutor : public PCSX::WebExecutor {
                     }
                     path = persistentDir / path;
                 }
-                auto screenshot = PCSX::g_emulator->m_gpu->takeScreenShot();
-                clip::image img = convertScreenshotToImage(std::move(screenshot));
-                bool success = writeImagePNG(path.string(), std::move(img));
-                if (success) {
-                    message =
-                        fmt::format("HTTP/1.1 200 OK\r\n\r\nScreenshot saved successfully to \"{}\".", path.string());
-                } else {
-                    message =
-                        fmt::format("HTTP/1.1 500 Internal Server Error\r\n\r\nFailed to save screenshot to \"{}\".",
-                                    path.string());
-                }
-                client->write(std::move(message));
+                // The GPU may only have the screenshot ready a frame later, so answer once it is
+                client->deferResponse();
+                PCSX::g_emulator->m_gpu->takeScreenShotAsync(
+                    [client, path, lifetime = client->lifetime()](PCSX::GPU::ScreenShot&& screenshot) {
+                        if (lifetime.expired()) return;
+                        std::string message;
+                        clip::image img = convertScreenshotToImage(std::move(screenshot));
+                        bool success = writeImagePNG(path.string(), std::move(img));
+                        if (success) {
+                            message = fmt::format("HTTP/1.1 200 OK\r\n\r\nScreenshot saved successfully to \"{}\".",
+                                                  path.string());
+                        } else {
+                            message = fmt::format(
+                                "HTTP/1.1 500 Internal Server Error\r\n\r\nFailed to save screenshot to \"{}\".",
+                                path.string());
+                        }
+                        client->write(std::move(message));
+                        client->completeResponse();
+                    });
                 return true;
             } else if (path == "still") {
-                auto screenshot = PCSX::g_emulator->m_gpu->takeScreenShot();
-                clip::image img = convertScreenshotToImage(std::move(screenshot));
-                writeImagePNG(client, std::move(img));
+                client->deferResponse();
+                PCSX::g_emulator->m_gpu->takeScreenShotAsync(
+                    [client, lifetime = client->lifetime()](PCSX::GPU::ScreenShot&& screenshot) {
+                        if (lifetime.expired()) return;
+                        clip::image img = convertScreenshotToImage(std::move(screenshot));
+                        writeImagePNG(client, std::move(img));
+                        client->completeResponse();
+                    });
                 return true;
             }
         }
         return false;
     }
-    clip::image convertScreenshotToImage(PCSX::GPU::ScreenShot&& screenshot) {
+    static clip::image convertScreenshotToImage(PCSX::GPU::ScreenShot&& screenshot) {
         clip::image_spec spec;
         spec.width = screenshot.width;
         spec.height = screenshot.height;
-        if (screenshot.bpp == PCSX::GPU::ScreenShot::BPP_16) {
-            spec.bits_per_pixel = 16;
-            spec.bytes_per_row = screenshot.width * 2;
-            spec.red_mask = 0x1f;  // 0x7c00;
-            spec.green_mask = 0x3e0;
-            spec.blue_mask = 0x7c00;  // 0x1f;
-            spec.alpha_mask = 0;
-            spec.red_shift = 0;  // 10;
-            spec.green_shift = 5;
-            spec.blue_shift = 10;  // 0;
-            spec.alpha_shift = 0;
-        } else {
-            spec.bits_per_pixel = 24;
-            spec.bytes_per_row = screenshot.width * 3;
-            spec.red_mask = 0xff0000;
-            spec.green_mask = 0xff00;
-            spec.blue_mask = 0xff;
-            spec.alpha_mask = 0;
-            spec.red_shift = 16;
-            spec.green_shift = 8;
-            spec.blue_shift = 0;
-            spec.alpha_shift = 0;
-        }
-        clip::image img(screenshot.data.data(), spec);
-        return img.to_rgba8888();
+        spec.bits_per_pixel = 32;
+        spec.bytes_per_row = screenshot.width * 4;
+        spec.red_mask = 0xff;
+        spec.green_mask = 0xff00;
+        spec.blue_mask = 0xff0000;
+        spec.alpha_mask = 0xff000000;
+        spec.red_shift = 0;
+        spec.green_shift = 8;
+        spec.blue_shift = 16;
+        spec.alpha_shift = 24;
+        clip::image img(spec);
+        screenshot.toRGBA(reinterpret_cast<uint8_t*>(img.data()));
+        return img;
     }
-    bool writeImagePNG(std::string filename, clip::image&& img) { return img.export_to_png(filename); }
-    bool writeImagePNG(PCSX::WebClient* client, clip::image&& img) {
+    static bool writeImagePNG(std::string filename, clip::image&& img) { return img.export_to_png(filename); }
+    static bool writeImagePNG(PCSX::WebClient* client, clip::image&& img) {
         std::vector<uint8_t> pngData;
         bool success = img.export_to_png(pngData);
         if (!success) {
@@ -795,12 +1314,38 @@ void PCSX::WebExecutor::write200(PCSX::WebClient* client, const nlohmann::json&
     client->write(std::move(message));
 }
 
+bool PCSX::WebExecutor::writeNotModified(PCSX::WebClient* client, const PCSX::RequestData& request,
+                                         std::string_view etag) {
+    auto ifNoneMatch = request.header("If-None-Match");
+    if (!ifNoneMatch) return false;
+    for (auto tag : StringsHelpers::split(std::string_view(*ifNoneMatch), ",")) {
+        tag = StringsHelpers::trim(tag);
+        if (tag.starts_with("W/")) tag.remove_prefix(2);
+        if ((tag == "*") || (tag == etag)) {
+            client->write(fmt::format("HTTP/1.1 304 Not Modified\r\nETag: {}\r\n\r\n", etag));
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::string* PCSX::RequestData::header(std::string_view name) const {
+    for (auto& [key, value] : headers) {
+        if (StringsHelpers::strcasecmp(key, name)) return &value;
+    }
+    return nullptr;
+}
+
 PCSX::WebServer::WebServer() : m_listener(g_system->m_eventBus) {
     m_executors.push_back(new VramExecutor());
+    m_executors.push_back(new VramStreamExecutor());
     m_executors.push_back(new RamExecutor());
+    m_executors.push_back(new RpcExecutor());
     m_executors.push_back(new AssemblyExecutor());
     m_executors.push_back(new CacheExecutor());
     m_executors.push_back(new FlowExecutor());
+    m_executors.push_back(new FrameStatsExecutor());
+    m_executors.push_back(new MetricsExecutor());
     m_executors.push_back(new LuaExecutor());
     m_executors.push_back(new CDExecutor());
     m_executors.push_back(new StateExecutor());
@@ -860,25 +1405,45 @@ struct PCSX::WebClient::WebClientImpl {
     struct WriteRequest : public Intrusive::HashTable<uintptr_t, WriteRequest>::Node {
         WriteRequest() {}
         WriteRequest(Slice&& slice) : m_slice(std::move(slice)) {}
+        WriteRequest(SliceChain&& slices) : m_slices(std::move(slices)) {}
         void enqueue(WebClientImpl* client) {
             if (client->m_closeScheduled) {
                 delete this;
                 return;
             }
-            m_buf.base = static_cast<char*>(const_cast<void*>(m_slice.data()));
-            m_buf.len = m_slice.size();
+            uv_buf_t* bufs = &m_buf;
+            unsigned count = 1;
+            if (m_slices.empty()) {
+                m_buf.base = static_cast<char*>(const_cast<void*>(m_slice.data()));
+                m_buf.len = m_slice.size();
+                m_bytes = m_buf.len;
+            } else {
+                m_bufs.reserve(m_slices.count());
+                m_slices.forEach([this](const void* ptr, size_t size) {
+                    m_bufs.push_back(uv_buf_init(static_cast<char*>(const_cast<void*>(ptr)), size));
+                });
+                bufs = m_bufs.data();
+                count = m_bufs.size();
+                m_bytes = m_slices.size();
+            }
+            client->m_pendingBytes += m_bytes;
             client->m_requests.insert(reinterpret_cast<uintptr_t>(&m_req), this);
-            uv_write(&m_req, reinterpret_cast<uv_stream_t*>(&client->m_tcp), &m_buf, 1, writeCB);
+            uv_write(&m_req, reinterpret_cast<uv_stream_t*>(&client->m_tcp), bufs, count, writeCB);
         }
         static void writeCB(uv_write_t* request, int status) {
             WebClientImpl* client = static_cast<WebClientImpl*>(request->handle->data);
             auto self = client->m_requests.find(reinterpret_cast<uintptr_t>(request));
+            client->m_pendingBytes -= self->m_bytes;
             delete &*self;
             if ((status != 0) || (client->m_closeScheduled && (client->m_requests.size() == 0))) client->close();
         }
         uv_buf_t m_buf;
         uv_write_t m_req;
+        size_t m_bytes = 0;
         Slice m_slice;
+        // Multi-part responses go out as one write, with one buffer per slice.
+        SliceChain m_slices;
+        std::vector<uv_buf_t> m_bufs;
     };
     Intrusive::HashTable<uintptr_t, WriteRequest> m_requests;
 
@@ -937,25 +1502,32 @@ struct PCSX::WebClient::WebClientImpl {
     bool accept(uv_tcp_t* srv) {
         assert(m_status == CLOSED);
         if (uv_accept(reinterpret_cast<uv_stream_t*>(srv), reinterpret_cast<uv_stream_t*>(&m_tcp)) == 0) {
-            uv_read_start(
-                reinterpret_cast<uv_stream_t*>(&m_tcp),
-                [](uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf) {
-                    WebClientImpl* client = static_cast<WebClientImpl*>(handle->data);
-                    client->alloc(suggestedSize, buf);
-                },
-                [](uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
-                    WebClientImpl* client = static_cast<WebClientImpl*>(stream->data);
-                    client->read(nread, buf);
-                });
+            startReading();
             m_status = OPEN;
         }
         return m_status == OPEN;
     }
+    void startReading() {
+        uv_read_start(
+            reinterpret_cast<uv_stream_t*>(&m_tcp),
+            [](uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf) {
+                WebClientImpl* client = static_cast<WebClientImpl*>(handle->data);
+                client->alloc(suggestedSize, buf);
+            },
+            [](uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+                WebClientImpl* client = static_cast<WebClientImpl*>(stream->data);
+                client->read(nread, buf);
+            });
+    }
 
     void onEOF() {
+        if (m_upgraded) {
+            scheduleClose();
+            return;
+        }
         auto error = llhttp_finish(&m_httpParser);
         if (error == HPE_PAUSED_UPGRADE) {
-            onUpgrade();
+            onUpgrade(nullptr, 0);
         } else if (error != HPE_OK) {
             send400(magic_enum::enum_name(error));
         } else {
@@ -963,8 +1535,25 @@ struct PCSX::WebClient::WebClientImpl {
         }
     }
 
-    void onUpgrade() {}
-    int onMessageBegin() { return 0; }
+    void onUpgrade(const char* data, size_t size) {
+        if (!m_upgraded) {
+            send400("HPE_UPGRADE_UNSUPPORTED");
+            return;
+        }
+        const char* rest = llhttp_get_error_pos(&m_httpParser);
+        if ((rest == nullptr) || (rest < data) || (rest >= data + size)) return;
+        Slice slice;
+        slice.borrow(rest, data + size - rest);
+        m_upgraded(slice);
+    }
+    int onMessageBegin() {
+        // The same connection can carry any number of requests, one after the other.
+        m_requestData = {};
+        m_headerState = PARSING_HEADER;
+        m_formHeaderState = PARSING_HEADER;
+        m_currentExecutor = m_server->m_executors.end();
+        return 0;
+    }
     int onUrl(const Slice& slice) {
         UriUriA uri;
         std::string urlString = slice.asString();
@@ -988,7 +1577,8 @@ struct PCSX::WebClient::WebClientImpl {
         uriFreeUriMembersA(&uri);
         g_system->log(LogClass::WEBSERVER, "Received web api request, path: %s, query: %s\n",
                       m_requestData.urlData.path.c_str(), m_requestData.urlData.query.c_str());
-        return findExecutor() ? 0 : 1;
+        findExecutor();
+        return 0;
     }
     int onStatus(const Slice& slice) { return 0; }
     void headerComplete() {
@@ -1093,9 +1683,11 @@ struct PCSX::WebClient::WebClientImpl {
     int onMessageComplete() {
         if (m_multipart) {
             multipart_parser_free(m_multipartParser);
+            m_multipart = false;
         }
         executeRequest();
-        return 0;
+        // Pipelined requests wait for the one in progress to be answered, so that the responses go out in order.
+        return (m_responding || m_closeScheduled) ? HPE_PAUSED : HPE_OK;
     }
     int onChunkHeader() { return 0; }
     int onChunkComplete() { return 0; }
@@ -1120,13 +1712,23 @@ struct PCSX::WebClient::WebClientImpl {
         delete client->m_parent;
     }
     void processData(const Slice& slice) {
+        if (m_upgraded) {
+            m_upgraded(slice);
+            return;
+        }
         const char* ptr = reinterpret_cast<const char*>(slice.data());
         auto size = slice.size();
 
         auto error = llhttp_execute(&m_httpParser, ptr, size);
-        if (m_status != OPEN) return;
-        if (error == HPE_PAUSED_UPGRADE) {
-            onUpgrade();
+        if ((m_status != OPEN) || m_closeScheduled) return;
+        if (error == HPE_PAUSED) {
+            // Holding on to what's left, and not reading any further, until the current response is complete.
+            const char* rest = llhttp_get_error_pos(&m_httpParser);
+            m_pendingInput.assign(rest, ptr + size);
+            m_paused = true;
+            uv_read_stop(reinterpret_cast<uv_stream_t*>(&m_tcp));
+        } else if (error == HPE_PAUSED_UPGRADE) {
+            onUpgrade(ptr, size);
         } else if (error != HPE_OK) {
             send400(magic_enum::enum_name(error));
         }
@@ -1140,11 +1742,36 @@ struct PCSX::WebClient::WebClientImpl {
         write(std::move(slice));
     }
 
+    // While an executor is answering a request, its writes are gathered, so that the response can be framed
+    // with its length once complete, which is what lets the connection carry the next request.
     void write(Slice&& slice) {
+        if (m_responding && !m_streaming) {
+            m_response.push(std::move(slice));
+            return;
+        }
+        send(std::move(slice));
+    }
+
+    void write(SliceChain&& slices) {
+        if (slices.empty()) return;
+        if (m_responding && !m_streaming) {
+            m_response.push(std::move(slices));
+            return;
+        }
+        send(std::move(slices));
+    }
+
+    void send(Slice&& slice) {
         auto* req = new WriteRequest(std::move(slice));
         req->enqueue(this);
     }
 
+    void send(SliceChain&& slices) {
+        if (slices.empty()) return;
+        auto* req = new WriteRequest(std::move(slices));
+        req->enqueue(this);
+    }
+
     void write(std::string&& str) {
         Slice slice(std::move(str));
         write(std::move(slice));
@@ -1156,30 +1783,217 @@ struct PCSX::WebClient::WebClientImpl {
     }
 
     void send400(std::string_view code) {
-        std::string str =
-            fmt::format("HTTP/1.1 400 Bad Request\r\n\r\nRequest failed to parse properly. Error: {}\r\n", code);
-        write(std::move(str));
-        scheduleClose();
-    }
-
-    void send404() {
-        write("HTTP/1.1 404 Not Found\r\n\r\nURL Not found.\r\n");
+        // The request stream can't be resynchronised after a parse error, so this is the last thing sent.
+        std::string str = fmt::format(
+            "HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\nRequest failed to parse properly. Error: {}\r\n",
+            code);
+        send(Slice(std::move(str)));
         scheduleClose();
     }
 
-    bool findExecutor() {
+    void findExecutor() {
         auto& list = m_server->m_executors;
         for (m_currentExecutor = list.begin(); m_currentExecutor != list.end(); m_currentExecutor++) {
-            if (m_currentExecutor->match(m_parent, m_requestData.urlData)) return true;
+            if (m_currentExecutor->match(m_parent, m_requestData.urlData)) return;
         }
-        send404();
-        return false;
     }
-    int executeRequest() {
+    void executeRequest() {
         m_requestData.method = static_cast<RequestData::Method>(m_httpParser.method);
-        m_currentExecutor->execute(m_parent, m_requestData);
-        scheduleClose();
-        return 0;
+        m_keepAlive = llhttp_should_keep_alive(&m_httpParser);
+        m_acceptsGzip = acceptsGzip(m_requestData);
+        m_responding = true;
+        bool handled = false;
+        if (m_currentExecutor != m_server->m_executors.end()) {
+            handled = m_currentExecutor->execute(m_parent, m_requestData);
+        }
+        if (m_upgraded) {
+            // The 101 response goes out as is, and whatever comes next is up to the upgrade handler.
+            m_responding = false;
+            send(std::move(m_response));
+            return;
+        }
+        if (m_deferredResponses != 0) {
+            // Streamed responses frame themselves with chunks, and never end, so they go out as they come.
+            auto head = responseHead(m_response);
+            if (head && hasHeader(*head, "transfer-encoding")) {
+                m_streaming = true;
+                send(std::move(m_response));
+            }
+            return;
+        }
+        if (!handled && m_response.empty()) m_response.push("HTTP/1.1 404 Not Found\r\n\r\nURL Not found.\r\n");
+        finishResponse();
+    }
+    void responseCompleted() {
+        if (m_streaming) {
+            m_streaming = false;
+            m_responding = false;
+            scheduleClose();
+            return;
+        }
+        finishResponse();
+        resume();
+    }
+    // Adds the Content-Length header the executors may have left out, computed from what they wrote, and
+    // tells the client when the connection won't be kept alive.
+    void finishResponse() {
+        SliceChain response = std::move(m_response);
+        auto head = responseHead(response);
+        if (!head) {
+            // Without a proper header, only closing the connection can tell where the response ends.
+            m_responding = false;
+            send(std::move(response));
+            scheduleClose();
+            return;
+        }
+        response.consume(head->size());
+        head->resize(head->size() - 2);
+        if (compressible(*head, response.size())) {
+            *head += "Vary: Accept-Encoding\r\n";
+            if (m_acceptsGzip) {
+                compressResponse(std::move(*head), std::move(response));
+                return;
+            }
+        }
+        sendResponse(std::move(*head), std::move(response));
+    }
+    void sendResponse(std::string&& head, SliceChain&& body) {
+        m_responding = false;
+        const std::string_view status = std::string_view(head).substr(9, 3);
+        const bool bodyless = (status == "204") || (status == "304");
+        if (!bodyless && !hasHeader(head, "content-length") && !hasHeader(head, "transfer-encoding")) {
+            head += fmt::format("Content-Length: {}\r\n", body.size());
+        }
+        if (!m_keepAlive) head += "Connection: close\r\n";
+        head += "\r\n";
+        SliceChain framed;
+        framed.push(std::move(head));
+        framed.push(std::move(body));
+        send(std::move(framed));
+        if (!m_keepAlive) scheduleClose();
+    }
+    // Large bodies which aren't compressed already, such as the RAM and VRAM dumps, and JSON.
+    static bool compressible(std::string_view head, size_t size) {
+        if ((size < c_minCompressedSize) || hasHeader(head, "content-encoding") ||
+            hasHeader(head, "transfer-encoding")) {
+            return false;
+        }
+        std::string lowered(head);
+        std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) { return tolower(c); });
+        auto pos = lowered.find("\r\ncontent-type:");
+        if (pos == std::string::npos) return true;
+        pos += 15;
+        auto type = StringsHelpers::trim(std::string_view(lowered).substr(pos, lowered.find("\r\n", pos) - pos));
+        return type.starts_with("application/octet-stream") || type.starts_with("application/json") ||
+               type.starts_with("text/");
+    }
+    static bool acceptsGzip(const RequestData& request) {
+        auto acceptEncoding = request.header("Accept-Encoding");
+        if (!acceptEncoding) return false;
+        for (auto coding : StringsHelpers::split(std::string_view(*acceptEncoding), ",")) {
+            auto parts = StringsHelpers::split(coding, ";");
+            if (parts.empty()) continue;
+            auto name = StringsHelpers::trim(parts[0]);
+            if (!StringsHelpers::strcasecmp(name, "gzip") && (name != "*")) continue;
+            // A zero quality value means the client doesn't want it.
+            if (parts.size() > 1) {
+                auto quality = StringsHelpers::trim(parts[1]);
+                if (quality.starts_with("q=") && (strtod(std::string(quality.substr(2)).c_str(), nullptr) == 0.0)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+    // The compression runs on the libuv thread pool, so that the emulation doesn't wait on it. The requests
+    // pipelined behind this one stay on hold until it's sent, to keep the responses in order.
+    struct CompressionWork {
+        uv_work_t req;
+        WebClientImpl* client;
+        std::weak_ptr<void> lifetime;
+        std::string head;
+        std::string body;
+        Slice compressed;
+    };
+    void compressResponse(std::string&& head, SliceChain&& body) {
+        auto work = new CompressionWork();
+        work->req.data = work;
+        work->client = this;
+        work->lifetime = m_parent->lifetime();
+        work->head = std::move(head);
+        // Copying the body out also snapshots the parts that are only borrowed, such as VRAM.
+        work->body.resize(body.size());
+        body.read(work->body.data(), work->body.size());
+        uv_queue_work(
+            m_server->m_loop, &work->req,
+            [](uv_work_t* req) {
+                auto work = static_cast<CompressionWork*>(req->data);
+                try {
+                    work->compressed = ZWriter::compress(work->body, Z_BEST_SPEED);
+                } catch (...) {
+                    work->compressed = {};
+                }
+            },
+            [](uv_work_t* req, int status) {
+                std::unique_ptr<CompressionWork> work(static_cast<CompressionWork*>(req->data));
+                if (work->lifetime.expired()) return;
+                SliceChain body;
+                if ((status == 0) && (work->compressed.size() != 0) &&
+                    (work->compressed.size() < work->body.size())) {
+                    removeHeader(work->head, "content-length");
+                    work->head += "Content-Encoding: gzip\r\n";
+                    body.push(std::move(work->compressed));
+                } else {
+                    body.push(std::move(work->body));
+                }
+                work->client->sendResponse(std::move(work->head), std::move(body));
+                work->client->resume();
+            });
+    }
+    static void removeHeader(std::string& head, std::string_view name) {
+        std::string lowered(head);
+        std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) { return tolower(c); });
+        auto pos = lowered.find(fmt::format("\r\n{}:", name));
+        if (pos == std::string::npos) return;
+        head.erase(pos, lowered.find("\r\n", pos + 2) - pos);
+    }
+    void resume() {
+        if (!m_paused || m_responding || (m_status != OPEN) || m_closeScheduled) return;
+        m_paused = false;
+        llhttp_resume(&m_httpParser);
+        startReading();
+        std::string pending = std::move(m_pendingInput);
+        m_pendingInput.clear();
+        if (pending.empty()) return;
+        Slice slice;
+        slice.borrow(pending.data(), pending.size());
+        processData(slice);
+    }
+    // The status line and headers of a response, up to and including the empty line, if all there.
+    static constexpr size_t c_maxHeadSize = 16384;
+    static constexpr size_t c_minCompressedSize = 1024;
+    static std::optional<std::string> responseHead(const SliceChain& response) {
+        std::string head;
+        bool complete = false;
+        response.forEach([&head, &complete](const void* ptr, size_t size) {
+            if (complete) return;
+            const char* data = static_cast<const char*>(ptr);
+            for (size_t i = 0; (i < size) && (head.size() < c_maxHeadSize); i++) {
+                head += data[i];
+                if (head.ends_with("\r\n\r\n")) {
+                    complete = true;
+                    return;
+                }
+            }
+        });
+        if (!complete) return std::nullopt;
+        return head;
+    }
+    static bool hasHeader(std::string_view head, std::string_view name) {
+        std::string lowered(head);
+        std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) { return tolower(c); });
+        return lowered.find(fmt::format("\r\n{}:", name)) != std::string::npos;
     }
     void scheduleClose() {
         if (m_requests.size() == 0) {
@@ -1191,7 +2005,8 @@ struct PCSX::WebClient::WebClientImpl {
 
     WebServer* m_server;
     uv_tcp_t m_tcp;
-    static constexpr size_t BUFFER_SIZE = 256;
+    // Upgraded connections can carry bulk writes, so this is larger than any HTTP request needs.
+    static constexpr size_t BUFFER_SIZE = 16384;
     char m_buffer[BUFFER_SIZE];
     bool m_allocated = false;
     enum { CLOSED, OPEN, CLOSING } m_status = CLOSED;
@@ -1217,14 +2032,33 @@ struct PCSX::WebClient::WebClientImpl {
     multipart_parser_settings m_multipartParserCallbacks;
 
     bool m_closeScheduled = false;
+    // Whether an executor is answering a request, and whether that answer is streamed as it's written.
+    bool m_responding = false;
+    bool m_streaming = false;
+    bool m_keepAlive = false;
+    bool m_acceptsGzip = false;
+    SliceChain m_response;
+    // Pipelined requests which arrived while the previous one was still being answered.
+    bool m_paused = false;
+    std::string m_pendingInput;
+    unsigned m_deferredResponses = 0;
+    size_t m_pendingBytes = 0;
+    WebClient::UpgradeHandler m_upgraded;
 };
 
 PCSX::WebClient::WebClient(WebServer* server) : m_impl(std::make_unique<WebClientImpl>(server, this)) {}
 void PCSX::WebClient::close() { m_impl->close(); }
 bool PCSX::WebClient::accept(uv_tcp_t* srv) { return m_impl->accept(srv); }
 void PCSX::WebClient::write(Slice&& slice) { m_impl->write(std::move(slice)); }
+void PCSX::WebClient::write(SliceChain&& slices) { m_impl->write(std::move(slices)); }
 void PCSX::WebClient::write(std::string&& str) { m_impl->write(std::move(str)); }
 void PCSX::WebClient::write(const std::string& str) { m_impl->write(str); }
+void PCSX::WebClient::deferResponse() { m_impl->m_deferredResponses++; }
+void PCSX::WebClient::completeResponse() {
+    if (--m_impl->m_deferredResponses == 0) m_impl->responseCompleted();
+}
+size_t PCSX::WebClient::pendingBytes() const { return m_impl->m_pendingBytes; }
+void PCSX::WebClient::upgrade(UpgradeHandler&& handler) { m_impl->m_upgraded = std::move(handler); }
 
 void PCSX::WebServer::onNewConnection(int status) {
     if (status < 0) return;
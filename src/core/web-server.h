@@ -21,6 +21,7 @@
 
 #include <uv.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -85,6 +86,8 @@ struct RequestData {
     std::multimap<std::string, std::string> headers;
     std::multimap<std::string, std::string> form;
     Slice body;
+    // Header names are case insensitive, and clients don't all spell them the same way.
+    const std::string* header(std::string_view name) const;
 };
 
 class WebClient;
@@ -96,6 +99,8 @@ class WebExecutor : public Intrusive::List<WebExecutor>::Node {
     virtual bool execute(WebClient* client, RequestData&) = 0;
     std::multimap<std::string, std::optional<std::string>> parseQuery(std::string_view);
     void write200(WebClient* client, const nlohmann::json& j);
+    // Answers 304 Not Modified, and returns true, if the request's If-None-Match has this entity tag.
+    bool writeNotModified(WebClient* client, const RequestData& request, std::string_view etag);
 };
 
 class WebClient : public Intrusive::List<WebClient>::Node {
@@ -105,6 +110,8 @@ class WebClient : public Intrusive::List<WebClient>::Node {
     void close();
     bool accept(uv_tcp_t* srv);
     void write(Slice&& slice);
+    // Sends a multi-part response as a single scatter/gather write, without copying the parts together.
+    void write(SliceChain&& slices);
     template <size_t L>
     void write(const char (&str)[L]) {
         static_assert((L - 1) <= std::numeric_limits<uint32_t>::max());
@@ -114,10 +121,25 @@ class WebClient : public Intrusive::List<WebClient>::Node {
     }
     void write(std::string&& str);
     void write(const std::string& str);
+    // Lets an executor write its response after execute() returned. The response is sent once
+    // completeResponse() is called, and the requests pipelined behind it wait until then. Responses which
+    // declare a Transfer-Encoding are streamed as they're written instead, and the connection closes once
+    // they're complete. Hold on to lifetime() to know if the client went away in the meantime.
+    void deferResponse();
+    void completeResponse();
+    std::weak_ptr<void> lifetime() { return m_lifetime; }
+    // How many bytes were handed to write() and haven't been sent out yet, for streaming executors to
+    // notice a client falling behind.
+    size_t pendingBytes() const;
+    // Takes the connection over from HTTP, once the executor wrote its 101 response. From then on, all the
+    // data received, starting with whatever came right after the request, goes to the handler.
+    using UpgradeHandler = std::function<void(const Slice&)>;
+    void upgrade(UpgradeHandler&& handler);
 
   private:
     struct WebClientImpl;
     std::unique_ptr<WebClientImpl> m_impl;
+    std::shared_ptr<void> m_lifetime = std::make_shared<bool>();
     friend WebServer;
 };
 
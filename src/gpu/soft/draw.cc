@@ -17,6 +17,7 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
+#include <algorithm>
 #include <cstdint>
 
 #include "GL/gl3w.h"
@@ -36,11 +37,26 @@ void PCSX::SoftGPU::impl::doBufferSwap(bool fromGui) {
         auto offset = (m_softDisplay.DisplayPosition.x * 2) % 3;
         textureID = m_vramTexture24;
         glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 682, 512, GL_RGB, GL_UNSIGNED_BYTE, m_vram + offset);
+        if (offset != m_texture24Offset) {
+            m_texture24Offset = offset;
+            m_texture24Dirty.markAll();
+        }
+        // RGB888 rows can't be sliced at VRAM word boundaries, so we upload whole rows covering the dirty
+        // tiles. The rectangles come sorted by their top row, so skipping what was already sent is enough
+        // to avoid uploading any row twice.
+        int uploaded = 0;
+        m_texture24Dirty.forEachRect([this, offset, &uploaded](int, int y, int, int h) {
+            const int start = std::max(y, uploaded);
+            if (start < y + h) {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, start, 682, y + h - start, GL_RGB, GL_UNSIGNED_BYTE,
+                                m_vram + offset + start * 2048);
+            }
+            uploaded = std::max(uploaded, y + h);
+        });
+        m_texture24Dirty.clear();
     } else {
         textureID = m_vramTexture16;
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1024, 512, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, m_vram16);
+        uploadTexture16();
     }
 
     float xRatio = m_softDisplay.RGB24 ? ((1.0f / 1.5f) * (1.0f / 1024.0f)) : (1.0f / 1024.0f);
@@ -64,12 +80,35 @@ void PCSX::SoftGPU::impl::doBufferSwap(bool fromGui) {
 void PCSX::SoftGPU::impl::clearVRAM() {
     GUI *gui = dynamic_cast<GUI *>(m_ui);
     if (!gui) return;
-    const auto oldTex = OpenGL::getTex2D();
+    syncCommands();
+    m_rasterizerPool.sync();
     std::memset(m_allocatedVRAM, 0x00, (GPU_HEIGHT * 2) * 1024 + (1024 * 1024));
+    markAllVRAMDirty();
+}
 
+// Binds the 16 bits texture, and brings the parts of it that changed up to date
+void PCSX::SoftGPU::impl::uploadTexture16() {
     glBindTexture(GL_TEXTURE_2D, m_vramTexture16);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1024, 512, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, m_allocatedVRAM);
+    if (m_texture16Dirty.empty()) return;
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 1024);
+    m_texture16Dirty.forEachRect([this](int x, int y, int w, int h) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV,
+                        m_vram16 + y * 1024 + x);
+    });
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    m_texture16Dirty.clear();
+}
+
+// The VRAM viewers sample this directly, so it needs to be current even when the display isn't in 16 bits mode
+GLuint PCSX::SoftGPU::impl::getVRAMTexture() {
+    GUI *gui = dynamic_cast<GUI *>(m_ui);
+    if (!gui) return m_vramTexture16;
+    syncCommands();
+    m_rasterizerPool.sync();
+    const auto oldTex = OpenGL::getTex2D();
+    uploadTexture16();
     glBindTexture(GL_TEXTURE_2D, oldTex);
+    return m_vramTexture16;
 }
 
 void PCSX::SoftGPU::impl::setLinearFiltering() {
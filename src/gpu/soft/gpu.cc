@@ -19,6 +19,9 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
 
 #include "core/debug.h"
 #include "core/psxemulator.h"
@@ -72,14 +75,57 @@ int32_t PCSX::SoftGPU::impl::initBackend(UI *ui) {
     m_statusRet |= GPUSTATUS_IDLE;
     m_statusRet |= GPUSTATUS_READYFORCOMMANDS;
 
+    addVRAMTracker(&m_texture16Dirty);
+    addVRAMTracker(&m_texture24Dirty);
+
+    startRasterizerPool();
+    if (g_emulator->settings.get<Emulator::SettingGPUCommandThread>()) startCommandThread();
+
     return 0;
 }
 
 int32_t PCSX::SoftGPU::impl::shutdown() {
+    stopCommandThread();
+    m_rasterizerPool.stop();
+    disableCachedDithering();
     delete[] m_allocatedVRAM;
     return 0;
 }
 
+void PCSX::SoftGPU::impl::startRasterizerPool() {
+    syncCommands();
+    const int threads = g_emulator->settings.get<Emulator::SettingSoftGPUThreads>();
+    if (threads > 0) {
+        m_rasterizerPool.start(threads);
+        m_rasterizerPool.setDrawingArea(m_drawY, m_drawH);
+    } else {
+        m_rasterizerPool.stop();
+    }
+}
+
+// Textured primitives can read from the rows other workers are drawing to. This doesn't happen often,
+// so these get drawn on the emulation thread after the workers are done instead.
+bool PCSX::SoftGPU::impl::textureOverlapsDrawingArea(int clutY) {
+    const int textureTop = m_globalTextAddrY;
+    const int textureBottom = std::min(m_globalTextAddrY + 255, GPU_HEIGHT - 1);
+    if ((textureBottom >= m_drawY) && (textureTop <= m_drawH)) return true;
+    if (m_globalTextTP != GPU::TexDepth::Tex16Bits) {
+        if ((clutY >= m_drawY) && (clutY <= m_drawH)) return true;
+    }
+    return false;
+}
+
+// Marks the bounding box of a primitive as dirty, clipped to the drawing area. Coordinates are before the
+// drawing offset gets applied.
+void PCSX::SoftGPU::impl::markDrawn(int left, int top, int right, int bottom) {
+    left = std::max(left + m_softDisplay.DrawOffset.x, m_drawX);
+    right = std::min(right + m_softDisplay.DrawOffset.x, m_drawW);
+    top = std::max(top + m_softDisplay.DrawOffset.y, m_drawY);
+    bottom = std::min(bottom + m_softDisplay.DrawOffset.y, m_drawH);
+    if ((left > right) || (top > bottom)) return;
+    markVRAMDirty(left, top, right - left + 1, bottom - top + 1);
+}
+
 std::unique_ptr<PCSX::GPU> PCSX::GPU::getSoft() { return std::unique_ptr<PCSX::GPU>(new PCSX::SoftGPU::impl()); }
 
 void PCSX::SoftGPU::impl::updateDisplay(bool fromGui) {
@@ -210,6 +256,8 @@ void PCSX::SoftGPU::impl::updateDisplayIfChanged() {
 }
 
 void PCSX::SoftGPU::impl::vblank(bool fromGui) {
+    syncCommands();
+    m_rasterizerPool.sync();
     m_statusRet ^= 0x80000000;  // odd/even bit
 
     if (m_softDisplay.Interlaced) {
@@ -258,6 +306,31 @@ bool PCSX::SoftGPU::impl::configure() {
             setLinearFiltering();
         }
 
+        auto &threads = g_emulator->settings.get<Emulator::SettingSoftGPUThreads>().value;
+        const int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        if (ImGui::SliderInt(_("Rasterizer threads"), &threads, 0, maxThreads)) {
+            changed = true;
+            startRasterizerPool();
+        }
+        ImGuiHelpers::ShowHelpMarker(
+            _("Number of worker threads drawing primitives. Each thread draws a horizontal slice of the drawing "
+              "area. 0 draws everything on the emulation thread."));
+
+        auto &commandThread = g_emulator->settings.get<Emulator::SettingGPUCommandThread>().value;
+        if (ImGui::Checkbox(_("Process GPU commands on a separate thread"), &commandThread)) {
+            changed = true;
+            if (commandThread) {
+                startCommandThread();
+            } else {
+                stopCommandThread();
+            }
+        }
+        ImGuiHelpers::ShowHelpMarker(
+            _("Parses and draws the GPU commands on a worker thread, while the emulation carries on. The emulation "
+              "waits for the worker whenever it reads back from the GPU, so games polling the GPU status a lot "
+              "will not benefit from it. Commands are processed on the emulation thread while the GPU logger is "
+              "enabled."));
+
         ImGui::Checkbox(_("Disable textures for polygons"), &m_disableTexturesInPolygons);
         ImGui::Checkbox(_("Disable textures for sprites"), &m_disableTexturesInRectangles);
 
@@ -286,6 +359,7 @@ static constexpr inline uint16_t BGR24to16(PCSX::GPU::EmptyColor) { return 0; }
 void PCSX::SoftGPU::impl::write0(ClearCache *) {}
 
 void PCSX::SoftGPU::impl::write0(FastFill *prim) {
+    m_rasterizerPool.sync();
     int16_t sX = prim->x;
     int16_t sY = prim->y;
     int16_t sW = prim->w;
@@ -303,19 +377,20 @@ void PCSX::SoftGPU::impl::write0(FastFill *prim) {
 
     fillSoftwareArea(sX, sY, sW, sH, BGR24to16(prim->color));
 
+    markVRAMDirty(sX, sY, sW - sX, sH - sY);
     m_doVSyncUpdate = true;
 }
 
 template <PCSX::GPU::Shading shading, PCSX::GPU::Shape shape, PCSX::GPU::Textured textured, PCSX::GPU::Blend blend,
           PCSX::GPU::Modulation modulation>
-void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulation> *prim) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly(GPU::Poly<shading, shape, textured, blend, modulation> *prim) {
     m_x0 = prim->x[0];
     m_y0 = prim->y[0];
     m_x1 = prim->x[1];
     m_y1 = prim->y[1];
     m_x2 = prim->x[2];
     m_y2 = prim->y[2];
-    if constexpr (shape == Shape::Quad) {
+    if constexpr (shape == GPU::Shape::Quad) {
         m_x3 = prim->x[3];
         m_y3 = prim->y[3];
         if (checkCoord4()) return;
@@ -325,9 +400,9 @@ void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulat
         applyOffset3();
     }
 
-    m_drawSemiTrans = blend == Blend::Semi;
+    m_drawSemiTrans = blend == GPU::Blend::Semi;
 
-    if constexpr (modulation == Modulation::On) {
+    if constexpr (modulation == GPU::Modulation::On) {
         m_m1 = (prim->colors[0] >> 0) & 0xff;
         m_m2 = (prim->colors[0] >> 8) & 0xff;
         m_m3 = (prim->colors[0] >> 16) & 0xff;
@@ -335,15 +410,15 @@ void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulat
         m_m1 = m_m2 = m_m3 = 128;
     }
 
-    if constexpr (shading == Shading::Flat) {
-        if ((textured == Textured::Yes) && !m_disableTexturesInPolygons) {
-            if constexpr (textured == Textured::Yes) {
+    if constexpr (shading == GPU::Shading::Flat) {
+        if ((textured == GPU::Textured::Yes) && !m_disableTexturesInPolygons) {
+            if constexpr (textured == GPU::Textured::Yes) {
                 if (m_ditherMode) {
                     prim->tpage.dither = true;
                     prim->tpage.raw |= 0x200;
                 }
                 texturePage(&prim->tpage);
-                if constexpr (shape == Shape::Quad) {
+                if constexpr (shape == GPU::Shape::Quad) {
                     switch (m_globalTextTP) {
                         case GPU::TexDepth::Tex4Bits:
                             drawPoly4TEx4(m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0], prim->v[0],
@@ -378,21 +453,21 @@ void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulat
                 }
             }
         } else {
-            if constexpr (shape == Shape::Quad) {
+            if constexpr (shape == GPU::Shape::Quad) {
                 drawPolyFlat4(prim->colors[0]);
             } else {
                 drawPolyFlat3(prim->colors[0]);
             }
         }
     } else {
-        if ((textured == Textured::Yes) && !m_disableTexturesInPolygons) {
-            if constexpr (textured == Textured::Yes) {
+        if ((textured == GPU::Textured::Yes) && !m_disableTexturesInPolygons) {
+            if constexpr (textured == GPU::Textured::Yes) {
                 if (m_ditherMode) {
                     prim->tpage.dither = true;
                     prim->tpage.raw |= 0x200;
                 }
                 texturePage(&prim->tpage);
-                if constexpr (shape == Shape::Quad) {
+                if constexpr (shape == GPU::Shape::Quad) {
                     switch (m_globalTextTP) {
                         case GPU::TexDepth::Tex4Bits:
                             drawPoly4TGEx4(m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0], prim->v[0],
@@ -433,14 +508,13 @@ void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulat
                 }
             }
         } else {
-            if constexpr (shape == Shape::Quad) {
+            if constexpr (shape == GPU::Shape::Quad) {
                 drawPolyShade4(prim->colors[0], prim->colors[1], prim->colors[2], prim->colors[3]);
             } else {
                 drawPolyShade3(prim->colors[0], prim->colors[1], prim->colors[2]);
             }
         }
     }
-    m_doVSyncUpdate = true;
 }
 
 static constexpr int CHKMAX_X = 1024;
@@ -464,10 +538,10 @@ static constexpr inline bool CheckCoordL(int16_t slx0, int16_t sly0, int16_t slx
 }
 
 template <PCSX::GPU::Shading shading, PCSX::GPU::LineType lineType, PCSX::GPU::Blend blend>
-void PCSX::SoftGPU::impl::lineExec(Line<shading, lineType, blend> *prim) {
+void PCSX::SoftGPU::SoftRenderer::drawLine(GPU::Line<shading, lineType, blend> *prim) {
     auto count = prim->colors.size();
 
-    m_drawSemiTrans = blend == Blend::Semi;
+    m_drawSemiTrans = blend == GPU::Blend::Semi;
 
     for (unsigned i = 1; i < count; i++) {
         auto x0 = prim->x[i - 1];
@@ -484,36 +558,35 @@ void PCSX::SoftGPU::impl::lineExec(Line<shading, lineType, blend> *prim) {
         m_x1 = x1;
 
         applyOffset2();
-        if constexpr (shading == Shading::Gouraud) {
+        if constexpr (shading == GPU::Shading::Gouraud) {
             drawSoftwareLineShade(c0, c1);
         } else {
             drawSoftwareLineFlat(c0);
         }
     }
-    m_doVSyncUpdate = true;
 }
 
 template <PCSX::GPU::Size size, PCSX::GPU::Textured textured, PCSX::GPU::Blend blend, PCSX::GPU::Modulation modulation>
-void PCSX::SoftGPU::impl::rectExec(Rect<size, textured, blend, modulation> *prim) {
+void PCSX::SoftGPU::SoftRenderer::drawRect(GPU::Rect<size, textured, blend, modulation> *prim) {
     int16_t w, h;
 
     m_x0 = prim->x;
     m_y0 = prim->y;
 
-    if constexpr (size == Size::Variable) {
+    if constexpr (size == GPU::Size::Variable) {
         w = prim->w;
         h = prim->h;
-    } else if constexpr (size == Size::S1) {
+    } else if constexpr (size == GPU::Size::S1) {
         w = h = 1;
-    } else if constexpr (size == Size::S8) {
+    } else if constexpr (size == GPU::Size::S8) {
         w = h = 8;
-    } else if constexpr (size == Size::S16) {
+    } else if constexpr (size == GPU::Size::S16) {
         w = h = 16;
     }
 
-    m_drawSemiTrans = blend == Blend::Semi;
+    m_drawSemiTrans = blend == GPU::Blend::Semi;
 
-    if constexpr (modulation == Modulation::On) {
+    if constexpr (modulation == GPU::Modulation::On) {
         m_m1 = (prim->color >> 0) & 0xff;
         m_m2 = (prim->color >> 8) & 0xff;
         m_m3 = (prim->color >> 16) & 0xff;
@@ -526,8 +599,8 @@ void PCSX::SoftGPU::impl::rectExec(Rect<size, textured, blend, modulation> *prim
     m_y2 = m_y3 = m_y0 + h + m_softDisplay.DrawOffset.y;
     m_y0 = m_y1 = m_y0 + m_softDisplay.DrawOffset.y;
 
-    if ((textured == Textured::Yes) && !m_disableTexturesInRectangles) {
-        if constexpr (textured == Textured::Yes) {
+    if ((textured == GPU::Textured::Yes) && !m_disableTexturesInRectangles) {
+        if constexpr (textured == GPU::Textured::Yes) {
             int16_t tx0, ty0, tx1, ty1, tx2, ty2, tx3, ty3;
             tx0 = tx3 = prim->u;
             tx1 = tx2 = tx0 + w;
@@ -552,11 +625,145 @@ void PCSX::SoftGPU::impl::rectExec(Rect<size, textured, blend, modulation> *prim
     } else {
         fillSoftwareAreaTrans(m_x0, m_y0, m_x2, m_y2, BGR24to16(prim->color));
     }
+}
+
+template <PCSX::GPU::Shading shading, PCSX::GPU::Shape shape, PCSX::GPU::Textured textured, PCSX::GPU::Blend blend,
+          PCSX::GPU::Modulation modulation>
+void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulation> *prim) {
+    m_doVSyncUpdate = true;
+    {
+        int left = std::numeric_limits<int>::max(), right = std::numeric_limits<int>::min();
+        int top = std::numeric_limits<int>::max(), bottom = std::numeric_limits<int>::min();
+        for (unsigned i = 0; i < prim->count; i++) {
+            const int16_t x = static_cast<int16_t>(prim->x[i]);
+            const int16_t y = static_cast<int16_t>(prim->y[i]);
+            left = std::min<int>(left, x);
+            right = std::max<int>(right, x);
+            top = std::min<int>(top, y);
+            bottom = std::max<int>(bottom, y);
+        }
+        markDrawn(left, top, right, bottom);
+    }
+    if (!m_rasterizerPool.isRunning()) {
+        drawPoly(prim);
+        return;
+    }
+
+    const SoftRenderer state = *this;
+    if constexpr (textured == Textured::Yes) {
+        if (!m_disableTexturesInPolygons) {
+            // The texture page set by the primitive sticks around for the next ones
+            if (m_ditherMode) {
+                prim->tpage.dither = true;
+                prim->tpage.raw |= 0x200;
+            }
+            texturePage(&prim->tpage);
+
+            if (textureOverlapsDrawingArea(prim->clutY())) {
+                m_rasterizerPool.sync();
+                static_cast<SoftRenderer &>(*this) = state;
+                drawPoly(prim);
+                return;
+            }
+        }
+    }
+
+    int top = std::numeric_limits<int>::max();
+    int bottom = std::numeric_limits<int>::min();
+    for (unsigned i = 0; i < prim->count; i++) {
+        const int16_t y = static_cast<int16_t>(prim->y[i]) + m_softDisplay.DrawOffset.y;
+        top = std::min<int>(top, y);
+        bottom = std::max<int>(bottom, y);
+    }
 
+    // Every worker needs its own copy, as drawing can modify the primitive
+    auto copy = std::make_shared<const Poly<shading, shape, textured, blend, modulation>>(*prim);
+    m_rasterizerPool.submit(state, top, bottom, [copy](SoftRenderer &renderer) {
+        auto primitive = *copy;
+        renderer.drawPoly(&primitive);
+    });
+}
+
+template <PCSX::GPU::Shading shading, PCSX::GPU::LineType lineType, PCSX::GPU::Blend blend>
+void PCSX::SoftGPU::impl::lineExec(Line<shading, lineType, blend> *prim) {
     m_doVSyncUpdate = true;
+    {
+        int left = std::numeric_limits<int>::max(), right = std::numeric_limits<int>::min();
+        int top = std::numeric_limits<int>::max(), bottom = std::numeric_limits<int>::min();
+        for (unsigned i = 0; i < prim->colors.size(); i++) {
+            const int16_t x = static_cast<int16_t>(prim->x[i]);
+            const int16_t y = static_cast<int16_t>(prim->y[i]);
+            left = std::min<int>(left, x);
+            right = std::max<int>(right, x);
+            top = std::min<int>(top, y);
+            bottom = std::max<int>(bottom, y);
+        }
+        markDrawn(left, top, right, bottom);
+    }
+    if (!m_rasterizerPool.isRunning()) {
+        drawLine(prim);
+        return;
+    }
+
+    int top = std::numeric_limits<int>::max();
+    int bottom = std::numeric_limits<int>::min();
+    for (unsigned i = 0; i < prim->colors.size(); i++) {
+        const int16_t y = static_cast<int16_t>(prim->y[i]) + m_softDisplay.DrawOffset.y;
+        top = std::min<int>(top, y);
+        bottom = std::max<int>(bottom, y);
+    }
+
+    // Every worker needs its own copy, as drawing can modify the primitive
+    auto copy = std::make_shared<const Line<shading, lineType, blend>>(*prim);
+    m_rasterizerPool.submit(*this, top, bottom, [copy](SoftRenderer &renderer) {
+        auto primitive = *copy;
+        renderer.drawLine(&primitive);
+    });
+}
+
+template <PCSX::GPU::Size size, PCSX::GPU::Textured textured, PCSX::GPU::Blend blend, PCSX::GPU::Modulation modulation>
+void PCSX::SoftGPU::impl::rectExec(Rect<size, textured, blend, modulation> *prim) {
+    m_doVSyncUpdate = true;
+    int16_t w, h;
+    if constexpr (size == Size::Variable) {
+        w = prim->w;
+        h = prim->h;
+    } else if constexpr (size == Size::S1) {
+        w = h = 1;
+    } else if constexpr (size == Size::S8) {
+        w = h = 8;
+    } else if constexpr (size == Size::S16) {
+        w = h = 16;
+    }
+    const int16_t x = static_cast<int16_t>(prim->x);
+    const int16_t y = static_cast<int16_t>(prim->y);
+    markDrawn(x, y, x + w - 1, y + h - 1);
+    if (!m_rasterizerPool.isRunning()) {
+        drawRect(prim);
+        return;
+    }
+
+    if constexpr (textured == Textured::Yes) {
+        if (!m_disableTexturesInRectangles && textureOverlapsDrawingArea(prim->clutY())) {
+            m_rasterizerPool.sync();
+            drawRect(prim);
+            return;
+        }
+    }
+
+    const int16_t top = static_cast<int16_t>(prim->y) + m_softDisplay.DrawOffset.y;
+    const int16_t bottom = static_cast<int16_t>(prim->y) + h + m_softDisplay.DrawOffset.y;
+
+    // Every worker needs its own copy, as drawing can modify the primitive
+    auto copy = std::make_shared<const Rect<size, textured, blend, modulation>>(*prim);
+    m_rasterizerPool.submit(*this, std::min(top, bottom), std::max(top, bottom), [copy](SoftRenderer &renderer) {
+        auto primitive = *copy;
+        renderer.drawRect(&primitive);
+    });
 }
 
 void PCSX::SoftGPU::impl::write0(BlitVramVram *prim) {
+    m_rasterizerPool.sync();
     int16_t imageY0, imageX0, imageY1, imageX1, imageSX, imageSY, i, j;
 
     imageX0 = prim->sX;
@@ -569,6 +776,7 @@ void PCSX::SoftGPU::impl::write0(BlitVramVram *prim) {
     if ((imageX0 == imageX1) && (imageY0 == imageY1)) return;
     if (imageSX <= 0) return;
     if (imageSY <= 0) return;
+    markVRAMDirty(imageX1, imageY1, imageSX, imageSY);
 
     if ((imageY0 + imageSY) > GPU_HEIGHT || (imageX0 + imageSX) > 1024 || (imageY1 + imageSY) > GPU_HEIGHT ||
         (imageX1 + imageSX) > 1024) {
@@ -626,12 +834,20 @@ void PCSX::SoftGPU::impl::write0(BlitVramVram *prim) {
 
 void PCSX::SoftGPU::impl::write0(TPage *prim) { texturePage(prim); }
 void PCSX::SoftGPU::impl::write0(TWindow *prim) { twindow(prim); }
-void PCSX::SoftGPU::impl::write0(DrawingAreaStart *prim) { drawingAreaStart(prim); }
-void PCSX::SoftGPU::impl::write0(DrawingAreaEnd *prim) { drawingAreaEnd(prim); }
+void PCSX::SoftGPU::impl::write0(DrawingAreaStart *prim) {
+    drawingAreaStart(prim);
+    m_rasterizerPool.setDrawingArea(m_drawY, m_drawH);
+}
+void PCSX::SoftGPU::impl::write0(DrawingAreaEnd *prim) {
+    drawingAreaEnd(prim);
+    m_rasterizerPool.setDrawingArea(m_drawY, m_drawH);
+}
 void PCSX::SoftGPU::impl::write0(DrawingOffset *prim) { drawingOffset(prim); }
 void PCSX::SoftGPU::impl::write0(MaskBit *prim) { maskBit(prim); }
 
 PCSX::GPU::ScreenShot PCSX::SoftGPU::impl::takeScreenShot() {
+    syncCommands();
+    m_rasterizerPool.sync();
     ScreenShot ss;
     auto startX = m_softDisplay.DisplayPosition.x;
     auto startY = m_softDisplay.DisplayPosition.y;
@@ -670,6 +886,7 @@ void PCSX::SoftGPU::impl::write1(CtrlReset *) {
     m_softDisplay.Disabled = 1;
     m_softDisplay.DrawOffset.x = m_softDisplay.DrawOffset.y = 0;
     resetRenderer();
+    m_rasterizerPool.setDrawingArea(m_drawY, m_drawH);
     acknowledgeIRQ1();
     m_softDisplay.RGB24 = false;
     m_softDisplay.Interlaced = false;
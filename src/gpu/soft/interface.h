@@ -20,6 +20,7 @@
 #pragma once
 
 #include "core/gpu.h"
+#include "gpu/soft/pool.h"
 #include "gpu/soft/soft.h"
 
 namespace PCSX {
@@ -42,9 +43,11 @@ class impl final : public GPU, public SoftRenderer {
         clearVRAM();
         m_display.reset();
     }
-    GLuint getVRAMTexture() override { return m_vramTexture16; }
+    GLuint getVRAMTexture() override;
     void setLinearFiltering() override;
     void setCachedDithering(bool value) override {
+        syncCommands();
+        m_rasterizerPool.sync();
         if (value) {
             enableCachedDithering();
         } else {
@@ -53,6 +56,7 @@ class impl final : public GPU, public SoftRenderer {
     }
 
     void restoreStatus(uint32_t status) override;
+    bool supportsCommandThread() override { return true; }
 
     void updateDisplay(bool fromGui);
     void initDisplay();
@@ -63,6 +67,8 @@ class impl final : public GPU, public SoftRenderer {
     void updateDisplayIfChanged();
 
     Slice getVRAM(Ownership ownership) override {
+        syncCommands();
+        m_rasterizerPool.sync();
         Slice ret;
         if (ownership == Ownership::BORROW) {
             ret.borrow(m_vram16, 1024 * 512 * 2);
@@ -73,6 +79,8 @@ class impl final : public GPU, public SoftRenderer {
     }
 
     void partialUpdateVRAM(int x, int y, int w, int h, const uint16_t *pixels, PartialUpdateVram) override {
+        syncCommands();
+        m_rasterizerPool.sync();
         auto ptr = m_vram16;
         ptr += y * 1024 + x;
         for (int i = 0; i < h; i++) {
@@ -80,15 +88,27 @@ class impl final : public GPU, public SoftRenderer {
             ptr += 1024;
             pixels += w;
         }
+        markVRAMDirty(x, y, w, h);
     }
 
     virtual ScreenShot takeScreenShot() override;
 
     GLuint m_vramTexture16;
     GLuint m_vramTexture24;
+    // What changed in VRAM since each texture was last uploaded. The 24 bits texture also depends on where
+    // the display starts, as its pixels don't line up with VRAM words.
+    VRAMDirtyTiles m_texture16Dirty;
+    VRAMDirtyTiles m_texture24Dirty;
+    int m_texture24Offset = -1;
+    void uploadTexture16();
+    void markDrawn(int left, int top, int right, int bottom);
 
     UI *m_ui;
 
+    RasterizerPool m_rasterizerPool;
+    void startRasterizerPool();
+    bool textureOverlapsDrawingArea(int clutY);
+
     bool m_doVSyncUpdate = false;
     SoftDisplay m_previousDisplay;
     unsigned char *m_allocatedVRAM;
@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "gpu/soft/pool.h"
+
+#include <algorithm>
+
+#include "core/psxemulator.h"
+
+void PCSX::SoftGPU::RasterizerPool::start(unsigned count) {
+    stop();
+    for (unsigned i = 0; i < count; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->thread = std::thread([w = worker.get(), emulator = g_emulator, system = g_system]() {
+            Emulator::Scope scope(emulator, system);
+            w->run();
+        });
+        m_workers.push_back(std::move(worker));
+    }
+}
+
+void PCSX::SoftGPU::RasterizerPool::stop() {
+    for (auto &worker : m_workers) {
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->exit = true;
+        }
+        worker->workAvailable.notify_one();
+        worker->thread.join();
+    }
+    m_workers.clear();
+}
+
+void PCSX::SoftGPU::RasterizerPool::sync() {
+    for (auto &worker : m_workers) {
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        worker->idle.wait(lock, [w = worker.get()]() { return w->queue.empty(); });
+    }
+}
+
+void PCSX::SoftGPU::RasterizerPool::setDrawingArea(int top, int bottom) {
+    if (!isRunning()) return;
+    // The queued primitives were binned against the old slices
+    sync();
+
+    // The rasterizer doesn't draw anything when the drawing area is a single row, so
+    // the slices need to be at least 2 rows tall to avoid losing rows at their edges.
+    const int count = m_workers.size();
+    const int height = bottom - top + 1;
+    const int slices = std::clamp(height / 2, 1, count);
+
+    for (int i = 0; i < count; i++) {
+        auto &worker = m_workers[i];
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        if (slices == 1) {
+            // Only one slice, so the first worker draws everything without clipping
+            worker->top = i == 0 ? -32768 : 0;
+            worker->bottom = i == 0 ? 32767 : -1;
+        } else if (i < slices) {
+            worker->top = top + height * i / slices;
+            worker->bottom = top + height * (i + 1) / slices - 1;
+        } else {
+            worker->top = 0;
+            worker->bottom = -1;
+        }
+    }
+}
+
+void PCSX::SoftGPU::RasterizerPool::submit(const SoftRenderer &state, int top, int bottom, Draw &&draw) {
+    auto job = std::make_shared<const Job>(Job{state, std::move(draw)});
+
+    for (auto &worker : m_workers) {
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            if (worker->top > worker->bottom) continue;
+            if (bottom < worker->top || top > worker->bottom) continue;
+            worker->queue.push_back(job);
+        }
+        worker->workAvailable.notify_one();
+    }
+}
+
+void PCSX::SoftGPU::RasterizerPool::Worker::run() {
+    while (true) {
+        std::shared_ptr<const Job> job;
+        int sliceTop, sliceBottom;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this]() { return exit || !queue.empty(); });
+            if (queue.empty()) return;
+            // The job stays in the queue until it's drawn, so that sync() waits for it
+            job = queue.front();
+            sliceTop = top;
+            sliceBottom = bottom;
+        }
+
+        renderer = job->state;
+        renderer.m_drawY = std::max<int>(renderer.m_drawY, sliceTop);
+        renderer.m_drawH = std::min<int>(renderer.m_drawH, sliceBottom);
+        job->draw(renderer);
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queue.pop_front();
+            if (queue.empty()) idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gpu/soft/soft.h"
+
+namespace PCSX {
+
+namespace SoftGPU {
+
+// Rasterizes primitives on worker threads. The drawing area is split into horizontal slices, one per worker,
+// and each primitive is queued to the workers whose slice its bounding box touches. Every worker draws its
+// queue in submission order, and no two workers write to the same rows, so the result is the same as drawing
+// everything on the emulation thread. Anything that reads or writes VRAM outside of the primitives needs to
+// call sync() first.
+class RasterizerPool {
+  public:
+    typedef std::function<void(SoftRenderer &)> Draw;
+
+    ~RasterizerPool() { stop(); }
+
+    void start(unsigned count);
+    void stop();
+    bool isRunning() const { return !m_workers.empty(); }
+
+    // Waits for all the workers to be done with their queues
+    void sync();
+    // Needs to be called whenever the drawing area changes, as it changes the slices of the workers
+    void setDrawingArea(int top, int bottom);
+    // Queues a primitive spanning the rows [top, bottom]. The renderer passed to the callback holds a copy of
+    // state, clipped to the worker's slice
+    void submit(const SoftRenderer &state, int top, int bottom, Draw &&draw);
+
+  private:
+    struct Job {
+        SoftRenderer state;
+        Draw draw;
+    };
+
+    struct Worker {
+        void run();
+
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable idle;
+        std::deque<std::shared_ptr<const Job>> queue;
+        bool exit = false;
+        // Slice of the drawing area this worker draws, inclusive
+        int top = 0;
+        int bottom = -1;
+        SoftRenderer renderer;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+};
+
+}  // namespace SoftGPU
+
+}  // namespace PCSX
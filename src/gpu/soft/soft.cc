@@ -320,9 +320,55 @@ void PCSX::SoftGPU::SoftRenderer::disableCachedDithering() {
     s_ditherLUT = nullptr;
 }
 
-PCSX::SoftGPU::SoftRenderer::~SoftRenderer() {
-    if (s_ditherLUT) delete[] s_ditherLUT;
-    s_ditherLUT = nullptr;
+namespace {
+
+template <bool semiTrans, PCSX::GPU::BlendFunction abr, bool checkMask, typename F>
+void dispatchDither(bool dither, bool cached, F &f) {
+    using PCSX::SoftGPU::SoftRenderer;
+    if (!dither) {
+        f(SoftRenderer::PixelState<semiTrans, abr, checkMask, false, false>{});
+    } else if (cached) {
+        f(SoftRenderer::PixelState<semiTrans, abr, checkMask, true, true>{});
+    } else {
+        f(SoftRenderer::PixelState<semiTrans, abr, checkMask, true, false>{});
+    }
+}
+
+template <bool semiTrans, PCSX::GPU::BlendFunction abr, typename F>
+void dispatchCheckMask(bool checkMask, bool dither, bool cached, F &f) {
+    if (checkMask) {
+        dispatchDither<semiTrans, abr, true>(dither, cached, f);
+    } else {
+        dispatchDither<semiTrans, abr, false>(dither, cached, f);
+    }
+}
+
+}  // namespace
+
+template <bool gouraud, typename F>
+void PCSX::SoftGPU::SoftRenderer::dispatchPixelState(F &&f) {
+    const bool dither = gouraud && m_ditherMode;
+    const bool cached = s_ditherLUT != nullptr;
+
+    if (!m_drawSemiTrans) {
+        dispatchCheckMask<false, GPU::BlendFunction::HalfBackAndHalfFront>(m_checkMask, dither, cached, f);
+        return;
+    }
+
+    switch (m_globalTextABR) {
+        case GPU::BlendFunction::HalfBackAndHalfFront:
+            dispatchCheckMask<true, GPU::BlendFunction::HalfBackAndHalfFront>(m_checkMask, dither, cached, f);
+            break;
+        case GPU::BlendFunction::FullBackAndFullFront:
+            dispatchCheckMask<true, GPU::BlendFunction::FullBackAndFullFront>(m_checkMask, dither, cached, f);
+            break;
+        case GPU::BlendFunction::FullBackSubFullFront:
+            dispatchCheckMask<true, GPU::BlendFunction::FullBackSubFullFront>(m_checkMask, dither, cached, f);
+            break;
+        case GPU::BlendFunction::FullBackAndQuarterFront:
+            dispatchCheckMask<true, GPU::BlendFunction::FullBackAndQuarterFront>(m_checkMask, dither, cached, f);
+            break;
+    }
 }
 
 static void applyDitherCached(uint16_t *pdest, uint16_t *base, uint32_t r, uint32_t g, uint32_t b, uint16_t sM) {
@@ -373,26 +419,26 @@ static void applyDither(uint16_t *pdest, uint16_t *base, uint32_t r, uint32_t g,
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 
-template <bool useCachedDither>
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::getShadeTransColDither(uint16_t *pdest, int32_t m1, int32_t m2, int32_t m3) {
     int32_t r, g, b;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (State::checkMask && *pdest & 0x8000) return;
 
-    if (m_drawSemiTrans) {
+    if (State::semiTrans) {
         r = ((XCOL1D(*pdest)) << 3);
         b = ((XCOL2D(*pdest)) << 3);
         g = ((XCOL3D(*pdest)) << 3);
 
-        if (m_globalTextABR == GPU::BlendFunction::HalfBackAndHalfFront) {
+        if constexpr (State::abr == GPU::BlendFunction::HalfBackAndHalfFront) {
             r = (r >> 1) + (m1 >> 1);
             b = (b >> 1) + (m2 >> 1);
             g = (g >> 1) + (m3 >> 1);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackAndFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackAndFullFront) {
             r += m1;
             b += m2;
             g += m3;
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackSubFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackSubFullFront) {
             r -= m1;
             b -= m2;
             g -= m3;
@@ -414,7 +460,7 @@ void PCSX::SoftGPU::SoftRenderer::getShadeTransColDither(uint16_t *pdest, int32_
     if (b & 0x7fffff00) b = 0xff;
     if (g & 0x7fffff00) g = 0xff;
 
-    if constexpr (useCachedDither) {
+    if constexpr (State::cachedDither) {
         applyDitherCached(pdest, m_vram16, r, b, g, m_setMask16);
     } else {
         applyDither(pdest, m_vram16, r, b, g, m_setMask16);
@@ -461,106 +507,30 @@ void PCSX::SoftGPU::SoftRenderer::getShadeTransCol(uint16_t *pdest, uint16_t col
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::getShadeTransCol32(uint32_t *pdest, uint32_t color) {
-    if (m_drawSemiTrans) {
-        int32_t r, g, b;
-
-        if (m_globalTextABR == GPU::BlendFunction::HalfBackAndHalfFront) {
-            if (!m_checkMask) {
-                *pdest = ((((*pdest) & 0x7bde7bde) >> 1) + ((color & 0x7bde7bde) >> 1)) | m_setMask32;  // 0x80008000;
-                return;
-            }
-            r = (X32ACOL1(*pdest) >> 1) + ((X32ACOL1(color)) >> 1);
-            b = (X32ACOL2(*pdest) >> 1) + ((X32ACOL2(color)) >> 1);
-            g = (X32ACOL3(*pdest) >> 1) + ((X32ACOL3(color)) >> 1);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackAndFullFront) {
-            r = (X32COL1(*pdest)) + ((X32COL1(color)));
-            b = (X32COL2(*pdest)) + ((X32COL2(color)));
-            g = (X32COL3(*pdest)) + ((X32COL3(color)));
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackSubFullFront) {
-            int32_t sr, sb, sg, src, sbc, sgc, c;
-            src = XCOL1(color);
-            sbc = XCOL2(color);
-            sgc = XCOL3(color);
-            c = (*pdest) >> 16;
-            sr = (XCOL1(c)) - src;
-            if (sr & 0x8000) sr = 0;
-            sb = (XCOL2(c)) - sbc;
-            if (sb & 0x8000) sb = 0;
-            sg = (XCOL3(c)) - sgc;
-            if (sg & 0x8000) sg = 0;
-            r = ((int32_t)sr) << 16;
-            b = ((int32_t)sb) << 11;
-            g = ((int32_t)sg) << 6;
-            c = (*pdest) & 0xffff;
-            sr = (XCOL1(c)) - src;
-            if (sr & 0x8000) sr = 0;
-            sb = (XCOL2(c)) - sbc;
-            if (sb & 0x8000) sb = 0;
-            sg = (XCOL3(c)) - sgc;
-            if (sg & 0x8000) sg = 0;
-            r |= sr;
-            b |= sb >> 5;
-            g |= sg >> 10;
-        } else {
-            r = (X32COL1(*pdest)) + ((X32BCOL1(color)) >> 2);
-            b = (X32COL2(*pdest)) + ((X32BCOL2(color)) >> 2);
-            g = (X32COL3(*pdest)) + ((X32BCOL3(color)) >> 2);
-        }
-
-        if (r & 0x7fe00000) r = 0x1f0000 | (r & 0xffff);
-        if (r & 0x7fe0) r = 0x1f | (r & 0xffff0000);
-        if (b & 0x7fe00000) b = 0x1f0000 | (b & 0xffff);
-        if (b & 0x7fe0) b = 0x1f | (b & 0xffff0000);
-        if (g & 0x7fe00000) g = 0x1f0000 | (g & 0xffff);
-        if (g & 0x7fe0) g = 0x1f | (g & 0xffff0000);
-
-        if (m_checkMask) {
-            uint32_t ma = *pdest;
-            *pdest = (X32PSXCOL(r, g, b)) | m_setMask32;  // 0x80008000;
-            if (ma & 0x80000000) *pdest = (ma & 0xffff0000) | (*pdest & 0xffff);
-            if (ma & 0x00008000) *pdest = (ma & 0xffff) | (*pdest & 0xffff0000);
-            return;
-        }
-        *pdest = (X32PSXCOL(r, g, b)) | m_setMask32;  // 0x80008000;
-    } else {
-        if (m_checkMask) {
-            uint32_t ma = *pdest;
-            *pdest = color | m_setMask32;  // 0x80008000;
-            if (ma & 0x80000000) *pdest = (ma & 0xffff0000) | (*pdest & 0xffff);
-            if (ma & 0x00008000) *pdest = (ma & 0xffff) | (*pdest & 0xffff0000);
-            return;
-        }
-
-        *pdest = color | m_setMask32;  // 0x80008000;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////
-
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::getTextureTransColShade(uint16_t *pdest, uint16_t color) {
     int32_t r, g, b;
     uint16_t l;
 
     if (color == 0) return;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (State::checkMask && *pdest & 0x8000) return;
 
     l = m_setMask16 | (color & 0x8000);
 
-    if (m_drawSemiTrans && (color & 0x8000)) {
-        if (m_globalTextABR == GPU::BlendFunction::HalfBackAndHalfFront) {
+    if (State::semiTrans && (color & 0x8000)) {
+        if constexpr (State::abr == GPU::BlendFunction::HalfBackAndHalfFront) {
             uint16_t d;
             d = ((*pdest) & 0x7bde) >> 1;
             color = (color & 0x7bde) >> 1;
             r = (XCOL1(d)) + ((((XCOL1(color))) * m_m1) >> 7);
             b = (XCOL2(d)) + ((((XCOL2(color))) * m_m2) >> 7);
             g = (XCOL3(d)) + ((((XCOL3(color))) * m_m3) >> 7);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackAndFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackAndFullFront) {
             r = (XCOL1(*pdest)) + ((((XCOL1(color))) * m_m1) >> 7);
             b = (XCOL2(*pdest)) + ((((XCOL2(color))) * m_m2) >> 7);
             g = (XCOL3(*pdest)) + ((((XCOL3(color))) * m_m3) >> 7);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackSubFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackSubFullFront) {
             r = (XCOL1(*pdest)) - ((((XCOL1(color))) * m_m1) >> 7);
             b = (XCOL2(*pdest)) - ((((XCOL2(color))) * m_m2) >> 7);
             g = (XCOL3(*pdest)) - ((((XCOL3(color))) * m_m3) >> 7);
@@ -608,29 +578,30 @@ inline void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeSolid(uint16_t *
 
 ////////////////////////////////////////////////////////////////////////
 
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeSemi(uint16_t *pdest, uint16_t color) {
     int32_t r, g, b;
     uint16_t l;
 
     if (color == 0) return;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (State::checkMask && *pdest & 0x8000) return;
 
     l = m_setMask16 | (color & 0x8000);
 
-    if (m_drawSemiTrans && (color & 0x8000)) {
-        if (m_globalTextABR == GPU::BlendFunction::HalfBackAndHalfFront) {
+    if (State::semiTrans && (color & 0x8000)) {
+        if constexpr (State::abr == GPU::BlendFunction::HalfBackAndHalfFront) {
             uint16_t d;
             d = ((*pdest) & 0x7bde) >> 1;
             color = (color & 0x7bde) >> 1;
             r = (XCOL1(d)) + ((((XCOL1(color))) * m_m1) >> 7);
             b = (XCOL2(d)) + ((((XCOL2(color))) * m_m2) >> 7);
             g = (XCOL3(d)) + ((((XCOL3(color))) * m_m3) >> 7);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackAndFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackAndFullFront) {
             r = (XCOL1(*pdest)) + ((((XCOL1(color))) * m_m1) >> 7);
             b = (XCOL2(*pdest)) + ((((XCOL2(color))) * m_m2) >> 7);
             g = (XCOL3(*pdest)) + ((((XCOL3(color))) * m_m3) >> 7);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackSubFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackSubFullFront) {
             r = (XCOL1(*pdest)) - ((((XCOL1(color))) * m_m1) >> 7);
             b = (XCOL2(*pdest)) - ((((XCOL2(color))) * m_m2) >> 7);
             g = (XCOL3(*pdest)) - ((((XCOL3(color))) * m_m3) >> 7);
@@ -657,6 +628,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeSemi(uint16_t *pdest, u
 
 ////////////////////////////////////////////////////////////////////////
 
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::getTextureTransColShade32(uint32_t *pdest, uint32_t color) {
     int32_t r, g, b, l;
 
@@ -664,16 +636,16 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShade32(uint32_t *pdest, uin
 
     l = m_setMask32 | (color & 0x80008000);
 
-    if (m_drawSemiTrans && (color & 0x80008000)) {
-        if (m_globalTextABR == GPU::BlendFunction::HalfBackAndHalfFront) {
+    if (State::semiTrans && (color & 0x80008000)) {
+        if constexpr (State::abr == GPU::BlendFunction::HalfBackAndHalfFront) {
             r = ((((X32TCOL1(*pdest)) + ((X32COL1(color)) * m_m1)) & 0xff00ff00) >> 8);
             b = ((((X32TCOL2(*pdest)) + ((X32COL2(color)) * m_m2)) & 0xff00ff00) >> 8);
             g = ((((X32TCOL3(*pdest)) + ((X32COL3(color)) * m_m3)) & 0xff00ff00) >> 8);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackAndFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackAndFullFront) {
             r = (X32COL1(*pdest)) + (((((X32COL1(color))) * m_m1) & 0xff80ff80) >> 7);
             b = (X32COL2(*pdest)) + (((((X32COL2(color))) * m_m2) & 0xff80ff80) >> 7);
             g = (X32COL3(*pdest)) + (((((X32COL3(color))) * m_m3) & 0xff80ff80) >> 7);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackSubFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackSubFullFront) {
             int32_t t;
             r = (((((X32COL1(color))) * m_m1) & 0xff80ff80) >> 7);
             t = (*pdest & 0x001f0000) - (r & 0x003f0000);
@@ -725,7 +697,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShade32(uint32_t *pdest, uin
     if (g & 0x7fe00000) g = 0x1f0000 | (g & 0xffff);
     if (g & 0x7fe0) g = 0x1f | (g & 0xffff0000);
 
-    if (m_checkMask) {
+    if constexpr (State::checkMask) {
         uint32_t ma = *pdest;
 
         *pdest = (X32PSXCOL(r, g, b)) | l;
@@ -781,21 +753,22 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShade32Solid(uint32_t *pdest
 
 ////////////////////////////////////////////////////////////////////////
 
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::getTextureTransColG32Semi(uint32_t *pdest, uint32_t color) {
     int32_t r, g, b;
 
     if (color == 0) return;
 
-    if (m_drawSemiTrans && (color & 0x80008000)) {
-        if (m_globalTextABR == GPU::BlendFunction::HalfBackAndHalfFront) {
+    if (State::semiTrans && (color & 0x80008000)) {
+        if constexpr (State::abr == GPU::BlendFunction::HalfBackAndHalfFront) {
             r = ((((X32TCOL1(*pdest)) + ((X32COL1(color)) * m_m1)) & 0xff00ff00) >> 8);
             b = ((((X32TCOL2(*pdest)) + ((X32COL2(color)) * m_m2)) & 0xff00ff00) >> 8);
             g = ((((X32TCOL3(*pdest)) + ((X32COL3(color)) * m_m3)) & 0xff00ff00) >> 8);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackAndFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackAndFullFront) {
             r = (X32COL1(*pdest)) + (((((X32COL1(color))) * m_m1) & 0xff80ff80) >> 7);
             b = (X32COL2(*pdest)) + (((((X32COL2(color))) * m_m2) & 0xff80ff80) >> 7);
             g = (X32COL3(*pdest)) + (((((X32COL3(color))) * m_m3) & 0xff80ff80) >> 7);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackSubFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackSubFullFront) {
             int32_t t;
             r = (((((X32COL1(color))) * m_m1) & 0xff80ff80) >> 7);
             t = (*pdest & 0x001f0000) - (r & 0x003f0000);
@@ -847,7 +820,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColG32Semi(uint32_t *pdest, uin
     if (g & 0x7fe00000) g = 0x1f0000 | (g & 0xffff);
     if (g & 0x7fe0) g = 0x1f | (g & 0xffff0000);
 
-    if (m_checkMask) {
+    if constexpr (State::checkMask) {
         uint32_t ma = *pdest;
 
         *pdest = (X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000);
@@ -873,33 +846,33 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColG32Semi(uint32_t *pdest, uin
 
 ////////////////////////////////////////////////////////////////////////
 
-template <bool useCachedDither>
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeXDither(uint16_t *pdest, uint16_t color, int32_t m1,
                                                                  int32_t m2, int32_t m3) {
     int32_t r, g, b;
 
     if (color == 0) return;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (State::checkMask && *pdest & 0x8000) return;
 
     m1 = (((XCOL1D(color))) * m1) >> 4;
     m2 = (((XCOL2D(color))) * m2) >> 4;
     m3 = (((XCOL3D(color))) * m3) >> 4;
 
-    if (m_drawSemiTrans && (color & 0x8000)) {
+    if (State::semiTrans && (color & 0x8000)) {
         r = ((XCOL1D(*pdest)) << 3);
         b = ((XCOL2D(*pdest)) << 3);
         g = ((XCOL3D(*pdest)) << 3);
 
-        if (m_globalTextABR == GPU::BlendFunction::HalfBackAndHalfFront) {
+        if constexpr (State::abr == GPU::BlendFunction::HalfBackAndHalfFront) {
             r = (r >> 1) + (m1 >> 1);
             b = (b >> 1) + (m2 >> 1);
             g = (g >> 1) + (m3 >> 1);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackAndFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackAndFullFront) {
             r += m1;
             b += m2;
             g += m3;
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackSubFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackSubFullFront) {
             r -= m1;
             b -= m2;
             g -= m3;
@@ -921,7 +894,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeXDither(uint16_t *pdest
     if (b & 0x7fffff00) b = 0xff;
     if (g & 0x7fffff00) g = 0xff;
 
-    if constexpr (useCachedDither) {
+    if constexpr (State::cachedDither) {
         applyDitherCached(pdest, m_vram16, r, b, g, m_setMask16 | (color & 0x8000));
     } else {
         applyDither(pdest, m_vram16, r, b, g, m_setMask16 | (color & 0x8000));
@@ -930,6 +903,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeXDither(uint16_t *pdest
 
 ////////////////////////////////////////////////////////////////////////
 
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeX(uint16_t *pdest, uint16_t color, int16_t m1, int16_t m2,
                                                            int16_t m3) {
     int32_t r, g, b;
@@ -937,23 +911,23 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeX(uint16_t *pdest, uint
 
     if (color == 0) return;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (State::checkMask && *pdest & 0x8000) return;
 
     l = m_setMask16 | (color & 0x8000);
 
-    if (m_drawSemiTrans && (color & 0x8000)) {
-        if (m_globalTextABR == GPU::BlendFunction::HalfBackAndHalfFront) {
+    if (State::semiTrans && (color & 0x8000)) {
+        if constexpr (State::abr == GPU::BlendFunction::HalfBackAndHalfFront) {
             uint16_t d;
             d = ((*pdest) & 0x7bde) >> 1;
             color = (color & 0x7bde) >> 1;
             r = (XCOL1(d)) + ((((XCOL1(color))) * m1) >> 7);
             b = (XCOL2(d)) + ((((XCOL2(color))) * m2) >> 7);
             g = (XCOL3(d)) + ((((XCOL3(color))) * m3) >> 7);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackAndFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackAndFullFront) {
             r = (XCOL1(*pdest)) + ((((XCOL1(color))) * m1) >> 7);
             b = (XCOL2(*pdest)) + ((((XCOL2(color))) * m2) >> 7);
             g = (XCOL3(*pdest)) + ((((XCOL3(color))) * m3) >> 7);
-        } else if (m_globalTextABR == GPU::BlendFunction::FullBackSubFullFront) {
+        } else if constexpr (State::abr == GPU::BlendFunction::FullBackSubFullFront) {
             r = (XCOL1(*pdest)) - ((((XCOL1(color))) * m1) >> 7);
             b = (XCOL2(*pdest)) - ((((XCOL2(color))) * m2) >> 7);
             g = (XCOL3(*pdest)) - ((((XCOL3(color))) * m3) >> 7);
@@ -1059,9 +1033,19 @@ void PCSX::SoftGPU::SoftRenderer::fillSoftwareAreaTrans(int16_t x0, int16_t y0,
 
     if (dx == 1 && dy == 1 && x0 == 1020 && y0 == 511) {
         // interlace hack - fix me
-        static int iCheat = 0;
-        col += iCheat;
-        iCheat ^= 1;
+        col += m_interlaceCheat;
+        m_interlaceCheat ^= 1;
+    }
+
+    if (m_checkMask || m_drawSemiTrans) {
+        const auto &spans = Spans::getKernels();
+        const auto blend = getSpanBlend();
+        uint16_t *DSTPtr = m_vram16 + (GPU_WIDTH * y0) + x0;
+        for (i = 0; i < dy; i++) {
+            spans.fill(DSTPtr, dx, col, blend);
+            DSTPtr += GPU_WIDTH;
+        }
+        return;
     }
 
     if (dx & 1) {
@@ -1083,16 +1067,9 @@ void PCSX::SoftGPU::SoftRenderer::fillSoftwareAreaTrans(int16_t x0, int16_t y0,
         DSTPtr = (uint32_t *)(m_vram16 + (GPU_WIDTH * y0) + x0);
         LineOffset = 512 - dx;
 
-        if (!m_checkMask && !m_drawSemiTrans) {
-            for (i = 0; i < dy; i++) {
-                for (j = 0; j < dx; j++) *DSTPtr++ = lcol;
-                DSTPtr += LineOffset;
-            }
-        } else {
-            for (i = 0; i < dy; i++) {
-                for (j = 0; j < dx; j++) getShadeTransCol32(DSTPtr++, lcol);
-                DSTPtr += LineOffset;
-            }
+        for (i = 0; i < dy; i++) {
+            for (j = 0; j < dx; j++) *DSTPtr++ = lcol;
+            DSTPtr += LineOffset;
         }
     }
 }
@@ -2471,16 +2448,16 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3Fi(int16_t x1, int16_t y1, int16_t x2
         return;
     }
 
+    const auto &spans = Spans::getKernels();
+    const auto blend = getSpanBlend();
+
     for (i = ymin; i <= ymax; i++) {
         xmin = m_leftX >> 16;
         if (drawX > xmin) xmin = drawX;
         xmax = (m_rightX >> 16) - 1;
         if (drawW < xmax) xmax = drawW;
 
-        for (j = xmin; j < xmax; j += 2) {
-            getShadeTransCol32((uint32_t *)&vram16[(i << 10) + j], lcolor);
-        }
-        if (j == xmax) getShadeTransCol(&vram16[(i << 10) + j], color);
+        if (xmax >= xmin) spans.fill(&vram16[(i << 10) + xmin], xmax - xmin + 1, color, blend);
 
         if (nextRowFlat3()) return;
     }
@@ -2497,9 +2474,10 @@ void PCSX::SoftGPU::SoftRenderer::drawPolyFlat4(int32_t rgb) {
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
-                                                int16_t ty3, int16_t clX, int16_t clY) {
+template <typename State>
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx4i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                 int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                                 int16_t ty3, int16_t clX, int16_t clY) {
     int i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
     int32_t posX, posY, YAdjust, XAdjust;
@@ -2541,7 +2519,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx4(int16_t x1, int16_t y1, int16_t
     const auto maskX = m_textureWindow.x1 - 1;
     const auto maskY = m_textureWindow.y1 - 1;
 
-    if (!m_checkMask && !m_drawSemiTrans) {
+    if constexpr (State::solid) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16);  //-1; //!!!!!!!!!!!!!!!!
@@ -2614,7 +2592,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx4(int16_t x1, int16_t y1, int16_t
 
                 uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
                 uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColShade32(pdest, color);
+                getTextureTransColShade32<State>(pdest, color);
 
                 posX += difX2;
                 posY += difY2;
@@ -2623,7 +2601,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx4(int16_t x1, int16_t y1, int16_t
                 XAdjust = (posX >> 16) & maskX;
                 tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
                 tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                getTextureTransColShade(&vram16[(i << 10) + j], vram16[clutP + tC1]);
+                getTextureTransColShade<State>(&vram16[(i << 10) + j], vram16[clutP + tC1]);
             }
         }
         if (nextRowFlatTextured3()) return;
@@ -2632,10 +2610,22 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx4(int16_t x1, int16_t y1, int16_t
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
-                                                int16_t clX, int16_t clY) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                                int16_t ty3, int16_t clX, int16_t clY) {
+    dispatchPixelState<false>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3TEx4i<State>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename State>
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                 int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                 int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
+                                                 int16_t clX, int16_t clY) {
     int32_t num;
     int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
@@ -2672,7 +2662,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4(int16_t x1, int16_t y1, int16_t
     const auto maskX = m_textureWindow.x1 - 1;
     const auto maskY = m_textureWindow.y1 - 1;
 
-    if (!m_checkMask && !m_drawSemiTrans) {
+    if constexpr (State::solid) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16);
@@ -2758,7 +2748,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4(int16_t x1, int16_t y1, int16_t
 
                 uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
                 uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColShade32(pdest, color);
+                getTextureTransColShade32<State>(pdest, color);
                 posX += difX2;
                 posY += difY2;
             }
@@ -2766,7 +2756,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4(int16_t x1, int16_t y1, int16_t
                 XAdjust = (posX >> 16) & maskX;
                 tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
                 tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                getTextureTransColShade(&vram16[(i << 10) + j], vram16[clutP + tC1]);
+                getTextureTransColShade<State>(&vram16[(i << 10) + j], vram16[clutP + tC1]);
             }
         }
         if (nextRowFlatTextured4()) return;
@@ -2775,10 +2765,23 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4(int16_t x1, int16_t y1, int16_t
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                  int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
-                                                  int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
-                                                  int16_t ty4, int16_t clX, int16_t clY) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
+                                                int16_t clX, int16_t clY) {
+    dispatchPixelState<false>([&](auto state) {
+        using State = decltype(state);
+        drawPoly4TEx4i<State>(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename State>
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4i_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
+                                                   int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
+                                                   int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                                                   int16_t ty4, int16_t clX, int16_t clY) {
     int32_t num;
     int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
@@ -2815,7 +2818,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4_S(int16_t x1, int16_t y1, int16_
     const auto maskX = m_textureWindow.x1 - 1;
     const auto maskY = m_textureWindow.y1 - 1;
 
-    if (!m_checkMask && !m_drawSemiTrans) {
+    if constexpr (State::solid) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16);
@@ -2901,7 +2904,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4_S(int16_t x1, int16_t y1, int16_
 
                 uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
                 uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColG32Semi(pdest, color);
+                getTextureTransColG32Semi<State>(pdest, color);
                 posX += difX2;
                 posY += difY2;
             }
@@ -2909,7 +2912,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4_S(int16_t x1, int16_t y1, int16_
                 XAdjust = (posX >> 16) & maskX;
                 tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
                 tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                getTextureTransColShadeSemi(&vram16[(i << 10) + j], vram16[clutP + tC1]);
+                getTextureTransColShadeSemi<State>(&vram16[(i << 10) + j], vram16[clutP + tC1]);
             }
         }
         if (nextRowFlatTextured4()) return;
@@ -2918,9 +2921,22 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4_S(int16_t x1, int16_t y1, int16_
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
-                                                int16_t ty3, int16_t clX, int16_t clY) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
+                                                  int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
+                                                  int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                                                  int16_t ty4, int16_t clX, int16_t clY) {
+    dispatchPixelState<false>([&](auto state) {
+        using State = decltype(state);
+        drawPoly4TEx4i_S<State>(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename State>
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx8i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                 int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                                 int16_t ty3, int16_t clX, int16_t clY) {
     int i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
     int32_t posX, posY, YAdjust, clutP;
@@ -2961,7 +2977,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx8(int16_t x1, int16_t y1, int16_t
     const auto maskX = m_textureWindow.x1 - 1;
     const auto maskY = m_textureWindow.y1 - 1;
 
-    if (!m_checkMask && !m_drawSemiTrans) {
+    if constexpr (State::solid) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16);  //-1; //!!!!!!!!!!!!!!!!
@@ -3023,14 +3039,14 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx8(int16_t x1, int16_t y1, int16_t
                                                 (((posX + difX) >> 16) & maskX))];
                 uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
                 uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColShade32(pdest, color);
+                getTextureTransColShade32<State>(pdest, color);
                 posX += difX2;
                 posY += difY2;
             }
 
             if (j == xmax) {
                 tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                getTextureTransColShade(&vram16[(i << 10) + j], vram16[clutP + tC1]);
+                getTextureTransColShade<State>(&vram16[(i << 10) + j], vram16[clutP + tC1]);
             }
         }
         if (nextRowFlatTextured3()) return;
@@ -3039,10 +3055,22 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx8(int16_t x1, int16_t y1, int16_t
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
-                                                int16_t clX, int16_t clY) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                                int16_t ty3, int16_t clX, int16_t clY) {
+    dispatchPixelState<false>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3TEx8i<State>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename State>
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                 int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                 int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
+                                                 int16_t clX, int16_t clY) {
     int32_t num;
     int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
@@ -3079,7 +3107,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8(int16_t x1, int16_t y1, int16_t
     const auto maskX = m_textureWindow.x1 - 1;
     const auto maskY = m_textureWindow.y1 - 1;
 
-    if (!m_checkMask && !m_drawSemiTrans) {
+    if constexpr (State::solid) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16);
@@ -3155,14 +3183,14 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8(int16_t x1, int16_t y1, int16_t
                                                 (((posX + difX) >> 16) & maskX))];
                 uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
                 uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColShade32(pdest, color);
+                getTextureTransColShade32<State>(pdest, color);
                 posX += difX2;
                 posY += difY2;
             }
             if (j == xmax) {
                 tC1 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
                                                 ((posX >> 16) & maskX))];
-                getTextureTransColShade(&vram16[(i << 10) + j], vram16[clutP + tC1]);
+                getTextureTransColShade<State>(&vram16[(i << 10) + j], vram16[clutP + tC1]);
             }
         }
         if (nextRowFlatTextured4()) return;
@@ -3171,10 +3199,23 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8(int16_t x1, int16_t y1, int16_t
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                  int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
-                                                  int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
-                                                  int16_t ty4, int16_t clX, int16_t clY) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
+                                                int16_t clX, int16_t clY) {
+    dispatchPixelState<false>([&](auto state) {
+        using State = decltype(state);
+        drawPoly4TEx8i<State>(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename State>
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8i_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
+                                                   int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
+                                                   int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                                                   int16_t ty4, int16_t clX, int16_t clY) {
     int32_t num;
     int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
@@ -3211,7 +3252,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_
     const auto maskX = m_textureWindow.x1 - 1;
     const auto maskY = m_textureWindow.y1 - 1;
 
-    if (!m_checkMask && !m_drawSemiTrans) {
+    if constexpr (State::solid) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16);
@@ -3287,27 +3328,40 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_
                                                 (((posX + difX) >> 16) & maskX))];
                 uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
                 uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColG32Semi(pdest, color);
+                getTextureTransColG32Semi<State>(pdest, color);
                 posX += difX2;
                 posY += difY2;
             }
             if (j == xmax) {
                 tC1 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
                                                 ((posX >> 16) & maskX))];
-                getTextureTransColShadeSemi(&vram16[(i << 10) + j], vram16[clutP + tC1]);
+                getTextureTransColShadeSemi<State>(&vram16[(i << 10) + j], vram16[clutP + tC1]);
             }
         }
         if (nextRowFlatTextured4()) return;
     }
 }
 
+////////////////////////////////////////////////////////////////////////
+
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
+                                                  int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
+                                                  int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                                                  int16_t ty4, int16_t clX, int16_t clY) {
+    dispatchPixelState<false>([&](auto state) {
+        using State = decltype(state);
+        drawPoly4TEx8i_S<State>(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY);
+    });
+}
+
 ////////////////////////////////////////////////////////////////////////
 // POLY 3 F-SHADED TEX 15 BIT
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                              int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
-                                              int16_t ty3) {
+template <typename State>
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TDi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                               int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                               int16_t ty3) {
     int i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
     int32_t posX, posY;
@@ -3345,7 +3399,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TD(int16_t x1, int16_t y1, int16_t x2
     const auto globalTextAddrY = m_globalTextAddrY;
     const auto textureWindow = m_textureWindow;
 
-    if (!m_checkMask && !m_drawSemiTrans) {
+    if constexpr (State::solid) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!
@@ -3406,7 +3460,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TD(int16_t x1, int16_t y1, int16_t x2
             }
 
             for (j = xmin; j < xmax; j += 2) {
-                getTextureTransColShade32(
+                getTextureTransColShade32<State>(
                     (uint32_t *)&vram16[(i << 10) + j],
                     (((int32_t)vram16[(((((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
                                       (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0])
@@ -3418,9 +3472,10 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TD(int16_t x1, int16_t y1, int16_t x2
                 posY += difY2;
             }
             if (j == xmax) {
-                getTextureTransColShade(&vram16[(i << 10) + j],
-                                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
+                getTextureTransColShade<State>(
+                    &vram16[(i << 10) + j],
+                    vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
+                           ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
             }
         }
         if (nextRowFlatTextured3()) return;
@@ -3429,9 +3484,21 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TD(int16_t x1, int16_t y1, int16_t x2
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                              int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                              int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                              int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                              int16_t ty3) {
+    dispatchPixelState<false>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3TDi<State>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename State>
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TDi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                               int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                               int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
     int32_t num;
     int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
@@ -3465,7 +3532,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2
     const auto globalTextAddrY = m_globalTextAddrY;
     const auto textureWindow = m_textureWindow;
 
-    if (!m_checkMask && !m_drawSemiTrans) {
+    if constexpr (State::solid) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16);
@@ -3540,7 +3607,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2
             if (drawW < xmax) xmax = drawW;
 
             for (j = xmin; j < xmax; j += 2) {
-                getTextureTransColShade32(
+                getTextureTransColShade32<State>(
                     (uint32_t *)&vram16[(i << 10) + j],
                     (((int32_t)vram16[(((((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
                                       (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0])
@@ -3552,9 +3619,10 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2
                 posY += difY2;
             }
             if (j == xmax) {
-                getTextureTransColShade(&vram16[(i << 10) + j],
-                                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
+                getTextureTransColShade<State>(
+                    &vram16[(i << 10) + j],
+                    vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
+                           ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
             }
         }
         if (nextRowFlatTextured4()) return;
@@ -3563,9 +3631,21 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                              int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                              int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
+    dispatchPixelState<false>([&](auto state) {
+        using State = decltype(state);
+        drawPoly4TDi<State>(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename State>
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TDi_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                 int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                 int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
     int32_t num;
     int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
@@ -3599,7 +3679,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t
     const auto globalTextAddrY = m_globalTextAddrY;
     const auto textureWindow = m_textureWindow;
 
-    if (!m_checkMask && !m_drawSemiTrans) {
+    if constexpr (State::solid) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16);
@@ -3674,7 +3754,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t
             if (drawW < xmax) xmax = drawW;
 
             for (j = xmin; j < xmax; j += 2) {
-                getTextureTransColG32Semi(
+                getTextureTransColG32Semi<State>(
                     (uint32_t *)&vram16[(i << 10) + j],
                     (((int32_t)vram16[(((((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
                                       (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0])
@@ -3686,7 +3766,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t
                 posY += difY2;
             }
             if (j == xmax) {
-                getTextureTransColShadeSemi(
+                getTextureTransColShadeSemi<State>(
                     &vram16[(i << 10) + j],
                     vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
                            ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
@@ -3696,11 +3776,22 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t
     }
 }
 
+////////////////////////////////////////////////////////////////////////
+
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
+    dispatchPixelState<false>([&](auto state) {
+        using State = decltype(state);
+        drawPoly4TDi_S<State>(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4);
+    });
+}
+
 ////////////////////////////////////////////////////////////////////////
 // POLY 3/4 G-SHADED
 ////////////////////////////////////////////////////////////////////////
 
-template <bool useCachedDither>
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
                                               int32_t rgb1, int32_t rgb2, int32_t rgb3) {
     int i, j, xmin, xmax, ymin, ymax;
@@ -3744,7 +3835,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2
     const auto setMask16 = m_setMask16;
     const auto setMask32 = m_setMask32;
 
-    if (!m_checkMask && !m_drawSemiTrans && !m_ditherMode) {
+    if constexpr (State::solid && !State::dither) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16) - 1;
@@ -3784,7 +3875,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2
         return;
     }
 
-    if (m_ditherMode) {
+    if constexpr (State::dither) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16) - 1;
@@ -3804,8 +3895,7 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2
                 }
 
                 for (j = xmin; j <= xmax; j++) {
-                    getShadeTransColDither<useCachedDither>(&vram16[(i << 10) + j], (cB1 >> 16), (cG1 >> 16),
-                                                            (cR1 >> 16));
+                    getShadeTransColDither<State>(&vram16[(i << 10) + j], (cB1 >> 16), (cG1 >> 16), (cR1 >> 16));
 
                     cR1 += difR;
                     cG1 += difG;
@@ -3815,6 +3905,11 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2
             if (nextRowShade3()) return;
         }
     } else {
+        // Interpolate the row first, then blend it in one go
+        const auto &spans = Spans::getKernels();
+        const auto blend = getSpanBlend();
+        uint16_t colors[GPU_WIDTH];
+
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16) - 1;
@@ -3834,13 +3929,13 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2
                 }
 
                 for (j = xmin; j <= xmax; j++) {
-                    getShadeTransCol(&vram16[(i << 10) + j],
-                                     ((cR1 >> 9) & 0x7c00) | ((cG1 >> 14) & 0x03e0) | ((cB1 >> 19) & 0x001f));
+                    colors[j - xmin] = ((cR1 >> 9) & 0x7c00) | ((cG1 >> 14) & 0x03e0) | ((cB1 >> 19) & 0x001f);
 
                     cR1 += difR;
                     cG1 += difG;
                     cB1 += difB;
                 }
+                if (xmax >= xmin) spans.blend(&vram16[(i << 10) + xmin], colors, xmax - xmin + 1, blend);
             }
             if (nextRowShade3()) return;
         }
@@ -3850,28 +3945,25 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SoftGPU::SoftRenderer::drawPolyShade3(int32_t rgb1, int32_t rgb2, int32_t rgb3) {
-    if (s_ditherLUT) {
-        drawPoly3Gi<true>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
-    } else {
-        drawPoly3Gi<false>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
-    }
+    dispatchPixelState<true>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3Gi<State>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
+    });
 }
 
 // draw two g-shaded tris for right psx shading emulation
 
 void PCSX::SoftGPU::SoftRenderer::drawPolyShade4(int32_t rgb1, int32_t rgb2, int32_t rgb3, int32_t rgb4) {
-    if (s_ditherLUT) {
-        drawPoly3Gi<true>(m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, rgb2, rgb4, rgb3);
-        drawPoly3Gi<true>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
-    } else {
-        drawPoly3Gi<false>(m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, rgb2, rgb4, rgb3);
-        drawPoly3Gi<false>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
-    }
+    dispatchPixelState<true>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3Gi<State>(m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, rgb2, rgb4, rgb3);
+        drawPoly3Gi<State>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
+    });
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-template <bool useCachedDither>
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx4i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
                                                   int16_t y3, int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2,
                                                   int16_t tx3, int16_t ty3, int16_t clX, int16_t clY, int32_t col1,
@@ -3929,9 +4021,8 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx4i(int16_t x1, int16_t y1, int16_
     const auto textureWindow = m_textureWindow;
     const auto setMask16 = m_setMask16;
     const auto setMask32 = m_setMask32;
-    const auto ditherMode = m_ditherMode;
 
-    if (!m_checkMask && !m_drawSemiTrans && !ditherMode) {
+    if constexpr (State::solid && !State::dither) {
         for (i = ymin; i <= ymax; i++) {
             xmin = ((m_leftX) >> 16);
             xmax = ((m_rightX) >> 16) - 1;  //!!!!!!!!!!!!!
@@ -4011,12 +4102,12 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx4i(int16_t x1, int16_t y1, int16_
                 XAdjust = (posX >> 16) & maskX;
                 tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
                 tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                if (ditherMode) {
-                    getTextureTransColShadeXDither<useCachedDither>(&vram16[(i << 10) + j], vram16[clutP + tC1],
-                                                                    (cB1 >> 16), (cG1 >> 16), (cR1 >> 16));
+                if constexpr (State::dither) {
+                    getTextureTransColShadeXDither<State>(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16),
+                                                          (cG1 >> 16), (cR1 >> 16));
                 } else {
-                    getTextureTransColShadeX(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16), (cG1 >> 16),
-                                             (cR1 >> 16));
+                    getTextureTransColShadeX<State>(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16),
+                                                    (cG1 >> 16), (cR1 >> 16));
                 }
                 posX += difX;
                 posY += difY;
@@ -4035,11 +4126,10 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx4(int16_t x1, int16_t y1, int16_t
                                                  int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
                                                  int16_t ty3, int16_t clX, int16_t clY, int32_t col1, int32_t col2,
                                                  int32_t col3) {
-    if (s_ditherLUT) {
-        drawPoly3TGEx4i<true>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
-    } else {
-        drawPoly3TGEx4i<false>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
-    }
+    dispatchPixelState<true>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3TGEx4i<State>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
+    });
 }
 
 void PCSX::SoftGPU::SoftRenderer::drawPoly4TGEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
@@ -4047,18 +4137,16 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TGEx4(int16_t x1, int16_t y1, int16_t
                                                  int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
                                                  int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3,
                                                  int32_t col4) {
-    if (s_ditherLUT) {
-        drawPoly3TGEx4i<true>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
-        drawPoly3TGEx4i<true>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
-    } else {
-        drawPoly3TGEx4i<false>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
-        drawPoly3TGEx4i<false>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
-    }
+    dispatchPixelState<true>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3TGEx4i<State>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
+        drawPoly3TGEx4i<State>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
+    });
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-template <bool useCachedDither>
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx8i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
                                                   int16_t y3, int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2,
                                                   int16_t tx3, int16_t ty3, int16_t clX, int16_t clY, int32_t col1,
@@ -4115,9 +4203,8 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx8i(int16_t x1, int16_t y1, int16_
     const auto textureWindow = m_textureWindow;
     const auto setMask16 = m_setMask16;
     const auto setMask32 = m_setMask32;
-    const auto ditherMode = m_ditherMode;
 
-    if (!m_checkMask && !m_drawSemiTrans && !m_ditherMode) {
+    if constexpr (State::solid && !State::dither) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16) - 1;  // !!!!!!!!!!!!!
@@ -4190,12 +4277,12 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx8i(int16_t x1, int16_t y1, int16_
 
             for (j = xmin; j <= xmax; j++) {
                 tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                if (ditherMode) {
-                    getTextureTransColShadeXDither<useCachedDither>(&vram16[(i << 10) + j], vram16[clutP + tC1],
-                                                                    (cB1 >> 16), (cG1 >> 16), (cR1 >> 16));
+                if constexpr (State::dither) {
+                    getTextureTransColShadeXDither<State>(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16),
+                                                          (cG1 >> 16), (cR1 >> 16));
                 } else {
-                    getTextureTransColShadeX(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16), (cG1 >> 16),
-                                             (cR1 >> 16));
+                    getTextureTransColShadeX<State>(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16),
+                                                    (cG1 >> 16), (cR1 >> 16));
                 }
                 posX += difX;
                 posY += difY;
@@ -4214,11 +4301,10 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx8(int16_t x1, int16_t y1, int16_t
                                                  int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
                                                  int16_t ty3, int16_t clX, int16_t clY, int32_t col1, int32_t col2,
                                                  int32_t col3) {
-    if (s_ditherLUT) {
-        drawPoly3TGEx8i<true>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
-    } else {
-        drawPoly3TGEx8i<false>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
-    }
+    dispatchPixelState<true>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3TGEx8i<State>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
+    });
 }
 
 void PCSX::SoftGPU::SoftRenderer::drawPoly4TGEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
@@ -4226,18 +4312,16 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TGEx8(int16_t x1, int16_t y1, int16_t
                                                  int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
                                                  int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3,
                                                  int32_t col4) {
-    if (s_ditherLUT) {
-        drawPoly3TGEx8i<true>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
-        drawPoly3TGEx8i<true>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
-    } else {
-        drawPoly3TGEx8i<false>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
-        drawPoly3TGEx8i<false>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
-    }
+    dispatchPixelState<true>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3TGEx8i<State>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
+        drawPoly3TGEx8i<State>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
+    });
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-template <bool useCachedDither>
+template <typename State>
 void PCSX::SoftGPU::SoftRenderer::drawPoly3TGDi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
                                                 int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
                                                 int16_t ty3, int32_t col1, int32_t col2, int32_t col3) {
@@ -4287,9 +4371,8 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGDi(int16_t x1, int16_t y1, int16_t
     const auto textureWindow = m_textureWindow;
     const auto setMask16 = m_setMask16;
     const auto setMask32 = m_setMask32;
-    const auto ditherMode = m_ditherMode;
 
-    if (!m_checkMask && !m_drawSemiTrans && !m_ditherMode) {
+    if constexpr (State::solid && !State::dither) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
             xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!!!!!!!!
@@ -4365,14 +4448,14 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGDi(int16_t x1, int16_t y1, int16_t
             }
 
             for (j = xmin; j <= xmax; j++) {
-                if (ditherMode) {
-                    getTextureTransColShadeXDither<useCachedDither>(
+                if constexpr (State::dither) {
+                    getTextureTransColShadeXDither<State>(
                         &vram16[(i << 10) + j],
                         vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
                                ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0],
                         (cB1 >> 16), (cG1 >> 16), (cR1 >> 16));
                 } else {
-                    getTextureTransColShadeX(
+                    getTextureTransColShadeX<State>(
                         &vram16[(i << 10) + j],
                         vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
                                ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0],
@@ -4394,24 +4477,21 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGDi(int16_t x1, int16_t y1, int16_t
 void PCSX::SoftGPU::SoftRenderer::drawPoly3TGD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
                                                int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
                                                int16_t ty3, int32_t col1, int32_t col2, int32_t col3) {
-    if (s_ditherLUT) {
-        drawPoly3TGDi<true>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, col1, col2, col3);
-    } else {
-        drawPoly3TGDi<false>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, col1, col2, col3);
-    }
+    dispatchPixelState<true>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3TGDi<State>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, col1, col2, col3);
+    });
 }
 
 void PCSX::SoftGPU::SoftRenderer::drawPoly4TGD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
                                                int32_t col1, int32_t col2, int32_t col3, int32_t col4) {
-    if (s_ditherLUT) {
-        drawPoly3TGDi<true>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, col2, col4, col3);
-        drawPoly3TGDi<true>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, col1, col2, col3);
-    } else {
-        drawPoly3TGDi<false>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, col2, col4, col3);
-        drawPoly3TGDi<false>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, col1, col2, col3);
-    }
+    dispatchPixelState<true>([&](auto state) {
+        using State = decltype(state);
+        drawPoly3TGDi<State>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, col2, col4, col3);
+        drawPoly3TGDi<State>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, col1, col2, col3);
+    });
 }
 
 ////////////////////////////////////////////////////////////////////////
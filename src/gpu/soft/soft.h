@@ -22,13 +22,13 @@
 #include <stdint.h>
 
 #include "core/gpu.h"
+#include "gpu/soft/spans.h"
 
 namespace PCSX {
 
 namespace SoftGPU {
 
 struct SoftRenderer {
-    ~SoftRenderer();
     inline void resetRenderer() {
         m_globalTextAddrX = 0;
         m_globalTextAddrY = 0;
@@ -99,6 +99,7 @@ struct SoftRenderer {
     static constexpr int GPU_HEIGHT_MASK = 511;
 
     bool m_drawSemiTrans = false;
+    int m_interlaceCheat = 0;
     int16_t m_m1 = 255, m_m2 = 255, m_m3 = 255;
     int16_t m_y0, m_x0, m_y1, m_x1, m_y2, m_x2, m_y3, m_x3;  // global psx vertex coords
 
@@ -149,50 +150,112 @@ struct SoftRenderer {
                                      int16_t ty3, int16_t tx4, int16_t ty4, int32_t rgb1, int32_t rgb2, int32_t rgb3,
                                      int32_t rgb4);
 
-    template <bool useCachedDither>
+    // The drawing state the per-pixel functions depend on, as compile-time constants. The rasterizers are
+    // instantiated for each combination, and dispatchPixelState picks the right one once per primitive,
+    // so that the inner loops don't test any of it.
+    template <bool SemiTrans, GPU::BlendFunction ABR, bool CheckMask, bool Dither, bool CachedDither>
+    struct PixelState {
+        static constexpr bool semiTrans = SemiTrans;
+        static constexpr GPU::BlendFunction abr = ABR;
+        static constexpr bool checkMask = CheckMask;
+        static constexpr bool dither = Dither;
+        static constexpr bool cachedDither = CachedDither;
+        static constexpr bool solid = !SemiTrans && !CheckMask;
+    };
+    // Calls f with a PixelState matching the current drawing state. Dithering is only
+    // looked at for gouraud-shaded primitives, which are the only ones it applies to.
+    template <bool gouraud, typename F>
+    void dispatchPixelState(F &&f);
+
+    template <typename State>
     void getShadeTransColDither(uint16_t *pdest, int32_t m1, int32_t m2, int32_t m3);
     void getShadeTransCol(uint16_t *pdest, uint16_t color);
-    void getShadeTransCol32(uint32_t *pdest, uint32_t color);
+    Spans::Blend getSpanBlend() const {
+        Spans::Blend blend;
+        blend.function = m_globalTextABR;
+        blend.semiTrans = m_drawSemiTrans;
+        blend.checkMask = m_checkMask;
+        blend.setMask = m_setMask16;
+        return blend;
+    }
+    template <typename State>
     void getTextureTransColShade(uint16_t *pdest, uint16_t color);
     void getTextureTransColShadeSolid(uint16_t *pdest, uint16_t color);
+    template <typename State>
     void getTextureTransColShadeSemi(uint16_t *pdest, uint16_t color);
+    template <typename State>
     void getTextureTransColShade32(uint32_t *pdest, uint32_t color);
     void getTextureTransColShade32Solid(uint32_t *pdest, uint32_t color);
+    template <typename State>
     void getTextureTransColG32Semi(uint32_t *pdest, uint32_t color);
-    template <bool useCachedDither>
+    template <typename State>
     void getTextureTransColShadeXDither(uint16_t *pdest, uint16_t color, int32_t m1, int32_t m2, int32_t m3);
+    template <typename State>
     void getTextureTransColShadeX(uint16_t *pdest, uint16_t color, int16_t m1, int16_t m2, int16_t m3);
     void getTextureTransColShadeXSolid(uint16_t *pdest, uint16_t color, int16_t m1, int16_t m2, int16_t m3);
     void getTextureTransColShadeX32Solid(uint32_t *pdest, uint32_t color, int16_t m1, int16_t m2, int16_t m3);
     void drawPoly3Fi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int32_t rgb);
+    template <typename State>
+    void drawPoly3TEx4i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1,
+                        int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY);
     void drawPoly3TEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1, int16_t ty1,
                        int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY);
+    template <typename State>
+    void drawPoly4TEx4i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
+                        int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                        int16_t ty4, int16_t clX, int16_t clY);
     void drawPoly4TEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                        int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                        int16_t ty4, int16_t clX, int16_t clY);
+    template <typename State>
+    void drawPoly4TEx4i_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4,
+                          int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3,
+                          int16_t tx4, int16_t ty4, int16_t clX, int16_t clY);
     void drawPoly4TEx4_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                          int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                          int16_t ty4, int16_t clX, int16_t clY);
+    template <typename State>
+    void drawPoly3TEx8i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1,
+                        int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY);
     void drawPoly3TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1, int16_t ty1,
                        int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY);
+    template <typename State>
+    void drawPoly4TEx8i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
+                        int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                        int16_t ty4, int16_t clX, int16_t clY);
     void drawPoly4TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                        int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                        int16_t ty4, int16_t clX, int16_t clY);
+    template <typename State>
+    void drawPoly4TEx8i_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4,
+                          int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3,
+                          int16_t tx4, int16_t ty4, int16_t clX, int16_t clY);
     void drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                          int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                          int16_t ty4, int16_t clX, int16_t clY);
+    template <typename State>
+    void drawPoly3TDi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1, int16_t ty1,
+                      int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3);
     void drawPoly3TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1, int16_t ty1,
                      int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3);
+    template <typename State>
+    void drawPoly4TDi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
+                      int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                      int16_t ty4);
     void drawPoly4TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                      int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                      int16_t ty4);
+    template <typename State>
+    void drawPoly4TDi_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
+                        int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                        int16_t ty4);
     void drawPoly4TD_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                        int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                        int16_t ty4);
-    template <bool useCachedDither>
+    template <typename State>
     void drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int32_t rgb1, int32_t rgb2,
                      int32_t rgb3);
-    template <bool useCachedDither>
+    template <typename State>
     void drawPoly3TGEx4i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1,
                          int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY,
                          int32_t col1, int32_t col2, int32_t col3);
@@ -202,7 +265,7 @@ struct SoftRenderer {
     void drawPoly4TGEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                         int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                         int16_t ty4, int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3, int32_t col4);
-    template <bool useCachedDither>
+    template <typename State>
     void drawPoly3TGEx8i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1,
                          int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY,
                          int32_t col1, int32_t col2, int32_t col3);
@@ -212,7 +275,7 @@ struct SoftRenderer {
     void drawPoly4TGEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                         int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                         int16_t ty4, int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3, int32_t col4);
-    template <bool useCachedDither>
+    template <typename State>
     void drawPoly3TGDi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1, int16_t ty1,
                        int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int32_t col1, int32_t col2, int32_t col3);
     void drawPoly3TGD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1, int16_t ty1,
@@ -236,6 +299,14 @@ struct SoftRenderer {
     void enableCachedDithering();
     void disableCachedDithering();
 
+    template <GPU::Shading shading, GPU::Shape shape, GPU::Textured textured, GPU::Blend blend,
+              GPU::Modulation modulation>
+    void drawPoly(GPU::Poly<shading, shape, textured, blend, modulation> *prim);
+    template <GPU::Shading shading, GPU::LineType lineType, GPU::Blend blend>
+    void drawLine(GPU::Line<shading, lineType, blend> *prim);
+    template <GPU::Size size, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+    void drawRect(GPU::Rect<size, textured, blend, modulation> *prim);
+
   private:
     int rightSectionFlat3();
     int leftSectionFlat3();
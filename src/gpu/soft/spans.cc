@@ -0,0 +1,316 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "gpu/soft/spans.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define SPANS_SSE2
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SPANS_TARGET_AVX2
+#else
+#define SPANS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SPANS_NEON
+#endif
+
+namespace {
+
+using PCSX::GPU;
+using PCSX::SoftGPU::Spans::Blend;
+using PCSX::SoftGPU::Spans::Kernels;
+
+// Pixel by pixel, this is SoftRenderer::getShadeTransCol with the channels unpacked.
+uint16_t blendPixel(uint16_t dest, uint16_t color, const Blend &blend) {
+    if (blend.checkMask && (dest & 0x8000)) return dest;
+    if (!blend.semiTrans) return color | blend.setMask;
+
+    if (blend.function == GPU::BlendFunction::HalfBackAndHalfFront) {
+        return (((dest & 0x7bde) >> 1) + ((color & 0x7bde) >> 1)) | blend.setMask;
+    }
+
+    int r = dest & 0x1f, g = (dest >> 5) & 0x1f, b = (dest >> 10) & 0x1f;
+    int cr = color & 0x1f, cg = (color >> 5) & 0x1f, cb = (color >> 10) & 0x1f;
+
+    switch (blend.function) {
+        case GPU::BlendFunction::FullBackAndFullFront:
+            r += cr;
+            g += cg;
+            b += cb;
+            break;
+        case GPU::BlendFunction::FullBackSubFullFront:
+            r = r > cr ? r - cr : 0;
+            g = g > cg ? g - cg : 0;
+            b = b > cb ? b - cb : 0;
+            break;
+        default:
+            r += cr >> 2;
+            g += cg >> 2;
+            b += cb >> 2;
+            break;
+    }
+
+    if (r > 0x1f) r = 0x1f;
+    if (g > 0x1f) g = 0x1f;
+    if (b > 0x1f) b = 0x1f;
+
+    return r | (g << 5) | (b << 10) | blend.setMask;
+}
+
+void fillScalar(uint16_t *dest, unsigned count, uint16_t color, const Blend &blend) {
+    for (unsigned i = 0; i < count; i++) dest[i] = blendPixel(dest[i], color, blend);
+}
+
+void blendScalar(uint16_t *dest, const uint16_t *src, unsigned count, const Blend &blend) {
+    for (unsigned i = 0; i < count; i++) dest[i] = blendPixel(dest[i], src[i], blend);
+}
+
+const Kernels c_scalarKernels = {fillScalar, blendScalar, "scalar"};
+
+#if defined(SPANS_SSE2)
+
+inline __m128i mixSSE2(__m128i dest, __m128i color, const Blend &blend) {
+    const __m128i setMask = _mm_set1_epi16(blend.setMask);
+    __m128i result;
+
+    if (!blend.semiTrans) {
+        result = color;
+    } else if (blend.function == GPU::BlendFunction::HalfBackAndHalfFront) {
+        const __m128i halfMask = _mm_set1_epi16(0x7bde);
+        result = _mm_add_epi16(_mm_srli_epi16(_mm_and_si128(dest, halfMask), 1),
+                               _mm_srli_epi16(_mm_and_si128(color, halfMask), 1));
+    } else {
+        const __m128i channel = _mm_set1_epi16(0x1f);
+        __m128i r = _mm_and_si128(dest, channel);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(dest, 5), channel);
+        __m128i b = _mm_and_si128(_mm_srli_epi16(dest, 10), channel);
+        __m128i cr = _mm_and_si128(color, channel);
+        __m128i cg = _mm_and_si128(_mm_srli_epi16(color, 5), channel);
+        __m128i cb = _mm_and_si128(_mm_srli_epi16(color, 10), channel);
+
+        if (blend.function == GPU::BlendFunction::FullBackSubFullFront) {
+            r = _mm_subs_epu16(r, cr);
+            g = _mm_subs_epu16(g, cg);
+            b = _mm_subs_epu16(b, cb);
+        } else {
+            if (blend.function == GPU::BlendFunction::FullBackAndQuarterFront) {
+                cr = _mm_srli_epi16(cr, 2);
+                cg = _mm_srli_epi16(cg, 2);
+                cb = _mm_srli_epi16(cb, 2);
+            }
+            r = _mm_min_epi16(_mm_add_epi16(r, cr), channel);
+            g = _mm_min_epi16(_mm_add_epi16(g, cg), channel);
+            b = _mm_min_epi16(_mm_add_epi16(b, cb), channel);
+        }
+
+        result = _mm_or_si128(r, _mm_or_si128(_mm_slli_epi16(g, 5), _mm_slli_epi16(b, 10)));
+    }
+
+    result = _mm_or_si128(result, setMask);
+    if (blend.checkMask) {
+        const __m128i masked = _mm_srai_epi16(dest, 15);
+        result = _mm_or_si128(_mm_and_si128(masked, dest), _mm_andnot_si128(masked, result));
+    }
+    return result;
+}
+
+void fillSSE2(uint16_t *dest, unsigned count, uint16_t color, const Blend &blend) {
+    const __m128i colors = _mm_set1_epi16(color);
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i *p = reinterpret_cast<__m128i *>(dest + i);
+        _mm_storeu_si128(p, mixSSE2(_mm_loadu_si128(p), colors, blend));
+    }
+    fillScalar(dest + i, count - i, color, blend);
+}
+
+void blendSSE2(uint16_t *dest, const uint16_t *src, unsigned count, const Blend &blend) {
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i *p = reinterpret_cast<__m128i *>(dest + i);
+        const __m128i colors = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(p, mixSSE2(_mm_loadu_si128(p), colors, blend));
+    }
+    blendScalar(dest + i, src + i, count - i, blend);
+}
+
+SPANS_TARGET_AVX2 inline __m256i mixAVX2(__m256i dest, __m256i color, const Blend &blend) {
+    const __m256i setMask = _mm256_set1_epi16(blend.setMask);
+    __m256i result;
+
+    if (!blend.semiTrans) {
+        result = color;
+    } else if (blend.function == GPU::BlendFunction::HalfBackAndHalfFront) {
+        const __m256i halfMask = _mm256_set1_epi16(0x7bde);
+        result = _mm256_add_epi16(_mm256_srli_epi16(_mm256_and_si256(dest, halfMask), 1),
+                                  _mm256_srli_epi16(_mm256_and_si256(color, halfMask), 1));
+    } else {
+        const __m256i channel = _mm256_set1_epi16(0x1f);
+        __m256i r = _mm256_and_si256(dest, channel);
+        __m256i g = _mm256_and_si256(_mm256_srli_epi16(dest, 5), channel);
+        __m256i b = _mm256_and_si256(_mm256_srli_epi16(dest, 10), channel);
+        __m256i cr = _mm256_and_si256(color, channel);
+        __m256i cg = _mm256_and_si256(_mm256_srli_epi16(color, 5), channel);
+        __m256i cb = _mm256_and_si256(_mm256_srli_epi16(color, 10), channel);
+
+        if (blend.function == GPU::BlendFunction::FullBackSubFullFront) {
+            r = _mm256_subs_epu16(r, cr);
+            g = _mm256_subs_epu16(g, cg);
+            b = _mm256_subs_epu16(b, cb);
+        } else {
+            if (blend.function == GPU::BlendFunction::FullBackAndQuarterFront) {
+                cr = _mm256_srli_epi16(cr, 2);
+                cg = _mm256_srli_epi16(cg, 2);
+                cb = _mm256_srli_epi16(cb, 2);
+            }
+            r = _mm256_min_epi16(_mm256_add_epi16(r, cr), channel);
+            g = _mm256_min_epi16(_mm256_add_epi16(g, cg), channel);
+            b = _mm256_min_epi16(_mm256_add_epi16(b, cb), channel);
+        }
+
+        result = _mm256_or_si256(r, _mm256_or_si256(_mm256_slli_epi16(g, 5), _mm256_slli_epi16(b, 10)));
+    }
+
+    result = _mm256_or_si256(result, setMask);
+    if (blend.checkMask) {
+        const __m256i masked = _mm256_srai_epi16(dest, 15);
+        result = _mm256_blendv_epi8(result, dest, masked);
+    }
+    return result;
+}
+
+SPANS_TARGET_AVX2 void fillAVX2(uint16_t *dest, unsigned count, uint16_t color, const Blend &blend) {
+    const __m256i colors = _mm256_set1_epi16(color);
+    unsigned i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i *p = reinterpret_cast<__m256i *>(dest + i);
+        _mm256_storeu_si256(p, mixAVX2(_mm256_loadu_si256(p), colors, blend));
+    }
+    fillSSE2(dest + i, count - i, color, blend);
+}
+
+SPANS_TARGET_AVX2 void blendAVX2(uint16_t *dest, const uint16_t *src, unsigned count, const Blend &blend) {
+    unsigned i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i *p = reinterpret_cast<__m256i *>(dest + i);
+        const __m256i colors = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        _mm256_storeu_si256(p, mixAVX2(_mm256_loadu_si256(p), colors, blend));
+    }
+    blendSSE2(dest + i, src + i, count - i, blend);
+}
+
+bool hasAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+const Kernels c_sse2Kernels = {fillSSE2, blendSSE2, "SSE2"};
+const Kernels c_avx2Kernels = {fillAVX2, blendAVX2, "AVX2"};
+
+#elif defined(SPANS_NEON)
+
+inline uint16x8_t mixNEON(uint16x8_t dest, uint16x8_t color, const Blend &blend) {
+    uint16x8_t result;
+
+    if (!blend.semiTrans) {
+        result = color;
+    } else if (blend.function == GPU::BlendFunction::HalfBackAndHalfFront) {
+        const uint16x8_t halfMask = vdupq_n_u16(0x7bde);
+        result = vaddq_u16(vshrq_n_u16(vandq_u16(dest, halfMask), 1), vshrq_n_u16(vandq_u16(color, halfMask), 1));
+    } else {
+        const uint16x8_t channel = vdupq_n_u16(0x1f);
+        uint16x8_t r = vandq_u16(dest, channel);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(dest, 5), channel);
+        uint16x8_t b = vandq_u16(vshrq_n_u16(dest, 10), channel);
+        uint16x8_t cr = vandq_u16(color, channel);
+        uint16x8_t cg = vandq_u16(vshrq_n_u16(color, 5), channel);
+        uint16x8_t cb = vandq_u16(vshrq_n_u16(color, 10), channel);
+
+        if (blend.function == GPU::BlendFunction::FullBackSubFullFront) {
+            r = vqsubq_u16(r, cr);
+            g = vqsubq_u16(g, cg);
+            b = vqsubq_u16(b, cb);
+        } else {
+            if (blend.function == GPU::BlendFunction::FullBackAndQuarterFront) {
+                cr = vshrq_n_u16(cr, 2);
+                cg = vshrq_n_u16(cg, 2);
+                cb = vshrq_n_u16(cb, 2);
+            }
+            r = vminq_u16(vaddq_u16(r, cr), channel);
+            g = vminq_u16(vaddq_u16(g, cg), channel);
+            b = vminq_u16(vaddq_u16(b, cb), channel);
+        }
+
+        result = vorrq_u16(r, vorrq_u16(vshlq_n_u16(g, 5), vshlq_n_u16(b, 10)));
+    }
+
+    result = vorrq_u16(result, vdupq_n_u16(blend.setMask));
+    if (blend.checkMask) result = vbslq_u16(vtstq_u16(dest, vdupq_n_u16(0x8000)), dest, result);
+    return result;
+}
+
+void fillNEON(uint16_t *dest, unsigned count, uint16_t color, const Blend &blend) {
+    const uint16x8_t colors = vdupq_n_u16(color);
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) vst1q_u16(dest + i, mixNEON(vld1q_u16(dest + i), colors, blend));
+    fillScalar(dest + i, count - i, color, blend);
+}
+
+void blendNEON(uint16_t *dest, const uint16_t *src, unsigned count, const Blend &blend) {
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) vst1q_u16(dest + i, mixNEON(vld1q_u16(dest + i), vld1q_u16(src + i), blend));
+    blendScalar(dest + i, src + i, count - i, blend);
+}
+
+const Kernels c_neonKernels = {fillNEON, blendNEON, "NEON"};
+
+#endif
+
+const Kernels &pickKernels() {
+#if defined(SPANS_SSE2)
+    return hasAVX2() ? c_avx2Kernels : c_sse2Kernels;
+#elif defined(SPANS_NEON)
+    return c_neonKernels;
+#else
+    return c_scalarKernels;
+#endif
+}
+
+}  // namespace
+
+const PCSX::SoftGPU::Spans::Kernels &PCSX::SoftGPU::Spans::getScalarKernels() { return c_scalarKernels; }
+
+const PCSX::SoftGPU::Spans::Kernels &PCSX::SoftGPU::Spans::getKernels() {
+    static const Kernels &kernels = pickKernels();
+    return kernels;
+}
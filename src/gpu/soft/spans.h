@@ -0,0 +1,60 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "core/gpu.h"
+
+namespace PCSX {
+
+namespace SoftGPU {
+
+namespace Spans {
+
+// How a span gets merged into VRAM, mirroring the SoftRenderer state of the same name.
+struct Blend {
+    GPU::BlendFunction function = GPU::BlendFunction::HalfBackAndHalfFront;
+    bool semiTrans = false;
+    bool checkMask = false;
+    uint16_t setMask = 0;
+};
+
+// Writes "count" pixels of the same color, the way SoftRenderer::getShadeTransCol would for each of them.
+typedef void (*FillFunc)(uint16_t *dest, unsigned count, uint16_t color, const Blend &blend);
+// Same, with one source color per pixel.
+typedef void (*BlendFunc)(uint16_t *dest, const uint16_t *src, unsigned count, const Blend &blend);
+
+struct Kernels {
+    FillFunc fill;
+    BlendFunc blend;
+    const char *name;
+};
+
+// The reference implementation. The vectorized ones must produce the exact same pixels.
+const Kernels &getScalarKernels();
+// The fastest kernels the host CPU supports, which may be the scalar ones.
+const Kernels &getKernels();
+
+}  // namespace Spans
+
+}  // namespace SoftGPU
+
+}  // namespace PCSX
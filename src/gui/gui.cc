@@ -37,6 +37,7 @@ extern "C" {
 }
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <ctime>
 #include <exception>
@@ -44,6 +45,7 @@ extern "C" {
 #include <iomanip>
 #include <magic_enum_all.hpp>
 #include <numbers>
+#include <thread>
 #include <type_traits>
 #include <unordered_set>
 
@@ -51,13 +53,19 @@ extern "C" {
 #include "core/callstacks.h"
 #include "core/cdrom.h"
 #include "core/debug.h"
+#include "core/discset.h"
+#include "core/framepacer.h"
+#include "core/framestats.h"
 #include "core/gdb-server.h"
 #include "core/gpu.h"
 #include "core/gpulogger.h"
+#include "core/mdec.h"
 #include "core/pad.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
+#include "core/runahead.h"
 #include "core/sio1-server.h"
 #include "core/sio1.h"
 #include "core/sstate.h"
@@ -549,12 +557,15 @@ void PCSX::GUI::init(std::function<void()> applyArguments) {
 
     m_listener.listen<Events::Quitting>([this](const auto& event) { saveCfg(); });
     m_listener.listen<Events::ExecutionFlow::Pause>([this](const auto& event) {
+        m_framePacing = false;
         glfwSwapInterval(m_idleSwapInterval);
         glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
     });
     m_listener.listen<Events::ExecutionFlow::Run>([this](const auto& event) {
         m_enableSplashScreen = false;
 
+        // The frame pacer switches to its own swap interval on the next vsync, when it applies.
+        m_framePacing = false;
         glfwSwapInterval(0);
         setRawMouseMotion();
     });
@@ -610,6 +621,7 @@ void PCSX::GUI::init(std::function<void()> applyArguments) {
     if (gl3wIsCppThrower(reinterpret_cast<GL3WglProc>(glDebugMessageCallback))) {
         glDebugMessageCallback = nullptr;
     }
+    m_programCache.init(g_system->getPersistentDir() / "shadercache");
 
     auto vg = m_nvgContext = nvgCreateGLES3(NVG_ANTIALIAS | NVG_STENCIL_STROKES);
     if (vg) {
@@ -641,6 +653,7 @@ void PCSX::GUI::init(std::function<void()> applyArguments) {
             }
             if ((m_settingsJson.count("loggers") == 1 && m_settingsJson["loggers"].is_object())) {
                 m_log.deserialize(m_settingsJson["loggers"]);
+                updateLogFilter();
             }
             auto& windowSizeX = settings.get<WindowSizeX>();
             auto& windowSizeY = settings.get<WindowSizeY>();
@@ -933,7 +946,7 @@ void PCSX::GUI::startFrame() {
     ZoneScoped;
     tick();
     if (glfwWindowShouldClose(m_window)) g_system->quit();
-    glfwPollEvents();
+    waitForEvents();
 
     if (m_setupScreenSize) {
         const float renderRatio = settings.get<WidescreenRatio>() ? 9.0f / 16.0f : 3.0f / 4.0f;
@@ -975,6 +988,13 @@ void PCSX::GUI::startFrame() {
 
     auto& io = ImGui::GetIO();
 
+    // Rasterising the japanese glyphs takes a good while, so they're left out until something needs them: the
+    // memory card manager's save titles, or the Japanese translation.
+    if (!m_wantJapanese && (m_memcardManager.m_show || (g_system->localeName() == "Nihongo"))) {
+        m_wantJapanese = true;
+        m_reloadFonts = true;
+    }
+
     if (m_reloadFonts) {
         m_reloadFonts = false;
         m_baseFontRanges.clear();
@@ -993,9 +1013,14 @@ void PCSX::GUI::startFrame() {
             for (auto e : g_system->getLocaleExtra()) {
                 loadFont(e.first, settings.get<MainFontSize>().value * scale, io, e.second, true, false);
             }
-            // try loading the japanese font for memory card manager
-            m_hasJapanese = loadFont(MAKEU8("NotoSansCJKjp-Regular.otf"), settings.get<MainFontSize>().value * scale,
-                                     io, reinterpret_cast<const ImWchar*>(PCSX::System::Range::JAPANESE), true, true);
+            // try loading the japanese font for memory card manager; it also provides the pad button symbols,
+            // which are all there is to rasterise from it until its japanese glyphs are wanted
+            static const ImWchar c_symbolsOnly[] = {0};
+            const ImWchar* japaneseRanges =
+                m_wantJapanese ? reinterpret_cast<const ImWchar*>(PCSX::System::Range::JAPANESE) : c_symbolsOnly;
+            bool japaneseLoaded = loadFont(MAKEU8("NotoSansCJKjp-Regular.otf"),
+                                           settings.get<MainFontSize>().value * scale, io, japaneseRanges, true, true);
+            m_hasJapanese = m_wantJapanese && japaneseLoaded;
             m_monoFonts[scale] = loadFont(MAKEU8("NotoMono-Regular.ttf"), settings.get<MonoFontSize>().value * scale,
                                           io, nullptr, false, false);
         }
@@ -1007,6 +1032,7 @@ void PCSX::GUI::startFrame() {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
+    g_emulator->m_pads->sampleHostInput();
     MarkDown::newFrame();
     if (io.WantSaveIniSettings) {
         io.WantSaveIniSettings = false;
@@ -1042,6 +1068,10 @@ void PCSX::GUI::startFrame() {
         loadSaveState(saveStateName);
     }
 
+    if (ImGui::IsKeyPressed(ImGuiKey_F3)) {  // Step back through the rewind buffer
+        g_emulator->m_rewind->stepBack();
+    }
+
     if (!g_system->running()) {
         if (ImGui::IsKeyPressed(ImGuiKey_F10)) {
             g_emulator->m_debug->stepOver();
@@ -1088,6 +1118,26 @@ void PCSX::GUI::flip() {
     m_currentTexture ^= 1;
 }
 
+void PCSX::GUI::requestRedraw() {
+    if (!m_redrawRequested.exchange(true)) glfwPostEmptyEvent();
+}
+
+void PCSX::GUI::waitForEvents() {
+    // The running emulation paces the GUI with its vsyncs, so there's only waiting to do while paused.
+    const bool redraw = m_redrawRequested.exchange(false);
+    if (g_system->running() || (m_idleRedrawRate <= 0) || redraw || (m_eagerFrames != 0)) {
+        if (m_eagerFrames != 0) m_eagerFrames--;
+        glfwPollEvents();
+        return;
+    }
+    FrameStats::Scope scope(FrameStats::Idle);
+    const auto timeout = std::chrono::duration<double>(1.0 / m_idleRedrawRate);
+    const auto start = std::chrono::steady_clock::now();
+    glfwWaitEventsTimeout(timeout.count());
+    // Waking up early means some input came in, and ImGui needs a few frames to settle after one.
+    if ((std::chrono::steady_clock::now() - start) < timeout) m_eagerFrames = 3;
+}
+
 void PCSX::GUI::endFrame() {
     constexpr float renderRatio = 3.0f / 4.0f;
     const int w = m_framebufferSize.x;
@@ -1099,31 +1149,19 @@ void PCSX::GUI::endFrame() {
         clip::image_spec spec;
         spec.width = screenshot.width;
         spec.height = screenshot.height;
-        if (screenshot.bpp == GPU::ScreenShot::BPP_16) {
-            spec.bits_per_pixel = 16;
-            spec.bytes_per_row = screenshot.width * 2;
-            spec.red_mask = 0x7c00;
-            spec.green_mask = 0x3e0;
-            spec.blue_mask = 0x1f;
-            spec.alpha_mask = 0;
-            spec.red_shift = 10;
-            spec.green_shift = 5;
-            spec.blue_shift = 0;
-            spec.alpha_shift = 0;
-        } else {
-            spec.bits_per_pixel = 24;
-            spec.bytes_per_row = screenshot.width * 3;
-            spec.red_mask = 0xff0000;
-            spec.green_mask = 0xff00;
-            spec.blue_mask = 0xff;
-            spec.alpha_mask = 0;
-            spec.red_shift = 16;
-            spec.green_shift = 8;
-            spec.blue_shift = 0;
-            spec.alpha_shift = 0;
-        }
-        clip::image img(screenshot.data.data(), spec);
-        clip::set_image(img.to_rgba8888());
+        spec.bits_per_pixel = 32;
+        spec.bytes_per_row = screenshot.width * 4;
+        spec.red_mask = 0xff;
+        spec.green_mask = 0xff00;
+        spec.blue_mask = 0xff0000;
+        spec.alpha_mask = 0xff000000;
+        spec.red_shift = 0;
+        spec.green_shift = 8;
+        spec.blue_shift = 16;
+        spec.alpha_shift = 24;
+        clip::image img(spec);
+        screenshot.toRGBA(reinterpret_cast<uint8_t*>(img.data()));
+        clip::set_image(img);
     }
     // bind back the output frame buffer
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -1297,6 +1335,15 @@ void PCSX::GUI::endFrame() {
                     PCSX::g_emulator->m_cdrom->setLidOpenTime((int64_t)time(nullptr) + 2);
                     PCSX::g_emulator->m_cdrom->lidInterrupt();
                 }
+                auto& discSet = PCSX::g_emulator->m_discSet;
+                if (ImGui::BeginMenu(_("Swap disc"), discSet->count() != 0)) {
+                    for (unsigned i = 0; i < discSet->count(); i++) {
+                        if (ImGui::MenuItem(discSet->label(i).c_str(), nullptr, i == discSet->current())) {
+                            discSet->swap(i);
+                        }
+                    }
+                    ImGui::EndMenu();
+                }
                 ImGui::Separator();
                 if (ImGui::MenuItem(_("Reboot"))) {
                     g_system->quit(0x12eb007);
@@ -1374,6 +1421,7 @@ void PCSX::GUI::endFrame() {
             ImGui::Separator();
             if (ImGui::BeginMenu(_("Debug"))) {
                 ImGui::MenuItem(_("Show Logs"), nullptr, &m_log.m_show);
+                ImGui::MenuItem(_("Show Frame Statistics"), nullptr, &m_showFrameStats);
                 if (ImGui::BeginMenu(_("Lua"))) {
                     ImGui::MenuItem(_("Show Lua Console"), nullptr, &m_luaConsole.m_show);
                     ImGui::MenuItem(_("Show Lua Inspector"), nullptr, &m_luaInspector.m_show);
@@ -1574,18 +1622,28 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
 
     ImGui::SetNextWindowPos(ImVec2(10, 20), ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowSize(ImVec2(1024, 512), ImGuiCond_FirstUseEver);
-    if (m_mainVRAMviewer.m_show) m_mainVRAMviewer.draw(this, g_emulator->m_gpu->getVRAMTexture());
-    if (m_clutVRAMviewer.m_show) m_clutVRAMviewer.draw(this, g_emulator->m_gpu->getVRAMTexture());
-    for (auto& viewer : m_VRAMviewers) {
-        if (viewer.m_show) {
-            viewer.draw(this, g_emulator->m_gpu->getVRAMTexture());
+    // Getting the VRAM texture brings it up to date, which means syncing the software rasterizer, or resolving
+    // the multisampled VRAM of the OpenGL GPU, so it's only worth doing once for all of the viewers.
+    bool anyVRAMViewer = m_mainVRAMviewer.m_show || m_clutVRAMviewer.m_show;
+    for (auto& viewer : m_VRAMviewers) anyVRAMViewer = anyVRAMViewer || viewer.m_show;
+    if (anyVRAMViewer) {
+        const auto vramTexture = g_emulator->m_gpu->getVRAMTexture();
+        if (m_mainVRAMviewer.m_show) m_mainVRAMviewer.draw(this, vramTexture);
+        if (m_clutVRAMviewer.m_show) m_clutVRAMviewer.draw(this, vramTexture);
+        for (auto& viewer : m_VRAMviewers) {
+            if (viewer.m_show) {
+                viewer.draw(this, vramTexture);
+            }
         }
     }
 
     if (m_log.m_show) {
         ImGui::SetNextWindowPos(ImVec2(10, 540), ImGuiCond_FirstUseEver);
         ImGui::SetNextWindowSize(ImVec2(1200, 250), ImGuiCond_FirstUseEver);
-        changed |= m_log.draw(this, _("Logs"));
+        if (m_log.draw(this, _("Logs"))) {
+            changed = true;
+            updateLogFilter();
+        }
     }
 
     if (m_luaConsole.m_show) {
@@ -1698,6 +1756,7 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
 
     if (m_showAbout) changed |= about();
     if (m_showInterruptsScaler) interruptsScaler();
+    if (m_showFrameStats) frameStats();
 
     if (m_outputShaderEditor.m_show && m_outputShaderEditor.draw(this, _("Output Video"))) {
         // maybe throttle this?
@@ -1753,7 +1812,7 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
                     ImGui::EndCombo();
                 }
                 if (ImGui::Button(_("Reload locales"))) {
-                    g_system->loadAllLocales();
+                    g_system->reloadLocales();
                     g_system->activateLocale(currentLocale);
                 }
             }
@@ -1783,6 +1842,89 @@ their TV set to match the aspect ratio of the game.)"));
         if (ImGui::Begin(_("System Configuration"), &m_showSysCfg)) {
             changed |=
                 ImGui::Checkbox(_("Preload Disk Image files"), &emuSettings.get<Emulator::SettingFullCaching>().value);
+            changed |= ImGui::Checkbox(_("Open all the discs of multi-disc games"),
+                                       &emuSettings.get<Emulator::SettingPreloadDiscSet>().value);
+            ImGuiHelpers::ShowHelpMarker(_(R"(Opens the other discs of a multi-disc game in the
+background once one of them is loaded, so that swapping
+discs is instant. The other discs are recognized from
+the images of a PBP, or from images named like the
+loaded one, with another number after "Disc". When disk
+image files are preloaded, theirs are preloaded too.)"));
+            changed |= ImGui::Checkbox(_("Read ahead on Disk Images"),
+                                       &emuSettings.get<Emulator::SettingCDReadAhead>().value);
+            ImGuiHelpers::ShowHelpMarker(_(R"(Reads the sectors following the ones the game asks for on a separate thread,
+so that slow disks or network shares don't stall the emulation. Not
+needed when disk images are preloaded.)"));
+            changed |= ImGui::SliderInt(_("Compressed CD audio lookahead"),
+                                        &emuSettings.get<Emulator::SettingCDDALookahead>().value, 0, 600);
+            ImGuiHelpers::ShowHelpMarker(_(R"(How many sectors of the MP3, FLAC, Opus... audio tracks
+of cue sheets to decode ahead of the play position, on a
+separate thread, so that playing them doesn't decode on
+the emulation thread. 75 sectors make a second of audio,
+and each takes about 2.3kB. Zero decodes them as they play.)"));
+            changed |= ImGui::SliderInt(_("Compressed Disk Image cache"),
+                                        &emuSettings.get<Emulator::SettingCompressedCacheBlocks>().value, 1, 256);
+            ImGuiHelpers::ShowHelpMarker(_(R"(How many decompressed blocks of PBP and CBIN disk images
+to keep around, so that games going back and forth between
+areas of the disc don't decompress the same data over and
+over. Each block holds up to 16 sectors, or about 37kB.
+Takes effect the next time a disk image is opened.)"));
+            auto& fastTimings = emuSettings.get<Emulator::SettingCDFastTimings>().value;
+            changed |= ImGui::Checkbox(_("Fast CD-ROM timings"), &fastTimings);
+            ImGuiHelpers::ShowHelpMarker(_(R"(Shortens the time the emulated CD-ROM drive takes to seek,
+read, and spin up, which cuts down loading times. The reading
+speed of streamed audio and video is left alone. Some games
+depend on the actual timings, and will misbehave with this.
+Takes effect on the next reset or disc change, and is saved
+in savestates.)"));
+            if (fastTimings) {
+                changed |= ImGui::SliderInt(_("Seek speedup"),
+                                            &emuSettings.get<Emulator::SettingCDFastSeekFactor>().value, 1, 64);
+                changed |= ImGui::SliderInt(_("Read speedup"),
+                                            &emuSettings.get<Emulator::SettingCDFastReadFactor>().value, 1, 64);
+                changed |= ImGui::SliderInt(_("Spin speedup"),
+                                            &emuSettings.get<Emulator::SettingCDFastSpinFactor>().value, 1, 64);
+                const auto& id = g_emulator->m_cdrom->getCDRomID();
+                if (!id.empty()) {
+                    auto& exclusions = emuSettings.get<Emulator::SettingCDFastTimingsExclusions>().value;
+                    auto found = std::find(exclusions.begin(), exclusions.end(), id);
+                    bool excluded = found != exclusions.end();
+                    if (ImGui::Checkbox(fmt::format(f_("Keep accurate timings for {}"), id).c_str(), &excluded)) {
+                        if (excluded) {
+                            exclusions.push_back(id);
+                        } else {
+                            exclusions.erase(found);
+                        }
+                        changed = true;
+                    }
+                }
+            }
+            auto& mcdFastAccess = emuSettings.get<Emulator::SettingMcdFastAccess>().value;
+            changed |= ImGui::Checkbox(_("Fast memory card access"), &mcdFastAccess);
+            ImGuiHelpers::ShowHelpMarker(_(R"(Shortens the time the emulated memory cards take to
+transfer each byte, which speeds up the save and load
+screens, and the memory card checks at boot. Some games
+time out or misbehave with this. Takes effect on the next
+reset, and is saved in savestates.)"));
+            if (mcdFastAccess) {
+                changed |= ImGui::SliderInt(_("Memory card speedup"),
+                                            &emuSettings.get<Emulator::SettingMcdFastAccessFactor>().value, 1, 64);
+                const auto& id = g_emulator->m_cdrom->getCDRomID();
+                if (!id.empty()) {
+                    auto& exclusions = emuSettings.get<Emulator::SettingMcdFastAccessExclusions>().value;
+                    auto found = std::find(exclusions.begin(), exclusions.end(), id);
+                    bool excluded = found != exclusions.end();
+                    if (ImGui::Checkbox(fmt::format(f_("Keep accurate memory card timings for {}"), id).c_str(),
+                                        &excluded)) {
+                        if (excluded) {
+                            exclusions.push_back(id);
+                        } else {
+                            exclusions.erase(found);
+                        }
+                        changed = true;
+                    }
+                }
+            }
             changed |= ImGui::Checkbox(_("Enable Auto Update"), &emuSettings.get<Emulator::SettingAutoUpdate>().value);
         }
         ImGui::End();
@@ -1931,6 +2073,7 @@ the update and manually apply it.)")));
     L.getfield("DrawImguiFrame", LUA_GLOBALSINDEX);
     if (!L.isnil()) {
         ScopedOnlyLog(this);
+        FrameStats::Scope scope(FrameStats::Lua);
         try {
             L.pcall();
             bool gotGLerror = false;
@@ -2051,7 +2194,17 @@ the update and manually apply it.)")));
         }
         glfwMakeContextCurrent(m_window);
     }
+    auto& pacer = *g_emulator->m_framePacer;
+    const bool running = g_system->running();
+    if (running) pacer.submit(FramePacer::clock::now());
     glfwSwapBuffers(m_window);
+    if (running) pacer.presented(FramePacer::clock::now());
+    if (m_timeToFirstFrame.count() == 0) {
+        m_timeToFirstFrame = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                   g_system->getStartTime());
+        g_system->log(LogClass::UI, "First frame presented %lli ms after startup.\n",
+                      static_cast<long long>(m_timeToFirstFrame.count()));
+    }
 
     L.getfieldtable("nvg", LUA_GLOBALSINDEX);
     L.push("_gui");
@@ -2089,6 +2242,26 @@ bool PCSX::GUI::configure() {
             changed = true;
             if (!g_system->running()) glfwSwapInterval(m_idleSwapInterval);
         }
+        changed |= ImGui::SliderInt(_("Paused Redraw Rate"), &m_idleRedrawRate, 0, 60);
+        ImGuiHelpers::ShowHelpMarker(
+            _("While the emulation is paused, the GUI only gets redrawn on input, on new log messages, and this "
+              "many times per second otherwise, to spare the host CPU and GPU. Zero redraws it continuously."));
+        changed |= ImGui::SliderInt(_("Maximum GUI Frame Skip"), &m_maxGUIFrameSkip, 0, 10);
+        ImGuiHelpers::ShowHelpMarker(
+            _("When the emulation can't keep up, the GUI, debugging windows included, can skip being drawn for up "
+              "to this many frames in a row, so that it doesn't slow the emulation down any further. The emulated "
+              "frames are still all rendered, only their display gets skipped. Zero draws the GUI on every frame."));
+        changed |= ImGui::Checkbox(_("Frame pacing"), &m_framePacingEnabled);
+        ImGuiHelpers::ShowHelpMarker(
+            _("Syncs the presentation to the host display, and delays the emulation of each frame so that it "
+              "finishes just before the display refreshes, which reads the pads as late as possible. Only kicks in "
+              "when the display refreshes at about the emulated frame rate, and not in turbo mode. A display a bit "
+              "off from the emulated rate will still repeat or drop a frame every so often, to stay in sync with "
+              "the audio."));
+        if (m_framePacingEnabled) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(m_framePacing ? _("Active") : _("Inactive"));
+        }
         ImGui::Separator();
         if (ImGui::Button(_("Reset Scaler"))) {
             changed = true;
@@ -2101,6 +2274,86 @@ bool PCSX::GUI::configure() {
         changed |= ImGui::Checkbox(_("Enable XA decoder"), &settings.get<Emulator::SettingXa>().value);
         changed |= ImGui::Checkbox(_("Always enable SPU IRQ"), &settings.get<Emulator::SettingSpuIrq>().value);
         changed |= ImGui::Checkbox(_("Decode MDEC videos in B&W"), &settings.get<Emulator::SettingBnWMdec>().value);
+        auto &mdecThreads = settings.get<Emulator::SettingMdecThreads>().value;
+        const int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        if (ImGui::SliderInt(_("MDEC decoding threads"), &mdecThreads, 0, maxThreads)) {
+            changed = true;
+            g_emulator->m_mdec->startWorkers();
+        }
+        ImGuiHelpers::ShowHelpMarker(
+            _("Number of worker threads doing the inverse DCT and colour conversion of MDEC videos. "
+              "0 decodes everything on the emulation thread."));
+        changed |= ImGui::SliderInt(_("Frame skip"), &settings.get<Emulator::SettingFrameSkip>().value, 0, 5);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Number of frames skipped after each rendered one.
+Skipped frames aren't displayed, and the drawing
+landing inside the display areas isn't rasterised.
+VRAM transfers and fills still run, as well as
+drawing elsewhere or into parts of VRAM the game
+reads back, so that the game keeps working.)"));
+        changed |= ImGui::Checkbox(_("Skip idle loops"), &settings.get<Emulator::SettingIdleLoopSkip>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Detects the short loops polling memory or status
+registers, waiting for an interrupt or a hardware
+event, and jumps straight to that event instead of
+emulating them. This makes the emulation faster,
+mostly when running faster than realtime.)"));
+        if (settings.get<Emulator::SettingIdleLoopSkip>()) {
+            ImGui::SameLine();
+            ImGui::Text(_("%llu cycles skipped over %llu loops"),
+                        (unsigned long long)g_emulator->m_cpu->m_idleCyclesSkipped,
+                        (unsigned long long)g_emulator->m_cpu->m_idleLoopsSkipped);
+        }
+        changed |= ImGui::Checkbox(_("HLE kernel memory calls"), &settings.get<Emulator::SettingHLEKernelCalls>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Runs the memcpy, memset, bzero, bcopy, strcpy
+and strlen calls of the kernel's A0 table natively,
+charging roughly the cycles the BIOS loops would
+take. Calls with unusual arguments, or made while
+debugging, still go through the BIOS code.)"));
+        changed |= ImGui::Checkbox(_("Rewind"), &settings.get<Emulator::SettingRewind>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Keeps snapshots of the recent past of the emulation,
+to step back through them with F3. Only the parts
+of the state which changed are stored, and the
+oldest snapshots are dropped once over the budget.)"));
+        if (settings.get<Emulator::SettingRewind>()) {
+            ImGui::SameLine();
+            ImGui::Text(_("%zu snapshots, %.1f MB"), g_emulator->m_rewind->count(),
+                        g_emulator->m_rewind->bytes() / (1024.0 * 1024.0));
+            changed |= ImGui::SliderInt(_("Rewind interval (frames)"),
+                                        &settings.get<Emulator::SettingRewindInterval>().value, 1, 300);
+            changed |= ImGui::SliderInt(_("Rewind memory budget (MB)"),
+                                        &settings.get<Emulator::SettingRewindMemory>().value, 16, 4096);
+        }
+        changed |= ImGui::SliderInt(_("Run ahead (frames)"), &settings.get<Emulator::SettingRunAheadFrames>().value, 0,
+                                    RunAhead::MAX_FRAMES);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Hides that many frames of the game's input latency,
+by emulating ahead of the real frame with the same
+input, and showing the furthest one. Every frame
+then costs that many more to emulate, plus a
+snapshot of the state. Disabled while netplay is
+running, or while a movie is recorded or replayed.)"));
+        changed |= ImGui::Checkbox(_("Export state to shared memory"),
+                                   &settings.get<Emulator::SettingSharedStateExport>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Copies VRAM, the SPU RAM and the CPU registers
+to named shared memory at the end of every frame,
+for external tools to read. See the layout in
+src/core/sharedstate-layout.h. With the OpenGL
+renderer, this reads VRAM back from the GPU.)"));
+        {
+            static const std::function<const char*()> codecs[] = {l_("Gzip"), l_("Gzip, fastest"), l_("None")};
+            auto& codec = settings.get<Emulator::SettingSaveStateCompression>().value;
+            if ((codec < 0) || (codec > 2)) codec = 0;
+            if (ImGui::BeginCombo(_("Save state compression"), codecs[codec]())) {
+                for (int i = 0; i < 3; i++) {
+                    if (ImGui::Selectable(codecs[i](), codec == i)) {
+                        changed = true;
+                        codec = i;
+                    }
+                }
+                ImGui::EndCombo();
+            }
+            ImGuiHelpers::ShowHelpMarker(_(R"(Save states get compressed and written in the
+background either way, and can be loaded back
+whichever way they were written.)"));
+        }
         if (ImGui::Checkbox(_("Dynarec CPU"), &settings.get<Emulator::SettingDynarec>().value)) {
             changed = true;
             showDynarecWarning = true;
@@ -2115,6 +2368,33 @@ however it doesn't play nicely with the debugger.
 Changing this setting requires a reboot to take effect.
 The dynarec core isn't available for all CPUs, so
 this setting may not have any effect for you.)"));
+        changed |= ImGui::Checkbox(_("Dynarec fastmem"), &settings.get<Emulator::SettingFastmem>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Lets the dynarec read from RAM through a mirror
+of the PSX address space, using a single host
+instruction per load. Only available on some
+platforms. Changing this setting requires a
+reboot to take effect.)"));
+        changed |=
+            ImGui::Checkbox(_("Dynarec block cache"), &settings.get<Emulator::SettingDynarecBlockCache>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Remembers which blocks the dynarec compiled, and
+how, across sessions. The BIOS gets compiled
+upfront on reset, and blocks which needed full
+load delay emulation get compiled that way
+directly. The cache is discarded when the BIOS
+or the emulator build changes.)"));
+        changed |= ImGui::Checkbox(_("Cached interpreter"), &settings.get<Emulator::SettingCachedInterpreter>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Lets the interpreted CPU decode straight runs
+of instructions once, and reuse them until they
+get overwritten, instead of decoding every
+instruction each time it runs. Only used when
+the debugger and tracing are off.)"));
+        changed |= ImGui::Checkbox(_("Dynarec perf map"), &settings.get<Emulator::SettingDynarecPerfMap>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Writes the address, size, and guest PC of every
+block the dynarec compiles to /tmp/perf-<pid>.map,
+so that host profilers such as perf can attribute
+time spent in recompiled code. Linux only.
+Changing this setting requires a reboot to take
+effect.)"));
         bool memChanged = ImGui::Checkbox(_("8MB"), &settings.get<Emulator::Setting8MB>().value);
         ImGuiHelpers::ShowHelpMarker(_(R"(Emulates an installed 8MB system,
 instead of the normal 2MB. Useful for working
@@ -2160,6 +2440,12 @@ when changing this setting.)"));
 which may include additional checks.
 Also will make the boot time substantially
 faster by not displaying the logo.)"));
+        changed |= ImGui::Checkbox(_("Boot cache"), &settings.get<Emulator::SettingBootCache>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Saves the state of the machine the first time
+the BIOS reaches the shell, and resumes from it
+on the next boots, skipping the BIOS initialization.
+There is one state per BIOS, RAM size, video
+standard and disc.)"));
         auto bios = settings.get<Emulator::SettingBios>().string();
         ImGui::InputText(_("BIOS file"), const_cast<char*>(reinterpret_cast<const char*>(bios.c_str())), bios.length(),
                          ImGuiInputTextFlags_ReadOnly);
@@ -2175,6 +2461,18 @@ faster by not displaying the logo.)"));
         ImGuiHelpers::ShowHelpMarker(_(R"(This will enable the usage of various breakpoints
 throughout the execution of mips code. Enabling this
 can slow down emulation to a noticeable extent.)"));
+        if (ImGui::Checkbox(_("Page protection watchpoints"),
+                            &debugSettings.get<Emulator::DebugSettings::PageWatchpoints>().value)) {
+            changed = true;
+            g_emulator->m_debug->updateWatchpoints();
+        }
+        ImGuiHelpers::ShowHelpMarker(_(R"(Catches read and write breakpoints on RAM by
+protecting the host memory pages they are in,
+instead of checking every memory access. This
+works with the dynarec too, but the emulation
+stops at the end of the block doing the access
+rather than right on it. Only available on some
+platforms.)"));
         if (ImGui::Checkbox(_("Enable GDB Server"), &debugSettings.get<Emulator::DebugSettings::GdbServer>().value)) {
             changed = true;
             if (debugSettings.get<Emulator::DebugSettings::GdbServer>()) {
@@ -2367,6 +2665,51 @@ void PCSX::GUI::interruptsScaler() {
     ImGui::End();
 }
 
+void PCSX::GUI::frameStats() {
+    ImGui::SetNextWindowSize(ImVec2(360, 260), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin(_("Frame Statistics"), &m_showFrameStats)) {
+        const auto frame = g_emulator->m_frameStats->average();
+        const uint64_t wallTime = frame.wallTime();
+        ImGui::Text(_("%.2f ms per frame, %llu emulated cycles"), wallTime / 1000000.0,
+                    (unsigned long long)frame.cycles);
+        ImGui::TextUnformatted(_("Averaged over the last 60 frames."));
+        ImGui::Separator();
+        if (ImGui::BeginTable("FrameStats", 2, ImGuiTableFlags_SizingStretchProp)) {
+            for (unsigned i = 0; i < FrameStats::COUNT; i++) {
+                const double ms = frame.nanoseconds[i] / 1000000.0;
+                const float fraction = wallTime == 0 ? 0.0f : float(frame.nanoseconds[i]) / wallTime;
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextUnformatted(FrameStats::c_names[i]);
+                ImGui::TableSetColumnIndex(1);
+                const std::string label = fmt::format("{:.2f} ms", ms);
+                ImGui::ProgressBar(std::min(fraction, 1.0f), ImVec2(-1, 0), label.c_str());
+            }
+            ImGui::EndTable();
+        }
+        ImGui::TextWrapped(
+            "%s", _("The rasterizer runs on its own thread, alongside the rest, and is shown relative to the frame."));
+        ImGui::Separator();
+        const auto& pacer = *g_emulator->m_framePacer;
+        const auto present = pacer.presentStats();
+        ImGui::Text(_("Presents: %.2f ms on average, %.2f ms deviation"), present.mean, present.stddev);
+        ImGui::Text(_("Shortest %.2f ms, longest %.2f ms, over %u presents"), present.min, present.max, present.count);
+        if (m_framePacing) {
+            const double work = std::chrono::duration<double, std::milli>(pacer.workEstimate()).count();
+            ImGui::Text(_("Paced, with frames estimated to take %.2f ms"), work);
+        }
+    }
+    ImGui::End();
+}
+
+void PCSX::GUI::updateLogFilter() {
+    // The log classes turned off here get dropped on output, so they may as well not get formatted at all.
+    if (!g_system->getArgs().isGUILogsEnabled()) return;
+    for (auto logClass : magic_enum::enum_values<LogClass>()) {
+        g_system->setLogEnabled(logClass, m_log.enabled(magic_enum::enum_integer(logClass)));
+    }
+}
+
 bool PCSX::GUI::showThemes() {
     static const std::function<const char*()> imgui_themes[] = {
         l_("Default theme##Theme name"), l_("Classic##Theme name"), l_("Light##Theme name"), l_("Cherry##Theme name"),
@@ -2440,6 +2783,8 @@ bool PCSX::GUI::about() {
                     std::string timestamp = fmt::format("{:%Y-%m-%d %H:%M:%S}", tm);
                     ImGui::Text(_("Date & time: %s"), timestamp.c_str());
                 }
+                ImGui::Separator();
+                ImGui::Text(_("Time to first frame: %lli ms"), static_cast<long long>(m_timeToFirstFrame.count()));
                 ImGui::EndTabItem();
             }
             ImGuiTabItemFlags flag = 0;
@@ -2597,8 +2942,23 @@ bool PCSX::GUI::about() {
 }
 
 void PCSX::GUI::update(bool vsync) {
+    // When the emulation is running behind, which is when the audio throttling didn't have to wait at all
+    // during the last frame, drawing the GUI gets skipped for a few vsyncs, so that the cost of the debugging
+    // windows stops adding up to how slow it runs. The events still get polled, to keep the input responsive.
+    if (vsync && (m_skippedGUIFrames < m_maxGUIFrameSkip) &&
+        (g_emulator->m_frameStats->lastFrame().nanoseconds[FrameStats::Idle] == 0)) {
+        m_skippedGUIFrames++;
+        tick();
+        glfwPollEvents();
+        g_emulator->m_pads->sampleHostInput();
+        return;
+    }
+    m_skippedGUIFrames = 0;
     glDisable(GL_SCISSOR_TEST);
     endFrame();
+    // The events get polled in startFrame, so the pacing delay goes in between, for the input to be as recent
+    // as possible when the emulation resumes.
+    if (vsync) paceFrame();
     startFrame();
     // At all times, either the emulated GPU core or the GUI have full control of the host GPU & the GL context
     // We do this by having the emulated GPU have it most of the time, then let the GUI steal it when it needs it.
@@ -2606,6 +2966,68 @@ void PCSX::GUI::update(bool vsync) {
     g_emulator->m_gpu->setOpenGLContext();
 }
 
+double PCSX::GUI::hostRefreshRate() {
+    GLFWmonitor* monitor = glfwGetWindowMonitor(m_window);
+    if (!monitor) {
+        // Windowed, so it's whichever monitor has the center of the window.
+        int x, y, w, h;
+        glfwGetWindowPos(m_window, &x, &y);
+        glfwGetWindowSize(m_window, &w, &h);
+        const int cx = x + w / 2;
+        const int cy = y + h / 2;
+        int count = 0;
+        GLFWmonitor** monitors = glfwGetMonitors(&count);
+        for (int i = 0; i < count; i++) {
+            int mx, my;
+            glfwGetMonitorPos(monitors[i], &mx, &my);
+            const GLFWvidmode* mode = glfwGetVideoMode(monitors[i]);
+            if (!mode) continue;
+            if ((cx >= mx) && (cx < mx + mode->width) && (cy >= my) && (cy < my + mode->height)) {
+                monitor = monitors[i];
+                break;
+            }
+        }
+        if (!monitor) monitor = glfwGetPrimaryMonitor();
+    }
+    const GLFWvidmode* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+    return mode ? mode->refreshRate : 0.0;
+}
+
+void PCSX::GUI::paceFrame() {
+    auto& pacer = *g_emulator->m_framePacer;
+    // Pacing to the host display only works out when it refreshes at about the emulated frame rate, as the
+    // blocking swaps would otherwise drag the emulation away from the audio.
+    bool pacing = m_framePacingEnabled && !g_system->getArgs().isTurboEnabled();
+    double hostHz = 0.0;
+    if (pacing) {
+        hostHz = hostRefreshRate();
+        const auto frame = g_emulator->m_frameStats->average();
+        const double emulatedHz = frame.cycles == 0 ? 0.0
+                                                    : double(g_emulator->m_psxClockSpeed) / frame.cycles *
+                                                          g_emulator->settings.get<Emulator::SettingScaler>() / 100.0;
+        pacing = FramePacer::ratesMatch(hostHz, emulatedHz);
+    }
+    if (pacing != m_framePacing) {
+        m_framePacing = pacing;
+        glfwSwapInterval(pacing ? 1 : 0);
+        pacer.reset();
+    }
+    if (pacing) {
+        const auto period =
+            std::chrono::duration_cast<FramePacer::clock::duration>(std::chrono::duration<double>(1.0 / hostHz));
+        const auto delay = pacer.delay(period);
+        if (delay > FramePacer::clock::duration::zero()) {
+            FrameStats::Scope scope(FrameStats::Idle);
+            // The OS timers can be a lot coarser than the margin, so the last millisecond gets yielded away instead.
+            const auto target = FramePacer::clock::now() + delay;
+            const auto coarse = delay - std::chrono::milliseconds(1);
+            if (coarse > FramePacer::clock::duration::zero()) std::this_thread::sleep_for(coarse);
+            while (FramePacer::clock::now() < target) std::this_thread::yield();
+        }
+    }
+    pacer.begin(FramePacer::clock::now());
+}
+
 void PCSX::GUI::magicOpen(const char* pathStr) {
     std::filesystem::path path = pathStr;
     bool success = false;
@@ -2614,7 +3036,7 @@ void PCSX::GUI::magicOpen(const char* pathStr) {
     // Is this something that looks like a binary we can load ?
     try {
         BinaryLoader::Info info;
-        std::map<uint32_t, std::string> symbols;
+        SymbolTable symbols;
         success = BinaryLoader::load(file, new Mem4G(), info, symbols);
         if (success) success = info.pc.has_value();
     } catch (...) {
@@ -2719,46 +3141,23 @@ bool PCSX::GUI::saveSaveState(std::filesystem::path filename) {
     if (filename.is_relative()) {
         filename = g_system->getPersistentDir() / filename;
     }
-    // TODO: yeet this to libuv's threadpool.
-    ZWriter save(new UvFile(filename, FileOps::TRUNCATE), ZWriter::GZIP);
-    bool success = !save.failed();
-    if (success) save.writeString(SaveStates::save());
-    save.close();
-    return success;
+    const int codec = g_emulator->settings.get<Emulator::SettingSaveStateCompression>();
+    return m_saveStateWriter.save(filename, static_cast<SaveStates::Codec>(codec));
 }
 
 bool PCSX::GUI::loadSaveState(std::filesystem::path filename) {
     if (filename.is_relative()) {
         filename = g_system->getPersistentDir() / filename;
     }
-    ZReader save(new PosixFile(filename));
-    if (save.failed()) return false;
-    std::ostringstream os;
-    constexpr unsigned buff_size = 1 << 16;
-    char* buff = new char[buff_size];
-    bool error = false;
-
-    while (!save.eof()) {
-        auto cnt = save.read(buff, buff_size);
-        if (cnt == 0) break;
-        if (cnt < 0) {
-            error = true;
-            break;
-        }
-        os.write(buff, cnt);
-    }
-
-    save.close();
-    delete[] buff;
-
-    if (!error) SaveStates::load(os.str());
-    return !error;
+    m_saveStateWriter.wait();
+    return SaveStates::load(new PosixFile(filename));
 }
 
 bool PCSX::GUI::deleteSaveState(std::filesystem::path filename) {
     if (filename.is_relative()) {
         filename = g_system->getPersistentDir() / filename;
     }
+    m_saveStateWriter.wait();
     return std::remove(filename.string().c_str()) == 0;
 }
 
@@ -2772,7 +3171,8 @@ bool PCSX::GUI::saveStateExists(std::filesystem::path filename) {
     if (filename.is_relative()) {
         filename = g_system->getPersistentDir() / filename;
     }
-    ZReader save(new PosixFile(filename));
+    m_saveStateWriter.wait();
+    PosixFile save(filename);
     return !save.failed();
 }
 
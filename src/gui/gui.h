@@ -22,6 +22,8 @@
 #include <GL/gl3w.h>
 #include <stdarg.h>
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <magic_enum_all.hpp>
 #include <map>
@@ -32,10 +34,12 @@
 #include <utility>
 #include <vector>
 
+#include "core/sstate.h"
 #include "core/system.h"
 #include "core/ui.h"
 #include "flags.h"
 #include "fmt/printf.h"
+#include "gui/programcache.h"
 #include "gui/widgets/assembly.h"
 #include "gui/widgets/breakpoints.h"
 #include "gui/widgets/callstacks.h"
@@ -119,6 +123,9 @@ class GUI final : public UI {
     typedef Setting<int, TYPESTRING("WindowSizeY"), 800> WindowSizeY;
     typedef Setting<bool, TYPESTRING("WindowMaximized"), false> WindowMaximized;
     typedef Setting<int, TYPESTRING("IdleSwapInterval"), 1> IdleSwapInterval;
+    typedef Setting<int, TYPESTRING("MaxGUIFrameSkip"), 2> MaxGUIFrameSkip;
+    typedef Setting<int, TYPESTRING("IdleRedrawRate"), 10> IdleRedrawRate;
+    typedef Setting<bool, TYPESTRING("FramePacing"), false> FramePacing;
     typedef Setting<int, TYPESTRING("MainFontSize"), 16> MainFontSize;
     typedef Setting<int, TYPESTRING("MonoFontSize"), 16> MonoFontSize;
     typedef Setting<int, TYPESTRING("GUITheme"), 0> GUITheme;
@@ -163,7 +170,8 @@ class GUI final : public UI {
              ShowMemoryEditor8, ShowParallelPortEditor, ShowScratchpadEditor, ShowHWRegsEditor, ShowBiosEditor,
              ShowVRAMEditor, MemoryEditor1Addr, MemoryEditor2Addr, MemoryEditor3Addr, MemoryEditor4Addr,
              MemoryEditor5Addr, MemoryEditor6Addr, MemoryEditor7Addr, MemoryEditor8Addr, ParallelPortEditorAddr,
-             ScratchpadEditorAddr, HWRegsEditorAddr, BiosEditorAddr, VRAMEditorAddr>
+             ScratchpadEditorAddr, HWRegsEditorAddr, BiosEditorAddr, VRAMEditorAddr, MaxGUIFrameSkip,
+             IdleRedrawRate, FramePacing>
         settings;
 
     // imgui can't handle more than one "instance", so...
@@ -220,9 +228,11 @@ class GUI final : public UI {
     void setFullscreen(bool fullscreen);
     void setRawMouseMotion();
     bool addLog(LogClass logClass, const std::string &msg) {
+        requestRedraw();
         return m_log.addLog(magic_enum::enum_integer(logClass), msg);
     }
     void addLuaLog(const std::string &msg, bool error) {
+        requestRedraw();
         if (error) {
             m_luaConsole.addError(msg);
         } else {
@@ -258,7 +268,14 @@ class GUI final : public UI {
         bool m_toOpen = false;
         std::string m_message;
     };
-    void addNotification(const std::string &notification) { m_notifier.notify(notification); }
+    void addNotification(const std::string &notification) {
+        requestRedraw();
+        m_notifier.notify(notification);
+    }
+    // While the emulation is paused, the GUI only gets redrawn on input, when this gets called, and at the
+    // IdleRedrawRate otherwise. Widgets which animate call this on each frame they draw, to keep the redraws
+    // going. It can be called from any thread.
+    void requestRedraw();
 
     void magicOpen(const char *path);
 
@@ -283,11 +300,16 @@ class GUI final : public UI {
 
     void startFrame();
     void endFrame();
+    void waitForEvents();
+    void paceFrame();
+    double hostRefreshRate();
 
     bool configure();
     bool showThemes();  // Theme window : Allows for custom imgui themes
     bool about();
     void interruptsScaler();
+    void frameStats();
+    void updateLogFilter();
 
   public:
     const ImVec2 &getRenderSize() { return m_renderSize; }
@@ -320,11 +342,20 @@ class GUI final : public UI {
     bool &m_fullWindowRender = {settings.get<FullWindowRender>().value};
     bool &m_showMenu = {settings.get<ShowMenu>().value};
     int &m_idleSwapInterval = {settings.get<IdleSwapInterval>().value};
+    int &m_maxGUIFrameSkip = {settings.get<MaxGUIFrameSkip>().value};
+    int m_skippedGUIFrames = 0;
+    int &m_idleRedrawRate = {settings.get<IdleRedrawRate>().value};
+    bool &m_framePacingEnabled = {settings.get<FramePacing>().value};
+    // Whether the swap interval is currently set for the frame pacer.
+    bool m_framePacing = false;
+    std::atomic<bool> m_redrawRequested = false;
+    unsigned m_eagerFrames = 0;
     bool m_showThemes = false;
     bool m_showDemo = false;
     bool m_showHandles = false;
     bool m_showAbout = false;
     bool m_showInterruptsScaler = false;
+    bool m_showFrameStats = false;
     Widgets::Log m_log = {settings.get<ShowLog>().value};
     struct MemoryEditorWrapper {
         MemoryEditorWrapper(GUI *gui, bool &show, size_t &offsetAddr, size_t baseAddr = 0x0000)
@@ -377,6 +408,7 @@ class GUI final : public UI {
     Widgets::FileDialog<> m_selectBiosDialog;
     Widgets::FileDialog<> m_selectEXP1Dialog;
     Widgets::NamedSaveStates m_namedSaveStates = {settings.get<ShowNamedSaveStates>().value};
+    SaveStates::FileWriter m_saveStateWriter;
     Widgets::Breakpoints m_breakpoints = {settings.get<ShowBreakpoints>().value};
     Widgets::IsoBrowser m_isoBrowser;
 
@@ -441,12 +473,14 @@ class GUI final : public UI {
     ImFont *findClosestFont(const std::map<float, ImFont *> &fonts);
     std::set<float> m_allScales;
     bool m_hasJapanese = false;
+    bool m_wantJapanese = false;
     float m_currentScale = 1.0f;
 
     ImFont *loadFont(const PCSX::u8string &name, int size, ImGuiIO &io, const ImWchar *ranges, bool combine,
                      bool isSymbolsFont);
 
     bool m_reloadFonts = true;
+    ProgramCache m_programCache;
     Widgets::ShaderEditor m_outputShaderEditor = {"output"};
 
     static void byteRateToString(float rate, std::string &out);
@@ -455,6 +489,8 @@ class GUI final : public UI {
     bool m_updateAvailable = false;
     bool m_updateDownloading = false;
     bool m_aboutSelectAuthors = false;
+    // How long it took from the process starting to the first frame showing up, as reported in the About dialog.
+    std::chrono::milliseconds m_timeToFirstFrame{0};
     bool m_enableSplashScreen = true;
 
     void setDefaultShaders();
@@ -462,6 +498,7 @@ class GUI final : public UI {
 
   public:
     bool hasJapanese() { return m_hasJapanese; }
+    ProgramCache &getProgramCache() { return m_programCache; }
     bool m_setupScreenSize = true;
     bool m_clearTextures = true;
     Widgets::ShaderEditor m_offscreenShaderEditor = {"offscreen"};
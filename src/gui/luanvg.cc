@@ -19,6 +19,12 @@
 
 #include "gui/luanvg.h"
 
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
 #include "gui/gui.h"
 #include "lua/luawrapper.h"
 #include "nanovg/src/nanovg.h"
@@ -59,6 +65,281 @@ void nvgImagePatternWrapper(NVGcontext* ctx, float ox, float oy, float ex, float
     *ret = nvgImagePattern(ctx, ox, oy, ex, ey, angle, image, alpha);
 }
 
+// A retained list of drawing commands, which scripts record once and only update when what they draw changes. The
+// whole list then gets replayed with a single call from Lua each frame, instead of one per command. The opcodes have
+// to match the ones in nvgffi.lua.
+class DisplayList {
+  public:
+    enum class Op : int {
+        Save,
+        Restore,
+        Reset,
+        ShapeAntiAlias,
+        MiterLimit,
+        StrokeWidth,
+        LineCap,
+        LineJoin,
+        GlobalAlpha,
+        GlobalCompositeOperation,
+        ResetTransform,
+        Translate,
+        Rotate,
+        SkewX,
+        SkewY,
+        Scale,
+        Scissor,
+        IntersectScissor,
+        ResetScissor,
+        BeginPath,
+        MoveTo,
+        LineTo,
+        BezierTo,
+        QuadTo,
+        ArcTo,
+        ClosePath,
+        PathWinding,
+        Arc,
+        Rect,
+        RoundedRect,
+        RoundedRectVarying,
+        Ellipse,
+        Circle,
+        Fill,
+        Stroke,
+        FontSize,
+        FontBlur,
+        TextLetterSpacing,
+        TextLineHeight,
+        TextAlign,
+        FontFaceId,
+        // Those take their arguments from the dedicated recording functions below.
+        StrokeColor,
+        FillColor,
+        StrokePaint,
+        FillPaint,
+        FontFace,
+        Text,
+        TextBox,
+    };
+
+    void clear() {
+        m_commands.clear();
+        m_args.clear();
+        m_strings.clear();
+    }
+    void command(Op op, const float* args, unsigned count) {
+        m_commands.push_back({op, uint32_t(m_args.size())});
+        m_args.insert(m_args.end(), args, args + count);
+    }
+    template <typename T>
+    void command(Op op, const T& arg) {
+        static_assert(sizeof(T) % sizeof(float) == 0);
+        float args[sizeof(T) / sizeof(float)];
+        memcpy(args, &arg, sizeof(T));
+        command(op, args, sizeof(T) / sizeof(float));
+    }
+    void text(Op op, float x, float y, float breakRowWidth, const char* string) {
+        const float args[3] = {x, y, breakRowWidth};
+        command(op, args, 3);
+        m_commands.back().string = uint32_t(m_strings.size());
+        m_strings.emplace_back(string);
+    }
+
+    void replay(NVGcontext* ctx) {
+        for (auto& command : m_commands) {
+            const float* a = m_args.data() + command.args;
+            switch (command.op) {
+                case Op::Save:
+                    nvgSave(ctx);
+                    break;
+                case Op::Restore:
+                    nvgRestore(ctx);
+                    break;
+                case Op::Reset:
+                    nvgReset(ctx);
+                    break;
+                case Op::ShapeAntiAlias:
+                    nvgShapeAntiAlias(ctx, int(a[0]));
+                    break;
+                case Op::MiterLimit:
+                    nvgMiterLimit(ctx, a[0]);
+                    break;
+                case Op::StrokeWidth:
+                    nvgStrokeWidth(ctx, a[0]);
+                    break;
+                case Op::LineCap:
+                    nvgLineCap(ctx, int(a[0]));
+                    break;
+                case Op::LineJoin:
+                    nvgLineJoin(ctx, int(a[0]));
+                    break;
+                case Op::GlobalAlpha:
+                    nvgGlobalAlpha(ctx, a[0]);
+                    break;
+                case Op::GlobalCompositeOperation:
+                    nvgGlobalCompositeOperation(ctx, int(a[0]));
+                    break;
+                case Op::ResetTransform:
+                    nvgResetTransform(ctx);
+                    break;
+                case Op::Translate:
+                    nvgTranslate(ctx, a[0], a[1]);
+                    break;
+                case Op::Rotate:
+                    nvgRotate(ctx, a[0]);
+                    break;
+                case Op::SkewX:
+                    nvgSkewX(ctx, a[0]);
+                    break;
+                case Op::SkewY:
+                    nvgSkewY(ctx, a[0]);
+                    break;
+                case Op::Scale:
+                    nvgScale(ctx, a[0], a[1]);
+                    break;
+                case Op::Scissor:
+                    nvgScissor(ctx, a[0], a[1], a[2], a[3]);
+                    break;
+                case Op::IntersectScissor:
+                    nvgIntersectScissor(ctx, a[0], a[1], a[2], a[3]);
+                    break;
+                case Op::ResetScissor:
+                    nvgResetScissor(ctx);
+                    break;
+                case Op::BeginPath:
+                    nvgBeginPath(ctx);
+                    break;
+                case Op::MoveTo:
+                    nvgMoveTo(ctx, a[0], a[1]);
+                    break;
+                case Op::LineTo:
+                    nvgLineTo(ctx, a[0], a[1]);
+                    break;
+                case Op::BezierTo:
+                    nvgBezierTo(ctx, a[0], a[1], a[2], a[3], a[4], a[5]);
+                    break;
+                case Op::QuadTo:
+                    nvgQuadTo(ctx, a[0], a[1], a[2], a[3]);
+                    break;
+                case Op::ArcTo:
+                    nvgArcTo(ctx, a[0], a[1], a[2], a[3], a[4]);
+                    break;
+                case Op::ClosePath:
+                    nvgClosePath(ctx);
+                    break;
+                case Op::PathWinding:
+                    nvgPathWinding(ctx, int(a[0]));
+                    break;
+                case Op::Arc:
+                    nvgArc(ctx, a[0], a[1], a[2], a[3], a[4], int(a[5]));
+                    break;
+                case Op::Rect:
+                    nvgRect(ctx, a[0], a[1], a[2], a[3]);
+                    break;
+                case Op::RoundedRect:
+                    nvgRoundedRect(ctx, a[0], a[1], a[2], a[3], a[4]);
+                    break;
+                case Op::RoundedRectVarying:
+                    nvgRoundedRectVarying(ctx, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+                    break;
+                case Op::Ellipse:
+                    nvgEllipse(ctx, a[0], a[1], a[2], a[3]);
+                    break;
+                case Op::Circle:
+                    nvgCircle(ctx, a[0], a[1], a[2]);
+                    break;
+                case Op::Fill:
+                    nvgFill(ctx);
+                    break;
+                case Op::Stroke:
+                    nvgStroke(ctx);
+                    break;
+                case Op::FontSize:
+                    nvgFontSize(ctx, a[0]);
+                    break;
+                case Op::FontBlur:
+                    nvgFontBlur(ctx, a[0]);
+                    break;
+                case Op::TextLetterSpacing:
+                    nvgTextLetterSpacing(ctx, a[0]);
+                    break;
+                case Op::TextLineHeight:
+                    nvgTextLineHeight(ctx, a[0]);
+                    break;
+                case Op::TextAlign:
+                    nvgTextAlign(ctx, int(a[0]));
+                    break;
+                case Op::FontFaceId:
+                    nvgFontFaceId(ctx, int(a[0]));
+                    break;
+                case Op::StrokeColor:
+                    nvgStrokeColor(ctx, load<NVGcolor>(a));
+                    break;
+                case Op::FillColor:
+                    nvgFillColor(ctx, load<NVGcolor>(a));
+                    break;
+                case Op::StrokePaint:
+                    nvgStrokePaint(ctx, load<NVGpaint>(a));
+                    break;
+                case Op::FillPaint:
+                    nvgFillPaint(ctx, load<NVGpaint>(a));
+                    break;
+                case Op::FontFace: {
+                    // Looking fonts up by name is a linear search, so only do it once.
+                    if (command.font < 0 || command.fontContext != ctx) {
+                        command.font = nvgFindFont(ctx, m_strings[command.string].c_str());
+                        command.fontContext = ctx;
+                    }
+                    if (command.font >= 0) nvgFontFaceId(ctx, command.font);
+                    break;
+                }
+                case Op::Text: {
+                    const auto& string = m_strings[command.string];
+                    nvgText(ctx, a[0], a[1], string.data(), string.data() + string.size());
+                    break;
+                }
+                case Op::TextBox: {
+                    const auto& string = m_strings[command.string];
+                    nvgTextBox(ctx, a[0], a[1], a[2], string.data(), string.data() + string.size());
+                    break;
+                }
+            }
+        }
+    }
+
+  private:
+    template <typename T>
+    static T load(const float* args) {
+        T ret;
+        memcpy(&ret, args, sizeof(T));
+        return ret;
+    }
+
+    struct Command {
+        Op op;
+        uint32_t args;
+        uint32_t string = 0;
+        int font = -1;
+        NVGcontext* fontContext = nullptr;
+    };
+    std::vector<Command> m_commands;
+    std::vector<float> m_args;
+    std::vector<std::string> m_strings;
+};
+
+DisplayList* nvgDisplayListCreate() { return new DisplayList(); }
+void nvgDisplayListDestroy(DisplayList* list) { delete list; }
+void nvgDisplayListClear(DisplayList* list) { list->clear(); }
+void nvgDisplayListCommand(DisplayList* list, int op, const float* args, unsigned count) {
+    list->command(DisplayList::Op(op), args, count);
+}
+void nvgDisplayListColor(DisplayList* list, int op, NVGcolor color) { list->command(DisplayList::Op(op), color); }
+void nvgDisplayListPaint(DisplayList* list, int op, NVGpaint paint) { list->command(DisplayList::Op(op), paint); }
+void nvgDisplayListText(DisplayList* list, int op, float x, float y, float breakRowWidth, const char* string) {
+    list->text(DisplayList::Op(op), x, y, breakRowWidth, string);
+}
+void nvgDisplayListDraw(NVGcontext* ctx, DisplayList* list) { list->replay(ctx); }
+
 template <typename T, size_t S>
 void registerSymbol(PCSX::Lua L, const char (&name)[S], const T ptr) {
     L.push<S>(name);
@@ -169,6 +450,15 @@ void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, nvgTextMetrics);
     REGISTER(L, nvgTextBreakLines);
 
+    REGISTER(L, nvgDisplayListCreate);
+    REGISTER(L, nvgDisplayListDestroy);
+    REGISTER(L, nvgDisplayListClear);
+    REGISTER(L, nvgDisplayListCommand);
+    REGISTER(L, nvgDisplayListColor);
+    REGISTER(L, nvgDisplayListPaint);
+    REGISTER(L, nvgDisplayListText);
+    REGISTER(L, nvgDisplayListDraw);
+
     REGISTER(L, guiDrawBezierArrow);
 
     L.settable();
@@ -151,6 +151,16 @@ int nvgTextGlyphPositions(NVGcontext* ctx, float x, float y, const char* string,
 void nvgTextMetrics(NVGcontext* ctx, float* ascender, float* descender, float* lineh);
 int nvgTextBreakLines(NVGcontext* ctx, const char* string, const char* end, float breakRowWidth, NVGtextRow* rows, int maxRows);
 
+typedef struct NVGdisplayList NVGdisplayList;
+NVGdisplayList* nvgDisplayListCreate();
+void nvgDisplayListDestroy(NVGdisplayList* list);
+void nvgDisplayListClear(NVGdisplayList* list);
+void nvgDisplayListCommand(NVGdisplayList* list, int op, const float* args, unsigned count);
+void nvgDisplayListColor(NVGdisplayList* list, int op, NVGcolor color);
+void nvgDisplayListPaint(NVGdisplayList* list, int op, NVGpaint paint);
+void nvgDisplayListText(NVGdisplayList* list, int op, float x, float y, float breakRowWidth, const char* string);
+void nvgDisplayListDraw(NVGcontext* ctx, NVGdisplayList* list);
+
 void guiDrawBezierArrow(void* gui, float width, ImVec2 p1, ImVec2 c1, ImVec2 c2, ImVec2 p2, NVGcolor innerColor, NVGcolor outerColor);
 ]]
 
@@ -254,6 +254,25 @@ nvg = {
         C.nvgDrawBezierArrow(self._gui, width, p1, c1, c2, p2, innerColor, outerColor)
     end,
 
+    drawDisplayList = function(self, list) C.nvgDisplayListDraw(self._ctx, list._wrapper) end,
+    -- Attached display lists get drawn every frame, before the queued functions, until detached.
+    attachDisplayList = function(self, list, viewportId)
+        viewportId = viewportId or imgui.extra.getCurrentViewportId()
+        local lists = self._retained[viewportId]
+        if lists == nil then
+            lists = {}
+            self._retained[viewportId] = lists
+        end
+        for i = 1, #lists do if lists[i] == list then return end end
+        lists[#lists + 1] = list
+    end,
+    detachDisplayList = function(self, list)
+        for _, lists in pairs(self._retained) do
+            for i = #lists, 1, -1 do if lists[i] == list then table.remove(lists, i) end end
+        end
+    end,
+    _retained = {},
+
     queueNvgRender = function(self, func)
         local viewportId = imgui.extra.getCurrentViewportId()
         local viewportQueue = self._queue[viewportId]
@@ -265,6 +284,8 @@ nvg = {
     end,
     _queue = {},
     _processQueueForViewportId = function(self, viewportId)
+        local lists = self._retained[viewportId]
+        if lists ~= nil then for i = 1, #lists do C.nvgDisplayListDraw(self._ctx, lists[i]._wrapper) end end
         local viewportQueue = self._queue[viewportId]
         if viewportQueue == nil then return end
         for i = 1, #viewportQueue do viewportQueue[i]() end
@@ -272,4 +293,59 @@ nvg = {
     end,
 }
 
+-- Display lists record the same calls as the nvg object, minus the ones returning something, and get drawn
+-- with nvg:drawDisplayList or nvg:attachDisplayList. The order of the opcodes must match luanvg.cc.
+local displayListOps = {
+    'save', 'restore', 'reset', 'shapeAntiAlias', 'miterLimit', 'strokeWidth', 'lineCap', 'lineJoin',
+    'globalAlpha', 'globalCompositeOperation', 'resetTransform', 'translate', 'rotate', 'skewX', 'skewY', 'scale',
+    'scissor', 'intersectScissor', 'resetScissor', 'beginPath', 'moveTo', 'lineTo', 'bezierTo', 'quadTo', 'arcTo',
+    'closePath', 'pathWinding', 'arc', 'rect', 'roundedRect', 'roundedRectVarying', 'ellipse', 'circle', 'fill',
+    'stroke', 'fontSize', 'fontBlur', 'textLetterSpacing', 'textLineHeight', 'textAlign', 'fontFaceId',
+    'strokeColor', 'fillColor', 'strokePaint', 'fillPaint', 'fontFace', 'text', 'textBox',
+}
+local displayListOpcodes = {}
+for i, name in ipairs(displayListOps) do displayListOpcodes[name] = i - 1 end
+
+local displayListArgs = ffi.new('float[8]')
+local displayListMethods = {
+    clear = function(self) C.nvgDisplayListClear(self._wrapper) end,
+    shapeAntiAlias = function(self, enabled)
+        displayListArgs[0] = enabled and 1 or 0
+        C.nvgDisplayListCommand(self._wrapper, displayListOpcodes.shapeAntiAlias, displayListArgs, 1)
+    end,
+    strokeColor = function(self, color)
+        C.nvgDisplayListColor(self._wrapper, displayListOpcodes.strokeColor, color)
+    end,
+    fillColor = function(self, color) C.nvgDisplayListColor(self._wrapper, displayListOpcodes.fillColor, color) end,
+    strokePaint = function(self, paint)
+        C.nvgDisplayListPaint(self._wrapper, displayListOpcodes.strokePaint, paint)
+    end,
+    fillPaint = function(self, paint) C.nvgDisplayListPaint(self._wrapper, displayListOpcodes.fillPaint, paint) end,
+    fontFace = function(self, font) C.nvgDisplayListText(self._wrapper, displayListOpcodes.fontFace, 0, 0, 0, font) end,
+    text = function(self, x, y, string)
+        C.nvgDisplayListText(self._wrapper, displayListOpcodes.text, x, y, 0, string)
+    end,
+    textBox = function(self, x, y, breakRowWidth, string)
+        C.nvgDisplayListText(self._wrapper, displayListOpcodes.textBox, x, y, breakRowWidth, string)
+    end,
+}
+for _, name in ipairs(displayListOps) do
+    if displayListMethods[name] == nil then
+        local op = displayListOpcodes[name]
+        displayListMethods[name] = function(self, ...)
+            local count = select('#', ...)
+            for i = 1, count do displayListArgs[i - 1] = select(i, ...) end
+            C.nvgDisplayListCommand(self._wrapper, op, displayListArgs, count)
+        end
+    end
+end
+local displayListMeta = { __index = displayListMethods }
+
+nvg.DisplayList = {
+    New = function()
+        local list = { _wrapper = ffi.gc(C.nvgDisplayListCreate(), C.nvgDisplayListDestroy) }
+        return setmetatable(list, displayListMeta)
+    end,
+}
+
 -- )EOF"
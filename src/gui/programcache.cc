@@ -0,0 +1,153 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "gui/programcache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include "fmt/format.h"
+
+void PCSX::ProgramCache::init(const std::filesystem::path& directory) {
+    m_enabled = false;
+    if (gl3wIsCppThrower(reinterpret_cast<GL3WglProc>(glGetProgramBinary)) ||
+        gl3wIsCppThrower(reinterpret_cast<GL3WglProc>(glProgramBinary)) ||
+        gl3wIsCppThrower(reinterpret_cast<GL3WglProc>(glProgramParameteri))) {
+        return;
+    }
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0) return;
+
+    m_driver.clear();
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        auto string = reinterpret_cast<const char*>(glGetString(name));
+        if (string) m_driver += string;
+        m_driver += '\n';
+    }
+    m_directory = directory;
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    m_enabled = !ec;
+}
+
+uint64_t PCSX::ProgramCache::key(std::initializer_list<std::string_view> sources) const {
+    // FNV-1a, with the lengths thrown in so that moving text from one source to the next changes the key.
+    uint64_t hash = 0xcbf29ce484222325;
+    auto add = [&hash](std::string_view data) {
+        for (char c : data) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3;
+        }
+    };
+    add(m_driver);
+    for (auto source : sources) {
+        const uint64_t size = source.size();
+        add({reinterpret_cast<const char*>(&size), sizeof(size)});
+        add(source);
+    }
+    return hash;
+}
+
+std::filesystem::path PCSX::ProgramCache::path(uint64_t key) const {
+    return m_directory / fmt::format("{:016x}.bin", key);
+}
+
+// Every entry holds the key, the driver string and the binary format, followed by the binary itself. The
+// driver string gets checked again, as it's what tells apart the binaries of two different drivers.
+GLuint PCSX::ProgramCache::load(std::initializer_list<std::string_view> sources) {
+    if (!m_enabled) return 0;
+    const uint64_t expected = key(sources);
+    const auto filename = path(expected);
+    std::ifstream input(filename, std::ios::binary);
+    if (!input.is_open()) return 0;
+
+    uint64_t stored = 0;
+    uint32_t driverSize = 0;
+    input.read(reinterpret_cast<char*>(&stored), sizeof(stored));
+    input.read(reinterpret_cast<char*>(&driverSize), sizeof(driverSize));
+    if (!input.good() || (stored != expected) || (driverSize != m_driver.size())) return 0;
+    std::string driver(driverSize, 0);
+    GLenum format = 0;
+    input.read(driver.data(), driverSize);
+    input.read(reinterpret_cast<char*>(&format), sizeof(format));
+    if (!input.good() || (driver != m_driver)) return 0;
+    std::vector<char> binary((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+    if (binary.empty()) return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glProgramBinary(program, format, binary.data(), binary.size());
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success) {
+        // Touching the entry, so that pruning goes by when they were last used.
+        std::error_code ec;
+        std::filesystem::last_write_time(filename, std::filesystem::file_time_type::clock::now(), ec);
+        return program;
+    }
+
+    glDeleteProgram(program);
+    std::error_code ec;
+    std::filesystem::remove(filename, ec);
+    return 0;
+}
+
+void PCSX::ProgramCache::prepare(GLuint program) {
+    if (m_enabled) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void PCSX::ProgramCache::store(GLuint program, std::initializer_list<std::string_view> sources) {
+    if (!m_enabled) return;
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    if (length <= 0) return;
+
+    const uint64_t stored = key(sources);
+    const uint32_t driverSize = m_driver.size();
+    std::ofstream output(path(stored), std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) return;
+    output.write(reinterpret_cast<const char*>(&stored), sizeof(stored));
+    output.write(reinterpret_cast<const char*>(&driverSize), sizeof(driverSize));
+    output.write(m_driver.data(), driverSize);
+    output.write(reinterpret_cast<const char*>(&format), sizeof(format));
+    output.write(binary.data(), length);
+    output.close();
+    prune();
+}
+
+// The shader editors compile on every change, so the entries are capped, and the least recently used go first.
+void PCSX::ProgramCache::prune() {
+    std::error_code ec;
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> entries;
+    for (auto& entry : std::filesystem::directory_iterator(m_directory, ec)) {
+        if (entry.path().extension() != ".bin") continue;
+        entries.emplace_back(entry.last_write_time(ec), entry.path());
+    }
+    if (entries.size() <= c_maxEntries) return;
+    std::sort(entries.begin(), entries.end());
+    for (size_t i = 0; i < entries.size() - c_maxEntries; i++) std::filesystem::remove(entries[i].second, ec);
+}
@@ -0,0 +1,57 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <GL/gl3w.h>
+#include <stdint.h>
+
+#include <filesystem>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace PCSX {
+
+// Keeps the binaries of the linked GL programs on disk, keyed by a hash of their sources and of the driver's
+// identification strings, so that they don't need compiling again on the next run. Drivers are free to refuse
+// a binary, after an update for instance, in which case the program simply gets compiled as usual.
+class ProgramCache {
+  public:
+    // Needs a current GL context. The cache stays disabled if the driver can't save program binaries.
+    void init(const std::filesystem::path& directory);
+    // Returns a linked program from the cache, or 0 if there's none that the driver accepts.
+    GLuint load(std::initializer_list<std::string_view> sources);
+    // To be called on a program before linking it, so that its binary can be retrieved afterwards.
+    void prepare(GLuint program);
+    void store(GLuint program, std::initializer_list<std::string_view> sources);
+
+  private:
+    static constexpr unsigned c_maxEntries = 64;
+
+    uint64_t key(std::initializer_list<std::string_view> sources) const;
+    std::filesystem::path path(uint64_t key) const;
+    void prune();
+
+    bool m_enabled = false;
+    std::string m_driver;
+    std::filesystem::path m_directory;
+};
+
+}  // namespace PCSX
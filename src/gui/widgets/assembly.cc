@@ -87,26 +87,178 @@ void DButton(const char* label, bool enabled, std::function<void(void)> clicked)
     if (!enabled) ImGui::PopStyleColor(3);
 }
 
-class DummyAsm : public PCSX::Disasm {
-    virtual void Invalid() final {}
-    virtual void OpCode(std::string_view str) final {}
-    virtual void GPR(uint8_t reg) final {}
-    virtual void CP0(uint8_t reg) final {}
-    virtual void CP2C(uint8_t reg) final {}
-    virtual void CP2D(uint8_t reg) final {}
-    virtual void HI() final {}
-    virtual void LO() final {}
-    virtual void Imm16(int16_t value) final {}
-    virtual void Imm16u(uint16_t value) final {}
-    virtual void Imm32(uint32_t value) final {}
-    virtual void Target(uint32_t value) final {}
-    virtual void Sa(uint8_t value) final {}
-    virtual void OfB(int16_t offset, uint8_t reg, int size) final {}
-    virtual void BranchDest(uint32_t offset) final {}
-    virtual void Offset(uint32_t offset, int size) final {}
+}  // namespace
+
+class PCSX::Widgets::Assembly::LineRecorder : public PCSX::Disasm {
+  public:
+    explicit LineRecorder(std::vector<Token>& tokens) : m_tokens(tokens) {}
+
+  private:
+    virtual void Invalid() final { m_tokens.push_back({.kind = Token::Kind::Invalid}); }
+    // Some of the opcode names are formatted on the fly, so they can't be kept as views.
+    virtual void OpCode(std::string_view str) final {
+        m_tokens.push_back({.kind = Token::Kind::OpCode, .text = std::string(str)});
+    }
+    virtual void GPR(uint8_t reg) final { m_tokens.push_back({.kind = Token::Kind::GPR, .reg = reg}); }
+    virtual void CP0(uint8_t reg) final { m_tokens.push_back({.kind = Token::Kind::CP0, .reg = reg}); }
+    virtual void CP2C(uint8_t reg) final { m_tokens.push_back({.kind = Token::Kind::CP2C, .reg = reg}); }
+    virtual void CP2D(uint8_t reg) final { m_tokens.push_back({.kind = Token::Kind::CP2D, .reg = reg}); }
+    virtual void HI() final { m_tokens.push_back({.kind = Token::Kind::HI}); }
+    virtual void LO() final { m_tokens.push_back({.kind = Token::Kind::LO}); }
+    virtual void Imm16(int16_t value) final { m_tokens.push_back({.kind = Token::Kind::Imm16, .offset = value}); }
+    virtual void Imm16u(uint16_t value) final { m_tokens.push_back({.kind = Token::Kind::Imm16u, .value = value}); }
+    virtual void Imm32(uint32_t value) final { m_tokens.push_back({.kind = Token::Kind::Imm32, .value = value}); }
+    virtual void Target(uint32_t value) final { m_tokens.push_back({.kind = Token::Kind::Target, .value = value}); }
+    virtual void Sa(uint8_t value) final { m_tokens.push_back({.kind = Token::Kind::Sa, .value = value}); }
+    virtual void OfB(int16_t offset, uint8_t reg, int size) final {
+        m_tokens.push_back({.kind = Token::Kind::OfB, .reg = reg, .size = uint8_t(size), .offset = offset});
+    }
+    virtual void BranchDest(uint32_t value) final {
+        m_tokens.push_back({.kind = Token::Kind::BranchDest, .value = value});
+    }
+    virtual void Offset(uint32_t addr, int size) final {
+        m_tokens.push_back({.kind = Token::Kind::Offset, .size = uint8_t(size), .value = addr});
+    }
+
+    std::vector<Token>& m_tokens;
 };
 
-}  // namespace
+const char* PCSX::Widgets::Assembly::fetchCode(uint32_t& addr, uint32_t& code, uint32_t& nextCode, uint32_t& base) {
+    if (addr < 0x00800000) {
+        code = *reinterpret_cast<uint32_t*>(m_memory->m_wram + addr);
+        if (addr <= 0x007ffff8) {
+            nextCode = *reinterpret_cast<uint32_t*>(m_memory->m_wram + addr + 4);
+        }
+        base = m_ramBase;
+        return "RAM";
+    } else if (addr < 0x00810000) {
+        addr -= 0x00800000;
+        code = *reinterpret_cast<uint32_t*>(m_memory->m_exp1 + addr);
+        if (addr <= 0x0000fff8) {
+            nextCode = *reinterpret_cast<uint32_t*>(m_memory->m_exp1 + addr + 4);
+        }
+        base = 0x1f000000;
+        return "PAR";
+    } else if (addr < 0x00890000) {
+        addr -= 0x00810000;
+        code = *reinterpret_cast<uint32_t*>(m_memory->m_bios + addr);
+        if (addr <= 0x0007fff8) {
+            nextCode = *reinterpret_cast<uint32_t*>(m_memory->m_bios + addr + 4);
+        }
+        base = 0xbfc00000;
+        return "ROM";
+    }
+    return "UNK";
+}
+
+const PCSX::Widgets::Assembly::CachedLine& PCSX::Widgets::Assembly::getLine(uint32_t dispAddr, uint32_t code,
+                                                                            uint32_t nextCode) {
+    auto& symbols = g_emulator->m_cpu->m_symbols;
+    auto it = m_lineCache.find(dispAddr);
+    if (it != m_lineCache.end()) {
+        // Whatever wrote over the code, be it the CPU, a patch, or the assembler, shows up here.
+        const auto& line = it->second;
+        if ((line.code == code) && (line.nextCode == nextCode) && (line.pseudo == m_pseudo) &&
+            (line.symbolsVersion == symbols.version())) {
+            return line;
+        }
+    } else {
+        // Only a handful of screens' worth of lines are ever needed at once.
+        if (m_lineCache.size() >= 16384) m_lineCache.clear();
+        it = m_lineCache.try_emplace(dispAddr).first;
+    }
+
+    auto& line = it->second;
+    line.code = code;
+    line.nextCode = nextCode;
+    line.symbolsVersion = symbols.version();
+    line.pseudo = m_pseudo;
+    line.skipNext = false;
+    line.delaySlotNext = false;
+    line.tokens.clear();
+    LineRecorder recorder(line.tokens);
+    recorder.process(code, nextCode, dispAddr, m_pseudo ? &line.skipNext : nullptr, &line.delaySlotNext);
+
+    auto symbol = symbols.findContaining(dispAddr);
+    if (symbol) {
+        line.symbolAddress = symbol->address;
+        line.symbolName = symbol->name;
+    } else {
+        line.symbolAddress.reset();
+        line.symbolName.clear();
+    }
+    line.nextIsSymbol = symbols.find(dispAddr + 4).has_value();
+    return line;
+}
+
+void PCSX::Widgets::Assembly::drawLine(const CachedLine& line) {
+    for (const auto& token : line.tokens) {
+        switch (token.kind) {
+            case Token::Kind::Invalid:
+                Invalid();
+                break;
+            case Token::Kind::OpCode:
+                OpCode(token.text);
+                break;
+            case Token::Kind::GPR:
+                GPR(token.reg);
+                break;
+            case Token::Kind::CP0:
+                CP0(token.reg);
+                break;
+            case Token::Kind::CP2C:
+                CP2C(token.reg);
+                break;
+            case Token::Kind::CP2D:
+                CP2D(token.reg);
+                break;
+            case Token::Kind::HI:
+                HI();
+                break;
+            case Token::Kind::LO:
+                LO();
+                break;
+            case Token::Kind::Imm16:
+                Imm16(token.offset);
+                break;
+            case Token::Kind::Imm16u:
+                Imm16u(token.value);
+                break;
+            case Token::Kind::Imm32:
+                Imm32(token.value);
+                break;
+            case Token::Kind::Target:
+                Target(token.value);
+                break;
+            case Token::Kind::Sa:
+                Sa(token.value);
+                break;
+            case Token::Kind::OfB:
+                OfB(token.offset, token.reg, token.size);
+                break;
+            case Token::Kind::BranchDest:
+                BranchDest(token.value);
+                break;
+            case Token::Kind::Offset:
+                Offset(token.value, token.size);
+                break;
+        }
+    }
+}
+
+const std::string* PCSX::Widgets::Assembly::symbolAt(uint32_t addr) {
+    const auto version = g_emulator->m_cpu->m_symbols.version();
+    if ((version != m_symbolAtCacheVersion) || (m_symbolAtCache.size() >= 16384)) {
+        m_symbolAtCache.clear();
+        m_symbolAtCacheVersion = version;
+    }
+    auto [it, inserted] = m_symbolAtCache.try_emplace(addr);
+    if (inserted) {
+        auto symbol = symbolAt(addr);
+        if (symbol) it->second = std::string(*symbol);
+    }
+    return it->second ? &*it->second : nullptr;
+}
 
 uint8_t PCSX::Widgets::Assembly::mem8(uint32_t addr) { return *ptr(addr); }
 uint16_t PCSX::Widgets::Assembly::mem16(uint32_t addr) { return SWAP_LE16(*(int16_t*)ptr(addr)); }
@@ -302,8 +454,8 @@ void PCSX::Widgets::Assembly::Target(uint32_t value) {
     if (m_displayArrowForJumps) m_arrows.push_back({m_currentAddr, value});
     std::snprintf(label, sizeof(label), "0x%8.8x##%8.8x", value, m_currentAddr);
     std::string longLabel = label;
-    std::string* symbol = g_emulator->m_cpu->getSymbolAt(value);
-    if (symbol) longLabel = *symbol + " ;" + label;
+    auto symbol = symbolAt(value);
+    if (symbol) longLabel = fmt::format("{} ;{}", *symbol, label);
     ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
     if (ImGui::Button(longLabel.c_str())) {
         m_jumpToPC = value;
@@ -371,8 +523,8 @@ void PCSX::Widgets::Assembly::OfB(int16_t offset, uint8_t reg, int size) {
     uint32_t addr = m_registers->GPR.r[reg] + offset;
 
     std::string longLabel;
-    std::string* symbol = g_emulator->m_cpu->getSymbolAt(addr);
-    if (symbol) longLabel = *symbol + " ; ";
+    auto symbol = symbolAt(addr);
+    if (symbol) longLabel = fmt::format("{} ; ", *symbol);
 
     const auto& io = ImGui::GetIO();
     unsigned targetEditorIndex = io.KeyShift ? 1 : (io.KeyCtrl ? 2 : 0);
@@ -410,9 +562,9 @@ void PCSX::Widgets::Assembly::BranchDest(uint32_t value) {
     sameLine();
     m_arrows.push_back({m_currentAddr, value});
     std::snprintf(label, sizeof(label), "0x%8.8x##%8.8x", value, m_currentAddr);
-    std::string* symbol = g_emulator->m_cpu->getSymbolAt(value);
+    auto symbol = symbolAt(value);
     if (symbol) {
-        std::string longLabel = *symbol + " ;" + label;
+        std::string longLabel = fmt::format("{} ;{}", *symbol, label);
         ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
         if (ImGui::Button(longLabel.c_str())) {
             m_jumpToPC = value;
@@ -432,8 +584,8 @@ void PCSX::Widgets::Assembly::Offset(uint32_t addr, int size) {
     char label[32];
     std::snprintf(label, sizeof(label), "0x%8.8x##%8.8x", addr, m_currentAddr);
     std::string longLabel = label;
-    std::string* symbol = g_emulator->m_cpu->getSymbolAt(addr);
-    if (symbol) longLabel = *symbol + " ;" + label;
+    auto symbol = symbolAt(addr);
+    if (symbol) longLabel = fmt::format("{} ;{}", *symbol, label);
 
     const auto& io = ImGui::GetIO();
     unsigned targetEditorIndex = io.KeyShift ? 1 : (io.KeyCtrl ? 2 : 0);
@@ -542,8 +694,6 @@ bool PCSX::Widgets::Assembly::draw(GUI* gui, psxRegisters* registers, Memory* me
         ImGui::EndMenuBar();
     }
 
-    DummyAsm dummy;
-
     uint32_t pc = virtToReal(m_registers->pc);
     auto& debugSettings = g_emulator->settings.get<Emulator::SettingDebugSettings>();
     if (ImGui::Checkbox(_("Enable Debugger"), &debugSettings.get<Emulator::DebugSettings::Debug>().value)) {
@@ -610,52 +760,37 @@ settings, otherwise debugging features may not work.)");
     while (clipper.Step()) {
         bool skipNext = false;
         bool delaySlotNext = false;
-        typedef std::function<void(uint32_t, const char*, uint32_t, uint32_t, uint32_t)> prependType;
-        auto process = [&](uint32_t addr, prependType prepend, PCSX::Disasm* disasm) {
+        typedef std::function<void(uint32_t, const char*, uint32_t, uint32_t, uint32_t, const CachedLine&)>
+            prependType;
+        auto process = [&](uint32_t addr, prependType prepend, bool draw) {
             uint32_t code = 0;
             uint32_t nextCode = 0;
             uint32_t base = 0;
             uint32_t absAddr = addr;
-            const char* section = "UNK";
-            if (addr < 0x00800000) {
-                section = "RAM";
-                code = *reinterpret_cast<uint32_t*>(m_memory->m_wram + addr);
-                if (addr <= 0x007ffff8) {
-                    nextCode = *reinterpret_cast<uint32_t*>(m_memory->m_wram + addr + 4);
-                }
-                base = m_ramBase;
-            } else if (addr < 0x00810000) {
-                section = "PAR";
-                addr -= 0x00800000;
-                code = *reinterpret_cast<uint32_t*>(m_memory->m_exp1 + addr);
-                if (addr <= 0x0000fff8) {
-                    nextCode = *reinterpret_cast<uint32_t*>(m_memory->m_exp1 + addr + 4);
-                }
-                base = 0x1f000000;
-            } else if (addr < 0x00890000) {
-                section = "ROM";
-                addr -= 0x00810000;
-                code = *reinterpret_cast<uint32_t*>(m_memory->m_bios + addr);
-                if (addr <= 0x0007fff8) {
-                    nextCode = *reinterpret_cast<uint32_t*>(m_memory->m_bios + addr + 4);
-                }
-                base = 0xbfc00000;
+            const char* section = fetchCode(addr, code, nextCode, base);
+            const auto& line = getLine(addr | base, code, nextCode);
+            if (prepend) prepend(code, section, addr | base, absAddr, base, line);
+            if (skipNext) {
+                // The second half of a pseudo-instruction, which got folded into the previous line.
+                skipNext = false;
+            } else {
+                if (draw) drawLine(line);
+                skipNext = line.skipNext;
+                delaySlotNext = line.delaySlotNext;
             }
-            prepend(code, section, addr | base, absAddr, base);
-            disasm->process(code, nextCode, addr | base, m_pseudo ? &skipNext : nullptr, &delaySlotNext);
             m_notch = delaySlotNext && m_delaySlotNotch;
             m_notchAfterSkip[1] = delaySlotNext && m_delaySlotNotch && m_pseudo && skipNext;
         };
         if (clipper.DisplayStart != 0) {
             uint32_t addr = clipper.DisplayStart * 4 - 4;
-            process(addr, [](uint32_t, const char*, uint32_t, uint32_t, uint32_t) {}, &dummy);
+            process(addr, nullptr, false);
         }
         auto& tree = g_emulator->m_debug->getTree();
         for (int x = clipper.DisplayStart; x < clipper.DisplayEnd; x++) {
             uint32_t addr = x * 4;
             const Debug::Breakpoint* currentBP = nullptr;
             prependType l = [&](uint32_t code, const char* section, uint32_t dispAddr, uint32_t absAddr,
-                                uint32_t base) mutable {
+                                uint32_t base, const CachedLine& line) mutable {
                 bool hasBP = false;
                 bool isBPEnabled = false;
 
@@ -685,19 +820,19 @@ settings, otherwise debugging features may not work.)");
                 tcode >>= 8;
                 b[3] = tcode & 0xff;
 
-                std::pair<const uint32_t, std::string>* symbol = cpu->findContainingSymbol(dispAddr);
+                const bool symbol = line.symbolAddress.has_value();
                 if (symbol) {
-                    if (symbol->first == dispAddr) {
+                    if (line.symbolAddress.value() == dispAddr) {
                         ImGui::PushStyleColor(ImGuiCol_Text, s_labelColor);
-                        ImGui::Text("%s:", symbol->second.c_str());
+                        ImGui::Text("%s:", line.symbolName.c_str());
                         ImGui::PopStyleColor();
                     } else {
                         // if this is the first visible line and it's not a label itself, store the previous symbol
                         float y = ImGui::GetCursorScreenPos().y;
                         if (y + lineHeight >= topleft.y && y <= topleft.y + lineHeight) {
-                            previousSymbol = symbol->second;
+                            previousSymbol = line.symbolName;
                             // if the second visible line is a symbol, push the previous symbol display up
-                            if (cpu->getSymbolAt(dispAddr + 4) && y < previousSymbolY) {
+                            if (line.nextIsSymbol && y < previousSymbolY) {
                                 previousSymbolY = y;
                             }
                         }
@@ -851,7 +986,26 @@ settings, otherwise debugging features may not work.)");
                 }
             };
             m_notchAfterSkip[0] = m_notchAfterSkip[1];
-            process(addr, l, this);
+            process(addr, l, true);
+        }
+        // Decoding the lines around the visible window ahead of time means scrolling through them only has
+        // to replay them. The lines already in the cache are only a lookup away, so this is cheap once warm.
+        if (clipper.DisplayEnd > clipper.DisplayStart + 1) {
+            const int window = clipper.DisplayEnd - clipper.DisplayStart;
+            const int first = std::max(clipper.DisplayStart - window, 0);
+            const int last = std::min(clipper.DisplayEnd + window, 0x00890000 / 4);
+            auto prefetch = [&](int begin, int end) {
+                for (int x = begin; x < end; x++) {
+                    uint32_t code = 0;
+                    uint32_t nextCode = 0;
+                    uint32_t base = 0;
+                    uint32_t addr = x * 4;
+                    fetchCode(addr, code, nextCode, base);
+                    getLine(addr | base, code, nextCode);
+                }
+            };
+            prefetch(first, clipper.DisplayStart);
+            prefetch(clipper.DisplayEnd, last);
         }
     }
     std::sort(m_arrows.begin(), m_arrows.end(), [](const auto& a, const auto& b) -> bool {
@@ -1027,7 +1181,7 @@ settings, otherwise debugging features may not work.)");
         ImGui::Text(_("Add symbol for address 0x%08x:"), m_symbolAddress);
         ImGui::InputText("##symbol", &m_addSymbolName);
         if (ImGui::Button(_("Add"))) {
-            cpu->m_symbols[m_symbolAddress] = m_addSymbolName;
+            cpu->m_symbols.insert(m_symbolAddress, m_addSymbolName);
             m_addSymbolName.clear();
             ImGui::CloseCurrentPopup();
         }
@@ -1099,7 +1253,7 @@ if not success then return msg else return nil end
                 uint32_t address = strtoul(addressString.c_str(), &endPtr, 16);
                 bool addressValid = addressString[0] && !*endPtr;
                 if (!addressValid) continue;
-                cpu->m_symbols[address] = name;
+                cpu->m_symbols.insert(address, name);
             }
         }
     }
@@ -1145,8 +1299,8 @@ if not success then return msg else return nil end
 void PCSX::Widgets::Assembly::rebuildSymbolsCache() {
     auto& cpu = g_emulator->m_cpu;
     m_symbolsCache.clear();
-    for (auto& symbol : cpu->m_symbols) {
-        m_symbolsCache.insert(std::pair(symbol.second, symbol.first));
+    for (const auto symbol : cpu->m_symbols) {
+        m_symbolsCache.insert(std::pair(std::string(symbol.name), symbol.address));
     }
     m_symbolsCacheValid = true;
 }
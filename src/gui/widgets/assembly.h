@@ -33,6 +33,7 @@
 #include "core/system.h"
 #include "gui/widgets/filedialog.h"
 #include "support/eventbus.h"
+#include "support/flathashmap.h"
 
 namespace PCSX {
 
@@ -92,6 +93,58 @@ class Assembly : private Disasm {
     virtual void OfB(int16_t offset, uint8_t reg, int size) final;
     virtual void BranchDest(uint32_t value) final;
     virtual void Offset(uint32_t addr, int size) final;
+
+    // Decoding an instruction goes through the Disasm callbacks above once, into a list of tokens, which then
+    // gets replayed on each frame, for as long as the code and the symbols at that address stay the same.
+    struct Token {
+        enum class Kind : uint8_t {
+            Invalid,
+            OpCode,
+            GPR,
+            CP0,
+            CP2C,
+            CP2D,
+            HI,
+            LO,
+            Imm16,
+            Imm16u,
+            Imm32,
+            Target,
+            Sa,
+            OfB,
+            BranchDest,
+            Offset,
+        };
+        Kind kind;
+        uint8_t reg = 0;
+        uint8_t size = 0;
+        int16_t offset = 0;
+        uint32_t value = 0;
+        std::string text;
+    };
+    struct CachedLine {
+        uint32_t code = 0;
+        uint32_t nextCode = 0;
+        uint32_t symbolsVersion = 0;
+        bool pseudo = false;
+        bool skipNext = false;
+        bool delaySlotNext = false;
+        bool nextIsSymbol = false;
+        std::optional<uint32_t> symbolAddress;
+        std::string symbolName;
+        std::vector<Token> tokens;
+    };
+    class LineRecorder;
+    // Reads the instruction at the given offset of the widget's flat address space, and turns the offset
+    // into one relative to the returned section.
+    const char* fetchCode(uint32_t& addr, uint32_t& code, uint32_t& nextCode, uint32_t& base);
+    const CachedLine& getLine(uint32_t dispAddr, uint32_t code, uint32_t nextCode);
+    void drawLine(const CachedLine& line);
+    const std::string* symbolAt(uint32_t addr);
+    FlatHashMap<uint32_t, CachedLine> m_lineCache;
+    FlatHashMap<uint32_t, std::optional<std::string>> m_symbolAtCache;
+    uint32_t m_symbolAtCacheVersion = 0;
+
     bool m_gotArg = false;
     bool m_notch = false;
     bool m_notchAfterSkip[2] = {false, false};
@@ -46,6 +46,8 @@ static const char* getBreakpointConditionName(PCSX::Debug::BreakpointCondition c
             return _("Change");
         case PCSX::Debug::BreakpointCondition::Equal:
             return _("Equal");
+        case PCSX::Debug::BreakpointCondition::Range:
+            return _("Range");
     }
     return _("Unknown");
 }
@@ -387,29 +389,29 @@ void PCSX::Widgets::Breakpoints::draw(const char* title) {
         ImGuiHelpers::ShowHelpMarker(
             _("The mapping feature is a simple concept, but requires some amount of explanation. See the documentation "
               "website for more details, in the Misc Features subsection of the Debugging section."));
-        ImGui::Checkbox(_("Map execution"), &debugger->m_mapping_e);
-        ImGui::Checkbox(_("Map byte reads         "), &debugger->m_mapping_r8);
+        ImGui::CheckboxFlags(_("Map execution"), &debugger->m_features, PCSX::Debug::FEATURE_MAP_EXEC);
+        ImGui::CheckboxFlags(_("Map byte reads         "), &debugger->m_features, PCSX::Debug::FEATURE_MAP_R8);
         ImGui::SameLine();
-        ImGui::Checkbox(_("Map half reads         "), &debugger->m_mapping_r16);
+        ImGui::CheckboxFlags(_("Map half reads         "), &debugger->m_features, PCSX::Debug::FEATURE_MAP_R16);
         ImGui::SameLine();
-        ImGui::Checkbox(_("Map word reads         "), &debugger->m_mapping_r32);
-        ImGui::Checkbox(_("Map byte writes        "), &debugger->m_mapping_w8);
+        ImGui::CheckboxFlags(_("Map word reads         "), &debugger->m_features, PCSX::Debug::FEATURE_MAP_R32);
+        ImGui::CheckboxFlags(_("Map byte writes        "), &debugger->m_features, PCSX::Debug::FEATURE_MAP_W8);
         ImGui::SameLine();
-        ImGui::Checkbox(_("Map half writes        "), &debugger->m_mapping_w16);
+        ImGui::CheckboxFlags(_("Map half writes        "), &debugger->m_features, PCSX::Debug::FEATURE_MAP_W16);
         ImGui::SameLine();
-        ImGui::Checkbox(_("Map word writes        "), &debugger->m_mapping_w32);
+        ImGui::CheckboxFlags(_("Map word writes        "), &debugger->m_features, PCSX::Debug::FEATURE_MAP_W32);
         ImGui::Separator();
-        ImGui::Checkbox(_("Break on execution map"), &debugger->m_breakmp_e);
-        ImGui::Checkbox(_("Break on byte read map "), &debugger->m_breakmp_r8);
+        ImGui::CheckboxFlags(_("Break on execution map"), &debugger->m_features, PCSX::Debug::FEATURE_BREAK_EXEC);
+        ImGui::CheckboxFlags(_("Break on byte read map "), &debugger->m_features, PCSX::Debug::FEATURE_BREAK_R8);
         ImGui::SameLine();
-        ImGui::Checkbox(_("Break on half read map "), &debugger->m_breakmp_r16);
+        ImGui::CheckboxFlags(_("Break on half read map "), &debugger->m_features, PCSX::Debug::FEATURE_BREAK_R16);
         ImGui::SameLine();
-        ImGui::Checkbox(_("Break on word read map "), &debugger->m_breakmp_r32);
-        ImGui::Checkbox(_("Break on byte write map"), &debugger->m_breakmp_w8);
+        ImGui::CheckboxFlags(_("Break on word read map "), &debugger->m_features, PCSX::Debug::FEATURE_BREAK_R32);
+        ImGui::CheckboxFlags(_("Break on byte write map"), &debugger->m_features, PCSX::Debug::FEATURE_BREAK_W8);
         ImGui::SameLine();
-        ImGui::Checkbox(_("Break on half write map"), &debugger->m_breakmp_w16);
+        ImGui::CheckboxFlags(_("Break on half write map"), &debugger->m_features, PCSX::Debug::FEATURE_BREAK_W16);
         ImGui::SameLine();
-        ImGui::Checkbox(_("Break on word write map"), &debugger->m_breakmp_w32);
+        ImGui::CheckboxFlags(_("Break on word write map"), &debugger->m_features, PCSX::Debug::FEATURE_BREAK_W32);
         ImGui::TreePop();
     }
 
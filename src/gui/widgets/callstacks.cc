@@ -28,16 +28,16 @@
 #include "supportpsx/memory.h"
 
 static void drawSymbol(uint32_t pc) {
-    std::pair<const uint32_t, std::string>* symbol = PCSX::g_emulator->m_cpu->findContainingSymbol(pc);
+    auto symbol = PCSX::g_emulator->m_cpu->findContainingSymbol(pc);
     if (symbol) {
-        auto symbolNameBegin = symbol->second.data();
-        auto symbolNameEnd = symbolNameBegin + symbol->second.size();
+        auto symbolNameBegin = symbol->name.data();
+        auto symbolNameEnd = symbolNameBegin + symbol->name.size();
         ImGui::SameLine();
         ImGui::TextUnformatted(" :: ");
         ImGui::SameLine();
         ImGui::TextUnformatted(symbolNameBegin, symbolNameEnd);
         ImGui::SameLine();
-        ImGui::Text("+0x%08x", pc - symbol->first);
+        ImGui::Text("+0x%08x", pc - symbol->address);
     }
 }
 
@@ -54,20 +54,20 @@ void PCSX::Widgets::CallStacks::draw(const char* title, PCSX::GUI* gui) {
     ImGui::Separator();
 
     auto& callstacks = g_emulator->m_callStacks;
-    auto& current = callstacks->getCurrent();
+    const PCSX::CallStacks::CallStack* current = callstacks->hasCurrent() ? &callstacks->getCurrent() : nullptr;
 
-    for (auto& stack : callstacks->getCallstacks()) {
+    callstacks->forEachCallstack([&](const PCSX::CallStacks::CallStack& stack) {
         uint32_t low = stack.getLow();
         uint32_t high = stack.getHigh();
-        if (stack.calls.size() == 0) continue;
-        bool isCurrent = &current == &stack;
+        if (stack.calls.empty()) return;
+        bool isCurrent = current == &stack;
         std::string label = fmt::format("0x{:08x} - 0x{:08x}", low, high);
         ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_Bullet | ImGuiTreeNodeFlags_DefaultOpen;
         if (isCurrent) flags |= ImGuiTreeNodeFlags_Selected;
-        if (!ImGui::TreeNodeEx(label.c_str(), flags)) continue;
-        int callId = 0;
-        for (auto& call : stack.calls) {
-            ImGui::PushID(callId++);
+        if (!ImGui::TreeNodeEx(label.c_str(), flags)) return;
+        for (unsigned callId = 0; callId < stack.calls.size(); callId++) {
+            auto& call = stack.calls[callId];
+            ImGui::PushID(callId);
             std::string label = fmt::format("0x{:08x}##lowsp", call.ra);
             if (ImGui::Button(label.c_str())) {
                 g_system->m_eventBus->signal(PCSX::Events::GUI::JumpToPC{call.ra});
@@ -110,7 +110,7 @@ void PCSX::Widgets::CallStacks::draw(const char* title, PCSX::GUI* gui) {
             drawSymbol(stack.ra);
         }
         ImGui::TreePop();
-    }
+    });
     ImGui::PopFont();
     ImGui::End();
 }
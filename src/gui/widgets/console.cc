@@ -23,6 +23,15 @@
 #include "imgui.h"
 #include "imgui_stdlib.h"
 
+void PCSX::Widgets::Console::addLines(LineType type, std::string_view str) {
+    while (!str.empty()) {
+        auto end = str.find('\n');
+        m_items.append(unsigned(type), str.substr(0, end));
+        if (end == std::string_view::npos) break;
+        str.remove_prefix(end + 1);
+    }
+}
+
 void PCSX::Widgets::Console::draw(const char* title, GUI* gui) {
     ImGui::SetNextWindowSize(ImVec2(520, 600), ImGuiCond_FirstUseEver);
     if (!ImGui::Begin(title, &m_show)) {
@@ -60,11 +69,10 @@ void PCSX::Widgets::Console::draw(const char* title, GUI* gui) {
                       ImGuiWindowFlags_HorizontalScrollbar);
 
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4, 1));  // Tighten spacing
-    if (copy_to_clipboard) ImGui::LogToClipboard();
-    for (auto& item : m_items) {
+    const auto drawItem = [this](uint64_t seq) {
         ImVec4 color;
         bool has_color = false;
-        switch (item.first) {
+        switch (LineType(m_items.tag(seq))) {
             case LineType::ERRORMSG:
                 color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
                 has_color = true;
@@ -75,10 +83,21 @@ void PCSX::Widgets::Console::draw(const char* title, GUI* gui) {
                 break;
         }
         if (has_color) ImGui::PushStyleColor(ImGuiCol_Text, color);
-        ImGui::TextUnformatted(item.second.c_str());
+        auto line = m_items.line(seq);
+        ImGui::TextUnformatted(line.data(), line.data() + line.size());
         if (has_color) ImGui::PopStyleColor();
+    };
+    if (copy_to_clipboard) {
+        ImGui::LogToClipboard();
+        for (uint64_t seq = m_items.begin(); seq < m_items.end(); seq++) drawItem(seq);
+        ImGui::LogFinish();
+    } else {
+        ImGuiListClipper clipper;
+        clipper.Begin(m_items.end() - m_items.begin());
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) drawItem(m_items.begin() + i);
+        }
     }
-    if (copy_to_clipboard) ImGui::LogFinish();
 
     if (m_scrollToBottom || (m_autoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())) {
         ImGui::SetScrollHereY(1.0f);
@@ -95,7 +114,7 @@ void PCSX::Widgets::Console::draw(const char* title, GUI* gui) {
     ImGuiInputTextFlags input_text_flags = ImGuiInputTextFlags_EnterReturnsTrue |
                                            ImGuiInputTextFlags_CallbackCompletion | ImGuiInputTextFlags_CallbackHistory;
     if (ImGui::InputText(_("Input"), &InputBuf, input_text_flags, &TextEditCallbackStub, (void*)this)) {
-        m_items.push_back(std::make_pair(LineType::COMMAND, "# " + InputBuf));
+        addLines(LineType::COMMAND, "# " + InputBuf);
 
         m_historyPos = -1;
         m_history.push_back(InputBuf);
@@ -21,9 +21,11 @@
 
 #include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "imgui.h"
+#include "support/linestore.h"
 
 namespace PCSX {
 class GUI;
@@ -34,10 +36,8 @@ class Console {
     Console(bool& show) : m_show(show) {}
     void setCmdExec(std::function<void(const std::string&)> cmdExec) { m_cmdExec = cmdExec; }
 
-    void addLog(const std::string& str) { m_items.push_back(std::make_pair(LineType::NORMAL, str)); }
-    void addLog(std::string&& str) { m_items.push_back(std::make_pair(LineType::NORMAL, std::move(str))); }
-    void addError(const std::string& str) { m_items.push_back(std::make_pair(LineType::ERRORMSG, str)); }
-    void addError(std::string&& str) { m_items.push_back(std::make_pair(LineType::ERRORMSG, std::move(str))); }
+    void addLog(std::string_view str) { addLines(LineType::NORMAL, str); }
+    void addError(std::string_view str) { addLines(LineType::ERRORMSG, str); }
 
     void draw(const char* title, GUI* gui);
 
@@ -57,7 +57,10 @@ class Console {
         COMMAND,
         ERRORMSG,
     };
-    std::vector<std::pair<LineType, std::string>> m_items;
+    // Split into lines, so that the clipper can skip the ones which aren't visible.
+    void addLines(LineType type, std::string_view str);
+    static constexpr size_t c_maxBytes = 8 * 1024 * 1024;
+    LineStore m_items = LineStore(c_maxBytes);
     std::vector<std::string> m_history;
     int m_historyPos = -1;  // -1: new line, 0..History.Size-1 browsing history.
     bool m_autoScroll = true;
@@ -19,6 +19,7 @@
 
 #include "gui/widgets/gpulogger.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <filesystem>
 
@@ -41,7 +42,7 @@ PCSX::Widgets::GPULogger::GPULogger(bool& show) : m_show(show), m_listener(g_sys
         m_filterProbing = false;
     });
 
-    std::snprintf(m_exportPath.data(), m_exportPath.size(), "gpulogger_frame.json");
+    std::snprintf(m_exportPath.data(), m_exportPath.size(), "gpulogger_frame.bin");
 }
 
 void PCSX::Widgets::GPULogger::draw(PCSX::GPULogger* logger, const char* title) {
@@ -73,8 +74,12 @@ void PCSX::Widgets::GPULogger::draw(PCSX::GPULogger* logger, const char* title)
         ImGui::EndMenuBar();
     }
 
-    if (ImGui::Checkbox(_("GPU logging"), &logger->m_enabled)) {
-        if (logger->m_enabled) {
+    bool enabled = logger->m_enabled;
+    if (ImGui::Checkbox(_("GPU logging"), &enabled)) {
+        // The GPU command thread may be in the middle of processing commands, which would start logging them
+        g_emulator->m_gpu->syncCommands();
+        logger->m_enabled = enabled;
+        if (enabled) {
             logger->enable();
         } else {
             logger->disable();
@@ -155,6 +160,9 @@ void PCSX::Widgets::GPULogger::draw(PCSX::GPULogger* logger, const char* title)
             m_frameCounterOrigin = logger->m_frameCounter;
         }
         ImGui::Text(_("%i primitives"), logger->m_list.size());
+        const auto& chainStats = g_emulator->m_gpu->getLastDMAChainStats();
+        ImGui::Text(_("Last DMA chain: %i nodes, %i empty, %i words"), chainStats.nodes, chainStats.emptyNodes,
+                    chainStats.words);
         GPU::GPUStats stats;
         for (auto& logged : logger->m_list) {
             logged.cumulateStats(&stats);
@@ -180,6 +188,40 @@ void PCSX::Widgets::GPULogger::draw(PCSX::GPULogger* logger, const char* title)
             m_exportStatus = fmt::format(f_("Failed to save frame to {}"), path.string());
         }
     }
+    ImGui::SameLine();
+    if (ImGui::Button(_("Load frame log"))) {
+        auto path = std::filesystem::path(m_exportPath.data());
+        if (logger->loadFrameLog(path)) {
+            m_exportStatus = fmt::format(f_("Loaded frame from {}"), path.string());
+        } else {
+            m_exportStatus = fmt::format(f_("Failed to load frame from {}"), path.string());
+        }
+    }
+    ImGuiHelpers::ShowHelpMarker(
+        _("Frame logs are saved in a compact binary form, holding the frame's starting VRAM and the raw GPU commands, "
+          "which can be loaded back while the GPU logging is enabled, and the emulation paused. Giving the file a "
+          ".json extension saves a human readable version instead, which can't be loaded back."));
+    if (logger->isCapturing()) {
+        ImGui::Text(_("Captured %u of %u frames"), logger->capturedFrames(), logger->captureLength());
+        ImGui::SameLine();
+        if (ImGui::Button(_("Cancel capture"))) logger->cancelCapture();
+    } else {
+        ImGui::InputInt(_("Frames"), &m_captureFrames);
+        m_captureFrames = std::clamp(m_captureFrames, 1, 3600);
+        ImGui::SameLine();
+        if (ImGui::Button(_("Capture frames"))) {
+            auto path = std::filesystem::path(m_exportPath.data());
+            if (logger->startCapture(path, m_captureFrames)) {
+                m_exportStatus = fmt::format(f_("Capturing {} frames into {}"), m_captureFrames, path.string());
+            } else {
+                m_exportStatus = _("The GPU logging needs to be enabled to capture frames");
+            }
+        }
+    }
+    ImGuiHelpers::ShowHelpMarker(
+        _("Captures the given number of frames as they get emulated, starting with the next one, into a single "
+          "binary frame log. Loading it back plays all of its frames, and the -gpu-bench command line option plays "
+          "it back as fast as possible, to time the GPU backend."));
     if (!m_exportStatus.empty()) {
         ImGui::TextWrapped("%s", m_exportStatus.c_str());
     }
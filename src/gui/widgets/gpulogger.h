@@ -59,6 +59,7 @@ class GPULogger {
     bool m_filterProbing = false;
     std::array<char, 256> m_exportPath{};
     std::string m_exportStatus;
+    int m_captureFrames = 60;
     EventBus::Listener m_listener;
     GPU::Logged::DrawLogSettings m_settings;
 };
@@ -19,41 +19,12 @@
 
 #include "gui/widgets/isobrowser.h"
 
-#include <zlib.h>
-
-#include <chrono>
-
 #include "core/cdrom.h"
 #include "fmt/format.h"
 #include "imgui/imgui.h"
 #include "support/imgui-helpers.h"
 #include "support/uvfile.h"
 
-PCSX::Coroutine<> PCSX::Widgets::IsoBrowser::computeCRC(PCSX::CDRIso* iso) {
-    auto time = std::chrono::steady_clock::now();
-
-    uint32_t fullCRC = crc32(0L, Z_NULL, 0);
-    uint32_t lba = 0;
-    for (unsigned t = 1; t <= iso->getTN(); t++) {
-        uint32_t len = iso->getLength(t).toLBA();
-        uint32_t crc = crc32(0L, Z_NULL, 0);
-        uint8_t buffer[2352];
-        for (unsigned s = 0; s < len; s++) {
-            iso->readSectors(lba++, buffer, 1);
-            fullCRC = crc32(fullCRC, buffer, 2352);
-            crc = crc32(crc, buffer, 2352);
-            if (std::chrono::steady_clock::now() - time > std::chrono::milliseconds(50)) {
-                m_crcProgress = (float)s / (float)len;
-                co_yield m_crcCalculator.awaiter();
-                time = std::chrono::steady_clock::now();
-            }
-        }
-        m_crcs[t] = crc;
-    }
-
-    m_fullCRC = fullCRC;
-};
-
 void PCSX::Widgets::IsoBrowser::draw(CDRom* cdrom, const char* title) {
     if (!ImGui::Begin(title, &m_show, ImGuiWindowFlags_MenuBar)) {
         ImGui::End();
@@ -124,32 +95,48 @@ void PCSX::Widgets::IsoBrowser::draw(CDRom* cdrom, const char* title) {
         if (!canCache) ImGui::EndDisabled();
     }
 
-    if (m_crcCalculator.done()) {
-        if (ImGui::Button(_("Compute CRCs"))) {
-            m_crcProgress = 0.0f;
-            m_crcCalculator = computeCRC(iso);
-        }
+    if (m_hashedPath != iso->getIsoPath()) {
+        m_hashedPath = iso->getIsoPath();
+        m_hasher.reset();
+        m_hashes = DiscHasher::loadSidecar(m_hashedPath).value_or(DiscHasher::Result{});
+    }
+    if (m_hasher && m_hasher->done()) {
+        if (!m_hasher->failed()) m_hashes = m_hasher->result();
+        m_hasher.reset();
+    }
+
+    if (!m_hasher) {
+        if (ImGui::Button(_("Compute hashes"))) m_hasher = DiscHasher::start(m_hashedPath);
 
-        ImGuiHelpers::ShowHelpMarker(_(R"(Computes the CRC32 of each track, and of
-the whole disk. The CRC32 is computed on the raw data,
-after decompression of the tracks. This is useful to
-check the disk image against redump's information.
+        ImGuiHelpers::ShowHelpMarker(_(R"(Computes the CRC32 and MD5 of each track, and
+of the whole disk. The hashes are computed on the raw
+data, after decompression of the tracks. This is useful
+to check the disk image against redump's information.
 
-The computation can be slow, and can be sped up
-significantly by caching the files beforehand.)"));
+The computation runs in the background, and its result
+is saved next to the disk image, in a .hashes file, so
+that it shows up immediately the next time the image
+gets loaded, as long as the image isn't modified.)"));
     } else {
-        ImGui::ProgressBar(m_crcProgress);
-        m_crcCalculator.resume();
+        ImGui::ProgressBar(m_hasher->progress());
     }
 
-    auto str = fmt::format(f_("Disc size: {} ({}) - CRC32: {:08x}"), iso->getTD(0), iso->getTD(0).toLBA(), m_fullCRC);
+    auto str = fmt::format(f_("Disc size: {} ({}) - CRC32: {:08x} - MD5: {}"), iso->getTD(0), iso->getTD(0).toLBA(),
+                           m_hashes.disc.crc32, m_hashes.tracks.empty() ? "" : m_hashes.disc.md5String());
     ImGui::TextUnformatted(str.c_str());
-    if (ImGui::BeginTable("Tracks", 5, ImGuiTableFlags_Resizable)) {
+    if (iso->isCompressed()) {
+        auto stats = iso->getCompressedStats();
+        str = fmt::format(f_("Block cache: {} hits, {} misses - {} bytes decompressed"), stats.hits, stats.misses,
+                          stats.inflatedBytes);
+        ImGui::TextUnformatted(str.c_str());
+    }
+    if (ImGui::BeginTable("Tracks", 6, ImGuiTableFlags_Resizable)) {
         ImGui::TableSetupColumn(_("Track"));
         ImGui::TableSetupColumn(_("Start"));
         ImGui::TableSetupColumn(_("Length"));
         ImGui::TableSetupColumn(_("Pregap"));
         ImGui::TableSetupColumn("CRC32");
+        ImGui::TableSetupColumn("MD5");
         ImGui::TableHeadersRow();
         for (unsigned t = 1; t <= iso->getTN(); t++) {
             ImGui::TableNextRow();
@@ -165,8 +152,11 @@ significantly by caching the files beforehand.)"));
             str = fmt::format("{} ({})", iso->getPregap(t), iso->getPregap(t).toLBA());
             ImGui::TextUnformatted(str.c_str());
             ImGui::TableSetColumnIndex(4);
-            str = fmt::format("{:08x}", m_crcs[t]);
+            const bool hashed = t <= m_hashes.tracks.size();
+            str = fmt::format("{:08x}", hashed ? m_hashes.tracks[t - 1].crc32 : 0);
             ImGui::TextUnformatted(str.c_str());
+            ImGui::TableSetColumnIndex(5);
+            if (hashed) ImGui::TextUnformatted(m_hashes.tracks[t - 1].md5String().c_str());
         }
         ImGui::EndTable();
     }
@@ -21,12 +21,14 @@
 
 #include <stdint.h>
 
+#include <filesystem>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "cdrom/disc-hasher.h"
 #include "gui/widgets/filedialog.h"
-#include "support/coroutine.h"
 
 namespace PCSX {
 
@@ -44,12 +46,11 @@ class IsoBrowser {
     bool& m_show;
 
   private:
-    uint32_t m_fullCRC = 0;
-    uint32_t m_crcs[100] = {0};
-    Coroutine<> m_crcCalculator;
-    float m_crcProgress = 0.0f;
+    // The image the hashes below are for; they get reset whenever another one gets loaded.
+    std::filesystem::path m_hashedPath;
+    std::shared_ptr<DiscHasher> m_hasher;
+    DiscHasher::Result m_hashes;
 
-    Coroutine<> computeCRC(CDRIso*);
     FileDialog<> m_openIsoFileDialog;
 };
 
@@ -21,6 +21,7 @@
 
 #include "core/kernel.h"
 #include "core/r3000a.h"
+#include "core/system.h"
 #include "imgui.h"
 
 bool PCSX::Widgets::KernelLog::draw(R3000Acpu* cpu, const char* title) {
@@ -29,6 +30,63 @@ bool PCSX::Widgets::KernelLog::draw(R3000Acpu* cpu, const char* title) {
         return false;
     }
 
+    bool changed = false;
+    if (ImGui::BeginTabBar("KernelLogTabs")) {
+        if (ImGui::BeginTabItem(_("Calls"))) {
+            changed |= drawCalls(cpu);
+            ImGui::EndTabItem();
+        }
+        if (ImGui::BeginTabItem(_("Filters"))) {
+            changed |= drawFilters();
+            ImGui::EndTabItem();
+        }
+        ImGui::EndTabBar();
+    }
+    ImGui::End();
+
+    return changed;
+}
+
+bool PCSX::Widgets::KernelLog::drawCalls(R3000Acpu* cpu) {
+    auto& calls = cpu->m_kernelCalls;
+    auto& debugSettings = g_emulator->settings.get<Emulator::SettingDebugSettings>();
+    bool changed = ImGui::Checkbox(_("Record"), &debugSettings.get<Emulator::DebugSettings::KernelLog>().value);
+    ImGui::SameLine();
+    ImGui::Checkbox(_("Follow"), &m_follow);
+    ImGui::SameLine();
+    if (ImGui::Button(_("Clear"))) calls.clear();
+    ImGui::SameLine();
+    bool copy = ImGui::Button(_("Copy"));
+    ImGui::SameLine();
+    ImGui::Text(_("%zu most recent calls, out of %llu"), calls.size(), (unsigned long long)calls.total());
+    ImGui::Separator();
+
+    // The calls only get turned into text here, and only the ones on screen, unless they're all being copied.
+    IO<File> memory = g_emulator->m_mem->getMemoryAsFile();
+    auto decode = [&memory](const Kernel::Call& call) {
+        return fmt::format("{:>12} {}", call.cycle, Kernel::CallLog::decode(call, memory));
+    };
+    ImGui::BeginChild("calls", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+    if (copy) {
+        ImGui::LogToClipboard();
+        for (size_t i = 0; i < calls.size(); i++) ImGui::LogText("%s\n", decode(calls[i]).c_str());
+        ImGui::LogFinish();
+    }
+    ImGuiListClipper clipper;
+    clipper.Begin(calls.size());
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            auto line = decode(calls[i]);
+            ImGui::TextUnformatted(line.c_str(), line.c_str() + line.length());
+        }
+    }
+    if (m_follow) ImGui::SetScrollHereY(1.0f);
+    ImGui::EndChild();
+
+    return changed;
+}
+
+bool PCSX::Widgets::KernelLog::drawFilters() {
     bool changed = false;
 
     unsigned numRows = std::max(std::max(Kernel::getA0namesSize(), Kernel::getB0namesSize()), Kernel::getC0namesSize());
@@ -108,7 +166,6 @@ bool PCSX::Widgets::KernelLog::draw(R3000Acpu* cpu, const char* title) {
         }
         ImGui::EndTable();
     }
-    ImGui::End();
 
     return changed;
 }
@@ -35,6 +35,12 @@ class KernelLog {
     bool draw(R3000Acpu* cpu, const char* title);
 
     bool& m_show;
+
+  private:
+    bool drawCalls(R3000Acpu* cpu);
+    bool drawFilters();
+
+    bool m_follow = true;
 };
 
 }  // namespace Widgets
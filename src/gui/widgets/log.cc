@@ -27,6 +27,7 @@
 #include "gui/gui.h"
 #include "imgui.h"
 #include "imgui_internal.h"
+#include "imgui_stdlib.h"
 
 PCSX::Widgets::Log::json PCSX::Widgets::Log::serialize() const {
     json ret;
@@ -50,12 +51,14 @@ void PCSX::Widgets::Log::deserialize(const json& j) {
             c->displayed = j[name]["displayed"];
         }
     }
+    updateFilter();
 }
 
 PCSX::Widgets::Log::Log(bool& show) : m_show(show) {
     for (auto logClass : magic_enum::enum_values<LogClass>()) {
         addClass(magic_enum::enum_integer(logClass), std::string{magic_enum::enum_name(logClass)});
     }
+    static_assert(magic_enum::enum_count<LogClass>() <= LineStore::MAX_TAGS);
 }
 
 bool PCSX::Widgets::Log::draw(GUI* gui, const char* title) {
@@ -112,13 +115,13 @@ bool PCSX::Widgets::Log::draw(GUI* gui, const char* title) {
                 ImGui::MenuItem(_("CPU trace"), nullptr, &debugSettings.get<Emulator::DebugSettings::Trace>().value);
             changed |= ImGui::MenuItem(_("Skip ISR during CPU traces"), nullptr,
                                        &debugSettings.get<Emulator::DebugSettings::SkipISR>().value);
-            changed |= ImGui::MenuItem(_("Log kernel calls"), nullptr,
+            changed |= ImGui::MenuItem(_("Record kernel calls"), nullptr,
                                        &debugSettings.get<Emulator::DebugSettings::KernelLog>().value);
             ImGui::PopItemFlag();
             ImGui::EndMenu();
         }
 
-        if (changed) rebuildActive();
+        if (changed) updateFilter();
         ImGui::EndMenuBar();
     }
 
@@ -130,40 +133,37 @@ bool PCSX::Widgets::Log::draw(GUI* gui, const char* title) {
     ImGui::SameLine();
     bool copy = ImGui::Button(_("Copy"));
     ImGui::SameLine();
-    ImGuiTextFilter filter;
-    // filter.Draw by default puts the label to the right side of the input box.
-    // To rememdy this, and keep the ImGui ID stack happy, we just do ## for the filter ID
-    // and draw our own text for the description of the input box
-    ImGui::TextUnformatted("Search");
+    // The label goes on the left of the input box, unlike what ImGui does.
+    ImGui::TextUnformatted(_("Search"));
     ImGui::SameLine();
-    filter.Draw("##FilterBox", -100.0f);
+    ImGui::SetNextItemWidth(-100.0f);
+    if (ImGui::InputText("##FilterBox", &m_search)) updateFilter();
+    if (m_view.filtering()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(_("Searching..."));
+    }
 
     ImGui::Separator();
     if (m_mono) gui->useMonoFont();
     ImGui::BeginChild("scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
-    if (copy) ImGui::LogToClipboard();
-
-    ImGuiListClipper clipper;
-    clipper.Begin(m_activeLogs.size());
-
-    if (filter.IsActive()) {  // Filter for logs if filter is active
-        for (auto& m_activeLog : m_activeLogs) {
-            auto& s = m_activeLog.entry;
-            if (filter.PassFilter(s.c_str(), s.c_str() + s.length()))
-                ImGui::TextUnformatted(s.c_str(), s.c_str() + s.length());
-        }
+    m_view.update();
+
+    const auto drawLine = [this](size_t i) {
+        auto line = m_store.line(m_view[i]);
+        ImGui::TextUnformatted(line.data(), line.data() + line.size());
+    };
+    if (copy) {
+        ImGui::LogToClipboard();
+        for (size_t i = 0; i < m_view.size(); i++) drawLine(i);
+        ImGui::LogFinish();
     } else {
-        // Otherwise, Display logs for selected log class as normal when filter is not active
+        ImGuiListClipper clipper;
+        clipper.Begin(m_view.size());
         while (clipper.Step()) {
-            for (auto i = m_activeLogs.find(clipper.DisplayStart);
-                 i != m_activeLogs.end() && i->getLow() < clipper.DisplayEnd; i++) {
-                auto& s = i->entry;
-                ImGui::TextUnformatted(s.c_str(), s.c_str() + s.length());
-            }
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) drawLine(i);
         }
     }
 
-    if (copy) ImGui::LogFinish();
     if (m_scrollToBottom) ImGui::SetScrollHereY(1.0f);
     m_scrollToBottom = m_follow;
     ImGui::EndChild();
@@ -173,17 +173,11 @@ bool PCSX::Widgets::Log::draw(GUI* gui, const char* title) {
     return changed;
 }
 
-void PCSX::Widgets::Log::rebuildActive() {
-    m_activeLogs.clear();
-
-    for (auto& e : m_allLogs) {
-        ClassElement* c = nullptr;
-        for (auto& cl : m_classes) {
-            if (cl.list.contains(&e)) {
-                c = &cl;
-                break;
-            }
-        }
-        if (c && c->enabled && c->displayed) m_activeLogs.insert(m_activeLogs.size(), &e);
+void PCSX::Widgets::Log::updateFilter() {
+    uint64_t tags = 0;
+    for (auto logClass : magic_enum::enum_values<LogClass>()) {
+        auto c = m_classes.find(magic_enum::enum_integer(logClass));
+        if (c->enabled && c->displayed) tags |= uint64_t(1) << magic_enum::enum_integer(logClass);
     }
+    m_view.setFilter(tags, m_search);
 }
@@ -25,9 +25,8 @@
 #include "imgui.h"
 #include "json.hpp"
 #include "support/hashtable.h"
-#include "support/list.h"
+#include "support/linestore.h"
 #include "support/strings-helpers.h"
-#include "support/tree.h"
 
 namespace PCSX {
 class GUI;
@@ -39,11 +38,8 @@ class Log {
     json serialize() const;
     void deserialize(const json& j);
     Log(bool& show);
-    ~Log() {
-        clear();
-        m_classes.destroyAll();
-    }
-    void clear() { m_allLogs.destroyAll(); }
+    ~Log() { m_classes.destroyAll(); }
+    void clear() { m_store.clear(); }
     template <size_t L>
     bool addLog(unsigned logClass, const char (&log)[L]) {
         std::string str(log);
@@ -61,41 +57,33 @@ class Log {
         auto lines = StringsHelpers::split(c->buffer, "\n", true);
         c->buffer = lines.back();
         lines.pop_back();
-        for (auto& line : lines) {
-            Element* element = new Element(std::move(line));
-            c->list.push_back(element);
-            m_allLogs.push_back(element);
-            if (c->displayed) m_activeLogs.insert(m_activeLogs.size(), element);
-        }
+        for (auto& line : lines) m_store.append(logClass, line);
         return true;
     }
+    bool enabled(unsigned logClass) {
+        auto c = m_classes.find(logClass);
+        return (c == m_classes.end()) || c->enabled;
+    }
     bool draw(GUI* gui, const char* title);
 
     bool& m_show;
 
   private:
     void addClass(unsigned logClass, const std::string& s) { m_classes.insert(logClass, new ClassElement(s)); }
-    void rebuildActive();
-    struct Element;
-    struct Class {};
-    typedef Intrusive::List<Element> All;
-    typedef Intrusive::Tree<unsigned, Element> ActiveTree;
-    typedef Intrusive::List<Element, Class> ClassList;
-    struct Element : public All::Node, public ActiveTree::Node, public ClassList::Node {
-        Element(const std::string& e) : entry(e) {}
-        Element(std::string&& e) : entry(std::move(e)) {}
-        const std::string entry;
-    };
+    void updateFilter();
 
-    All m_allLogs;
-    ActiveTree m_activeLogs;
+    // A few minutes of verbose logging used to bring the UI down, so the lines are kept in a bounded store,
+    // only the visible ones get drawn, and the search runs off the UI thread.
+    static constexpr size_t c_maxBytes = 32 * 1024 * 1024;
+    LineStore m_store = LineStore(c_maxBytes);
+    LineStore::View m_view = LineStore::View(m_store);
+    std::string m_search;
     struct ClassElement;
     typedef Intrusive::HashTable<unsigned, ClassElement> ClassMap;
     struct ClassElement : public ClassMap::Node {
         ClassElement(const std::string& n) : name(n) {}
         const std::string name;
         std::string buffer;
-        ClassList list;
         bool enabled = true;
         bool displayed = true;
     };
@@ -21,10 +21,14 @@
 
 #include <set>
 
+#include "core/luaprofiler.h"
+#include "core/psxemulator.h"
 #include "fmt/format.h"
 #include "gui/gui.h"
 #include "imgui.h"
+#include "imgui_stdlib.h"
 #include "lua/luawrapper.h"
+#include "support/imgui-helpers.h"
 
 void PCSX::Widgets::LuaInspector::dumpTree(const std::string& label, Lua L, int i) {
     if (L.istable(i)) {
@@ -83,6 +87,57 @@ void PCSX::Widgets::LuaInspector::dumpTree(const std::string& label, Lua L, int
     }
 }
 
+void PCSX::Widgets::LuaInspector::drawProfiler(Lua L) {
+    auto& profiler = g_emulator->m_luaProfiler;
+    if (profiler->isRunning()) {
+        if (ImGui::Button(_("Stop"))) profiler->stop();
+    } else {
+        if (ImGui::Button(_("Start"))) profiler->start(L, m_profilerInterval);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(ImGui::GetFontSize() * 8);
+        ImGui::SliderInt(_("Interval (ms)"), &m_profilerInterval, 1, 10);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button(_("Clear"))) profiler->clear();
+    ImGui::InputText(_("Filename"), &m_profileFilename);
+    ImGui::SameLine();
+    if (ImGui::Button(_("Save"))) {
+        if (!profiler->save(m_profileFilename)) {
+            g_system->printf(_("Unable to save the Lua profile to %s\n"), m_profileFilename);
+        }
+    }
+    ImGuiHelpers::ShowHelpMarker(_(R"(Saved as collapsed stacks, which the flame graph
+scripts and speedscope can display. The time spent in
+event listeners is rooted under the name of the event.)"));
+
+    const uint64_t samples = profiler->samples();
+    ImGui::Text(_("%llu samples"), (unsigned long long)samples);
+    if (samples == 0) return;
+    if (ImGui::BeginTable("LuaProfile", 5, ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn(_("Function"));
+        ImGui::TableSetupColumn(_("Self (ms)"));
+        ImGui::TableSetupColumn(_("Self %"));
+        ImGui::TableSetupColumn(_("Total (ms)"));
+        ImGui::TableSetupColumn(_("Total %"));
+        ImGui::TableHeadersRow();
+        const unsigned interval = profiler->interval();
+        for (auto& function : profiler->functions()) {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextUnformatted(function.name.c_str());
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%llu", (unsigned long long)(function.self * interval));
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%.1f", 100.0 * function.self / samples);
+            ImGui::TableSetColumnIndex(3);
+            ImGui::Text("%llu", (unsigned long long)(function.total * interval));
+            ImGui::TableSetColumnIndex(4);
+            ImGui::Text("%.1f", 100.0 * function.total / samples);
+        }
+        ImGui::EndTable();
+    }
+}
+
 void PCSX::Widgets::LuaInspector::draw(const char* title, Lua L, PCSX::GUI* gui) {
     ImGui::SetNextWindowSize(ImVec2(520, 600), ImGuiCond_FirstUseEver);
     if (!ImGui::Begin(title, &m_show)) {
@@ -90,7 +145,7 @@ void PCSX::Widgets::LuaInspector::draw(const char* title, Lua L, PCSX::GUI* gui)
         return;
     }
 
-    static const char* displays[] = {"Globals", "Stack", "Registry"};
+    static const char* displays[] = {"Globals", "Stack", "Registry", "Profiler"};
 
     if (ImGui::BeginCombo(_("Display"), displays[int(m_display)])) {
         for (int i = 0; i < (sizeof(displays) / sizeof(displays[0])); i++) {
@@ -100,6 +155,11 @@ void PCSX::Widgets::LuaInspector::draw(const char* title, Lua L, PCSX::GUI* gui)
         }
         ImGui::EndCombo();
     }
+    if (m_display == Display::PROFILER) {
+        drawProfiler(L);
+        ImGui::End();
+        return;
+    }
     ImGui::SameLine();
     ImGui::Checkbox(_("Raw"), &m_raw);
 
@@ -37,13 +37,17 @@ class LuaInspector {
 
   private:
     void dumpTree(const std::string& label, Lua L, int i);
+    void drawProfiler(Lua L);
     enum class Display {
         GLOBALS,
         STACK,
         REGISTRY,
+        PROFILER,
     } m_display = Display::GLOBALS;
 
     bool m_raw = true;
+    int m_profilerInterval = 1;
+    std::string m_profileFilename = "lua-profile.txt";
 };
 
 }  // namespace Widgets
@@ -34,12 +34,10 @@
 
 PCSX::Widgets::MemoryObserver::MemoryObserver(bool& show) : m_show(show), m_listener(g_system->m_eventBus) {
     m_listener.listen<PCSX::Events::GPU::VSync>([this](const auto& event) {
-        for (const auto& addressValuePair : m_addressValuePairs) {
-            if (addressValuePair.frozen) {
-                const auto dataSize = getStrideFromValueType(m_scanValueType);
-                memcpy(g_emulator->m_mem->m_wram + addressValuePair.address - 0x80000000, &addressValuePair.frozenValue,
-                       dataSize);
-            }
+        for (const auto& frozenValue : m_frozenValues) {
+            memcpy(g_emulator->m_mem->m_wram + frozenValue.address - 0x80000000, &frozenValue.value,
+                   frozenValue.stride);
+            g_emulator->m_mem->markDirtyRange(frozenValue.address, frozenValue.stride);
         }
     });
 
@@ -195,93 +193,28 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
         }
 
         if (ImGui::BeginTabItem(_("Delta-over-time search"))) {
-            const auto stride = getStrideFromValueType(m_scanValueType);
-
-            if (m_addressValuePairs.empty() && ImGui::Button(_("First scan"))) {
-                int64_t memValue = 0;
-
-                for (uint32_t i = 0; i < memSize; ++i) {
-                    if (i != 0 && i % stride == 0) {
-                        switch (m_scanType) {
-                            case ScanType::ExactValue:
-                                if (memValue == m_value) {
-                                    m_addressValuePairs.push_back({memBase + i - stride, memValue});
-                                }
-                                break;
-                            case ScanType::GreaterThan:
-                                if (memValue > m_value) {
-                                    m_addressValuePairs.push_back({memBase + i - stride, memValue});
-                                }
-                                break;
-                            case ScanType::LessThan:
-                                if (memValue < m_value) {
-                                    m_addressValuePairs.push_back({memBase + i - stride, memValue});
-                                }
-                                break;
-                            case ScanType::Changed:
-                            case ScanType::Unchanged:
-                            case ScanType::Increased:
-                            case ScanType::Decreased:
-                                break;
-                            case ScanType::UnknownInitialValue:
-                                m_addressValuePairs.push_back({memBase + i - stride, memValue});
-                                break;
-                        }
-
-                        memValue = 0;
-                    }
+            const auto stride = MemoryScanner::width(m_scanValueType);
 
-                    const uint8_t currentByte = memData[i];
-                    const uint8_t leftShift = 8 * (i % stride);
-                    const uint32_t mask = 0xffffffff ^ (0xff << leftShift);
-                    const int byteToWrite = currentByte << leftShift;
-                    memValue = (memValue & mask) | byteToWrite;
-                    memValue = getValueAsSelectedType(memValue);
-                }
+            // The scans go over the whole RAM at once, see support/memscanner.h.
+            if (m_scanner.empty() && ImGui::Button(_("First scan"))) {
+                m_scanner.first(memData, memSize, m_scanValueType, getComparison(m_scanType), m_value);
             }
 
-            if (!m_addressValuePairs.empty() && ImGui::Button(_("Next scan"))) {
-                auto doesntMatchCriterion = [this, memData, memSize, stride](const AddressValuePair& addressValuePair) {
-                    const uint32_t address = addressValuePair.address;
-                    const int64_t memValue =
-                        getValueAsSelectedType(getMemValue(address, memData, memSize, memBase, stride));
-
-                    switch (m_scanType) {
-                        case ScanType::ExactValue:
-                            return memValue != m_value;
-                        case ScanType::GreaterThan:
-                            return memValue <= m_value;
-                        case ScanType::LessThan:
-                            return memValue >= m_value;
-                        case ScanType::Changed:
-                            return memValue == addressValuePair.scannedValue;
-                        case ScanType::Unchanged:
-                            return memValue != addressValuePair.scannedValue;
-                        case ScanType::Increased:
-                            return memValue <= addressValuePair.scannedValue;
-                        case ScanType::Decreased:
-                            return memValue >= addressValuePair.scannedValue;
-                        case ScanType::UnknownInitialValue:
-                            return true;
-                    }
-
-                    return true;
-                };
-
-                std::erase_if(m_addressValuePairs, doesntMatchCriterion);
-
-                if (m_addressValuePairs.empty()) {
-                    m_scanType = ScanType::ExactValue;
+            if (!m_scanner.empty() && ImGui::Button(_("Next scan"))) {
+                if (m_scanType == ScanType::UnknownInitialValue) {
+                    m_scanner.clear();
                 } else {
-                    for (auto& addressValuePair : m_addressValuePairs) {
-                        addressValuePair.scannedValue = getValueAsSelectedType(
-                            getMemValue(addressValuePair.address, memData, memSize, memBase, stride));
-                    }
+                    m_scanner.next(memData, getComparison(m_scanType), m_value);
+                }
+                if (m_scanner.empty()) {
+                    m_scanType = ScanType::ExactValue;
+                    m_frozenValues.clear();
                 }
             }
 
-            if (!m_addressValuePairs.empty() && ImGui::Button(_("New scan"))) {
-                m_addressValuePairs.clear();
+            if (!m_scanner.empty() && ImGui::Button(_("New scan"))) {
+                m_scanner.clear();
+                m_frozenValues.clear();
                 m_scanType = ScanType::ExactValue;
             }
 
@@ -291,6 +224,9 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
             m_value = getValueAsSelectedType(m_value);
 
             const auto currentScanValueType = magic_enum::enum_name(m_scanValueType);
+            // The candidates are slots of the scanned width, so the type can't change until the next new scan.
+            const bool scanning = !m_scanner.empty();
+            if (scanning) ImGui::BeginDisabled();
             if (ImGui::BeginCombo(_("Value type"), currentScanValueType.data())) {
                 for (auto v : magic_enum::enum_values<ScanValueType>()) {
                     bool selected = (v == m_scanValueType);
@@ -304,6 +240,7 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
                 }
                 ImGui::EndCombo();
             }
+            if (scanning) ImGui::EndDisabled();
 
             const auto currentScanType = magic_enum::enum_name(m_scanType);
             if (ImGui::BeginCombo(_("Scan type"), currentScanType.data())) {
@@ -339,14 +276,13 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
                                                                                : (as_uint ? "%u" : "%i");
 
                 ImGuiListClipper clipper;
-                clipper.Begin(m_addressValuePairs.size());
+                clipper.Begin(m_scanner.count());
                 while (clipper.Step()) {
                     for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
-                        auto& addressValuePair = m_addressValuePairs[row];
-                        const uint32_t currentAddress = addressValuePair.address;
-                        const auto memValue =
-                            getValueAsSelectedType(getMemValue(currentAddress, memData, memSize, memBase, stride));
-                        const auto scannedValue = addressValuePair.scannedValue;
+                        const uint32_t offset = m_scanner.offset(row);
+                        const uint32_t currentAddress = memBase + offset;
+                        const auto memValue = MemoryScanner::read(memData, offset, m_scanValueType);
+                        const auto scannedValue = m_scanner.previous(offset);
                         const bool displayAsFixedPoint = !m_hex && m_fixedPoint && stride > 1;
 
                         ImGui::TableNextRow();
@@ -360,8 +296,17 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
                         }
                         ImGui::SameLine();
                         auto CheckboxName = fmt::format(f_("Freeze##{}"), row);
-                        if (ImGui::Checkbox(CheckboxName.c_str(), &addressValuePair.frozen)) {
-                            addressValuePair.frozenValue = memValue;
+                        auto frozen = std::find_if(m_frozenValues.begin(), m_frozenValues.end(),
+                                                   [currentAddress](const FrozenValue& frozenValue) {
+                                                       return frozenValue.address == currentAddress;
+                                                   });
+                        bool isFrozen = frozen != m_frozenValues.end();
+                        if (ImGui::Checkbox(CheckboxName.c_str(), &isFrozen)) {
+                            if (isFrozen) {
+                                m_frozenValues.push_back({currentAddress, memValue, uint8_t(stride)});
+                            } else {
+                                m_frozenValues.erase(frozen);
+                            }
                         }
                         ImGui::TableSetColumnIndex(2);
                         if (displayAsFixedPoint) {
@@ -455,20 +400,26 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
     ImGui::End();
 }
 
-uint8_t PCSX::Widgets::MemoryObserver::getStrideFromValueType(ScanValueType valueType) {
-    switch (valueType) {
-        case ScanValueType::Char:
-        case ScanValueType::Uchar:
-            return 1;
-        case ScanValueType::Short:
-        case ScanValueType::Ushort:
-            return 2;
-        case ScanValueType::Int:
-        case ScanValueType::Uint:
-            return 4;
-        default:
-            throw std::runtime_error("Invalid value type.");
+PCSX::MemoryScanner::Comparison PCSX::Widgets::MemoryObserver::getComparison(ScanType scanType) {
+    switch (scanType) {
+        case ScanType::ExactValue:
+            return MemoryScanner::Comparison::Equal;
+        case ScanType::GreaterThan:
+            return MemoryScanner::Comparison::Greater;
+        case ScanType::LessThan:
+            return MemoryScanner::Comparison::Less;
+        case ScanType::Changed:
+            return MemoryScanner::Comparison::Changed;
+        case ScanType::Unchanged:
+            return MemoryScanner::Comparison::Unchanged;
+        case ScanType::Increased:
+            return MemoryScanner::Comparison::Increased;
+        case ScanType::Decreased:
+            return MemoryScanner::Comparison::Decreased;
+        case ScanType::UnknownInitialValue:
+            return MemoryScanner::Comparison::Any;
     }
+    throw std::runtime_error("Invalid scan type.");
 }
 
 int64_t PCSX::Widgets::MemoryObserver::getValueAsSelectedType(int64_t memValue) {
@@ -502,21 +453,6 @@ int64_t PCSX::Widgets::MemoryObserver::getValueAsSelectedType(int64_t memValue)
     }
 }
 
-int PCSX::Widgets::MemoryObserver::getMemValue(uint32_t absoluteAddress, const uint8_t* memData, uint32_t memSize,
-                                               uint32_t memBase, uint8_t stride) {
-    int memValue = 0;
-    const uint32_t relativeAddress = absoluteAddress - memBase;
-    assert(relativeAddress < memSize);
-    for (uint32_t i = relativeAddress; i < relativeAddress + stride; ++i) {
-        const uint8_t currentByte = memData[i];
-        const uint8_t leftShift = 8 * (i % stride);
-        const uint32_t mask = 0xffffffff ^ (0xff << leftShift);
-        const int byteToWrite = currentByte << leftShift;
-        memValue = (memValue & mask) | byteToWrite;
-    }
-    return memValue;
-}
-
 #ifdef MEMORY_OBSERVER_X86
 // Check if all bytes in a 256-bit vector are equal
 // Broadcasts byte 0 of the vector to 256 bits, then xors the result with the starting vector
@@ -29,6 +29,7 @@
 
 #include "imgui.h"
 #include "support/eventbus.h"
+#include "support/memscanner.h"
 #if defined(__i386__) || defined(_M_IX86) || defined(__x86_64) || defined(_M_AMD64)
 #define MEMORY_OBSERVER_X86  // Do not include immintrin/xbyak or use avx intrinsics unless we're compiling for x86
 #if defined(__GNUC__) || defined(__clang__)
@@ -50,9 +51,6 @@ class MemoryObserver {
     MemoryObserver(bool& show);
 
   private:
-    static int getMemValue(uint32_t absoluteAddress, const uint8_t* memData, uint32_t memSize, uint32_t memBase,
-                           uint8_t stride);
-
     /**
      * Plain search.
      */
@@ -78,21 +76,20 @@ class MemoryObserver {
         UnknownInitialValue
     };
 
-    enum class ScanValueType { Char, Uchar, Short, Ushort, Int, Uint };
-    static uint8_t getStrideFromValueType(ScanValueType valueType);
+    using ScanValueType = MemoryScanner::ValueType;
+    static MemoryScanner::Comparison getComparison(ScanType scanType);
     int64_t getValueAsSelectedType(int64_t memValue);
 
-    struct AddressValuePair {
+    struct FrozenValue {
         uint32_t address = 0;
-        int64_t scannedValue = 0;
-
-        bool frozen = false;
-        int64_t frozenValue = 0;
+        int64_t value = 0;
+        uint8_t stride = 0;
     };
 
     ScanType m_scanType = ScanType::ExactValue;
     ScanValueType m_scanValueType = ScanValueType::Short;
-    std::vector<AddressValuePair> m_addressValuePairs;
+    MemoryScanner m_scanner;
+    std::vector<FrozenValue> m_frozenValues;
     bool m_hex = false;
     bool m_fixedPoint = false;
     bool m_useSIMD = false;
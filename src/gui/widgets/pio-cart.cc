@@ -22,6 +22,7 @@
 #include "core/pio-cart.h"
 #include "core/psxemulator.h"
 #include "imgui.h"
+#include "support/imgui-helpers.h"
 
 bool PCSX::Widgets::PIOCart::draw(const char* title) {
     bool selectEXP1Dialog = false;
@@ -55,6 +56,11 @@ bool PCSX::Widgets::PIOCart::draw(const char* title) {
         if (ImGui::Checkbox(_("Connected"), &settings.get<Emulator::SettingPIOConnected>().value)) {
             g_emulator->m_pioCart->setLuts();
         }
+        changed |= ImGui::Checkbox(_("Write flash back to the ROM file"),
+                                   &settings.get<Emulator::SettingPIOFlashWriteback>().value);
+        ImGuiHelpers::ShowHelpMarker(
+            _("Saves what the cartridge programs into its flash back into the ROM file, in place, shortly after "
+              "it happens. Without this, the flash contents are lost when closing the emulator."));
 
         {  // Select EXP1 Dialog
             auto& exp1path = settings.get<Emulator::SettingEXP1BrowsePath>();
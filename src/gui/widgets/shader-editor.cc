@@ -299,15 +299,10 @@ void PCSX::Widgets::ShaderEditor::init() {
     m_quadVertices[3].positions[1] = 1.0;
 }
 
-PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::compile(GUI *gui,
-                                                          const std::vector<std::string_view> &mandatoryAttributes) {
-    m_setupVAO = true;
-    m_shaderProjMtxLoc = -1;
+GLuint PCSX::Widgets::ShaderEditor::link(ProgramCache &cache, const std::string &VS, const std::string &PS) {
     GLint status = 0;
-    GUI::ScopedOnlyLog scopedOnlyLog(gui);
 
     GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    auto VS = getVertexText();
     const char *VSv = VS.data();
     glShaderSource(vertexShader, 1, &VSv, 0);
     glCompileShader(vertexShader);
@@ -323,11 +318,10 @@ PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::compile(GUI *gui,
 
         free(log);
         glDeleteShader(vertexShader);
-        return OpenGL::Status::makeError(m_errorMessage);
+        return 0;
     }
 
     GLuint pixelShader = glCreateShader(GL_FRAGMENT_SHADER);
-    auto PS = getPixelText();
     const char *PSv = PS.data();
     glShaderSource(pixelShader, 1, &PSv, 0);
     glCompileShader(pixelShader);
@@ -345,14 +339,17 @@ PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::compile(GUI *gui,
         free(log);
         glDeleteShader(vertexShader);
         glDeleteShader(pixelShader);
-        return OpenGL::Status::makeError(m_errorMessage);
+        return 0;
     }
 
     GLuint shaderProgram = glCreateProgram();
     glAttachShader(shaderProgram, vertexShader);
     glAttachShader(shaderProgram, pixelShader);
+    cache.prepare(shaderProgram);
 
     glLinkProgram(shaderProgram);
+    glDeleteShader(vertexShader);
+    glDeleteShader(pixelShader);
 
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &status);
     if (status == 0) {
@@ -366,9 +363,27 @@ PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::compile(GUI *gui,
 
         free(log);
         glDeleteProgram(shaderProgram);
-        glDeleteShader(vertexShader);
-        glDeleteShader(pixelShader);
-        return OpenGL::Status::makeError(m_errorMessage);
+        return 0;
+    }
+
+    return shaderProgram;
+}
+
+PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::compile(GUI *gui,
+                                                          const std::vector<std::string_view> &mandatoryAttributes) {
+    m_setupVAO = true;
+    m_shaderProjMtxLoc = -1;
+    GUI::ScopedOnlyLog scopedOnlyLog(gui);
+
+    // The program only gets compiled when the cache doesn't already have it for these exact sources.
+    auto &cache = gui->getProgramCache();
+    const auto VS = getVertexText();
+    const auto PS = getPixelText();
+    GLuint shaderProgram = cache.load({VS, PS});
+    if (shaderProgram == 0) {
+        shaderProgram = link(cache, VS, PS);
+        if (shaderProgram == 0) return OpenGL::Status::makeError(m_errorMessage);
+        cache.store(shaderProgram, {VS, PS});
     }
 
     for (auto attrib : mandatoryAttributes) {
@@ -376,15 +391,10 @@ PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::compile(GUI *gui,
         if (loc == -1) {
             m_errorMessage = fmt::format(f_("Missing attribute {} in shader program"), attrib);
             glDeleteProgram(shaderProgram);
-            glDeleteShader(vertexShader);
-            glDeleteShader(pixelShader);
             return OpenGL::Status::makeError(m_errorMessage);
         }
     }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(pixelShader);
-
     m_errorMessage.clear();
     gui->getGLerrors();
 
@@ -33,6 +33,7 @@
 namespace PCSX {
 
 class GUI;
+class ProgramCache;
 
 namespace Widgets {
 
@@ -73,6 +74,7 @@ class ShaderEditor {
     void configure(GUI*);
 
   private:
+    GLuint link(ProgramCache &cache, const std::string &VS, const std::string &PS);
     std::string getVertexText() { return m_vertexShaderEditor.getText(); }
     std::string getPixelText() { return m_pixelShaderEditor.getText(); }
     std::string getLuaText() { return m_luaEditor.getText(); }
@@ -20,6 +20,7 @@
 
 #include "gui/widgets/typed_debugger.h"
 
+#include <algorithm>
 #include <fstream>
 #include <magic_enum_all.hpp>
 #include <regex>
@@ -120,6 +121,8 @@ void PCSX::Widgets::TypedDebugger::import(std::string_view fileContents, ImportT
         }
     }
 
+    if (importType == ImportType::Functions) sortFunctionRanges();
+
     if (importType == ImportType::DataTypes) {
         std::sort(m_typeNames.begin(), m_typeNames.end(), [](const std::string& left, const std::string& right) {
             const auto leftSize = left.size();
@@ -182,33 +185,32 @@ PCSX::Widgets::TypedDebugger::TypedDebugger(bool& show, std::vector<std::string>
 void PCSX::Widgets::TypedDebugger::populate(WatchTreeNode* node) {
     const auto type = node->type;
 
-    const std::regex arrayRegex(R"((.*)\[(\d+)\])");
+    // Compiling the regex costs a lot more than matching it, and deep structs get here once per field.
+    static const std::regex arrayRegex(R"((.*)\[(\d+)\])");
     std::smatch matches;
     if (std::regex_match(type, matches, arrayRegex)) {
         const auto elementType = matches[1].str();
         const auto numChildren = std::stoul(matches[2].str());
 
         size_t elementSize = 0;
-        if (m_structs.contains(elementType)) {
-            for (const auto& field : m_structs[elementType]) {
+        auto elementStruct = m_structs.find(elementType);
+        if (elementStruct != m_structs.end()) {
+            for (const auto& field : elementStruct->second) {
                 elementSize += field.size;
             }
         } else {
             elementSize = node->size / numChildren;
         }
 
+        node->children.reserve(node->children.size() + numChildren);
         for (size_t i = 0; i < numChildren; ++i) {
-            WatchTreeNode newNode{elementType, std::string(node->name + "[" + std::to_string(i) + "]"), elementSize};
-            node->children.push_back(newNode);
+            node->children.push_back({elementType, fmt::format("{}[{}]", node->name, i), elementSize});
             populate(&node->children.back());
         }
-    } else if (m_structs.contains(type)) {
-        const size_t numChildren = m_structs[type].size();
-
-        for (size_t i = 0; i < numChildren; ++i) {
-            const auto& field = m_structs[type][i];
-            WatchTreeNode newNode{field.type, field.name, field.size};
-            node->children.push_back(newNode);
+    } else if (auto fields = m_structs.find(type); fields != m_structs.end()) {
+        node->children.reserve(node->children.size() + fields->second.size());
+        for (const auto& field : fields->second) {
+            node->children.push_back({field.type, field.name, field.size});
             populate(&node->children.back());
         }
     }
@@ -249,7 +251,7 @@ void PCSX::Widgets::TypedDebugger::displayBreakpointOptions(WatchTreeNode* node,
                 }
             }
 
-            ReadWriteLogEntry newLogEntry{pc, funcName.data(), accessType};
+            ReadWriteLogEntry newLogEntry{pc, intern(funcName), accessType};
             node->logEntries.push_back(newLogEntry);
 
             if (pause) {
@@ -305,7 +307,8 @@ void PCSX::Widgets::TypedDebugger::displayBreakpointOptions(WatchTreeNode* node,
 
                 ImGui::TableNextRow();
                 ImGui::TableNextColumn();  // Name.
-                ImGui::TextUnformatted(logEntry.functionName.c_str());
+                ImGui::TextUnformatted(logEntry.functionName.data(),
+                                       logEntry.functionName.data() + logEntry.functionName.size());
                 ImGui::TableNextColumn();  // Type.
                 ImGui::Text("0x%x", instructionAddress);
                 ImGui::TableNextColumn();  // Size.
@@ -338,19 +341,80 @@ void PCSX::Widgets::TypedDebugger::displayBreakpointOptions(WatchTreeNode* node,
     }
 }
 
+void PCSX::Widgets::TypedDebugger::sortFunctionRanges() {
+    m_functionRanges.clear();
+    m_functionRanges.reserve(m_functions.size());
+    for (const auto& [address, function] : m_functions) m_functionRanges.push_back({address, intern(function.name)});
+    std::sort(m_functionRanges.begin(), m_functionRanges.end(),
+              [](const FunctionRange& a, const FunctionRange& b) { return a.address < b.address; });
+}
+
+std::string_view PCSX::Widgets::TypedDebugger::intern(std::string_view name) {
+    auto it = m_internedNames.find(name);
+    if (it == m_internedNames.end()) it = m_internedNames.emplace(name).first;
+    return *it;
+}
+
 std::string_view PCSX::Widgets::TypedDebugger::getFunctionNameFromInstructionAddress(uint32_t address) {
-    if (m_instructionAddressToFunctionMap.contains(address)) {
-        return m_instructionAddressToFunctionMap[address];
-    } else {
-        for (size_t i = 0; i < m_functionAddresses.size() - 1; ++i) {
-            if (address >= m_functionAddresses[i] && address < m_functionAddresses[i + 1]) {
-                const auto knownAddress = m_functionAddresses[i];
-                m_instructionAddressToFunctionMap[address] = m_functions[knownAddress].name;
-                return m_instructionAddressToFunctionMap[address];
-            }
-        }
+    // The last function has no known end, so nothing past its start is attributed to it.
+    auto it = std::upper_bound(m_functionRanges.begin(), m_functionRanges.end(), address,
+                               [](uint32_t address, const FunctionRange& range) { return address < range.address; });
+    if ((it == m_functionRanges.begin()) || (it == m_functionRanges.end())) return std::string_view();
+    return std::prev(it)->name;
+}
+
+void PCSX::Widgets::TypedDebugger::updatePageGenerations() {
+    auto& mem = g_emulator->m_mem;
+    if (!m_dirtyPagesConsumer) m_dirtyPagesConsumer = mem->addDirtyPagesConsumer();
+    const auto dirty = mem->takeDirtyPages(m_dirtyPagesConsumer.value());
+    m_generation++;
+    for (size_t i = 0; i < dirty.size(); i++) {
+        if (dirty[i]) m_pageGenerations[i] = m_generation;
+    }
+}
+
+bool PCSX::Widgets::TypedDebugger::isClean(uint32_t address, size_t size, uint32_t generation) {
+    if (generation == 0) return false;
+    auto& mem = g_emulator->m_mem;
+    // Anything outside of RAM, such as the scratchpad, isn't tracked, and always gets read again.
+    const int first = mem->dirtyPageOf(address);
+    const int last = mem->dirtyPageOf(address + std::max(size, size_t(1)) - 1);
+    if ((first < 0) || (last < first)) return false;
+    for (int page = first; page <= last; page++) {
+        if (m_pageGenerations[page] > generation) return false;
+    }
+    return true;
+}
+
+uint32_t PCSX::Widgets::TypedDebugger::readPointer(WatchTreeNode* node, uint32_t address, IO<File> memFile) {
+    if ((node->pointerAddress != address) || !isClean(address, 4, node->pointerGeneration)) {
+        node->pointerAddress = address;
+        node->pointerGeneration = m_generation;
+        node->pointerValue = memFile->readAt<uint32_t>(address);
+    }
+    return node->pointerValue;
+}
+
+const PCSX::Slice& PCSX::Widgets::TypedDebugger::readValue(WatchTreeNode* node, uint32_t address, IO<File> memFile) {
+    if ((node->valueAddress != address) || !isClean(address, node->size, node->valueGeneration)) {
+        node->valueAddress = address;
+        node->valueGeneration = m_generation;
+        node->value = memFile->readAt(node->size, address);
+    }
+    return node->value;
+}
+
+// A string only depends on its bytes up to the terminator, so those are the only ones that need to be clean.
+const std::string& PCSX::Widgets::TypedDebugger::readString(WatchTreeNode* node, uint32_t address,
+                                                            IO<File> memFile) {
+    const size_t size = node->valueAddress == address ? node->string.size() + 1 : 1;
+    if ((node->valueAddress != address) || !isClean(address, size, node->valueGeneration)) {
+        node->valueAddress = address;
+        node->valueGeneration = m_generation;
+        memFile->rSeek(address, SEEK_SET);
+        node->string = memFile->gets();
     }
-    return std::string_view();
+    return node->string;
 }
 
 void PCSX::Widgets::TypedDebugger::displayNode(WatchTreeNode* node, const uint32_t currentAddress, bool watchView,
@@ -364,7 +428,7 @@ void PCSX::Widgets::TypedDebugger::displayNode(WatchTreeNode* node, const uint32
     const bool isPointer = node->type.back() == '*';
     uint32_t startAddress = currentAddress;
     if (isPointer && addressOfPointer) {
-        startAddress = memFile->readAt<uint32_t>(currentAddress);
+        startAddress = readPointer(node, currentAddress, memFile);
     }
 
     if (node->children.size() > 0) {  // If this is a struct, array or already populated pointer, display children.
@@ -447,8 +511,7 @@ void PCSX::Widgets::TypedDebugger::displayNode(WatchTreeNode* node, const uint32
             return;
         }
         if (equals(nodeType, "char *")) {
-            memFile->rSeek(startAddress, SEEK_SET);
-            auto str = memFile->gets();
+            const auto& str = readString(node, startAddress, memFile);
             unsigned strLength = str.size() + 1;
 
             ImGui::TableNextColumn();  // Size.
@@ -485,7 +548,7 @@ void PCSX::Widgets::TypedDebugger::displayNode(WatchTreeNode* node, const uint32
         ImGui::TableNextColumn();  // Size.
         ImGui::Text("%zu", node->size);
         ImGui::TableNextColumn();  // Value.
-        auto value = memFile->readAt(node->size, startAddress);
+        const auto& value = readValue(node, startAddress, memFile);
         const auto* nodeType = node->type.c_str();
         printValue(nodeType, node->size, value);
         ImGui::TableNextColumn();  // New value.
@@ -690,7 +753,7 @@ Arrays and pointers are specified as for data types)"));
                 } else {
                     m_functionAddresses.clear();
                     m_functions.clear();
-                    m_instructionAddressToFunctionMap.clear();
+                    m_functionRanges.clear();
                 }
                 std::ifstream file(reinterpret_cast<const char*>(fileToOpen[0].c_str()));
                 std::stringstream fileContents;
@@ -740,6 +803,8 @@ Arrays and pointers are specified as for data types)"));
                                             ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_Resizable |
                                             ImGuiTableFlags_RowBg | ImGuiTableFlags_NoBordersInBody;
 
+    updatePageGenerations();
+
     if (ImGui::BeginTabBar(_("TypedDebuggerTabBar"))) {
         if (ImGui::BeginTabItem(_("Watch"))) {
             ImGuiInputTextFlags textFlags = ImGuiInputTextFlags_CharsHexadecimal |
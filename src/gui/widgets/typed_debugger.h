@@ -20,12 +20,17 @@
 
 #pragma once
 
+#include <array>
+#include <optional>
+#include <set>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <variant>
 #include <vector>
 
 #include "core/debug.h"
+#include "core/psxmem.h"
 #include "gui/widgets/filedialog.h"
 #include "imgui.h"
 #include "support/eventbus.h"
@@ -67,7 +72,8 @@ class TypedDebugger {
         enum class AccessType { Read, Write };
 
         uint32_t instructionAddress;
-        std::string functionName;
+        // Interned, see intern().
+        std::string_view functionName;
         AccessType accessType;
     };
 
@@ -78,6 +84,16 @@ class TypedDebugger {
         size_t size = 0;
         std::vector<WatchTreeNode> children;
         std::vector<ReadWriteLogEntry> logEntries;
+
+        // What got read from memory the last time this node was displayed, along with the generation it was
+        // read at. A generation of 0 means nothing is cached. See isClean().
+        uint32_t pointerAddress = 0;
+        uint32_t pointerGeneration = 0;
+        uint32_t pointerValue = 0;
+        uint32_t valueAddress = 0;
+        uint32_t valueGeneration = 0;
+        Slice value;
+        std::string string;
     };
 
     using StructFields = std::vector<FieldOrArgumentData>;
@@ -143,7 +159,34 @@ class TypedDebugger {
     // Returns the name of the function from which the instruction at the given address was emitted if found, an empty
     // string otherwise.
     std::string_view getFunctionNameFromInstructionAddress(uint32_t address);
-    std::unordered_map<uint32_t, std::string> m_instructionAddressToFunctionMap;
+    // The imported functions sorted by address, with each one assumed to end where the next one starts.
+    struct FunctionRange {
+        uint32_t address;
+        std::string_view name;
+    };
+    std::vector<FunctionRange> m_functionRanges;
+    void sortFunctionRanges();
+
+    // The function names end up in every log entry, and outlive a reimport of the functions, so they're
+    // only ever stored once, here.
+    std::string_view intern(std::string_view name);
+    std::set<std::string, std::less<>> m_internedNames;
+
+    /**
+     * Memory reads.
+     */
+
+    // The values displayed only get read again once the RAM pages they're in have been written to, which
+    // the emulated machine tells us through its dirty pages. Each frame is a generation, and each page
+    // remembers the last generation it was written in.
+    void updatePageGenerations();
+    bool isClean(uint32_t address, size_t size, uint32_t generation);
+    uint32_t readPointer(WatchTreeNode* node, uint32_t address, IO<File> memFile);
+    const Slice& readValue(WatchTreeNode* node, uint32_t address, IO<File> memFile);
+    const std::string& readString(WatchTreeNode* node, uint32_t address, IO<File> memFile);
+    std::optional<unsigned> m_dirtyPagesConsumer;
+    std::array<uint32_t, Memory::c_dirtyPageCount> m_pageGenerations = {};
+    uint32_t m_generation = 1;
 
     /**
      * Display.
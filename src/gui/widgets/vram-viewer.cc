@@ -398,6 +398,8 @@ void PCSX::Widgets::VRAMViewer::drawVRAM(GUI *gui, GLuint textureID) {
     m_resolution = ImGui::GetContentRegionAvail();
     m_origin = ImGui::GetCursorScreenPos();
     auto viewport = ImGui::GetWindowViewport();
+    m_viewportPosition = viewport->Pos;
+    m_viewportSize = viewport->Size;
     auto monitor = ImGui::GetViewportPlatformMonitor(viewport);
     m_monitorResolution = monitor->MainSize;
     m_monitorPosition = monitor->MainPos;
@@ -492,6 +494,8 @@ void PCSX::Widgets::VRAMViewer::drawVRAM(GUI *gui, GLuint textureID) {
 }
 
 void PCSX::Widgets::VRAMViewer::drawEditor(GUI *gui) {
+    // Shaders being worked on may well animate, so the viewer keeps redrawing even while paused.
+    gui->requestRedraw();
     bool changed = m_editor.draw(gui, _("VRAM Shader Editor"));
     if (!changed) return;
     compileShader(gui);
@@ -502,13 +506,19 @@ void PCSX::Widgets::VRAMViewer::imguiCB(const ImDrawList *parentList, const ImDr
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     if (!m_shaderProgram) return;
-    GLint imguiProgramID;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &imguiProgramID);
 
-    GLint projMatrixLocation = glGetUniformLocation(imguiProgramID, "ProjMtx");
-
-    GLfloat currentProjection[4][4];
-    glGetUniformfv(imguiProgramID, projMatrixLocation, &currentProjection[0][0]);
+    // This is the orthographic projection the ImGui OpenGL backend sets up for the viewport. Building it here
+    // instead of reading it back from the backend's program avoids stalling on the driver every frame.
+    const float L = m_viewportPosition.x;
+    const float R = m_viewportPosition.x + m_viewportSize.x;
+    const float T = m_viewportPosition.y;
+    const float B = m_viewportPosition.y + m_viewportSize.y;
+    const GLfloat currentProjection[4][4] = {
+        {2.0f / (R - L), 0.0f, 0.0f, 0.0f},
+        {0.0f, 2.0f / (T - B), 0.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f, 0.0f},
+        {(R + L) / (L - R), (T + B) / (B - T), 0.0f, 1.0f},
+    };
 
     glUseProgram(m_shaderProgram);
 
@@ -653,6 +663,8 @@ void PCSX::Widgets::VRAMViewer::draw(GUI *gui, unsigned int VRAMTexture) {
             }
             ImGui::EndMenuBar();
         }
+        // The logger only draws its heatmaps at the end of each frame, which may not have come yet when paused.
+        g_emulator->m_gpuLogger->flushHeatmaps();
         drawVRAM(gui, VRAMTexture);
     }
     if (openReadColorPicker) {
@@ -124,6 +124,9 @@ class VRAMViewer {
     ImVec2 m_mousePos;
     ImVec2 m_mouseUV;
     ImVec2 m_origin;
+    // The area the viewport's draw data covers, to rebuild the same projection as the ImGui backend.
+    ImVec2 m_viewportPosition;
+    ImVec2 m_viewportSize;
     ImVec4 m_readColor = ImVec4{0.0f, 1.0f, 0.0f, 0.375f};
     ImVec2 m_resolution;
     ImVec4 m_writtenColor = ImVec4{1.0f, 0.0f, 0.0f, 0.375f};
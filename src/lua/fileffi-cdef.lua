@@ -27,6 +27,7 @@ enum FileOps {
     CREATE,
     READWRITE,
     DOWNLOAD_URL,
+    STREAM_URL,
 };
 
 enum SeekWheel {
@@ -74,6 +75,8 @@ uint64_t readFileAtRawPtr(LuaFile* wrapper, void* dst, uint64_t size, uint64_t p
 uint64_t readFileAtBuffer(LuaFile* wrapper, LuaBuffer* buffer, uint64_t pos);
 LuaSlice* readFileAtToSlice(LuaFile* wrapper, uint64_t size, uint64_t pos);
 uint64_t readFileAtToExistingSlice(LuaFile* wrapper, LuaSlice* slice, uint64_t size, uint64_t pos);
+LuaSlice* viewFileAt(LuaFile* wrapper, uint64_t size, uint64_t pos);
+uint64_t viewFileAtToExistingSlice(LuaFile* wrapper, LuaSlice* slice, uint64_t size, uint64_t pos);
 
 uint64_t writeFileAtRawPtr(LuaFile* wrapper, const const void* data, uint64_t size, uint64_t pos);
 uint64_t writeFileAtBuffer(LuaFile* wrapper, const LuaBuffer* buffer, uint64_t pos);
@@ -92,6 +95,12 @@ bool startFileCachingWithCallback(LuaFile* wrapper, void (*callback)());
 LuaFile* dupFile(LuaFile*);
 
 LuaFile* zReader(LuaFile*, int64_t size, bool raw);
+LuaFile* zWriter(LuaFile*, int level, int windowBits, int memLevel, int format);
+
+typedef struct { char opaque[?]; } LuaZCompressor;
+LuaZCompressor* newZCompressor(int level, int windowBits, int memLevel, int format);
+void destroyZCompressor(LuaZCompressor*);
+uint64_t zCompress(LuaZCompressor*, const void* data, uint64_t size, LuaFile* out);
 
 LuaSlice* createEmptySlice();
 uint64_t getSliceSize(LuaSlice*);
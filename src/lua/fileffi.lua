@@ -74,6 +74,20 @@ local function readAtToSlice(self, size, pos)
         C.readFileAtToSlice, self._wrapper, size, pos))
 end
 
+-- Returns a Slice referencing the file's memory directly when possible, instead of a copy.
+-- The Slice keeps the file alive. Passing an existing Slice reuses it, which avoids any
+-- allocation when called repeatedly, for instance every frame.
+local function viewAt(self, size, pos, slice)
+    if type(slice) == 'table' and slice._type == 'Slice' then
+        Support.extra.safeFFI('File::viewAt(C.viewFileAtToExistingSlice)', C.viewFileAtToExistingSlice, self._wrapper,
+            slice._wrapper, size, pos)
+        rawset(slice, '_owner', self)
+        return slice
+    end
+    return Support.File._createSliceWrapper(Support.extra.safeFFI('File::viewAt(C.viewFileAt)', C.viewFileAt,
+        self._wrapper, size, pos), self)
+end
+
 local function write(self, data, size)
     if type(data) == 'cdata' and size == nil and ffi.typeof(data) == LuaBuffer then
         return Support.extra.safeFFI('File::write(C.writeFileBuffer)', C.writeFileBuffer, self._wrapper,
@@ -191,6 +205,7 @@ local function createFileWrapper(wrapper)
         readToSlice = readToSlice,
         readAt = readAt,
         readAtToSlice = readAtToSlice,
+        viewAt = viewAt,
         gets = function(self) return Support._internal.readFileGets(self._wrapper) end,
         write = write,
         writeAt = writeAt,
@@ -300,6 +315,48 @@ local function zReader(file, size, raw)
     return createFileWrapper(C.zReader(file._wrapper, size, raw))
 end
 
+-- The options are a table with the optional fields level, windowBits, memLevel, and format,
+-- the latter being one of 'ZLIB' (the default), 'RAW', or 'GZIP'.
+local zFormats = { ZLIB = 0, RAW = 1, GZIP = 2 }
+local function zArgs(options)
+    if type(options) == 'string' then options = { format = options } end
+    if type(options) ~= 'table' then options = {} end
+    local format = zFormats[options.format or 'ZLIB']
+    if format == nil then error('Invalid zlib format ' .. tostring(options.format)) end
+    return options.level or -1, options.windowBits or 15, options.memLevel or 9, format
+end
+
+local function zWriter(file, options)
+    return createFileWrapper(C.zWriter(file._wrapper, zArgs(options)))
+end
+
+-- A compression context which can be reused for many independent streams, which is much
+-- cheaper than creating a new zWriter every time something small needs compressing.
+local function zCompressor(options)
+    local compressor = {
+        _wrapper = ffi.gc(C.newZCompressor(zArgs(options)), C.destroyZCompressor),
+        compress = function(self, data, size, file)
+            if type(size) == 'table' and file == nil then
+                file = size
+                size = nil
+            end
+            if type(data) == 'table' and data._type == 'Slice' then
+                size = size or data.size
+                data = data.data
+            elseif Support.isLuaBuffer(data) then
+                size = size or data.size
+                data = data.data
+            elseif type(data) == 'string' then
+                size = size or string.len(data)
+            end
+            if file == nil then file = Support.File.buffer() end
+            Support.extra.safeFFI('ZCompressor::compress', C.zCompress, self._wrapper, data, size, file._wrapper)
+            return file
+        end,
+    }
+    return compressor
+end
+
 local function uvFifo(address, port)
     if type(address) ~= 'string' then error('address must be a string') end
     if type(port) ~= 'number' then error('port must be a number') end
@@ -339,6 +396,8 @@ Support.File = {
     open = open,
     buffer = buffer,
     zReader = zReader,
+    zWriter = zWriter,
+    zCompressor = zCompressor,
     uvFifo = uvFifo,
     mem4g = mem4g,
     failedFile = function() return createFileWrapper(C.failedFile()) end,
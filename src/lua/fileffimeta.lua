@@ -51,8 +51,8 @@ local sliceMeta = {
     end,
 }
 
-local function createSliceWrapper(wrapper)
-    local slice = { _wrapper = ffi.gc(wrapper, C.destroySlice), _type = 'Slice' }
+local function createSliceWrapper(wrapper, owner)
+    local slice = { _wrapper = ffi.gc(wrapper, C.destroySlice), _type = 'Slice', _owner = owner }
     return setmetatable(slice, sliceMeta)
 end
 
@@ -37,6 +37,7 @@ enum FileOps {
     CREATE,
     READWRITE,
     DOWNLOAD_URL,
+    STREAM_URL,
 };
 
 void deleteFile(LuaFile* wrapper) { delete wrapper; }
@@ -53,6 +54,8 @@ LuaFile* openFile(const char* filename, FileOps type) {
             return new LuaFile(new PCSX::UvFile(filename, PCSX::FileOps::READWRITE));
         case DOWNLOAD_URL:
             return new LuaFile(new PCSX::UvFile(filename, PCSX::UvFile::DOWNLOAD_URL));
+        case STREAM_URL:
+            return new LuaFile(new PCSX::UvHttpFile(filename));
     }
 
     return nullptr;
@@ -129,6 +132,13 @@ PCSX::Slice* readFileAtToSlice(LuaFile* wrapper, uint64_t size, uint64_t pos) {
 uint64_t readFileAtToExistingSlice(LuaFile* wrapper, PCSX::Slice* slice, uint64_t size, uint64_t pos) {
     return wrapper->file->readAt(slice->mutableData(), size, pos);
 }
+PCSX::Slice* viewFileAt(LuaFile* wrapper, uint64_t size, uint64_t pos) {
+    return new PCSX::Slice(wrapper->file->viewAt(size, pos));
+}
+uint64_t viewFileAtToExistingSlice(LuaFile* wrapper, PCSX::Slice* slice, uint64_t size, uint64_t pos) {
+    *slice = wrapper->file->viewAt(size, pos);
+    return slice->size();
+}
 
 uint64_t writeFileAtRawPtr(LuaFile* wrapper, const uint8_t* data, uint64_t size, uint64_t pos) {
     return wrapper->file->writeAt(data, size, pos);
@@ -179,6 +189,41 @@ LuaFile* zReader(LuaFile* wrapper, int64_t size, bool raw) {
                            : new PCSX::ZReader(wrapper->file, size));
 }
 
+// The format is 0 for a zlib stream, 1 for a raw deflate stream, and 2 for a gzip stream.
+PCSX::ZWriter::Options zOptions(int level, int windowBits, int memLevel) {
+    PCSX::ZWriter::Options options;
+    options.level = level;
+    options.windowBits = windowBits;
+    options.memLevel = memLevel;
+    return options;
+}
+
+LuaFile* zWriter(LuaFile* wrapper, int level, int windowBits, int memLevel, int format) {
+    auto options = zOptions(level, windowBits, memLevel);
+    switch (format) {
+        case 1:
+            return new LuaFile(new PCSX::ZWriter(wrapper->file, PCSX::ZWriter::RAW, options));
+        case 2:
+            return new LuaFile(new PCSX::ZWriter(wrapper->file, PCSX::ZWriter::GZIP, options));
+    }
+    return new LuaFile(new PCSX::ZWriter(wrapper->file, options));
+}
+
+PCSX::ZCompressor* newZCompressor(int level, int windowBits, int memLevel, int format) {
+    auto options = zOptions(level, windowBits, memLevel);
+    switch (format) {
+        case 1:
+            return new PCSX::ZCompressor(PCSX::ZCompressor::RAW, options);
+        case 2:
+            return new PCSX::ZCompressor(PCSX::ZCompressor::GZIP, options);
+    }
+    return new PCSX::ZCompressor(options);
+}
+void destroyZCompressor(PCSX::ZCompressor* compressor) { delete compressor; }
+uint64_t zCompress(PCSX::ZCompressor* compressor, const void* data, uint64_t size, LuaFile* out) {
+    return compressor->compress(data, size, out->file);
+}
+
 PCSX::Slice* createEmptySlice() { return new PCSX::Slice(); }
 uint64_t getSliceSize(PCSX::Slice* slice) { return slice->size(); }
 const void* getSliceData(PCSX::Slice* slice) { return slice->data(); }
@@ -342,6 +387,8 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, readFileAtBuffer);
     REGISTER(L, readFileAtToSlice);
     REGISTER(L, readFileAtToExistingSlice);
+    REGISTER(L, viewFileAt);
+    REGISTER(L, viewFileAtToExistingSlice);
 
     REGISTER(L, writeFileAtRawPtr);
     REGISTER(L, writeFileAtBuffer);
@@ -360,6 +407,10 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, dupFile);
 
     REGISTER(L, zReader);
+    REGISTER(L, zWriter);
+    REGISTER(L, newZCompressor);
+    REGISTER(L, destroyZCompressor);
+    REGISTER(L, zCompress);
 
     REGISTER(L, createEmptySlice);
     REGISTER(L, getSliceSize);
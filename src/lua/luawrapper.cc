@@ -226,11 +226,20 @@ void PCSX::Lua::call(int nargs) {
 }
 
 int PCSX::Lua::pcall(int nargs) {
-    push([](lua_State* L_) -> int {
-        Lua L(L_);
-        L.pushLuaContext(true);
-        return 1;
-    });
+    // The error handler is created once and kept in the registry, so that calls don't allocate a closure.
+    push("_PCALL_ERROR_HANDLER");
+    gettable(LUA_REGISTRYINDEX);
+    if (isnil()) {
+        pop();
+        push([](lua_State* L_) -> int {
+            Lua L(L_);
+            L.pushLuaContext(true);
+            return 1;
+        });
+        push("_PCALL_ERROR_HANDLER");
+        copy(-2);
+        settable(LUA_REGISTRYINDEX);
+    }
 
     const int errfunc = gettop() - (nargs + 1);
     insert(-2 - nargs);
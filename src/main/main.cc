@@ -17,6 +17,7 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
+#include <chrono>
 #include <csignal>
 #include <filesystem>
 #include <iostream>
@@ -25,11 +26,15 @@
 
 #include "core/arguments.h"
 #include "core/cdrom.h"
+#include "core/framestats.h"
 #include "core/gpu.h"
+#include "core/gpulogger.h"
 #include "core/logger.h"
+#include "core/movie.h"
 #include "core/psxemulator.h"
 #include "core/r3000a.h"
 #include "core/sstate.h"
+#include "core/statebench.h"
 #include "core/ui.h"
 #include "flags.h"
 #include "fmt/chrono.h"
@@ -38,12 +43,14 @@
 #include "lua/luawrapper.h"
 #include "main/textui.h"
 #include "spu/interface.h"
+#include "support/benchmark.h"
 #include "support/binpath.h"
 #include "support/uvfile.h"
 #include "support/version.h"
 #include "tracy/Tracy.hpp"
 
 static PCSX::UI *s_ui;
+static PCSX::System *s_system;
 
 class SystemImpl final : public PCSX::System {
     virtual void biosPutc(int c) final override {
@@ -55,6 +62,7 @@ class SystemImpl final : public PCSX::System {
         }
     }
     virtual void message(std::string &&s) final override {
+        flushLogs();
         if (m_args.isGUILogsEnabled()) s_ui->addNotification(s.c_str());
         if (s_ui->addLog(PCSX::LogClass::UI, s)) {
             if (m_args.isStdoutEnabled()) ::fputs(s.c_str(), stdout);
@@ -63,7 +71,7 @@ class SystemImpl final : public PCSX::System {
         }
     }
 
-    virtual void log(PCSX::LogClass logClass, std::string &&s) final override {
+    virtual void writeLog(PCSX::LogClass logClass, std::string &&s) final override {
         if (m_args.isGUILogsEnabled()) {
             if (!s_ui->addLog(logClass, s)) return;
         }
@@ -73,6 +81,7 @@ class SystemImpl final : public PCSX::System {
     }
 
     virtual void printf(std::string &&s) final override {
+        flushLogs();
         if (m_args.isGUILogsEnabled()) {
             if (!s_ui->addLog(PCSX::LogClass::UNCATEGORIZED, s)) return;
         }
@@ -97,6 +106,7 @@ class SystemImpl final : public PCSX::System {
 
     virtual void update(bool vsync = false) final override {
         // called on vblank to update states
+        flushLogs();
         s_ui->update(vsync);
     }
 
@@ -166,7 +176,8 @@ struct Cleaner {
     std::function<void()> f;
 };
 
-void handleSignal(int signal) { PCSX::g_system->quit(-1); }
+// Signals can land on any thread, which wouldn't have the system bound.
+void handleSignal(int signal) { s_system->quit(-1); }
 
 int pcsxMain(int argc, char **argv) {
     ZoneScoped;
@@ -195,6 +206,7 @@ int pcsxMain(int argc, char **argv) {
     // enabled as much as possible.
     SystemImpl *system = new SystemImpl(args);
     PCSX::g_system = system;
+    s_system = system;
     auto sigint = std::signal(SIGINT, handleSignal);
     auto sigterm = std::signal(SIGTERM, handleSignal);
 #ifndef _WIN32
@@ -206,7 +218,6 @@ int pcsxMain(int argc, char **argv) {
     std::filesystem::path self = PCSX::BinPath::getExecutablePath();
     std::filesystem::path binDir = std::filesystem::absolute(self).parent_path();
     system->setBinDir(binDir);
-    system->loadAllLocales();
 
     // This is another early out, which can only be done once we have a system object.
     if (args.get<bool>("version")) {
@@ -269,6 +280,27 @@ int pcsxMain(int argc, char **argv) {
         if (args.get<bool>("no-trace")) {
             debugSettings.get<PCSX::Emulator::DebugSettings::Trace>() = false;
         }
+        auto traceFile = args.get<std::string>("trace-file");
+        if (traceFile.has_value()) {
+            debugSettings.get<PCSX::Emulator::DebugSettings::TraceFile>() = traceFile.value();
+            debugSettings.get<PCSX::Emulator::DebugSettings::Trace>() = true;
+        }
+        auto blockTraceRecord = args.get<std::string>("blocktrace-record");
+        if (blockTraceRecord.has_value()) {
+            debugSettings.get<PCSX::Emulator::DebugSettings::BlockTraceRecord>() = blockTraceRecord.value();
+        }
+        auto blockTraceVerify = args.get<std::string>("blocktrace-verify");
+        if (blockTraceVerify.has_value()) {
+            debugSettings.get<PCSX::Emulator::DebugSettings::BlockTraceVerify>() = blockTraceVerify.value();
+        }
+        auto profileFile = args.get<std::string>("profile");
+        if (profileFile.has_value()) {
+            debugSettings.get<PCSX::Emulator::DebugSettings::ProfileFile>() = profileFile.value();
+        }
+        auto profileInterval = args.get<uint32_t>("profile-interval");
+        if (profileInterval.has_value()) {
+            debugSettings.get<PCSX::Emulator::DebugSettings::ProfileInterval>() = profileInterval.value();
+        }
 
         if (args.get<bool>("8mb")) {
             emuSettings.get<PCSX::Emulator::Setting8MB>() = true;
@@ -327,6 +359,11 @@ int pcsxMain(int argc, char **argv) {
         if (args.get<bool>("no-kiosk")) {
             emuSettings.get<PCSX::Emulator::SettingKioskMode>() = false;
         }
+
+        if (!args.get<bool>("no-http-cache")) {
+            const uint64_t cacheSize = args.get<uint64_t>("http-cache-size").value_or(4096);
+            PCSX::UvHttpFile::setCacheDirectory(system->getPersistentDir() / "http-cache", cacheSize * 1024 * 1024);
+        }
     });
 
     // Now it's time to mount our iso filesystem
@@ -445,6 +482,56 @@ runner.init({
 
             system->m_inStartup = false;
 
+            // The GPU benchmark mode only plays a capture back through the GPU, reports how long it took, and exits.
+            auto gpuBench = args.get<std::string>("gpu-bench");
+            if (gpuBench.has_value()) {
+                const unsigned passes = args.get<uint32_t>("gpu-bench-passes").value_or(10);
+                std::string report;
+                if (emulator->m_gpuLogger->benchmark(gpuBench.value(), emulator->m_gpu.get(), passes, report)) {
+                    fmt::print("{}", report);
+                    system->quit(0);
+                } else {
+                    fmt::print("Unable to replay the GPU capture {}\n", gpuBench.value());
+                    system->quit(1);
+                }
+            }
+
+            // The benchmark mode runs whichever benchmarks got linked in, against the emulator as set up so far,
+            // and exits. The pcsx-redux-bench binary is the one which reports their results.
+            if (args.get<bool>("bench")) {
+                const auto minTime = args.get<double>("bench-min-time");
+                if (minTime.has_value()) PCSX::Benchmark::setMinTime(minTime.value());
+                PCSX::Benchmark::runAll(args.get<std::string>("bench-filter").value_or(""));
+                system->quit(0);
+            }
+
+            // A headless replay plays a movie back from its first keyframe, and exits once it's over.
+            auto replay = system->getArgs().getReplayPath();
+            if (!replay.empty()) {
+                if (emulator->m_movie->replay(std::filesystem::path(replay), true)) {
+                    system->resume();
+                } else {
+                    fmt::print("Unable to replay the movie {}\n", replay);
+                    system->quit(1);
+                }
+            }
+
+            // The whole system benchmark runs a number of frames from a save state, and exits. Input can be scripted
+            // with the Lua files given through -dofile, and the disc the state needs given through -iso.
+            std::unique_ptr<PCSX::StateBenchmark> stateBench;
+            auto benchState = system->getArgs().getBenchStatePath();
+            if (!benchState.empty()) {
+                stateBench = std::make_unique<PCSX::StateBenchmark>();
+                if (!stateBench->start(std::filesystem::path(benchState), system->getArgs().getBenchFrames())) {
+                    fmt::print("Unable to run the benchmark from the save state {}\n", benchState);
+                    system->quit(1);
+                }
+            }
+
+            // Turbo mode reports the emulated frame rate on exit, counting from here.
+            const auto turboStart = std::chrono::steady_clock::now();
+            const uint64_t turboFirstFrame = emulator->m_frameStats->frames();
+
             // And finally, main loop.
             while (!system->quitting()) {
                 if (system->running()) {
@@ -454,10 +541,28 @@ runner.init({
                     // The "update" method will be called periodically by the emulator while
                     // it's running, meaning if we want our UI to work, we have to manually
                     // call "update" when the emulator is paused.
+                    PCSX::FrameStats::Scope scope(PCSX::FrameStats::GUI);
+                    system->flushLogs();
                     s_ui->update();
                 }
             }
             system->pause();
+            system->flushLogs();
+            if (stateBench && stateBench->done()) {
+                const auto report = stateBench->report();
+                auto output = args.get<std::string>("bench-output");
+                if (output.has_value()) {
+                    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(output.value(), PCSX::FileOps::TRUNCATE));
+                    file->write(report.data(), report.size());
+                } else {
+                    fmt::print("{}\n", report);
+                }
+            } else if (system->getArgs().isTurboEnabled()) {
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - turboStart;
+                const uint64_t frames = emulator->m_frameStats->frames() - turboFirstFrame;
+                fmt::print("Emulated {} frames in {:.2f}s, {:.1f} frames per second\n", frames, elapsed.count(),
+                           elapsed.count() > 0 ? frames / elapsed.count() : 0.0);
+            }
             system->m_eventBus->signal(PCSX::Events::Quitting{});
             system->purgeAllEvents();
         } catch (...) {
@@ -56,6 +56,7 @@ struct SPUVoice {
 #define SPU_REVERB_EN_LOW HW_U16(0x1f801d98)
 #define SPU_REVERB_EN_HIGH HW_U16(0x1f801d9a)
 
+#define SPU_IRQ_ADDR HW_U16(0x1f801da4)
 #define SPU_RAM_DTA HW_U16(0x1f801da6)
 #define SPU_CTRL HW_U16(0x1f801daa)
 #define SPU_RAM_DTC HW_U16(0x1f801dac)
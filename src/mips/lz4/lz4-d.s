@@ -0,0 +1,147 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* This is the R3000 version of lz4_decompress_block, see lz4.h for its
+   interface. It works the same way as the C version used to, alternating
+   between literal runs and back references, except that both are copied
+   one word at a time using unaligned loads and stores, falling back to
+   bytes for the last few, and for back references closer than 4 bytes,
+   which overlap their own output. Every load is followed by an unrelated
+   instruction, so no cycle is wasted on load delays. Since the copies
+   never write past the end of a run, and only ever read bytes which are
+   either behind the destination pointer, or in front of the source
+   pointer, the in-place decompression guarantees of the C version still
+   hold. */
+
+    .section .text.lz4_decompress_block, "ax", @progbits
+    .set noreorder
+    .align 2
+    .global lz4_decompress_block
+    .type lz4_decompress_block, @function
+
+    /* $a0 = source, $a1 = source end, $a2 = destination */
+lz4_decompress_block:
+    li     $t8, 15
+    li     $t9, 255
+
+.Llz4_sequence:
+    /* The token holds the literal run length in its top 4 bits,
+       and the back reference length, minus 4, in its bottom 4 bits. */
+    lbu    $t0, 0($a0)
+    addiu  $a0, 1
+    srl    $t1, $t0, 4
+    bne    $t1, $t8, .Llz4_literals
+    andi   $t0, 15
+
+    /* A length of 15 is followed by bytes to add to it, until one isn't 255. */
+.Llz4_literal_length:
+    lbu    $t2, 0($a0)
+    addiu  $a0, 1
+    beq    $t2, $t9, .Llz4_literal_length
+    addu   $t1, $t2
+
+.Llz4_literals:
+    /* Copy $t1 bytes from the source, a word at a time first. */
+    srl    $t6, $t1, 2
+    beqz   $t6, .Llz4_literal_bytes
+    andi   $t1, 3
+.Llz4_literal_words:
+    lwr    $t5, 0($a0)
+    lwl    $t5, 3($a0)
+    addiu  $t6, -1
+    addiu  $a0, 4
+    swr    $t5, 0($a2)
+    swl    $t5, 3($a2)
+    bnez   $t6, .Llz4_literal_words
+    addiu  $a2, 4
+.Llz4_literal_bytes:
+    beqz   $t1, .Llz4_literals_done
+    nop
+.Llz4_literal_bytes_loop:
+    lbu    $t5, 0($a0)
+    addiu  $t1, -1
+    addiu  $a0, 1
+    sb     $t5, 0($a2)
+    bnez   $t1, .Llz4_literal_bytes_loop
+    addiu  $a2, 1
+
+.Llz4_literals_done:
+    /* The block always ends with a literal run. */
+    sltu   $t2, $a0, $a1
+    beqz   $t2, .Llz4_end
+    /* The back reference offset is 16 bits, little endian. */
+    lbu    $t4, 0($a0)
+    lbu    $t2, 1($a0)
+    addiu  $a0, 2
+    sll    $t2, 8
+    bne    $t0, $t8, .Llz4_match
+    or     $t4, $t2
+
+.Llz4_match_length:
+    lbu    $t2, 0($a0)
+    addiu  $a0, 1
+    beq    $t2, $t9, .Llz4_match_length
+    addu   $t0, $t2
+
+.Llz4_match:
+    /* Copy $t0 + 4 bytes from $t4 bytes behind the destination. If that's
+       less than 4 bytes behind, the copy reads bytes it just wrote, which
+       can't be done a word at a time. */
+    addiu  $t0, 4
+    sltiu  $t2, $t4, 4
+    bnez   $t2, .Llz4_match_bytes_loop
+    subu   $t3, $a2, $t4
+    srl    $t6, $t0, 2
+    beqz   $t6, .Llz4_match_bytes
+    andi   $t0, 3
+.Llz4_match_words:
+    lwr    $t5, 0($t3)
+    lwl    $t5, 3($t3)
+    addiu  $t6, -1
+    addiu  $t3, 4
+    swr    $t5, 0($a2)
+    swl    $t5, 3($a2)
+    bnez   $t6, .Llz4_match_words
+    addiu  $a2, 4
+.Llz4_match_bytes:
+    beqz   $t0, .Llz4_match_done
+    nop
+.Llz4_match_bytes_loop:
+    lbu    $t5, 0($t3)
+    addiu  $t0, -1
+    addiu  $t3, 1
+    sb     $t5, 0($a2)
+    bnez   $t0, .Llz4_match_bytes_loop
+    addiu  $a2, 1
+
+.Llz4_match_done:
+    sltu   $t2, $a0, $a1
+    bnez   $t2, .Llz4_sequence
+    nop
+
+.Llz4_end:
+    jr     $ra
+    nop
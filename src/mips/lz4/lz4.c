@@ -24,84 +24,75 @@ SOFTWARE.
 
 */
 
+#include "lz4/lz4.h"
+
 #include <stddef.h>
 #include <stdint.h>
 
 // See https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
-// We are not taking too much care about the fault tolerance of the
-// decompression code. While the LZ4 format is not very complex, it
-// has a few failure modes that we are not handling. This means that
-// if the data is corrupted, this will likely result in a crash or an
-// infinite loop.
-void lz4_decompress_block(const void* source_, const void* sourceEnd_, void* dest_) {
-    uint8_t* source = (uint8_t*)source_;
-    uint8_t* sourceEnd = (uint8_t*)sourceEnd_;
-    uint8_t* dest = (uint8_t*)dest_;
-    uint8_t token;
-    int state = 0;
+// The block decompressor, lz4_decompress_block, lives in lz4-d.s, as
+// hand scheduled assembly.
+
+void lz4_stream_init(struct lz4_stream* stream, const void* source, void* dest) {
+    stream->source = (const uint8_t*)source;
+    stream->dest = (uint8_t*)dest;
+    stream->token = 0;
+    stream->state = 0;
+}
+
+// This is the same state machine as the block decompressor, alternating
+// between literal runs and back references, except that each literal run
+// or back reference is only consumed once all of its bytes are available,
+// so that the decompression can be suspended and resumed in between.
+int lz4_decompress_stream(struct lz4_stream* stream, const void* available_, const void* sourceEnd_) {
+    const uint8_t* source = stream->source;
+    const uint8_t* available = (const uint8_t*)available_;
+    const uint8_t* sourceEnd = (const uint8_t*)sourceEnd_;
+    uint8_t* dest = stream->dest;
+    uint8_t token = stream->token;
+    int state = stream->state;
+    if (available > sourceEnd) available = sourceEnd;
 
-    do {
+    while (source < sourceEnd) {
+        const uint8_t* ptr = source;
+        uint8_t nextToken = token;
         size_t len;
-        size_t offset;
-        // Decompression flips flops between copying literal bytes and
-        // copying back references. The first byte of the block is a
-        // token that indicates the length of the literal bytes and
-        // the length of the back reference. We always start with
-        // copying literal bytes, which is indicated by state == 0.
+        size_t offset = 0;
         if (state == 0) {
-            // The top 4 bits of the token indicate the length of the
-            // literal bytes.
-            token = *source++;
-            len = token >> 4;
+            if (ptr >= available) break;
+            nextToken = *ptr++;
+            len = nextToken >> 4;
         } else {
-            // In the second state, the lower 4 bits of the token
-            // indicate the length of the back reference. The offset
-            // is a 16-bit value that is stored in the next two bytes
-            // of the stream.
-            offset = source[0] | (source[1] << 8);
-            source += 2;
+            if ((ptr + 2) > available) break;
+            offset = ptr[0] | (ptr[1] << 8);
+            ptr += 2;
             len = token & 0x0f;
         }
-        // The length is always stored using a variable-length encoding,
-        // which is what comes next. If the length is 15, we need to
-        // read more bytes until we get a value that is not 255.
         if (len == 0x0f) {
-            uint8_t b;
-            do {
-                b = *source++;
+            uint8_t b = 255;
+            while ((ptr < available) && (b == 255)) {
+                b = *ptr++;
                 len += b;
-            } while (b == 255);
+            }
+            if (b == 255) break;
         }
-        uint8_t* ptr;
         if (state == 0) {
-            // When copying literal bytes, just copy the bytes
-            // directly from the source to the destination.
-            ptr = source;
+            if ((ptr + len) > available) break;
+            uint8_t* end = dest + len;
+            while (dest != end) *dest++ = *ptr++;
+            token = nextToken;
         } else {
-            // When copying back references, we need to copy the
-            // bytes from the destination buffer. Also, the minimum
-            // length of the back reference is 4 bytes, so we need
-            // to bump the length by 4.
-            ptr = dest - offset;
-            len += 4;
+            const uint8_t* ref = dest - offset;
+            uint8_t* end = dest + len + 4;
+            while (dest != end) *dest++ = *ref++;
         }
-        // Do the actual copying of the bytes. It doesn't matter
-        // whether we are copying literal bytes or back references,
-        // the code is the same.
-        uint8_t* ptrEnd = ptr + len;
-        while (ptr != ptrEnd) {
-            *dest++ = *ptr++;
-        }
-        if (state == 0) {
-            // When copying literal bytes, we need to update the
-            // source pointer to point to the next byte after the
-            // literal bytes.
-            source = ptr;
-        }
-        // We flip the state before we go to the next iteration.
+        source = ptr;
         state ^= 1;
-        // The lz4 format doesn't have a way to indicate the end of the
-        // stream, so we need to check if we are at the end of the
-        // source buffer.
-    } while (source < sourceEnd);
+    }
+
+    stream->source = source;
+    stream->dest = dest;
+    stream->token = token;
+    stream->state = state;
+    return source >= sourceEnd;
 }
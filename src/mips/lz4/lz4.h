@@ -54,4 +54,53 @@ SOFTWARE.
  * @param dest The pointer to the destination buffer where the
  * decompressed data will be stored.
  */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void lz4_decompress_block(const void* source, const void* sourceEnd, void* dest);
+
+/**
+ * @brief The state of an incremental lz4 block decompression.
+ *
+ * @details This is used by `lz4_decompress_stream` to decompress a block
+ * of lz4 compressed data while it is still being loaded, for instance
+ * from the CD-Rom. The fields are private to the decompressor.
+ */
+struct lz4_stream {
+    const uint8_t* source;
+    uint8_t* dest;
+    uint8_t token;
+    uint8_t state;
+};
+
+/**
+ * @brief Initializes an incremental lz4 block decompression.
+ *
+ * @param stream The stream state to initialize.
+ * @param source The pointer to the start of the compressed data.
+ * @param dest The pointer to the destination buffer.
+ */
+void lz4_stream_init(struct lz4_stream* stream, const void* source, void* dest);
+
+/**
+ * @brief Decompresses as much of a block as the loaded data allows.
+ *
+ * @details This function decompresses the compressed data of the stream
+ * up to the `available` pointer, which marks the end of the data loaded
+ * so far. It stops before any literal run or back reference which isn't
+ * entirely available yet, and will resume from there on the next call.
+ * The same in-place decompression guarantees as `lz4_decompress_block`
+ * apply, since the destination pointer never overtakes the source pointer,
+ * which never goes past `available`.
+ *
+ * @param stream The stream state.
+ * @param available The pointer to the end of the data loaded so far.
+ * @param sourceEnd The pointer to the end of the compressed data.
+ * @return 1 if the whole block has been decompressed, 0 otherwise.
+ */
+int lz4_decompress_stream(struct lz4_stream* stream, const void* available, const void* sourceEnd);
+
+#ifdef __cplusplus
+}
+#endif
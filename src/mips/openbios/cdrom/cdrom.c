@@ -84,8 +84,14 @@ int cdromBlockGetStatus() {
     }
 
     while (cyclesToWait > 0) {
-        if (syscall_testEvent(g_cdEventDNE)) return status;
+        if (syscall_testEvent(g_cdEventDNE)) {
+            // The shell has been opened since the last status read,
+            // so the disc may have been swapped.
+            if (status & 0x10) cdromInvalidatePathTable();
+            return status;
+        }
         if (syscall_testEvent(g_cdEventERR)) {
+            cdromInvalidatePathTable();
             syscall_exception(0x44, 0x20);
             return -1;
         }
@@ -58,13 +58,30 @@ static int s_pathTableLocation;
 static int s_pathTableCount;
 static struct PathTableEntry s_pathTable[45];
 
+// The original bios only keeps the last directory read in memory,
+// and reads the path table again on most operations. We keep the path
+// table until the shell gets opened, and a few directories, so that
+// opening files doesn't incur any extra seek.
+#define DIRECTORY_CACHE_SIZE 4
+
+struct DirectoryCache {
+    int ID, count;
+    uint32_t lastUse;
+    struct DirectoryEntry entries[40];
+};
+
+static int s_pathTableValid;
+static uint32_t s_directoryCacheTick;
+static struct DirectoryCache s_directoryCache[DIRECTORY_CACHE_SIZE];
+
 static int s_cachedDirectoryEntryID;
 static int s_directoryEntryCount;
-static struct DirectoryEntry s_cachedDirectoryEntry[40];
+static struct DirectoryEntry *s_cachedDirectoryEntry;
 
 static int s_foundDirectoryEntry;
 
 int cdromReadPathTable() {
+    s_pathTableValid = 0;
     if (cdromBlockReading(1, 16, g_readBuffer) != 1) return 0;
     if (strncmp(g_readBuffer + 1, "CD001", 5) != 0) return 0;
 
@@ -98,11 +115,20 @@ int cdromReadPathTable() {
         entry++;
         entryID++;
     }
+    for (int i = 0; i < DIRECTORY_CACHE_SIZE; i++) s_directoryCache[i].ID = 0;
     s_cachedDirectoryEntryID = 0;
     s_pathTableCount = entryID - 1;
+    s_pathTableValid = 1;
     return 1;
 }
 
+void cdromInvalidatePathTable() { s_pathTableValid = 0; }
+
+static int cdromCheckPathTable() {
+    if (s_pathTableValid) return 1;
+    return cdromReadPathTable();
+}
+
 static int findDirectoryID(int parentID, const char *name) {
     struct PathTableEntry *entry = s_pathTable;
 
@@ -112,16 +138,36 @@ static int findDirectoryID(int parentID, const char *name) {
     return -1;
 }
 
+static void selectDirectory(struct DirectoryCache *directory) {
+    directory->lastUse = ++s_directoryCacheTick;
+    s_cachedDirectoryEntry = directory->entries;
+    s_directoryEntryCount = directory->count;
+    s_cachedDirectoryEntryID = directory->ID;
+}
+
 static int readDirectory(int entryID) {
     if (s_cachedDirectoryEntryID == entryID) return 1;
+
+    struct DirectoryCache *directory = s_directoryCache;
+    for (int i = 0; i < DIRECTORY_CACHE_SIZE; i++) {
+        if (s_directoryCache[i].ID == entryID) {
+            selectDirectory(s_directoryCache + i);
+            return 1;
+        }
+        if (s_directoryCache[i].lastUse < directory->lastUse) directory = s_directoryCache + i;
+    }
+
+    // Evicting the least recently used directory.
+    if (directory->entries == s_cachedDirectoryEntry) s_cachedDirectoryEntryID = 0;
+    directory->ID = 0;
+    directory->lastUse = 0;
     if (cdromBlockReading(1, s_pathTable[entryID - 1].LBA, g_readBuffer) != 1) return -1;
 
-    struct DirectoryEntry *entry = s_cachedDirectoryEntry;
+    struct DirectoryEntry *entry = directory->entries;
     int count = 0;
     uint8_t *ptr = g_readBuffer;
     while ((ptr < (g_readBuffer + sizeof(g_readBuffer))) &&
-           (entry < s_cachedDirectoryEntry + sizeof(s_cachedDirectoryEntry) / sizeof(s_cachedDirectoryEntry[0])) &&
-           ptr[0]) {
+           (entry < directory->entries + sizeof(directory->entries) / sizeof(directory->entries[0])) && ptr[0]) {
         entry->LBA = load32Unaligned(ptr, 2);
         entry->size = load32Unaligned(ptr, 10);
         uint8_t nameSize = ptr[32];
@@ -132,8 +178,9 @@ static int readDirectory(int entryID) {
         count++;
     }
 
-    s_directoryEntryCount = count;
-    s_cachedDirectoryEntryID = entryID;
+    directory->ID = entryID;
+    directory->count = count;
+    selectDirectory(directory);
 
     return 1;
 }
@@ -268,7 +315,7 @@ int dev_cd_read(struct File *file, void *buffer_, int size) {
     }
 
     size >>= 11;
-    if ((cdromBlockGetStatus() & 0x10) || !cdromReadPathTable() || (s_currentDiscHash != file->deviceId) ||
+    if ((cdromBlockGetStatus() & 0x10) || !cdromCheckPathTable() || (s_currentDiscHash != file->deviceId) ||
         (cdromBlockReading(size, file->LBA + (file->offset >> 11), buffer) != size)) {
         file->errno = PSXEBUSY;
         return -1;
@@ -288,7 +335,7 @@ static int s_cdFirstFileDirectoryEntryID;
 static char s_cdFirstFilePattern[21];
 
 struct DirEntry *dev_cd_firstFile(struct File *file, const char *filename, struct DirEntry *entry) {
-    if (!cdromReadPathTable()) {
+    if (!cdromCheckPathTable()) {
         s_cdFirstFileErrno = PSXEBUSY;
         return NULL;
     }
@@ -347,5 +394,5 @@ int dev_cd_chdir(struct File *file, char *name) {
     char c;
     while ((c = *name++)) *ptr++ = toupper(c);
     *ptr = 0;
-    return cdromReadPathTable();
+    return cdromCheckPathTable();
 }
@@ -34,6 +34,7 @@ SOFTWARE.
 extern char g_cdromCWD[128];
 
 int cdromReadPathTable();
+void cdromInvalidatePathTable();
 int dev_cd_open(struct File* file, const char* filename, int mode);
 int dev_cd_read(struct File* file, void* buffer, int size);
 struct DirEntry* dev_cd_firstFile(struct File* file, const char* filename, struct DirEntry* entry);
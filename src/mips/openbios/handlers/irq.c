@@ -74,49 +74,56 @@ static __attribute__((section(".ramtext"))) int IRQVerifier(void) {
 #else
 static __attribute__((section(".ramtext"))) int IRQVerifier(void) {
     // This version of the IRQ verifier is a bit bigger, but it's
-    // guaranteed to not lose any IRQs.
-    if ((IMASK & IREG & IRQ_CDROM) != 0) {
+    // guaranteed to not lose any IRQs. The hardware registers are
+    // first read once to skip all of the IRQs which aren't pending,
+    // and each pending one is checked again live before delivery, in
+    // case an event handler acknowledged it. An IRQ raised after the
+    // first read keeps the exception pending, and will be caught on
+    // the next pass.
+    uint32_t pending = IMASK & IREG;
+    if (pending == 0) return 0;
+    if ((pending & IRQ_CDROM) && ((IMASK & IREG & IRQ_CDROM) != 0)) {
         deliverEvent(EVENT_CDROM, 0x1000);
         if (s_IRQsAutoAck[IRQ_CDROM_NUMBER]) IREG &= ~IRQ_CDROM;
     }
-    if ((IMASK & IREG & IRQ_SPU) != 0) {
+    if ((pending & IRQ_SPU) && ((IMASK & IREG & IRQ_SPU) != 0)) {
         deliverEvent(EVENT_SPU, 0x1000);
         if (s_IRQsAutoAck[IRQ_SPU_NUMBER]) IREG &= ~IRQ_SPU;
     }
-    if ((IMASK & IREG & IRQ_GPU) != 0) {
+    if ((pending & IRQ_GPU) && ((IMASK & IREG & IRQ_GPU) != 0)) {
         deliverEvent(EVENT_GPU, 0x1000);
         if (s_IRQsAutoAck[IRQ_GPU_NUMBER]) IREG &= ~IRQ_GPU;
     }
-    if ((IMASK & IREG & IRQ_PIO) != 0) {
+    if ((pending & IRQ_PIO) && ((IMASK & IREG & IRQ_PIO) != 0)) {
         deliverEvent(EVENT_PIO, 0x1000);
         if (s_IRQsAutoAck[IRQ_PIO_NUMBER]) IREG &= ~IRQ_PIO;
     }
-    if ((IMASK & IREG & IRQ_SIO) != 0) {
+    if ((pending & IRQ_SIO) && ((IMASK & IREG & IRQ_SIO) != 0)) {
         deliverEvent(EVENT_SIO, 0x1000);
         if (s_IRQsAutoAck[IRQ_SIO_NUMBER]) IREG &= ~IRQ_SIO;
     }
-    if ((IMASK & IREG & IRQ_VBLANK) != 0) {
+    if ((pending & IRQ_VBLANK) && ((IMASK & IREG & IRQ_VBLANK) != 0)) {
         deliverEvent(EVENT_VBLANK, 0x1000);
         if (s_IRQsAutoAck[IRQ_VBLANK_NUMBER]) IREG &= ~IRQ_VBLANK;
     }
-    if ((IMASK & IREG & IRQ_TIMER0) != 0) {
+    if ((pending & IRQ_TIMER0) && ((IMASK & IREG & IRQ_TIMER0) != 0)) {
         deliverEvent(EVENT_RTC0, 0x1000);
         if (s_IRQsAutoAck[IRQ_TIMER0_NUMBER]) IREG &= ~IRQ_TIMER0;
     }
-    if ((IMASK & IREG & IRQ_TIMER1) != 0) {
+    if ((pending & IRQ_TIMER1) && ((IMASK & IREG & IRQ_TIMER1) != 0)) {
         deliverEvent(EVENT_RTC1, 0x1000);
         if (s_IRQsAutoAck[IRQ_TIMER1_NUMBER]) IREG &= ~IRQ_TIMER1;
     }
-    if ((IMASK & IREG & IRQ_TIMER2) != 0) {
+    if ((pending & IRQ_TIMER2) && ((IMASK & IREG & IRQ_TIMER2) != 0)) {
         // Keeping this copy/paste mistake this way to avoid breaking stuff.
         deliverEvent(EVENT_RTC1, 0x1000);
         if (s_IRQsAutoAck[IRQ_TIMER2_NUMBER]) IREG &= ~IRQ_TIMER2;
     }
-    if ((IMASK & IREG & IRQ_CONTROLLER) != 0) {
+    if ((pending & IRQ_CONTROLLER) && ((IMASK & IREG & IRQ_CONTROLLER) != 0)) {
         deliverEvent(EVENT_CONTROLLER, 0x1000);
         if (s_IRQsAutoAck[IRQ_CONTROLLER_NUMBER]) IREG &= ~IRQ_CONTROLLER;
     }
-    if ((IMASK & IREG & IRQ_DMA) != 0) {
+    if ((pending & IRQ_DMA) && ((IMASK & IREG & IRQ_DMA) != 0)) {
         deliverEvent(EVENT_DMA, 0x1000);
         if (s_IRQsAutoAck[IRQ_DMA_NUMBER]) IREG &= ~IRQ_DMA;
     }
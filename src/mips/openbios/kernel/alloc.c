@@ -44,163 +44,155 @@ located in the ROM, while the kernel versions are located in RAM.
 Our version here will be completely located in RAM, and has a single
 implementation, with a parameter to switch between kernel and user heaps.
 
-*/
+The allocator is a segregated fit one. Every block, free or allocated,
+starts with a header holding its size, and the size of the previous block
+when that one is free. Two flags in the lower bits of the size tell if the
+block itself and the previous one are in use. This means that freeing a
+block can merge it with both of its neighbours without walking anything.
+Free blocks are kept in doubly linked lists, one per size class. Small
+sizes get one exact class every 8 bytes, and larger sizes get one class
+per power of two. The end of the heap is marked by an in-use block of
+size 0, which stops the merging.
+
+Allocating from a small class is a simple pop from its list. Otherwise,
+the head of the matching class is tried first, then any block from a
+larger class, which is guaranteed to fit, and only as a last resort the
+rest of the matching class is searched.
 
-// See alloc.c in the psyqo project for more details on this allocator.
+*/
 
 #define ALIGN_MASK ((2 * sizeof(void *)) - 1)
 #define ALIGN_TO(x) (((uintptr_t)(x) + ALIGN_MASK) & ~ALIGN_MASK)
 
-typedef struct empty_block_ {
-    struct empty_block_ *next;
-    size_t size;
-} empty_block;
-
-typedef struct allocated_block_ {
-    uintptr_t dummy;
-    size_t size;
-} allocated_block;
-
-_Static_assert(sizeof(empty_block) == (2 * sizeof(void *)), "empty_block is of the wrong size");
-_Static_assert(sizeof(allocated_block) == (2 * sizeof(void *)), "allocated_block is of the wrong size");
-
-static empty_block *user_heap_head = NULL;
-static empty_block *kern_heap_head = NULL;
-
-static empty_block marker = {.next = NULL, .size = 0};
-
-enum heap { HEAP_USER, HEAP_KERNEL };
-
-static __attribute__((section(".ramtext"))) void *multi_malloc(size_t size_, const enum heap heap) {
-    empty_block *curr = heap == HEAP_USER ? user_heap_head : kern_heap_head;
-    empty_block *prev = NULL;
-    empty_block *best_fit = NULL;
-    empty_block *best_fit_prev = NULL;
-
-    size_t size = ALIGN_TO(size_ + sizeof(allocated_block));
-
-    size_t curr_size = 0;
-    while ((curr_size != size) && (curr != &marker)) {
-        curr_size = curr->size;
-        if (curr_size >= size) {
-            if ((best_fit == NULL) || (curr_size < best_fit->size)) {
-                best_fit = curr;
-                best_fit_prev = prev;
-            }
-        }
-        prev = curr;
-        curr = curr->next;
-    }
-
-    if (best_fit == NULL) {
-        return NULL;
+#define BLOCK_USED 1
+#define BLOCK_PREV_USED 2
+#define BLOCK_FLAGS (BLOCK_USED | BLOCK_PREV_USED)
+
+typedef struct block_ {
+    size_t prev_size;
+    size_t size_and_flags;
+    // These are only valid in free blocks.
+    struct block_ *next;
+    struct block_ *prev;
+} block;
+
+#define HEADER_SIZE (2 * sizeof(size_t))
+#define MIN_BLOCK_SIZE sizeof(block)
+
+_Static_assert(HEADER_SIZE == (ALIGN_MASK + 1), "block header is of the wrong size");
+_Static_assert(sizeof(block) == (2 * HEADER_SIZE), "block is of the wrong size");
+
+// Blocks under 256 bytes get one exact class every 8 bytes,
+// and the rest get one class per power of two.
+#define SMALL_LIMIT 256
+#define SMALL_CLASSES (SMALL_LIMIT / 8)
+#define LARGE_CLASSES 24
+#define NUM_CLASSES (SMALL_CLASSES + LARGE_CLASSES)
+
+struct heap {
+    block *free_lists[NUM_CLASSES];
+};
+
+static struct heap user_heap;
+static struct heap kern_heap;
+
+#define RAMTEXT __attribute__((section(".ramtext")))
+
+static inline RAMTEXT size_t block_size(const block *b) { return b->size_and_flags & ~BLOCK_FLAGS; }
+static inline RAMTEXT block *block_at(const void *b, ptrdiff_t offset) { return (block *)((char *)b + offset); }
+
+static RAMTEXT unsigned size_class(size_t size) {
+    if (size < SMALL_LIMIT) return size >> 3;
+    unsigned c = SMALL_CLASSES;
+    size /= 2 * SMALL_LIMIT;
+    while (size) {
+        c++;
+        size >>= 1;
     }
+    return c;
+}
 
-    size_t best_fit_size = best_fit->size;
-    allocated_block *ptr = (allocated_block *)best_fit;
-
-    if (best_fit_size == size) {
-        if (best_fit_prev == NULL) {
-            if (heap == HEAP_USER) {
-                user_heap_head = best_fit->next;
-            } else {
-                kern_heap_head = best_fit->next;
-            }
-        } else {
-            best_fit_prev->next = best_fit->next;
-        }
+static RAMTEXT void unlink_block(struct heap *heap, block *b) {
+    if (b->prev) {
+        b->prev->next = b->next;
     } else {
-        empty_block *new_block = (empty_block *)((char *)best_fit + size);
-        new_block->next = best_fit->next;
-        new_block->size = best_fit_size - size;
-        if (best_fit_prev == NULL) {
-            if (heap == HEAP_USER) {
-                user_heap_head = new_block;
-            } else {
-                kern_heap_head = new_block;
-            }
-        } else {
-            best_fit_prev->next = new_block;
-        }
+        heap->free_lists[size_class(block_size(b))] = b->next;
     }
+    if (b->next) b->next->prev = b->prev;
+}
 
-    ptr->size = size;
-    ptr++;
-    return ptr;
+// Turns the range starting at b into a free block of the specified size,
+// and inserts it in its list. The block before it has to be in use.
+static RAMTEXT void make_free(struct heap *heap, block *b, size_t size) {
+    b->size_and_flags = size | BLOCK_PREV_USED;
+    block **head = &heap->free_lists[size_class(size)];
+    b->prev = NULL;
+    b->next = *head;
+    if (*head) (*head)->prev = b;
+    *head = b;
+    block *next = block_at(b, size);
+    next->prev_size = size;
+    next->size_and_flags &= ~BLOCK_PREV_USED;
 }
 
-static __attribute__((section(".ramtext"))) void multi_free(void *ptr_, const enum heap heap) {
-    if (ptr_ == NULL) {
-        return;
+// Marks b as used with the specified size, giving back what's left
+// at its end, if it's large enough to hold a block.
+static RAMTEXT void take_block(struct heap *heap, block *b, size_t total, size_t size) {
+    size_t flags = b->size_and_flags & BLOCK_PREV_USED;
+    if ((total - size) >= MIN_BLOCK_SIZE) {
+        b->size_and_flags = size | flags | BLOCK_USED;
+        make_free(heap, block_at(b, size), total - size);
+    } else {
+        b->size_and_flags = total | flags | BLOCK_USED;
+        block_at(b, total)->size_and_flags |= BLOCK_PREV_USED;
     }
+}
 
-    empty_block *block = (empty_block *)ptr_;
-    block--;
-    size_t size = block->size;
-    empty_block *const head = heap == HEAP_USER ? user_heap_head : kern_heap_head;
+static RAMTEXT size_t request_size(size_t size_) {
+    if (size_ > (SIZE_MAX / 2)) return 0;
+    size_t size = ALIGN_TO(size_ + HEADER_SIZE);
+    return size < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : size;
+}
 
-    if (head == &marker) {
-        if (heap == HEAP_USER) {
-            user_heap_head = block;
-        } else {
-            kern_heap_head = block;
-        }
-        block->next = &marker;
-        return;
-    }
+static RAMTEXT void *multi_malloc(size_t size_, struct heap *heap) {
+    size_t size = request_size(size_);
+    if (size == 0) return NULL;
 
-    if (head == NULL) {
-        return;
+    unsigned c = size_class(size);
+    block *b = heap->free_lists[c];
+    if (b && (block_size(b) < size)) b = NULL;
+    for (unsigned i = c + 1; !b && (i < NUM_CLASSES); i++) b = heap->free_lists[i];
+    if (!b && (c >= SMALL_CLASSES)) {
+        for (b = heap->free_lists[c]; b && (block_size(b) < size); b = b->next);
     }
+    if (!b) return NULL;
 
-    if (head > block) {
-        if (((char *)block + size) == (char *)head) {
-            block->size = head->size + size;
-            block->next = head->next;
-        } else {
-            block->next = head;
-        }
-        if (heap == HEAP_USER) {
-            user_heap_head = block;
-        } else {
-            kern_heap_head = block;
-        }
-        return;
-    }
+    unlink_block(heap, b);
+    take_block(heap, b, block_size(b), size);
+    return block_at(b, HEADER_SIZE);
+}
 
-    empty_block *curr = head;
-    empty_block *next = NULL;
-    while ((next = curr->next) != &marker) {
-        if (next <= block) {
-            curr = next;
-            continue;
-        }
-        if (((char *)curr + curr->size) == (char *)block) {
-            curr->size += size;
-            if (((char *)curr + curr->size) == (char *)next) {
-                curr->size += next->size;
-                curr->next = next->next;
-            }
-        } else if (((char *)block + size) == (char *)next) {
-            block->next = next->next;
-            block->size = size + next->size;
-            curr->next = block;
-        } else {
-            block->next = next;
-            curr->next = block;
-        }
-        return;
-    }
+static RAMTEXT void multi_free(void *ptr_, struct heap *heap) {
+    if (ptr_ == NULL) return;
 
-    if (((char *)curr + curr->size) == (char *)block) {
-        curr->size += size;
-    } else {
-        block->next = &marker;
-        curr->next = block;
+    block *b = block_at(ptr_, -(ptrdiff_t)HEADER_SIZE);
+    size_t size = block_size(b);
+
+    block *next = block_at(b, size);
+    if (!(next->size_and_flags & BLOCK_USED)) {
+        unlink_block(heap, next);
+        size += block_size(next);
+    }
+    if (!(b->size_and_flags & BLOCK_PREV_USED)) {
+        block *prev = block_at(b, -(ptrdiff_t)b->prev_size);
+        unlink_block(heap, prev);
+        size += block_size(prev);
+        b = prev;
     }
+    make_free(heap, b, size);
 }
 
-static __attribute__((section(".ramtext"))) void *multi_realloc(void *ptr_, size_t size_, const enum heap heap) {
+static RAMTEXT void *multi_realloc(void *ptr_, size_t size_, struct heap *heap) {
     if (ptr_ == NULL) {
         return multi_malloc(size_, heap);
     }
@@ -210,113 +202,25 @@ static __attribute__((section(".ramtext"))) void *multi_realloc(void *ptr_, size
         return NULL;
     }
 
-    size_t size = ALIGN_TO(size_ + sizeof(empty_block));
-    empty_block *block = (empty_block *)ptr_;
-    size_t old_size = (--block)->size;
-
-    if (size == old_size) {
-        return ptr_;
-    }
-
-    empty_block *const head = heap == HEAP_USER ? user_heap_head : kern_heap_head;
-    if (head == &marker) {
-        if (size < old_size) {
-            empty_block *new_block = (empty_block *)((char *)block + size);
-            new_block->next = &marker;
-            new_block->size = old_size - size;
-            if (heap == HEAP_USER) {
-                user_heap_head = new_block;
-            } else {
-                kern_heap_head = new_block;
-            }
-            block->size = size;
-            return ptr_;
-        }
-        return NULL;
-    }
-
-    if (block < head) {
-        if (size < old_size) {
-            empty_block *new_block = (empty_block *)((char *)block + size);
-            if (head == (empty_block *)((char *)block + size)) {
-                new_block->next = head->next;
-                new_block->size = head->size + (old_size - size);
-            } else {
-                new_block->next = head;
-                new_block->size = old_size - size;
-            }
-            if (heap == HEAP_USER) {
-                user_heap_head = new_block;
-            } else {
-                kern_heap_head = new_block;
-            }
-            block->size = size;
-            return ptr_;
-        }
-        if (((char *)block + old_size) == (char *)head) {
-            size_t delta = size - old_size;
-            if (head->size >= delta) {
-                // If it has exactly the right amount of space, we can just remove
-                // the first block from the list.
-                if (head->size == delta) {
-                    if (heap == HEAP_USER) {
-                        user_heap_head = head->next;
-                    } else {
-                        kern_heap_head = head->next;
-                    }
-                } else {
-                    // Otherwise, we need to create a new empty block after what we are re-allocating.
-                    empty_block *new_block = (empty_block *)((char *)block + size);
-                    new_block->next = head->next;
-                    new_block->size = head->size - delta;
-                    if (heap == HEAP_USER) {
-                        user_heap_head = new_block;
-                    } else {
-                        kern_heap_head = new_block;
-                    }
-                }
-                block->size = size;
-                return ptr_;
-            }
-        }
-    } else {
-        empty_block *curr = head;
-        empty_block *next = NULL;
-        while ((next = curr->next) != NULL) {
-            if ((next <= block) && (next != &marker)) {
-                curr = next;
-            } else {
-                break;
-            }
-        }
-
-        if (size < old_size) {
-            empty_block *new_block = (empty_block *)((char *)block + size);
-            if ((next != &marker) && (((char *)block + size) == (char *)next)) {
-                new_block->next = next->next;
-                new_block->size = old_size - size + next->size;
-            } else {
-                new_block->next = next;
-                new_block->size = old_size - size;
-            }
-            curr->next = new_block;
-            block->size = size;
-            return ptr_;
-        }
-
-        size_t delta = size - old_size;
-        if ((next != &marker) && (((char *)block + old_size) == (char *)next) && (next->size >= delta)) {
-            if (next->size == delta) {
-                curr->next = next->next;
-            } else {
-                empty_block *new_block = (empty_block *)((char *)block + size);
-                new_block->next = next->next;
-                new_block->size = next->size - delta;
-                curr->next = new_block;
-            }
-            block->size = size;
-            return ptr_;
+    size_t size = request_size(size_);
+    if (size == 0) return NULL;
+    block *b = block_at(ptr_, -(ptrdiff_t)HEADER_SIZE);
+    size_t old_size = block_size(b);
+
+    // Shrinking, or growing into the next block if it's free and large enough.
+    size_t available = old_size;
+    block *next = block_at(b, old_size);
+    if ((size > old_size) && !(next->size_and_flags & BLOCK_USED)) available += block_size(next);
+    if (size <= available) {
+        if (available != old_size) {
+            unlink_block(heap, next);
+        } else if (((old_size - size) >= MIN_BLOCK_SIZE) && !(next->size_and_flags & BLOCK_USED)) {
+            // Merging the released tail with the free block after it.
+            unlink_block(heap, next);
+            available += block_size(next);
         }
+        take_block(heap, b, available, size);
+        return ptr_;
     }
 
     void *new_ptr = multi_malloc(size_, heap);
@@ -325,7 +229,7 @@ static __attribute__((section(".ramtext"))) void *multi_realloc(void *ptr_, size
     }
     uint32_t *src = (uint32_t *)ptr_;
     uint32_t *dst = (uint32_t *)new_ptr;
-    uint32_t size_to_copy = old_size - sizeof(empty_block);
+    uint32_t size_to_copy = old_size - HEADER_SIZE;
     while (size_to_copy > 0) {
         *dst++ = *src++;
         size_to_copy -= sizeof(uint32_t);
@@ -334,24 +238,29 @@ static __attribute__((section(".ramtext"))) void *multi_realloc(void *ptr_, size
     return new_ptr;
 }
 
-__attribute__((section(".ramtext"))) void *user_malloc(size_t size) { return multi_malloc(size, HEAP_USER); }
-__attribute__((section(".ramtext"))) void user_free(void *ptr) { multi_free(ptr, HEAP_USER); }
-__attribute__((section(".ramtext"))) void *user_realloc(void *ptr, size_t size) {
-    return multi_realloc(ptr, size, HEAP_USER);
-}
-__attribute__((section(".ramtext"))) void user_initheap(void *base, size_t size) {
-    user_heap_head = (empty_block *)ALIGN_TO(base);
-    user_heap_head->next = &marker;
-    user_heap_head->size = ALIGN_TO(size - sizeof(empty_block));
+// Like the retail code, this forgets about everything allocated
+// previously, and makes the whole range available again.
+static RAMTEXT void multi_initheap(void *base, size_t size, struct heap *heap) {
+    for (unsigned i = 0; i < NUM_CLASSES; i++) heap->free_lists[i] = NULL;
+
+    uintptr_t start = ALIGN_TO(base);
+    uintptr_t end = ((uintptr_t)base + size) & ~ALIGN_MASK;
+    if ((end < start) || ((end - start) < (MIN_BLOCK_SIZE + HEADER_SIZE))) return;
+
+    size_t first_size = end - start - HEADER_SIZE;
+    block *sentinel = (block *)(end - HEADER_SIZE);
+    sentinel->size_and_flags = BLOCK_USED;
+    block *b = (block *)start;
+    b->prev_size = 0;
+    make_free(heap, b, first_size);
 }
 
-__attribute__((section(".ramtext"))) void *kern_malloc(size_t size) { return multi_malloc(size, HEAP_KERNEL); }
-__attribute__((section(".ramtext"))) void kern_free(void *ptr) { multi_free(ptr, HEAP_KERNEL); }
-__attribute__((section(".ramtext"))) void *kern_realloc(void *ptr, size_t size) {
-    return multi_realloc(ptr, size, HEAP_KERNEL);
-}
-__attribute__((section(".ramtext"))) void kern_initheap(void *base, size_t size) {
-    kern_heap_head = (empty_block *)ALIGN_TO(base);
-    kern_heap_head->next = &marker;
-    kern_heap_head->size = ALIGN_TO(size - sizeof(empty_block));
-}
+RAMTEXT void *user_malloc(size_t size) { return multi_malloc(size, &user_heap); }
+RAMTEXT void user_free(void *ptr) { multi_free(ptr, &user_heap); }
+RAMTEXT void *user_realloc(void *ptr, size_t size) { return multi_realloc(ptr, size, &user_heap); }
+RAMTEXT void user_initheap(void *base, size_t size) { multi_initheap(base, size, &user_heap); }
+
+RAMTEXT void *kern_malloc(size_t size) { return multi_malloc(size, &kern_heap); }
+RAMTEXT void kern_free(void *ptr) { multi_free(ptr, &kern_heap); }
+RAMTEXT void *kern_realloc(void *ptr, size_t size) { return multi_realloc(ptr, size, &kern_heap); }
+RAMTEXT void kern_initheap(void *base, size_t size) { multi_initheap(base, size, &kern_heap); }
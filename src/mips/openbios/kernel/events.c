@@ -39,13 +39,51 @@ struct EventInfo {
     uint32_t unknown1, unknown2;
 };
 
+// Delivering an event used to scan the whole EvCB array. We instead keep
+// the opened events chained by buckets of class and spec, in slot order,
+// so that delivery only looks at the entries which may match. The chains
+// live right after the EvCB array, in the same allocation, but aren't part
+// of the observable eventsSize, which some games use to walk the array.
+#define EVENT_BUCKETS 16
+#define EVENT_NONE 0xffff
+
+static uint16_t s_eventBuckets[EVENT_BUCKETS];
+static uint16_t *s_eventNext;
+
+static inline __attribute__((section(".ramtext"))) unsigned eventBucket(uint32_t class, uint32_t spec) {
+    uint32_t h = class ^ (class >> 16) ^ spec ^ (spec >> 8);
+    return (h ^ (h >> 4)) & (EVENT_BUCKETS - 1);
+}
+
+static void unlinkEvent(unsigned slot) {
+    struct EventInfo *event = __globals.events + slot;
+    uint16_t *link = s_eventBuckets + eventBucket(event->class, event->spec);
+    while (*link != EVENT_NONE) {
+        if (*link == slot) {
+            *link = s_eventNext[slot];
+            return;
+        }
+        link = s_eventNext + *link;
+    }
+}
+
+static void linkEvent(unsigned slot) {
+    struct EventInfo *event = __globals.events + slot;
+    uint16_t *link = s_eventBuckets + eventBucket(event->class, event->spec);
+    while ((*link != EVENT_NONE) && (*link < slot)) link = s_eventNext + *link;
+    s_eventNext[slot] = *link;
+    *link = slot;
+}
+
 int initEvents(int count) {
     psxprintf("\nConfiguration : EvCB\t0x%02x\t\t", count);
     int size = count * sizeof(struct EventInfo);
-    struct EventInfo *array = syscall_kmalloc(size);
+    struct EventInfo *array = syscall_kmalloc(size + count * sizeof(uint16_t));
     if (!array) return 0;
     __globals.eventsSize = size;
     __globals.events = array;
+    s_eventNext = (uint16_t *)(array + count);
+    for (unsigned i = 0; i < EVENT_BUCKETS; i++) s_eventBuckets[i] = EVENT_NONE;
     struct EventInfo *ptr = array;
     while (ptr < (array + count)) ptr++->flags = 0;
     return size;
@@ -71,20 +109,23 @@ uint32_t openEvent(uint32_t class, uint32_t spec, uint32_t mode, void (*handler)
     if (slot == -1) return -1;
 
     struct EventInfo *event = __globals.events + slot;
+    // In case the slot was freed by writing to the EvCB directly.
+    unlinkEvent(slot);
     event->class = class;
     event->spec = spec;
     event->mode = mode;
     event->flags = EVENT_FLAG_DISABLED;
     event->handler = handler;
+    linkEvent(slot);
     return slot | 0xf1000000;
 }
 
 __attribute__((section(".ramtext"))) void deliverEvent(uint32_t class, uint32_t spec) {
-    struct EventInfo *ptr, *end;
+    struct EventInfo *events = __globals.events;
+    unsigned slot = s_eventBuckets[eventBucket(class, spec)];
 
-    ptr = __globals.events;
-    end = (struct EventInfo *)(((char *)ptr) + __globals.eventsSize);
-    while (ptr < end) {
+    while (slot != EVENT_NONE) {
+        struct EventInfo *ptr = events + slot;
         if ((ptr->flags == EVENT_FLAG_ENABLED) && (class == ptr->class) && (spec == ptr->spec)) {
             if (ptr->mode == EVENT_MODE_NO_CALLBACK) {
                 ptr->flags = EVENT_FLAG_PENDING;
@@ -92,7 +133,7 @@ __attribute__((section(".ramtext"))) void deliverEvent(uint32_t class, uint32_t
                 ptr->handler();
             }
         }
-        ptr++;
+        slot = s_eventNext[slot];
     }
 }
 
@@ -110,21 +151,22 @@ int disableEvent(uint32_t event) {
 
 int closeEvent(uint32_t event) {
     struct EventInfo *ptr = __globals.events + (event & 0xffff);
+    if (ptr->flags != EVENT_FLAG_FREE) unlinkEvent(event & 0xffff);
     ptr->flags = EVENT_FLAG_FREE;
     return 1;
 }
 
 __attribute__((section(".ramtext"))) void undeliverEvent(uint32_t class, uint32_t spec) {
-    struct EventInfo *ptr, *end;
+    struct EventInfo *events = __globals.events;
+    unsigned slot = s_eventBuckets[eventBucket(class, spec)];
 
-    ptr = __globals.events;
-    end = (struct EventInfo *)(((char *)ptr) + __globals.eventsSize);
-    while (ptr < end) {
+    while (slot != EVENT_NONE) {
+        struct EventInfo *ptr = events + slot;
         if ((ptr->flags == EVENT_FLAG_PENDING) && (class == ptr->class) && (spec == ptr->spec) &&
             (ptr->mode == EVENT_MODE_NO_CALLBACK)) {
             ptr->flags = EVENT_FLAG_ENABLED;
         }
-        ptr++;
+        slot = s_eventNext[slot];
     }
 }
 
@@ -40,7 +40,23 @@ namespace psyqo {
 struct Lua {
     using lua_CPPFunction = int (*)(Lua);
 
-    Lua();
+    // Where the VM gets its memory from. With Pools, the small objects
+    // Lua constantly creates and collects are carved out of size-class
+    // pools instead, which don't fragment the heap, and don't need a
+    // header per object. The pools are shared by all of the VMs using
+    // them, and never give their memory back to the heap.
+    enum class Allocator { Heap, Pools };
+
+    struct PoolStats {
+        // The memory taken from the heap for the pools, in bytes.
+        size_t reserved;
+        // How much of it is currently holding objects, in bytes.
+        size_t used;
+        unsigned objects;
+    };
+
+    Lua() : Lua(Allocator::Heap) {}
+    explicit Lua(Allocator allocator);
     Lua(lua_State* L) : L(L) {}
     Lua(Lua&& oL) noexcept : L(oL.L) { oL.L = nullptr; }
     Lua(const Lua& oL) : L(oL.L) {}
@@ -52,6 +68,10 @@ struct Lua {
     // Get the lua state, for use in C functions when a wrapper method isn't available
     lua_State* getState() { return L; }
 
+    // The lua_Alloc function behind Allocator::Pools, and its statistics.
+    static void* poolAllocator(void* ud, void* ptr, size_t osize, size_t nsize);
+    static PoolStats getPoolStats();
+
     // Stack Manipulation
     int getTop() { return lua_gettop(L); }
     void setTop(int idx) { lua_settop(L, idx); }
@@ -0,0 +1,153 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdint.h>
+
+#include "psyqo-lua/lua.hh"
+#include "psyqo/alloc.h"
+
+// Lua always tells its allocator the size of the block it's freeing or
+// resizing, which means the pools don't need to store anything in the
+// objects themselves: the size alone tells which pool a pointer comes
+// from. Each size class has a free list of the slots given back, and
+// a chunk it carves new slots out of, which gets replaced by a fresh
+// one from the heap once exhausted.
+
+namespace {
+
+constexpr size_t c_granularity = 8;
+constexpr unsigned c_classCount = 8;
+// Anything larger than this goes to the heap.
+constexpr size_t c_poolLimit = c_granularity * c_classCount;
+constexpr size_t c_chunkSize = 2048;
+
+struct FreeSlot {
+    FreeSlot* next;
+};
+
+struct SizeClass {
+    FreeSlot* freeList = nullptr;
+    uint8_t* chunk = nullptr;
+    uint8_t* chunkEnd = nullptr;
+};
+
+SizeClass s_classes[c_classCount];
+psyqo::Lua::PoolStats s_stats;
+
+unsigned classOf(size_t size) { return (size - 1) / c_granularity; }
+size_t slotSize(unsigned c) { return (c + 1) * c_granularity; }
+
+void setChunk(SizeClass& sizeClass, size_t slot, uint8_t* chunk, size_t size) {
+    sizeClass.chunk = chunk;
+    sizeClass.chunkEnd = chunk + size - size % slot;
+    s_stats.reserved += size;
+}
+
+void* poolAlloc(size_t size) {
+    unsigned c = classOf(size);
+    SizeClass& sizeClass = s_classes[c];
+    size_t slot = slotSize(c);
+    void* ptr;
+    if (sizeClass.freeList) {
+        ptr = sizeClass.freeList;
+        sizeClass.freeList = sizeClass.freeList->next;
+    } else {
+        if (sizeClass.chunk == sizeClass.chunkEnd) {
+            uint8_t* chunk = reinterpret_cast<uint8_t*>(psyqo_malloc(c_chunkSize));
+            if (!chunk) return nullptr;
+            setChunk(sizeClass, slot, chunk, c_chunkSize);
+        }
+        ptr = sizeClass.chunk;
+        sizeClass.chunk += slot;
+    }
+    s_stats.used += slot;
+    s_stats.objects++;
+    return ptr;
+}
+
+void poolFree(void* ptr, size_t size) {
+    unsigned c = classOf(size);
+    FreeSlot* slot = reinterpret_cast<FreeSlot*>(ptr);
+    slot->next = s_classes[c].freeList;
+    s_classes[c].freeList = slot;
+    s_stats.used -= slotSize(c);
+    s_stats.objects--;
+}
+
+}  // namespace
+
+void* psyqo::Lua::poolAllocator(void* ud, void* ptr, size_t osize, size_t nsize) {
+    // When there's no block yet, osize holds the type of the object instead.
+    if (!ptr) osize = 0;
+    if (nsize == 0) {
+        if (osize > c_poolLimit) {
+            psyqo_free(ptr);
+        } else if (ptr) {
+            poolFree(ptr, osize);
+        }
+        return nullptr;
+    }
+
+    if (osize > c_poolLimit) {
+        if (nsize > c_poolLimit) return psyqo_realloc(ptr, nsize);
+    } else if (ptr && (nsize <= c_poolLimit) && (classOf(osize) == classOf(nsize))) {
+        return ptr;
+    }
+
+    void* newPtr = nsize > c_poolLimit ? psyqo_malloc(nsize) : poolAlloc(nsize);
+    if (!newPtr) {
+        // Lua expects shrinking to never fail. Here it can only be going
+        // to a pool that's out of slots, so the old block becomes the
+        // pool's new chunk, its first slot being the object.
+        if (!ptr || (nsize > osize)) return nullptr;
+        unsigned c = classOf(nsize);
+        size_t slot = slotSize(c);
+        size_t size = osize;
+        if (osize <= c_poolLimit) {
+            // Like freeing the old slot, except its memory stays reserved.
+            size = slotSize(classOf(osize));
+            s_stats.used -= size;
+            s_stats.objects--;
+            s_stats.reserved -= size;
+        }
+        setChunk(s_classes[c], slot, reinterpret_cast<uint8_t*>(ptr), size);
+        s_classes[c].chunk += slot;
+        s_stats.used += slot;
+        s_stats.objects++;
+        return ptr;
+    }
+    if (ptr) {
+        __builtin_memcpy(newPtr, ptr, osize < nsize ? osize : nsize);
+        if (osize > c_poolLimit) {
+            psyqo_free(ptr);
+        } else {
+            poolFree(ptr, osize);
+        }
+    }
+    return newPtr;
+}
+
+psyqo::Lua::PoolStats psyqo::Lua::getPoolStats() { return s_stats; }
@@ -110,7 +110,8 @@ psyqo::FixedPoint<> psyqo::Lua::optFixedPoint(int idx, FixedPoint<> def) {
     return checkFixedPoint(idx);
 }
 
-psyqo::Lua::Lua() : L(luaL_newstate()) {
+psyqo::Lua::Lua(Allocator allocator)
+    : L(allocator == Allocator::Pools ? lua_newstate(poolAllocator, nullptr) : luaL_newstate()) {
     static_assert(sizeof(Lua) == sizeof(lua_State*));
     Kernel::assert(L, "Couldn't create Lua VM");
     luaL_openlibs(L);
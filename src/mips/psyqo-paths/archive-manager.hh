@@ -35,6 +35,7 @@ SOFTWARE.
 
 #include "common/util/bitfield.hh"
 #include "common/util/djbhash.h"
+#include "lz4/lz4.h"
 #include "psyqo/buffer.hh"
 #include "psyqo/iso9660-parser.hh"
 #include "psyqo/task.hh"
@@ -276,6 +277,22 @@ class ArchiveManager {
      */
     void setBuffer(Buffer<uint8_t> &&buffer) { m_data = eastl::move(buffer); }
 
+    /**
+     * @brief Enable pipelined decompression of LZ4 files.
+     *
+     * @details By default, a compressed file is read entirely before being
+     * decompressed. When a non-zero batch size is set, LZ4 compressed files
+     * will instead be read in batches of that many sectors, and each batch
+     * will be decompressed while the CDRom is busy reading the next one,
+     * which hides most of the decompression time behind the drive transfer.
+     * Smaller batches overlap more, but each batch is a separate read
+     * request for the drive. Files compressed with other methods are not
+     * affected, and the LZ4 decompressor still needs to be registered.
+     *
+     * @param sectors The number of sectors per batch, or 0 to disable.
+     */
+    void setPipelineBatch(unsigned sectors) { m_pipelineBatch = sectors; }
+
     /**
      * @brief Read a file from the archive.
      *
@@ -371,6 +388,9 @@ class ArchiveManager {
     Buffer<IndexEntry> m_index;
     ISO9660Parser::DirEntry m_archiveDirentry;
     CDRom::ReadRequest m_request;
+    lz4_stream m_lz4;
+    unsigned m_pipelineBatch = 0;
+    uint32_t m_pipelineRead = 0;
     bool m_pending = false;
     bool m_success = false;
 
@@ -385,6 +405,7 @@ class ArchiveManager {
     static eastl::array<void (ArchiveManager::*)(const IndexEntry *), toUnderlying(IndexEntry::Method::COUNT)> s_decompressors;
     void decompressUCL_NRV2E(const IndexEntry *entry);
     void decompressLZ4(const IndexEntry *entry);
+    void pipelineStep(const IndexEntry *entry, CDRom &device, TaskQueue::Task *task);
 };
 
 }  // namespace psyqo::paths
@@ -134,10 +134,22 @@ void psyqo::paths::ArchiveManager::setupQueue(const IndexEntry* entry, CDRom& de
         m_data.resize(actualSize);
         m_request.buffer = m_data.data() + actualSize - sectorCount * 2048;
     }
-    m_queue.startWith(device.scheduleReadRequest(&m_request))
-        .then([this, entry](auto task) {
+    const bool pipelined = m_pipelineBatch && (method == IndexEntry::Method::LZ4) &&
+                           s_decompressors[toUnderlying(IndexEntry::Method::LZ4)];
+    if (pipelined) {
+        m_queue.startWith([this, entry, &device](auto task) {
+            lz4_stream_init(&m_lz4, reinterpret_cast<uint8_t*>(m_request.buffer) + entry->getPadding(),
+                            m_data.data());
+            m_pipelineRead = 0;
+            pipelineStep(entry, device, task);
+        });
+    } else {
+        m_queue.startWith(device.scheduleReadRequest(&m_request));
+    }
+    m_queue
+        .then([this, entry, pipelined](auto task) {
             auto decompress = s_decompressors[toUnderlying(entry->getCompressionMethod())];
-            if (decompress) (this->*decompress)(entry);
+            if (decompress && !pipelined) (this->*decompress)(entry);
             uint32_t decompSize = entry->getDecompSize();
             if (decompSize) m_data.resize(decompSize);
             task->resolve();
@@ -162,3 +174,27 @@ void psyqo::paths::ArchiveManager::decompressLZ4(const IndexEntry* entry) {
     uint8_t* src = reinterpret_cast<uint8_t*>(m_request.buffer) + padding;
     lz4_decompress_block(src, src + srcSize, m_data.data());
 }
+
+void psyqo::paths::ArchiveManager::pipelineStep(const IndexEntry* entry, CDRom& device, TaskQueue::Task* task) {
+    const uint32_t sectorCount = entry->getCompressedSize();
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(m_request.buffer);
+    uint8_t* end = buffer + sectorCount * 2048;
+    const uint32_t loaded = m_pipelineRead;
+    if (loaded == sectorCount) {
+        lz4_decompress_stream(&m_lz4, end, end);
+        task->resolve();
+        return;
+    }
+    const uint32_t count = eastl::min<uint32_t>(m_pipelineBatch, sectorCount - loaded);
+    m_pipelineRead += count;
+    device.readSectors(m_request.LBA + loaded, count, buffer + loaded * 2048,
+                       [this, entry, &device, task](bool success) {
+                           if (!success) {
+                               task->reject();
+                               return;
+                           }
+                           pipelineStep(entry, device, task);
+                       });
+    // The drive is now busy with the next batch, so decompress what we have so far.
+    lz4_decompress_stream(&m_lz4, buffer + loaded * 2048, end);
+}
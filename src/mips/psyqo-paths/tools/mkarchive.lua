@@ -39,6 +39,27 @@ property pointing to the file to be included in the archive. The script will
 compress the files using the UCL-NRV2E algorithm and write the resulting archive
 to a specified output file.
 
+Files are stored in the order of the 'files' array, unless a load trace is provided,
+in which case the files are laid out in the order the software first reads them,
+followed by the files which never appear in the trace, in their original order.
+The trace is given using the optional 'trace' property of the JSON root object,
+which can be either:
+- an array of file paths, in access order;
+- the name of a text file, with one file path per line, in access order;
+- the name of a CD-Rom log captured by PCSX-Redux while running the software
+  with a previous build of the archive. The CdlSetloc commands found in the log
+  are mapped back to files using the index of that previous archive, which needs
+  to be given using the 'previous' property, and the LBA at which it was located
+  on the disc, given using the 'previousLBA' property.
+
+Compression is only kept when it actually makes loading faster, that is, when the
+time saved reading fewer sectors is larger than the time spent decompressing. The
+estimate uses the 'readRate' property, in bytes per second, defaulting to the 2x
+speed of the drive, and the 'decompressionRate' property, in decompressed bytes
+per second, defaulting to a conservative measure of the NRV2E decompressor on the
+PSX. Individual files can also force their method using a 'compression' property,
+set to either 'none' or 'ucl'.
+
 Using PCSX-Redux as a CLI tool, one can run the script as follows:
 
 ./PCSX-Redux -cli -dofile mkarchive.lua -exec "mkarchive('index.json', 'output.arc') PCSX.Quit()"
@@ -81,7 +102,7 @@ manager will allow the user to specify a custom hash function, but the default i
 The index order isn't affecting the order of the files in the archive, as the files are stored
 in the order they are added to the archive. It is in fact probably important that the user
 stores the files in the order in which they are supposed to be accessed, to limit seeking
-times into the archive.
+times into the archive, which is what the load trace option is for.
 
 This tool only supports the UCL-NRV2E compression, but the archive manager code in
 psyqo-paths can handle both UCL-NRV2E and LZ4 compression.
@@ -186,6 +207,15 @@ to avoid the binary overhead of having both decompression code in the executable
 choice between the two methods is left to the user, according to their needs.
 
 
+Why not duplicate frequently read files?
+
+Some games store several copies of the same file on the disc, so the drive can
+read whichever is closest. The index holds a single entry per hash, and the
+archive manager resolves a file to that entry, so extra copies would never be
+read. The trace-based ordering gets most of the benefit, as files are laid out
+next to the ones read right before them.
+
+
 Anything else?
 
 The format of the index means that the files stored in the archive do not need
@@ -257,6 +287,79 @@ local json     = P {
     object       = lit '{' * Cf(Ct '' * V 'member_pair' ^ 0, rawset) * lit '}'
 }
 
+local function traceOrder(options, files)
+    local trace = options.trace
+    if not trace then return nil end
+
+    local byPath = {}
+    local byHash = {}
+    for _, v in ipairs(files) do
+        byPath[v.path] = v
+        byHash[tostring(v.hash)] = v
+    end
+
+    local order = {}
+    local seen = {}
+    local function visit(entry)
+        if entry and not seen[entry] then
+            seen[entry] = true
+            order[#order + 1] = entry
+        end
+    end
+
+    if type(trace) == 'table' then
+        for _, path in ipairs(trace) do visit(byPath[path]) end
+        return order
+    end
+
+    local file = Support.File.open(trace)
+    local content = tostring(file:read(file:size()))
+    file:close()
+
+    -- Build a sector map of the previous archive, if any, so we can map
+    -- CdlSetloc commands found in a CD-Rom log back to files.
+    local previous = {}
+    if options.previous then
+        local arc = Support.File.open(options.previous)
+        if tostring(arc:read(8)) ~= 'PSX-ARC1' then
+            error('mkarchive: previous archive has an invalid signature')
+        end
+        local count = arc:readU32()
+        arc:readU32()
+        for _ = 1, count do
+            local hash = arc:readU64()
+            arc:readU32()
+            local high = arc:readU32()
+            previous[#previous + 1] = {
+                hash = tostring(hash),
+                offset = bit.band(high, 0x7ffff),
+                size = bit.band(bit.rshift(high, 19), 0x3ff),
+            }
+        end
+        arc:close()
+    end
+    local previousLBA = options.previousLBA or 0
+
+    for line in content:gmatch('[^\r\n]+') do
+        local m, s, f = line:match('CdlSetloc (%x+):(%x+):(%x+)')
+        if m then
+            -- The MSF values are in BCD, and the log prints them in hexadecimal.
+            local lba = tonumber(m, 10) * 60 * 75 + tonumber(s, 10) * 75 + tonumber(f, 10) - 150
+            local sector = lba - previousLBA
+            for _, v in ipairs(previous) do
+                if sector >= v.offset and sector < v.offset + v.size then
+                    visit(byHash[v.hash])
+                    break
+                end
+            end
+        elseif not line:find('[CDROM]', 1, true) then
+            visit(byPath[line])
+        end
+    end
+
+    return order
+end
+
 function mkarchive(index, out)
     if type(index) == 'string' then
         index = Support.File.open(index)
@@ -270,7 +373,12 @@ function mkarchive(index, out)
     if type(index) ~= 'table' then
         error('mkarchive: invalid index type')
     end
+    local options = index
     index = index.files or {}
+    -- Default to the 2x drive speed, and a conservative estimate of the
+    -- NRV2E decompressor running on the PSX.
+    local readRate = options.readRate or 307200
+    local decompressionRate = options.decompressionRate or 1048576
 
     local needsToClose = false
 
@@ -290,6 +398,16 @@ function mkarchive(index, out)
         index[k].hash = v.hash or Support.extra.djbHash(v.path)
     end
 
+    local order = traceOrder(options, index)
+    if order then
+        local traced = {}
+        for _, v in ipairs(order) do traced[v] = true end
+        for _, v in ipairs(index) do
+            if not traced[v] then order[#order + 1] = v end
+        end
+        index = order
+    end
+
     local zeroBuffer = ffi.new('uint8_t[?]', 2048, 0)
 
     local fileCount = #index
@@ -306,11 +424,23 @@ function mkarchive(index, out)
         index[k].decompressedSize = file:size()
         index[k].offset = out:wTell() / 2048
         local srcData = file:readToSlice(file:size())
-        local compressedData = PCSX.Misc.uclPack(srcData)
-        local compressedSize = #compressedData
-        local compressedSectors = math.ceil((compressedSize + 2047) / 2048)
-        local decompressedSectors = math.ceil((index[k].decompressedSize + 2047) / 2048)
-        if compressedSectors >= decompressedSectors then
+        local compressedData
+        local compressedSize = index[k].decompressedSize
+        if v.compression ~= 'none' then
+            compressedData = PCSX.Misc.uclPack(srcData)
+            compressedSize = #compressedData
+        end
+        local compressedSectors = math.floor((compressedSize + 2047) / 2048)
+        local decompressedSectors = math.floor((index[k].decompressedSize + 2047) / 2048)
+        -- Only keep the compressed data if reading it and decompressing it is
+        -- faster than reading the data as is, unless explicitly requested.
+        local savedTime = (decompressedSectors - compressedSectors) * 2048 / readRate
+        local decompressionTime = index[k].decompressedSize / decompressionRate
+        local compress = compressedSectors < decompressedSectors
+        if v.compression == nil then
+            compress = compress and savedTime > decompressionTime
+        end
+        if not compress then
             compressedSize = index[k].decompressedSize
             local padding = compressedSize % 2048
             out:writeMoveSlice(srcData)
@@ -99,6 +99,39 @@ void *psyqo_heap_start();
  */
 void *psyqo_heap_end();
 
+/**
+ * @brief The heap statistics, as returned by `psyqo_heap_get_stats`.
+ *
+ * @details All of the sizes are in bytes, and account for the
+ * allocator's own headers, so that `used` plus `free` is always
+ * the size of the whole heap.
+ */
+struct psyqo_heap_stats {
+    size_t used;
+    size_t free;
+    // The largest free block. The largest allocation that can currently
+    // succeed is a little smaller than this, by the size of a block
+    // header, and with the TLSF allocator, by up to a 16th of it.
+    size_t largest_free;
+    // The highest value `used` reached since the last time the
+    // peak got reset.
+    size_t peak_used;
+    unsigned allocations;
+};
+
+/**
+ * @brief Retrieves the current heap statistics.
+ *
+ * @details This can be used to budget memory, for instance by looking
+ * at the peak usage over a frame. The heap being lazily initialized,
+ * all of the statistics will be zero until the first allocation.
+ *
+ * @param stats The structure to fill with the statistics.
+ * @param reset_peak If non-zero, the peak usage will be reset to the
+ * current usage after being read.
+ */
+void psyqo_heap_get_stats(struct psyqo_heap_stats *stats, int reset_peak);
+
 #ifdef __cplusplus
 }
 #endif
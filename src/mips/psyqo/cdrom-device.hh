@@ -192,6 +192,22 @@ class CDRomDevice final : public CDRom {
         PlaybackLocation *m_location;
     };
 
+    struct StreamAwaiter {
+        StreamAwaiter(CDRomDevice &device, unsigned count) : m_device(device), m_count(count) {}
+        bool await_ready() const { return m_device.streamAvailable() >= m_count; }
+        template <typename U>
+        void await_suspend(std::coroutine_handle<U> handle) {
+            m_device.waitStream(m_count, [handle](bool) { handle.resume(); });
+        }
+        const uint8_t *await_resume() {
+            return m_device.streamAvailable() >= m_count ? m_device.streamData() : nullptr;
+        }
+
+      private:
+        CDRomDevice &m_device;
+        unsigned m_count;
+    };
+
   private:
     struct ActionBase {
         const char *name() const { return m_name; }
@@ -264,6 +280,73 @@ class CDRomDevice final : public CDRom {
     void readSectors(uint32_t sector, uint32_t count, void *buffer, eastl::function<void(bool)> &&callback) override;
     bool readSectorsBlocking(uint32_t sector, uint32_t count, void *buffer, GPU &);
 
+    /**
+     * @brief Starts streaming sectors from the CDRom into a ring buffer.
+     *
+     * @details This method will start reading sectors continuously from
+     * the given sector onward, at double speed, into a ring buffer of
+     * `ringSectors` sectors of 2048 bytes each. Unlike `readSectors`, the
+     * drive isn't stopped between requests: sectors are delivered as soon
+     * as they arrive, and the application consumes them at its own pace
+     * using `streamAvailable`, `streamData` and `streamRelease`, or the
+     * `waitStream` awaitable. The drive is only paused when the ring is
+     * full, and resumes from the next sector once some space has been
+     * released, which costs a short seek. Sizing the ring to absorb the
+     * longest expected frame hitch avoids this. The callback will be
+     * called once the stream is stopped with `stopStream`, with `true`,
+     * or with `false` if the drive reported an error. Like the other
+     * methods, only one action can be active at a time.
+     *
+     * @param sector The sector to start streaming from.
+     * @param ring The buffer to stream into, of `ringSectors * 2048` bytes.
+     * @param ringSectors The number of sectors in the ring buffer.
+     * @param callback The callback to call when the stream has stopped.
+     */
+    void startStream(uint32_t sector, void *ring, unsigned ringSectors, eastl::function<void(bool)> &&callback);
+
+    /**
+     * @brief Stops the current stream.
+     *
+     * @details The drive will be paused, and the callback given to
+     * `startStream` will be called. Sectors already in the ring remain
+     * readable until the next stream is started.
+     */
+    void stopStream();
+
+    /**
+     * @brief Returns the number of sectors ready to be consumed in the ring.
+     */
+    unsigned streamAvailable() const;
+
+    /**
+     * @brief Returns the oldest sector ready to be consumed.
+     *
+     * @details Consecutive sectors are contiguous in memory until the end
+     * of the ring buffer, at which point they wrap around to its start.
+     */
+    const uint8_t *streamData() const;
+
+    /**
+     * @brief Releases consumed sectors back to the ring.
+     *
+     * @param count The number of sectors to release.
+     */
+    void streamRelease(unsigned count = 1);
+
+    /**
+     * @brief Waits for sectors to be available in the stream.
+     *
+     * @details The callback is called with `true` once at least `count`
+     * sectors are ready, or with `false` if the stream stopped before. The
+     * awaitable variant returns the oldest sector, or a null pointer if
+     * the stream stopped. `count` can't be larger than the ring.
+     *
+     * @param count The number of sectors to wait for.
+     * @param callback The callback to call when the sectors are available.
+     */
+    void waitStream(unsigned count, eastl::function<void(bool)> &&callback);
+    StreamAwaiter waitStream(unsigned count = 1) { return {*this, count}; }
+
     /**
      * @brief Gets the size of the Table of Contents from the CDRom. Note that
      * while the blocking variant is available because it is a fairly short
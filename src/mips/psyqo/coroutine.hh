@@ -38,6 +38,8 @@ SOFTWARE.
 
 namespace psyqo {
 
+class Scheduler;
+
 /**
  * @brief A suitable type to hold and return a C++20 coroutine.
  *
@@ -229,6 +231,8 @@ struct Coroutine {
     bool m_suspended = true;
     bool m_earlyResume = false;
 
+    friend class Scheduler;
+
   public:
     using promise_type = Promise;
 
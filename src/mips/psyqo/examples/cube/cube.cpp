@@ -25,8 +25,10 @@ SOFTWARE.
 */
 
 #include "psyqo/application.hh"
+#include "psyqo/bump-allocator.hh"
 #include "psyqo/fixed-point.hh"
 #include "psyqo/fragments.hh"
+#include "psyqo/frame-resources.hh"
 #include "psyqo/gpu.hh"
 #include "psyqo/gte-kernels.hh"
 #include "psyqo/gte-registers.hh"
@@ -69,15 +71,10 @@ class CubeScene final : public psyqo::Scene {
 
     psyqo::Angle m_rot = 0;
 
-    // We need to create 2 OrderingTable objects since we can't reuse a single one for both
-    // framebuffers, as the previous one may not finish transfering in time.
-    psyqo::OrderingTable<ORDERING_TABLE_SIZE> m_ots[2];
-
-    // Since we're using an ordering table, we need to sort fill commands as well,
-    // otherwise they'll draw over our beautiful cube.
-    psyqo::Fragments::SimpleFragment<psyqo::Prim::FastFill> m_clear[2];
-
-    eastl::array<psyqo::Fragments::SimpleFragment<psyqo::Prim::Quad>, 6> m_quads;
+    // We can't reuse a single ordering table, nor the fragments inserted into it, for both
+    // framebuffers, as the previous frame may not finish transfering in time. FrameResources
+    // keeps one ordering table and one allocator per frame, and rotates them on each flip.
+    psyqo::FrameResources<psyqo::OrderingTable<ORDERING_TABLE_SIZE>, psyqo::BumpAllocator<1024>> m_frames;
 
     static constexpr psyqo::Color c_bg = {.r = 63, .g = 63, .b = 63};
 
@@ -128,12 +125,13 @@ void CubeScene::start(StartReason reason) {
 void CubeScene::frame() {
     eastl::array<psyqo::Vertex, 4> projected;
 
-    // Get which frame we're currently drawing
-    int parity = gpu().getParity();
+    // Get the resources of the frame we're currently drawing
+    auto& frame = m_frames.begin(gpu());
+    auto& ot = frame.ot;
 
-    // Get our current ordering table and fill command
-    auto& ot = m_ots[parity];
-    auto& clear = m_clear[parity];
+    // Since we're using an ordering table, we need to sort fill commands as well,
+    // otherwise they'll draw over our beautiful cube.
+    auto& clear = frame.allocator.allocateFragment<psyqo::Prim::FastFill>();
 
     // Chain the fill command accordingly to clear the buffer
     gpu().getNextClear(clear.primitive, c_bg);
@@ -157,8 +155,6 @@ void CubeScene::frame() {
     psyqo::SoftMath::multiplyMatrix33(transform, rot, &transform);
     psyqo::GTE::writeUnsafe<psyqo::GTE::PseudoRegister::Rotation>(transform);
 
-    int faceNum = 0;
-
     for (auto face : c_cubeFaces) {
         // We load the first 3 vertices into the GTE. We can't do all 4 at once because the GTE
         // handles only 3 at a time...
@@ -201,8 +197,8 @@ void CubeScene::frame() {
         psyqo::GTE::read<psyqo::GTE::Register::SXY1>(&projected[2].packed);
         psyqo::GTE::read<psyqo::GTE::Register::SXY2>(&projected[3].packed);
 
-        // Take a Quad fragment from our array, set its vertices, color and make it opaque
-        auto& quad = m_quads[faceNum];
+        // Allocate a Quad fragment for this frame, set its vertices, color and make it opaque
+        auto& quad = frame.allocator.allocateFragment<psyqo::Prim::Quad>();
         quad.primitive.setPointA(projected[0]);
         quad.primitive.setPointB(projected[1]);
         quad.primitive.setPointC(projected[2]);
@@ -212,11 +208,10 @@ void CubeScene::frame() {
 
         // Insert the Quad fragment into the ordering table at the calculated Z-index.
         ot.insert(quad, zIndex);
-        faceNum++;
     }
 
     // Send the entire ordering table as a DMA chain to the GPU.
-    gpu().chain(ot);
+    m_frames.end(gpu());
     m_rot += 0.005_pi;
 }
 
@@ -0,0 +1,155 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/hardware/counters.h"
+#include "psyqo/application.hh"
+#include "psyqo/fixed-point.hh"
+#include "psyqo/font.hh"
+#include "psyqo/gpu.hh"
+#include "psyqo/kernel.hh"
+#include "psyqo/scene.hh"
+#include "psyqo/soft-math.hh"
+#include "psyqo/trigonometry.hh"
+
+using namespace psyqo::fixed_point_literals;
+using namespace psyqo::trig_literals;
+
+// This example measures the cost of the fixed-point and trigonometry helpers,
+// using root counter 2 as a cycle counter. Each benchmark runs its kernel
+// a number of times with interrupts disabled, and the result is displayed
+// in CPU cycles per iteration.
+
+namespace {
+
+// The trigonometry table is computed by the compiler and lives in
+// read-only data, instead of being generated at boot time into RAM.
+static constexpr psyqo::Trig<> s_trig;
+
+class MathBench final : public psyqo::Application {
+    void prepare() override;
+    void createScene() override;
+
+  public:
+    psyqo::Font<> m_font;
+};
+
+class MathBenchScene final : public psyqo::Scene {
+    void start(Scene::StartReason reason) override;
+    void frame() override;
+
+    struct Result {
+        const char* name;
+        uint32_t cycles;
+    };
+    eastl::array<Result, 6> m_results;
+};
+
+MathBench mathBench;
+MathBenchScene mathBenchScene;
+
+constexpr unsigned c_iterations = 256;
+
+// Root counter 2, when sourced from the system clock divided by 8, wraps
+// after about 500k cycles, which is plenty for our loops.
+template <typename F>
+uint32_t measure(F&& f) {
+    psyqo::Kernel::fastEnterCriticalSection();
+    COUNTERS[2].mode = 0x200;
+    uint16_t start = COUNTERS[2].value;
+    for (unsigned i = 0; i < c_iterations; i++) f(i);
+    uint16_t end = COUNTERS[2].value;
+    psyqo::Kernel::fastLeaveCriticalSection();
+    return uint16_t(end - start) * 8;
+}
+
+// Sinks to prevent the compiler from optimizing the kernels away.
+volatile int32_t s_sink;
+psyqo::Matrix33 s_matrix;
+
+}  // namespace
+
+void MathBench::prepare() {
+    psyqo::GPU::Configuration config;
+    config.set(psyqo::GPU::Resolution::W320)
+        .set(psyqo::GPU::VideoMode::AUTO)
+        .set(psyqo::GPU::ColorMode::C15BITS)
+        .set(psyqo::GPU::Interlace::PROGRESSIVE);
+    gpu().initialize(config);
+}
+
+void MathBench::createScene() {
+    m_font.uploadSystemFont(gpu());
+    pushScene(&mathBenchScene);
+}
+
+void MathBenchScene::start(Scene::StartReason reason) {
+    m_results[0] = {"cos", measure([](unsigned i) {
+                        psyqo::Angle a;
+                        a.value = i * 7;
+                        s_sink = s_trig.cos(a).raw();
+                    })};
+    m_results[1] = {"sin", measure([](unsigned i) {
+                        psyqo::Angle a;
+                        a.value = i * 7;
+                        s_sink = s_trig.sin(a).raw();
+                    })};
+    // Small operands: the quotient is computed with a single hardware division.
+    m_results[2] = {"div small", measure([](unsigned i) {
+                        psyqo::FixedPoint<> n(int32_t(i + 3), 0);
+                        psyqo::FixedPoint<> d(int32_t(7), 0);
+                        s_sink = (n / d).raw();
+                    })};
+    // Large operands: both the numerator and the divisor overflow 32 bits once
+    // scaled, and the quotient has to go through the long division loop.
+    m_results[3] = {"div large", measure([](unsigned i) {
+                        psyqo::FixedPoint<> n(int32_t(i + 30000), 0);
+                        psyqo::FixedPoint<> d(int32_t(300), 0);
+                        s_sink = (n / d).raw();
+                    })};
+    m_results[4] = {"rotation", measure([](unsigned i) {
+                        psyqo::Angle a;
+                        a.value = i * 7;
+                        psyqo::SoftMath::generateRotationMatrix33(&s_matrix, a, psyqo::SoftMath::Axis::Y, s_trig);
+                    })};
+    m_results[5] = {"mat mul", measure([](unsigned) {
+                        psyqo::SoftMath::multiplyMatrix33(s_matrix, s_matrix, &s_matrix);
+                    })};
+}
+
+void MathBenchScene::frame() {
+    auto& gpu = mathBench.gpu();
+    gpu.clear();
+    auto c = psyqo::Color{{.r = 255, .g = 255, .b = 255}};
+    mathBench.m_font.print(gpu, "Cycles per iteration", {{.x = 16, .y = 16}}, c);
+    int16_t y = 48;
+    for (auto& result : m_results) {
+        uint32_t cycles = result.cycles / c_iterations;
+        mathBench.m_font.printf(gpu, {{.x = 16, .y = y}}, c, "%s: %i", result.name, cycles);
+        y += 16;
+    }
+}
+
+int main() { return mathBench.run(); }
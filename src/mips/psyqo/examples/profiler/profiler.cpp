@@ -0,0 +1,120 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "psyqo/application.hh"
+#include "psyqo/font.hh"
+#include "psyqo/gpu.hh"
+#include "psyqo/profiler.hh"
+#include "psyqo/scene.hh"
+#include "psyqo/soft-math.hh"
+#include "psyqo/trigonometry.hh"
+
+namespace {
+
+// This example shows how to use the Profiler class to measure the time
+// spent in various parts of an application. The results are drawn on
+// screen every frame, and sent once per second to the emulator, where
+// the companion script `profiler.lua` prints them in the console. It can
+// be loaded using the `-dofile profiler.lua` command line argument when
+// starting the emulator.
+class ProfilerDemo final : public psyqo::Application {
+    void prepare() override;
+    void createScene() override;
+
+  public:
+    psyqo::Font<> m_font;
+    psyqo::Profiler m_profiler;
+};
+
+class ProfilerScene final : public psyqo::Scene {
+    void start(StartReason reason) override;
+    void frame() override;
+
+    unsigned m_rotationScope;
+    unsigned m_clearScope;
+    unsigned m_frames = 0;
+    psyqo::Angle m_angle;
+};
+
+ProfilerDemo profilerDemo;
+ProfilerScene profilerScene;
+
+constexpr psyqo::Trig<> s_trig;
+psyqo::Matrix33 s_matrix;
+
+}  // namespace
+
+void ProfilerDemo::prepare() {
+    psyqo::GPU::Configuration config;
+    config.set(psyqo::GPU::Resolution::W320)
+        .set(psyqo::GPU::VideoMode::AUTO)
+        .set(psyqo::GPU::ColorMode::C15BITS)
+        .set(psyqo::GPU::Interlace::PROGRESSIVE);
+    gpu().initialize(config);
+}
+
+void ProfilerDemo::createScene() {
+    m_font.uploadSystemFont(gpu());
+    m_profiler.initialize();
+    pushScene(&profilerScene);
+}
+
+void ProfilerScene::start(StartReason reason) {
+    if (reason == StartReason::Create) {
+        m_rotationScope = profilerDemo.m_profiler.registerScope("rotations");
+        m_clearScope = profilerDemo.m_profiler.registerScope("clear");
+    }
+}
+
+void ProfilerScene::frame() {
+    auto& gpu = profilerDemo.gpu();
+    auto& profiler = profilerDemo.m_profiler;
+
+    {
+        // The scope is measured from the construction of this object
+        // until the end of the enclosing block.
+        psyqo::Profiler::Scope scope(profiler, m_rotationScope);
+        for (unsigned i = 0; i < 64; i++) {
+            psyqo::SoftMath::generateRotationMatrix33(&s_matrix, m_angle, psyqo::SoftMath::Axis::Z, s_trig);
+            m_angle.value += 3;
+        }
+    }
+
+    {
+        psyqo::Profiler::Scope scope(profiler, m_clearScope);
+        gpu.clear();
+    }
+
+    profiler.render(gpu, profilerDemo.m_font, {{.x = 16, .y = 16}}, {{.r = 255, .g = 255, .b = 255}});
+
+    if (++m_frames == 60) {
+        m_frames = 0;
+        profiler.report();
+        profiler.reset();
+    }
+}
+
+int main() { return profilerDemo.run(); }
@@ -0,0 +1,49 @@
+-- MIT License
+--
+-- Copyright (c) 2025 PCSX-Redux authors
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+-- SOFTWARE.
+
+
+-- This is the companion Lua script for the profiler demo, and
+-- can be used with any application using psyqo::Profiler::report.
+-- See profiler.cpp for the C++ side of the demo. The statistics
+-- are printed in the console, one line per scope, with durations
+-- converted to CPU cycles, which is easy to parse from a CI job.
+
+PCSX.execSlots[254] = function()
+    local mem = PCSX.getMemPtr()
+    local regs = PCSX.getRegisters().GPR.n
+    local function u32(addr) return ffi.cast('uint32_t*', mem + bit.band(addr, 0x7fffff))[0] end
+    local stats = regs.a0
+    local count = regs.a1
+    local cyclesPerTick = regs.a2
+    -- Matches the layout of psyqo::Profiler::Stats
+    local statsSize = 20 + 2 * 16
+    for i = 0, count - 1 do
+        local base = stats + i * statsSize
+        local name = ffi.string(mem + bit.band(u32(base), 0x7fffff))
+        local samples = u32(base + 4)
+        if samples ~= 0 then
+            print(string.format('profile %s samples=%d min=%d avg=%d max=%d', name, samples,
+                u32(base + 12) * cyclesPerTick, math.floor(u32(base + 8) / samples) * cyclesPerTick,
+                u32(base + 16) * cyclesPerTick))
+        end
+    end
+end
@@ -26,6 +26,7 @@ SOFTWARE.
 
 #pragma once
 
+#include <EASTL/algorithm.h>
 #include <EASTL/array.h>
 #include <EASTL/functional.h>
 #include <EASTL/string_view.h>
@@ -36,6 +37,7 @@ SOFTWARE.
 #include "psyqo/gpu.hh"
 #include "psyqo/primitives/common.hh"
 #include "psyqo/primitives/sprites.hh"
+#include "psyqo/xprintf.h"
 
 namespace psyqo {
 
@@ -56,6 +58,9 @@ class Font;
  */
 class FontBase {
   public:
+    template <size_t MaxLength>
+    class Text;
+
     virtual ~FontBase() {}
 
     /**
@@ -150,6 +155,17 @@ class FontBase {
     }
     void chainvprintf(GPU& gpu, Vertex pos, Color color, const char* format, va_list ap);
 
+    /**
+     * @brief Chains a pre-laid-out `Text` object to the next DMA chain transfer.
+     *
+     * @details Only lays the text out again if it changed since the last time it got chained with the
+     * same frame parity. See the `Text` class for more details.
+     */
+    template <size_t MaxLength>
+    void chainprint(GPU& gpu, Text<MaxLength>& text) {
+        gpu.chain(text.prepare(gpu, *this));
+    }
+
   protected:
     struct GlyphsFragmentPrologue {
         Prim::VRAMUpload upload;
@@ -165,10 +181,114 @@ class FontBase {
     void innerprint(GlyphsFragment* fragment, GPU& gpu, const char* text, Vertex pos, Color color);
     void innervprintf(GlyphsFragment* fragment, GPU& gpu, Vertex pos, Color color, const char* format, va_list ap);
 
+  public:
+    /**
+     * @brief A piece of text which is laid out once, and then chained as many frames as needed.
+     *
+     * @details The `print` and `chainprint` methods lay their text out into glyph sprites on every call,
+     * which adds up when lots of mostly static text get redrawn every frame, such as a debug display.
+     * A `Text` object keeps its sprites instead, and only lays them out again when its string, position,
+     * or font changes. Changing its color costs nothing. Each object owns its fragments, so the amount
+     * of `Text` objects isn't bound by the number of fragments of the `Font` template, and they are sent
+     * along with the rest of the frame, in the same DMA chain, using `chainprint`. As the GPU may still be
+     * reading what was chained during the previous frame, the object holds two fragments, picked according
+     * to `GPU::getParity`. This means a `Text` object can only be chained once per frame.
+     * @tparam MaxLength The maximum number of characters, spaces included. Longer strings get truncated.
+     */
+    template <size_t MaxLength>
+    class Text {
+      public:
+        /**
+         * @brief Sets the string to display.
+         *
+         * @details Does nothing if the string is the same as the current one.
+         */
+        void set(eastl::string_view text) {
+            if (text.size() > MaxLength) text = text.substr(0, MaxLength);
+            if (text == get()) return;
+            eastl::copy(text.begin(), text.end(), m_text.begin());
+            m_length = text.size();
+            m_generation++;
+        }
+        void printf(const char* format, ...) {
+            va_list args;
+            va_start(args, format);
+            vprintf(format, args);
+            va_end(args);
+        }
+        void vprintf(const char* format, va_list ap) {
+            char buffer[MaxLength + 1];
+            int length = vsnprintf(buffer, sizeof(buffer), format, ap);
+            if (length < 0) length = 0;
+            set({buffer, eastl::min(size_t(length), MaxLength)});
+        }
+        eastl::string_view get() const { return {m_text.data(), m_length}; }
+
+        /**
+         * @brief Sets the position of the first character.
+         */
+        void setPosition(Vertex pos) {
+            if (pos.packed == m_position.packed) return;
+            m_position = pos;
+            m_generation++;
+        }
+        Vertex getPosition() const { return m_position; }
+
+        /**
+         * @brief Sets the color of the text. This doesn't require laying the text out again.
+         */
+        void setColor(Color color) { m_color = color; }
+        Color getColor() const { return m_color; }
+
+      private:
+        typedef Fragments::FixedFragmentWithPrologue<GlyphsFragmentPrologue, Prim::Sprite, MaxLength> Fragment;
+        Fragment& prepare(GPU& gpu, const FontBase& font) {
+            unsigned parity = gpu.getParity();
+            auto& fragment = m_fragments[parity];
+            if (m_fonts[parity] != &font) {
+                m_fonts[parity] = &font;
+                m_generations[parity] = m_generation - 1;
+                font.setupFragment(fragment);
+            }
+            if (m_generations[parity] != m_generation) {
+                m_generations[parity] = m_generation;
+                fragment.count = font.layout(fragment.primitives.data(), MaxLength, get(), m_position);
+            }
+            fragment.prologue.pixel = glyphPixel(m_color);
+            return fragment;
+        }
+
+        eastl::array<Fragment, 2> m_fragments;
+        eastl::array<char, MaxLength> m_text;
+        unsigned m_length = 0;
+        unsigned m_generation = 0;
+        unsigned m_generations[2] = {0, 0};
+        const FontBase* m_fonts[2] = {nullptr, nullptr};
+        Vertex m_position = {{.x = 0, .y = 0}};
+        Color m_color = {{.r = 0xff, .g = 0xff, .b = 0xff}};
+
+        friend class FontBase;
+    };
+
   private:
     struct XPrintfInfo;
     GlyphsFragment& printToFragment(GPU& gpu, const char* text, Vertex pos, Color color);
+    template <typename Frag>
+    void setupFragment(Frag& fragment) const {
+        setupPrologue(fragment.prologue);
+        for (auto& p : fragment.primitives) {
+            p.setColor({{.r = 0x80, .g = 0x80, .b = 0x80}});
+            p.size = m_glyphSize;
+        }
+    }
+    void setupPrologue(GlyphsFragmentPrologue& prologue) const;
+    unsigned layout(Prim::Sprite* sprites, unsigned maxSize, eastl::string_view text, Vertex pos) const;
+    static uint32_t glyphPixel(Color color) {
+        uint32_t pixel = (color.r >> 3) | ((color.g >> 3) << 5) | ((color.b >> 3) << 10);
+        return pixel << 16;
+    }
     eastl::array<PrimPieces::TexInfo, 224> m_lut;
+    Vertex m_location;
     Vertex m_glyphSize;
 
     friend struct XPrintfInfo;
@@ -0,0 +1,111 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psyqo/gpu.hh"
+
+namespace psyqo {
+
+/**
+ * @brief A set of per-frame rendering resources, rotated on each frame flip.
+ *
+ * @details Fragments chained to the GPU are sent during the frame flip, while the
+ * CPU is already busy computing the next frame. This means that an ordering table,
+ * and the fragments inserted into it, can't be touched again until the GPU is done
+ * with them, which is why applications usually keep two copies of each, and pick
+ * one according to `GPU::getParity`. This class does this bookkeeping: it holds
+ * `Count` frames, each made of an ordering table and a bump allocator, and hands
+ * out the one which is safe to use for the frame being built.
+ *
+ * The typical usage is to call `begin` at the top of the scene's `frame` method,
+ * allocate fragments from the returned frame's allocator, insert them into its
+ * ordering table, and call `end` at the bottom to chain the ordering table.
+ *
+ * Since the `GPU` class waits for the previous chain to complete before sending
+ * the next one, two frames are enough when the chain is only sent during the
+ * frame flip. A third frame is only useful when `GPU::sendChain` is also used
+ * in the middle of a frame.
+ *
+ * @tparam OT The ordering table type, e.g. `OrderingTable<1024>`.
+ * @tparam Bump The bump allocator type, e.g. `BumpAllocator<8192>`.
+ * @tparam Count The number of frames to rotate through.
+ */
+template <typename OT, typename Bump, unsigned Count = 2>
+class FrameResources {
+    static_assert(Count >= 2, "FrameResources needs at least two frames");
+
+  public:
+    struct Frame {
+        OT ot;
+        Bump allocator;
+    };
+
+    /**
+     * @brief Selects and prepares the frame to build.
+     *
+     * @details This rotates to the next frame, and resets its allocator. It is
+     * tied to the GPU's frame flip: calling it more than once between two flips
+     * returns the same frame, without resetting it again.
+     * @param gpu The GPU the frame will be chained to.
+     * @return Frame& The frame to build.
+     */
+    Frame &begin(GPU &gpu) {
+        uint32_t frameCount = gpu.getFrameCount();
+        if (!m_started || (frameCount != m_frameCount)) {
+            m_started = true;
+            m_frameCount = frameCount;
+            m_index = (m_index + 1) % Count;
+            m_frames[m_index].allocator.reset();
+        }
+        return m_frames[m_index];
+    }
+
+    /**
+     * @brief Chains the current frame's ordering table to the next DMA chain transfer.
+     *
+     * @details The ordering table will be cleared automatically by the GPU
+     * once it has been sent, as with `GPU::chain`.
+     * @param gpu The GPU to chain the ordering table to.
+     */
+    void end(GPU &gpu) { gpu.chain(m_frames[m_index].ot); }
+
+    /**
+     * @brief Returns the frame last returned by `begin`.
+     */
+    Frame &current() { return m_frames[m_index]; }
+
+  private:
+    Frame m_frames[Count];
+    uint32_t m_frameCount = 0;
+    unsigned m_index = Count - 1;
+    bool m_started = false;
+};
+
+}  // namespace psyqo
@@ -358,6 +358,47 @@ class GPU {
         scheduleOTC(&table.m_table[N], N + 1);
     }
 
+    /**
+     * @brief Clears an ordering table using the OTC DMA channel as a non-blocking call.
+     *
+     * @details The ordering table constructor and `OrderingTable::clear` use a CPU loop,
+     * which is noticeable for large tables. This method will instead let the OTC DMA
+     * channel rebuild the table in the background, and call the callback upon completion.
+     * See the non-blocking variant of `uploadToVRAM` for more information about asynchronous
+     * transfers. Note that tables sent through `chain` are already cleared this way
+     * automatically after their transfer, so this is only needed for tables which were
+     * filled but never sent.
+     * @param table The ordering table to clear.
+     * @param callback The callback to call upon completion.
+     * @param dmaCallback `DMA::FROM_MAIN_LOOP` or `DMA::FROM_ISR`.
+     */
+    template <size_t N, Safe safety = Safe::Yes>
+    void clear(OrderingTable<N, safety> &table, eastl::function<void()> &&callback,
+               DMA::DmaCallback dmaCallback = DMA::FROM_MAIN_LOOP) {
+        clearOTC(&table.m_table[N], N + 1, eastl::move(callback), dmaCallback);
+    }
+
+    /**
+     * @brief Sends an ordering table immediately, and clears it afterward, as a non-blocking call.
+     *
+     * @details This method will chain the ordering table to the current DMA chain, and
+     * initiate the transfer right away, instead of waiting for the frame flip. Once the
+     * GPU has consumed the chain, the OTC DMA channel will clear the ordering table in
+     * the background, and only then will the callback be called, meaning the table can
+     * be filled again as soon as the callback runs. The CPU is free to run game logic
+     * during the whole operation. See the non-blocking variant of `uploadToVRAM` for more
+     * information about asynchronous transfers.
+     * @param table The ordering table to send.
+     * @param callback The callback to call upon completion.
+     * @param dmaCallback `DMA::FROM_MAIN_LOOP` or `DMA::FROM_ISR`.
+     */
+    template <size_t N, Safe safety = Safe::Yes>
+    void sendChain(OrderingTable<N, safety> &table, eastl::function<void()> &&callback,
+                   DMA::DmaCallback dmaCallback = DMA::FROM_MAIN_LOOP) {
+        chain(table);
+        sendChain(eastl::move(callback), dmaCallback);
+    }
+
     /**
      * @brief Immediately sends the current DMA chain
      *
@@ -537,6 +578,7 @@ class GPU {
     void scheduleChainedDMA(uintptr_t head);
     void chain(uint32_t *first, uint32_t *last, size_t count);
     void scheduleOTC(uint32_t *start, uint32_t count);
+    void clearOTC(uint32_t *start, uint32_t count, eastl::function<void()> &&callback, DMA::DmaCallback dmaCallback);
     void checkOTCAndTriggerCallback();
     void prepareForTakeover();
 
@@ -565,7 +607,9 @@ class GPU {
         uint32_t *start;
         uint32_t count;
     };
+    // One list for the chain being built, one for the chain being transferred.
     eastl::fixed_list<ScheduledOTC, 32> m_OTCs[2];
+    unsigned m_pendingOTCs = 0;
     uint32_t *m_chainNext = nullptr;
 
     uint16_t m_lastHSyncCounter = 0;
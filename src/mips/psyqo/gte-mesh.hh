@@ -0,0 +1,140 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psyqo/gte-kernels.hh"
+#include "psyqo/gte-registers.hh"
+
+namespace psyqo {
+
+namespace GTE {
+
+/**
+ * @brief A mesh vertex, laid out so it can be loaded into the GTE directly.
+ *
+ * @details The coordinates are in the same format as `PackedVec3`, but the
+ * vertex is padded to 8 bytes and aligned, so that the X/Y pair and the Z
+ * coordinate can each be loaded with a single `lwc2` instruction.
+ */
+struct alignas(4) MeshVertex {
+    int16_t x, y, z;
+    int16_t pad = 0;
+};
+static_assert(sizeof(MeshVertex) == 8, "MeshVertex is not 64 bits");
+
+/**
+ * @brief A mesh triangle, as three indices into a `MeshVertex` array.
+ */
+struct MeshTriangle {
+    uint16_t a, b, c;
+};
+
+/**
+ * @brief Transforms a triangle mesh, and emits its visible faces as primitives.
+ *
+ * @details This function runs the whole GTE pipeline for a mesh: each triangle is
+ * loaded into the GTE and projected using `rtpt`, back faces are culled using
+ * `nclip`, and `avsz3` computes the ordering table index of the remaining ones.
+ * A fragment is then allocated from the bump allocator, its three points are
+ * stored straight from the GTE's screen coordinates FIFO, and it is inserted into
+ * the ordering table. Triangles with an average Z of 0 are behind the projection
+ * plane, and are skipped as well.
+ *
+ * The loop is written so the CPU does useful work while the GTE is busy: the
+ * vertex indices of the next triangle are fetched during `rtpt`, instead of
+ * stalling on its result. Culled triangles never touch the bump allocator.
+ *
+ * The rotation, translation, screen offset, projection distance and Z averaging
+ * scale factor registers need to be set up beforehand. The `shade` callback is
+ * called for each emitted primitive, with the primitive and the index of the
+ * triangle it came from, and is meant to set its color, texture coordinates,
+ * or any other attribute.
+ *
+ * @tparam Prim The primitive to emit. It needs to have `pointA`, `pointB` and
+ * `pointC` members, which is the case of all the triangle primitives.
+ * @param vertices The vertices of the mesh.
+ * @param triangles The triangles of the mesh.
+ * @param count The number of triangles.
+ * @param ot The ordering table to insert the primitives into.
+ * @param allocator The bump allocator to allocate the fragments from.
+ * @param shade The callback to finish setting up each primitive.
+ * @return unsigned The number of primitives emitted.
+ */
+template <typename Prim, typename OT, typename Bump, typename Shade>
+unsigned transformMesh(const MeshVertex *vertices, const MeshTriangle *triangles, size_t count, OT &ot,
+                       Bump &allocator, Shade &&shade) {
+    if (count == 0) return 0;
+    unsigned emitted = 0;
+    const MeshTriangle *triangle = triangles;
+    const MeshTriangle *end = triangles + count;
+    const MeshVertex *v0 = &vertices[triangle->a];
+    const MeshVertex *v1 = &vertices[triangle->b];
+    const MeshVertex *v2 = &vertices[triangle->c];
+    while (true) {
+        write<Register::VXY0, Unsafe>(reinterpret_cast<const uint32_t *>(&v0->x));
+        write<Register::VZ0, Unsafe>(reinterpret_cast<const uint32_t *>(&v0->z));
+        write<Register::VXY1, Unsafe>(reinterpret_cast<const uint32_t *>(&v1->x));
+        write<Register::VZ1, Unsafe>(reinterpret_cast<const uint32_t *>(&v1->z));
+        write<Register::VXY2, Unsafe>(reinterpret_cast<const uint32_t *>(&v2->x));
+        write<Register::VZ2, Safe>(reinterpret_cast<const uint32_t *>(&v2->z));
+        Kernels::rtpt();
+
+        // The GTE is busy for 22 cycles: prepare the next triangle meanwhile.
+        unsigned index = triangle - triangles;
+        bool last = ++triangle == end;
+        if (!last) {
+            v0 = &vertices[triangle->a];
+            v1 = &vertices[triangle->b];
+            v2 = &vertices[triangle->c];
+        }
+
+        Kernels::nclip();
+        int32_t mac0 = readRaw<Register::MAC0, Safe>();
+        if (mac0 > 0) {
+            Kernels::avsz3();
+            int32_t z = readRaw<Register::OTZ, Safe>();
+            if (z > 0) {
+                auto &fragment = allocator.template allocateFragment<Prim>();
+                read<Register::SXY0>(&fragment.primitive.pointA.packed);
+                read<Register::SXY1>(&fragment.primitive.pointB.packed);
+                read<Register::SXY2>(&fragment.primitive.pointC.packed);
+                shade(fragment.primitive, index);
+                ot.insert(fragment, z);
+                emitted++;
+            }
+        }
+        if (last) break;
+    }
+    return emitted;
+}
+
+}  // namespace GTE
+
+}  // namespace psyqo
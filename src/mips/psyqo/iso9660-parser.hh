@@ -32,6 +32,7 @@ SOFTWARE.
 
 #include <coroutine>
 
+#include "common/util/djbhash.h"
 #include "psyqo/cdrom.hh"
 #include "psyqo/task.hh"
 
@@ -76,6 +77,23 @@ class ISO9660Parser {
         void* buffer = nullptr;
     };
 
+    /**
+     * @brief A directory cache entry.
+     *
+     * @details This struct is the storage unit of the optional directory
+     * cache. The user is only expected to allocate an array of these, and
+     * hand it over to `setDirectoryCache`. The hash is the djb2 hash of
+     * the full path of the entry, without its leading slash, such as
+     * `DATA/LEVEL1.BIN;1`, which is what the `getCachedDirentry` lookups
+     * expect.
+     */
+    struct CachedEntry {
+        uint64_t hash;
+        uint32_t LBA;
+        uint32_t size;
+        uint8_t type;
+    };
+
     /**
      * @brief The ISO9660Parser constructor.
      *
@@ -151,6 +169,61 @@ class ISO9660Parser {
         return GetDirentryAwaiter(*this, path, entry);
     }
 
+    /**
+     * @brief Sets up the directory cache.
+     *
+     * @details Without a cache, every lookup walks the directories on the
+     * disc, one sector at a time. With one, every directory entry found in
+     * the directory sectors read by the parser gets recorded in the given
+     * buffer, which the lookups then check first, and which can also be
+     * searched by precomputed path hashes, without any disc access. The
+     * buffer is not owned by the parser, and needs to stay valid for as long
+     * as the parser uses it. Once full, no more entries get recorded. The
+     * cache is emptied when initializing the parser. Passing a null buffer
+     * disables the cache.
+     *
+     * @param buffer The array of entries to use as the cache.
+     * @param capacity The number of entries in the array.
+     */
+    void setDirectoryCache(CachedEntry* buffer, unsigned capacity) {
+        m_cache = buffer;
+        m_cacheCapacity = buffer ? capacity : 0;
+        m_cacheCount = 0;
+    }
+
+    /**
+     * @brief Reads a whole directory into the cache.
+     *
+     * @details This method warms up the directory cache, by reading all the
+     * sectors of the given directory, so that all the files within it can
+     * then be found without reading the disc. It will fail if the CDRom
+     * device fails reading the disc, if the parser hasn't been initialized,
+     * or if the path isn't a directory. An empty path is the root directory.
+     *
+     * @param path The path of the directory to cache.
+     */
+    void cacheDirectory(eastl::string_view path, eastl::function<void(bool success)> callback);
+    TaskQueue::Task scheduleCacheDirectory(eastl::string_view path);
+
+    /**
+     * @brief Get the Direntry object for a given path hash.
+     *
+     * @details This method looks up the directory cache only, and as such
+     * completes immediately. Its main purpose is to find files by their
+     * path hash, computed at compile time, the same way the ArchiveManager
+     * does for the files of its archives. The name of the entry is left
+     * empty.
+     *
+     * @param hash The djb2 hash of the path, without its leading slash.
+     * @param[out] entry The DirEntry object to fill.
+     * @return true if the entry was in the cache, false otherwise.
+     */
+    bool getCachedDirentry(uint64_t hash, DirEntry* entry) const;
+    template <unsigned S>
+    bool getCachedDirentry(const char (&path)[S], DirEntry* entry) const {
+        return getCachedDirentry(djb::hash<uint64_t>(path), entry);
+    }
+
     /**
      * @brief Read a file asynchronously.
      *
@@ -186,6 +259,10 @@ class ISO9660Parser {
     void parseDirEntry(const uint8_t* data, DirEntry* entry);
     eastl::string_view getEntryName(const uint8_t* data);
     void findDirEntry();
+    static uint64_t hashDirectory(eastl::string_view path);
+    void cacheSector(uint64_t directoryHash);
+    void cacheEntry(uint64_t hash, const uint8_t* data);
+    void cacheNextSector();
 
     uint8_t m_buffer[2048];
     eastl::function<void(bool success)> m_callback = nullptr;
@@ -197,6 +274,15 @@ class ISO9660Parser {
     DirEntry m_cachedEntry;
     eastl::fixed_string<char, 128> m_cachedPath;
     bool m_initialized = false;
+
+    CachedEntry* m_cache = nullptr;
+    unsigned m_cacheCapacity = 0;
+    unsigned m_cacheCount = 0;
+    // The directory sector last recorded into the cache, to not record it again on every lookup.
+    uint32_t m_cacheLastLBA = 0;
+    DirEntry m_cacheDirectory;
+    uint64_t m_cacheDirectoryHash = 0;
+    unsigned m_cacheSectorIndex = 0;
 };
 
 }  // namespace psyqo
@@ -0,0 +1,171 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <EASTL/array.h>
+#include <stdint.h>
+
+#include "common/hardware/counters.h"
+#include "psyqo/font.hh"
+#include "psyqo/gpu.hh"
+
+namespace psyqo {
+
+/**
+ * @brief A cycle profiler for on-target measurements.
+ *
+ * @details This class measures the time spent in named scopes, using one
+ * of the root counters as its clock. For each scope, it accumulates the
+ * number of samples, their total, minimum and maximum durations, and a
+ * logarithmic histogram of them, all in a fixed buffer. The results can
+ * be drawn as an overlay using a `Font`, or reported to the PCSX-Redux
+ * emulator through its Lua bridge, so that scripts can log them, for
+ * instance to track performance in a CI environment.
+ *
+ * The counters are 16 bits wide, so a single sample can't be longer than
+ * 65535 ticks. With the system clock divided by 8, this is about 15ms,
+ * which is slightly less than a frame. Use the HBlank clock to measure
+ * longer scopes, at a coarser granularity.
+ */
+class Profiler {
+  public:
+    static constexpr unsigned c_maxScopes = 16;
+    static constexpr unsigned c_histogramBuckets = 16;
+
+    enum class Clock : uint8_t {
+        /** Root counter 2, sourced from the system clock divided by 8. */
+        SysClockDiv8,
+        /** Root counter 1, counting HBlanks, as set up by the GPU class. */
+        HBlank,
+    };
+
+    /**
+     * @brief The statistics of a single scope.
+     *
+     * @details The layout of this structure is part of the interface
+     * with the emulator's Lua scripts, and should not be changed lightly.
+     * The histogram bucket `n` counts the samples whose duration has its
+     * most significant bit at position `n - 1`, with bucket 0 counting
+     * the samples of 0 ticks.
+     */
+    struct Stats {
+        const char* name;
+        uint32_t count;
+        uint32_t total;
+        uint32_t min;
+        uint32_t max;
+        uint16_t histogram[c_histogramBuckets];
+    };
+
+    /**
+     * @brief A RAII helper measuring the lifetime of a scope.
+     */
+    class Scope {
+      public:
+        Scope(Profiler& profiler, unsigned id) : m_profiler(profiler), m_id(id), m_start(profiler.now()) {}
+        ~Scope() { m_profiler.record(m_id, uint16_t(m_profiler.now() - m_start)); }
+
+      private:
+        Profiler& m_profiler;
+        unsigned m_id;
+        uint16_t m_start;
+    };
+
+    /**
+     * @brief Sets up the profiler's clock.
+     *
+     * @details When using the HBlank clock, this needs to be called after
+     * the GPU has been initialized, which is the one configuring the
+     * root counter 1.
+     */
+    void initialize(Clock clock = Clock::SysClockDiv8);
+
+    /**
+     * @brief Registers a new scope.
+     *
+     * @param name The name of the scope. The string needs to outlive the profiler.
+     * @return unsigned The scope identifier, to use with `record` or `Scope`.
+     */
+    unsigned registerScope(const char* name);
+
+    /**
+     * @brief Reads the current value of the profiler's clock.
+     */
+    uint16_t now() const { return COUNTERS[m_clock == Clock::SysClockDiv8 ? 2 : 1].value; }
+
+    /**
+     * @brief Records a sample for a scope.
+     *
+     * @param id The scope identifier, as returned by `registerScope`.
+     * @param ticks The duration of the sample, in clock ticks.
+     */
+    void record(unsigned id, uint32_t ticks);
+
+    /**
+     * @brief Clears the accumulated statistics of all the scopes.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the statistics of a scope.
+     */
+    const Stats& stats(unsigned id) const { return m_stats[id]; }
+
+    /**
+     * @brief The number of CPU cycles represented by a clock tick.
+     *
+     * @details For the HBlank clock, this is an approximation, as the
+     * duration of a scanline depends on the video mode.
+     */
+    uint32_t cyclesPerTick() const { return m_clock == Clock::SysClockDiv8 ? 8 : 2160; }
+
+    /**
+     * @brief Draws the min/avg/max durations of all the scopes.
+     *
+     * @details The durations are displayed in clock ticks, one line
+     * per scope, starting at the specified position.
+     */
+    void render(GPU& gpu, FontBase& font, Vertex pos, Color color);
+
+    /**
+     * @brief Sends the statistics to the emulator.
+     *
+     * @details This calls into the Lua execution slot `slot` of PCSX-Redux,
+     * with `a0` pointing to the array of `Stats`, `a1` holding the number of
+     * registered scopes, and `a2` holding the result of `cyclesPerTick`.
+     * See the `profiler` example for a companion script. This does nothing
+     * when not running under the emulator.
+     */
+    void report(uint8_t slot = 254);
+
+  private:
+    eastl::array<Stats, c_maxScopes> m_stats;
+    unsigned m_scopes = 0;
+    Clock m_clock = Clock::SysClockDiv8;
+};
+
+}  // namespace psyqo
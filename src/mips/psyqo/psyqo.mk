@@ -8,7 +8,7 @@ CXXFLAGS += -std=c++20
 include $(PSYQODIR)../common.mk
 
 $(PSYQODIR)libpsyqo.a:
-	$(MAKE) -C $(PSYQODIR) BUILD=$(BUILD) CPPFLAGS_$(BUILD)="$(CPPFLAGS_$(BUILD))" LDFLAGS_$(BUILD)="$(LDFLAGS_$(BUILD))"
+	$(MAKE) -C $(PSYQODIR) BUILD=$(BUILD) CPPFLAGS_$(BUILD)="$(CPPFLAGS_$(BUILD))" LDFLAGS_$(BUILD)="$(LDFLAGS_$(BUILD))" PSYQO_ALLOCATOR=$(PSYQO_ALLOCATOR)
 
 clean::
 	$(MAKE) -C $(PSYQODIR) clean
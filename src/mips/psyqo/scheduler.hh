@@ -0,0 +1,134 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <EASTL/array.h>
+#include <stdint.h>
+
+#include <coroutine>
+
+#include "psyqo/coroutine.hh"
+
+namespace psyqo {
+
+/**
+ * @brief A cooperative scheduler for C++20 coroutines.
+ *
+ * @details This class runs a set of `Coroutine<>` tasks by priority, within
+ * a time budget. The typical usage is to call `run` once per frame, after
+ * the rendering work has been queued, with the amount of time left before
+ * the next vblank. This allows long running jobs such as loading, decompression
+ * or AI to be spread over several frames, by having them regularly call
+ * `co_await scheduler.yield()`. The scheduler will then resume the ready
+ * task with the highest priority, as long as the budget isn't exhausted,
+ * and tasks of the same priority are resumed in a round-robin fashion.
+ *
+ * A task can also suspend on any other awaitable, such as a CD-ROM read.
+ * It is then no longer ready as far as the scheduler is concerned, and
+ * will get resumed by the awaitable itself, outside of the scheduler. Its
+ * next `yield` will put it back in the ready set.
+ *
+ * The budget is measured in scanlines, using the root counter 1, which
+ * is set up by the GPU class to count HBlanks. Note that the scheduler
+ * can't preempt a task, so a task which doesn't yield often enough will
+ * overrun the budget.
+ */
+class Scheduler {
+  public:
+    static constexpr unsigned c_maxTasks = 16;
+
+    struct YieldAwaiter {
+        constexpr bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { m_scheduler->yieldInternal(handle); }
+        constexpr void await_resume() const {}
+
+      private:
+        YieldAwaiter(Scheduler *scheduler) : m_scheduler(scheduler) {}
+        Scheduler *m_scheduler;
+        friend class Scheduler;
+    };
+
+    /**
+     * @brief Adds a task to the scheduler.
+     *
+     * @details The coroutine needs to be freshly created, and not started yet.
+     * The scheduler doesn't take ownership of the coroutine object, which
+     * needs to stay alive until the task is done. The task will first be
+     * resumed on the next call to `run`.
+     *
+     * @param coroutine The coroutine to run.
+     * @param priority The priority of the task. Higher values run first.
+     */
+    void spawn(Coroutine<> &coroutine, uint8_t priority = 0);
+
+    /**
+     * @brief Yields the current task back to the scheduler.
+     *
+     * @details The returned object needs to be `co_await`ed by a task. The
+     * task stays ready, and will be resumed when its turn comes again,
+     * possibly during the same call to `run` if there is budget left.
+     * When awaited from a nested coroutine, this must happen while the
+     * scheduler is running the task, and not after the task was resumed
+     * by another awaitable.
+     */
+    YieldAwaiter yield() { return YieldAwaiter(this); }
+
+    /**
+     * @brief Runs ready tasks until the budget is exhausted.
+     *
+     * @details This method needs to be called from the main thread, typically
+     * from the `frame` method of a scene. The budget is checked before resuming
+     * each task, so the method returns either when no task is ready anymore, or
+     * when at least `budget` scanlines have elapsed.
+     *
+     * @param budget The time budget, in scanlines.
+     * @return unsigned The number of tasks which are still alive.
+     */
+    unsigned run(uint16_t budget);
+
+    /**
+     * @brief Returns the number of tasks which are still alive.
+     */
+    unsigned count() const;
+
+  private:
+    struct Entry {
+        Coroutine<> *coroutine = nullptr;
+        std::coroutine_handle<> resumePoint;
+        uint32_t lastRun = 0;
+        uint8_t priority = 0;
+        bool ready = false;
+        bool started = false;
+    };
+    void yieldInternal(std::coroutine_handle<> handle);
+
+    eastl::array<Entry, c_maxTasks> m_entries;
+    Entry *m_current = nullptr;
+    uint32_t m_tick = 0;
+};
+
+}  // namespace psyqo
@@ -0,0 +1,122 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <EASTL/type_traits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psyqo/bump-allocator.hh"
+#include "psyqo/shared.hh"
+
+/**
+ * @brief Places a global variable into the scratchpad.
+ *
+ * @details The scratchpad section is not loaded from the executable, so
+ * variables placed there start with undefined contents, unless they have
+ * a constructor. The linker will fail if the scratchpad overflows.
+ */
+#define PSYQO_SCRATCHPAD __attribute__((section(".scratchpad")))
+
+namespace psyqo {
+
+/**
+ * @brief Helpers for the scratchpad memory.
+ *
+ * @details The scratchpad is 1KB of data cache mapped at 0x1f800000. It is the
+ * only memory of the PS1 without wait states, which makes it ideal for small
+ * and hot data, such as matrix stacks, vertex buffers being transformed, or the
+ * stack of a function spilling lots of registers. It can't be used for code, nor
+ * as a DMA source or destination.
+ */
+namespace Scratchpad {
+
+static constexpr uintptr_t c_base = 0x1f800000;
+static constexpr size_t c_size = 1024;
+
+/**
+ * @brief A bump allocator meant to be placed into the scratchpad.
+ *
+ * @details This is a `BumpAllocator` whose size is checked at compile time to
+ * fit within the scratchpad. It needs to be declared using `PSYQO_SCRATCHPAD`:
+ *
+ * `PSYQO_SCRATCHPAD psyqo::Scratchpad::Arena<512> s_arena;`
+ *
+ * @tparam N The size of the arena in bytes.
+ */
+template <size_t N, Safe safety = Safe::Yes>
+class Arena : public BumpAllocator<N, safety> {
+    static_assert(N + sizeof(uint8_t *) <= c_size, "Arena doesn't fit in the scratchpad");
+};
+
+namespace Internal {
+void runOnStack(void (*func)(void *), void *arg, void *stack, unsigned size);
+}
+
+/**
+ * @brief A stack meant to be placed into the scratchpad.
+ *
+ * @details Running a function with its stack in the scratchpad makes its
+ * register spills, local arrays and nested calls avoid the main RAM entirely.
+ * Switching stacks costs a context save and restore, so this is only worth it
+ * for functions doing a lot of work per call. It needs to be declared using
+ * `PSYQO_SCRATCHPAD`, and can't be used by two functions at the same time,
+ * which means `run` must not be called recursively, nor from an interrupt
+ * handler while it is already in use:
+ *
+ * `PSYQO_SCRATCHPAD psyqo::Scratchpad::Stack<768> s_stack;`
+ *
+ * `s_stack.run([&]() { transformEverything(); });`
+ *
+ * @tparam N The size of the stack in bytes.
+ */
+template <size_t N>
+class Stack {
+    static_assert(N <= c_size, "Stack doesn't fit in the scratchpad");
+    static_assert((N & 7) == 0, "Stack size needs to be a multiple of 8");
+
+  public:
+    /**
+     * @brief Runs a function with its stack in the scratchpad.
+     *
+     * @details The function is called synchronously, and `run` returns once
+     * it has returned. Results can be passed back through lambda captures.
+     * @param func The function to run.
+     */
+    template <typename F>
+    void run(F &&func) {
+        using Func = eastl::remove_reference_t<F>;
+        Internal::runOnStack([](void *arg) { (*static_cast<Func *>(arg))(); }, &func, m_stack, N);
+    }
+
+  private:
+    uint8_t m_stack[N] __attribute__((aligned(8)));
+};
+
+}  // namespace Scratchpad
+
+}  // namespace psyqo
@@ -26,15 +26,107 @@ SOFTWARE.
 
 #pragma once
 
+#include <EASTL/functional.h>
+#include <stdint.h>
+
 namespace psyqo {
 
+class CDRomDevice;
+
 class SPU {
   public:
     static void reset();
     static void resetVoice(unsigned voice);
 
+    class Stream;
+
   private:
     static void waitIdle();
 };
 
+/**
+ * @brief Plays a stream of SPU ADPCM data from the CDRom.
+ *
+ * @details This class plays a mono stream of raw SPU ADPCM blocks, such as the body of a VAG file, stored
+ * contiguously on the disc. It uses the `CDRomDevice` streaming system to read the data into a ring buffer in
+ * main RAM, and copies it by DMA into a ring of two halves in SPU RAM, which a single voice loops over. The SPU
+ * IRQ address is set at the start of the half being played next, so that the SPU signals when the voice moves
+ * from one half to the other, which is when the half it just left gets refilled. This all happens in the
+ * background, from callbacks, without the application having to do anything. The CPU cost of a refill is
+ * fixed: one DMA transfer, and a pass over the loop flags of the refilled chunk, one byte per 16 bytes of
+ * data. The loop flags present in the source data are ignored, and replaced with the ones needed to loop
+ * the voice over the ring. If the CDRom can't keep up, the refill happens as soon as the data arrives, and
+ * the voice replays stale data in the meantime. Such underruns are counted.
+ *
+ * Only one stream can be played at a time, since the SPU only has one IRQ address, and since the `CDRomDevice`
+ * can only stream one thing at a time. The stream owns the SPU IRQ, the SPU DMA channel, and the CDRom while
+ * it is playing.
+ */
+class SPU::Stream {
+  public:
+    struct Config {
+        // The voice to play the stream with.
+        unsigned voice = 0;
+        // Where the two halves of the ring lie in SPU RAM. Must be 8-byte aligned.
+        uint32_t spuAddress = 0x1010;
+        // The size of each half of the ring in SPU RAM, in sectors of 2048 bytes.
+        unsigned chunkSectors = 2;
+        // The pitch of the voice, where 0x1000 means 44100Hz.
+        uint16_t sampleRate = 0x1000;
+        uint16_t volumeLeft = 0x3fff;
+        uint16_t volumeRight = 0x3fff;
+    };
+
+    /**
+     * @brief Starts streaming and playing data from the CDRom.
+     *
+     * @details The voice starts playing as soon as the two halves of the SPU ring are filled. The callback
+     * is called with `true` once the last chunk has been sent to the SPU, or once `stop` is called, and with
+     * `false` if the CDRom reported an error. The voice will finish playing the last chunk on its own.
+     *
+     * @param cdrom The CDRom device to stream from. It has to be idle.
+     * @param sector The first sector of the data.
+     * @param sectorCount The number of sectors of data.
+     * @param ring The buffer to stream the sectors into, of `ringSectors * 2048` bytes.
+     * @param ringSectors The number of sectors in the ring buffer. It has to be a multiple of the
+     * chunk size, and at least twice as large.
+     * @param config The voice and SPU RAM configuration.
+     * @param callback The callback to call when the stream is over.
+     */
+    void start(CDRomDevice& cdrom, uint32_t sector, uint32_t sectorCount, void* ring, unsigned ringSectors,
+               const Config& config, eastl::function<void(bool)>&& callback);
+
+    /**
+     * @brief Stops the voice and the stream.
+     *
+     * @details This can also be called after the callback, to cut the last chunk short.
+     */
+    void stop();
+
+    /**
+     * @brief Returns whether the stream is still reading from the CDRom.
+     */
+    bool isPlaying() const { return m_cdrom != nullptr; }
+    unsigned getUnderruns() const { return m_underruns; }
+
+  private:
+    static void prepare();
+    void upload(unsigned half);
+    void uploaded();
+    void irq();
+    void refill();
+    void streamStopped(bool success);
+    void keyOn();
+    void keyOff();
+
+    CDRomDevice* m_cdrom = nullptr;
+    eastl::function<void(bool)> m_callback;
+    Config m_config;
+    uint32_t m_remaining = 0;
+    unsigned m_underruns = 0;
+    unsigned m_uploading = 0;
+    bool m_priming = false;
+    bool m_draining = false;
+};
+
 }  // namespace psyqo
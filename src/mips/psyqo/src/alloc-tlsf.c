@@ -0,0 +1,347 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "psyqo/alloc.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(PSYQO_TLSF_ALLOCATOR) && !defined(USE_PCSXMSAN)
+
+// This is a two-level segregated fit allocator, which is selected
+// instead of the one in alloc.c by building psyqo with
+// PSYQO_ALLOCATOR=tlsf. Both malloc and free run in constant time,
+// no matter how fragmented the heap gets, which makes it a better
+// fit for workloads with many small, short-lived allocations, such
+// as a Lua VM. It respects the same interface guarantees as alloc.c.
+//
+// Every block, free or allocated, starts with a header holding its
+// size, and the size of the previous block when that one is free. Two
+// flags in the lower bits of the size tell if the block itself and
+// the previous one are in use, so that freeing a block merges it with
+// both of its neighbours without walking anything. The end of the heap
+// is marked by an in-use block of size 0, which stops the merging.
+//
+// Free blocks are kept in doubly linked lists, indexed by two levels.
+// The first level is the power of two of the size, and the second
+// level splits each power of two in 16 linear ranges. Blocks under
+// 128 bytes all go in the first row, which is then one exact class
+// every 8 bytes. A bitmap per level tells which lists aren't empty,
+// so finding a block is a couple of bit scans: the request size is
+// rounded up to the next class boundary, and any block from that
+// class or above is then guaranteed to fit.
+
+#define ALIGN_MASK ((2 * sizeof(void *)) - 1)
+#define ALIGN_TO(x) (((uintptr_t)(x) + ALIGN_MASK) & ~ALIGN_MASK)
+
+#define BLOCK_USED 1
+#define BLOCK_PREV_USED 2
+#define BLOCK_FLAGS (BLOCK_USED | BLOCK_PREV_USED)
+
+typedef struct block_ {
+    size_t prev_size;
+    size_t size_and_flags;
+    // These are only valid in free blocks.
+    struct block_ *next;
+    struct block_ *prev;
+} block;
+
+#define HEADER_SIZE (2 * sizeof(size_t))
+#define MIN_BLOCK_SIZE sizeof(block)
+
+_Static_assert(HEADER_SIZE == (ALIGN_MASK + 1), "block header is of the wrong size");
+_Static_assert(sizeof(block) == (2 * HEADER_SIZE), "block is of the wrong size");
+
+#define SL_LOG2 4
+#define SL_COUNT (1 << SL_LOG2)
+// Sizes below this all go in the first row.
+#define SMALL_LOG2 (SL_LOG2 + 3)
+#define SMALL_LIMIT (1 << SMALL_LOG2)
+// Enough rows for a heap of up to 8MB, as found on development units.
+#define FL_COUNT (23 - SMALL_LOG2 + 1)
+
+_Static_assert((SMALL_LIMIT / SL_COUNT) == (ALIGN_MASK + 1), "the first row should have one class per alignment");
+
+extern char __heap_start;
+extern char __stack_start;
+
+static uint32_t fl_bitmap;
+static uint32_t sl_bitmap[FL_COUNT];
+static block *free_lists[FL_COUNT][SL_COUNT];
+
+static block *bottom = NULL;
+static block *top = NULL;
+static void *maximum_heap_end = NULL;
+
+static size_t used = 0;
+static size_t peak_used = 0;
+static unsigned allocations = 0;
+
+static inline size_t block_size(const block *b) { return b->size_and_flags & ~BLOCK_FLAGS; }
+static inline block *block_at(const void *b, ptrdiff_t offset) { return (block *)((char *)b + offset); }
+
+// The R3000 has no instruction to count leading zeroes, and the
+// libgcc helper isn't available, so this is a plain binary search.
+// Returns the index of the highest bit set, which must exist.
+static inline unsigned find_last_set(uint32_t x) {
+    unsigned r = 0;
+    if (x & 0xffff0000) {
+        x >>= 16;
+        r += 16;
+    }
+    if (x & 0xff00) {
+        x >>= 8;
+        r += 8;
+    }
+    if (x & 0xf0) {
+        x >>= 4;
+        r += 4;
+    }
+    if (x & 0xc) {
+        x >>= 2;
+        r += 2;
+    }
+    if (x & 0x2) r += 1;
+    return r;
+}
+
+static inline unsigned find_first_set(uint32_t x) { return find_last_set(x & -x); }
+
+// Computes the list a block of the specified size belongs to.
+static inline void mapping(size_t size, unsigned *fl, unsigned *sl) {
+    if (size < SMALL_LIMIT) {
+        *fl = 0;
+        *sl = size >> 3;
+    } else {
+        unsigned f = find_last_set(size);
+        *fl = f - SMALL_LOG2 + 1;
+        *sl = (size >> (f - SL_LOG2)) ^ SL_COUNT;
+    }
+}
+
+// Finds a free block of at least the specified size, and unlinks it.
+static block *find_suitable(size_t size) {
+    // Rounding up to the next class boundary, so that
+    // every block of the resulting class is large enough.
+    if (size >= SMALL_LIMIT) size += (1 << (find_last_set(size) - SL_LOG2)) - 1;
+    unsigned fl, sl;
+    mapping(size, &fl, &sl);
+    if (fl >= FL_COUNT) return NULL;
+
+    uint32_t sl_map = sl_bitmap[fl] & (~0u << sl);
+    if (!sl_map) {
+        uint32_t fl_map = fl_bitmap & (~0u << (fl + 1));
+        if (!fl_map) return NULL;
+        fl = find_first_set(fl_map);
+        sl_map = sl_bitmap[fl];
+    }
+    sl = find_first_set(sl_map);
+
+    block *b = free_lists[fl][sl];
+    free_lists[fl][sl] = b->next;
+    if (b->next) {
+        b->next->prev = NULL;
+    } else {
+        sl_bitmap[fl] &= ~(1u << sl);
+        if (!sl_bitmap[fl]) fl_bitmap &= ~(1u << fl);
+    }
+    return b;
+}
+
+static void unlink_block(block *b) {
+    unsigned fl, sl;
+    mapping(block_size(b), &fl, &sl);
+    if (b->prev) {
+        b->prev->next = b->next;
+    } else {
+        free_lists[fl][sl] = b->next;
+        if (!b->next) {
+            sl_bitmap[fl] &= ~(1u << sl);
+            if (!sl_bitmap[fl]) fl_bitmap &= ~(1u << fl);
+        }
+    }
+    if (b->next) b->next->prev = b->prev;
+}
+
+// Turns the range starting at b into a free block of the specified size,
+// and inserts it in its list. The block before it has to be in use.
+static void make_free(block *b, size_t size) {
+    unsigned fl, sl;
+    mapping(size, &fl, &sl);
+    b->size_and_flags = size | BLOCK_PREV_USED;
+    block **head = &free_lists[fl][sl];
+    b->prev = NULL;
+    b->next = *head;
+    if (*head) (*head)->prev = b;
+    *head = b;
+    fl_bitmap |= 1u << fl;
+    sl_bitmap[fl] |= 1u << sl;
+    block *next = block_at(b, size);
+    next->prev_size = size;
+    next->size_and_flags &= ~BLOCK_PREV_USED;
+}
+
+// Marks b as used with the specified size, giving back what's left
+// at its end, if it's large enough to hold a block.
+static void take_block(block *b, size_t total, size_t size) {
+    size_t flags = b->size_and_flags & BLOCK_PREV_USED;
+    if ((total - size) >= MIN_BLOCK_SIZE) {
+        b->size_and_flags = size | flags | BLOCK_USED;
+        make_free(block_at(b, size), total - size);
+    } else {
+        b->size_and_flags = total | flags | BLOCK_USED;
+        block_at(b, total)->size_and_flags |= BLOCK_PREV_USED;
+    }
+}
+
+static void account_resize(size_t old_size, size_t size) {
+    used += size - old_size;
+    if (used > peak_used) peak_used = used;
+}
+
+static size_t request_size(size_t size_) {
+    if (size_ > (SIZE_MAX / 2)) return 0;
+    size_t size = ALIGN_TO(size_ + HEADER_SIZE);
+    return size < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : size;
+}
+
+// The heap spans from the end of the binary up to the stack.
+static void init_heap() {
+    uintptr_t start = ALIGN_TO(&__heap_start);
+    uintptr_t end = (uintptr_t)&__stack_start & ~ALIGN_MASK;
+    bottom = (block *)start;
+    top = (block *)end;
+    block *sentinel = block_at(top, -(ptrdiff_t)HEADER_SIZE);
+    sentinel->size_and_flags = BLOCK_USED;
+    bottom->prev_size = 0;
+    make_free(bottom, end - start - HEADER_SIZE);
+}
+
+void *psyqo_malloc(size_t size_) {
+    if (bottom == NULL) init_heap();
+    size_t size = request_size(size_);
+    if (size == 0) return NULL;
+
+    block *b = find_suitable(size);
+    if (!b) return NULL;
+
+    take_block(b, block_size(b), size);
+    size = block_size(b);
+    void *end = block_at(b, size);
+    if (end > maximum_heap_end) maximum_heap_end = end;
+    account_resize(0, size);
+    allocations++;
+    return block_at(b, HEADER_SIZE);
+}
+
+void psyqo_free(void *ptr_) {
+    if (ptr_ == NULL) return;
+
+    block *b = block_at(ptr_, -(ptrdiff_t)HEADER_SIZE);
+    size_t size = block_size(b);
+    used -= size;
+    allocations--;
+
+    block *next = block_at(b, size);
+    if (!(next->size_and_flags & BLOCK_USED)) {
+        unlink_block(next);
+        size += block_size(next);
+    }
+    if (!(b->size_and_flags & BLOCK_PREV_USED)) {
+        block *prev = block_at(b, -(ptrdiff_t)b->prev_size);
+        unlink_block(prev);
+        size += block_size(prev);
+        b = prev;
+    }
+    make_free(b, size);
+}
+
+void *psyqo_realloc(void *ptr_, size_t size_) {
+    if (ptr_ == NULL) {
+        return psyqo_malloc(size_);
+    }
+
+    if (size_ == 0) {
+        psyqo_free(ptr_);
+        return NULL;
+    }
+
+    size_t size = request_size(size_);
+    if (size == 0) return NULL;
+    block *b = block_at(ptr_, -(ptrdiff_t)HEADER_SIZE);
+    size_t old_size = block_size(b);
+
+    // Shrinking, or growing into the next block if it's free and large enough.
+    size_t available = old_size;
+    block *next = block_at(b, old_size);
+    if ((size > old_size) && !(next->size_and_flags & BLOCK_USED)) available += block_size(next);
+    if (size <= available) {
+        if (available != old_size) {
+            unlink_block(next);
+        } else if (((old_size - size) >= MIN_BLOCK_SIZE) && !(next->size_and_flags & BLOCK_USED)) {
+            // Merging the released tail with the free block after it.
+            unlink_block(next);
+            available += block_size(next);
+        }
+        take_block(b, available, size);
+        size = block_size(b);
+        void *end = block_at(b, size);
+        if (end > maximum_heap_end) maximum_heap_end = end;
+        account_resize(old_size, size);
+        return ptr_;
+    }
+
+    void *new_ptr = psyqo_malloc(size_);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    __builtin_memcpy(new_ptr, ptr_, old_size - HEADER_SIZE);
+    psyqo_free(ptr_);
+    return new_ptr;
+}
+
+void *psyqo_heap_start() { return bottom; }
+void *psyqo_heap_end() { return maximum_heap_end; }
+
+void psyqo_heap_get_stats(struct psyqo_heap_stats *stats, int reset_peak) {
+    stats->used = used;
+    // The sentinel at the end of the heap is neither used nor free.
+    stats->free = bottom ? ((char *)top - (char *)bottom) - HEADER_SIZE - used : 0;
+    stats->largest_free = 0;
+    stats->peak_used = peak_used;
+    stats->allocations = allocations;
+    // Only the highest non-empty list can hold the largest block.
+    if (fl_bitmap) {
+        unsigned fl = find_last_set(fl_bitmap);
+        unsigned sl = find_last_set(sl_bitmap[fl]);
+        for (const block *b = free_lists[fl][sl]; b; b = b->next) {
+            if (block_size(b) > stats->largest_free) stats->largest_free = block_size(b);
+        }
+    }
+    if (reset_peak) peak_used = used;
+}
+
+#endif
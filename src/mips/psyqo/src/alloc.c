@@ -49,6 +49,10 @@ SOFTWARE.
 // 3. Re-allocating a pointer to 0 bytes will behave as if free was called.
 // 4. Re-allocating a NULL pointer will behave like a call to malloc.
 
+// The two-level segregated fit allocator in alloc-tlsf.c replaces
+// this one when PSYQO_TLSF_ALLOCATOR is defined.
+#if !defined(PSYQO_TLSF_ALLOCATOR) || defined(USE_PCSXMSAN)
+
 // Align to 8 bytes on 32-bit platforms,
 // and 16 bytes on 64-bit platforms.
 #define ALIGN_MASK ((2 * sizeof(void *)) - 1)
@@ -103,6 +107,15 @@ static void *maximum_heap_end = NULL;
 // back to the head. It will never fit any allocation, and will always
 // be the last block in the list.
 static empty_block marker;
+// The statistics, for psyqo_heap_get_stats. The sizes include the headers.
+static size_t used = 0;
+static size_t peak_used = 0;
+static unsigned allocations = 0;
+
+static inline void account_resize(size_t old_size, size_t size) {
+    used += size - old_size;
+    if (used > peak_used) peak_used = used;
+}
 
 // Enable this to debug the allocator very thoroughly. May be used to
 // detect memory corruption, and other issues.
@@ -335,6 +348,8 @@ void *psyqo_malloc(size_t size_) {
     }
     ptr->size = size;
     ptr++;
+    account_resize(0, size);
+    allocations++;
 
     dprintf("psyqo_malloc(%u) -> %p\n", size_, ptr);
     check_integrity();
@@ -348,9 +363,19 @@ void psyqo_free(void *ptr_) {
         return;
     }
 
+    // If the head is NULL, this means the user is trying to free
+    // a block that was never allocated. This is undefined behavior,
+    // but we will just ignore it, because it's an easy one, and
+    // it'll be a pain to debug due to the comparisons below.
+    if (head == NULL) {
+        return;
+    }
+
     empty_block *block = (empty_block *)ptr_;
     block--;
     size_t size = block->size;
+    used -= size;
+    allocations--;
 
     // Is head pointing to our marker? If that's the case, the
     // heap was totally full. So freeing this block means
@@ -365,14 +390,6 @@ void psyqo_free(void *ptr_) {
         return;
     }
 
-    // If the head is NULL, this means the user is trying to free
-    // a block that was never allocated. This is undefined behavior,
-    // but we will just ignore it, because it's an easy one, and
-    // it'll be a pain to debug due to the comparison below.
-    if (head == NULL) {
-        return;
-    }
-
     // If the head is after the block we're freeing, we can just
     // insert it at the head of the list.
     if (head > block) {
@@ -503,6 +520,7 @@ void *psyqo_realloc(void *ptr_, size_t size_) {
             new_block->size = old_size - size;
             head = new_block;
             block->size = size;
+            account_resize(old_size, size);
             dprintf("psyqo_realloc(%p, %u) -> %p\n", ptr_, size_, ptr_);
             check_integrity();
             return ptr_;
@@ -530,6 +548,7 @@ void *psyqo_realloc(void *ptr_, size_t size_) {
             }
             head = new_block;
             block->size = size;
+            account_resize(old_size, size);
             dprintf("psyqo_realloc(%p, %u) -> %p\n", ptr_, size_, ptr_);
             check_integrity();
             return ptr_;
@@ -553,6 +572,7 @@ void *psyqo_realloc(void *ptr_, size_t size_) {
                     head = new_block;
                 }
                 block->size = size;
+                account_resize(old_size, size);
                 dprintf("psyqo_realloc(%p, %u) -> %p\n", ptr_, size_, ptr_);
                 check_integrity();
                 return ptr_;
@@ -596,6 +616,7 @@ void *psyqo_realloc(void *ptr_, size_t size_) {
             }
             curr->next = new_block;
             block->size = size;
+            account_resize(old_size, size);
             dprintf("psyqo_realloc(%p, %u) -> %p\n", ptr_, size_, ptr_);
             check_integrity();
             return ptr_;
@@ -620,6 +641,7 @@ void *psyqo_realloc(void *ptr_, size_t size_) {
                 curr->next = new_block;
             }
             block->size = size;
+            account_resize(old_size, size);
             dprintf("psyqo_realloc(%p, %u) -> %p\n", ptr_, size_, ptr_);
             check_integrity();
             return ptr_;
@@ -644,6 +666,7 @@ void *psyqo_realloc(void *ptr_, size_t size_) {
     return new_ptr;
 }
 #endif
+#endif
 
 void *__builtin_new(size_t size) { return psyqo_malloc(size); }
 void __builtin_delete(void *ptr) { psyqo_free(ptr); }
@@ -660,5 +683,21 @@ void _ZdlPvj(void *ptr, unsigned int size) { psyqo_free(ptr); }
 // void operator delete[](void*, unsigned int);
 void _ZdaPvj(void *ptr, unsigned int size) { psyqo_free(ptr); }
 
+#if !defined(PSYQO_TLSF_ALLOCATOR) || defined(USE_PCSXMSAN)
 void *psyqo_heap_start() { return bottom; }
 void *psyqo_heap_end() { return maximum_heap_end; }
+
+void psyqo_heap_get_stats(struct psyqo_heap_stats *stats, int reset_peak) {
+    stats->used = used;
+    stats->free = bottom ? ((char *)top - (char *)bottom) - used : 0;
+    stats->largest_free = 0;
+    stats->peak_used = peak_used;
+    stats->allocations = allocations;
+    // The free list is walked in full, so this isn't something to
+    // call more than once per frame with a fragmented heap.
+    for (const empty_block *curr = head; curr && (curr != &marker); curr = curr->next) {
+        if (curr->size > stats->largest_free) stats->largest_free = curr->size;
+    }
+    if (reset_peak) peak_used = used;
+}
+#endif
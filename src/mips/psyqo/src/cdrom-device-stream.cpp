@@ -0,0 +1,268 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <EASTL/atomic.h>
+
+#include "common/hardware/dma.h"
+#include "psyqo/cdrom-device.hh"
+#include "psyqo/hardware/cdrom.hh"
+#include "psyqo/hardware/sbus.hh"
+#include "psyqo/kernel.hh"
+#include "psyqo/msf.hh"
+
+namespace {
+
+enum class StreamActionState : uint8_t {
+    IDLE,
+    SETLOC,
+    SETMODE,
+    READ,
+    STREAMING,
+    FULL,
+    FULL_ACK,
+    PAUSED,
+    STOPPING,
+    STOPPING_ACK,
+};
+
+class StreamAction : public psyqo::CDRomDevice::Action<StreamActionState> {
+  public:
+    StreamAction() : Action("StreamAction") {}
+    void start(psyqo::CDRomDevice *device, uint32_t sector, uint8_t *ring, unsigned ringSectors,
+               eastl::function<void(bool)> &&callback) {
+        psyqo::Kernel::assert(device->isIdle(),
+                              "CDRomDevice::startStream() called while another action is in progress");
+        psyqo::Kernel::assert(ringSectors != 0, "CDRomDevice::startStream() called with an empty ring");
+        registerMe(device);
+        setCallback([this, callback = eastl::move(callback)](bool success) {
+            m_active = false;
+            if (m_waiter) {
+                auto waiter = eastl::move(m_waiter);
+                m_waiter = nullptr;
+                waiter(false);
+            }
+            callback(success);
+        });
+        m_ring = ring;
+        m_ringSectors = ringSectors;
+        m_next = sector;
+        m_written = m_consumed = 0;
+        m_active = true;
+        m_resuming = false;
+        m_stopRequested = false;
+        seek();
+    }
+    void stop() {
+        switch (getState()) {
+            case StreamActionState::STREAMING:
+            case StreamActionState::PAUSED:
+                pause(StreamActionState::STOPPING);
+                break;
+            default:
+                // A command is in flight, and the state machine
+                // will pick this up at its next step.
+                m_stopRequested = true;
+                eastl::atomic_signal_fence(eastl::memory_order_release);
+                break;
+        }
+    }
+    void release(unsigned count) {
+        psyqo::Kernel::assert(count <= available(), "CDRomDevice::streamRelease() called with too many sectors");
+        m_consumed += count;
+        eastl::atomic_signal_fence(eastl::memory_order_release);
+        if (count && m_active && (getState() == StreamActionState::PAUSED)) {
+            m_resuming = true;
+            seek();
+        }
+    }
+    void wait(unsigned count, eastl::function<void(bool)> &&callback) {
+        psyqo::Kernel::assert(!m_waiter, "CDRomDevice::waitStream() called while another wait is pending");
+        psyqo::Kernel::assert(count <= m_ringSectors,
+                              "CDRomDevice::waitStream() called with more sectors than the ring");
+        if ((available() >= count) || !m_active) {
+            psyqo::Kernel::queueCallback([callback = eastl::move(callback), ready = available() >= count]() {
+                callback(ready);
+            });
+            return;
+        }
+        m_wanted = count;
+        m_waiter = eastl::move(callback);
+        eastl::atomic_signal_fence(eastl::memory_order_release);
+    }
+    unsigned available() const { return m_written - m_consumed; }
+    const uint8_t *data() const { return m_ring ? m_ring + (m_consumed % m_ringSectors) * 2048 : nullptr; }
+
+    bool dataReady(const psyqo::CDRomDevice::Response &) override {
+        psyqo::Hardware::CDRom::Ctrl.throwAway();
+        psyqo::Hardware::CDRom::DataRequest = 0;
+        // Sectors racing a pause command are kept if there's room left,
+        // and dropped otherwise, in which case they will be read again
+        // when the stream resumes.
+        if (available() < m_ringSectors) {
+            psyqo::Hardware::CDRom::InterruptControl.throwAway();
+            psyqo::Hardware::CDRom::DataRequest = 0x80;
+            psyqo::Hardware::SBus::Dev5Ctrl = 0x20943;
+            psyqo::Hardware::SBus::ComCtrl = 0x132c;
+            eastl::atomic_signal_fence(eastl::memory_order_acquire);
+            DMA_CTRL[DMA_CDROM].MADR = reinterpret_cast<uintptr_t>(m_ring + (m_written % m_ringSectors) * 2048);
+            DMA_CTRL[DMA_CDROM].BCR = 512 | 0x10000;
+            DMA_CTRL[DMA_CDROM].CHCR = 0x11000000;
+            m_written++;
+            m_next++;
+            if (m_waiter && (available() >= m_wanted)) wakeWaiter();
+        }
+        if ((getState() == StreamActionState::STREAMING) && (available() == m_ringSectors)) {
+            pause(StreamActionState::FULL);
+        }
+        eastl::atomic_signal_fence(eastl::memory_order_release);
+        return false;
+    }
+    bool complete(const psyqo::CDRomDevice::Response &) override {
+        switch (getState()) {
+            case StreamActionState::FULL_ACK:
+                if (m_stopRequested) {
+                    setSuccess(true);
+                    return true;
+                }
+                if (available() < m_ringSectors) {
+                    // The application released sectors while we were pausing.
+                    m_resuming = true;
+                    seek();
+                } else {
+                    setState(StreamActionState::PAUSED);
+                }
+                break;
+            case StreamActionState::STOPPING_ACK:
+                setSuccess(true);
+                return true;
+            default:
+                psyqo::Kernel::abort("StreamAction got CDROM complete in wrong state");
+                break;
+        }
+        return false;
+    }
+    bool acknowledge(const psyqo::CDRomDevice::Response &) override {
+        switch (getState()) {
+            case StreamActionState::SETLOC:
+                if (m_stopRequested) {
+                    pause(StreamActionState::STOPPING);
+                } else if (m_resuming) {
+                    setState(StreamActionState::READ);
+                    psyqo::Hardware::CDRom::Command.send(psyqo::Hardware::CDRom::CDL::READN);
+                } else {
+                    setState(StreamActionState::SETMODE);
+                    psyqo::Hardware::CDRom::Command.send(psyqo::Hardware::CDRom::CDL::SETMODE, 0x80);
+                }
+                break;
+            case StreamActionState::SETMODE:
+                setState(StreamActionState::READ);
+                psyqo::Hardware::CDRom::Command.send(psyqo::Hardware::CDRom::CDL::READN);
+                break;
+            case StreamActionState::READ:
+                if (m_stopRequested) {
+                    pause(StreamActionState::STOPPING);
+                } else {
+                    setState(StreamActionState::STREAMING);
+                }
+                break;
+            case StreamActionState::FULL:
+                setState(StreamActionState::FULL_ACK);
+                break;
+            case StreamActionState::STOPPING:
+                setState(StreamActionState::STOPPING_ACK);
+                break;
+            default:
+                psyqo::Kernel::abort("StreamAction got CDROM acknowledge in wrong state");
+                break;
+        }
+        return false;
+    }
+
+  private:
+    void seek() {
+        setState(StreamActionState::SETLOC);
+        eastl::atomic_signal_fence(eastl::memory_order_release);
+        psyqo::MSF msf(m_next + 150);
+        uint8_t bcd[3];
+        msf.toBCD(bcd);
+        psyqo::Hardware::CDRom::Command.send(psyqo::Hardware::CDRom::CDL::SETLOC, bcd[0], bcd[1], bcd[2]);
+    }
+    void pause(StreamActionState state) {
+        setState(state);
+        eastl::atomic_signal_fence(eastl::memory_order_release);
+        psyqo::Hardware::CDRom::Command.send(psyqo::Hardware::CDRom::CDL::PAUSE);
+    }
+    void wakeWaiter() {
+        psyqo::Kernel::queueCallbackFromISR([waiter = eastl::move(m_waiter)]() { waiter(true); });
+        m_waiter = nullptr;
+    }
+
+    eastl::function<void(bool)> m_waiter;
+    uint8_t *m_ring = nullptr;
+    unsigned m_ringSectors = 0;
+    unsigned m_wanted = 0;
+    uint32_t m_next = 0;
+    uint32_t m_written = 0;
+    uint32_t m_consumed = 0;
+    bool m_active = false;
+    bool m_resuming = false;
+    bool m_stopRequested = false;
+};
+
+StreamAction s_streamAction;
+
+}  // namespace
+
+void psyqo::CDRomDevice::startStream(uint32_t sector, void *ring, unsigned ringSectors,
+                                     eastl::function<void(bool)> &&callback) {
+    Kernel::assert(m_callback == nullptr, "CDRomDevice::startStream called with pending action");
+    s_streamAction.start(this, sector, reinterpret_cast<uint8_t *>(ring), ringSectors, eastl::move(callback));
+}
+
+void psyqo::CDRomDevice::stopStream() {
+    MaskedIRQ masked;
+    // If the stream isn't running anymore, it means we got
+    // raced by an error, and we should just ignore this.
+    if (m_action != &s_streamAction) return;
+    s_streamAction.stop();
+}
+
+unsigned psyqo::CDRomDevice::streamAvailable() const {
+    eastl::atomic_signal_fence(eastl::memory_order_acquire);
+    return s_streamAction.available();
+}
+
+const uint8_t *psyqo::CDRomDevice::streamData() const { return s_streamAction.data(); }
+
+void psyqo::CDRomDevice::streamRelease(unsigned count) {
+    MaskedIRQ masked;
+    s_streamAction.release(count);
+}
+
+void psyqo::CDRomDevice::waitStream(unsigned count, eastl::function<void(bool)> &&callback) {
+    MaskedIRQ masked;
+    s_streamAction.wait(count, eastl::move(callback));
+}
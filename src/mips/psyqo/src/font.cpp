@@ -228,6 +228,7 @@ void psyqo::FontBase::unpackFont(GPU& gpu, const uint8_t* data, Vertex location,
 }
 
 void psyqo::FontBase::initialize(GPU& gpu, Vertex location, Vertex glyphSize) {
+    m_location = location;
     m_glyphSize = glyphSize;
     PrimPieces::ClutIndex clut(location);
     unsigned glyphPerRow = 256 / glyphSize.w;
@@ -239,24 +240,18 @@ void psyqo::FontBase::initialize(GPU& gpu, Vertex location, Vertex glyphSize) {
         texInfo.v += glyphSize.h * l;
         m_lut[i] = texInfo;
     }
-    forEach([this, location](auto& fragment) {
-        fragment.prologue.upload.region.pos = location;
-        fragment.prologue.upload.region.size = {{.w = 2, .h = 1}};
-        fragment.prologue.pixel = 0x7fff0000;
-        psyqo::PrimPieces::TPageAttr attr;
-        uint8_t pageX = location.x >> 6;
-        uint8_t pageY = location.y >> 8;
-        attr.setPageX(pageX)
-            .setPageY(pageY)
-            .set(psyqo::Prim::TPageAttr::Tex4Bits)
-            .setDithering(false)
-            .enableDisplayArea();
-        fragment.prologue.tpage.attr = attr;
-        for (auto& p : fragment.primitives) {
-            p.setColor({{.r = 0x80, .g = 0x80, .b = 0x80}});
-            p.size = m_glyphSize;
-        }
-    });
+    forEach([this](auto& fragment) { setupFragment(fragment); });
+}
+
+void psyqo::FontBase::setupPrologue(GlyphsFragmentPrologue& prologue) const {
+    prologue.upload.region.pos = m_location;
+    prologue.upload.region.size = {{.w = 2, .h = 1}};
+    prologue.pixel = 0x7fff0000;
+    psyqo::PrimPieces::TPageAttr attr;
+    uint8_t pageX = m_location.x >> 6;
+    uint8_t pageY = m_location.y >> 8;
+    attr.setPageX(pageX).setPageY(pageY).set(psyqo::Prim::TPageAttr::Tex4Bits).setDithering(false).enableDisplayArea();
+    prologue.tpage.attr = attr;
 }
 
 void psyqo::FontBase::print(GPU& gpu, eastl::string_view text, Vertex pos, Color color) {
@@ -316,9 +311,13 @@ void psyqo::FontBase::chainprint(GPU& gpu, const char* text, Vertex pos, Color c
 }
 
 void psyqo::FontBase::innerprint(GlyphsFragment* fragment, GPU& gpu, eastl::string_view text, Vertex pos, Color color) {
+    fragment->count = layout(fragment->primitives.data(), fragment->primitives.size(), text, pos);
+    fragment->prologue.pixel = glyphPixel(color);
+}
+
+unsigned psyqo::FontBase::layout(Prim::Sprite* sprites, unsigned maxSize, eastl::string_view text, Vertex pos) const {
     auto size = m_glyphSize;
     unsigned i = 0;
-    auto maxSize = fragment->primitives.size();
 
     for (auto c : text) {
         if (i >= maxSize) break;
@@ -329,18 +328,13 @@ void psyqo::FontBase::innerprint(GlyphsFragment* fragment, GPU& gpu, eastl::stri
             pos.x += size.w;
             continue;
         }
-        auto& f = fragment->primitives[i++];
+        auto& f = sprites[i++];
         auto p = m_lut[c - 32];
         f.position = pos;
         f.texInfo = p;
         pos.x += size.w;
     }
-    fragment->count = i;
-    color.r >>= 3;
-    color.g >>= 3;
-    color.b >>= 3;
-    uint32_t pixel = color.r | (color.g << 5) | (color.b << 10);
-    fragment->prologue.pixel = pixel << 16;
+    return i;
 }
 
 void psyqo::FontBase::innerprint(GlyphsFragment* fragment, GPU& gpu, const char* text, Vertex pos, Color color) {
@@ -363,11 +357,7 @@ void psyqo::FontBase::innerprint(GlyphsFragment* fragment, GPU& gpu, const char*
         f.texInfo = p;
     }
     fragment->count = i;
-    color.r >>= 3;
-    color.g >>= 3;
-    color.b >>= 3;
-    uint32_t pixel = color.r | (color.g << 5) | (color.b << 10);
-    fragment->prologue.pixel = pixel << 16;
+    fragment->prologue.pixel = glyphPixel(color);
 }
 
 void psyqo::FontBase::vprintf(GPU& gpu, Vertex pos, Color color, const char* format, va_list ap) {
@@ -410,11 +400,7 @@ extern "C" int vxprintf(void (*func)(const char*, int, void*), void* arg, const
 void psyqo::FontBase::innervprintf(GlyphsFragment* fragment, GPU& gpu, Vertex pos, Color color, const char* format,
                                    va_list ap) {
     fragment->count = 0;
-    color.r >>= 3;
-    color.g >>= 3;
-    color.b >>= 3;
-    uint32_t pixel = color.r | (color.g << 5) | (color.b << 10);
-    fragment->prologue.pixel = pixel << 16;
+    fragment->prologue.pixel = glyphPixel(color);
     XPrintfInfo info{fragment, gpu, pos, this};
     vxprintf(
         [](const char* str, int len, void* info_) {
@@ -194,7 +194,7 @@ void psyqo::GPU::initialize(const psyqo::GPU::Configuration &config) {
 }
 
 void psyqo::GPU::checkOTCAndTriggerCallback() {
-    auto &OTCs = m_OTCs[m_parity ^ 1];
+    auto &OTCs = m_OTCs[m_pendingOTCs ^ 1];
     if (!OTCs.empty()) {
         auto &otc = OTCs.front();
         DMA_CTRL[DMA_GPUOTC].MADR = uint32_t(otc.start);
@@ -457,7 +457,10 @@ void psyqo::GPU::sendChain(eastl::function<void()> &&callback, DMA::DmaCallback
     *m_chainTail = m_chainTailCount | 0xffffff;
     Kernel::assert(!m_dmaCallback, "Only one GPU DMA transfer at a time is permitted");
     Kernel::assert((ptr & 3) == 0, "Unaligned DMA transfer");
+    Kernel::assert(m_OTCs[m_pendingOTCs ^ 1].empty(), "Previous ordering tables still being cleared");
     m_chainHead = m_chainTail = nullptr;
+    // The ordering tables chained so far now belong to this transfer.
+    m_pendingOTCs ^= 1;
     m_fromISR = dmaCallback == DMA::FROM_ISR;
     m_dmaCallback = eastl::move(callback);
     uint32_t head = *chainHead;
@@ -579,7 +582,17 @@ void psyqo::GPU::pumpCallbacks() {
     m_lastHSyncCounter = hsyncCounter;
 }
 
-void psyqo::GPU::scheduleOTC(uint32_t *start, uint32_t count) { m_OTCs[m_parity].emplace_back(start, count); }
+void psyqo::GPU::scheduleOTC(uint32_t *start, uint32_t count) { m_OTCs[m_pendingOTCs].emplace_back(start, count); }
+
+void psyqo::GPU::clearOTC(uint32_t *start, uint32_t count, eastl::function<void()> &&callback,
+                          DMA::DmaCallback dmaCallback) {
+    Kernel::assert(!m_dmaCallback, "Only one GPU DMA transfer at a time is permitted");
+    Kernel::assert((DMA_CTRL[DMA_GPUOTC].CHCR & 0x01000000) == 0, "OTC DMA busy");
+    m_fromISR = dmaCallback == DMA::FROM_ISR;
+    m_dmaCallback = eastl::move(callback);
+    m_OTCs[m_pendingOTCs ^ 1].emplace_back(start, count);
+    checkOTCAndTriggerCallback();
+}
 
 extern uint16_t psyqoExceptionHandlerAdjustFrameCount[];
 
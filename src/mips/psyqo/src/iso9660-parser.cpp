@@ -26,6 +26,8 @@ SOFTWARE.
 
 #include "psyqo/iso9660-parser.hh"
 
+#include <EASTL/algorithm.h>
+
 #include "psyqo/kernel.hh"
 #include "psyqo/strings-helpers.hh"
 
@@ -35,6 +37,9 @@ void psyqo::ISO9660Parser::initialize(eastl::function<void(bool success)> callba
     m_cdrom->readSectors(16, 1, m_buffer, [this](bool success) {
         m_cachedLBA = 0;
         m_initialized = false;
+        // The disc may have changed, so everything recorded so far is stale.
+        m_cacheCount = 0;
+        m_cacheLastLBA = 0;
         if (!success) {
             auto callback = eastl::move(m_callback);
             m_callback = nullptr;
@@ -86,6 +91,14 @@ void psyqo::ISO9660Parser::getDirentry(eastl::string_view path, DirEntry* entry,
         path.remove_prefix(1);
     }
 
+    if (m_cache && getCachedDirentry(djb::hash<uint64_t>(path.data(), path.size()), entry)) {
+        auto pos = path.rfind('/');
+        auto name = (pos == eastl::string_view::npos) ? path : path.substr(pos + 1);
+        entry->name.append(name.data(), name.length());
+        callback(true);
+        return;
+    }
+
     eastl::string_view cachedPath = m_cachedPath;
 
     if ((cachedPath.length() > 0) && (cachedPath[0] == '/')) {
@@ -113,6 +126,110 @@ psyqo::TaskQueue::Task psyqo::ISO9660Parser::scheduleGetDirentry(eastl::string_v
         [this](auto task) { getDirentry(m_path, m_dirEntry, [task](bool success) { task->complete(success); }); });
 }
 
+bool psyqo::ISO9660Parser::getCachedDirentry(uint64_t hash, DirEntry* entry) const {
+    const CachedEntry* first = m_cache;
+    const CachedEntry* last = first + m_cacheCount;
+    const CachedEntry* cached =
+        eastl::lower_bound(first, last, hash, [](const CachedEntry& e, uint64_t hash) { return e.hash < hash; });
+    if ((cached == last) || (cached->hash != hash)) {
+        entry->type = DirEntry::INVALID;
+        return false;
+    }
+    entry->LBA = cached->LBA;
+    entry->size = cached->size;
+    entry->name.clear();
+    entry->type = static_cast<decltype(entry->type)>(cached->type);
+    return true;
+}
+
+void psyqo::ISO9660Parser::cacheDirectory(eastl::string_view path, eastl::function<void(bool success)> callback) {
+    if (!m_cache) {
+        callback(false);
+        return;
+    }
+    uint64_t directoryHash = hashDirectory(path);
+    getDirentry(path, &m_cacheDirectory, [this, directoryHash, callback](bool success) {
+        if (!success || (m_cacheDirectory.type != DirEntry::DIRECTORY)) {
+            callback(false);
+            return;
+        }
+        m_cacheDirectoryHash = directoryHash;
+        m_cacheSectorIndex = 0;
+        m_callback = callback;
+        cacheNextSector();
+    });
+}
+
+psyqo::TaskQueue::Task psyqo::ISO9660Parser::scheduleCacheDirectory(eastl::string_view path) {
+    return TaskQueue::Task(
+        [this, path](auto task) { cacheDirectory(path, [task](bool success) { task->complete(success); }); });
+}
+
+void psyqo::ISO9660Parser::cacheNextSector() {
+    if (m_cacheSectorIndex == (m_cacheDirectory.size + 2047) / 2048) {
+        auto callback = eastl::move(m_callback);
+        m_callback = nullptr;
+        callback(true);
+        return;
+    }
+    // The sectors get read into the same buffer as the directory walks use, so the next
+    // lookup will have to start over from the root directory.
+    m_cachedLBA = 0;
+    m_cachedEntry.type = DirEntry::INVALID;
+    m_cachedPath.clear();
+    uint32_t sectorToRead = m_cacheDirectory.LBA + m_cacheSectorIndex;
+    m_cdrom->readSectors(sectorToRead, 1, m_buffer, [this, sectorToRead](bool success) {
+        if (!success) {
+            auto callback = eastl::move(m_callback);
+            m_callback = nullptr;
+            callback(false);
+            return;
+        }
+        m_cacheLastLBA = sectorToRead;
+        cacheSector(m_cacheDirectoryHash);
+        m_cacheSectorIndex++;
+        cacheNextSector();
+    });
+}
+
+uint64_t psyqo::ISO9660Parser::hashDirectory(eastl::string_view path) {
+    if ((path.length() > 0) && (path[0] == '/')) path.remove_prefix(1);
+    if ((path.length() > 0) && (path.back() == '/')) path.remove_suffix(1);
+    // The hash of the empty string, so that the entries of the root directory hash as their bare names.
+    if (path.empty()) return djb::hash<uint64_t>("");
+    return djb::process<uint64_t>(djb::hash<uint64_t>(path.data(), path.size()), "/", 1);
+}
+
+void psyqo::ISO9660Parser::cacheSector(uint64_t directoryHash) {
+    uint32_t offset = 0;
+    while (offset < 2048) {
+        auto entry = &m_buffer[offset];
+        if (entry[0] == 0) break;
+        offset += entry[0];
+        auto name = getEntryName(entry);
+        if ((name == ".") || (name == "..")) continue;
+        cacheEntry(djb::process<uint64_t>(directoryHash, name.data(), name.length()), entry);
+    }
+}
+
+void psyqo::ISO9660Parser::cacheEntry(uint64_t hash, const uint8_t* data) {
+    CachedEntry* first = m_cache;
+    CachedEntry* last = first + m_cacheCount;
+    CachedEntry* cached =
+        eastl::lower_bound(first, last, hash, [](const CachedEntry& e, uint64_t hash) { return e.hash < hash; });
+    if ((cached == last) || (cached->hash != hash)) {
+        if (m_cacheCount == m_cacheCapacity) return;
+        for (CachedEntry* move = last; move != cached; move--) *move = *(move - 1);
+        m_cacheCount++;
+    }
+    DirEntry entry;
+    parseDirEntry(data, &entry);
+    cached->hash = hash;
+    cached->LBA = entry.LBA;
+    cached->size = entry.size;
+    cached->type = entry.type;
+}
+
 psyqo::TaskQueue::Task psyqo::ISO9660Parser::scheduleReadRequest(const ReadRequest* request) {
     return TaskQueue::Task([this, request](auto task) {
         unsigned count = (request->entry.size + 2047) / 2048;
@@ -196,6 +313,11 @@ void psyqo::ISO9660Parser::findDirEntry() {
         return;
     }
 
+    if (m_cache && (m_cachedLBA != m_cacheLastLBA)) {
+        m_cacheLastLBA = m_cachedLBA;
+        cacheSector(hashDirectory(m_cachedPath));
+    }
+
     uint32_t offset = 0;
     while (offset < 2048) {
         auto entry = &m_buffer[offset];
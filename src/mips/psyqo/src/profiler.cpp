@@ -0,0 +1,86 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "psyqo/profiler.hh"
+
+#include "common/hardware/pcsxhw.h"
+#include "psyqo/kernel.hh"
+
+void psyqo::Profiler::initialize(Clock clock) {
+    m_clock = clock;
+    // Counter 2, source set to the system clock divided by 8, free running.
+    if (clock == Clock::SysClockDiv8) COUNTERS[2].mode = 0x200;
+    reset();
+}
+
+unsigned psyqo::Profiler::registerScope(const char* name) {
+    Kernel::assert(m_scopes < c_maxScopes, "Profiler: too many scopes");
+    unsigned id = m_scopes++;
+    m_stats[id].name = name;
+    return id;
+}
+
+void psyqo::Profiler::record(unsigned id, uint32_t ticks) {
+    auto& stats = m_stats[id];
+    stats.count++;
+    stats.total += ticks;
+    if (ticks < stats.min) stats.min = ticks;
+    if (ticks > stats.max) stats.max = ticks;
+    unsigned bucket = ticks == 0 ? 0 : 32 - __builtin_clz(ticks);
+    if (bucket >= c_histogramBuckets) bucket = c_histogramBuckets - 1;
+    if (stats.histogram[bucket] != 0xffff) stats.histogram[bucket]++;
+}
+
+void psyqo::Profiler::reset() {
+    for (auto& stats : m_stats) {
+        stats.count = 0;
+        stats.total = 0;
+        stats.min = 0xffffffff;
+        stats.max = 0;
+        for (auto& bucket : stats.histogram) bucket = 0;
+    }
+}
+
+void psyqo::Profiler::render(GPU& gpu, FontBase& font, Vertex pos, Color color) {
+    for (unsigned i = 0; i < m_scopes; i++) {
+        auto& stats = m_stats[i];
+        if (stats.count == 0) {
+            font.printf(gpu, pos, color, "%s: -", stats.name);
+        } else {
+            font.printf(gpu, pos, color, "%s: %u/%u/%u", stats.name, stats.min, stats.total / stats.count,
+                        stats.max);
+        }
+        pos.y += 16;
+    }
+}
+
+void psyqo::Profiler::report(uint8_t slot) {
+    if (!pcsx_present()) return;
+    register Stats* a0 asm("a0") = m_stats.data();
+    register unsigned a1 asm("a1") = m_scopes;
+    register uint32_t a2 asm("a2") = cyclesPerTick();
+    __asm__ volatile("sb %0, 0x2081(%1)" : : "r"(slot), "r"(0x1f800000), "r"(a0), "r"(a1), "r"(a2) : "memory");
+}
@@ -0,0 +1,105 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "psyqo/scheduler.hh"
+
+#include "common/hardware/counters.h"
+#include "psyqo/kernel.hh"
+
+void psyqo::Scheduler::spawn(Coroutine<> &coroutine, uint8_t priority) {
+    for (auto &entry : m_entries) {
+        if (entry.coroutine) continue;
+        entry.coroutine = &coroutine;
+        entry.resumePoint = nullptr;
+        entry.lastRun = 0;
+        entry.priority = priority;
+        entry.ready = true;
+        entry.started = false;
+        return;
+    }
+    Kernel::abort("Scheduler: too many tasks");
+}
+
+void psyqo::Scheduler::yieldInternal(std::coroutine_handle<> handle) {
+    Entry *current = m_current;
+    if (!current) {
+        // The task was resumed by something else than the scheduler,
+        // such as a CD-ROM read completion. Find it back from its frame.
+        void *address = handle.address();
+        for (auto &entry : m_entries) {
+            if (entry.coroutine && entry.coroutine->m_handle.address() == address) {
+                current = &entry;
+                break;
+            }
+        }
+        Kernel::assert(current != nullptr, "Scheduler: yield from an unknown task");
+    }
+    current->resumePoint = handle;
+    current->ready = true;
+}
+
+unsigned psyqo::Scheduler::run(uint16_t budget) {
+    uint16_t start = COUNTERS[1].value;
+    while (true) {
+        Entry *best = nullptr;
+        for (auto &entry : m_entries) {
+            if (!entry.coroutine) continue;
+            if (entry.coroutine->done()) {
+                entry.coroutine = nullptr;
+                continue;
+            }
+            if (!entry.ready) continue;
+            if (!best || (entry.priority > best->priority) ||
+                ((entry.priority == best->priority) && (entry.lastRun < best->lastRun))) {
+                best = &entry;
+            }
+        }
+        if (!best) break;
+        if (uint16_t(COUNTERS[1].value - start) >= budget) break;
+
+        best->ready = false;
+        best->lastRun = ++m_tick;
+        m_current = best;
+        if (best->started) {
+            best->resumePoint.resume();
+        } else {
+            best->started = true;
+            best->coroutine->resume();
+        }
+        m_current = nullptr;
+    }
+    return count();
+}
+
+unsigned psyqo::Scheduler::count() const {
+    unsigned count = 0;
+    for (auto &entry : m_entries) {
+        if (!entry.coroutine) continue;
+        auto &handle = entry.coroutine->m_handle;
+        if (handle && !handle.done()) count++;
+    }
+    return count;
+}
@@ -0,0 +1,216 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <EASTL/algorithm.h>
+
+#include "common/hardware/dma.h"
+#include "common/hardware/irq.h"
+#include "common/hardware/spu.h"
+#include "common/kernel/events.h"
+#include "common/syscalls/syscalls.h"
+#include "psyqo/cdrom-device.hh"
+#include "psyqo/kernel.hh"
+#include "psyqo/spu.hh"
+
+namespace {
+
+psyqo::SPU::Stream* s_current = nullptr;
+bool s_prepared = false;
+
+enum : uint8_t {
+    ADPCM_LOOP_END = 0x01,
+    ADPCM_LOOP_REPEAT = 0x02,
+    ADPCM_LOOP_START = 0x04,
+};
+
+constexpr uint16_t SPU_CTRL_IRQ_ENABLE = 0x0040;
+
+void dmaWrite(uint32_t spuAddress, const uint8_t* data, uint32_t size) {
+    SPU_RAM_DTA = spuAddress >> 3;
+    SPU_CTRL = (SPU_CTRL & ~0x0030) | 0x0020;
+    while ((SPU_CTRL & 0x0030) != 0x0020);
+    DMA_CTRL[DMA_SPU].MADR = reinterpret_cast<uintptr_t>(data);
+    DMA_CTRL[DMA_SPU].BCR = ((size / 64) << 16) | 0x10;
+    DMA_CTRL[DMA_SPU].CHCR = 0x01000201;
+}
+
+}  // namespace
+
+void psyqo::SPU::Stream::prepare() {
+    if (s_prepared) return;
+    s_prepared = true;
+    IMASK = IMASK | IRQ_SPU;
+    Kernel::enableDma(Kernel::DMA::SPU);
+    Kernel::registerDmaEvent(Kernel::DMA::SPU, []() {
+        if (s_current) Kernel::queueCallbackFromISR([]() { s_current->uploaded(); });
+    });
+    eastl::function<void()> callback = []() {
+        IREG = ~IRQ_SPU;
+        if (s_current) s_current->irq();
+    };
+    if (Kernel::isKernelTakenOver()) {
+        Kernel::queueIRQHandler(Kernel::IRQ::SPU, eastl::move(callback));
+    } else {
+        uint32_t event = Kernel::openEvent(EVENT_SPU, 0x1000, EVENT_MODE_CALLBACK, eastl::move(callback));
+        syscall_enableEvent(event);
+    }
+}
+
+void psyqo::SPU::Stream::start(CDRomDevice& cdrom, uint32_t sector, uint32_t sectorCount, void* ring,
+                               unsigned ringSectors, const Config& config, eastl::function<void(bool)>&& callback) {
+    Kernel::assert(s_current == nullptr, "SPU::Stream::start() called while a stream is already playing");
+    Kernel::assert(sectorCount != 0, "SPU::Stream::start() called with no data");
+    Kernel::assert(config.chunkSectors != 0, "SPU::Stream::start() called with empty chunks");
+    Kernel::assert((ringSectors % config.chunkSectors) == 0 && (ringSectors >= config.chunkSectors * 2),
+                   "SPU::Stream::start() called with a ring which doesn't fit two chunks");
+    Kernel::assert((config.spuAddress & 7) == 0, "SPU::Stream::start() called with a misaligned SPU address");
+    Kernel::assert((config.spuAddress + config.chunkSectors * 2048 * 2) <= 512 * 1024,
+                   "SPU::Stream::start() called with a ring which doesn't fit in SPU RAM");
+    prepare();
+    s_current = this;
+    m_cdrom = &cdrom;
+    m_callback = eastl::move(callback);
+    m_config = config;
+    m_remaining = sectorCount;
+    m_underruns = 0;
+    m_priming = true;
+    m_draining = false;
+    keyOff();
+    SPU_CTRL = SPU_CTRL & ~SPU_CTRL_IRQ_ENABLE;
+    cdrom.startStream(sector, ring, ringSectors, [this](bool success) { streamStopped(success); });
+    cdrom.waitStream(m_config.chunkSectors, [this](bool ready) {
+        if (ready) upload(0);
+    });
+}
+
+void psyqo::SPU::Stream::stop() {
+    // This also silences the voice if it's still playing the last chunk.
+    keyOff();
+    SPU_CTRL = SPU_CTRL & ~SPU_CTRL_IRQ_ENABLE;
+    if (m_cdrom) m_cdrom->stopStream();
+}
+
+void psyqo::SPU::Stream::upload(unsigned half) {
+    auto chunkSectors = m_config.chunkSectors;
+    uint32_t size = chunkSectors * 2048;
+    // The stream only ever releases whole chunks, and the ring is a multiple of
+    // the chunk size, so a chunk is always contiguous in the ring.
+    auto data = const_cast<uint8_t*>(m_cdrom->streamData());
+    for (uint32_t offset = 1; offset < size; offset += 16) data[offset] = 0;
+    if (half == 0) {
+        data[1] = ADPCM_LOOP_START;
+    } else {
+        data[size - 15] = ADPCM_LOOP_END | ADPCM_LOOP_REPEAT;
+    }
+    if (m_remaining <= chunkSectors) {
+        // Last chunk: let the voice stop on its own at the end of the data.
+        data[m_remaining * 2048 - 15] = ADPCM_LOOP_END;
+        m_draining = true;
+    }
+    m_remaining -= eastl::min(m_remaining, uint32_t(chunkSectors));
+    m_uploading = half;
+    dmaWrite(m_config.spuAddress + half * size, data, size);
+}
+
+void psyqo::SPU::Stream::uploaded() {
+    if (!m_cdrom) return;
+    m_cdrom->streamRelease(m_config.chunkSectors);
+    if (m_draining) {
+        if (m_priming) keyOn();
+        m_priming = false;
+        m_cdrom->stopStream();
+        return;
+    }
+    if (m_priming && (m_uploading == 0)) {
+        m_cdrom->waitStream(m_config.chunkSectors, [this](bool ready) {
+            if (ready) upload(1);
+        });
+        return;
+    }
+    if (m_priming) {
+        m_priming = false;
+        keyOn();
+    }
+    // The SPU IRQ is disabled from the moment it fires until here, so the DMA
+    // writing into the half which is about to be watched can't trigger it,
+    // and the IRQ handler never races with this read-modify-write.
+    SPU_IRQ_ADDR = (m_config.spuAddress + m_uploading * m_config.chunkSectors * 2048) >> 3;
+    SPU_CTRL = SPU_CTRL | SPU_CTRL_IRQ_ENABLE;
+}
+
+void psyqo::SPU::Stream::irq() {
+    SPU_CTRL = SPU_CTRL & ~SPU_CTRL_IRQ_ENABLE;
+    Kernel::queueCallbackFromISR([this]() { refill(); });
+}
+
+void psyqo::SPU::Stream::refill() {
+    if (!m_cdrom) return;
+    // The voice just entered the half we last refilled, so the other one is free.
+    unsigned half = m_uploading ^ 1;
+    if (m_cdrom->streamAvailable() >= m_config.chunkSectors) {
+        upload(half);
+        return;
+    }
+    m_underruns++;
+    m_cdrom->waitStream(m_config.chunkSectors, [this, half](bool ready) {
+        if (ready) upload(half);
+    });
+}
+
+void psyqo::SPU::Stream::streamStopped(bool success) {
+    // When draining, the voice still has the last chunk to play.
+    if (!success || !m_draining) keyOff();
+    SPU_CTRL = SPU_CTRL & ~SPU_CTRL_IRQ_ENABLE;
+    m_cdrom = nullptr;
+    s_current = nullptr;
+    auto callback = eastl::move(m_callback);
+    m_callback = nullptr;
+    if (callback) callback(success);
+}
+
+void psyqo::SPU::Stream::keyOn() {
+    auto& voice = SPU_VOICES[m_config.voice];
+    voice.volumeLeft = m_config.volumeLeft;
+    voice.volumeRight = m_config.volumeRight;
+    voice.sampleRate = m_config.sampleRate;
+    voice.sampleStartAddr = m_config.spuAddress >> 3;
+    voice.sampleRepeatAddr = m_config.spuAddress >> 3;
+    voice.ad = 0x000f;
+    voice.sr = 0x0000;
+    if (m_config.voice < 16) {
+        SPU_KEY_ON_LOW = 1 << m_config.voice;
+    } else {
+        SPU_KEY_ON_HIGH = 1 << (m_config.voice - 16);
+    }
+}
+
+void psyqo::SPU::Stream::keyOff() {
+    if (m_config.voice < 16) {
+        SPU_KEY_OFF_LOW = 1 << m_config.voice;
+    } else {
+        SPU_KEY_OFF_HIGH = 1 << (m_config.voice - 16);
+    }
+}
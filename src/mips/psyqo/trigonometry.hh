@@ -35,7 +35,39 @@ namespace psyqo {
 
 namespace TrigInternals {
 
-void generateTable(eastl::array<int32_t, 512>& table, unsigned precisionBits);
+// This is a table generator for cos(n * 2pi / 2048) * 2^24
+// The table is 512 entries long, from cos(0) to cos(pi/2).
+// The table is generated by the following recurrence relation:
+// f(n) = cos(n * 2pi / 2048)
+// f(n) = 2 * f(1) * f(n - 1) - f(n - 2)
+// It is constexpr so that a constexpr Trig object gets its table
+// computed by the compiler and placed in read-only data.
+constexpr void generateTable(eastl::array<int32_t, 512>& table, unsigned precisionBits) {
+    // 2^24 * cos(0 * 2pi / 2048)
+    table[0] = 16777216;
+    // 2^24 * cos(1 * 2pi / 2048) = C = f(1)
+    constexpr int64_t C = 16777137;
+    table[1] = C;
+
+    for (int i = 2; i < 511; i++) {
+        table[i] = ((C * table[i - 1]) >> 23) - table[i - 2];
+    }
+
+    // The approximation is a bit too steep, so this value would otherwise
+    // get slightly negative
+    table[511] = 0;
+
+    // Adjusts the precision of the table
+    if (precisionBits > 24) {
+        for (int i = 0; i < 512; i++) {
+            table[i] <<= (precisionBits - 24);
+        }
+    } else if (precisionBits < 24) {
+        for (int i = 0; i < 512; i++) {
+            table[i] >>= (24 - precisionBits);
+        }
+    }
+}
 
 }
 
@@ -67,13 +99,18 @@ consteval Angle operator""_pi(long double angle) { return angle; }
  * template parameter that specifies the number of bits of
  * precision to use for the table. The default is 12 bits.
  *
+ * The constructor is constexpr, so declaring the object as
+ * `static constexpr psyqo::Trig<> trig;` will have the compiler
+ * compute the table, and store it in read-only data, instead of
+ * generating it at runtime into a 2kB block of RAM.
+ *
  * @tparam precisionBits The number of bits of precision to use
  * for the FixedPoint values in the table.
  */
 template <unsigned precisionBits = 12>
 class Trig {
   public:
-    Trig() { TrigInternals::generateTable(table, precisionBits); }
+    constexpr Trig() { TrigInternals::generateTable(table, precisionBits); }
 
     /**
      * @brief Calculate the cosine of an angle.
@@ -116,7 +153,7 @@ class Trig {
     }
 
   private:
-    eastl::array<int32_t, 512> table;
+    eastl::array<int32_t, 512> table = {};
 };
 
 }  // namespace psyqo
@@ -0,0 +1,192 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "compressors.h"
+
+#define HASH_BITS 12
+
+static uint16_t s_hashTable[1 << HASH_BITS];
+
+static uint32_t read32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+static unsigned hash4(const uint8_t* p) { return (read32(p) * 2654435761u) >> (32 - HASH_BITS); }
+
+static unsigned hash3(const uint8_t* p) { return ((read32(p) & 0xffffff) * 2654435761u) >> (32 - HASH_BITS); }
+
+static void resetHashTable(void) {
+    for (unsigned i = 0; i < (1 << HASH_BITS); i++) s_hashTable[i] = 0;
+}
+
+static uint8_t* lz4Length(uint8_t* op, uint32_t length) {
+    for (length -= 15; length >= 255; length -= 255) *op++ = 255;
+    *op++ = length;
+    return op;
+}
+
+static uint8_t* lz4Sequence(uint8_t* op, const uint8_t* literals, uint32_t literalCount, uint32_t offset,
+                            uint32_t matchLength) {
+    uint8_t* token = op++;
+    *token = (literalCount < 15 ? literalCount : 15) << 4;
+    if (literalCount >= 15) op = lz4Length(op, literalCount);
+    for (uint32_t i = 0; i < literalCount; i++) *op++ = literals[i];
+    if (matchLength == 0) return op;
+    *op++ = offset;
+    *op++ = offset >> 8;
+    matchLength -= 4;
+    *token |= matchLength < 15 ? matchLength : 15;
+    if (matchLength >= 15) op = lz4Length(op, matchLength);
+    return op;
+}
+
+uint32_t test_lz4_compress(const uint8_t* in, uint32_t size, uint8_t* out) {
+    uint8_t* op = out;
+    uint32_t anchor = 0;
+    uint32_t i = 0;
+    // The format wants the last match to start 12 bytes before the end,
+    // and the last 5 bytes to be literals.
+    uint32_t matchLimit = size > 12 ? size - 12 : 0;
+    resetHashTable();
+    while (i < matchLimit) {
+        unsigned h = hash4(in + i);
+        uint32_t candidate = s_hashTable[h];
+        s_hashTable[h] = i + 1;
+        if (candidate && (read32(in + candidate - 1) == read32(in + i))) {
+            uint32_t ref = candidate - 1;
+            uint32_t length = 4;
+            while ((i + length < size - 5) && (in[ref + length] == in[i + length])) length++;
+            op = lz4Sequence(op, in + anchor, i - anchor, i - ref, length);
+            i += length;
+            anchor = i;
+        } else {
+            i++;
+        }
+    }
+    return lz4Sequence(op, in + anchor, size - anchor, 0, 0) - out;
+}
+
+struct BitWriter {
+    uint8_t* out;
+    uint8_t* bits;
+    unsigned count;
+};
+
+static void putBit(struct BitWriter* w, unsigned bit) {
+    if (w->count == 8) {
+        w->bits = w->out++;
+        *w->bits = 0;
+        w->count = 0;
+    }
+    *w->bits |= bit << (7 - w->count++);
+}
+
+static void putByte(struct BitWriter* w, uint8_t byte) { *w->out++ = byte; }
+
+// The offset prefix, for values of 2 and above, as read by the decompressor's m_off loop.
+static void putOffsetPrefix(struct BitWriter* w, uint32_t value) {
+    uint8_t bits[96];
+    unsigned count = 0;
+    bits[count++] = 1;
+    bits[count++] = value & 1;
+    for (uint32_t u = value >> 1; u != 1;) {
+        uint32_t previous = (u >> 1) + 1;
+        bits[count++] = u & 1;
+        bits[count++] = 0;
+        bits[count++] = previous & 1;
+        u = previous >> 1;
+    }
+    while (count) putBit(w, bits[--count]);
+}
+
+// The length prefix, for values of 2 and above, as read by the decompressor's long length loop.
+static void putLengthPrefix(struct BitWriter* w, uint32_t value) {
+    int top = 31;
+    while (!(value & (1u << top))) top--;
+    for (int i = top - 1; i >= 0; i--) {
+        putBit(w, (value >> i) & 1);
+        putBit(w, i == 0);
+    }
+}
+
+uint32_t test_n2e_compress(const uint8_t* in, uint32_t size, uint8_t* out) {
+    struct BitWriter w = {out, out, 8};
+    uint32_t lastOffset = 1;
+    uint32_t i = 0;
+    resetHashTable();
+    while (i < size) {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        if (i + 4 <= size) {
+            unsigned h = hash3(in + i);
+            uint32_t candidate = s_hashTable[h];
+            s_hashTable[h] = i + 1;
+            if (candidate) {
+                uint32_t ref = candidate - 1;
+                while ((i + length < size) && (in[ref + length] == in[i + length])) length++;
+                offset = i - ref;
+            }
+        }
+        if ((length < 3) && (i >= lastOffset) && (i + 2 <= size)) {
+            uint32_t repeated = 0;
+            while ((i + repeated < size) && (in[i - lastOffset + repeated] == in[i + repeated])) repeated++;
+            if (repeated >= 2) {
+                offset = lastOffset;
+                length = repeated;
+            }
+        }
+        if ((length < 2) || ((length < 3) && (offset > 0x500))) {
+            putBit(&w, 1);
+            putByte(&w, in[i++]);
+            continue;
+        }
+        uint32_t adjusted = length + (offset <= 0x500);
+        unsigned shortLength = adjusted <= 4;
+        putBit(&w, 0);
+        if (offset == lastOffset) {
+            putOffsetPrefix(&w, 2);
+            putBit(&w, shortLength);
+        } else {
+            uint32_t x = ((offset - 1) << 1) | !shortLength;
+            putOffsetPrefix(&w, (x >> 8) + 3);
+            putByte(&w, x);
+            lastOffset = offset;
+        }
+        if (shortLength) {
+            putBit(&w, adjusted - 3);
+        } else if (adjusted <= 6) {
+            putBit(&w, 1);
+            putBit(&w, adjusted - 5);
+        } else {
+            putBit(&w, 0);
+            putLengthPrefix(&w, adjusted - 5);
+        }
+        i += length;
+    }
+    // The end marker is an offset of 0xffffffff.
+    putBit(&w, 0);
+    putOffsetPrefix(&w, 0x1000002);
+    putByte(&w, 0xff);
+    return w.out - out;
+}
@@ -0,0 +1,40 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/* Minimal greedy compressors, only there to produce test data for the
+   decompressors on the target itself. They are neither fast nor good. */
+
+/* Compresses `size` bytes, less than 64kB, into a raw lz4 block.
+   Returns the compressed size. */
+uint32_t test_lz4_compress(const uint8_t* in, uint32_t size, uint8_t* out);
+
+/* Compresses `size` bytes, less than 64kB, into an 8-bit NRV2E stream.
+   Returns the compressed size. */
+uint32_t test_n2e_compress(const uint8_t* in, uint32_t size, uint8_t* out);
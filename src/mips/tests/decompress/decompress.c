@@ -0,0 +1,150 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/hardware/counters.h"
+#include "common/syscalls/syscalls.h"
+#include "compressors.h"
+#include "lz4/lz4.h"
+#include "ucl-demo/n2e-d.h"
+
+#undef unix
+#define CESTER_NO_SIGNAL
+#define CESTER_NO_TIME
+#define EXIT_SUCCESS 0
+#define EXIT_FAILURE 1
+#include "exotic/cester.h"
+
+// clang-format off
+
+/* This tests the lz4 and n2e decompressors, against data compressed on the spot. */
+
+CESTER_BODY(
+    #define DATA_SIZE 8192
+    // In-place decompression needs a bit of room after the decompressed data.
+    #define BUFFER_SIZE (DATA_SIZE + DATA_SIZE / 8 + 64)
+
+    static uint8_t s_original[DATA_SIZE];
+    static uint8_t s_compressed[BUFFER_SIZE];
+    static uint8_t s_buffer[BUFFER_SIZE] __attribute__((aligned(4)));
+    static uint32_t s_seed;
+
+    static uint32_t nextRandom() {
+        s_seed = s_seed * 1103515245 + 12345;
+        return s_seed >> 16;
+    }
+
+    // Words picked out of a small dictionary, which compresses roughly like text.
+    static void generateText() {
+        static const char * const words[] = {
+            "the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog ", "and ", "runs ",
+            "away ", "from ", "a ", "playstation ", "while ", "it ", "decompresses ", "data.\n",
+        };
+        s_seed = 12345;
+        unsigned i = 0;
+        while (i < DATA_SIZE) {
+            const char * word = words[nextRandom() % (sizeof(words) / sizeof(words[0]))];
+            while (*word && (i < DATA_SIZE)) s_original[i++] = *word++;
+        }
+    }
+
+    // Mostly incompressible, with a few runs thrown in for overlapping back references.
+    static void generateRandom() {
+        s_seed = 54321;
+        unsigned i = 0;
+        while (i < DATA_SIZE) {
+            uint32_t r = nextRandom();
+            if ((r & 15) == 0) {
+                unsigned count = (r >> 4) & 31;
+                uint8_t value = r >> 9;
+                while (count-- && (i < DATA_SIZE)) s_original[i++] = value;
+            } else {
+                s_original[i++] = r;
+            }
+        }
+    }
+
+    static int matches(const uint8_t * data) {
+        for (unsigned i = 0; i < DATA_SIZE; i++) {
+            if (data[i] != s_original[i]) return 0;
+        }
+        return 1;
+    }
+
+    static void startTimer() {
+        // Root counter 2, counting the system clock divided by 8.
+        COUNTERS[2].mode = 0x200;
+    }
+
+    static int checkLZ4(const char * name, int inPlace) {
+        uint32_t size = test_lz4_compress(s_original, DATA_SIZE, s_compressed);
+        uint8_t * source = inPlace ? s_buffer + BUFFER_SIZE - size : s_compressed;
+        for (unsigned i = 0; i < size; i++) source[i] = s_compressed[i];
+        startTimer();
+        uint16_t start = COUNTERS[2].value;
+        lz4_decompress_block(source, source + size, s_buffer);
+        uint16_t ticks = COUNTERS[2].value - start;
+        ramsyscall_printf("lz4 %s%s: %d bytes, %d cycles per byte\n", name, inPlace ? " in place" : "", size,
+                          ticks * 8 / DATA_SIZE);
+        return matches(s_buffer);
+    }
+
+    static int checkN2E(const char * name, int inPlace) {
+        uint32_t size = test_n2e_compress(s_original, DATA_SIZE, s_compressed);
+        uint8_t * source = inPlace ? s_buffer + BUFFER_SIZE - size : s_compressed;
+        for (unsigned i = 0; i < size; i++) source[i] = s_compressed[i];
+        startTimer();
+        uint16_t start = COUNTERS[2].value;
+        n2e_decompress(source, s_buffer);
+        uint16_t ticks = COUNTERS[2].value - start;
+        ramsyscall_printf("n2e %s%s: %d bytes, %d cycles per byte\n", name, inPlace ? " in place" : "", size,
+                          ticks * 8 / DATA_SIZE);
+        return matches(s_buffer);
+    }
+)
+
+CESTER_TEST(lz4Text, test_instance,
+    generateText();
+    cester_assert_true(checkLZ4("text", 0));
+    cester_assert_true(checkLZ4("text", 1));
+)
+
+CESTER_TEST(lz4Random, test_instance,
+    generateRandom();
+    cester_assert_true(checkLZ4("random", 0));
+    cester_assert_true(checkLZ4("random", 1));
+)
+
+CESTER_TEST(n2eText, test_instance,
+    generateText();
+    cester_assert_true(checkN2E("text", 0));
+    cester_assert_true(checkN2E("text", 1));
+)
+
+CESTER_TEST(n2eRandom, test_instance,
+    generateRandom();
+    cester_assert_true(checkN2E("random", 0));
+    cester_assert_true(checkN2E("random", 1));
+)
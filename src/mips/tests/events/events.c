@@ -0,0 +1,133 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/hardware/counters.h"
+#include "common/kernel/events.h"
+#include "common/syscalls/syscalls.h"
+
+#undef unix
+#define CESTER_NO_SIGNAL
+#define CESTER_NO_TIME
+#define EXIT_SUCCESS 0
+#define EXIT_FAILURE 1
+#include "exotic/cester.h"
+
+// clang-format off
+
+/* This tests the bios events delivery, and how its cost scales with the number of opened events. */
+
+CESTER_BODY(
+    #define TEST_CLASS 0xf5000000
+    #define FILLER_CLASS 0xf6000000
+    #define MAX_FILLERS 32
+
+    static int s_order[8];
+    static int s_orderCount;
+    static void callback0() { s_order[s_orderCount++] = 0; }
+    static void callback1() { s_order[s_orderCount++] = 1; }
+    static void callback2() { s_order[s_orderCount++] = 2; }
+
+    static uint32_t measureDeliveries(uint32_t class, uint32_t spec) {
+        // Root counter 2, counting the system clock divided by 8.
+        COUNTERS[2].mode = 0x200;
+        uint16_t start = COUNTERS[2].value;
+        for (unsigned i = 0; i < 64; i++) syscall_deliverEvent(class, spec);
+        uint16_t end = COUNTERS[2].value;
+        return ((uint16_t)(end - start)) * 8 / 64;
+    }
+)
+
+CESTER_TEST(eventNoCallback, test_instance,
+    uint32_t event = syscall_openEvent(TEST_CLASS, 0x10, EVENT_MODE_NO_CALLBACK, NULL);
+    cester_assert_uint_ne(event, 0xffffffff);
+    syscall_enableEvent(event);
+    cester_assert_int_eq(syscall_testEvent(event), 0);
+    syscall_deliverEvent(TEST_CLASS, 0x20);
+    cester_assert_int_eq(syscall_testEvent(event), 0);
+    syscall_deliverEvent(TEST_CLASS, 0x10);
+    cester_assert_int_eq(syscall_testEvent(event), 1);
+    cester_assert_int_eq(syscall_testEvent(event), 0);
+    syscall_deliverEvent(TEST_CLASS, 0x10);
+    syscall_undeliverEvent(TEST_CLASS, 0x10);
+    cester_assert_int_eq(syscall_testEvent(event), 0);
+    syscall_closeEvent(event);
+)
+
+CESTER_TEST(eventCallbackOrder, test_instance,
+    uint32_t events[3];
+    events[0] = syscall_openEvent(TEST_CLASS, 0x10, EVENT_MODE_CALLBACK, callback0);
+    events[1] = syscall_openEvent(TEST_CLASS, 0x10, EVENT_MODE_CALLBACK, callback1);
+    events[2] = syscall_openEvent(TEST_CLASS, 0x10, EVENT_MODE_CALLBACK, callback2);
+    for (unsigned i = 0; i < 3; i++) {
+        cester_assert_uint_ne(events[i], 0xffffffff);
+        syscall_enableEvent(events[i]);
+    }
+    // Callbacks are called in the order of the EvCB slots.
+    s_orderCount = 0;
+    syscall_deliverEvent(TEST_CLASS, 0x10);
+    cester_assert_int_eq(s_orderCount, 3);
+    cester_assert_int_eq(s_order[0], 0);
+    cester_assert_int_eq(s_order[1], 1);
+    cester_assert_int_eq(s_order[2], 2);
+
+    // Closing and reopening reuses the same slot, and keeps the order.
+    syscall_closeEvent(events[1]);
+    s_orderCount = 0;
+    syscall_deliverEvent(TEST_CLASS, 0x10);
+    cester_assert_int_eq(s_orderCount, 2);
+    cester_assert_int_eq(s_order[0], 0);
+    cester_assert_int_eq(s_order[1], 2);
+    uint32_t reopened = syscall_openEvent(TEST_CLASS, 0x10, EVENT_MODE_CALLBACK, callback1);
+    cester_assert_uint_eq(reopened, events[1]);
+    syscall_enableEvent(reopened);
+    s_orderCount = 0;
+    syscall_deliverEvent(TEST_CLASS, 0x10);
+    cester_assert_int_eq(s_orderCount, 3);
+    cester_assert_int_eq(s_order[0], 0);
+    cester_assert_int_eq(s_order[1], 1);
+    cester_assert_int_eq(s_order[2], 2);
+
+    for (unsigned i = 0; i < 3; i++) syscall_closeEvent(events[i]);
+)
+
+CESTER_TEST(eventDeliveryCost, test_instance,
+    uint32_t fillers[MAX_FILLERS];
+    unsigned count = 0;
+    uint32_t before = measureDeliveries(TEST_CLASS, 0x10);
+    while (count < MAX_FILLERS) {
+        uint32_t event = syscall_openEvent(FILLER_CLASS + count, 0x10, EVENT_MODE_NO_CALLBACK, NULL);
+        if (event == 0xffffffff) break;
+        syscall_enableEvent(event);
+        fillers[count++] = event;
+    }
+    uint32_t after = measureDeliveries(TEST_CLASS, 0x10);
+    for (unsigned i = 0; i < count; i++) syscall_closeEvent(fillers[i]);
+    ramsyscall_printf("deliverEvent: %d cycles, %d cycles with %d unrelated events\n", before, after, count);
+    // Scanning all of the EvCBs costs at least 8 cycles per enabled event,
+    // while unrelated events only cost something when they share a bucket.
+    cester_assert_true(count >= 4);
+    cester_assert_true(after < (before + count * 4));
+)
@@ -0,0 +1,167 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/hardware/counters.h"
+#include "common/syscalls/syscalls.h"
+
+#undef unix
+#define CESTER_NO_SIGNAL
+#define CESTER_NO_TIME
+#define EXIT_SUCCESS 0
+#define EXIT_FAILURE 1
+#include "exotic/cester.h"
+
+// clang-format off
+
+/* This tests the bios user heap, going through the A0 table the same way games do. */
+
+CESTER_BODY(
+    static uint8_t s_heap[256 * 1024] __attribute__((aligned(8)));
+
+    static void * biosMalloc(size_t size) {
+        register int n asm("t1") = 0x33;
+        __asm__ volatile("" : "=r"(n) : "r"(n));
+        return ((void * (*)(size_t))0xa0)(size);
+    }
+    static void biosFree(void * ptr) {
+        register int n asm("t1") = 0x34;
+        __asm__ volatile("" : "=r"(n) : "r"(n));
+        ((void (*)(void *))0xa0)(ptr);
+    }
+    static void * biosRealloc(void * ptr, size_t size) {
+        register int n asm("t1") = 0x38;
+        __asm__ volatile("" : "=r"(n) : "r"(n));
+        return ((void * (*)(void *, size_t))0xa0)(ptr, size);
+    }
+    static void biosInitHeap(void * base, size_t size) {
+        register int n asm("t1") = 0x39;
+        __asm__ volatile("" : "=r"(n) : "r"(n));
+        ((void (*)(void *, size_t))0xa0)(base, size);
+    }
+    static int inHeap(void * ptr, size_t size) {
+        uint8_t * p = (uint8_t *)ptr;
+        return (p >= s_heap) && ((p + size) <= (s_heap + sizeof(s_heap)));
+    }
+)
+
+CESTER_TEST(heapBasic, test_instance,
+    biosInitHeap(s_heap, sizeof(s_heap));
+    uint8_t * a = biosMalloc(100);
+    uint8_t * b = biosMalloc(100);
+    cester_assert_not_null(a);
+    cester_assert_not_null(b);
+    cester_assert_true(inHeap(a, 100));
+    cester_assert_true(inHeap(b, 100));
+    cester_assert_uint_eq(((uintptr_t)a) & 7, 0);
+    cester_assert_true((a + 100 <= b) || (b + 100 <= a));
+    biosFree(a);
+    biosFree(b);
+)
+
+CESTER_TEST(heapExhaustion, test_instance,
+    biosInitHeap(s_heap, sizeof(s_heap));
+    cester_assert_null(biosMalloc(sizeof(s_heap)));
+    uint8_t * a = biosMalloc(sizeof(s_heap) / 2);
+    cester_assert_not_null(a);
+    cester_assert_null(biosMalloc(sizeof(s_heap) / 2));
+    biosFree(a);
+)
+
+CESTER_TEST(heapCoalescing, test_instance,
+    biosInitHeap(s_heap, sizeof(s_heap));
+    void * ptrs[64];
+    for (unsigned i = 0; i < 64; i++) {
+        ptrs[i] = biosMalloc(1000 + i * 8);
+        cester_assert_not_null(ptrs[i]);
+    }
+    // Freeing in an interleaved order, so that blocks get merged
+    // both with their previous and their next neighbours.
+    for (unsigned i = 0; i < 64; i += 2) biosFree(ptrs[i]);
+    for (unsigned i = 1; i < 64; i += 2) biosFree(ptrs[i]);
+    // The whole heap should be available as a single block again.
+    void * big = biosMalloc(sizeof(s_heap) - 64);
+    cester_assert_not_null(big);
+    biosFree(big);
+)
+
+CESTER_TEST(heapRealloc, test_instance,
+    biosInitHeap(s_heap, sizeof(s_heap));
+    uint8_t * a = biosMalloc(64);
+    cester_assert_not_null(a);
+    for (unsigned i = 0; i < 64; i++) a[i] = i;
+    // Growing in place, since the rest of the heap is free.
+    uint8_t * b = biosRealloc(a, 4096);
+    cester_assert_ptr_equal(a, b);
+    // Growing with a move, since c is in the way.
+    uint8_t * c = biosMalloc(16);
+    cester_assert_not_null(c);
+    uint8_t * d = biosRealloc(b, 8192);
+    cester_assert_not_null(d);
+    cester_assert_ptr_not_equal(b, d);
+    for (unsigned i = 0; i < 64; i++) cester_assert_uint_eq(d[i], i);
+    // Shrinking always happens in place.
+    uint8_t * e = biosRealloc(d, 32);
+    cester_assert_ptr_equal(d, e);
+    for (unsigned i = 0; i < 32; i++) cester_assert_uint_eq(e[i], i);
+    cester_assert_null(biosRealloc(e, 0));
+    biosFree(c);
+)
+
+CESTER_TEST(heapInitResets, test_instance,
+    biosInitHeap(s_heap, sizeof(s_heap));
+    for (unsigned i = 0; i < 16; i++) cester_assert_not_null(biosMalloc(8192));
+    // InitHeap forgets about everything allocated previously.
+    biosInitHeap(s_heap, sizeof(s_heap));
+    void * big = biosMalloc(sizeof(s_heap) - 64);
+    cester_assert_not_null(big);
+)
+
+CESTER_TEST(heapBenchmark, test_instance,
+    biosInitHeap(s_heap, sizeof(s_heap));
+    void * ptrs[128];
+    for (unsigned i = 0; i < 128; i++) ptrs[i] = NULL;
+    uint32_t seed = 12345;
+    // Root counter 2, counting the system clock divided by 8.
+    COUNTERS[2].mode = 0x200;
+    uint32_t ticks = 0;
+    for (unsigned round = 0; round < 16; round++) {
+        uint16_t start = COUNTERS[2].value;
+        for (unsigned i = 0; i < 256; i++) {
+            seed = seed * 1103515245 + 12345;
+            unsigned slot = (seed >> 16) & 127;
+            if (ptrs[slot]) {
+                biosFree(ptrs[slot]);
+                ptrs[slot] = NULL;
+            } else {
+                ptrs[slot] = biosMalloc(((seed >> 8) & 255) + 8);
+                cester_assert_not_null(ptrs[slot]);
+            }
+        }
+        ticks += (uint16_t)(COUNTERS[2].value - start);
+    }
+    for (unsigned i = 0; i < 128; i++) biosFree(ptrs[i]);
+    ramsyscall_printf("heap benchmark: %d cycles per operation\n", ticks * 8 / (16 * 256));
+)
@@ -61,6 +61,10 @@ at the cost of extra power required.)"));
         m_audioOut.reinit();
     }
     changed = deviceChanged;
+    changed |= ImGui::SliderInt(_("Latency (ms)"), &settings.get<Latency>().value, 5, 45);
+    ImGuiHelpers::ShowHelpMarker(_(R"(How much audio the SPU keeps queued up for the audio
+device. Lower values make the sound react faster to the
+game, but may cause crackling on slower machines.)"));
 
     changed |= ImGui::Checkbox(_("Muted"), &settings.get<Mute>().value);
     changed |= ImGui::Checkbox(_("Enable streaming"), &settings.get<Streaming>().value);
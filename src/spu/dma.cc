@@ -24,6 +24,10 @@
 //
 //*************************************************************************//
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "spu/externals.h"
 #include "spu/interface.h"
 
@@ -31,12 +35,17 @@
 void PCSX::SPU::impl::readDMAMem(uint16_t* mainMem, int size) {
     if (pMixIrq) cbMtx.lock();
 
-    for (int i = 0; i < size; i++) {
-        *mainMem++ = spuMem[spuAddr >> 1];  // Copy 2 bytes
-        spuAddr = (spuAddr + 2) & 0x7ffff;  // Increment SPU address and wrap around
+    // Copy in as few blocks as the wrap around of the SPU RAM allows
+    while (size > 0) {
+        spuAddr &= 0x7ffff;
+        const int block = std::min(size, int((0x80000 - (spuAddr & ~1)) >> 1));
+        memcpy(mainMem, &spuMem[spuAddr >> 1], block * 2);
+        mainMem += block;
+        size -= block;
+        spuAddr = (spuAddr + block * 2) & 0x7ffff;
     }
     if (pMixIrq) cbMtx.unlock();
-    iSpuAsyncWait = 0;
+    ReleaseIRQWait();
 }
 
 // to investigate: do sound data updates by writedma affect spu
@@ -48,8 +57,8 @@ void PCSX::SPU::impl::unlockSPURAM() { cbMtx.unlock(); }
 
 void PCSX::SPU::impl::resetCaptureBuffer() {
     if (settings.get<DBufIRQ>().value) pMixIrq = spuMemC;  // enable decoded buffer irqs by setting the address
-    memset(captureBuffer.CDCapLeft, 0, CaptureBuffer::CB_SIZE);
-    memset(captureBuffer.CDCapRight, 0, CaptureBuffer::CB_SIZE);
+    memset(captureBuffer.CDCapLeft, 0, sizeof(captureBuffer.CDCapLeft));
+    memset(captureBuffer.CDCapRight, 0, sizeof(captureBuffer.CDCapRight));
     captureBuffer.currIndex = 0;
     captureBuffer.endIndex = 0;
     captureBuffer.startIndex = 0;
@@ -60,11 +69,15 @@ void PCSX::SPU::impl::resetCaptureBuffer() {
 void PCSX::SPU::impl::writeDMAMem(uint16_t* mainMem, int size) {
     if (pMixIrq) cbMtx.lock();
 
-    for (int i = 0; i < size; i++) {
-        spuMem[spuAddr >> 1] = *mainMem++;  // Copy 2 bytes
-        spuAddr = (spuAddr + 2) & 0x7ffff;  // Increment SPU address and wrap around
+    while (size > 0) {
+        spuAddr &= 0x7ffff;
+        const int block = std::min(size, int((0x80000 - (spuAddr & ~1)) >> 1));
+        memcpy(&spuMem[spuAddr >> 1], mainMem, block * 2);
+        mainMem += block;
+        size -= block;
+        spuAddr = (spuAddr + block * 2) & 0x7ffff;
     }
 
     if (pMixIrq) cbMtx.unlock();
-    iSpuAsyncWait = 0;
+    ReleaseIRQWait();
 }
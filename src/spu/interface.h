@@ -21,6 +21,10 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 #include "core/decode_xa.h"
@@ -72,6 +76,7 @@ class impl final : public SPUInterface {
     static const unsigned DEBUG_SAMPLES = 1024;
 
     uint32_t getFrameCount() override { return m_audioOut.getFrameCount(); }
+    uint64_t getUnderruns() override { return m_audioOut.getUnderruns(); }
 
     void debug() final;
     bool configure() final;
@@ -85,8 +90,16 @@ class impl final : public SPUInterface {
     }
     uint32_t getCurrentFrames() override { return m_audioOut.getCurrentFrames(); }
     void waitForGoal(uint32_t goal) override { m_audioOut.waitForGoal(goal); }
+    void holdOutput(bool hold) final {
+        m_outputHeld = hold;
+        if (!hold) wakeMixer();
+    }
+    const uint8_t *getRAM() final { return reinterpret_cast<const uint8_t *>(spuMem); }
 
   private:
+    // The benchmarks drive the mixing stages directly.
+    friend struct MixBenchmark;
+
     struct ADSRFlags {
         enum : uint16_t {
             AttackMode = 1 << 15,      // 15 0=Linear, 1=Exponential
@@ -146,12 +159,6 @@ class impl final : public SPUInterface {
         };
     };
 
-    // sound buffer sizes
-    // 400 ms complete sound buffer
-    static const size_t SOUNDSIZE = 70560;
-    // 137 ms test buffer... if less than that is buffered, a new upload will happen
-    static const size_t TESTSIZE = 24192;
-
     // ~ 1 ms of data
     static const size_t NSSIZE = 45;
 
@@ -169,6 +176,8 @@ class impl final : public SPUInterface {
     void StoreInterpolationVal(SPUCHAN *pChannel, int fa);
     int iGetInterpolationVal(SPUCHAN *pChannel);
     void NoiseClock();
+    void MixVoiceBlock(SPUCHAN *pChannel, int ch, int count, bool gauss, int32_t &capVoice1Index,
+                       int32_t &capVoice3Index);
 
     // registers
     void SoundOn(int start, int end, uint16_t val);
@@ -181,15 +190,11 @@ class impl final : public SPUInterface {
     void ReverbOn(int start, int end, uint16_t val);
 
     // reverb
-    int g_buffer(int iOff);              // get_buffer content helper: takes care about wraps
-    void s_buffer(int iOff, int iVal);   // set_buffer content helper: takes care about wraps and clipping
-    void s_buffer1(int iOff, int iVal);  // set_buffer (+1 sample) content helper: takes care about wraps and clipping
     void InitREVERB();
     void SetREVERB(uint16_t val);
     void StartREVERB(SPUCHAN *pChannel);
     void StoreREVERB(SPUCHAN *pChannel, int ns);
-    int MixREVERBLeft(int ns);
-    int MixREVERBRight();
+    void MixREVERB(int *sumLeft, int *sumRight);
 
     // xa
     void FeedXA(xa_decode_t *xap);
@@ -205,16 +210,38 @@ class impl final : public SPUInterface {
     uint8_t *pSpuBuffer;
     uint8_t *pMixIrq = 0;
 
+    // The CD-XA feed is the only writer and the mixer the only reader, so the samples go through
+    // without any lock: each side only ever moves its own index.
     struct CaptureBuffer {
         static const int CB_SIZE = 1024 * 16;
         // These buffers have to be large enough to allow the CD-XA to stream in enough data.
         uint16_t CDCapLeft[CB_SIZE] = {0};
         uint16_t CDCapRight[CB_SIZE] = {0};
 
-        int32_t startIndex = 0;
-        int32_t endIndex = 0;
+        std::atomic<int32_t> startIndex = 0;
+        std::atomic<int32_t> endIndex = 0;
         int32_t currIndex = 0;
+
+        // Returns false if the buffer is full, in which case the sample is dropped.
+        bool push(uint16_t left, uint16_t right) {
+            const int32_t end = endIndex.load(std::memory_order_relaxed);
+            const int32_t next = (end + 1) % CB_SIZE;
+            if (next == startIndex.load(std::memory_order_acquire)) return false;
+            CDCapLeft[end] = left;
+            CDCapRight[end] = right;
+            endIndex.store(next, std::memory_order_release);
+            return true;
+        }
+        bool pop(uint16_t &left, uint16_t &right) {
+            const int32_t start = startIndex.load(std::memory_order_relaxed);
+            if (start == endIndex.load(std::memory_order_acquire)) return false;
+            left = CDCapLeft[start];
+            right = CDCapRight[start];
+            startIndex.store((start + 1) % CB_SIZE, std::memory_order_release);
+            return true;
+        }
     };
+    // Guards the SPU RAM against the DMA and the debugger while the mixer writes the capture data.
     std::mutex cbMtx;
 
     // The temporary cap buffer for CD Audio left/right.
@@ -243,7 +270,7 @@ class impl final : public SPUInterface {
     int bSpuInit = 0;
 
     std::thread hMainThread;
-    uint32_t dwNewChannel = 0;  // flags for faster testing, if new channel starts
+    std::atomic<uint32_t> dwNewChannel = 0;  // flags for faster testing, if new channel starts
 
     void (*cddavCallback)(uint16_t, uint16_t) = 0;
 
@@ -253,13 +280,36 @@ class impl final : public SPUInterface {
     int SSumR[NSSIZE];
     int SSumL[NSSIZE];
     int iFMod[NSSIZE];
-    int iCycle = 0;
     int16_t *pS;
 
-    int lastch = -1;       // last channel processed on spu irq in timer mode
-    int lastns = 0;        // last ns pos
+    // Scratch space for mixing 1 ms of one voice. The samples of the whole block are fetched and decoded
+    // first, then the envelope, the interpolation and the mixing each run as a tight pass over these
+    // arrays. The arrays are padded to a multiple of 4 samples for the vectorised interpolation.
+    static constexpr size_t VOICEBLOCKSIZE = (NSSIZE + 3) & ~3;
+    struct VoiceBlock {
+        alignas(16) int32_t gaussTaps[VOICEBLOCKSIZE][4] = {};
+        int32_t gaussIndex[VOICEBLOCKSIZE] = {};
+        alignas(16) int32_t samples[VOICEBLOCKSIZE] = {};
+        int32_t envelope[VOICEBLOCKSIZE] = {};
+    } m_voiceBlock;
+
     int iSecureStart = 0;  // secure start counter
-    int iSpuAsyncWait = 0;
+    std::atomic<int> iSpuAsyncWait = 0;
+
+    // The mixer thread sleeps on this until the audio output went below the latency target, a voice
+    // got keyed on, the CPU acknowledged the IRQ the mixer is waiting on, or the thread has to end.
+    // Whoever changes one of these conditions needs to call wakeMixer afterwards.
+    std::mutex m_mixerMutex;
+    std::condition_variable m_mixerWakeup;
+    void wakeMixer() {
+        { std::lock_guard<std::mutex> lock(m_mixerMutex); }
+        m_mixerWakeup.notify_one();
+    }
+    // The CPU touched the SPU, so it's done with the IRQ the mixer may be waiting on.
+    void ReleaseIRQWait() {
+        if (iSpuAsyncWait.exchange(0) != 0) wakeMixer();
+    }
+    size_t latencyFrames() { return std::clamp(settings.get<Latency>().value, 5, 45) * 44100 / 1000; }
 
     // REVERB info and timing vars...
 
@@ -285,7 +335,9 @@ class impl final : public SPUInterface {
     int &gvalr(int pos) { return gauss_window[4 + ((gauss_ptr + pos) & 3)]; }
 
     ADSR m_adsr;
-    MiniAudio m_audioOut = {settings};
+    MiniAudio m_audioOut = {settings, [this](size_t buffered) {
+                                if (buffered < latencyFrames()) wakeMixer();
+                            }};
     xa_decode_t m_cdda;
 
     // debug window
@@ -28,8 +28,21 @@
 #define MINIAUDIO_IMPLEMENTATION
 #include "miniaudio/miniaudio.h"
 
-PCSX::SPU::MiniAudio::MiniAudio(PCSX::SPU::SettingsType& settings)
-    : m_settings(settings), m_listener(g_system->m_eventBus) {
+PCSX::SPU::MiniAudio::MiniAudio(PCSX::SPU::SettingsType& settings, std::function<void(size_t buffered)> drained)
+    : m_settings(settings),
+      m_drained(std::move(drained)),
+      m_listener(g_system->m_eventBus),
+      m_sinkEnabled(g_system->getArgs().isAudioSinkEnabled()) {
+    if (m_sinkEnabled) {
+        const auto& args = g_system->getArgs();
+        if (!args.getAudioSinkPath().empty()) {
+            m_sink.setFile(new PosixFile(std::string(args.getAudioSinkPath()), FileOps::TRUNCATE));
+            if (m_sink->failed()) {
+                throw std::runtime_error("Unable to open the audio sink file");
+            }
+        }
+        m_sinkHashPath = args.getAudioHashPath();
+    }
     for (unsigned i = 0; i <= ma_backend_null; i++) {
         ma_backend b = ma_backend(i);
         if (ma_is_backend_enabled(b)) {
@@ -37,6 +50,7 @@ PCSX::SPU::MiniAudio::MiniAudio(PCSX::SPU::SettingsType& settings)
         }
     }
     m_listener.listen<Events::ExecutionFlow::Run>([this](const auto& event) {
+        if (m_sinkEnabled) return;
         if (ma_device_start(&m_device) != MA_SUCCESS) {
             uninit();
             init(true);
@@ -47,6 +61,7 @@ PCSX::SPU::MiniAudio::MiniAudio(PCSX::SPU::SettingsType& settings)
         }
     });
     m_listener.listen<Events::ExecutionFlow::Pause>([this](const auto& event) {
+        if (m_sinkEnabled) return;
         if (ma_device_stop(&m_device) != MA_SUCCESS) {
             throw std::runtime_error("Unable to stop audio device");
         };
@@ -56,6 +71,7 @@ PCSX::SPU::MiniAudio::MiniAudio(PCSX::SPU::SettingsType& settings)
         };
     });
     m_listener.listen<Events::SettingsLoaded>([this](const auto& event) { init(event.safe); });
+    m_listener.listen<Events::Quitting>([this](const auto& event) { closeSink(); });
 }
 
 void PCSX::SPU::MiniAudio::init(bool safe) {
@@ -166,7 +182,7 @@ void PCSX::SPU::MiniAudio::uninit() {
 }
 
 void PCSX::SPU::MiniAudio::maybeRestart() {
-    if (!g_system->running()) return;
+    if (!g_system->running() || m_sinkEnabled) return;
 
     if (ma_device_start(&m_device) != MA_SUCCESS) {
         uninit();
@@ -182,20 +198,26 @@ void PCSX::SPU::MiniAudio::callback(ma_device* device, float* output, ma_uint32
     if (frameCount > VoiceStream::BUFFER_SIZE) {
         throw std::runtime_error("Too many frames requested by miniaudio");
     }
-    static std::array<Buffer, STREAMS> buffers;
+    auto& buffers = m_buffers;
     const bool mono = m_settings.get<Mono>();
     const bool muted = m_settings.get<Mute>();
 
     static_assert(STREAMS == 2);
 
     for (unsigned i = 0; i < STREAMS; i++) {
-        size_t a = i == 0 ? m_voicesStream.dequeue(buffers[i].data(), frameCount)
-                          : m_audioStream.dequeue(buffers[i].data(), frameCount);
+        size_t a = i == 0 ? dequeue(m_voicesStream, buffers[i].data(), frameCount)
+                          : dequeue(m_audioStream, buffers[i].data(), frameCount);
+        if (i == 0) {
+            const bool starved = a < frameCount;
+            if (starved && !m_starved) m_underruns.fetch_add(1, std::memory_order_relaxed);
+            m_starved = starved;
+        }
         for (size_t f = (muted ? 0 : a); f < frameCount; f++) {
             // maybe warn about underflow? tho it's fine if it happens on stream 1 (cdda)
             buffers[i][f] = {};
         }
     }
+    if (m_drained) m_drained(m_voicesStream.buffered());
 
     for (ma_uint32 f = 0; f < frameCount; f++) {
         float l = 0.0f, r = 0.0f;
@@ -219,6 +241,71 @@ void PCSX::SPU::MiniAudio::callback(ma_device* device, float* output, ma_uint32
     callbackNull(device, output, frameCount);
 }
 
+void PCSX::SPU::MiniAudio::renderSink(uint32_t goal) {
+    // The same chunking as the devices, so that the mixer gets woken up just as often.
+    static constexpr size_t c_chunk = 64;
+    std::array<Frame, c_chunk> voices;
+    std::array<Frame, c_chunk> audio;
+    std::array<Frame, c_chunk> output;
+    const bool mono = m_settings.get<Mono>();
+    const bool muted = m_settings.get<Mute>();
+
+    while (((int32_t)(goal - m_frames.load())) > 0) {
+        const size_t frameCount = std::min(size_t(goal - m_frames.load()), c_chunk);
+        {
+            // Waiting for the mixer to catch up, but not forever, in case it's stuck waiting on the
+            // emulation itself, for instance on an SPU IRQ. This gives an underflow, like a device would.
+            if (m_drained) m_drained(m_voicesStream.buffered());
+            std::unique_lock<std::mutex> l(m_sinkMutex);
+            m_sinkCV.wait_for(l, std::chrono::milliseconds(100),
+                              [this, frameCount]() { return m_voicesStream.buffered() >= frameCount; });
+        }
+        const size_t v = dequeue(m_voicesStream, voices.data(), frameCount);
+        const size_t a = dequeue(m_audioStream, audio.data(), frameCount);
+        if (m_drained) m_drained(m_voicesStream.buffered());
+
+        for (size_t f = 0; f < frameCount; f++) {
+            if (muted) {
+                output[f] = {};
+                continue;
+            }
+            int l = 0, r = 0;
+            if (f < v) {
+                l += voices[f].L;
+                r += voices[f].R;
+            }
+            if (f < a) {
+                l += audio[f].L;
+                r += audio[f].R;
+            }
+            if (mono) l = r = (l + r) / 2;
+            output[f].L = std::clamp(l, -32768, 32767);
+            output[f].R = std::clamp(r, -32768, 32767);
+        }
+        writeSink(output.data(), frameCount);
+        m_frames.fetch_add(frameCount);
+    }
+}
+
+void PCSX::SPU::MiniAudio::writeSink(const Frame* frames, size_t count) {
+    if (m_sink) m_sink->write(frames, count * sizeof(Frame));
+    if (!m_sinkHashPath.empty()) m_sinkHash.update(frames, count * sizeof(Frame));
+}
+
+void PCSX::SPU::MiniAudio::closeSink() {
+    if (m_sink) m_sink.reset();
+    if (m_sinkHashPath.empty()) return;
+
+    uint8_t digest[16];
+    m_sinkHash.finish(digest);
+    std::string hex;
+    for (auto b : digest) hex += fmt::format("{:02x}", b);
+    hex += "\n";
+    IO<File> out(new PosixFile(m_sinkHashPath, FileOps::TRUNCATE));
+    if (!out->failed()) out->writeString(hex);
+    m_sinkHashPath.clear();
+}
+
 void PCSX::SPU::MiniAudio::callbackNull(ma_device* device, float* output, ma_uint32 frameCount) {
     m_frameCount.store(frameCount);
 
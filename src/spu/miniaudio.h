@@ -21,9 +21,15 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #define MA_NO_CUSTOM
@@ -36,8 +42,10 @@
 
 #include "miniaudio/miniaudio.h"
 #include "spu/settings.h"
-#include "support/circular.h"
 #include "support/eventbus.h"
+#include "support/file.h"
+#include "support/md5.h"
+#include "support/spsc.h"
 
 #if defined(_MSC_VER) || defined(__linux__)
 #define HAS_ATOMIC_WAIT 1
@@ -53,9 +61,16 @@ class MiniAudio {
     struct Frame {
         int16_t L = 0, R = 0;
     };
-    MiniAudio(SettingsType& settings);
-    ~MiniAudio() { uninit(); }
+    // The drained callback is called from the audio thread every time it pulled frames from the
+    // voices stream, with the number of frames still buffered in there.
+    MiniAudio(SettingsType& settings, std::function<void(size_t buffered)> drained = {});
+    ~MiniAudio() {
+        closeSink();
+        uninit();
+    }
     ma_uint32 getFrameCount() { return m_frameCount.load(); }
+    // How many times the voices stream ran dry while the device wanted more.
+    uint64_t getUnderruns() { return m_underruns.load(std::memory_order_relaxed); }
     void reinit() {
         uninit();
         init();
@@ -63,13 +78,17 @@ class MiniAudio {
     }
     const std::vector<std::string>& getBackends() { return m_backends; }
     const std::vector<std::string>& getDevices() { return m_devices; }
+    // Only one thread may feed a given stream. Returns false if there was no room for the data
+    // within 200ms.
     bool feedStreamData(const Frame* data, size_t frames, unsigned streamId = 0) {
         switch (streamId) {
-            case 0:
-                return m_voicesStream.enqueue(data, frames);
-                break;
+            case 0: {
+                const bool ret = enqueue(m_voicesStream, data, frames);
+                if (m_sinkEnabled) wakeSink();
+                return ret;
+            } break;
             case 1:
-                return m_audioStream.enqueue(data, frames);
+                return enqueue(m_audioStream, data, frames);
                 break;
             default:
                 throw std::runtime_error("Invalid stream ID");
@@ -91,6 +110,10 @@ class MiniAudio {
     }
     uint32_t getCurrentFrames() { return m_frames.load(); }
     void waitForGoal(uint32_t goal) {
+        if (m_sinkEnabled) {
+            renderSink(goal);
+            return;
+        }
 #if HAS_ATOMIC_WAIT
         // for once, Visual Studio is better than clang/gcc/libc++/libstdc++. Its C++20
         // support contain the appropriate wait/notify on atomics, so we can do this:
@@ -109,12 +132,23 @@ class MiniAudio {
   private:
     static constexpr unsigned STREAMS = 2;
     SettingsType& m_settings;
+    const std::function<void(size_t buffered)> m_drained;
     void callback(ma_device* device, float* output, ma_uint32 frameCount);
     void callbackNull(ma_device* device, float* output, ma_uint32 frameCount);
     void init(bool safe = false);
     void uninit();
     void maybeRestart();
 
+    // When the audio goes to a file, there's no device pulling the streams. Instead, the emulation
+    // thread renders the frames itself as it reaches each goal, so the audio follows emulated time.
+    void renderSink(uint32_t goal);
+    void writeSink(const Frame* frames, size_t count);
+    void closeSink();
+    void wakeSink() {
+        { std::unique_lock<std::mutex> l(m_sinkMutex); }
+        m_sinkCV.notify_one();
+    }
+
     ma_context m_context;
     ma_device_config m_config;
     ma_device m_device;
@@ -123,10 +157,36 @@ class MiniAudio {
     ma_device m_deviceNull;
     EventBus::Listener m_listener;
 
-    typedef Circular<Frame, 2 * 1024> VoiceStream;
+    // The streams are lock-free, so that the audio thread never waits on the emulator. Only the
+    // feeding side may block, and it polls for room rather than waiting for the audio thread to wake it.
+    template <typename Stream>
+    static bool enqueue(Stream& stream, const Frame* data, size_t frames) {
+        if (frames > Stream::BUFFER_SIZE) {
+            throw std::runtime_error("Trying to enqueue too much data");
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+        while (stream.available() < frames) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        stream.write(data, frames);
+        stream.commit(frames);
+        return true;
+    }
+    template <typename Stream>
+    static size_t dequeue(Stream& stream, Frame* data, size_t frames) {
+        frames = std::min(frames, stream.buffered());
+        stream.read(data, frames);
+        stream.consume(frames);
+        return frames;
+    }
+
+    typedef SPSCRing<Frame, 2 * 1024> VoiceStream;
     VoiceStream m_voicesStream;
-    Circular<Frame, 16 * 1024> m_audioStream;
+    SPSCRing<Frame, 16 * 1024> m_audioStream;
     typedef std::array<Frame, VoiceStream::BUFFER_SIZE> Buffer;
+    // Only ever touched by the device's thread, but each instance has its own device.
+    std::array<Buffer, STREAMS> m_buffers;
     std::atomic<uint32_t> m_frames = 0;
 #if HAS_ATOMIC_WAIT
     std::atomic<uint32_t> m_goalpost = 0;
@@ -143,6 +203,16 @@ class MiniAudio {
     std::vector<std::string> m_devices;
 
     std::atomic<ma_uint32> m_frameCount;
+    std::atomic<uint64_t> m_underruns = 0;
+    // So that a stream that stays empty, while paused for instance, only counts as one underrun.
+    bool m_starved = true;
+
+    const bool m_sinkEnabled;
+    IO<File> m_sink;
+    MD5 m_sinkHash;
+    std::string m_sinkHashPath;
+    std::mutex m_sinkMutex;
+    std::condition_variable m_sinkCV;
 };
 
 }  // namespace SPU
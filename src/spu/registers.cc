@@ -206,7 +206,7 @@ void PCSX::SPU::impl::writeRegister(uint32_t reg, uint16_t val) {
                 //------------------------------------------------//
         }
 
-        iSpuAsyncWait = 0;
+        ReleaseIRQWait();
         return;
     }
 
@@ -488,7 +488,7 @@ void PCSX::SPU::impl::writeRegister(uint32_t reg, uint16_t val) {
             break;
     }
 
-    iSpuAsyncWait = 0;
+    ReleaseIRQWait();
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -498,7 +498,7 @@ void PCSX::SPU::impl::writeRegister(uint32_t reg, uint16_t val) {
 uint16_t PCSX::SPU::impl::readRegister(uint32_t reg) {
     const uint32_t r = reg & 0xfff;
 
-    iSpuAsyncWait = 0;
+    ReleaseIRQWait();
 
     if (r >= 0x0c00 && r < 0x0d80) {
         switch (r & 0x0f) {
@@ -572,14 +572,17 @@ uint16_t PCSX::SPU::impl::readRegister(uint32_t reg) {
 
 // Start ADSR for voices [start, end] depending on val
 void PCSX::SPU::impl::SoundOn(int start, int end, uint16_t val) {
+    bool keyedOn = false;
     for (int ch = start; ch < end; ch++, val >>= 1) {
         if ((val & 1) && s_chan[ch].pStart) {  // mmm... start has to be set before key on !?!
             s_chan[ch].data.get<Chan::IgnoreLoop>().value = false;
             s_chan[ch].data.get<Chan::New>().value = true;
             dwNewChannel |= (1 << ch);  // bitfield for faster testing
+            keyedOn = true;
             PCSX::PSXSPU_LOGGER::Log("SPU.write, Voice %02i ON\n", ch);
         }
     }
+    if (keyedOn) wakeMixer();
 }
 
 // Stop sound for voices [start, end] if the corresponding bit in val is set to 1
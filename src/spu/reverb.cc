@@ -33,6 +33,20 @@
 //
 //*************************************************************************//
 
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SPU_SSE41
+#define SPU_TARGET_SSE41
+#else
+#define SPU_SSE41
+#define SPU_TARGET_SSE41 __attribute__((target("sse4.1")))
+#endif
+#endif
+
 #include "spu/externals.h"
 #include "spu/interface.h"
 
@@ -165,169 +179,263 @@ void PCSX::SPU::impl::StoreREVERB(SPUCHAN *pChannel, int ns) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////
+// NEILL'S REVERB NETWORK
 ////////////////////////////////////////////////////////////////////////
 
-inline int PCSX::SPU::impl::g_buffer(int iOff)  // get_buffer content helper: takes care about wraps
-{
-    short *p = (short *)spuMem;
-    iOff = (iOff * 4) + rvb.CurrAddr;
-    while (iOff > 0x3FFFF) iOff = rvb.StartAddr + (iOff - 0x40000);
-    while (iOff < rvb.StartAddr) iOff = 0x3ffff - (rvb.StartAddr - iOff);
-    return (int)*(p + iOff);
+namespace {
+
+// Every tap of the network is an offset from the current reverb address, wrapped into the reverb work
+// area. Between two wraps, all of them move forward by one sample per 22 khz tick, so the wrapping is
+// resolved once per run of ticks, and the taps become plain pointers within that run. The taps of the
+// four paths are stored in A0, A1, B0, B1 order, which is also the order of the vector lanes.
+struct ReverbTaps {
+    int16_t *iirSrc[4];
+    int16_t *iirDest[4];
+    int16_t *iirStore[4];  // IIR_DEST + 1 sample
+    int16_t *accSrc[8];    // A0, A1, B0, B1, C0, C1, D0, D1
+    int16_t *fbSrc[4];
+    int16_t *mixDest[4];
+};
+
+// Same wrapping as the hardware notes describe, including the historical off-by-one when wrapping
+// below the start of the area. Also returns how many consecutive ticks this tap stays linear.
+int ReverbAddress(const PCSX::SPU::REVERBInfo &rvb, int iOff, int extra, int &run) {
+    const int raw = (iOff * 4) + rvb.CurrAddr + extra;
+    int addr = raw;
+    while (addr > 0x3FFFF) addr = rvb.StartAddr + (addr - 0x40000);
+    while (addr < rvb.StartAddr) addr = 0x3ffff - (rvb.StartAddr - addr);
+    run = std::min(run, (raw < rvb.StartAddr ? 0x3ffff : 0x40000) - addr);
+    return addr;
 }
 
-////////////////////////////////////////////////////////////////////////
+// Resolves all the taps at the current reverb address, and returns for how many ticks they are valid,
+// up to maxTicks.
+int SetupReverbTaps(const PCSX::SPU::REVERBInfo &rvb, uint16_t *spuMem, ReverbTaps &taps, int maxTicks) {
+    int16_t *p = reinterpret_cast<int16_t *>(spuMem);
+    int run = std::min(maxTicks, 0x40000 - rvb.CurrAddr);
+    auto tap = [&](int iOff, int extra = 0) { return p + ReverbAddress(rvb, iOff, extra, run); };
+
+    const int iirSrc[4] = {rvb.IIR_SRC_A0, rvb.IIR_SRC_A1, rvb.IIR_SRC_B0, rvb.IIR_SRC_B1};
+    const int iirDest[4] = {rvb.IIR_DEST_A0, rvb.IIR_DEST_A1, rvb.IIR_DEST_B0, rvb.IIR_DEST_B1};
+    const int accSrc[8] = {rvb.ACC_SRC_A0, rvb.ACC_SRC_A1, rvb.ACC_SRC_B0, rvb.ACC_SRC_B1,
+                           rvb.ACC_SRC_C0, rvb.ACC_SRC_C1, rvb.ACC_SRC_D0, rvb.ACC_SRC_D1};
+    const int mixDest[4] = {rvb.MIX_DEST_A0, rvb.MIX_DEST_A1, rvb.MIX_DEST_B0, rvb.MIX_DEST_B1};
+    const int fbSrc[4] = {rvb.FB_SRC_A, rvb.FB_SRC_A, rvb.FB_SRC_B, rvb.FB_SRC_B};
+
+    for (int i = 0; i < 4; i++) {
+        taps.iirSrc[i] = tap(iirSrc[i]);
+        taps.iirDest[i] = tap(iirDest[i]);
+        taps.iirStore[i] = tap(iirDest[i], 1);
+        taps.fbSrc[i] = tap(mixDest[i] - fbSrc[i]);
+        taps.mixDest[i] = tap(mixDest[i]);
+    }
+    for (int i = 0; i < 8; i++) taps.accSrc[i] = tap(accSrc[i]);
 
-inline void PCSX::SPU::impl::s_buffer(int iOff,
-                                      int iVal)  // set_buffer content helper: takes care about wraps and clipping
-{
-    short *p = (short *)spuMem;
-    iOff = (iOff * 4) + rvb.CurrAddr;
-    while (iOff > 0x3FFFF) iOff = rvb.StartAddr + (iOff - 0x40000);
-    while (iOff < rvb.StartAddr) iOff = 0x3ffff - (rvb.StartAddr - iOff);
-    if (iVal < -32768L) iVal = -32768L;
-    if (iVal > 32767L) iVal = 32767L;
-    *(p + iOff) = (short)iVal;
+    return run;
 }
 
-////////////////////////////////////////////////////////////////////////
+// The coefficients can push the intermediate products past 32 bits; they wrap around like they
+// always did, but without relying on signed overflow.
+inline int ReverbMul(int a, int b) { return int(uint32_t(a) * uint32_t(b)); }
+
+inline int16_t ReverbClip(int val) { return std::clamp(val, -32768, 32767); }
+
+// Runs count ticks of the network. The input holds the 44.1 khz stereo reverb mix, and only every
+// second frame of it is used. The outputs are the unscaled wet samples of each tick.
+void ReverbBlockScalar(const PCSX::SPU::REVERBInfo &rvb, const ReverbTaps &taps, const int *input, int count,
+                       int *wetLeft, int *wetRight) {
+    const int inCoef[4] = {rvb.IN_COEF_L, rvb.IN_COEF_R, rvb.IN_COEF_L, rvb.IN_COEF_R};
+    const int accCoef[8] = {rvb.ACC_COEF_A, rvb.ACC_COEF_A, rvb.ACC_COEF_B, rvb.ACC_COEF_B,
+                            rvb.ACC_COEF_C, rvb.ACC_COEF_C, rvb.ACC_COEF_D, rvb.ACC_COEF_D};
+
+    for (int n = 0; n < count; n++, input += 4) {
+        int iir[4];
+        for (int i = 0; i < 4; i++) {
+            const int iirInput =
+                ReverbMul(taps.iirSrc[i][n], rvb.IIR_COEF) / 32768 + ReverbMul(input[i & 1], inCoef[i]) / 32768;
+            iir[i] = ReverbMul(iirInput, rvb.IIR_ALPHA) / 32768 +
+                     ReverbMul(taps.iirDest[i][n], 32768 - rvb.IIR_ALPHA) / 32768;
+        }
+        for (int i = 0; i < 4; i++) taps.iirStore[i][n] = ReverbClip(iir[i]);
 
-inline void PCSX::SPU::impl::s_buffer1(
-    int iOff, int iVal)  // set_buffer (+1 sample) content helper: takes care about wraps and clipping
-{
-    short *p = (short *)spuMem;
-    iOff = (iOff * 4) + rvb.CurrAddr + 1;
-    while (iOff > 0x3FFFF) iOff = rvb.StartAddr + (iOff - 0x40000);
-    while (iOff < rvb.StartAddr) iOff = 0x3ffff - (rvb.StartAddr - iOff);
-    if (iVal < -32768L) iVal = -32768L;
-    if (iVal > 32767L) iVal = 32767L;
-    *(p + iOff) = (short)iVal;
-}
+        int acc[2] = {0, 0};
+        for (int i = 0; i < 8; i++) acc[i & 1] += ReverbMul(taps.accSrc[i][n], accCoef[i]) / 32768;
 
-////////////////////////////////////////////////////////////////////////
-int PCSX::SPU::impl::MixREVERBLeft(int ns) {
-    if (settings.get<Reverb>() == 0)
-        return 0;
-    else if (settings.get<Reverb>() == 2) {
-        static int iCnt = 0;  // this func will be called with 44.1 khz
+        int fb[4];
+        for (int i = 0; i < 4; i++) fb[i] = taps.fbSrc[i][n];
 
-        if (!rvb.StartAddr)  // reverb is off
-        {
-            rvb.iLastRVBLeft = rvb.iLastRVBRight = rvb.iRVBLeft = rvb.iRVBRight = 0;
-            return 0;
+        for (int i = 0; i < 2; i++) {
+            taps.mixDest[i][n] = ReverbClip(acc[i] - ReverbMul(fb[i], rvb.FB_ALPHA) / 32768);
+        }
+        for (int i = 0; i < 2; i++) {
+            taps.mixDest[i + 2][n] =
+                ReverbClip(ReverbMul(rvb.FB_ALPHA, acc[i]) / 32768 -
+                           ReverbMul(fb[i], int(rvb.FB_ALPHA ^ 0xFFFF8000)) / 32768 -
+                           ReverbMul(fb[i + 2], rvb.FB_X) / 32768);
         }
 
-        iCnt++;
+        wetLeft[n] = (taps.mixDest[0][n] + taps.mixDest[2][n]) / 3;
+        wetRight[n] = (taps.mixDest[1][n] + taps.mixDest[3][n]) / 3;
+    }
+}
 
-        if (iCnt & 1)  // we work on every second left value: downsample to 22 khz
-        {
-            if (spuCtrl & ControlFlags::ReverbMasterEnable)  // -> reverb on? oki
-            {
-                int ACC0, ACC1, FB_A0, FB_A1, FB_B0, FB_B1;
-
-                const int INPUT_SAMPLE_L = *(sRVBStart + (ns << 1));
-                const int INPUT_SAMPLE_R = *(sRVBStart + (ns << 1) + 1);
-
-                const int IIR_INPUT_A0 =
-                    (g_buffer(rvb.IIR_SRC_A0) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_L * rvb.IN_COEF_L) / 32768L;
-                const int IIR_INPUT_A1 =
-                    (g_buffer(rvb.IIR_SRC_A1) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_R * rvb.IN_COEF_R) / 32768L;
-                const int IIR_INPUT_B0 =
-                    (g_buffer(rvb.IIR_SRC_B0) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_L * rvb.IN_COEF_L) / 32768L;
-                const int IIR_INPUT_B1 =
-                    (g_buffer(rvb.IIR_SRC_B1) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_R * rvb.IN_COEF_R) / 32768L;
-
-                const int IIR_A0 = (IIR_INPUT_A0 * rvb.IIR_ALPHA) / 32768L +
-                                   (g_buffer(rvb.IIR_DEST_A0) * (32768L - rvb.IIR_ALPHA)) / 32768L;
-                const int IIR_A1 = (IIR_INPUT_A1 * rvb.IIR_ALPHA) / 32768L +
-                                   (g_buffer(rvb.IIR_DEST_A1) * (32768L - rvb.IIR_ALPHA)) / 32768L;
-                const int IIR_B0 = (IIR_INPUT_B0 * rvb.IIR_ALPHA) / 32768L +
-                                   (g_buffer(rvb.IIR_DEST_B0) * (32768L - rvb.IIR_ALPHA)) / 32768L;
-                const int IIR_B1 = (IIR_INPUT_B1 * rvb.IIR_ALPHA) / 32768L +
-                                   (g_buffer(rvb.IIR_DEST_B1) * (32768L - rvb.IIR_ALPHA)) / 32768L;
-
-                s_buffer1(rvb.IIR_DEST_A0, IIR_A0);
-                s_buffer1(rvb.IIR_DEST_A1, IIR_A1);
-                s_buffer1(rvb.IIR_DEST_B0, IIR_B0);
-                s_buffer1(rvb.IIR_DEST_B1, IIR_B1);
-
-                ACC0 = (g_buffer(rvb.ACC_SRC_A0) * rvb.ACC_COEF_A) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_B0) * rvb.ACC_COEF_B) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_C0) * rvb.ACC_COEF_C) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_D0) * rvb.ACC_COEF_D) / 32768L;
-                ACC1 = (g_buffer(rvb.ACC_SRC_A1) * rvb.ACC_COEF_A) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_B1) * rvb.ACC_COEF_B) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_C1) * rvb.ACC_COEF_C) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_D1) * rvb.ACC_COEF_D) / 32768L;
-
-                FB_A0 = g_buffer(rvb.MIX_DEST_A0 - rvb.FB_SRC_A);
-                FB_A1 = g_buffer(rvb.MIX_DEST_A1 - rvb.FB_SRC_A);
-                FB_B0 = g_buffer(rvb.MIX_DEST_B0 - rvb.FB_SRC_B);
-                FB_B1 = g_buffer(rvb.MIX_DEST_B1 - rvb.FB_SRC_B);
-
-                s_buffer(rvb.MIX_DEST_A0, ACC0 - (FB_A0 * rvb.FB_ALPHA) / 32768L);
-                s_buffer(rvb.MIX_DEST_A1, ACC1 - (FB_A1 * rvb.FB_ALPHA) / 32768L);
-
-                s_buffer(rvb.MIX_DEST_B0, (rvb.FB_ALPHA * ACC0) / 32768L -
-                                              (FB_A0 * (int)(rvb.FB_ALPHA ^ 0xFFFF8000)) / 32768L -
-                                              (FB_B0 * rvb.FB_X) / 32768L);
-                s_buffer(rvb.MIX_DEST_B1, (rvb.FB_ALPHA * ACC1) / 32768L -
-                                              (FB_A1 * (int)(rvb.FB_ALPHA ^ 0xFFFF8000)) / 32768L -
-                                              (FB_B1 * rvb.FB_X) / 32768L);
-
-                rvb.iLastRVBLeft = rvb.iRVBLeft;
-                rvb.iLastRVBRight = rvb.iRVBRight;
-
-                rvb.iRVBLeft = (g_buffer(rvb.MIX_DEST_A0) + g_buffer(rvb.MIX_DEST_B0)) / 3;
-                rvb.iRVBRight = (g_buffer(rvb.MIX_DEST_A1) + g_buffer(rvb.MIX_DEST_B1)) / 3;
-
-                rvb.iRVBLeft = (rvb.iRVBLeft * rvb.VolLeft) / 0x4000;
-                rvb.iRVBRight = (rvb.iRVBRight * rvb.VolRight) / 0x4000;
-
-                rvb.CurrAddr++;
-                if (rvb.CurrAddr > 0x3ffff) rvb.CurrAddr = rvb.StartAddr;
-
-                return rvb.iLastRVBLeft + (rvb.iRVBLeft - rvb.iLastRVBLeft) / 2;
-            } else  // -> reverb off
-            {
-                rvb.iLastRVBLeft = rvb.iLastRVBRight = rvb.iRVBLeft = rvb.iRVBRight = 0;
-            }
+#if defined(SPU_SSE41)
 
-            rvb.CurrAddr++;
-            if (rvb.CurrAddr > 0x3ffff) rvb.CurrAddr = rvb.StartAddr;
-        }
+SPU_TARGET_SSE41 inline __m128i ReverbGather(int16_t *const *taps, int n) {
+    return _mm_setr_epi32(taps[0][n], taps[1][n], taps[2][n], taps[3][n]);
+}
 
-        return rvb.iLastRVBLeft;
-    } else  // easy fake reverb:
-    {
-        const int iRV = *sRVBPlay;                      // -> simply take the reverb mix buf value
-        *sRVBPlay++ = 0;                                // -> init it after
-        if (sRVBPlay >= sRVBEnd) sRVBPlay = sRVBStart;  // -> and take care about wrap arounds
-        return iRV;                                     // -> return reverb mix buf val
+// Signed division by 32768, rounding towards zero like the scalar code does.
+SPU_TARGET_SSE41 inline __m128i ReverbDiv(__m128i val) {
+    return _mm_srai_epi32(_mm_add_epi32(val, _mm_srli_epi32(_mm_srai_epi32(val, 31), 17)), 15);
+}
+
+SPU_TARGET_SSE41 inline __m128i ReverbMulDiv(__m128i a, __m128i b) { return ReverbDiv(_mm_mullo_epi32(a, b)); }
+
+// The stores are done lane by lane and in order, so that overlapping taps behave like the scalar code.
+SPU_TARGET_SSE41 inline void ReverbScatter(int16_t *const *taps, int n, __m128i val) {
+    const __m128i packed = _mm_packs_epi32(val, val);
+    taps[0][n] = _mm_extract_epi16(packed, 0);
+    taps[1][n] = _mm_extract_epi16(packed, 1);
+    taps[2][n] = _mm_extract_epi16(packed, 2);
+    taps[3][n] = _mm_extract_epi16(packed, 3);
+}
+
+// Same as the scalar version, with the four paths of the network in the four lanes.
+SPU_TARGET_SSE41 void ReverbBlockSIMD(const PCSX::SPU::REVERBInfo &rvb, const ReverbTaps &taps, const int *input,
+                                      int count, int *wetLeft, int *wetRight) {
+    const __m128i iirCoef = _mm_set1_epi32(rvb.IIR_COEF);
+    const __m128i inCoef = _mm_setr_epi32(rvb.IN_COEF_L, rvb.IN_COEF_R, rvb.IN_COEF_L, rvb.IN_COEF_R);
+    const __m128i iirAlpha = _mm_set1_epi32(rvb.IIR_ALPHA);
+    const __m128i iirBeta = _mm_set1_epi32(32768 - rvb.IIR_ALPHA);
+    const __m128i accCoefAB = _mm_setr_epi32(rvb.ACC_COEF_A, rvb.ACC_COEF_A, rvb.ACC_COEF_B, rvb.ACC_COEF_B);
+    const __m128i accCoefCD = _mm_setr_epi32(rvb.ACC_COEF_C, rvb.ACC_COEF_C, rvb.ACC_COEF_D, rvb.ACC_COEF_D);
+    const int fbAlphaB = int(rvb.FB_ALPHA ^ 0xFFFF8000);
+    const __m128i fbAlpha = _mm_set1_epi32(rvb.FB_ALPHA);
+    const __m128i fbCoefA = _mm_setr_epi32(rvb.FB_ALPHA, rvb.FB_ALPHA, fbAlphaB, fbAlphaB);
+    const __m128i fbCoefB = _mm_setr_epi32(0, 0, rvb.FB_X, rvb.FB_X);
+
+    for (int n = 0; n < count; n++, input += 4) {
+        // L, R, L, R
+        const __m128i in = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(input)),
+                                              _mm_loadl_epi64(reinterpret_cast<const __m128i *>(input)));
+        const __m128i iirInput = _mm_add_epi32(ReverbMulDiv(ReverbGather(taps.iirSrc, n), iirCoef),
+                                               ReverbMulDiv(in, inCoef));
+        const __m128i iir = _mm_add_epi32(ReverbMulDiv(iirInput, iirAlpha),
+                                          ReverbMulDiv(ReverbGather(taps.iirDest, n), iirBeta));
+        ReverbScatter(taps.iirStore, n, iir);
+
+        // ACC0 and ACC1 both end up in the A and the B lanes.
+        const __m128i accHalves = _mm_add_epi32(ReverbMulDiv(ReverbGather(taps.accSrc, n), accCoefAB),
+                                                ReverbMulDiv(ReverbGather(taps.accSrc + 4, n), accCoefCD));
+        const __m128i acc = _mm_add_epi32(accHalves, _mm_shuffle_epi32(accHalves, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        const __m128i fb = ReverbGather(taps.fbSrc, n);
+        const __m128i fbB = _mm_shuffle_epi32(fb, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m128i fbA = _mm_shuffle_epi32(fb, _MM_SHUFFLE(1, 0, 1, 0));
+        // The A lanes take ACC as is, the B lanes scale it by FB_ALPHA.
+        const __m128i accScaled = _mm_blend_epi16(acc, ReverbMulDiv(acc, fbAlpha), 0xf0);
+        const __m128i mix =
+            _mm_sub_epi32(_mm_sub_epi32(accScaled, ReverbMulDiv(fbA, fbCoefA)), ReverbMulDiv(fbB, fbCoefB));
+        ReverbScatter(taps.mixDest, n, mix);
+
+        wetLeft[n] = (taps.mixDest[0][n] + taps.mixDest[2][n]) / 3;
+        wetRight[n] = (taps.mixDest[1][n] + taps.mixDest[3][n]) / 3;
     }
 }
 
+bool HasSIMD() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+#endif
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////
+// MIX REVERB... adds the reverb output of one block to the mix
 ////////////////////////////////////////////////////////////////////////
 
-int PCSX::SPU::impl::MixREVERBRight() {
-    if (settings.get<Reverb>() == 0)
-        return 0;
-    else if (settings.get<Reverb>() == 2)  // Neill's reverb:
+void PCSX::SPU::impl::MixREVERB(int *sumLeft, int *sumRight) {
+    if (settings.get<Reverb>() == 0) return;
+
+    if (settings.get<Reverb>() == 1) {  // easy fake reverb:
+        for (int ns = 0; ns < NSSIZE; ns++) {
+            sumLeft[ns] += *sRVBPlay;                       // -> simply take the reverb mix buf value
+            *sRVBPlay++ = 0;                                // -> init it after
+            if (sRVBPlay >= sRVBEnd) sRVBPlay = sRVBStart;  // -> and take care about wrap arounds
+            sumRight[ns] += *sRVBPlay;
+            *sRVBPlay++ = 0;
+            if (sRVBPlay >= sRVBEnd) sRVBPlay = sRVBStart;
+        }
+        return;
+    }
+
+    if (!rvb.StartAddr)  // reverb is off
     {
-        int i = rvb.iLastRVBRight + (rvb.iRVBRight - rvb.iLastRVBRight) / 2;
+        rvb.iLastRVBLeft = rvb.iLastRVBRight = rvb.iRVBLeft = rvb.iRVBRight = 0;
+        return;
+    }
+
+    // The network runs at 22 khz, on every second output sample; the phase carries over between blocks.
+    const int first = rvb.iCnt & 1;
+    const int ticks = (NSSIZE - first + 1) / 2;
+    rvb.iCnt += NSSIZE;
+
+    const bool enabled = spuCtrl & ControlFlags::ReverbMasterEnable;
+    int wetLeft[(NSSIZE + 1) / 2];
+    int wetRight[(NSSIZE + 1) / 2];
+#if defined(SPU_SSE41)
+    static const bool simd = HasSIMD();
+#endif
+
+    // The work address always moves on, even when the reverb isn't running.
+    for (int tick = 0; tick < ticks;) {
+        ReverbTaps taps;
+        const int run = SetupReverbTaps(rvb, spuMem, taps, ticks - tick);
+        if (enabled) {
+            const int *input = sRVBStart + (first + tick * 2) * 2;
+#if defined(SPU_SSE41)
+            if (simd) {
+                ReverbBlockSIMD(rvb, taps, input, run, wetLeft + tick, wetRight + tick);
+            } else {
+                ReverbBlockScalar(rvb, taps, input, run, wetLeft + tick, wetRight + tick);
+            }
+#else
+            ReverbBlockScalar(rvb, taps, input, run, wetLeft + tick, wetRight + tick);
+#endif
+        }
+        tick += run;
+        rvb.CurrAddr += run;
+        if (rvb.CurrAddr > 0x3ffff) rvb.CurrAddr = rvb.StartAddr;
+    }
+
+    // Upsampling back to 44.1 khz, by averaging with the previous tick.
+    for (int ns = 0, tick = 0; ns < NSSIZE; ns++) {
+        if (((ns - first) & 1) == 0 && !enabled) {
+            rvb.iLastRVBLeft = rvb.iLastRVBRight = rvb.iRVBLeft = rvb.iRVBRight = 0;
+        } else if (((ns - first) & 1) == 0) {
+            rvb.iLastRVBLeft = rvb.iRVBLeft;
+            rvb.iLastRVBRight = rvb.iRVBRight;
+            rvb.iRVBLeft = (wetLeft[tick] * rvb.VolLeft) / 0x4000;
+            rvb.iRVBRight = (wetRight[tick] * rvb.VolRight) / 0x4000;
+            tick++;
+            sumLeft[ns] += rvb.iLastRVBLeft + (rvb.iRVBLeft - rvb.iLastRVBLeft) / 2;
+        } else {
+            sumLeft[ns] += rvb.iLastRVBLeft;
+        }
+        sumRight[ns] += rvb.iLastRVBRight + (rvb.iRVBRight - rvb.iLastRVBRight) / 2;
         rvb.iLastRVBRight = rvb.iRVBRight;
-        return i;  // -> just return the last right reverb val (little bit scaled by the previous right val)
-    } else         // easy fake reverb:
-    {
-        const int iRV = *sRVBPlay;                      // -> simply take the reverb mix buf value
-        *sRVBPlay++ = 0;                                // -> init it after
-        if (sRVBPlay >= sRVBEnd) sRVBPlay = sRVBStart;  // -> and take care about wrap arounds
-        return iRV;                                     // -> return reverb mix buf val
     }
 }
 
-////////////////////////////////////////////////////////////////////////
-
 /*
 -----------------------------------------------------------------------------
 PSX reverb hardware notes
@@ -35,7 +35,9 @@ typedef Setting<int, TYPESTRING("Interp"), 2> Interpolation;
 typedef Setting<bool, TYPESTRING("Mono")> Mono;
 typedef Setting<bool, TYPESTRING("DBufIRQ"), true> DBufIRQ;
 typedef Setting<bool, TYPESTRING("Mute")> Mute;
-typedef Settings<Backend, Device, NullSync, Streaming, Volume, SPUIRQWait, Reverb, Interpolation, Mono, DBufIRQ, Mute>
+typedef Setting<int, TYPESTRING("LatencyMs"), 30> Latency;
+typedef Settings<Backend, Device, NullSync, Streaming, Volume, SPUIRQWait, Reverb, Interpolation, Mono, DBufIRQ, Mute,
+                 Latency>
     SettingsType;
 
 }  // namespace SPU
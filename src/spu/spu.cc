@@ -96,6 +96,18 @@
 #include <chrono>
 #include <thread>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SPU_SSE41
+#define SPU_TARGET_SSE41
+#else
+#define SPU_SSE41
+#define SPU_TARGET_SSE41 __attribute__((target("sse4.1")))
+#endif
+#endif
+
 #include "spu/adsr.h"
 #include "spu/externals.h"
 #include "spu/gauss.h"
@@ -428,6 +440,130 @@ inline int PCSX::SPU::impl::iGetInterpolationVal(SPUCHAN *pChannel) {
     return fa;
 }
 
+////////////////////////////////////////////////////////////////////////
+// gauss interpolation of a whole block, from the windows saved while fetching the samples
+
+static void GaussBlockScalar(const int32_t (*taps)[4], const int32_t *index, int32_t *out, int count) {
+    for (int n = 0; n < count; n++) {
+        const int vl = index[n];
+        int vr = (Gauss::gauss[vl] * taps[n][0]) & ~2047;
+        vr += (Gauss::gauss[vl + 1] * taps[n][1]) & ~2047;
+        vr += (Gauss::gauss[vl + 2] * taps[n][2]) & ~2047;
+        vr += (Gauss::gauss[vl + 3] * taps[n][3]) & ~2047;
+        out[n] = vr >> 11;
+    }
+}
+
+#if defined(SPU_SSE41)
+
+// The 4 coefficients of each sample are next to each other in the table, so this works on 4 samples
+// at a time, one per vector, then sums them horizontally. The arrays need to be padded to a multiple of 4.
+SPU_TARGET_SSE41 static void GaussBlockSIMD(const int32_t (*taps)[4], const int32_t *index, int32_t *out, int count) {
+    const __m128i mask = _mm_set1_epi32(~2047);
+    for (int n = 0; n < count; n += 4) {
+        __m128i products[4];
+        for (int i = 0; i < 4; i++) {
+            const __m128i coefficients =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(&Gauss::gauss[index[n + i]]));
+            const __m128i window = _mm_load_si128(reinterpret_cast<const __m128i *>(taps[n + i]));
+            products[i] = _mm_and_si128(_mm_mullo_epi32(coefficients, window), mask);
+        }
+        const __m128i sums =
+            _mm_hadd_epi32(_mm_hadd_epi32(products[0], products[1]), _mm_hadd_epi32(products[2], products[3]));
+        _mm_store_si128(reinterpret_cast<__m128i *>(out + n), _mm_srai_epi32(sums, 11));
+    }
+}
+
+static bool HasSIMD() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////
+// MIX VOICE BLOCK... envelope, interpolation, volume and reverb of the
+// samples fetched for one channel by the main loop
+////////////////////////////////////////////////////////////////////////
+
+void PCSX::SPU::impl::MixVoiceBlock(SPUCHAN *pChannel, int ch, int count, bool gauss, int32_t &capVoice1Index,
+                                    int32_t &capVoice3Index) {
+    auto &block = m_voiceBlock;
+
+    // The envelope doesn't depend on the samples, so it can be stepped on its own.
+    for (int n = 0; n < count; n++) block.envelope[n] = m_adsr.mix(pChannel);
+
+    if (gauss) {
+#if defined(SPU_SSE41)
+        static const bool simd = HasSIMD();
+        if (simd) {
+            GaussBlockSIMD(block.gaussTaps, block.gaussIndex, block.samples, count);
+        } else {
+            GaussBlockScalar(block.gaussTaps, block.gaussIndex, block.samples, count);
+        }
+#else
+        GaussBlockScalar(block.gaussTaps, block.gaussIndex, block.samples, count);
+#endif
+    }
+
+    const bool fmodFreq = pChannel->data.get<PCSX::SPU::Chan::FMod>().value == 2;
+    const bool muted = pChannel->data.get<PCSX::SPU::Chan::Mute>().value &&
+                       !pChannel->data.get<PCSX::SPU::Chan::Solo>().value;
+    const bool reverb = pChannel->data.get<PCSX::SPU::Chan::RVBActive>().value;
+    const int leftVolume = pChannel->data.get<PCSX::SPU::Chan::LeftVolume>().value;
+    const int rightVolume = pChannel->data.get<PCSX::SPU::Chan::RightVolume>().value;
+    auto &sval = pChannel->data.get<PCSX::SPU::Chan::sval>().value;
+
+    // Capture buffer should contain voice1/3 sample after any adsr processing but before volume processing?
+    uint16_t *capture = nullptr;
+    int32_t *captureIndex = nullptr;
+    std::unique_lock<std::mutex> lock(cbMtx, std::defer_lock);
+    if (pMixIrq && ch == 1) {
+        capture = spuMem + 0x400;
+        captureIndex = &capVoice1Index;
+        lock.lock();
+    } else if (pMixIrq && ch == 3) {
+        capture = spuMem + 0x600;
+        captureIndex = &capVoice3Index;
+        lock.lock();
+    }
+
+    for (int n = 0; n < count; n++) {
+        int32_t mixedSample = (block.envelope[n] * block.samples[n]) / 1023;  // mix adsr
+        sval = mixedSample;
+
+        if (capture) {
+            capture[*captureIndex] = std::min(0xFFFF, std::max(-0xFFFF, mixedSample));
+            *captureIndex = (*captureIndex + 1) % 0x200;
+        }
+
+        if (fmodFreq) {  // fmod freq channel
+            iFMod[n] = sval;  // -> store 1T sample data, use that to do fmod on next channel
+            continue;
+        }
+
+        //////////////////////////////////////////////
+        // ok, left/right sound volume (psx volume goes from 0 ... 0x3fff)
+
+        if (muted) {
+            sval = 0;  // debug mute
+        } else {
+            SSumL[n] += (sval * leftVolume) / 0x4000L;
+            SSumR[n] += (sval * rightVolume) / 0x4000L;
+        }
+
+        //////////////////////////////////////////////
+        // now let us store sound data for reverb
+
+        if (reverb) StoreREVERB(pChannel, n);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////
 // MAIN SPU FUNCTION
 // here is the main job handler... thread, timer or direct func call
@@ -448,14 +584,19 @@ void PCSX::SPU::impl::MainThread() {
     SPUCHAN *pChannel;
     while (!bEndThread)  // until we are shutting down
     {
+        // while the output is held, the voices get mixed once it's released, from whichever state they're in then
+        if (m_outputHeld) {
+            std::unique_lock<std::mutex> lock(m_mixerMutex);
+            m_mixerWakeup.wait(lock, [this]() { return bEndThread || !m_outputHeld; });
+            continue;
+        }
+
         int voldiv = 4 - settings.get<Volume>();
         //--------------------------------------------------//
         // ok, at the beginning we are looking if there is
-        // enuff free place in the dsound/oss buffer to
-        // fill in new data, or if there is a new channel to start.
-        // if not, we wait (thread) or return (timer/spuasync)
-        // until enuff free place is available/a new channel gets
-        // started
+        // a new channel to start, or if the audio output went
+        // below the latency target. if not, we sleep until
+        // one of these happens
 
         if (dwNewChannel)    // new channel should start immedately?
         {                    // (at least one bit 0 ... MAXCHANNEL is set?)
@@ -466,29 +607,15 @@ void PCSX::SPU::impl::MainThread() {
         } else
             iSecureStart = 0;  // 0: no new channel should start
 
-        while (!iSecureStart && !bEndThread &&              // no new start? no thread end?
-               (m_audioOut.getBytesBuffered() > TESTSIZE))  // and still enuff data in sound buffer?
-        {
-            iSecureStart = 0;  // reset secure
-
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(5ms);
-
-            if (dwNewChannel)
-                iSecureStart =
-                    1;  // if a new channel kicks in (or, of course, sound buffer runs low), we will leave the loop
-        }
-
-        //--------------------------------------------------// continue from irq handling in timer mode?
-
-        if (lastch >= 0)  // will be -1 if no continue is pending
-        {
-            ch = lastch;
-            ns = lastns;
-            lastch = -1;  // -> setup all kind of vars to continue
-            pChannel = &s_chan[ch];
-            goto GOON;  // -> directly jump to the continue point
+        if (!iSecureStart) {
+            const bool waitForOutput = dwNewChannel != 0;
+            std::unique_lock<std::mutex> lock(m_mixerMutex);
+            m_mixerWakeup.wait(lock, [this, waitForOutput]() {
+                return bEndThread || (!waitForOutput && dwNewChannel) ||
+                       (m_audioOut.getBytesBuffered() < latencyFrames());
+            });
         }
+        if (bEndThread) break;
 
         tmpCapVoice1Index = capBufVoiceIndex;
         tmpCapVoice3Index = capBufVoiceIndex;
@@ -525,6 +652,11 @@ void PCSX::SPU::impl::MainThread() {
                     VoiceChangeFrequency(pChannel);
 
                 ns = 0;
+                bool stopped = false;
+                // Picked once for the whole block, as the interpolation is done after the fact.
+                const bool noise = pChannel->data.get<PCSX::SPU::Chan::Noise>().value;
+                const bool gauss = !noise && (pChannel->data.get<PCSX::SPU::Chan::FMod>().value != 2) &&
+                                   (settings.get<Interpolation>() == 2);
 
                 while (ns < NSSIZE)  // loop until 1 ms of data is reached
                 {
@@ -540,21 +672,8 @@ void PCSX::SPU::impl::MainThread() {
 
                             if (start == (uint8_t *)-1)  // special "stop" sign
                             {
-                                pChannel->data.get<PCSX::SPU::Chan::On>().value = false;  // -> turn everything off
-                                pChannel->ADSRX.get<exVolume>().value = 0;
-                                pChannel->ADSRX.get<exEnvelopeVol>().value = 0;
-                                // Although the voices may stop outputting audio, the capture buffer is still filling
-                                // up. At this point, ns samples are already filled, we need (NSSIZE-ns) more samples.
-                                if (pMixIrq && ch == 1) {
-                                    std::unique_lock<std::mutex> lock(cbMtx);
-                                    for (int c = ns; c < NSSIZE; c++) spuMem[tmpCapVoice1Index + c + 0x400] = 0;
-                                    tmpCapVoice1Index = (tmpCapVoice1Index + (NSSIZE - ns)) % 0x200;
-                                } else if (pMixIrq && ch == 3) {
-                                    std::unique_lock<std::mutex> lock(cbMtx);
-                                    for (int c = ns; c < NSSIZE; c++) spuMem[tmpCapVoice3Index + c + 0x600] = 0;
-                                    tmpCapVoice3Index = (tmpCapVoice3Index + (NSSIZE - ns)) % 0x200;
-                                }
-                                goto ENDX;  // -> and done for this channel
+                                stopped = true;
+                                goto MIX;  // -> mix what we have so far, and done for this channel
                             }
 
                             pChannel->data.get<PCSX::SPU::Chan::SBPos>().value = 0;
@@ -644,14 +763,10 @@ void PCSX::SPU::impl::MainThread() {
                                 bIRQReturn = 0;
                                 auto dwWatchTime = std::chrono::steady_clock::now() + 2500ms;
 
-                                while (iSpuAsyncWait && !bEndThread && std::chrono::steady_clock::now() < dwWatchTime) {
-                                    std::this_thread::sleep_for(1ms);
-                                }
+                                std::unique_lock<std::mutex> lock(m_mixerMutex);
+                                m_mixerWakeup.wait_until(lock, dwWatchTime,
+                                                         [this]() { return !iSpuAsyncWait || bEndThread; });
                             }
-
-                            ////////////////////////////////////////////
-
-                        GOON:;
                         }
 
                         fa = pChannel->data.get<PCSX::SPU::Chan::SB>()
@@ -665,51 +780,20 @@ void PCSX::SPU::impl::MainThread() {
 
                     ////////////////////////////////////////////////
 
-                    if (pChannel->data.get<PCSX::SPU::Chan::Noise>().value)
-                        fa = iGetNoiseVal(pChannel);  // get noise val
-                    else
-                        fa = iGetInterpolationVal(pChannel);  // get sample val
-
-                    int32_t mixedSample = (m_adsr.mix(pChannel) * fa) / 1023;  // mix adsr
-                    pChannel->data.get<PCSX::SPU::Chan::sval>().value = mixedSample;
-
-                    // Capture buffer should contain voice1/3 sample after any adsr processing but before volume
-                    // processing?
-                    mixedSample = std::min(0xFFFF, std::max(-0xFFFF, mixedSample));
-                    if (pMixIrq && ch == 1) {
-                        std::unique_lock<std::mutex> lock(cbMtx);
-                        spuMem[tmpCapVoice1Index + 0x400] = mixedSample;
-                        tmpCapVoice1Index = (tmpCapVoice1Index + 1) % 0x200;
-                    } else if (pMixIrq && ch == 3) {
-                        std::unique_lock<std::mutex> lock(cbMtx);
-                        spuMem[tmpCapVoice3Index + 0x600] = mixedSample;
-                        tmpCapVoice3Index = (tmpCapVoice3Index + 1) % 0x200;
-                    }
-
-                    if (pChannel->data.get<PCSX::SPU::Chan::FMod>().value == 2)  // fmod freq channel
-                        iFMod[ns] = pChannel->data.get<PCSX::SPU::Chan::sval>()
-                                        .value;  // -> store 1T sample data, use that to do fmod on next channel
-                    else                         // no fmod freq channel
-                    {
-                        //////////////////////////////////////////////
-                        // ok, left/right sound volume (psx volume goes from 0 ... 0x3fff)
-
-                        if (pChannel->data.get<PCSX::SPU::Chan::Mute>().value &&
-                            !pChannel->data.get<PCSX::SPU::Chan::Solo>().value)
-                            pChannel->data.get<PCSX::SPU::Chan::sval>().value = 0;  // debug mute
-                        else {
-                            SSumL[ns] += (pChannel->data.get<PCSX::SPU::Chan::sval>().value *
-                                          pChannel->data.get<PCSX::SPU::Chan::LeftVolume>().value) /
-                                         0x4000L;
-                            SSumR[ns] += (pChannel->data.get<PCSX::SPU::Chan::sval>().value *
-                                          pChannel->data.get<PCSX::SPU::Chan::RightVolume>().value) /
-                                         0x4000L;
-                        }
-
-                        //////////////////////////////////////////////
-                        // now let us store sound data for reverb
-
-                        if (pChannel->data.get<PCSX::SPU::Chan::RVBActive>().value) StoreREVERB(pChannel, ns);
+                    if (noise) {
+                        m_voiceBlock.samples[ns] = iGetNoiseVal(pChannel);  // get noise val
+                    } else if (gauss) {
+                        // the gauss window moves on with each decoded sample, so it's saved for later here
+                        auto &SB = pChannel->data.get<PCSX::SPU::Chan::SB>().value;
+                        int gpos = SB[28].value;
+                        auto &taps = m_voiceBlock.gaussTaps[ns];
+                        taps[0] = gval0;
+                        taps[1] = gval(1);
+                        taps[2] = gval(2);
+                        taps[3] = gval(3);
+                        m_voiceBlock.gaussIndex[ns] = (pChannel->data.get<PCSX::SPU::Chan::spos>().value >> 6) & ~3;
+                    } else {
+                        m_voiceBlock.samples[ns] = iGetInterpolationVal(pChannel);  // get sample val
                     }
 
                     ////////////////////////////////////////////////
@@ -719,7 +803,26 @@ void PCSX::SPU::impl::MainThread() {
                     pChannel->data.get<PCSX::SPU::Chan::spos>().value +=
                         pChannel->data.get<PCSX::SPU::Chan::sinc>().value;
                 }
-            ENDX:;
+
+            MIX:
+                MixVoiceBlock(pChannel, ch, ns, gauss, tmpCapVoice1Index, tmpCapVoice3Index);
+
+                if (stopped) {
+                    pChannel->data.get<PCSX::SPU::Chan::On>().value = false;  // -> turn everything off
+                    pChannel->ADSRX.get<exVolume>().value = 0;
+                    pChannel->ADSRX.get<exEnvelopeVol>().value = 0;
+                    // Although the voices may stop outputting audio, the capture buffer is still filling
+                    // up. At this point, ns samples are already filled, we need (NSSIZE-ns) more samples.
+                    if (pMixIrq && ch == 1) {
+                        std::unique_lock<std::mutex> lock(cbMtx);
+                        for (int c = ns; c < NSSIZE; c++) spuMem[tmpCapVoice1Index + c + 0x400] = 0;
+                        tmpCapVoice1Index = (tmpCapVoice1Index + (NSSIZE - ns)) % 0x200;
+                    } else if (pMixIrq && ch == 3) {
+                        std::unique_lock<std::mutex> lock(cbMtx);
+                        for (int c = ns; c < NSSIZE; c++) spuMem[tmpCapVoice3Index + c + 0x600] = 0;
+                        tmpCapVoice3Index = (tmpCapVoice3Index + (NSSIZE - ns)) % 0x200;
+                    }
+                }
             }
         }
 
@@ -733,17 +836,15 @@ void PCSX::SPU::impl::MainThread() {
         ///////////////////////////////////////////////////////
         // mix all channels (including reverb) into one buffer
 
-        for (ns = 0; ns < NSSIZE; ns++) {
-            SSumL[ns] += MixREVERBLeft(ns);
+        MixREVERB(SSumL, SSumR);
 
+        for (ns = 0; ns < NSSIZE; ns++) {
             d = SSumL[ns] / voldiv;
             SSumL[ns] = 0;
             if (d < -32767) d = -32767;
             if (d > 32767) d = 32767;
             *pS++ = d;
 
-            SSumR[ns] += MixREVERBRight();
-
             d = SSumR[ns] / voldiv;
             SSumR[ns] = 0;
             if (d < -32767) d = -32767;
@@ -791,22 +892,19 @@ void PCSX::SPU::impl::MainThread() {
 
         //////////////////////////////////////////////////////
         // feed the sound
-        // wanna have around 1/60 sec (16.666 ms) updates
-
-        if (iCycle++ > 16) {
-            bool done = false;
-            while (!done) {
-                done =
-                    m_audioOut.feedStreamData(reinterpret_cast<MiniAudio::Frame *>(pSpuBuffer),
-                                              (((uint8_t *)pS) - ((uint8_t *)pSpuBuffer)) / sizeof(MiniAudio::Frame));
-                if (bEndThread) {
-                    bThreadEnded = 1;
-                    return;
-                }
+        // every 1 ms block goes out right away, the amount of
+        // buffered audio being bounded by the latency target
+
+        bool done = false;
+        while (!done) {
+            done = m_audioOut.feedStreamData(reinterpret_cast<MiniAudio::Frame *>(pSpuBuffer),
+                                             (((uint8_t *)pS) - ((uint8_t *)pSpuBuffer)) / sizeof(MiniAudio::Frame));
+            if (bEndThread) {
+                bThreadEnded = 1;
+                return;
             }
-            pS = (int16_t *)pSpuBuffer;
-            iCycle = 0;
         }
+        pS = (int16_t *)pSpuBuffer;
     }
 
     // end of big main loop...
@@ -818,16 +916,14 @@ void PCSX::SPU::impl::writeCaptureBufferCD(int numbSamples) {
     if (pMixIrq) {
         std::unique_lock<std::mutex> lock(cbMtx);
         for (int n = 0; n < numbSamples; n++) {
-            if (captureBuffer.startIndex == captureBuffer.endIndex) {
+            uint16_t left, right;
+            if (!captureBuffer.pop(left, right)) {
                 // If there are no samples left in the temp buffer,
                 // we still HAVE to keep writing to the capture buffer.
-                spuMem[captureBuffer.currIndex] = 0;
-                spuMem[captureBuffer.currIndex + 0x200] = 0;
-            } else {
-                spuMem[captureBuffer.currIndex] = captureBuffer.CDCapLeft[captureBuffer.startIndex];
-                spuMem[captureBuffer.currIndex + 0x200] = captureBuffer.CDCapRight[captureBuffer.startIndex];
-                captureBuffer.startIndex = (captureBuffer.startIndex + 1) % CaptureBuffer::CB_SIZE;
+                left = right = 0;
             }
+            spuMem[captureBuffer.currIndex] = left;
+            spuMem[captureBuffer.currIndex + 0x200] = right;
             captureBuffer.currIndex = (captureBuffer.currIndex + 1) % 0x200;
         }
         // Update the capture buffer voice index, which in the end, should be the same as
@@ -851,9 +947,8 @@ void PCSX::SPU::impl::writeCaptureBufferCD(int numbSamples) {
 
 void PCSX::SPU::impl::async(uint32_t cycle) {
     if (iSpuAsyncWait) {
-        iSpuAsyncWait++;
-        if (iSpuAsyncWait <= 64) return;
-        iSpuAsyncWait = 0;
+        if (++iSpuAsyncWait <= 64) return;
+        ReleaseIRQWait();
     }
 }
 
@@ -863,6 +958,7 @@ void PCSX::SPU::impl::async(uint32_t cycle) {
 
 void PCSX::SPU::impl::playADPCMchannel(xa_decode_t *xap) {
     if (!settings.get<Streaming>()) return;  // no XA? bye
+    if (m_outputHeld) return;                // not meant to be heard? bye
     if (!xap) return;
     if (!xap->freq) return;  // no xa freq ? bye
 
@@ -911,7 +1007,10 @@ void PCSX::SPU::impl::SetupThread() {
     bThreadEnded = 0;
     bSpuInit = 1;  // flag: we are inited
 
-    hMainThread = std::thread([this]() { MainThread(); });
+    hMainThread = std::thread([this, emulator = g_emulator, system = g_system]() {
+        Emulator::Scope scope(emulator, system);
+        MainThread();
+    });
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -920,14 +1019,9 @@ void PCSX::SPU::impl::SetupThread() {
 
 void PCSX::SPU::impl::RemoveThread() {
     bEndThread = 1;  // raise flag to end thread
+    wakeMixer();
 
-    using namespace std::chrono_literals;
-    while (!bThreadEnded) {
-        std::this_thread::sleep_for(5ms);
-    }  // -> wait till thread has ended
-    std::this_thread::sleep_for(5ms);
-
-    hMainThread.join();
+    hMainThread.join();  // -> wait till thread has ended
 
     bThreadEnded = 0;  // no more spu is running
     bSpuInit = 0;
@@ -1042,6 +1136,7 @@ void PCSX::SPU::impl::registerCDDAVolume(void (*CDDAVcallback)(uint16_t, uint16_
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SPU::impl::playCDDAchannel(int16_t *data, int size) {
+    if (m_outputHeld) return;
     m_cdda.freq = 44100;
     m_cdda.nsamples = size / 4;
     m_cdda.stereo = 1;
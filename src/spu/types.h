@@ -155,6 +155,7 @@ struct REVERBInfo {
     int iLastRVBRight;
     int iRVBLeft;
     int iRVBRight;
+    int iCnt;  // output samples mixed so far, for the 22 khz phase
 
     int FB_SRC_A;     // (offset)
     int FB_SRC_B;     // (offset)
@@ -59,9 +59,7 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
 
     spos = 0x10000L;
     sinc = (xap->nsamples << 16) / iSize;  // calc freq by num / size
-
-    // We need the lock for capture buffers. The question is, do we put it here or in the inner loop?
-    if (pMixIrq) cbMtx.lock();
+    bool captureOverflow = false;
 
     if (xap->stereo) {
         uint32_t *pS = (uint32_t *)xap->pcm;
@@ -97,14 +95,7 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
             MiniAudio::Frame f;
             int16_t rawSampleL = static_cast<int16_t>(l & 0xffff);
             int16_t rawSampleR = static_cast<int16_t>(l >> 16);
-            if (pMixIrq) {
-                captureBuffer.CDCapLeft[captureBuffer.endIndex] = (uint16_t)rawSampleL;
-                captureBuffer.CDCapRight[captureBuffer.endIndex] = (uint16_t)rawSampleR;
-                captureBuffer.endIndex = (captureBuffer.endIndex + 1) % CaptureBuffer::CB_SIZE;
-                if (captureBuffer.endIndex == captureBuffer.startIndex) {
-                    g_system->log(LogClass::SPU, "Capture buffer is overflowing. Increase CB_SIZE.\n");
-                }
-            }
+            if (pMixIrq && !captureBuffer.push((uint16_t)rawSampleL, (uint16_t)rawSampleR)) captureOverflow = true;
             f.L = rawSampleL / voldiv;
             f.R = rawSampleR / voldiv;
 
@@ -142,14 +133,7 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
             int16_t rawSampleL = static_cast<int16_t>(l & 0xffff);
             int16_t rawSampleR = static_cast<int16_t>(l >> 16);
             // Write the CD-XA samples (left/right) to a temporary buffer. Wrap around if necessary.
-            if (pMixIrq) {
-                captureBuffer.CDCapLeft[captureBuffer.endIndex] = (uint16_t)rawSampleL;
-                captureBuffer.CDCapRight[captureBuffer.endIndex] = (uint16_t)rawSampleR;
-                captureBuffer.endIndex = (captureBuffer.endIndex + 1) % CaptureBuffer::CB_SIZE;
-                if (captureBuffer.endIndex == captureBuffer.startIndex) {
-                    g_system->log(LogClass::SPU, "Capture buffer is overflowing. Increase CB_SIZE.\n");
-                }
-            }
+            if (pMixIrq && !captureBuffer.push((uint16_t)rawSampleL, (uint16_t)rawSampleR)) captureOverflow = true;
 
             f.L = rawSampleL / voldiv;
             f.R = rawSampleR / voldiv;
@@ -157,7 +141,7 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
             spos += sinc;
         }
     }
-    if (pMixIrq) cbMtx.unlock();
+    if (captureOverflow) g_system->log(LogClass::SPU, "Capture buffer is overflowing. Increase CB_SIZE.\n");
 
     m_audioOut.feedStreamData(reinterpret_cast<MiniAudio::Frame *>(XABuffer), (XAFeed - XABuffer), 1);
 }
@@ -0,0 +1,188 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/benchmark.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "json.hpp"
+
+namespace {
+
+struct Registered {
+    std::string name;
+    PCSX::Benchmark::Function function;
+};
+
+// Function-local, as benchmarks get registered during static initialization, in no particular order.
+std::vector<Registered>& registry() {
+    static std::vector<Registered> benchmarks;
+    return benchmarks;
+}
+
+std::vector<PCSX::Benchmark::Result> s_results;
+double s_minTime = 0.5;
+
+}  // namespace
+
+PCSX::Benchmark::Registrar::Registrar(std::string name, Function function) {
+    registry().push_back({std::move(name), std::move(function)});
+}
+
+void PCSX::Benchmark::State::pauseTiming() {
+    if (m_paused) return;
+    m_elapsed += Clock::now() - m_start;
+    m_cpuElapsed += std::clock() - m_cpuStart;
+    m_paused = true;
+}
+
+void PCSX::Benchmark::State::resumeTiming() {
+    if (!m_paused) return;
+    m_paused = false;
+    m_cpuStart = std::clock();
+    m_start = Clock::now();
+}
+
+bool PCSX::Benchmark::State::nextBatch() {
+    if (!m_started) {
+        m_started = true;
+        m_batch = 1;
+        m_iterations = 1;
+        m_cpuStart = std::clock();
+        m_start = Clock::now();
+        return true;
+    }
+
+    const auto now = Clock::now();
+    const auto elapsed = m_elapsed + (m_paused ? Clock::duration{} : now - m_start);
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    if ((seconds >= m_minTime) || !m_error.empty()) {
+        pauseTiming();
+        return false;
+    }
+
+    // Clock reads aren't free, so the iterations run in batches, sized for the next one to be the last,
+    // without growing by more than 10 times at once, in case the first ones were unusually slow.
+    const double perIteration = std::max(seconds / m_iterations, 1e-9);
+    const double wanted = (m_minTime - seconds) * 1.2 / perIteration;
+    m_batch = std::clamp<uint64_t>(uint64_t(wanted), 1, m_batch * 10);
+    m_iterations += m_batch;
+    m_remaining = m_batch - 1;
+    return true;
+}
+
+void PCSX::Benchmark::setMinTime(double seconds) { s_minTime = seconds; }
+
+void PCSX::Benchmark::runAll(std::string_view filter) {
+    for (auto& benchmark : registry()) {
+        if (benchmark.name.find(filter) == std::string::npos) continue;
+        State state(s_minTime);
+        benchmark.function(state);
+        Result result;
+        result.name = benchmark.name;
+        result.iterations = state.m_iterations;
+        result.error = std::move(state.m_error);
+        if ((result.iterations == 0) && result.error.empty()) result.error = "the benchmark never ran its loop";
+        if ((result.iterations != 0) && result.error.empty()) {
+            const double seconds = std::chrono::duration<double>(state.m_elapsed).count();
+            const double cpuSeconds = double(state.m_cpuElapsed) / CLOCKS_PER_SEC;
+            result.realTime = seconds * 1e9 / result.iterations;
+            result.cpuTime = cpuSeconds * 1e9 / result.iterations;
+            if ((state.m_items != 0) && (seconds > 0)) result.itemsPerSecond = state.m_items / seconds;
+            if ((state.m_bytes != 0) && (seconds > 0)) result.bytesPerSecond = state.m_bytes / seconds;
+        }
+        s_results.push_back(std::move(result));
+    }
+}
+
+void PCSX::Benchmark::addResult(Result&& result) { s_results.push_back(std::move(result)); }
+
+const std::vector<PCSX::Benchmark::Result>& PCSX::Benchmark::results() { return s_results; }
+
+std::string PCSX::Benchmark::reportConsole() {
+    size_t width = 9;
+    for (auto& result : s_results) width = std::max(width, result.name.size());
+    std::string ret = fmt::format("{:<{}} {:>14} {:>14} {:>12} {:>16}\n", "Benchmark", width, "Time (ns)", "CPU (ns)",
+                                  "Iterations", "Rate");
+    for (auto& result : s_results) {
+        if (!result.error.empty()) {
+            ret += fmt::format("{:<{}} ERROR: {}\n", result.name, width, result.error);
+            continue;
+        }
+        std::string rate;
+        if (result.bytesPerSecond != 0) {
+            rate = fmt::format("{:.1f} MiB/s", result.bytesPerSecond / (1024.0 * 1024.0));
+        } else if (result.itemsPerSecond != 0) {
+            rate = fmt::format("{:.3f} M/s", result.itemsPerSecond / 1e6);
+        }
+        ret += fmt::format("{:<{}} {:>14.1f} {:>14.1f} {:>12} {:>16}\n", result.name, width, result.realTime,
+                           result.cpuTime, result.iterations, rate);
+    }
+    return ret;
+}
+
+std::string PCSX::Benchmark::reportJson() {
+    using json = nlohmann::json;
+    std::time_t now = std::time(nullptr);
+    json report;
+    report["context"] = {
+        {"date", fmt::format("{:%Y-%m-%dT%H:%M:%S}", *std::localtime(&now))},
+        {"num_cpus", std::thread::hardware_concurrency()},
+#ifdef NDEBUG
+        {"library_build_type", "release"},
+#else
+        {"library_build_type", "debug"},
+#endif
+    };
+    json benchmarks = json::array();
+    for (auto& result : s_results) {
+        json entry = {
+            {"name", result.name},
+            {"run_name", result.name},
+            {"run_type", "iteration"},
+            {"repetitions", 1},
+            {"repetition_index", 0},
+            {"threads", 1},
+            {"iterations", result.iterations},
+            {"real_time", result.realTime},
+            {"cpu_time", result.cpuTime},
+            {"time_unit", "ns"},
+        };
+        if (result.itemsPerSecond != 0) entry["items_per_second"] = result.itemsPerSecond;
+        if (result.bytesPerSecond != 0) entry["bytes_per_second"] = result.bytesPerSecond;
+        if (!result.error.empty()) {
+            entry["error_occurred"] = true;
+            entry["error_message"] = result.error;
+        }
+        benchmarks.push_back(std::move(entry));
+    }
+    report["benchmarks"] = std::move(benchmarks);
+    return report.dump(2) + "\n";
+}
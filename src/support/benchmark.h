@@ -0,0 +1,133 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PCSX {
+
+// A small benchmark harness, loosely modeled after Google Benchmark. Benchmarks register themselves
+// statically, and only get linked into the pcsx-redux-bench binary. They are run by the -bench command
+// line mode, once the emulator is set up, so that they may use any of it. The results then get reported
+// in Google Benchmark's JSON format, for tools comparing runs to be able to read them.
+namespace Benchmark {
+
+class State {
+    using Clock = std::chrono::steady_clock;
+
+  public:
+    // Loops over the timed code for as long as needed to get a stable measure: while (state.keepRunning()) {}
+    bool keepRunning() {
+        if (m_remaining != 0) {
+            m_remaining--;
+            return true;
+        }
+        return nextBatch();
+    }
+    // Leaves the setup code of an iteration out of the measure.
+    void pauseTiming();
+    void resumeTiming();
+    // The amount of work done over all of the iterations, reported as rates.
+    void setItemsProcessed(uint64_t items) { m_items = items; }
+    void setBytesProcessed(uint64_t bytes) { m_bytes = bytes; }
+    // Gives up on the benchmark, reporting why. Its loop needs to be exited right after.
+    void skipWithError(std::string_view message) {
+        m_error = message;
+        m_remaining = 0;
+    }
+    uint64_t iterations() const { return m_iterations; }
+
+  private:
+    friend void runAll(std::string_view);
+    State(double minTime) : m_minTime(minTime) {}
+    bool nextBatch();
+
+    const double m_minTime;
+    uint64_t m_remaining = 0;
+    uint64_t m_batch = 0;
+    uint64_t m_iterations = 0;
+    uint64_t m_items = 0;
+    uint64_t m_bytes = 0;
+    bool m_started = false;
+    bool m_paused = false;
+    Clock::time_point m_start;
+    Clock::duration m_elapsed = {};
+    std::clock_t m_cpuStart = 0;
+    std::clock_t m_cpuElapsed = 0;
+    std::string m_error;
+};
+
+using Function = std::function<void(State&)>;
+
+struct Result {
+    std::string name;
+    uint64_t iterations = 0;
+    // Per iteration, in nanoseconds.
+    double realTime = 0;
+    double cpuTime = 0;
+    // Zero when the benchmark didn't say how much work it did.
+    double itemsPerSecond = 0;
+    double bytesPerSecond = 0;
+    std::string error;
+};
+
+// Keeps the compiler from optimizing a computed value away.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+struct Registrar {
+    Registrar(std::string name, Function function);
+};
+
+// How long each benchmark runs for, in seconds, at the very least.
+void setMinTime(double seconds);
+// Runs the registered benchmarks whose name contains the filter, adding their results.
+void runAll(std::string_view filter);
+// For measures taken outside of the harness.
+void addResult(Result&& result);
+const std::vector<Result>& results();
+
+std::string reportConsole();
+std::string reportJson();
+
+}  // namespace Benchmark
+
+}  // namespace PCSX
@@ -33,10 +33,17 @@ SOFTWARE.
 #include <condition_variable>
 #include <mutex>
 #include <stdexcept>
+#include <thread>
+
+#include "support/spsc.h"
 
 namespace PCSX {
 
-template <typename T, size_t BS = 1024>
+// Locked is safe with any number of threads on either side, while SPSC requires exactly one producer
+// thread and one consumer thread, but never takes a lock.
+enum class CircularPolicy { Locked, SPSC };
+
+template <typename T, size_t BS = 1024, CircularPolicy P = CircularPolicy::Locked>
 class Circular {
     using ms = std::chrono::milliseconds;
 
@@ -106,4 +113,57 @@ class Circular {
     std::mutex m_mu;
     std::condition_variable m_cv;
 };
+
+// The same interface, on top of SPSCRing. Atomic waits can't time out, so a bounded enqueue polls for
+// room, yielding first and then sleeping briefly. An unbounded one, with ms::max(), blocks on the ring.
+template <typename T, size_t BS>
+class Circular<T, BS, CircularPolicy::SPSC> {
+    using ms = std::chrono::milliseconds;
+
+  public:
+    static constexpr size_t BUFFER_SIZE = BS;
+    size_t available() const { return m_ring.available(); }
+    size_t buffered() const { return m_ring.buffered(); }
+    bool enqueue(const T* data, size_t N, ms maxWait = ms{200}) {
+        if (N > BUFFER_SIZE) {
+            throw std::runtime_error("Trying to enqueue too much data");
+        }
+        if (!hasRoom(N)) {
+            if ((maxWait == ms::max()) && (N < BUFFER_SIZE)) {
+                m_ring.waitForSpace(N + 1);
+            } else if (!pollForRoom(N, maxWait)) {
+                return false;
+            }
+        }
+        m_ring.write(data, N);
+        m_ring.commit(N);
+        return true;
+    }
+    size_t dequeue(T* data, size_t N) {
+        N = std::min(N, m_ring.buffered());
+        m_ring.read(data, N);
+        m_ring.consume(N);
+        return N;
+    }
+
+  private:
+    // Same as the locked version, which never fills the buffer completely.
+    bool hasRoom(size_t N) const { return N < m_ring.available(); }
+    bool pollForRoom(size_t N, ms maxWait) const {
+        const auto deadline = std::chrono::steady_clock::now() + maxWait;
+        unsigned spins = 0;
+        while (!hasRoom(N)) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            if (spins++ < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        return true;
+    }
+
+    SPSCRing<T, BS> m_ring;
+};
+
 }  // namespace PCSX
@@ -26,104 +26,210 @@ SOFTWARE.
 
 #pragma once
 
-#include <any>
-#include <functional>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
-
-#include "support/hashtable.h"
-#include "support/list.h"
-
-#if defined(_CPPRTTI) || defined(__GXX_RTTI) || defined(__cpp_rtti)
-#define PCSX_RTTI 1
-#include <typeindex>
-#include <typeinfo>
-#define PCSX_HASH_TYPE(type) typeid(type).hash_code()
-#else
-#define PCSX_RTTI 0
-#define CTTI_HAS_ENUM_AWARE_PRETTY_FUNCTION 1
-#include "ctti/type_id.hpp"
-#define PCSX_HASH_TYPE(type) ctti::unnamed_type_id<type>().hash()
-#endif
+#include <vector>
 
 namespace PCSX {
 
 namespace EventBus {
 
-#if PCSX_RTTI
-typedef std::size_t HashType;
-#else
-typedef std::uint64_t HashType;
-#endif
-
-struct ListenerElementBaseEventBusList {};
-struct ListenerElementBase;
-typedef PCSX::Intrusive::List<ListenerElementBase> ListenerBaseListType;
-typedef PCSX::Intrusive::List<ListenerElementBase, ListenerElementBaseEventBusList> ListenerBaseEventBusList;
-struct ListenerElementBase : public ListenerBaseListType::Node, public ListenerBaseEventBusList::Node {
-    virtual std::any getCB() = 0;
-};
-template <typename M>
-struct ListenerElement : public ListenerElementBase {
-    typedef std::function<void(const M&)> Functor;
-    virtual std::any getCB() { return &cb; }
-    ListenerElement(Functor&& cb) : cb(std::move(cb)) {}
-    Functor cb;
-};
+// Each event type gets a small dense index the first time it's used, which the bus uses to find
+// its listeners with a plain array lookup.
+inline size_t nextEventSlot() {
+    static std::atomic<size_t> counter = 0;
+    return counter++;
+}
+template <typename Event>
+size_t eventSlot() {
+    static const size_t slot = nextEventSlot();
+    return slot;
+}
 
 class EventBus;
+class Listener;
+
+// One registered callback. Small callables are stored inline, so listening doesn't allocate beyond
+// the bus' own arrays, and calling one is a single indirect call through a typed trampoline.
+class ListenerEntry {
+  public:
+    template <typename Event, typename F>
+    static ListenerEntry create(Listener* owner, F&& cb) {
+        using Functor = std::decay_t<F>;
+        ListenerEntry entry;
+        entry.m_owner = owner;
+        if constexpr (fitsInline<Functor>()) {
+            new (entry.m_storage) Functor(std::forward<F>(cb));
+            entry.m_call = [](void* storage, const void* event) {
+                (*std::launder(reinterpret_cast<Functor*>(storage)))(*static_cast<const Event*>(event));
+            };
+            entry.m_relocate = [](void* from, void* to) {
+                Functor* f = std::launder(reinterpret_cast<Functor*>(from));
+                new (to) Functor(std::move(*f));
+                f->~Functor();
+            };
+            entry.m_destroy = [](void* storage) { std::launder(reinterpret_cast<Functor*>(storage))->~Functor(); };
+        } else {
+            new (entry.m_storage) Functor*(new Functor(std::forward<F>(cb)));
+            entry.m_call = [](void* storage, const void* event) {
+                (**reinterpret_cast<Functor**>(storage))(*static_cast<const Event*>(event));
+            };
+            entry.m_relocate = [](void* from, void* to) { memcpy(to, from, sizeof(Functor*)); };
+            entry.m_destroy = [](void* storage) { delete *reinterpret_cast<Functor**>(storage); };
+        }
+        return entry;
+    }
+    ListenerEntry(ListenerEntry&& other) noexcept { take(other); }
+    ListenerEntry& operator=(ListenerEntry&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+    ListenerEntry(const ListenerEntry&) = delete;
+    ListenerEntry& operator=(const ListenerEntry&) = delete;
+    ~ListenerEntry() { reset(); }
+
+    void call(const void* event) { m_call(m_storage, event); }
+    Listener* owner() const { return m_owner; }
+    // Removed entries stay in place, and don't get called anymore, until the bus isn't dispatching.
+    bool alive() const { return m_owner != nullptr; }
+    void kill() { m_owner = nullptr; }
+
+  private:
+    static constexpr size_t c_inlineSize = 6 * sizeof(void*);
+    template <typename Functor>
+    static constexpr bool fitsInline() {
+        return (sizeof(Functor) <= c_inlineSize) && (alignof(Functor) <= alignof(std::max_align_t)) &&
+               std::is_nothrow_move_constructible_v<Functor>;
+    }
+    ListenerEntry() = default;
+    void take(ListenerEntry& other) {
+        m_call = other.m_call;
+        m_relocate = other.m_relocate;
+        m_destroy = other.m_destroy;
+        m_owner = other.m_owner;
+        if (m_relocate) m_relocate(other.m_storage, m_storage);
+        other.m_relocate = nullptr;
+        other.m_destroy = nullptr;
+        other.m_owner = nullptr;
+    }
+    void reset() {
+        if (m_destroy) m_destroy(m_storage);
+        m_relocate = nullptr;
+        m_destroy = nullptr;
+        m_owner = nullptr;
+    }
+
+    void (*m_call)(void* storage, const void* event) = nullptr;
+    void (*m_relocate)(void* from, void* to) = nullptr;
+    void (*m_destroy)(void* storage) = nullptr;
+    Listener* m_owner = nullptr;
+    alignas(std::max_align_t) std::byte m_storage[c_inlineSize];
+};
 
 class Listener {
   public:
     Listener(std::shared_ptr<EventBus> bus) : m_bus(bus) {}
-    ~Listener() { m_listeners.destroyAll(); }
-    template <typename Event>
-    void listen(typename ListenerElement<Event>::Functor&& cb);
+    ~Listener();
+    Listener(const Listener&) = delete;
+    Listener& operator=(const Listener&) = delete;
+    template <typename Event, typename F>
+    void listen(F&& cb);
 
   private:
     std::shared_ptr<EventBus> m_bus;
-    ListenerBaseListType m_listeners;
-};
-
-struct ListenerElementsHashTableList;
-typedef PCSX::Intrusive::HashTable<HashType, ListenerElementsHashTableList> ListenersHashTable;
-struct ListenerElementsHashTableList : public ListenersHashTable::Node {
-    ~ListenerElementsHashTableList() { list.destroyAll(); }
-    ListenerBaseEventBusList list;
+    // The slots this listener registered into, so it can unregister without walking the whole bus.
+    std::vector<size_t> m_slots;
 };
 
 class EventBus {
   public:
-    ~EventBus() { m_table.destroyAll(); }
     template <typename Event>
     void signal(const Event& event) {
-        using Functor = typename ListenerElement<Event>::Functor;
-        auto list = m_table.find(PCSX_HASH_TYPE(Event));
-        if (list == m_table.end()) return;
-        for (auto& listener : list->list) {
-            std::any cb = listener.getCB();
-            Functor* func = std::any_cast<Functor*>(cb);
-            (*func)(event);
+        const size_t slot = eventSlot<Event>();
+        if (slot >= m_slots.size()) return;
+        auto& entries = m_slots[slot];
+        if (entries.empty()) return;
+        // Listeners added or removed by a callback get applied once the outermost signal is done,
+        // so the arrays can't move around while they're being walked.
+        Dispatching dispatching(this);
+        const size_t count = entries.size();
+        for (size_t i = 0; i < count; i++) {
+            auto& entry = entries[i];
+            if (entry.alive()) entry.call(&event);
         }
     }
 
   private:
-    void listen(HashType id, ListenerElementBase* listenerElement) {
-        auto list = m_table.find(id);
-        if (list == m_table.end()) {
-            list = m_table.insert(id, new ListenerElementsHashTableList());
+    struct Dispatching {
+        Dispatching(EventBus* bus) : bus(bus) { bus->m_dispatching++; }
+        ~Dispatching() {
+            if ((--bus->m_dispatching == 0) && bus->m_dirty) bus->applyDeferred();
+        }
+        EventBus* bus;
+    };
+    void add(size_t slot, ListenerEntry&& entry) {
+        if (m_dispatching) {
+            m_deferred.emplace_back(slot, std::move(entry));
+            m_dirty = true;
+            return;
         }
-        list->list.push_back(listenerElement);
+        if (slot >= m_slots.size()) m_slots.resize(slot + 1);
+        m_slots[slot].push_back(std::move(entry));
     }
-    ListenersHashTable m_table;
+    void remove(Listener* owner, const std::vector<size_t>& slots) {
+        for (auto slot : slots) {
+            if (slot < m_slots.size()) {
+                for (auto& entry : m_slots[slot]) {
+                    if (entry.owner() == owner) entry.kill();
+                }
+            }
+        }
+        for (auto& [slot, entry] : m_deferred) {
+            if (entry.owner() == owner) entry.kill();
+        }
+        if (m_dispatching) {
+            m_dirty = true;
+        } else {
+            applyDeferred();
+        }
+    }
+    void applyDeferred() {
+        m_dirty = false;
+        for (auto& entries : m_slots) {
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [](auto& entry) { return !entry.alive(); }),
+                          entries.end());
+        }
+        auto deferred = std::move(m_deferred);
+        m_deferred.clear();
+        for (auto& [slot, entry] : deferred) {
+            if (entry.alive()) add(slot, std::move(entry));
+        }
+    }
+
+    std::vector<std::vector<ListenerEntry>> m_slots;
+    std::vector<std::pair<size_t, ListenerEntry>> m_deferred;
+    unsigned m_dispatching = 0;
+    bool m_dirty = false;
     friend class Listener;
 };
 
-template <typename Event>
-void Listener::listen(typename ListenerElement<Event>::Functor&& cb) {
-    ListenerElement<Event>* element = new ListenerElement(std::move(cb));
-    m_listeners.push_back(element);
-    m_bus->listen(PCSX_HASH_TYPE(Event), element);
+inline Listener::~Listener() { m_bus->remove(this, m_slots); }
+
+template <typename Event, typename F>
+void Listener::listen(F&& cb) {
+    const size_t slot = eventSlot<Event>();
+    if (std::find(m_slots.begin(), m_slots.end(), slot) == m_slots.end()) m_slots.push_back(slot);
+    m_bus->add(slot, ListenerEntry::create<Event>(this, std::forward<F>(cb)));
 }
 
 }  // namespace EventBus
@@ -0,0 +1,135 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <limits>
+
+namespace PCSX {
+
+// A fixed set of N event sources, numbered from 0 to N - 1, each of which has at most one pending deadline.
+// This is a binary min-heap which also remembers where each source sits in it, so that scheduling,
+// rescheduling, cancelling and popping an event are all O(log N), and the next deadline is always at hand.
+// Events with the same deadline come out in the order of their ids.
+template <unsigned N>
+class EventQueue {
+    static_assert(N > 0 && N < 256, "The queue holds between 1 and 255 event sources");
+
+  public:
+    static constexpr unsigned SIZE = N;
+    static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+    EventQueue() { clear(); }
+
+    void clear() {
+        m_size = 0;
+        for (auto& position : m_positions) position = NOWHERE;
+    }
+    bool empty() const { return m_size == 0; }
+    unsigned size() const { return m_size; }
+    bool scheduled(unsigned id) const { return m_positions[id] != NOWHERE; }
+    uint64_t nextDeadline() const { return m_size ? m_heap[0].deadline : NEVER; }
+
+    // Schedules the event, replacing its previous deadline if it was already pending.
+    void schedule(unsigned id, uint64_t deadline) {
+        unsigned pos = m_positions[id];
+        if (pos == NOWHERE) {
+            pos = m_size++;
+        } else if (deadline > m_heap[pos].deadline) {
+            siftDown(pos, {deadline, uint8_t(id)});
+            return;
+        }
+        siftUp(pos, {deadline, uint8_t(id)});
+    }
+    void cancel(unsigned id) {
+        const unsigned pos = m_positions[id];
+        if (pos == NOWHERE) return;
+        m_positions[id] = NOWHERE;
+        removeAt(pos);
+    }
+    // Removes the earliest event if it's due at or before now, and returns its id. Returns -1 otherwise.
+    int popDue(uint64_t now) {
+        if ((m_size == 0) || (m_heap[0].deadline > now)) return -1;
+        const unsigned id = m_heap[0].id;
+        m_positions[id] = NOWHERE;
+        removeAt(0);
+        return id;
+    }
+
+  private:
+    static constexpr uint8_t NOWHERE = 0xff;
+    struct Entry {
+        uint64_t deadline;
+        uint8_t id;
+    };
+    static bool before(const Entry& a, const Entry& b) {
+        return (a.deadline < b.deadline) || ((a.deadline == b.deadline) && (a.id < b.id));
+    }
+
+    void place(unsigned pos, const Entry& entry) {
+        m_heap[pos] = entry;
+        m_positions[entry.id] = pos;
+    }
+    // Both sift functions move the hole at pos until the entry can go there.
+    void siftUp(unsigned pos, const Entry& entry) {
+        while (pos > 0) {
+            const unsigned parent = (pos - 1) / 2;
+            if (!before(entry, m_heap[parent])) break;
+            place(pos, m_heap[parent]);
+            pos = parent;
+        }
+        place(pos, entry);
+    }
+    void siftDown(unsigned pos, const Entry& entry) {
+        while (true) {
+            unsigned child = pos * 2 + 1;
+            if (child >= m_size) break;
+            if ((child + 1 < m_size) && before(m_heap[child + 1], m_heap[child])) child++;
+            if (!before(m_heap[child], entry)) break;
+            place(pos, m_heap[child]);
+            pos = child;
+        }
+        place(pos, entry);
+    }
+    // The last entry gets moved in the hole, which can then need to go either way.
+    void removeAt(unsigned pos) {
+        const Entry last = m_heap[--m_size];
+        if (pos == m_size) return;
+        if ((pos > 0) && before(last, m_heap[(pos - 1) / 2])) {
+            siftUp(pos, last);
+        } else {
+            siftDown(pos, last);
+        }
+    }
+
+    Entry m_heap[N];
+    uint8_t m_positions[N];
+    unsigned m_size;
+};
+
+}  // namespace PCSX
@@ -27,7 +27,9 @@ SOFTWARE.
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <bit>
+#include <iterator>
 
 AVSampleFormat PCSX::FFmpegAudioFile::getSampleFormat() const {
     switch (m_sampleFormat) {
@@ -65,7 +67,12 @@ unsigned PCSX::FFmpegAudioFile::getSampleSize() const {
 
 PCSX::FFmpegAudioFile::FFmpegAudioFile(IO<File> file, Channels channels, Endianness endianess,
                                        SampleFormat sampleFormat, unsigned frequency)
-    : File(RO_SEEKABLE), m_file(file), m_channels(channels), m_endianess(endianess), m_sampleFormat(sampleFormat) {
+    : File(RO_SEEKABLE),
+      m_file(file),
+      m_channels(channels),
+      m_endianess(endianess),
+      m_sampleFormat(sampleFormat),
+      m_frequency(frequency) {
     av_log_set_level(AV_LOG_QUIET);
 
     unsigned char *buffer = reinterpret_cast<unsigned char *>(av_malloc(4096));
@@ -204,39 +211,92 @@ ssize_t PCSX::FFmpegAudioFile::rSeek(ssize_t pos, int wheel) {
 
 ssize_t PCSX::FFmpegAudioFile::read(void *dest_, size_t size) {
     uint8_t *dest = reinterpret_cast<uint8_t *>(dest_);
+    if (m_failed) return -1;
 
-    ssize_t dumpDelta = m_filePtr - m_totalOut;
-    if (dumpDelta < 0) {
-        dumpDelta = m_filePtr;
-        m_filePtr = 0;
-        m_hitEOF = false;
-        if (av_seek_frame(m_formatContext, m_audioStreamIndex, 0, AVSEEK_FLAG_BYTE) < 0) return -1;
-        m_totalOut = 0;
-    }
-    if (m_hitEOF) return -1;
+    m_hitEOF = false;
     ssize_t ret = 0;
-    while (dumpDelta) {
-        uint8_t dummy[256];
-        ssize_t toDump = std::min(ssize_t(sizeof(dummy)), dumpDelta);
-        ssize_t p = decompSome(dummy, toDump);
-        if (p < 0) return p;
-        dumpDelta -= p;
-        if (m_hitEOF || !p) break;
-    }
     while (size) {
-        if (m_hitEOF) break;
-        ssize_t p = decompSome(dest, size);
-        if (p < 0) return p;
-        if (!p) break;
-        size -= p;
-        ret += p;
-        dest += p;
-        m_filePtr += p;
+        const size_t offset = m_filePtr % c_chunkSize;
+        auto chunk = getChunk(m_filePtr / c_chunkSize);
+        if (!chunk) return ret ? ret : -1;
+        if (offset >= chunk->size()) {
+            m_hitEOF = true;
+            break;
+        }
+        const size_t toCopy = std::min(size, chunk->size() - offset);
+        memcpy(dest, chunk->data() + offset, toCopy);
+        size -= toCopy;
+        ret += toCopy;
+        dest += toCopy;
+        m_filePtr += toCopy;
     }
 
+    if (m_hitEOF && (ret == 0)) return -1;
     return ret;
 }
 
+const std::vector<uint8_t> *PCSX::FFmpegAudioFile::getChunk(size_t index) {
+    auto cached = std::find_if(m_cache.begin(), m_cache.end(), [index](auto &c) { return c.index == index; });
+    if (cached != m_cache.end()) {
+        m_cache.splice(m_cache.begin(), m_cache, cached);
+        return &m_cache.front().data;
+    }
+
+    // Reading linearly, the decoder is already right where the chunk starts.
+    if (!seekDecoder(index * c_chunkSize)) return nullptr;
+    std::vector<uint8_t> data(c_chunkSize);
+    size_t decoded = 0;
+    while ((decoded < c_chunkSize) && !m_decoderEOF) {
+        ssize_t p = decompSome(data.data() + decoded, c_chunkSize - decoded);
+        if (p < 0) return nullptr;
+        decoded += p;
+    }
+    data.resize(decoded);
+
+    if (m_cache.size() >= c_cachedChunks) m_cache.pop_back();
+    m_cache.push_front({index, std::move(data)});
+    return &m_cache.front().data;
+}
+
+bool PCSX::FFmpegAudioFile::seekDecoder(ssize_t target) {
+    // Going backward, or further forward than the index spacing, restarts the decoder from the closest
+    // indexed point before the target, if that's any closer, or from the beginning otherwise.
+    if ((target < m_totalOut) || ((target - m_totalOut) > ssize_t(c_chunkSize))) {
+        auto next = std::upper_bound(m_index.begin(), m_index.end(), target,
+                                     [](ssize_t offset, const IndexEntry &entry) { return offset < entry.offset; });
+        const IndexEntry *entry = next == m_index.begin() ? nullptr : &*std::prev(next);
+        if (target < m_totalOut) {
+            if (!restartDecoder(entry)) return false;
+        } else if (entry && (entry->offset > m_totalOut)) {
+            if (!restartDecoder(entry)) return false;
+        }
+    }
+    while ((m_totalOut < target) && !m_decoderEOF) {
+        uint8_t dummy[4096];
+        ssize_t p = decompSome(dummy, std::min(ssize_t(sizeof(dummy)), target - m_totalOut));
+        if (p < 0) return false;
+    }
+    return true;
+}
+
+bool PCSX::FFmpegAudioFile::restartDecoder(const IndexEntry *entry) {
+    if (entry) {
+        if (av_seek_frame(m_formatContext, m_audioStreamIndex, entry->pts, AVSEEK_FLAG_BACKWARD) < 0) return false;
+        m_totalOut = entry->offset;
+        m_skipToPts = entry->pts;
+    } else {
+        if (av_seek_frame(m_formatContext, m_audioStreamIndex, 0, AVSEEK_FLAG_BYTE) < 0) return false;
+        m_totalOut = 0;
+        m_skipToPts = AV_NOPTS_VALUE;
+    }
+    avcodec_flush_buffers(m_codecContext);
+    if (swr_init(m_resamplerContext) < 0) return false;
+    m_resampledFrame->nb_samples = 0;
+    m_packetPtr = 0;
+    m_decoderEOF = false;
+    return true;
+}
+
 ssize_t PCSX::FFmpegAudioFile::decompSome(void *dest_, ssize_t size) {
     unsigned sampleSize = getSampleSize();
     if (m_channels == Channels::Stereo) sampleSize *= 2;
@@ -275,13 +335,24 @@ ssize_t PCSX::FFmpegAudioFile::decompSome(void *dest_, ssize_t size) {
         if (available == 0) {
             while (true) {
                 if (av_read_frame(m_formatContext, m_packet) < 0) {
-                    m_hitEOF = true;
+                    m_decoderEOF = true;
                     return dataRead;
                 }
                 if (m_packet->stream_index != m_audioStreamIndex) {
                     av_packet_unref(m_packet);
                     continue;
                 }
+                const int64_t pts = m_packet->pts;
+                if (pts != AV_NOPTS_VALUE) {
+                    if ((m_skipToPts != AV_NOPTS_VALUE) && (pts < m_skipToPts)) {
+                        av_packet_unref(m_packet);
+                        continue;
+                    }
+                    // Everything before this packet got output, so this is exactly where its own output starts.
+                    const ssize_t next = m_index.empty() ? c_chunkSize : m_index.back().offset + c_chunkSize;
+                    if (m_totalOut >= next) m_index.push_back({pts, m_totalOut});
+                }
+                m_skipToPts = AV_NOPTS_VALUE;
                 break;
             }
             if (avcodec_send_packet(m_codecContext, m_packet) < 0) return -1;
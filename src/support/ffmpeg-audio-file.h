@@ -34,6 +34,9 @@ extern "C" {
 #include <libswresample/swresample.h>
 }
 
+#include <list>
+#include <vector>
+
 #include "support/file.h"
 
 namespace PCSX {
@@ -59,10 +62,29 @@ class FFmpegAudioFile : public File {
     virtual bool failed() final override { return m_failed || m_file->failed(); }
 
   private:
+    // The decoded output is cached in chunks of this size, which is a whole number of CD sectors and of samples
+    // in any format. It's also the spacing of the seek index.
+    static constexpr size_t c_chunkSize = 2352 * 32;
+    static constexpr size_t c_cachedChunks = 32;
+
+    // Where an audio packet's output starts, recorded the first time it gets decoded, so that seeking there
+    // later on doesn't need to decode everything before it again.
+    struct IndexEntry {
+        int64_t pts;
+        ssize_t offset;
+    };
+    struct CachedChunk {
+        size_t index;
+        std::vector<uint8_t> data;
+    };
+
     virtual void closeInternal() final override;
     AVSampleFormat getSampleFormat() const;
     unsigned getSampleSize() const;
     ssize_t decompSome(void* dest, ssize_t size);
+    const std::vector<uint8_t>* getChunk(size_t index);
+    bool seekDecoder(ssize_t target);
+    bool restartDecoder(const IndexEntry* entry);
     IO<File> m_file;
     ssize_t m_filePtr = 0;
     ssize_t m_size = 0;
@@ -80,8 +102,15 @@ class FFmpegAudioFile : public File {
     AVCodecContext* m_codecContext = nullptr;
     SwrContext* m_resamplerContext = nullptr;
     int m_audioStreamIndex = -1;
+    // The decoder's own position, in the output, which only matches m_filePtr when reading linearly.
     ssize_t m_totalOut = 0;
     size_t m_packetPtr = 0;
+    bool m_decoderEOF = false;
+    // After seeking to an index entry, the packets before it get dropped.
+    int64_t m_skipToPts = AV_NOPTS_VALUE;
+    std::vector<IndexEntry> m_index;
+    // Most recently used first.
+    std::list<CachedChunk> m_cache;
 };
 
 }  // namespace PCSX
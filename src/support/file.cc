@@ -159,6 +159,13 @@ PCSX::File *PCSX::BufferFile::dup() {
     }
 }
 
+PCSX::Slice PCSX::BufferFile::viewAt(size_t size, size_t pos) {
+    Slice ret;
+    if (pos >= m_size) return ret;
+    ret.borrow(m_data + pos, std::min(size, m_size - pos));
+    return ret;
+}
+
 PCSX::Slice PCSX::BufferFile::borrow(size_t offset) {
     Slice ret;
     ret.borrow(m_data + offset, m_size - offset);
@@ -312,26 +319,8 @@ ssize_t PCSX::SubFile::readAt(void *dest, size_t size, size_t ptr) {
     return m_file->readAt(dest, size, ptr + m_start);
 }
 
-ssize_t PCSX::Fifo::read(void *dest_, size_t size) {
+ssize_t PCSX::Fifo::read(void *dest, size_t size) {
     if (size == 0) return 0;
-    uint8_t *dest = static_cast<uint8_t *>(dest_);
-    ssize_t ret = 0;
-    while (size != 0) {
-        if (m_slices.empty()) {
-            return ret == 0 ? -1 : ret;
-        }
-        Slice &slice = m_slices.front();
-        auto tocopy = std::min(size, slice.size() - m_ptrR);
-        memcpy(dest + ret, slice.data<uint8_t>() + m_ptrR, tocopy);
-        size -= tocopy;
-        ret += tocopy;
-        m_size -= tocopy;
-        m_ptrR += tocopy;
-        if (slice.size() == m_ptrR) {
-            m_slices.pop();
-            m_ptrR = 0;
-        }
-    }
-
-    return ret;
+    if (m_slices.empty()) return -1;
+    return m_slices.read(dest, size);
 }
@@ -94,6 +94,8 @@ class File {
         return ret;
     }
     virtual void writeAt(Slice&& slice, size_t ptr) { writeAt(slice.data(), slice.size(), ptr); }
+    // A hint that this range is going to be read soon, so that it can be fetched in one go.
+    virtual void prefetch(size_t ptr, size_t size) {}
     virtual bool eof() { return rTell() == size(); }
     virtual std::filesystem::path filename() { return ""; }
     virtual File* dup() { throw std::runtime_error("Cannot duplicate file"); };
@@ -166,6 +168,12 @@ class File {
         return slice;
     }
 
+    // Same as above, but files backed by memory that can be referenced directly will
+    // return a borrowed slice pointing into it instead of a copy. Such a view is only
+    // valid for as long as the file is alive and its underlying memory isn't moved, and
+    // will reflect any later write to it. Other files simply return a copy.
+    virtual Slice viewAt(size_t size, size_t pos) { return readAt(size, pos); }
+
     std::string readString(size_t size) {
         std::string r(size, '\0');
         read(r.data(), size);
@@ -373,6 +381,7 @@ class BufferFile : public File {
     virtual ssize_t write(const void* dest, size_t size) final override;
     virtual bool eof() final override;
     virtual File* dup() final override;
+    virtual Slice viewAt(size_t size, size_t pos) final override;
 
     Slice borrow(size_t offset = 0);
 
@@ -462,6 +471,7 @@ class SubFile : public File {
     virtual size_t size() final override { return m_size; }
     virtual ssize_t read(void* dest, size_t size) final override;
     virtual ssize_t readAt(void* dest, size_t size, size_t ptr) final override;
+    virtual void prefetch(size_t ptr, size_t size) final override { m_file->prefetch(m_start + ptr, size); }
     virtual bool eof() final override { return m_ptrR == m_size; }
     virtual File* dup() final override { return new SubFile(m_file, m_start, m_size); }
     virtual bool failed() final override { return m_file->failed(); }
@@ -476,24 +486,19 @@ class SubFile : public File {
 class Fifo : public File {
   public:
     Fifo() : File(RO_STREAM) {}
-    void reset() {
-        m_size = 0;
-        m_ptrR = 0;
-        while (!m_slices.empty()) m_slices.pop();
-    }
-    virtual size_t size() final override { return m_size; }
+    void reset() { m_slices.clear(); }
+    virtual size_t size() final override { return m_slices.size(); }
     virtual ssize_t read(void* dest, size_t size) final override;
     virtual bool eof() final override { return m_slices.empty(); }
 
-    void pushSlice(Slice&& slice) {
-        m_size += slice.size();
-        m_slices.emplace(std::move(slice));
-    }
+    void pushSlice(Slice&& slice) { m_slices.push(std::move(slice)); }
+    void pushSlices(SliceChain&& slices) { m_slices.push(std::move(slices)); }
+    // Hands over everything buffered so far, for consumers which can deal with the slices as they are,
+    // rather than having them copied out through read().
+    SliceChain takeSlices() { return std::move(m_slices); }
 
   private:
-    std::queue<Slice> m_slices;
-    size_t m_ptrR = 0;
-    size_t m_size = 0;
+    SliceChain m_slices;
 };
 
 }  // namespace PCSX
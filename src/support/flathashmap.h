@@ -0,0 +1,330 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <bit>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace PCSX {
+
+// An open addressing hash map, in the spirit of the Swiss tables: one control byte per slot holds 7 bits of
+// the hash of its key, and the probing looks at 8 of them at a time, so a lookup only touches the slots
+// whose key is likely to match. Keys and values are stored inline, without any per-element allocation.
+//
+// Its interface is a subset of std::unordered_map's, with one notable difference: an insertion can move all
+// of the elements around, so pointers and iterators to them don't survive it. Erasing doesn't move anything,
+// and erase(iterator) returns the next element, so erasing while iterating is fine.
+template <typename Key, typename T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class FlatHashMap final {
+  public:
+    typedef std::pair<Key, T> value_type;
+
+  private:
+    static constexpr unsigned c_groupSize = 8;
+    static constexpr size_t c_minCapacity = 16;
+    static constexpr uint8_t c_empty = 0x80;
+    static constexpr uint8_t c_deleted = 0xfe;
+    static constexpr uint64_t c_lsbs = 0x0101010101010101ull;
+    static constexpr uint64_t c_msbs = 0x8080808080808080ull;
+
+    template <bool Const>
+    class IteratorBase {
+        typedef std::conditional_t<Const, const FlatHashMap, FlatHashMap> Map;
+
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef FlatHashMap::value_type value_type;
+        typedef ptrdiff_t difference_type;
+        typedef std::conditional_t<Const, const value_type*, value_type*> pointer;
+        typedef std::conditional_t<Const, const value_type&, value_type&> reference;
+
+        IteratorBase() {}
+        template <bool C = Const, std::enable_if_t<C, int> = 0>
+        IteratorBase(const IteratorBase<false>& src) : m_map(src.m_map), m_index(src.m_index) {}
+        reference operator*() const { return m_map->m_slots[m_index]; }
+        pointer operator->() const { return &m_map->m_slots[m_index]; }
+        IteratorBase& operator++() {
+            m_index = m_map->nextFull(m_index + 1);
+            return *this;
+        }
+        IteratorBase operator++(int) {
+            IteratorBase copy(*this);
+            ++*this;
+            return copy;
+        }
+        bool operator==(const IteratorBase& other) const { return m_index == other.m_index; }
+        bool operator!=(const IteratorBase& other) const { return m_index != other.m_index; }
+
+      private:
+        IteratorBase(Map* map, size_t index) : m_map(map), m_index(index) {}
+        Map* m_map = nullptr;
+        size_t m_index = 0;
+        friend class FlatHashMap;
+        friend class IteratorBase<true>;
+    };
+
+  public:
+    typedef IteratorBase<false> iterator;
+    typedef IteratorBase<true> const_iterator;
+
+    FlatHashMap() {}
+    FlatHashMap(const FlatHashMap& other) { *this = other; }
+    FlatHashMap(FlatHashMap&& other) noexcept { swap(other); }
+    ~FlatHashMap() { release(); }
+    FlatHashMap& operator=(const FlatHashMap& other) {
+        if (this == &other) return *this;
+        clear();
+        reserve(other.size());
+        for (auto& value : other) insertUnique(hash(value.first), value_type(value));
+        return *this;
+    }
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+        FlatHashMap tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+    void swap(FlatHashMap& other) noexcept {
+        std::swap(m_ctrl, other.m_ctrl);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        std::swap(m_growthLeft, other.m_growthLeft);
+    }
+
+    iterator begin() { return iterator(this, nextFull(0)); }
+    iterator end() { return iterator(this, m_capacity); }
+    const_iterator begin() const { return const_iterator(this, nextFull(0)); }
+    const_iterator end() const { return const_iterator(this, m_capacity); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t capacity() const { return m_capacity; }
+
+    void clear() {
+        for (size_t i = 0; i < m_capacity; i++) {
+            if (isFull(m_ctrl[i])) std::destroy_at(&m_slots[i]);
+        }
+        if (m_capacity != 0) memset(m_ctrl, c_empty, m_capacity + c_groupSize);
+        m_size = 0;
+        m_growthLeft = maxLoad(m_capacity);
+    }
+    // Makes sure that many elements fit without rehashing.
+    void reserve(size_t count) {
+        if (count <= m_size + m_growthLeft) return;
+        size_t capacity = c_minCapacity;
+        while (maxLoad(capacity) < count) capacity *= 2;
+        rehash(capacity);
+    }
+
+    iterator find(const Key& key) { return iterator(this, findIndex(key)); }
+    const_iterator find(const Key& key) const { return const_iterator(this, findIndex(key)); }
+    bool contains(const Key& key) const { return findIndex(key) != m_capacity; }
+    size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        const size_t h = hash(key);
+        size_t index = findIndex(key, h);
+        if (index != m_capacity) return {iterator(this, index), false};
+        index = insertUnique(h, value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                           std::forward_as_tuple(std::forward<Args>(args)...)));
+        return {iterator(this, index), true};
+    }
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return try_emplace(value.first, std::move(value.second));
+    }
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+        auto ret = try_emplace(key, std::forward<M>(obj));
+        if (!ret.second) ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    // Returns the iterator to the element following the erased one.
+    iterator erase(const_iterator pos) {
+        const size_t index = pos.m_index;
+        std::destroy_at(&m_slots[index]);
+        m_size--;
+        // A slot which never got into a full group can go back to being empty, as no probe ever went past it.
+        const size_t before = (index - c_groupSize) & (m_capacity - 1);
+        const uint64_t emptyAfter = matchEmpty(loadGroup(index));
+        const uint64_t emptyBefore = matchEmpty(loadGroup(before));
+        const unsigned fullRun = (std::countl_zero(emptyBefore) >> 3) + (std::countr_zero(emptyAfter) >> 3);
+        const bool wasNeverFull = emptyBefore && emptyAfter && (fullRun < c_groupSize);
+        setCtrl(index, wasNeverFull ? c_empty : c_deleted);
+        if (wasNeverFull) m_growthLeft++;
+        return iterator(this, nextFull(index + 1));
+    }
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+    size_t erase(const Key& key) {
+        const size_t index = findIndex(key);
+        if (index == m_capacity) return 0;
+        erase(const_iterator(this, index));
+        return 1;
+    }
+
+  private:
+    static bool isFull(uint8_t ctrl) { return (ctrl & 0x80) == 0; }
+    static size_t maxLoad(size_t capacity) { return capacity - capacity / 8; }
+    static uint8_t h2(size_t hash) { return hash & 0x7f; }
+    static size_t h1(size_t hash) { return hash >> 7; }
+    // std::hash is the identity for integers with most standard libraries, which would leave the low bits
+    // the control bytes are made of badly distributed, so the hash always gets mixed.
+    static size_t hash(const Key& key) {
+        uint64_t h = static_cast<uint64_t>(Hash{}(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+
+    uint64_t loadGroup(size_t index) const {
+        uint64_t group;
+        memcpy(&group, m_ctrl + index, sizeof(group));
+        return group;
+    }
+    // These return one bit set per matching byte, on its msb. Matching h2 can have false positives on the
+    // byte right after a real match, which the key comparison weeds out.
+    static uint64_t matchByte(uint64_t group, uint8_t byte) {
+        const uint64_t x = group ^ (c_lsbs * byte);
+        return (x - c_lsbs) & ~x & c_msbs;
+    }
+    static uint64_t matchEmpty(uint64_t group) { return (group & ~(group << 6)) & c_msbs; }
+    static uint64_t matchEmptyOrDeleted(uint64_t group) { return (group & ~(group << 7)) & c_msbs; }
+    static unsigned lowestMatch(uint64_t mask) { return std::countr_zero(mask) >> 3; }
+
+    void setCtrl(size_t index, uint8_t ctrl) {
+        m_ctrl[index] = ctrl;
+        // The first group is mirrored past the end, so that loading a group never has to wrap around.
+        if (index < c_groupSize) m_ctrl[m_capacity + index] = ctrl;
+    }
+
+    size_t nextFull(size_t index) const {
+        while (index < m_capacity && !isFull(m_ctrl[index])) index++;
+        return index;
+    }
+
+    size_t findIndex(const Key& key) const { return findIndex(key, hash(key)); }
+    size_t findIndex(const Key& key, size_t h) const {
+        if (m_capacity == 0) return 0;
+        const size_t mask = m_capacity - 1;
+        size_t pos = h1(h) & mask;
+        for (size_t step = c_groupSize;; step += c_groupSize) {
+            const uint64_t group = loadGroup(pos);
+            for (uint64_t match = matchByte(group, h2(h)); match; match &= match - 1) {
+                const size_t index = (pos + lowestMatch(match)) & mask;
+                if (KeyEqual{}(m_slots[index].first, key)) return index;
+            }
+            if (matchEmpty(group)) return m_capacity;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    size_t findFreeSlot(size_t h) const {
+        const size_t mask = m_capacity - 1;
+        size_t pos = h1(h) & mask;
+        for (size_t step = c_groupSize;; step += c_groupSize) {
+            const uint64_t match = matchEmptyOrDeleted(loadGroup(pos));
+            if (match) return (pos + lowestMatch(match)) & mask;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    size_t insertUnique(size_t h, value_type&& value) {
+        // When the slots are mostly used up by deleted elements, rehashing in place is enough to purge them.
+        if (m_growthLeft == 0) {
+            rehash(m_capacity == 0 ? c_minCapacity : (m_size * 2 >= m_capacity ? m_capacity * 2 : m_capacity));
+        }
+        const size_t index = findFreeSlot(h);
+        if (m_ctrl[index] == c_empty) m_growthLeft--;
+        std::construct_at(&m_slots[index], std::move(value));
+        setCtrl(index, h2(h));
+        m_size++;
+        return index;
+    }
+
+    void rehash(size_t capacity) {
+        uint8_t* oldCtrl = m_ctrl;
+        value_type* oldSlots = m_slots;
+        const size_t oldCapacity = m_capacity;
+        m_ctrl = new uint8_t[capacity + c_groupSize];
+        memset(m_ctrl, c_empty, capacity + c_groupSize);
+        m_slots = std::allocator<value_type>().allocate(capacity);
+        m_capacity = capacity;
+        m_growthLeft = maxLoad(capacity);
+        m_size = 0;
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (!isFull(oldCtrl[i])) continue;
+            const size_t h = hash(oldSlots[i].first);
+            const size_t index = findFreeSlot(h);
+            std::construct_at(&m_slots[index], std::move(oldSlots[i]));
+            std::destroy_at(&oldSlots[i]);
+            setCtrl(index, h2(h));
+            m_growthLeft--;
+            m_size++;
+        }
+        if (oldCapacity != 0) {
+            delete[] oldCtrl;
+            std::allocator<value_type>().deallocate(oldSlots, oldCapacity);
+        }
+    }
+
+    void release() {
+        if (m_capacity == 0) return;
+        for (size_t i = 0; i < m_capacity; i++) {
+            if (isFull(m_ctrl[i])) std::destroy_at(&m_slots[i]);
+        }
+        delete[] m_ctrl;
+        std::allocator<value_type>().deallocate(m_slots, m_capacity);
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growthLeft = 0;
+    }
+
+    uint8_t* m_ctrl = nullptr;
+    value_type* m_slots = nullptr;
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+    size_t m_growthLeft = 0;
+};
+
+}  // namespace PCSX
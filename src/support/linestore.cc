@@ -0,0 +1,168 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/linestore.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <utility>
+
+PCSX::LineStore::LineStore(size_t maxBytes) : m_maxChunks(std::max<size_t>(maxBytes / CHUNK_SIZE, 1)) {}
+
+void PCSX::LineStore::append(unsigned tag, std::string_view line) {
+    if (line.size() > CHUNK_SIZE) line = line.substr(0, CHUNK_SIZE);
+    if (m_chunks.empty() || (m_chunks.back()->count == CHUNK_LINES) ||
+        ((CHUNK_SIZE - m_chunks.back()->bytes) < line.size())) {
+        m_chunks.push_back(std::make_shared<Chunk>(m_end));
+        if (m_chunks.size() > m_maxChunks) {
+            m_chunks.pop_front();
+            m_begin = m_chunks.front()->first;
+            for (auto& index : m_indexes) {
+                while (!index.empty() && (index.front() < m_begin)) index.pop_front();
+            }
+        }
+    }
+    auto& chunk = *m_chunks.back();
+    memcpy(chunk.text.get() + chunk.bytes, line.data(), line.size());
+    chunk.lines[chunk.count++] = {chunk.bytes, uint32_t(line.size()), tag};
+    chunk.bytes += line.size();
+    m_indexes[tag].push_back(m_end++);
+}
+
+void PCSX::LineStore::clear() {
+    m_chunks.clear();
+    for (auto& index : m_indexes) index.clear();
+    m_begin = m_end;
+}
+
+const PCSX::LineStore::Chunk& PCSX::LineStore::find(uint64_t seq) const {
+    auto chunk = std::upper_bound(m_chunks.begin(), m_chunks.end(), seq,
+                                  [](uint64_t seq, const std::shared_ptr<Chunk>& chunk) { return seq < chunk->first; });
+    return **(chunk - 1);
+}
+
+std::string_view PCSX::LineStore::line(uint64_t seq) const {
+    auto& chunk = find(seq);
+    return chunk.line(seq - chunk.first);
+}
+
+unsigned PCSX::LineStore::tag(uint64_t seq) const {
+    auto& chunk = find(seq);
+    return chunk.lines[seq - chunk.first].tag;
+}
+
+bool PCSX::LineStore::View::matches(std::string_view line, std::string_view text) {
+    if (text.empty()) return true;
+    return std::search(line.begin(), line.end(), text.begin(), text.end(),
+                       [](char a, char b) { return tolower(uint8_t(a)) == b; }) != line.end();
+}
+
+bool PCSX::LineStore::View::matches(uint64_t seq) const {
+    auto& chunk = m_store.find(seq);
+    auto& line = chunk.lines[seq - chunk.first];
+    return ((m_tags >> line.tag) & 1) && matches(chunk.line(seq - chunk.first), m_text);
+}
+
+PCSX::LineStore::View::Result PCSX::LineStore::View::scan(Snapshot snapshot, uint64_t tags, std::string text,
+                                                         std::shared_ptr<std::atomic<bool>> cancel) {
+    Result result;
+    result.end = snapshot.end;
+    for (size_t c = 0; c < snapshot.chunks.size(); c++) {
+        if (cancel->load(std::memory_order_relaxed)) break;
+        auto& chunk = snapshot.chunks[c];
+        // Not looking at the chunk's count, as lines may be getting appended to the last one meanwhile.
+        const uint64_t end = (c + 1 < snapshot.chunks.size()) ? snapshot.chunks[c + 1]->first : snapshot.end;
+        const uint32_t count = end - chunk->first;
+        for (uint32_t i = 0; i < count; i++) {
+            if (((tags >> chunk->lines[i].tag) & 1) && matches(chunk->line(i), text)) {
+                result.matches.push_back(chunk->first + i);
+            }
+        }
+    }
+    return result;
+}
+
+void PCSX::LineStore::View::cancel() {
+    if (!m_pending.valid()) return;
+    m_cancel->store(true, std::memory_order_relaxed);
+    m_pending.wait();
+    m_pending = {};
+}
+
+void PCSX::LineStore::View::setFilter(uint64_t tags, std::string_view text) {
+    std::string lowered(text);
+    for (auto& c : lowered) c = tolower(uint8_t(c));
+    if ((tags == m_tags) && (lowered == m_text)) return;
+    cancel();
+    m_tags = tags;
+    m_text = std::move(lowered);
+    m_matches.clear();
+    m_scanned = m_store.end();
+
+    if (m_text.empty()) {
+        // Merging the indexes of the tags is cheap enough to do right away.
+        using Cursor = std::pair<std::deque<uint64_t>::const_iterator, std::deque<uint64_t>::const_iterator>;
+        const auto later = [](const Cursor& a, const Cursor& b) { return *a.first > *b.first; };
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> cursors(later);
+        for (unsigned tag = 0; tag < MAX_TAGS; tag++) {
+            auto& index = m_store.m_indexes[tag];
+            if (((m_tags >> tag) & 1) && !index.empty()) cursors.push({index.begin(), index.end()});
+        }
+        while (!cursors.empty()) {
+            auto cursor = cursors.top();
+            cursors.pop();
+            m_matches.push_back(*cursor.first);
+            if (++cursor.first != cursor.second) cursors.push(cursor);
+        }
+        return;
+    }
+
+    // Reading the text of the lines is the part which could take a while.
+    Snapshot snapshot;
+    snapshot.chunks.assign(m_store.m_chunks.begin(), m_store.m_chunks.end());
+    snapshot.end = m_store.end();
+    m_cancel = std::make_shared<std::atomic<bool>>(false);
+    m_pending = std::async(std::launch::async, scan, std::move(snapshot), m_tags, m_text, m_cancel);
+}
+
+void PCSX::LineStore::View::update() {
+    if (m_pending.valid()) {
+        if (m_pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+        auto result = m_pending.get();
+        m_matches.assign(result.matches.begin(), result.matches.end());
+        m_scanned = result.end;
+    }
+    const uint64_t begin = m_store.begin();
+    while (!m_matches.empty() && (m_matches.front() < begin)) m_matches.pop_front();
+    for (uint64_t seq = std::max(m_scanned, begin); seq < m_store.end(); seq++) {
+        if (matches(seq)) m_matches.push_back(seq);
+    }
+    m_scanned = m_store.end();
+}
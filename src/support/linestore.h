@@ -0,0 +1,130 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PCSX {
+
+// Holds the lines of a log, in chunks of a fixed size, so that appending never moves what's already there,
+// and that the memory stays bounded: once over budget, the oldest chunk gets dropped as a whole. Every line
+// gets a sequence number, which keeps growing, and a tag, such as its log class, with an index of the lines
+// of each tag. Only one thread may use the store, but the lines written never change, so the Views can
+// filter them on a separate thread, from a snapshot of the chunks.
+class LineStore {
+  public:
+    static constexpr uint32_t CHUNK_SIZE = 64 * 1024;
+    static constexpr uint32_t CHUNK_LINES = 4096;
+    static constexpr unsigned MAX_TAGS = 64;
+
+    explicit LineStore(size_t maxBytes);
+
+    // Lines longer than a chunk get truncated.
+    void append(unsigned tag, std::string_view line);
+    void clear();
+    // The range of sequence numbers of the lines still in the store.
+    uint64_t begin() const { return m_begin; }
+    uint64_t end() const { return m_end; }
+    std::string_view line(uint64_t seq) const;
+    unsigned tag(uint64_t seq) const;
+    const std::deque<uint64_t>& index(unsigned tag) const { return m_indexes[tag]; }
+
+    class View;
+
+  private:
+    struct Line {
+        uint32_t offset;
+        uint32_t length;
+        unsigned tag;
+    };
+    struct Chunk {
+        explicit Chunk(uint64_t first) : first(first) {}
+        const uint64_t first;
+        uint32_t bytes = 0;
+        uint32_t count = 0;
+        std::unique_ptr<char[]> text = std::make_unique<char[]>(CHUNK_SIZE);
+        std::unique_ptr<Line[]> lines = std::make_unique<Line[]>(CHUNK_LINES);
+        std::string_view line(uint32_t i) const { return {text.get() + lines[i].offset, lines[i].length}; }
+    };
+    const Chunk& find(uint64_t seq) const;
+
+    const size_t m_maxChunks;
+    uint64_t m_begin = 0;
+    uint64_t m_end = 0;
+    std::deque<std::shared_ptr<Chunk>> m_chunks;
+    std::deque<uint64_t> m_indexes[MAX_TAGS];
+};
+
+// The lines of a store matching a set of tags, and optionally a piece of text. The tags alone get resolved
+// straight from the store's indexes, while looking for text in the whole store happens on a separate
+// thread. Either way, the lines appended afterwards get matched incrementally.
+class LineStore::View {
+  public:
+    explicit View(const LineStore& store) : m_store(store) {}
+    ~View() { cancel(); }
+
+    // The text is looked for case insensitively, and an empty one matches every line.
+    void setFilter(uint64_t tags, std::string_view text);
+    // Catches up with the store, and has to be called before looking at the matches.
+    void update();
+    // While the text is being looked for in the lines already there.
+    bool filtering() const { return m_pending.valid(); }
+    size_t size() const { return m_matches.size(); }
+    uint64_t operator[](size_t i) const { return m_matches[i]; }
+
+  private:
+    struct Snapshot {
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+        uint64_t end;
+    };
+    struct Result {
+        std::vector<uint64_t> matches;
+        uint64_t end;
+    };
+    static bool matches(std::string_view line, std::string_view text);
+    static Result scan(Snapshot snapshot, uint64_t tags, std::string text, std::shared_ptr<std::atomic<bool>> cancel);
+    bool matches(uint64_t seq) const;
+    void cancel();
+
+    const LineStore& m_store;
+    uint64_t m_tags = ~uint64_t(0);
+    std::string m_text;
+    std::deque<uint64_t> m_matches;
+    uint64_t m_scanned = 0;
+    std::future<Result> m_pending;
+    std::shared_ptr<std::atomic<bool>> m_cancel;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,137 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "fmt/printf.h"
+
+namespace PCSX {
+
+// Records log lines as their format string and raw arguments, to only format them later, away from the code
+// emitting them. Only arguments which can be copied bytewise, and which don't point to anything that might be
+// gone by the time the line gets formatted, can be recorded: integers, enums, floating point numbers, and the
+// values of non-string pointers. Each argument takes a 64 bits slot. The format strings are kept as pointers,
+// so they need to outlive the entries. Any number of threads can push and pop.
+template <size_t BS = 4096>
+class LogRing {
+    static_assert((BS & (BS - 1)) == 0, "The ring size needs to be a power of two");
+
+  public:
+    static constexpr size_t BUFFER_SIZE = BS;
+    static constexpr size_t MAX_ARGS = 8;
+
+    template <typename T>
+    static constexpr bool c_deferrableArg = [] {
+        using D = std::remove_cvref_t<T>;
+        if (sizeof(D) > sizeof(uint64_t)) return false;
+        if constexpr (std::is_pointer_v<D>) {
+            using P = std::remove_cv_t<std::remove_pointer_t<D>>;
+            return !std::is_same_v<P, char> && !std::is_same_v<P, signed char> && !std::is_same_v<P, unsigned char>;
+        }
+        return std::is_arithmetic_v<D> || std::is_enum_v<D>;
+    }();
+    // A line without arguments has nothing to format, and its format string may well be a temporary.
+    template <typename... Args>
+    static constexpr bool c_deferrable = (sizeof...(Args) != 0) && (sizeof...(Args) <= MAX_ARGS) &&
+                                         (... && c_deferrableArg<Args>);
+
+    // Returns false when the ring is full, in which case the caller needs to format the line itself.
+    template <typename... Args>
+    bool push(unsigned tag, const char* format, const Args&... args) {
+        static_assert(c_deferrable<Args...>, "These arguments can't have their formatting deferred");
+        std::lock_guard lock(m_mutex);
+        if ((m_head - m_tail) == BUFFER_SIZE) return false;
+        Entry& entry = m_entries[m_head++ & (BUFFER_SIZE - 1)];
+        entry.tag = tag;
+        entry.format = format;
+        entry.formatter = &formatSlots<Args...>;
+        unsigned slot = 0;
+        (store(entry.slots[slot++], args), ...);
+        return true;
+    }
+    // Formats the oldest entry, if any. The lock isn't held while formatting.
+    bool pop(unsigned& tag, std::string& line) {
+        Entry entry;
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_head == m_tail) return false;
+            entry = m_entries[m_tail++ & (BUFFER_SIZE - 1)];
+        }
+        tag = entry.tag;
+        line = entry.formatter(entry.format, entry.slots);
+        return true;
+    }
+    size_t size() {
+        std::lock_guard lock(m_mutex);
+        return m_head - m_tail;
+    }
+
+  private:
+    using Formatter = std::string (*)(const char*, const uint64_t*);
+    struct Entry {
+        unsigned tag;
+        const char* format;
+        Formatter formatter;
+        uint64_t slots[MAX_ARGS];
+    };
+
+    template <typename T>
+    static void store(uint64_t& slot, const T& value) {
+        slot = 0;
+        memcpy(&slot, &value, sizeof(T));
+    }
+    template <typename T>
+    static T load(const uint64_t& slot) {
+        T value;
+        memcpy(&value, &slot, sizeof(T));
+        return value;
+    }
+    template <typename... Args, size_t... I>
+    static std::string formatIndexed(const char* format, const uint64_t* slots, std::index_sequence<I...>) {
+        return fmt::sprintf(format, load<std::remove_cvref_t<Args>>(slots[I])...);
+    }
+    template <typename... Args>
+    static std::string formatSlots(const char* format, const uint64_t* slots) {
+        return formatIndexed<Args...>(format, slots, std::index_sequence_for<Args...>{});
+    }
+
+    std::mutex m_mutex;
+    size_t m_head = 0;
+    size_t m_tail = 0;
+    std::unique_ptr<Entry[]> m_entries = std::make_unique<Entry[]>(BUFFER_SIZE);
+};
+
+}  // namespace PCSX
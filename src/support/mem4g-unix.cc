@@ -0,0 +1,47 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <sys/mman.h>
+
+#include "support/mem4g.h"
+
+void PCSX::Mem4G::reserve() {
+    void* base = mmap(nullptr, c_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    m_base = base == MAP_FAILED ? nullptr : reinterpret_cast<uint8_t*>(base);
+}
+
+void PCSX::Mem4G::release() {
+    if (m_base) munmap(m_base, c_size);
+    m_base = nullptr;
+}
+
+bool PCSX::Mem4G::commit(size_t firstBlock, size_t count) {
+    return mprotect(m_base + firstBlock * c_blockSize, count * c_blockSize, PROT_READ | PROT_WRITE) == 0;
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+#if defined(_WIN32) || defined(_WIN64)
+
+#include "support/mem4g.h"
+#include "support/windowswrapper.h"
+
+void PCSX::Mem4G::reserve() {
+    m_base = reinterpret_cast<uint8_t*>(VirtualAlloc(nullptr, c_size, MEM_RESERVE, PAGE_NOACCESS));
+}
+
+void PCSX::Mem4G::release() {
+    if (m_base) VirtualFree(m_base, 0, MEM_RELEASE);
+    m_base = nullptr;
+}
+
+bool PCSX::Mem4G::commit(size_t firstBlock, size_t count) {
+    return VirtualAlloc(m_base + firstBlock * c_blockSize, count * c_blockSize, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+#endif
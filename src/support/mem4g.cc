@@ -58,15 +58,26 @@ ssize_t PCSX::Mem4G::wSeek(ssize_t pos, int wheel) {
     return m_ptrW;
 }
 
-ssize_t PCSX::Mem4G::readAt(void* dest, size_t size, size_t ptr) {
+ssize_t PCSX::Mem4G::readAt(void* dest_, size_t size, size_t ptr) {
     if (ptr >= c_size) return 0;
+    uint8_t* dest = reinterpret_cast<uint8_t*>(dest_);
     size_t ret = size = cappedSize(size, ptr);
+    if (!m_base) return -1;
     while (size) {
-        auto blockSize = std::min(size, c_blockSize - (ptr % c_blockSize));
-        readBlock(dest, blockSize, ptr);
-        size -= blockSize;
-        ptr += blockSize;
-        dest = (char*)dest + blockSize;
+        // Copies or clears whole runs of blocks at once.
+        const bool committed = m_committed[ptr / c_blockSize];
+        size_t run = std::min(size, c_blockSize - (ptr % c_blockSize));
+        while ((run < size) && (m_committed[(ptr + run) / c_blockSize] == committed)) {
+            run += std::min(size - run, c_blockSize);
+        }
+        if (committed) {
+            memcpy(dest, m_base + ptr, run);
+        } else {
+            memset(dest, 0, run);
+        }
+        size -= run;
+        ptr += run;
+        dest += run;
     }
     return ret;
 }
@@ -74,37 +85,37 @@ ssize_t PCSX::Mem4G::readAt(void* dest, size_t size, size_t ptr) {
 ssize_t PCSX::Mem4G::writeAt(const void* src, size_t size, size_t ptr) {
     if (ptr >= c_size) return 0;
     size_t ret = size = cappedSize(size, ptr);
+    if (!m_base) return -1;
+    if (size == 0) return 0;
+    const size_t first = ptr / c_blockSize;
+    const size_t last = (ptr + size - 1) / c_blockSize;
+    for (size_t block = first; block <= last; block++) {
+        if (m_committed[block]) continue;
+        size_t count = 1;
+        while ((block + count <= last) && !m_committed[block + count]) count++;
+        if (!commit(block, count)) return -1;
+        for (size_t i = 0; i < count; i++) m_committed[block + i] = true;
+        block += count - 1;
+    }
+    for (size_t block = first; block <= last; block++) m_dirty[block] = true;
     m_lowestAddress = std::min<uint32_t>(m_lowestAddress, ptr);
     m_highestAddress = std::max<uint32_t>(m_highestAddress, ptr + size);
-    while (size) {
-        auto blockSize = std::min(size, c_blockSize - (ptr % c_blockSize));
-        writeBlock(src, blockSize, ptr);
-        size -= blockSize;
-        ptr += blockSize;
-        src = (char*)src + blockSize;
-    }
+    memcpy(m_base + ptr, src, size);
     return ret;
 }
 
-void PCSX::Mem4G::closeInternal() { m_blocks.destroyAll(); }
-
-void PCSX::Mem4G::readBlock(void* dest, size_t size, size_t ptr) {
-    auto block = m_blocks.find(ptr / c_blockSize);
-    if (block == m_blocks.end()) {
-        memset(dest, 0, size);
-        return;
+std::vector<uint32_t> PCSX::Mem4G::dirtyBlocks(bool clear) {
+    std::vector<uint32_t> blocks;
+    if (m_dirty.none()) return blocks;
+    for (size_t block = 0; block < c_blocks; block++) {
+        if (m_dirty[block]) blocks.push_back(block * c_blockSize);
     }
-    auto offset = ptr % c_blockSize;
-    auto toCopy = std::min(size, c_blockSize - offset);
-    memcpy(dest, block->data + offset, toCopy);
+    if (clear) m_dirty.reset();
+    return blocks;
 }
 
-void PCSX::Mem4G::writeBlock(const void* src, size_t size, size_t ptr) {
-    auto block = m_blocks.find(ptr / c_blockSize);
-    if (block == m_blocks.end()) {
-        block = m_blocks.insert(ptr / c_blockSize, new Block());
-    }
-    auto offset = ptr % c_blockSize;
-    auto toCopy = std::min(size, c_blockSize - offset);
-    memcpy(block->data + offset, src, toCopy);
+void PCSX::Mem4G::closeInternal() {
+    release();
+    m_committed.reset();
+    m_dirty.reset();
 }
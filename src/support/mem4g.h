@@ -26,15 +26,24 @@ SOFTWARE.
 
 #pragma once
 
+#include <stdint.h>
+
+#include <bitset>
+#include <vector>
+
 #include "support/file.h"
-#include "support/hashtable.h"
 
 namespace PCSX {
 
+// A sparse 4GB address space. The whole range gets reserved upfront, and its blocks only get committed the first
+// time they're written to, so an address translates to host memory with a single addition, and bulk reads and
+// writes are straight copies. The blocks never written to read as zeroes, and cost nothing.
 class Mem4G : public File {
   public:
-    Mem4G() : File(File::FileType::RW_SEEKABLE) {}
-    virtual ~Mem4G() { m_blocks.destroyAll(); }
+    constexpr static size_t c_blockSize = 64 * 1024;
+
+    Mem4G() : File(File::FileType::RW_SEEKABLE) { reserve(); }
+    virtual ~Mem4G() { release(); }
     ssize_t rSeek(ssize_t pos, int wheel) final override;
     ssize_t rTell() final override { return m_ptrR; }
     ssize_t wSeek(ssize_t pos, int wheel) final override;
@@ -52,6 +61,7 @@ class Mem4G : public File {
     }
     ssize_t readAt(void* dest, size_t size, size_t ptr) final override;
     ssize_t writeAt(const void* src, size_t size, size_t ptr) final override;
+    bool failed() final override { return m_base == nullptr; }
 
     uint32_t lowestAddress() const { return m_lowestAddress; }
     uint32_t highestAddress() const { return m_highestAddress; }
@@ -60,26 +70,33 @@ class Mem4G : public File {
 
     bool isEmpty() const { return m_lowestAddress == 0xffffffff; }
 
+    // The addresses of the blocks written to since the last time they got cleared, in increasing order, so
+    // that diffing two images only needs to look at these.
+    std::vector<uint32_t> dirtyBlocks(bool clear = true);
+    // The contents of the block holding this address, or nullptr if it was never written to.
+    const uint8_t* blockData(uint32_t address) const {
+        const size_t block = address / c_blockSize;
+        return m_committed[block] ? m_base + block * c_blockSize : nullptr;
+    }
+
   private:
     constexpr static size_t c_size = 0x100000000ULL;
-    constexpr static size_t c_blockSize = 64 * 1024;
+    constexpr static size_t c_blocks = c_size / c_blockSize;
     void closeInternal() final override;
     size_t m_ptrR = 0;
     size_t m_ptrW = 0;
     uint32_t m_lowestAddress = 0xffffffff;
     uint32_t m_highestAddress = 0;
 
-    struct Block;
-    typedef PCSX::Intrusive::HashTable<uint32_t, Block> Blocks;
-    struct Block : public Blocks::Node {
-        Block() { memset(data, 0, c_blockSize); }
-        uint8_t data[c_blockSize];
-    };
-    Blocks m_blocks;
+    uint8_t* m_base = nullptr;
+    std::bitset<c_blocks> m_committed;
+    std::bitset<c_blocks> m_dirty;
     size_t cappedSize(size_t size, size_t ptr) const { return std::min(size, c_size - ptr); }
 
-    void readBlock(void* dest, size_t size, size_t ptr);
-    void writeBlock(const void* src, size_t size, size_t ptr);
+    // These are per platform, in mem4g-unix.cc and mem4g-windows.cc.
+    void reserve();
+    void release();
+    bool commit(size_t firstBlock, size_t count);
 };
 
 }  // namespace PCSX
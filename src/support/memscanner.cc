@@ -0,0 +1,331 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include "support/memscanner.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define MEMSCANNER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+using ValueType = PCSX::MemoryScanner::ValueType;
+using Comparison = PCSX::MemoryScanner::Comparison;
+
+// Every comparison boils down to one of these, against either a constant or the previous values.
+enum class Op { Eq, Ne, Gt, Lt, All };
+
+// Below this, splitting the work across threads costs more than it saves.
+constexpr size_t c_bytesPerThread = 1024 * 1024;
+
+#ifdef MEMSCANNER_SSE2
+
+template <typename T>
+struct Lanes;
+template <>
+struct Lanes<int8_t> {
+    static __m128i bias() { return _mm_setzero_si128(); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+    static __m128i gt(__m128i a, __m128i b) { return _mm_cmpgt_epi8(a, b); }
+    static unsigned bits(__m128i m) { return _mm_movemask_epi8(m); }
+};
+// SSE2 only has signed compares, so the unsigned types get their sign bit flipped first.
+template <>
+struct Lanes<uint8_t> : Lanes<int8_t> {
+    static __m128i bias() { return _mm_set1_epi8(char(0x80)); }
+};
+template <>
+struct Lanes<int16_t> {
+    static __m128i bias() { return _mm_setzero_si128(); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+    static __m128i gt(__m128i a, __m128i b) { return _mm_cmpgt_epi16(a, b); }
+    static unsigned bits(__m128i m) { return _mm_movemask_epi8(_mm_packs_epi16(m, _mm_setzero_si128())); }
+};
+template <>
+struct Lanes<uint16_t> : Lanes<int16_t> {
+    static __m128i bias() { return _mm_set1_epi16(short(0x8000)); }
+};
+template <>
+struct Lanes<int32_t> {
+    static __m128i bias() { return _mm_setzero_si128(); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+    static __m128i gt(__m128i a, __m128i b) { return _mm_cmpgt_epi32(a, b); }
+    static unsigned bits(__m128i m) { return _mm_movemask_ps(_mm_castsi128_ps(m)); }
+};
+template <>
+struct Lanes<uint32_t> : Lanes<int32_t> {
+    static __m128i bias() { return _mm_set1_epi32(int(0x80000000)); }
+};
+
+// Compares 64 consecutive values of a against the ones of b, and returns one bit per value.
+template <typename T, Op op>
+uint64_t compareBlock(const uint8_t* a, const uint8_t* b) {
+    if constexpr (op == Op::All) return ~uint64_t(0);
+    using L = Lanes<T>;
+    constexpr unsigned perVector = 16 / sizeof(T);
+    const __m128i bias = L::bias();
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < 64 / perVector; i++) {
+        const __m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a) + i), bias);
+        const __m128i y = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b) + i), bias);
+        __m128i r;
+        if constexpr (op == Op::Gt) {
+            r = L::gt(x, y);
+        } else if constexpr (op == Op::Lt) {
+            r = L::gt(y, x);
+        } else {
+            r = L::eq(x, y);
+        }
+        mask |= uint64_t(L::bits(r)) << (i * perVector);
+    }
+    if constexpr (op == Op::Ne) mask = ~mask;
+    return mask;
+}
+
+#else
+
+template <typename T, Op op>
+uint64_t compareBlock(const uint8_t* a, const uint8_t* b) {
+    if constexpr (op == Op::All) return ~uint64_t(0);
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < 64; i++) {
+        T x, y;
+        memcpy(&x, a + i * sizeof(T), sizeof(T));
+        memcpy(&y, b + i * sizeof(T), sizeof(T));
+        bool r;
+        if constexpr (op == Op::Eq) r = x == y;
+        if constexpr (op == Op::Ne) r = x != y;
+        if constexpr (op == Op::Gt) r = x > y;
+        if constexpr (op == Op::Lt) r = x < y;
+        mask |= uint64_t(r) << i;
+    }
+    return mask;
+}
+
+#endif
+
+typedef uint64_t (*BlockCompare)(const uint8_t* a, const uint8_t* b);
+
+template <typename T>
+BlockCompare selectCompare(Op op) {
+    switch (op) {
+        case Op::Eq:
+            return compareBlock<T, Op::Eq>;
+        case Op::Ne:
+            return compareBlock<T, Op::Ne>;
+        case Op::Gt:
+            return compareBlock<T, Op::Gt>;
+        case Op::Lt:
+            return compareBlock<T, Op::Lt>;
+        case Op::All:
+            return compareBlock<T, Op::All>;
+    }
+    return nullptr;
+}
+
+BlockCompare selectCompare(ValueType type, Op op) {
+    switch (type) {
+        case ValueType::Char:
+            return selectCompare<int8_t>(op);
+        case ValueType::Uchar:
+            return selectCompare<uint8_t>(op);
+        case ValueType::Short:
+            return selectCompare<int16_t>(op);
+        case ValueType::Ushort:
+            return selectCompare<uint16_t>(op);
+        case ValueType::Int:
+            return selectCompare<int32_t>(op);
+        case ValueType::Uint:
+            return selectCompare<uint32_t>(op);
+    }
+    return nullptr;
+}
+
+Op getOp(Comparison comparison) {
+    switch (comparison) {
+        case Comparison::Equal:
+        case Comparison::Unchanged:
+            return Op::Eq;
+        case Comparison::NotEqual:
+        case Comparison::Changed:
+            return Op::Ne;
+        case Comparison::Greater:
+        case Comparison::Increased:
+            return Op::Gt;
+        case Comparison::Less:
+        case Comparison::Decreased:
+            return Op::Lt;
+        case Comparison::Any:
+            return Op::All;
+    }
+    return Op::All;
+}
+
+bool usesPrevious(Comparison comparison) {
+    return (comparison == Comparison::Changed) || (comparison == Comparison::Unchanged) ||
+           (comparison == Comparison::Increased) || (comparison == Comparison::Decreased);
+}
+
+}  // namespace
+
+unsigned PCSX::MemoryScanner::width(ValueType type) {
+    switch (type) {
+        case ValueType::Char:
+        case ValueType::Uchar:
+            return 1;
+        case ValueType::Short:
+        case ValueType::Ushort:
+            return 2;
+        case ValueType::Int:
+        case ValueType::Uint:
+            return 4;
+    }
+    throw std::runtime_error("Invalid value type.");
+}
+
+int64_t PCSX::MemoryScanner::read(const uint8_t* memory, uint32_t offset, ValueType type) {
+    auto get = [memory, offset]<typename T>(T value) -> int64_t {
+        memcpy(&value, memory + offset, sizeof(T));
+        return value;
+    };
+    switch (type) {
+        case ValueType::Char:
+            return get(int8_t(0));
+        case ValueType::Uchar:
+            return get(uint8_t(0));
+        case ValueType::Short:
+            return get(int16_t(0));
+        case ValueType::Ushort:
+            return get(uint16_t(0));
+        case ValueType::Int:
+            return get(int32_t(0));
+        case ValueType::Uint:
+            return get(uint32_t(0));
+    }
+    throw std::runtime_error("Invalid value type.");
+}
+
+void PCSX::MemoryScanner::first(const uint8_t* memory, size_t size, ValueType type, Comparison comparison,
+                                int64_t value) {
+    m_type = type;
+    m_slots = size / width(type);
+    m_bits.assign((m_slots + 63) / 64, 0);
+    m_previous.resize(size);
+    if (usesPrevious(comparison)) comparison = Comparison::Any;
+    scan(memory, comparison, value, false);
+}
+
+void PCSX::MemoryScanner::next(const uint8_t* memory, Comparison comparison, int64_t value) {
+    if (m_bits.empty()) return;
+    scan(memory, comparison, value, true);
+}
+
+void PCSX::MemoryScanner::clear() {
+    m_slots = 0;
+    m_count = 0;
+    m_bits.clear();
+    m_ranks.clear();
+    m_previous.clear();
+}
+
+uint32_t PCSX::MemoryScanner::offset(size_t index) const {
+    auto it = std::upper_bound(m_ranks.begin(), m_ranks.end(), uint32_t(index));
+    const size_t word = it - m_ranks.begin() - 1;
+    uint64_t bits = m_bits[word];
+    for (size_t skip = index - m_ranks[word]; skip; skip--) bits &= bits - 1;
+    return uint32_t((word * 64 + std::countr_zero(bits)) * width(m_type));
+}
+
+void PCSX::MemoryScanner::scan(const uint8_t* memory, Comparison comparison, int64_t value, bool incremental) {
+    const unsigned w = width(m_type);
+    // The constant gets repeated over a whole block, so it can be compared the same way as the previous values.
+    alignas(16) uint8_t broadcast[64 * 4];
+    for (unsigned i = 0; i < 64 * w; i++) broadcast[i] = uint8_t(value >> (8 * (i % w)));
+
+    const size_t words = m_bits.size();
+    const size_t bytes = m_slots * w;
+    size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    threads = std::clamp(bytes / c_bytesPerThread, size_t(1), threads);
+    const size_t perThread = (words + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; t++) {
+        const size_t begin = std::min(words, t * perThread);
+        const size_t end = std::min(words, begin + perThread);
+        workers.emplace_back([=, this]() { scanWords(memory, begin, end, comparison, broadcast, incremental); });
+    }
+    scanWords(memory, 0, std::min(words, perThread), comparison, broadcast, incremental);
+    for (auto& worker : workers) worker.join();
+
+    m_ranks.resize(words + 1);
+    uint32_t count = 0;
+    for (size_t i = 0; i < words; i++) {
+        m_ranks[i] = count;
+        count += std::popcount(m_bits[i]);
+    }
+    m_ranks[words] = count;
+    m_count = count;
+    memcpy(m_previous.data(), memory, m_previous.size());
+}
+
+void PCSX::MemoryScanner::scanWords(const uint8_t* memory, size_t begin, size_t end, Comparison comparison,
+                                    const uint8_t* broadcast, bool incremental) {
+    const unsigned w = width(m_type);
+    const size_t blockSize = 64 * w;
+    const bool previous = usesPrevious(comparison);
+    const BlockCompare compare = selectCompare(m_type, getOp(comparison));
+
+    for (size_t i = begin; i < end; i++) {
+        if (incremental && !m_bits[i]) continue;
+        const uint8_t* a = memory + i * blockSize;
+        const uint8_t* b = previous ? m_previous.data() + i * blockSize : broadcast;
+        uint64_t valid = ~uint64_t(0);
+        // The last block may be short, and gets padded so the comparison never reads past the end.
+        alignas(16) uint8_t tailA[64 * 4];
+        alignas(16) uint8_t tailB[64 * 4];
+        if ((i + 1) * 64 > m_slots) {
+            const size_t slots = m_slots - i * 64;
+            valid = (uint64_t(1) << slots) - 1;
+            memset(tailA, 0, sizeof(tailA));
+            memcpy(tailA, a, slots * w);
+            a = tailA;
+            if (previous) {
+                memset(tailB, 0, sizeof(tailB));
+                memcpy(tailB, b, slots * w);
+                b = tailB;
+            }
+        }
+        const uint64_t mask = compare(a, b) & valid;
+        m_bits[i] = incremental ? m_bits[i] & mask : mask;
+    }
+}
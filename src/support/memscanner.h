@@ -0,0 +1,89 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <bit>
+#include <vector>
+
+namespace PCSX {
+
+// Cheat-style value scanner over a block of memory. The candidates are kept as one bit per aligned
+// slot of the scanned width, along with a copy of the memory as it was on the last scan, so that a
+// rescan only has to look at the slots still standing. The comparisons run on whole blocks of 64
+// slots at a time using SIMD when available, and large regions get split across threads.
+class MemoryScanner {
+  public:
+    enum class ValueType { Char, Uchar, Short, Ushort, Int, Uint };
+    enum class Comparison { Equal, NotEqual, Greater, Less, Changed, Unchanged, Increased, Decreased, Any };
+    static unsigned width(ValueType type);
+    static int64_t read(const uint8_t* memory, uint32_t offset, ValueType type);
+
+    // There's nothing to compare against on the first scan, so the comparisons against the
+    // previous values keep every slot, same as Any.
+    void first(const uint8_t* memory, size_t size, ValueType type, Comparison comparison, int64_t value = 0);
+    // Filters the surviving candidates, using the same memory size and value type as the first scan.
+    void next(const uint8_t* memory, Comparison comparison, int64_t value = 0);
+    void clear();
+
+    bool empty() const { return m_count == 0; }
+    size_t count() const { return m_count; }
+    ValueType valueType() const { return m_type; }
+    // The offset of the n-th surviving candidate, in increasing order.
+    uint32_t offset(size_t index) const;
+    // The value this candidate had when it was last scanned.
+    int64_t previous(uint32_t offset) const { return read(m_previous.data(), offset, m_type); }
+    template <typename F>
+    void forEach(F&& cb) const {
+        const unsigned w = width(m_type);
+        for (size_t i = 0; i < m_bits.size(); i++) {
+            uint64_t bits = m_bits[i];
+            while (bits) {
+                cb(uint32_t((i * 64 + std::countr_zero(bits)) * w));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+  private:
+    void scan(const uint8_t* memory, Comparison comparison, int64_t value, bool incremental);
+    void scanWords(const uint8_t* memory, size_t begin, size_t end, Comparison comparison, const uint8_t* broadcast,
+                   bool incremental);
+
+    ValueType m_type = ValueType::Uchar;
+    size_t m_slots = 0;
+    size_t m_count = 0;
+    std::vector<uint64_t> m_bits;
+    // How many candidates there are before each word of the bitmap, to find the n-th one quickly.
+    std::vector<uint32_t> m_ranks;
+    std::vector<uint8_t> m_previous;
+};
+
+}  // namespace PCSX
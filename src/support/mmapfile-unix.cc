@@ -24,36 +24,34 @@ SOFTWARE.
 
 */
 
-#include "psyqo/trigonometry.hh"
-
-// This is a table generator for cos(n * 2pi / 2048) * 2^24
-// The table is 512 entries long, from cos(0) to cos(pi/2).
-// The table is generated by the following recurrence relation:
-// f(n) = cos(n * 2pi / 2048)
-// f(n) = 2 * f(1) * f(n - 1) - f(n - 2)
-void psyqo::TrigInternals::generateTable(eastl::array<int32_t, 512>& table, unsigned precisionBits) {
-    // 2^24 * cos(0 * 2pi / 2048)
-    table[0] = 16777216;
-    // 2^24 * cos(1 * 2pi / 2048) = C = f(1)
-    constexpr int64_t C = 16777137;
-    table[1] = C;
-
-    for (int i = 2; i < 511; i++) {
-        table[i] = ((C * table[i - 1]) >> 23) - table[i - 2];
-    }
-
-    // The approximation is a bit too steep, so this value would otherwise
-    // get slightly negative
-    table[511] = 0;
-
-    // Adjusts the precision of the table
-    if (precisionBits > 24) {
-        for (int i = 0; i < 512; i++) {
-            table[i] <<= (precisionBits - 24);
-        }
-    } else if (precisionBits < 24) {
-        for (int i = 0; i < 512; i++) {
-            table[i] >>= (24 - precisionBits);
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "support/mmapfile.h"
+
+void PCSX::MmapFile::map() {
+    int fd = ::open(reinterpret_cast<const char*>(m_filename.u8string().c_str()), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0)) {
+        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+            m_data = static_cast<const uint8_t*>(data);
+            m_size = st.st_size;
+            // The emulator mostly reads sectors in order, so let the kernel read ahead
+            madvise(data, m_size, MADV_SEQUENTIAL);
         }
     }
+    // The mapping keeps its own reference to the file
+    ::close(fd);
 }
+
+void PCSX::MmapFile::unmap() {
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+}
+
+#endif
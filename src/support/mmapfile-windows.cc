@@ -0,0 +1,61 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+#if defined(_WIN32) || defined(_WIN64)
+
+#include "support/mmapfile.h"
+#include "support/windowswrapper.h"
+
+void PCSX::MmapFile::map() {
+    HANDLE file = CreateFileW(m_filename.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return;
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && (size.QuadPart > 0)) {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    if (mapping != nullptr) {
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data != nullptr) {
+            m_data = static_cast<const uint8_t*>(data);
+            m_size = size.QuadPart;
+            m_fileHandle = file;
+            m_mappingHandle = mapping;
+            return;
+        }
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+}
+
+void PCSX::MmapFile::unmap() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mappingHandle) CloseHandle(m_mappingHandle);
+    if (m_fileHandle) CloseHandle(m_fileHandle);
+    m_mappingHandle = m_fileHandle = nullptr;
+}
+
+#endif
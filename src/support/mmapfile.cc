@@ -0,0 +1,71 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/mmapfile.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+PCSX::MmapFile::MmapFile(const std::filesystem::path& filename) : File(RO_SEEKABLE), m_filename(filename) { map(); }
+
+void PCSX::MmapFile::closeInternal() {
+    unmap();
+    m_data = nullptr;
+    m_size = 0;
+}
+
+ssize_t PCSX::MmapFile::rSeek(ssize_t pos, int wheel) {
+    switch (wheel) {
+        case SEEK_SET:
+            m_ptrR = pos;
+            break;
+        case SEEK_END:
+            m_ptrR = m_size - pos;
+            break;
+        case SEEK_CUR:
+            m_ptrR += pos;
+            break;
+    }
+    m_ptrR = std::max(std::min(m_ptrR, m_size), size_t(0));
+    return m_ptrR;
+}
+
+ssize_t PCSX::MmapFile::read(void* dest, size_t size) {
+    size = std::min(m_size - m_ptrR, size);
+    if (size == 0) return -1;
+    memcpy(dest, m_data + m_ptrR, size);
+    m_ptrR += size;
+    return size;
+}
+
+ssize_t PCSX::MmapFile::readAt(void* dest, size_t size, size_t ptr) {
+    if (ptr >= m_size) return -1;
+    size = std::min(m_size - ptr, size);
+    if (size == 0) return -1;
+    memcpy(dest, m_data + ptr, size);
+    return size;
+}
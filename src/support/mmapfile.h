@@ -0,0 +1,73 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <string>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+// A read-only file mapped in memory. Reads are copies straight out of the mapping, and data() gives direct
+// access to it. The OS page cache deals with what's actually resident, and every process mapping the same
+// file shares the same physical pages. The file is considered failed if it can't be mapped, for example
+// because it's empty, or on a file system that doesn't support it.
+class MmapFile : public File {
+  public:
+    // Open the file in read-only mode.
+    MmapFile(const std::filesystem::path& filename);
+
+    virtual ssize_t rSeek(ssize_t pos, int wheel) final override;
+    virtual ssize_t rTell() final override { return m_ptrR; }
+    virtual size_t size() final override { return m_size; }
+    virtual ssize_t read(void* dest, size_t size) final override;
+    virtual ssize_t readAt(void* dest, size_t size, size_t ptr) final override;
+    virtual bool eof() final override { return m_ptrR == m_size; }
+    virtual std::filesystem::path filename() final override { return m_filename; }
+    virtual File* dup() final override { return new MmapFile(m_filename); }
+    virtual bool failed() final override { return m_data == nullptr; }
+
+    const uint8_t* data() const { return m_data; }
+
+  private:
+    virtual void closeInternal() final override;
+    void map();
+    void unmap();
+
+    const std::filesystem::path m_filename;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_ptrR = 0;
+
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+};
+
+}  // namespace PCSX
@@ -352,14 +352,36 @@ struct VertexBuffer {
         glBufferData(GL_ARRAY_BUFFER, size, nullptr, usage);
     }
 
+    // Allocates immutable storage and maps all of it persistently, so vertices can be written to it directly.
+    // Returns nullptr if buffer storage isn't available (needs GL 4.4), in which case the buffer is left uncreated.
+    void* createPersistent(GLsizeiptr size) {
+        if (!gl3wIsSupported(4, 4) || gl3wIsCppThrower(reinterpret_cast<GL3WglProc>(glBufferStorage))) {
+            return nullptr;
+        }
+
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        create();
+        bind();
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        void* mapping = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (mapping == nullptr) {
+            // Immutable storage can't be reallocated, so drop the buffer altogether
+            glDeleteBuffers(1, &m_handle);
+            m_handle = 0;
+        }
+        return mapping;
+    }
+
     VertexBuffer(bool shouldCreate = false) {
         if (shouldCreate) {
             create();
         }
     }
 
-    ~VertexBuffer() {
+    ~VertexBuffer() { destroy(); }
+    void destroy() {
         if (exists()) glDeleteBuffers(1, &m_handle);
+        m_handle = 0;
     }
     GLuint handle() { return m_handle; }
     bool exists() { return m_handle != 0; }
@@ -453,6 +475,14 @@ static inline GLint getProgram() { return get<GLint>(GL_CURRENT_PROGRAM); }
 static inline bool scissorEnabled() { return isEnabled(GL_SCISSOR_TEST); }
 
 static inline bool versionSupported(int major, int minor) { return gl3wIsSupported(major, minor); }
+static inline bool hasExtension(std::string_view name) {
+    const GLint count = get<GLint>(GL_NUM_EXTENSIONS);
+    for (GLint i = 0; i < count; i++) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension && (name == extension)) return true;
+    }
+    return false;
+}
 
 [[nodiscard]] static inline GLint uniformLocation(GLuint program, const char* name) {
     return glGetUniformLocation(program, name);
@@ -577,6 +607,10 @@ struct Rectangle {
 
     bool isEmpty() { return width == 0 && height == 0; }
     bool isLine() { return (width == 0 && height != 0) || (width != 0 && height == 0); }
+    bool intersects(const Rectangle& other) const {
+        return x < other.x + other.width && other.x < x + width && y < other.y + other.height &&
+               other.y < y + height;
+    }
 
     void setEmpty() { x = y = width = height = 0; }
 };
@@ -37,6 +37,7 @@ SOFTWARE.
 #include <type_traits>
 #include <vector>
 
+#include "support/file.h"
 #include "typestring.hh"
 
 namespace PCSX {
@@ -120,9 +121,26 @@ class InSlice {
     }
 };
 
+// Where the serialized data goes. By default, it is all kept in memory, until finalize() hands it over.
+// An OutSlice can instead stream it straight into a file, in which case the large byte fields are written
+// from where they live, without any intermediate copy, or only count how many bytes would be written, which
+// is how the length of an embedded message gets known before streaming it.
 class OutSlice {
   public:
-    void putU8(uint8_t value) { m_data += std::string(reinterpret_cast<const char *>(&value), 1); }
+    enum Count { COUNT };
+    OutSlice() {}
+    explicit OutSlice(File *sink) : m_sink(sink) {}
+    explicit OutSlice(Count) : m_counting(true) {}
+    ~OutSlice() { flush(); }
+    OutSlice(const OutSlice &) = delete;
+    OutSlice &operator=(const OutSlice &) = delete;
+
+    void putU8(uint8_t value) {
+        m_size++;
+        if (m_counting) return;
+        m_data.push_back(static_cast<char>(value));
+        if (m_sink && (m_data.size() >= c_flushThreshold)) flush();
+    }
     void putU16(uint16_t value) {
         putU8(value & 0xff);
         value >>= 8;
@@ -139,10 +157,18 @@ class OutSlice {
         putU32(value & 0xffffffff);
     }
     void putBytes(const uint8_t *bytes, uint64_t size) {
-        m_data += std::string(reinterpret_cast<const char *>(bytes), size);
+        m_size += size;
+        if (m_counting) return;
+        if (m_sink && (size >= c_flushThreshold)) {
+            flush();
+            write(bytes, size);
+            return;
+        }
+        m_data.append(reinterpret_cast<const char *>(bytes), size);
+        if (m_sink && (m_data.size() >= c_flushThreshold)) flush();
     }
-    void putBytes(const std::string &str) { m_data += str; }
-    void putSlice(OutSlice *slice) { m_data += slice->m_data; }
+    void putBytes(const std::string &str) { putBytes(reinterpret_cast<const uint8_t *>(str.data()), str.size()); }
+    void putSlice(OutSlice *slice) { putBytes(slice->m_data); }
     void putVarInt(uint64_t value) {
         uint8_t b = 0;
         do {
@@ -153,8 +179,30 @@ class OutSlice {
     }
     std::string finalize() { return std::move(m_data); }
 
+    // Whether everything goes in memory, as opposed to a file, or nowhere.
+    bool buffered() const { return !m_sink && !m_counting; }
+    // How many bytes went through this slice so far.
+    uint64_t size() const { return m_size; }
+    // Only for streaming slices: pushes the pending bytes into the file.
+    void flush() {
+        if (!m_sink || m_data.empty()) return;
+        write(reinterpret_cast<const uint8_t *>(m_data.data()), m_data.size());
+        m_data.clear();
+    }
+    bool failed() const { return m_failed; }
+
   private:
+    static constexpr size_t c_flushThreshold = 16384;
+    void write(const uint8_t *bytes, uint64_t size) {
+        if (m_failed) return;
+        if (m_sink->write(bytes, size) != static_cast<ssize_t>(size)) m_failed = true;
+    }
+
     std::string m_data;
+    File *m_sink = nullptr;
+    uint64_t m_size = 0;
+    bool m_counting = false;
+    bool m_failed = false;
 };
 
 template <typename innerType, unsigned wireTypeValue>
@@ -343,6 +391,10 @@ struct FixedBytes {
         allocate();
         memcpy(value, src, amount);
     }
+    void release() {
+        delete[] value;
+        value = nullptr;
+    }
     constexpr void copyTo(uint8_t *dst) const {
         if (!value) {
             memset(dst, 0, amount);
@@ -475,6 +527,8 @@ struct FieldPtr<FieldType, irqus::typestring<C...>, fieldNumberValue> {
     constexpr void deserialize(InSlice *slice, unsigned wireType) { copy.deserialize(slice, wireType); }
     constexpr void reset() {}
     constexpr void commit() {
+        // Leaving the destination alone if the field wasn't in the data.
+        if (!copy.value) return;
         FieldType *field = reinterpret_cast<FieldType *>(&ref);
         field->copyFrom(copy.value);
     }
@@ -714,6 +768,14 @@ struct MessageField<MessageType, irqus::typestring<C...>, fieldNumberValue> : pu
     }
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const {
+        if (!slice->buffered()) {
+            // The length goes first, so it needs a dry run, but nothing of the message gets copied.
+            OutSlice counter(OutSlice::COUNT);
+            MessageType::serialize(&counter);
+            slice->putVarInt(counter.size());
+            MessageType::serialize(slice);
+            return;
+        }
         OutSlice subSlice;
         MessageType::serialize(&subSlice);
         std::string subSliceData = subSlice.finalize();
@@ -81,6 +81,12 @@ bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero) {
     return !(doRawAlloc && id != nullptr);
 }
 
+bool PCSX::SharedMem::mapView(void* address, size_t offset, size_t size) {
+    if (m_fd < 0 || offset + size > m_size) return false;
+    void* view = mmap(address, size, PROT_READ, MAP_SHARED | MAP_FIXED, m_fd, static_cast<off_t>(offset));
+    return view == address;
+}
+
 PCSX::SharedMem::~SharedMem() {
     if (m_fd == -1) {
         free(m_mem);
@@ -72,6 +72,10 @@ bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero) {
     return !(doRawAlloc && id != nullptr);
 }
 
+// Placing views at fixed addresses on Windows requires VirtualAlloc2 placeholders and MapViewOfFile3,
+// which aren't wired up yet. Callers fall back to not using fixed views.
+bool PCSX::SharedMem::mapView(void* address, size_t offset, size_t size) { return false; }
+
 PCSX::SharedMem::~SharedMem() {
     if (m_fileHandle != nullptr) {
         UnmapViewOfFile(m_mem);
@@ -51,6 +51,19 @@ class SharedMem {
 
     const std::string& getSharedName() { return m_sharedName; }
 
+    /**
+     * Returns true if the memory is backed by a named shared mapping,
+     * as opposed to having defaulted to a raw alloc.
+     */
+    bool isShared() { return m_fd >= 0 || m_fileHandle != nullptr; }
+
+    /**
+     * Maps a read-only view of [offset, offset + size) of the shared memory
+     * at a fixed host address, replacing any mapping already there.
+     * Returns false if the memory isn't shared, or if the OS refused.
+     */
+    bool mapView(void* address, size_t offset, size_t size);
+
   private:
     std::string getSharedName(const char* id, uint32_t pid);
 
@@ -32,6 +32,7 @@ SOFTWARE.
 #include <string.h>
 
 #include <algorithm>
+#include <deque>
 #include <limits>
 #include <string>
 #include <string_view>
@@ -262,4 +263,124 @@ class Slice {
     std::variant<std::monostate, std::string, Inlined, Owned, Borrowed> m_data;
 };
 
+// An ordered list of slices, meant to be handed as a whole to scatter/gather writes, or drained from the
+// front, without ever copying the slices' contents together. The slices are kept in a deque, so that the
+// inlined ones don't move around while they're being referenced.
+class SliceChain {
+  public:
+    SliceChain() {}
+    SliceChain(const SliceChain &) = delete;
+    SliceChain(SliceChain &&other) noexcept
+        : m_slices(std::move(other.m_slices)), m_offset(other.m_offset), m_size(other.m_size) {
+        other.m_offset = 0;
+        other.m_size = 0;
+    }
+    SliceChain &operator=(const SliceChain &) = delete;
+    SliceChain &operator=(SliceChain &&other) noexcept {
+        m_slices = std::move(other.m_slices);
+        m_offset = other.m_offset;
+        m_size = other.m_size;
+        other.m_slices.clear();
+        other.m_offset = 0;
+        other.m_size = 0;
+        return *this;
+    }
+
+    void push(Slice &&slice) {
+        if (slice.size() == 0) return;
+        m_size += slice.size();
+        m_slices.emplace_back(std::move(slice));
+    }
+    template <size_t L>
+    void push(const char (&str)[L]) {
+        Slice slice;
+        slice.borrow(str, L - 1);
+        push(std::move(slice));
+    }
+    void push(std::string &&str) { push(Slice(std::move(str))); }
+    void push(SliceChain &&other) {
+        if (other.m_offset != 0) {
+            Slice &front = other.m_slices.front();
+            Slice rest;
+            rest.copy(front.data<uint8_t>() + other.m_offset, front.size() - other.m_offset);
+            other.m_slices.pop_front();
+            push(std::move(rest));
+        }
+        for (auto &slice : other.m_slices) push(std::move(slice));
+        other.clear();
+    }
+
+    void clear() {
+        m_slices.clear();
+        m_offset = 0;
+        m_size = 0;
+    }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    // How many separate buffers are left, which is what a scatter/gather write needs to know.
+    size_t count() const { return m_slices.size(); }
+
+    // Calls cb(const void *ptr, size_t size) for each contiguous piece of what's left, in order.
+    template <typename CB>
+    void forEach(CB &&cb) const {
+        size_t offset = m_offset;
+        for (auto &slice : m_slices) {
+            cb(slice.data<uint8_t>() + offset, slice.size() - offset);
+            offset = 0;
+        }
+    }
+
+    // Drops the first size bytes, releasing the slices that got fully consumed.
+    void consume(size_t size) {
+        size = std::min(size, m_size);
+        m_size -= size;
+        while (size != 0) {
+            auto left = m_slices.front().size() - m_offset;
+            if (size < left) {
+                m_offset += size;
+                return;
+            }
+            size -= left;
+            m_offset = 0;
+            m_slices.pop_front();
+        }
+    }
+
+    // Copies out, and consumes, up to size bytes. This is only for the consumers which need contiguous data.
+    size_t read(void *dest, size_t size) {
+        uint8_t *ptr = static_cast<uint8_t *>(dest);
+        size = std::min(size, m_size);
+        size_t copied = 0;
+        while (copied < size) {
+            const Slice &front = m_slices.front();
+            auto amount = std::min(size - copied, front.size() - m_offset);
+            memcpy(ptr + copied, front.data<uint8_t>() + m_offset, amount);
+            copied += amount;
+            consume(amount);
+        }
+        return copied;
+    }
+
+    // Takes the first slice out, or what's left of it. Only the partially consumed case needs a copy.
+    Slice pop() {
+        Slice ret;
+        if (m_slices.empty()) return ret;
+        Slice &front = m_slices.front();
+        if (m_offset == 0) {
+            ret = std::move(front);
+        } else {
+            ret.copy(front.data<uint8_t>() + m_offset, front.size() - m_offset);
+        }
+        m_size -= ret.size();
+        m_offset = 0;
+        m_slices.pop_front();
+        return ret;
+    }
+
+  private:
+    std::deque<Slice> m_slices;
+    size_t m_offset = 0;
+    size_t m_size = 0;
+};
+
 }  // namespace PCSX
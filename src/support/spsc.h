@@ -0,0 +1,139 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <span>
+#include <type_traits>
+
+namespace PCSX {
+
+// A lock-free ring buffer with exactly one producer thread and one consumer thread. Unlike Circular, nothing
+// becomes visible to the other side until it's explicitly committed or consumed, so that the producer can
+// write a packet in several pieces, and so that the consumer can hold on to the data while it's working on
+// it. The wait functions block on the positions themselves, so there's no mutex involved at any point.
+template <typename T, size_t BS = 1024>
+class SPSCRing {
+    static_assert((BS & (BS - 1)) == 0, "The ring size needs to be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "The ring can only hold trivially copyable types");
+
+  public:
+    static constexpr size_t BUFFER_SIZE = BS;
+
+    // Producer side.
+    size_t available() const { return BUFFER_SIZE - (m_head.load(std::memory_order_relaxed) - acquireTail()); }
+    // Writes into the free space, at an offset from the current head. The caller needs to have checked
+    // that there's enough room first.
+    void write(const T* data, size_t N, size_t offset = 0) {
+        size_t pos = m_head.load(std::memory_order_relaxed) + offset;
+        while (N != 0) {
+            const size_t index = pos & (BUFFER_SIZE - 1);
+            const size_t len = std::min(N, BUFFER_SIZE - index);
+            std::copy_n(data, len, m_buffer + index);
+            data += len;
+            pos += len;
+            N -= len;
+        }
+    }
+    // Makes the first N written elements visible to the consumer.
+    void commit(size_t N) {
+        m_head.store(m_head.load(std::memory_order_relaxed) + N, std::memory_order_release);
+        m_head.notify_one();
+    }
+    // Blocks until at least N elements are free.
+    void waitForSpace(size_t N) const {
+        while (true) {
+            const size_t tail = acquireTail();
+            if ((BUFFER_SIZE - (m_head.load(std::memory_order_relaxed) - tail)) >= N) return;
+            m_tail.wait(tail, std::memory_order_acquire);
+        }
+    }
+    // Blocks until the consumer consumed everything that was committed.
+    void waitForEmpty() const {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        while (true) {
+            const size_t tail = acquireTail();
+            if (tail == head) return;
+            m_tail.wait(tail, std::memory_order_acquire);
+        }
+    }
+
+    // Consumer side.
+    size_t buffered() const { return acquireHead() - m_tail.load(std::memory_order_relaxed); }
+    // Copies N elements starting at an offset from the current tail, without consuming them.
+    void read(T* data, size_t N, size_t offset = 0) const {
+        size_t pos = m_tail.load(std::memory_order_relaxed) + offset;
+        while (N != 0) {
+            const size_t index = pos & (BUFFER_SIZE - 1);
+            const size_t len = std::min(N, BUFFER_SIZE - index);
+            std::copy_n(m_buffer + index, len, data);
+            data += len;
+            pos += len;
+            N -= len;
+        }
+    }
+    // Returns the largest contiguous span of committed data at an offset from the current tail.
+    // If the data wraps around the end of the ring, the rest is in the span at the next offset.
+    std::span<const T> peek(size_t offset = 0) const {
+        const size_t pos = m_tail.load(std::memory_order_relaxed) + offset;
+        const size_t head = acquireHead();
+        if (pos >= head) return {};
+        const size_t index = pos & (BUFFER_SIZE - 1);
+        return {m_buffer + index, std::min(head - pos, BUFFER_SIZE - index)};
+    }
+    // Releases the first N elements back to the producer.
+    void consume(size_t N) {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + N, std::memory_order_release);
+        m_tail.notify_one();
+    }
+    // Blocks until there's at least one committed element.
+    void waitForData() const {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        while (true) {
+            const size_t head = acquireHead();
+            if (head != tail) return;
+            m_head.wait(head, std::memory_order_acquire);
+        }
+    }
+
+  private:
+    size_t acquireHead() const { return m_head.load(std::memory_order_acquire); }
+    size_t acquireTail() const { return m_tail.load(std::memory_order_acquire); }
+
+    // Both positions only ever grow, and get wrapped when indexing the buffer. This way, a full ring
+    // and an empty ring don't look the same. They are kept on separate cache lines, as they are
+    // written by different threads.
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+    alignas(64) T m_buffer[BUFFER_SIZE];
+};
+
+}  // namespace PCSX
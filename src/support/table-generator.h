@@ -36,7 +36,7 @@ namespace generator::details {
 template <typename T, std::size_t N>
 struct Table {
     const T data[N];
-    T operator[](std::size_t index) const { return data[index]; }
+    constexpr T operator[](std::size_t index) const { return data[index]; }
     static constexpr std::size_t size() { return N; }
     const T* begin() const { return &data[0]; }
     const T* end() const { return &data[N]; }
@@ -25,10 +25,25 @@ SOFTWARE.
 */
 #include "support/uvfile.h"
 
+#include <ctype.h>
 #include <curl/curl.h>
-
+#include <errno.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
 #include <cstdint>
 #include <exception>
+#include <mutex>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "support/md5.h"
 
 struct CurlContext {
     CurlContext(curl_socket_t sockfd, uv_loop_t *loop) : sockfd(sockfd) {
@@ -58,6 +73,7 @@ size_t PCSX::UvThreadOp::s_dataDownloadSinceLastTick;
 std::atomic<size_t> PCSX::UvThreadOp::s_dataReadLastTick;
 std::atomic<size_t> PCSX::UvThreadOp::s_dataWrittenLastTick;
 std::atomic<size_t> PCSX::UvThreadOp::s_dataDownloadLastTick;
+std::atomic<size_t> PCSX::UvThreadOp::s_dataReadDirectly;
 ConcurrentQueue<PCSX::UvThreadOp::UvRequest> PCSX::UvThreadOp::s_queue;
 PCSX::UvThreadOpListType PCSX::UvThreadOp::s_allOps;
 uv_loop_t PCSX::UvThreadOp::s_uvLoop;
@@ -105,6 +121,7 @@ void PCSX::UvThreadOp::startThread() {
         uv_timer_start(
             &s_timer,
             [](uv_timer_t *timer) {
+                s_dataReadTotal += s_dataReadDirectly.exchange(0, std::memory_order_relaxed);
                 s_dataReadLastTick.store(s_dataReadTotal - s_dataReadSinceLastTick, std::memory_order_relaxed);
                 s_dataWrittenLastTick.store(s_dataWrittenTotal - s_dataWrittenSinceLastTick, std::memory_order_relaxed);
                 s_dataDownloadLastTick.store(s_dataDownloadTotal - s_dataDownloadSinceLastTick,
@@ -375,7 +392,6 @@ void PCSX::UvThreadOp::processCurlMultiInfo() {
 
             curl_easy_getinfo(easy_handle, CURLINFO_PRIVATE, &self);
             self->downloadDone(message);
-            break;
         }
     }
 }
@@ -448,6 +464,11 @@ ssize_t PCSX::UvFile::read(void *dest, size_t size) {
         m_ptrR += size;
         return size;
     }
+    if (canReadDirectly()) {
+        ssize_t ret = readDirectly(dest, size, m_ptrR);
+        if (ret > 0) m_ptrR += ret;
+        return ret;
+    }
     struct Info {
         std::promise<ssize_t> res;
         uv_buf_t buf;
@@ -595,6 +616,7 @@ ssize_t PCSX::UvFile::readAt(void *dest, size_t size, size_t ptr) {
         memcpy(dest, m_cache + ptr, size);
         return size;
     }
+    if (canReadDirectly()) return readDirectly(dest, size, ptr);
     struct Info {
         std::promise<ssize_t> res;
         uv_buf_t buf;
@@ -712,6 +734,39 @@ void PCSX::UvFile::writeAt(Slice &&slice, size_t ptr) {
 
 bool PCSX::UvFile::eof() { return m_size == m_ptrR; }
 
+ssize_t PCSX::UvFile::readDirectly(void *dest, size_t size, size_t ptr) {
+#ifdef _WIN32
+    // The handle isn't opened for overlapped I/O, but the offset in the OVERLAPPED structure still makes
+    // this a positional read, which doesn't care about the file pointer.
+    HANDLE handle = uv_get_osfhandle(m_handle);
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = DWORD(ptr);
+    overlapped.OffsetHigh = DWORD(uint64_t(ptr) >> 32);
+    DWORD bytesRead = 0;
+    if (!ReadFile(handle, dest, DWORD(size), &bytesRead, &overlapped)) return -1;
+    ssize_t ret = bytesRead;
+#else
+    ssize_t ret;
+    do {
+        ret = pread(m_handle, dest, size, ptr);
+    } while ((ret < 0) && (errno == EINTR));
+#endif
+    if (ret > 0) s_dataReadDirectly.fetch_add(ret, std::memory_order_relaxed);
+    return ret;
+}
+
+void PCSX::UvFile::prefetch(size_t ptr, size_t size) {
+    if (!canReadDirectly() || (m_cacheProgress.load(std::memory_order_relaxed) == 1.0f)) return;
+#if defined(__linux__)
+    posix_fadvise(m_handle, ptr, size, POSIX_FADV_WILLNEED);
+#elif defined(__APPLE__)
+    radvisory advisory;
+    advisory.ra_offset = ptr;
+    advisory.ra_count = size;
+    fcntl(m_handle, F_RDADVISE, &advisory);
+#endif
+}
+
 void PCSX::UvFile::readCacheChunk(uv_loop_t *loop) {
     if (m_cachePtr >= m_size) {
         m_cacheProgress.store(1.0f, std::memory_order_release);
@@ -775,6 +830,432 @@ void PCSX::UvFile::cacheCallbackSetup(std::function<void()> &&callbackDone, uv_l
     }
 }
 
+std::filesystem::path PCSX::UvHttpFile::s_cacheDirectory;
+uint64_t PCSX::UvHttpFile::s_cacheMaxSize = 0;
+
+// Writes to a temporary file first, so that the other processes sharing the cache directory never see
+// a partial file.
+static bool writeAtomically(const std::filesystem::path &path, const void *data, size_t size) {
+    static std::atomic<uint64_t> s_counter = std::random_device()();
+    std::filesystem::path temp = path;
+    temp += "." + std::to_string(s_counter++) + ".tmp";
+    PCSX::IO<PCSX::File> out(new PCSX::PosixFile(temp, PCSX::FileOps::TRUNCATE));
+    if (out->failed()) return false;
+    bool written = out->write(data, size) == ssize_t(size);
+    out->close();
+    std::error_code ec;
+    if (written) std::filesystem::rename(temp, path, ec);
+    if (!written || ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+struct PCSX::UvHttpFile::Cache : public std::enable_shared_from_this<Cache> {
+    enum class State : uint8_t { Missing, Pending, Ready, Failed, OnDisk };
+    Cache(std::string_view url) : url(url) {}
+    size_t blockCount() const { return (size + c_blockSize - 1) / c_blockSize; }
+    size_t blockBytes(size_t block) const { return std::min(c_blockSize, size - block * c_blockSize); }
+    bool needsFetching(size_t block) const {
+        return (states[block] == State::Missing) || (states[block] == State::Failed);
+    }
+    // These have to be called with the mutex held.
+    void fetch(size_t first, size_t last);
+    void attach(const std::filesystem::path &entry);
+    bool load(size_t block);
+    // The data of the ready blocks doesn't change anymore, so this doesn't need the mutex.
+    void persist(const std::filesystem::path &entry, size_t block) {
+        writeAtomically(entry / std::to_string(block), blocks[block].get(), blockBytes(block));
+    }
+
+    const std::string url;
+    std::string validator;
+    std::filesystem::path directory;
+    size_t size = 0;
+    bool rangesSupported = false;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<State> states;
+    std::vector<std::unique_ptr<uint8_t[]>> blocks;
+    size_t lastBlock = 0;
+    size_t readAhead = c_minReadAhead;
+    std::promise<bool> opened;
+    bool isOpened = false;
+};
+
+// One range request, covering the blocks from first to last. It deletes itself once done.
+class PCSX::UvHttpFile::Request : public UvThreadOp {
+  public:
+    Request(std::shared_ptr<Cache> cache, size_t first, size_t last, bool initial)
+        : m_blocks(std::move(cache)), m_first(first), m_last(last), m_initial(initial) {}
+    void start() {
+        std::string range = std::to_string(m_first * c_blockSize) + "-" + std::to_string((m_last + 1) * c_blockSize - 1);
+        m_handle = curl_easy_init();
+        curl_easy_setopt(m_handle, CURLOPT_URL, m_blocks->url.c_str());
+        curl_easy_setopt(m_handle, CURLOPT_RANGE, range.c_str());
+        curl_easy_setopt(m_handle, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(m_handle, CURLOPT_FAILONERROR, 1L);
+        curl_easy_setopt(m_handle, CURLOPT_PRIVATE, static_cast<UvThreadOp *>(this));
+        curl_easy_setopt(m_handle, CURLOPT_HEADERDATA, this);
+        curl_easy_setopt(m_handle, CURLOPT_HEADERFUNCTION, headerTrampoline);
+        curl_easy_setopt(m_handle, CURLOPT_WRITEDATA, this);
+        curl_easy_setopt(m_handle, CURLOPT_WRITEFUNCTION, writeTrampoline);
+        curl_multi_add_handle(s_curlMulti, m_handle);
+    }
+
+  private:
+    virtual bool canCache() const override { return false; }
+    virtual void downloadDone(CURLMsg *message) override;
+    static size_t headerTrampoline(char *ptr, size_t size, size_t nmemb, void *userdata) {
+        return reinterpret_cast<Request *>(userdata)->header(std::string_view(ptr, size * nmemb));
+    }
+    static size_t writeTrampoline(char *ptr, size_t size, size_t nmemb, void *userdata) {
+        return reinterpret_cast<Request *>(userdata)->write(reinterpret_cast<const uint8_t *>(ptr), size * nmemb);
+    }
+    size_t header(std::string_view line);
+    void headersDone();
+    size_t write(const uint8_t *ptr, size_t size);
+
+    std::shared_ptr<Cache> m_blocks;
+    CURL *m_handle = nullptr;
+    const size_t m_first;
+    const size_t m_last;
+    const bool m_initial;
+    bool m_receiving = false;
+    size_t m_position = 0;
+    size_t m_contentLength = 0;
+    size_t m_total = 0;
+    std::string m_etag;
+    std::string m_lastModified;
+};
+
+void PCSX::UvHttpFile::Cache::fetch(size_t first, size_t last) {
+    // Without range support, the initial request is already streaming all of the file.
+    if (!rangesSupported) return;
+    size_t block = first;
+    while (block <= last) {
+        if (!needsFetching(block)) {
+            block++;
+            continue;
+        }
+        size_t end = block;
+        while ((end < last) && ((end + 1 - block) < c_maxReadAhead) && needsFetching(end + 1)) end++;
+        for (size_t i = block; i <= end; i++) states[i] = State::Pending;
+        request([cache = shared_from_this(), block, end](auto loop) {
+            (new Request(cache, block, end, false))->start();
+        });
+        block = end + 1;
+    }
+}
+
+static size_t parseHeaderNumber(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ')) value.remove_prefix(1);
+    size_t ret = 0;
+    std::from_chars(value.data(), value.data() + value.size(), ret);
+    return ret;
+}
+
+static std::string trimHeaderValue(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ')) value.remove_prefix(1);
+    while (!value.empty() && ((value.back() == '\r') || (value.back() == '\n') || (value.back() == ' '))) {
+        value.remove_suffix(1);
+    }
+    return std::string(value);
+}
+
+static bool headerIs(std::string_view line, std::string_view name) {
+    if (line.size() < name.size()) return false;
+    for (size_t i = 0; i < name.size(); i++) {
+        if (tolower(line[i]) != name[i]) return false;
+    }
+    return true;
+}
+
+size_t PCSX::UvHttpFile::Request::header(std::string_view line) {
+    if (line.starts_with("HTTP/")) {
+        // Redirects get their own set of headers.
+        m_contentLength = 0;
+        m_total = 0;
+        m_etag.clear();
+        m_lastModified.clear();
+    } else if (headerIs(line, "content-length:")) {
+        m_contentLength = parseHeaderNumber(line.substr(15));
+    } else if (headerIs(line, "content-range:")) {
+        auto slash = line.rfind('/');
+        if (slash != std::string_view::npos) m_total = parseHeaderNumber(line.substr(slash + 1));
+    } else if (headerIs(line, "etag:")) {
+        m_etag = trimHeaderValue(line.substr(5));
+    } else if (headerIs(line, "last-modified:")) {
+        m_lastModified = trimHeaderValue(line.substr(14));
+    } else if ((line == "\r\n") || (line == "\n")) {
+        headersDone();
+    }
+    return line.size();
+}
+
+void PCSX::UvHttpFile::Request::headersDone() {
+    long code = 0;
+    curl_easy_getinfo(m_handle, CURLINFO_RESPONSE_CODE, &code);
+    if ((code != 200) && (code != 206)) return;
+    m_receiving = true;
+    // A server ignoring the range sends the file from its start.
+    m_position = code == 206 ? m_first * c_blockSize : 0;
+    if (!m_initial) return;
+
+    std::unique_lock<std::mutex> lock(m_blocks->mutex);
+    const size_t size = code == 206 ? m_total : m_contentLength;
+    if (size == 0) return;
+    m_blocks->size = size;
+    m_blocks->rangesSupported = code == 206;
+    m_blocks->validator = m_etag.empty() ? (m_lastModified.empty() ? "" : "lm:" + m_lastModified) : "etag:" + m_etag;
+    const size_t count = m_blocks->blockCount();
+    m_blocks->states.assign(count, m_blocks->rangesSupported ? Cache::State::Missing : Cache::State::Pending);
+    m_blocks->blocks.resize(count);
+    for (size_t i = m_first; i <= std::min(m_last, count - 1); i++) m_blocks->states[i] = Cache::State::Pending;
+    m_blocks->isOpened = true;
+    m_blocks->opened.set_value(true);
+}
+
+size_t PCSX::UvHttpFile::Request::write(const uint8_t *ptr, size_t size) {
+    s_dataDownloadTotal += size;
+    std::unique_lock<std::mutex> lock(m_blocks->mutex);
+    if (!m_receiving || (m_blocks->size == 0)) return 0;
+    bool completed = false;
+    size_t firstCompleted = 0;
+    size_t lastCompleted = 0;
+    size_t done = 0;
+    while ((done < size) && (m_position < m_blocks->size)) {
+        const size_t block = m_position / c_blockSize;
+        const size_t offset = m_position % c_blockSize;
+        const size_t bytes = m_blocks->blockBytes(block);
+        const size_t amount = std::min(bytes - offset, size - done);
+        auto &state = m_blocks->states[block];
+        if (state != Cache::State::Ready) {
+            auto &data = m_blocks->blocks[block];
+            if (!data) data.reset(new uint8_t[bytes]);
+            memcpy(data.get() + offset, ptr + done, amount);
+            if ((offset + amount) == bytes) {
+                state = Cache::State::Ready;
+                if (!completed) firstCompleted = block;
+                lastCompleted = block;
+                completed = true;
+            }
+        }
+        m_position += amount;
+        done += amount;
+    }
+    if (!completed) return size;
+    m_blocks->cv.notify_all();
+    std::filesystem::path directory = m_blocks->directory;
+    lock.unlock();
+    if (directory.empty()) return size;
+    for (size_t i = firstCompleted; i <= lastCompleted; i++) m_blocks->persist(directory, i);
+    return size;
+}
+
+void PCSX::UvHttpFile::Request::downloadDone(CURLMsg *message) {
+    curl_multi_remove_handle(s_curlMulti, m_handle);
+    curl_easy_cleanup(m_handle);
+    m_handle = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(m_blocks->mutex);
+        // Whatever didn't make it gets requested again by the next read needing it.
+        const size_t count = m_blocks->blockCount();
+        const size_t last = m_blocks->rangesSupported ? std::min(m_last, count - 1) : count - 1;
+        for (size_t i = m_first; (i <= last) && (i < count); i++) {
+            if (m_blocks->states[i] == Cache::State::Pending) m_blocks->states[i] = Cache::State::Failed;
+        }
+        if (m_initial && !m_blocks->isOpened) {
+            m_blocks->isOpened = true;
+            m_blocks->opened.set_value(false);
+        }
+        m_blocks->cv.notify_all();
+    }
+    delete this;
+}
+
+PCSX::UvHttpFile::UvHttpFile(const std::string_view &url)
+    : File(RO_SEEKABLE), m_blocks(std::make_shared<Cache>(url)), m_filename(url) {
+    auto opened = m_blocks->opened.get_future();
+    request([cache = m_blocks](auto loop) { (new Request(cache, 0, c_minReadAhead - 1, true))->start(); });
+    m_failed = !opened.get();
+    if (m_failed) return;
+    m_size = m_blocks->size;
+
+    if (s_cacheDirectory.empty()) return;
+    std::filesystem::path entry;
+    {
+        std::unique_lock<std::mutex> lock(m_blocks->mutex);
+        if (m_blocks->validator.empty() || !m_blocks->rangesSupported) return;
+        // The entries are named after the version of the URL they contain, so a changed file gets a new one,
+        // and the old one ages out.
+        MD5 md5;
+        std::string key = m_blocks->url + "\n" + std::to_string(m_size) + "\n" + m_blocks->validator;
+        md5.update(key.data(), key.size());
+        uint8_t digest[16];
+        md5.finish(digest);
+        std::string name;
+        for (auto d : digest) {
+            static const char c_hex[] = "0123456789abcdef";
+            name += c_hex[d >> 4];
+            name += c_hex[d & 15];
+        }
+        entry = s_cacheDirectory / name;
+        m_blocks->attach(entry);
+    }
+    trimCache(entry);
+}
+
+void PCSX::UvHttpFile::Cache::attach(const std::filesystem::path &entry) {
+    std::error_code ec;
+    std::filesystem::create_directories(entry, ec);
+    // The metadata file's time tells when the entry got opened last, for the eviction.
+    if (!writeAtomically(entry / "meta", url.data(), url.size())) return;
+    try {
+        for (auto &file : std::filesystem::directory_iterator(entry)) {
+            const auto name = file.path().filename().string();
+            size_t block = 0;
+            auto [end, error] = std::from_chars(name.data(), name.data() + name.size(), block);
+            if ((error != std::errc()) || (end != (name.data() + name.size())) || (block >= states.size())) continue;
+            if (states[block] == State::Missing) states[block] = State::OnDisk;
+        }
+    } catch (...) {
+        return;
+    }
+    directory = entry;
+    for (size_t i = 0; i < states.size(); i++) {
+        if (states[i] == State::Ready) persist(entry, i);
+    }
+}
+
+bool PCSX::UvHttpFile::Cache::load(size_t block) {
+    // Another process may have evicted the block in the meantime, and it then gets fetched again.
+    IO<File> in(new PosixFile(directory / std::to_string(block)));
+    const size_t bytes = blockBytes(block);
+    if (in->failed() || (in->size() != bytes)) return false;
+    auto &data = blocks[block];
+    if (!data) data.reset(new uint8_t[bytes]);
+    bool ret = in->readAt(data.get(), bytes, 0) == ssize_t(bytes);
+    in->close();
+    return ret;
+}
+
+void PCSX::UvHttpFile::trimCache(const std::filesystem::path &keep) {
+    std::vector<std::tuple<std::filesystem::file_time_type, uint64_t, std::filesystem::path>> entries;
+    uint64_t total = 0;
+    try {
+        for (auto &entry : std::filesystem::directory_iterator(s_cacheDirectory)) {
+            if (!entry.is_directory()) continue;
+            uint64_t size = 0;
+            for (auto &file : std::filesystem::directory_iterator(entry.path())) {
+                std::error_code ec;
+                auto fileSize = file.file_size(ec);
+                if (!ec) size += fileSize;
+            }
+            std::error_code ec;
+            auto time = std::filesystem::last_write_time(entry.path() / "meta", ec);
+            total += size;
+            if (entry.path() != keep) entries.emplace_back(time, size, entry.path());
+        }
+    } catch (...) {
+        return;
+    }
+    std::sort(entries.begin(), entries.end());
+    for (auto &[time, size, path] : entries) {
+        if (total <= s_cacheMaxSize) break;
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+        total -= size;
+    }
+}
+
+PCSX::UvHttpFile::UvHttpFile(std::shared_ptr<Cache> cache, const std::filesystem::path &filename)
+    : File(RO_SEEKABLE), m_blocks(std::move(cache)), m_filename(filename), m_failed(false), m_size(m_blocks->size) {}
+
+PCSX::File *PCSX::UvHttpFile::dup() {
+    if (m_failed) return new FailedFile();
+    return new UvHttpFile(m_blocks, m_filename);
+}
+
+ssize_t PCSX::UvHttpFile::rSeek(ssize_t pos, int wheel) {
+    switch (wheel) {
+        case SEEK_SET:
+            m_ptrR = pos;
+            break;
+        case SEEK_END:
+            m_ptrR = m_size - pos;
+            break;
+        case SEEK_CUR:
+            m_ptrR += pos;
+            break;
+    }
+    m_ptrR = std::max(std::min(m_ptrR, m_size), size_t(0));
+    return m_ptrR;
+}
+
+void PCSX::UvHttpFile::prefetch(size_t ptr, size_t size) {
+    if (m_failed || (ptr >= m_size) || (size == 0)) return;
+    const size_t first = ptr / c_blockSize;
+    const size_t last = std::min(ptr + size - 1, m_size - 1) / c_blockSize;
+    std::unique_lock<std::mutex> lock(m_blocks->mutex);
+    m_blocks->fetch(first, last);
+}
+
+ssize_t PCSX::UvHttpFile::read(void *dest, size_t size) {
+    ssize_t ret = readAt(dest, size, m_ptrR);
+    if (ret > 0) m_ptrR += ret;
+    return ret;
+}
+
+ssize_t PCSX::UvHttpFile::readAt(void *dest, size_t size, size_t ptr) {
+    if (m_failed || (ptr >= m_size)) return -1;
+    size = std::min(m_size - ptr, size);
+    if (size == 0) return -1;
+    const size_t first = ptr / c_blockSize;
+    const size_t last = (ptr + size - 1) / c_blockSize;
+
+    auto &cache = *m_blocks;
+    std::unique_lock<std::mutex> lock(cache.mutex);
+    // Sequential reads keep doubling how far ahead gets fetched, and seeking elsewhere starts over.
+    if (first == (cache.lastBlock + 1)) {
+        cache.readAhead = std::min(cache.readAhead * 2, c_maxReadAhead);
+    } else if (first != cache.lastBlock) {
+        cache.readAhead = c_minReadAhead;
+    }
+    cache.lastBlock = last;
+    const size_t count = cache.blockCount();
+    for (size_t i = first; i <= last; i++) {
+        if (cache.states[i] == Cache::State::OnDisk) {
+            cache.states[i] = cache.load(i) ? Cache::State::Ready : Cache::State::Missing;
+        }
+    }
+    cache.fetch(first, last);
+    // Topping up the read-ahead only once half of it got consumed makes for fewer, larger requests.
+    if ((last + 1) < count) {
+        const size_t horizon = std::min(last + cache.readAhead / 2, count - 1);
+        if (cache.needsFetching(horizon)) cache.fetch(last + 1, std::min(last + cache.readAhead, count - 1));
+    }
+    cache.cv.wait(lock, [&]() {
+        for (size_t i = first; i <= last; i++) {
+            if (cache.states[i] == Cache::State::Pending) return false;
+        }
+        return true;
+    });
+
+    uint8_t *out = reinterpret_cast<uint8_t *>(dest);
+    size_t position = ptr;
+    for (size_t i = first; i <= last; i++) {
+        if (cache.states[i] != Cache::State::Ready) return -1;
+        const size_t offset = position % c_blockSize;
+        const size_t amount = std::min(cache.blockBytes(i) - offset, ptr + size - position);
+        memcpy(out, cache.blocks[i].get() + offset, amount);
+        out += amount;
+        position += amount;
+    }
+    return size;
+}
+
 PCSX::UvFifo::UvFifo(uv_tcp_t *tcp) : File(File::FileType::RW_STREAM) {
     tcp->data = this;
     m_tcp = tcp;
@@ -820,6 +1301,8 @@ PCSX::UvFifo::UvFifo(const std::string_view address, unsigned port) : File(File:
 void PCSX::UvFifo::startRead(uv_tcp_t *tcp) {
     tcp->data = this;
     m_tcp = tcp;
+    // These carry interactive protocols, where waiting on Nagle to coalesce small writes only adds latency.
+    uv_tcp_nodelay(m_tcp, 1);
     uv_read_start(
         reinterpret_cast<uv_stream_t *>(m_tcp),
         [](uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
@@ -925,6 +1408,29 @@ void PCSX::UvFifo::write(Slice &&slice) {
     });
 }
 
+void PCSX::UvFifo::write(SliceChain &&slices) {
+    struct Info {
+        std::vector<uv_buf_t> bufs;
+        uv_write_t req;
+        SliceChain slices;
+    };
+    if (slices.empty()) return;
+    auto info = new Info();
+    info->req.data = info;
+    info->slices = std::move(slices);
+    request([info, tcp = m_tcp](auto loop) {
+        info->bufs.reserve(info->slices.count());
+        info->slices.forEach([info](const void *ptr, size_t size) {
+            info->bufs.push_back(uv_buf_init(reinterpret_cast<char *>(const_cast<void *>(ptr)), size));
+        });
+        uv_write(&info->req, reinterpret_cast<uv_stream_t *>(tcp), info->bufs.data(), info->bufs.size(),
+                 [](uv_write_t *req, int status) {
+                     auto info = reinterpret_cast<Info *>(req->data);
+                     delete info;
+                 });
+    });
+}
+
 void PCSX::UvFifoListener::start(unsigned port, uv_loop_t *loop, uv_async_t *async,
                                  std::function<void(UvFifo *)> &&cb) {
     m_cb = std::move(cb);
@@ -31,6 +31,7 @@ SOFTWARE.
 #include <atomic>
 #include <functional>
 #include <future>
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -125,6 +126,7 @@ class UvThreadOp : public UvThreadOpListType::Node {
     static std::atomic<size_t> s_dataReadLastTick;
     static std::atomic<size_t> s_dataWrittenLastTick;
     static std::atomic<size_t> s_dataDownloadLastTick;
+    static std::atomic<size_t> s_dataReadDirectly;
     static constexpr uint64_t c_tick = 500;
 
     static UvThreadOpListType s_allOps;
@@ -148,6 +150,7 @@ class UvFile : public File, public UvThreadOp {
     virtual ssize_t readAt(void* dest, size_t size, size_t ptr) final override;
     virtual ssize_t writeAt(const void* src, size_t size, size_t ptr) final override;
     virtual void writeAt(Slice&& slice, size_t ptr) final override;
+    virtual void prefetch(size_t ptr, size_t size) final override;
     virtual bool failed() final override { return m_failed; }
     virtual bool eof() final override;
     virtual std::filesystem::path filename() final override { return m_filename; }
@@ -194,6 +197,10 @@ class UvFile : public File, public UvThreadOp {
     virtual void closeInternal() final override;
     virtual bool canCache() const override { return true; }
     void openwrapper(const char* filename, int flags);
+    // Read-only files don't have writes queued on the UV thread to keep ordered with, so they can get
+    // read straight from the calling thread, saving a round trip to the UV thread for each read.
+    bool canReadDirectly() { return (m_handle >= 0) && !writable(); }
+    ssize_t readDirectly(void* dest, size_t size, size_t ptr);
     void readCacheChunk(uv_loop_t* loop);
     void readCacheChunkResult();
     virtual void downloadDone(CURLMsg* message) override;
@@ -227,6 +234,56 @@ class UvFile : public File, public UvThreadOp {
     PendingCloseInfo* m_pendingCloseInfo = nullptr;
 };
 
+// Reads a URL on demand using HTTP range requests, instead of downloading all of it first. The blocks that
+// got fetched are kept in a sparse cache, shared with the duplicates of the file, and sequential reads
+// fetch gradually more blocks ahead. Servers which don't support ranges get the whole file streamed in,
+// and the reads only wait for the blocks they need.
+class UvHttpFile : public File, public UvThreadOp {
+  public:
+    UvHttpFile(const std::string_view& url);
+    virtual ssize_t rSeek(ssize_t pos, int wheel) final override;
+    virtual ssize_t rTell() final override { return m_ptrR; }
+    virtual size_t size() final override { return m_size; }
+    virtual ssize_t read(void* dest, size_t size) final override;
+    virtual ssize_t readAt(void* dest, size_t size, size_t ptr) final override;
+    virtual void prefetch(size_t ptr, size_t size) final override;
+    virtual bool failed() final override { return m_failed; }
+    virtual bool eof() final override { return m_ptrR == m_size; }
+    virtual std::filesystem::path filename() final override { return m_filename; }
+    virtual File* dup() final override;
+
+    static bool isUrl(std::string_view path) { return path.starts_with("http://") || path.starts_with("https://"); }
+    // Keeps the fetched blocks of the URLs in this directory, so that reopening them doesn't fetch them again.
+    // The entries are keyed by the URL and its ETag or Last-Modified header, and the servers giving neither
+    // don't get cached. The least recently opened entries get evicted when opening a URL, so that the
+    // directory stays within the size limit. Several processes can share the same directory. An empty path
+    // disables the cache.
+    static void setCacheDirectory(const std::filesystem::path& directory, uint64_t maxSize) {
+        s_cacheDirectory = directory;
+        s_cacheMaxSize = maxSize;
+    }
+
+    static constexpr size_t c_blockSize = 64 * 1024;
+    static constexpr size_t c_minReadAhead = 4;
+    static constexpr size_t c_maxReadAhead = 64;
+
+  private:
+    struct Cache;
+    class Request;
+    UvHttpFile(std::shared_ptr<Cache> cache, const std::filesystem::path& filename);
+    virtual bool canCache() const override { return false; }
+    static void trimCache(const std::filesystem::path& keep);
+
+    static std::filesystem::path s_cacheDirectory;
+    static uint64_t s_cacheMaxSize;
+
+    std::shared_ptr<Cache> m_blocks;
+    const std::filesystem::path m_filename;
+    bool m_failed = true;
+    size_t m_ptrR = 0;
+    size_t m_size = 0;
+};
+
 class UvFifo : public File, public UvThreadOp {
   public:
     UvFifo(const std::string_view address, unsigned port);
@@ -234,6 +291,8 @@ class UvFifo : public File, public UvThreadOp {
     virtual ssize_t read(void* dest, size_t size) final override;
     virtual ssize_t write(const void* src, size_t size) final override;
     virtual void write(Slice&& slice) final override;
+    // Sends all of the slices with a single scatter/gather write, without gluing them together first.
+    void write(SliceChain&& slices);
     virtual size_t size() final override { return m_size.load(); }
     virtual bool eof() final override { return m_closed.load() && (m_size.load() == 0); }
     virtual bool failed() final override { return m_failed.test(); }
@@ -44,13 +44,15 @@ bool PCSX::Update::applyUpdate(const std::filesystem::path& binDir) {
 
     std::filesystem::path filename;
 
-    zip.listAllFiles([&zip, &filename, &tmp](std::string_view name) {
-        IO<File> out(new UvFile(tmp / name, FileOps::TRUNCATE));
-        IO<File> in(zip.openFile(std::string(name)));
-        Slice data = in->read(in->size());
-        out->write(std::move(data));
+    std::vector<std::string> names;
+    zip.listAllFiles([&names](std::string_view name) { names.emplace_back(name); });
+    auto contents = zip.readFiles(names);
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!contents[i]) return false;
+        IO<File> out(new UvFile(tmp / names[i], FileOps::TRUNCATE));
+        out->write(std::move(*contents[i]));
         filename = out->filename();
-    });
+    }
 
     std::filesystem::permissions(filename,
                                  std::filesystem::perms::owner_all | std::filesystem::perms::group_exec |
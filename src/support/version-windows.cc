@@ -73,12 +73,19 @@ bool PCSX::Update::applyUpdate(const std::filesystem::path& binDir) {
 
     script->writeString("$failed = $False\n");
 
+    std::vector<std::string> names;
+    zip.listAllFiles([&names](std::string_view name) { names.emplace_back(name); });
+    auto contents = zip.readFiles(names);
+    for (auto& data : contents) {
+        if (!data) return false;
+    }
+
     unsigned count = 0;
-    zip.listAllFiles([&zip, &script, &tmp, &binDir, &count](std::string_view name) {
+    for (size_t index = 0; index < names.size(); index++) {
+        const std::string& name = names[index];
         auto filename = tmp / ("pcsx-update-file-" + std::to_string(count++) + ".tmp");
         IO<File> out(new UvFile(filename, FileOps::TRUNCATE));
-        IO<File> in(zip.openFile(std::string(name)));
-        Slice data = in->read(in->size());
+        Slice data = std::move(*contents[index]);
         uint8_t digest[16];
         MD5 md5;
         md5.update(data);
@@ -98,7 +105,7 @@ bool PCSX::Update::applyUpdate(const std::filesystem::path& binDir) {
         script->writeString("\"\n");
         script->writeString("    $failed = $True\n");
         script->writeString("}\n");
-    });
+    }
 
     script->writeString("if ($failed) {\n");
     script->writeString("    Write-Host \"Corruption detected, cancelling update.\"\n");
@@ -0,0 +1,110 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <string_view>
+
+namespace PCSX {
+
+// The difference between two buffers of the same size, as the runs of bytes which differ, XORed together.
+// A delta is a sequence of records, each of them being how many bytes are the same, then how many differ,
+// both as varints, followed by the differing bytes. Since XOR is its own inverse, the same delta turns
+// the base into the data, and the data back into the base.
+namespace XorDelta {
+
+// Identical gaps shorter than this are folded in the differing run around them, as a new record costs more.
+static constexpr size_t MIN_GAP = 4;
+
+static inline void putVarInt(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+static inline bool getVarInt(std::string_view& in, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (in.empty()) return false;
+        const uint8_t b = in[0];
+        in.remove_prefix(1);
+        value |= uint64_t(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Appends the delta from base to data to out. Identical buffers give an empty delta.
+static inline void encode(const uint8_t* base, const uint8_t* data, size_t size, std::string& out) {
+    size_t pos = 0;
+    while (pos < size) {
+        const size_t start = pos;
+        while ((pos + 8 <= size) && (memcmp(base + pos, data + pos, 8) == 0)) pos += 8;
+        while ((pos < size) && (base[pos] == data[pos])) pos++;
+        if (pos == size) return;
+
+        size_t end = pos + 1;
+        while (end < size) {
+            if (base[end] != data[end]) {
+                end++;
+                continue;
+            }
+            size_t gap = end;
+            while ((gap < size) && (base[gap] == data[gap]) && (gap - end < MIN_GAP)) gap++;
+            if ((gap == size) || (gap - end >= MIN_GAP)) break;
+            end = gap;
+        }
+
+        putVarInt(out, pos - start);
+        putVarInt(out, end - pos);
+        for (size_t i = pos; i < end; i++) out.push_back(char(base[i] ^ data[i]));
+        pos = end;
+    }
+}
+
+// Applies the delta to the buffer, in place. Returns false if the delta doesn't fit the buffer.
+static inline bool apply(std::string_view delta, uint8_t* data, size_t size) {
+    size_t pos = 0;
+    while (!delta.empty()) {
+        uint64_t skip, length;
+        if (!getVarInt(delta, skip) || !getVarInt(delta, length)) return false;
+        if ((skip > size - pos) || (length > size - pos - skip) || (length > delta.size())) return false;
+        pos += skip;
+        for (size_t i = 0; i < length; i++) data[pos++] ^= uint8_t(delta[i]);
+        delta.remove_prefix(length);
+    }
+    return true;
+}
+
+}  // namespace XorDelta
+
+}  // namespace PCSX
@@ -26,6 +26,11 @@ SOFTWARE.
 
 #include "support/zfile.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
 ssize_t PCSX::ZReader::rSeek(ssize_t pos, int wheel) {
     switch (wheel) {
         case SEEK_SET:
@@ -53,19 +58,20 @@ ssize_t PCSX::ZReader::read(void *dest_, size_t size) {
         m_filePtr = 0;
         m_hitEOF = false;
         inflateEnd(&m_zstream);
-        m_zstream.avail_in = sizeof(m_inBuffer);
-        m_zstream.next_in = m_inBuffer;
-        inflateInit2(&m_zstream, m_raw ? -MAX_WBITS : MAX_WBITS);
+        // Whatever is left in the input buffer belongs to the old position in the stream.
+        m_zstream.avail_in = 0;
+        inflateInit2(&m_zstream, m_raw ? -MAX_WBITS : MAX_WBITS + 32);
     }
     if (m_hitEOF) return -1;
+    if (!m_inBuffer) m_inBuffer.reset(new uint8_t[m_bufferSize]);
     auto decompSome = [this](void *dest, ssize_t size) -> ssize_t {
         m_zstream.avail_out = size;
         m_zstream.next_out = reinterpret_cast<decltype(m_zstream.next_out)>(dest);
         if (!m_zstream.avail_in) {
-            ssize_t block = m_file->readAt(m_inBuffer, sizeof(m_inBuffer), m_zstream.total_in);
+            ssize_t block = m_file->readAt(m_inBuffer.get(), m_bufferSize, m_zstream.total_in);
             if (block < 0) return block;
             m_zstream.avail_in = block;
-            m_zstream.next_in = m_inBuffer;
+            m_zstream.next_in = m_inBuffer.get();
         }
         auto res = inflate(&m_zstream, Z_FINISH);
         if ((res < 0) && (res != Z_BUF_ERROR)) {
@@ -78,7 +84,7 @@ ssize_t PCSX::ZReader::read(void *dest_, size_t size) {
     };
     ssize_t ret = 0;
     while (dumpDelta) {
-        uint8_t dummy[256];
+        uint8_t dummy[16384];
         ssize_t toDump = std::min(ssize_t(sizeof(dummy)), dumpDelta);
         ssize_t p = decompSome(dummy, toDump);
         if (p < 0) return p;
@@ -98,33 +104,120 @@ ssize_t PCSX::ZReader::read(void *dest_, size_t size) {
     return ret;
 }
 
-ssize_t PCSX::ZWriter::write(const void *dest, size_t size) {
+bool PCSX::ZReader::uncompress(std::string_view in, std::string &out) {
+    z_stream z = {};
+    if (inflateInit2(&z, MAX_WBITS + 32) != Z_OK) return false;
+    z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.data()));
+    z.avail_in = in.size();
+    // A gzip stream ends with its uncompressed size modulo 4GB, which is a good first guess.
+    size_t guess = in.size() * 4;
+    if ((in.size() >= 18) && (uint8_t(in[0]) == 0x1f) && (uint8_t(in[1]) == 0x8b)) {
+        const uint8_t *isize = reinterpret_cast<const uint8_t *>(in.data() + in.size() - 4);
+        guess = isize[0] | (isize[1] << 8) | (isize[2] << 16) | (uint32_t(isize[3]) << 24);
+        // Deflate can't do better than about 1:1032, so a corrupted trailer shouldn't blow up memory.
+        guess = std::min(guess, in.size() * 1032);
+    }
+    out.clear();
+    out.resize(std::max(guess, size_t(1024)));
+    int res = Z_OK;
+    while (res != Z_STREAM_END) {
+        if (z.total_out == out.size()) out.resize(out.size() * 2);
+        z.next_out = reinterpret_cast<Bytef *>(out.data() + z.total_out);
+        z.avail_out = out.size() - z.total_out;
+        res = inflate(&z, Z_FINISH);
+        if ((res != Z_STREAM_END) && (((res != Z_OK) && (res != Z_BUF_ERROR)) || z.avail_out)) break;
+    }
+    out.resize(z.total_out);
+    inflateEnd(&z);
+    return res == Z_STREAM_END;
+}
+
+void PCSX::ZWriter::deflateSome(const uint8_t *data, size_t size, int flush) {
     m_zstream.avail_in = size;
-    m_zstream.next_in = static_cast<Bytef *>(const_cast<void *>(dest));
-
-    while (m_zstream.avail_in) {
-        void *data = malloc(c_chunkSize);
-        m_zstream.avail_out = c_chunkSize;
-        m_zstream.next_out = static_cast<Bytef *>(data);
-        deflate(&m_zstream, Z_NO_FLUSH);
-        Slice out;
-        out.acquire(data, c_chunkSize - m_zstream.avail_out);
-        m_file->write(std::move(out));
+    m_zstream.next_in = const_cast<Bytef *>(data);
+
+    // The output goes into full sized chunks, which get handed over to the file without a copy.
+    while (true) {
+        if (!m_chunk) {
+            m_chunk = static_cast<uint8_t *>(malloc(m_chunkSize));
+            m_zstream.avail_out = m_chunkSize;
+            m_zstream.next_out = m_chunk;
+        }
+        int r = deflate(&m_zstream, flush);
+        bool done = flush == Z_FINISH ? r == Z_STREAM_END : !m_zstream.avail_in && m_zstream.avail_out;
+        if (!m_zstream.avail_out || (done && (flush == Z_FINISH))) {
+            Slice out;
+            out.acquire(m_chunk, m_chunkSize - m_zstream.avail_out);
+            m_chunk = nullptr;
+            m_file->write(std::move(out));
+        }
+        if (done) break;
     }
+}
+
+void PCSX::ZWriter::flushBatch() {
+    if (!m_batchSize) return;
+    deflateSome(m_batch, m_batchSize, Z_NO_FLUSH);
+    m_batchSize = 0;
+}
 
+ssize_t PCSX::ZWriter::write(const void *dest, size_t size) {
+    // Lots of tiny writes are much cheaper to copy together than to push through deflate one by one.
+    if (size < c_batchSize) {
+        if (m_batchSize + size > c_batchSize) flushBatch();
+        memcpy(m_batch + m_batchSize, dest, size);
+        m_batchSize += size;
+        return size;
+    }
+    flushBatch();
+    deflateSome(static_cast<const uint8_t *>(dest), size, Z_NO_FLUSH);
     return size;
 }
 
 void PCSX::ZWriter::closeInternal() {
+    flushBatch();
+    deflateSome(nullptr, 0, Z_FINISH);
+    deflateEnd(&m_zstream);
+}
+
+PCSX::Slice PCSX::ZWriter::compress(std::string_view in, int level) {
+    z_stream z = {};
+    if (deflateInit2(&z, level, Z_DEFLATED, MAX_WBITS + 16, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("deflateInit2 didn't work");
+    }
+    // The bound is large enough for deflate to finish in a single call.
+    const size_t bound = deflateBound(&z, in.size());
+    uint8_t *data = static_cast<uint8_t *>(malloc(bound));
+    z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.data()));
+    z.avail_in = in.size();
+    z.next_out = data;
+    z.avail_out = bound;
+    deflate(&z, Z_FINISH);
+    Slice out;
+    out.acquire(data, z.total_out);
+    deflateEnd(&z);
+    return out;
+}
+
+size_t PCSX::ZCompressor::compress(const void *data, size_t size, IO<File> out) {
+    deflateReset(&m_zstream);
+    m_zstream.next_in = reinterpret_cast<Bytef *>(const_cast<void *>(data));
+    m_zstream.avail_in = size;
+    // Small inputs get a single chunk sized for the worst case, so that they go through in one pass.
+    const size_t chunkSize = std::min<size_t>(m_chunkSize, deflateBound(&m_zstream, size));
     int r = Z_OK;
     while (r != Z_STREAM_END) {
-        void *data = malloc(c_chunkSize);
-        m_zstream.avail_out = c_chunkSize;
-        m_zstream.next_out = static_cast<Bytef *>(data);
+        uint8_t *chunk = static_cast<uint8_t *>(malloc(chunkSize));
+        m_zstream.next_out = chunk;
+        m_zstream.avail_out = chunkSize;
         r = deflate(&m_zstream, Z_FINISH);
-        Slice out;
-        out.acquire(data, c_chunkSize - m_zstream.avail_out);
-        m_file->write(std::move(out));
+        if (r == Z_STREAM_ERROR) {
+            free(chunk);
+            throw std::runtime_error("deflate didn't work");
+        }
+        Slice slice;
+        slice.acquire(chunk, chunkSize - m_zstream.avail_out);
+        out->write(std::move(slice));
     }
-    deflateEnd(&m_zstream);
+    return m_zstream.total_out;
 }
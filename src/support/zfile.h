@@ -28,7 +28,12 @@ SOFTWARE.
 
 #include <zlib.h>
 
+#include <memory>
+#include <string>
+#include <string_view>
+
 #include "support/file.h"
+#include "support/slice.h"
 
 namespace PCSX {
 
@@ -49,8 +54,18 @@ class ZReader : public File {
     virtual bool eof() final override { return m_hitEOF; }
     virtual File* dup() final override { return new ZReader(INTERNAL, m_file, m_size, m_raw); };
     virtual bool failed() final override { return m_file->failed(); }
+    // How much compressed data gets read from the underlying file at once. Only takes
+    // effect before the first read.
+    void setBufferSize(size_t size) {
+        if (!m_inBuffer) m_bufferSize = size;
+    }
+
+    // Inflates a whole gzip or zlib stream at once, for when the compressed data is already
+    // in memory and nothing needs to be streamed. Returns false if the stream is corrupted.
+    static bool uncompress(std::string_view in, std::string& out);
 
   private:
+    static constexpr size_t c_defaultBufferSize = 65536;
     virtual void closeInternal() final override { inflateEnd(&m_zstream); }
     enum Internal { INTERNAL };
     ZReader(Internal, IO<File> file, ssize_t size, bool raw)
@@ -75,37 +90,99 @@ class ZReader : public File {
     ssize_t m_size = 0;
     bool m_hitEOF = false;
     bool m_raw = false;
-    uint8_t m_inBuffer[1024];
+    size_t m_bufferSize = c_defaultBufferSize;
+    std::unique_ptr<uint8_t[]> m_inBuffer;
 };
 
 class ZWriter : public File {
   public:
     enum Raw { RAW };
     enum GZip { GZIP };
-    ZWriter(IO<File> file) : ZWriter(INTERNAL, file, false, false) {}
-    ZWriter(IO<File> file, Raw) : ZWriter(INTERNAL, file, true, false) {}
-    ZWriter(IO<File> file, GZip) : ZWriter(INTERNAL, file, false, true) {}
+    ZWriter(IO<File> file) : ZWriter(INTERNAL, file, false, false, Options()) {}
+    ZWriter(IO<File> file, Raw) : ZWriter(INTERNAL, file, true, false, Options()) {}
+    ZWriter(IO<File> file, GZip) : ZWriter(INTERNAL, file, false, true, Options()) {}
+    // The level goes from Z_BEST_SPEED to Z_BEST_COMPRESSION.
+    ZWriter(IO<File> file, GZip, int level) : ZWriter(INTERNAL, file, false, true, Options{.level = level}) {}
+    struct Options {
+        int level = Z_DEFAULT_COMPRESSION;
+        // Between 9 and MAX_WBITS; smaller windows use less memory, at the expense of the ratio.
+        int windowBits = MAX_WBITS;
+        int memLevel = MAX_MEM_LEVEL;
+        // The compressed data goes out to the underlying file in slices of this size.
+        size_t chunkSize = 256 * 1024;
+    };
+    ZWriter(IO<File> file, const Options& options) : ZWriter(INTERNAL, file, false, false, options) {}
+    ZWriter(IO<File> file, Raw, const Options& options) : ZWriter(INTERNAL, file, true, false, options) {}
+    ZWriter(IO<File> file, GZip, const Options& options) : ZWriter(INTERNAL, file, false, true, options) {}
     virtual ssize_t write(const void* dest, size_t size) final override;
     virtual bool failed() final override { return m_file->failed(); }
 
+    // Deflates a whole buffer at once into a gzip stream, for when nothing needs to be streamed.
+    static Slice compress(std::string_view in, int level = Z_DEFAULT_COMPRESSION);
+
   private:
     virtual void closeInternal() final override;
-    static constexpr size_t c_chunkSize = 65536;
+    // Writes smaller than this get gathered before going through deflate.
+    static constexpr size_t c_batchSize = 4096;
     enum Internal { INTERNAL };
-    ZWriter(Internal, IO<File> file, bool raw, bool gzip) : File(RW_STREAM), m_file(file) {
+    ZWriter(Internal, IO<File> file, bool raw, bool gzip, const Options& options)
+        : File(RW_STREAM), m_file(file), m_chunkSize(options.chunkSize) {
         auto z = &m_zstream;
         z->zalloc = Z_NULL;
         z->zfree = Z_NULL;
         z->opaque = Z_NULL;
         z->avail_in = 0;
-        int wbits = MAX_WBITS;
+        int wbits = options.windowBits;
         if (raw) wbits = -wbits;
         if (gzip) wbits += 16;
-        auto res = deflateInit2(z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, wbits, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+        auto res = deflateInit2(z, options.level, Z_DEFLATED, wbits, options.memLevel, Z_DEFAULT_STRATEGY);
         if (res != Z_OK) throw std::runtime_error("deflateInit2 didn't work");
     }
+    void deflateSome(const uint8_t* data, size_t size, int flush);
+    void flushBatch();
     IO<File> m_file;
     z_stream m_zstream;
+    size_t m_chunkSize;
+    uint8_t* m_chunk = nullptr;
+    uint8_t m_batch[c_batchSize];
+    size_t m_batchSize = 0;
+};
+
+// A deflate context which can be reused for any number of independent streams. Setting up
+// zlib's internal state costs a few hundred kilobytes of allocations every time, which adds
+// up when compressing something small and often, such as a capture every frame.
+class ZCompressor {
+  public:
+    using Options = ZWriter::Options;
+    enum Raw { RAW };
+    enum GZip { GZIP };
+    ZCompressor() : ZCompressor(false, false, Options()) {}
+    ZCompressor(const Options& options) : ZCompressor(false, false, options) {}
+    ZCompressor(Raw, const Options& options) : ZCompressor(true, false, options) {}
+    ZCompressor(GZip, const Options& options) : ZCompressor(false, true, options) {}
+    ~ZCompressor() { deflateEnd(&m_zstream); }
+    ZCompressor(const ZCompressor&) = delete;
+    ZCompressor& operator=(const ZCompressor&) = delete;
+
+    // Compresses the input into a complete stream, written to the output file,
+    // and returns the number of compressed bytes.
+    size_t compress(const void* data, size_t size, IO<File> out);
+
+  private:
+    ZCompressor(bool raw, bool gzip, const Options& options) : m_chunkSize(options.chunkSize) {
+        auto z = &m_zstream;
+        z->zalloc = Z_NULL;
+        z->zfree = Z_NULL;
+        z->opaque = Z_NULL;
+        z->avail_in = 0;
+        int wbits = options.windowBits;
+        if (raw) wbits = -wbits;
+        if (gzip) wbits += 16;
+        auto res = deflateInit2(z, options.level, Z_DEFLATED, wbits, options.memLevel, Z_DEFAULT_STRATEGY);
+        if (res != Z_OK) throw std::runtime_error("deflateInit2 didn't work");
+    }
+    z_stream m_zstream;
+    size_t m_chunkSize;
 };
 
 }  // namespace PCSX
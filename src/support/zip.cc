@@ -26,6 +26,10 @@ SOFTWARE.
 
 #include "support/zip.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "support/binstruct.h"
 #include "support/typestring-wrapper.h"
 #include "support/zfile.h"
@@ -58,7 +62,111 @@ typedef PCSX::BinStruct::Struct<TYPESTRING("CentralDirectoryFileHeader"), Signat
                                 InternalFileAttributes, ExternalFileAttributes, RelativeOffsetOfLocalHeader>
     CentralDirectoryFileHeader;
 
+typedef PCSX::BinStruct::Field<PCSX::BinStruct::UInt16, TYPESTRING("DiskNumber")> DiskNumber;
+typedef PCSX::BinStruct::Field<PCSX::BinStruct::UInt16, TYPESTRING("CentralDirectoryDisk")> CentralDirectoryDisk;
+typedef PCSX::BinStruct::Field<PCSX::BinStruct::UInt16, TYPESTRING("DiskEntries")> DiskEntries;
+typedef PCSX::BinStruct::Field<PCSX::BinStruct::UInt16, TYPESTRING("TotalEntries")> TotalEntries;
+typedef PCSX::BinStruct::Field<PCSX::BinStruct::UInt32, TYPESTRING("CentralDirectorySize")> CentralDirectorySize;
+typedef PCSX::BinStruct::Field<PCSX::BinStruct::UInt32, TYPESTRING("CentralDirectoryOffset")> CentralDirectoryOffset;
+typedef PCSX::BinStruct::Struct<TYPESTRING("EndOfCentralDirectory"), Signature, DiskNumber, CentralDirectoryDisk,
+                                DiskEntries, TotalEntries, CentralDirectorySize, CentralDirectoryOffset, CommentLength>
+    EndOfCentralDirectory;
+
+namespace {
+
+bool inflateRaw(const PCSX::Slice& in, void* out, uint32_t size) {
+    z_stream z = {};
+    if (inflateInit2(&z, -MAX_WBITS) != Z_OK) return false;
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<void*>(in.data()));
+    z.avail_in = in.size();
+    z.next_out = reinterpret_cast<Bytef*>(out);
+    z.avail_out = size;
+    int result = inflate(&z, Z_FINISH);
+    inflateEnd(&z);
+    return (result == Z_STREAM_END) && (z.total_out == size);
+}
+
+}  // namespace
+
 PCSX::ZipArchive::ZipArchive(IO<File> file) : m_file(file) {
+    if (!readCentralDirectory()) scanLocalHeaders();
+}
+
+bool PCSX::ZipArchive::addFile(CompressedFile&& fileInfo, uint16_t method) {
+    if ((fileInfo.size == 0xffffffff) && (fileInfo.compressedSize == 0xffffffff)) {
+        m_failed = true;
+        return false;
+    }
+    if ((method != 0) && (method != 8)) {
+        m_failed = true;
+        return false;
+    }
+    fileInfo.compressed = method == 8;
+    // Like the linear search this replaced, the first entry of a given name wins.
+    m_index.try_emplace(fileInfo.name, m_files.size());
+    m_files.push_back(std::move(fileInfo));
+    return true;
+}
+
+// The central directory at the end of the archive has everything needed to index it without going through the
+// whole file, and it also has the sizes of the entries which got streamed in with a data descriptor.
+bool PCSX::ZipArchive::readCentralDirectory() {
+    const size_t size = m_file->size();
+    if (size < 22) return false;
+    // The end of central directory record is followed by a comment of up to 64kB, so it has to be searched for.
+    const size_t tailSize = std::min<size_t>(size, 65535 + 22);
+    Slice tail = m_file->readAt(tailSize, size - tailSize);
+    if (tail.size() != tailSize) return false;
+    const uint8_t* data = tail.data<uint8_t>();
+    ssize_t position = -1;
+    for (ssize_t i = tailSize - 22; i >= 0; i--) {
+        if ((data[i] == 0x50) && (data[i + 1] == 0x4b) && (data[i + 2] == 0x05) && (data[i + 3] == 0x06)) {
+            position = i;
+            break;
+        }
+    }
+    if (position < 0) return false;
+
+    EndOfCentralDirectory end;
+    end.deserialize(new BufferFile(const_cast<uint8_t*>(data + position), tailSize - position));
+    const uint32_t directorySize = end.get<CentralDirectorySize>();
+    const uint32_t directoryOffset = end.get<CentralDirectoryOffset>();
+    if ((directoryOffset == 0xffffffff) || ((uint64_t(directoryOffset) + directorySize) > size)) return false;
+
+    Slice directoryData = m_file->readAt(directorySize, directoryOffset);
+    if (directoryData.size() != directorySize) return false;
+    IO<File> directory(new BufferFile(const_cast<void*>(directoryData.data()), directoryData.size()));
+    for (unsigned i = 0; i < end.get<TotalEntries>(); i++) {
+        CentralDirectoryFileHeader header;
+        header.deserialize(directory);
+        if (header.get<Signature>() != 0x02014b50) {
+            m_files.clear();
+            m_index.clear();
+            return false;
+        }
+        CompressedFile fileInfo;
+        fileInfo.name = directory->readString(header.get<FilenameLength>());
+        directory->skip(header.get<ExtraFieldLength>() + header.get<CommentLength>());
+        fileInfo.size = header.get<UncompressedSize>();
+        fileInfo.compressedSize = header.get<CompressedSize>();
+        // The local header's name and extra field don't have to match the central directory's, so the data
+        // offset has to come from the local header itself.
+        const uint32_t localOffset = header.get<RelativeOffsetOfLocalHeader>();
+        if (m_file->readAt<uint32_t>(localOffset) != 0x04034b50) {
+            m_files.clear();
+            m_index.clear();
+            return false;
+        }
+        const uint16_t nameLength = m_file->readAt<uint16_t>(localOffset + 26);
+        const uint16_t extraLength = m_file->readAt<uint16_t>(localOffset + 28);
+        fileInfo.offset = localOffset + 30 + nameLength + extraLength;
+        if (!addFile(std::move(fileInfo), header.get<CompressionMethod>())) return true;
+    }
+    return true;
+}
+
+void PCSX::ZipArchive::scanLocalHeaders() {
+    IO<File> file = m_file;
     file->rSeek(0);
     while (!file->eof()) {
         uint32_t signature = file->peek<uint32_t>();
@@ -78,17 +186,7 @@ PCSX::ZipArchive::ZipArchive(IO<File> file) : m_file(file) {
                 file->skip(header.get<CompressedSize>());
                 fileInfo.size = header.get<UncompressedSize>();
                 fileInfo.compressedSize = header.get<CompressedSize>();
-                if ((fileInfo.size == 0xffffffff) && (fileInfo.compressedSize == 0xffffffff)) {
-                    m_failed = true;
-                    return;
-                }
-                auto method = header.get<CompressionMethod>();
-                if ((method != 0) && (method != 8)) {
-                    m_failed = true;
-                    return;
-                }
-                fileInfo.compressed = method == 8;
-                m_files.push_back(fileInfo);
+                if (!addFile(std::move(fileInfo), header.get<CompressionMethod>())) return;
                 break;
             }
             case 0x02014b50: {
@@ -126,23 +224,71 @@ void PCSX::ZipArchive::listDirectories(std::function<bool(std::string_view)> wal
     }
 }
 
-PCSX::File* PCSX::ZipArchive::openFile(std::string path) {
+const PCSX::ZipArchive::CompressedFile* PCSX::ZipArchive::findFile(std::string path) const {
     for (auto& c : path) {
         if (c == '\\') c = '/';
     }
-    File* ret = nullptr;
-    for (auto& file : m_files) {
-        if (file.name == path) {
-            SubFile* sub = new SubFile(m_file, file.offset, file.compressedSize);
-            if (file.compressed) {
-                ret = new ZReader(sub, file.size, ZReader::RAW);
-            } else {
-                ret = sub;
-            }
-            break;
+    auto i = m_index.find(path);
+    if (i == m_index.end()) return nullptr;
+    return &m_files[i->second];
+}
+
+PCSX::File* PCSX::ZipArchive::openFile(std::string path) {
+    auto file = findFile(std::move(path));
+    if (!file) return new FailedFile();
+    if (!file->compressed) return new SubFile(m_file, file->offset, file->compressedSize);
+    if (file->size > c_inflateInMemory) {
+        return new ZReader(new SubFile(m_file, file->offset, file->compressedSize), file->size, ZReader::RAW);
+    }
+
+    Slice compressed = m_file->readAt(file->compressedSize, file->offset);
+    void* data = malloc(std::max(file->size, uint32_t(1)));
+    if ((compressed.size() != file->compressedSize) || !inflateRaw(compressed, data, file->size)) {
+        free(data);
+        return new FailedFile();
+    }
+    return new BufferFile(data, file->size, BufferFile::ACQUIRE);
+}
+
+std::vector<std::optional<PCSX::Slice>> PCSX::ZipArchive::readFiles(const std::vector<std::string>& paths) {
+    std::vector<std::optional<Slice>> ret(paths.size());
+    struct Job {
+        size_t index;
+        uint32_t size;
+        Slice compressed;
+    };
+    std::vector<Job> jobs;
+    for (size_t i = 0; i < paths.size(); i++) {
+        auto file = findFile(paths[i]);
+        if (!file) continue;
+        Slice data = m_file->readAt(file->compressedSize, file->offset);
+        if (data.size() != file->compressedSize) continue;
+        if (file->compressed) {
+            jobs.push_back({i, file->size, std::move(data)});
+        } else {
+            ret[i] = std::move(data);
         }
     }
 
-    if (!ret) ret = new FailedFile();
+    std::atomic<size_t> next = 0;
+    auto worker = [&jobs, &ret, &next]() {
+        for (size_t j = next++; j < jobs.size(); j = next++) {
+            auto& job = jobs[j];
+            void* data = malloc(std::max(job.size, uint32_t(1)));
+            if (inflateRaw(job.compressed, data, job.size)) {
+                Slice slice;
+                slice.acquire(data, job.size);
+                ret[job.index] = std::move(slice);
+            } else {
+                free(data);
+            }
+            job.compressed.reset();
+        }
+    };
+    const size_t threadCount = std::min<size_t>(jobs.size(), std::max(std::thread::hardware_concurrency(), 1u));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; i++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
     return ret;
 }
@@ -27,11 +27,14 @@ SOFTWARE.
 #pragma once
 
 #include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "support/file.h"
+#include "support/flathashmap.h"
+#include "support/slice.h"
 
 namespace PCSX {
 
@@ -53,11 +56,19 @@ class ZipArchive {
     }
     void listFiles(std::function<bool(std::string_view)> walker);
     void listDirectories(std::function<bool(std::string_view)> walker);
+    // Stored entries are read straight from the archive, and so are large deflated ones. Smaller deflated
+    // entries get inflated in one go into memory, which makes seeking around them cheap.
     File *openFile(std::string path);
+    // Reads the whole contents of several entries, inflating them in parallel. The compressed data is read
+    // from the archive on the calling thread, so the archive's file doesn't have to be thread safe.
+    std::vector<std::optional<Slice>> readFiles(const std::vector<std::string> &paths);
 
     std::filesystem::path archiveFilename() { return m_file->filename(); }
 
   private:
+    // Large deflated entries are streamed rather than inflated in memory by openFile.
+    static constexpr uint32_t c_inflateInMemory = 8 * 1024 * 1024;
+
     IO<File> m_file;
 
     struct CompressedFile {
@@ -76,7 +87,13 @@ class ZipArchive {
         bool compressed;
     };
 
+    bool readCentralDirectory();
+    void scanLocalHeaders();
+    bool addFile(CompressedFile &&file, uint16_t method);
+    const CompressedFile *findFile(std::string path) const;
+
     std::vector<CompressedFile> m_files;
+    FlatHashMap<std::string, size_t> m_index;
     bool m_failed = false;
 };
 
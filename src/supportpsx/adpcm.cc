@@ -27,8 +27,20 @@ SOFTWARE.
 #include "supportpsx/adpcm.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Below this, splitting the filter search across threads costs more than it saves.
+constexpr unsigned c_blocksPerThread = 256;
+// The batch functions work over chunks of this many blocks, to bound their memory usage.
+constexpr unsigned c_blocksPerChunk = 4096;
+
+}  // namespace
 
 void PCSX::ADPCM::Encoder::reset(Mode mode) {
     m_lastBlockSamples[0][0] = 0.0;
@@ -76,50 +88,95 @@ void PCSX::ADPCM::Encoder::convertToDoubles(std::span<const int16_t> input, std:
     }
 }
 
-void PCSX::ADPCM::Encoder::findFilterAndShift(std::span<const double> input, std::span<double> output,
-                                              uint8_t* filterPtr, uint8_t* shiftPtr, unsigned channel) {
+void PCSX::ADPCM::Encoder::findFilterAndShift(std::span<const double> input,
+                                              const std::array<double, 2>& lastBlockSamples,
+                                              BlockAnalysis& analysis) const {
+    // The prediction only uses the input samples, never the filtered ones, so once the last two samples of
+    // the previous block are laid out in front of the current one, each filtered sample can be computed
+    // independently from the others, and these loops can be vectorised by the compiler.
+    std::array<double, 30> samples;
+    samples[0] = lastBlockSamples[1];
+    samples[1] = lastBlockSamples[0];
+    std::copy(input.begin(), input.begin() + 28, samples.begin() + 2);
+
     double minMax = 1.8e+307;
     std::array<double, 5> filteredMax;
     std::array<std::array<double, 28>, 5> allFiltered;
-    std::array<double, 2> samples;
 
-    *filterPtr = 0;
+    analysis.filter = 0;
 
     for (unsigned filter = 0; filter < 5; filter++) {
-        samples[0] = m_lastBlockSamples[channel][0];
-        samples[1] = m_lastBlockSamples[channel][1];
-        filteredMax[filter] = 0.0;
-        auto inputPtr = input;
+        const double f0 = c_filters[filter][0];
+        const double f1 = c_filters[filter][1];
+        auto& filtered = allFiltered[filter];
         for (unsigned i = 0; i < 28; i++) {
-            auto next = inputPtr[i];
-            auto f = samples[0] * c_filters[filter][0] + samples[1] * c_filters[filter][1] + next;
-            allFiltered[filter][i] = f;
-            if (f <= 0.0) f = -f;
-            if (filteredMax[filter] < f) filteredMax[filter] = f;
-            samples[1] = samples[0];
-            samples[0] = next;
+            filtered[i] = samples[i + 1] * f0 + samples[i] * f1 + samples[i + 2];
         }
-        auto factorized = m_factors[filter] * filteredMax[filter];
+        double max = 0.0;
+        for (unsigned i = 0; i < 28; i++) {
+            max = std::max(max, std::abs(filtered[i]));
+        }
+        filteredMax[filter] = max;
+        auto factorized = m_factors[filter] * max;
         if (factorized < minMax) {
-            *filterPtr = filter;
+            analysis.filter = filter;
             minMax = factorized;
         }
-        if ((filter == 0) && (filteredMax[0] <= 7.0)) break;
+        if ((filter == 0) && (max <= 7.0)) break;
     }
-    m_lastBlockSamples[channel][0] = samples[0];
-    m_lastBlockSamples[channel][1] = samples[1];
-    unsigned filter = *filterPtr;
-    std::copy(allFiltered[filter].begin(), allFiltered[filter].end(), output.begin());
+    unsigned filter = analysis.filter;
+    analysis.filtered = allFiltered[filter];
     int maxI = filteredMax[filter] * m_factors[filter + 5];
     maxI = std::clamp(maxI, -32768, 32767);
     int mask = 0x4000;
-    for (*shiftPtr = 0; *shiftPtr < 12; (*shiftPtr)++) {
+    for (analysis.shift = 0; analysis.shift < 12; analysis.shift++) {
         int compare = maxI + (mask >> 3);
         if ((mask & compare) != 0) return;
         mask >>= 1;
     }
 }
 
+void PCSX::ADPCM::Encoder::analyseBlocks(const int16_t* input, unsigned subBlocks, unsigned channels,
+                                         BlockAnalysis* analyses) {
+    if (subBlocks == 0) return;
+    auto work = [=, this](unsigned begin, unsigned end) {
+        end = std::min(end, subBlocks);
+        std::array<double, 28> converted;
+        for (unsigned b = begin; b < end; b++) {
+            const int16_t* block = input + b * 28 * channels;
+            for (unsigned channel = 0; channel < channels; channel++) {
+                auto lastBlockSamples = m_lastBlockSamples[channel];
+                if (b != 0) {
+                    const int16_t* previous = block + channel - channels;
+                    lastBlockSamples[0] = previous[0];
+                    lastBlockSamples[1] = *(previous - channels);
+                }
+                convertToDoubles(std::span<const int16_t>(block + channel, 28 * channels - channel), converted,
+                                 channels);
+                findFilterAndShift(converted, lastBlockSamples, analyses[b * channels + channel]);
+            }
+        }
+    };
+    // Querying the number of cores isn't free, and processBlock comes through here for every single block.
+    unsigned threads = 1;
+    if (subBlocks >= 2 * c_blocksPerThread) {
+        threads = std::clamp(subBlocks / c_blocksPerThread, 1u, std::max(std::thread::hardware_concurrency(), 1u));
+    }
+    const unsigned perThread = (subBlocks + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++) {
+        workers.emplace_back(work, t * perThread, (t + 1) * perThread);
+    }
+    work(0, perThread);
+    for (auto& worker : workers) worker.join();
+
+    const int16_t* last = input + (subBlocks * 28 - 1) * channels;
+    for (unsigned channel = 0; channel < channels; channel++) {
+        m_lastBlockSamples[channel][0] = last[channel];
+        m_lastBlockSamples[channel][1] = (last - channels)[channel];
+    }
+}
+
 void PCSX::ADPCM::Encoder::convert(std::span<const double> input, std::span<int16_t> output, uint8_t filter,
                                    uint8_t shift, unsigned channel, XAMode xaMode) {
     double multiplier = 1 << shift;
@@ -141,20 +198,24 @@ void PCSX::ADPCM::Encoder::convert(std::span<const double> input, std::span<int1
 
 void PCSX::ADPCM::Encoder::processBlock(const int16_t* input, int16_t* output, uint8_t* filterPtr, uint8_t* shiftPtr,
                                         unsigned channels, XAMode xaMode) {
+    encodeBlock(input, nullptr, output, filterPtr, shiftPtr, channels, xaMode);
+}
+
+void PCSX::ADPCM::Encoder::encodeBlock(const int16_t* input, const BlockAnalysis* analyses, int16_t* output,
+                                       uint8_t* filterPtr, uint8_t* shiftPtr, unsigned channels, XAMode xaMode) {
     if (channels > 2) {
         throw std::invalid_argument("Channels must be 1 or 2");
     }
-    std::array<std::array<double, 28>, 2> converted;
-    std::array<std::array<double, 28>, 2> filtered;
-    auto inputSpan = std::span<const int16_t>(input, 28 * channels);
-    convertToDoubles(inputSpan, converted[0], channels);
-    if (channels == 2) {
-        convertToDoubles(inputSpan.subspan(1), converted[1], channels);
+    std::array<BlockAnalysis, 2> local;
+    if (!analyses) {
+        analyseBlocks(input, 1, channels, local.data());
+        analyses = local.data();
     }
     for (unsigned channel = 0; channel < channels; channel++) {
-        findFilterAndShift(converted[channel], filtered[channel], filterPtr + channel, shiftPtr + channel, channel);
-        convert(filtered[channel], std::span<int16_t>(output + channel * 28, 28), filterPtr[channel], shiftPtr[channel],
-                channel, xaMode);
+        filterPtr[channel] = analyses[channel].filter;
+        shiftPtr[channel] = analyses[channel].shift;
+        convert(analyses[channel].filtered, std::span<int16_t>(output + channel * 28, 28), filterPtr[channel],
+                shiftPtr[channel], channel, xaMode);
     }
 }
 
@@ -173,10 +234,30 @@ void PCSX::ADPCM::Encoder::blockTo8Bit(const int16_t* input, uint8_t* output) {
 }
 
 void PCSX::ADPCM::Encoder::processSPUBlock(const int16_t* input, uint8_t* output, BlockAttribute blockAttribute) {
+    encodeSPUBlock(input, nullptr, output, blockAttribute);
+}
+
+void PCSX::ADPCM::Encoder::processSPUBlocks(const int16_t* input, uint8_t* output, unsigned blocks,
+                                            BlockAttribute blockAttribute) {
+    std::vector<BlockAnalysis> analyses(std::min(blocks, c_blocksPerChunk));
+    while (blocks != 0) {
+        const unsigned chunk = std::min(blocks, c_blocksPerChunk);
+        analyseBlocks(input, chunk, 1, analyses.data());
+        for (unsigned b = 0; b < chunk; b++) {
+            encodeSPUBlock(input + b * 28, &analyses[b], output + b * 16, blockAttribute);
+        }
+        input += chunk * 28;
+        output += chunk * 16;
+        blocks -= chunk;
+    }
+}
+
+void PCSX::ADPCM::Encoder::encodeSPUBlock(const int16_t* input, const BlockAnalysis* analyses, uint8_t* output,
+                                          BlockAttribute blockAttribute) {
     uint8_t filter;
     uint8_t shift;
     int16_t encoded[28];
-    processBlock(input, encoded, &filter, &shift);
+    encodeBlock(input, analyses, encoded, &filter, &shift, 1, XAMode::FourBits);
 
     uint8_t h1 = (shift & 0x0f) | ((filter & 0x0f) << 4);
     uint8_t h2 = 0;
@@ -211,6 +292,33 @@ void PCSX::ADPCM::Encoder::finishSPU(uint8_t* output) {
 }
 
 void PCSX::ADPCM::Encoder::processXABlock(const int16_t* input, uint8_t* output, XAMode xaMode, unsigned channels) {
+    encodeXABlock(input, nullptr, output, xaMode, channels);
+}
+
+void PCSX::ADPCM::Encoder::processXABlocks(const int16_t* input, uint8_t* output, unsigned blocks, XAMode xaMode,
+                                           unsigned channels) {
+    if ((channels == 0) || (channels > 2)) {
+        throw std::invalid_argument("Channels must be 1 or 2");
+    }
+    // Each XA block holds 8 sound groups in 4 bits, or 4 in 8 bits, shared between the channels.
+    const unsigned subBlocks = (xaMode == XAMode::FourBits ? 8 : 4) / channels;
+    const unsigned chunkBlocks = c_blocksPerChunk / subBlocks;
+    std::vector<BlockAnalysis> analyses(std::min(blocks, chunkBlocks) * subBlocks * channels);
+    while (blocks != 0) {
+        const unsigned chunk = std::min(blocks, chunkBlocks);
+        analyseBlocks(input, chunk * subBlocks, channels, analyses.data());
+        for (unsigned b = 0; b < chunk; b++) {
+            encodeXABlock(input + b * subBlocks * 28 * channels, analyses.data() + b * subBlocks * channels,
+                          output + b * 128, xaMode, channels);
+        }
+        input += chunk * subBlocks * 28 * channels;
+        output += chunk * 128;
+        blocks -= chunk;
+    }
+}
+
+void PCSX::ADPCM::Encoder::encodeXABlock(const int16_t* input, const BlockAnalysis* analyses, uint8_t* output,
+                                         XAMode xaMode, unsigned channels) {
     if (channels > 2) {
         throw std::invalid_argument("Channels must be 1 or 2");
     }
@@ -222,7 +330,8 @@ void PCSX::ADPCM::Encoder::processXABlock(const int16_t* input, uint8_t* output,
             int16_t encoded[28 * 8];
             // Process all of the 8 28-samples block
             for (unsigned b = 0; b < 8; b++) {
-                processBlock(input + b * 28, encoded + b * 28, &filter, &shift, channels, xaMode);
+                const BlockAnalysis* blockAnalyses = analyses ? analyses + b : nullptr;
+                encodeBlock(input + b * 28, blockAnalyses, encoded + b * 28, &filter, &shift, channels, xaMode);
                 uint8_t h = (shift & 0x0f) | ((filter & 0x0f) << 4);
                 unsigned offset = (b & 3) + (b >> 2) * 8;
                 output[offset + 0] = h;
@@ -241,7 +350,8 @@ void PCSX::ADPCM::Encoder::processXABlock(const int16_t* input, uint8_t* output,
             int16_t encoded[28 * 4];
             // Process all of the 4 28-samples block
             for (unsigned b = 0; b < 4; b++) {
-                processBlock(input + b * 28, encoded + b * 28, &filter, &shift, channels, xaMode);
+                const BlockAnalysis* blockAnalyses = analyses ? analyses + b : nullptr;
+                encodeBlock(input + b * 28, blockAnalyses, encoded + b * 28, &filter, &shift, channels, xaMode);
                 shift = std::max(0, int(shift) - 4);
                 uint8_t h = (shift & 0x0f) | ((filter & 0x0f) << 4);
                 output[b + 0] = h;
@@ -264,7 +374,8 @@ void PCSX::ADPCM::Encoder::processXABlock(const int16_t* input, uint8_t* output,
             int16_t encoded[56 * 4];
             // Process all the 4 input blocks
             for (unsigned b = 0; b < 4; b++) {
-                processBlock(input + b * 56, encoded + b * 56, filter, shift, channels, xaMode);
+                const BlockAnalysis* blockAnalyses = analyses ? analyses + b * 2 : nullptr;
+                encodeBlock(input + b * 56, blockAnalyses, encoded + b * 56, filter, shift, channels, xaMode);
                 uint8_t h0 = (shift[0] & 0x0f) | ((filter[0] & 0x0f) << 4);
                 uint8_t h1 = (shift[1] & 0x0f) | ((filter[1] & 0x0f) << 4);
                 unsigned offset = (b & 1) + (b >> 1) * 4;
@@ -286,7 +397,8 @@ void PCSX::ADPCM::Encoder::processXABlock(const int16_t* input, uint8_t* output,
             int16_t encoded[56 * 2];
             // Process all the 2 input blocks
             for (unsigned b = 0; b < 2; b++) {
-                processBlock(input + b * 56, encoded + b * 56, filter, shift, channels, xaMode);
+                const BlockAnalysis* blockAnalyses = analyses ? analyses + b * 2 : nullptr;
+                encodeBlock(input + b * 56, blockAnalyses, encoded + b * 56, filter, shift, channels, xaMode);
                 shift[0] = std::max(0, int(shift[0]) - 4);
                 shift[1] = std::max(0, int(shift[1]) - 4);
                 uint8_t h0 = (shift[0] & 0x0f) | ((filter[0] & 0x0f) << 4);
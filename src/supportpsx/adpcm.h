@@ -41,6 +41,26 @@ namespace PCSX {
 // that are doing so.
 namespace ADPCM {
 
+// The prediction filters of the SPU and of the XA decoder chip, as the factors applied to the previous
+// sample and to the one before it. The XA decoder only knows about the first 4 of them.
+constexpr std::array<std::array<double, 2>, 5> c_filters = {{
+    {0.0, 0.0},            // 0
+    {-0.9375, 0.0},        // 1
+    {-1.796875, 0.8125},   // 2
+    {-1.53125, 0.859375},  // 3
+    {-1.90625, 0.9375},    // 4
+}};
+
+// Same as above, in the 6.10 fixed point format the hardware decoders use.
+constexpr std::array<std::array<int32_t, 2>, 5> c_fixedFilters = [] {
+    std::array<std::array<int32_t, 2>, 5> ret{};
+    for (unsigned i = 0; i < c_filters.size(); i++) {
+        ret[i][0] = int32_t(c_filters[i][0] * 1024);
+        ret[i][1] = int32_t(c_filters[i][1] * 1024);
+    }
+    return ret;
+}();
+
 class Encoder {
   public:
     // The mode of the encoder. Normal is the default, and is used for most audio. XA is used for XA audio,
@@ -120,7 +140,24 @@ class Encoder {
     // user. The last 4 bytes of the MODE2 FORM2 sector should either be the yellow book checksum, or set to 0.
     void processXABlock(const int16_t* input, uint8_t* output, XAMode xaMode, unsigned channels);
 
+    // Batch versions of processSPUBlock and processXABlock. The output is identical to calling the single block
+    // functions in a loop over the input, but faster for long streams: the filter and shift search of a block only
+    // depends on the input samples, so it is done for all of the blocks at once, spread over multiple threads, and
+    // only the final quantization, which carries the encoder state over from one block to the next, is serial.
+    // For SPU blocks, the same block attribute is applied to all of the blocks, and the output buffer needs to be
+    // 16 * blocks bytes long. For XA blocks, the input buffer is the concatenation of the inputs described above,
+    // and the output buffer needs to be 128 * blocks bytes long.
+    void processSPUBlocks(const int16_t* input, uint8_t* output, unsigned blocks, BlockAttribute blockAttribute);
+    void processXABlocks(const int16_t* input, uint8_t* output, unsigned blocks, XAMode xaMode, unsigned channels);
+
   private:
+    // The result of the filter and shift search for a single channel of a 28 samples block.
+    struct BlockAnalysis {
+        std::array<double, 28> filtered;
+        uint8_t filter;
+        uint8_t shift;
+    };
+
     // The original encvag code uses this to force some filters to be discarded, by setting the factors
     // to 1000.0 instead of 1.0. This is used when calling reset with a mode different than Normal.
     std::array<double, 10> m_factors;
@@ -128,18 +165,20 @@ class Encoder {
     // samples and anomalies, which are used to calculate the filter and shift values for the next block.
     std::array<std::array<double, 2>, 2> m_lastBlockSamples;
     std::array<std::array<double, 2>, 2> m_anomalies;
-    // Early versions of the encoder only used 4 filters, and the XA mode is meant to mimic that behavior.
-    static constexpr std::array<std::array<double, 2>, 5> c_filters = {{
-        {0.0, 0.0},            // 0
-        {-0.9375, 0.0},        // 1
-        {-1.796875, 0.8125},   // 2
-        {-1.53125, 0.859375},  // 3
-        {-1.90625, 0.9375},    // 4
-    }};
 
     void convertToDoubles(std::span<const int16_t> input, std::span<double> output, unsigned channels);
-    void findFilterAndShift(std::span<const double> input, std::span<double> output, uint8_t* filterPtr,
-                            uint8_t* shiftPtr, unsigned channel);
+    void findFilterAndShift(std::span<const double> input, const std::array<double, 2>& lastBlockSamples,
+                            BlockAnalysis& analysis) const;
+    // Runs the filter and shift search over subBlocks consecutive 28 samples blocks of interleaved input, storing
+    // one analysis per block and channel, then updates m_lastBlockSamples as if they had been processed in order.
+    void analyseBlocks(const int16_t* input, unsigned subBlocks, unsigned channels, BlockAnalysis* analyses);
+    // Same as processBlock, using the given analyses when not null, instead of searching for them.
+    void encodeBlock(const int16_t* input, const BlockAnalysis* analyses, int16_t* output, uint8_t* filterPtr,
+                     uint8_t* shiftPtr, unsigned channels, XAMode xaMode);
+    void encodeSPUBlock(const int16_t* input, const BlockAnalysis* analyses, uint8_t* output,
+                        BlockAttribute blockAttribute);
+    void encodeXABlock(const int16_t* input, const BlockAnalysis* analyses, uint8_t* output, XAMode xaMode,
+                       unsigned channels);
     void convert(std::span<const double> input, std::span<int16_t> output, uint8_t filter, uint8_t shift,
                  unsigned channel, XAMode xaMode);
 };
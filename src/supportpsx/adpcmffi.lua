@@ -52,9 +52,13 @@ void adpcmEncoderProcessBlock(LuaAdpcmEncoder* encoder, const void* in, void* ou
                               uint8_t* shiftPtr, unsigned channels);
 void adpcmEncoderProcessSPUBlock(LuaAdpcmEncoder* encoder, const void* input, void* output,
                                  enum AdpcmEncoderBlockAttribute);
+void adpcmEncoderProcessSPUBlocks(LuaAdpcmEncoder* encoder, const void* input, void* output, unsigned blocks,
+                                  enum AdpcmEncoderBlockAttribute);
 void adpcmEncoderFinishSPU(LuaAdpcmEncoder* encoder, uint8_t* output);
 void adpcmEncoderProcessXABlock(LuaAdpcmEncoder* encoder, const int16_t* input, uint8_t* output,
                                 enum XAMode, unsigned channels);
+void adpcmEncoderProcessXABlocks(LuaAdpcmEncoder* encoder, const void* input, void* output, unsigned blocks,
+                                 enum XAMode, unsigned channels);
 
 ]]
 
@@ -169,6 +173,58 @@ PCSX.Adpcm = {
                 C.adpcmEncoderProcessXABlock(self._wrapped, inp, out, mode, channels)
                 return outData
             end,
+            processSPUBlocks = function(self, inData, blocks, outData, blockAttribute)
+                if type(outData) == 'string' and blockAttribute == nil then
+                    blockAttribute = outData
+                    outData = nil
+                end
+                if outData == nil then outData = Support.NewLuaBuffer(16 * blocks) end
+                if blockAttribute == nil then blockAttribute = 'OneShot' end
+                local inp = inData
+                local out = outData
+                if Support.isLuaBuffer(inp) then
+                    if #inp < 56 * blocks then error('input buffer too small') end
+                    inp = inp.data
+                end
+                if Support.isLuaBuffer(out) then
+                    if out:maxsize() < 16 * blocks then error('output buffer too small') end
+                    out:resize(16 * blocks)
+                    out = out.data
+                end
+                C.adpcmEncoderProcessSPUBlocks(self._wrapped, inp, out, blocks, blockAttribute)
+                return outData
+            end,
+            processXABlocks = function(self, inData, blocks, outData, mode, channels)
+                if type(outData) == 'string' and mode == nil and channels == nil then
+                    mode = outData
+                    outData = nil
+                end
+                if type(outData) == 'number' and mode == nil and channels == nil then
+                    channels = outData
+                    outData = nil
+                end
+                if type(mode) == 'number' and channels == nil then
+                    channels = mode
+                    mode = nil
+                end
+                if outData == nil then outData = Support.NewLuaBuffer(128 * blocks) end
+                if mode == nil then mode = 'XAFourBits' end
+                if channels == nil then channels = 1 end
+                local inp = inData
+                local out = outData
+                if Support.isLuaBuffer(inp) then
+                    local theoreticalSize = 28 * 4 * (mode == 'XAFourBits' and 2 or 1) * 2 * blocks
+                    if #inp < theoreticalSize then error('input buffer too small') end
+                    inp = inp.data
+                end
+                if Support.isLuaBuffer(out) then
+                    if out:maxsize() < 128 * blocks then error('output buffer too small') end
+                    out:resize(128 * blocks)
+                    out = out.data
+                end
+                C.adpcmEncoderProcessXABlocks(self._wrapped, inp, out, blocks, mode, channels)
+                return outData
+            end,
         }
         debug.setmetatable(encoder._proxy, { __gc = function() C.destroyAdpcmEncoder(encoder._wrapped) end })
         return encoder
@@ -43,11 +43,19 @@ void adpcmEncoderProcessSPUBlock(PCSX::ADPCM::Encoder* encoder, const int16_t* i
                                  PCSX::ADPCM::Encoder::BlockAttribute blockAttribute) {
     encoder->processSPUBlock(input, output, blockAttribute);
 }
+void adpcmEncoderProcessSPUBlocks(PCSX::ADPCM::Encoder* encoder, const int16_t* input, uint8_t* output, unsigned blocks,
+                                  PCSX::ADPCM::Encoder::BlockAttribute blockAttribute) {
+    encoder->processSPUBlocks(input, output, blocks, blockAttribute);
+}
 void adpcmEncoderFinishSPU(PCSX::ADPCM::Encoder* encoder, uint8_t* output) { encoder->finishSPU(output); }
 void adpcmEncoderProcessXABlock(PCSX::ADPCM::Encoder* encoder, const int16_t* input, uint8_t* output,
                                 PCSX::ADPCM::Encoder::XAMode mode, unsigned channels) {
     encoder->processXABlock(input, output, mode, channels);
 }
+void adpcmEncoderProcessXABlocks(PCSX::ADPCM::Encoder* encoder, const int16_t* input, uint8_t* output, unsigned blocks,
+                                 PCSX::ADPCM::Encoder::XAMode mode, unsigned channels) {
+    encoder->processXABlocks(input, output, blocks, mode, channels);
+}
 
 template <typename T, size_t S>
 void registerSymbol(PCSX::Lua L, const char (&name)[S], const T ptr) {
@@ -67,8 +75,10 @@ void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, adpcmEncoderReset);
     REGISTER(L, adpcmEncoderProcessBlock);
     REGISTER(L, adpcmEncoderProcessSPUBlock);
+    REGISTER(L, adpcmEncoderProcessSPUBlocks);
     REGISTER(L, adpcmEncoderFinishSPU);
     REGISTER(L, adpcmEncoderProcessXABlock);
+    REGISTER(L, adpcmEncoderProcessXABlocks);
     L.settable();
     L.pop();
 }
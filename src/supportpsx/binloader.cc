@@ -26,8 +26,11 @@ SOFTWARE.
 
 #include "supportpsx/binloader.h"
 
+#include <string.h>
+
 #include <map>
 #include <string>
+#include <string_view>
 
 #include "elfio/elfio.hpp"
 #include "fmt/format.h"
@@ -40,17 +43,20 @@ namespace PCSX {
 
 namespace {
 
-void eraseSymbolsInSpan(uint32_t low, uint32_t high, std::map<uint32_t, std::string>& symbols) {
-    for (auto s = symbols.begin(); s != symbols.end();) {
-        if (s->first >= low && s->first < high) {
-            s = symbols.erase(s);
-        } else {
-            s++;
-        }
+// In-memory inputs get viewed rather than read, which saves an allocation and a copy of the whole
+// segment. Anything else, such as the decompressed stream of a PSF, is read sequentially.
+void copySegment(IO<File> file, IO<File> dest, uint32_t size, uint32_t addr) {
+    if (!file.isA<BufferFile>()) {
+        dest->writeAt(file->read(size), addr);
+        return;
     }
+    const size_t pos = file->rTell();
+    Slice segment = file->viewAt(size, pos);
+    file->rSeek(pos + segment.size(), SEEK_SET);
+    dest->writeAt(std::move(segment), addr);
 }
 
-bool loadCPE(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<uint32_t, std::string>& symbols) {
+bool loadCPE(IO<File> file, IO<File> dest, BinaryLoader::Info& info, SymbolTable& symbols) {
     uint32_t magic = file->read<uint32_t>();
     if (magic != 0x1455043) return false;
     file->skip<uint16_t>();
@@ -66,8 +72,8 @@ bool loadCPE(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<ui
             case 1: {  // load
                 uint32_t addr = file->read<uint32_t>();
                 uint32_t size = file->read<uint32_t>();
-                dest->writeAt(file->read(size), addr);
-                eraseSymbolsInSpan(addr, addr + size, symbols);
+                copySegment(file, dest, size, addr);
+                symbols.eraseRange(addr, addr + size);
             } break;
             case 2: {
                 file->read<uint32_t>();
@@ -114,7 +120,7 @@ bool loadCPE(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<ui
     return true;
 }
 
-bool loadPSEXE(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<uint32_t, std::string>& symbols) {
+bool loadPSEXE(IO<File> file, IO<File> dest, BinaryLoader::Info& info, SymbolTable& symbols) {
     uint64_t magic = file->read<uint64_t>();
     if (magic != 0x45584520582d5350) return false;
 
@@ -134,8 +140,8 @@ bool loadPSEXE(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<
     file->rSeek(0x71, SEEK_SET);
     uint8_t regionByte = file->byte();
     file->rSeek(2048, SEEK_SET);
-    dest->writeAt(file->read(size), addr);
-    eraseSymbolsInSpan(addr, addr + size, symbols);
+    copySegment(file, dest, size, addr);
+    symbols.eraseRange(addr, addr + size);
     switch (regionByte) {
         case 'A':
         case 'J':
@@ -148,7 +154,7 @@ bool loadPSEXE(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<
     return true;
 }
 
-bool loadPSF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<uint32_t, std::string>& symbols,
+bool loadPSF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, SymbolTable& symbols,
              bool seenRefresh = false, unsigned depth = 0) {
     if (depth >= 10) return false;
     uint32_t magic = file->read<uint32_t>();
@@ -212,7 +218,7 @@ bool loadPSF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<ui
     return true;
 }
 
-bool loadELF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<uint32_t, std::string>& symbols) {
+bool loadELF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, SymbolTable& symbols) {
     using namespace ELFIO;
     elfio reader;
     FileIStream stream(file);
@@ -236,26 +242,36 @@ bool loadELF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<ui
         auto data = psec->get_data();
         auto addr = psec->get_address();
         dest->writeAt(data, size, addr);
-        eraseSymbolsInSpan(addr, addr + size, symbols);
+        symbols.eraseRange(addr, addr + size);
     }
 
+    // Debug builds can carry hundreds of thousands of symbols, so rather than going through the
+    // symbol accessor, which builds a std::string for each of them, the symbol entries are decoded
+    // in place, and the names are handed over to the symbol table as views into the string table.
+    // The PlayStation being little endian, so are its binaries, and so is the host.
+    if (reader.get_encoding() != ELFDATA2LSB) return true;
     for (unsigned i = 0; i < sec_num; i++) {
         section* psec = reader.sections[i];
-        auto name = psec->get_name();
-
-        auto type = psec->get_type();
-        if (type != SHT_SYMTAB) continue;
-        const ELFIO::symbol_section_accessor symbolstab(reader, psec);
-        for (unsigned s = 0; s < symbolstab.get_symbols_num(); s++) {
-            std::string name;
-            Elf64_Addr value;
-            Elf_Xword size;
-            unsigned char bind;
-            unsigned char type;
-            Elf_Half section_index;
-            unsigned char other;
-            symbolstab.get_symbol(s, name, value, size, bind, type, section_index, other);
-            symbols[value] = name;
+        if (psec->get_type() != SHT_SYMTAB) continue;
+        if (psec->get_link() >= sec_num) continue;
+        section* strtab = reader.sections[psec->get_link()];
+
+        const char* entries = psec->get_data();
+        const char* strings = strtab->get_data();
+        const size_t entrySize = psec->get_entry_size() ? psec->get_entry_size() : sizeof(Elf32_Sym);
+        if (!entries || !strings || (entrySize < sizeof(Elf32_Sym))) continue;
+        const size_t count = psec->get_size() / entrySize;
+        const size_t stringsSize = strtab->get_size();
+        symbols.reserve(count, stringsSize);
+
+        for (size_t s = 0; s < count; s++) {
+            Elf32_Sym sym;
+            memcpy(&sym, entries + s * entrySize, sizeof(Elf32_Sym));
+            std::string_view name;
+            if (sym.st_name < stringsSize) {
+                name = {strings + sym.st_name, strnlen(strings + sym.st_name, stringsSize - sym.st_name)};
+            }
+            symbols.insert(sym.st_value, name);
         }
     }
 
@@ -266,7 +282,7 @@ bool loadELF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<ui
 
 }  // namespace PCSX
 
-bool PCSX::BinaryLoader::load(IO<File> in, IO<File> dest, Info& info, std::map<uint32_t, std::string>& symbols) {
+bool PCSX::BinaryLoader::load(IO<File> in, IO<File> dest, Info& info, SymbolTable& symbols) {
     {
         IO<File> ny(new PosixFile(in->filename().parent_path() / "libps.exe"));
         if (!ny->failed()) loadPSEXE(ny, dest, info, symbols);
@@ -34,6 +34,7 @@ SOFTWARE.
 #include <string>
 
 #include "support/file.h"
+#include "supportpsx/symboltable.h"
 
 namespace PCSX {
 
@@ -47,7 +48,7 @@ struct Info {
     std::optional<uint32_t> gp;
 };
 
-bool load(IO<File> in, IO<File> dest, Info& info, std::map<uint32_t, std::string>& symbols);
+bool load(IO<File> in, IO<File> dest, Info& info, SymbolTable& symbols);
 
 }  // namespace BinaryLoader
 
@@ -48,7 +48,7 @@ struct BinaryLoaderInfo {
 
 bool binaryLoaderLoad(PCSX::LuaFFI::LuaFile* src, PCSX::LuaFFI::LuaFile* dest, BinaryLoaderInfo* info) {
     PCSX::BinaryLoader::Info i;
-    std::map<uint32_t, std::string> symbols;
+    PCSX::SymbolTable symbols;
     info->region = PCSX::BinaryLoader::Region::UNKNOWN;
     info->pc = 0;
     info->sp = 0;
@@ -0,0 +1,85 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "supportpsx/exectrace-reader.h"
+
+#include <algorithm>
+
+#include "support/zfile.h"
+
+bool PCSX::ExecTrace::Reader::open(const std::filesystem::path& filename) {
+    close();
+    IO<File> file(new PosixFile(filename));
+    if (file->failed()) return false;
+    m_file = new ZReader(file);
+    if (!refill()) return false;
+    std::string_view view = pending();
+    if (!Decoder::header(view)) return false;
+    consume(view);
+    return true;
+}
+
+void PCSX::ExecTrace::Reader::close() {
+    m_file.reset();
+    m_buffer.clear();
+    m_offset = 0;
+    m_decoder = {};
+    m_count = 0;
+}
+
+PCSX::ExecTrace::Reader::Status PCSX::ExecTrace::Reader::next() {
+    if (!m_file) return Status::Error;
+    while (true) {
+        std::string_view view = pending();
+        const auto result = m_decoder.next(view);
+        consume(view);
+        switch (result) {
+            case Decoder::Result::Instruction:
+                m_count++;
+                return Status::Instruction;
+            case Decoder::Result::Checkpoint:
+                m_count++;
+                return Status::Checkpoint;
+            case Decoder::Result::Snapshot:
+                continue;
+            case Decoder::Result::NeedMore:
+                if (!refill()) return pending().empty() ? Status::End : Status::Error;
+                continue;
+            case Decoder::Result::Error:
+                return Status::Error;
+        }
+    }
+}
+
+bool PCSX::ExecTrace::Reader::refill() {
+    m_buffer.erase(0, m_offset);
+    m_offset = 0;
+    const size_t size = m_buffer.size();
+    m_buffer.resize(size + c_chunkSize);
+    const ssize_t count = m_file->read(m_buffer.data() + size, c_chunkSize);
+    m_buffer.resize(size + std::max<ssize_t>(count, 0));
+    return count > 0;
+}
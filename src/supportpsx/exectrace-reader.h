@@ -0,0 +1,72 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "support/file.h"
+#include "supportpsx/exectrace.h"
+
+namespace PCSX {
+
+namespace ExecTrace {
+
+// Feeds the decoder from a trace file, one chunk at a time, as traces can get much larger than memory.
+class Reader {
+  public:
+    enum class Status { Instruction, Checkpoint, End, Error };
+
+    bool open(const std::filesystem::path& filename);
+    void close();
+    // Skips over the snapshots, only stopping on instructions and checkpoints.
+    Status next();
+
+    const Decoder& decoder() const { return m_decoder; }
+    // How many instructions, and checkpoints, have been read so far.
+    uint64_t count() const { return m_count; }
+
+  private:
+    static constexpr size_t c_chunkSize = 1024 * 1024;
+
+    std::string_view pending() const { return std::string_view(m_buffer).substr(m_offset); }
+    void consume(std::string_view view) { m_offset = m_buffer.size() - view.size(); }
+    bool refill();
+
+    IO<File> m_file;
+    std::string m_buffer;
+    size_t m_offset = 0;
+    Decoder m_decoder;
+    uint64_t m_count = 0;
+};
+
+}  // namespace ExecTrace
+
+}  // namespace PCSX
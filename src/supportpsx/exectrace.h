@@ -0,0 +1,230 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <string_view>
+
+namespace PCSX {
+
+// A compact, binary, trace of the instructions the CPU ran. The stream starts with an 8 bytes magic and
+// a 32 bits version, followed by records, each of them starting with a tag byte:
+//  - 0x00 to 0x7f is an instruction. Bit 0 is set when its pc isn't the previous one plus 4, in which
+//    case the pc follows. Bits 1 to 6 are how many registers it changed. Then comes its opcode, and for
+//    each register it changed, the register's index, and its new value.
+//  - 0x80 is a snapshot of all of the registers, the pc first. It's what the changes are relative to.
+//  - 0x81 is a checkpoint, taken in between two blocks of instructions rather than after each of them.
+//    It holds the pc, the 64 bits cycle counter, how many registers changed since the last record as a
+//    byte, and then the changed registers, the same way instructions do.
+// All values are 32 bits little endian. Registers 0 to 31 are the GPRs, 32 is lo and 33 is hi, the same
+// as Mips::GPRRegs. A trace without any snapshot is a trace of the opcodes only.
+namespace ExecTrace {
+
+static constexpr char MAGIC[8] = {'P', 'S', 'X', 'T', 'R', 'A', 'C', 'E'};
+static constexpr uint32_t VERSION = 1;
+static constexpr unsigned REGISTERS = 34;
+static constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 4;
+
+static constexpr uint8_t TAG_EXPLICIT_PC = 0x01;
+static constexpr uint8_t TAG_SNAPSHOT = 0x80;
+static constexpr uint8_t TAG_CHECKPOINT = 0x81;
+
+static inline void put32(std::string& out, uint32_t value) {
+    const char bytes[4] = {char(value), char(value >> 8), char(value >> 16), char(value >> 24)};
+    out.append(bytes, 4);
+}
+
+static inline uint32_t get32(const char* in) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(in);
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (uint32_t(bytes[3]) << 24);
+}
+
+class Encoder {
+  public:
+    static void header(std::string& out) {
+        out.append(MAGIC, sizeof(MAGIC));
+        put32(out, VERSION);
+    }
+
+    void snapshot(std::string& out, uint32_t pc, const uint32_t* regs) {
+        out.push_back(char(TAG_SNAPSHOT));
+        put32(out, pc);
+        for (unsigned i = 0; i < REGISTERS; i++) put32(out, regs[i]);
+        m_nextPC = pc;
+    }
+
+    // The instruction at pc turned the registers from before into after. Both may be null, to only
+    // trace the opcodes.
+    void instruction(std::string& out, uint32_t pc, uint32_t code, const uint32_t* before = nullptr,
+                     const uint32_t* after = nullptr) {
+        uint8_t changed[REGISTERS];
+        unsigned count = 0;
+        if (before && after) {
+            for (unsigned i = 0; i < REGISTERS; i++) {
+                if (before[i] != after[i]) changed[count++] = i;
+            }
+        }
+        const bool explicitPC = pc != m_nextPC;
+        out.push_back(char((count << 1) | (explicitPC ? TAG_EXPLICIT_PC : 0)));
+        if (explicitPC) put32(out, pc);
+        put32(out, code);
+        for (unsigned i = 0; i < count; i++) {
+            out.push_back(char(changed[i]));
+            put32(out, after[changed[i]]);
+        }
+        m_nextPC = pc + 4;
+    }
+
+    // The registers went from before to after since the last record, and the CPU is about to run the
+    // block at pc.
+    void checkpoint(std::string& out, uint32_t pc, uint64_t cycle, const uint32_t* before, const uint32_t* after) {
+        uint8_t changed[REGISTERS];
+        unsigned count = 0;
+        for (unsigned i = 0; i < REGISTERS; i++) {
+            if (before[i] != after[i]) changed[count++] = i;
+        }
+        out.push_back(char(TAG_CHECKPOINT));
+        put32(out, pc);
+        put32(out, uint32_t(cycle));
+        put32(out, uint32_t(cycle >> 32));
+        out.push_back(char(count));
+        for (unsigned i = 0; i < count; i++) {
+            out.push_back(char(changed[i]));
+            put32(out, after[changed[i]]);
+        }
+        m_nextPC = pc;
+    }
+
+  private:
+    uint32_t m_nextPC = 0;
+};
+
+class Decoder {
+  public:
+    enum class Result { Instruction, Snapshot, Checkpoint, NeedMore, Error };
+
+    // Checks and skips the header. Returns false if it isn't one of ours, or it's truncated.
+    static bool header(std::string_view& in) {
+        if (in.size() < HEADER_SIZE) return false;
+        if (memcmp(in.data(), MAGIC, sizeof(MAGIC)) != 0) return false;
+        if (get32(in.data() + sizeof(MAGIC)) != VERSION) return false;
+        in.remove_prefix(HEADER_SIZE);
+        return true;
+    }
+
+    // Decodes the next record out of in. A record cut short at the end of in leaves it untouched, and
+    // returns NeedMore, so the caller can append more data and try again.
+    Result next(std::string_view& in) {
+        if (in.empty()) return Result::NeedMore;
+        const uint8_t tag = in[0];
+        if (tag == TAG_SNAPSHOT) {
+            if (in.size() < 1 + 4 + REGISTERS * 4) return Result::NeedMore;
+            m_pc = get32(in.data() + 1);
+            for (unsigned i = 0; i < REGISTERS; i++) m_regs[i] = get32(in.data() + 5 + i * 4);
+            in.remove_prefix(1 + 4 + REGISTERS * 4);
+            m_nextPC = m_pc;
+            m_hasRegisters = true;
+            m_changed = 0;
+            return Result::Snapshot;
+        }
+        if (tag == TAG_CHECKPOINT) {
+            if (in.size() < 1 + 4 + 8 + 1) return Result::NeedMore;
+            const unsigned count = uint8_t(in[13]);
+            if (count > REGISTERS) return Result::Error;
+            const size_t size = 1 + 4 + 8 + 1 + count * 5;
+            if (in.size() < size) return Result::NeedMore;
+            if (!applyChanges(in.data() + 14, count)) return Result::Error;
+            m_pc = get32(in.data() + 1);
+            m_cycle = get32(in.data() + 5) | (uint64_t(get32(in.data() + 9)) << 32);
+            in.remove_prefix(size);
+            m_nextPC = m_pc;
+            return Result::Checkpoint;
+        }
+        if (tag & 0x80) return Result::Error;
+
+        const unsigned count = tag >> 1;
+        if (count > REGISTERS) return Result::Error;
+        const bool explicitPC = tag & TAG_EXPLICIT_PC;
+        const size_t size = 1 + (explicitPC ? 4 : 0) + 4 + count * 5;
+        if (in.size() < size) return Result::NeedMore;
+        const char* data = in.data() + 1;
+        if (explicitPC) {
+            m_nextPC = get32(data);
+            data += 4;
+        }
+        m_pc = m_nextPC;
+        m_code = get32(data);
+        data += 4;
+        if (!applyChanges(data, count)) return Result::Error;
+        in.remove_prefix(size);
+        m_nextPC = m_pc + 4;
+        return Result::Instruction;
+    }
+
+    uint32_t pc() const { return m_pc; }
+    uint32_t code() const { return m_code; }
+    // Only set by checkpoints.
+    uint64_t cycle() const { return m_cycle; }
+    // Whether a snapshot has been seen, without which the register values aren't known.
+    bool hasRegisters() const { return m_hasRegisters; }
+    // The registers after the last instruction ran, and before.
+    const uint32_t* registers() const { return m_regs; }
+    const uint32_t* previousRegisters() const { return m_previous; }
+    // Bit n is set if the last instruction, or checkpoint, changed register n.
+    uint64_t changed() const { return m_changed; }
+
+  private:
+    bool applyChanges(const char* data, unsigned count) {
+        // What the instruction saw, before it ran.
+        memcpy(m_previous, m_regs, sizeof(m_regs));
+        m_changed = 0;
+        for (unsigned i = 0; i < count; i++) {
+            const uint8_t index = data[0];
+            if (index >= REGISTERS) return false;
+            m_regs[index] = get32(data + 1);
+            m_changed |= uint64_t(1) << index;
+            data += 5;
+        }
+        return true;
+    }
+
+    uint32_t m_pc = 0;
+    uint32_t m_code = 0;
+    uint64_t m_cycle = 0;
+    uint32_t m_nextPC = 0;
+    uint32_t m_regs[REGISTERS] = {};
+    uint32_t m_previous[REGISTERS] = {};
+    uint64_t m_changed = 0;
+    bool m_hasRegisters = false;
+};
+
+}  // namespace ExecTrace
+
+}  // namespace PCSX
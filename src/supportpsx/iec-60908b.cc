@@ -27,8 +27,18 @@ SOFTWARE.
 #include "supportpsx/iec-60908b.h"
 
 #include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <vector>
 
 #include "iec-60908b/edcecc.h"
+#include "iec-60908b/tables.h"
+
+// Below this, spinning up threads costs more than the EDC/ECC computation itself.
+static constexpr unsigned c_sectorsPerThread = 64;
 
 // Lookup table for crc-16 subq calculation. This is a normal CRC-CCITT.
 static constexpr uint16_t crctab[256] = {
@@ -76,4 +86,141 @@ uint16_t PCSX::IEC60908b::subqCRC(const uint8_t* d, int len) {
     return ~crc;
 }
 
-void PCSX::IEC60908b::computeEDCECC(uint8_t* sector) { compute_edcecc(sector); }
+namespace {
+
+// Slicing-by-8 tables for the yellow book's crc32, which is the reflected form of
+// the polynomial x^32 + x^31 + x^16 + x^15 + x^4 + x^3 + x + 1. The first slice is
+// the same as the bytewise table the reference implementation uses.
+constexpr std::array<std::array<uint32_t, 256>, 8> generateEDCTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables = {};
+    for (unsigned i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (unsigned j = 0; j < 8; j++) crc = (crc >> 1) ^ ((crc & 1) ? 0xd8018001 : 0);
+        tables[0][i] = crc;
+    }
+    for (unsigned t = 1; t < 8; t++) {
+        for (unsigned i = 0; i < 256; i++) {
+            tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+        }
+    }
+    return tables;
+}
+
+constexpr auto c_edcTables = generateEDCTables();
+
+uint32_t computeEDC(const uint8_t* data, unsigned len) {
+    uint32_t edc = 0;
+    for (; len >= 8; len -= 8, data += 8) {
+        edc ^= data[0] | (data[1] << 8) | (data[2] << 16) | (uint32_t(data[3]) << 24);
+        edc = c_edcTables[7][edc & 0xff] ^ c_edcTables[6][(edc >> 8) & 0xff] ^ c_edcTables[5][(edc >> 16) & 0xff] ^
+              c_edcTables[4][edc >> 24] ^ c_edcTables[3][data[4]] ^ c_edcTables[2][data[5]] ^
+              c_edcTables[1][data[6]] ^ c_edcTables[0][data[7]];
+    }
+    while (len--) edc = c_edcTables[0][(edc ^ *data++) & 0xff] ^ (edc >> 8);
+    return edc;
+}
+
+// The P and Q parities are computed 8 lines at a time, with one line per byte
+// of a 64 bits word. Lines are independent from each other, so this only needs
+// a carry-less multiplication by 2 in GF(2^8), which is easy to do on all lanes
+// at once: shift left, and fold the overflowing bit back using the field's
+// polynomial, 0x11d.
+inline uint64_t gfMul2x8(uint64_t v) {
+    const uint64_t high = (v >> 7) & 0x0101010101010101ull;
+    return ((v & 0x7f7f7f7f7f7f7f7full) << 1) ^ (high * 0x1d);
+}
+
+// Same long division as the reference implementation: the upper portion of each
+// line accumulates the sum of its bytes, and the lower portion the series
+// S(n) = 2(S(n-1) + b). The final adjustment is done bytewise, with the tables.
+template <unsigned words>
+struct ECCLines {
+    uint64_t sum[words] = {};
+    uint64_t series[words] = {};
+    void feed(const uint8_t* coeffs) {
+        for (unsigned w = 0; w < words; w++) {
+            uint64_t c;
+            memcpy(&c, coeffs + w * 8, 8);
+            series[w] = gfMul2x8(series[w] ^ c);
+            sum[w] ^= c;
+        }
+    }
+    void store(uint8_t* low, uint8_t* high, unsigned count) {
+        uint8_t sums[words * 8], serieses[words * 8];
+        memcpy(sums, sum, sizeof(sums));
+        memcpy(serieses, series, sizeof(serieses));
+        for (unsigned i = 0; i < count; i++) {
+            uint8_t eccLow = gf_div3_table[gf_mul2_table[serieses[i]] ^ sums[i]];
+            low[i] = eccLow;
+            high[i] = sums[i] ^ eccLow;
+        }
+    }
+};
+
+void computeECC(uint8_t* eccData) {
+    // P: 86 lines of 24 bytes, line i being the column at 86 * j + i. Reading 88
+    // bytes per row spills over the next row, or the P parity itself for the last
+    // one, which is harmless as these two extra lanes are discarded.
+    ECCLines<11> p;
+    for (unsigned j = 0; j < 24; j++) p.feed(eccData + 86 * j);
+    p.store(eccData + 24 * 86, eccData + 25 * 86, 86);
+
+    // Q: 52 lines of 43 bytes, covering P. Seen as a 26x43 matrix of 16 bits words,
+    // line k picks the word at row (j + k) % 26 and column j, so the diagonal is
+    // gathered in a contiguous buffer first, for all the lines at once.
+    ECCLines<7> q;
+    for (unsigned j = 0; j < 43; j++) {
+        uint8_t diagonal[56] = {};
+        unsigned row = j % 26;
+        for (unsigned k = 0; k < 26; k++) {
+            const uint8_t* word = eccData + (43 * row + j) * 2;
+            diagonal[2 * k] = word[0];
+            diagonal[2 * k + 1] = word[1];
+            if (++row == 26) row = 0;
+        }
+        q.feed(diagonal);
+    }
+    q.store(eccData + 43 * 26 * 2, eccData + 44 * 26 * 2, 52);
+}
+
+}  // namespace
+
+// This is the same algorithm as compute_edcecc, which remains the reference
+// implementation, only processing more data at once. See edcecc.c for the
+// explanations of the format.
+void PCSX::IEC60908b::computeEDCECC(uint8_t* sector) {
+    uint8_t* location = sector + 12;
+    if (location[3] != 2) return;
+    uint8_t* subheader = location + 4;
+    const bool form2 = (subheader[2] & 0x20) != 0;
+    const unsigned len = (form2 ? 2324 : 2048) + 8;
+
+    const uint32_t edc = computeEDC(subheader, len);
+    subheader[len + 0] = edc & 0xff;
+    subheader[len + 1] = (edc >> 8) & 0xff;
+    subheader[len + 2] = (edc >> 16) & 0xff;
+    subheader[len + 3] = edc >> 24;
+    if (form2) return;
+
+    uint8_t actualLocation[4];
+    memcpy(actualLocation, location, 4);
+    memset(location, 0, 4);
+    computeECC(location);
+    memcpy(location, actualLocation, 4);
+}
+
+void PCSX::IEC60908b::computeEDCECC(uint8_t* sectors, unsigned count) {
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    threads = std::clamp(count / c_sectorsPerThread, 1u, threads);
+    const unsigned perThread = (count + threads - 1) / threads;
+    auto work = [sectors, count](unsigned begin, unsigned end) {
+        end = std::min(end, count);
+        for (unsigned i = begin; i < end; i++) computeEDCECC(sectors + i * FRAMESIZE_RAW);
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++) {
+        workers.emplace_back(work, t * perThread, (t + 1) * perThread);
+    }
+    work(0, perThread);
+    for (auto& worker : workers) worker.join();
+}
@@ -154,6 +154,10 @@ struct MSF {
 // Compute the EDC and ECC for a mode2 sector.
 void computeEDCECC(uint8_t *sector);
 
+// Compute the EDC and ECC for count contiguous raw mode2 sectors, spreading
+// the work over several threads when the batch is large enough.
+void computeEDCECC(uint8_t *sectors, unsigned count);
+
 // Compute the CRC-16 for the SubQ channel.
 uint16_t subqCRC(const uint8_t *d, int len = 10);
 
@@ -28,8 +28,6 @@ SOFTWARE.
 
 #include <stdexcept>
 
-#include "iec-60908b/edcecc.h"
-
 void PCSX::ISO9660Builder::writeLicense(IO<File> licenseFile) {
     if (licenseFile && !licenseFile->failed()) {
         uint8_t licenseData[IEC60908b::FRAMESIZE_RAW * 16];
@@ -44,73 +42,77 @@ void PCSX::ISO9660Builder::writeLicense(IO<File> licenseFile) {
             return;
         } else if (licenseData[0x24e2] == 'L') {
             // looks like an iso file itself
-            for (unsigned i = 0; i < 16; i++) {
-                writeSectorAt(licenseData + IEC60908b::FRAMESIZE_RAW * i, {0, 2, uint8_t(i)},
-                              IEC60908b::SectorMode::RAW);
-            }
+            writeSectorsAt(licenseData, 16, {0, 2, 0}, IEC60908b::SectorMode::RAW);
             return;
         }
     }
-    uint8_t dummy[2048];
-    memset(dummy, 0, 2048);
-    for (unsigned i = 0; i < 16; i++) {
-        writeSectorAt(dummy, {0, 2, uint8_t(i)}, IEC60908b::SectorMode::M2_FORM1);
+    uint8_t dummy[2048 * 16];
+    memset(dummy, 0, sizeof(dummy));
+    writeSectorsAt(dummy, 16, {0, 2, 0}, IEC60908b::SectorMode::M2_FORM1);
+}
+
+namespace {
+
+size_t inputSize(PCSX::IEC60908b::SectorMode mode) {
+    switch (mode) {
+        case PCSX::IEC60908b::SectorMode::RAW:
+            return PCSX::IEC60908b::FRAMESIZE_RAW;
+        case PCSX::IEC60908b::SectorMode::M2_RAW:
+            return 2336;
+        case PCSX::IEC60908b::SectorMode::M2_FORM1:
+            return 2048;
+        case PCSX::IEC60908b::SectorMode::M2_FORM2:
+            return 2324;
+        default:
+            return 0;
     }
 }
 
+// Lays out the sync pattern, header, subheader and user data of a raw sector; EDC/ECC is left to the caller.
+void buildSector(uint8_t* ptr, const uint8_t* sectorData, PCSX::IEC60908b::MSF msf, PCSX::IEC60908b::SectorMode mode) {
+    static const uint8_t c_sync[12] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+    memcpy(ptr, c_sync, sizeof(c_sync));
+    msf.toBCD(ptr + 12);
+    ptr[15] = 2;
+    if (mode == PCSX::IEC60908b::SectorMode::M2_RAW) {
+        memcpy(ptr + 16, sectorData, 2336);
+        return;
+    }
+    ptr[16] = ptr[20] = 0;
+    ptr[17] = ptr[21] = 0;
+    ptr[18] = ptr[22] = 8;
+    ptr[19] = ptr[23] = 0;
+    memcpy(ptr + 24, sectorData, inputSize(mode));
+}
+
+}  // namespace
+
 PCSX::IEC60908b::MSF PCSX::ISO9660Builder::writeSectorAt(const uint8_t* sectorData, PCSX::IEC60908b::MSF msf,
                                                          IEC60908b::SectorMode mode) {
+    return writeSectorsAt(sectorData, 1, msf, mode);
+}
+
+PCSX::IEC60908b::MSF PCSX::ISO9660Builder::writeSectorsAt(const uint8_t* sectorsData, unsigned count,
+                                                          PCSX::IEC60908b::MSF msf, IEC60908b::SectorMode mode) {
     if (failed()) return {0, 0, 0};
-    Slice slice;
-    uint8_t* ptr;
-    static const uint8_t c_sync[12] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+    const size_t stride = inputSize(mode);
+    if ((stride == 0) || (count == 0)) return {0, 0, 0};
     uint32_t lba = msf.toLBA() - 150;
-    switch (mode) {
-        case IEC60908b::SectorMode::RAW:
-            m_out->writeAt(sectorData, IEC60908b::FRAMESIZE_RAW, lba * IEC60908b::FRAMESIZE_RAW);
-            break;
-        case IEC60908b::SectorMode::M2_RAW:
-            slice.resize(IEC60908b::FRAMESIZE_RAW);
-            ptr = slice.mutableData<uint8_t>();
-            memcpy(ptr, c_sync, sizeof(c_sync));
-            msf.toBCD(ptr + 12);
-            ptr[15] = 2;
-            memcpy(ptr + 16, sectorData, 2336);
-            m_out->writeAt(std::move(slice), lba * IEC60908b::FRAMESIZE_RAW);
-            break;
-        case IEC60908b::SectorMode::M2_FORM1:
-            slice.resize(IEC60908b::FRAMESIZE_RAW);
-            ptr = slice.mutableData<uint8_t>();
-            memcpy(ptr, c_sync, sizeof(c_sync));
-            msf.toBCD(ptr + 12);
-            ptr[15] = 2;
-            ptr[16] = ptr[20] = 0;
-            ptr[17] = ptr[21] = 0;
-            ptr[18] = ptr[22] = 8;
-            ptr[19] = ptr[23] = 0;
-            memcpy(ptr + 24, sectorData, 2048);
-            compute_edcecc(ptr);
-            m_out->writeAt(std::move(slice), lba * IEC60908b::FRAMESIZE_RAW);
-            break;
-        case IEC60908b::SectorMode::M2_FORM2:
-            slice.resize(IEC60908b::FRAMESIZE_RAW);
-            ptr = slice.mutableData<uint8_t>();
-            memcpy(ptr, c_sync, sizeof(c_sync));
-            msf.toBCD(ptr + 12);
-            ptr[15] = 2;
-            ptr[16] = ptr[20] = 0;
-            ptr[17] = ptr[21] = 0;
-            ptr[18] = ptr[22] = 8;
-            ptr[19] = ptr[23] = 0;
-            memcpy(ptr + 24, sectorData, 2324);
-            compute_edcecc(ptr);
-            m_out->writeAt(std::move(slice), lba * IEC60908b::FRAMESIZE_RAW);
-            break;
-        default:
-            return {0, 0, 0};
+    if (mode == IEC60908b::SectorMode::RAW) {
+        m_out->writeAt(sectorsData, IEC60908b::FRAMESIZE_RAW * count, lba * IEC60908b::FRAMESIZE_RAW);
+    } else {
+        Slice slice;
+        slice.resize(IEC60908b::FRAMESIZE_RAW * count);
+        uint8_t* ptr = slice.mutableData<uint8_t>();
+        auto current = msf;
+        for (unsigned i = 0; i < count; i++) {
+            buildSector(ptr + i * IEC60908b::FRAMESIZE_RAW, sectorsData + i * stride, current++, mode);
+        }
+        if (mode != IEC60908b::SectorMode::M2_RAW) IEC60908b::computeEDCECC(ptr, count);
+        m_out->writeAt(std::move(slice), lba * IEC60908b::FRAMESIZE_RAW);
     }
     auto ret = msf;
-    msf++;
+    for (unsigned i = 0; i < count; i++) msf++;
     if (msf > m_location) m_location = msf;
     return ret;
 }
@@ -41,6 +41,16 @@ class ISO9660Builder {
         return writeSectorAt(sectorData, m_location++, mode);
     }
     IEC60908b::MSF writeSectorAt(const uint8_t* sectorData, IEC60908b::MSF msf, IEC60908b::SectorMode mode);
+    // Batch versions of the above: sectorsData holds count sectors back to back, at the size
+    // implied by mode. The EDC/ECC of the whole batch is computed in parallel, and the
+    // resulting span is sent to the output file in a single write.
+    IEC60908b::MSF writeSectors(const uint8_t* sectorsData, unsigned count, IEC60908b::SectorMode mode) {
+        auto ret = m_location;
+        writeSectorsAt(sectorsData, count, m_location, mode);
+        return ret;
+    }
+    IEC60908b::MSF writeSectorsAt(const uint8_t* sectorsData, unsigned count, IEC60908b::MSF msf,
+                                  IEC60908b::SectorMode mode);
     void close() {
         m_out->close();
         m_out = nullptr;
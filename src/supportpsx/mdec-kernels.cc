@@ -0,0 +1,943 @@
+/***************************************************************************
+ *   Copyright (C) 2010 Gabriele Gorla                                     *
+ *   Copyright (C) 2007 Ryan Schultz, PCSX-df Team, PCSX team              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "supportpsx/mdec-kernels.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define MDEC_KERNELS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define MDEC_KERNELS_TARGET_SSE41
+#define MDEC_KERNELS_TARGET_AVX2
+#else
+#define MDEC_KERNELS_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define MDEC_KERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MDEC_KERNELS_NEON
+#endif
+
+#if defined(__BIGENDIAN__)
+#define MDEC_LE16(v) ((((v) & 0xff00) >> 8) | (((v) & 0xff) << 8))
+#else
+#define MDEC_LE16(v) (v)
+#endif
+
+#define AAN_CONST_BITS 12
+#define AAN_PRESCALE_BITS 16
+
+#define AAN_CONST_SIZE 24
+#define AAN_CONST_SCALE (AAN_CONST_SIZE - AAN_CONST_BITS)
+
+#define AAN_PRESCALE_SIZE 20
+#define AAN_PRESCALE_SCALE (AAN_PRESCALE_SIZE - AAN_PRESCALE_BITS)
+#define AAN_EXTRA 12
+
+#define SCALE(x, n) ((x) >> (n))
+#define SCALER(x, n) (((x) + ((1 << (n)) >> 1)) >> (n))
+
+#define MULS(var, const) (SCALE((var) * (const), AAN_CONST_BITS))
+
+#define RLE_RUN(a) ((a) >> 10)
+#define RLE_VAL(a) (((int)(a) << (sizeof(int) * 8 - 10)) >> (sizeof(int) * 8 - 10))
+
+#define FIX_1_082392200 SCALER(18159528, AAN_CONST_SCALE)  // B6
+#define FIX_1_414213562 SCALER(23726566, AAN_CONST_SCALE)  // A4
+#define FIX_1_847759065 SCALER(31000253, AAN_CONST_SCALE)  // A2
+#define FIX_2_613125930 SCALER(43840978, AAN_CONST_SCALE)  // B2
+
+namespace {
+
+using PCSX::MDECKernels::DSIZE;
+using PCSX::MDECKernels::DSIZE2;
+using PCSX::MDECKernels::Kernels;
+
+const int zscan[DSIZE2] = {
+    0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,   // 00
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,  // 10
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,  // 20
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,  // 30
+};
+
+const int aanscales[DSIZE2] = {
+    1048576, 1454417, 1370031, 1232995, 1048576, 823861,  567485, 289301,  // 00
+    1454417, 2017334, 1900287, 1710213, 1454417, 1142728, 787125, 401273,  // 08
+    1370031, 1900287, 1790031, 1610986, 1370031, 1076426, 741455, 377991,  // 10
+    1232995, 1710213, 1610986, 1449849, 1232995, 968758,  667292, 340183,  // 18
+    1048576, 1454417, 1370031, 1232995, 1048576, 823861,  567485, 289301,  // 20
+    823861,  1142728, 1076426, 968758,  823861,  647303,  445870, 227303,  // 28
+    567485,  787125,  741455,  667292,  567485,  445870,  307121, 156569,  // 30
+    289301,  401273,  377991,  340183,  289301,  227303,  156569, 79818    // 38
+};
+
+inline void fillcol(int *blk, int val) {
+    blk[0 * DSIZE] = blk[1 * DSIZE] = blk[2 * DSIZE] = blk[3 * DSIZE] =
+        blk[4 * DSIZE] = blk[5 * DSIZE] = blk[6 * DSIZE] =
+            blk[7 * DSIZE] = val;
+}
+
+inline void fillrow(int *blk, int val) {
+    blk[0] = blk[1] = blk[2] = blk[3] = blk[4] = blk[5] = blk[6] = blk[7] = val;
+}
+
+// The block has only the DC coefficient.
+inline void fillDC(int *block) {
+    const int v = block[0];
+    for (unsigned i = 0; i < DSIZE2; i++) block[i] = v;
+}
+
+void idctScalar(int *block, int used_col) {
+    int tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+    int z5, z10, z11, z12, z13;
+    int *ptr;
+
+    // the block has only the DC coefficient
+    if (used_col == -1) {
+        fillDC(block);
+        return;
+    }
+
+    // last_col keeps track of the highest column with non zero coefficients
+    ptr = block;
+    for (unsigned i = 0; i < DSIZE; i++, ptr++) {
+        if ((used_col & (1 << i)) == 0) {
+            // the column is empty or has only the DC coefficient
+            if (ptr[DSIZE * 0]) {
+                fillcol(ptr, ptr[0]);
+                used_col |= (1 << i);
+            }
+            continue;
+        }
+
+        // further optimization could be made by keeping track of
+        // last_row in rl2blk
+        z10 = ptr[DSIZE * 0] + ptr[DSIZE * 4];  // s04
+        z11 = ptr[DSIZE * 0] - ptr[DSIZE * 4];  // d04
+        z13 = ptr[DSIZE * 2] + ptr[DSIZE * 6];  // s26
+        z12 = MULS(ptr[DSIZE * 2] - ptr[DSIZE * 6], FIX_1_414213562) - z13;
+        //^^^^  d26=d26*2*A4-s26
+
+        tmp0 = z10 + z13;  // os07 = s04 + s26
+        tmp3 = z10 - z13;  // os34 = s04 - s26
+        tmp1 = z11 + z12;  // os16 = d04 + d26
+        tmp2 = z11 - z12;  // os25 = d04 - d26
+
+        z13 = ptr[DSIZE * 3] + ptr[DSIZE * 5];  // s53
+        z10 = ptr[DSIZE * 3] - ptr[DSIZE * 5];  //-d53
+        z11 = ptr[DSIZE * 1] + ptr[DSIZE * 7];  // s17
+        z12 = ptr[DSIZE * 1] - ptr[DSIZE * 7];  // d17
+
+        tmp7 = z11 + z13;  // od07 = s17 + s53
+
+        z5 = (z12 - z10) * (FIX_1_847759065);
+        tmp6 = SCALE(z10 * (FIX_2_613125930) + z5, AAN_CONST_BITS) - tmp7;
+        tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
+        tmp4 = SCALE(z12 * (FIX_1_082392200)-z5, AAN_CONST_BITS) + tmp5;
+
+        // path #1
+        // z5 = (z12 - z10)* FIX_1_847759065;
+        // tmp0 = (d17 + d53) * 2*A2
+
+        // tmp6 = DESCALE(z10*FIX_2_613125930 + z5, CONST_BITS) - tmp7;
+        // od16 = (d53*-2*B2 + tmp0) - od07
+
+        // tmp4 = DESCALE(z12*FIX_1_082392200 - z5, CONST_BITS) + tmp5;
+        // od34 = (d17*2*B6 - tmp0) + od25
+
+        // path #2
+
+        // od34 = d17*2*(B6-A2) - d53*2*A2
+        // od16 = d53*2*(A2-B2) + d17*2*A2
+
+        // end
+
+        //    tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
+        // od25 = (s17 - s53)*2*A4 - od16
+
+        ptr[DSIZE * 0] = (tmp0 + tmp7);  // os07 + od07
+        ptr[DSIZE * 7] = (tmp0 - tmp7);  // os07 - od07
+        ptr[DSIZE * 1] = (tmp1 + tmp6);  // os16 + od16
+        ptr[DSIZE * 6] = (tmp1 - tmp6);  // os16 - od16
+        ptr[DSIZE * 2] = (tmp2 + tmp5);  // os25 + od25
+        ptr[DSIZE * 5] = (tmp2 - tmp5);  // os25 - od25
+        ptr[DSIZE * 4] = (tmp3 + tmp4);  // os34 + od34
+        ptr[DSIZE * 3] = (tmp3 - tmp4);  // os34 - od34
+    }
+
+    ptr = block;
+    if (used_col == 1) {
+        for (unsigned i = 0; i < DSIZE; i++)
+            fillrow(block + DSIZE * i, block[DSIZE * i]);
+    } else {
+        for (unsigned i = 0; i < DSIZE; i++, ptr += DSIZE) {
+            z10 = ptr[0] + ptr[4];
+            z11 = ptr[0] - ptr[4];
+            z13 = ptr[2] + ptr[6];
+            z12 = MULS(ptr[2] - ptr[6], FIX_1_414213562) - z13;
+
+            tmp0 = z10 + z13;
+            tmp3 = z10 - z13;
+            tmp1 = z11 + z12;
+            tmp2 = z11 - z12;
+
+            z13 = ptr[3] + ptr[5];
+            z10 = ptr[3] - ptr[5];
+            z11 = ptr[1] + ptr[7];
+            z12 = ptr[1] - ptr[7];
+
+            tmp7 = z11 + z13;
+            z5 = (z12 - z10) * FIX_1_847759065;
+            tmp6 = SCALE(z10 * FIX_2_613125930 + z5, AAN_CONST_BITS) - tmp7;
+            tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
+            tmp4 = SCALE(z12 * FIX_1_082392200 - z5, AAN_CONST_BITS) + tmp5;
+
+            ptr[0] = tmp0 + tmp7;
+
+            ptr[7] = tmp0 - tmp7;
+            ptr[1] = tmp1 + tmp6;
+            ptr[6] = tmp1 - tmp6;
+            ptr[2] = tmp2 + tmp5;
+            ptr[5] = tmp2 - tmp5;
+            ptr[4] = tmp3 + tmp4;
+            ptr[3] = tmp3 - tmp4;
+        }
+    }
+}
+
+// full scale (JPEG)
+// Y/Cb/Cr[0...255] -> R/G/B[0...255]
+// R = 1.000 * (Y) + 1.400 * (Cr - 128)
+// G = 1.000 * (Y) - 0.343 * (Cb - 128) - 0.711 (Cr - 128)
+// B = 1.000 * (Y) + 1.765 * (Cb - 128)
+#define MULR(a) ((1434 * (a)))
+#define MULB(a) ((1807 * (a)))
+#define MULG2(a, b) ((-351 * (a) - 728 * (b)))
+#define MULY(a) ((a) << 10)
+
+#define MAKERGB15(r, g, b, a) (MDEC_LE16(a | ((b) << 10) | ((g) << 5) | (r)))
+#define SCALE8(c) SCALER(c, 20)
+#define SCALE5(c) SCALER(c, 23)
+
+#define CLAMP5(c) (((c) < -16) ? 0 : (((c) > (31 - 16)) ? 31 : ((c) + 16)))
+#define CLAMP8(c) (((c) < -128) ? 0 : (((c) > (255 - 128)) ? 255 : ((c) + 128)))
+
+#define CLAMP_SCALE8(a) (CLAMP8(SCALE8(a)))
+#define CLAMP_SCALE5(a) (CLAMP5(SCALE5(a)))
+
+inline void putlinebw15(uint16_t *image, const int *Yblk, int A) {
+    for (int i = 0; i < 8; i++, Yblk++) {
+        int Y = *Yblk;
+        // missing rounding
+        image[i] = MDEC_LE16((CLAMP5(Y >> 3) * 0x421) | A);
+    }
+}
+
+inline void putquadrgb15(uint16_t *image, const int *Yblk, int Cr, int Cb, int A) {
+    int Y, R, G, B;
+    R = MULR(Cr);
+    G = MULG2(Cb, Cr);
+    B = MULB(Cb);
+
+    // added transparency
+    Y = MULY(Yblk[0]);
+    image[0] = MAKERGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
+    Y = MULY(Yblk[1]);
+    image[1] = MAKERGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
+    Y = MULY(Yblk[8]);
+    image[16] = MAKERGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
+    Y = MULY(Yblk[9]);
+    image[17] = MAKERGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
+}
+
+void rgb15Scalar(const int *blk, uint16_t *image, uint16_t A) {
+    const int *Yblk = blk + DSIZE2 * 2;
+    const int *Crblk = blk;
+    const int *Cbblk = blk + DSIZE2;
+
+    for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 24) {
+        if (y == 8) Yblk += DSIZE2;
+        for (int x = 0; x < 4; x++, image += 2, Crblk++, Cbblk++, Yblk += 2) {
+            putquadrgb15(image, Yblk, *Crblk, *Cbblk, A);
+            putquadrgb15(image + 8, Yblk + DSIZE2, *(Crblk + 4), *(Cbblk + 4), A);
+        }
+    }
+}
+
+void bnw15Scalar(const int *blk, uint16_t *image, uint16_t A) {
+    const int *Yblk = blk + DSIZE2 * 2;
+
+    for (int y = 0; y < 16; y++, Yblk += 8, image += 16) {
+        if (y == 8) Yblk += DSIZE2;
+        putlinebw15(image, Yblk, A);
+        putlinebw15(image + 8, Yblk + DSIZE2, A);
+    }
+}
+
+inline void putlinebw24(uint8_t *image, const int *Yblk) {
+    for (int i = 0; i < 8 * 3; i += 3, Yblk++) {
+        uint8_t Y = CLAMP8(*Yblk);
+        image[i + 0] = Y;
+        image[i + 1] = Y;
+        image[i + 2] = Y;
+    }
+}
+
+inline void putquadrgb24(uint8_t *image, const int *Yblk, int Cr, int Cb) {
+    int Y, R, G, B;
+
+    R = MULR(Cr);
+    G = MULG2(Cb, Cr);
+    B = MULB(Cb);
+
+    Y = MULY(Yblk[0]);
+    image[0 * 3 + 0] = CLAMP_SCALE8(Y + R);
+    image[0 * 3 + 1] = CLAMP_SCALE8(Y + G);
+    image[0 * 3 + 2] = CLAMP_SCALE8(Y + B);
+    Y = MULY(Yblk[1]);
+    image[1 * 3 + 0] = CLAMP_SCALE8(Y + R);
+    image[1 * 3 + 1] = CLAMP_SCALE8(Y + G);
+    image[1 * 3 + 2] = CLAMP_SCALE8(Y + B);
+    Y = MULY(Yblk[8]);
+    image[16 * 3 + 0] = CLAMP_SCALE8(Y + R);
+    image[16 * 3 + 1] = CLAMP_SCALE8(Y + G);
+    image[16 * 3 + 2] = CLAMP_SCALE8(Y + B);
+    Y = MULY(Yblk[9]);
+    image[17 * 3 + 0] = CLAMP_SCALE8(Y + R);
+    image[17 * 3 + 1] = CLAMP_SCALE8(Y + G);
+    image[17 * 3 + 2] = CLAMP_SCALE8(Y + B);
+}
+
+void rgb24Scalar(const int *blk, uint8_t *image) {
+    const int *Yblk = blk + DSIZE2 * 2;
+    const int *Crblk = blk;
+    const int *Cbblk = blk + DSIZE2;
+
+    for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 8 * 3 * 3) {
+        if (y == 8) Yblk += DSIZE2;
+        for (int x = 0; x < 4; x++, image += 6, Crblk++, Cbblk++, Yblk += 2) {
+            putquadrgb24(image, Yblk, *Crblk, *Cbblk);
+            putquadrgb24(image + 8 * 3, Yblk + DSIZE2, *(Crblk + 4), *(Cbblk + 4));
+        }
+    }
+}
+
+void bnw24Scalar(const int *blk, uint8_t *image) {
+    const int *Yblk = blk + DSIZE2 * 2;
+
+    for (int y = 0; y < 16; y++, Yblk += 8, image += 16 * 3) {
+        if (y == 8) Yblk += DSIZE2;
+        putlinebw24(image, Yblk);
+        putlinebw24(image + 8 * 3, Yblk + DSIZE2);
+    }
+}
+
+const Kernels c_scalarKernels = {idctScalar, rgb15Scalar, bnw15Scalar, rgb24Scalar, bnw24Scalar, "Scalar"};
+
+#if defined(MDEC_KERNELS_X86)
+
+// The same butterflies as above, on 4 columns at a time.
+MDEC_KERNELS_TARGET_SSE41 inline void idctPassSSE41(__m128i *v) {
+    const __m128i fix1_082 = _mm_set1_epi32(FIX_1_082392200);
+    const __m128i fix1_414 = _mm_set1_epi32(FIX_1_414213562);
+    const __m128i fix1_847 = _mm_set1_epi32(FIX_1_847759065);
+    const __m128i fix2_613 = _mm_set1_epi32(FIX_2_613125930);
+
+    __m128i z10 = _mm_add_epi32(v[0], v[4]);
+    __m128i z11 = _mm_sub_epi32(v[0], v[4]);
+    __m128i z13 = _mm_add_epi32(v[2], v[6]);
+    __m128i z12 =
+        _mm_sub_epi32(_mm_srai_epi32(_mm_mullo_epi32(_mm_sub_epi32(v[2], v[6]), fix1_414), AAN_CONST_BITS), z13);
+
+    const __m128i tmp0 = _mm_add_epi32(z10, z13);
+    const __m128i tmp3 = _mm_sub_epi32(z10, z13);
+    const __m128i tmp1 = _mm_add_epi32(z11, z12);
+    const __m128i tmp2 = _mm_sub_epi32(z11, z12);
+
+    z13 = _mm_add_epi32(v[3], v[5]);
+    z10 = _mm_sub_epi32(v[3], v[5]);
+    z11 = _mm_add_epi32(v[1], v[7]);
+    z12 = _mm_sub_epi32(v[1], v[7]);
+
+    const __m128i tmp7 = _mm_add_epi32(z11, z13);
+    const __m128i z5 = _mm_mullo_epi32(_mm_sub_epi32(z12, z10), fix1_847);
+    const __m128i tmp6 = _mm_sub_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(z10, fix2_613), z5), AAN_CONST_BITS), tmp7);
+    const __m128i tmp5 =
+        _mm_sub_epi32(_mm_srai_epi32(_mm_mullo_epi32(_mm_sub_epi32(z11, z13), fix1_414), AAN_CONST_BITS), tmp6);
+    const __m128i tmp4 = _mm_add_epi32(
+        _mm_srai_epi32(_mm_sub_epi32(_mm_mullo_epi32(z12, fix1_082), z5), AAN_CONST_BITS), tmp5);
+
+    v[0] = _mm_add_epi32(tmp0, tmp7);
+    v[7] = _mm_sub_epi32(tmp0, tmp7);
+    v[1] = _mm_add_epi32(tmp1, tmp6);
+    v[6] = _mm_sub_epi32(tmp1, tmp6);
+    v[2] = _mm_add_epi32(tmp2, tmp5);
+    v[5] = _mm_sub_epi32(tmp2, tmp5);
+    v[4] = _mm_add_epi32(tmp3, tmp4);
+    v[3] = _mm_sub_epi32(tmp3, tmp4);
+}
+
+MDEC_KERNELS_TARGET_SSE41 inline void transpose4x4SSE41(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+    const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+    r0 = _mm_unpacklo_epi64(t0, t1);
+    r1 = _mm_unpackhi_epi64(t0, t1);
+    r2 = _mm_unpacklo_epi64(t2, t3);
+    r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+// The left and right halves of the 8x8 block are transposed between the passes, so that the rows also get
+// processed 4 at a time. The shortcuts of the scalar version for empty and DC-only columns give the same
+// result as the full butterflies, so they're not needed here.
+MDEC_KERNELS_TARGET_SSE41 void idctSSE41(int *block, int usedCol) {
+    if (usedCol == -1) {
+        fillDC(block);
+        return;
+    }
+
+    __m128i left[8], right[8];
+    for (unsigned i = 0; i < 8; i++) {
+        left[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * DSIZE));
+        right[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * DSIZE + 4));
+    }
+    idctPassSSE41(left);
+    idctPassSSE41(right);
+
+    // After transposing each 4x4 quarter, left[i] holds column i of rows 0 to 3, left[i + 4] column i of
+    // rows 4 to 7, and the same goes for right with columns 4 to 7.
+    transpose4x4SSE41(left[0], left[1], left[2], left[3]);
+    transpose4x4SSE41(left[4], left[5], left[6], left[7]);
+    transpose4x4SSE41(right[0], right[1], right[2], right[3]);
+    transpose4x4SSE41(right[4], right[5], right[6], right[7]);
+    __m128i top[8], bottom[8];
+    for (unsigned i = 0; i < 4; i++) {
+        top[i] = left[i];
+        top[i + 4] = right[i];
+        bottom[i] = left[i + 4];
+        bottom[i + 4] = right[i + 4];
+    }
+    idctPassSSE41(top);
+    idctPassSSE41(bottom);
+
+    transpose4x4SSE41(top[0], top[1], top[2], top[3]);
+    transpose4x4SSE41(top[4], top[5], top[6], top[7]);
+    transpose4x4SSE41(bottom[0], bottom[1], bottom[2], bottom[3]);
+    transpose4x4SSE41(bottom[4], bottom[5], bottom[6], bottom[7]);
+    for (unsigned i = 0; i < 4; i++) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(block + i * DSIZE), top[i]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(block + i * DSIZE + 4), top[i + 4]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(block + (i + 4) * DSIZE), bottom[i]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(block + (i + 4) * DSIZE + 4), bottom[i + 4]);
+    }
+}
+
+// With 8 lanes, a whole row fits in a register, so both passes work on the full block.
+MDEC_KERNELS_TARGET_AVX2 inline void idctPassAVX2(__m256i *v) {
+    const __m256i fix1_082 = _mm256_set1_epi32(FIX_1_082392200);
+    const __m256i fix1_414 = _mm256_set1_epi32(FIX_1_414213562);
+    const __m256i fix1_847 = _mm256_set1_epi32(FIX_1_847759065);
+    const __m256i fix2_613 = _mm256_set1_epi32(FIX_2_613125930);
+
+    __m256i z10 = _mm256_add_epi32(v[0], v[4]);
+    __m256i z11 = _mm256_sub_epi32(v[0], v[4]);
+    __m256i z13 = _mm256_add_epi32(v[2], v[6]);
+    __m256i z12 = _mm256_sub_epi32(
+        _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(v[2], v[6]), fix1_414), AAN_CONST_BITS), z13);
+
+    const __m256i tmp0 = _mm256_add_epi32(z10, z13);
+    const __m256i tmp3 = _mm256_sub_epi32(z10, z13);
+    const __m256i tmp1 = _mm256_add_epi32(z11, z12);
+    const __m256i tmp2 = _mm256_sub_epi32(z11, z12);
+
+    z13 = _mm256_add_epi32(v[3], v[5]);
+    z10 = _mm256_sub_epi32(v[3], v[5]);
+    z11 = _mm256_add_epi32(v[1], v[7]);
+    z12 = _mm256_sub_epi32(v[1], v[7]);
+
+    const __m256i tmp7 = _mm256_add_epi32(z11, z13);
+    const __m256i z5 = _mm256_mullo_epi32(_mm256_sub_epi32(z12, z10), fix1_847);
+    const __m256i tmp6 = _mm256_sub_epi32(
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(z10, fix2_613), z5), AAN_CONST_BITS), tmp7);
+    const __m256i tmp5 = _mm256_sub_epi32(
+        _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(z11, z13), fix1_414), AAN_CONST_BITS), tmp6);
+    const __m256i tmp4 = _mm256_add_epi32(
+        _mm256_srai_epi32(_mm256_sub_epi32(_mm256_mullo_epi32(z12, fix1_082), z5), AAN_CONST_BITS), tmp5);
+
+    v[0] = _mm256_add_epi32(tmp0, tmp7);
+    v[7] = _mm256_sub_epi32(tmp0, tmp7);
+    v[1] = _mm256_add_epi32(tmp1, tmp6);
+    v[6] = _mm256_sub_epi32(tmp1, tmp6);
+    v[2] = _mm256_add_epi32(tmp2, tmp5);
+    v[5] = _mm256_sub_epi32(tmp2, tmp5);
+    v[4] = _mm256_add_epi32(tmp3, tmp4);
+    v[3] = _mm256_sub_epi32(tmp3, tmp4);
+}
+
+MDEC_KERNELS_TARGET_AVX2 inline void transpose8x8AVX2(__m256i *v) {
+    // Rows a to h: first interleaving pairs of rows, then pairs of pairs, which leaves the 4x4 quarters
+    // transposed in place, and finally swapping the two off-diagonal quarters.
+    const __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+    const __m256i t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+    const __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+    const __m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+    const __m256i t4 = _mm256_unpacklo_epi32(v[4], v[5]);
+    const __m256i t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+    const __m256i t6 = _mm256_unpacklo_epi32(v[6], v[7]);
+    const __m256i t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+MDEC_KERNELS_TARGET_AVX2 void idctAVX2(int *block, int usedCol) {
+    if (usedCol == -1) {
+        fillDC(block);
+        return;
+    }
+
+    __m256i v[8];
+    for (unsigned i = 0; i < 8; i++) v[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i * DSIZE));
+    idctPassAVX2(v);
+    transpose8x8AVX2(v);
+    idctPassAVX2(v);
+    transpose8x8AVX2(v);
+    for (unsigned i = 0; i < 8; i++) _mm256_storeu_si256(reinterpret_cast<__m256i *>(block + i * DSIZE), v[i]);
+}
+
+// The colour conversions work on one row of one luma block at a time, which is 8 pixels, sharing
+// 4 chroma samples, each one spanning 2 pixels.
+MDEC_KERNELS_TARGET_AVX2 inline __m256i loadChromaAVX2(const int *chroma) {
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(chroma));
+    return _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(c), _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3));
+}
+
+MDEC_KERNELS_TARGET_AVX2 inline __m256i clampAVX2(__m256i c, int range) {
+    // CLAMP5 / CLAMP8: clamping to [-range, range - 1], then offsetting by range.
+    c = _mm256_min_epi32(_mm256_max_epi32(c, _mm256_set1_epi32(-range)), _mm256_set1_epi32(range - 1));
+    return _mm256_add_epi32(c, _mm256_set1_epi32(range));
+}
+
+// SCALER(Y + C, shift), then clamped.
+template <int shift>
+MDEC_KERNELS_TARGET_AVX2 inline __m256i scaleClampAVX2(__m256i y, __m256i c, int range) {
+    const __m256i rounding = _mm256_set1_epi32(1 << (shift - 1));
+    return clampAVX2(_mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(y, c), rounding), shift), range);
+}
+
+// Loads the chroma and luma of one row of one luma block, and returns the clamped r, g, b channels.
+template <int shift, int range>
+MDEC_KERNELS_TARGET_AVX2 inline void rgbRowAVX2(const int *blk, unsigned y, unsigned half, __m256i &r, __m256i &g,
+                                                __m256i &b) {
+    const unsigned chroma = (y >> 1) * DSIZE + half * 4;
+    const __m256i cr = loadChromaAVX2(blk + chroma);
+    const __m256i cb = loadChromaAVX2(blk + DSIZE2 + chroma);
+    const int *Yblk = blk + DSIZE2 * (2 + (y >> 3) * 2 + half) + (y & 7) * DSIZE;
+    const __m256i luma = _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(Yblk)), 10);
+
+    const __m256i R = _mm256_mullo_epi32(cr, _mm256_set1_epi32(1434));
+    const __m256i G = _mm256_add_epi32(_mm256_mullo_epi32(cb, _mm256_set1_epi32(-351)),
+                                       _mm256_mullo_epi32(cr, _mm256_set1_epi32(-728)));
+    const __m256i B = _mm256_mullo_epi32(cb, _mm256_set1_epi32(1807));
+    r = scaleClampAVX2<shift>(luma, R, range);
+    g = scaleClampAVX2<shift>(luma, G, range);
+    b = scaleClampAVX2<shift>(luma, B, range);
+}
+
+MDEC_KERNELS_TARGET_AVX2 inline void store15AVX2(uint16_t *image, __m256i pixels) {
+    // The pixels fit in 16 bits unsigned, so the saturation never kicks in.
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(pixels, pixels), 0xd8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(image), _mm256_castsi256_si128(packed));
+}
+
+MDEC_KERNELS_TARGET_AVX2 inline void store24AVX2(uint8_t *image, __m256i pixels) {
+    // Each lane holds 0x00bbggrr, squeeze out the top bytes, then copy exactly the 24 bytes of the row,
+    // as the next bytes may belong to a macroblock another thread is working on.
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,  //
+                                             0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    alignas(32) uint8_t bytes[32];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(bytes), _mm256_shuffle_epi8(pixels, shuffle));
+    memcpy(image, bytes, 12);
+    memcpy(image + 12, bytes + 16, 12);
+}
+
+MDEC_KERNELS_TARGET_AVX2 void rgb15AVX2(const int *blk, uint16_t *image, uint16_t A) {
+    const __m256i alpha = _mm256_set1_epi32(A);
+    for (unsigned y = 0; y < 16; y++) {
+        for (unsigned half = 0; half < 2; half++) {
+            __m256i r, g, b;
+            rgbRowAVX2<23, 16>(blk, y, half, r, g, b);
+            const __m256i pixels = _mm256_or_si256(
+                _mm256_or_si256(alpha, r), _mm256_or_si256(_mm256_slli_epi32(g, 5), _mm256_slli_epi32(b, 10)));
+            store15AVX2(image + y * 16 + half * 8, pixels);
+        }
+    }
+}
+
+MDEC_KERNELS_TARGET_AVX2 void bnw15AVX2(const int *blk, uint16_t *image, uint16_t A) {
+    const __m256i alpha = _mm256_set1_epi32(A);
+    const __m256i scale = _mm256_set1_epi32(0x421);
+    for (unsigned y = 0; y < 16; y++) {
+        for (unsigned half = 0; half < 2; half++) {
+            const int *Yblk = blk + DSIZE2 * (2 + (y >> 3) * 2 + half) + (y & 7) * DSIZE;
+            const __m256i luma = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Yblk));
+            const __m256i c = clampAVX2(_mm256_srai_epi32(luma, 3), 16);
+            store15AVX2(image + y * 16 + half * 8, _mm256_or_si256(_mm256_mullo_epi32(c, scale), alpha));
+        }
+    }
+}
+
+MDEC_KERNELS_TARGET_AVX2 void rgb24AVX2(const int *blk, uint8_t *image) {
+    for (unsigned y = 0; y < 16; y++) {
+        for (unsigned half = 0; half < 2; half++) {
+            __m256i r, g, b;
+            rgbRowAVX2<20, 128>(blk, y, half, r, g, b);
+            const __m256i pixels =
+                _mm256_or_si256(r, _mm256_or_si256(_mm256_slli_epi32(g, 8), _mm256_slli_epi32(b, 16)));
+            store24AVX2(image + (y * 16 + half * 8) * 3, pixels);
+        }
+    }
+}
+
+MDEC_KERNELS_TARGET_AVX2 void bnw24AVX2(const int *blk, uint8_t *image) {
+    const __m256i scale = _mm256_set1_epi32(0x010101);
+    for (unsigned y = 0; y < 16; y++) {
+        for (unsigned half = 0; half < 2; half++) {
+            const int *Yblk = blk + DSIZE2 * (2 + (y >> 3) * 2 + half) + (y & 7) * DSIZE;
+            const __m256i luma = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Yblk));
+            store24AVX2(image + (y * 16 + half * 8) * 3, _mm256_mullo_epi32(clampAVX2(luma, 128), scale));
+        }
+    }
+}
+
+bool hasSSE41() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+bool hasAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+// Without AVX2, only the IDCT gets vectorised, as the colour conversions need the 8 lanes to be worth it.
+const Kernels c_sse41Kernels = {idctSSE41, rgb15Scalar, bnw15Scalar, rgb24Scalar, bnw24Scalar, "SSE4.1"};
+const Kernels c_avx2Kernels = {idctAVX2, rgb15AVX2, bnw15AVX2, rgb24AVX2, bnw24AVX2, "AVX2"};
+
+#elif defined(MDEC_KERNELS_NEON)
+
+inline void idctPassNEON(int32x4_t *v) {
+    const int32x4_t fix1_082 = vdupq_n_s32(FIX_1_082392200);
+    const int32x4_t fix1_414 = vdupq_n_s32(FIX_1_414213562);
+    const int32x4_t fix1_847 = vdupq_n_s32(FIX_1_847759065);
+    const int32x4_t fix2_613 = vdupq_n_s32(FIX_2_613125930);
+
+    int32x4_t z10 = vaddq_s32(v[0], v[4]);
+    int32x4_t z11 = vsubq_s32(v[0], v[4]);
+    int32x4_t z13 = vaddq_s32(v[2], v[6]);
+    int32x4_t z12 = vsubq_s32(vshrq_n_s32(vmulq_s32(vsubq_s32(v[2], v[6]), fix1_414), AAN_CONST_BITS), z13);
+
+    const int32x4_t tmp0 = vaddq_s32(z10, z13);
+    const int32x4_t tmp3 = vsubq_s32(z10, z13);
+    const int32x4_t tmp1 = vaddq_s32(z11, z12);
+    const int32x4_t tmp2 = vsubq_s32(z11, z12);
+
+    z13 = vaddq_s32(v[3], v[5]);
+    z10 = vsubq_s32(v[3], v[5]);
+    z11 = vaddq_s32(v[1], v[7]);
+    z12 = vsubq_s32(v[1], v[7]);
+
+    const int32x4_t tmp7 = vaddq_s32(z11, z13);
+    const int32x4_t z5 = vmulq_s32(vsubq_s32(z12, z10), fix1_847);
+    const int32x4_t tmp6 = vsubq_s32(vshrq_n_s32(vmlaq_s32(z5, z10, fix2_613), AAN_CONST_BITS), tmp7);
+    const int32x4_t tmp5 = vsubq_s32(vshrq_n_s32(vmulq_s32(vsubq_s32(z11, z13), fix1_414), AAN_CONST_BITS), tmp6);
+    const int32x4_t tmp4 = vaddq_s32(vshrq_n_s32(vsubq_s32(vmulq_s32(z12, fix1_082), z5), AAN_CONST_BITS), tmp5);
+
+    v[0] = vaddq_s32(tmp0, tmp7);
+    v[7] = vsubq_s32(tmp0, tmp7);
+    v[1] = vaddq_s32(tmp1, tmp6);
+    v[6] = vsubq_s32(tmp1, tmp6);
+    v[2] = vaddq_s32(tmp2, tmp5);
+    v[5] = vsubq_s32(tmp2, tmp5);
+    v[4] = vaddq_s32(tmp3, tmp4);
+    v[3] = vsubq_s32(tmp3, tmp4);
+}
+
+inline void transpose4x4NEON(int32x4_t &r0, int32x4_t &r1, int32x4_t &r2, int32x4_t &r3) {
+    const int32x4x2_t t0 = vtrnq_s32(r0, r1);
+    const int32x4x2_t t1 = vtrnq_s32(r2, r3);
+    r0 = vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0]));
+    r1 = vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1]));
+    r2 = vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0]));
+    r3 = vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1]));
+}
+
+// Same layout as the SSE4.1 version.
+void idctNEON(int *block, int usedCol) {
+    if (usedCol == -1) {
+        fillDC(block);
+        return;
+    }
+
+    int32x4_t left[8], right[8];
+    for (unsigned i = 0; i < 8; i++) {
+        left[i] = vld1q_s32(block + i * DSIZE);
+        right[i] = vld1q_s32(block + i * DSIZE + 4);
+    }
+    idctPassNEON(left);
+    idctPassNEON(right);
+
+    transpose4x4NEON(left[0], left[1], left[2], left[3]);
+    transpose4x4NEON(left[4], left[5], left[6], left[7]);
+    transpose4x4NEON(right[0], right[1], right[2], right[3]);
+    transpose4x4NEON(right[4], right[5], right[6], right[7]);
+    int32x4_t top[8], bottom[8];
+    for (unsigned i = 0; i < 4; i++) {
+        top[i] = left[i];
+        top[i + 4] = right[i];
+        bottom[i] = left[i + 4];
+        bottom[i + 4] = right[i + 4];
+    }
+    idctPassNEON(top);
+    idctPassNEON(bottom);
+
+    transpose4x4NEON(top[0], top[1], top[2], top[3]);
+    transpose4x4NEON(top[4], top[5], top[6], top[7]);
+    transpose4x4NEON(bottom[0], bottom[1], bottom[2], bottom[3]);
+    transpose4x4NEON(bottom[4], bottom[5], bottom[6], bottom[7]);
+    for (unsigned i = 0; i < 4; i++) {
+        vst1q_s32(block + i * DSIZE, top[i]);
+        vst1q_s32(block + i * DSIZE + 4, top[i + 4]);
+        vst1q_s32(block + (i + 4) * DSIZE, bottom[i]);
+        vst1q_s32(block + (i + 4) * DSIZE + 4, bottom[i + 4]);
+    }
+}
+
+// One row of one luma block is 8 pixels, so two registers, and 4 chroma samples spanning 2 pixels each.
+struct RowNEON {
+    int32x4_t lo, hi;
+};
+
+inline RowNEON loadChromaNEON(const int *chroma) {
+    const int32x4_t c = vld1q_s32(chroma);
+    return {vzip1q_s32(c, c), vzip2q_s32(c, c)};
+}
+
+inline RowNEON loadLumaNEON(const int *blk, unsigned y, unsigned half) {
+    const int *Yblk = blk + DSIZE2 * (2 + (y >> 3) * 2 + half) + (y & 7) * DSIZE;
+    return {vld1q_s32(Yblk), vld1q_s32(Yblk + 4)};
+}
+
+inline int32x4_t clampNEON(int32x4_t c, int range) {
+    c = vminq_s32(vmaxq_s32(c, vdupq_n_s32(-range)), vdupq_n_s32(range - 1));
+    return vaddq_s32(c, vdupq_n_s32(range));
+}
+
+template <int shift>
+inline int32x4_t scaleNEON(int32x4_t y, int32x4_t c) {
+    return vshrq_n_s32(vaddq_s32(vaddq_s32(y, c), vdupq_n_s32(1 << (shift - 1))), shift);
+}
+
+// Returns the clamped r, g, b channels of 4 pixels, as 16 bits lanes.
+template <int shift, int range>
+inline uint16x4x3_t rgbNEON(int32x4_t luma, int32x4_t cr, int32x4_t cb) {
+    luma = vshlq_n_s32(luma, 10);
+    const int32x4_t R = vmulq_n_s32(cr, 1434);
+    const int32x4_t G = vmlaq_n_s32(vmulq_n_s32(cb, -351), cr, -728);
+    const int32x4_t B = vmulq_n_s32(cb, 1807);
+    uint16x4x3_t ret;
+    ret.val[0] = vmovn_u32(vreinterpretq_u32_s32(clampNEON(scaleNEON<shift>(luma, R), range)));
+    ret.val[1] = vmovn_u32(vreinterpretq_u32_s32(clampNEON(scaleNEON<shift>(luma, G), range)));
+    ret.val[2] = vmovn_u32(vreinterpretq_u32_s32(clampNEON(scaleNEON<shift>(luma, B), range)));
+    return ret;
+}
+
+void rgb15NEON(const int *blk, uint16_t *image, uint16_t A) {
+    const uint16x8_t alpha = vdupq_n_u16(A);
+    for (unsigned y = 0; y < 16; y++) {
+        const unsigned chroma = (y >> 1) * DSIZE;
+        for (unsigned half = 0; half < 2; half++) {
+            const RowNEON cr = loadChromaNEON(blk + chroma + half * 4);
+            const RowNEON cb = loadChromaNEON(blk + DSIZE2 + chroma + half * 4);
+            const RowNEON luma = loadLumaNEON(blk, y, half);
+            const uint16x4x3_t lo = rgbNEON<23, 16>(luma.lo, cr.lo, cb.lo);
+            const uint16x4x3_t hi = rgbNEON<23, 16>(luma.hi, cr.hi, cb.hi);
+            const uint16x8_t r = vcombine_u16(lo.val[0], hi.val[0]);
+            const uint16x8_t g = vcombine_u16(lo.val[1], hi.val[1]);
+            const uint16x8_t b = vcombine_u16(lo.val[2], hi.val[2]);
+            const uint16x8_t pixels = vorrq_u16(vorrq_u16(alpha, r), vorrq_u16(vshlq_n_u16(g, 5), vshlq_n_u16(b, 10)));
+            vst1q_u16(image + y * 16 + half * 8, pixels);
+        }
+    }
+}
+
+void bnw15NEON(const int *blk, uint16_t *image, uint16_t A) {
+    const uint16x8_t alpha = vdupq_n_u16(A);
+    for (unsigned y = 0; y < 16; y++) {
+        for (unsigned half = 0; half < 2; half++) {
+            const RowNEON luma = loadLumaNEON(blk, y, half);
+            const uint16x4_t lo = vmovn_u32(vreinterpretq_u32_s32(clampNEON(vshrq_n_s32(luma.lo, 3), 16)));
+            const uint16x4_t hi = vmovn_u32(vreinterpretq_u32_s32(clampNEON(vshrq_n_s32(luma.hi, 3), 16)));
+            const uint16x8_t c = vcombine_u16(lo, hi);
+            vst1q_u16(image + y * 16 + half * 8, vorrq_u16(vmulq_n_u16(c, 0x421), alpha));
+        }
+    }
+}
+
+void rgb24NEON(const int *blk, uint8_t *image) {
+    for (unsigned y = 0; y < 16; y++) {
+        const unsigned chroma = (y >> 1) * DSIZE;
+        for (unsigned half = 0; half < 2; half++) {
+            const RowNEON cr = loadChromaNEON(blk + chroma + half * 4);
+            const RowNEON cb = loadChromaNEON(blk + DSIZE2 + chroma + half * 4);
+            const RowNEON luma = loadLumaNEON(blk, y, half);
+            const uint16x4x3_t lo = rgbNEON<20, 128>(luma.lo, cr.lo, cb.lo);
+            const uint16x4x3_t hi = rgbNEON<20, 128>(luma.hi, cr.hi, cb.hi);
+            uint8x8x3_t pixels;
+            for (unsigned c = 0; c < 3; c++) pixels.val[c] = vmovn_u16(vcombine_u16(lo.val[c], hi.val[c]));
+            vst3_u8(image + (y * 16 + half * 8) * 3, pixels);
+        }
+    }
+}
+
+void bnw24NEON(const int *blk, uint8_t *image) {
+    for (unsigned y = 0; y < 16; y++) {
+        for (unsigned half = 0; half < 2; half++) {
+            const RowNEON luma = loadLumaNEON(blk, y, half);
+            const uint16x4_t lo = vmovn_u32(vreinterpretq_u32_s32(clampNEON(luma.lo, 128)));
+            const uint16x4_t hi = vmovn_u32(vreinterpretq_u32_s32(clampNEON(luma.hi, 128)));
+            const uint8x8_t c = vmovn_u16(vcombine_u16(lo, hi));
+            uint8x8x3_t pixels;
+            pixels.val[0] = pixels.val[1] = pixels.val[2] = c;
+            vst3_u8(image + (y * 16 + half * 8) * 3, pixels);
+        }
+    }
+}
+
+const Kernels c_neonKernels = {idctNEON, rgb15NEON, bnw15NEON, rgb24NEON, bnw24NEON, "NEON"};
+
+#endif
+
+const Kernels &pickKernels() {
+#if defined(MDEC_KERNELS_X86)
+    if (hasAVX2()) return c_avx2Kernels;
+    if (hasSSE41()) return c_sse41Kernels;
+    return c_scalarKernels;
+#elif defined(MDEC_KERNELS_NEON)
+    return c_neonKernels;
+#else
+    return c_scalarKernels;
+#endif
+}
+
+}  // namespace
+
+void PCSX::MDECKernels::initQuantTable(int *iqtab, const uint8_t *table) {
+    for (unsigned i = 0; i < DSIZE2; i++) {
+        iqtab[i] = (table[i] * SCALER(aanscales[zscan[i]], AAN_PRESCALE_SCALE));
+    }
+}
+
+uint16_t *PCSX::MDECKernels::parseMacroblock(int *blk, int *usedCol, uint16_t *mdec_rl, const int *iqY,
+                                             const int *iqUV) {
+    int k, q_scale, rl, used_col;
+    const int *iqtab;
+
+    memset(blk, 0, 6 * DSIZE2 * sizeof(int));
+    iqtab = iqUV;
+    for (int i = 0; i < 6; i++) {
+        // decode blocks (Cr,Cb,Y1,Y2,Y3,Y4)
+        if (i == 2) iqtab = iqY;
+
+        rl = MDEC_LE16(*mdec_rl);
+        mdec_rl++;
+        q_scale = RLE_RUN(rl);
+        blk[0] = SCALER(iqtab[0] * RLE_VAL(rl), AAN_EXTRA - 3);
+        for (k = 0, used_col = 0;;) {
+            rl = MDEC_LE16(*mdec_rl);
+            mdec_rl++;
+            if (rl == PCSX::MDECKernels::END_OF_DATA) break;
+            k += RLE_RUN(rl) + 1;  // skip zero-coefficients
+
+            if (k > 63) {
+                // printf("run lenght exceeded 64 enties\n");
+                break;
+            }
+
+            // zigzag transformation
+            blk[zscan[k]] = SCALER(RLE_VAL(rl) * iqtab[k] * q_scale, AAN_EXTRA);
+            // keep track of used columns to speed up the idtc
+            used_col |= (zscan[k] > 7) ? 1 << (zscan[k] & 7) : 0;
+        }
+
+        if (k == 0) used_col = -1;
+        // used_col is -1 for blocks with only the DC coefficient
+        // any other value is a bitmask of the columns that have
+        // at least one non zero cofficient in the rows 1-7
+        // single coefficients in row 0 are treted specially
+        // in the idtc function
+        usedCol[i] = used_col;
+        blk += DSIZE2;
+    }
+    return mdec_rl;
+}
+
+const PCSX::MDECKernels::Kernels &PCSX::MDECKernels::getScalarKernels() { return c_scalarKernels; }
+
+const PCSX::MDECKernels::Kernels &PCSX::MDECKernels::getKernels() {
+    static const Kernels &kernels = pickKernels();
+    return kernels;
+}
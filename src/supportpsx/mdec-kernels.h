@@ -0,0 +1,68 @@
+/***************************************************************************
+ *   Copyright (C) 2010 Gabriele Gorla                                     *
+ *   Copyright (C) 2007 Ryan Schultz, PCSX-df Team, PCSX team              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace PCSX {
+
+// The MDEC decoding steps, without any of the hardware state, so they can be used and benchmarked
+// outside of the emulator. A macroblock is 6 blocks of 8x8 coefficients, Cr, Cb, and then the 4 luma
+// blocks, top left, top right, bottom left and bottom right, which gets converted to 16x16 pixels.
+namespace MDECKernels {
+
+static constexpr unsigned DSIZE = 8;
+static constexpr unsigned DSIZE2 = DSIZE * DSIZE;
+static constexpr unsigned MACROBLOCK_SIZE = DSIZE2 * 6;
+// Ends the coefficients of a block in the run-length data.
+static constexpr uint16_t END_OF_DATA = 0xfe00;
+
+// Scales a quantization table, as uploaded to the MDEC, for the decoder.
+void initQuantTable(int *iqtab, const uint8_t *table);
+// Decodes the run-length data of one macroblock into dequantized coefficients, and returns the pointer
+// to the data of the next one. usedCol gets, for each block, -1 if the block only has its DC coefficient,
+// or else the mask of the columns with coefficients past the first row.
+uint16_t *parseMacroblock(int *blk, int *usedCol, uint16_t *rl, const int *iqY, const int *iqUV);
+
+// In-place inverse DCT of one block, with its usedCol from parseMacroblock.
+typedef void (*IDCTFunc)(int *block, int usedCol);
+// Writes the 16x16 pixels of a macroblock, after its IDCT, as 15 bits pixels, OR'ed with alpha...
+typedef void (*RGB15Func)(const int *blk, uint16_t *image, uint16_t alpha);
+// ...or as 24 bits pixels.
+typedef void (*RGB24Func)(const int *blk, uint8_t *image);
+
+struct Kernels {
+    IDCTFunc idct;
+    RGB15Func rgb15;
+    RGB15Func bnw15;
+    RGB24Func rgb24;
+    RGB24Func bnw24;
+    const char *name;
+};
+
+// The reference implementation. The vectorized ones must produce the exact same pixels.
+const Kernels &getScalarKernels();
+// The fastest kernels the host CPU supports, which may be the scalar ones.
+const Kernels &getKernels();
+
+}  // namespace MDECKernels
+
+}  // namespace PCSX
@@ -0,0 +1,172 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "supportpsx/pixel-kernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define PIXEL_KERNELS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define PIXEL_KERNELS_TARGET_SSSE3
+#else
+#define PIXEL_KERNELS_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PIXEL_KERNELS_NEON
+#endif
+
+namespace {
+
+using namespace PCSX::PixelKernels;
+
+inline uint8_t expand5(unsigned c) { return (c << 3) | (c >> 2); }
+
+void rgb15Scalar(const uint16_t *src, uint8_t *dst, unsigned count) {
+    for (unsigned i = 0; i < count; i++) {
+        const uint16_t p = src[i];
+        dst[0] = expand5(p & 0x1f);
+        dst[1] = expand5((p >> 5) & 0x1f);
+        dst[2] = expand5((p >> 10) & 0x1f);
+        dst[3] = 0xff;
+        dst += 4;
+    }
+}
+
+void rgb24Scalar(const uint8_t *src, uint8_t *dst, unsigned count) {
+    for (unsigned i = 0; i < count; i++) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst[3] = 0xff;
+        src += 3;
+        dst += 4;
+    }
+}
+
+const Kernels c_scalarKernels = {rgb15Scalar, rgb24Scalar, "Scalar"};
+
+#if defined(PIXEL_KERNELS_X86)
+
+inline __m128i expand5SSE2(__m128i c) { return _mm_or_si128(_mm_slli_epi16(c, 3), _mm_srli_epi16(c, 2)); }
+
+// SSE2 is always there on x86_64, so this one needs no check.
+void rgb15SSE2(const uint16_t *src, uint8_t *dst, unsigned count) {
+    const __m128i mask = _mm_set1_epi16(0x1f);
+    const __m128i alpha = _mm_set1_epi16(0xff00);
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i r = expand5SSE2(_mm_and_si128(p, mask));
+        const __m128i g = expand5SSE2(_mm_and_si128(_mm_srli_epi16(p, 5), mask));
+        const __m128i b = expand5SSE2(_mm_and_si128(_mm_srli_epi16(p, 10), mask));
+        // Each 16 bits lane holds two bytes of the output pixel, which interleaving brings together.
+        const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+        const __m128i ba = _mm_or_si128(b, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_unpacklo_epi16(rg, ba));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4 + 16), _mm_unpackhi_epi16(rg, ba));
+    }
+    rgb15Scalar(src + i, dst + i * 4, count - i);
+}
+
+PIXEL_KERNELS_TARGET_SSSE3 void rgb24SSSE3(const uint8_t *src, uint8_t *dst, unsigned count) {
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(0xff000000);
+    unsigned i = 0;
+    // Each load reads 16 bytes for the 12 it converts, so the last few pixels are left to the scalar loop
+    // to avoid reading past the end of the source.
+    for (; i + 6 <= count; i += 4) {
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(p, shuffle), alpha));
+    }
+    rgb24Scalar(src + i * 3, dst + i * 4, count - i);
+}
+
+bool hasSSSE3() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+const Kernels c_sse2Kernels = {rgb15SSE2, rgb24Scalar, "SSE2"};
+const Kernels c_ssse3Kernels = {rgb15SSE2, rgb24SSSE3, "SSSE3"};
+
+#elif defined(PIXEL_KERNELS_NEON)
+
+inline uint8x8_t expand5NEON(uint16x8_t c) {
+    c = vandq_u16(c, vdupq_n_u16(0x1f));
+    return vmovn_u16(vorrq_u16(vshlq_n_u16(c, 3), vshrq_n_u16(c, 2)));
+}
+
+void rgb15NEON(const uint16_t *src, uint8_t *dst, unsigned count) {
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint16x8_t p = vld1q_u16(src + i);
+        uint8x8x4_t pixels;
+        pixels.val[0] = expand5NEON(p);
+        pixels.val[1] = expand5NEON(vshrq_n_u16(p, 5));
+        pixels.val[2] = expand5NEON(vshrq_n_u16(p, 10));
+        pixels.val[3] = vdup_n_u8(0xff);
+        vst4_u8(dst + i * 4, pixels);
+    }
+    rgb15Scalar(src + i, dst + i * 4, count - i);
+}
+
+void rgb24NEON(const uint8_t *src, uint8_t *dst, unsigned count) {
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint8x8x3_t p = vld3_u8(src + i * 3);
+        uint8x8x4_t pixels;
+        pixels.val[0] = p.val[0];
+        pixels.val[1] = p.val[1];
+        pixels.val[2] = p.val[2];
+        pixels.val[3] = vdup_n_u8(0xff);
+        vst4_u8(dst + i * 4, pixels);
+    }
+    rgb24Scalar(src + i * 3, dst + i * 4, count - i);
+}
+
+const Kernels c_neonKernels = {rgb15NEON, rgb24NEON, "NEON"};
+
+#endif
+
+const Kernels &pickKernels() {
+#if defined(PIXEL_KERNELS_X86)
+    if (hasSSSE3()) return c_ssse3Kernels;
+    return c_sse2Kernels;
+#elif defined(PIXEL_KERNELS_NEON)
+    return c_neonKernels;
+#else
+    return c_scalarKernels;
+#endif
+}
+
+}  // namespace
+
+const PCSX::PixelKernels::Kernels &PCSX::PixelKernels::getScalarKernels() { return c_scalarKernels; }
+
+const PCSX::PixelKernels::Kernels &PCSX::PixelKernels::getKernels() {
+    static const Kernels &kernels = pickKernels();
+    return kernels;
+}
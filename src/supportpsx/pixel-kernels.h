@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace PCSX {
+
+// Converts rows of VRAM pixels, as the display shows them, to RGBA8888, with the bytes in R, G, B, A order
+// and an opaque alpha. This is what screenshots get turned into before being encoded or handed to the
+// clipboard.
+namespace PixelKernels {
+
+// 15 bits pixels, with the red in the lowest bits, and the mask bit ignored. Each channel gets expanded
+// by replicating its top bits, so that 0x1f becomes 0xff.
+typedef void (*RGB15Func)(const uint16_t *src, uint8_t *dst, unsigned count);
+// Packed 24 bits pixels, as the display reads them in 24 bits mode.
+typedef void (*RGB24Func)(const uint8_t *src, uint8_t *dst, unsigned count);
+
+struct Kernels {
+    RGB15Func rgb15;
+    RGB24Func rgb24;
+    const char *name;
+};
+
+// The reference implementation. The vectorized ones must produce the exact same pixels.
+const Kernels &getScalarKernels();
+// The fastest kernels the host CPU supports, which may be the scalar ones.
+const Kernels &getKernels();
+
+}  // namespace PixelKernels
+
+}  // namespace PCSX
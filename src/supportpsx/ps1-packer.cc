@@ -30,6 +30,7 @@ SOFTWARE.
 #include <stdint.h>
 
 #include <exception>
+#include <thread>
 #include <vector>
 
 #include "mips/common/util/encoder.hh"
@@ -75,6 +76,39 @@ int16_t getLO(uint32_t v) {
     return ret;
 }
 
+// Compresses the data using ucl-nrv2e at several levels concurrently, and keeps the smallest
+// result. The highest level is usually the winner, but not always, and since the candidates
+// are compressed in parallel, trying the others costs nothing in wall time. All of them are
+// decoded by the same n2e-d stub, whose run time grows with the amount of bits it has to
+// read, so the smallest candidate is also the one which boots the fastest.
+std::vector<uint8_t> compress(const std::vector<uint8_t>& dataIn) {
+    static constexpr int c_levels[] = {8, 9, 10};
+    static constexpr size_t c_count = sizeof(c_levels) / sizeof(c_levels[0]);
+    std::vector<uint8_t> candidates[c_count];
+    int results[c_count];
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < c_count; i++) {
+        workers.emplace_back([&dataIn, &candidate = candidates[i], &result = results[i], level = c_levels[i]]() {
+            candidate.resize(dataIn.size() * 1.2 + 2064);
+            ucl_uint outSize = 0;
+            result = ucl_nrv2e_99_compress(dataIn.data(), dataIn.size(), candidate.data(), &outSize, nullptr, level,
+                                           nullptr, nullptr);
+            candidate.resize(outSize);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    std::vector<uint8_t>* best = nullptr;
+    for (unsigned i = 0; i < c_count; i++) {
+        if (results[i] != UCL_E_OK) continue;
+        if (!best || (candidates[i].size() <= best->size())) best = &candidates[i];
+    }
+    if (!best) {
+        throw std::runtime_error("Fatal error during data compression.\n");
+    }
+    return std::move(*best);
+}
+
 }  // namespace
 
 void PCSX::PS1Packer::pack(IO<File> src, IO<File> dest, uint32_t addr, uint32_t pc, uint32_t gp, uint32_t sp,
@@ -85,20 +119,12 @@ void PCSX::PS1Packer::pack(IO<File> src, IO<File> dest, uint32_t addr, uint32_t
     src->read(dataIn.data(), dataIn.size());
     while ((dataIn.size() & 3) != 0) dataIn.push_back(0);
 
-    std::vector<uint8_t> dataOut;
-    dataOut.resize(dataIn.size() * 1.2 + 2064);
-    ucl_uint outSize;
-    int r;
-
     // Compress the binary using ucl-nrv2e, and store the compressed
     // binary in dataOut, potentially offset by the size of our stub,
     // if we're outputting a raw file.
-    r = ucl_nrv2e_99_compress(dataIn.data(), dataIn.size(), dataOut.data() + (options.raw ? stubSize : 0), &outSize,
-                              nullptr, 10, nullptr, nullptr);
-    if (r != UCL_E_OK) {
-        throw std::runtime_error("Fatal error during data compression.\n");
-    }
-    dataOut.resize(outSize + (options.raw ? stubSize : 0));
+    std::vector<uint8_t> compressed = compress(dataIn);
+    std::vector<uint8_t> dataOut(options.raw ? stubSize : 0);
+    dataOut.insert(dataOut.end(), compressed.begin(), compressed.end());
     while ((dataOut.size() & 3) != 0) {
         dataOut.push_back(0);
     }
@@ -0,0 +1,127 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "supportpsx/symboltable.h"
+
+#include <algorithm>
+
+void PCSX::SymbolTable::insert(uint32_t address, std::string_view name) {
+    m_edits.push_back({address, uint32_t(m_editsPool.size()), uint32_t(name.size()), false});
+    m_editsPool.append(name);
+    m_version++;
+}
+
+void PCSX::SymbolTable::erase(uint32_t address) {
+    m_edits.push_back({address, 0, 0, true});
+    m_version++;
+}
+
+void PCSX::SymbolTable::eraseRange(uint32_t low, uint32_t high) {
+    if (low >= high) return;
+    flush();
+    const size_t first = std::lower_bound(m_addresses.begin(), m_addresses.end(), low) - m_addresses.begin();
+    const size_t last = std::lower_bound(m_addresses.begin(), m_addresses.end(), high) - m_addresses.begin();
+    if (first == last) return;
+    m_version++;
+    // The erased names are in the middle of the pool, so everything after them has to move down.
+    const uint32_t removed = m_offsets[last] - m_offsets[first];
+    m_pool.erase(m_offsets[first], removed);
+    m_addresses.erase(m_addresses.begin() + first, m_addresses.begin() + last);
+    m_offsets.erase(m_offsets.begin() + first + 1, m_offsets.begin() + last + 1);
+    for (size_t i = first + 1; i < m_offsets.size(); i++) m_offsets[i] -= removed;
+}
+
+void PCSX::SymbolTable::clear() {
+    m_addresses.clear();
+    m_offsets = {0};
+    m_pool.clear();
+    m_edits.clear();
+    m_editsPool.clear();
+    m_version++;
+}
+
+PCSX::SymbolTable::const_iterator PCSX::SymbolTable::upperBound(uint32_t address) const {
+    flush();
+    const auto i = std::upper_bound(m_addresses.begin(), m_addresses.end(), address);
+    return {this, size_t(i - m_addresses.begin())};
+}
+
+std::optional<PCSX::SymbolTable::Symbol> PCSX::SymbolTable::find(uint32_t address) const {
+    flush();
+    const auto i = std::lower_bound(m_addresses.begin(), m_addresses.end(), address);
+    if ((i == m_addresses.end()) || (*i != address)) return std::nullopt;
+    return at(i - m_addresses.begin());
+}
+
+std::optional<PCSX::SymbolTable::Symbol> PCSX::SymbolTable::findContaining(uint32_t address) const {
+    flush();
+    const auto i = std::upper_bound(m_addresses.begin(), m_addresses.end(), address);
+    if (i == m_addresses.begin()) return std::nullopt;
+    return at(i - m_addresses.begin() - 1);
+}
+
+void PCSX::SymbolTable::merge() const {
+    // Sorting by address while keeping the order of the edits means the last one for each address wins.
+    std::stable_sort(m_edits.begin(), m_edits.end(),
+                     [](const Edit& a, const Edit& b) { return a.address < b.address; });
+
+    std::vector<uint32_t> addresses;
+    std::vector<uint32_t> offsets = {0};
+    std::string pool;
+    addresses.reserve(m_addresses.size() + m_edits.size());
+    offsets.reserve(m_addresses.size() + m_edits.size() + 1);
+    pool.reserve(m_pool.size() + m_editsPool.size());
+
+    auto push = [&](uint32_t address, std::string_view name) {
+        addresses.push_back(address);
+        pool.append(name);
+        offsets.push_back(pool.size());
+    };
+
+    size_t current = 0;
+    const size_t count = m_addresses.size();
+    for (size_t e = 0; e < m_edits.size(); e++) {
+        const auto address = m_edits[e].address;
+        if ((e + 1 < m_edits.size()) && (m_edits[e + 1].address == address)) continue;
+        while ((current < count) && (m_addresses[current] < address)) {
+            push(m_addresses[current], {m_pool.data() + m_offsets[current], m_offsets[current + 1] - m_offsets[current]});
+            current++;
+        }
+        if ((current < count) && (m_addresses[current] == address)) current++;
+        const auto& edit = m_edits[e];
+        if (!edit.erase) push(address, {m_editsPool.data() + edit.offset, edit.length});
+    }
+    while (current < count) {
+        push(m_addresses[current], {m_pool.data() + m_offsets[current], m_offsets[current + 1] - m_offsets[current]});
+        current++;
+    }
+
+    m_addresses = std::move(addresses);
+    m_offsets = std::move(offsets);
+    m_pool = std::move(pool);
+    m_edits.clear();
+    m_editsPool.clear();
+}
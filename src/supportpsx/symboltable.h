@@ -0,0 +1,137 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PCSX {
+
+// The symbols of the loaded binaries, sorted by address. They're kept as a sorted array of addresses, with
+// the names packed together in a single string pool, which is both much more compact than a std::map with
+// its one node and one string per symbol, and faster to search.
+//
+// Edits get queued up, and merged in all at once by the next lookup, so loading a large symbol table from
+// an ELF or a .map file costs one sort rather than one tree insertion per symbol. The names handed out are
+// views into the pool, and stay valid until the table gets modified.
+class SymbolTable {
+  public:
+    struct Symbol {
+        uint32_t address;
+        std::string_view name;
+    };
+
+    class const_iterator {
+      public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef Symbol value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Symbol* pointer;
+        typedef Symbol reference;
+
+        Symbol operator*() const { return m_table->at(m_index); }
+        const_iterator& operator++() {
+            m_index++;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator copy(*this);
+            m_index++;
+            return copy;
+        }
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+      private:
+        const_iterator(const SymbolTable* table, size_t index) : m_table(table), m_index(index) {}
+        const SymbolTable* m_table;
+        size_t m_index;
+        friend class SymbolTable;
+    };
+
+    void insert(uint32_t address, std::string_view name);
+    void erase(uint32_t address);
+    // Drops all of the symbols in [low, high), for when a binary gets loaded over them.
+    void eraseRange(uint32_t low, uint32_t high);
+    void clear();
+    // Makes room for a batch of upcoming insertions, given their count and the total length of their names.
+    void reserve(size_t symbols, size_t names) {
+        m_edits.reserve(m_edits.size() + symbols);
+        m_editsPool.reserve(m_editsPool.size() + names);
+    }
+    // Bumped by every modification, so that whatever caches lookups can tell when to drop them.
+    uint32_t version() const { return m_version; }
+
+    size_t size() const {
+        flush();
+        return m_addresses.size();
+    }
+    bool empty() const { return size() == 0; }
+    Symbol at(size_t index) const {
+        flush();
+        return {m_addresses[index], {m_pool.data() + m_offsets[index], m_offsets[index + 1] - m_offsets[index]}};
+    }
+    const_iterator begin() const {
+        flush();
+        return {this, 0};
+    }
+    const_iterator end() const { return {this, size()}; }
+    // The first symbol strictly after the given address.
+    const_iterator upperBound(uint32_t address) const;
+
+    std::optional<Symbol> find(uint32_t address) const;
+    // The closest symbol at or before the given address.
+    std::optional<Symbol> findContaining(uint32_t address) const;
+
+  private:
+    void flush() const {
+        if (!m_edits.empty()) merge();
+    }
+    void merge() const;
+
+    struct Edit {
+        uint32_t address;
+        uint32_t offset;
+        uint32_t length;
+        bool erase;
+    };
+
+    mutable std::vector<uint32_t> m_addresses;
+    // One more entry than there are symbols, so that each name ends where the next one starts.
+    mutable std::vector<uint32_t> m_offsets = {0};
+    mutable std::string m_pool;
+    mutable std::vector<Edit> m_edits;
+    mutable std::string m_editsPool;
+    uint32_t m_version = 0;
+};
+
+}  // namespace PCSX
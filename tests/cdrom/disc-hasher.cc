@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/disc-hasher.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+static std::filesystem::path makeImage(const char* name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(PCSX::DiscHasher::sidecarPath(path));
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "not really a disc image";
+    return path;
+}
+
+static PCSX::DiscHasher::Result makeResult() {
+    PCSX::DiscHasher::Result result;
+    result.disc.crc32 = 0xdeadbeef;
+    for (unsigned i = 0; i < 16; i++) result.disc.md5[i] = i * 17;
+    auto& track = result.tracks.emplace_back();
+    track.crc32 = 0x00c0ffee;
+    track.md5[15] = 0x42;
+    return result;
+}
+
+TEST(DiscHasher, SidecarRoundTrip) {
+    auto path = makeImage("pcsx-redux-dischasher-roundtrip.bin");
+    EXPECT_FALSE(PCSX::DiscHasher::loadSidecar(path).has_value());
+    ASSERT_TRUE(PCSX::DiscHasher::saveSidecar(path, makeResult()));
+
+    auto loaded = PCSX::DiscHasher::loadSidecar(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->disc.crc32, 0xdeadbeef);
+    EXPECT_EQ(loaded->disc.md5String(), "00112233445566778899aabbccddeeff");
+    ASSERT_EQ(loaded->tracks.size(), 1);
+    EXPECT_EQ(loaded->tracks[0].crc32, 0x00c0ffee);
+    EXPECT_EQ(loaded->tracks[0].md5String(), "00000000000000000000000000000042");
+
+    std::filesystem::remove(PCSX::DiscHasher::sidecarPath(path));
+    std::filesystem::remove(path);
+}
+
+TEST(DiscHasher, StaleSidecar) {
+    auto path = makeImage("pcsx-redux-dischasher-stale.bin");
+    ASSERT_TRUE(PCSX::DiscHasher::saveSidecar(path, makeResult()));
+
+    // Same size, different modification time.
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) - std::chrono::hours(1));
+    EXPECT_FALSE(PCSX::DiscHasher::loadSidecar(path).has_value());
+
+    // Different size.
+    ASSERT_TRUE(PCSX::DiscHasher::saveSidecar(path, makeResult()));
+    { std::ofstream(path, std::ios::binary | std::ios::app) << "!"; }
+    EXPECT_FALSE(PCSX::DiscHasher::loadSidecar(path).has_value());
+
+    std::filesystem::remove(PCSX::DiscHasher::sidecarPath(path));
+    std::filesystem::remove(path);
+}
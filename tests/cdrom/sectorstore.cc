@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/sectorstore.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+static void fillSector(uint8_t* sector, uint8_t seed) {
+    for (unsigned i = 0; i < PCSX::IEC60908b::FRAMESIZE_RAW; i++) sector[i] = static_cast<uint8_t>(seed + i);
+}
+
+TEST(SectorStore, Dedup) {
+    auto path = std::filesystem::temp_directory_path() / "pcsx-redux-sectorstore-dedup";
+    std::filesystem::remove_all(path);
+    uint8_t a[PCSX::IEC60908b::FRAMESIZE_RAW];
+    uint8_t b[PCSX::IEC60908b::FRAMESIZE_RAW];
+    fillSector(a, 0);
+    fillSector(b, 1);
+
+    PCSX::SectorStore::Digest digestA, digestB;
+    {
+        PCSX::SectorStore store(path, true);
+        ASSERT_FALSE(store.failed());
+        EXPECT_EQ(store.count(), 0);
+        digestA = store.add(a);
+        digestB = store.add(b);
+        EXPECT_EQ(store.add(a), digestA);
+        EXPECT_NE(digestA, digestB);
+        EXPECT_EQ(store.count(), 2);
+    }
+
+    {
+        PCSX::SectorStore store(path);
+        ASSERT_FALSE(store.failed());
+        EXPECT_EQ(store.count(), 2);
+        EXPECT_EQ(store.find(digestA), 0);
+        EXPECT_EQ(store.find(digestB), 1);
+        EXPECT_EQ(memcmp(store.sector(1), b, sizeof(b)), 0);
+        EXPECT_EQ(store.sector(2), nullptr);
+        uint8_t c[PCSX::IEC60908b::FRAMESIZE_RAW];
+        fillSector(c, 2);
+        EXPECT_EQ(store.find(PCSX::SectorStore::digest(c)), -1);
+    }
+
+    std::filesystem::remove_all(path);
+}
+
+TEST(SectorStore, InterruptedAdd) {
+    auto path = std::filesystem::temp_directory_path() / "pcsx-redux-sectorstore-interrupted";
+    std::filesystem::remove_all(path);
+    uint8_t a[PCSX::IEC60908b::FRAMESIZE_RAW];
+    uint8_t b[PCSX::IEC60908b::FRAMESIZE_RAW];
+    fillSector(a, 0);
+    fillSector(b, 1);
+
+    {
+        PCSX::SectorStore store(path, true);
+        ASSERT_FALSE(store.failed());
+        store.add(a);
+    }
+    // A sector which made it to the pack only partially, and never made it to the index.
+    {
+        std::ofstream pack(path / "sectors.pack", std::ios::binary | std::ios::app);
+        pack.write(reinterpret_cast<const char*>(b), 1000);
+    }
+
+    {
+        PCSX::SectorStore store(path, true);
+        ASSERT_FALSE(store.failed());
+        EXPECT_EQ(store.count(), 1);
+        store.add(b);
+    }
+
+    {
+        PCSX::SectorStore store(path);
+        ASSERT_FALSE(store.failed());
+        EXPECT_EQ(store.count(), 2);
+        EXPECT_EQ(store.find(PCSX::SectorStore::digest(b)), 1);
+        EXPECT_EQ(memcmp(store.sector(1), b, sizeof(b)), 0);
+    }
+
+    std::filesystem::remove_all(path);
+}
+
+TEST(SectorStore, Missing) {
+    PCSX::SectorStore store(std::filesystem::temp_directory_path() / "pcsx-redux-sectorstore-missing");
+    EXPECT_TRUE(store.failed());
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/decode_xa.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// The subheader, then 18 sound groups of 128 bytes.
+constexpr size_t c_sectorSize = 8 + 18 * 128;
+
+void compare(uint8_t coding, std::mt19937& gen) {
+    auto expected = std::make_unique<xa_decode_t>();
+    auto actual = std::make_unique<xa_decode_t>();
+    memset(expected.get(), 0, sizeof(xa_decode_t));
+    memset(actual.get(), 0, sizeof(xa_decode_t));
+    std::uniform_int_distribution<unsigned> byte(0, 255);
+
+    for (unsigned sector = 0; sector < 16; sector++) {
+        uint8_t data[c_sectorSize];
+        for (auto& b : data) b = byte(gen);
+        data[3] = data[7] = coding;
+        // Some of the sectors are silent, or saturating, blocks.
+        if (sector == 4) memset(data + 8, 0, c_sectorSize - 8);
+        if (sector == 5) {
+            for (unsigned j = 0; j < 18; j++) {
+                memset(data + 8 + j * 128, 0x20, 16);
+                memset(data + 8 + j * 128 + 16, 0x77, 112);
+            }
+        }
+
+        uint8_t copy[c_sectorSize];
+        memcpy(copy, data, sizeof(data));
+        ASSERT_EQ(xa_decode_sector_scalar(expected.get(), data, sector == 0), 0);
+        ASSERT_EQ(xa_decode_sector(actual.get(), copy, sector == 0), 0);
+        ASSERT_EQ(expected->nsamples, actual->nsamples);
+        const size_t samples = expected->stereo ? expected->nsamples * 2 : expected->nsamples;
+        ASSERT_EQ(memcmp(expected->pcm, actual->pcm, samples * sizeof(short)), 0) << "sector " << sector;
+        EXPECT_EQ(expected->left.y0, actual->left.y0);
+        EXPECT_EQ(expected->left.y1, actual->left.y1);
+        EXPECT_EQ(expected->right.y0, actual->right.y0);
+        EXPECT_EQ(expected->right.y1, actual->right.y1);
+    }
+}
+
+}  // namespace
+
+TEST(DecodeXA, Mono4Bits) {
+    std::mt19937 gen(1);
+    compare(0x00, gen);
+    compare(0x04, gen);
+}
+
+TEST(DecodeXA, Stereo4Bits) {
+    std::mt19937 gen(2);
+    compare(0x01, gen);
+    compare(0x05, gen);
+}
+
+TEST(DecodeXA, Mono8Bits) {
+    std::mt19937 gen(3);
+    compare(0x10, gen);
+    compare(0x14, gen);
+}
+
+TEST(DecodeXA, Stereo8Bits) {
+    std::mt19937 gen(4);
+    compare(0x11, gen);
+    compare(0x15, gen);
+}
@@ -0,0 +1,46 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/discset.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+TEST(DiscSet, FindSiblings) {
+    auto dir = std::filesystem::temp_directory_path() / "pcsx-redux-discset";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    for (auto name : {"Game (Disc 1).cue", "Game (Disc 2).cue", "Game (Disc 3).bin", "Game (Disc 4).cue"}) {
+        std::ofstream(dir / name) << "";
+    }
+
+    auto siblings = PCSX::DiscSet::findSiblings(dir / "Game (Disc 2).cue");
+    ASSERT_EQ(siblings.size(), 3);
+    EXPECT_EQ(siblings[0], dir / "Game (Disc 1).cue");
+    EXPECT_EQ(siblings[1], dir / "Game (Disc 2).cue");
+    EXPECT_EQ(siblings[2], dir / "Game (Disc 4).cue");
+
+    siblings = PCSX::DiscSet::findSiblings(dir / "Other.cue");
+    ASSERT_EQ(siblings.size(), 1);
+    EXPECT_EQ(siblings[0], dir / "Other.cue");
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,165 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "supportpsx/exectrace.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+using namespace PCSX::ExecTrace;
+
+TEST(ExecTrace, Header) {
+    std::string out;
+    Encoder::header(out);
+    EXPECT_EQ(out.size(), HEADER_SIZE);
+
+    std::string_view view = out;
+    EXPECT_TRUE(Decoder::header(view));
+    EXPECT_TRUE(view.empty());
+
+    std::string_view truncated = std::string_view(out).substr(0, HEADER_SIZE - 1);
+    EXPECT_FALSE(Decoder::header(truncated));
+
+    std::string corrupted = out;
+    corrupted[0] = 'X';
+    view = corrupted;
+    EXPECT_FALSE(Decoder::header(view));
+    EXPECT_EQ(view.size(), HEADER_SIZE);
+}
+
+TEST(ExecTrace, OpcodesOnly) {
+    std::string out;
+    Encoder encoder;
+    encoder.instruction(out, 0x80010000, 0x11111111);
+    encoder.instruction(out, 0x80010004, 0x22222222);
+    encoder.instruction(out, 0x80020000, 0x33333333);
+    // Sequential instructions don't need their pc, only the first one and the jump target do.
+    EXPECT_EQ(out.size(), 3 * 5 + 2 * 4);
+
+    Decoder decoder;
+    std::string_view view = out;
+    ASSERT_EQ(decoder.next(view), Decoder::Result::Instruction);
+    EXPECT_EQ(decoder.pc(), 0x80010000);
+    EXPECT_EQ(decoder.code(), 0x11111111);
+    ASSERT_EQ(decoder.next(view), Decoder::Result::Instruction);
+    EXPECT_EQ(decoder.pc(), 0x80010004);
+    EXPECT_EQ(decoder.code(), 0x22222222);
+    ASSERT_EQ(decoder.next(view), Decoder::Result::Instruction);
+    EXPECT_EQ(decoder.pc(), 0x80020000);
+    EXPECT_EQ(decoder.code(), 0x33333333);
+    EXPECT_FALSE(decoder.hasRegisters());
+    EXPECT_EQ(decoder.next(view), Decoder::Result::NeedMore);
+}
+
+TEST(ExecTrace, Registers) {
+    uint32_t regs[REGISTERS];
+    for (unsigned i = 0; i < REGISTERS; i++) regs[i] = i * 0x01010101;
+    uint32_t before[REGISTERS];
+    memcpy(before, regs, sizeof(regs));
+
+    std::string out;
+    Encoder encoder;
+    encoder.snapshot(out, 0xbfc00000, regs);
+    regs[2] = 0xdeadbeef;
+    regs[33] = 0x12345678;
+    encoder.instruction(out, 0xbfc00000, 0x3c02dead, before, regs);
+
+    Decoder decoder;
+    std::string_view view = out;
+    ASSERT_EQ(decoder.next(view), Decoder::Result::Snapshot);
+    EXPECT_TRUE(decoder.hasRegisters());
+    EXPECT_EQ(memcmp(decoder.registers(), before, sizeof(before)), 0);
+    ASSERT_EQ(decoder.next(view), Decoder::Result::Instruction);
+    EXPECT_EQ(decoder.pc(), 0xbfc00000);
+    EXPECT_EQ(decoder.code(), 0x3c02dead);
+    EXPECT_EQ(decoder.changed(), (uint64_t(1) << 2) | (uint64_t(1) << 33));
+    EXPECT_EQ(memcmp(decoder.registers(), regs, sizeof(regs)), 0);
+    EXPECT_EQ(memcmp(decoder.previousRegisters(), before, sizeof(before)), 0);
+    EXPECT_TRUE(view.empty());
+}
+
+TEST(ExecTrace, Truncated) {
+    uint32_t regs[REGISTERS] = {};
+    uint32_t after[REGISTERS] = {};
+    after[4] = 42;
+
+    std::string out;
+    Encoder encoder;
+    encoder.snapshot(out, 0x80010000, regs);
+    encoder.instruction(out, 0x80010000, 0x24040000 | 42, regs, after);
+
+    // Feeding the stream one byte at a time has to decode to the same records.
+    Decoder decoder;
+    std::string_view view = std::string_view(out).substr(0, 0);
+    size_t available = 0;
+    unsigned snapshots = 0, instructions = 0;
+    while (true) {
+        const auto result = decoder.next(view);
+        if (result == Decoder::Result::NeedMore) {
+            if (available == out.size()) break;
+            const size_t consumed = available - view.size();
+            available++;
+            view = std::string_view(out).substr(consumed, available - consumed);
+            continue;
+        }
+        ASSERT_NE(result, Decoder::Result::Error);
+        if (result == Decoder::Result::Snapshot) snapshots++;
+        if (result == Decoder::Result::Instruction) instructions++;
+    }
+    EXPECT_EQ(snapshots, 1);
+    EXPECT_EQ(instructions, 1);
+    EXPECT_EQ(decoder.registers()[4], 42);
+    EXPECT_TRUE(view.empty());
+}
+
+TEST(ExecTrace, Checkpoints) {
+    uint32_t regs[REGISTERS] = {};
+    uint32_t after[REGISTERS] = {};
+    after[31] = 0x80010008;
+
+    std::string out;
+    Encoder encoder;
+    encoder.snapshot(out, 0x80010000, regs);
+    encoder.checkpoint(out, 0x80020000, 0x123456789a, regs, after);
+
+    Decoder decoder;
+    std::string_view view = out;
+    ASSERT_EQ(decoder.next(view), Decoder::Result::Snapshot);
+    std::string_view truncated = view.substr(0, view.size() - 1);
+    EXPECT_EQ(decoder.next(truncated), Decoder::Result::NeedMore);
+    ASSERT_EQ(decoder.next(view), Decoder::Result::Checkpoint);
+    EXPECT_EQ(decoder.pc(), 0x80020000);
+    EXPECT_EQ(decoder.cycle(), 0x123456789a);
+    EXPECT_EQ(decoder.changed(), uint64_t(1) << 31);
+    EXPECT_EQ(decoder.registers()[31], 0x80010008);
+    EXPECT_TRUE(view.empty());
+}
+
+TEST(ExecTrace, Corrupted) {
+    std::string out;
+    out.push_back(char(0x82));
+    Decoder decoder;
+    std::string_view view = out;
+    EXPECT_EQ(decoder.next(view), Decoder::Result::Error);
+}
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+
+#include "core/framepacer.h"
+
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = PCSX::FramePacer::clock;
+
+// Runs frames taking `work` each, presented `interval` apart.
+void run(PCSX::FramePacer& pacer, Clock::time_point& now, unsigned frames, Clock::duration work,
+         Clock::duration interval) {
+    for (unsigned i = 0; i < frames; i++) {
+        pacer.begin(now);
+        pacer.submit(now + work);
+        now += interval;
+        pacer.presented(now);
+    }
+}
+
+}  // namespace
+
+TEST(FramePacer, RatesMatch) {
+    EXPECT_TRUE(PCSX::FramePacer::ratesMatch(60.0, 59.826));
+    EXPECT_TRUE(PCSX::FramePacer::ratesMatch(50.0, 49.76));
+    EXPECT_FALSE(PCSX::FramePacer::ratesMatch(60.0, 49.76));
+    EXPECT_FALSE(PCSX::FramePacer::ratesMatch(144.0, 59.826));
+    EXPECT_FALSE(PCSX::FramePacer::ratesMatch(0.0, 59.826));
+}
+
+TEST(FramePacer, NoDelayWithoutHistory) {
+    PCSX::FramePacer pacer;
+    Clock::time_point now;
+    run(pacer, now, 3, 4ms, 16ms);
+    EXPECT_EQ(pacer.delay(16ms), Clock::duration::zero());
+}
+
+TEST(FramePacer, DelayLeavesRoomForTheSlowFrames) {
+    PCSX::FramePacer pacer;
+    Clock::time_point now;
+    run(pacer, now, 100, 4ms, 16ms);
+    run(pacer, now, 10, 8ms, 16ms);
+    // The slower frames are more than 5% of the history, so they're the ones the delay accounts for.
+    EXPECT_EQ(pacer.workEstimate(), 8ms);
+    EXPECT_EQ(pacer.delay(16ms), 16ms - 8ms - PCSX::FramePacer::c_margin);
+    // Frames longer than the period can't be helped.
+    run(pacer, now, PCSX::FramePacer::HISTORY, 20ms, 20ms);
+    EXPECT_EQ(pacer.delay(16ms), Clock::duration::zero());
+}
+
+TEST(FramePacer, PresentStats) {
+    PCSX::FramePacer pacer;
+    Clock::time_point now;
+    pacer.presented(now);
+    for (unsigned i = 0; i < 10; i++) {
+        now += (i & 1) ? 18ms : 14ms;
+        pacer.presented(now);
+    }
+    const auto stats = pacer.presentStats();
+    EXPECT_EQ(stats.count, 10u);
+    EXPECT_DOUBLE_EQ(stats.mean, 16.0);
+    EXPECT_DOUBLE_EQ(stats.stddev, 2.0);
+    EXPECT_DOUBLE_EQ(stats.min, 14.0);
+    EXPECT_DOUBLE_EQ(stats.max, 18.0);
+}
+
+TEST(FramePacer, GapsRestartTheMeasurements) {
+    PCSX::FramePacer pacer;
+    Clock::time_point now;
+    run(pacer, now, 20, 4ms, 16ms);
+    now += 1s;
+    pacer.presented(now);
+    EXPECT_EQ(pacer.presentStats().count, 0u);
+    EXPECT_EQ(pacer.delay(16ms), Clock::duration::zero());
+    run(pacer, now, 1, 4ms, 16ms);
+    EXPECT_EQ(pacer.presentStats().count, 1u);
+}
@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/gte-kernels.h"
+
+#include <stdint.h>
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+void compare(const int16_t m[3][3], const int16_t v[3], const int32_t t[3]) {
+    const auto expected = PCSX::GTEKernels::multiplyScalar(m, v, t);
+    const auto actual = PCSX::GTEKernels::multiplySIMD(m, v, t);
+    EXPECT_EQ(expected.mac[0], actual.mac[0]);
+    EXPECT_EQ(expected.mac[1], actual.mac[1]);
+    EXPECT_EQ(expected.mac[2], actual.mac[2]);
+    EXPECT_EQ(expected.flags, actual.flags);
+}
+
+}  // namespace
+
+TEST(GTEKernels, Overflow) {
+    const int16_t m[3][3] = {{0x7fff, 0x7fff, 0x7fff}, {-0x8000, -0x8000, -0x8000}, {0x7fff, -0x8000, 0x7fff}};
+    const int16_t v[3] = {0x7fff, 0x7fff, 0x7fff};
+    const int32_t t[3] = {0x7fffffff, -0x7fffffff - 1, 0};
+
+    const auto result = PCSX::GTEKernels::multiplyScalar(m, v, t);
+    EXPECT_EQ(result.flags, (1u << 31) | (1 << 30) | (1 << 26));
+    compare(m, v, t);
+}
+
+TEST(GTEKernels, NoOverflow) {
+    const int16_t m[3][3] = {{0x1000, 0, 0}, {0, 0x1000, 0}, {0, 0, 0x1000}};
+    const int16_t v[3] = {-1, 2, -3};
+    const int32_t t[3] = {4, -5, 6};
+
+    const auto result = PCSX::GTEKernels::multiplyScalar(m, v, t);
+    EXPECT_EQ(result.mac[0], (4 << 12) - 0x1000);
+    EXPECT_EQ(result.mac[1], (-5 << 12) + 0x2000);
+    EXPECT_EQ(result.mac[2], (6 << 12) - 0x3000);
+    EXPECT_EQ(result.flags, 0);
+    compare(m, v, t);
+}
+
+TEST(GTEKernels, Random) {
+    if (!PCSX::GTEKernels::hasSIMD()) GTEST_SKIP();
+
+    std::mt19937 gen(0x6e7e);
+    std::uniform_int_distribution<int32_t> dist32;
+    std::uniform_int_distribution<int16_t> dist16;
+
+    for (int i = 0; i < 100000; i++) {
+        int16_t m[3][3];
+        int16_t v[3];
+        int32_t t[3];
+        for (auto& row : m) {
+            for (auto& c : row) c = dist16(gen);
+        }
+        for (auto& c : v) c = dist16(gen);
+        // Alternate between large and small translations, so both overflowing and regular cases get tested
+        for (auto& c : t) c = (i & 1) ? dist32(gen) : dist16(gen);
+        compare(m, v, t);
+    }
+}
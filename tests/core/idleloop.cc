@@ -0,0 +1,119 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/idleloop.h"
+
+#include <stdint.h>
+
+#include "gtest/gtest.h"
+#include "mips/common/util/encoder.hh"
+
+using namespace Mips::Encoder;
+
+namespace {
+
+constexpr uint32_t c_pc = 0x80010000;
+
+template <size_t N>
+PCSX::IdleLoop::Loop analyze(const uint32_t (&code)[N]) {
+    return PCSX::IdleLoop::analyze(code, N, c_pc);
+}
+
+}  // namespace
+
+TEST(IdleLoop, PollingLoop) {
+    // lui $a0, 0x1f80; loop: lw $v0, 0x1070($a0); nop; andi $v0, 1; beqz $v0, loop; nop
+    const uint32_t code[] = {
+        lw(Reg::V0, 0x1070, Reg::A0), nop(), andi(Reg::V0, Reg::V0, 1), beqz(Reg::V0, -4 * 4), nop(),
+    };
+    const auto loop = analyze(code);
+    EXPECT_EQ(loop.length, 5);
+    ASSERT_EQ(loop.loadCount, 1);
+    EXPECT_EQ(loop.loads[0].base, 4);
+    EXPECT_EQ(loop.loads[0].offset, 0x1070);
+    EXPECT_EQ(loop.loads[0].size, 4);
+}
+
+TEST(IdleLoop, ExitBranch) {
+    // loop: lbu $v0, 0($a0); nop; bnez $v0, out; nop; j loop; nop; out:
+    const uint32_t code[] = {
+        lbu(Reg::V0, 0, Reg::A0), nop(), bnez(Reg::V0, 3 * 4), nop(), j(c_pc), nop(), nop(),
+    };
+    const auto loop = analyze(code);
+    EXPECT_EQ(loop.length, 6);
+    ASSERT_EQ(loop.loadCount, 1);
+    EXPECT_EQ(loop.loads[0].size, 1);
+}
+
+TEST(IdleLoop, WaitForever) {
+    const uint32_t code[] = {j(c_pc), nop()};
+    EXPECT_EQ(analyze(code).length, 2);
+}
+
+TEST(IdleLoop, DelayLoop) {
+    // loop: addiu $t0, -1; bnez $t0, loop; nop
+    const uint32_t code[] = {addiu(Reg::T0, Reg::T0, -1), bnez(Reg::T0, -2 * 4), nop()};
+    EXPECT_EQ(analyze(code).length, 0);
+}
+
+TEST(IdleLoop, LoadDelay) {
+    // The branch still sees the value from the previous iteration.
+    // loop: lw $v0, 0($a0); beqz $v0, loop; nop
+    const uint32_t code[] = {lw(Reg::V0, 0, Reg::A0), beqz(Reg::V0, -2 * 4), nop()};
+    EXPECT_EQ(analyze(code).length, 0);
+}
+
+TEST(IdleLoop, Stores) {
+    // loop: sw $zero, 0($a0); lw $v0, 4($a0); nop; beqz $v0, loop; nop
+    const uint32_t code[] = {sw(Reg::R0, 0, Reg::A0), lw(Reg::V0, 4, Reg::A0), nop(), beqz(Reg::V0, -4 * 4), nop()};
+    EXPECT_EQ(analyze(code).length, 0);
+}
+
+TEST(IdleLoop, WalkingPointer) {
+    // loop: lw $v0, 0($a0); addiu $a0, 4; beqz $v0, loop; nop
+    const uint32_t code[] = {lw(Reg::V0, 0, Reg::A0), addiu(Reg::A0, Reg::A0, 4), beqz(Reg::V0, -3 * 4), nop()};
+    EXPECT_EQ(analyze(code).length, 0);
+}
+
+TEST(IdleLoop, Calls) {
+    // loop: jal somewhere; nop; beqz $v0, loop; nop
+    const uint32_t code[] = {jal(0x80020000), nop(), beqz(Reg::V0, -3 * 4), nop()};
+    EXPECT_EQ(analyze(code).length, 0);
+}
+
+TEST(IdleLoop, Truncated) {
+    const uint32_t code[] = {lw(Reg::V0, 0, Reg::A0), nop(), beqz(Reg::V0, -3 * 4)};
+    EXPECT_EQ(analyze(code).length, 0);
+}
+
+TEST(IdleLoop, StableAddresses) {
+    EXPECT_TRUE(PCSX::IdleLoop::isStableAddress(0x80012345, 4));
+    EXPECT_TRUE(PCSX::IdleLoop::isStableAddress(0xa0001000, 2));
+    EXPECT_TRUE(PCSX::IdleLoop::isStableAddress(0x1f800100, 4));
+    EXPECT_TRUE(PCSX::IdleLoop::isStableAddress(0xbfc00180, 4));
+    EXPECT_TRUE(PCSX::IdleLoop::isStableAddress(0x1f801070, 2));
+    EXPECT_TRUE(PCSX::IdleLoop::isStableAddress(0x1f801814, 4));
+    EXPECT_TRUE(PCSX::IdleLoop::isStableAddress(0x1f8010f4, 4));
+    EXPECT_TRUE(PCSX::IdleLoop::isStableAddress(0x1f801800, 1));
+    EXPECT_FALSE(PCSX::IdleLoop::isStableAddress(0x1f801800, 4));
+    EXPECT_FALSE(PCSX::IdleLoop::isStableAddress(0x1f801801, 1));
+    EXPECT_FALSE(PCSX::IdleLoop::isStableAddress(0x1f801810, 4));
+    EXPECT_FALSE(PCSX::IdleLoop::isStableAddress(0x1f801100, 4));
+    EXPECT_FALSE(PCSX::IdleLoop::isStableAddress(0xfffe0130, 4));
+}
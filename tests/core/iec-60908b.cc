@@ -0,0 +1,107 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "supportpsx/iec-60908b.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "iec-60908b/edcecc.h"
+
+using namespace PCSX::IEC60908b;
+
+namespace {
+
+void fillSector(uint8_t* sector, bool form2, std::mt19937& gen) {
+    for (unsigned i = 0; i < FRAMESIZE_RAW; i++) sector[i] = gen();
+    sector[15] = 2;
+    if (form2) {
+        sector[18] |= 0x20;
+    } else {
+        sector[18] &= ~0x20;
+    }
+}
+
+void compareSector(const uint8_t* source) {
+    uint8_t expected[FRAMESIZE_RAW];
+    uint8_t actual[FRAMESIZE_RAW];
+    memcpy(expected, source, FRAMESIZE_RAW);
+    memcpy(actual, source, FRAMESIZE_RAW);
+    compute_edcecc(expected);
+    computeEDCECC(actual);
+    ASSERT_EQ(memcmp(expected, actual, FRAMESIZE_RAW), 0);
+}
+
+}  // namespace
+
+TEST(IEC60908b, EDCECCForm1) {
+    std::mt19937 gen(1);
+    uint8_t sector[FRAMESIZE_RAW];
+    for (unsigned i = 0; i < 1000; i++) {
+        fillSector(sector, false, gen);
+        compareSector(sector);
+    }
+}
+
+TEST(IEC60908b, EDCECCForm2) {
+    std::mt19937 gen(2);
+    uint8_t sector[FRAMESIZE_RAW];
+    for (unsigned i = 0; i < 1000; i++) {
+        fillSector(sector, true, gen);
+        compareSector(sector);
+    }
+}
+
+TEST(IEC60908b, EDCECCUniform) {
+    uint8_t sector[FRAMESIZE_RAW];
+    for (unsigned value : {0x00, 0x80, 0xff}) {
+        memset(sector, value, sizeof(sector));
+        sector[15] = 2;
+        sector[18] = 8;
+        compareSector(sector);
+        sector[18] = 0x28;
+        compareSector(sector);
+    }
+}
+
+TEST(IEC60908b, EDCECCIgnoresOtherModes) {
+    std::mt19937 gen(3);
+    uint8_t sector[FRAMESIZE_RAW];
+    uint8_t copy[FRAMESIZE_RAW];
+    fillSector(sector, false, gen);
+    sector[15] = 1;
+    memcpy(copy, sector, sizeof(sector));
+    computeEDCECC(sector);
+    EXPECT_EQ(memcmp(sector, copy, sizeof(sector)), 0);
+}
+
+TEST(IEC60908b, EDCECCBatch) {
+    std::mt19937 gen(4);
+    const unsigned count = 500;
+    std::vector<uint8_t> expected(count * FRAMESIZE_RAW);
+    for (unsigned i = 0; i < count; i++) fillSector(expected.data() + i * FRAMESIZE_RAW, (i % 3) == 0, gen);
+    std::vector<uint8_t> actual = expected;
+    for (unsigned i = 0; i < count; i++) compute_edcecc(expected.data() + i * FRAMESIZE_RAW);
+    computeEDCECC(actual.data(), count);
+    EXPECT_EQ(memcmp(expected.data(), actual.data(), expected.size()), 0);
+}
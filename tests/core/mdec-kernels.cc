@@ -0,0 +1,145 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "supportpsx/mdec-kernels.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+using namespace PCSX::MDECKernels;
+
+namespace {
+
+// Fills a block the same way the run-length decoder would, with a few random coefficients,
+// and returns its usedCol.
+int fillBlock(int* block, unsigned coefficients, std::mt19937& gen) {
+    std::uniform_int_distribution<int> value(-2048, 2047);
+    std::uniform_int_distribution<unsigned> position(1, DSIZE2 - 1);
+    memset(block, 0, DSIZE2 * sizeof(int));
+    block[0] = value(gen);
+    if (coefficients == 0) return -1;
+    int usedCol = 0;
+    for (unsigned i = 0; i < coefficients; i++) {
+        const unsigned k = position(gen);
+        block[k] = value(gen);
+        if (k >= DSIZE) usedCol |= 1 << (k & 7);
+    }
+    return usedCol;
+}
+
+void compareIDCT(unsigned coefficients, std::mt19937& gen) {
+    auto& expected = getScalarKernels();
+    auto& actual = getKernels();
+    for (unsigned i = 0; i < 1000; i++) {
+        int expectedBlock[DSIZE2];
+        int actualBlock[DSIZE2];
+        const int usedCol = fillBlock(expectedBlock, coefficients, gen);
+        memcpy(actualBlock, expectedBlock, sizeof(expectedBlock));
+        expected.idct(expectedBlock, usedCol);
+        actual.idct(actualBlock, usedCol);
+        ASSERT_EQ(memcmp(expectedBlock, actualBlock, sizeof(expectedBlock)), 0) << actual.name << " block " << i;
+    }
+}
+
+// Post-IDCT values, mostly in range, with some of them far out to exercise the clamping.
+void fillMacroblock(int* blk, std::mt19937& gen) {
+    std::uniform_int_distribution<int> value(-160, 160);
+    std::uniform_int_distribution<int> outlier(-100000, 100000);
+    for (unsigned i = 0; i < MACROBLOCK_SIZE; i++) blk[i] = (gen() % 16) == 0 ? outlier(gen) : value(gen);
+}
+
+}  // namespace
+
+TEST(MDECKernels, IDCTDCOnly) {
+    std::mt19937 gen(1);
+    compareIDCT(0, gen);
+}
+
+TEST(MDECKernels, IDCTFirstRow) {
+    std::mt19937 gen(2);
+    auto& expected = getScalarKernels();
+    auto& actual = getKernels();
+    // Coefficients in the first row don't show up in usedCol.
+    for (unsigned i = 0; i < 1000; i++) {
+        int expectedBlock[DSIZE2];
+        int actualBlock[DSIZE2];
+        memset(expectedBlock, 0, sizeof(expectedBlock));
+        expectedBlock[0] = int(gen() % 4096) - 2048;
+        expectedBlock[1 + gen() % 7] = int(gen() % 4096) - 2048;
+        memcpy(actualBlock, expectedBlock, sizeof(expectedBlock));
+        expected.idct(expectedBlock, 0);
+        actual.idct(actualBlock, 0);
+        ASSERT_EQ(memcmp(expectedBlock, actualBlock, sizeof(expectedBlock)), 0) << actual.name << " block " << i;
+    }
+}
+
+TEST(MDECKernels, IDCTSparse) {
+    std::mt19937 gen(3);
+    compareIDCT(1, gen);
+    compareIDCT(4, gen);
+}
+
+TEST(MDECKernels, IDCTDense) {
+    std::mt19937 gen(4);
+    compareIDCT(20, gen);
+    compareIDCT(63, gen);
+}
+
+TEST(MDECKernels, Colour15) {
+    std::mt19937 gen(5);
+    auto& expected = getScalarKernels();
+    auto& actual = getKernels();
+    for (unsigned i = 0; i < 1000; i++) {
+        int blk[MACROBLOCK_SIZE];
+        fillMacroblock(blk, gen);
+        const uint16_t alpha = (i & 1) ? 0x8000 : 0;
+        uint16_t expectedImage[256], actualImage[256];
+        expected.rgb15(blk, expectedImage, alpha);
+        actual.rgb15(blk, actualImage, alpha);
+        ASSERT_EQ(memcmp(expectedImage, actualImage, sizeof(expectedImage)), 0) << actual.name << " rgb " << i;
+        expected.bnw15(blk, expectedImage, alpha);
+        actual.bnw15(blk, actualImage, alpha);
+        ASSERT_EQ(memcmp(expectedImage, actualImage, sizeof(expectedImage)), 0) << actual.name << " bnw " << i;
+    }
+}
+
+TEST(MDECKernels, Colour24) {
+    std::mt19937 gen(6);
+    auto& expected = getScalarKernels();
+    auto& actual = getKernels();
+    for (unsigned i = 0; i < 1000; i++) {
+        int blk[MACROBLOCK_SIZE];
+        fillMacroblock(blk, gen);
+        uint8_t expectedImage[768];
+        // The kernels must not write past the macroblock.
+        uint8_t actualImage[768 + 32];
+        memset(actualImage, 0xcc, sizeof(actualImage));
+        expected.rgb24(blk, expectedImage);
+        actual.rgb24(blk, actualImage);
+        ASSERT_EQ(memcmp(expectedImage, actualImage, sizeof(expectedImage)), 0) << actual.name << " rgb " << i;
+        expected.bnw24(blk, expectedImage);
+        actual.bnw24(blk, actualImage);
+        ASSERT_EQ(memcmp(expectedImage, actualImage, sizeof(expectedImage)), 0) << actual.name << " bnw " << i;
+        for (unsigned j = sizeof(expectedImage); j < sizeof(actualImage); j++) ASSERT_EQ(actualImage[j], 0xcc);
+    }
+}
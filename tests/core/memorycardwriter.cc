@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/memorycardwriter.h"
+
+#include <string.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+class MemoryCardWriterTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_path = std::filesystem::temp_directory_path() /
+                 ("mcdwriter-" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) + ".mcd");
+        std::filesystem::remove(m_path);
+        memset(m_card, 0, sizeof(m_card));
+    }
+    void TearDown() override { std::filesystem::remove(m_path); }
+
+    std::filesystem::path m_path;
+    char m_card[PCSX::MemoryCardWriter::c_cardSize];
+};
+
+}  // namespace
+
+TEST_F(MemoryCardWriterTest, WritesWholeCard) {
+    PCSX::MemoryCardWriter writer;
+    m_card[0] = 'M';
+    m_card[1] = 'C';
+    writer.write(m_path, m_card, {});
+    writer.flush();
+    EXPECT_EQ(readFile(m_path), std::string(m_card, sizeof(m_card)));
+    EXPECT_FALSE(std::filesystem::exists(m_path.string() + ".tmp"));
+}
+
+TEST_F(MemoryCardWriterTest, MergesDirtyFrames) {
+    PCSX::MemoryCardWriter writer(std::chrono::hours(1));
+    writer.write(m_path, m_card, {});
+    PCSX::MemoryCardWriter::Frames dirty;
+    m_card[3 * 128] = 1;
+    dirty.set(3);
+    writer.write(m_path, m_card, dirty);
+    // Frames not flagged as dirty keep what the writer had
+    m_card[5 * 128] = 2;
+    dirty.reset();
+    dirty.set(7);
+    writer.write(m_path, m_card, dirty);
+    // Nothing is written before the delay
+    EXPECT_FALSE(std::filesystem::exists(m_path));
+    writer.flush();
+    const auto contents = readFile(m_path);
+    ASSERT_EQ(contents.size(), sizeof(m_card));
+    EXPECT_EQ(contents[3 * 128], 1);
+    EXPECT_EQ(contents[5 * 128], 0);
+}
+
+TEST_F(MemoryCardWriterTest, KeepsHeader) {
+    std::string header(64, 'V');
+    {
+        std::ofstream out(m_path, std::ios::binary);
+        out << header << std::string(sizeof(m_card), '\0');
+    }
+    PCSX::MemoryCardWriter writer;
+    m_card[0] = 'M';
+    writer.write(m_path, m_card, {}, true);
+    writer.flush();
+    EXPECT_EQ(readFile(m_path), header + std::string(m_card, sizeof(m_card)));
+}
+
+TEST_F(MemoryCardWriterTest, FlushesOnClose) {
+    {
+        PCSX::MemoryCardWriter writer(std::chrono::hours(1));
+        m_card[42] = 'X';
+        writer.write(m_path, m_card, {});
+    }
+    EXPECT_EQ(readFile(m_path), std::string(m_card, sizeof(m_card)));
+}
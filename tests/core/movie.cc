@@ -0,0 +1,100 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/movie.h"
+
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+using PCSX::Movie;
+
+TEST(Movie, RoundTrip) {
+    std::string out;
+    Movie::encodeHeader(out, 2);
+    Movie::encodeKeyframe(out, 0, "first");
+    Movie::encodeInputs(out, Movie::inputs(0xffff, 0xfffe), 2);
+    Movie::encodeKeyframe(out, 2, "second");
+    Movie::encodeInputs(out, Movie::inputs(0xffef, 0xffff), 1);
+
+    Movie::Contents contents;
+    ASSERT_TRUE(Movie::parse(out, contents));
+    EXPECT_EQ(contents.keyframeInterval, 2);
+    ASSERT_EQ(contents.inputs.size(), 3);
+    EXPECT_EQ(contents.inputs[0], 0xfffeffff);
+    EXPECT_EQ(contents.inputs[1], 0xfffeffff);
+    EXPECT_EQ(contents.inputs[2], 0xffffffef);
+    ASSERT_EQ(contents.keyframes.size(), 2);
+    EXPECT_EQ(contents.keyframes[0].frame, 0);
+    EXPECT_EQ(contents.keyframes[0].state, "first");
+    EXPECT_EQ(contents.keyframes[1].frame, 2);
+    EXPECT_EQ(contents.keyframes[1].state, "second");
+}
+
+TEST(Movie, KeyframeFor) {
+    std::string out;
+    Movie::encodeHeader(out, 10);
+    Movie::encodeKeyframe(out, 0, "a");
+    Movie::encodeInputs(out, 0xffffffff, 10);
+    Movie::encodeKeyframe(out, 10, "b");
+    Movie::encodeInputs(out, 0xffffffff, 10);
+    Movie::encodeKeyframe(out, 20, "c");
+    Movie::encodeInputs(out, 0xffffffff, 5);
+
+    Movie::Contents contents;
+    ASSERT_TRUE(Movie::parse(out, contents));
+    EXPECT_EQ(contents.inputs.size(), 25);
+    EXPECT_EQ(contents.keyframeFor(0)->frame, 0);
+    EXPECT_EQ(contents.keyframeFor(9)->frame, 0);
+    EXPECT_EQ(contents.keyframeFor(10)->frame, 10);
+    EXPECT_EQ(contents.keyframeFor(19)->frame, 10);
+    EXPECT_EQ(contents.keyframeFor(24)->frame, 20);
+}
+
+TEST(Movie, Malformed) {
+    Movie::Contents contents;
+    EXPECT_FALSE(Movie::parse("", contents));
+    EXPECT_FALSE(Movie::parse("PSXMOVIX", contents));
+
+    std::string header;
+    Movie::encodeHeader(header, 600);
+    // A movie has to start with a keyframe.
+    EXPECT_FALSE(Movie::parse(header, contents));
+    std::string noKeyframe = header;
+    Movie::encodeInputs(noKeyframe, 0xffffffff, 1);
+    EXPECT_FALSE(Movie::parse(noKeyframe, contents));
+
+    // Keyframes have to sit where their frame starts.
+    std::string misplaced = header;
+    Movie::encodeKeyframe(misplaced, 0, "a");
+    Movie::encodeKeyframe(misplaced, 1, "b");
+    EXPECT_FALSE(Movie::parse(misplaced, contents));
+
+    std::string truncated = header;
+    Movie::encodeKeyframe(truncated, 0, "state");
+    Movie::encodeInputs(truncated, 0xffffffff, 1);
+    truncated.pop_back();
+    EXPECT_FALSE(Movie::parse(truncated, contents));
+
+    std::string empty = header;
+    Movie::encodeKeyframe(empty, 0, "state");
+    Movie::encodeInputs(empty, 0xffffffff, 0);
+    EXPECT_FALSE(Movie::parse(empty, contents));
+}
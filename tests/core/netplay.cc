@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/netplay.h"
+
+#include "gtest/gtest.h"
+
+using PCSX::Netplay;
+
+TEST(NetplayInputs, DelayedStart) {
+    Netplay::Inputs inputs;
+    inputs.reset(2);
+    EXPECT_EQ(inputs.confirmed(), 2);
+    EXPECT_EQ(inputs.local(0), 0xffff);
+    EXPECT_EQ(inputs.remote(0), 0xffff);
+    EXPECT_EQ(inputs.remote(1), 0xffff);
+    EXPECT_FALSE(inputs.takeRollback().has_value());
+
+    inputs.setLocal(2, 0xfffe);
+    EXPECT_EQ(inputs.local(2), 0xfffe);
+    EXPECT_EQ(inputs.local(3), 0xffff);
+}
+
+TEST(NetplayInputs, Ordering) {
+    Netplay::Inputs inputs;
+    inputs.reset(2);
+    EXPECT_FALSE(inputs.setRemote(3, 0x1234));
+    EXPECT_TRUE(inputs.setRemote(2, 0x1234));
+    EXPECT_FALSE(inputs.setRemote(2, 0x1234));
+    EXPECT_EQ(inputs.confirmed(), 3);
+    EXPECT_EQ(inputs.remote(2), 0x1234);
+}
+
+TEST(NetplayInputs, Prediction) {
+    Netplay::Inputs inputs;
+    inputs.reset(1);
+    EXPECT_TRUE(inputs.setRemote(1, 0xffef));
+    // The frames past the last known one get the last known input.
+    EXPECT_EQ(inputs.remote(2), 0xffef);
+    EXPECT_EQ(inputs.remote(3), 0xffef);
+    EXPECT_TRUE(inputs.setRemote(2, 0xffef));
+    EXPECT_FALSE(inputs.takeRollback().has_value());
+}
+
+TEST(NetplayInputs, Misprediction) {
+    Netplay::Inputs inputs;
+    inputs.reset(1);
+    for (uint32_t frame = 1; frame < 6; frame++) EXPECT_EQ(inputs.remote(frame), 0xffff);
+    EXPECT_TRUE(inputs.setRemote(1, 0xffff));
+    EXPECT_TRUE(inputs.setRemote(2, 0xfffd));
+    EXPECT_TRUE(inputs.setRemote(3, 0xfffb));
+    // Only the earliest wrong frame matters, as everything after it gets replayed.
+    auto rollback = inputs.takeRollback();
+    ASSERT_TRUE(rollback.has_value());
+    EXPECT_EQ(rollback.value(), 2);
+    EXPECT_FALSE(inputs.takeRollback().has_value());
+
+    // Replaying uses the actual inputs, and predicts again past them.
+    EXPECT_EQ(inputs.remote(2), 0xfffd);
+    EXPECT_EQ(inputs.remote(3), 0xfffb);
+    EXPECT_EQ(inputs.remote(4), 0xfffb);
+    EXPECT_TRUE(inputs.setRemote(4, 0xfffb));
+    EXPECT_FALSE(inputs.takeRollback().has_value());
+}
+
+TEST(NetplayInputs, Wraparound) {
+    Netplay::Inputs inputs;
+    inputs.reset(1);
+    for (uint32_t frame = 1; frame < 3 * Netplay::Inputs::HISTORY; frame++) {
+        inputs.setLocal(frame, uint16_t(frame));
+        inputs.remote(frame);
+        EXPECT_TRUE(inputs.setRemote(frame, uint16_t(frame)));
+        EXPECT_EQ(inputs.local(frame), uint16_t(frame));
+        EXPECT_EQ(inputs.remote(frame), uint16_t(frame));
+    }
+    EXPECT_EQ(inputs.local(1), 0xffff);
+}
@@ -0,0 +1,74 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "supportpsx/pixel-kernels.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+using namespace PCSX::PixelKernels;
+
+TEST(PixelKernels, RGB15Expansion) {
+    auto& kernels = getScalarKernels();
+    const uint16_t src[] = {0x0000, 0x7fff, 0x801f, 0x03e0, 0x7c00, 0x0421};
+    uint8_t dst[sizeof(src) / 2 * 4];
+    kernels.rgb15(src, dst, sizeof(src) / 2);
+    const uint8_t expected[] = {0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0xff,
+                                0x00, 0xff, 0x00, 0xff, 0x00, 0x00, 0xff, 0xff, 0x08, 0x08, 0x08, 0xff};
+    EXPECT_EQ(memcmp(dst, expected, sizeof(expected)), 0);
+}
+
+TEST(PixelKernels, RGB15) {
+    std::mt19937 gen(1);
+    auto& expected = getScalarKernels();
+    auto& actual = getKernels();
+    // Odd lengths and offsets, so that the vectorized loops get to hand tails over to the scalar ones.
+    for (unsigned count = 0; count < 80; count++) {
+        uint16_t src[81];
+        for (auto& p : src) p = gen();
+        uint8_t expectedImage[80 * 4];
+        uint8_t actualImage[80 * 4 + 32];
+        memset(actualImage, 0xcc, sizeof(actualImage));
+        expected.rgb15(src + 1, expectedImage, count);
+        actual.rgb15(src + 1, actualImage, count);
+        ASSERT_EQ(memcmp(expectedImage, actualImage, count * 4), 0) << actual.name << " count " << count;
+        for (unsigned j = count * 4; j < sizeof(actualImage); j++) ASSERT_EQ(actualImage[j], 0xcc);
+    }
+}
+
+TEST(PixelKernels, RGB24) {
+    std::mt19937 gen(2);
+    auto& expected = getScalarKernels();
+    auto& actual = getKernels();
+    for (unsigned count = 0; count < 80; count++) {
+        uint8_t src[80 * 3 + 1];
+        for (auto& p : src) p = gen();
+        uint8_t expectedImage[80 * 4];
+        uint8_t actualImage[80 * 4 + 32];
+        memset(actualImage, 0xcc, sizeof(actualImage));
+        expected.rgb24(src + 1, expectedImage, count);
+        actual.rgb24(src + 1, actualImage, count);
+        ASSERT_EQ(memcmp(expectedImage, actualImage, count * 4), 0) << actual.name << " count " << count;
+        for (unsigned j = count * 4; j < sizeof(actualImage); j++) ASSERT_EQ(actualImage[j], 0xcc);
+    }
+}
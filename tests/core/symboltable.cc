@@ -0,0 +1,107 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "supportpsx/symboltable.h"
+
+#include <map>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(SymbolTable, Lookups) {
+    PCSX::SymbolTable symbols;
+    symbols.insert(0x80010000, "main");
+    symbols.insert(0x80020000, "helper");
+    symbols.insert(0x80000000, "start");
+    EXPECT_EQ(symbols.size(), 3);
+
+    auto symbol = symbols.find(0x80010000);
+    ASSERT_NE(symbol, std::nullopt);
+    EXPECT_EQ(symbol->name, "main");
+    EXPECT_EQ(symbols.find(0x80010004), std::nullopt);
+
+    symbol = symbols.findContaining(0x80010004);
+    ASSERT_NE(symbol, std::nullopt);
+    EXPECT_EQ(symbol->address, 0x80010000);
+    EXPECT_EQ(symbol->name, "main");
+    EXPECT_EQ(symbols.findContaining(0x7fffffff), std::nullopt);
+    EXPECT_EQ(symbols.findContaining(0xffffffff)->name, "helper");
+
+    auto next = symbols.upperBound(0x80000000);
+    ASSERT_NE(next, symbols.end());
+    EXPECT_EQ((*next).name, "main");
+}
+
+TEST(SymbolTable, Edits) {
+    PCSX::SymbolTable symbols;
+    symbols.insert(0x100, "a");
+    symbols.insert(0x200, "b");
+    symbols.insert(0x300, "c");
+    symbols.insert(0x400, "d");
+    symbols.insert(0x200, "renamed");
+    symbols.erase(0x300);
+    EXPECT_EQ(symbols.size(), 3);
+    EXPECT_EQ(symbols.find(0x200)->name, "renamed");
+    EXPECT_EQ(symbols.find(0x300), std::nullopt);
+
+    symbols.eraseRange(0x150, 0x400);
+    EXPECT_EQ(symbols.size(), 2);
+    EXPECT_EQ(symbols.find(0x100)->name, "a");
+    EXPECT_EQ(symbols.find(0x400)->name, "d");
+
+    symbols.clear();
+    EXPECT_TRUE(symbols.empty());
+}
+
+// Random edits, checked against the std::map this replaced.
+TEST(SymbolTable, Stress) {
+    PCSX::SymbolTable symbols;
+    std::map<uint32_t, std::string> reference;
+    std::mt19937 rng(42);
+    for (unsigned i = 0; i < 20000; i++) {
+        const uint32_t address = (rng() % 2048) * 4;
+        switch (rng() % 8) {
+            case 0:
+                symbols.erase(address);
+                reference.erase(address);
+                break;
+            case 1: {
+                const uint32_t high = address + (rng() % 64) * 4;
+                symbols.eraseRange(address, high);
+                reference.erase(reference.lower_bound(address), reference.lower_bound(high));
+            } break;
+            case 2:
+                EXPECT_EQ(symbols.size(), reference.size());
+                break;
+            default: {
+                const std::string name = "sym" + std::to_string(i);
+                symbols.insert(address, name);
+                reference[address] = name;
+            } break;
+        }
+    }
+    ASSERT_EQ(symbols.size(), reference.size());
+    auto it = symbols.begin();
+    for (const auto& [address, name] : reference) {
+        EXPECT_EQ((*it).address, address);
+        EXPECT_EQ((*it).name, name);
+        ++it;
+    }
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <vector>
+
+#include "core/gpu.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+struct Rect {
+    int x, y, w, h;
+    bool operator==(const Rect &other) const {
+        return x == other.x && y == other.y && w == other.w && h == other.h;
+    }
+};
+
+std::vector<Rect> collect(const PCSX::GPU::VRAMDirtyTiles &tiles) {
+    std::vector<Rect> rects;
+    tiles.forEachRect([&rects](int x, int y, int w, int h) { rects.push_back({x, y, w, h}); });
+    return rects;
+}
+
+}  // namespace
+
+TEST(VRAMDirtyTiles, StartsEmpty) {
+    PCSX::GPU::VRAMDirtyTiles tiles;
+    EXPECT_TRUE(tiles.empty());
+    EXPECT_TRUE(collect(tiles).empty());
+}
+
+TEST(VRAMDirtyTiles, RoundsToTiles) {
+    PCSX::GPU::VRAMDirtyTiles tiles;
+    tiles.mark(40, 20, 30, 1);
+    EXPECT_FALSE(tiles.empty());
+    EXPECT_EQ(collect(tiles), (std::vector<Rect>{{32, 16, 64, 16}}));
+    tiles.clear();
+    EXPECT_TRUE(tiles.empty());
+}
+
+TEST(VRAMDirtyTiles, MergesRows) {
+    PCSX::GPU::VRAMDirtyTiles tiles;
+    tiles.mark(0, 0, 320, 240);
+    EXPECT_EQ(collect(tiles), (std::vector<Rect>{{0, 0, 320, 240}}));
+    tiles.markAll();
+    EXPECT_EQ(collect(tiles), (std::vector<Rect>{{0, 0, 1024, 512}}));
+}
+
+TEST(VRAMDirtyTiles, SplitsDisjointAreas) {
+    PCSX::GPU::VRAMDirtyTiles tiles;
+    tiles.mark(0, 0, 32, 32);
+    tiles.mark(0, 16, 64, 16);
+    tiles.mark(512, 0, 32, 16);
+    EXPECT_EQ(collect(tiles), (std::vector<Rect>{{0, 0, 32, 32}, {512, 0, 32, 16}, {32, 16, 32, 16}}));
+}
+
+TEST(VRAMDirtyTiles, WrapsAround) {
+    PCSX::GPU::VRAMDirtyTiles tiles;
+    tiles.mark(1000, 500, 48, 24);
+    EXPECT_EQ(collect(tiles), (std::vector<Rect>{{0, 0, 32, 16}, {992, 0, 32, 16}, {0, 496, 32, 16},
+                                                 {992, 496, 32, 16}}));
+}
+
+TEST(VRAMDirtyTiles, IgnoresEmptyAreas) {
+    PCSX::GPU::VRAMDirtyTiles tiles;
+    tiles.mark(100, 100, 0, 10);
+    tiles.mark(100, 100, 10, -1);
+    EXPECT_TRUE(tiles.empty());
+}
+
+TEST(VRAMDirtyTiles, IntersectsAndCovers) {
+    PCSX::GPU::VRAMDirtyTiles tiles;
+    tiles.mark(0, 0, 320, 240);
+    EXPECT_TRUE(tiles.intersects(300, 200, 100, 100));
+    EXPECT_FALSE(tiles.covers(300, 200, 100, 100));
+    EXPECT_TRUE(tiles.covers(10, 10, 300, 200));
+    EXPECT_FALSE(tiles.intersects(320, 0, 64, 64));
+    EXPECT_FALSE(tiles.intersects(0, 240, 64, 64));
+    EXPECT_FALSE(tiles.covers(10, 10, 0, 10));
+}
+
+TEST(VRAMDirtyTiles, CombinesTrackers) {
+    PCSX::GPU::VRAMDirtyTiles display, readback;
+    display.mark(0, 0, 320, 240);
+    display.mark(0, 256, 320, 240);
+    readback.mark(0, 256, 64, 32);
+    display.remove(readback);
+    EXPECT_TRUE(display.covers(0, 0, 320, 240));
+    EXPECT_FALSE(display.intersects(0, 256, 64, 32));
+    EXPECT_TRUE(display.covers(64, 288, 256, 208));
+    display |= readback;
+    EXPECT_TRUE(display.covers(0, 256, 320, 240));
+}
@@ -0,0 +1,95 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/gpu.h"
+#include "gtest/gtest.h"
+
+using Cache = PCSX::GPU::PGXPVertexCache;
+
+TEST(PGXPVertexCache, StartsEmpty) {
+    Cache cache;
+    EXPECT_EQ(cache.lookup(0, 0), nullptr);
+    EXPECT_EQ(cache.lookup(-12, 34), nullptr);
+}
+
+TEST(PGXPVertexCache, FindsVertices) {
+    Cache cache;
+    cache.insert(10, 20, {10.25f, 20.5f, 3.0f});
+    cache.insert(-10, -20, {-10.75f, -19.5f, 4.0f});
+    const auto *vertex = cache.lookup(10, 20);
+    ASSERT_NE(vertex, nullptr);
+    EXPECT_EQ(vertex->x, 10.25f);
+    EXPECT_EQ(vertex->y, 20.5f);
+    EXPECT_EQ(vertex->z, 3.0f);
+    vertex = cache.lookup(-10, -20);
+    ASSERT_NE(vertex, nullptr);
+    EXPECT_EQ(vertex->x, -10.75f);
+    EXPECT_EQ(cache.lookup(20, 10), nullptr);
+}
+
+TEST(PGXPVertexCache, AmbiguousVertices) {
+    Cache cache;
+    cache.insert(5, 5, {5.1f, 5.2f, 1.0f});
+    cache.insert(5, 5, {5.1f, 5.2f, 1.0f});
+    EXPECT_NE(cache.lookup(5, 5), nullptr);
+    cache.insert(5, 5, {4.9f, 5.2f, 1.0f});
+    EXPECT_EQ(cache.lookup(5, 5), nullptr);
+}
+
+TEST(PGXPVertexCache, KeepsPreviousFrame) {
+    Cache cache;
+    cache.insert(1, 2, {1.5f, 2.5f, 1.0f});
+    cache.newFrame();
+    ASSERT_NE(cache.lookup(1, 2), nullptr);
+    EXPECT_EQ(cache.lookup(1, 2)->x, 1.5f);
+    // The current frame takes precedence over the previous one
+    cache.insert(1, 2, {0.5f, 2.5f, 1.0f});
+    EXPECT_EQ(cache.lookup(1, 2)->x, 0.5f);
+    cache.newFrame();
+    EXPECT_EQ(cache.lookup(1, 2)->x, 0.5f);
+    cache.newFrame();
+    EXPECT_EQ(cache.lookup(1, 2), nullptr);
+}
+
+TEST(PGXPVertexCache, Clear) {
+    Cache cache;
+    cache.insert(1, 2, {1.5f, 2.5f, 1.0f});
+    cache.newFrame();
+    cache.insert(3, 4, {3.5f, 4.5f, 1.0f});
+    cache.clear();
+    EXPECT_EQ(cache.lookup(1, 2), nullptr);
+    EXPECT_EQ(cache.lookup(3, 4), nullptr);
+}
+
+TEST(PGXPVertexCache, ManyVertices) {
+    Cache cache;
+    // A lot of vertices, most of them colliding in the table, all have to be found back
+    for (int i = 0; i < 4000; i++) cache.insert(i % 640, i / 640, {float(i), 0.0f, 1.0f});
+    for (int i = 0; i < 4000; i++) {
+        const auto *vertex = cache.lookup(i % 640, i / 640);
+        ASSERT_NE(vertex, nullptr);
+        EXPECT_EQ(vertex->x, float(i));
+    }
+    // Once half full, new vertices get dropped rather than making the probes slower
+    for (int i = 4000; i < 10000; i++) cache.insert(i % 640, i / 640, {float(i), 0.0f, 1.0f});
+    EXPECT_EQ(cache.lookup(9999 % 640, 9999 / 640), nullptr);
+    cache.newFrame();
+    cache.insert(9999 % 640, 9999 / 640, {1.0f, 0.0f, 1.0f});
+    EXPECT_NE(cache.lookup(9999 % 640, 9999 / 640), nullptr);
+}
@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+#include "gpu/soft/spans.h"
+
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using PCSX::GPU;
+using PCSX::SoftGPU::Spans::Blend;
+
+const GPU::BlendFunction c_functions[] = {
+    GPU::BlendFunction::HalfBackAndHalfFront,
+    GPU::BlendFunction::FullBackAndFullFront,
+    GPU::BlendFunction::FullBackSubFullFront,
+    GPU::BlendFunction::FullBackAndQuarterFront,
+};
+
+// Runs "test" over every combination of blending state
+template <typename T>
+void forEachBlend(T test) {
+    for (auto function : c_functions) {
+        for (int flags = 0; flags < 8; flags++) {
+            Blend blend;
+            blend.function = function;
+            blend.semiTrans = (flags & 1) != 0;
+            blend.checkMask = (flags & 2) != 0;
+            blend.setMask = (flags & 4) ? 0x8000 : 0;
+            test(blend);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(SoftGPUSpans, Saturation) {
+    const auto& scalar = PCSX::SoftGPU::Spans::getScalarKernels();
+    Blend blend;
+    blend.semiTrans = true;
+
+    uint16_t pixel = 0x7c1f;
+    blend.function = GPU::BlendFunction::FullBackAndFullFront;
+    scalar.fill(&pixel, 1, 0x0c21, blend);
+    EXPECT_EQ(pixel, 0x7c3f);
+
+    pixel = 0x0421;
+    blend.function = GPU::BlendFunction::FullBackSubFullFront;
+    scalar.fill(&pixel, 1, 0x0c01, blend);
+    EXPECT_EQ(pixel, 0x0020);
+
+    pixel = 0x8000;
+    blend.checkMask = true;
+    scalar.fill(&pixel, 1, 0x1234, blend);
+    EXPECT_EQ(pixel, 0x8000);
+}
+
+TEST(SoftGPUSpans, Fill) {
+    const auto& scalar = PCSX::SoftGPU::Spans::getScalarKernels();
+    const auto& kernels = PCSX::SoftGPU::Spans::getKernels();
+
+    std::mt19937 gen(0x5a5a);
+    std::uniform_int_distribution<uint32_t> dist16(0, 0xffff);
+
+    forEachBlend([&](const Blend& blend) {
+        // Odd lengths and offsets exercise the unaligned heads and the scalar tails
+        for (unsigned count = 0; count < 70; count++) {
+            std::vector<uint16_t> expected(count + 3);
+            for (auto& p : expected) p = dist16(gen);
+            auto actual = expected;
+            const uint16_t color = dist16(gen);
+            scalar.fill(expected.data() + 3, count, color, blend);
+            kernels.fill(actual.data() + 3, count, color, blend);
+            EXPECT_EQ(expected, actual) << kernels.name;
+        }
+    });
+}
+
+TEST(SoftGPUSpans, Blend) {
+    const auto& scalar = PCSX::SoftGPU::Spans::getScalarKernels();
+    const auto& kernels = PCSX::SoftGPU::Spans::getKernels();
+
+    std::mt19937 gen(0xa5a5);
+    std::uniform_int_distribution<uint32_t> dist16(0, 0xffff);
+
+    forEachBlend([&](const Blend& blend) {
+        for (unsigned count = 0; count < 70; count++) {
+            std::vector<uint16_t> src(count);
+            std::vector<uint16_t> expected(count + 1);
+            for (auto& p : src) p = dist16(gen);
+            for (auto& p : expected) p = dist16(gen);
+            auto actual = expected;
+            scalar.blend(expected.data() + 1, src.data(), count, blend);
+            kernels.blend(actual.data() + 1, src.data(), count, blend);
+            EXPECT_EQ(expected, actual) << kernels.name;
+        }
+    });
+}
@@ -147,3 +147,37 @@ function TestAdpcm:test_simpleXA()
     end
     file:close()
 end
+
+function TestAdpcm:test_batchSPU()
+    local sampleRate = 44100
+    local duration = 1
+    local samples, size = generateDTMF1(sampleRate, duration)
+    local blockCount = size / 28
+    local e = PCSX.Adpcm.NewEncoder()
+    e:reset 'Normal'
+    local ptr = ffi.cast('int16_t *', samples)
+    local expected = ffi.new('uint8_t[?]', blockCount * 16)
+    for i = 0, blockCount - 1 do
+        e:processSPUBlock(ptr + i * 28, expected + i * 16, 'LoopBody')
+    end
+    e:reset 'Normal'
+    local actual = e:processSPUBlocks(ptr, blockCount, 'LoopBody')
+    lu.assertEquals(ffi.string(actual.data, blockCount * 16), ffi.string(expected, blockCount * 16))
+end
+
+function TestAdpcm:test_batchXA()
+    local sampleRate = 37800
+    local duration = 2
+    local samples, size = generateDTMFStereo(sampleRate, duration)
+    local blockCount = math.floor(size / 112)
+    local e = PCSX.Adpcm.NewEncoder()
+    e:reset 'XA'
+    local ptr = ffi.cast('int16_t *', samples)
+    local expected = ffi.new('uint8_t[?]', blockCount * 128)
+    for i = 0, blockCount - 1 do
+        e:processXABlock(ptr + i * 112 * 2, expected + i * 128, 'XAFourBits', 2)
+    end
+    e:reset 'XA'
+    local actual = e:processXABlocks(ptr, blockCount, 'XAFourBits', 2)
+    lu.assertEquals(ffi.string(actual.data, blockCount * 128), ffi.string(expected, blockCount * 128))
+end
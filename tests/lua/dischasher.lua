@@ -0,0 +1,85 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+local lu = require 'luaunit'
+
+TestDiscHasher = {}
+
+local sectorSize = 2352
+local audioSectors = 16
+
+local function writeFile(name, data)
+    local f = Support.File.open(name, 'TRUNCATE')
+    f:write(data)
+    f:close()
+end
+
+-- A sawtooth, so that the decoded audio is easy to tell apart from silence.
+local function makePCM()
+    local sector = {}
+    for i = 0, sectorSize - 1 do sector[#sector + 1] = string.char((i * 7) % 256) end
+    return string.rep(table.concat(sector), audioSectors)
+end
+
+local function u16(n) return string.char(n % 256, math.floor(n / 256) % 256) end
+local function u32(n) return u16(n % 65536) .. u16(math.floor(n / 65536)) end
+
+local function makeWAV(pcm)
+    return 'RIFF' .. u32(36 + #pcm) .. 'WAVE' .. 'fmt ' .. u32(16) .. u16(1) .. u16(2) .. u32(44100) .. u32(44100 * 4)
+        .. u16(4) .. u16(16) .. 'data' .. u32(#pcm) .. pcm
+end
+
+local function makeCue(name, audioFile, audioType)
+    writeFile(name, 'FILE "dischasher-data.bin" BINARY\n  TRACK 01 MODE2/2352\n    INDEX 01 00:00:00\n'
+        .. 'FILE "' .. audioFile .. '" ' .. audioType .. '\n  TRACK 02 AUDIO\n    INDEX 01 00:00:00\n')
+end
+
+local function hash(cue)
+    local iso = PCSX.openIso(cue)
+    lu.assertFalse(iso:failed())
+    local hasher = iso:startHashing()
+    local co = coroutine.running()
+    while not hasher:done() do
+        PCSX.nextTick(function() coroutine.resume(co) end)
+        coroutine.yield()
+    end
+    lu.assertFalse(hasher:failed())
+    lu.assertEquals(hasher:trackCount(), 2)
+    return hasher
+end
+
+-- The compressed audio track gets decoded from the hashing thread, which needs to see the emulator.
+function TestDiscHasher:test_compressedAudio()
+    local pcm = makePCM()
+    writeFile('dischasher-data.bin', string.rep('\0', sectorSize * 16))
+    writeFile('dischasher-audio.bin', pcm)
+    writeFile('dischasher-audio.wav', makeWAV(pcm))
+    makeCue('dischasher-raw.cue', 'dischasher-audio.bin', 'BINARY')
+    makeCue('dischasher-wav.cue', 'dischasher-audio.wav', 'WAVE')
+
+    local raw = hash('dischasher-raw.cue')
+    local wav = hash('dischasher-wav.cue')
+    lu.assertEquals(wav:crc32(2), raw:crc32(2))
+    lu.assertEquals(wav:md5(2), raw:md5(2))
+    lu.assertEquals(wav:md5(), raw:md5())
+
+    for _, name in ipairs { 'dischasher-data.bin', 'dischasher-audio.bin', 'dischasher-audio.wav', 'dischasher-raw.cue',
+        'dischasher-wav.cue', 'dischasher-raw.cue.hashes', 'dischasher-wav.cue.hashes' } do
+        os.remove(name)
+    end
+end
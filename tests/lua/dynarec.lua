@@ -0,0 +1,57 @@
+--   Copyright (C) 2026 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+local lu = require 'luaunit'
+local ffi = require 'ffi'
+
+TestDynarec = {}
+
+local first = 0x80100000
+local second = 0x80100100
+
+local function jump(target) return 0x08000000 + bit.band(bit.rshift(target, 2), 0x3ffffff) end
+
+-- Two blocks jumping to each other, forever. Both of them get hot, and promoted, quickly.
+local function writeLoop()
+    local ram = ffi.cast('uint32_t*', PCSX.getMemPtr())
+    local function emit(address, code)
+        local base = bit.rshift(bit.band(address, 0x1fffff), 2)
+        for i, word in ipairs(code) do ram[base + i - 1] = word end
+    end
+    emit(first, { 0x25080001, jump(second), 0 })   -- addiu $t0, $t0, 1; j second; nop
+    emit(second, { 0x25290001, jump(first), 0 })   -- addiu $t1, $t1, 1; j first; nop
+    PCSX.invalidateCache()
+end
+
+function TestDynarec:test_promotedLoopStaysLinked()
+    writeLoop()
+    local promoted = PCSX.getBlocksPromoted()
+    PCSX.getRegisters().pc = first
+    PCSX.resumeEmulator()
+    local co = coroutine.running()
+    local ticks = 0
+    while PCSX.getBlocksPromoted() < promoted + 2 and ticks < 600 do
+        PCSX.nextTick(function() coroutine.resume(co) end)
+        coroutine.yield()
+        ticks = ticks + 1
+    end
+    PCSX.pauseEmulator()
+
+    lu.assertTrue(PCSX.getBlocksPromoted() >= promoted + 2)
+    lu.assertTrue(PCSX.isBlockLinked(first, second))
+    lu.assertTrue(PCSX.isBlockLinked(second, first))
+end
@@ -28,3 +28,40 @@ function TestFile:test_buffer()
     local r = buf:read(buf:size())
     lu.assertEquals(tostring(r), 'hello world')
 end
+
+function TestFile:test_viewAt()
+    local buf = Support.File.buffer()
+    buf:write('hello world')
+    local view = buf:viewAt(5, 6)
+    lu.assertEquals(tostring(view), 'world')
+    buf:writeAt('W', 1, 6)
+    lu.assertEquals(tostring(view), 'World')
+    local reused = buf:viewAt(5, 0, view)
+    lu.assertIs(reused, view)
+    lu.assertEquals(tostring(view), 'hello')
+    lu.assertEquals(#buf:viewAt(100, 8), 3)
+    lu.assertEquals(#buf:viewAt(4, 20), 0)
+end
+
+function TestFile:test_zCompressor()
+    local compressor = Support.File.zCompressor { level = 1, format = 'GZIP' }
+    for i = 1, 3 do
+        local data = string.rep('frame ' .. i .. ' ', 1000)
+        local compressed = compressor:compress(data)
+        lu.assertTrue(compressed:size() < string.len(data))
+        compressed:rSeek(0)
+        local reader = Support.File.zReader(compressed)
+        lu.assertEquals(tostring(reader:read(string.len(data))), data)
+    end
+end
+
+function TestFile:test_zWriter()
+    local compressed = Support.File.buffer()
+    local writer = Support.File.zWriter(compressed, 'GZIP')
+    writer:write('hello ')
+    writer:write('world')
+    writer:close()
+    compressed:rSeek(0)
+    local reader = Support.File.zReader(compressed)
+    lu.assertEquals(tostring(reader:read(11)), 'hello world')
+end
@@ -0,0 +1,40 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <filesystem>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "main/main.h"
+
+// Runs the cpu test once to record its block boundaries, then once more to check it against them. A run
+// that diverges from the recording exits with an error. Comparing the interpreter against itself makes
+// sure the emulation is deterministic, which the comparisons between the CPU cores rely on.
+TEST(BlockTrace, Interpreter) {
+    const std::string trace = (std::filesystem::temp_directory_path() / "pcsx-redux-cpu-blocks.trace").string();
+    MainInvoker recorder("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-interpreter",
+                         "-blocktrace-record", trace.c_str(), "-loadexe", "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(recorder.invoke(), 0);
+    ASSERT_TRUE(std::filesystem::exists(trace));
+
+    MainInvoker verifier("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-interpreter",
+                         "-blocktrace-verify", trace.c_str(), "-loadexe", "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(verifier.invoke(), 0);
+    std::filesystem::remove(trace);
+}
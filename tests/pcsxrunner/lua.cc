@@ -68,3 +68,7 @@ TEST(LuaFile, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.file"), 0); }
 TEST(LuaFile, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.file"), 0); }
 TEST(LuaAdpcm, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.adpcm"), 0); }
 TEST(LuaAdpcm, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.adpcm"), 0); }
+TEST(LuaDiscHasher, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.dischasher"), 0); }
+TEST(LuaDiscHasher, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.dischasher"), 0); }
+// Looks at the dynarec's block links, which the interpreter doesn't have.
+TEST(LuaDynarec, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.dynarec"), 0); }
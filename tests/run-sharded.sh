@@ -0,0 +1,47 @@
+#!/bin/sh
+
+# Runs the test binary as several processes in parallel, each with its own shard of the tests, using the
+# sharding built into googletest. Each shard writes its log and its JSON report under the output directory,
+# and the tests get listed at the end, slowest first, along with the logs of the shards which failed.
+#
+# Usage: run-sharded.sh <tests binary> [shards] [output directory]
+
+TESTS=$1
+SHARDS=${2:-4}
+OUT=${3:-test-shards}
+
+if [ -z "$TESTS" ]; then
+  echo "Usage: $0 <tests binary> [shards] [output directory]"
+  exit 1
+fi
+
+mkdir -p "$OUT"
+rm -f "$OUT"/shard-*
+
+PIDS=""
+i=0
+while [ $i -lt "$SHARDS" ]; do
+  GTEST_TOTAL_SHARDS=$SHARDS GTEST_SHARD_INDEX=$i "$TESTS" --gtest_output=json:"$OUT/shard-$i.json" > "$OUT/shard-$i.log" 2>&1 &
+  PIDS="$PIDS $!"
+  i=$((i + 1))
+done
+
+FAILED=""
+i=0
+for PID in $PIDS; do
+  if ! wait "$PID"; then
+    FAILED="$FAILED $i"
+  fi
+  i=$((i + 1))
+done
+
+echo "Tests, slowest first:"
+grep -h -E '^\[ +(OK|FAILED) +\] .* \([0-9]+ ms\)$' "$OUT"/shard-*.log | sed -E 's/^(.*) \(([0-9]+) ms\)$/\2 ms \1/' | sort -n -r
+
+for i in $FAILED; do
+  echo
+  echo "Shard $i failed:"
+  cat "$OUT/shard-$i.log"
+done
+
+[ -z "$FAILED" ]
@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/eventbus.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+struct Ping {
+    int value;
+};
+struct Pong {
+    int value;
+};
+
+}  // namespace
+
+TEST(EventBus, Dispatch) {
+    auto bus = std::make_shared<PCSX::EventBus::EventBus>();
+    int pings = 0, pongs = 0;
+    PCSX::EventBus::Listener listener(bus);
+    listener.listen<Ping>([&pings](const auto& event) { pings += event.value; });
+    listener.listen<Ping>([&pings](const auto& event) { pings += event.value * 10; });
+    listener.listen<Pong>([&pongs](auto event) { pongs += event.value; });
+    bus->signal(Ping{1});
+    bus->signal(Pong{2});
+    EXPECT_EQ(pings, 11);
+    EXPECT_EQ(pongs, 2);
+
+    {
+        PCSX::EventBus::Listener other(bus);
+        other.listen<Pong>([&pongs](const auto& event) { pongs += 100; });
+        bus->signal(Pong{2});
+        EXPECT_EQ(pongs, 104);
+    }
+    bus->signal(Pong{2});
+    EXPECT_EQ(pongs, 106);
+}
+
+TEST(EventBus, LargeCallable) {
+    auto bus = std::make_shared<PCSX::EventBus::EventBus>();
+    int64_t total = 0;
+    int64_t weights[16];
+    for (unsigned i = 0; i < 16; i++) weights[i] = i;
+    PCSX::EventBus::Listener listener(bus);
+    // Too big to be stored inline, so it goes to the heap instead.
+    listener.listen<Ping>([&total, weights](const auto& event) mutable {
+        for (auto w : weights) total += w * event.value;
+        weights[0]++;
+    });
+    bus->signal(Ping{1});
+    bus->signal(Ping{1});
+    EXPECT_EQ(total, 120 + 121);
+}
+
+TEST(EventBus, ChangesWhileDispatching) {
+    auto bus = std::make_shared<PCSX::EventBus::EventBus>();
+    int calls = 0, late = 0;
+    std::unique_ptr<PCSX::EventBus::Listener> self(new PCSX::EventBus::Listener(bus));
+    PCSX::EventBus::Listener adder(bus);
+    std::vector<std::unique_ptr<PCSX::EventBus::Listener>> added;
+    // A listener that removes itself, and one that adds more listeners to the same event.
+    self->listen<Ping>([&calls, &self](const auto& event) {
+        calls++;
+        self.reset();
+    });
+    adder.listen<Ping>([&](const auto& event) {
+        added.emplace_back(new PCSX::EventBus::Listener(bus));
+        added.back()->listen<Ping>([&late](const auto& event) { late++; });
+    });
+    bus->signal(Ping{0});
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(late, 0);
+    bus->signal(Ping{0});
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(late, 1);
+    EXPECT_EQ(added.size(), 2);
+}
+
+// Every listener sees every signal, in the order they got sent. Timing the dispatch is up to
+// bench/support/containers.cc.
+TEST(EventBus, ManyListeners) {
+    constexpr unsigned listeners = 8;
+    constexpr unsigned signals = 1000;
+    auto bus = std::make_shared<PCSX::EventBus::EventBus>();
+    PCSX::EventBus::Listener listener(bus);
+    std::vector<std::vector<int>> received(listeners);
+    for (unsigned i = 0; i < listeners; i++) {
+        listener.listen<Ping>([&received, i](const auto& event) { received[i].push_back(event.value); });
+    }
+    for (unsigned i = 0; i < signals; i++) bus->signal(Ping{int(i)});
+    for (auto& values : received) {
+        ASSERT_EQ(values.size(), signals);
+        for (unsigned i = 0; i < signals; i++) EXPECT_EQ(values[i], int(i));
+    }
+}
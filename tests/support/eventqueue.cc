@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/eventqueue.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(EventQueue, Basic) {
+    PCSX::EventQueue<8> queue;
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.nextDeadline(), PCSX::EventQueue<8>::NEVER);
+    EXPECT_EQ(queue.popDue(1000), -1);
+
+    queue.schedule(3, 300);
+    queue.schedule(1, 100);
+    queue.schedule(5, 200);
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.nextDeadline(), 100);
+    EXPECT_TRUE(queue.scheduled(5));
+    EXPECT_FALSE(queue.scheduled(4));
+
+    EXPECT_EQ(queue.popDue(99), -1);
+    EXPECT_EQ(queue.popDue(100), 1);
+    EXPECT_FALSE(queue.scheduled(1));
+    EXPECT_EQ(queue.popDue(250), 5);
+    EXPECT_EQ(queue.popDue(250), -1);
+    EXPECT_EQ(queue.nextDeadline(), 300);
+}
+
+TEST(EventQueue, Reschedule) {
+    PCSX::EventQueue<8> queue;
+
+    queue.schedule(0, 100);
+    queue.schedule(1, 200);
+    queue.schedule(2, 300);
+    queue.schedule(0, 400);
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.nextDeadline(), 200);
+    queue.schedule(2, 50);
+    EXPECT_EQ(queue.nextDeadline(), 50);
+    queue.cancel(2);
+    queue.cancel(2);
+    EXPECT_EQ(queue.size(), 2);
+    EXPECT_EQ(queue.popDue(1000), 1);
+    EXPECT_EQ(queue.popDue(1000), 0);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(EventQueue, Ties) {
+    PCSX::EventQueue<8> queue;
+
+    queue.schedule(6, 100);
+    queue.schedule(2, 100);
+    queue.schedule(4, 100);
+    EXPECT_EQ(queue.popDue(100), 2);
+    EXPECT_EQ(queue.popDue(100), 4);
+    EXPECT_EQ(queue.popDue(100), 6);
+}
+
+TEST(EventQueue, Random) {
+    constexpr unsigned N = 15;
+    PCSX::EventQueue<N> queue;
+    std::vector<uint64_t> deadlines(N, PCSX::EventQueue<N>::NEVER);
+    std::mt19937 gen(1234);
+
+    for (unsigned i = 0; i < 10000; i++) {
+        const unsigned id = gen() % N;
+        switch (gen() % 4) {
+            case 0:
+                queue.cancel(id);
+                deadlines[id] = PCSX::EventQueue<N>::NEVER;
+                break;
+            case 1: {
+                const uint64_t now = gen() % 1000;
+                const int popped = queue.popDue(now);
+                auto lowest = std::min_element(deadlines.begin(), deadlines.end());
+                if (*lowest > now) {
+                    EXPECT_EQ(popped, -1);
+                } else {
+                    ASSERT_EQ(popped, lowest - deadlines.begin());
+                    *lowest = PCSX::EventQueue<N>::NEVER;
+                }
+                break;
+            }
+            default:
+                deadlines[id] = gen() % 1000;
+                queue.schedule(id, deadlines[id]);
+                break;
+        }
+        ASSERT_EQ(queue.nextDeadline(), *std::min_element(deadlines.begin(), deadlines.end()));
+        for (unsigned j = 0; j < N; j++) {
+            ASSERT_EQ(queue.scheduled(j), deadlines[j] != PCSX::EventQueue<N>::NEVER);
+        }
+    }
+}
@@ -20,8 +20,13 @@
 #include "support/hashtable.h"
 
 #include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "support/flathashmap.h"
 
 struct HashElement;
 typedef PCSX::Intrusive::HashTable<int, HashElement> HashTableType;
@@ -202,3 +207,113 @@ TEST(FlawedHashTable, DeleteMany) {
     hashtab.destroyAll();
     EXPECT_TRUE(hashtab.empty());
 }
+
+TEST(FlatHashMap, InsertMany) {
+    PCSX::FlatHashMap<uint32_t, std::string> map;
+    EXPECT_TRUE(map.empty());
+    for (uint32_t i = 0; i < 1000; i++) {
+        auto [it, inserted] = map.try_emplace(i * 4, std::to_string(i));
+        EXPECT_TRUE(inserted);
+    }
+    EXPECT_EQ(map.size(), 1000);
+    EXPECT_FALSE(map.try_emplace(8, "nope").second);
+    for (uint32_t i = 0; i < 1000; i++) {
+        auto p = map.find(i * 4);
+        ASSERT_NE(p, map.end());
+        EXPECT_EQ(p->second, std::to_string(i));
+        EXPECT_FALSE(map.contains(i * 4 + 1));
+    }
+    map[8] = "eight";
+    EXPECT_EQ(map.find(8)->second, "eight");
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(8), map.end());
+}
+
+TEST(FlatHashMap, EraseWhileIterating) {
+    PCSX::FlatHashMap<int, int> map;
+    for (int i = 0; i < 64; i++) map[i] = i;
+    for (auto it = map.begin(); it != map.end();) {
+        if (it->first & 1) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    EXPECT_EQ(map.size(), 32);
+    uint64_t seen = 0;
+    for (const auto& [key, value] : map) {
+        EXPECT_EQ(key, value);
+        seen |= 1ULL << key;
+    }
+    EXPECT_EQ(seen, 0x5555555555555555ULL);
+}
+
+// Random operations, checked against std::unordered_map, to go through tombstones and rehashes.
+TEST(FlatHashMap, Stress) {
+    PCSX::FlatHashMap<uint32_t, uint32_t> map;
+    std::unordered_map<uint32_t, uint32_t> reference;
+    std::mt19937 rng(42);
+    for (unsigned i = 0; i < 200000; i++) {
+        const uint32_t key = rng() % 4096;
+        if (rng() & 1) {
+            map[key] = i;
+            reference[key] = i;
+        } else {
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+        }
+    }
+    EXPECT_EQ(map.size(), reference.size());
+    for (const auto& [key, value] : reference) {
+        auto p = map.find(key);
+        ASSERT_NE(p, map.end());
+        EXPECT_EQ(p->second, value);
+    }
+}
+
+namespace {
+
+struct LookupElement;
+typedef PCSX::Intrusive::HashTable<uint32_t, LookupElement> LookupHashTable;
+struct LookupElement : public LookupHashTable::Node {
+    uint32_t value = 0;
+};
+
+}  // namespace
+
+// Both maps need to agree on the same set of code addresses. Timing these lookups is up to
+// bench/support/containers.cc.
+TEST(FlatHashMap, MatchesHashTable) {
+    constexpr unsigned count = 100000;
+    std::vector<uint32_t> keys;
+    std::mt19937 rng(1);
+    for (unsigned i = 0; i < count; i++) keys.push_back(0x80000000 | (rng() & 0x1ffffc));
+
+    LookupHashTable hashtab;
+    PCSX::FlatHashMap<uint32_t, uint32_t> flat;
+    for (auto key : keys) {
+        if (hashtab.find(key) == hashtab.end()) {
+            auto* element = new LookupElement();
+            element->value = key;
+            hashtab.insert(key, element);
+        }
+        flat[key] = key;
+    }
+    EXPECT_EQ(flat.size(), hashtab.size());
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    for (auto key : keys) {
+        auto intrusive = hashtab.find(key);
+        auto open = flat.find(key);
+        ASSERT_NE(intrusive, hashtab.end());
+        ASSERT_NE(open, flat.end());
+        EXPECT_EQ(intrusive->value, key);
+        EXPECT_EQ(open->second, key);
+    }
+    for (unsigned i = 0; i < 1000; i++) {
+        const uint32_t missing = 0x80000002 | (rng() & 0x1ffffc);
+        EXPECT_EQ(hashtab.find(missing), hashtab.end());
+        EXPECT_EQ(flat.find(missing), flat.end());
+    }
+    hashtab.destroyAll();
+}
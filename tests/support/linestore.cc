@@ -0,0 +1,93 @@
+/*
+
+MIT License
+
+Copyright (c) 2023 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/linestore.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(LineStore, AppendAndIndex) {
+    PCSX::LineStore store(PCSX::LineStore::CHUNK_SIZE * 4);
+    store.append(0, "hello");
+    store.append(1, "world");
+    store.append(0, "again");
+    EXPECT_EQ(store.begin(), 0);
+    EXPECT_EQ(store.end(), 3);
+    EXPECT_EQ(store.line(1), "world");
+    EXPECT_EQ(store.tag(1), 1);
+    ASSERT_EQ(store.index(0).size(), 2);
+    EXPECT_EQ(store.index(0)[1], 2);
+}
+
+TEST(LineStore, Bounded) {
+    PCSX::LineStore store(PCSX::LineStore::CHUNK_SIZE * 2);
+    const std::string line(1000, 'x');
+    for (unsigned i = 0; i < 1000; i++) store.append(i & 1, line);
+    // Two chunks of 65 lines each at most.
+    EXPECT_EQ(store.end(), 1000);
+    EXPECT_GT(store.begin(), 0);
+    EXPECT_LE(store.end() - store.begin(), 2 * (PCSX::LineStore::CHUNK_SIZE / 1000));
+    EXPECT_EQ(store.index(0).front(), store.begin() + (store.begin() & 1));
+    EXPECT_EQ(store.line(store.begin()), line);
+
+    store.clear();
+    EXPECT_EQ(store.begin(), store.end());
+    EXPECT_TRUE(store.index(0).empty());
+}
+
+TEST(LineStore, ViewTags) {
+    PCSX::LineStore store(PCSX::LineStore::CHUNK_SIZE * 4);
+    for (unsigned i = 0; i < 10; i++) store.append(i % 3, std::to_string(i));
+    PCSX::LineStore::View view(store);
+    view.setFilter((1 << 0) | (1 << 2), "");
+    view.update();
+    ASSERT_EQ(view.size(), 7);
+    EXPECT_EQ(view[0], 0);
+    EXPECT_EQ(view[1], 2);
+    EXPECT_EQ(view[2], 3);
+    store.append(1, "10");
+    store.append(2, "11");
+    view.update();
+    ASSERT_EQ(view.size(), 8);
+    EXPECT_EQ(view[7], 11);
+}
+
+TEST(LineStore, ViewText) {
+    PCSX::LineStore store(PCSX::LineStore::CHUNK_SIZE * 4);
+    store.append(0, "Loaded CD Image");
+    store.append(1, "cd-rom command");
+    store.append(0, "nothing here");
+    PCSX::LineStore::View view(store);
+    view.setFilter(~uint64_t(0), "CD");
+    while (view.filtering()) view.update();
+    store.append(0, "another cd line");
+    view.update();
+    ASSERT_EQ(view.size(), 3);
+    EXPECT_EQ(view[0], 0);
+    EXPECT_EQ(view[1], 1);
+    EXPECT_EQ(view[2], 3);
+}
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/logring.h"
+
+#include <stdint.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+enum class Color { Red, Green };
+
+}  // namespace
+
+TEST(LogRing, Deferrable) {
+    EXPECT_TRUE((PCSX::LogRing<>::c_deferrable<int, uint32_t, uint64_t, double, Color, const void*>));
+    EXPECT_FALSE(PCSX::LogRing<>::c_deferrable<>);
+    EXPECT_FALSE((PCSX::LogRing<>::c_deferrable<int, const char*>));
+    EXPECT_FALSE((PCSX::LogRing<>::c_deferrable<char*>));
+    EXPECT_FALSE(PCSX::LogRing<>::c_deferrable<std::string>);
+    EXPECT_FALSE((PCSX::LogRing<>::c_deferrable<int, int, int, int, int, int, int, int, int>));
+}
+
+TEST(LogRing, FormatsInOrder) {
+    PCSX::LogRing<16> ring;
+    EXPECT_TRUE(ring.push(3, "%08x: %i\n", uint32_t(0x80010000), -42));
+    EXPECT_TRUE(ring.push(5, "%.2f %c %s\n", 1.5, 'a', true));
+    EXPECT_EQ(ring.size(), 2);
+
+    unsigned tag;
+    std::string line;
+    ASSERT_TRUE(ring.pop(tag, line));
+    EXPECT_EQ(tag, 3);
+    EXPECT_EQ(line, "80010000: -42\n");
+    ASSERT_TRUE(ring.pop(tag, line));
+    EXPECT_EQ(tag, 5);
+    EXPECT_EQ(line, "1.50 a true\n");
+    EXPECT_FALSE(ring.pop(tag, line));
+}
+
+TEST(LogRing, KeepsTheArgumentsTypes) {
+    PCSX::LogRing<16> ring;
+    // A negative 32 bits value needs to stay 32 bits wide for %x.
+    EXPECT_TRUE(ring.push(0, "%x %x", int32_t(-1), int16_t(-1)));
+    unsigned tag;
+    std::string line;
+    ASSERT_TRUE(ring.pop(tag, line));
+    EXPECT_EQ(line, fmt::sprintf("%x %x", int32_t(-1), int16_t(-1)));
+}
+
+TEST(LogRing, Full) {
+    PCSX::LogRing<4> ring;
+    for (int i = 0; i < 4; i++) EXPECT_TRUE(ring.push(0, "%i", i));
+    EXPECT_FALSE(ring.push(0, "%i", 4));
+
+    unsigned tag;
+    std::string line;
+    ASSERT_TRUE(ring.pop(tag, line));
+    EXPECT_EQ(line, "0");
+    // This wraps around the end of the ring.
+    EXPECT_TRUE(ring.push(0, "%i", 5));
+    for (auto expected : {"1", "2", "3", "5"}) {
+        ASSERT_TRUE(ring.pop(tag, line));
+        EXPECT_EQ(line, expected);
+    }
+    EXPECT_EQ(ring.size(), 0);
+}
@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/mem4g.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(Mem4G, Sparse) {
+    PCSX::Mem4G mem;
+    ASSERT_FALSE(mem.failed());
+    EXPECT_TRUE(mem.isEmpty());
+
+    uint8_t data[16];
+    for (unsigned i = 0; i < 16; i++) data[i] = i + 1;
+    // Straddles two blocks, near the top of the address space.
+    const size_t address = 0x80000000 - 8;
+    EXPECT_EQ(mem.writeAt(data, 16, address), 16);
+    EXPECT_EQ(mem.lowestAddress(), address);
+    EXPECT_EQ(mem.highestAddress(), address + 16);
+
+    std::vector<uint8_t> out(3 * PCSX::Mem4G::c_blockSize, 0xff);
+    const size_t start = address - PCSX::Mem4G::c_blockSize - 8;
+    EXPECT_EQ(mem.readAt(out.data(), out.size(), start), out.size());
+    for (size_t i = 0; i < out.size(); i++) {
+        const size_t a = start + i;
+        const uint8_t expected = ((a >= address) && (a < address + 16)) ? a - address + 1 : 0;
+        ASSERT_EQ(out[i], expected) << "at " << a;
+    }
+    EXPECT_EQ(mem.blockData(0x10000000), nullptr);
+    ASSERT_NE(mem.blockData(address), nullptr);
+    EXPECT_EQ(mem.blockData(address)[PCSX::Mem4G::c_blockSize - 8], 1);
+}
+
+TEST(Mem4G, DirtyBlocks) {
+    PCSX::Mem4G mem;
+    uint32_t value = 0x12345678;
+    mem.writeAt(&value, 4, 0x80010000);
+    mem.writeAt(&value, 4, 0x1f800000);
+    mem.writeAt(&value, 4, 0x80010004);
+    auto dirty = mem.dirtyBlocks();
+    ASSERT_EQ(dirty.size(), 2);
+    EXPECT_EQ(dirty[0], 0x1f800000);
+    EXPECT_EQ(dirty[1], 0x80010000);
+    EXPECT_TRUE(mem.dirtyBlocks().empty());
+
+    mem.writeAt(&value, 4, 0x1f800010);
+    dirty = mem.dirtyBlocks(false);
+    ASSERT_EQ(dirty.size(), 1);
+    EXPECT_EQ(dirty[0], 0x1f800000);
+    EXPECT_EQ(mem.dirtyBlocks().size(), 1);
+}
+
+TEST(Mem4G, EndOfSpace) {
+    PCSX::Mem4G mem;
+    uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    EXPECT_EQ(mem.writeAt(data, 8, 0xfffffffc), 4);
+    uint8_t out[8] = {};
+    EXPECT_EQ(mem.readAt(out, 8, 0xfffffffc), 4);
+    EXPECT_EQ(out[3], 4);
+    EXPECT_EQ(mem.readAt(out, 8, 0x100000000ULL), 0);
+}
@@ -0,0 +1,147 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/memscanner.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using PCSX::MemoryScanner;
+
+namespace {
+
+// The plain loop the scanner has to agree with, on every slot.
+std::vector<uint32_t> reference(const std::vector<uint8_t>& memory, const std::vector<uint8_t>& previous,
+                                const std::vector<uint32_t>& candidates, MemoryScanner::ValueType type,
+                                MemoryScanner::Comparison comparison, int64_t value) {
+    using Comparison = MemoryScanner::Comparison;
+    std::vector<uint32_t> ret;
+    const int64_t truncated = MemoryScanner::read(reinterpret_cast<const uint8_t*>(&value), 0, type);
+    for (auto offset : candidates) {
+        const int64_t current = MemoryScanner::read(memory.data(), offset, type);
+        const int64_t before = MemoryScanner::read(previous.data(), offset, type);
+        bool keep = false;
+        switch (comparison) {
+            case Comparison::Equal:
+                keep = current == truncated;
+                break;
+            case Comparison::NotEqual:
+                keep = current != truncated;
+                break;
+            case Comparison::Greater:
+                keep = current > truncated;
+                break;
+            case Comparison::Less:
+                keep = current < truncated;
+                break;
+            case Comparison::Changed:
+                keep = current != before;
+                break;
+            case Comparison::Unchanged:
+                keep = current == before;
+                break;
+            case Comparison::Increased:
+                keep = current > before;
+                break;
+            case Comparison::Decreased:
+                keep = current < before;
+                break;
+            case Comparison::Any:
+                keep = true;
+                break;
+        }
+        if (keep) ret.push_back(offset);
+    }
+    return ret;
+}
+
+std::vector<uint32_t> results(const MemoryScanner& scanner) {
+    std::vector<uint32_t> ret;
+    scanner.forEach([&ret](uint32_t offset) { ret.push_back(offset); });
+    return ret;
+}
+
+}  // namespace
+
+TEST(MemoryScanner, MatchesReference) {
+    using Comparison = MemoryScanner::Comparison;
+    using ValueType = MemoryScanner::ValueType;
+    std::mt19937 rng(1);
+    // Odd sizes, so that the last block is a short one, and large enough to use several threads.
+    for (size_t size : {size_t(1000), size_t(3 * 1024 * 1024 + 6)}) {
+        for (auto type : {ValueType::Char, ValueType::Uchar, ValueType::Short, ValueType::Ushort, ValueType::Int,
+                          ValueType::Uint}) {
+            const unsigned width = MemoryScanner::width(type);
+            std::vector<uint8_t> memory(size);
+            // Few distinct values, so that the equality comparisons find something.
+            for (auto& byte : memory) byte = (rng() & 3) ? 0 : uint8_t(rng() | 0x80);
+            std::vector<uint32_t> all;
+            for (uint32_t offset = 0; offset + width <= size; offset += width) all.push_back(offset);
+
+            MemoryScanner scanner;
+            scanner.first(memory.data(), size, type, Comparison::Less, 1);
+            auto expected = reference(memory, memory, all, type, Comparison::Less, 1);
+            EXPECT_EQ(scanner.count(), expected.size());
+            EXPECT_TRUE(results(scanner) == expected);
+
+            for (auto comparison : {Comparison::Changed, Comparison::Unchanged, Comparison::Equal, Comparison::Any,
+                                    Comparison::Increased, Comparison::Greater, Comparison::NotEqual,
+                                    Comparison::Decreased}) {
+                std::vector<uint8_t> previous = memory;
+                for (unsigned i = 0; i < size / 8; i++) memory[rng() % size] += 1;
+                expected = reference(memory, previous, expected, type, comparison, 0);
+                scanner.next(memory.data(), comparison, 0);
+                EXPECT_EQ(scanner.count(), expected.size());
+                EXPECT_TRUE(results(scanner) == expected);
+            }
+            for (size_t i = 0; i < expected.size(); i += 1 + expected.size() / 100) {
+                EXPECT_EQ(scanner.offset(i), expected[i]);
+                EXPECT_EQ(scanner.previous(expected[i]), MemoryScanner::read(memory.data(), expected[i], type));
+            }
+        }
+    }
+}
+
+TEST(MemoryScanner, ExactValue) {
+    std::vector<uint8_t> memory(4096);
+    const uint32_t value = 0xdeadbeef;
+    memcpy(memory.data() + 128, &value, 4);
+    memcpy(memory.data() + 4000, &value, 4);
+    // Unaligned copies don't count.
+    memcpy(memory.data() + 2001, &value, 4);
+
+    MemoryScanner scanner;
+    scanner.first(memory.data(), memory.size(), MemoryScanner::ValueType::Uint, MemoryScanner::Comparison::Equal,
+                  value);
+    ASSERT_EQ(scanner.count(), 2);
+    EXPECT_EQ(scanner.offset(0), 128);
+    EXPECT_EQ(scanner.offset(1), 4000);
+
+    memory[4000] = 0;
+    scanner.next(memory.data(), MemoryScanner::Comparison::Changed);
+    ASSERT_EQ(scanner.count(), 1);
+    EXPECT_EQ(scanner.offset(0), 4000);
+    scanner.clear();
+    EXPECT_TRUE(scanner.empty());
+}
@@ -0,0 +1,62 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/mmapfile.h"
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(MmapFile, Basic) {
+    auto path = std::filesystem::temp_directory_path() / "pcsx-redux-mmapfile-test.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (unsigned i = 0; i < 4096; i++) out.put(static_cast<char>(i & 0xff));
+    }
+
+    {
+        PCSX::IO<PCSX::MmapFile> file(new PCSX::MmapFile(path));
+        ASSERT_FALSE(file->failed());
+        EXPECT_EQ(file->size(), 4096);
+        EXPECT_EQ(file->data()[0x123], 0x23);
+
+        uint8_t buffer[16];
+        EXPECT_EQ(file->readAt(buffer, sizeof(buffer), 4090), 6);
+        EXPECT_EQ(buffer[5], 0xff);
+        EXPECT_EQ(file->readAt(buffer, sizeof(buffer), 4096), -1);
+
+        file->rSeek(0x80, SEEK_SET);
+        EXPECT_EQ(file->read(buffer, 4), 4);
+        EXPECT_EQ(buffer[3], 0x83);
+        EXPECT_EQ(file->rTell(), 0x84);
+        file->rSeek(0, SEEK_END);
+        EXPECT_TRUE(file->eof());
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(MmapFile, Missing) {
+    PCSX::IO<PCSX::MmapFile> file(new PCSX::MmapFile(std::filesystem::temp_directory_path() / "pcsx-redux-missing"));
+    EXPECT_TRUE(file->failed());
+}
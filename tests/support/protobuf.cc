@@ -0,0 +1,85 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/protobuf.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "support/file.h"
+#include "support/typestring-wrapper.h"
+
+namespace {
+
+using namespace PCSX::Protobuf;
+
+typedef Field<UInt32, TYPESTRING("counter"), 1> Counter;
+typedef FieldPtr<FixedBytes<0x20000>, TYPESTRING("ram"), 2> Ram;
+typedef Field<String, TYPESTRING("label"), 3> Label;
+typedef Message<TYPESTRING("Inner"), Counter, Ram, Label> Inner;
+typedef MessageField<Inner, TYPESTRING("inner"), 1> InnerField;
+typedef Field<UInt64, TYPESTRING("cycle"), 2> Cycle;
+typedef Message<TYPESTRING("Outer"), InnerField, Cycle> Outer;
+
+// A file which only appends to a string, remembering the size of each write.
+class StringFile : public PCSX::File {
+  public:
+    StringFile() : File(PCSX::File::RW_STREAM) {}
+    virtual ssize_t write(const void* src, size_t size) override {
+        data.append(reinterpret_cast<const char*>(src), size);
+        writes.push_back(size);
+        return size;
+    }
+    std::string data;
+    std::vector<size_t> writes;
+};
+
+}  // namespace
+
+TEST(Protobuf, StreamingMatchesBuffered) {
+    std::vector<uint8_t> ram(0x20000);
+    for (unsigned i = 0; i < ram.size(); i++) ram[i] = uint8_t(i * 13);
+    Outer outer(InnerField(Counter(42), Ram(ram.data()), Label("hello")), Cycle(0x123456789));
+
+    OutSlice buffered;
+    outer.serialize(&buffered);
+    const std::string expected = buffered.finalize();
+
+    StringFile file;
+    {
+        OutSlice streamed(&file);
+        outer.serialize(&streamed);
+        streamed.flush();
+        EXPECT_FALSE(streamed.failed());
+        EXPECT_EQ(streamed.size(), expected.size());
+    }
+    EXPECT_EQ(file.data, expected);
+    // The large field went in one go, straight from where it lives.
+    bool sawRam = false;
+    for (auto size : file.writes) sawRam |= size == ram.size();
+    EXPECT_TRUE(sawRam);
+
+    OutSlice counter(OutSlice::COUNT);
+    outer.serialize(&counter);
+    EXPECT_EQ(counter.size(), expected.size());
+    EXPECT_TRUE(counter.finalize().empty());
+}
@@ -0,0 +1,74 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/slice.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(SliceChain, Basic) {
+    PCSX::SliceChain chain;
+    chain.push("Hello");
+    chain.push(PCSX::Slice());
+    chain.push(std::string(", world"));
+    EXPECT_EQ(chain.size(), 12);
+    EXPECT_EQ(chain.count(), 2);
+
+    std::string gathered;
+    chain.forEach([&gathered](const void* ptr, size_t size) { gathered.append((const char*)ptr, size); });
+    EXPECT_EQ(gathered, "Hello, world");
+}
+
+TEST(SliceChain, Consume) {
+    PCSX::SliceChain chain;
+    chain.push("abc");
+    chain.push("defgh");
+    chain.push("ij");
+    chain.consume(4);
+    EXPECT_EQ(chain.size(), 6);
+    EXPECT_EQ(chain.count(), 2);
+
+    char buffer[4] = {};
+    EXPECT_EQ(chain.read(buffer, 4), 4);
+    EXPECT_EQ(std::string(buffer, 4), "efgh");
+    EXPECT_EQ(chain.count(), 1);
+
+    PCSX::Slice last = chain.pop();
+    EXPECT_EQ(last.asStringView(), "ij");
+    EXPECT_TRUE(chain.empty());
+    EXPECT_EQ(chain.read(buffer, 4), 0);
+}
+
+TEST(SliceChain, Move) {
+    PCSX::SliceChain first;
+    first.push("0123");
+    first.consume(1);
+    PCSX::SliceChain second;
+    second.push("x");
+    second.push(std::move(first));
+    EXPECT_TRUE(first.empty());
+    EXPECT_EQ(second.size(), 4);
+
+    PCSX::SliceChain third = std::move(second);
+    EXPECT_TRUE(second.empty());
+    std::string gathered;
+    third.forEach([&gathered](const void* ptr, size_t size) { gathered.append((const char*)ptr, size); });
+    EXPECT_EQ(gathered, "x123");
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/spsc.h"
+
+#include <stdint.h>
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(SPSCRing, Basic) {
+    PCSX::SPSCRing<uint32_t, 16> ring;
+
+    uint32_t data[12];
+    for (unsigned i = 0; i < 12; i++) {
+        data[i] = i;
+    }
+
+    EXPECT_EQ(ring.available(), 16);
+    ring.write(data, 12);
+    EXPECT_EQ(ring.buffered(), 0);
+    ring.commit(12);
+    EXPECT_EQ(ring.buffered(), 12);
+    EXPECT_EQ(ring.available(), 4);
+
+    uint32_t out[12];
+    ring.read(out, 2, 10);
+    EXPECT_EQ(out[0], 10);
+    EXPECT_EQ(out[1], 11);
+    ring.consume(10);
+    EXPECT_EQ(ring.buffered(), 2);
+
+    // This wraps around the end of the ring.
+    ring.write(data, 8);
+    ring.commit(8);
+    EXPECT_EQ(ring.buffered(), 10);
+
+    auto span = ring.peek();
+    ASSERT_EQ(span.size(), 6);
+    EXPECT_EQ(span[0], 10);
+    EXPECT_EQ(span[1], 11);
+    EXPECT_EQ(span[2], 0);
+    span = ring.peek(span.size());
+    ASSERT_EQ(span.size(), 4);
+    EXPECT_EQ(span[0], 4);
+    EXPECT_EQ(span[3], 7);
+
+    ring.read(out, 10);
+    for (unsigned i = 0; i < 8; i++) {
+        EXPECT_EQ(out[i + 2], i);
+    }
+    ring.consume(10);
+    EXPECT_EQ(ring.buffered(), 0);
+    EXPECT_TRUE(ring.peek().empty());
+}
+
+TEST(SPSCRing, Threaded) {
+    static PCSX::SPSCRing<uint32_t, 64> ring;
+    constexpr uint32_t count = 100000;
+
+    std::thread consumer([]() {
+        uint32_t expected = 0;
+        while (expected < count) {
+            ring.waitForData();
+            auto span = ring.peek();
+            for (auto value : span) {
+                ASSERT_EQ(value, expected++);
+            }
+            ring.consume(span.size());
+        }
+    });
+
+    for (uint32_t i = 0; i < count;) {
+        uint32_t data[7];
+        uint32_t n = std::min<uint32_t>(7, count - i);
+        for (uint32_t j = 0; j < n; j++) {
+            data[j] = i + j;
+        }
+        ring.waitForSpace(n);
+        ring.write(data, n);
+        ring.commit(n);
+        i += n;
+    }
+
+    ring.waitForEmpty();
+    consumer.join();
+    EXPECT_EQ(ring.buffered(), 0);
+}
@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/xordelta.h"
+
+#include <stdint.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(XorDelta, Identical) {
+    std::vector<uint8_t> base(4096, 0x55);
+    std::string delta;
+    PCSX::XorDelta::encode(base.data(), base.data(), base.size(), delta);
+    EXPECT_TRUE(delta.empty());
+}
+
+TEST(XorDelta, Runs) {
+    std::vector<uint8_t> base(4096);
+    for (unsigned i = 0; i < base.size(); i++) base[i] = uint8_t(i * 7);
+    auto data = base;
+    data[0] ^= 1;
+    data[100] ^= 2;
+    data[102] ^= 3;  // close enough to the previous one to be in the same run
+    for (unsigned i = 2000; i < 2100; i++) data[i] = 0;
+    data[4095] ^= 4;
+
+    std::string delta;
+    PCSX::XorDelta::encode(base.data(), data.data(), base.size(), delta);
+    EXPECT_LT(delta.size(), 150);
+
+    auto patched = base;
+    EXPECT_TRUE(PCSX::XorDelta::apply(delta, patched.data(), patched.size()));
+    EXPECT_EQ(patched, data);
+    // And back.
+    EXPECT_TRUE(PCSX::XorDelta::apply(delta, patched.data(), patched.size()));
+    EXPECT_EQ(patched, base);
+}
+
+TEST(XorDelta, Random) {
+    std::mt19937 gen(42);
+    for (unsigned round = 0; round < 100; round++) {
+        const size_t size = 1 + gen() % 10000;
+        std::vector<uint8_t> base(size);
+        for (auto& b : base) b = gen();
+        auto data = base;
+        const unsigned changes = gen() % 64;
+        for (unsigned i = 0; i < changes; i++) data[gen() % size] = gen();
+
+        std::string delta;
+        PCSX::XorDelta::encode(base.data(), data.data(), size, delta);
+        auto patched = base;
+        ASSERT_TRUE(PCSX::XorDelta::apply(delta, patched.data(), size));
+        ASSERT_EQ(patched, data);
+    }
+}
+
+TEST(XorDelta, Corrupted) {
+    std::vector<uint8_t> base(256, 0);
+    auto data = base;
+    data[200] = 1;
+    std::string delta;
+    PCSX::XorDelta::encode(base.data(), data.data(), base.size(), delta);
+
+    // The same delta doesn't fit in a smaller buffer.
+    EXPECT_FALSE(PCSX::XorDelta::apply(delta, base.data(), 100));
+    // Nor once truncated.
+    delta.pop_back();
+    EXPECT_FALSE(PCSX::XorDelta::apply(delta, base.data(), base.size()));
+}
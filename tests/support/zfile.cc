@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/zfile.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string makeData(size_t size) {
+    std::string data;
+    data.reserve(size);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        data.push_back("abcdefgh"[(seed >> 16) & 7]);
+    }
+    return data;
+}
+
+}  // namespace
+
+TEST(ZFile, StreamRoundTrip) {
+    const std::string data = makeData(3 * 1024 * 1024);
+    PCSX::IO<PCSX::File> buffer(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    {
+        PCSX::IO<PCSX::File> writer(new PCSX::ZWriter(buffer, PCSX::ZWriter::GZIP));
+        // A mix of tiny writes, which get batched, and large ones, which go straight through.
+        size_t pos = 0, step = 0;
+        while (pos < data.size()) {
+            size_t size = std::min(data.size() - pos, (step++ % 4) ? size_t(17) : size_t(70000));
+            writer->write(data.data() + pos, size);
+            pos += size;
+        }
+        writer->close();
+    }
+
+    PCSX::ZReader reader(buffer);
+    std::string chunk(1000, 0);
+    reader.rSeek(2000000, SEEK_SET);
+    EXPECT_EQ(reader.read(chunk.data(), chunk.size()), 1000);
+    EXPECT_TRUE(chunk == data.substr(2000000, 1000));
+    // Going backwards restarts the inflate from the beginning of the stream.
+    reader.rSeek(10, SEEK_SET);
+    EXPECT_EQ(reader.read(chunk.data(), chunk.size()), 1000);
+    EXPECT_TRUE(chunk == data.substr(10, 1000));
+    reader.close();
+}
+
+TEST(ZFile, WholeBuffer) {
+    const std::string data = makeData(1024 * 1024);
+    PCSX::Slice compressed = PCSX::ZWriter::compress(data, Z_BEST_SPEED);
+    EXPECT_TRUE(compressed.size() < data.size());
+    std::string out;
+    EXPECT_TRUE(PCSX::ZReader::uncompress(compressed.asStringView(), out));
+    EXPECT_TRUE(out == data);
+
+    std::string truncated(compressed.asStringView().substr(0, compressed.size() / 2));
+    EXPECT_FALSE(PCSX::ZReader::uncompress(truncated, out));
+}
@@ -183,7 +183,7 @@ Usage: {} input.json [-h] -o output.bin
 
     PCSX::BinaryLoader::Info info;
     PCSX::IO<PCSX::Mem4G> memory(new PCSX::Mem4G());
-    std::map<uint32_t, std::string> symbols;
+    PCSX::SymbolTable symbols;
     bool success = PCSX::BinaryLoader::load(executableFile, memory, info, symbols);
     if (!success) {
         fmt::print("Unable to load file: {}\n", executablePath);
@@ -231,11 +231,10 @@ Usage: {} input.json [-h] -o output.bin
     const unsigned executableSectorsCount = compressedExecutable->size() / 2048;
     unsigned currentSector = 23 + indexSectorsCount;
 
-    for (unsigned i = 0; i < executableSectorsCount; i++) {
-        auto sector = compressedExecutable.asA<PCSX::BufferFile>()->borrow(i * 2048);
-        builder.writeSectorAt(sector.data<uint8_t>(), PCSX::IEC60908b::MSF{150 + currentSector++},
-                              PCSX::IEC60908b::SectorMode::M2_FORM1);
-    }
+    auto executableSectors = compressedExecutable.asA<PCSX::BufferFile>()->borrow(0);
+    builder.writeSectorsAt(executableSectors.data<uint8_t>(), executableSectorsCount,
+                           PCSX::IEC60908b::MSF{150 + currentSector}, PCSX::IEC60908b::SectorMode::M2_FORM1);
+    currentSector += executableSectorsCount;
 
     std::unique_ptr<uint8_t[]> indexEntryDataBuffer(new uint8_t[indexSectorsCount * 2048]);
     memset(indexEntryDataBuffer.get(), 0, indexSectorsCount * 2048);
@@ -403,10 +402,8 @@ Usage: {} input.json [-h] -o output.bin
     std::sort(indexEntryData.begin(), indexEntryData.end(),
               [](const IndexEntry& a, const IndexEntry& b) { return a.hash < b.hash; });
 
-    for (unsigned i = 0; i < indexSectorsCount; i++) {
-        auto sector = indexEntryDataBuffer.get() + i * 2048;
-        builder.writeSectorAt(sector, PCSX::IEC60908b::MSF{150 + i + 23}, PCSX::IEC60908b::SectorMode::M2_FORM1);
-    }
+    builder.writeSectorsAt(indexEntryDataBuffer.get(), indexSectorsCount, PCSX::IEC60908b::MSF{150 + 23},
+                           PCSX::IEC60908b::SectorMode::M2_FORM1);
 
     PCSX::IO<PCSX::File> pvdSector(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
     PCSX::ISO9660LowLevel::PVD pvd;
@@ -63,7 +63,7 @@ Usage: {} input.ps-exe [-h] -o output.elf
 
     PCSX::BinaryLoader::Info info;
     PCSX::IO<PCSX::Mem4G> memory(new PCSX::Mem4G());
-    std::map<uint32_t, std::string> symbols;
+    PCSX::SymbolTable symbols;
     bool success = PCSX::BinaryLoader::load(file, memory, info, symbols);
     if (!success) {
         fmt::print("Unable to load file: {}\n", input);
@@ -19,9 +19,10 @@
 
 #include <stdint.h>
 
+#include <vector>
+
 #include "flags.h"
 #include "fmt/format.h"
-#include "iec-60908b/edcecc.h"
 #include "support/file.h"
 #include "supportpsx/iec-60908b.h"
 
@@ -160,10 +161,21 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
     makeHeaderOnce(sector);
     bool wroteLicense = false;
     unsigned LBA = 0;
+    // Sectors are queued up and written in large spans, so that the EDC/ECC
+    // regeneration can be spread over multiple threads.
+    static constexpr unsigned c_batchSize = 1024;
+    std::vector<uint8_t> pending;
+    pending.reserve(c_batchSize * sizeof(sector));
+    auto flush = [&]() {
+        if (pending.empty()) return;
+        if (regen) PCSX::IEC60908b::computeEDCECC(pending.data(), pending.size() / sizeof(sector));
+        out->write(pending.data(), pending.size());
+        pending.clear();
+    };
     auto writeSector = [&]() {
         makeHeader(sector, LBA++);
-        if (regen) compute_edcecc(sector);
-        out->write(sector, sizeof(sector));
+        pending.insert(pending.end(), sector, sector + sizeof(sector));
+        if (pending.size() >= c_batchSize * sizeof(sector)) flush();
     };
     // Sectors 0-15 are the license. We can keep it to zeroes and it'll work most everywhere.
     if (licenseFile && !licenseFile->failed()) {
@@ -233,5 +245,6 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
             writeSector();
         }
     }
+    flush();
     fmt::print("Done.");
 }
@@ -0,0 +1,213 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "flags.h"
+#include "fmt/format.h"
+#include "support/file.h"
+#include "supportpsx/mdec-kernels.h"
+
+using namespace PCSX::MDECKernels;
+
+namespace {
+
+// The parser can read up to 65 words per block, so this much padding keeps a truncated capture from
+// running past the end of the buffer.
+constexpr size_t c_padding = 6 * 65;
+
+struct Stream {
+    int iqY[DSIZE2];
+    int iqUV[DSIZE2];
+    std::vector<uint16_t> rl;
+};
+
+// A capture is the 128 bytes of the quantization tables upload, luma then chroma, followed by the
+// run-length data of the decode commands, the same way the game sends them through DMA0.
+bool loadCapture(const std::string& path, Stream& stream) {
+    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(path));
+    if (file->failed()) return false;
+    uint8_t tables[128];
+    const size_t size = file->size();
+    if ((size < sizeof(tables)) || (file->read(tables, sizeof(tables)) != sizeof(tables))) return false;
+    initQuantTable(stream.iqY, tables);
+    initQuantTable(stream.iqUV, tables + 64);
+    stream.rl.resize((size - sizeof(tables)) / 2);
+    const ssize_t len = stream.rl.size() * 2;
+    return file->read(stream.rl.data(), len) == len;
+}
+
+// Random, but plausible, blocks: a DC coefficient, a handful of AC coefficients towards the
+// low frequencies, and the occasional denser block.
+void generateStream(Stream& stream, unsigned macroblocks, std::mt19937& gen) {
+    uint8_t tables[128];
+    for (auto& t : tables) t = 1 + gen() % 63;
+    initQuantTable(stream.iqY, tables);
+    initQuantTable(stream.iqUV, tables + 64);
+    std::uniform_int_distribution<int> value(-64, 63);
+    for (unsigned i = 0; i < macroblocks * 6; i++) {
+        const unsigned qscale = 1 + gen() % 32;
+        stream.rl.push_back((qscale << 10) | (value(gen) & 0x3ff));
+        const unsigned coefficients = (gen() % 8) == 0 ? 40 : gen() % 10;
+        unsigned k = 0;
+        for (unsigned c = 0; c < coefficients; c++) {
+            const unsigned run = gen() % 3;
+            if ((k + run + 1) > 63) break;
+            k += run + 1;
+            stream.rl.push_back((run << 10) | (value(gen) & 0x3ff));
+        }
+        stream.rl.push_back(END_OF_DATA);
+    }
+}
+
+struct Parsed {
+    std::vector<int> blocks;
+    std::vector<int> usedCols;
+    size_t count = 0;
+};
+
+Parsed parse(Stream& stream) {
+    Parsed parsed;
+    const size_t size = stream.rl.size();
+    stream.rl.resize(size + c_padding, END_OF_DATA);
+    uint16_t* rl = stream.rl.data();
+    uint16_t* end = rl + size;
+    while (rl < end) {
+        parsed.blocks.resize((parsed.count + 1) * MACROBLOCK_SIZE);
+        parsed.usedCols.resize((parsed.count + 1) * 6);
+        rl = parseMacroblock(parsed.blocks.data() + parsed.count * MACROBLOCK_SIZE,
+                             parsed.usedCols.data() + parsed.count * 6, rl, stream.iqY, stream.iqUV);
+        parsed.count++;
+    }
+    return parsed;
+}
+
+enum class Mode { RGB15, RGB24, BNW15, BNW24 };
+
+// Returns the time spent in the IDCT and the colour conversion, in seconds, leaving the pixels of
+// the last iteration in image.
+double decode(const Parsed& parsed, const Kernels& kernels, Mode mode, unsigned iterations,
+              std::vector<uint8_t>& image) {
+    const size_t pixelSize = ((mode == Mode::RGB24) || (mode == Mode::BNW24)) ? 3 : 2;
+    const size_t macroblockSize = 16 * 16 * pixelSize;
+    image.resize(parsed.count * macroblockSize);
+    std::vector<int> blocks(parsed.blocks.size());
+    std::chrono::duration<double> total(0);
+
+    for (unsigned i = 0; i < iterations; i++) {
+        memcpy(blocks.data(), parsed.blocks.data(), blocks.size() * sizeof(int));
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t m = 0; m < parsed.count; m++) {
+            int* blk = blocks.data() + m * MACROBLOCK_SIZE;
+            const int* usedCol = parsed.usedCols.data() + m * 6;
+            uint8_t* out = image.data() + m * macroblockSize;
+            for (unsigned b = 0; b < 6; b++) kernels.idct(blk + b * DSIZE2, usedCol[b]);
+            switch (mode) {
+                case Mode::RGB15:
+                    kernels.rgb15(blk, reinterpret_cast<uint16_t*>(out), 0);
+                    break;
+                case Mode::RGB24:
+                    kernels.rgb24(blk, out);
+                    break;
+                case Mode::BNW15:
+                    kernels.bnw15(blk, reinterpret_cast<uint16_t*>(out), 0);
+                    break;
+                case Mode::BNW24:
+                    kernels.bnw24(blk, out);
+                    break;
+            }
+        }
+        total += std::chrono::steady_clock::now() - start;
+    }
+
+    return total.count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    CommandLine::args args(argc, argv);
+
+    fmt::print(R"(
+mdec-bench
+https://github.com/grumpycoders/pcsx-redux/tree/main/tools/mdec-bench/
+)");
+
+    const auto inputs = args.positional();
+    const bool asksForHelp = args.get<bool>("h").value_or(false);
+    const unsigned iterations = args.get<unsigned>("n").value_or(100);
+    const unsigned synthetic = args.get<unsigned>("synthetic").value_or(0);
+    const bool bits24 = args.get<bool>("rgb24").value_or(false);
+    const bool bnw = args.get<bool>("bnw").value_or(false);
+    if (asksForHelp || (inputs.size() > 1) || (inputs.empty() == (synthetic == 0)) || (iterations == 0)) {
+        fmt::print(R"(
+Usage: {} [capture.bin | -synthetic count] [-n iterations] [-rgb24] [-bnw] [-h]
+  capture.bin       the quantization tables, then the run-length data of a capture.
+  -synthetic count  decodes this many random macroblocks instead of a capture.
+  -n iterations     how many times to decode everything, default 100.
+  -rgb24            benchmarks the 24 bits output instead of the 15 bits one.
+  -bnw              benchmarks the monochrome output.
+  -h                displays this help information and exit.
+)",
+                   argv[0]);
+        return -1;
+    }
+
+    Stream stream;
+    if (synthetic != 0) {
+        std::mt19937 gen(synthetic);
+        generateStream(stream, synthetic, gen);
+    } else if (!loadCapture(std::string(inputs[0]), stream)) {
+        fmt::print("Unable to load capture: {}\n", inputs[0]);
+        return -1;
+    }
+
+    const auto parseStart = std::chrono::steady_clock::now();
+    const Parsed parsed = parse(stream);
+    const std::chrono::duration<double> parseTime = std::chrono::steady_clock::now() - parseStart;
+    fmt::print("{} macroblocks, parsed in {:.3f} ms\n", parsed.count, parseTime.count() * 1000.0);
+    if (parsed.count == 0) return -1;
+
+    Mode mode = bits24 ? Mode::RGB24 : Mode::RGB15;
+    if (bnw) mode = bits24 ? Mode::BNW24 : Mode::BNW15;
+
+    const Kernels* candidates[] = {&getScalarKernels(), &getKernels()};
+    std::vector<uint8_t> images[2];
+    double times[2];
+    for (unsigned i = 0; i < 2; i++) {
+        times[i] = decode(parsed, *candidates[i], mode, iterations, images[i]);
+        const double macroblocks = double(parsed.count) * iterations;
+        fmt::print("{:>8}: {:.3f} ms per iteration, {:.0f} macroblocks per second\n", candidates[i]->name,
+                   times[i] * 1000.0 / iterations, macroblocks / times[i]);
+    }
+    fmt::print("Speedup: {:.2f}x\n", times[0] / times[1]);
+
+    if (images[0] != images[1]) {
+        fmt::print("The {} kernels don't match the scalar ones!\n", candidates[1]->name);
+        return -1;
+    }
+
+    return 0;
+}
@@ -21,6 +21,7 @@
 #include <cctype>
 #include <memory>
 #include <string_view>
+#include <vector>
 
 #include "flags.h"
 #include "fmt/format.h"
@@ -161,12 +162,15 @@ both the pattern and sample data.
         loopStart *= 2;
         unsigned loopEnd = loopStart + loopLength * 2;
         unsigned encodedLength = 0;
-        while (length >= 28) {
-            for (unsigned j = 0; j < 28; j++) {
-                input[j] = int16_t(file->read<int8_t>()) * amplification;
-            }
+        // All of the full blocks are encoded in one go, and their attributes patched afterwards.
+        const unsigned fullBlocks = length / 28;
+        std::vector<int16_t> fullInput(fullBlocks * 28);
+        std::vector<uint8_t> fullOutput(fullBlocks * 16);
+        for (auto& value : fullInput) value = int16_t(file->read<int8_t>()) * amplification;
+        encoder->processSPUBlocks(fullInput.data(), fullOutput.data(), fullBlocks,
+                                  PCSX::ADPCM::Encoder::BlockAttribute::OneShot);
+        for (unsigned b = 0; b < fullBlocks; b++) {
             length -= 28;
-            encoder->processSPUBlock(input, spuBlock, PCSX::ADPCM::Encoder::BlockAttribute::OneShot);
             uint8_t blockAttribute = 0;
             if (length == 0) {
                 blockAttribute |= 1;
@@ -177,11 +181,11 @@ both the pattern and sample data.
                     blockAttribute |= 4;
                 }
             }
-            spuBlock[1] = blockAttribute;
+            fullOutput[b * 16 + 1] = blockAttribute;
             position += 28;
-            encodedSamples->write(spuBlock, 16);
-            encodedLength += 16;
         }
+        encodedSamples->write(fullOutput.data(), fullOutput.size());
+        encodedLength += fullOutput.size();
         if (length != 0) {
             for (unsigned j = 0; j < length; j++) {
                 input[j] = int16_t(file->read<int8_t>()) * amplification;
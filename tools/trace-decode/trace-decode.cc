@@ -0,0 +1,178 @@
+/***************************************************************************
+ *   Copyright (C) 2023 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <magic_enum_all.hpp>
+#include <string>
+#include <string_view>
+
+#include "flags.h"
+#include "fmt/format.h"
+#include "mips/common/util/decoder.hh"
+#include "supportpsx/exectrace-reader.h"
+
+using namespace PCSX::ExecTrace;
+
+namespace {
+
+const char* const c_registerNames[REGISTERS] = {
+    "r0", "at", "v0", "v1", "a0", "a1", "a2", "a3", "t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7", "s0",
+    "s1", "s2", "s3", "s4", "s5", "s6", "s7", "t8", "t9", "k0", "k1", "gp", "sp", "fp", "ra", "lo", "hi",
+};
+
+unsigned storeWidth(Mips::Decoder::Instruction::Mnemonic mnemonic) {
+    using Mips::Decoder::Instruction;
+    switch (mnemonic) {
+        case Instruction::SB:
+            return 1;
+        case Instruction::SH:
+            return 2;
+        case Instruction::SW:
+        case Instruction::SWL:
+        case Instruction::SWR:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+void formatChanges(std::string& line, const Decoder& decoder) {
+    const uint64_t changed = decoder.changed();
+    for (unsigned i = 0; i < REGISTERS; i++) {
+        if (!(changed & (uint64_t(1) << i))) continue;
+        line += fmt::format(" {}={:08x}", c_registerNames[i], decoder.registers()[i]);
+    }
+}
+
+std::string format(Reader::Status status, const Decoder& decoder) {
+    if (status == Reader::Status::Checkpoint) {
+        std::string line = fmt::format("{:08x}  cycle {}", decoder.pc(), decoder.cycle());
+        formatChanges(line, decoder);
+        return line;
+    }
+    const Mips::Decoder::Instruction instruction(decoder.code());
+    const auto mnemonic = instruction.mnemonic();
+    std::string line =
+        fmt::format("{:08x}  {:08x}  {:<8}", decoder.pc(), decoder.code(), magic_enum::enum_name(mnemonic));
+    if (!decoder.hasRegisters()) return line;
+
+    formatChanges(line, decoder);
+    // Stores don't change any register, but what they wrote can be worked out from the ones they read.
+    const unsigned width = storeWidth(mnemonic);
+    if (width != 0) {
+        const uint32_t* regs = decoder.previousRegisters();
+        const uint32_t address = regs[instruction.rs()] + instruction.imm();
+        const uint32_t value = regs[instruction.rt()];
+        if (width == 1) line += fmt::format(" [{:08x}]={:02x}", address, value & 0xff);
+        if (width == 2) line += fmt::format(" [{:08x}]={:04x}", address, value & 0xffff);
+        if (width == 4) line += fmt::format(" [{:08x}]={:08x}", address, value);
+    }
+    return line;
+}
+
+// The cycles of the checkpoints aren't compared, as two CPU cores don't have to agree on them.
+bool same(const Decoder& a, const Decoder& b) {
+    if ((a.pc() != b.pc()) || (a.code() != b.code())) return false;
+    if (!a.hasRegisters() || !b.hasRegisters()) return true;
+    return memcmp(a.registers(), b.registers(), REGISTERS * sizeof(uint32_t)) == 0;
+}
+
+int dump(Reader& reader, uint64_t limit) {
+    while (reader.count() < limit) {
+        const auto status = reader.next();
+        if (status == Reader::Status::End) return 0;
+        if (status == Reader::Status::Error) {
+            fmt::print("Corrupted trace after {} records\n", reader.count());
+            return -1;
+        }
+        fmt::print("{}\n", format(status, reader.decoder()));
+    }
+    return 0;
+}
+
+// Walks both traces in lockstep, and stops at the first instruction where they differ.
+int diff(Reader& a, Reader& b) {
+    while (true) {
+        const auto statusA = a.next();
+        const auto statusB = b.next();
+        if ((statusA == Reader::Status::Error) || (statusB == Reader::Status::Error)) {
+            fmt::print("Corrupted trace after {} records\n", a.count());
+            return -1;
+        }
+        if ((statusA == Reader::Status::End) && (statusB == Reader::Status::End)) {
+            fmt::print("The traces are identical, {} records\n", a.count());
+            return 0;
+        }
+        if ((statusA == Reader::Status::End) || (statusB == Reader::Status::End)) {
+            fmt::print("The {} trace ends first, after {} records\n",
+                       statusA == Reader::Status::End ? "first" : "second", std::min(a.count(), b.count()));
+            return 1;
+        }
+        if ((statusA != statusB) || !same(a.decoder(), b.decoder())) {
+            fmt::print("The traces diverge at record {}:\n", a.count());
+            fmt::print("< {}\n", format(statusA, a.decoder()));
+            fmt::print("> {}\n", format(statusB, b.decoder()));
+            return 1;
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    CommandLine::args args(argc, argv);
+
+    fmt::print(R"(
+trace-decode
+https://github.com/grumpycoders/pcsx-redux/tree/main/tools/trace-decode/
+)");
+
+    const auto inputs = args.positional();
+    const bool asksForHelp = args.get<bool>("h").value_or(false);
+    const auto other = args.get<std::string>("diff");
+    const uint64_t limit = args.get<uint64_t>("n").value_or(UINT64_MAX);
+    if (asksForHelp || (inputs.size() != 1)) {
+        fmt::print(R"(
+Usage: {} trace.bin [-diff other.bin] [-n count] [-h]
+  trace.bin         a binary CPU trace, as written with the TraceFile or BlockTraceRecord debug settings.
+  -diff other.bin   compares against another trace, and shows where they first differ.
+  -n count          stops printing after this many records.
+  -h                displays this help information and exit.
+)",
+                   argv[0]);
+        return -1;
+    }
+
+    Reader reader;
+    if (!reader.open(std::string(inputs[0]))) {
+        fmt::print("Unable to open trace: {}\n", inputs[0]);
+        return -1;
+    }
+    if (!other.has_value()) return dump(reader, limit);
+
+    Reader otherReader;
+    if (!otherReader.open(other.value())) {
+        fmt::print("Unable to open trace: {}\n", other.value());
+        return -1;
+    }
+    return diff(reader, otherReader);
+}